@@ -0,0 +1,257 @@
+#!/usr/bin/env python
+"""Replays traffic captured with the server's trafficRecordingDirectory parameter.
+
+The server writes rotating capture files named traffic.<n>. Each one holds the requests it
+received, the headers of the replies it sent and the ends of sessions, along with wall clock
+timestamps. See src/mongo/transport/traffic_recorder.h for the file format.
+
+This script opens one connection per recorded session and sends every request at its recorded
+time relative to the start of the capture, divided by --speed. Requests that received a reply
+during recording wait for a reply during replay, so each connection sees the same sequence of
+request/reply exchanges. At the end it prints (or writes as JSON, with --report) the replay
+latency percentiles per opcode next to the latencies the server saw while recording. That makes
+it suitable for before/after comparisons of the same workload.
+
+Limitations: cursor ids and other server-generated values in the recorded requests are sent
+unchanged. A getMore for a cursor that does not exist in the target deployment therefore fails.
+Authentication is not replayed either, so the target must not require it.
+
+Sample usage:
+
+traffic_replay.py --host=localhost --port=27017 --speed=2 /path/to/trafficRecordingDirectory
+"""
+
+from __future__ import print_function
+
+import json
+import optparse
+import os
+import socket
+import struct
+import sys
+import threading
+import time
+
+MAGIC = b"MDBTRAF1"
+RECORD_HEADER = struct.Struct("<IBQq")
+MSG_HEADER = struct.Struct("<iiii")
+
+EVENT_REQUEST = 0
+EVENT_RESPONSE = 1
+EVENT_SESSION_END = 2
+
+OPCODE_NAMES = {
+    1: "reply",
+    2001: "update",
+    2002: "insert",
+    2004: "query",
+    2005: "getMore",
+    2006: "delete",
+    2007: "killCursors",
+    2010: "command",
+    2011: "commandReply",
+    2012: "compressed",
+    2013: "msg",
+}
+
+
+def read_capture_file(path):
+    """Yields (event_type, session_id, timestamp_micros, message_bytes) for each record."""
+    with open(path, "rb") as capture:
+        data = capture.read()
+    if not data.startswith(MAGIC):
+        raise ValueError("%s is not a traffic recording file" % path)
+    offset = len(MAGIC)
+    while offset < len(data):
+        if len(data) - offset < RECORD_HEADER.size:
+            raise ValueError("truncated record header in %s" % path)
+        length, event_type, session, timestamp = RECORD_HEADER.unpack_from(data, offset)
+        if length < RECORD_HEADER.size or offset + length > len(data):
+            raise ValueError("truncated or corrupt record in %s" % path)
+        yield event_type, session, timestamp, data[offset + RECORD_HEADER.size:offset + length]
+        offset += length
+
+
+def capture_files(paths):
+    """Expands directories into the capture files they contain, oldest first."""
+    files = []
+    for path in paths:
+        if os.path.isdir(path):
+            files.extend(
+                sorted(os.path.join(path, name) for name in os.listdir(path)
+                       if name.startswith("traffic.")))
+        else:
+            files.append(path)
+    return files
+
+
+def load_sessions(files):
+    """Groups the recorded events by session.
+
+    Returns (sessions, first_timestamp, recorded_latencies), where sessions maps a session id to
+    a list of (timestamp, message_bytes or None for a session end, expects_reply) tuples and
+    recorded_latencies maps an opcode name to the microsecond latencies observed while recording.
+    """
+    sessions = {}
+    pending = {}
+    recorded_latencies = {}
+    first_timestamp = None
+    for path in files:
+        for event_type, session, timestamp, message in read_capture_file(path):
+            if first_timestamp is None or timestamp < first_timestamp:
+                first_timestamp = timestamp
+            events = sessions.setdefault(session, [])
+            if event_type == EVENT_REQUEST:
+                _, request_id, _, opcode = MSG_HEADER.unpack_from(message)
+                events.append([timestamp, message, False])
+                pending[(session, request_id)] = (len(events) - 1, opcode, timestamp)
+            elif event_type == EVENT_RESPONSE:
+                _, _, response_to, _ = MSG_HEADER.unpack_from(message)
+                request = pending.pop((session, response_to), None)
+                if request is not None:
+                    index, opcode, request_timestamp = request
+                    events[index][2] = True
+                    recorded_latencies.setdefault(opcode_name(opcode), []).append(
+                        timestamp - request_timestamp)
+            elif event_type == EVENT_SESSION_END:
+                events.append([timestamp, None, False])
+    return sessions, first_timestamp, recorded_latencies
+
+
+def opcode_name(opcode):
+    return OPCODE_NAMES.get(opcode, str(opcode))
+
+
+def recv_exactly(sock, length):
+    chunks = []
+    while length > 0:
+        chunk = sock.recv(length)
+        if not chunk:
+            raise IOError("connection closed by server")
+        chunks.append(chunk)
+        length -= len(chunk)
+    return b"".join(chunks)
+
+
+class SessionReplayer(threading.Thread):
+    """Replays the events of one recorded session over its own connection."""
+
+    def __init__(self, events, host, port, start_time, first_timestamp, speed):
+        threading.Thread.__init__(self)
+        self.daemon = True
+        self.events = events
+        self.host = host
+        self.port = port
+        self.start_time = start_time
+        self.first_timestamp = first_timestamp
+        self.speed = speed
+        self.latencies = {}
+        self.errors = 0
+        self.sent = 0
+
+    def run(self):
+        sock = None
+        try:
+            for timestamp, message, expects_reply in self.events:
+                due = self.start_time + (timestamp - self.first_timestamp) / 1e6 / self.speed
+                delay = due - time.time()
+                if delay > 0:
+                    time.sleep(delay)
+
+                if message is None:
+                    break
+                if sock is None:
+                    sock = socket.create_connection((self.host, self.port))
+                    sock.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+
+                opcode = MSG_HEADER.unpack_from(message)[3]
+                started = time.time()
+                sock.sendall(message)
+                self.sent += 1
+                if expects_reply:
+                    length = struct.unpack("<i", recv_exactly(sock, 4))[0]
+                    recv_exactly(sock, length - 4)
+                    self.latencies.setdefault(opcode_name(opcode), []).append(
+                        (time.time() - started) * 1e6)
+        except (IOError, socket.error) as err:
+            print("session replay failed: %s" % err, file=sys.stderr)
+            self.errors += 1
+        finally:
+            if sock is not None:
+                sock.close()
+
+
+def summarize(latencies):
+    """Returns count and p50/p95/p99/p99.9/max of a list of microsecond latencies."""
+    latencies = sorted(latencies)
+
+    def percentile(pct):
+        index = max(0, int(-(-pct * len(latencies) // 100)) - 1)
+        return latencies[min(index, len(latencies) - 1)]
+
+    return {
+        "count": len(latencies),
+        "p50": percentile(50),
+        "p95": percentile(95),
+        "p99": percentile(99),
+        "p99_9": percentile(99.9),
+        "max": latencies[-1],
+    }
+
+
+def main():
+    parser = optparse.OptionParser(usage="Usage: %prog [options] <capture file or directory>...")
+    parser.add_option("--host", dest="host", default="localhost",
+                      help="Host to replay against [default: %default].")
+    parser.add_option("--port", dest="port", type="int", default=27017,
+                      help="Port to replay against [default: %default].")
+    parser.add_option("--speed", dest="speed", type="float", default=1.0,
+                      help="Replay speed relative to the recording; 2 replays twice as fast"
+                      " [default: %default].")
+    parser.add_option("--report", dest="report", default=None,
+                      help="Write the latency summary as JSON to this file.")
+    (options, args) = parser.parse_args()
+    if not args:
+        parser.error("no capture files given")
+    if options.speed <= 0:
+        parser.error("--speed must be positive")
+
+    sessions, first_timestamp, recorded = load_sessions(capture_files(args))
+    if first_timestamp is None:
+        print("no recorded events")
+        return 0
+
+    start_time = time.time() + 0.5
+    replayers = [
+        SessionReplayer(events, options.host, options.port, start_time, first_timestamp,
+                        options.speed) for _, events in sorted(sessions.items())
+    ]
+    for replayer in replayers:
+        replayer.start()
+    for replayer in replayers:
+        replayer.join()
+
+    replayed = {}
+    for replayer in replayers:
+        for name, values in replayer.latencies.items():
+            replayed.setdefault(name, []).extend(values)
+
+    report = {
+        "sessions": len(replayers),
+        "requestsSent": sum(replayer.sent for replayer in replayers),
+        "failedSessions": sum(replayer.errors for replayer in replayers),
+        "speed": options.speed,
+        "replayLatencyMicros": {name: summarize(values) for name, values in replayed.items()},
+        "recordedLatencyMicros": {name: summarize(values) for name, values in recorded.items()},
+    }
+
+    if options.report:
+        with open(options.report, "w") as report_file:
+            json.dump(report, report_file, indent=4, sort_keys=True)
+    else:
+        print(json.dumps(report, indent=4, sort_keys=True))
+    return 1 if report["failedSessions"] else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
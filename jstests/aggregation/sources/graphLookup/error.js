@@ -322,6 +322,13 @@ load("jstests/aggregation/extras/utils.js");  // For "assertErrorCode".
     };
     assertErrorCode(local, pipeline, 40099, "maximum memory usage reached");
 
+    // Unless the visited set may spill to disk, which succeeds if the results are unwound.
+    var res = local
+                  .aggregate([pipeline, {$unwind: "$graph"}, {$project: {"graph._id": 1}}],
+                             {allowDiskUse: true})
+                  .toArray();
+    assert.eq(initial, res.map(doc => doc.graph._id).sort());
+
     // Here, the visited set should grow to approximately 90 MB, and the frontier should push memory
     // usage over 100MB.
     foreign.drop();
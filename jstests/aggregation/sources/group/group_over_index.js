@@ -0,0 +1,79 @@
+/**
+ * Tests that a $group whose input is read from an index, either as a DISTINCT_SCAN or as an index
+ * scan sorted on the group key, returns the same groups as grouping the unindexed collection.
+ * @tags: [do_not_wrap_aggregations_in_facets, assumes_unsharded_collection]
+ */
+load("jstests/aggregation/extras/utils.js");  // For arrayEq.
+load("jstests/libs/analyze_plan.js");         // For getAggPlanStage.
+
+(function() {
+    "use strict";
+
+    const coll = db.group_over_index;
+    coll.drop();
+
+    // Documents missing 'a' and documents with a null 'a' share an index key, but group
+    // differently when the _id has more than one field.
+    const docs = [
+        {a: 1, b: 1},
+        {a: 1, b: 2},
+        {a: 1.0, b: 2},
+        {a: NumberLong(2), b: 1},
+        {a: "str", b: 1},
+        {a: {x: 1}, b: 3},
+        {a: null, b: 1},
+        {b: 1},
+        {a: null},
+        {},
+    ];
+    for (let i = 0; i < 10; i++) {
+        docs.forEach(doc => assert.writeOK(coll.insert(doc)));
+    }
+
+    const pipelines = [
+        [{$group: {_id: "$a"}}],
+        [{$match: {b: {$gte: 1}}}, {$group: {_id: "$a"}}],
+        [{$sort: {a: 1}}, {$group: {_id: "$a", count: {$sum: 1}}}],
+        [{$sort: {a: 1, b: 1}}, {$group: {_id: {x: "$a", y: "$b"}, count: {$sum: 1}}}],
+        [{$match: {a: {$gte: 1}}}, {$group: {_id: "$a", total: {$sum: "$b"}}}],
+    ];
+    const expected = pipelines.map(pipeline => coll.aggregate(pipeline).toArray());
+
+    function assertSameGroups() {
+        pipelines.forEach((pipeline, i) => {
+            const results = coll.aggregate(pipeline).toArray();
+            assert(arrayEq(expected[i], results),
+                   tojson({pipeline: pipeline, expected: expected[i], results: results}));
+        });
+    }
+
+    assert.commandWorked(coll.createIndex({a: 1, b: 1}));
+    assertSameGroups();
+
+    // A $group computing nothing but distinct values of 'a' skips through the index.
+    let explain = coll.explain().aggregate(pipelines[0]);
+    assert.neq(null, getAggPlanStage(explain, "DISTINCT_SCAN"), tojson(explain));
+
+    // A $group over input sorted on its _id returns each group as soon as it is complete.
+    explain = coll.explain().aggregate(pipelines[2]);
+    assert.eq(null, getAggPlanStage(explain, "SORT"), tojson(explain));
+    assert(explain.stages.some(stage => stage.hasOwnProperty("$streamingGroup")), tojson(explain));
+
+    // Neither applies once the index is multikey, since an array is grouped as a whole.
+    docs.push({a: [1, 2], b: 1});
+    assert.writeOK(coll.insert(docs[docs.length - 1]));
+    assert.commandWorked(coll.dropIndexes());
+    const expectedWithArray = pipelines.map(pipeline => coll.aggregate(pipeline).toArray());
+    assert.commandWorked(coll.createIndex({a: 1, b: 1}));
+
+    pipelines.forEach((pipeline, i) => {
+        const results = coll.aggregate(pipeline).toArray();
+        assert(arrayEq(expectedWithArray[i], results),
+               tojson({pipeline: pipeline, expected: expectedWithArray[i], results: results}));
+    });
+
+    explain = coll.explain().aggregate(pipelines[0]);
+    assert.eq(null, getAggPlanStage(explain, "DISTINCT_SCAN"), tojson(explain));
+    explain = coll.explain().aggregate(pipelines[2]);
+    assert(!explain.stages.some(stage => stage.hasOwnProperty("$streamingGroup")), tojson(explain));
+}());
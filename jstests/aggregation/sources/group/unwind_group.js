@@ -0,0 +1,70 @@
+// Tests that a $group absorbing the $unwind before it computes the same groups as the two stages
+// run separately.
+(function() {
+    "use strict";
+
+    var coll = db.unwind_group;
+    coll.drop();
+
+    assert.writeOK(coll.insert({_id: 0, x: 1, a: [1, 2, 2, 3]}));
+    assert.writeOK(coll.insert({_id: 1, x: 2, a: [{b: 1, c: 5}, {b: 2, c: 6}, {c: 7}, 4]}));
+    assert.writeOK(coll.insert({_id: 2, x: 1, a: [[1, 2], {b: [1, 2], c: 1}]}));
+    assert.writeOK(coll.insert({_id: 3, x: 3, a: 5}));
+    assert.writeOK(coll.insert({_id: 4, x: 3, a: {b: 3, c: 2}}));
+    assert.writeOK(coll.insert({_id: 5, x: 4, a: []}));
+    assert.writeOK(coll.insert({_id: 6, x: 4, a: null}));
+    assert.writeOK(coll.insert({_id: 7, x: 4}));
+    assert.writeOK(coll.insert({_id: 8, x: 5, o: {arr: [1, 1, 2], other: "p"}}));
+    assert.writeOK(coll.insert({_id: 9, x: 5, o: {arr: 7, other: "q"}}));
+    assert.writeOK(coll.insert({_id: 10, x: 5, o: [{arr: [1]}]}));
+
+    function normalize(results) {
+        results.forEach(function(result) {
+            Object.keys(result).forEach(function(field) {
+                if (Array.isArray(result[field])) {
+                    result[field].sort(function(lhs, rhs) {
+                        return tojson(lhs) < tojson(rhs) ? -1 : 1;
+                    });
+                }
+            });
+        });
+        return results.sort(function(lhs, rhs) {
+            return tojson(lhs._id) < tojson(rhs._id) ? -1 : 1;
+        });
+    }
+
+    function checkGroup(path, group) {
+        var fused = coll.aggregate([{$unwind: path}, {$group: group}]).toArray();
+
+        // Asking for the array index keeps the $unwind a stage of its own.
+        var separate =
+            coll.aggregate([{$unwind: {path: path, includeArrayIndex: "idx"}}, {$group: group}])
+                .toArray();
+        assert.eq(normalize(separate), normalize(fused), tojson(group));
+    }
+
+    checkGroup("$a", {_id: "$a", n: {$sum: 1}});
+    checkGroup("$a", {_id: "$a.b", total: {$sum: "$a.c"}, xs: {$addToSet: "$x"}});
+    checkGroup("$a", {_id: {k: "$x", v: "$a"}, n: {$sum: 1}, max: {$max: "$$ROOT.a.c"}});
+    checkGroup("$a", {_id: null, n: {$sum: 1}, avg: {$avg: "$a"}, set: {$addToSet: "$a.b"}});
+    checkGroup("$o.arr", {_id: "$o.arr", others: {$addToSet: "$o.other"}, n: {$sum: 1}});
+    checkGroup("$o.arr", {_id: "$x", values: {$addToSet: "$o.arr"}});
+
+    var explain = coll.explain().aggregate([{$unwind: "$a"}, {$group: {_id: "$a.b"}}]);
+    if (explain.hasOwnProperty("stages")) {
+        var group = explain.stages[explain.stages.length - 1].$group;
+        assert.eq({path: "$a"}, group.$unwinding, tojson(explain));
+    }
+
+    // A $group which reads more of the unwound document than paths into the array and paths
+    // disjoint from it leaves the $unwind in place.
+    explain = coll.explain().aggregate([{$unwind: "$o.arr"}, {$group: {_id: "$o"}}]);
+    if (explain.hasOwnProperty("stages")) {
+        var last = explain.stages[explain.stages.length - 1];
+        assert(!last.$group.hasOwnProperty("$unwinding"), tojson(explain));
+        assert(explain.stages[explain.stages.length - 2].hasOwnProperty("$unwind"),
+               tojson(explain));
+    }
+    checkGroup("$o.arr", {_id: "$o"});
+    checkGroup("$a", {_id: "$$ROOT"});
+})();
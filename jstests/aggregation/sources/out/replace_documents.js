@@ -0,0 +1,51 @@
+/**
+ * Tests $out in 'replaceDocuments' mode, which replaces or inserts each output document in the
+ * target collection by _id, instead of replacing the whole target collection.
+ * @tags: [assumes_unsharded_collection]
+ */
+load("jstests/aggregation/extras/utils.js");  // For assertErrorCode and arrayEq.
+
+(function() {
+    "use strict";
+
+    const source = db.out_replace_documents_source;
+    const target = db.out_replace_documents_target;
+    source.drop();
+    target.drop();
+
+    assert.writeOK(source.insert([{_id: 1, a: 1}, {_id: 2, a: 2}, {_id: 3, a: 3}]));
+    assert.writeOK(target.insert([{_id: 1, a: 1}, {_id: 2, a: 0}, {_id: 4, a: 4}]));
+    assert.commandWorked(target.createIndex({a: 1}));
+
+    const outSpec = {$out: {to: target.getName(), mode: "replaceDocuments"}};
+    assert.eq([], source.aggregate([outSpec]).toArray());
+
+    // Documents with a new _id are inserted, and changed documents are replaced, while documents
+    // of the target collection absent from the output are left untouched.
+    const expected = [{_id: 1, a: 1}, {_id: 2, a: 2}, {_id: 3, a: 3}, {_id: 4, a: 4}];
+    assert(arrayEq(expected, target.find().toArray()), tojson(target.find().toArray()));
+    assert.eq(2, target.getIndexes().length);
+
+    // Rerunning the same aggregation leaves the target collection unchanged.
+    source.aggregate([outSpec]);
+    assert(arrayEq(expected, target.find().toArray()), tojson(target.find().toArray()));
+
+    // The output of a later run is merged into the same collection.
+    assert.writeOK(source.update({_id: 3}, {$set: {a: 30}}));
+    source.aggregate([{$match: {_id: 3}}, outSpec]);
+    assert.eq({_id: 3, a: 30}, target.findOne({_id: 3}));
+    assert.eq(4, target.count());
+
+    // The string form replaces the whole collection, keeping its indexes.
+    source.aggregate([{$out: target.getName()}]);
+    assert(arrayEq([{_id: 1, a: 1}, {_id: 2, a: 2}, {_id: 3, a: 30}], target.find().toArray()),
+           tojson(target.find().toArray()));
+    assert.eq(2, target.getIndexes().length);
+
+    // Every output document needs an _id to be matched against the target collection.
+    assertErrorCode(source, [{$project: {_id: 0}}, outSpec], 40638);
+
+    assertErrorCode(source, [{$out: {to: target.getName(), mode: "unknown"}}], 40635);
+    assertErrorCode(source, [{$out: {to: target.getName(), unknown: 1}}], 40636);
+    assertErrorCode(source, [{$out: {mode: "replaceDocuments"}}], 40637);
+}());
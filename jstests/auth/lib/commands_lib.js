@@ -201,6 +201,31 @@ var authCommandsLib = {
           }]
         },
 
+        {
+          testname: "analyze",
+          command: {analyze: "x"},
+          skipSharded: true,
+          setup: function(db) {
+              db.x.save({});
+          },
+          teardown: function(db) {
+              db.x.drop();
+          },
+          testcases: [
+              {
+                runOnDb: firstDbName,
+                roles: roles_dbAdmin,
+                privileges:
+                    [{resource: {db: firstDbName, collection: "x"}, actions: ["planCacheWrite"]}],
+              },
+              {
+                runOnDb: secondDbName,
+                roles: roles_dbAdminAny,
+                privileges:
+                    [{resource: {db: secondDbName, collection: "x"}, actions: ["planCacheWrite"]}],
+              },
+          ]
+        },
         {
           testname: "applyOps_empty",
           command: {applyOps: []},
@@ -3587,6 +3612,31 @@ var authCommandsLib = {
               },
           ]
         },
+        {
+          testname: "planCacheWarm",
+          command: {planCacheWarm: "x", shapes: [{query: {a: 1}}]},
+          skipSharded: true,
+          setup: function(db) {
+              db.x.save({});
+          },
+          teardown: function(db) {
+              db.x.drop();
+          },
+          testcases: [
+              {
+                runOnDb: firstDbName,
+                roles: roles_dbAdmin,
+                privileges:
+                    [{resource: {db: firstDbName, collection: "x"}, actions: ["planCacheWrite"]}],
+              },
+              {
+                runOnDb: secondDbName,
+                roles: roles_dbAdminAny,
+                privileges:
+                    [{resource: {db: secondDbName, collection: "x"}, actions: ["planCacheWrite"]}],
+              },
+          ]
+        },
         {
           testname: "ping",
           command: {ping: 1},
@@ -0,0 +1,47 @@
+// Test the analyze command, which gathers field statistics used to estimate plan costs.
+
+(function() {
+    "use strict";
+
+    var t = db.jstests_analyze;
+    t.drop();
+
+    // Analyzing a missing collection fails.
+    assert.commandFailedWithCode(t.runCommand('analyze'), ErrorCodes.NamespaceNotFound);
+
+    for (var i = 0; i < 200; i++) {
+        t.insert({a: i % 10, b: i, c: [i, i + 1]});
+    }
+    assert.commandWorked(t.ensureIndex({a: 1}));
+    assert.commandWorked(t.ensureIndex({b: 1, a: 1}));
+
+    // Invalid arguments.
+    assert.commandFailedWithCode(t.runCommand('analyze', {sampleSize: 0}), ErrorCodes.BadValue);
+    assert.commandFailedWithCode(t.runCommand('analyze', {sampleSize: "x"}), ErrorCodes.BadValue);
+    assert.commandFailedWithCode(t.runCommand('analyze', {buckets: 0}), ErrorCodes.BadValue);
+    assert.commandFailedWithCode(t.runCommand('analyze', {fields: "a"}), ErrorCodes.BadValue);
+    assert.commandFailedWithCode(t.runCommand('analyze', {fields: [1]}), ErrorCodes.BadValue);
+
+    // By default every indexed field is analyzed.
+    var res = assert.commandWorked(t.runCommand('analyze'));
+    assert.eq(200, res.numRecords, tojson(res));
+    assert.eq(200, res.numSampled, tojson(res));
+    assert.eq(["_id", "a", "b"], Object.keys(res.fields).sort(), tojson(res));
+    assert.eq(10, res.fields.a.numDistinctValues, tojson(res));
+    assert.eq(1, res.fields.a.fractionPresent, tojson(res));
+    assert.eq(0, res.fields.a.bucketBoundaries[0], tojson(res));
+    assert.eq(9, res.fields.a.bucketBoundaries[res.fields.a.bucketBoundaries.length - 1],
+              tojson(res));
+
+    // Explicit fields, including array and missing ones, with a custom bucket count.
+    res = assert.commandWorked(
+        t.runCommand('analyze', {fields: ["b", "c", "missing"], sampleSize: 50, buckets: 4}));
+    assert.eq(50, res.numSampled, tojson(res));
+    assert.eq(5, res.fields.b.bucketBoundaries.length, tojson(res));
+    assert.eq(0, res.fields.missing.fractionPresent, tojson(res));
+    assert.eq([], res.fields.missing.bucketBoundaries, tojson(res));
+
+    // Queries still return correct results once statistics exist.
+    assert.eq(20, t.find({a: 3, b: {$gte: 0}}).itcount());
+    assert.eq(1, t.find({a: 3, b: 13}).itcount());
+})();
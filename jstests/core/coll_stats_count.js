@@ -0,0 +1,26 @@
+// Test the count option of the $collStats aggregation stage.
+(function() {
+    "use strict";
+
+    var coll = db.coll_stats_count;
+    coll.drop();
+
+    for (var i = 0; i < 5; i++) {
+        assert.writeOK(coll.insert({_id: i}));
+    }
+
+    var stats = coll.aggregate([{$collStats: {count: {}}}]).toArray();
+    assert.eq(1, stats.length, tojson(stats));
+    assert.eq(5, stats[0].count, tojson(stats));
+
+    // The count is only reported when asked for.
+    stats = coll.aggregate([{$collStats: {latencyStats: {}}}]).toArray();
+    assert(!stats[0].hasOwnProperty("count"), tojson(stats));
+
+    assert.commandFailedWithCode(db.runCommand({
+        aggregate: coll.getName(),
+        pipeline: [{$collStats: {count: 1}}],
+        cursor: {}
+    }),
+                                 40666);
+})();
@@ -138,3 +138,13 @@ explain = db.runCommand(
     {explain: {count: collName, query: {a: 2}, limit: 2}, verbosity: "executionStats"});
 checkCountExplain(explain, 1);
 checkCountScanIndexExplain(explain, {a: 2}, {a: 2}, true, true);
+
+// Counts over several intervals are answered from the index without fetching.
+assert.eq(11, db.runCommand({count: collName, query: {a: {$in: [1, 2]}}}).n);
+explain = db.runCommand(
+    {explain: {count: collName, query: {a: {$in: [1, 2]}}}, verbosity: "executionStats"});
+checkCountExplain(explain, 11);
+var countScanStage = getPlanStage(explain.executionStats.executionStages, "COUNT_SCAN");
+assert.neq(null, countScanStage, tojson(explain));
+assert.eq({a: ["[1.0, 1.0]", "[2.0, 2.0]"]}, countScanStage.indexBounds, tojson(explain));
+assert.eq(null, getPlanStage(explain.executionStats.executionStages, "FETCH"), tojson(explain));
@@ -0,0 +1,41 @@
+// Test that inserting a batch of large documents into a text index, whose keys may be generated on
+// several threads, indexes every document and reports a bad document at its place in the batch.
+(function() {
+    "use strict";
+
+    var t = db.fts_bulk_insert_large_docs;
+    t.drop();
+    assert.commandWorked(t.ensureIndex({a: "text"}));
+
+    // Roughly 200KB per document, with one word unique to each document.
+    var filler = new Array(20001).join(" lorem ipsum");
+    var docs = [];
+    for (var i = 0; i < 20; i++) {
+        docs.push({_id: i, a: "unique" + i + filler + " shared"});
+    }
+    assert.writeOK(t.insert(docs));
+
+    assert.eq(20, t.find({$text: {$search: "shared"}}).itcount());
+    for (i = 0; i < 20; i++) {
+        var found = t.find({$text: {$search: "unique" + i}}).toArray();
+        assert.eq(1, found.length, "unique" + i);
+        assert.eq(i, found[0]._id);
+    }
+    var validate = t.validate(true);
+    assert(validate.valid, tojson(validate));
+
+    // An ordered insert stops at the first document whose keys cannot be generated.
+    t.drop();
+    assert.commandWorked(t.ensureIndex({a: "text"}));
+    docs = [];
+    for (i = 0; i < 20; i++) {
+        docs.push({_id: i, a: "unique" + i + filler});
+    }
+    docs[13].language = "klingon";
+    docs[17].language = "klingon";
+    var res = t.insert(docs);
+    assert.writeError(res);
+    assert.eq(13, res.nInserted, tojson(res));
+    assert.eq(13, res.getWriteErrors()[0].index, tojson(res));
+    assert.eq(13, t.find({$text: {$search: "lorem"}}).itcount());
+})();
@@ -0,0 +1,74 @@
+// Test that a $text query sorted by text score with a limit returns the same highest scoring
+// documents, with the same scores, as the full sort does.
+(function() {
+    "use strict";
+
+    var t = db.fts_score_sort_limit;
+    t.drop();
+
+    var words = ["apple", "banana", "cherry", "damson", "elder", "fig", "grape"];
+    var bulk = t.initializeUnorderedBulkOp();
+    for (var i = 0; i < 500; i++) {
+        var text = [];
+        for (var j = 0; j < words.length; j++) {
+            // Give every document a different mix of term frequencies.
+            for (var k = 0; k < (i * (j + 3)) % (j + 5); k++) {
+                text.push(words[j]);
+            }
+        }
+        text.push("filler" + (i % 17));
+        bulk.insert({_id: i, a: text.join(" "), b: i % 3});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(t.ensureIndex({a: "text"}));
+
+    function checkLimit(filter, limit) {
+        var proj = {score: {$meta: "textScore"}};
+        var sort = {score: {$meta: "textScore"}};
+        var full = t.find(filter, proj).sort(sort).toArray();
+        var limited = t.find(filter, proj).sort(sort).limit(limit).toArray();
+
+        var scores = {};
+        full.forEach(function(doc) {
+            scores[doc._id] = doc.score;
+        });
+
+        assert.eq(Math.min(limit, full.length), limited.length, tojson(filter));
+        for (var i = 0; i < limited.length; i++) {
+            // Ties may be returned in any order, so compare scores rather than _ids.
+            assert.eq(full[i].score, limited[i].score, tojson(filter));
+            assert.eq(scores[limited[i]._id], limited[i].score, tojson(filter));
+        }
+    }
+
+    checkLimit({$text: {$search: "apple"}}, 5);
+    checkLimit({$text: {$search: "apple banana"}}, 1);
+    checkLimit({$text: {$search: "apple banana cherry"}}, 10);
+    checkLimit({$text: {$search: "fig grape filler3"}}, 20);
+    checkLimit({$text: {$search: "damson elder"}, b: 1}, 7);
+    checkLimit({$text: {$search: "apple nomatch"}}, 1000);
+    checkLimit({$text: {$search: "apple -banana"}}, 5);
+    checkLimit({$text: {$search: "\"apple apple\" cherry"}}, 5);
+
+    // A few short documents with many mentions of both terms score far above the rest, so the
+    // limited query should not need to examine every matching document.
+    t.drop();
+    var filler = new Array(21).join(" filler");
+    bulk = t.initializeUnorderedBulkOp();
+    for (i = 0; i < 5; i++) {
+        bulk.insert({a: "apple apple apple apple banana banana banana banana"});
+    }
+    for (i = 0; i < 300; i++) {
+        bulk.insert({a: "apple" + filler});
+        bulk.insert({a: "banana" + filler});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(t.ensureIndex({a: "text"}));
+    checkLimit({$text: {$search: "apple banana"}}, 3);
+
+    var explain = t.find({$text: {$search: "apple banana"}}, {score: {$meta: "textScore"}})
+                      .sort({score: {$meta: "textScore"}})
+                      .limit(3)
+                      .explain("executionStats");
+    assert.lt(explain.executionStats.totalDocsExamined, 100, tojson(explain));
+})();
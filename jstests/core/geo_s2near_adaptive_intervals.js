@@ -0,0 +1,107 @@
+// Test that $near on a 2dsphere index returns the same results while it sizes its search
+// intervals by the density of the results, and that it does not fetch documents whose index keys
+// lie outside $minDistance and $maxDistance.
+(function() {
+    "use strict";
+
+    var t = db.geo_s2near_adaptive_intervals;
+    t.drop();
+
+    function getNearStage(explain) {
+        var stage = explain.executionStats.executionStages;
+        while (stage.stage !== "GEO_NEAR_2DSPHERE") {
+            assert(stage.inputStage, tojson(explain));
+            stage = stage.inputStage;
+        }
+        return stage;
+    }
+
+    function distanceInMeters(a, b) {
+        var toRad = Math.PI / 180;
+        var lat1 = a[1] * toRad, lat2 = b[1] * toRad;
+        var dLat = lat2 - lat1, dLng = (b[0] - a[0]) * toRad;
+        var h = Math.pow(Math.sin(dLat / 2), 2) +
+            Math.cos(lat1) * Math.cos(lat2) * Math.pow(Math.sin(dLng / 2), 2);
+        return 2 * 6378100 * Math.asin(Math.sqrt(h));
+    }
+
+    // A dense grid of points about 11 meters apart around the origin.
+    var points = [];
+    var bulk = t.initializeUnorderedBulkOp();
+    for (var x = -50; x < 50; x++) {
+        for (var y = -50; y < 50; y++) {
+            var point = [x / 10000, y / 10000];
+            points.push(point);
+            bulk.insert({geo: {type: "Point", coordinates: point}});
+        }
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(t.ensureIndex({geo: "2dsphere"}));
+
+    function checkNear(minDistance, maxDistance) {
+        var near = {$geometry: {type: "Point", coordinates: [0.00003, 0.00002]}};
+        if (minDistance !== undefined) {
+            near.$minDistance = minDistance;
+        }
+        if (maxDistance !== undefined) {
+            near.$maxDistance = maxDistance;
+        }
+
+        var expected = points.map(function(point) {
+                                 return distanceInMeters(point, [0.00003, 0.00002]);
+                             })
+                           .filter(function(distance) {
+                               return (minDistance === undefined || distance >= minDistance) &&
+                                   (maxDistance === undefined || distance <= maxDistance);
+                           })
+                           .sort(function(a, b) {
+                               return a - b;
+                           });
+        var results = t.find({geo: {$near: near}}).toArray();
+        assert.eq(expected.length, results.length, tojson(near));
+
+        var last = 0;
+        results.forEach(function(doc) {
+            var distance = distanceInMeters(doc.geo.coordinates, [0.00003, 0.00002]);
+            assert.gte(distance, last - 1e-6, tojson(near));
+            last = distance;
+        });
+        return getNearStage(t.find({geo: {$near: near}}).explain("executionStats"));
+    }
+
+    checkNear();
+    checkNear(undefined, 2000);
+    checkNear(100, 300);
+
+    // The coverings of the search intervals reach past $maxDistance, but the documents beyond it
+    // are filtered out on their index keys.
+    var nearStage = checkNear(undefined, 150);
+    var fetched = 0;
+    var keys = 0;
+    (function count(stage) {
+        if (stage.stage === "FETCH") {
+            fetched += stage.docsExamined;
+        } else if (stage.stage === "IXSCAN") {
+            keys += stage.keysExamined;
+        }
+        (stage.inputStages || []).forEach(count);
+        if (stage.inputStage) {
+            count(stage.inputStage);
+        }
+    })(nearStage);
+    assert.lt(fetched, keys, tojson(nearStage));
+
+    // A few points near the origin and one far away. The search should widen quickly through the
+    // empty space in between rather than doubling its intervals one at a time.
+    t.drop();
+    assert.commandWorked(t.ensureIndex({geo: "2dsphere"}));
+    for (var i = 0; i < 5; i++) {
+        assert.writeOK(t.insert({geo: {type: "Point", coordinates: [i / 1000, 0]}}));
+    }
+    assert.writeOK(t.insert({geo: {type: "Point", coordinates: [60, 0]}}));
+
+    var near = {geo: {$near: {$geometry: {type: "Point", coordinates: [0, 0]}}}};
+    assert.eq(6, t.find(near).itcount());
+    nearStage = getNearStage(t.find(near).explain("executionStats"));
+    assert.lte(nearStage.searchIntervals.length, 10, tojson(nearStage));
+})();
@@ -0,0 +1,60 @@
+// Tests hashed indexes built with the MurmurHash3 hash function (hashVersion 1).
+// Cannot implicitly shard accessed collections because of extra shard key index in sharded
+// collection.
+// @tags: [assumes_no_implicit_index_creation]
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");
+
+    var t = db.hashed_index_version;
+    t.drop();
+
+    // Only the known hash functions are accepted, and only for hashed indexes.
+    assert.commandFailedWithCode(t.createIndex({a: "hashed"}, {hashVersion: 2}),
+                                 ErrorCodes.CannotCreateIndex);
+    assert.commandFailedWithCode(t.createIndex({a: "hashed"}, {hashVersion: "1"}),
+                                 ErrorCodes.TypeMismatch);
+    assert.commandFailedWithCode(t.createIndex({a: 1}, {hashVersion: 1}),
+                                 ErrorCodes.CannotCreateIndex);
+
+    assert.commandWorked(t.createIndex({a: "hashed"}, {hashVersion: 1}));
+    var bulk = t.initializeUnorderedBulkOp();
+    for (var i = 0; i < 100; i++) {
+        bulk.insert({a: i, b: "x" + i});
+    }
+    bulk.insert({a: 3.1});
+    bulk.insert({b: "missing"});
+    bulk.insert({a: null});
+    bulk.insert({a: {c: 5}});
+    assert.writeOK(bulk.execute());
+
+    // Equality queries use the index and find the same documents as a collection scan.
+    [3, 3.1, 99, "3", null, {c: 5}, 1000].forEach(function(value) {
+        var query = {a: value};
+        var expected = t.find(query).hint({$natural: 1}).sort({_id: 1}).toArray();
+        var actual = t.find(query).hint({a: "hashed"}).sort({_id: 1}).toArray();
+        assert.eq(expected, actual, tojson(query));
+
+        var explain = t.find(query).explain();
+        assert(isIxscan(explain.queryPlanner.winningPlan), tojson(explain));
+    });
+
+    var inQuery = {a: {$in: [1, 2, 50]}};
+    assert.eq(3, t.find(inQuery).hint({a: "hashed"}).itcount());
+
+    var explain = t.find({a: 7}).explain("executionStats");
+    assert.eq(1, explain.executionStats.nReturned, tojson(explain));
+    assert.eq(1, explain.executionStats.totalKeysExamined, tojson(explain));
+
+    // The hash function is part of the index options.
+    var indexes = t.getIndexes().filter(function(index) {
+        return bsonWoCompare(index.key, {a: "hashed"}) === 0;
+    });
+    assert.eq(1, indexes.length, tojson(t.getIndexes()));
+    assert.eq(1, indexes[0].hashVersion, tojson(indexes));
+    assert.commandFailedWithCode(t.createIndex({a: "hashed"}, {name: "a_md5", hashVersion: 0}),
+                                 ErrorCodes.IndexOptionsConflict);
+
+    assert(t.validate({full: true}).valid);
+})();
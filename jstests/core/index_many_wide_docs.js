@@ -0,0 +1,57 @@
+/**
+ * Tests that documents with many fields in a collection with many indexes, whose keys are generated
+ * from a table of the document's fields shared by all of the indexes, are indexed correctly on
+ * insert and update.
+ */
+(function() {
+    "use strict";
+
+    const coll = db.index_many_wide_docs;
+    coll.drop();
+
+    const numFields = 300;
+    function makeDoc(id, offset) {
+        const doc = {_id: id};
+        for (let i = 0; i < numFields; i++) {
+            doc["f" + i] = i + offset;
+        }
+        doc.arr = [{x: offset}, {x: offset + 1}];
+        doc.sub = {y: offset};
+        return doc;
+    }
+
+    const keyPatterns = [{f0: 1}, {f150: 1, f299: 1}, {"arr.x": 1, f1: 1}, {"sub.y": 1}, {f42: -1}];
+    keyPatterns.forEach(keyPattern => assert.commandWorked(coll.createIndex(keyPattern)));
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let id = 0; id < 10; id++) {
+        bulk.insert(makeDoc(id, id * 1000));
+    }
+    assert.writeOK(bulk.execute());
+    assert.writeOK(coll.insert(makeDoc(10, 10000)));
+
+    function assertFoundThroughEveryIndex(id, offset) {
+        const queries = [
+            {f0: offset},
+            {f150: 150 + offset, f299: 299 + offset},
+            {"arr.x": offset + 1, f1: 1 + offset},
+            {"sub.y": offset},
+            {f42: 42 + offset},
+        ];
+        queries.forEach((query, i) => {
+            const results = coll.find(query, {_id: 1}).hint(keyPatterns[i]).toArray();
+            assert.eq([{_id: id}], results, tojson({query: query, hint: keyPatterns[i]}));
+        });
+    }
+
+    for (let id = 0; id <= 10; id++) {
+        assertFoundThroughEveryIndex(id, id * 1000);
+    }
+
+    // Replacing the document updates the keys of every index.
+    assert.writeOK(coll.update({_id: 3}, makeDoc(3, 50000)));
+    assertFoundThroughEveryIndex(3, 50000);
+    assert.eq(0, coll.find({f0: 3000}).hint({f0: 1}).itcount());
+
+    assert(coll.validate().valid);
+}());
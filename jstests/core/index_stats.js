@@ -243,9 +243,9 @@
                  ])
                   .itcount());
     assert.eq(1, getUsageCount("_id_", col), "Expected aggregation to use _id index");
-    assert.eq(2,
+    assert.eq(1,
               getUsageCount("_id_", foreignCollection),
-              "Expected each lookup to be tracked as an index use");
+              "Expected the batched lookup of both documents to be tracked as one index use");
 
     //
     // Confirm index use is recorded for $graphLookup.
@@ -0,0 +1,112 @@
+// Tests that map and reduce functions which mapReduce recognizes and runs without the JavaScript
+// engine produce the same results as their JavaScript equivalents.
+(function() {
+    "use strict";
+
+    const coll = db.mr_native;
+    coll.drop();
+
+    assert.writeOK(coll.insert([
+        {_id: 1, k: 1, v: 1},
+        {_id: 2, k: 1.0, v: 2.5},
+        {_id: 3, k: "a", v: NumberInt(3)},
+        {_id: 4, k: "a", v: -1},
+        {_id: 5, v: 4},
+        {_id: 6, k: null, v: 5},
+        {_id: 7, k: {x: 1}, v: 6},
+        {_id: 8, k: true, v: NumberLong(7)},
+        {_id: 9, k: true, v: 8},
+        {_id: 10, k: "b", v: "str"},
+        {_id: 11, k: "b", v: 9},
+        {_id: 12, k: [1, 2], v: 10},
+    ]));
+
+    function runMapReduce(map, reduce, out) {
+        const res = assert.commandWorked(db.runCommand({
+            mapReduce: coll.getName(),
+            map: map,
+            reduce: reduce,
+            out: out || {inline: 1},
+            verbose: true,
+        }));
+        return res;
+    }
+
+    function sortById(results) {
+        return results.sort((a, b) => bsonWoCompare({_id: a._id}, {_id: b._id}));
+    }
+
+    const nativeReduce = function(key, values) {
+        return Array.sum(values);
+    };
+    // Equivalent to Array.sum, but not recognized as such.
+    const jsReduce = function(key, values) {
+        var total = values[0];
+        for (var i = 1; i < values.length; i++) {
+            total += values[i];
+        }
+        return total;
+    };
+
+    const testCases = [
+        {
+          nativeMap: function() {
+              emit(this.k, this.v);
+          },
+          jsMap: function() {
+              var doc = this;
+              emit(doc.k, doc.v);
+          }
+        },
+        {
+          nativeMap: function() {
+              emit(this.k, 1);
+          },
+          jsMap: function() {
+              var one = 1;
+              emit(this.k, one);
+          }
+        },
+        {
+          nativeMap: function() {
+              emit(0, this.v);
+          },
+          jsMap: function() {
+              var zero = 0;
+              emit(zero, this.v);
+          }
+        },
+    ];
+
+    testCases.forEach(function(testCase) {
+        const expected = runMapReduce(testCase.jsMap, jsReduce);
+        assert.eq("mixed", expected.timing.mode, tojson(expected));
+        assert.eq(false, expected.timing.nativeMap, tojson(expected));
+
+        const res = runMapReduce(testCase.nativeMap, nativeReduce);
+        assert.eq("native", res.timing.mode, tojson(res));
+        assert.eq(true, res.timing.nativeMap, tojson(res));
+        assert.eq(true, res.timing.nativeReduce, tojson(res));
+        assert.eq(sortById(expected.results), sortById(res.results), tojson(res));
+        assert.eq(expected.counts, res.counts, tojson(res));
+
+        // The results written to a collection are the same as well.
+        runMapReduce(testCase.nativeMap, nativeReduce, "mr_native_out");
+        assert.eq(sortById(expected.results),
+                  sortById(db.mr_native_out.find().toArray()),
+                  tojson(res));
+    });
+
+    // A native mapper runs even if jsMode is requested, in which case the reduce runs natively too.
+    const res = assert.commandWorked(db.runCommand({
+        mapReduce: coll.getName(),
+        map: testCases[1].nativeMap,
+        reduce: nativeReduce,
+        out: {inline: 1},
+        jsMode: true,
+        verbose: true,
+    }));
+    assert.eq("native", res.timing.mode, tojson(res));
+
+    db.mr_native_out.drop();
+}());
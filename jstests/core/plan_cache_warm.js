@@ -0,0 +1,47 @@
+// Test the planCacheWarm command, which plans and caches a list of query shapes.
+
+var t = db.jstests_plan_cache_warm;
+t.drop();
+
+// Warming the cache of a non-existent collection is not an error.
+var missingCollection = db.jstests_plan_cache_warm_missing;
+missingCollection.drop();
+assert.commandWorked(missingCollection.runCommand('planCacheWarm', {shapes: [{query: {a: 1}}]}));
+
+t.save({a: 1, b: 1});
+t.save({a: 1, b: 2});
+t.save({a: 2, b: 2});
+
+// We need two indices so that the MultiPlanRunner is executed.
+t.ensureIndex({a: 1});
+t.ensureIndex({a: 1, b: 1});
+
+// Invalid arguments.
+assert.commandFailed(t.runCommand('planCacheWarm'));
+assert.commandFailed(t.runCommand('planCacheWarm', {shapes: {query: {a: 1}}}));
+assert.commandFailed(t.runCommand('planCacheWarm', {shapes: [1]}));
+assert.commandFailed(t.runCommand('planCacheWarm', {shapes: [{sort: {a: 1}}]}));
+assert.commandFailed(t.runCommand('planCacheWarm', {shapes: [{query: {a: {$bad: 1}}}]}));
+
+// Populate the cache by running queries, then capture its shapes and clear it.
+assert.eq(1, t.find({a: 1, b: 1}, {_id: 1, a: 1}).sort({a: -1}).itcount());
+assert.eq(2, t.find({a: 1}).itcount());
+var shapes = t.getPlanCache().listQueryShapes();
+assert.eq(2, shapes.length, tojson(shapes));
+t.getPlanCache().clear();
+assert.eq(0, t.getPlanCache().listQueryShapes().length);
+
+// Warming the cache with the captured shapes re-creates the same entries without running queries.
+var res = t.getPlanCache().warm(shapes);
+assert.eq(2, res.numShapes, tojson(res));
+assert.eq(2, res.numCached, tojson(res));
+var warmedShapes = t.getPlanCache().listQueryShapes();
+assert.eq(2, warmedShapes.length, tojson(warmedShapes));
+shapes.forEach(function(shape) {
+    assert.neq(0, t.getPlanCache().getPlansByQuery(shape).length, tojson(shape));
+});
+
+// Shapes with a single candidate plan are planned but not cached.
+res = t.getPlanCache().warm([{query: {b: 1}}]);
+assert.eq(1, res.numShapes, tojson(res));
+assert.eq(0, res.numCached, tojson(res));
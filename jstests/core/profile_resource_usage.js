@@ -0,0 +1,35 @@
+// Confirms that profiled operations report the CPU time they consumed where the platform can
+// measure it.
+
+(function() {
+    "use strict";
+
+    // For getLatestProfilerEntry.
+    load("jstests/libs/profiler.js");
+
+    const testDB = db.getSiblingDB("profile_resource_usage");
+    assert.commandWorked(testDB.dropDatabase());
+    const coll = testDB.getCollection("test");
+
+    testDB.setProfilingLevel(2);
+
+    for (let i = 0; i < 100; ++i) {
+        assert.writeOK(coll.insert({a: i}));
+    }
+    assert.eq(100, coll.find({a: {$gte: 0}}).itcount());
+
+    const isLinux = getBuildInfo().buildEnvironment.target_os === "linux";
+    [{op: "insert"}, {op: "query"}].forEach(function(filter) {
+        const profileObj = getLatestProfilerEntry(testDB, filter);
+        if (isLinux) {
+            assert.gte(profileObj.cpuTimeMicros, 0, tojson(profileObj));
+        } else {
+            assert(!profileObj.hasOwnProperty("cpuTimeMicros"), tojson(profileObj));
+        }
+        if (profileObj.hasOwnProperty("ticketQueuedMicros")) {
+            assert.gt(profileObj.ticketQueuedMicros, 0, tojson(profileObj));
+        }
+    });
+
+    testDB.setProfilingLevel(0);
+}());
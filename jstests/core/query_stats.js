@@ -0,0 +1,50 @@
+// Tests that the $queryStats aggregation stage reports the execution statistics of each query
+// shape of a collection.
+// @tags: [assumes_unsharded_collection]
+
+(function() {
+    "use strict";
+
+    const coll = db.jstests_query_stats;
+    coll.drop();
+
+    for (let i = 0; i < 10; ++i) {
+        assert.writeOK(coll.insert({a: i, b: i % 2}));
+    }
+    assert.commandWorked(coll.createIndex({a: 1}));
+
+    function getShapeStats(predicate) {
+        const stats = coll.aggregate([{$queryStats: {}}]).toArray();
+        return stats.filter(predicate);
+    }
+
+    // Queries differing only in their constants share a shape.
+    assert.eq(1, coll.find({a: 1}).itcount());
+    assert.eq(1, coll.find({a: 5}).itcount());
+    assert.eq(5, coll.find({b: 1}).sort({a: 1}).itcount());
+
+    let shapes = getShapeStats(shape => shape.shape.query.hasOwnProperty("a"));
+    assert.eq(1, shapes.length, tojson(shapes));
+    const indexedShape = shapes[0];
+    assert.eq(coll.getFullName(), indexedShape.ns, tojson(indexedShape));
+    assert.eq({a: 1}, indexedShape.shape.query, tojson(indexedShape));
+    assert.eq(2, indexedShape.count, tojson(indexedShape));
+    assert.eq(2, indexedShape.nReturned, tojson(indexedShape));
+    assert.eq(2, indexedShape.docsExamined, tojson(indexedShape));
+    assert.eq(1, indexedShape.docsExaminedPerReturned, tojson(indexedShape));
+    assert.eq("IXSCAN { a: 1 }", indexedShape.planSummary, tojson(indexedShape));
+    assert.eq(2, indexedShape.latencyStats.reads.ops, tojson(indexedShape));
+    assert(indexedShape.hasOwnProperty("host"), tojson(indexedShape));
+
+    shapes = getShapeStats(shape => shape.shape.query.hasOwnProperty("b"));
+    assert.eq(1, shapes.length, tojson(shapes));
+    assert.eq({a: 1}, shapes[0].shape.sort, tojson(shapes));
+    assert.eq(5, shapes[0].nReturned, tojson(shapes));
+
+    // The stage takes no options and must be the first stage of the pipeline.
+    assert.commandFailedWithCode(
+        db.runCommand({aggregate: coll.getName(), pipeline: [{$queryStats: {a: 1}}], cursor: {}}),
+        40641);
+    assert.commandFailed(db.runCommand(
+        {aggregate: coll.getName(), pipeline: [{$match: {}}, {$queryStats: {}}], cursor: {}}));
+}());
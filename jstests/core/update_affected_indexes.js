@@ -0,0 +1,63 @@
+/**
+ * Tests that an update which only modifies the paths of some of a collection's indexes leaves the
+ * keys of every index consistent with the updated document.
+ */
+(function() {
+    "use strict";
+
+    const coll = db.update_affected_indexes;
+    coll.drop();
+
+    const keyPatterns = [{a: 1}, {b: 1}, {"c.d": 1}, {e: 1, a: 1}, {"f.g": 1}];
+    keyPatterns.forEach(keyPattern => assert.commandWorked(coll.createIndex(keyPattern)));
+    assert.commandWorked(coll.createIndex({h: 1}, {partialFilterExpression: {i: {$gt: 0}}}));
+
+    assert.writeOK(coll.insert({_id: 0, a: 1, b: 1, c: {d: 1}, e: 1, f: {g: 1}, h: 1, i: 0}));
+
+    function assertFoundThroughIndex(query, keyPattern, expectedCount) {
+        const count = coll.find(query).hint(keyPattern).itcount();
+        assert.eq(expectedCount, count, tojson({query: query, hint: keyPattern}));
+    }
+
+    // Modifying a path indexed on its own or as part of a compound index updates both indexes.
+    assert.writeOK(coll.update({_id: 0}, {$set: {a: 2}}));
+    assertFoundThroughIndex({a: 2}, {a: 1}, 1);
+    assertFoundThroughIndex({a: 1}, {a: 1}, 0);
+    assertFoundThroughIndex({e: 1, a: 2}, {e: 1, a: 1}, 1);
+    assertFoundThroughIndex({e: 1, a: 1}, {e: 1, a: 1}, 0);
+    assertFoundThroughIndex({b: 1}, {b: 1}, 1);
+
+    // Modifying a prefix of an indexed path, or a path inside an indexed field, updates its index.
+    assert.writeOK(coll.update({_id: 0}, {$set: {c: {d: 2}}}));
+    assertFoundThroughIndex({"c.d": 2}, {"c.d": 1}, 1);
+    assertFoundThroughIndex({"c.d": 1}, {"c.d": 1}, 0);
+    assert.writeOK(coll.update({_id: 0}, {$set: {"f.g": [3, 4]}}));
+    assertFoundThroughIndex({"f.g": 4}, {"f.g": 1}, 1);
+    assertFoundThroughIndex({"f.g": 1}, {"f.g": 1}, 0);
+
+    // Modifying the filter of a partial index adds the document to the index.
+    assertFoundThroughIndex({h: 1, i: {$gt: 0}}, {h: 1}, 0);
+    assert.writeOK(coll.update({_id: 0}, {$inc: {i: 1}}));
+    assertFoundThroughIndex({h: 1, i: {$gt: 0}}, {h: 1}, 1);
+
+    // A $rename modifies both its source and its target.
+    assert.writeOK(coll.update({_id: 0}, {$rename: {b: "e"}}));
+    assertFoundThroughIndex({b: 1}, {b: 1}, 0);
+    assertFoundThroughIndex({b: null}, {b: 1}, 1);
+    assertFoundThroughIndex({e: 1, a: 2}, {e: 1, a: 1}, 1);
+
+    // Updates of unindexed paths, which may grow the document, leave every index correct.
+    assert.writeOK(coll.update({_id: 0}, {$set: {unindexed: "x".repeat(10 * 1024)}}));
+    assertFoundThroughIndex({a: 2}, {a: 1}, 1);
+    assertFoundThroughIndex({"c.d": 2}, {"c.d": 1}, 1);
+    assertFoundThroughIndex({h: 1, i: {$gt: 0}}, {h: 1}, 1);
+
+    // A replacement updates every index.
+    assert.writeOK(coll.update({_id: 0}, {a: 5, b: 5}));
+    assertFoundThroughIndex({a: 5}, {a: 1}, 1);
+    assertFoundThroughIndex({b: 5}, {b: 1}, 1);
+    assertFoundThroughIndex({"c.d": 2}, {"c.d": 1}, 0);
+    assertFoundThroughIndex({h: 1, i: {$gt: 0}}, {h: 1}, 0);
+
+    assert(coll.validate().valid);
+}());
@@ -362,6 +362,12 @@
             {command: {planCacheListQueryShapes: "view"}, expectFailure: true},
         planCacheSetFilter: {command: {planCacheSetFilter: "view"}, expectFailure: true},
         profile: {skip: isUnrelated},
+        refreshView: {
+            command: {refreshView: "view"},
+            expectFailure: true,
+            expectedErrorCode: ErrorCodes.InvalidOptions,
+            skipSharded: true
+        },
         reIndex: {command: {reIndex: "view"}, expectFailure: true},
         removeShard: {skip: isUnrelated},
         removeShardFromZone: {skip: isUnrelated},
@@ -0,0 +1,85 @@
+/**
+ * Tests materialized views, which are read from the collection they are materialized into while
+ * their contents are fresh enough, and expanded like any other view otherwise.
+ * @tags: [requires_find_command]
+ */
+(function() {
+    "use strict";
+
+    // For arrayEq.
+    load("jstests/aggregation/extras/utils.js");
+
+    // mongos has no refreshView command.
+    if (db.isMaster().msg === "isdbgrid") {
+        return;
+    }
+
+    let viewDB = db.getSiblingDB("views_materialized");
+    assert.commandWorked(viewDB.dropDatabase());
+
+    let coll = viewDB.coll;
+    for (let i = 0; i < 10; i++) {
+        assert.writeOK(coll.insert({_id: i, k: i % 2, v: i}));
+    }
+
+    const pipeline = [{$group: {_id: "$k", total: {$sum: "$v"}}}];
+    assert.commandWorked(viewDB.runCommand(
+        {create: "totals", viewOn: "coll", pipeline: pipeline, materialized: {into: "totalsData"}}));
+
+    function materialization(name) {
+        let res = viewDB.runCommand({listCollections: 1, filter: {name: name}});
+        assert.commandWorked(res);
+        let infos = new DBCommandCursor(db.getMongo(), res).toArray();
+        assert.eq(1, infos.length, tojson(infos));
+        assert.eq({into: "totalsData", maxStalenessMS: 0}, infos[0].options.materialized);
+        return infos[0].info.materialization;
+    }
+
+    function assertTotals(expected) {
+        assert(arrayEq(viewDB.totals.find().toArray(), expected), tojson(expected));
+    }
+
+    // Until it is refreshed, the view is computed from its source.
+    assert.eq(false, materialization("totals").readsMaterialization);
+    assertTotals([{_id: 0, total: 20}, {_id: 1, total: 25}]);
+
+    assert.commandWorked(viewDB.runCommand({refreshView: "totals"}));
+    let info = materialization("totals");
+    assert.eq(true, info.upToDate, tojson(info));
+    assert.eq(true, info.readsMaterialization, tojson(info));
+    assertTotals([{_id: 0, total: 20}, {_id: 1, total: 25}]);
+
+    // Reads of a fresh view come from the collection it is materialized into, so a change made
+    // there directly shows through.
+    assert.writeOK(viewDB.totalsData.insert({_id: "marker"}));
+    assert.eq(1, viewDB.totals.find({_id: "marker"}).itcount());
+    assert.commandWorked(viewDB.runCommand({refreshView: "totals"}));
+    assert.eq(0, viewDB.totals.find({_id: "marker"}).itcount());
+
+    // A change to the source makes the view stale. Since its maximum staleness is zero, reads
+    // compute the view again until the next refresh.
+    assert.writeOK(coll.insert({_id: 10, k: 0, v: 10}));
+    info = materialization("totals");
+    assert.eq(false, info.upToDate, tojson(info));
+    assert.eq(false, info.readsMaterialization, tojson(info));
+    assertTotals([{_id: 0, total: 30}, {_id: 1, total: 25}]);
+
+    assert.commandWorked(viewDB.runCommand({refreshView: "totals"}));
+    assert.eq(true, materialization("totals").upToDate);
+    assertTotals([{_id: 0, total: 30}, {_id: 1, total: 25}]);
+
+    // Dropping the collection the view is materialized into forgets the refresh.
+    assert(viewDB.totalsData.drop());
+    assert.eq(false, materialization("totals").readsMaterialization);
+    assertTotals([{_id: 0, total: 30}, {_id: 1, total: 25}]);
+
+    // Only materialized views can be refreshed, and a view cannot be materialized into its source.
+    assert.commandWorked(viewDB.runCommand({create: "plain", viewOn: "coll", pipeline: pipeline}));
+    assert.commandFailedWithCode(viewDB.runCommand({refreshView: "plain"}),
+                                 ErrorCodes.InvalidOptions);
+    assert.commandFailedWithCode(
+        viewDB.runCommand({create: "self", viewOn: "coll", materialized: {into: "coll"}}),
+        ErrorCodes.InvalidOptions);
+    assert.commandFailed(
+        viewDB.runCommand({create: "noInto", viewOn: "coll", materialized: {maxStalenessMS: 1}}));
+})();
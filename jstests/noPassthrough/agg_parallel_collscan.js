@@ -0,0 +1,47 @@
+/**
+ * Tests that an aggregation whose $match is answered by a collection scan returns the same results
+ * when the scan filters documents on several threads.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, "mongod failed to start");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.agg_parallel_collscan;
+    coll.drop();
+
+    const numDocs = 10000;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < numDocs; ++i) {
+        bulk.insert({_id: i, a: i % 100, b: "str" + (i % 7)});
+    }
+    assert.writeOK(bulk.execute());
+
+    const pipelines = [
+        [{$match: {a: {$lt: 30}}}, {$group: {_id: "$b", count: {$sum: 1}, total: {$sum: "$a"}}}],
+        [{$match: {$or: [{a: 5}, {b: /^str[12]$/}]}}, {$group: {_id: null, count: {$sum: 1}}}],
+        [{$match: {a: {$gte: 99}}}, {$project: {_id: 1}}],
+        [{$match: {$where: "this.a === 42"}}, {$count: "count"}],
+    ];
+
+    function runPipelines() {
+        return pipelines.map(pipeline => coll.aggregate(pipeline).toArray().sort(
+                                 (x, y) => tojson(x._id) < tojson(y._id) ? -1 : 1));
+    }
+
+    function setMaxParallelism(value) {
+        assert.commandWorked(testDB.adminCommand(
+            {setParameter: 1, internalQueryExecCollScanMaxParallelism: value}));
+    }
+
+    setMaxParallelism(1);
+    const expected = runPipelines();
+
+    setMaxParallelism(4);
+    assert.eq(expected, runPipelines());
+
+    setMaxParallelism(1);
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,52 @@
+// Test that a collection created with the 'clustered' option accepts only positive integral _ids
+// and finds documents by _id.
+(function() {
+    "use strict";
+
+    var storageEngine = jsTest.options().storageEngine || "wiredTiger";
+    var conn = MongoRunner.runMongod({});
+    var db = conn.getDB("test");
+
+    if (storageEngine !== "wiredTiger") {
+        assert.commandFailedWithCode(db.createCollection("clustered", {clustered: true}), 40645);
+        MongoRunner.stopMongod(conn);
+        return;
+    }
+
+    assert.commandWorked(db.createCollection("clustered", {clustered: true}));
+    var coll = db.clustered;
+
+    assert.writeOK(coll.insert({_id: 3, x: "c"}));
+    assert.writeOK(coll.insert({_id: NumberLong(1), x: "a"}));
+    assert.writeOK(coll.insert({_id: 2.0, x: "b"}));
+
+    assert.writeError(coll.insert({_id: 3, x: "duplicate"}));
+    assert.writeError(coll.insert({_id: "d"}));
+    assert.writeError(coll.insert({_id: 0}));
+    assert.writeError(coll.insert({_id: 1.5}));
+    assert.writeError(coll.insert({x: "no _id"}));
+
+    // The documents are stored in _id order.
+    assert.eq([1, 2, 3], coll.find().toArray().map(function(doc) {
+        return doc._id;
+    }));
+
+    assert.eq("a", coll.findOne({_id: 1}).x);
+    assert.eq("c", coll.findOne({_id: 3}).x);
+    assert.eq(null, coll.findOne({_id: 4}));
+    assert.eq(null, coll.findOne({_id: "a"}));
+
+    var explain = coll.find({_id: 2}).explain("executionStats");
+    assert.eq(1, explain.executionStats.nReturned, tojson(explain));
+    assert.eq(0, explain.executionStats.totalKeysExamined, tojson(explain));
+
+    assert.writeOK(coll.update({_id: 2}, {$set: {x: "B"}}));
+    assert.eq("B", coll.findOne({_id: 2}).x);
+    assert.writeOK(coll.remove({_id: 2}));
+    assert.eq(2, coll.count());
+
+    assert.commandFailed(
+        db.createCollection("clustered_capped", {clustered: true, capped: true, size: 1024}));
+
+    MongoRunner.stopMongod(conn);
+})();
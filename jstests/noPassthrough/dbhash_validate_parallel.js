@@ -0,0 +1,64 @@
+/**
+ * Tests that dbHash returns the same hashes whether or not it hashes collections on worker
+ * threads, and that validate can check a snapshot of a collection without locking it exclusively.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, "mongod failed to start");
+
+    const testDB = conn.getDB("test");
+    const adminDB = conn.getDB("admin");
+
+    for (let c = 0; c < 6; ++c) {
+        const coll = testDB["dbhash_parallel_" + c];
+        const bulk = coll.initializeUnorderedBulkOp();
+        for (let i = 0; i < 1000 * c; ++i) {
+            bulk.insert({_id: i, x: "x".repeat(i % 100), c: c});
+        }
+        if (c > 0) {
+            assert.writeOK(bulk.execute());
+        } else {
+            assert.commandWorked(testDB.createCollection(coll.getName()));
+        }
+        assert.commandWorked(coll.createIndex({x: 1}));
+    }
+    assert.commandWorked(
+        testDB.createCollection("dbhash_parallel_capped", {capped: true, size: 4096}));
+    assert.writeOK(testDB.dbhash_parallel_capped.insert({a: 1}));
+
+    function dbHash(numThreads, collections) {
+        assert.commandWorked(adminDB.runCommand({setParameter: 1, maxDBHashThreads: numThreads}));
+        const cmd = {dbHash: 1};
+        if (collections) {
+            cmd.collections = collections;
+        }
+        const res = assert.commandWorked(testDB.runCommand(cmd));
+        delete res.timeMillis;
+        return res;
+    }
+
+    const serial = dbHash(1);
+    assert.eq(serial, dbHash(4));
+    assert.eq(serial, dbHash(64));
+    assert.eq(dbHash(1, ["dbhash_parallel_3", "dbhash_parallel_5"]),
+              dbHash(4, ["dbhash_parallel_3", "dbhash_parallel_5"]));
+
+    // Validating in the background needs the storage engine to read from a snapshot.
+    const coll = testDB.dbhash_parallel_5;
+    const storageEngine = testDB.serverStatus().storageEngine.name;
+    if (storageEngine === "mmapv1" || storageEngine === "ephemeralForTest") {
+        assert.commandFailedWithCode(coll.runCommand("validate", {background: true}),
+                                     ErrorCodes.CommandNotSupported);
+    } else {
+        [{}, {full: true}].forEach(function(options) {
+            const res = assert.commandWorked(
+                coll.runCommand("validate", Object.merge({background: true}, options)));
+            assert(res.valid, tojson(res));
+            assert.eq(5000, res.nrecords, tojson(res));
+        });
+    }
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,119 @@
+/**
+ * Tests that $lookup returns the same results whether it queries the foreign collection for every
+ * input document, queries it for a batch of input documents at once, rebinds the values of either
+ * into a query it prepared once, or answers the join from a hash table of the foreign collection.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, "mongod failed to start");
+
+    const testDB = conn.getDB("test");
+    const local = testDB.lookup_hash_join_local;
+    const foreign = testDB.lookup_hash_join_foreign;
+    local.drop();
+    foreign.drop();
+
+    const values = [1, 2, NumberLong(2), 2.0, "a", "A", null, [1, 3], [[1]], {b: 1}, /a/, [], 7];
+    for (let i = 0; i < 200; ++i) {
+        assert.writeOK(local.insert({_id: i, x: values[i % values.length]}));
+    }
+    assert.writeOK(local.insert({_id: "missing"}));
+    for (let i = 0; i < 50; ++i) {
+        assert.writeOK(foreign.insert({_id: i, y: values[(i * 7) % values.length]}));
+        assert.writeOK(foreign.insert({_id: "nested" + i, y: [{z: i % 3}, {z: [i % 5]}]}));
+    }
+    assert.writeOK(foreign.insert({_id: "missing"}));
+
+    const pipelines = [
+        [{$lookup: {from: foreign.getName(), localField: "x", foreignField: "y", as: "joined"}}],
+        [
+          {$lookup: {from: foreign.getName(), localField: "x", foreignField: "y.z", as: "joined"}},
+          {$unwind: {path: "$joined", preserveNullAndEmptyArrays: true}}
+        ],
+        [
+          {$lookup: {from: foreign.getName(), localField: "x", foreignField: "y", as: "joined"}},
+          {$unwind: "$joined"},
+          {$match: {"joined._id": {$lt: 25}}}
+        ],
+    ];
+
+    function sortedJoins(result) {
+        return result
+            .map(doc => {
+                if (Array.isArray(doc.joined)) {
+                    doc.joined = doc.joined.map(tojson).sort();
+                }
+                return tojson(doc);
+            })
+            .sort();
+    }
+
+    function setHashJoinEnabled(enabled) {
+        assert.commandWorked(testDB.adminCommand(
+            {setParameter: 1, internalDocumentSourceLookupEnableHashJoin: enabled}));
+    }
+
+    function setBatchSize(batchSize) {
+        assert.commandWorked(testDB.adminCommand(
+            {setParameter: 1, internalDocumentSourceLookupBatchSize: batchSize}));
+    }
+
+    function setPrepareQueries(enabled) {
+        assert.commandWorked(testDB.adminCommand(
+            {setParameter: 1, internalDocumentSourceLookupPrepareQueries: enabled}));
+    }
+
+    function runPipelines() {
+        return pipelines.map(pipeline => sortedJoins(local.aggregate(pipeline).toArray()));
+    }
+
+    setHashJoinEnabled(false);
+    setPrepareQueries(false);
+    setBatchSize(1);
+    const expected = runPipelines();
+
+    for (let batchSize of [2, 7, 100]) {
+        setBatchSize(batchSize);
+        assert.eq(expected, runPipelines(), "batchSize: " + batchSize);
+    }
+
+    // Without an index there is no plan to prepare, so queries are planned one by one.
+    setPrepareQueries(true);
+    assert.eq(expected, runPipelines());
+
+    // Once the foreign fields are indexed, queries are answered by rebinding their values into the
+    // bounds of a prepared index scan, which must return the same documents.
+    assert.commandWorked(foreign.createIndex({y: 1}));
+    assert.commandWorked(foreign.createIndex({"y.z": 1}));
+    for (let batchSize of [1, 7, 100]) {
+        setBatchSize(batchSize);
+        assert.eq(expected, runPipelines(), "batchSize: " + batchSize);
+    }
+
+    // Indexes created or dropped between runs are noticed by the prepared queries.
+    assert.commandWorked(foreign.dropIndex({"y.z": 1}));
+    assert.eq(expected, runPipelines());
+    assert.commandWorked(foreign.createIndex({"y.z": -1}));
+    assert.eq(expected, runPipelines());
+
+    setHashJoinEnabled(true);
+    assert.eq(expected, runPipelines());
+
+    // An indexed foreign field defers building the hash table for longer, but the results must
+    // not change.
+    setPrepareQueries(false);
+    assert.eq(expected, runPipelines());
+    setPrepareQueries(true);
+
+    // Explain reports the strategy that will be used first, how many documents each query
+    // answers, and when a hash join would take over.
+    const explain = local.explain().aggregate(pipelines[0]);
+    const lookupStage = explain.stages.find(stage => stage.hasOwnProperty("$lookup")).$lookup;
+    assert.eq("nestedLoop", lookupStage.strategy, tojson(explain));
+    assert.eq(100, lookupStage.batchSize, tojson(explain));
+    assert.gt(lookupStage.hashJoinAfterQueries, 0, tojson(explain));
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,83 @@
+/**
+ * Tests that mapReduce returns the same results when its JavaScript map function runs on several
+ * threads, and that errors raised by the map function on a worker thread are reported.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({setParameter: "mapReduceMapThreads=4"});
+    assert.neq(null, conn, "mongod failed to start");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.mr_parallel_map;
+    coll.drop();
+
+    const numDocs = 5000;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < numDocs; ++i) {
+        bulk.insert({_id: i, a: i % 100, tags: ["t" + (i % 3), "t" + (i % 5)]});
+    }
+    assert.writeOK(bulk.execute());
+
+    // Stored functions are available to the map function on every thread.
+    assert.writeOK(testDB.system.js.save({_id: "double", value: function(x) {
+                                              return 2 * x;
+                                          }}));
+
+    const map = function() {
+        var doc = this;
+        this.tags.forEach(function(tag) {
+            emit(tag, {count: 1, total: double(doc.a), firstId: doc._id});
+        });
+    };
+    // Depends on the order of the values, which the parallel map must preserve.
+    const reduce = function(key, values) {
+        var res = {count: 0, total: 0, firstId: values[0].firstId};
+        values.forEach(function(v) {
+            res.count += v.count;
+            res.total += v.total;
+        });
+        return res;
+    };
+
+    function runMapReduce(out) {
+        const res = assert.commandWorked(testDB.runCommand({
+            mapReduce: coll.getName(),
+            map: map,
+            reduce: reduce,
+            out: out,
+            sort: {_id: 1},
+        }));
+        const results = res.results || testDB[out].find().toArray();
+        return results.sort((x, y) => x._id < y._id ? -1 : 1);
+    }
+
+    function setMapThreads(value) {
+        assert.commandWorked(testDB.adminCommand({setParameter: 1, mapReduceMapThreads: value}));
+    }
+
+    setMapThreads(1);
+    const expected = runMapReduce({inline: 1});
+    assert.eq(5, expected.length, tojson(expected));
+
+    setMapThreads(4);
+    assert.eq(expected, runMapReduce({inline: 1}));
+    assert.eq(expected, runMapReduce("mr_parallel_map_out"));
+
+    // An error in the map function fails the command.
+    const res = testDB.runCommand({
+        mapReduce: coll.getName(),
+        map: function() {
+            if (this._id === 4321) {
+                throw new Error("map failed");
+            }
+            emit(this.a, 1);
+        },
+        reduce: reduce,
+        out: {inline: 1},
+    });
+    assert.commandFailed(res);
+    assert(/map failed/.test(res.errmsg), tojson(res));
+
+    MongoRunner.stopMongod(conn);
+}());
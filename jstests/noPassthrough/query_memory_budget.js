@@ -0,0 +1,49 @@
+/**
+ * Tests that blocking query stages reserve memory from the process-wide budget set by
+ * internalQueryMaxProcessMemoryBytes: stages that may spill do so early once the budget is
+ * exhausted, and the others fail with ExceededMemoryLimit after waiting for memory.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({
+        setParameter: {
+            internalQueryMaxProcessMemoryBytes: 1024 * 1024,
+            internalQueryMemoryWaitMS: 100
+        }
+    });
+    assert.neq(null, conn, "mongod failed to start");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.query_memory_budget;
+    coll.drop();
+
+    const str = "x".repeat(1024);
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 2000; ++i) {
+        bulk.insert({_id: i, a: i % 500, str: str});
+    }
+    assert.writeOK(bulk.execute());
+
+    const pipeline = [{$group: {_id: "$a", strs: {$push: "$str"}}}];
+
+    // The group stays far below its own limit, but not below the process-wide budget.
+    assert.commandFailedWithCode(
+        testDB.runCommand({aggregate: coll.getName(), pipeline: pipeline, cursor: {}}),
+        ErrorCodes.ExceededMemoryLimit);
+
+    // With allowDiskUse the group spills early instead.
+    assert.eq(500, coll.aggregate(pipeline, {allowDiskUse: true}).itcount());
+
+    // A blocking sort of the documents cannot fit in the budget either.
+    assert.throws(() => coll.find().sort({str: 1, a: 1}).itcount());
+
+    const stats = assert.commandWorked(testDB.adminCommand({serverStatus: 1})).queryMemory;
+    assert.eq(1024 * 1024, stats.limitBytes, tojson(stats));
+    assert.eq(0, stats.reservedBytes, tojson(stats));
+    assert.gte(stats.earlySpills, 1, tojson(stats));
+    assert.gte(stats.waits, 2, tojson(stats));
+    assert.gte(stats.failures, 2, tojson(stats));
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,104 @@
+/**
+ * Tests that the results of find commands are cached when internalQueryResultCacheSizeBytes is
+ * set, and that writes to a collection keep its cached results from being returned again.
+ */
+(function() {
+    "use strict";
+
+    const conn =
+        MongoRunner.runMongod({setParameter: {internalQueryResultCacheSizeBytes: 1024 * 1024}});
+    assert.neq(null, conn, "mongod failed to start");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.query_result_cache;
+    coll.drop();
+
+    function stats() {
+        return testDB.serverStatus().metrics.query.resultCache;
+    }
+
+    function find(filter) {
+        const res = assert.commandWorked(
+            testDB.runCommand({find: coll.getName(), filter: filter, sort: {_id: 1}}));
+        assert.eq(0, res.cursor.id);
+        return res.cursor.firstBatch;
+    }
+
+    for (let i = 0; i < 10; ++i) {
+        assert.writeOK(coll.insert({_id: i, a: i % 2}));
+    }
+
+    // The first run of a query caches its results, and the next one returns them.
+    let before = stats();
+    assert.eq(5, find({a: 1}).length);
+    assert.eq(5, find({a: 1}).length);
+    let after = stats();
+    assert.eq(before.misses + 1, after.misses, tojson(after));
+    assert.eq(before.inserts + 1, after.inserts, tojson(after));
+    assert.eq(before.hits + 1, after.hits, tojson(after));
+
+    // Queries with other values are cached apart.
+    assert.eq(5, find({a: 0}).length);
+    assert.eq(after.misses + 1, stats().misses);
+
+    // Inserting, updating and removing documents invalidates the results of the collection.
+    assert.writeOK(coll.insert({_id: 10, a: 1}));
+    assert.eq(before.invalidations + 2, stats().invalidations);
+    assert.eq(6, find({a: 1}).length);
+
+    assert.eq(6, find({a: 1}).length);
+    assert.writeOK(coll.update({_id: 10}, {$set: {a: 0}}));
+    assert.eq(5, find({a: 1}).length);
+
+    assert.eq(5, find({a: 1}).length);
+    assert.writeOK(coll.remove({_id: 1}));
+    assert.eq(4, find({a: 1}).length);
+
+    // Dropping an index invalidates the results of the queries which can no longer run.
+    assert.commandWorked(coll.createIndex({a: 1}));
+    const hinted = {find: coll.getName(), filter: {a: 1}, hint: {a: 1}};
+    assert.commandWorked(testDB.runCommand(hinted));
+    assert.commandWorked(testDB.runCommand(hinted));
+    assert.commandWorked(coll.dropIndex({a: 1}));
+    assert.commandFailed(testDB.runCommand(hinted));
+
+    // Dropping the collection invalidates its results too.
+    assert.eq(4, find({a: 1}).length);
+    coll.drop();
+    assert.eq(0, find({a: 1}).length);
+
+    // Results which do not fit in the first batch are not cached.
+    for (let i = 0; i < 10; ++i) {
+        assert.writeOK(coll.insert({_id: i, a: i % 2}));
+    }
+    before = stats();
+    assert.eq(10, coll.find().batchSize(2).itcount());
+    assert.eq(before.inserts, stats().inserts);
+
+    // Nor are the results of queries using JavaScript.
+    assert.eq(5, coll.find({$where: "this.a == 1"}).itcount());
+    assert.eq(before.inserts, stats().inserts);
+
+    // Capped collections lose documents behind the back of the cache.
+    const capped = testDB.query_result_cache_capped;
+    capped.drop();
+    assert.commandWorked(testDB.createCollection(capped.getName(), {capped: true, size: 4096}));
+    assert.writeOK(capped.insert({a: 1}));
+    assert.eq(1, capped.find({a: 1}).itcount());
+    assert.eq(before.inserts, stats().inserts);
+
+    // Setting the size of the cache drops everything, and zero disables it.
+    assert.eq(5, find({a: 1}).length);
+    assert.gt(stats().entries, 0);
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, internalQueryResultCacheSizeBytes: 0}));
+    assert.eq(0, stats().entries);
+    before = stats();
+    assert.eq(5, find({a: 1}).length);
+    assert.eq(5, find({a: 1}).length);
+    after = stats();
+    assert.eq(before.hits, after.hits);
+    assert.eq(before.misses, after.misses);
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,53 @@
+// Test that the TTL monitor deletes the expired documents of a collection in batches over several
+// passes when there are more of them than it may delete in one pass, and that it reports the
+// outcome of the passes for each TTL index.
+(function() {
+    "use strict";
+    var runner = MongoRunner.runMongod({
+        setParameter: {
+            ttlMonitorSleepSecs: 1,
+            ttlMonitorBatchSize: 3,
+            ttlIndexMaxDeletesPerPass: 10,
+        }
+    });
+    var db = runner.getDB("test");
+
+    var past = new Date(new Date().getTime() - 60 * 60 * 1000);
+    var future = new Date(new Date().getTime() + 60 * 60 * 1000);
+    ["ttl_batched_a", "ttl_batched_b"].forEach(function(collName) {
+        var coll = db[collName];
+        coll.drop();
+        var bulk = coll.initializeUnorderedBulkOp();
+        for (var i = 0; i < 25; i++) {
+            bulk.insert({x: past});
+        }
+        bulk.insert({x: future});
+        assert.writeOK(bulk.execute());
+        assert.commandWorked(coll.ensureIndex({x: 1}, {expireAfterSeconds: 0}));
+    });
+
+    assert.soon(function() {
+        return db.ttl_batched_a.count() === 1 && db.ttl_batched_b.count() === 1;
+    }, "TTL monitor didn't delete the expired documents before timing out.");
+
+    // Each pass deletes at most 10 documents through an index, so it takes several of them.
+    assert.gte(db.serverStatus().metrics.ttl.deletedDocuments, 50);
+
+    // Wait for a pass with nothing left to delete.
+    var ttlPass = db.serverStatus().metrics.ttl.passes;
+    assert.soon(function() {
+        return db.serverStatus().metrics.ttl.passes >= ttlPass + 2;
+    }, "TTL monitor didn't run before timing out.");
+
+    var indexStats = db.serverStatus().metrics.ttl.indexes;
+    ["ttl_batched_a", "ttl_batched_b"].forEach(function(collName) {
+        var stats = indexStats["test." + collName + ".$x_1"];
+        assert(stats, tojson(indexStats));
+        assert.eq(0, stats.deletedLastPass, tojson(stats));
+        assert.eq(false, stats.backlog, tojson(stats));
+        assert.eq(0, stats.lagSecs, tojson(stats));
+    });
+
+    assert.eq(1, db.ttl_batched_a.find({x: future}).itcount());
+    MongoRunner.stopMongod(runner);
+})();
@@ -0,0 +1,72 @@
+// Tests the open-loop "opsPerSecond" mode of benchRun() and its latency percentiles.
+(function() {
+    "use strict";
+
+    var coll = db.bench_open_loop;
+    coll.drop();
+    assert.writeOK(coll.insert({_id: 1, x: 0}));
+
+    function makeBenchArgs(extra) {
+        var benchArgs = {
+            ops: [{op: "update", ns: coll.getFullName(), query: {_id: 1}, update: {$inc: {x: 1}}}],
+            parallel: 2,
+            seconds: 4,
+            host: db.getMongo().host
+        };
+        if (jsTest.options().auth) {
+            benchArgs['db'] = 'admin';
+            benchArgs['username'] = jsTest.options().authUser;
+            benchArgs['password'] = jsTest.options().authPassword;
+        }
+        return Object.extend(benchArgs, extra);
+    }
+
+    function checkPercentiles(latencies) {
+        assert(latencies, "missing latency percentiles");
+        assert.lte(0, latencies.p50, tojson(latencies));
+        assert.lte(latencies.p50, latencies.p95, tojson(latencies));
+        assert.lte(latencies.p95, latencies.p99, tojson(latencies));
+        assert.lte(latencies.p99, latencies.p99_9, tojson(latencies));
+        assert.lte(latencies.p99_9, latencies.max, tojson(latencies));
+    }
+
+    // Closed-loop runs report percentiles too.
+    var res = benchRun(makeBenchArgs({}));
+    checkPercentiles(res.updateLatencyMicros);
+    assert.eq(undefined, res["targetOps/s"], tojson(res));
+
+    // An open-loop run issues operations at the requested rate rather than as fast as possible.
+    var target = 100;
+    res = benchRun(makeBenchArgs({opsPerSecond: target}));
+    checkPercentiles(res.updateLatencyMicros);
+    assert.eq(target, res["targetOps/s"], tojson(res));
+    assert.gt(res.update, target * 0.5, tojson(res));
+    assert.lt(res.update, target * 1.5, tojson(res));
+
+    // Two runners splitting one aggregate rate together issue about that rate.
+    var startAt = new Date(new Date().getTime() + 500);
+    var runners = [0, 1].map(function(processId) {
+        return benchStart(makeBenchArgs(
+            {opsPerSecond: target, numProcesses: 2, processId: processId, startAt: startAt}));
+    });
+    sleep(4000);
+    var results = runners.map(function(runner) {
+        return benchFinish(runner);
+    });
+    var combined = 0;
+    results.forEach(function(result) {
+        assert.eq(target / 2, result["targetOps/s"], tojson(result));
+        checkPercentiles(result.updateLatencyMicros);
+        combined += result.update;
+    });
+    assert.gt(combined, target * 0.5, tojson(results));
+    assert.lt(combined, target * 1.5, tojson(results));
+
+    // Invalid open-loop configurations are rejected.
+    assert.throws(function() {
+        benchRun(makeBenchArgs({opsPerSecond: -1}));
+    });
+    assert.throws(function() {
+        benchRun(makeBenchArgs({opsPerSecond: target, numProcesses: 2, processId: 2}));
+    });
+})();
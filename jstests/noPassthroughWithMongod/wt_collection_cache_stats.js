@@ -0,0 +1,78 @@
+/**
+ * Tests that $collStats, $indexStats and the "collectionCache" serverStatus section report how
+ * much of a collection and its indexes WiredTiger holds in its cache.
+ */
+(function() {
+    'use strict';
+
+    // Skip this test if not running with the "wiredTiger" storage engine.
+    if (db.serverStatus().storageEngine.name !== 'wiredTiger') {
+        jsTest.log('Skipping test because storageEngine is not "wiredTiger"');
+        return;
+    }
+
+    var coll = db.wt_collection_cache_stats;
+    coll.drop();
+
+    assert.commandWorked(coll.createIndex({a: 1}));
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 1000; i++) {
+        bulk.insert({a: i, padding: new Array(101).join('x')});
+    }
+    assert.writeOK(bulk.execute());
+    assert.eq(1000, coll.find().hint({a: 1}).itcount());
+
+    function checkCacheStats(stats) {
+        assert.gt(stats.bytesInCache, 0, tojson(stats));
+        assert.gt(stats.pagesRequestedFromCache, 0, tojson(stats));
+        ['bytesDirtyInCache',
+         'bytesReadIntoCache',
+         'bytesWrittenFromCache',
+         'pagesReadIntoCache',
+         'pagesWrittenFromCache',
+         'unmodifiedPagesEvicted',
+         'modifiedPagesEvicted']
+            .forEach(function(field) {
+                assert.gte(stats[field], 0, field + ' in ' + tojson(stats));
+            });
+    }
+
+    assert.commandFailedWithCode(
+        db.runCommand({aggregate: coll.getName(), pipeline: [{$collStats: {cacheStats: 1}}]}),
+        40664);
+
+    var collStats = coll.aggregate([{$collStats: {cacheStats: {}}}]).toArray();
+    assert.eq(1, collStats.length, tojson(collStats));
+    var cacheStats = collStats[0].cacheStats;
+    checkCacheStats(cacheStats);
+    checkCacheStats(cacheStats.indexes._id_);
+    checkCacheStats(cacheStats.indexes.a_1);
+
+    var indexStats = coll.aggregate([{$indexStats: {}}]).toArray();
+    assert.eq(2, indexStats.length, tojson(indexStats));
+    indexStats.forEach(function(index) {
+        checkCacheStats(index.cache);
+    });
+
+    // The section is only reported when asked for a positive number of collections.
+    assert(!db.serverStatus().hasOwnProperty('collectionCache'));
+    var collections = db.serverStatus({collectionCache: 1000}).collectionCache.collections;
+    var entry = collections.filter(function(c) {
+        return c.ns === coll.getFullName();
+    });
+    assert.eq(1, entry.length, tojson(collections));
+    checkCacheStats(entry[0]);
+    assert.gt(entry[0].indexBytesInCache, 0, tojson(entry[0]));
+    assert(!entry[0].hasOwnProperty('indexes'), tojson(entry[0]));
+    for (i = 1; i < collections.length; i++) {
+        assert.gte(collections[i - 1].bytesInCache + collections[i - 1].indexBytesInCache,
+                   collections[i].bytesInCache + collections[i].indexBytesInCache,
+                   tojson(collections));
+    }
+
+    assert.eq(1, db.serverStatus({collectionCache: 1}).collectionCache.collections.length);
+
+    assert.commandWorked(db.adminCommand({setParameter: 1, collectionCacheStatsTopN: 2}));
+    assert.gte(2, db.serverStatus().collectionCache.collections.length);
+    assert.commandWorked(db.adminCommand({setParameter: 1, collectionCacheStatsTopN: 0}));
+})();
@@ -0,0 +1,71 @@
+// Test that mongos sends each shard only its share of a $sample, in proportion to how many of the
+// collection's documents the shard holds, and still returns the full sample size.
+(function() {
+    "use strict";
+
+    var st = new ShardingTest({shards: 2});
+
+    var dbName = jsTest.name();
+    var mongosDB = st.s.getDB(dbName);
+    var coll = mongosDB.coll;
+
+    assert.commandWorked(st.s.adminCommand({enableSharding: dbName}));
+    st.ensurePrimaryShard(dbName, 'shard0000');
+    assert.commandWorked(st.s.adminCommand({shardCollection: coll.getFullName(), key: {_id: 1}}));
+
+    // Leave nine tenths of the documents on shard0000 and the rest on shard0001.
+    var numDocs = 10000;
+    assert.commandWorked(st.s.adminCommand({split: coll.getFullName(), middle: {_id: 9000}}));
+    assert.commandWorked(st.s.adminCommand(
+        {moveChunk: coll.getFullName(), find: {_id: 9000}, to: 'shard0001', _waitForDelete: true}));
+
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < numDocs; i++) {
+        bulk.insert({_id: i});
+    }
+    assert.writeOK(bulk.execute());
+
+    var shard0DB = st.shard0.getDB(dbName);
+    var shard1DB = st.shard1.getDB(dbName);
+    assert.commandWorked(shard0DB.setProfilingLevel(2));
+    assert.commandWorked(shard1DB.setProfilingLevel(2));
+
+    var sampleSize = 200;
+    var res = assert.commandWorked(mongosDB.runCommand({
+        aggregate: coll.getName(),
+        pipeline: [{$sample: {size: sampleSize}}],
+        comment: "proportional_sample",
+        cursor: {}
+    }));
+    var docs = new DBCommandCursor(st.s, res).toArray();
+    assert.eq(sampleSize, docs.length, tojson(docs));
+
+    var ids = {};
+    docs.forEach(function(doc) {
+        assert(!ids.hasOwnProperty(doc._id), "duplicate document in sample: " + tojson(doc));
+        ids[doc._id] = true;
+    });
+
+    // Returns the size of the $sample that mongos sent to the shard.
+    function sampleSizeSentTo(shardDB) {
+        var entries = shardDB.system.profile
+                          .find({"command.aggregate": coll.getName(),
+                                 "command.comment": "proportional_sample"})
+                          .toArray();
+        assert.eq(1, entries.length, tojson(entries));
+        var firstStage = entries[0].command.pipeline[0];
+        assert(firstStage.hasOwnProperty("$sample"), tojson(entries[0]));
+        return firstStage.$sample.size;
+    }
+
+    var shard0Size = sampleSizeSentTo(shard0DB);
+    var shard1Size = sampleSizeSentTo(shard1DB);
+    assert.gte(shard0Size, sampleSize * 0.9, "shard0000 sample size: " + shard0Size);
+    assert.lt(shard1Size, sampleSize / 2, "shard0001 sample size: " + shard1Size);
+    assert.lt(shard0Size + shard1Size, sampleSize * 1.5);
+
+    assert.commandWorked(shard0DB.setProfilingLevel(0));
+    assert.commandWorked(shard1DB.setProfilingLevel(0));
+
+    st.stop();
+})();
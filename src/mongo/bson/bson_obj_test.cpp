@@ -25,6 +25,8 @@
  *    then also delete it in the license file.
  */
 
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault
+
 #include "mongo/bson/bsonelement_comparator.h"
 #include "mongo/bson/bsonobj_comparator.h"
 #include "mongo/bson/simple_bsonelement_comparator.h"
@@ -34,6 +36,8 @@
 #include "mongo/platform/decimal128.h"
 
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/log.h"
+#include "mongo/util/timer.h"
 
 namespace {
 using namespace mongo;
@@ -608,4 +612,53 @@ TEST(BSONObj, ShareOwnershipWith) {
     ASSERT_BSONOBJ_EQ(obj, BSON("a" << 1));
 }
 
+TEST(BSONObjCompare, OrderingAgreesWithKeyPattern) {
+    const BSONObj pattern = BSON("a" << 1 << "b" << -1 << "c" << 1);
+    const Ordering ordering = Ordering::make(pattern);
+    const std::vector<BSONObj> keys = {BSON("" << 1 << "" << 2 << "" << "x"),
+                                       BSON("" << 1 << "" << 3 << "" << "x"),
+                                       BSON("" << 1.0 << "" << 2 << "" << "y"),
+                                       BSON("" << 2LL << "" << MINKEY << "" << BSONNULL),
+                                       BSON("" << "s" << "" << 2 << "" << "x")};
+    for (auto&& l : keys) {
+        for (auto&& r : keys) {
+            ASSERT_EQ(l.woCompare(r, pattern, false), l.woCompare(r, ordering, false));
+        }
+    }
+}
+
+TEST(BSONObjComparePerf, SameTypeKeys) {
+    const int kNumKeys = 1000;
+    const int kNumPasses = 20;
+
+    std::vector<BSONObj> keys;
+    for (int i = 0; i < kNumKeys; i++) {
+        keys.push_back(BSON("" << (i % 10) << "" << std::string(16, 'a' + i % 26) << ""
+                               << static_cast<double>(i)));
+    }
+    const BSONObj pattern = BSON("a" << 1 << "b" << -1 << "c" << 1);
+    const Ordering ordering = Ordering::make(pattern);
+
+    long long sum = 0;
+    Timer patternTimer;
+    for (int pass = 0; pass < kNumPasses; pass++) {
+        for (int i = 1; i < kNumKeys; i++) {
+            sum += keys[i].woCompare(keys[i - 1], pattern, false) < 0;
+        }
+    }
+    long long patternMicros = patternTimer.micros();
+
+    Timer orderingTimer;
+    for (int pass = 0; pass < kNumPasses; pass++) {
+        for (int i = 1; i < kNumKeys; i++) {
+            sum -= keys[i].woCompare(keys[i - 1], ordering, false) < 0;
+        }
+    }
+    long long orderingMicros = orderingTimer.micros();
+
+    ASSERT_EQ(0, sum);
+    log() << "woCompare of " << kNumKeys * kNumPasses << " key pairs: " << patternMicros
+          << "us with a key pattern, " << orderingMicros << "us with an Ordering";
+}
+
 }  // unnamed namespace
@@ -27,9 +27,9 @@
  *    then also delete it in the license file.
  */
 
+#include <boost/container/small_vector.hpp>
 #include <cstring>
 #include <limits>
-#include <vector>
 
 #include "mongo/base/data_view.h"
 #include "mongo/bson/bson_depth.h"
@@ -317,8 +317,9 @@ Status validateElementInfo(Buffer* buffer,
 }
 
 Status validateBSONIterative(Buffer* buffer) {
-    std::vector<ValidationObjectFrame> frames;
-    frames.reserve(16);
+    // Every incoming document is validated, so the frames of all but deeply nested documents are
+    // kept on the stack rather than allocated for each one.
+    boost::container::small_vector<ValidationObjectFrame, 16> frames;
     ValidationObjectFrame* curr = NULL;
     ValidationState::State state = ValidationState::BeginObj;
 
@@ -345,25 +346,30 @@ Status validateBSONIterative(Buffer* buffer) {
             // fall through
             case ValidationState::WithinObj: {
                 const bool atTopLevel = frames.size() == 1;
-                // check if we've finished validating idElem and are at start of next element.
-                if (atTopLevel && idElemStartPos) {
-                    idElem = BSONElement(buffer->getBasePtr() + idElemStartPos);
-                    buffer->setIdElem(idElem);
-                    idElemStartPos = 0;
-                }
-
-                const uint64_t elemStartPos = buffer->position();
                 ValidationState::State nextState = state;
-                StringData elemName;
-                Status status = validateElementInfo(buffer, &nextState, idElem, &elemName);
-                if (!status.isOK())
-                    return status;
 
-                // we've already validated that fieldname is safe to access as long as we aren't
-                // at the end of the object, since EOO doesn't have a fieldname.
-                if (nextState != ValidationState::EndObj && idElem.eoo() && atTopLevel) {
-                    if (elemName == "_id") {
-                        idElemStartPos = elemStartPos;
+                // Validate the elements of this object until one begins a nested object or this
+                // object ends, without returning to the state machine for each element.
+                while (nextState == ValidationState::WithinObj) {
+                    // check if we've finished validating idElem and are at start of next element.
+                    if (atTopLevel && idElemStartPos) {
+                        idElem = BSONElement(buffer->getBasePtr() + idElemStartPos);
+                        buffer->setIdElem(idElem);
+                        idElemStartPos = 0;
+                    }
+
+                    const uint64_t elemStartPos = buffer->position();
+                    StringData elemName;
+                    Status status = validateElementInfo(buffer, &nextState, idElem, &elemName);
+                    if (!status.isOK())
+                        return status;
+
+                    // we've already validated that fieldname is safe to access as long as we
+                    // aren't at the end of the object, since EOO doesn't have a fieldname.
+                    if (nextState != ValidationState::EndObj && idElem.eoo() && atTopLevel) {
+                        if (elemName == "_id") {
+                            idElemStartPos = elemStartPos;
+                        }
                     }
                 }
 
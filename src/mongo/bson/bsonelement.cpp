@@ -397,11 +397,16 @@ std::vector<BSONElement> BSONElement::Array() const {
 int BSONElement::woCompare(const BSONElement& e,
                            bool considerFieldName,
                            const StringData::ComparatorInterface* comparator) const {
-    int lt = (int)canonicalType();
-    int rt = (int)e.canonicalType();
-    int x = lt - rt;
-    if (x != 0 && (!isNumber() || !e.isNumber()))
-        return x;
+    int x;
+    // Elements of the same type always share a canonical type, so only mixed-type comparisons need
+    // to look up where each type falls in the sort order.
+    if (type() != e.type()) {
+        int lt = (int)canonicalType();
+        int rt = (int)e.canonicalType();
+        x = lt - rt;
+        if (x != 0 && (!isNumber() || !e.isNumber()))
+            return x;
+    }
     if (considerFieldName) {
         x = strcmp(fieldName(), e.fieldName());
         if (x != 0)
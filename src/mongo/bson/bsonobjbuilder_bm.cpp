@@ -0,0 +1,143 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/unittest/benchmark.h"
+
+namespace mongo {
+namespace {
+
+using unittest::benchmarkDoNotOptimize;
+
+const char* const kFieldNames[] = {"a", "b", "c", "d", "e", "f", "g", "h", "i", "j"};
+const int kNumFields = sizeof(kFieldNames) / sizeof(kFieldNames[0]);
+
+BSONObj makeMixedDocument() {
+    BSONObjBuilder bob;
+    bob.append("_id", OID::gen());
+    bob.append("int", 1);
+    bob.append("long", 1LL << 40);
+    bob.append("double", 3.14);
+    bob.append("string", "a string of moderate length");
+    bob.append("date", Date_t::fromMillisSinceEpoch(1000));
+    {
+        BSONObjBuilder sub(bob.subobjStart("subobj"));
+        sub.append("x", 1);
+        sub.append("y", "two");
+    }
+    {
+        BSONArrayBuilder arr(bob.subarrayStart("array"));
+        for (int i = 0; i < 5; ++i) {
+            arr.append(i);
+        }
+    }
+    return bob.obj();
+}
+
+BENCHMARK(BSONObjBuilder, AppendInts) {
+    long long bytes = 0;
+    while (state.keepRunning()) {
+        BSONObjBuilder bob;
+        for (int i = 0; i < kNumFields; ++i) {
+            bob.append(kFieldNames[i], i);
+        }
+        BSONObj obj = bob.done();
+        bytes += obj.objsize();
+        benchmarkDoNotOptimize(obj);
+    }
+    state.setItemsProcessed(state.iterations() * kNumFields);
+    state.setBytesProcessed(bytes);
+}
+
+BENCHMARK(BSONObjBuilder, AppendStrings) {
+    const std::string value(64, 'x');
+    long long bytes = 0;
+    while (state.keepRunning()) {
+        BSONObjBuilder bob;
+        for (int i = 0; i < kNumFields; ++i) {
+            bob.append(kFieldNames[i], value);
+        }
+        BSONObj obj = bob.done();
+        bytes += obj.objsize();
+        benchmarkDoNotOptimize(obj);
+    }
+    state.setItemsProcessed(state.iterations() * kNumFields);
+    state.setBytesProcessed(bytes);
+}
+
+BENCHMARK(BSONObjBuilder, MixedDocument) {
+    long long bytes = 0;
+    while (state.keepRunning()) {
+        BSONObj obj = makeMixedDocument();
+        bytes += obj.objsize();
+        benchmarkDoNotOptimize(obj);
+    }
+    state.setBytesProcessed(bytes);
+}
+
+BENCHMARK(BSONObjBuilder, AppendElements) {
+    const BSONObj source = makeMixedDocument();
+    while (state.keepRunning()) {
+        BSONObjBuilder bob;
+        bob.appendElements(source);
+        benchmarkDoNotOptimize(bob.done());
+    }
+    state.setBytesProcessed(state.iterations() * source.objsize());
+}
+
+BENCHMARK(BSONObj, IterateFields) {
+    const BSONObj obj = makeMixedDocument();
+    while (state.keepRunning()) {
+        int count = 0;
+        for (auto&& elem : obj) {
+            count += elem.size();
+        }
+        benchmarkDoNotOptimize(count);
+    }
+    state.setBytesProcessed(state.iterations() * obj.objsize());
+}
+
+BENCHMARK(BSONObj, GetLastField) {
+    const BSONObj obj = makeMixedDocument();
+    while (state.keepRunning()) {
+        benchmarkDoNotOptimize(obj["array"]);
+    }
+}
+
+BENCHMARK(BSONObj, WoCompare) {
+    const BSONObj lhs = makeMixedDocument();
+    const BSONObj rhs = makeMixedDocument();
+    while (state.keepRunning()) {
+        benchmarkDoNotOptimize(lhs.woCompare(rhs));
+    }
+}
+
+}  // namespace
+}  // namespace mongo
@@ -65,8 +65,6 @@ enum {
     ID_RESERVE_SIZE = 64,
     PAT_RESERVE_SIZE = 4096,
     OPT_RESERVE_SIZE = 64,
-    FIELD_RESERVE_SIZE = 4096,
-    STRINGVAL_RESERVE_SIZE = 4096,
     BINDATA_RESERVE_SIZE = 4096,
     BINDATATYPE_RESERVE_SIZE = 4096,
     NS_RESERVE_SIZE = 64,
@@ -151,13 +149,13 @@ Status JParse::value(StringData fieldName, BSONObjBuilder& builder) {
             return ret;
         }
     } else if (peekToken(DOUBLEQUOTE) || peekToken(SINGLEQUOTE)) {
-        std::string valueString;
-        valueString.reserve(STRINGVAL_RESERVE_SIZE);
-        Status ret = quotedString(&valueString);
+        // String values are appended as soon as they are read, so they can all share one buffer.
+        _stringValue.clear();
+        Status ret = quotedString(&_stringValue);
         if (ret != Status::OK()) {
             return ret;
         }
-        builder.append(fieldName, valueString);
+        builder.append(fieldName, _stringValue);
     } else if (readToken("true")) {
         builder.append(fieldName, true);
     } else if (readToken("false")) {
@@ -201,8 +199,9 @@ Status JParse::object(StringData fieldName, BSONObjBuilder& builder, bool subObj
     }
 
     // Special object
+    // Field names are mostly short enough for std::string to hold without allocating, so they are
+    // not given a reservation.
     std::string firstField;
-    firstField.reserve(FIELD_RESERVE_SIZE);
     Status ret = field(&firstField);
     if (ret != Status::OK()) {
         return ret;
@@ -314,9 +313,9 @@ Status JParse::object(StringData fieldName, BSONObjBuilder& builder, bool subObj
         if (valueRet != Status::OK()) {
             return valueRet;
         }
+        std::string fieldName;
         while (readToken(COMMA)) {
-            std::string fieldName;
-            fieldName.reserve(FIELD_RESERVE_SIZE);
+            fieldName.clear();
             Status fieldRet = field(&fieldName);
             if (fieldRet != Status::OK()) {
                 return fieldRet;
@@ -429,7 +428,6 @@ Status JParse::dateObject(StringData fieldName, BSONObjBuilder& builder) {
         date = dateRet.getValue();
     } else if (readToken(LBRACE)) {
         std::string fieldName;
-        fieldName.reserve(FIELD_RESERVE_SIZE);
         Status ret = field(&fieldName);
         if (ret != Status::OK()) {
             return ret;
@@ -1152,10 +1150,7 @@ Status JParse::chars(std::string* result, const char* terminalSet, const char* a
                     }
                     unsigned char first = fromHex(q);
                     unsigned char second = fromHex(q += 2);
-                    const std::string& utf8str = encodeUTF8(first, second);
-                    for (unsigned int i = 0; i < utf8str.size(); i++) {
-                        result->push_back(utf8str[i]);
-                    }
+                    encodeUTF8(first, second, result);
                     ++q;
                     break;
                 }
@@ -1184,7 +1179,13 @@ Status JParse::chars(std::string* result, const char* terminalSet, const char* a
             }
             ++q;
         } else {
-            result->push_back(*q++);
+            // Copy the run of characters up to the next one which needs checking in one go.
+            const char* run = q++;
+            while (q < _input_end && *q != '\\' && !(0x00 <= *q && *q <= 0x1F) &&
+                   !match(*q, terminalSet) && (allowedSet == NULL || match(*q, allowedSet))) {
+                ++q;
+            }
+            result->append(run, q - run);
         }
     }
     if (q < _input_end) {
@@ -1194,19 +1195,17 @@ Status JParse::chars(std::string* result, const char* terminalSet, const char* a
     return parseError("Unexpected end of input");
 }
 
-std::string JParse::encodeUTF8(unsigned char first, unsigned char second) const {
-    std::ostringstream oss;
+void JParse::encodeUTF8(unsigned char first, unsigned char second, std::string* result) const {
     if (first == 0 && second < 0x80) {
-        oss << second;
+        result->push_back(second);
     } else if (first < 0x08) {
-        oss << char(0xc0 | (first << 2 | second >> 6));
-        oss << char(0x80 | (~0xc0 & second));
+        result->push_back(char(0xc0 | (first << 2 | second >> 6)));
+        result->push_back(char(0x80 | (~0xc0 & second)));
     } else {
-        oss << char(0xe0 | (first >> 4));
-        oss << char(0x80 | (~0xc0 & (first << 2 | second >> 6)));
-        oss << char(0x80 | (~0xc0 & second));
+        result->push_back(char(0xe0 | (first >> 4)));
+        result->push_back(char(0x80 | (~0xc0 & (first << 2 | second >> 6))));
+        result->push_back(char(0x80 | (~0xc0 & second)));
     }
-    return oss.str();
 }
 
 inline bool JParse::peekToken(const char* token) {
@@ -1246,7 +1245,6 @@ bool JParse::readTokenImpl(const char* token, bool advance) {
 bool JParse::readField(StringData expectedField) {
     MONGO_JSON_DEBUG("expectedField: " << expectedField);
     std::string nextField;
-    nextField.reserve(FIELD_RESERVE_SIZE);
     Status ret = field(&nextField);
     if (ret != Status::OK()) {
         return false;
@@ -412,12 +412,11 @@ private:
     Status chars(std::string* result, const char* terminalSet, const char* allowedSet = NULL);
 
     /**
-     * Converts the two byte Unicode code point to its UTF8 character
-     * encoding representation.  This function returns a std::string because
-     * UTF8 encodings for code points from 0x0000 to 0xFFFF can range
-     * from one to three characters.
+     * Appends the UTF8 character encoding representation of the two byte
+     * Unicode code point to result.  UTF8 encodings for code points from
+     * 0x0000 to 0xFFFF can range from one to three characters.
      */
-    std::string encodeUTF8(unsigned char first, unsigned char second) const;
+    void encodeUTF8(unsigned char first, unsigned char second, std::string* result) const;
 
     /**
      * @return true if the given token matches the next non whitespace
@@ -492,6 +491,12 @@ private:
     const char* const _buf;
     const char* _input;
     const char* const _input_end;
+
+    /*
+     * Holds each string value while it is appended to its builder, so that
+     * string values do not each allocate a buffer.
+     */
+    std::string _stringValue;
 };
 
 }  // namespace mongo
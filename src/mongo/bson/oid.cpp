@@ -60,12 +60,19 @@ MONGO_INITIALIZER_GENERAL(OIDGeneration, MONGO_NO_PREREQUISITES, ("default"))
 }
 
 OID::Increment OID::Increment::next() {
-    uint64_t nextCtr = counter->fetchAndAdd(1);
+    return fromCounter(reserve(1));
+}
+
+uint32_t OID::Increment::reserve(uint32_t count) {
+    return counter->fetchAndAdd(count);
+}
+
+OID::Increment OID::Increment::fromCounter(uint32_t counterValue) {
     OID::Increment incr;
 
-    incr.bytes[0] = uint8_t(nextCtr >> 16);
-    incr.bytes[1] = uint8_t(nextCtr >> 8);
-    incr.bytes[2] = uint8_t(nextCtr);
+    incr.bytes[0] = uint8_t(counterValue >> 16);
+    incr.bytes[1] = uint8_t(counterValue >> 8);
+    incr.bytes[2] = uint8_t(counterValue);
 
     return incr;
 }
@@ -139,6 +146,21 @@ void OID::init() {
     setIncrement(Increment::next());
 }
 
+void OID::gen(OID* oids, size_t count) {
+    if (count == 0) {
+        return;
+    }
+
+    const Timestamp now = time(0);
+    const uint32_t firstCounterValue = Increment::reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        // each set* method handles endianness
+        oids[i].setTimestamp(now);
+        oids[i].setInstanceUnique(_instanceUnique);
+        oids[i].setIncrement(Increment::fromCounter(firstCounterValue + i));
+    }
+}
+
 void OID::initFromTermNumber(int64_t term) {
     // Each set* method handles endianness.
     // Set max timestamp because the drivers compare ElectionId's to determine valid new primaries,
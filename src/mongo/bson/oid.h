@@ -114,6 +114,13 @@ public:
         return o;
     }
 
+    /**
+     * Sets 'count' OIDs starting at 'oids' to new values, as if each had been produced by gen().
+     * The clock is read once and the increments are reserved from the shared counter as a single
+     * block, which makes this much cheaper than calling gen() in a loop.
+     */
+    static void gen(OID* oids, size_t count);
+
     MONGO_STATIC_ASSERT_MSG(sizeof(int64_t) == kInstanceUniqueSize + kIncrementSize,
                             "size of term must be size of instance unique + increment");
 
@@ -188,6 +195,14 @@ public:
     struct Increment {
     public:
         static Increment next();
+
+        /**
+         * Reserves 'count' consecutive increments, returning the counter value of the first;
+         * fromCounter() turns each reserved value into an Increment.
+         */
+        static uint32_t reserve(uint32_t count);
+        static Increment fromCounter(uint32_t counterValue);
+
         uint8_t bytes[kIncrementSize];
     };
 
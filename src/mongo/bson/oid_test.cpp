@@ -57,6 +57,28 @@ TEST(Increasing, Simple) {
     ASSERT_TRUE(o1 < o2);
 }
 
+TEST(GenBatch, Simple) {
+    OID single = OID::gen();
+    OID batch[100];
+    OID::gen(batch, 100);
+
+    for (size_t i = 0; i < 100; ++i) {
+        ASSERT_TRUE(batch[i].isSet());
+        ASSERT_TRUE(std::memcmp(single.getInstanceUnique().bytes,
+                                batch[i].getInstanceUnique().bytes,
+                                OID::kInstanceUniqueSize) == 0);
+        ASSERT_NOT_EQUALS(single, batch[i]);
+        for (size_t j = 0; j < i; ++j) {
+            ASSERT_NOT_EQUALS(batch[j], batch[i]);
+        }
+    }
+
+    // Generating nothing leaves the destination alone.
+    OID untouched;
+    OID::gen(&untouched, 0);
+    ASSERT_FALSE(untouched.isSet());
+}
+
 TEST(IsSet, Simple) {
     OID o;
     ASSERT_FALSE(o.isSet());
@@ -47,6 +47,7 @@
 #include "mongo/platform/decimal128.h"
 #include "mongo/stdx/type_traits.h"
 #include "mongo/util/allocator.h"
+#include "mongo/util/arena.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/shared_buffer.h"
 
@@ -147,6 +148,45 @@ private:
     void* _ptr = _buf;
 };
 
+/**
+ * Allocates the buffer from an Arena, which releases it along with everything else it holds: the
+ * buffer is never freed individually. Like StackAllocator, it cannot release() its buffer.
+ */
+class ArenaAllocator {
+    MONGO_DISALLOW_COPYING(ArenaAllocator);
+
+public:
+    explicit ArenaAllocator(Arena* arena) : _arena(arena) {}
+
+    ArenaAllocator(ArenaAllocator&&) = default;
+    ArenaAllocator& operator=(ArenaAllocator&&) = default;
+
+    void malloc(size_t sz) {
+        _ptr = static_cast<char*>(_arena->allocate(sz));
+        _size = sz;
+    }
+    void realloc(size_t sz) {
+        _ptr = static_cast<char*>(_arena->reallocate(_ptr, _size, sz));
+        _size = sz;
+    }
+    void free() {
+        _ptr = nullptr;
+        _size = 0;
+    }
+
+    // Not supported on this allocator.
+    void release() = delete;
+
+    char* get() const {
+        return _ptr;
+    }
+
+private:
+    Arena* _arena;
+    char* _ptr = nullptr;
+    size_t _size = 0;
+};
+
 template <class BufferAllocator>
 class _BufBuilder {
 public:
@@ -158,6 +198,15 @@ public:
         reservedBytes = 0;
     }
 
+    _BufBuilder(BufferAllocator&& allocator, int initsize)
+        : _buf(std::move(allocator)), size(initsize) {
+        if (size > 0) {
+            _buf.malloc(size);
+        }
+        l = 0;
+        reservedBytes = 0;
+    }
+
     void kill() {
         _buf.free();
     }
@@ -361,6 +410,18 @@ public:
 };
 MONGO_STATIC_ASSERT(!std::is_move_constructible<StackBufBuilder>::value);
 
+/** The ArenaBufBuilder builds into memory drawn from 'arena', which must outlive anything pointing
+      into the buffer, such as a BSONObj viewing it. The buffer only grows in place while it is the
+      arena's latest allocation, otherwise the old space stays in the arena until it is destroyed,
+      so this suits builders whose results are short-lived and whose final size is known up front.
+*/
+class ArenaBufBuilder : public _BufBuilder<ArenaAllocator> {
+public:
+    explicit ArenaBufBuilder(Arena* arena, int initsize = 512)
+        : _BufBuilder<ArenaAllocator>(ArenaAllocator(arena), initsize) {}
+    void release() = delete;  // not allowed. not implemented.
+};
+
 /** std::stringstream deals with locale so this is a lot faster than std::stringstream for UTF8 */
 template <typename Allocator>
 class StringBuilderImpl {
@@ -82,4 +82,19 @@ TEST(Builder, StackAllocatorShouldNotLeak) {
     stackAlloc.malloc(StackAllocator::SZ + 1);  // Force heap allocation.
     // Let the builder go out of scope. If this leaks, it will trip the ASAN leak detector.
 }
+
+TEST(Builder, ArenaBufBuilderGrowsWithinArena) {
+    Arena arena;
+    ArenaBufBuilder builder(&arena, 16);
+    for (int i = 0; i < 10000; ++i) {
+        builder.appendNum(i);
+    }
+    ASSERT_EQ(10000 * static_cast<int>(sizeof(int)), builder.len());
+    for (int i = 0; i < 10000; ++i) {
+        int value;
+        memcpy(&value, builder.buf() + i * sizeof(int), sizeof(int));
+        ASSERT_EQ(i, value);
+    }
+    ASSERT_GTE(arena.bytesReserved(), static_cast<size_t>(builder.len()));
+}
 }
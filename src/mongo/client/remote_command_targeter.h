@@ -92,6 +92,14 @@ public:
         return findHostWithMaxWait(readPref, Milliseconds::zero());
     }
 
+    /**
+     * Finds a host other than 'excluded' which also matches readPref, to send a hedged duplicate
+     * of a read to. Never blocks or performs networking; returns HostNotFound if no such host is
+     * currently known.
+     */
+    virtual StatusWith<HostAndPort> findHedgeHost(const ReadPreferenceSetting& readPref,
+                                                  const HostAndPort& excluded) = 0;
+
     /**
      * Reports to the targeter that a 'status' indicating a not master error was received when
      * communicating with 'host', and so it should update its bookkeeping to avoid giving out the
@@ -57,6 +57,11 @@ public:
         return _mock->findHostWithMaxWait(readPref, maxWait);
     }
 
+    StatusWith<HostAndPort> findHedgeHost(const ReadPreferenceSetting& readPref,
+                                          const HostAndPort& excluded) override {
+        return _mock->findHedgeHost(readPref, excluded);
+    }
+
     void markHostNotMaster(const HostAndPort& host, const Status& status) override {
         _mock->markHostNotMaster(host, status);
     }
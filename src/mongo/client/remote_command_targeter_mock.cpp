@@ -36,7 +36,8 @@
 namespace mongo {
 
 RemoteCommandTargeterMock::RemoteCommandTargeterMock()
-    : _findHostReturnValue(Status(ErrorCodes::InternalError, "No return value set")) {}
+    : _findHostReturnValue(Status(ErrorCodes::InternalError, "No return value set")),
+      _findHedgeHostReturnValue(Status(ErrorCodes::HostNotFound, "No hedge host set")) {}
 
 RemoteCommandTargeterMock::~RemoteCommandTargeterMock() = default;
 
@@ -63,6 +64,11 @@ StatusWith<HostAndPort> RemoteCommandTargeterMock::findHostWithMaxWait(
     return _findHostReturnValue;
 }
 
+StatusWith<HostAndPort> RemoteCommandTargeterMock::findHedgeHost(
+    const ReadPreferenceSetting& readPref, const HostAndPort& excluded) {
+    return _findHedgeHostReturnValue;
+}
+
 void RemoteCommandTargeterMock::markHostNotMaster(const HostAndPort& host, const Status& status) {}
 
 void RemoteCommandTargeterMock::markHostUnreachable(const HostAndPort& host, const Status& status) {
@@ -76,4 +82,8 @@ void RemoteCommandTargeterMock::setFindHostReturnValue(StatusWith<HostAndPort> r
     _findHostReturnValue = std::move(returnValue);
 }
 
+void RemoteCommandTargeterMock::setFindHedgeHostReturnValue(StatusWith<HostAndPort> returnValue) {
+    _findHedgeHostReturnValue = std::move(returnValue);
+}
+
 }  // namespace mongo
@@ -60,6 +60,13 @@ public:
     StatusWith<HostAndPort> findHost(OperationContext* opCtx,
                                      const ReadPreferenceSetting& readPref) override;
 
+    /**
+     * Returns the return value last set by setFindHedgeHostReturnValue.
+     * Returns ErrorCodes::HostNotFound if setFindHedgeHostReturnValue was never called.
+     */
+    StatusWith<HostAndPort> findHedgeHost(const ReadPreferenceSetting& readPref,
+                                          const HostAndPort& excluded) override;
+
     /**
      * No-op for the mock.
      */
@@ -80,9 +87,15 @@ public:
      */
     void setFindHostReturnValue(StatusWith<HostAndPort> returnValue);
 
+    /**
+     * Sets the return value for the next call to findHedgeHost.
+     */
+    void setFindHedgeHostReturnValue(StatusWith<HostAndPort> returnValue);
+
 private:
     ConnectionString _connectionStringReturnValue;
     StatusWith<HostAndPort> _findHostReturnValue;
+    StatusWith<HostAndPort> _findHedgeHostReturnValue;
 };
 
 }  // namespace mongo
@@ -88,6 +88,20 @@ StatusWith<HostAndPort> RemoteCommandTargeterRS::findHost(OperationContext* opCt
     }
 }
 
+StatusWith<HostAndPort> RemoteCommandTargeterRS::findHedgeHost(
+    const ReadPreferenceSetting& readPref, const HostAndPort& excluded) {
+    invariant(_rsMonitor);
+
+    auto host = _rsMonitor->getHedgeHost(readPref, excluded);
+    if (host.empty()) {
+        return Status(ErrorCodes::HostNotFound,
+                      str::stream() << "No other host in replica set " << _rsName
+                                    << " matches read preference "
+                                    << readPref.toString());
+    }
+    return host;
+}
+
 void RemoteCommandTargeterRS::markHostNotMaster(const HostAndPort& host, const Status& status) {
     invariant(_rsMonitor);
 
@@ -52,6 +52,11 @@ StatusWith<HostAndPort> RemoteCommandTargeterStandalone::findHost(
     return _hostAndPort;
 }
 
+StatusWith<HostAndPort> RemoteCommandTargeterStandalone::findHedgeHost(
+    const ReadPreferenceSetting& readPref, const HostAndPort& excluded) {
+    return Status(ErrorCodes::HostNotFound, "A standalone host has no other host to hedge to");
+}
+
 void RemoteCommandTargeterStandalone::markHostNotMaster(const HostAndPort& host,
                                                         const Status& status) {
     dassert(host == _hostAndPort);
@@ -42,6 +42,7 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/repl/bson_extract_optime.h"
 #include "mongo/db/server_options.h"
+#include "mongo/executor/connection_pool_stats.h"
 #include "mongo/s/grid.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
@@ -110,6 +111,38 @@ bool compareLatencies(const Node* lhs, const Node* rhs) {
     return lhs->latencyMicros < rhs->latencyMicros;
 }
 
+/**
+ * Power of two choices: of two distinct random nodes, returns the one with the lower product of
+ * ping latency and requests this process has in flight to it through executor::ConnectionPool.
+ * While neither has requests in flight, as is always the case for processes which only reach the
+ * set through DBClient connections, this is a uniform random choice.
+ */
+const Node* pickLessLoadedNode(const std::vector<const Node*>& nodes, PseudoRandom& rand) {
+    const int32_t firstIndex = rand.nextInt32(nodes.size());
+    const Node* first = nodes[firstIndex];
+    if (nodes.size() == 1) {
+        return first;
+    }
+
+    int32_t secondIndex = rand.nextInt32(nodes.size() - 1);
+    if (secondIndex >= firstIndex) {
+        ++secondIndex;
+    }
+    const Node* second = nodes[secondIndex];
+
+    const auto firstInFlight = executor::InUseConnectionsByHost::get(first->host);
+    const auto secondInFlight = executor::InUseConnectionsByHost::get(second->host);
+    if (!firstInFlight && !secondInFlight) {
+        return first;
+    }
+
+    // Doubles, since unknown latencies are the maximum int64_t.
+    auto score = [](const Node* node, int64_t inFlight) {
+        return (static_cast<double>(node->latencyMicros) + 1) * (inFlight + 1);
+    };
+    return score(second, secondInFlight) < score(first, firstInFlight) ? second : first;
+}
+
 bool hostsEqual(const Node& lhs, const HostAndPort& rhs) {
     return lhs.host == rhs;
 }
@@ -305,6 +338,16 @@ StatusWith<HostAndPort> ReplicaSetMonitor::getHostOrRefresh(const ReadPreference
                                 << getName());
 }
 
+HostAndPort ReplicaSetMonitor::getHedgeHost(const ReadPreferenceSetting& criteria,
+                                            const HostAndPort& excluded) {
+    if (_isRemovedFromManager.load()) {
+        return HostAndPort();
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+    return _state->getHedgeHost(criteria, excluded);
+}
+
 HostAndPort ReplicaSetMonitor::getMasterOrUassert() {
     return uassertStatusOK(getHostOrRefresh(kPrimaryOnlyReadPreference));
 }
@@ -1142,13 +1185,14 @@ HostAndPort SetState::getMatchingHost(const ReadPreferenceSetting& criteria) con
                     }
                 }
 
-                // of the remaining nodes, pick one at random (or use round-robin)
+                // of the remaining nodes, pick the less loaded of two random ones (or use
+                // round-robin)
                 if (ReplicaSetMonitor::useDeterministicHostSelection) {
                     // only in tests
                     return matchingNodes[roundRobin++ % matchingNodes.size()]->host;
                 } else {
                     // normal case
-                    return matchingNodes[rand.nextInt32(matchingNodes.size())]->host;
+                    return pickLessLoadedNode(matchingNodes, rand)->host;
                 };
             }
 
@@ -1161,6 +1205,60 @@ HostAndPort SetState::getMatchingHost(const ReadPreferenceSetting& criteria) con
     }
 }
 
+HostAndPort SetState::getHedgeHost(const ReadPreferenceSetting& criteria,
+                                   const HostAndPort& excluded) const {
+    // Staleness and causal bounds are only enforced by getMatchingHost.
+    if (criteria.maxStalenessSeconds.count() || !criteria.minOpTime.isNull()) {
+        return HostAndPort();
+    }
+
+    switch (criteria.pref) {
+        case ReadPreference::SecondaryPreferred: {
+            HostAndPort out = getHedgeHost(
+                ReadPreferenceSetting(ReadPreference::SecondaryOnly, criteria.tags), excluded);
+            if (!out.empty())
+                return out;
+            return getHedgeHost(ReadPreferenceSetting(ReadPreference::PrimaryOnly, criteria.tags),
+                                excluded);
+        }
+
+        case ReadPreference::PrimaryOnly: {
+            Nodes::const_iterator it = std::find_if(nodes.begin(), nodes.end(), isMaster);
+            if (it == nodes.end() || it->host == excluded)
+                return HostAndPort();
+            return it->host;
+        }
+
+        case ReadPreference::SecondaryOnly:
+        case ReadPreference::Nearest: {
+            BSONForEach(tagElem, criteria.tags.getTagBSON()) {
+                uassert(40643, "Tags should be a BSON object", tagElem.isABSONObj());
+                BSONObj tag = tagElem.Obj();
+
+                const Node* best = nullptr;
+                for (const auto& node : nodes) {
+                    if (node.host == excluded || !node.matches(criteria.pref) ||
+                        !node.matches(tag)) {
+                        continue;
+                    }
+                    if (!best || compareLatencies(&node, best)) {
+                        best = &node;
+                    }
+                }
+
+                if (best) {
+                    return best->host;
+                }
+            }
+
+            return HostAndPort();
+        }
+
+        default:
+            return HostAndPort();
+    }
+}
+
 Node* SetState::findNode(const HostAndPort& host) {
     const Nodes::iterator it = std::lower_bound(nodes.begin(), nodes.end(), host, compareHosts);
     if (it == nodes.end() || it->host != host)
@@ -93,6 +93,16 @@ public:
     StatusWith<HostAndPort> getHostOrRefresh(const ReadPreferenceSetting& readPref,
                                              Milliseconds maxWait = kDefaultFindHostTimeout);
 
+    /**
+     * Returns the lowest latency host, other than 'excluded', which also matches the given read
+     * preference, or an empty HostAndPort if the set has no such host. Only consults the current
+     * view of the set and never refreshes it.
+     *
+     * Intended for choosing the destination of a hedged read, so read preferences which carry
+     * maxStalenessSeconds or a minOpTime never yield a host.
+     */
+    HostAndPort getHedgeHost(const ReadPreferenceSetting& readPref, const HostAndPort& excluded);
+
     /**
      * Returns the host we think is the current master or uasserts.
      *
@@ -153,6 +153,16 @@ public:
      */
     HostAndPort getMatchingHost(const ReadPreferenceSetting& criteria) const;
 
+    /**
+     * Returns the lowest latency host other than 'excluded' which matches the mode and tags of
+     * 'criteria', or an empty host if there is none. Used to pick the target of a hedged read, so
+     * criteria carrying maxStalenessSeconds or a minOpTime never match.
+     *
+     * Note: Uses only local data and does not go over the network.
+     */
+    HostAndPort getHedgeHost(const ReadPreferenceSetting& criteria,
+                             const HostAndPort& excluded) const;
+
     /**
      * Returns the Node with the given host, or NULL if no Node has that host.
      */
@@ -1912,5 +1912,95 @@ TEST(ReplicaSetMonitor, MinOpTimeIgnored) {
     ASSERT_EQUALS(notStale.host(), "c");
 }
 
+/**
+ * Hedging picks the lowest latency matching host other than the excluded one
+ */
+TEST(ReplicaSetMonitor, HedgeHostPicksLowestLatencyOtherHost) {
+    SetStatePtr state = std::make_shared<SetState>("name", basicSeedsSet);
+    Refresher refresher(state);
+
+    BSONArray hosts = BSON_ARRAY("a"
+                                 << "b"
+                                 << "c");
+
+    // mock all replies
+    NextStep ns = refresher.getNextStep();
+    while (ns.step == NextStep::CONTACT_HOST) {
+        bool primary = ns.host.host() == "a";
+        int64_t latencyMicros = ns.host.host() == "a" ? 300 : ns.host.host() == "b" ? 100 : 200;
+        BSONObj bson = BSON("setName"
+                            << "name"
+                            << "ismaster"
+                            << primary
+                            << "secondary"
+                            << !primary
+                            << "hosts"
+                            << hosts
+                            << "ok"
+                            << true);
+        refresher.receivedIsMaster(ns.host, latencyMicros, bson);
+        ns = refresher.getNextStep();
+    }
+
+    // Ensure that we have heard from all hosts and scan is done
+    ASSERT_EQUALS(ns.step, NextStep::DONE);
+
+    ReadPreferenceSetting nearest(ReadPreference::Nearest, TagSet());
+    ASSERT_EQUALS(state->getHedgeHost(nearest, HostAndPort("b")).host(), "c");
+    ASSERT_EQUALS(state->getHedgeHost(nearest, HostAndPort("c")).host(), "b");
+
+    ReadPreferenceSetting secPref(ReadPreference::SecondaryPreferred, TagSet());
+    ASSERT_EQUALS(state->getHedgeHost(secPref, HostAndPort("b")).host(), "c");
+
+    // Hedging never overrides the bounds set by a minOpTime
+    nearest.minOpTime = repl::OpTime{Timestamp{10, 10}, 10};
+    ASSERT(state->getHedgeHost(nearest, HostAndPort("b")).empty());
+}
+
+/**
+ * Hedging a secondaryPreferred read falls back to the primary if it is the only other host up
+ */
+TEST(ReplicaSetMonitor, HedgeHostSecPrefFallsBackToPrimary) {
+    SetStatePtr state = std::make_shared<SetState>("name", basicSeedsSet);
+    Refresher refresher(state);
+
+    BSONArray hosts = BSON_ARRAY("a"
+                                 << "b"
+                                 << "c");
+
+    // mock all replies
+    NextStep ns = refresher.getNextStep();
+    while (ns.step == NextStep::CONTACT_HOST) {
+        if (ns.host.host() == "c") {
+            refresher.failedHost(ns.host, {ErrorCodes::InternalError, "Test error"});
+            ns = refresher.getNextStep();
+            continue;
+        }
+
+        bool primary = ns.host.host() == "a";
+        BSONObj bson = BSON("setName"
+                            << "name"
+                            << "ismaster"
+                            << primary
+                            << "secondary"
+                            << !primary
+                            << "hosts"
+                            << hosts
+                            << "ok"
+                            << true);
+        refresher.receivedIsMaster(ns.host, -1, bson);
+        ns = refresher.getNextStep();
+    }
+
+    // Ensure that we have heard from all hosts and scan is done
+    ASSERT_EQUALS(ns.step, NextStep::DONE);
+
+    ReadPreferenceSetting secPref(ReadPreference::SecondaryPreferred, TagSet());
+    ASSERT_EQUALS(state->getHedgeHost(secPref, HostAndPort("b")).host(), "a");
+
+    ReadPreferenceSetting secOnly(ReadPreference::SecondaryOnly, TagSet());
+    ASSERT(state->getHedgeHost(secOnly, HostAndPort("b")).empty());
+}
+
 }  // namespace
 }  // namespace mongo
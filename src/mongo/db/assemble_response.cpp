@@ -43,18 +43,22 @@
 #include "mongo/db/introspect.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/lasterror.h"
+#include "mongo/db/operation_arena.h"
+#include "mongo/db/operation_phases.h"
 #include "mongo/db/ops/write_ops_exec.h"
 #include "mongo/db/ops/write_ops_parsers.h"
 #include "mongo/db/query/find.h"
 #include "mongo/db/run_commands.h"
 #include "mongo/db/s/sharded_connection_info.h"
 #include "mongo/db/s/sharding_state.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/stats/counters.h"
 #include "mongo/db/stats/top.h"
 #include "mongo/rpc/command_reply_builder.h"
 #include "mongo/rpc/command_request.h"
 #include "mongo/rpc/legacy_reply_builder.h"
 #include "mongo/rpc/legacy_request.h"
+#include "mongo/rpc/metadata/client_metadata_ismaster.h"
 #include "mongo/rpc/op_msg_rpc_impls.h"
 #include "mongo/s/stale_exception.h"
 #include "mongo/util/fail_point_service.h"
@@ -83,6 +87,28 @@ inline void opwrite(const Message& m) {
     }
 }
 
+// Operations of clients with one of these application names, such as batch jobs, are low priority
+// for admission into the storage engine. See Locker::setLowPriorityThrottling().
+std::vector<std::string> lowPriorityAdmissionAppNames;
+ExportedServerParameter<std::vector<std::string>, ServerParameterType::kStartupOnly>
+    lowPriorityAdmissionAppNamesSetting(ServerParameterSet::getGlobal(),
+                                        "lowPriorityAdmissionAppNames",
+                                        &lowPriorityAdmissionAppNames);
+
+bool isLowPriorityAdmissionClient(Client* client) {
+    if (lowPriorityAdmissionAppNames.empty()) {
+        return false;
+    }
+    const auto& clientMetadata = ClientMetadataIsMasterState::get(client).getClientMetadata();
+    if (!clientMetadata) {
+        return false;
+    }
+    const StringData appName = clientMetadata.get().getApplicationName();
+    return std::find(lowPriorityAdmissionAppNames.begin(),
+                     lowPriorityAdmissionAppNames.end(),
+                     appName) != lowPriorityAdmissionAppNames.end();
+}
+
 void generateLegacyQueryErrorResponse(const AssertionException* exception,
                                       const QueryMessage& queryMessage,
                                       CurOp* curop,
@@ -176,9 +202,13 @@ DbResponse receivedCommand(OperationContext* opCtx,
                               << ") for $cmd type ns - can only be 1 or -1",
                 nToReturn == 1 || nToReturn == -1);
 
-        auto request = OpMsgRequest::fromDBAndBody(legacyRequest.getDatabase(),
-                                                   legacyRequest.getCommandArgs(),
-                                                   legacyRequest.getMetadata());
+        OpMsgRequest request;
+        {
+            OperationPhases::Scope parsePhase(opCtx, OperationPhases::Phase::kParse);
+            request = OpMsgRequest::fromDBAndBody(legacyRequest.getDatabase(),
+                                                  legacyRequest.getCommandArgs(),
+                                                  legacyRequest.getMetadata());
+        }
         runCommands(opCtx, request, &builder);
 
         op->debug().iscommand = true;
@@ -186,6 +216,7 @@ DbResponse receivedCommand(OperationContext* opCtx,
         generateErrorResponse(opCtx, &builder, exception);
     }
 
+    OperationPhases::Scope responsePhase(opCtx, OperationPhases::Phase::kResponse);
     auto response = builder.done();
 
     op->debug().responseLength = response.header().dataLen();
@@ -193,6 +224,47 @@ DbResponse receivedCommand(OperationContext* opCtx,
     return {std::move(response)};
 }
 
+/**
+ * Returns the getMore that continues streaming a cursor to a client that sent a find or getMore
+ * with the exhaustAllowed flag, or an empty object if the command failed or exhausted the cursor.
+ */
+BSONObj getNextExhaustInvocation(const OpMsgRequest& request, const Message& response) {
+    if (!request.isFlagSet(OpMsg::kExhaustAllowed)) {
+        return BSONObj();
+    }
+
+    const auto commandName = request.getCommandName();
+    if (commandName != "find" && commandName != "getMore") {
+        return BSONObj();
+    }
+
+    const auto reply = OpMsg::parse(response).body;
+    const auto cursor = reply["cursor"];
+    if (!reply["ok"].trueValue() || cursor.type() != Object) {
+        return BSONObj();
+    }
+
+    const auto cursorId = cursor["id"].numberLong();
+    if (!cursorId) {
+        return BSONObj();
+    }
+
+    BSONObjBuilder nextInvocation;
+    nextInvocation.append("getMore", cursorId);
+    nextInvocation.append("collection", NamespaceString(cursor["ns"].valueStringData()).coll());
+    if (auto batchSize = request.body["batchSize"]) {
+        nextInvocation.append(batchSize);
+    }
+    if (commandName == "getMore") {
+        // Tailable awaitData cursors carry their wait time on each getMore.
+        if (auto maxTimeMS = request.body["maxTimeMS"]) {
+            nextInvocation.append(maxTimeMS);
+        }
+    }
+    nextInvocation.append("$db", request.getDatabase());
+    return nextInvocation.obj();
+}
+
 DbResponse receivedMsg(OperationContext* opCtx, Client& client, const Message& message) {
     invariant(message.operation() == dbMsg);
 
@@ -203,7 +275,10 @@ DbResponse receivedMsg(OperationContext* opCtx, Client& client, const Message& m
         // Request is validated here.
         // TODO If this fails we reply to an invalid request which isn't always safe. Unfortunately
         // tests currently rely on this. Figure out what to do.
-        request = OpMsgRequest::parse(message);
+        {
+            OperationPhases::Scope parsePhase(opCtx, OperationPhases::Phase::kParse);
+            request = OpMsgRequest::parse(message);
+        }
 
         // We construct a legacy $cmd namespace so we can fill in curOp using
         // the existing logic that existed for OP_QUERY commands
@@ -222,16 +297,27 @@ DbResponse receivedMsg(OperationContext* opCtx, Client& client, const Message& m
         generateErrorResponse(opCtx, &replyBuilder, exception);
     }
 
+    OperationPhases::Scope responsePhase(opCtx, OperationPhases::Phase::kResponse);
     auto response = replyBuilder.done();
 
     curOp->debug().responseLength = response.header().dataLen();
 
-    // TODO exhaust
     if (request.isFlagSet(OpMsg::kMoreToCome)) {
         return {};
     }
 
-    return DbResponse{std::move(response)};
+    DbResponse dbResponse{std::move(response)};
+
+    // If the client allows it, keep streaming batches from the cursor without waiting for it to
+    // ask. The service state machine runs the next getMore only once this reply has been written
+    // to the socket, so a client that stops reading pauses the cursor.
+    dbResponse.nextInvocation = getNextExhaustInvocation(request, dbResponse.response);
+    if (!dbResponse.nextInvocation.isEmpty()) {
+        curOp->debug().exhaust = true;
+        OpMsg::setFlag(&dbResponse.response, OpMsg::kMoreToCome);
+    }
+
+    return dbResponse;
 }
 
 DbResponse receivedRpc(OperationContext* opCtx, Client& client, const Message& message) {
@@ -254,10 +340,13 @@ DbResponse receivedRpc(OperationContext* opCtx, Client& client, const Message& m
             curOp->markCommand_inlock();
         }
 
-
-        auto request = OpMsgRequest::fromDBAndBody(commandRequest.getDatabase(),
-                                                   commandRequest.getCommandArgs(),
-                                                   commandRequest.getMetadata());
+        OpMsgRequest request;
+        {
+            OperationPhases::Scope parsePhase(opCtx, OperationPhases::Phase::kParse);
+            request = OpMsgRequest::fromDBAndBody(commandRequest.getDatabase(),
+                                                  commandRequest.getCommandArgs(),
+                                                  commandRequest.getMetadata());
+        }
         runCommands(opCtx, request, &replyBuilder);
 
         curOp->debug().iscommand = true;
@@ -266,6 +355,7 @@ DbResponse receivedRpc(OperationContext* opCtx, Client& client, const Message& m
         generateErrorResponse(opCtx, &replyBuilder, exception);
     }
 
+    OperationPhases::Scope responsePhase(opCtx, OperationPhases::Phase::kResponse);
     auto response = replyBuilder.done();
 
     curOp->debug().responseLength = response.header().dataLen();
@@ -532,6 +622,10 @@ DbResponse assembleResponse(OperationContext* opCtx, const Message& m, const Hos
 
         // We should not be holding any locks at this point
         invariant(!opCtx->lockState()->isLocked());
+
+        if (isLowPriorityAdmissionClient(&c)) {
+            opCtx->lockState()->setLowPriorityAdmission(true);
+        }
     }
 
     const char* ns = dbmsg.messageShouldHaveNs() ? dbmsg.getns() : NULL;
@@ -657,6 +751,9 @@ DbResponse assembleResponse(OperationContext* opCtx, const Message& m, const Hos
     if (shouldLogOpDebug || (shouldSample && debug.executionTimeMicros > logThresholdMs * 1000LL)) {
         Locker::LockerInfo lockerInfo;
         opCtx->lockState()->getLockerInfo(&lockerInfo);
+        debug.ticketQueuedMicros = lockerInfo.ticketQueuedMicros;
+        debug.phases = OperationPhases::get(opCtx);
+        debug.arenaBytes = OperationArena::get(opCtx).bytesReserved();
         log() << debug.report(&c, currentOp, lockerInfo.stats);
     }
 
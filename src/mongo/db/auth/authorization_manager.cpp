@@ -53,6 +53,7 @@
 #include "mongo/db/auth/user_name.h"
 #include "mongo/db/auth/user_name_hash.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/platform/compiler.h"
 #include "mongo/platform/unordered_map.h"
 #include "mongo/stdx/memory.h"
@@ -113,6 +114,17 @@ const int AuthorizationManager::schemaVersion26Upgrade;
 const int AuthorizationManager::schemaVersion26Final;
 const int AuthorizationManager::schemaVersion28SCRAM;
 
+namespace {
+
+// How long an out-of-date User object is served after the invalidation of the whole user cache,
+// while an up-to-date one is being read. Zero disables serving out-of-date users.
+MONGO_EXPORT_SERVER_PARAMETER(authUserCacheStaleLifetimeSecs, int, 30);
+
+// Whether all the users are acquired into the user cache on startup.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(authPreloadUserCache, bool, true);
+
+}  // namespace
+
 /**
  * Guard object for synchronizing accesses to data cached in AuthorizationManager instances.
  * This guard allows one thread to access the cache at a time, and provides an exception-safe
@@ -204,6 +216,31 @@ public:
         _lock.unlock();
     }
 
+    /**
+     * Releases the _authzManager->_cacheMutex while reading the privilege document of a single
+     * user. Unlike beginFetchPhase(), this does not prevent other guards from reading other
+     * documents meanwhile.
+     */
+    void beginUserFetch() {
+        fassert(40646, !_isThisGuardInFetchPhase);
+        _lock.unlock();
+    }
+
+    /**
+     * Reacquires the _authzManager->_cacheMutex after beginUserFetch().
+     */
+    void endUserFetch() {
+        _lock.lock();
+    }
+
+    /**
+     * Waits on 'condition', which must be signalled while holding the _authzManager->_cacheMutex.
+     */
+    void wait(stdx::condition_variable& condition) {
+        fassert(40647, !_isThisGuardInFetchPhase);
+        condition.wait(_lock);
+    }
+
     /**
      * Exits the fetch phase, reacquiring the _authzManager->_cacheMutex.
      */
@@ -255,6 +292,14 @@ AuthorizationManager::AuthorizationManager(std::unique_ptr<AuthzManagerExternalS
 }
 
 AuthorizationManager::~AuthorizationManager() {
+    for (auto&& entry : _preloadedUsers) {
+        entry.second->decrementRefCount();
+    }
+    for (auto&& entry : _staleUsers) {
+        // Stale users have been invalidated, so they are not also in the _userCache.
+        entry.second.user->decrementRefCount();
+        delete entry.second.user;
+    }
     for (unordered_map<UserName, User*>::iterator it = _userCache.begin(); it != _userCache.end();
          ++it) {
         fassert(17265, it->second != internalSecurity.user);
@@ -483,14 +528,12 @@ Status AuthorizationManager::acquireUserForInitialAuth(OperationContext* opCtx,
         return Status::OK();
     }
 
-    unordered_map<UserName, User*>::iterator it;
-
     CacheGuard guard(this, CacheGuard::fetchSynchronizationManual);
-    while ((_userCache.end() == (it = _userCache.find(userName))) &&
-           guard.otherUpdateInFetchPhase()) {
+    while (_isFetchPhaseBusy) {
         guard.wait();
     }
 
+    unordered_map<UserName, User*>::iterator it = _userCache.find(userName);
     if (it != _userCache.end()) {
         fassert(16914, it->second);
         fassert(17003, it->second->isValid());
@@ -500,34 +543,110 @@ Status AuthorizationManager::acquireUserForInitialAuth(OperationContext* opCtx,
         return Status::OK();
     }
 
-    std::unique_ptr<User> user;
+    auto fetchIt = _userFetches.find(userName);
+    if (fetchIt != _userFetches.end()) {
+        // Rather than wait for the read in progress, serve the user as it was before the last
+        // invalidation of the whole cache, if that was recent enough.
+        if (User* staleUser = _lookUpStaleUser_inlock(userName)) {
+            staleUser->incrementRefCount();
+            *acquiredUser = staleUser;
+            return Status::OK();
+        }
 
+        // Share the result of the read in progress.
+        std::shared_ptr<UserFetch> fetch = fetchIt->second;
+        ++fetch->numWaiters;
+        while (!fetch->done) {
+            guard.wait(fetch->isDone);
+        }
+        if (!fetch->status.isOK()) {
+            return fetch->status;
+        }
+        // The reader took a reference on our behalf.
+        *acquiredUser = fetch->user;
+        return Status::OK();
+    }
+
+    auto fetch = std::make_shared<UserFetch>();
+    _userFetches.emplace(userName, fetch);
+
+    std::unique_ptr<User> user;
     int authzVersion = _version;
-    guard.beginFetchPhase();
+    const OID startGeneration = _cacheGeneration;
+    guard.beginUserFetch();
+    Status status = Status::OK();
+    try {
+        status = _fetchUser(opCtx, userName, &authzVersion, &user);
+    } catch (const DBException& ex) {
+        status = ex.toStatus();
+    }
+    guard.endUserFetch();
+
+    // NOTE: It is not safe to throw an exception from here to the end of the method.
+    _userFetches.erase(userName);
+    if (status.isOK()) {
+        user->incrementRefCount();
+        for (int i = 0; i < fetch->numWaiters; ++i) {
+            user->incrementRefCount();
+        }
+
+        if (startGeneration == _cacheGeneration) {
+            _userCache.insert(std::make_pair(userName, user.get()));
+            if (_version == schemaVersionInvalid)
+                _version = authzVersion;
+
+            // The stale copy is no longer needed once the up-to-date one is in the cache.
+            auto staleIt = _staleUsers.find(userName);
+            if (staleIt != _staleUsers.end()) {
+                _releaseUser_inlock(staleIt->second.user);
+                _staleUsers.erase(staleIt);
+            }
+        } else {
+            // If the cache generation changed while this thread was in fetch mode, the data
+            // associated with the user may now be invalid, so we must mark it as such.  The caller
+            // may still opt to use the information for a short while, but not indefinitely.
+            user->invalidate();
+        }
+        fetch->user = user.release();
+    }
+    fetch->status = status;
+    fetch->done = true;
+    fetch->isDone.notify_all();
+
+    if (!status.isOK()) {
+        return status;
+    }
+    *acquiredUser = fetch->user;
+    return Status::OK();
+}
 
+Status AuthorizationManager::_fetchUser(OperationContext* opCtx,
+                                        const UserName& userName,
+                                        int* authzVersion,
+                                        std::unique_ptr<User>* acquiredUser) {
     // Number of times to retry a user document that fetches due to transient
     // AuthSchemaIncompatible errors.  These errors should only ever occur during and shortly
     // after schema upgrades.
     static const int maxAcquireRetries = 2;
     Status status = Status::OK();
     for (int i = 0; i < maxAcquireRetries; ++i) {
-        if (authzVersion == schemaVersionInvalid) {
-            Status status = _externalState->getStoredAuthorizationVersion(opCtx, &authzVersion);
+        if (*authzVersion == schemaVersionInvalid) {
+            Status status = _externalState->getStoredAuthorizationVersion(opCtx, authzVersion);
             if (!status.isOK())
                 return status;
         }
 
-        switch (authzVersion) {
+        switch (*authzVersion) {
             default:
                 status = Status(ErrorCodes::BadValue,
                                 mongoutils::str::stream()
                                     << "Illegal value for authorization data schema version, "
-                                    << authzVersion);
+                                    << *authzVersion);
                 break;
             case schemaVersion28SCRAM:
             case schemaVersion26Final:
             case schemaVersion26Upgrade:
-                status = _fetchUserV2(opCtx, userName, &user);
+                status = _fetchUserV2(opCtx, userName, acquiredUser);
                 break;
             case schemaVersion24:
                 status = Status(ErrorCodes::AuthSchemaIncompatible,
@@ -542,29 +661,36 @@ Status AuthorizationManager::acquireUserForInitialAuth(OperationContext* opCtx,
         if (status != ErrorCodes::AuthSchemaIncompatible)
             return status;
 
-        authzVersion = schemaVersionInvalid;
+        *authzVersion = schemaVersionInvalid;
     }
+    return status;
+}
 
-    if (!status.isOK())
-        return status;
-
-    guard.endFetchPhase();
+User* AuthorizationManager::_lookUpStaleUser_inlock(const UserName& userName) {
+    auto it = _staleUsers.find(userName);
+    if (it == _staleUsers.end()) {
+        return nullptr;
+    }
+    if (it->second.expiration < Date_t::now()) {
+        _releaseUser_inlock(it->second.user);
+        _staleUsers.erase(it);
+        return nullptr;
+    }
+    return it->second.user;
+}
 
-    user->incrementRefCount();
-    // NOTE: It is not safe to throw an exception from here to the end of the method.
-    if (guard.isSameCacheGeneration()) {
-        _userCache.insert(std::make_pair(userName, user.get()));
-        if (_version == schemaVersionInvalid)
-            _version = authzVersion;
-    } else {
-        // If the cache generation changed while this thread was in fetch mode, the data
-        // associated with the user may now be invalid, so we must mark it as such.  The caller
-        // may still opt to use the information for a short while, but not indefinitely.
-        user->invalidate();
+void AuthorizationManager::_dropRetainedUser_inlock(const UserName& userName) {
+    auto staleIt = _staleUsers.find(userName);
+    if (staleIt != _staleUsers.end()) {
+        _releaseUser_inlock(staleIt->second.user);
+        _staleUsers.erase(staleIt);
     }
-    *acquiredUser = user.release();
 
-    return Status::OK();
+    auto preloadedIt = _preloadedUsers.find(userName);
+    if (preloadedIt != _preloadedUsers.end()) {
+        _releaseUser_inlock(preloadedIt->second);
+        _preloadedUsers.erase(preloadedIt);
+    }
 }
 
 Status AuthorizationManager::_fetchUserV2(OperationContext* opCtx,
@@ -594,6 +720,10 @@ void AuthorizationManager::releaseUser(User* user) {
     }
 
     CacheGuard guard(this, CacheGuard::fetchSynchronizationManual);
+    _releaseUser_inlock(user);
+}
+
+void AuthorizationManager::_releaseUser_inlock(User* user) {
     user->decrementRefCount();
     if (user->getRefCount() == 0) {
         // If it's been invalidated then it's not in the _userCache anymore.
@@ -610,12 +740,14 @@ void AuthorizationManager::invalidateUserByName(const UserName& userName) {
     _updateCacheGeneration_inlock();
     unordered_map<UserName, User*>::iterator it = _userCache.find(userName);
     if (it == _userCache.end()) {
+        _dropRetainedUser_inlock(userName);
         return;
     }
 
     User* user = it->second;
     _userCache.erase(it);
     user->invalidate();
+    _dropRetainedUser_inlock(userName);
 }
 
 void AuthorizationManager::invalidateUsersFromDB(const std::string& dbname) {
@@ -631,6 +763,19 @@ void AuthorizationManager::invalidateUsersFromDB(const std::string& dbname) {
             ++it;
         }
     }
+
+    std::vector<UserName> retainedUsers;
+    for (auto&& entry : _staleUsers) {
+        if (entry.first.getDB() == dbname)
+            retainedUsers.push_back(entry.first);
+    }
+    for (auto&& entry : _preloadedUsers) {
+        if (entry.first.getDB() == dbname)
+            retainedUsers.push_back(entry.first);
+    }
+    for (const auto& userName : retainedUsers) {
+        _dropRetainedUser_inlock(userName);
+    }
 }
 
 void AuthorizationManager::invalidateUserCache() {
@@ -640,17 +785,72 @@ void AuthorizationManager::invalidateUserCache() {
 
 void AuthorizationManager::_invalidateUserCache_inlock() {
     _updateCacheGeneration_inlock();
+
+    // Keep the invalidated users around for a while, so that they can be served while their
+    // replacements are being read.
+    const int staleLifetimeSecs = authUserCacheStaleLifetimeSecs.load();
+    const Date_t staleExpiration = Date_t::now() + Seconds(staleLifetimeSecs);
     for (unordered_map<UserName, User*>::iterator it = _userCache.begin(); it != _userCache.end();
          ++it) {
         fassert(17266, it->second != internalSecurity.user);
         it->second->invalidate();
+        if (staleLifetimeSecs > 0) {
+            it->second->incrementRefCount();
+            auto staleIt = _staleUsers.find(it->first);
+            if (staleIt != _staleUsers.end()) {
+                _releaseUser_inlock(staleIt->second.user);
+                staleIt->second = StaleUser{it->second, staleExpiration};
+            } else {
+                _staleUsers.emplace(it->first, StaleUser{it->second, staleExpiration});
+            }
+        }
     }
     _userCache.clear();
 
+    for (auto&& entry : _preloadedUsers) {
+        _releaseUser_inlock(entry.second);
+    }
+    _preloadedUsers.clear();
+
     // Reread the schema version before acquiring the next user.
     _version = schemaVersionInvalid;
 }
 
+Status AuthorizationManager::preloadUserCache(OperationContext* opCtx) {
+    if (!authPreloadUserCache) {
+        return Status::OK();
+    }
+
+    std::vector<UserName> userNames;
+    Status status = _externalState->getAllUserNames(opCtx, &userNames);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    size_t numPreloaded = 0;
+    for (const auto& userName : userNames) {
+        User* user;
+        status = acquireUserForInitialAuth(opCtx, userName, &user);
+        if (!status.isOK()) {
+            warning() << "Could not preload user " << userName << " into the user cache: "
+                      << redact(status);
+            continue;
+        }
+
+        CacheGuard guard(this, CacheGuard::fetchSynchronizationManual);
+        // Leave the user to the cache's usual reference counting if it was invalidated meanwhile.
+        if (!user->isValid() || !_preloadedUsers.emplace(userName, user).second) {
+            _releaseUser_inlock(user);
+            continue;
+        }
+        ++numPreloaded;
+    }
+
+    log() << "Preloaded " << numPreloaded << " of " << userNames.size()
+          << " users into the user cache";
+    return Status::OK();
+}
+
 Status AuthorizationManager::initialize(OperationContext* opCtx) {
     invalidateUserCache();
     Status status = _externalState->initialize(opCtx);
@@ -50,6 +50,7 @@
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -261,6 +262,10 @@ public:
      *
      * If no user object for this user name exists yet in the cache, read the user's privilege
      * document from disk, build up a User object, sets the refcount to 1, and give that out.
+     * Concurrent acquisitions of a user which is not in the cache share a single read of its
+     * privilege document. While that read is in progress, they are given the out-of-date User
+     * object left by the last invalidation of the whole cache instead, if there is one and it is
+     * younger than authUserCacheStaleLifetimeSecs.
      *
      * The returned user may be invalid by the time the caller gets access to it.
      * The AuthorizationManager retains ownership of the returned User object.
@@ -317,6 +322,13 @@ public:
      */
     void invalidateUserCache();
 
+    /**
+     * Acquires every user defined in the system and keeps them in the user cache until they are
+     * invalidated, so that the first authentications after startup do not have to read the
+     * privilege documents one at a time. Errors acquiring individual users are only logged.
+     */
+    Status preloadUserCache(OperationContext* opCtx);
+
     /**
      * Parses privDoc and fully initializes the user object (credentials, roles, and privileges)
      * with the information extracted from the privilege document.
@@ -342,6 +354,56 @@ private:
     class CacheGuard;
     friend class AuthorizationManager::CacheGuard;
 
+    /**
+     * State of a read of a user's privilege document that other acquisitions of the same user are
+     * waiting for. Guarded by CacheGuard.
+     */
+    struct UserFetch {
+        bool done = false;
+        Status status = Status::OK();
+
+        // Holds a reference for each of the waiters once done, if the status is OK.
+        User* user = nullptr;
+        int numWaiters = 0;
+
+        stdx::condition_variable isDone;
+    };
+
+    /**
+     * An out-of-date User object kept after the invalidation of the whole user cache, so that it
+     * can be served while an up-to-date one is being read. Holds a reference to the user.
+     */
+    struct StaleUser {
+        User* user;
+        Date_t expiration;
+    };
+
+    /**
+     * Reads the privilege document of the named user and builds a User object from it, reading
+     * the schema version first if *authzVersion is schemaVersionInvalid.
+     */
+    Status _fetchUser(OperationContext* opCtx,
+                      const UserName& userName,
+                      int* authzVersion,
+                      std::unique_ptr<User>* acquiredUser);
+
+    /**
+     * Returns the unexpired stale User object for the named user, if there is one. Should only be
+     * called when already holding _cacheMutex.
+     */
+    User* _lookUpStaleUser_inlock(const UserName& userName);
+
+    /**
+     * Drops the stale User object and the preloaded reference for the named user, if there are.
+     * Should only be called when already holding _cacheMutex.
+     */
+    void _dropRetainedUser_inlock(const UserName& userName);
+
+    /**
+     * Same as releaseUser(), but should only be called when already holding _cacheMutex.
+     */
+    void _releaseUser_inlock(User* user);
+
     /**
      * Invalidates all User objects in the cache and removes them from the cache.
      * Should only be called when already holding _cacheMutex.
@@ -415,6 +477,23 @@ private:
      */
     unordered_map<UserName, User*> _userCache;
 
+    /**
+     * Reads of privilege documents in progress, by user name. Protected by CacheGuard.
+     */
+    unordered_map<UserName, std::shared_ptr<UserFetch>> _userFetches;
+
+    /**
+     * Out-of-date User objects which may be served while their replacement is being read.
+     * Protected by CacheGuard.
+     */
+    unordered_map<UserName, StaleUser> _staleUsers;
+
+    /**
+     * Users acquired by preloadUserCache(), with the reference which keeps them in the cache.
+     * Protected by CacheGuard.
+     */
+    unordered_map<UserName, User*> _preloadedUsers;
+
     /**
      * Current generation of cached data.  Updated every time part of the cache gets
      * invalidated.  Protected by CacheGuard.
@@ -430,8 +509,8 @@ private:
     bool _isFetchPhaseBusy;
 
     /**
-     * Protects _userCache, _cacheGeneration, _version and _isFetchPhaseBusy.  Manipulated
-     * via CacheGuard.
+     * Protects _userCache, _userFetches, _staleUsers, _preloadedUsers, _cacheGeneration, _version
+     * and _isFetchPhaseBusy.  Manipulated via CacheGuard.
      */
     stdx::mutex _cacheMutex;
 
@@ -247,6 +247,39 @@ TEST_F(AuthorizationManagerTest, testAcquireV2User) {
     authzManager->releaseUser(v2cluster);
 }
 
+TEST_F(AuthorizationManagerTest, testPreloadUserCache) {
+    OperationContextNoop opCtx;
+
+    ASSERT_OK(externalState->insertPrivilegeDocument(&opCtx,
+                                                     BSON("_id"
+                                                          << "test.v2read"
+                                                          << "user"
+                                                          << "v2read"
+                                                          << "db"
+                                                          << "test"
+                                                          << "credentials"
+                                                          << BSON("MONGODB-CR"
+                                                                  << "password")
+                                                          << "roles"
+                                                          << BSON_ARRAY(BSON("role"
+                                                                             << "read"
+                                                                             << "db"
+                                                                             << "test"))),
+                                                     BSONObj()));
+    ASSERT_OK(authzManager->preloadUserCache(&opCtx));
+
+    // The cache holds on to the preloaded user until it is invalidated.
+    User* v2read;
+    ASSERT_OK(authzManager->acquireUserForInitialAuth(&opCtx, UserName("v2read", "test"), &v2read));
+    ASSERT(v2read->isValid());
+    ASSERT_EQUALS(2U, v2read->getRefCount());
+
+    authzManager->invalidateUserByName(UserName("v2read", "test"));
+    ASSERT_FALSE(v2read->isValid());
+    ASSERT_EQUALS(1U, v2read->getRefCount());
+    authzManager->releaseUser(v2read);
+}
+
 TEST_F(AuthorizationManagerTest, testLocalX509Authorization) {
     ServiceContextNoop serviceContext;
     transport::TransportLayerMock transportLayer{};
@@ -209,14 +209,27 @@ void AuthorizationSession::_addPrivilegesForStage(const std::string& db,
                                                   BSONObj stageSpec,
                                                   bool haveRecursed) {
     StringData stageName = stageSpec.firstElementFieldName();
-    if (stageName == "$out" && stageSpec.firstElementType() == BSONType::String) {
-        NamespaceString outputNs(db, stageSpec.firstElement().str());
+    if (stageName == "$out" && (stageSpec.firstElementType() == BSONType::String ||
+                                stageSpec.firstElementType() == BSONType::Object)) {
+        // The object form is {$out: {to: <collection>, mode: <mode>}}.
+        BSONElement outSpec = stageSpec.firstElement();
+        BSONElement mode;
+        if (outSpec.type() == BSONType::Object) {
+            mode = outSpec.embeddedObject()["mode"];
+            outSpec = outSpec.embeddedObject()["to"];
+        }
+        NamespaceString outputNs(db, outSpec.type() == BSONType::String ? outSpec.str() : "");
         uassert(17139,
                 mongoutils::str::stream() << "Invalid $out target namespace, " << outputNs.ns(),
                 outputNs.isValid());
 
         ActionSet actions;
-        actions.addAction(ActionType::remove);
+        if (mode.type() == BSONType::String && mode.valueStringData() == "replaceDocuments") {
+            // Documents are upserted into the target collection.
+            actions.addAction(ActionType::update);
+        } else {
+            actions.addAction(ActionType::remove);
+        }
         actions.addAction(ActionType::insert);
         if (shouldBypassDocumentValidationForCommand(cmdObj)) {
             actions.addAction(ActionType::bypassDocumentValidation);
@@ -291,6 +304,10 @@ Status AuthorizationSession::checkAuthForAggregate(const NamespaceString& ns,
             Privilege::addPrivilegeToPrivilegeVector(
                 &privileges,
                 Privilege(ResourcePattern::forExactNamespace(ns), ActionType::indexStats));
+        } else if (str::equals("$queryStats", firstPipelineStage.firstElementFieldName())) {
+            Privilege::addPrivilegeToPrivilegeVector(
+                &privileges,
+                Privilege(ResourcePattern::forExactNamespace(ns), ActionType::planCacheRead));
         } else if (str::equals("$collStats", firstPipelineStage.firstElementFieldName())) {
             Privilege::addPrivilegeToPrivilegeVector(
                 &privileges,
@@ -627,6 +627,23 @@ TEST_F(AuthorizationSessionTest, CanAggregateIndexStatsWithIndexStatsAction) {
     ASSERT_OK(authzSession->checkAuthForAggregate(testFooNss, cmdObj));
 }
 
+TEST_F(AuthorizationSessionTest, CannotAggregateQueryStatsWithoutPlanCacheReadAction) {
+    authzSession->assumePrivilegesForDB(Privilege(testFooCollResource, {ActionType::find}));
+
+    BSONArray pipeline = BSON_ARRAY(BSON("$queryStats" << BSONObj()));
+    BSONObj cmdObj = BSON("aggregate" << testFooNss.coll() << "pipeline" << pipeline);
+    ASSERT_EQ(ErrorCodes::Unauthorized, authzSession->checkAuthForAggregate(testFooNss, cmdObj));
+}
+
+TEST_F(AuthorizationSessionTest, CanAggregateQueryStatsWithPlanCacheReadAction) {
+    authzSession->assumePrivilegesForDB(
+        Privilege(testFooCollResource, {ActionType::planCacheRead}));
+
+    BSONArray pipeline = BSON_ARRAY(BSON("$queryStats" << BSONObj()));
+    BSONObj cmdObj = BSON("aggregate" << testFooNss.coll() << "pipeline" << pipeline);
+    ASSERT_OK(authzSession->checkAuthForAggregate(testFooNss, cmdObj));
+}
+
 TEST_F(AuthorizationSessionTest, CanAggregateCurrentOpAllUsersFalseWithoutInprogAction) {
     authzSession->assumePrivilegesForDB(Privilege(testFooCollResource, {ActionType::find}));
 
@@ -700,6 +717,40 @@ TEST_F(AuthorizationSessionTest, CanAggregateOutWithInsertAndRemoveOnTargetNames
     ASSERT_OK(authzSession->checkAuthForAggregate(testFooNss, cmdObjNoBypassDocumentValidation));
 }
 
+TEST_F(AuthorizationSessionTest, CanAggregateOutReplacingDocumentsWithInsertAndUpdateOnTarget) {
+    BSONArray pipeline = BSON_ARRAY(
+        BSON("$out" << BSON("to" << testBarNss.coll() << "mode"
+                                 << "replaceDocuments")));
+    BSONObj cmdObj = BSON("aggregate" << testFooNss.coll() << "pipeline" << pipeline);
+
+    // We have insert and remove, but not update, on the $out namespace.
+    authzSession->assumePrivilegesForDB(
+        {Privilege(testFooCollResource, {ActionType::find}),
+         Privilege(testBarCollResource, {ActionType::insert, ActionType::remove})});
+    ASSERT_EQ(ErrorCodes::Unauthorized, authzSession->checkAuthForAggregate(testFooNss, cmdObj));
+
+    authzSession->assumePrivilegesForDB(
+        {Privilege(testFooCollResource, {ActionType::find}),
+         Privilege(testBarCollResource, {ActionType::insert, ActionType::update})});
+    ASSERT_OK(authzSession->checkAuthForAggregate(testFooNss, cmdObj));
+}
+
+TEST_F(AuthorizationSessionTest, CannotAggregateOutObjectFormWithoutInsertAndRemoveOnTarget) {
+    authzSession->assumePrivilegesForDB(Privilege(testFooCollResource, {ActionType::find}));
+
+    BSONArray pipeline = BSON_ARRAY(BSON("$out" << BSON("to" << testBarNss.coll())));
+    BSONObj cmdObj = BSON("aggregate" << testFooNss.coll() << "pipeline" << pipeline);
+    ASSERT_EQ(ErrorCodes::Unauthorized, authzSession->checkAuthForAggregate(testFooNss, cmdObj));
+}
+
+TEST_F(AuthorizationSessionTest, AddPrivilegesForStageFailsIfOutObjectFormHasNoTarget) {
+    BSONArray pipeline = BSON_ARRAY(BSON("$out" << BSON("mode"
+                                                        << "replaceDocuments")));
+    BSONObj cmdObj = BSON("aggregate" << testFooNss.coll() << "pipeline" << pipeline);
+    ASSERT_THROWS_CODE(
+        authzSession->checkAuthForAggregate(testFooNss, cmdObj), UserException, 17139);
+}
+
 TEST_F(AuthorizationSessionTest,
        CannotAggregateOutBypassingValidationWithoutBypassDocumentValidationOnTargetNamespace) {
     authzSession->assumePrivilegesForDB(
@@ -40,6 +40,12 @@ stdx::function<std::unique_ptr<AuthzManagerExternalState>()> AuthzManagerExterna
 AuthzManagerExternalState::AuthzManagerExternalState() = default;
 AuthzManagerExternalState::~AuthzManagerExternalState() = default;
 
+Status AuthzManagerExternalState::getAllUserNames(OperationContext* opCtx,
+                                                 std::vector<UserName>* result) {
+    return Status(ErrorCodes::CommandNotSupported,
+                  "Listing all users is not supported by this authorization manager");
+}
+
 bool AuthzManagerExternalState::shouldUseRolesFromConnection(OperationContext* opCtx,
                                                              const UserName& userName) {
     if (!opCtx || !opCtx->getClient() || !opCtx->getClient()->session())
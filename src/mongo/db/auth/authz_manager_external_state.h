@@ -155,6 +155,13 @@ public:
      */
     virtual bool hasAnyPrivilegeDocuments(OperationContext* opCtx) = 0;
 
+    /**
+     * Appends the names of all the users defined in the system to "result".
+     *
+     * Returns ErrorCodes::CommandNotSupported if the users cannot be listed from this process.
+     */
+    virtual Status getAllUserNames(OperationContext* opCtx, std::vector<UserName>* result);
+
     virtual void logOp(OperationContext* opCtx,
                        const char* op,
                        const NamespaceString& ns,
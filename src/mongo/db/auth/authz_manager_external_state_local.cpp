@@ -149,6 +149,22 @@ bool AuthzManagerExternalStateLocal::hasAnyPrivilegeDocuments(OperationContext*
     return statusFindRoles != ErrorCodes::NoMatchingDocument;
 }
 
+Status AuthzManagerExternalStateLocal::getAllUserNames(OperationContext* opCtx,
+                                                       std::vector<UserName>* result) {
+    return query(opCtx,
+                 AuthorizationManager::usersCollectionNamespace,
+                 BSONObj(),
+                 BSON(AuthorizationManager::USER_NAME_FIELD_NAME
+                      << 1
+                      << AuthorizationManager::USER_DB_FIELD_NAME
+                      << 1),
+                 [result](const BSONObj& userDoc) {
+                     result->emplace_back(
+                         userDoc[AuthorizationManager::USER_NAME_FIELD_NAME].str(),
+                         userDoc[AuthorizationManager::USER_DB_FIELD_NAME].str());
+                 });
+}
+
 Status AuthzManagerExternalStateLocal::getUserDescription(OperationContext* opCtx,
                                                           const UserName& userName,
                                                           BSONObj* result) {
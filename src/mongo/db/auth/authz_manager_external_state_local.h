@@ -77,6 +77,8 @@ public:
 
     bool hasAnyPrivilegeDocuments(OperationContext* opCtx) override;
 
+    Status getAllUserNames(OperationContext* opCtx, std::vector<UserName>* result) override;
+
     /**
      * Finds a document matching "query" in "collectionName", and store a shared-ownership
      * copy into "result".
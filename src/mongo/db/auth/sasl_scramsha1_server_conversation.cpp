@@ -38,6 +38,7 @@
 #include "mongo/crypto/mechanism_scram.h"
 #include "mongo/crypto/sha1_block.h"
 #include "mongo/db/auth/sasl_options.h"
+#include "mongo/db/auth/scram_sha1_server_cache.h"
 #include "mongo/platform/random.h"
 #include "mongo/util/base64.h"
 #include "mongo/util/log.h"
@@ -190,12 +191,20 @@ StatusWith<bool> SaslSCRAMSHA1ServerConversation::_firstStep(std::vector<string>
         // Use a default value of 5000 for the scramIterationCount when in mixed mode,
         // overriding the default value (10000) used for SCRAM mode or the user-given value.
         const int mixedModeScramIterationCount = 5000;
-        BSONObj scramCreds =
-            scram::generateCredentials(_creds.password, mixedModeScramIterationCount);
-        _creds.scram.iterationCount = scramCreds[scram::iterationCountFieldName].Int();
-        _creds.scram.salt = scramCreds[scram::saltFieldName].String();
-        _creds.scram.storedKey = scramCreds[scram::storedKeyFieldName].String();
-        _creds.scram.serverKey = scramCreds[scram::serverKeyFieldName].String();
+        // Reuse the credentials derived by earlier authentications of this user, since deriving
+        // them is the most expensive part of the conversation.
+        auto& cache = SCRAMSHA1ServerCache::get();
+        if (!cache.getCachedCredentials(
+                userName, _creds.password, mixedModeScramIterationCount, &_creds.scram)) {
+            BSONObj scramCreds =
+                scram::generateCredentials(_creds.password, mixedModeScramIterationCount);
+            _creds.scram.iterationCount = scramCreds[scram::iterationCountFieldName].Int();
+            _creds.scram.salt = scramCreds[scram::saltFieldName].String();
+            _creds.scram.storedKey = scramCreds[scram::storedKeyFieldName].String();
+            _creds.scram.serverKey = scramCreds[scram::serverKeyFieldName].String();
+            cache.setCachedCredentials(
+                userName, _creds.password, mixedModeScramIterationCount, _creds.scram);
+        }
     }
 
     // Generate server-first-message
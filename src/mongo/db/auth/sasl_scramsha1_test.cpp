@@ -36,6 +36,7 @@
 #include "mongo/db/auth/authz_session_external_state_mock.h"
 #include "mongo/db/auth/native_sasl_authentication_session.h"
 #include "mongo/db/auth/sasl_scramsha1_server_conversation.h"
+#include "mongo/db/auth/scram_sha1_server_cache.h"
 #include "mongo/db/service_context_noop.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
@@ -438,6 +439,46 @@ TEST_F(SCRAMSHA1Fixture, testMONGODBCR) {
     ASSERT_EQ(goalState, runSteps(saslServerSession.get(), saslClientSession.get()));
 }
 
+TEST(SCRAMSHA1ServerCache, testSetAndGet) {
+    SCRAMSHA1ServerCache cache(10);
+    UserName user("sajack", "test");
+    BSONObj scramCreds = scram::generateCredentials(createPasswordDigest("sajack", "sajack"), 5000);
+    User::SCRAMCredentials creds;
+    creds.iterationCount = scramCreds[scram::iterationCountFieldName].Int();
+    creds.salt = scramCreds[scram::saltFieldName].String();
+    creds.storedKey = scramCreds[scram::storedKeyFieldName].String();
+    creds.serverKey = scramCreds[scram::serverKeyFieldName].String();
+
+    User::SCRAMCredentials found;
+    ASSERT_FALSE(
+        cache.getCachedCredentials(user, createPasswordDigest("sajack", "sajack"), 5000, &found));
+    cache.setCachedCredentials(user, createPasswordDigest("sajack", "sajack"), 5000, creds);
+
+    ASSERT_TRUE(
+        cache.getCachedCredentials(user, createPasswordDigest("sajack", "sajack"), 5000, &found));
+    ASSERT_EQ(creds.salt, found.salt);
+    ASSERT_EQ(creds.storedKey, found.storedKey);
+    ASSERT_EQ(creds.serverKey, found.serverKey);
+
+    // Changing the password or the iteration count invalidates the entry.
+    ASSERT_FALSE(
+        cache.getCachedCredentials(user, createPasswordDigest("sajack", "other"), 5000, &found));
+    ASSERT_FALSE(
+        cache.getCachedCredentials(user, createPasswordDigest("sajack", "sajack"), 10000, &found));
+    ASSERT_FALSE(cache.getCachedCredentials(
+        UserName("sajack", "admin"), createPasswordDigest("sajack", "sajack"), 5000, &found));
+}
+
+TEST(SCRAMSHA1ServerCache, testDisabled) {
+    SCRAMSHA1ServerCache cache(0);
+    UserName user("sajack", "test");
+    User::SCRAMCredentials creds;
+    creds.salt = "salt";
+
+    cache.setCachedCredentials(user, "password", 5000, creds);
+    ASSERT_FALSE(cache.getCachedCredentials(user, "password", 5000, &creds));
+}
+
 TEST(SCRAMSHA1Cache, testGetFromEmptyCache) {
     SCRAMSHA1ClientCache cache;
     std::string saltStr("saltsaltsaltsalt");
@@ -0,0 +1,96 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/auth/scram_sha1_server_cache.h"
+
+#include <algorithm>
+
+#include "mongo/base/counter.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/server_parameters.h"
+
+namespace mongo {
+
+namespace {
+
+// Maximum number of users whose derived SCRAM-SHA-1 credentials are cached. Zero disables the
+// cache.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(scramSHA1ServerCacheSize, int, 10000);
+
+Counter64 cacheHits;
+Counter64 cacheMisses;
+ServerStatusMetricField<Counter64> displayCacheHits("auth.scramSHA1ServerCache.hits", &cacheHits);
+ServerStatusMetricField<Counter64> displayCacheMisses("auth.scramSHA1ServerCache.misses",
+                                                      &cacheMisses);
+
+}  // namespace
+
+SCRAMSHA1ServerCache::SCRAMSHA1ServerCache(std::size_t maxSize)
+    : _enabled(maxSize > 0), _entries(maxSize) {}
+
+SCRAMSHA1ServerCache& SCRAMSHA1ServerCache::get() {
+    static SCRAMSHA1ServerCache cache(std::max(scramSHA1ServerCacheSize, 0));
+    return cache;
+}
+
+bool SCRAMSHA1ServerCache::getCachedCredentials(const UserName& userName,
+                                                const std::string& password,
+                                                int iterationCount,
+                                                User::SCRAMCredentials* result) {
+    if (!_enabled) {
+        return false;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _entries.find(userName);
+    if (it == _entries.end() || it->second.password != password ||
+        it->second.iterationCount != iterationCount) {
+        cacheMisses.increment();
+        return false;
+    }
+
+    cacheHits.increment();
+    *result = it->second.credentials;
+    return true;
+}
+
+void SCRAMSHA1ServerCache::setCachedCredentials(const UserName& userName,
+                                                std::string password,
+                                                int iterationCount,
+                                                User::SCRAMCredentials credentials) {
+    if (!_enabled) {
+        return;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _entries.add(userName, Entry{std::move(password), iterationCount, std::move(credentials)});
+}
+
+}  // namespace mongo
@@ -0,0 +1,96 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/auth/user.h"
+#include "mongo/db/auth/user_name.h"
+#include "mongo/db/auth/user_name_hash.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/lru_cache.h"
+
+namespace mongo {
+
+/**
+ * A bounded cache of the SCRAM-SHA-1 credentials the server derives on the fly for users which
+ * only have MONGODB-CR credentials.
+ *
+ * Deriving the credentials runs the PBKDF2 iterations over the user's password hash, which is as
+ * expensive for the server as it is for SCRAMSHA1ClientCache's clients. Without this cache, a
+ * storm of reconnections from such users spends most of its time there.
+ *
+ * Entries are keyed by user, and are only returned for the password hash and iteration count
+ * they were derived from, so a change of the user's credentials, or of the iteration count, turns
+ * the next lookup into a miss which replaces the entry.
+ */
+class SCRAMSHA1ServerCache {
+    MONGO_DISALLOW_COPYING(SCRAMSHA1ServerCache);
+
+public:
+    explicit SCRAMSHA1ServerCache(std::size_t maxSize);
+
+    /**
+     * Returns the cache shared by all the SCRAM-SHA-1 server conversations.
+     */
+    static SCRAMSHA1ServerCache& get();
+
+    /**
+     * Copies into "result" the credentials cached for "userName", if they were derived from
+     * "password" with "iterationCount" iterations, and returns true. Otherwise returns false.
+     */
+    bool getCachedCredentials(const UserName& userName,
+                              const std::string& password,
+                              int iterationCount,
+                              User::SCRAMCredentials* result);
+
+    /**
+     * Records the credentials derived for "userName" from "password" with "iterationCount"
+     * iterations, replacing any previous entry for the user.
+     */
+    void setCachedCredentials(const UserName& userName,
+                              std::string password,
+                              int iterationCount,
+                              User::SCRAMCredentials credentials);
+
+private:
+    struct Entry {
+        std::string password;
+        int iterationCount;
+        User::SCRAMCredentials credentials;
+    };
+
+    const bool _enabled;
+
+    stdx::mutex _mutex;
+    LRUCache<UserName, Entry> _entries;
+};
+
+}  // namespace mongo
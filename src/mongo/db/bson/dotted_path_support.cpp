@@ -37,6 +37,7 @@
 #include "mongo/bson/bsonmisc.h"
 #include "mongo/bson/bsonobj.h"
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 namespace dotted_path_support {
@@ -120,8 +121,68 @@ void _extractAllElementsAlongPath(const BSONObj& obj,
     }
 }
 
+/**
+ * Continues extractElementAtPathOrArrayAlongPath() once the first component of 'path', ending at
+ * 'p', has been looked up as 'sub'.
+ */
+BSONElement _extractRemainderAlongPath(BSONElement sub, const char* p, const char*& path) {
+    path = p ? p + 1 : path + strlen(path);
+
+    if (sub.eoo())
+        return BSONElement();
+    else if (sub.type() == Array || path[0] == '\0')
+        return sub;
+    else if (sub.type() == Object)
+        return extractElementAtPathOrArrayAlongPath(sub.embeddedObject(), path);
+    else
+        return BSONElement();
+}
+
 }  // namespace
 
+TopLevelFieldTable::TopLevelFieldTable(const BSONObj& obj) : _obj(obj) {
+    size_t numSlots = 2;
+    for (int numFields = obj.nFields(); numSlots < 2 * static_cast<size_t>(numFields);) {
+        numSlots *= 2;
+    }
+    _slots.resize(numSlots, Slot{0, 0});
+    _mask = numSlots - 1;
+
+    for (auto&& elt : obj) {
+        const StringData name = elt.fieldNameStringData();
+        const uint32_t hash = StringMapTraits::hash(name);
+        for (uint32_t i = hash & _mask;; i = (i + 1) & _mask) {
+            Slot& slot = _slots[i];
+            if (!slot.offset) {
+                slot.hash = hash;
+                slot.offset = elt.rawdata() - obj.objdata();
+                break;
+            }
+            if (slot.hash == hash &&
+                BSONElement(obj.objdata() + slot.offset).fieldNameStringData() == name) {
+                // Keep the first element with this name, as BSONObj::getField() would.
+                break;
+            }
+        }
+    }
+}
+
+BSONElement TopLevelFieldTable::getField(StringData name) const {
+    const uint32_t hash = StringMapTraits::hash(name);
+    for (uint32_t i = hash & _mask;; i = (i + 1) & _mask) {
+        const Slot& slot = _slots[i];
+        if (!slot.offset) {
+            return BSONElement();
+        }
+        if (slot.hash == hash) {
+            BSONElement elt(_obj.objdata() + slot.offset);
+            if (elt.fieldNameStringData() == name) {
+                return elt;
+            }
+        }
+    }
+}
+
 BSONElement extractElementAtPath(const BSONObj& obj, StringData path) {
     BSONElement e = obj.getField(path);
     if (e.eoo()) {
@@ -139,25 +200,15 @@ BSONElement extractElementAtPath(const BSONObj& obj, StringData path) {
 
 BSONElement extractElementAtPathOrArrayAlongPath(const BSONObj& obj, const char*& path) {
     const char* p = strchr(path, '.');
+    BSONElement sub = p ? obj.getField(StringData(path, p - path)) : obj.getField(path);
+    return _extractRemainderAlongPath(sub, p, path);
+}
 
-    BSONElement sub;
-
-    if (p) {
-        sub = obj.getField(std::string(path, p - path));
-        path = p + 1;
-    } else {
-        sub = obj.getField(path);
-        path = path + strlen(path);
-    }
-
-    if (sub.eoo())
-        return BSONElement();
-    else if (sub.type() == Array || path[0] == '\0')
-        return sub;
-    else if (sub.type() == Object)
-        return extractElementAtPathOrArrayAlongPath(sub.embeddedObject(), path);
-    else
-        return BSONElement();
+BSONElement extractElementAtPathOrArrayAlongPath(const TopLevelFieldTable& fields,
+                                                 const char*& path) {
+    const char* p = strchr(path, '.');
+    BSONElement sub = fields.getField(p ? StringData(path, p - path) : StringData(path));
+    return _extractRemainderAlongPath(sub, p, path);
 }
 
 void extractAllElementsAlongPath(const BSONObj& obj,
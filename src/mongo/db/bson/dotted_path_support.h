@@ -29,13 +29,68 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <set>
+#include <vector>
 
+#include "mongo/base/disallow_copying.h"
 #include "mongo/bson/bsonobj.h"
 
 namespace mongo {
 namespace dotted_path_support {
 
+/**
+ * A hash table from the top-level field names of an object to the offsets of their elements,
+ * built in a single pass over the object. BSONObj::getField() scans the object, so looking up
+ * several fields of a document with hundreds of fields costs a scan per lookup; looking them up
+ * in a TopLevelFieldTable costs one scan in total. Use shouldBuild() to decide whether building a
+ * table is worth it.
+ *
+ * Like BSONObj::getField(), getField() returns the first element with the given field name. The
+ * table does not own the object's buffer, so the object must outlive the table.
+ */
+class TopLevelFieldTable {
+    MONGO_DISALLOW_COPYING(TopLevelFieldTable);
+
+public:
+    // Building a table costs about as much as two scans of the object, and smaller objects are
+    // scanned quickly enough that the allocation is not paid back.
+    static constexpr size_t kMinLookups = 4;
+    static constexpr int kMinObjSize = 2048;
+
+    /**
+     * Returns true if 'numLookups' lookups into 'obj' are expected to be cheaper with a table.
+     */
+    static bool shouldBuild(const BSONObj& obj, size_t numLookups) {
+        return numLookups >= kMinLookups && obj.objsize() >= kMinObjSize;
+    }
+
+    explicit TopLevelFieldTable(const BSONObj& obj);
+
+    /**
+     * Returns the element named 'name', or BSONElement() if 'obj' has no such field.
+     */
+    BSONElement getField(StringData name) const;
+
+    const BSONObj& obj() const {
+        return _obj;
+    }
+
+private:
+    struct Slot {
+        uint32_t hash;
+        // Offset of the element from the start of the object, or 0 if the slot is empty.
+        uint32_t offset;
+    };
+
+    BSONObj _obj;
+
+    // Open addressing with linear probing. The number of slots is a power of two and at least
+    // twice the number of fields, so every probe sequence ends at an empty slot.
+    std::vector<Slot> _slots;
+    uint32_t _mask;
+};
+
 /**
  * Returns the element at the specified path. This function returns BSONElement() if the element
  * wasn't found.
@@ -76,6 +131,13 @@ BSONElement extractElementAtPath(const BSONObj& obj, StringData path);
  */
 BSONElement extractElementAtPathOrArrayAlongPath(const BSONObj& obj, const char*& path);
 
+/**
+ * Same as above, but looks up the first component of 'path' in 'fields' instead of scanning the
+ * object.
+ */
+BSONElement extractElementAtPathOrArrayAlongPath(const TopLevelFieldTable& fields,
+                                                 const char*& path);
+
 /**
  * Expands arrays along the specified path and adds all elements to the 'elements' set.
  *
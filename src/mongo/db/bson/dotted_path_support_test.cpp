@@ -40,6 +40,7 @@
 #include "mongo/bson/json.h"
 #include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
 namespace {
@@ -606,5 +607,60 @@ TEST(ExtractElementAtPathOrArrayAlongPath, NumericalPathElementTreatedAsFieldNam
     ASSERT(StringData(pathData).empty());
 }
 
+BSONObj makeWideObject(int numFields) {
+    BSONObjBuilder bob;
+    for (int i = 0; i < numFields; ++i) {
+        bob.append(str::stream() << "f" << i, i);
+    }
+    return bob.obj();
+}
+
+TEST(TopLevelFieldTable, FindsEveryField) {
+    BSONObj obj = makeWideObject(500);
+    dps::TopLevelFieldTable fields(obj);
+    for (auto&& elt : obj) {
+        ASSERT_EQ(elt.rawdata(), fields.getField(elt.fieldNameStringData()).rawdata());
+    }
+    ASSERT_TRUE(fields.getField("f500").eoo());
+    ASSERT_TRUE(fields.getField("").eoo());
+    ASSERT_TRUE(fields.getField("f1.a").eoo());
+}
+
+TEST(TopLevelFieldTable, ReturnsFirstOfDuplicateFields) {
+    BSONObj obj = BSON("a" << 1 << "b" << 2 << "a" << 3);
+    dps::TopLevelFieldTable fields(obj);
+    ASSERT_EQ(obj.getField("a").rawdata(), fields.getField("a").rawdata());
+    ASSERT_EQ(1, fields.getField("a").numberInt());
+}
+
+TEST(TopLevelFieldTable, EmptyObjectHasNoFields) {
+    BSONObj obj;
+    dps::TopLevelFieldTable fields(obj);
+    ASSERT_TRUE(fields.getField("a").eoo());
+    ASSERT_TRUE(fields.getField("").eoo());
+}
+
+TEST(TopLevelFieldTable, ShouldOnlyBeBuiltForManyLookupsIntoLargeObjects) {
+    BSONObj wide = makeWideObject(500);
+    ASSERT_TRUE(dps::TopLevelFieldTable::shouldBuild(wide, dps::TopLevelFieldTable::kMinLookups));
+    ASSERT_FALSE(
+        dps::TopLevelFieldTable::shouldBuild(wide, dps::TopLevelFieldTable::kMinLookups - 1));
+    ASSERT_FALSE(dps::TopLevelFieldTable::shouldBuild(BSON("a" << 1), 100));
+}
+
+TEST(ExtractElementAtPathOrArrayAlongPath, LooksUpFirstComponentInFieldTable) {
+    BSONObj obj(fromjson("{x: 1, a: {b: [{c: 1}, {c: 2}]}, d: {e: 3}, f: 4}"));
+    dps::TopLevelFieldTable fields(obj);
+
+    for (StringData path : {"a.b.c", "a.b", "d.e", "d.x", "f", "f.g", "x.y", "y", "a.0"}) {
+        const char* objPath = path.rawData();
+        const char* tablePath = path.rawData();
+        auto objElt = dps::extractElementAtPathOrArrayAlongPath(obj, objPath);
+        auto tableElt = dps::extractElementAtPathOrArrayAlongPath(fields, tablePath);
+        ASSERT_EQ(objElt.rawdata(), tableElt.rawdata()) << path;
+        ASSERT_EQ(StringData(objPath), StringData(tablePath)) << path;
+    }
+}
+
 }  // namespace
 }  // namespace mongo
@@ -56,6 +56,7 @@ namespace mongo {
 class CollectionCatalogEntry;
 class DatabaseCatalogEntry;
 class ExtentManager;
+class FieldRefSet;
 class IndexCatalog;
 class DatabaseImpl;
 class MatchExpression;
@@ -258,7 +259,8 @@ public:
                                                     bool enforceQuota,
                                                     bool indexesAffected,
                                                     OpDebug* opDebug,
-                                                    OplogUpdateEntryArgs* args) = 0;
+                                                    OplogUpdateEntryArgs* args,
+                                                    const FieldRefSet* updatedFields) = 0;
 
         virtual bool updateWithDamagesSupported() const = 0;
 
@@ -506,6 +508,8 @@ public:
      * Sets 'args.updatedDoc' to the updated version of the document with damages applied, on
      * success.
      * 'opDebug' Optional argument. When not null, will be used to record operation statistics.
+     * 'updatedFields' Optional argument. When not null, holds every path the update may have
+     * modified, and only the indexes on one of those paths are updated; otherwise every index is.
      * @return the post update location of the doc (may or may not be the same as oldLocation)
      */
     inline StatusWith<RecordId> updateDocument(OperationContext* const opCtx,
@@ -515,9 +519,17 @@ public:
                                                const bool enforceQuota,
                                                const bool indexesAffected,
                                                OpDebug* const opDebug,
-                                               OplogUpdateEntryArgs* const args) {
-        return this->_impl().updateDocument(
-            opCtx, oldLocation, oldDoc, newDoc, enforceQuota, indexesAffected, opDebug, args);
+                                               OplogUpdateEntryArgs* const args,
+                                               const FieldRefSet* const updatedFields = nullptr) {
+        return this->_impl().updateDocument(opCtx,
+                                            oldLocation,
+                                            oldDoc,
+                                            newDoc,
+                                            enforceQuota,
+                                            indexesAffected,
+                                            opDebug,
+                                            args,
+                                            updatedFields);
     }
 
     inline bool updateWithDamagesSupported() const {
@@ -41,6 +41,7 @@
 #include "mongo/bson/simple_bsonelement_comparator.h"
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/background.h"
+#include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/catalog/collection_catalog_entry.h"
 #include "mongo/db/catalog/database_catalog_entry.h"
 #include "mongo/db/catalog/document_validation.h"
@@ -49,6 +50,8 @@
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/curop.h"
+#include "mongo/db/exec/shared_oplog_buffer.h"
+#include "mongo/db/field_ref_set.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/keypattern.h"
 #include "mongo/db/matcher/expression_parser.h"
@@ -65,6 +68,7 @@
 #include "mongo/db/storage/record_fetcher.h"
 #include "mongo/db/storage/record_store.h"
 #include "mongo/db/update/update_driver.h"
+#include "mongo/db/update_index_data.h"
 
 #include "mongo/db/auth/user_document_parser.h"  // XXX-ANDY
 #include "mongo/rpc/object_check.h"
@@ -73,6 +77,8 @@
 
 namespace mongo {
 
+namespace dps = ::mongo::dotted_path_support;
+
 namespace {
 MONGO_INITIALIZER(InitializeCollectionFactory)(InitializerContext* const) {
     Collection::registerFactory(
@@ -206,6 +212,9 @@ CollectionImpl::~CollectionImpl() {
         _recordStore->setCappedCallback(nullptr);
         _cappedNotifier->kill();
     }
+    if (_ns.isOplog()) {
+        SharedOplogBuffer::get(getGlobalServiceContext()).clear();
+    }
     _magic = 0;
 }
 
@@ -566,7 +575,8 @@ StatusWith<RecordId> CollectionImpl::updateDocument(OperationContext* opCtx,
                                                     bool enforceQuota,
                                                     bool indexesAffected,
                                                     OpDebug* opDebug,
-                                                    OplogUpdateEntryArgs* args) {
+                                                    OplogUpdateEntryArgs* args,
+                                                    const FieldRefSet* updatedFields) {
     {
         auto status = checkValidation(opCtx, newDoc);
         if (!status.isOK()) {
@@ -617,15 +627,52 @@ StatusWith<RecordId> CollectionImpl::updateDocument(OperationContext* opCtx,
                               << " != "
                               << newDoc.objsize()};
 
-    // At the end of this step, we will have a map of UpdateTickets, one per index, which
+    // An index needs new keys only if the update may have modified one of its paths. Without the
+    // set of updated paths, as for a replacement, every index is updated.
+    auto isIndexAffected = [updatedFields](const IndexCatalogEntry* entry) {
+        if (!updatedFields) {
+            return true;
+        }
+        const UpdateIndexData& indexedPaths = entry->getIndexedPaths();
+        for (const FieldRef* field : *updatedFields) {
+            if (indexedPaths.mightBeIndexed(field->dottedField())) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    // At the end of this step, we will have a map of UpdateTickets, one per affected index, which
     // represent the index updates needed to be done, based on the changes between oldDoc and
     // newDoc.
     OwnedPointerMap<IndexDescriptor*, UpdateTicket> updateTickets;
     if (indexesAffected) {
+        // As when inserting, share tables of the top-level fields of both versions of the
+        // document among the indexes when they look up enough fields in total.
+        size_t numLookups = 0;
+        IndexCatalog::IndexIterator lookupsIt = _indexCatalog.getIndexIterator(opCtx, true);
+        while (lookupsIt.more()) {
+            IndexDescriptor* descriptor = lookupsIt.next();
+            if (isIndexAffected(lookupsIt.catalogEntry(descriptor))) {
+                numLookups += lookupsIt.accessMethod(descriptor)->numTopLevelFieldLookups();
+            }
+        }
+        boost::optional<dps::TopLevelFieldTable> oldFields;
+        boost::optional<dps::TopLevelFieldTable> newFields;
+        if (dps::TopLevelFieldTable::shouldBuild(oldDoc.value(), numLookups)) {
+            oldFields.emplace(oldDoc.value());
+        }
+        if (dps::TopLevelFieldTable::shouldBuild(newDoc, numLookups)) {
+            newFields.emplace(newDoc);
+        }
+
         IndexCatalog::IndexIterator ii = _indexCatalog.getIndexIterator(opCtx, true);
         while (ii.more()) {
             IndexDescriptor* descriptor = ii.next();
             IndexCatalogEntry* entry = ii.catalogEntry(descriptor);
+            if (!isIndexAffected(entry)) {
+                continue;
+            }
             IndexAccessMethod* iam = ii.accessMethod(descriptor);
 
             InsertDeleteOptions options;
@@ -638,7 +685,9 @@ StatusWith<RecordId> CollectionImpl::updateDocument(OperationContext* opCtx,
                                              oldLocation,
                                              options,
                                              updateTicket,
-                                             entry->getFilterExpression());
+                                             entry->getFilterExpression(),
+                                             oldFields.get_ptr(),
+                                             newFields.get_ptr());
             if (!ret.isOK()) {
                 return StatusWith<RecordId>(ret);
             }
@@ -655,17 +704,20 @@ StatusWith<RecordId> CollectionImpl::updateDocument(OperationContext* opCtx,
         return updateStatus;
     }
 
-    // Object did not move.  We update each index with each respective UpdateTicket.
+    // Object did not move.  We update each affected index with its respective UpdateTicket.
     if (indexesAffected) {
         IndexCatalog::IndexIterator ii = _indexCatalog.getIndexIterator(opCtx, true);
         while (ii.more()) {
             IndexDescriptor* descriptor = ii.next();
+            auto ticket = updateTickets.mutableMap().find(descriptor);
+            if (ticket == updateTickets.mutableMap().end()) {
+                continue;
+            }
             IndexAccessMethod* iam = ii.accessMethod(descriptor);
 
             int64_t keysInserted;
             int64_t keysDeleted;
-            Status ret = iam->update(
-                opCtx, *updateTickets.mutableMap()[descriptor], &keysInserted, &keysDeleted);
+            Status ret = iam->update(opCtx, *ticket->second, &keysInserted, &keysDeleted);
             if (!ret.isOK())
                 return StatusWith<RecordId>(ret);
             if (opDebug) {
@@ -857,6 +909,9 @@ Status CollectionImpl::truncate(OperationContext* opCtx) {
     _cursorManager.invalidateAll(opCtx, false, "collection truncated");
 
     // 3) truncate record store
+    if (ns().isOplog()) {
+        SharedOplogBuffer::get(opCtx->getServiceContext()).clear();
+    }
     auto status = _recordStore->truncate(opCtx);
     if (!status.isOK())
         return status;
@@ -878,6 +933,9 @@ void CollectionImpl::cappedTruncateAfter(OperationContext* opCtx, RecordId end,
     invariant(_indexCatalog.numIndexesInProgress(opCtx) == 0);
 
     _cursorManager.invalidateAll(opCtx, false, "capped collection truncated");
+    if (ns().isOplog()) {
+        SharedOplogBuffer::get(opCtx->getServiceContext()).clear();
+    }
     _recordStore->cappedTruncateAfter(opCtx, end, inclusive);
 }
 
@@ -1281,14 +1339,21 @@ Status CollectionImpl::validate(OperationContext* opCtx,
 
         // Validate index key count.
         if (results->valid) {
+            // A validation which doesn't hold the collection exclusively reads a snapshot of it
+            // while other operations keep writing to it, so the index keys are compared with the
+            // number of records the record store validation found in the same snapshot.
+            long long numRecords = _recordStore->numRecords(opCtx);
+            if (!opCtx->lockState()->isCollectionLockedForMode(ns().ns(), MODE_X)) {
+                numRecords = output->asTempObj()["nrecords"].safeNumberLong();
+            }
+
             IndexCatalog::IndexIterator i = _indexCatalog.getIndexIterator(opCtx, false);
             while (i.more()) {
                 IndexDescriptor* descriptor = i.next();
                 ValidateResults& curIndexResults = indexNsResultsMap[descriptor->indexNamespace()];
 
                 if (curIndexResults.valid) {
-                    indexValidator->validateIndexKeyCount(
-                        descriptor, _recordStore->numRecords(opCtx), curIndexResults);
+                    indexValidator->validateIndexKeyCount(descriptor, numRecords, curIndexResults);
                 }
             }
         }
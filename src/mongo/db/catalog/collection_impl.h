@@ -193,6 +193,8 @@ public:
      * Sets 'args.updatedDoc' to the updated version of the document with damages applied, on
      * success.
      * 'opDebug' Optional argument. When not null, will be used to record operation statistics.
+     * 'updatedFields' Optional argument. When not null, holds every path the update may have
+     * modified, and only the indexes on one of those paths are updated; otherwise every index is.
      * @return the post update location of the doc (may or may not be the same as oldLocation)
      */
     StatusWith<RecordId> updateDocument(OperationContext* opCtx,
@@ -202,7 +204,8 @@ public:
                                         bool enforceQuota,
                                         bool indexesAffected,
                                         OpDebug* opDebug,
-                                        OplogUpdateEntryArgs* args) final;
+                                        OplogUpdateEntryArgs* args,
+                                        const FieldRefSet* updatedFields) final;
 
     bool updateWithDamagesSupported() const final;
 
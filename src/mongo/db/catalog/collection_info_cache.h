@@ -29,10 +29,12 @@
 #pragma once
 
 #include "mongo/db/collection_index_usage_tracker.h"
+#include "mongo/db/query/collection_statistics.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/query_settings.h"
 #include "mongo/db/update_index_data.h"
 #include "mongo/stdx/functional.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 class Collection;
@@ -53,8 +55,16 @@ public:
 
         virtual QuerySettings* getQuerySettings() const = 0;
 
+        virtual std::shared_ptr<const CollectionStatistics> getStatistics() const = 0;
+
+        virtual void setStatistics(std::shared_ptr<const CollectionStatistics> stats) = 0;
+
         virtual const UpdateIndexData& getIndexKeys(OperationContext* opCtx) const = 0;
 
+        virtual void ensureIndexDataBuilt(OperationContext* opCtx) const = 0;
+
+        virtual bool evictIndexDataIfIdle(OperationContext* opCtx, Date_t idleSince) = 0;
+
         virtual CollectionIndexUsageMap getIndexUsageStats() const = 0;
 
         virtual void init(OperationContext* opCtx) = 0;
@@ -103,6 +113,21 @@ public:
         return this->_impl().getQuerySettings();
     }
 
+    /**
+     * Returns the field statistics most recently gathered by the 'analyze' command, or nullptr if
+     * the collection has not been analyzed.
+     */
+    inline std::shared_ptr<const CollectionStatistics> getStatistics() const {
+        return this->_impl().getStatistics();
+    }
+
+    /**
+     * Replaces the collection's field statistics.
+     */
+    inline void setStatistics(std::shared_ptr<const CollectionStatistics> stats) {
+        return this->_impl().setStatistics(std::move(stats));
+    }
+
     /* get set of index keys for this namespace.  handy to quickly check if a given
        field is indexed (Note it might be a secondary component of a compound index.)
     */
@@ -110,6 +135,27 @@ public:
         return this->_impl().getIndexKeys(opCtx);
     }
 
+    /**
+     * Builds the index-dependent state of the cache, namely the index keys and the indexability
+     * state of the plan cache, if it is not built yet. Queries must call this before using the
+     * plan cache or the query settings, so that their keys account for the indexes.
+     *
+     * Must be called under at least an intent shared collection lock.
+     */
+    inline void ensureIndexDataBuilt(OperationContext* const opCtx) const {
+        return this->_impl().ensureIndexDataBuilt(opCtx);
+    }
+
+    /**
+     * Discards the index-dependent state of the cache and the cached query plans if they have not
+     * been used since 'idleSince'. Returns whether they were discarded.
+     *
+     * Must be called under exclusive collection lock.
+     */
+    inline bool evictIndexDataIfIdle(OperationContext* const opCtx, const Date_t idleSince) {
+        return this->_impl().evictIndexDataIfIdle(opCtx, idleSince);
+    }
+
     /**
      * Returns cached index usage statistics for this collection.  The map returned will contain
      * entry for each index in the collection along with both a usage counter and a timestamp
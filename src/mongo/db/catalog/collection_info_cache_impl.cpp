@@ -32,19 +32,30 @@
 
 #include "mongo/db/catalog/collection_info_cache_impl.h"
 
+#include <set>
+
+#include "mongo/base/counter.h"
 #include "mongo/base/init.h"
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog/database_holder.h"
+#include "mongo/db/client.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/fts/fts_spec.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/index_legacy.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/planner_ixselect.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/ttl_collection_cache.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/background.h"
 #include "mongo/util/clock_source.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/debug_util.h"
+#include "mongo/util/exit.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -56,17 +67,106 @@ MONGO_INITIALIZER(InitializeCollectionInfoCacheFactory)(InitializerContext* cons
         });
     return Status::OK();
 }
+
+ServerStatusMetricField<Counter64> planCacheLockContentionDisplay(
+    "query.planCacheLockContention", &PlanCache::lockContentionCounter());
+
+// The index-dependent state of a collection's cache is discarded when it has not been used for
+// this long. Zero disables the eviction.
+MONGO_EXPORT_SERVER_PARAMETER(collectionInfoCacheIdleEvictionSecs, int, 15 * 60);
+
+Counter64 indexDataInitializedCounter;
+Counter64 indexDataEvictedCounter;
+
+ServerStatusMetricField<Counter64> indexDataInitializedDisplay(
+    "catalog.collectionInfoCache.initialized", &indexDataInitializedCounter);
+ServerStatusMetricField<Counter64> indexDataEvictedDisplay("catalog.collectionInfoCache.evicted",
+                                                           &indexDataEvictedCounter);
+
+// The caches whose index-dependent state is built, so that the idle ones can be found without
+// going through every collection.
+stdx::mutex builtCachesMutex;
+std::set<const CollectionInfoCacheImpl*> builtCaches;
+
+long long nowMillis() {
+    return getGlobalServiceContext()->getFastClockSource()->now().toMillisSinceEpoch();
+}
+
+/**
+ * Periodically evicts the index-dependent state of the caches which were not used for
+ * collectionInfoCacheIdleEvictionSecs.
+ */
+class CollectionInfoCacheIdleEvictor : public BackgroundJob {
+public:
+    std::string name() const {
+        return "CollectionInfoCacheIdleEvictor";
+    }
+
+    void run() {
+        Client::initThread(name().c_str());
+        while (!globalInShutdownDeprecated()) {
+            {
+                MONGO_IDLE_THREAD_BLOCK;
+                sleepsecs(60);
+            }
+
+            const int idleSecs = collectionInfoCacheIdleEvictionSecs.load();
+            if (idleSecs <= 0) {
+                continue;
+            }
+
+            const ServiceContext::UniqueOperationContext opCtx = cc().makeOperationContext();
+            const Date_t idleSince = Date_t::fromMillisSinceEpoch(nowMillis()) - Seconds(idleSecs);
+            for (const auto& nss : CollectionInfoCacheImpl::getIdleNamespaces(idleSince)) {
+                // The exclusive lock ensures that no operation is using the state being discarded.
+                Lock::DBLock dbLock(opCtx.get(), nss.db(), MODE_IX);
+                Lock::CollectionLock collLock(opCtx->lockState(), nss.ns(), MODE_X);
+
+                Database* db = dbHolder().get(opCtx.get(), nss.db());
+                if (!db) {
+                    continue;
+                }
+                Collection* collection = db->getCollection(opCtx.get(), nss);
+                if (!collection) {
+                    continue;
+                }
+                collection->infoCache()->evictIndexDataIfIdle(opCtx.get(), idleSince);
+            }
+        }
+    }
+};
+
+CollectionInfoCacheIdleEvictor collectionInfoCacheIdleEvictor;
 }  // namespace
 
+void CollectionInfoCacheImpl::startIdleEvictor() {
+    collectionInfoCacheIdleEvictor.go();
+}
+
+std::vector<NamespaceString> CollectionInfoCacheImpl::getIdleNamespaces(Date_t idleSince) {
+    std::vector<NamespaceString> idle;
+    stdx::lock_guard<stdx::mutex> lk(builtCachesMutex);
+    for (const auto* cache : builtCaches) {
+        if (cache->_lastIndexDataUseMillis.load() <= idleSince.toMillisSinceEpoch()) {
+            idle.push_back(cache->_ns);
+        }
+    }
+    return idle;
+}
+
 CollectionInfoCacheImpl::CollectionInfoCacheImpl(Collection* collection, const NamespaceString& ns)
     : _collection(collection),
       _ns(ns),
-      _keysComputed(false),
       _planCache(stdx::make_unique<PlanCache>(ns.ns())),
       _querySettings(stdx::make_unique<QuerySettings>()),
       _indexUsageTracker(getGlobalServiceContext()->getPreciseClockSource()) {}
 
 CollectionInfoCacheImpl::~CollectionInfoCacheImpl() {
+    if (_indexDataBuilt.load()) {
+        stdx::lock_guard<stdx::mutex> lk(builtCachesMutex);
+        builtCaches.erase(this);
+    }
+
     // Necessary because the collection cache will not explicitly get updated upon database drop.
     if (_hasTTLIndex) {
         TTLCollectionCache& ttlCollectionCache = TTLCollectionCache::get(getGlobalServiceContext());
@@ -74,16 +174,104 @@ CollectionInfoCacheImpl::~CollectionInfoCacheImpl() {
     }
 }
 
+void CollectionInfoCacheImpl::addIndexedPaths(const IndexDescriptor* descriptor,
+                                              const MatchExpression* filter,
+                                              UpdateIndexData* indexedPaths) {
+    if (descriptor->getAccessMethodName() != IndexNames::TEXT) {
+        BSONObjIterator j(descriptor->keyPattern());
+        while (j.more()) {
+            BSONElement e = j.next();
+            indexedPaths->addPath(e.fieldName());
+        }
+    } else {
+        fts::FTSSpec ftsSpec(descriptor->infoObj());
+
+        if (ftsSpec.wildcard()) {
+            indexedPaths->allPathsIndexed();
+        } else {
+            for (size_t i = 0; i < ftsSpec.numExtraBefore(); ++i) {
+                indexedPaths->addPath(ftsSpec.extraBefore(i));
+            }
+            for (fts::Weights::const_iterator it = ftsSpec.weights().begin();
+                 it != ftsSpec.weights().end();
+                 ++it) {
+                indexedPaths->addPath(it->first);
+            }
+            for (size_t i = 0; i < ftsSpec.numExtraAfter(); ++i) {
+                indexedPaths->addPath(ftsSpec.extraAfter(i));
+            }
+            // Any update to a path containing "language" as a component could change the
+            // language of a subdocument.  Add the override field as a path component.
+            indexedPaths->addPathComponent(ftsSpec.languageOverrideField());
+        }
+    }
+
+    // handle partial indexes
+    if (filter) {
+        unordered_set<std::string> paths;
+        QueryPlannerIXSelect::getFields(filter, "", &paths);
+        for (auto it = paths.begin(); it != paths.end(); ++it) {
+            indexedPaths->addPath(*it);
+        }
+    }
+}
+
 const UpdateIndexData& CollectionInfoCacheImpl::getIndexKeys(OperationContext* opCtx) const {
     // This requires "some" lock, and MODE_IS is an expression for that, for now.
     dassert(opCtx->lockState()->isCollectionLockedForMode(_collection->ns().ns(), MODE_IS));
-    invariant(_keysComputed);
+    ensureIndexDataBuilt(opCtx);
     return _indexedPaths;
 }
 
-void CollectionInfoCacheImpl::computeIndexKeys(OperationContext* opCtx) {
+void CollectionInfoCacheImpl::ensureIndexDataBuilt(OperationContext* opCtx) const {
+    _lastIndexDataUseMillis.store(nowMillis());
+    if (_indexDataBuilt.load()) {
+        return;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_indexDataMutex);
+    if (_indexDataBuilt.load()) {
+        return;
+    }
+
+    computeIndexKeys(opCtx);
+    updatePlanCacheIndexEntries(opCtx);
+
+    {
+        stdx::lock_guard<stdx::mutex> builtLk(builtCachesMutex);
+        builtCaches.insert(this);
+    }
+    indexDataInitializedCounter.increment();
+    _indexDataBuilt.store(true);
+}
+
+bool CollectionInfoCacheImpl::evictIndexDataIfIdle(OperationContext* opCtx, Date_t idleSince) {
+    // Requires exclusive collection lock.
+    invariant(opCtx->lockState()->isCollectionLockedForMode(_collection->ns().ns(), MODE_X));
+
+    if (!_indexDataBuilt.load() ||
+        _lastIndexDataUseMillis.load() > idleSince.toMillisSinceEpoch()) {
+        return false;
+    }
+
+    LOG(1) << _ns << ": evicting idle collection info cache";
+    resetIndexData();
+    indexDataEvictedCounter.increment();
+    return true;
+}
+
+void CollectionInfoCacheImpl::computeIndexKeys(OperationContext* opCtx) const {
     _indexedPaths.clear();
 
+    IndexCatalog::IndexIterator i = _collection->getIndexCatalog()->getIndexIterator(opCtx, true);
+    while (i.more()) {
+        IndexDescriptor* descriptor = i.next();
+        addIndexedPaths(
+            descriptor, i.catalogEntry(descriptor)->getFilterExpression(), &_indexedPaths);
+    }
+}
+
+void CollectionInfoCacheImpl::updateTTLRegistration(OperationContext* opCtx) {
     bool hadTTLIndex = _hasTTLIndex;
     _hasTTLIndex = false;
 
@@ -91,49 +279,10 @@ void CollectionInfoCacheImpl::computeIndexKeys(OperationContext* opCtx) {
     while (i.more()) {
         IndexDescriptor* descriptor = i.next();
 
-        if (descriptor->getAccessMethodName() != IndexNames::TEXT) {
-            BSONObj key = descriptor->keyPattern();
-            const BSONObj& infoObj = descriptor->infoObj();
-            if (infoObj.hasField("expireAfterSeconds")) {
-                _hasTTLIndex = true;
-            }
-            BSONObjIterator j(key);
-            while (j.more()) {
-                BSONElement e = j.next();
-                _indexedPaths.addPath(e.fieldName());
-            }
-        } else {
-            fts::FTSSpec ftsSpec(descriptor->infoObj());
-
-            if (ftsSpec.wildcard()) {
-                _indexedPaths.allPathsIndexed();
-            } else {
-                for (size_t i = 0; i < ftsSpec.numExtraBefore(); ++i) {
-                    _indexedPaths.addPath(ftsSpec.extraBefore(i));
-                }
-                for (fts::Weights::const_iterator it = ftsSpec.weights().begin();
-                     it != ftsSpec.weights().end();
-                     ++it) {
-                    _indexedPaths.addPath(it->first);
-                }
-                for (size_t i = 0; i < ftsSpec.numExtraAfter(); ++i) {
-                    _indexedPaths.addPath(ftsSpec.extraAfter(i));
-                }
-                // Any update to a path containing "language" as a component could change the
-                // language of a subdocument.  Add the override field as a path component.
-                _indexedPaths.addPathComponent(ftsSpec.languageOverrideField());
-            }
-        }
-
-        // handle partial indexes
-        const IndexCatalogEntry* entry = i.catalogEntry(descriptor);
-        const MatchExpression* filter = entry->getFilterExpression();
-        if (filter) {
-            unordered_set<std::string> paths;
-            QueryPlannerIXSelect::getFields(filter, "", &paths);
-            for (auto it = paths.begin(); it != paths.end(); ++it) {
-                _indexedPaths.addPath(*it);
-            }
+        if (descriptor->getAccessMethodName() != IndexNames::TEXT &&
+            descriptor->infoObj().hasField("expireAfterSeconds")) {
+            _hasTTLIndex = true;
+            break;
         }
     }
 
@@ -146,8 +295,6 @@ void CollectionInfoCacheImpl::computeIndexKeys(OperationContext* opCtx) {
             ttlCollectionCache.unregisterCollection(_collection->ns());
         }
     }
-
-    _keysComputed = true;
 }
 
 void CollectionInfoCacheImpl::notifyOfQuery(OperationContext* opCtx,
@@ -177,7 +324,17 @@ QuerySettings* CollectionInfoCacheImpl::getQuerySettings() const {
     return _querySettings.get();
 }
 
-void CollectionInfoCacheImpl::updatePlanCacheIndexEntries(OperationContext* opCtx) {
+std::shared_ptr<const CollectionStatistics> CollectionInfoCacheImpl::getStatistics() const {
+    stdx::lock_guard<stdx::mutex> lk(_statisticsMutex);
+    return _statistics;
+}
+
+void CollectionInfoCacheImpl::setStatistics(std::shared_ptr<const CollectionStatistics> stats) {
+    stdx::lock_guard<stdx::mutex> lk(_statisticsMutex);
+    _statistics = std::move(stats);
+}
+
+void CollectionInfoCacheImpl::updatePlanCacheIndexEntries(OperationContext* opCtx) const {
     std::vector<IndexEntry> indexEntries;
 
     // TODO We shouldn't need to include unfinished indexes, but we must here because the index
@@ -215,7 +372,8 @@ void CollectionInfoCacheImpl::init(OperationContext* opCtx) {
         _indexUsageTracker.registerIndex(desc->indexName(), desc->keyPattern());
     }
 
-    rebuildIndexData(opCtx);
+    resetIndexData();
+    updateTTLRegistration(opCtx);
 }
 
 void CollectionInfoCacheImpl::addedIndex(OperationContext* opCtx, const IndexDescriptor* desc) {
@@ -223,7 +381,8 @@ void CollectionInfoCacheImpl::addedIndex(OperationContext* opCtx, const IndexDes
     invariant(opCtx->lockState()->isCollectionLockedForMode(_collection->ns().ns(), MODE_X));
     invariant(desc);
 
-    rebuildIndexData(opCtx);
+    resetIndexData();
+    updateTTLRegistration(opCtx);
 
     _indexUsageTracker.registerIndex(desc->indexName(), desc->keyPattern());
 }
@@ -232,16 +391,25 @@ void CollectionInfoCacheImpl::droppedIndex(OperationContext* opCtx, StringData i
     // Requires exclusive collection lock.
     invariant(opCtx->lockState()->isCollectionLockedForMode(_collection->ns().ns(), MODE_X));
 
-    rebuildIndexData(opCtx);
+    resetIndexData();
+    updateTTLRegistration(opCtx);
     _indexUsageTracker.unregisterIndex(indexName);
 }
 
-void CollectionInfoCacheImpl::rebuildIndexData(OperationContext* opCtx) {
+void CollectionInfoCacheImpl::resetIndexData() {
     clearQueryCache();
 
-    _keysComputed = false;
-    computeIndexKeys(opCtx);
-    updatePlanCacheIndexEntries(opCtx);
+    stdx::lock_guard<stdx::mutex> lk(_indexDataMutex);
+    if (!_indexDataBuilt.load()) {
+        return;
+    }
+
+    _indexDataBuilt.store(false);
+    _indexedPaths.clear();
+    _planCache->notifyOfIndexEntries({});
+
+    stdx::lock_guard<stdx::mutex> builtLk(builtCachesMutex);
+    builtCaches.erase(this);
 }
 
 CollectionIndexUsageMap CollectionInfoCacheImpl::getIndexUsageStats() const {
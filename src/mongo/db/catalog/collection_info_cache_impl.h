@@ -31,14 +31,18 @@
 #include "mongo/db/catalog/collection_info_cache.h"
 
 #include "mongo/db/collection_index_usage_tracker.h"
+#include "mongo/db/query/collection_statistics.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/query_settings.h"
 #include "mongo/db/update_index_data.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
 
 namespace mongo {
 
 class Collection;
 class IndexDescriptor;
+class MatchExpression;
 class OperationContext;
 
 /**
@@ -61,11 +65,31 @@ public:
      */
     QuerySettings* getQuerySettings() const;
 
+    /**
+     * Get or replace the field statistics gathered by the 'analyze' command. Safe to call
+     * concurrently, under any collection lock mode.
+     */
+    std::shared_ptr<const CollectionStatistics> getStatistics() const;
+    void setStatistics(std::shared_ptr<const CollectionStatistics> stats);
+
     /* get set of index keys for this namespace.  handy to quickly check if a given
        field is indexed (Note it might be a secondary component of a compound index.)
     */
     const UpdateIndexData& getIndexKeys(OperationContext* opCtx) const;
 
+    /**
+     * Builds the index keys and the indexability state of the plan cache if they are not built
+     * yet. They are built on first use rather than by init(), so that collections which are
+     * never queried or updated do not pay for them.
+     */
+    void ensureIndexDataBuilt(OperationContext* opCtx) const;
+
+    /**
+     * Discards the state built by ensureIndexDataBuilt() and the cached query plans if they have
+     * not been used since 'idleSince'.
+     */
+    bool evictIndexDataIfIdle(OperationContext* opCtx, Date_t idleSince);
+
     /**
      * Returns cached index usage statistics for this collection.  The map returned will contain
      * entry for each index in the collection along with both a usage counter and a timestamp
@@ -80,6 +104,18 @@ public:
      */
     void init(OperationContext* opCtx);
 
+    /**
+     * Starts the background job which evicts the index-dependent state of the caches that were
+     * not used for collectionInfoCacheIdleEvictionSecs.
+     */
+    static void startIdleEvictor();
+
+    /**
+     * Returns the namespaces of the collections whose index-dependent state is built but was not
+     * used since 'idleSince'.
+     */
+    static std::vector<NamespaceString> getIdleNamespaces(Date_t idleSince);
+
     /**
      * Register a newly-created index with the cache.  Must be called whenever an index is
      * built on the associated collection.
@@ -107,22 +143,46 @@ public:
      */
     void notifyOfQuery(OperationContext* opCtx, const std::set<std::string>& indexesUsed);
 
+    /**
+     * Registers in 'indexedPaths' the paths whose modification may change the keys of the index
+     * 'descriptor', or whether a document belongs in the index given its partial filter 'filter',
+     * which may be null.
+     */
+    static void addIndexedPaths(const IndexDescriptor* descriptor,
+                                const MatchExpression* filter,
+                                UpdateIndexData* indexedPaths);
+
 private:
-    void computeIndexKeys(OperationContext* opCtx);
-    void updatePlanCacheIndexEntries(OperationContext* opCtx);
+    void computeIndexKeys(OperationContext* opCtx) const;
+    void updatePlanCacheIndexEntries(OperationContext* opCtx) const;
 
     /**
-     * Rebuilds cached information that is dependent on index composition. Must be called
-     * when index composition changes.
+     * Registers the collection with the TTLCollectionCache if it has a TTL index, or deregisters
+     * it if it no longer has one.
      */
-    void rebuildIndexData(OperationContext* opCtx);
+    void updateTTLRegistration(OperationContext* opCtx);
+
+    /**
+     * Discards cached information that is dependent on index composition, so that it is rebuilt
+     * on next use. Must be called when index composition changes.
+     */
+    void resetIndexData();
 
     Collection* _collection;  // not owned
     const NamespaceString _ns;
 
+    // Protects building and discarding the index keys and the plan cache indexability state.
+    mutable stdx::mutex _indexDataMutex;
+
+    // Set once the index keys and the plan cache indexability state are built. Only cleared under
+    // exclusive collection lock, so readers under a collection lock can rely on it staying set.
+    mutable AtomicWord<bool> _indexDataBuilt{false};
+
+    // When the index-dependent state was last used, in milliseconds since the epoch.
+    mutable AtomicWord<long long> _lastIndexDataUseMillis{0};
+
     // ---  index keys cache
-    bool _keysComputed;
-    UpdateIndexData _indexedPaths;
+    mutable UpdateIndexData _indexedPaths;
 
     // A cache for query plans.
     std::unique_ptr<PlanCache> _planCache;
@@ -131,6 +191,12 @@ private:
     // Includes index filters.
     std::unique_ptr<QuerySettings> _querySettings;
 
+    // Field statistics for cost estimation. Null until the collection is analyzed.
+    std::shared_ptr<const CollectionStatistics> _statistics;
+
+    // Protects _statistics.
+    mutable stdx::mutex _statisticsMutex;
+
     // Tracks index usage statistics for this collection.
     CollectionIndexUsageTracker _indexUsageTracker;
 
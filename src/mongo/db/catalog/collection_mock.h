@@ -169,7 +169,8 @@ public:
                                         bool enforceQuota,
                                         bool indexesAffected,
                                         OpDebug* opDebug,
-                                        OplogUpdateEntryArgs* args) {
+                                        OplogUpdateEntryArgs* args,
+                                        const FieldRefSet* updatedFields) {
         std::abort();
     }
 
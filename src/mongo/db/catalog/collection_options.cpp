@@ -175,6 +175,8 @@ Status CollectionOptions::parse(const BSONObj& options, ParseKind kind) {
             flagsSet = true;
         } else if (fieldName == "temp") {
             temp = e.trueValue();
+        } else if (fieldName == "clustered") {
+            clustered = e.trueValue();
         } else if (fieldName == "storageEngine") {
             Status status = checkStorageEngineOptions(e);
             if (!status.isOK()) {
@@ -243,6 +245,12 @@ Status CollectionOptions::parse(const BSONObj& options, ParseKind kind) {
             }
 
             pipeline = e.Obj().getOwned();
+        } else if (fieldName == "materialized") {
+            if (e.type() != mongo::Object) {
+                return Status(ErrorCodes::BadValue, "'materialized' has to be a document.");
+            }
+
+            materialized = e.Obj().getOwned();
         } else if (!createdOn24OrEarlier && !Command::isGenericArgument(fieldName)) {
             return Status(ErrorCodes::InvalidOptions,
                           str::stream() << "The field '" << fieldName
@@ -255,6 +263,24 @@ Status CollectionOptions::parse(const BSONObj& options, ParseKind kind) {
         return Status(ErrorCodes::BadValue, "'pipeline' cannot be specified without 'viewOn'");
     }
 
+    if (viewOn.empty() && !materialized.isEmpty()) {
+        return Status(ErrorCodes::BadValue, "'materialized' cannot be specified without 'viewOn'");
+    }
+
+    if (clustered) {
+        if (capped) {
+            return Status(ErrorCodes::BadValue, "a clustered collection cannot be capped");
+        }
+        if (autoIndexId == NO) {
+            return Status(ErrorCodes::BadValue,
+                          "a clustered collection must have an _id index, so autoIndexId cannot be"
+                          " false");
+        }
+        if (!viewOn.empty()) {
+            return Status(ErrorCodes::BadValue, "a view cannot be clustered");
+        }
+    }
+
     return Status::OK();
 }
 
@@ -287,6 +313,9 @@ BSONObj CollectionOptions::toBSON() const {
     if (temp)
         b.appendBool("temp", true);
 
+    if (clustered)
+        b.appendBool("clustered", true);
+
     if (!storageEngine.isEmpty()) {
         b.append("storageEngine", storageEngine);
     }
@@ -319,6 +348,10 @@ BSONObj CollectionOptions::toBSON() const {
         b.append("pipeline", pipeline);
     }
 
+    if (!materialized.isEmpty()) {
+        b.append("materialized", materialized);
+    }
+
     return b.obj();
 }
 }
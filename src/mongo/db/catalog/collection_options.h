@@ -115,6 +115,10 @@ struct CollectionOptions {
 
     bool temp = false;
 
+    // Whether the RecordId of each document is derived from its _id, so that the documents are
+    // stored in _id order and can be found by _id without going through the _id index.
+    bool clustered = false;
+
     // Storage engine collection options. Always owned or empty.
     BSONObj storageEngine;
 
@@ -135,5 +139,8 @@ struct CollectionOptions {
     std::string viewOn;
     // The aggregation pipeline that defines this view.
     BSONObj pipeline;
+    // The options of a materialized view, or empty if the view is not materialized. Always owned
+    // or empty.
+    BSONObj materialized;
 };
 }
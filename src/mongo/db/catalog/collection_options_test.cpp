@@ -252,6 +252,23 @@ TEST(CollectionOptions, PipelineFieldRequiresViewOn) {
     ASSERT_NOT_OK(options.parse(fromjson("{pipeline: [{$match: {}}]}")));
 }
 
+TEST(CollectionOptions, ClusteredParsesCorrectly) {
+    CollectionOptions options;
+    ASSERT_OK(options.parse(fromjson("{clustered: true}")));
+    ASSERT_TRUE(options.clustered);
+    ASSERT_BSONOBJ_EQ(options.toBSON(), fromjson("{clustered: true}"));
+}
+
+TEST(CollectionOptions, ClusteredCannotBeCapped) {
+    CollectionOptions options;
+    ASSERT_NOT_OK(options.parse(fromjson("{clustered: true, capped: true, size: 1024}")));
+}
+
+TEST(CollectionOptions, ClusteredRequiresIdIndex) {
+    CollectionOptions options;
+    ASSERT_NOT_OK(options.parse(fromjson("{clustered: true, autoIndexId: false}")));
+}
+
 TEST(CollectionOptions, UnknownTopLevelOptionFailsToParse) {
     CollectionOptions options;
     auto status = options.parse(fromjson("{invalidOption: 1}"));
@@ -380,16 +380,19 @@ void CursorManager::invalidateDocument(OperationContext* opCtx,
         return;
     }
 
-    auto allExecPartitions = _registeredPlanExecutors.lockAllPartitions();
-    for (auto&& partition : allExecPartitions) {
-        for (auto&& exec : partition) {
+    // Without document locking, the caller's collection lock excludes any other use of this
+    // collection's executors, so the partitions can be visited one at a time rather than blocking
+    // registrations on all of them for the whole walk.
+    for (size_t partitionId = 0; partitionId < kNumPartitions; ++partitionId) {
+        auto lockedPartition = _registeredPlanExecutors.lockOnePartitionById(partitionId);
+        for (auto&& exec : *lockedPartition) {
             exec->invalidate(opCtx, dl, type);
         }
     }
 
-    auto allPartitions = _cursorMap->lockAllPartitions();
-    for (auto&& partition : allPartitions) {
-        for (auto&& entry : partition) {
+    for (size_t partitionId = 0; partitionId < kNumPartitions; ++partitionId) {
+        auto lockedPartition = _cursorMap->lockOnePartitionById(partitionId);
+        for (auto&& entry : *lockedPartition) {
             auto exec = entry.second->getExecutor();
             exec->invalidate(opCtx, dl, type);
         }
@@ -488,28 +491,21 @@ size_t CursorManager::numCursors() const {
     return _cursorMap->size();
 }
 
-CursorId CursorManager::allocateCursorId_inlock() {
-    for (int i = 0; i < 10000; i++) {
-        // The leading two bits of a CursorId are used to determine if the cursor is registered on
-        // the global cursor manager.
-        CursorId id;
-        if (isGlobalManager()) {
-            // This is the global cursor manager, so generate a random number and make sure the
-            // first two bits are 01.
-            uint64_t mask = 0x3FFFFFFFFFFFFFFF;
-            uint64_t bitToSet = 1ULL << 62;
-            id = ((_random->nextInt64() & mask) | bitToSet);
-        } else {
-            // The first 2 bits are 0, the next 30 bits are the collection identifier, the next 32
-            // bits are random.
-            uint32_t myPart = static_cast<uint32_t>(_random->nextInt32());
-            id = cursorIdFromParts(_collectionCacheRuntimeId, myPart);
-        }
-        auto partition = _cursorMap->lockOnePartition(id);
-        if (partition->count(id) == 0)
-            return id;
+CursorId CursorManager::generateCursorId_inlock() {
+    // The leading two bits of a CursorId are used to determine if the cursor is registered on
+    // the global cursor manager.
+    if (isGlobalManager()) {
+        // This is the global cursor manager, so generate a random number and make sure the
+        // first two bits are 01.
+        uint64_t mask = 0x3FFFFFFFFFFFFFFF;
+        uint64_t bitToSet = 1ULL << 62;
+        return ((_random->nextInt64() & mask) | bitToSet);
+    } else {
+        // The first 2 bits are 0, the next 30 bits are the collection identifier, the next 32
+        // bits are random.
+        uint32_t myPart = static_cast<uint32_t>(_random->nextInt32());
+        return cursorIdFromParts(_collectionCacheRuntimeId, myPart);
     }
-    fassertFailed(17360);
 }
 
 ClientCursorPin CursorManager::registerCursor(OperationContext* opCtx,
@@ -524,18 +520,29 @@ ClientCursorPin CursorManager::registerCursor(OperationContext* opCtx,
     cursorParams.exec.get_deleter().dismissDisposal();
     cursorParams.exec->unsetRegistered();
 
-    // Note we must hold the registration lock from now until insertion into '_cursorMap' to ensure
-    // we don't insert two cursors with the same cursor id.
-    stdx::lock_guard<SimpleMutex> lock(_registrationLock);
-    CursorId cursorId = allocateCursorId_inlock();
-    std::unique_ptr<ClientCursor, ClientCursor::Deleter> clientCursor(
-        new ClientCursor(std::move(cursorParams), this, cursorId, now));
-
-    // Transfer ownership of the cursor to '_cursorMap'.
-    auto partition = _cursorMap->lockOnePartition(cursorId);
-    ClientCursor* unownedCursor = clientCursor.release();
-    partition->emplace(cursorId, unownedCursor);
-    return ClientCursorPin(opCtx, unownedCursor);
+    for (int i = 0; i < 10000; i++) {
+        CursorId cursorId;
+        {
+            stdx::lock_guard<SimpleMutex> lock(_registrationLock);
+            cursorId = generateCursorId_inlock();
+        }
+
+        // Checking that the id is unused and inserting the cursor under the same partition lock
+        // ensures we don't insert two cursors with the same cursor id, while registrations landing
+        // in other partitions proceed concurrently.
+        auto partition = _cursorMap->lockOnePartition(cursorId);
+        if (partition->count(cursorId) != 0) {
+            continue;
+        }
+        std::unique_ptr<ClientCursor, ClientCursor::Deleter> clientCursor(
+            new ClientCursor(std::move(cursorParams), this, cursorId, now));
+
+        // Transfer ownership of the cursor to '_cursorMap'.
+        ClientCursor* unownedCursor = clientCursor.release();
+        partition->emplace(cursorId, unownedCursor);
+        return ClientCursorPin(opCtx, unownedCursor);
+    }
+    fassertFailed(17360);
 }
 
 void CursorManager::deregisterCursor(ClientCursor* cc) {
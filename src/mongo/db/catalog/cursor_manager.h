@@ -198,7 +198,11 @@ private:
     struct PlanExecutorPartitioner {
         std::size_t operator()(const PlanExecutor* exec, std::size_t nPartitions);
     };
-    CursorId allocateCursorId_inlock();
+    /**
+     * Returns a random cursor id for this cursor manager, which may already be in use. Must be
+     * called while holding '_registrationLock'.
+     */
+    CursorId generateCursorId_inlock();
 
     ClientCursorPin _registerCursor(
         OperationContext* opCtx, std::unique_ptr<ClientCursor, ClientCursor::Deleter> clientCursor);
@@ -227,9 +231,10 @@ private:
     // this cursor manager. The two registration data structures '_registeredPlanExecutors' and
     // '_cursorMap' are partitioned to decrease contention, and each partition of the structure is
     // protected by its own mutex. Separately, there is a '_registrationLock' which protects
-    // concurrent access to '_random' for cursor id generation, and must be held from cursor id
-    // generation until insertion into '_cursorMap'. If you ever need to acquire more than one of
-    // these mutexes at once, you must follow the following rules:
+    // concurrent access to '_random' for cursor id generation. It is released before locking the
+    // partition of '_cursorMap' which a new id falls into, where the id is checked for uniqueness
+    // and the cursor inserted under that partition's lock. If you ever need to acquire more than
+    // one of these mutexes at once, you must follow the following rules:
     // - '_registrationLock' must be acquired first, if at all.
     // - Mutex(es) for '_registeredPlanExecutors' must be acquired next.
     // - Mutex(es) for '_cursorMap' must be acquired next.
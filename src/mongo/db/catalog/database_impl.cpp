@@ -644,6 +644,11 @@ void DatabaseImpl::_checkCanCreateCollection(OperationContext* opCtx,
 
     uassert(17316, "cannot create a blank collection", nss.coll() > 0);
     uassert(28838, "cannot create a non-capped oplog collection", options.capped || !nss.isOplog());
+
+    StorageEngine* storageEngine = getGlobalServiceContext()->getGlobalStorageEngine();
+    uassert(40645,
+            "the storage engine does not support clustered collections",
+            !options.clustered || storageEngine->supportsClusteredCollections());
 }
 
 Status DatabaseImpl::createView(OperationContext* opCtx,
@@ -661,7 +666,12 @@ Status DatabaseImpl::createView(OperationContext* opCtx,
         return Status(ErrorCodes::InvalidNamespace,
                       str::stream() << "invalid namespace name for a view: " + nss.toString());
 
-    return _views.createView(opCtx, nss, viewOnNss, BSONArray(options.pipeline), options.collation);
+    return _views.createView(opCtx,
+                             nss,
+                             viewOnNss,
+                             BSONArray(options.pipeline),
+                             options.collation,
+                             options.materialized);
 }
 
 Collection* DatabaseImpl::createCollection(OperationContext* opCtx,
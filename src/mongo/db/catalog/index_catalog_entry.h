@@ -51,6 +51,7 @@ class IndexAccessMethod;
 class IndexDescriptor;
 class MatchExpression;
 class OperationContext;
+class UpdateIndexData;
 
 class IndexCatalogEntry {
 public:
@@ -77,6 +78,8 @@ public:
 
         virtual const MatchExpression* getFilterExpression() const = 0;
 
+        virtual const UpdateIndexData& getIndexedPaths() const = 0;
+
         virtual const CollatorInterface* getCollator() const = 0;
 
         virtual const RecordId& head(OperationContext* opCtx) const = 0;
@@ -161,6 +164,14 @@ public:
         return this->_impl().getFilterExpression();
     }
 
+    /**
+     * Returns the paths whose modification can change this index's keys, including the paths of
+     * its partial filter.
+     */
+    inline const UpdateIndexData& getIndexedPaths() const {
+        return this->_impl().getIndexedPaths();
+    }
+
     inline const CollatorInterface* getCollator() const {
         return this->_impl().getCollator();
     }
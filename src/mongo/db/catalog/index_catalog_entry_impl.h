@@ -38,6 +38,7 @@
 #include "mongo/db/record_id.h"
 #include "mongo/db/storage/kv/kv_prefix.h"
 #include "mongo/db/storage/snapshot_name.h"
+#include "mongo/db/update_index_data.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
 
@@ -94,6 +95,10 @@ public:
         return _filterExpression.get();
     }
 
+    const UpdateIndexData& getIndexedPaths() const final {
+        return _indexedPaths;
+    }
+
     const CollatorInterface* getCollator() const final {
         return _collator.get();
     }
@@ -192,6 +197,8 @@ private:
     std::unique_ptr<CollatorInterface> _collator;
     std::unique_ptr<MatchExpression> _filterExpression;
 
+    UpdateIndexData _indexedPaths;
+
     // cached stuff
 
     Ordering _ordering;  // TODO: this might be b-tree specific
@@ -39,6 +39,7 @@
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/audit.h"
 #include "mongo/db/background.h"
+#include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/collection_catalog_entry.h"
 #include "mongo/db/catalog/database_catalog_entry.h"
@@ -48,6 +49,7 @@
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/field_ref.h"
+#include "mongo/db/hasher.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/index_legacy.h"
@@ -109,6 +111,8 @@ using std::vector;
 
 using IndexVersion = IndexDescriptor::IndexVersion;
 
+namespace dps = ::mongo::dotted_path_support;
+
 static const int INDEX_CATALOG_INIT = 283711;
 static const int INDEX_CATALOG_UNINIT = 654321;
 
@@ -1219,6 +1223,15 @@ IndexDescriptor* IndexCatalogImpl::findShardKeyPrefixedIndex(OperationContext* o
         if (!shardKey.isPrefixOf(desc->keyPattern(), SimpleBSONElementComparator::kInstance))
             continue;
 
+        // Hashed shard keys always hash with the default seed and function, so a hashed index
+        // that uses others doesn't order the documents by shard key.
+        if (desc->getAccessMethodName() == IndexNames::HASHED) {
+            BSONElement seed = desc->infoObj()["seed"];
+            if ((!seed.eoo() && seed.numberInt() != BSONElementHasher::DEFAULT_HASH_SEED) ||
+                desc->infoObj()["hashVersion"].numberInt() != BSONElementHasher::MD5_HASH_VERSION)
+                continue;
+        }
+
         if (!desc->isMultikey(opCtx) && hasSimpleCollation)
             return desc;
 
@@ -1298,18 +1311,39 @@ const IndexDescriptor* IndexCatalogImpl::refreshEntry(OperationContext* opCtx,
 
 // ---------------------------
 
-Status IndexCatalogImpl::_indexFilteredRecords(OperationContext* opCtx,
-                                               IndexCatalogEntry* index,
-                                               const std::vector<BsonRecord>& bsonRecords,
-                                               int64_t* keysInsertedOut) {
+Status IndexCatalogImpl::_indexFilteredRecords(
+    OperationContext* opCtx,
+    IndexCatalogEntry* index,
+    const std::vector<BsonRecord>& bsonRecords,
+    const std::vector<const dps::TopLevelFieldTable*>& fieldTables,
+    int64_t* keysInsertedOut) {
     InsertDeleteOptions options;
     prepareInsertDeleteOptions(opCtx, index->descriptor(), &options);
 
-    for (auto bsonRecord : bsonRecords) {
+    if (bsonRecords.size() > 1) {
+        for (const auto& bsonRecord : bsonRecords) {
+            invariant(bsonRecord.id != RecordId());
+        }
+
+        // Insert the keys of all of the records in one pass over the index, in key order.
+        int64_t inserted;
+        Status status = index->accessMethod()->insertBatch(
+            opCtx, bsonRecords, options, &inserted, &fieldTables);
+        if (!status.isOK())
+            return status;
+
+        if (keysInsertedOut) {
+            *keysInsertedOut += inserted;
+        }
+        return Status::OK();
+    }
+
+    for (size_t i = 0; i < bsonRecords.size(); ++i) {
+        const BsonRecord& bsonRecord = bsonRecords[i];
         int64_t inserted;
         invariant(bsonRecord.id != RecordId());
         Status status = index->accessMethod()->insert(
-            opCtx, *bsonRecord.docPtr, bsonRecord.id, options, &inserted);
+            opCtx, *bsonRecord.docPtr, bsonRecord.id, options, &inserted, fieldTables[i]);
         if (!status.isOK())
             return status;
 
@@ -1320,21 +1354,27 @@ Status IndexCatalogImpl::_indexFilteredRecords(OperationContext* opCtx,
     return Status::OK();
 }
 
-Status IndexCatalogImpl::_indexRecords(OperationContext* opCtx,
-                                       IndexCatalogEntry* index,
-                                       const std::vector<BsonRecord>& bsonRecords,
-                                       int64_t* keysInsertedOut) {
+Status IndexCatalogImpl::_indexRecords(
+    OperationContext* opCtx,
+    IndexCatalogEntry* index,
+    const std::vector<BsonRecord>& bsonRecords,
+    const std::vector<const dps::TopLevelFieldTable*>& fieldTables,
+    int64_t* keysInsertedOut) {
     const MatchExpression* filter = index->getFilterExpression();
     if (!filter)
-        return _indexFilteredRecords(opCtx, index, bsonRecords, keysInsertedOut);
+        return _indexFilteredRecords(opCtx, index, bsonRecords, fieldTables, keysInsertedOut);
 
     std::vector<BsonRecord> filteredBsonRecords;
-    for (auto bsonRecord : bsonRecords) {
-        if (filter->matchesBSON(*(bsonRecord.docPtr)))
-            filteredBsonRecords.push_back(bsonRecord);
+    std::vector<const dps::TopLevelFieldTable*> filteredFieldTables;
+    for (size_t i = 0; i < bsonRecords.size(); ++i) {
+        if (filter->matchesBSON(*(bsonRecords[i].docPtr))) {
+            filteredBsonRecords.push_back(bsonRecords[i]);
+            filteredFieldTables.push_back(fieldTables[i]);
+        }
     }
 
-    return _indexFilteredRecords(opCtx, index, filteredBsonRecords, keysInsertedOut);
+    return _indexFilteredRecords(
+        opCtx, index, filteredBsonRecords, filteredFieldTables, keysInsertedOut);
 }
 
 Status IndexCatalogImpl::_unindexRecord(OperationContext* opCtx,
@@ -1378,9 +1418,26 @@ Status IndexCatalogImpl::indexRecords(OperationContext* opCtx,
         *keysInsertedOut = 0;
     }
 
+    // Each index looks up fields of every document to generate its keys. When the indexes
+    // together look up enough of them, build a table of each document's top-level fields once
+    // and share it among all of the indexes, rather than have every index scan the document.
+    size_t numLookups = 0;
+    for (auto&& entry : _entries) {
+        numLookups += entry->accessMethod()->numTopLevelFieldLookups();
+    }
+    std::vector<std::unique_ptr<dps::TopLevelFieldTable>> ownedFieldTables;
+    std::vector<const dps::TopLevelFieldTable*> fieldTables(bsonRecords.size(), nullptr);
+    for (size_t i = 0; i < bsonRecords.size(); ++i) {
+        if (dps::TopLevelFieldTable::shouldBuild(*bsonRecords[i].docPtr, numLookups)) {
+            ownedFieldTables.push_back(
+                stdx::make_unique<dps::TopLevelFieldTable>(*bsonRecords[i].docPtr));
+            fieldTables[i] = ownedFieldTables.back().get();
+        }
+    }
+
     for (IndexCatalogEntryContainer::const_iterator i = _entries.begin(); i != _entries.end();
          ++i) {
-        Status s = _indexRecords(opCtx, i->get(), bsonRecords, keysInsertedOut);
+        Status s = _indexRecords(opCtx, i->get(), bsonRecords, fieldTables, keysInsertedOut);
         if (!s.isOK())
             return s;
     }
@@ -50,6 +50,10 @@ class IndexDescriptor;
 class IndexAccessMethod;
 struct InsertDeleteOptions;
 
+namespace dotted_path_support {
+class TopLevelFieldTable;
+}  // namespace dotted_path_support
+
 /**
  * how many: 1 per Collection.
  * lifecycle: attached to a Collection.
@@ -373,15 +377,23 @@ private:
 
     void _checkMagic() const;
 
-    Status _indexFilteredRecords(OperationContext* opCtx,
-                                 IndexCatalogEntry* index,
-                                 const std::vector<BsonRecord>& bsonRecords,
-                                 int64_t* keysInsertedOut);
+    /**
+     * 'fieldTables' holds a table of the top-level fields, or null, for each document in
+     * 'bsonRecords'. The tables are shared by all of the indexes.
+     */
+    Status _indexFilteredRecords(
+        OperationContext* opCtx,
+        IndexCatalogEntry* index,
+        const std::vector<BsonRecord>& bsonRecords,
+        const std::vector<const dotted_path_support::TopLevelFieldTable*>& fieldTables,
+        int64_t* keysInsertedOut);
 
-    Status _indexRecords(OperationContext* opCtx,
-                         IndexCatalogEntry* index,
-                         const std::vector<BsonRecord>& bsonRecords,
-                         int64_t* keysInsertedOut);
+    Status _indexRecords(
+        OperationContext* opCtx,
+        IndexCatalogEntry* index,
+        const std::vector<BsonRecord>& bsonRecords,
+        const std::vector<const dotted_path_support::TopLevelFieldTable*>& fieldTables,
+        int64_t* keysInsertedOut);
 
     Status _unindexRecord(OperationContext* opCtx,
                           IndexCatalogEntry* index,
@@ -82,6 +82,8 @@ public:
 
         virtual Status doneInserting(std::set<RecordId>* dupsOut = NULL) = 0;
 
+        virtual Status drainBackgroundWrites(std::set<RecordId>* dupsOut = nullptr) = 0;
+
         virtual void commit() = 0;
 
         virtual void abortWithoutCleanup() = 0;
@@ -229,9 +231,29 @@ public:
         return this->_impl().doneInserting(dupsOut);
     }
 
+    /**
+     * Applies the writes made to the collection since the end of the collection scan to the
+     * indexes of a background build which bulk loads them, and checks their unique constraints.
+     * Must be called after insertAllDocumentsInCollection() or doneInserting() return success and
+     * before commit(). Does nothing for other builds.
+     *
+     * If dupsOut is passed as non-NULL, violators of uniqueness constraints will be added to
+     * the set rather than failing the build. Unlike for doneInserting(), these documents are
+     * indexed, and callers MUST either fail this index build or delete the documents from the
+     * collection.
+     *
+     * Should not be called inside of a WriteUnitOfWork.
+     *
+     * Requires holding an exclusive lock on the collection.
+     */
+    inline Status drainBackgroundWrites(std::set<RecordId>* const dupsOut = nullptr) {
+        return this->_impl().drainBackgroundWrites(dupsOut);
+    }
+
     /**
      * Marks the index ready for use. Should only be called as the last method after
-     * doneInserting() or insertAllDocumentsInCollection() return success.
+     * doneInserting() or insertAllDocumentsInCollection(), then drainBackgroundWrites(), return
+     * success.
      *
      * Should be called inside of a WriteUnitOfWork. If the index building is to be logOp'd,
      * logOp() should be called from the same unit of work as commit().
@@ -32,6 +32,8 @@
 
 #include "mongo/db/catalog/index_create_impl.h"
 
+#include <deque>
+
 #include "mongo/base/error_codes.h"
 #include "mongo/base/init.h"
 #include "mongo/client/dbclientinterface.h"
@@ -43,12 +45,15 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/index/index_build_side_writes.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
@@ -99,6 +104,185 @@ public:
 
 } exportedMaxIndexBuildMemoryUsageParameter;
 
+// Maximum number of threads generating the index keys of the documents scanned by a foreground
+// index build
+MONGO_EXPORT_SERVER_PARAMETER(maxIndexBuildKeyGenerationThreads, int, 4);
+
+// Whether background index builds bulk load the index like foreground builds do, recording the
+// concurrent writes to the collection on the side until the bulk load is done, rather than
+// inserting each scanned document into the index as it goes
+MONGO_EXPORT_SERVER_PARAMETER(bulkLoadBackgroundIndexBuilds, bool, true);
+
+namespace {
+
+// Collections with fewer documents than this are not worth starting key generation threads for
+const long long kMinRecordsForParallelKeyGeneration = 10000;
+
+/**
+ * Generates the index keys for the documents scanned by a foreground index build on a set of
+ * worker threads, while the scanning thread keeps reading the collection. The documents are
+ * handed to the workers in batches and each worker adds the keys to its own partition of the bulk
+ * builders, so that every partition is sorted independently and they are only merged when the
+ * bulk builders are committed.
+ */
+class ParallelKeyGenerator {
+    MONGO_DISALLOW_COPYING(ParallelKeyGenerator);
+
+public:
+    using InsertFn = stdx::function<Status(size_t, const BSONObj&, const RecordId&)>;
+
+    ParallelKeyGenerator(size_t numThreads, InsertFn insertFn) : _insertFn(std::move(insertFn)) {
+        for (size_t partition = 0; partition < numThreads; partition++) {
+            _threads.emplace_back([this, partition] { _workerLoop(partition); });
+        }
+    }
+
+    /**
+     * Stops the workers without waiting for them to process the queued documents, if finish() was
+     * not called, which is the case when the index build fails.
+     */
+    ~ParallelKeyGenerator() {
+        _shutdown(false);
+    }
+
+    /**
+     * Queues an owned document for key generation. Returns an error if any of the workers failed
+     * generating keys, in which case the index build must fail.
+     */
+    Status add(BSONObj doc, const RecordId& loc) {
+        _currentBatchBytes += doc.objsize();
+        _currentBatch.emplace_back(std::move(doc), loc);
+
+        if (_currentBatch.size() < kMaxBatchDocuments && _currentBatchBytes < kMaxBatchBytes) {
+            return Status::OK();
+        }
+
+        return _enqueueCurrentBatch();
+    }
+
+    /**
+     * Waits for the keys of all the added documents to be generated and returns the first error
+     * encountered by any of the workers.
+     */
+    Status finish() {
+        Status status = _enqueueCurrentBatch();
+        _shutdown(true);
+
+        if (!status.isOK()) {
+            return status;
+        }
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        return _status;
+    }
+
+private:
+    using Batch = std::vector<std::pair<BSONObj, RecordId>>;
+
+    static const size_t kMaxBatchDocuments = 1024;
+    static const int kMaxBatchBytes = 16 * 1024 * 1024;
+
+    Status _enqueueCurrentBatch() {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+
+        // Bound the memory used by the queued documents
+        _queueNotFull.wait(
+            lk, [&] { return _queue.size() < 2 * _threads.size() || !_status.isOK(); });
+        if (!_status.isOK()) {
+            return _status;
+        }
+
+        if (!_currentBatch.empty()) {
+            _queue.push_back(std::move(_currentBatch));
+            _queueNotEmpty.notify_one();
+        }
+
+        _currentBatch.clear();
+        _currentBatchBytes = 0;
+
+        return Status::OK();
+    }
+
+    void _shutdown(bool drain) {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _inShutdown = true;
+            if (!drain) {
+                _queue.clear();
+            }
+        }
+
+        _queueNotEmpty.notify_all();
+        _queueNotFull.notify_all();
+
+        for (auto& thread : _threads) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+    }
+
+    void _workerLoop(size_t partition) {
+        while (true) {
+            Batch batch;
+            {
+                stdx::unique_lock<stdx::mutex> lk(_mutex);
+                _queueNotEmpty.wait(
+                    lk, [&] { return !_queue.empty() || _inShutdown || !_status.isOK(); });
+                if (_queue.empty() || !_status.isOK()) {
+                    return;
+                }
+
+                batch = std::move(_queue.front());
+                _queue.pop_front();
+                _queueNotFull.notify_one();
+            }
+
+            Status status = [&] {
+                try {
+                    for (const auto& entry : batch) {
+                        Status insertStatus = _insertFn(partition, entry.first, entry.second);
+                        if (!insertStatus.isOK()) {
+                            return insertStatus;
+                        }
+                    }
+                    return Status::OK();
+                } catch (const DBException& ex) {
+                    return ex.toStatus();
+                }
+            }();
+
+            if (!status.isOK()) {
+                stdx::lock_guard<stdx::mutex> lk(_mutex);
+                if (_status.isOK()) {
+                    _status = std::move(status);
+                }
+                _queueNotEmpty.notify_all();
+                _queueNotFull.notify_all();
+                return;
+            }
+        }
+    }
+
+    const InsertFn _insertFn;
+
+    // Only accessed by the scanning thread
+    Batch _currentBatch;
+    int _currentBatchBytes{0};
+
+    // Protects the state below
+    stdx::mutex _mutex;
+    stdx::condition_variable _queueNotEmpty;
+    stdx::condition_variable _queueNotFull;
+    std::deque<Batch> _queue;
+    bool _inShutdown{false};
+    Status _status{Status::OK()};
+
+    std::vector<stdx::thread> _threads;
+};
+
+}  // namespace
+
 
 /**
  * On rollback sets MultiIndexBlockImpl::_needToCleanup to true.
@@ -227,6 +411,12 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlockImpl::init(const std::vector<BSO
             indexSpecs.size();
     }
 
+    // The memory available to each index is split between the bulk builders of all the key
+    // generation threads
+    _numKeyGenerationThreads = _getNumKeyGenerationThreads();
+    const std::size_t eachBulkBuilderMaxMemoryUsageBytes =
+        eachIndexBuildMaxMemoryUsageBytes / _numKeyGenerationThreads;
+
     for (size_t i = 0; i < indexSpecs.size(); i++) {
         BSONObj info = indexSpecs[i];
         StatusWith<BSONObj> statusWithInfo =
@@ -251,7 +441,17 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlockImpl::init(const std::vector<BSO
         if (!_buildInBackground) {
             // Bulk build process requires foreground building as it assumes nothing is changing
             // under it.
-            index.bulk = index.real->initiateBulk(eachIndexBuildMaxMemoryUsageBytes);
+            index.bulk = index.real->initiateBulk(eachBulkBuilderMaxMemoryUsageBytes);
+            for (size_t j = 1; j < _numKeyGenerationThreads; j++) {
+                index.parallelBulks.push_back(
+                    index.real->initiateBulk(eachBulkBuilderMaxMemoryUsageBytes));
+            }
+        } else if (bulkLoadBackgroundIndexBuilds.load()) {
+            // The collection is locked exclusively, so every write made to it from now on will be
+            // recorded rather than applied to the index being bulk loaded.
+            index.bulk = index.real->initiateBulk(eachBulkBuilderMaxMemoryUsageBytes);
+            index.sideWrites = std::make_shared<IndexBuildSideWrites>();
+            index.real->setSideWrites(index.sideWrites);
         }
 
         const IndexDescriptor* descriptor = index.block->getEntry()->descriptor();
@@ -315,6 +515,16 @@ Status MultiIndexBlockImpl::insertAllDocumentsInCollection(std::set<RecordId>* d
     auto exec =
         InternalPlanner::collectionScan(_opCtx, _collection->ns().ns(), _collection, yieldPolicy);
 
+    std::unique_ptr<ParallelKeyGenerator> keyGenerator;
+    if (_numKeyGenerationThreads > 1) {
+        log() << "\t generating index keys using " << _numKeyGenerationThreads << " threads";
+        keyGenerator = stdx::make_unique<ParallelKeyGenerator>(
+            _numKeyGenerationThreads,
+            [this](size_t partition, const BSONObj& doc, const RecordId& loc) {
+                return _insertIntoPartition(partition, doc, loc);
+            });
+    }
+
     Snapshotted<BSONObj> objToIndex;
     RecordId loc;
     PlanExecutor::ExecState state;
@@ -336,22 +546,32 @@ Status MultiIndexBlockImpl::insertAllDocumentsInCollection(std::set<RecordId>* d
             // Done before insert so we can retry document if it WCEs.
             progress->setTotalWhileRunning(_collection->numRecords(_opCtx));
 
-            WriteUnitOfWork wunit(_opCtx);
-            Status ret = insert(objToIndex.value(), loc);
-            if (_buildInBackground)
-                exec->saveState();
-            if (ret.isOK()) {
-                wunit.commit();
-            } else if (dupsOut && ret.code() == ErrorCodes::DuplicateKey) {
-                // If dupsOut is non-null, we should only fail the specific insert that
-                // led to a DuplicateKey rather than the whole index build.
-                dupsOut->insert(loc);
+            if (keyGenerator) {
+                // The keys are generated and added to the bulk builders by the key generation
+                // threads, which do not write anything. Bulk builders never report duplicates
+                // before they are committed.
+                Status ret = keyGenerator->add(objToIndex.value().getOwned(), loc);
+                if (!ret.isOK()) {
+                    return ret;
+                }
             } else {
-                // Fail the index build hard.
-                return ret;
+                WriteUnitOfWork wunit(_opCtx);
+                Status ret = insert(objToIndex.value(), loc);
+                if (_buildInBackground)
+                    exec->saveState();
+                if (ret.isOK()) {
+                    wunit.commit();
+                } else if (dupsOut && ret.code() == ErrorCodes::DuplicateKey) {
+                    // If dupsOut is non-null, we should only fail the specific insert that
+                    // led to a DuplicateKey rather than the whole index build.
+                    dupsOut->insert(loc);
+                } else {
+                    // Fail the index build hard.
+                    return ret;
+                }
+                if (_buildInBackground)
+                    exec->restoreState();  // Handles any WCEs internally.
             }
-            if (_buildInBackground)
-                exec->restoreState();  // Handles any WCEs internally.
 
             // Go to the next document
             progress->hit();
@@ -375,6 +595,13 @@ Status MultiIndexBlockImpl::insertAllDocumentsInCollection(std::set<RecordId>* d
                 WorkingSetCommon::toStatusString(objToIndex.value()),
             state == PlanExecutor::IS_EOF);
 
+    if (keyGenerator) {
+        Status ret = keyGenerator->finish();
+        if (!ret.isOK()) {
+            return ret;
+        }
+    }
+
     if (MONGO_FAIL_POINT(hangAfterStartingIndexBuild)) {
         // Need the index build to hang before the progress meter is marked as finished so we can
         // reliably check that the index build has actually started in js tests.
@@ -432,20 +659,120 @@ Status MultiIndexBlockImpl::insert(const BSONObj& doc, const RecordId& loc) {
     return Status::OK();
 }
 
+Status MultiIndexBlockImpl::_insertIntoPartition(size_t partition,
+                                                 const BSONObj& doc,
+                                                 const RecordId& loc) {
+    for (auto& index : _indexes) {
+        if (index.filterExpression && !index.filterExpression->matchesBSON(doc)) {
+            continue;
+        }
+
+        auto& bulk = (partition == 0) ? index.bulk : index.parallelBulks[partition - 1];
+
+        // Generating the keys does not use the operation context, which belongs to the scanning
+        // thread
+        Status status = bulk->insert(nullptr, doc, loc, index.options, nullptr);
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+
+    return Status::OK();
+}
+
+size_t MultiIndexBlockImpl::_getNumKeyGenerationThreads() const {
+    if (_buildInBackground) {
+        return 1;
+    }
+
+    const int maxThreads = maxIndexBuildKeyGenerationThreads.load();
+    if (maxThreads <= 1 || _collection->numRecords(_opCtx) < kMinRecordsForParallelKeyGeneration) {
+        return 1;
+    }
+
+    return std::max(1U, std::min(static_cast<unsigned>(maxThreads), ProcessInfo().getNumCores()));
+}
+
 Status MultiIndexBlockImpl::doneInserting(std::set<RecordId>* dupsOut) {
     for (size_t i = 0; i < _indexes.size(); i++) {
         if (_indexes[i].bulk == NULL)
             continue;
         LOG(1) << "\t bulk commit starting for index: "
                << _indexes[i].block->getEntry()->descriptor()->indexName();
+
+        std::vector<std::unique_ptr<IndexAccessMethod::BulkBuilder>> bulks;
+        bulks.push_back(std::move(_indexes[i].bulk));
+        for (auto& parallelBulk : _indexes[i].parallelBulks) {
+            bulks.push_back(std::move(parallelBulk));
+        }
+        _indexes[i].parallelBulks.clear();
+
+        if (!_indexes[i].sideWrites) {
+            Status status = _indexes[i].real->commitBulk(_opCtx,
+                                                         std::move(bulks),
+                                                         _allowInterruption,
+                                                         _indexes[i].options.dupsAllowed,
+                                                         dupsOut);
+            if (!status.isOK()) {
+                return status;
+            }
+            continue;
+        }
+
+        // As the collection scan of a background build yields, it can see a value of a unique key
+        // both in a document which was then deleted and in one which was inserted afterwards. The
+        // keys indexed for several documents are only checked once the side writes, which contain
+        // the deletion, are applied.
+        const bool dupsAllowed = _indexes[i].options.dupsAllowed;
         Status status = _indexes[i].real->commitBulk(_opCtx,
-                                                     std::move(_indexes[i].bulk),
+                                                     std::move(bulks),
                                                      _allowInterruption,
-                                                     _indexes[i].options.dupsAllowed,
-                                                     dupsOut);
+                                                     true,
+                                                     nullptr,
+                                                     &_indexes[i].duplicateKeys);
+        if (!status.isOK()) {
+            return status;
+        }
+
+        // Catch up with the writes made during the collection scan while writers can still
+        // proceed, so that there are few of them left to apply with the collection locked.
+        status = _indexes[i].real->drainSideWrites(
+            _opCtx, _allowInterruption, dupsAllowed, &_indexes[i].duplicateKeys);
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+
+    return Status::OK();
+}
+
+Status MultiIndexBlockImpl::drainBackgroundWrites(std::set<RecordId>* dupsOut) {
+    for (auto& index : _indexes) {
+        if (!index.sideWrites) {
+            continue;
+        }
+
+        invariant(
+            _opCtx->lockState()->isCollectionLockedForMode(_collection->ns().ns(), MODE_X));
+
+        Status status = index.real->drainSideWrites(
+            _opCtx, _allowInterruption, index.options.dupsAllowed, &index.duplicateKeys);
         if (!status.isOK()) {
             return status;
         }
+
+        // No write to the collection can be in progress while it is locked exclusively.
+        invariant(index.sideWrites->size() == 0);
+        index.real->setSideWrites(nullptr);
+        index.sideWrites.reset();
+
+        if (!index.options.dupsAllowed) {
+            status = index.real->checkDuplicateKeys(_opCtx, index.duplicateKeys, dupsOut);
+            if (!status.isOK()) {
+                return status;
+            }
+        }
+        index.duplicateKeys.clear();
     }
 
     return Status::OK();
@@ -458,6 +785,8 @@ void MultiIndexBlockImpl::abortWithoutCleanup() {
 
 void MultiIndexBlockImpl::commit() {
     for (size_t i = 0; i < _indexes.size(); i++) {
+        // The index would miss the writes not drained by drainBackgroundWrites().
+        invariant(!_indexes[i].sideWrites);
         _indexes[i].block->success();
     }
 
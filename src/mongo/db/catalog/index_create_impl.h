@@ -46,6 +46,7 @@ namespace mongo {
 
 class BackgroundOperation;
 class BSONObj;
+class IndexBuildSideWrites;
 class Collection;
 class OperationContext;
 
@@ -159,7 +160,8 @@ public:
 
     /**
      * Marks the index ready for use. Should only be called as the last method after
-     * doneInserting() or insertAllDocumentsInCollection() return success.
+     * doneInserting() or insertAllDocumentsInCollection(), then drainBackgroundWrites(), return
+     * success.
      *
      * Should be called inside of a WriteUnitOfWork. If the index building is to be logOp'd,
      * logOp() should be called from the same unit of work as commit().
@@ -168,6 +170,23 @@ public:
      */
     void commit() override;
 
+    /**
+     * Applies the writes made to the collection since the end of the collection scan to the
+     * indexes of a background build which bulk loads them, and checks their unique constraints.
+     * Must be called after insertAllDocumentsInCollection() or doneInserting() return success and
+     * before commit(). Does nothing for other builds.
+     *
+     * If dupsOut is passed as non-NULL, violators of uniqueness constraints will be added to
+     * the set rather than failing the build. Unlike for doneInserting(), these documents are
+     * indexed, and callers MUST either fail this index build or delete the documents from the
+     * collection.
+     *
+     * Should not be called inside of a WriteUnitOfWork.
+     *
+     * Requires holding an exclusive lock on the collection.
+     */
+    Status drainBackgroundWrites(std::set<RecordId>* dupsOut = nullptr) override;
+
     /**
      * May be called at any time after construction but before a successful commit(). Suppresses
      * the default behavior on destruction of removing all traces of uncommitted index builds.
@@ -199,9 +218,34 @@ private:
         const MatchExpression* filterExpression;  // might be NULL, owned elsewhere
         std::unique_ptr<IndexAccessMethod::BulkBuilder> bulk;
 
+        // Additional bulk builders, one for each key generation thread other than the first,
+        // which uses 'bulk'. Only used by parallel foreground builds.
+        std::vector<std::unique_ptr<IndexAccessMethod::BulkBuilder>> parallelBulks;
+
+        // Records the writes made to the collection by other operations while a background build
+        // bulk loads the index. Set on 'real' until drainBackgroundWrites() applies them.
+        std::shared_ptr<IndexBuildSideWrites> sideWrites;
+
+        // The keys which may be indexed for more than one document, despite the index being
+        // unique. Only filled by background builds which bulk load the index.
+        BSONObjSet duplicateKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+
         InsertDeleteOptions options;
     };
 
+    /**
+     * Returns how many threads should generate the keys of the documents scanned by
+     * insertAllDocumentsInCollection. Only foreground builds of large enough collections use
+     * more than one.
+     */
+    size_t _getNumKeyGenerationThreads() const;
+
+    /**
+     * Generates the keys of 'doc' for all the indexes being built and adds them to the bulk
+     * builders of the key generation thread 'partition'. Must only be called by that thread.
+     */
+    Status _insertIntoPartition(size_t partition, const BSONObj& doc, const RecordId& loc);
+
     std::vector<IndexToBuild> _indexes;
 
     std::unique_ptr<BackgroundOperation> _backgroundOperation;
@@ -215,6 +259,9 @@ private:
     bool _ignoreUnique;
 
     bool _needToCleanup;
+
+    // Number of threads generating the keys for the documents of the collection scan
+    size_t _numKeyGenerationThreads = 1;
 };
 
 }  // namespace mongo
@@ -38,6 +38,7 @@
 #include "mongo/base/status.h"
 #include "mongo/base/status_with.h"
 #include "mongo/db/field_ref.h"
+#include "mongo/db/hasher.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/index_names.h"
 #include "mongo/db/jsobj.h"
@@ -75,6 +76,7 @@ static const std::set<StringData> allowedFieldNames = {
     IndexDescriptor::kDropDuplicatesFieldName,
     IndexDescriptor::kExpireAfterSecondsFieldName,
     IndexDescriptor::kGeoHaystackBucketSize,
+    IndexDescriptor::kHashVersionFieldName,
     IndexDescriptor::kIndexNameFieldName,
     IndexDescriptor::kIndexVersionFieldName,
     IndexDescriptor::kKeyPatternFieldName,
@@ -333,6 +335,29 @@ StatusWith<BSONObj> validateIndexSpec(
             }
 
             hasCollationField = true;
+        } else if (IndexDescriptor::kHashVersionFieldName == indexSpecElemFieldName) {
+            if (!indexSpecElem.isNumber()) {
+                return {ErrorCodes::TypeMismatch,
+                        str::stream() << "The field '" << IndexDescriptor::kHashVersionFieldName
+                                      << "' must be a number, but got "
+                                      << typeName(indexSpecElem.type())};
+            }
+
+            auto hashVersion = representAs<int>(indexSpecElem.number());
+            if (!hashVersion || !BSONElementHasher::isSupportedHashVersion(*hashVersion)) {
+                return {ErrorCodes::CannotCreateIndex,
+                        str::stream() << "Unsupported value for the field '"
+                                      << IndexDescriptor::kHashVersionFieldName
+                                      << "': "
+                                      << indexSpecElem.toString(false, false)};
+            }
+
+            if (IndexNames::findPluginName(indexSpec.getObjectField(
+                    IndexDescriptor::kKeyPatternFieldName)) != IndexNames::HASHED) {
+                return {ErrorCodes::CannotCreateIndex,
+                        str::stream() << "The field '" << IndexDescriptor::kHashVersionFieldName
+                                      << "' is only valid for hashed indexes"};
+            }
         } else {
             // We can assume field name is valid at this point. Validation of fieldname is handled
             // prior to this in validateIndexSpecFieldNames().
@@ -693,6 +693,64 @@ TEST(IndexSpecValidateTest, ReturnsAnErrorIfUnknownFieldIsPresentInSpecV1) {
     ASSERT_EQ(ErrorCodes::InvalidIndexSpecificationOption, result);
 }
 
+TEST(IndexSpecValidateTest, AcceptsSupportedHashVersionsForHashedIndexes) {
+    ServerGlobalParams::FeatureCompatibility featureCompatibility;
+    featureCompatibility.version.store(ServerGlobalParams::FeatureCompatibility::Version::k34);
+    featureCompatibility.validateFeaturesAsMaster.store(true);
+
+    for (int hashVersion : {0, 1}) {
+        auto result = validateIndexSpec(BSON("key" << BSON("field"
+                                                           << "hashed")
+                                                   << "name"
+                                                   << "indexName"
+                                                   << "hashVersion"
+                                                   << hashVersion),
+                                        kTestNamespace,
+                                        featureCompatibility);
+        ASSERT_OK(result.getStatus());
+    }
+}
+
+TEST(IndexSpecValidateTest, ReturnsAnErrorIfHashVersionIsUnsupported) {
+    ServerGlobalParams::FeatureCompatibility featureCompatibility;
+    featureCompatibility.version.store(ServerGlobalParams::FeatureCompatibility::Version::k34);
+    featureCompatibility.validateFeaturesAsMaster.store(true);
+
+    auto result = validateIndexSpec(BSON("key" << BSON("field"
+                                                       << "hashed")
+                                               << "name"
+                                               << "indexName"
+                                               << "hashVersion"
+                                               << 2),
+                                    kTestNamespace,
+                                    featureCompatibility);
+    ASSERT_EQ(ErrorCodes::CannotCreateIndex, result);
+
+    result = validateIndexSpec(BSON("key" << BSON("field"
+                                                  << "hashed")
+                                          << "name"
+                                          << "indexName"
+                                          << "hashVersion"
+                                          << "1"),
+                               kTestNamespace,
+                               featureCompatibility);
+    ASSERT_EQ(ErrorCodes::TypeMismatch, result);
+}
+
+TEST(IndexSpecValidateTest, ReturnsAnErrorIfHashVersionIsPresentOnANonHashedIndex) {
+    ServerGlobalParams::FeatureCompatibility featureCompatibility;
+    featureCompatibility.version.store(ServerGlobalParams::FeatureCompatibility::Version::k34);
+    featureCompatibility.validateFeaturesAsMaster.store(true);
+
+    auto result = validateIndexSpec(BSON("key" << BSON("field" << 1) << "name"
+                                               << "indexName"
+                                               << "hashVersion"
+                                               << 1),
+                                    kTestNamespace,
+                                    featureCompatibility);
+    ASSERT_EQ(ErrorCodes::CannotCreateIndex, result);
+}
+
 TEST(IdIndexSpecValidateTest, ReturnsAnErrorIfKeyPatternIsIncorrectForIdIndex) {
     ASSERT_EQ(ErrorCodes::BadValue,
               validateIdIndexSpec(BSON("key" << BSON("_id" << -1) << "name"
@@ -26,10 +26,13 @@
  *    it in the license file.
  */
 
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/clientcursor.h"
 
+#include <algorithm>
 #include <string>
 #include <time.h>
 #include <vector>
@@ -46,12 +49,12 @@
 #include "mongo/db/commands/server_status.h"
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/query/find_common.h"
 #include "mongo/db/repl/repl_client_info.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/server_parameters.h"
-#include "mongo/util/background.h"
-#include "mongo/util/concurrency/idle_thread_block.h"
-#include "mongo/util/exit.h"
+#include "mongo/util/log.h"
+#include "mongo/util/periodic_runner.h"
 
 namespace mongo {
 
@@ -73,6 +76,13 @@ static ServerStatusMetricField<Counter64> dCursorStatusTimedout("cursor.timedOut
 
 MONGO_EXPORT_SERVER_PARAMETER(clientCursorMonitorFrequencySecs, int, 4);
 
+// The time a getMore batch without a batchSize should take the client to consume, judging by how
+// fast it consumed the previous batch. Zero disables adaptive sizing of getMore batches.
+MONGO_EXPORT_SERVER_PARAMETER(cursorAdaptiveBatchTargetMillis, int, 1000);
+
+// The smallest getMore batch adaptive sizing may return, in bytes.
+MONGO_EXPORT_SERVER_PARAMETER(cursorAdaptiveBatchMinBytes, int, 1024 * 1024);
+
 long long ClientCursor::totalOpen() {
     return cursorStatsOpen.get();
 }
@@ -113,6 +123,23 @@ ClientCursor::~ClientCursor() {
     }
 }
 
+int ClientCursor::getBatchByteBudget(Date_t now) const {
+    const int maxBytes = FindCommon::kMaxBytesToReturnToClientAtOnce;
+    const long long targetMillis = cursorAdaptiveBatchTargetMillis.load();
+    const long long consumptionMillis = durationCount<Milliseconds>(now - _lastBatchReturnedDate);
+    if (targetMillis <= 0 || _lastBatchBytes <= 0 || consumptionMillis <= targetMillis) {
+        // The client got through the last batch at least as fast as targeted, or there is
+        // nothing to measure yet.
+        return maxBytes;
+    }
+
+    // Scale the last batch by how much faster than this client the target is.
+    const long long budget = static_cast<long long>(_lastBatchBytes) * targetMillis /
+        consumptionMillis;
+    const long long minBytes = std::min(cursorAdaptiveBatchMinBytes.load(), maxBytes);
+    return static_cast<int>(std::max(budget, minBytes));
+}
+
 void ClientCursor::markAsKilled(const std::string& reason) {
     _exec->markAsKilled(reason);
 }
@@ -263,34 +290,24 @@ ClientCursor* ClientCursorPin::getCursor() const {
 // ClientCursorMonitor
 //
 
+namespace {
+
 /**
- * Thread for timing out inactive cursors.
+ * Periodic job for timing out inactive cursors.
  */
-class ClientCursorMonitor : public BackgroundJob {
-public:
-    std::string name() const {
-        return "ClientCursorMonitor";
+void timeOutInactiveCursors() {
+    try {
+        const ServiceContext::UniqueOperationContext opCtx = cc().makeOperationContext();
+        auto now = opCtx->getServiceContext()->getPreciseClockSource()->now();
+        cursorStatsTimedOut.increment(CursorManager::timeoutCursorsGlobal(opCtx.get(), now));
+    } catch (const DBException& ex) {
+        warning() << "Failed to time out inactive cursors: " << ex.toStatus();
     }
+}
 
-    void run() {
-        Client::initThread("clientcursormon");
-        while (!globalInShutdownDeprecated()) {
-            {
-                const ServiceContext::UniqueOperationContext opCtx = cc().makeOperationContext();
-                auto now = opCtx->getServiceContext()->getPreciseClockSource()->now();
-                cursorStatsTimedOut.increment(
-                    CursorManager::timeoutCursorsGlobal(opCtx.get(), now));
-            }
-            MONGO_IDLE_THREAD_BLOCK;
-            sleepsecs(clientCursorMonitorFrequencySecs.load());
-        }
-    }
-};
+}  // namespace
 
 namespace {
-// Only one instance of the ClientCursorMonitor exists
-ClientCursorMonitor clientCursorMonitor;
-
 void _appendCursorStats(BSONObjBuilder& b) {
     b.append("note", "deprecated, use server status metrics");
     b.appendNumber("clientCursors_size", cursorStatsOpen.get());
@@ -302,7 +319,8 @@ void _appendCursorStats(BSONObjBuilder& b) {
 }
 
 void startClientCursorMonitor() {
-    clientCursorMonitor.go();
+    getGlobalServiceContext()->getPeriodicRunner()->scheduleJob(
+        {timeOutInactiveCursors, [] { return Seconds(clientCursorMonitorFrequencySecs.load()); }});
 }
 
 }  // namespace mongo
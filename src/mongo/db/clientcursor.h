@@ -173,6 +173,23 @@ public:
         _leftoverMaxTimeMicros = leftoverMaxTimeMicros;
     }
 
+    /**
+     * Returns how many bytes a getMore without a batchSize should return at 'now'. This is sized
+     * after the rate at which the client consumed the previous batch, as measured from when it was
+     * returned until 'now', so that slow consumers are not handed more data than they can get
+     * through in cursorAdaptiveBatchTargetMillis. Fast consumers get the usual 16MB.
+     */
+    int getBatchByteBudget(Date_t now) const;
+
+    /**
+     * Records that a batch of 'batchBytes' was returned to the client at 'now', for
+     * getBatchByteBudget() to measure the client's consumption rate.
+     */
+    void recordBatchReturned(int batchBytes, Date_t now) {
+        _lastBatchBytes = batchBytes;
+        _lastBatchReturnedDate = now;
+    }
+
     //
     // Replication-related methods.
     //
@@ -280,6 +297,11 @@ private:
     // Unused maxTime budget for this cursor.
     Microseconds _leftoverMaxTimeMicros = Microseconds::max();
 
+    // The size of the last batch returned by this cursor, and when it was returned. Used to size
+    // the next batch after the client's consumption rate.
+    int _lastBatchBytes = 0;
+    Date_t _lastBatchReturnedDate;
+
     // The underlying query execution machinery. Must be non-null.
     std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> _exec;
 
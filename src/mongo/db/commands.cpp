@@ -75,6 +75,19 @@ ExportedServerParameter<bool, ServerParameterType::kStartupOnly> testCommandsPar
 
 Command::~Command() = default;
 
+bool Command::enhancedRun(OperationContext* opCtx,
+                          const OpMsgRequest& request,
+                          std::string& errmsg,
+                          BSONObjBuilder& result) {
+    uassert(40642,
+            str::stream() << "The " << getName() << " command does not accept document sequences",
+            request.sequences.empty());
+
+    // run expects const db std::string (can't bind to temporary)
+    const std::string db = request.getDatabase().toString();
+    return run(opCtx, db, request.body, errmsg, result);
+}
+
 string Command::parseNsFullyQualified(const string& dbname, const BSONObj& cmdObj) {
     BSONElement first = cmdObj.firstElement();
     uassert(ErrorCodes::BadValue,
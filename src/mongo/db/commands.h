@@ -45,6 +45,7 @@
 #include "mongo/db/write_concern.h"
 #include "mongo/rpc/reply_builder_interface.h"
 #include "mongo/stdx/functional.h"
+#include "mongo/util/net/op_msg.h"
 #include "mongo/util/string_map.h"
 
 namespace mongo {
@@ -106,6 +107,16 @@ public:
                      std::string& errmsg,
                      BSONObjBuilder& result) = 0;
 
+    /**
+     * Runs the command against a full OP_MSG request, including any document sequences. Commands
+     * that accept document sequences implement this to consume them without first folding them
+     * into the command body.
+     */
+    virtual bool enhancedRun(OperationContext* opCtx,
+                             const OpMsgRequest& request,
+                             std::string& errmsg,
+                             BSONObjBuilder& result) = 0;
+
     /**
      * supportsWriteConcern returns true if this command should be parsed for a writeConcern
      * field and wait for that write concern to be satisfied after the command runs.
@@ -309,6 +320,14 @@ public:
         return 0u;
     }
 
+    /**
+     * Rejects requests that carry document sequences and runs the command on the request body.
+     */
+    bool enhancedRun(OperationContext* opCtx,
+                     const OpMsgRequest& request,
+                     std::string& errmsg,
+                     BSONObjBuilder& result) override;
+
     bool adminOnly() const override {
         return false;
     }
@@ -0,0 +1,235 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/index_names.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/query/collection_statistics.h"
+#include "mongo/platform/random.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+const long long kDefaultSampleSize = 1000;
+const long long kMaxSampleSize = 100 * 1000;
+const long long kMaxNumBuckets = 1000;
+
+/**
+ * Returns the fields that make up the key patterns of the collection's non-special indexes, in
+ * index order and without duplicates.
+ */
+std::vector<std::string> getIndexedFields(OperationContext* opCtx, Collection* collection) {
+    std::vector<std::string> fields;
+    std::set<std::string> seen;
+    IndexCatalog::IndexIterator it =
+        collection->getIndexCatalog()->getIndexIterator(opCtx, false);
+    while (it.more()) {
+        const IndexDescriptor* desc = it.next();
+        if (!IndexNames::findPluginName(desc->keyPattern()).empty()) {
+            continue;
+        }
+        for (auto&& elem : desc->keyPattern()) {
+            if (seen.insert(elem.fieldName()).second) {
+                fields.push_back(elem.fieldName());
+            }
+        }
+    }
+    return fields;
+}
+
+/**
+ * Draws up to 'sampleSize' documents from 'collection'. Uses the storage engine's random cursor
+ * when it has one and the collection is larger than the sample, and otherwise reservoir-samples
+ * a full scan.
+ */
+std::vector<BSONObj> sampleDocuments(OperationContext* opCtx,
+                                     Collection* collection,
+                                     long long sampleSize) {
+    std::vector<BSONObj> sample;
+    const long long numRecords = collection->numRecords(opCtx);
+
+    if (numRecords > sampleSize) {
+        if (auto cursor = collection->getRecordStore()->getRandomCursor(opCtx)) {
+            while (static_cast<long long>(sample.size()) < sampleSize) {
+                auto record = cursor->next();
+                if (!record) {
+                    break;
+                }
+                sample.push_back(record->data.releaseToBson().getOwned());
+                if (sample.size() % 128 == 0) {
+                    opCtx->checkForInterrupt();
+                }
+            }
+            return sample;
+        }
+    }
+
+    PseudoRandom random(Date_t::now().asInt64());
+    auto cursor = collection->getCursor(opCtx);
+    long long numSeen = 0;
+    while (auto record = cursor->next()) {
+        ++numSeen;
+        if (static_cast<long long>(sample.size()) < sampleSize) {
+            sample.push_back(record->data.releaseToBson().getOwned());
+        } else {
+            const long long slot = random.nextInt64(numSeen);
+            if (slot < sampleSize) {
+                sample[slot] = record->data.releaseToBson().getOwned();
+            }
+        }
+        if (numSeen % 128 == 0) {
+            opCtx->checkForInterrupt();
+        }
+    }
+    return sample;
+}
+
+/**
+ * { analyze: <collection>, fields: [<path>, ...], sampleSize: <int>, buckets: <int> }
+ *
+ * Samples the collection and stores an equi-depth histogram and distinct value estimate for each
+ * of 'fields', which defaults to every field of every index. The statistics are kept in memory
+ * with the collection's plan cache and are used to estimate the cost of candidate plans.
+ */
+class AnalyzeCmd : public Command {
+public:
+    AnalyzeCmd() : Command("analyze") {}
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    bool slaveOk() const override {
+        return false;
+    }
+
+    bool slaveOverrideOk() const override {
+        return true;
+    }
+
+    void help(std::stringstream& help) const override {
+        help << "Samples a collection and gathers field statistics for the query planner.";
+    }
+
+    Status checkAuthForCommand(Client* client,
+                               const std::string& dbname,
+                               const BSONObj& cmdObj) override {
+        if (AuthorizationSession::get(client)->isAuthorizedForActionsOnResource(
+                parseResourcePattern(dbname, cmdObj), ActionType::planCacheWrite)) {
+            return Status::OK();
+        }
+        return Status(ErrorCodes::Unauthorized, "unauthorized");
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             std::string& errmsg,
+             BSONObjBuilder& result) override {
+        const NamespaceString nss(parseNsCollectionRequired(dbname, cmdObj));
+
+        long long sampleSize = kDefaultSampleSize;
+        if (auto elem = cmdObj["sampleSize"]) {
+            if (!elem.isNumber() || elem.numberLong() < 1 || elem.numberLong() > kMaxSampleSize) {
+                return appendCommandStatus(
+                    result,
+                    Status(ErrorCodes::BadValue,
+                           str::stream() << "sampleSize must be a number between 1 and "
+                                         << kMaxSampleSize));
+            }
+            sampleSize = elem.numberLong();
+        }
+
+        long long numBuckets = FieldHistogram::kDefaultNumBuckets;
+        if (auto elem = cmdObj["buckets"]) {
+            if (!elem.isNumber() || elem.numberLong() < 1 || elem.numberLong() > kMaxNumBuckets) {
+                return appendCommandStatus(
+                    result,
+                    Status(ErrorCodes::BadValue,
+                           str::stream() << "buckets must be a number between 1 and "
+                                         << kMaxNumBuckets));
+            }
+            numBuckets = elem.numberLong();
+        }
+
+        std::vector<std::string> fields;
+        if (auto elem = cmdObj["fields"]) {
+            if (elem.type() != Array) {
+                return appendCommandStatus(
+                    result, Status(ErrorCodes::BadValue, "fields must be an array of strings"));
+            }
+            for (auto&& field : elem.Obj()) {
+                if (field.type() != String || field.valueStringData().empty()) {
+                    return appendCommandStatus(
+                        result,
+                        Status(ErrorCodes::BadValue, "fields must be an array of strings"));
+                }
+                fields.push_back(field.String());
+            }
+        }
+
+        AutoGetCollectionForReadCommand ctx(opCtx, nss);
+        Collection* collection = ctx.getCollection();
+        if (!collection) {
+            return appendCommandStatus(
+                result,
+                Status(ErrorCodes::NamespaceNotFound,
+                       str::stream() << "ns does not exist: " << nss.ns()));
+        }
+
+        if (fields.empty()) {
+            fields = getIndexedFields(opCtx, collection);
+        }
+
+        auto stats = std::make_shared<const CollectionStatistics>(
+            CollectionStatistics::make(sampleDocuments(opCtx, collection, sampleSize),
+                                       fields,
+                                       collection->numRecords(opCtx),
+                                       static_cast<size_t>(numBuckets)));
+        stats->appendTo(&result);
+        collection->infoCache()->setStatistics(std::move(stats));
+        return true;
+    }
+
+} analyzeCmd;
+
+}  // namespace
+}  // namespace mongo
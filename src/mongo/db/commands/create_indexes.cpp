@@ -381,6 +381,10 @@ public:
             Database* db = dbHolder().get(opCtx, ns.db());
             uassert(28551, "database dropped during index build", db);
             uassert(28552, "collection dropped during index build", db->getCollection(opCtx, ns));
+
+            // No more writes can be made to the collection, so the ones made during the build
+            // can all be applied to the indexes.
+            uassertStatusOK(indexer.drainBackgroundWrites());
         }
 
         MONGO_WRITE_CONFLICT_RETRY_LOOP_BEGIN {
@@ -44,6 +44,7 @@
 #include "mongo/db/matcher/matcher.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/query/query_memory_budget.h"
 #include "mongo/db/stats/fill_locker_info.h"
 #include "mongo/rpc/metadata/client_metadata.h"
 #include "mongo/rpc/metadata/client_metadata_ismaster.h"
@@ -164,6 +165,7 @@ public:
                 }
 
                 CurOp::get(clientOpCtx)->reportState(&infoBuilder);
+                QueryMemoryBudget::appendOperationUsage(clientOpCtx, &infoBuilder);
 
                 // LockState
                 Locker::LockerInfo lockerInfo;
@@ -32,6 +32,8 @@
 
 #include "mongo/platform/basic.h"
 
+#include <boost/optional.hpp>
+#include <deque>
 #include <map>
 #include <string>
 
@@ -43,9 +45,14 @@
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/internal_plans.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/log.h"
 #include "mongo/util/md5.hpp"
+#include "mongo/util/processinfo.h"
 #include "mongo/util/timer.h"
 
 namespace mongo {
@@ -56,8 +63,165 @@ using std::string;
 using std::unique_ptr;
 using std::vector;
 
+// Maximum number of threads hashing the documents read by a dbHash command
+MONGO_EXPORT_SERVER_PARAMETER(maxDBHashThreads, int, 4);
+
 namespace {
 
+/**
+ * Computes the MD5 hashes of collections on a set of worker threads, while the thread running the
+ * command keeps reading the documents of the next collections. Each collection is hashed by a
+ * single worker, which is handed its documents in batches and in order, so that its hash is the
+ * same as when computed serially. Reading stays on the command's thread, which holds the locks
+ * keeping the database from changing.
+ */
+class ParallelCollectionHasher {
+    MONGO_DISALLOW_COPYING(ParallelCollectionHasher);
+
+public:
+    explicit ParallelCollectionHasher(size_t numThreads) : _queues(numThreads) {
+        for (size_t worker = 0; worker < numThreads; worker++) {
+            _threads.emplace_back([this, worker] { _workerLoop(worker); });
+        }
+    }
+
+    /**
+     * Stops the workers without waiting for them to hash the queued documents, if finish() was not
+     * called, which is the case when the command fails.
+     */
+    ~ParallelCollectionHasher() {
+        _shutdown(false);
+    }
+
+    /**
+     * Starts hashing another collection, whose documents are passed to add() until the next call.
+     * Returns the index of its hash in the result of finish().
+     */
+    size_t startCollection() {
+        _enqueueCurrentBatch();
+
+        _states.push_back(stdx::make_unique<md5_state_t>());
+        md5_init(_states.back().get());
+        _currentBatch.state = _states.back().get();
+        _currentWorker = (_states.size() - 1) % _threads.size();
+
+        return _states.size() - 1;
+    }
+
+    void add(const BSONObj& doc) {
+        _currentBatchBytes += doc.objsize();
+        _currentBatch.docs.push_back(doc.getOwned());
+
+        if (_currentBatch.docs.size() >= kMaxBatchDocuments ||
+            _currentBatchBytes >= kMaxBatchBytes) {
+            _enqueueCurrentBatch();
+        }
+    }
+
+    /**
+     * Waits for all the added documents to be hashed and returns the hash of every collection.
+     */
+    std::vector<std::string> finish() {
+        _enqueueCurrentBatch();
+        _shutdown(true);
+
+        std::vector<std::string> hashes;
+        for (const auto& state : _states) {
+            md5digest d;
+            md5_finish(state.get(), d);
+            hashes.push_back(digestToString(d));
+        }
+        return hashes;
+    }
+
+private:
+    struct Batch {
+        md5_state_t* state = nullptr;
+        std::vector<BSONObj> docs;
+    };
+
+    static const size_t kMaxBatchDocuments = 1024;
+    static const int kMaxBatchBytes = 16 * 1024 * 1024;
+
+    void _enqueueCurrentBatch() {
+        if (_currentBatch.docs.empty()) {
+            return;
+        }
+
+        {
+            stdx::unique_lock<stdx::mutex> lk(_mutex);
+
+            // Bound the memory used by the queued documents
+            auto& queue = _queues[_currentWorker];
+            _queueNotFull.wait(lk, [&] { return queue.size() < 2; });
+            queue.push_back(std::move(_currentBatch));
+        }
+        _queueNotEmpty.notify_all();
+
+        _currentBatch.docs.clear();
+        _currentBatchBytes = 0;
+    }
+
+    void _shutdown(bool drain) {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _inShutdown = true;
+            if (!drain) {
+                for (auto& queue : _queues) {
+                    queue.clear();
+                }
+            }
+        }
+
+        _queueNotEmpty.notify_all();
+        _queueNotFull.notify_all();
+
+        for (auto& thread : _threads) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+    }
+
+    void _workerLoop(size_t worker) {
+        auto& queue = _queues[worker];
+        while (true) {
+            Batch batch;
+            {
+                stdx::unique_lock<stdx::mutex> lk(_mutex);
+                _queueNotEmpty.wait(lk, [&] { return !queue.empty() || _inShutdown; });
+                if (queue.empty()) {
+                    return;
+                }
+
+                batch = std::move(queue.front());
+                queue.pop_front();
+            }
+            _queueNotFull.notify_all();
+
+            for (const auto& doc : batch.docs) {
+                md5_append(batch.state, (const md5_byte_t*)doc.objdata(), doc.objsize());
+            }
+        }
+    }
+
+    // Only accessed by the command's thread. The workers only access the state of the collection
+    // a batch they dequeued belongs to, until they are joined.
+    std::vector<std::unique_ptr<md5_state_t>> _states;
+    Batch _currentBatch;
+    int _currentBatchBytes{0};
+    size_t _currentWorker{0};
+
+    // Protects the state below
+    stdx::mutex _mutex;
+    stdx::condition_variable _queueNotEmpty;
+    stdx::condition_variable _queueNotFull;
+    std::vector<std::deque<Batch>> _queues;
+    bool _inShutdown{false};
+
+    std::vector<stdx::thread> _threads;
+};
+
 class DBHashCmd : public Command {
 public:
     DBHashCmd() : Command("dbHash", "dbhash") {}
@@ -127,7 +291,16 @@ public:
                                                                             "system.views"};
 
 
-        BSONObjBuilder bb(result.subobjStart("collections"));
+        std::unique_ptr<ParallelCollectionHasher> hasher;
+        const int maxThreads = maxDBHashThreads.load();
+        if (maxThreads > 1 && colls.size() > 1) {
+            hasher = stdx::make_unique<ParallelCollectionHasher>(
+                std::min({static_cast<size_t>(maxThreads),
+                          colls.size(),
+                          static_cast<size_t>(ProcessInfo().getNumCores())}));
+        }
+        vector<CollectionHash> hashes;
+
         for (list<string>::iterator i = colls.begin(); i != colls.end(); i++) {
             string fullCollectionName = *i;
             if (fullCollectionName.size() - 1 <= dbname.size()) {
@@ -145,10 +318,24 @@ public:
             if (desiredCollections.size() > 0 && desiredCollections.count(shortCollectionName) == 0)
                 continue;
 
-            string hash = _hashCollection(opCtx, db, fullCollectionName);
+            hashes.emplace_back();
+            hashes.back().shortName = shortCollectionName;
+            _hashCollection(opCtx, db, fullCollectionName, hasher.get(), &hashes.back());
+        }
+
+        if (hasher) {
+            std::vector<std::string> hasherResults = hasher->finish();
+            for (auto& entry : hashes) {
+                if (entry.hasherIndex) {
+                    entry.hash = hasherResults[*entry.hasherIndex];
+                }
+            }
+        }
 
-            bb.append(shortCollectionName, hash);
-            md5_append(&globalState, (const md5_byte_t*)hash.c_str(), hash.size());
+        BSONObjBuilder bb(result.subobjStart("collections"));
+        for (const auto& entry : hashes) {
+            bb.append(entry.shortName, entry.hash);
+            md5_append(&globalState, (const md5_byte_t*)entry.hash.c_str(), entry.hash.size());
         }
         bb.done();
 
@@ -163,15 +350,30 @@ public:
     }
 
 private:
-    std::string _hashCollection(OperationContext* opCtx,
-                                Database* db,
-                                const std::string& fullCollectionName) {
+    struct CollectionHash {
+        std::string shortName;
+        std::string hash;
+
+        // Set when the collection is hashed by a ParallelCollectionHasher, in which case its hash
+        // is only known once the hasher is finished.
+        boost::optional<size_t> hasherIndex;
+    };
+
+    /**
+     * Hashes the collection 'fullCollectionName' into 'out', on the workers of 'hasher' unless it
+     * is null.
+     */
+    void _hashCollection(OperationContext* opCtx,
+                         Database* db,
+                         const std::string& fullCollectionName,
+                         ParallelCollectionHasher* hasher,
+                         CollectionHash* out) {
 
         NamespaceString ns(fullCollectionName);
 
         Collection* collection = db->getCollection(opCtx, ns);
         if (!collection)
-            return "";
+            return;
 
         IndexDescriptor* desc = collection->getIndexCatalog()->findIdIndex(opCtx);
 
@@ -191,18 +393,26 @@ private:
                 opCtx, fullCollectionName, collection, PlanExecutor::NO_YIELD);
         } else {
             log() << "can't find _id index for: " << fullCollectionName;
-            return "no _id _index";
+            out->hash = "no _id _index";
+            return;
         }
 
         md5_state_t st;
         md5_init(&st);
+        if (hasher) {
+            out->hasherIndex = hasher->startCollection();
+        }
 
         long long n = 0;
         PlanExecutor::ExecState state;
         BSONObj c;
         verify(NULL != exec.get());
         while (PlanExecutor::ADVANCED == (state = exec->getNext(&c, NULL))) {
-            md5_append(&st, (const md5_byte_t*)c.objdata(), c.objsize());
+            if (hasher) {
+                hasher->add(c);
+            } else {
+                md5_append(&st, (const md5_byte_t*)c.objdata(), c.objsize());
+            }
             n++;
         }
         if (PlanExecutor::IS_EOF != state) {
@@ -211,11 +421,11 @@ private:
                       "Plan executor error while running dbHash command: " +
                           WorkingSetCommon::toStatusString(c));
         }
-        md5digest d;
-        md5_finish(&st, d);
-        string hash = digestToString(d);
-
-        return hash;
+        if (!hasher) {
+            md5digest d;
+            md5_finish(&st, d);
+            out->hash = digestToString(d);
+        }
     }
 
 } dbhashCmd;
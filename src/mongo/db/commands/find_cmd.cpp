@@ -48,8 +48,11 @@
 #include "mongo/db/query/find.h"
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/get_executor.h"
+#include "mongo/db/query/query_result_cache.h"
+#include "mongo/db/repl/read_concern_args.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/collection_sharding_state.h"
+#include "mongo/db/s/operation_sharding_state.h"
 #include "mongo/db/server_options.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
@@ -251,6 +254,14 @@ public:
 
         auto& qr = qrStatus.getValue();
 
+        // The results of versioned queries depend on the chunks the shard owns, which the result
+        // cache does not track. The version of the collection must be taken before reading it.
+        auto& resultCache = QueryResultCache::get(opCtx);
+        const bool useResultCache = QueryResultCache::enabled() &&
+            !OperationShardingState::get(opCtx).hasShardVersion();
+        const QueryResultCache::Version resultCacheVersion =
+            useResultCache ? resultCache.getCollectionVersion(nss) : 0;
+
         if (!qr->getCollation().isEmpty() &&
             serverGlobalParams.featureCompatibility.version.load() ==
                 ServerGlobalParams::FeatureCompatibility::Version::k32) {
@@ -288,6 +299,14 @@ public:
         }
         std::unique_ptr<CanonicalQuery> cq = std::move(statusWithCQ.getValue());
 
+        boost::optional<std::string> resultCacheKey;
+        if (useResultCache) {
+            repl::ReadConcernArgs readConcernArgs;
+            if (readConcernArgs.initialize(cmdObj).isOK()) {
+                resultCacheKey = QueryResultCache::makeKey(*cq, readConcernArgs);
+            }
+        }
+
         // Acquire locks. If the query is on a view, we release our locks and convert the query
         // request into an aggregation command.
         AutoGetCollectionOrViewForReadCommand ctx(opCtx, nss);
@@ -318,6 +337,34 @@ public:
             return true;
         }
 
+        // Capped collections lose documents without telling the OpObserver, so their results are
+        // never cached.
+        if (!collection || collection->isCapped()) {
+            resultCacheKey = boost::none;
+        }
+
+        // Answer the query straight from the result cache if it has been run since the collection
+        // last changed.
+        QueryResultCache::Results cachedResults;
+        if (resultCacheKey && resultCache.lookup(nss, *resultCacheKey, &cachedResults)) {
+            CursorResponseBuilder firstBatch(/*isInitialResponse*/ true, &result);
+            for (auto&& doc : cachedResults.documents) {
+                firstBatch.append(doc.Obj());
+            }
+
+            auto curOp = CurOp::get(opCtx);
+            {
+                stdx::lock_guard<Client> lk(*opCtx->getClient());
+                curOp->setPlanSummary_inlock("CACHED_RESULTS"_sd);
+            }
+            curOp->debug().nreturned = cachedResults.numDocuments;
+            curOp->debug().cursorid = -1;
+            curOp->debug().cursorExhausted = true;
+
+            firstBatch.done(0, nss.ns());
+            return true;
+        }
+
         // Get the execution plan for the query.
         auto statusWithPlanExecutor =
             getExecutorFind(opCtx, collection, nss, std::move(cq), PlanExecutor::YIELD_AUTO);
@@ -349,6 +396,13 @@ public:
         BSONObj obj;
         PlanExecutor::ExecState state = PlanExecutor::ADVANCED;
         long long numResults = 0;
+
+        // The results are copied aside for the result cache, until they grow too large for it.
+        boost::optional<BSONArrayBuilder> resultsToCache;
+        if (resultCacheKey) {
+            resultsToCache.emplace();
+        }
+
         while (!FindCommon::enoughForFirstBatch(originalQR, numResults) &&
                PlanExecutor::ADVANCED == (state = exec->getNext(&obj, NULL))) {
             // If we can't fit this result inside the current batch, then we stash it for later.
@@ -360,6 +414,14 @@ public:
             // Add result to output buffer.
             firstBatch.append(obj);
             numResults++;
+
+            if (resultsToCache) {
+                if (resultsToCache->len() + obj.objsize() > QueryResultCache::maxEntryBytes()) {
+                    resultsToCache = boost::none;
+                } else {
+                    resultsToCache->append(obj);
+                }
+            }
         }
 
         // Throw an assertion if query execution fails for any reason.
@@ -380,6 +442,10 @@ public:
         auto css = CollectionShardingState::get(opCtx, nss);
         css->checkShardVersionOrThrow(opCtx);
 
+        if (exec->getCanonicalQuery()) {
+            css->onQueryOp(opCtx, *exec->getCanonicalQuery());
+        }
+
         // Set up the cursor for getMore.
         CursorId cursorId = 0;
         if (shouldSaveCursor(opCtx, collection, state, exec.get())) {
@@ -403,11 +469,21 @@ public:
 
             pinnedCursor.getCursor()->setLeftoverMaxTimeMicros(opCtx->getRemainingMaxTimeMicros());
             pinnedCursor.getCursor()->setPos(numResults);
+            pinnedCursor.getCursor()->recordBatchReturned(
+                firstBatch.bytesUsed(), opCtx->getServiceContext()->getFastClockSource()->now());
 
             // Fill out curop based on the results.
             endQueryOp(opCtx, collection, *cursorExec, numResults, cursorId);
         } else {
             endQueryOp(opCtx, collection, *exec, numResults, cursorId);
+
+            // Only results which were all returned at once can be replayed from the cache.
+            if (resultsToCache) {
+                QueryResultCache::Results results;
+                results.documents = resultsToCache->arr();
+                results.numDocuments = numResults;
+                resultCache.insert(nss, *resultCacheKey, resultCacheVersion, results);
+            }
         }
 
         // Generate the response object to send to the client.
@@ -350,7 +350,13 @@ public:
         PlanSummaryStats preExecutionStats;
         Explain::getSummaryStats(*exec, &preExecutionStats);
 
-        Status batchStatus = generateBatch(cursor, request, &nextBatch, &state, &numResults);
+        // Without a batchSize from the client, size the batch after how fast it is consuming them.
+        const int batchByteBudget = request.batchSize
+            ? FindCommon::kMaxBytesToReturnToClientAtOnce
+            : cursor->getBatchByteBudget(opCtx->getServiceContext()->getFastClockSource()->now());
+
+        Status batchStatus =
+            generateBatch(cursor, request, batchByteBudget, &nextBatch, &state, &numResults);
         if (!batchStatus.isOK()) {
             return appendCommandStatus(result, batchStatus);
         }
@@ -387,7 +393,8 @@ public:
 
                 // We woke up because either the timed_wait expired, or there was more data. Either
                 // way, attempt to generate another batch of results.
-                batchStatus = generateBatch(cursor, request, &nextBatch, &state, &numResults);
+                batchStatus = generateBatch(
+                    cursor, request, batchByteBudget, &nextBatch, &state, &numResults);
                 if (!batchStatus.isOK()) {
                     return appendCommandStatus(result, batchStatus);
                 }
@@ -424,6 +431,8 @@ public:
             }
 
             cursor->incPos(numResults);
+            cursor->recordBatchReturned(nextBatch.bytesUsed(),
+                                        opCtx->getServiceContext()->getFastClockSource()->now());
         } else {
             curOp->debug().cursorExhausted = true;
         }
@@ -465,7 +474,7 @@ public:
 
     /**
      * Uses 'cursor' and 'request' to fill out 'nextBatch' with the batch of result documents to
-     * be returned by this getMore.
+     * be returned by this getMore, holding at most 'maxBytes' unless the first document is larger.
      *
      * Returns the number of documents in the batch in *numResults, which must be initialized to
      * zero by the caller. Returns the final ExecState returned by the cursor in *state.
@@ -475,6 +484,7 @@ public:
      */
     Status generateBatch(ClientCursor* cursor,
                          const GetMoreRequest& request,
+                         int maxBytes,
                          CursorResponseBuilder* nextBatch,
                          PlanExecutor::ExecState* state,
                          long long* numResults) {
@@ -490,7 +500,8 @@ public:
                    PlanExecutor::ADVANCED == (*state = exec->getNext(&obj, NULL))) {
                 // If adding this object will cause us to exceed the message size limit, then we
                 // stash it for later.
-                if (!FindCommon::haveSpaceForNext(obj, *numResults, nextBatch->bytesUsed())) {
+                if (!FindCommon::haveSpaceForNext(
+                        obj, *numResults, nextBatch->bytesUsed(), maxBytes)) {
                     exec->enqueue(obj);
                     break;
                 }
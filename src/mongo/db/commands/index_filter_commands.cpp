@@ -74,6 +74,7 @@ static Status getQuerySettingsAndPlanCache(OperationContext* opCtx,
 
     CollectionInfoCache* infoCache = collection->infoCache();
     invariant(infoCache);
+    infoCache->ensureIndexDataBuilt(opCtx);
 
     QuerySettings* querySettings = infoCache->getQuerySettings();
     invariant(querySettings);
@@ -129,7 +129,11 @@ void _addWorkingSetMember(OperationContext* opCtx,
     root->pushBack(id);
 }
 
-BSONObj buildViewBson(const ViewDefinition& view) {
+/**
+ * 'materialization' describes how fresh the contents of 'view' are if it is materialized, and is
+ * empty otherwise.
+ */
+BSONObj buildViewBson(const ViewDefinition& view, const BSONObj& materialization) {
     BSONObjBuilder b;
     b.append("name", view.name().coll());
     b.append("type", "view");
@@ -140,10 +144,17 @@ BSONObj buildViewBson(const ViewDefinition& view) {
     if (view.defaultCollator()) {
         optionsBuilder.append("collation", view.defaultCollator()->getSpec().toBSON());
     }
+    if (view.materialization()) {
+        optionsBuilder.append("materialized", view.materialization()->toBSON());
+    }
     optionsBuilder.doneFast();
 
-    BSONObj info = BSON("readOnly" << true);
-    b.append("info", info);
+    BSONObjBuilder infoBuilder(b.subobjStart("info"));
+    infoBuilder.append("readOnly", true);
+    if (!materialization.isEmpty()) {
+        infoBuilder.append("materialization", materialization);
+    }
+    infoBuilder.doneFast();
     return b.obj();
 }
 
@@ -287,12 +298,21 @@ public:
                 SimpleBSONObjComparator::kInstance.evaluate(
                     filterElt.Obj() == ListCollectionsFilter::makeTypeCollectionFilter());
             if (!skipViews) {
-                db->getViewCatalog()->iterate(opCtx, [&](const ViewDefinition& view) {
-                    BSONObj viewBson = buildViewBson(view);
+                // The materialization of a view can only be described once the iteration, which
+                // holds the view catalog's mutex, is over.
+                std::vector<ViewDefinition> views;
+                db->getViewCatalog()->iterate(
+                    opCtx, [&](const ViewDefinition& view) { views.push_back(view); });
+                for (auto&& view : views) {
+                    BSONObj viewBson = buildViewBson(
+                        view,
+                        view.materialization()
+                            ? db->getViewCatalog()->describeMaterialization(opCtx, view.name())
+                            : BSONObj());
                     if (!viewBson.isEmpty()) {
                         _addWorkingSetMember(opCtx, viewBson, matcher.get(), ws.get(), root.get());
                     }
-                });
+                }
             }
         }
 
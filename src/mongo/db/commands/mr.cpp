@@ -32,6 +32,10 @@
 
 #include "mongo/db/commands/mr.h"
 
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
 #include "mongo/base/status_with.h"
 #include "mongo/bson/util/builder.h"
 #include "mongo/client/connpool.h"
@@ -65,6 +69,7 @@
 #include "mongo/db/s/sharded_connection_info.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/s/catalog_cache.h"
 #include "mongo/s/client/parallel.h"
@@ -106,7 +111,11 @@ JSFunction::JSFunction(const std::string& type, const BSONElement& e) {
 }
 
 void JSFunction::init(State* state) {
-    _scope = state->scope();
+    init(state->scope());
+}
+
+void JSFunction::init(Scope* scope) {
+    _scope = scope;
     verify(_scope);
     _scope->init(&_wantedScope);
 
@@ -118,8 +127,12 @@ void JSFunction::init(State* state) {
 }
 
 void JSMapper::init(State* state) {
-    _func.init(state);
-    _params = state->config().mapParams;
+    init(state->scope(), state->config().mapParams);
+}
+
+void JSMapper::init(Scope* scope, const BSONObj& params) {
+    _func.init(scope);
+    _params = params;
 }
 
 /**
@@ -272,6 +285,308 @@ void JSReducer::_reduce(const BSONList& tuples, BSONObj& key, int& endSizeEstima
     _reduce(x, key, endSizeEstimate);
 }
 
+namespace {
+
+/**
+ * Splits JavaScript source into identifiers, unsigned numeric literals and single punctuation
+ * characters, dropping whitespace and comments. Anything else, such as a string literal, becomes
+ * a token of its own which no recognized function shape contains.
+ */
+std::vector<std::string> tokenizeJS(StringData code) {
+    auto isIdentChar = [](char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$';
+    };
+
+    std::vector<std::string> tokens;
+    size_t i = 0;
+    while (i < code.size()) {
+        const char c = code[i];
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            ++i;
+        } else if (code.substr(i, 2) == "//") {
+            i = code.find('\n', i);
+        } else if (code.substr(i, 2) == "/*") {
+            const size_t commentLength = code.substr(i + 2).find("*/");
+            if (commentLength == std::string::npos) {
+                // An unterminated comment, which fails to compile.
+                tokens.push_back("/*");
+                break;
+            }
+            i += commentLength + 4;
+        } else if (isIdentChar(c)) {
+            // A numeric literal also takes in its decimal point.
+            const bool isNumber = std::isdigit(static_cast<unsigned char>(c));
+            size_t end = i + 1;
+            while (end < code.size() &&
+                   (isIdentChar(code[end]) || (isNumber && code[end] == '.'))) {
+                ++end;
+            }
+            tokens.push_back(code.substr(i, end - i).toString());
+            i = end;
+        } else {
+            tokens.push_back(std::string(1, c));
+            ++i;
+        }
+    }
+    return tokens;
+}
+
+/**
+ * Consumes tokens from the front of a tokenized function, failing on the first mismatch.
+ */
+class JSTokenMatcher {
+public:
+    explicit JSTokenMatcher(const BSONElement& code)
+        : _tokens(code.type() == Code || code.type() == CodeWScope || code.type() == String
+                      ? tokenizeJS(code._asCode())
+                      : std::vector<std::string>{}) {}
+
+    bool atEnd() const {
+        return _pos == _tokens.size();
+    }
+
+    bool consume(StringData token) {
+        if (atEnd() || _tokens[_pos] != token)
+            return false;
+        ++_pos;
+        return true;
+    }
+
+    /**
+     * Consumes an identifier which can name a field of a document without colliding with a
+     * property that JavaScript objects inherit, such as 'constructor' or '__proto__'.
+     */
+    bool consumeFieldName(std::string* name) {
+        static const std::set<std::string> kInheritedProperties = {"constructor",
+                                                                   "hasOwnProperty",
+                                                                   "isPrototypeOf",
+                                                                   "propertyIsEnumerable",
+                                                                   "toLocaleString",
+                                                                   "toSource",
+                                                                   "toString",
+                                                                   "valueOf",
+                                                                   "watch",
+                                                                   "unwatch"};
+        if (atEnd() || !isIdentifier(_tokens[_pos]) ||
+            StringData(_tokens[_pos]).startsWith("__") || kInheritedProperties.count(_tokens[_pos]))
+            return false;
+        *name = _tokens[_pos++];
+        return true;
+    }
+
+    bool consumeIdentifier(std::string* name) {
+        static const std::set<std::string> kKeywords = {
+            "arguments", "Array", "emit", "function", "return", "this", "var"};
+        if (atEnd() || !isIdentifier(_tokens[_pos]) || kKeywords.count(_tokens[_pos]))
+            return false;
+        *name = _tokens[_pos++];
+        return true;
+    }
+
+    /**
+     * Consumes a decimal literal, optionally negated. Literals with a leading zero are rejected
+     * since JavaScript may read them as octal.
+     */
+    bool consumeNumber(double* value) {
+        const bool negative = consume("-");
+        if (atEnd())
+            return false;
+        const std::string& token = _tokens[_pos];
+        if (token.find_first_not_of("0123456789.") != std::string::npos || token[0] == '.' ||
+            token.back() == '.' || std::count(token.begin(), token.end(), '.') > 1 ||
+            (token.size() > 1 && token[0] == '0' && token[1] != '.'))
+            return false;
+        *value = std::strtod(token.c_str(), nullptr) * (negative ? -1 : 1);
+        ++_pos;
+        return true;
+    }
+
+    /**
+     * Consumes 'function', an optional name, and the opening parenthesis of the parameter list.
+     */
+    bool consumeFunctionHeader() {
+        std::string name;
+        return consume("function") && (consume("(") || (consumeIdentifier(&name) && consume("(")));
+    }
+
+    /**
+     * Consumes the end of a function body: an optional semicolon, the closing brace, and
+     * nothing after it.
+     */
+    bool consumeFunctionEnd() {
+        consume(";");
+        return consume("}") && atEnd();
+    }
+
+private:
+    static bool isIdentifier(const std::string& token) {
+        return !token.empty() &&
+            (std::isalpha(static_cast<unsigned char>(token[0])) || token[0] == '_' ||
+             token[0] == '$');
+    }
+
+    const std::vector<std::string> _tokens;
+    size_t _pos = 0;
+};
+
+}  // namespace
+
+std::unique_ptr<NativeMapper> NativeMapper::parse(const BSONElement& code) {
+    JSTokenMatcher matcher(code);
+    auto consumeOperand = [&matcher](Operand* operand) {
+        double constant;
+        if (matcher.consumeNumber(&constant)) {
+            // JavaScript emits every number as a double.
+            operand->constant = BSON("" << constant);
+            return true;
+        }
+        return matcher.consume("this") && matcher.consume(".") &&
+            matcher.consumeFieldName(&operand->fieldName);
+    };
+
+    Operand key;
+    Operand value;
+    if (!(matcher.consumeFunctionHeader() && matcher.consume(")") && matcher.consume("{") &&
+          matcher.consume("emit") && matcher.consume("(") && consumeOperand(&key) &&
+          matcher.consume(",") && consumeOperand(&value) && matcher.consume(")") &&
+          matcher.consumeFunctionEnd())) {
+        return nullptr;
+    }
+    return std::unique_ptr<NativeMapper>(new NativeMapper(code, std::move(key), std::move(value)));
+}
+
+void NativeMapper::init(State* state) {
+    _state = state;
+    _jsMapper.init(state);
+}
+
+/**
+ * Emits the key and value of 'o' as JavaScript would: numbers become doubles, and a missing key
+ * becomes null. Falls back to the JavaScript map function for the types whose conversion isn't
+ * replicated here.
+ */
+void NativeMapper::map(const BSONObj& o) {
+    BSONElement key = _key.fieldName.empty() ? _key.constant.firstElement() : o[_key.fieldName];
+    BSONElement value =
+        _value.fieldName.empty() ? _value.constant.firstElement() : o[_value.fieldName];
+
+    BSONObjBuilder b;
+    switch (key.type()) {
+        case EOO:
+        case jstNULL:
+        case Undefined:
+            b.appendNull("0");
+            break;
+        case NumberInt:
+        case NumberDouble:
+            b.append("0", key.numberDouble());
+            break;
+        case String:
+        case Bool:
+        case jstOID:
+        case Date:
+            b.appendAs(key, "0");
+            break;
+        default:
+            _jsMapper.map(o);
+            return;
+    }
+
+    if (value.type() != NumberInt && value.type() != NumberDouble) {
+        _jsMapper.map(o);
+        return;
+    }
+    b.append("1", value.numberDouble());
+
+    BSONObj tuple = b.obj();
+    uassert(13069,
+            "an emit can't be more than half max bson size",
+            tuple.objsize() < (BSONObjMaxUserSize / 2));
+    _state->emit(tuple);
+}
+
+std::unique_ptr<NativeSumReducer> NativeSumReducer::parse(const BSONElement& code) {
+    JSTokenMatcher matcher(code);
+    std::string keyName;
+    std::string valuesName;
+    std::string summedName;
+    if (!(matcher.consumeFunctionHeader() && matcher.consumeIdentifier(&keyName) &&
+          matcher.consume(",") && matcher.consumeIdentifier(&valuesName) && matcher.consume(")") &&
+          matcher.consume("{") && matcher.consume("return") && matcher.consume("Array") &&
+          matcher.consume(".") && matcher.consume("sum") && matcher.consume("(") &&
+          matcher.consumeIdentifier(&summedName) && matcher.consume(")") &&
+          matcher.consumeFunctionEnd()) ||
+        keyName == valuesName || summedName != valuesName) {
+        return nullptr;
+    }
+    return std::unique_ptr<NativeSumReducer>(new NativeSumReducer(code));
+}
+
+void NativeSumReducer::init(State* state) {
+    _jsReducer.init(state);
+}
+
+boost::optional<double> NativeSumReducer::_sum(const BSONList& tuples) {
+    double sum = 0;
+    for (size_t i = 0; i < tuples.size(); ++i) {
+        BSONObjIterator it(tuples[i]);
+        it.next();
+        BSONElement value = it.next();
+        if (value.type() != NumberDouble)
+            return boost::none;
+        sum = (i == 0) ? value.Double() : sum + value.Double();
+    }
+    return sum;
+}
+
+BSONObj NativeSumReducer::reduce(const BSONList& tuples) {
+    if (tuples.size() <= 1)
+        return tuples[0];
+
+    auto sum = _sum(tuples);
+    if (!sum) {
+        const long long jsReduces = _jsReducer.numReduces;
+        BSONObj res = _jsReducer.reduce(tuples);
+        numReduces += _jsReducer.numReduces - jsReduces;
+        return res;
+    }
+
+    ++numReduces;
+    BSONObjBuilder b;
+    b.appendAs(tuples[0].firstElement(), "0");
+    b.append("1", *sum);
+    return b.obj();
+}
+
+BSONObj NativeSumReducer::finalReduce(const BSONList& tuples, Finalizer* finalizer) {
+    boost::optional<double> sum;
+    if (tuples.size() > 1) {
+        if (!(sum = _sum(tuples))) {
+            const long long jsReduces = _jsReducer.numReduces;
+            BSONObj res = _jsReducer.finalReduce(tuples, finalizer);
+            numReduces += _jsReducer.numReduces - jsReduces;
+            return res;
+        }
+    }
+
+    BSONObjIterator it(tuples[0]);
+    BSONObjBuilder b;
+    b.appendAs(it.next(), "_id");
+    if (sum) {
+        ++numReduces;
+        b.append("value", *sum);
+    } else {
+        b.appendAs(it.next(), "value");
+    }
+    BSONObj res = b.obj();
+
+    if (finalizer) {
+        res = finalizer->finalize(res);
+    }
+
+    return res;
+}
+
 Config::Config(const string& _dbname, const BSONObj& cmdObj) {
     dbname = _dbname;
     uassert(ErrorCodes::TypeMismatch,
@@ -320,8 +635,29 @@ Config::Config(const string& _dbname, const BSONObj& cmdObj) {
         if (cmdObj["scope"].type() == Object)
             scopeSetup = cmdObj["scope"].embeddedObjectUserCheck();
 
-        mapper.reset(new JSMapper(cmdObj["map"]));
-        reducer.reset(new JSReducer(cmdObj["reduce"]));
+        // Recognize the simple map and reduce functions that can run without converting every
+        // document and emitted value to JavaScript. Since a native mapper emits straight into
+        // the C++ map, it can't run in jsMode.
+        const bool scopeRedefinesArray = scopeSetup.hasField("Array") ||
+            (cmdObj["reduce"].type() == CodeWScope &&
+             cmdObj["reduce"].codeWScopeObject().hasField("Array"));
+        auto nativeMap = NativeMapper::parse(cmdObj["map"]);
+        nativeMapper = static_cast<bool>(nativeMap);
+        if (nativeMap) {
+            mapper = std::move(nativeMap);
+            jsMode = false;
+        } else {
+            mapper.reset(new JSMapper(cmdObj["map"]));
+        }
+
+        auto nativeReduce =
+            scopeRedefinesArray ? nullptr : NativeSumReducer::parse(cmdObj["reduce"]);
+        nativeReducer = static_cast<bool>(nativeReduce);
+        if (nativeReduce) {
+            reducer = std::move(nativeReduce);
+        } else {
+            reducer.reset(new JSReducer(cmdObj["reduce"]));
+        }
         if (cmdObj["finalize"].type() && cmdObj["finalize"].trueValue())
             finalizer.reset(new JSFinalizer(cmdObj["finalize"]));
 
@@ -1299,26 +1635,231 @@ void State::reduceAndSpillInMemoryStateIfNeeded() {
     }
 }
 
+namespace {
+
 /**
- * emit that will be called by js function
+ * Checks the arguments of an emit, and returns them with an undefined key replaced by null.
  */
-BSONObj fast_emit(const BSONObj& args, void* data) {
+BSONObj prepareEmit(const BSONObj& args) {
     uassert(10077, "fast_emit takes 2 args", args.nFields() == 2);
     uassert(13069,
             "an emit can't be more than half max bson size",
             args.objsize() < (BSONObjMaxUserSize / 2));
 
-    State* state = (State*)data;
     if (args.firstElement().type() == Undefined) {
         BSONObjBuilder b(args.objsize());
         b.appendNull("");
         BSONObjIterator i(args);
         i.next();
         b.append(i.next());
-        state->emit(b.obj());
-    } else {
-        state->emit(args);
+        return b.obj();
     }
+    return args;
+}
+
+/**
+ * emit that will be called by the map function on a ParallelMapper worker, which buffers the
+ * emits of a batch until it is finished
+ */
+BSONObj bufferEmit(const BSONObj& args, void* data) {
+    static_cast<BSONList*>(data)->push_back(prepareEmit(args).getOwned());
+    return BSONObj();
+}
+
+// The number of threads mapReduce runs a JavaScript map function on, or 1 to run it on the
+// command's thread. A native map function always runs on the command's thread.
+MONGO_EXPORT_SERVER_PARAMETER(mapReduceMapThreads, int, 1);
+
+// A ParallelMapper hands out the input in batches of up to this many documents or bytes.
+const size_t kMaxParallelMapBatchDocs = 256;
+const int kMaxParallelMapBatchBytes = 1024 * 1024;
+
+}  // namespace
+
+ParallelMapper::ParallelMapper(OperationContext* opCtx,
+                               const Config& config,
+                               const BSONObj& cmdObj,
+                               DBDirectClient* client,
+                               size_t numThreads)
+    : _opCtx(opCtx),
+      _dbName(config.dbname),
+      _mapCode(cmdObj["map"]),
+      _mapParams(config.mapParams),
+      _scopeSetup(config.scopeSetup),
+      _maxBatchesInFlight(2 * numThreads),
+      _workerOpCtxs(numThreads, nullptr) {
+    // The workers' scopes aren't connected to the database, so this thread loads the stored
+    // functions for them, as Scope::loadStored() does.
+    BSONObjBuilder storedFunctions;
+    unique_ptr<DBClientCursor> cursor =
+        client->query(_dbName + ".system.js", Query(), 0, 0, nullptr, QueryOption_SlaveOk, 0);
+    massert(40640, "unable to get db client cursor from query", cursor.get());
+    while (cursor->more()) {
+        BSONObj o = cursor->nextSafe();
+        BSONElement n = o["_id"];
+        BSONElement v = o["value"];
+        uassert(10209, str::stream() << "name has to be a string: " << n, n.type() == String);
+        uassert(10210, "value has to be set", v.type() != EOO);
+        storedFunctions.appendAs(v, n.valueStringData());
+    }
+    _storedFunctions = storedFunctions.obj();
+
+    for (size_t i = 0; i < numThreads; ++i) {
+        _workers.emplace_back([this, i] { _workerThread(i); });
+    }
+}
+
+ParallelMapper::~ParallelMapper() {
+    if (!_workers.empty()) {
+        _joinWorkers(true);
+    }
+}
+
+void ParallelMapper::_workerThread(size_t workerId) {
+    Client::initThread("MapReduceMapWorker");
+    auto opCtx = cc().makeOperationContext();
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_closing) {
+            return;
+        }
+        _workerOpCtxs[workerId] = opCtx.get();
+    }
+    ON_BLOCK_EXIT([this, workerId] {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _workerOpCtxs[workerId] = nullptr;
+    });
+
+    try {
+        std::unique_ptr<Scope> scope(getGlobalScriptEngine()->newScopeForCurrentThread());
+        scope->registerOperation(opCtx.get());
+        scope->setLocalDB(_dbName);
+        scope->init(&_storedFunctions);
+        if (!_scopeSetup.isEmpty())
+            scope->init(&_scopeSetup);
+
+        JSMapper mapper(_mapCode);
+        mapper.init(scope.get(), _mapParams);
+
+        BSONList emits;
+        scope->injectNative("emit", bufferEmit, &emits);
+
+        while (true) {
+            Batch batch;
+            {
+                stdx::unique_lock<stdx::mutex> lk(_mutex);
+                _batchQueued.wait(lk, [this] { return _closing || !_queuedBatches.empty(); });
+                if (_queuedBatches.empty()) {
+                    return;
+                }
+                batch = std::move(_queuedBatches.front());
+                _queuedBatches.pop_front();
+            }
+
+            for (const BSONObj& doc : batch.docs) {
+                mapper.map(doc);
+            }
+
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _finished[batch.id] = std::move(emits);
+            emits.clear();
+            _batchFinished.notify_one();
+        }
+    } catch (const DBException& ex) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_workerStatus.isOK()) {
+            _workerStatus = ex.toStatus();
+        }
+        _batchFinished.notify_one();
+    }
+}
+
+void ParallelMapper::map(const BSONObj& o, State* state) {
+    _currentBatch.docs.push_back(o.getOwned());
+    _currentBatch.bytes += o.objsize();
+    if (_currentBatch.docs.size() >= kMaxParallelMapBatchDocs ||
+        _currentBatch.bytes >= kMaxParallelMapBatchBytes) {
+        _dispatchCurrentBatch(state);
+    }
+}
+
+void ParallelMapper::_dispatchCurrentBatch(State* state) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    if (_nextBatchId - _nextBatchToEmit >= _maxBatchesInFlight) {
+        _emitFinishedBatches(lk, state, false);
+    }
+
+    _currentBatch.id = _nextBatchId++;
+    _queuedBatches.push_back(std::move(_currentBatch));
+    _currentBatch = Batch();
+    _batchQueued.notify_one();
+}
+
+void ParallelMapper::_emitFinishedBatches(stdx::unique_lock<stdx::mutex>& lk,
+                                          State* state,
+                                          bool all) {
+    auto nextBatchDone = [this] {
+        return !_workerStatus.isOK() || _finished.count(_nextBatchToEmit);
+    };
+
+    do {
+        _opCtx->waitForConditionOrInterrupt(_batchFinished, lk, nextBatchDone);
+        uassertStatusOK(_workerStatus);
+
+        // Pass on every batch that is finished, without holding the mutex.
+        while (_finished.count(_nextBatchToEmit)) {
+            BSONList emits = std::move(_finished[_nextBatchToEmit]);
+            _finished.erase(_nextBatchToEmit++);
+
+            lk.unlock();
+            for (const BSONObj& emit : emits) {
+                state->emit(emit);
+            }
+            lk.lock();
+        }
+    } while (all && _nextBatchToEmit < _nextBatchId);
+}
+
+void ParallelMapper::finish(State* state) {
+    if (!_currentBatch.docs.empty()) {
+        _dispatchCurrentBatch(state);
+    }
+    if (_nextBatchToEmit < _nextBatchId) {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _emitFinishedBatches(lk, state, true);
+    }
+    _joinWorkers(false);
+}
+
+void ParallelMapper::_joinWorkers(bool interrupt) {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _closing = true;
+        if (interrupt) {
+            // Stop the map function of every worker still running one.
+            _queuedBatches.clear();
+            for (OperationContext* workerOpCtx : _workerOpCtxs) {
+                if (workerOpCtx) {
+                    stdx::lock_guard<Client> clientLock(*workerOpCtx->getClient());
+                    workerOpCtx->getServiceContext()->killOperation(workerOpCtx);
+                }
+            }
+        }
+        _batchQueued.notify_all();
+    }
+
+    for (auto&& worker : _workers) {
+        worker.join();
+    }
+    _workers.clear();
+}
+
+/**
+ * emit that will be called by js function
+ */
+BSONObj fast_emit(const BSONObj& args, void* data) {
+    State* state = (State*)data;
+    state->emit(prepareEmit(args));
     return BSONObj();
 }
 
@@ -1406,7 +1947,8 @@ public:
                        "http://dochub.mongodb.org/core/3.4-feature-compatibility."));
         }
 
-        LOG(1) << "mr ns: " << config.nss;
+        LOG(1) << "mr ns: " << config.nss << " native map: " << config.nativeMapper
+               << " native reduce: " << config.nativeReducer;
 
         uassert(16149, "cannot run map reduce without the js engine", getGlobalScriptEngine());
 
@@ -1466,6 +2008,15 @@ public:
             long long reduceTime = 0;
             long long numInputs = 0;
 
+            // A JavaScript map function can run on several threads, unless emits have to stay
+            // in the JavaScript scope of this thread.
+            std::unique_ptr<ParallelMapper> parallelMapper;
+            const int mapThreads = std::min(mapReduceMapThreads.load(), 64);
+            if (mapThreads > 1 && !state.jsMode() && !config.nativeMapper) {
+                parallelMapper = stdx::make_unique<ParallelMapper>(
+                    opCtx, config, cmd, &state._db, static_cast<size_t>(mapThreads));
+            }
+
             {
                 // We've got a cursor preventing migrations off, now re-establish our
                 // useful cursor.
@@ -1538,7 +2089,11 @@ public:
                     // do map
                     if (config.verbose)
                         mt.reset();
-                    config.mapper->map(o);
+                    if (parallelMapper) {
+                        parallelMapper->map(o, &state);
+                    } else {
+                        config.mapper->map(o);
+                    }
                     if (config.verbose)
                         mapTime += mt.micros();
 
@@ -1588,6 +2143,14 @@ public:
                                              << WorkingSetCommon::toStatusString(o)));
                 }
 
+                if (parallelMapper) {
+                    if (config.verbose)
+                        mt.reset();
+                    parallelMapper->finish(&state);
+                    if (config.verbose)
+                        mapTime += mt.micros();
+                }
+
                 // Record the indexes used by the PlanExecutor.
                 PlanSummaryStats stats;
                 Explain::getSummaryStats(*exec, &stats);
@@ -1643,7 +2206,13 @@ public:
 
             countsBuilder.appendNumber("reduce", state.numReduces());
             timingBuilder.appendNumber("reduceTime", reduceTime / 1000);
-            timingBuilder.append("mode", state.jsMode() ? "js" : "mixed");
+            timingBuilder.append("mode",
+                                 state.jsMode()
+                                     ? "js"
+                                     : (config.nativeMapper && config.nativeReducer) ? "native"
+                                                                                     : "mixed");
+            timingBuilder.append("nativeMap", config.nativeMapper);
+            timingBuilder.append("nativeReduce", config.nativeReducer);
 
             long long finalCount = state.postProcessCollection(opCtx, curOp, pm);
             state.appendResults(result);
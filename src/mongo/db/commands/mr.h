@@ -30,6 +30,9 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+#include <deque>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -40,6 +43,9 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/scripting/engine.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 
 namespace mongo {
 
@@ -117,6 +123,11 @@ public:
 
     virtual void init(State* state);
 
+    /**
+     * Compiles the function in 'scope', which must outlive this JSFunction.
+     */
+    void init(Scope* scope);
+
     Scope* scope() const {
         return _scope;
     }
@@ -139,6 +150,12 @@ public:
     virtual void map(const BSONObj& o);
     virtual void init(State* state);
 
+    /**
+     * Prepares to map in 'scope' rather than in the scope of a State, passing 'params' to the
+     * map function.
+     */
+    void init(Scope* scope, const BSONObj& params);
+
 private:
     JSFunction _func;
     BSONObj _params;
@@ -175,6 +192,81 @@ private:
     JSFunction _func;
 };
 
+// ------------  native function implementations -----------
+
+/**
+ * A mapper for map functions of the form
+ *
+ *     function() { emit(this.<field>, <number or this.<field>>); }
+ *
+ * which emits directly into the State without converting each document to a JavaScript object.
+ * Documents whose key or value would not round-trip through JavaScript unchanged are passed to
+ * the equivalent JSMapper instead.
+ */
+class NativeMapper : public Mapper {
+public:
+    /**
+     * Returns a NativeMapper if 'code' is a map function of the recognized form, or nullptr if it
+     * has to be run by the JavaScript engine.
+     */
+    static std::unique_ptr<NativeMapper> parse(const BSONElement& code);
+
+    virtual void map(const BSONObj& o);
+    virtual void init(State* state);
+
+private:
+    /**
+     * An emitted key or value, which is either the constant 'constant' or the value of the
+     * top-level field 'fieldName' of each document.
+     */
+    struct Operand {
+        std::string fieldName;
+        BSONObj constant;
+    };
+
+    NativeMapper(const BSONElement& code, Operand key, Operand value)
+        : _key(std::move(key)), _value(std::move(value)), _jsMapper(code) {}
+
+    Operand _key;
+    Operand _value;
+
+    State* _state = nullptr;
+    JSMapper _jsMapper;
+};
+
+/**
+ * A reducer for reduce functions of the form
+ *
+ *     function(key, values) { return Array.sum(values); }
+ *
+ * which adds up values in C++ when they are all doubles, the only numbers JavaScript emits.
+ * Other values are reduced by the equivalent JSReducer.
+ */
+class NativeSumReducer : public Reducer {
+public:
+    /**
+     * Returns a NativeSumReducer if 'code' is a reduce function of the recognized form, or
+     * nullptr if it has to be run by the JavaScript engine.
+     */
+    static std::unique_ptr<NativeSumReducer> parse(const BSONElement& code);
+
+    virtual void init(State* state);
+
+    virtual BSONObj reduce(const BSONList& tuples);
+    virtual BSONObj finalReduce(const BSONList& tuples, Finalizer* finalizer);
+
+private:
+    explicit NativeSumReducer(const BSONElement& code) : _jsReducer(code) {}
+
+    /**
+     * Sums the values of 'tuples' in order, as Array.sum does, or returns boost::none if one of
+     * them isn't a double.
+     */
+    static boost::optional<double> _sum(const BSONList& tuples);
+
+    JSReducer _jsReducer;
+};
+
 // -----------------
 
 
@@ -203,6 +295,10 @@ public:
     bool jsMode;
     int splitInfo;
 
+    // Whether the map and reduce functions are run natively rather than by the JavaScript engine.
+    bool nativeMapper;
+    bool nativeReducer;
+
     // query options
 
     BSONObj filter;
@@ -407,6 +503,88 @@ protected:
     ScriptingFunction _reduceAndFinalizeAndInsert;
 };
 
+/**
+ * Runs a JavaScript map function over the input on worker threads, each with its own Client,
+ * scope and compiled copy of the function. The input is handed to the workers in batches, and the
+ * emits of each batch are passed to the State in input order, so the State sees the same emits
+ * in the same order as if the map function ran on the command's thread.
+ */
+class ParallelMapper {
+    MONGO_DISALLOW_COPYING(ParallelMapper);
+
+public:
+    /**
+     * Starts 'numThreads' workers for the map function of 'cmdObj', which must outlive this
+     * ParallelMapper. The workers' scopes get the stored functions of the database that 'client'
+     * reads them from.
+     */
+    ParallelMapper(OperationContext* opCtx,
+                   const Config& config,
+                   const BSONObj& cmdObj,
+                   DBDirectClient* client,
+                   size_t numThreads);
+
+    /**
+     * Interrupts and joins the workers if finish() wasn't called.
+     */
+    ~ParallelMapper();
+
+    /**
+     * Queues a copy of 'o' to be mapped, then passes the emits of the batches finished so far to
+     * 'state'. Blocks while the workers are too far behind.
+     */
+    void map(const BSONObj& o, State* state);
+
+    /**
+     * Maps everything queued, passes all remaining emits to 'state', and joins the workers.
+     * Throws the first error that the map function raised on any worker.
+     */
+    void finish(State* state);
+
+private:
+    struct Batch {
+        size_t id = 0;
+        BSONList docs;
+        int bytes = 0;
+    };
+
+    void _workerThread(size_t workerId);
+
+    /**
+     * Waits until the oldest unemitted batch is done if 'all' is false, or every batch if it is
+     * true, passing the emits of each finished batch to 'state' in order.
+     */
+    void _emitFinishedBatches(stdx::unique_lock<stdx::mutex>& lk, State* state, bool all);
+
+    void _dispatchCurrentBatch(State* state);
+
+    void _joinWorkers(bool interrupt);
+
+    OperationContext* const _opCtx;
+    const std::string _dbName;
+    const BSONElement _mapCode;
+    const BSONObj _mapParams;
+    const BSONObj _scopeSetup;
+    BSONObj _storedFunctions;
+
+    // Only used by the command's thread.
+    Batch _currentBatch;
+    size_t _nextBatchId = 0;
+    size_t _nextBatchToEmit = 0;
+    const size_t _maxBatchesInFlight;
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _batchQueued;
+    stdx::condition_variable _batchFinished;
+    std::deque<Batch> _queuedBatches;              // Guarded by _mutex.
+    std::map<size_t, BSONList> _finished;          // Guarded by _mutex. Emits by batch id.
+    std::vector<OperationContext*> _workerOpCtxs;  // Guarded by _mutex.
+    Status _workerStatus = Status::OK();           // Guarded by _mutex.
+    bool _closing = false;                         // Guarded by _mutex.
+
+    std::vector<stdx::thread> _workers;
+};
+
 BSONObj fast_emit(const BSONObj& args, void* data);
 BSONObj _bailFromJS(const BSONObj& args, void* data);
 
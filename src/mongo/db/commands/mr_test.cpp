@@ -254,4 +254,92 @@ TEST(ConfigTest, CollationNotAnObjectFailsToParse) {
     ASSERT_THROWS(mr::Config(dbname, cmdObj), UserException);
 }
 
+BSONObj makeMapReduceCmd(StringData map, StringData reduce, BSONObj options = BSONObj()) {
+    BSONObjBuilder bob;
+    bob.append("mapReduce", "myCollection");
+    bob.appendCode("map", map);
+    bob.appendCode("reduce", reduce);
+    bob.append("out", "outCollection");
+    bob.appendElements(options);
+    return bob.obj();
+}
+
+TEST(ConfigTest, RecognizesNativeMapFunctions) {
+    const std::vector<std::string> nativeMaps = {
+        "function() { emit(this.a, 1); }",
+        "function () {emit(this.a, this.b)}",
+        "function map() {\n    // Count documents by 'a'.\n    emit(this._id, -2.5);\n}",
+        "function() { /* total */ emit(0, this.amount); }",
+    };
+    for (auto&& map : nativeMaps) {
+        BSONObj cmdObj = makeMapReduceCmd(map, "function(k, v) { return {count: 0}; }");
+        ASSERT_TRUE(mr::NativeMapper::parse(cmdObj["map"])) << map;
+        ASSERT_TRUE(mr::Config("myDB", cmdObj).nativeMapper) << map;
+    }
+}
+
+TEST(ConfigTest, RunsOtherMapFunctionsInJavaScript) {
+    const std::vector<std::string> jsMaps = {
+        "function() { emit(this.a.b, 1); }",
+        "function() { emit(this.a, 1); emit(this.b, 1); }",
+        "function() { emit(this.constructor, 1); }",
+        "function() { emit(this.__proto__, 1); }",
+        "function() { emit(this.a, 010); }",
+        "function() { emit(this.a, '1'); }",
+        "function() { emit(this.a, 1) } foo()",
+        "function emit() { emit(this.a, 1); }",
+        "function(emit) { emit(this.a, 1); }",
+        "function() { emit(this.a, 1); /* unterminated }",
+    };
+    for (auto&& map : jsMaps) {
+        BSONObj cmdObj = makeMapReduceCmd(map, "function(k, v) { return {count: 0}; }");
+        ASSERT_FALSE(mr::NativeMapper::parse(cmdObj["map"])) << map;
+        ASSERT_FALSE(mr::Config("myDB", cmdObj).nativeMapper) << map;
+    }
+}
+
+TEST(ConfigTest, RecognizesNativeSumReduceFunctions) {
+    const std::vector<std::string> nativeReduces = {
+        "function(key, values) { return Array.sum(values); }",
+        "function reduce(k,vals){return Array.sum(vals)}",
+    };
+    for (auto&& reduce : nativeReduces) {
+        BSONObj cmdObj = makeMapReduceCmd("function() { emit(0, 1); }", reduce);
+        ASSERT_TRUE(mr::NativeSumReducer::parse(cmdObj["reduce"])) << reduce;
+        ASSERT_TRUE(mr::Config("myDB", cmdObj).nativeReducer) << reduce;
+    }
+}
+
+TEST(ConfigTest, RunsOtherReduceFunctionsInJavaScript) {
+    const std::vector<std::string> jsReduces = {
+        "function(key, values) { return Array.sum(key); }",
+        "function(values, values) { return Array.sum(values); }",
+        "function(key, Array) { return Array.sum(Array); }",
+        "function(key, values) { return values.length; }",
+        "function(key, values) { return Array.avg(values); }",
+    };
+    for (auto&& reduce : jsReduces) {
+        BSONObj cmdObj = makeMapReduceCmd("function() { emit(0, 1); }", reduce);
+        ASSERT_FALSE(mr::NativeSumReducer::parse(cmdObj["reduce"])) << reduce;
+        ASSERT_FALSE(mr::Config("myDB", cmdObj).nativeReducer) << reduce;
+    }
+}
+
+TEST(ConfigTest, NativeMapperDisablesJSMode) {
+    BSONObj cmdObj = makeMapReduceCmd("function() { emit(this.a, 1); }",
+                                      "function(k, v) { return Array.sum(v); }",
+                                      BSON("jsMode" << true));
+    mr::Config config("myDB", cmdObj);
+    ASSERT_TRUE(config.nativeMapper);
+    ASSERT_TRUE(config.nativeReducer);
+    ASSERT_FALSE(config.jsMode);
+}
+
+TEST(ConfigTest, ScopeRedefiningArrayDisablesNativeReducer) {
+    BSONObj cmdObj = makeMapReduceCmd("function() { emit(this.a, 1); }",
+                                      "function(k, v) { return Array.sum(v); }",
+                                      BSON("scope" << BSON("Array" << 1)));
+    ASSERT_FALSE(mr::Config("myDB", cmdObj).nativeReducer);
+}
+
 }  // namespace
@@ -45,6 +45,7 @@
 #include "mongo/db/matcher/extensions_callback_real.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/explain.h"
+#include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_ranker.h"
 #include "mongo/util/log.h"
 
@@ -70,6 +71,7 @@ static Status getPlanCache(OperationContext* opCtx,
 
     CollectionInfoCache* infoCache = collection->infoCache();
     invariant(infoCache);
+    infoCache->ensureIndexDataBuilt(opCtx);
 
     PlanCache* planCache = infoCache->getPlanCache();
     invariant(planCache);
@@ -92,6 +94,7 @@ MONGO_INITIALIZER_WITH_PREREQUISITES(SetupPlanCacheCommands, MONGO_NO_PREREQUISI
     new PlanCacheListQueryShapes();
     new PlanCacheClear();
     new PlanCacheListPlans();
+    new PlanCacheWarm();
 
     return Status::OK();
 }
@@ -442,4 +445,74 @@ Status PlanCacheListPlans::list(OperationContext* opCtx,
     return Status::OK();
 }
 
+PlanCacheWarm::PlanCacheWarm()
+    : PlanCacheCommand("planCacheWarm",
+                       "Plans and caches a list of query shapes in a collection.",
+                       ActionType::planCacheWrite) {}
+
+Status PlanCacheWarm::runPlanCacheCommand(OperationContext* opCtx,
+                                          const std::string& ns,
+                                          const BSONObj& cmdObj,
+                                          BSONObjBuilder* bob) {
+    AutoGetCollectionForReadCommand ctx(opCtx, NamespaceString(ns));
+
+    PlanCache* planCache;
+    Status status = getPlanCache(opCtx, ctx.getCollection(), ns, &planCache);
+    if (!status.isOK()) {
+        // No collection - nothing to do. Return OK status.
+        return Status::OK();
+    }
+    return warm(opCtx, ctx.getCollection(), *planCache, ns, cmdObj, bob);
+}
+
+// static
+Status PlanCacheWarm::warm(OperationContext* opCtx,
+                           Collection* collection,
+                           const PlanCache& planCache,
+                           const std::string& ns,
+                           const BSONObj& cmdObj,
+                           BSONObjBuilder* bob) {
+    BSONElement shapesElt = cmdObj.getField("shapes");
+    if (shapesElt.type() != Array) {
+        return Status(ErrorCodes::BadValue, "required field shapes must be an array");
+    }
+
+    const NamespaceString nss(ns);
+    int numShapes = 0;
+    int numCached = 0;
+    for (auto&& shapeElt : shapesElt.Obj()) {
+        if (!shapeElt.isABSONObj()) {
+            return Status(ErrorCodes::BadValue, "each element of shapes must be an object");
+        }
+
+        auto statusWithCQ = canonicalize(opCtx, ns, shapeElt.Obj());
+        if (!statusWithCQ.isOK()) {
+            return statusWithCQ.getStatus();
+        }
+
+        // Building the executor ranks the candidate plans and caches the winner; there is no need
+        // to run it.
+        auto statusWithExec = getExecutorFind(opCtx,
+                                              collection,
+                                              nss,
+                                              std::move(statusWithCQ.getValue()),
+                                              PlanExecutor::YIELD_AUTO);
+        if (!statusWithExec.isOK()) {
+            return statusWithExec.getStatus();
+        }
+
+        ++numShapes;
+        if (planCache.contains(*statusWithExec.getValue()->getCanonicalQuery())) {
+            ++numCached;
+        }
+    }
+
+    LOG(1) << ns << ": warmed plan cache with " << numShapes << " query shapes, " << numCached
+           << " of which are cached";
+
+    bob->append("numShapes", numShapes);
+    bob->append("numCached", numCached);
+    return Status::OK();
+}
+
 }  // namespace mongo
@@ -181,4 +181,37 @@ public:
                        BSONObjBuilder* bob);
 };
 
+/**
+ * planCacheWarm
+ *
+ * {
+ *     planCacheWarm: <collection>,
+ *     shapes: [{query: <query>, sort: <sort>, projection: <projection>, collation: <collation>},
+ *              ...]
+ * }
+ *
+ * Plans each query shape, caching the winning plan where there is a choice, so that the first
+ * queries after a restart or failover don't all pay for plan ranking. 'shapes' has the format
+ * returned by planCacheListQueryShapes, which lets the cache of one node seed another's.
+ */
+class PlanCacheWarm : public PlanCacheCommand {
+public:
+    PlanCacheWarm();
+    virtual Status runPlanCacheCommand(OperationContext* opCtx,
+                                       const std::string& ns,
+                                       const BSONObj& cmdObj,
+                                       BSONObjBuilder* bob);
+
+    /**
+     * Plans each shape in 'cmdObj' against 'collection', whose plan cache is 'planCache'.
+     * Reports how many shapes were planned and how many of them are now cached.
+     */
+    static Status warm(OperationContext* opCtx,
+                       Collection* collection,
+                       const PlanCache& planCache,
+                       const std::string& ns,
+                       const BSONObj& cmdObj,
+                       BSONObjBuilder* bob);
+};
+
 }  // namespace mongo
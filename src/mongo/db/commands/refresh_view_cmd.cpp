@@ -0,0 +1,144 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/auth/action_set.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/privilege.h"
+#include "mongo/db/catalog/database.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/repl/replication_coordinator_global.h"
+#include "mongo/db/views/view_catalog.h"
+#include "mongo/rpc/get_status_from_command_result.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Recomputes the contents of a materialized view, replacing those of the collection it is
+ * materialized into, and records that they are up to date as of the start of the refresh.
+ */
+class CmdRefreshView : public Command {
+public:
+    CmdRefreshView() : Command("refreshView") {}
+
+    bool slaveOk() const override {
+        return false;
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    void help(std::stringstream& help) const override {
+        help << "recompute a materialized view\n"
+                "{ refreshView: <view name>[, allowDiskUse: <bool>] }";
+    }
+
+    // The aggregation which recomputes the view checks that the user may read its sources and
+    // write the collection it is materialized into.
+    void addRequiredPrivileges(const std::string& dbname,
+                               const BSONObj& cmdObj,
+                               std::vector<Privilege>* out) override {
+        ActionSet actions;
+        actions.addAction(ActionType::find);
+        out->push_back(Privilege(parseResourcePattern(dbname, cmdObj), actions));
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             std::string& errmsg,
+             BSONObjBuilder& result) override {
+        const NamespaceString nss(parseNsCollectionRequired(dbname, cmdObj));
+
+        auto refresh = [&]() -> StatusWith<ViewCatalog::MaterializedViewRefresh> {
+            AutoGetDb autoDb(opCtx, dbname, MODE_IS);
+            if (!autoDb.getDb()) {
+                return {ErrorCodes::NamespaceNotFound,
+                        str::stream() << "database " << dbname << " not found"};
+            }
+            if (!repl::getGlobalReplicationCoordinator()->canAcceptWritesFor(opCtx, nss)) {
+                return {ErrorCodes::NotMaster,
+                        str::stream() << "Not primary while refreshing view " << nss.ns()};
+            }
+            return autoDb.getDb()->getViewCatalog()->beginMaterializedViewRefresh(opCtx, nss);
+        }();
+        if (!refresh.isOK()) {
+            return appendCommandStatus(result, refresh.getStatus());
+        }
+
+        // Recompute the view with $out, which atomically replaces the contents of its 'into'
+        // collection once the results are complete. No locks may be held while it runs.
+        const auto& view = refresh.getValue().view;
+        BSONArrayBuilder pipeline;
+        for (auto&& stage : view.getPipeline()) {
+            pipeline.append(stage);
+        }
+        pipeline.append(BSON("$out" << refresh.getValue().into.coll()));
+
+        BSONObjBuilder aggregate;
+        aggregate.append("aggregate", view.getNamespace().coll());
+        aggregate.append("pipeline", pipeline.arr());
+        aggregate.append("cursor", BSONObj());
+        aggregate.append("collation", refresh.getValue().collation);
+        if (auto allowDiskUse = cmdObj["allowDiskUse"]) {
+            aggregate.append("allowDiskUse", allowDiskUse.trueValue());
+        }
+
+        DBDirectClient client(opCtx);
+        BSONObj aggregateResult;
+        client.runCommand(dbname, aggregate.obj(), aggregateResult);
+        auto status = getStatusFromCommandResult(aggregateResult);
+        if (!status.isOK()) {
+            return appendCommandStatus(result,
+                                       {status.code(),
+                                        str::stream() << "failed to refresh view " << nss.ns()
+                                                      << ": "
+                                                      << status.reason()});
+        }
+
+        {
+            AutoGetDb autoDb(opCtx, dbname, MODE_IS);
+            if (autoDb.getDb()) {
+                autoDb.getDb()->getViewCatalog()->finishMaterializedViewRefresh(
+                    nss, refresh.getValue());
+            }
+        }
+
+        result.append("lastRefresh", refresh.getValue().startedAt);
+        return true;
+    }
+} cmdRefreshView;
+
+}  // namespace
+}  // namespace mongo
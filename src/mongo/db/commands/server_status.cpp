@@ -48,10 +48,12 @@
 #include "mongo/db/stats/counters.h"
 #include "mongo/platform/process_id.h"
 #include "mongo/transport/message_compressor_registry.h"
+#include "mongo/transport/service_executor.h"
 #include "mongo/transport/transport_layer.h"
 #include "mongo/util/log.h"
 #include "mongo/util/net/hostname_canonicalization.h"
 #include "mongo/util/net/ssl_manager.h"
+#include "mongo/util/numa.h"
 #include "mongo/util/processinfo.h"
 #include "mongo/util/ramlog.h"
 #include "mongo/util/time_support.h"
@@ -261,6 +263,21 @@ public:
 
 } extraInfo;
 
+class Numa : public ServerStatusSection {
+public:
+    Numa() : ServerStatusSection("numa") {}
+    virtual bool includeByDefault() const {
+        return NumaTopology::get().isNuma();
+    }
+
+    BSONObj generateSection(OperationContext* opCtx, const BSONElement& configElement) const {
+        BSONObjBuilder bb;
+        NumaTopology::get().appendStats(&bb);
+        return bb.obj();
+    }
+
+} numa;
+
 
 class Asserts : public ServerStatusSection {
 public:
@@ -293,6 +310,11 @@ public:
         BSONObjBuilder b;
         networkCounter.append(b);
         appendMessageCompressionStats(&b);
+        auto svcCtx = opCtx->getServiceContext();
+        svcCtx->getTransportLayer()->appendStats(&b);
+        if (auto executor = svcCtx->getServiceExecutor()) {
+            executor->appendStats(&b);
+        }
         return b.obj();
     }
 
@@ -307,12 +329,13 @@ public:
     }
 
     BSONObj generateSection(OperationContext* opCtx, const BSONElement& configElement) const {
-        BSONObj result;
+        BSONObjBuilder result;
         if (getSSLManager()) {
-            result = getSSLManager()->getSSLConfiguration().getServerStatusBSON();
+            result.appendElements(getSSLManager()->getSSLConfiguration().getServerStatusBSON());
+            getSSLManager()->appendHandshakeStats(&result);
         }
 
-        return result;
+        return result.obj();
     }
 } security;
 #endif
@@ -37,6 +37,7 @@
 #include "mongo/db/commands.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/query/internal_plans.h"
+#include "mongo/db/service_context.h"
 #include "mongo/db/storage/record_store.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
@@ -60,7 +61,9 @@ public:
     virtual void help(stringstream& h) const {
         h << "Validate contents of a namespace by scanning its data structures for correctness.  "
              "Slow.\n"
-             "Add full:true option to do a more thorough check";
+             "Add full:true option to do a more thorough check.\n"
+             "Add background:true option to validate a snapshot of the collection without "
+             "blocking writes to it";
     }
 
     virtual bool supportsWriteConcern(const BSONObj& cmd) const override {
@@ -73,7 +76,8 @@ public:
         actions.addAction(ActionType::validate);
         out->push_back(Privilege(parseResourcePattern(dbname, cmdObj), actions));
     }
-    //{ validate: "collectionnamewithoutthedbpart" [, scandata: <bool>] [, full: <bool> } */
+    //{ validate: "collectionnamewithoutthedbpart" [, scandata: <bool>] [, full: <bool>]
+    //  [, background: <bool>] } */
 
     bool run(OperationContext* opCtx,
              const string& dbname,
@@ -90,6 +94,7 @@ public:
 
         const bool full = cmdObj["full"].trueValue();
         const bool scanData = cmdObj["scandata"].trueValue();
+        const bool background = cmdObj["background"].trueValue();
 
         ValidateCmdLevel level = kValidateIndex;
 
@@ -104,12 +109,19 @@ public:
             return false;
         }
 
+        // Validating in the background relies on the storage engine reading the record store and
+        // the indexes from a single snapshot, as the collection is only intent locked.
+        if (background && !supportsDocLocking()) {
+            errmsg = "Background validation requires a storage engine with document-level locking";
+            return appendCommandStatus(result, {ErrorCodes::CommandNotSupported, errmsg});
+        }
+
         if (!serverGlobalParams.quiet.load()) {
-            LOG(0) << "CMD: validate " << nss.ns();
+            LOG(0) << "CMD: validate " << nss.ns() << (background ? " in the background" : "");
         }
 
-        AutoGetDb ctx(opCtx, nss.db(), MODE_IX);
-        Lock::CollectionLock collLk(opCtx->lockState(), nss.ns(), MODE_X);
+        AutoGetDb ctx(opCtx, nss.db(), background ? MODE_IS : MODE_IX);
+        Lock::CollectionLock collLk(opCtx->lockState(), nss.ns(), background ? MODE_IS : MODE_X);
         Collection* collection = ctx.getDb() ? ctx.getDb()->getCollection(opCtx, nss) : NULL;
         if (!collection) {
             if (ctx.getDb() && ctx.getDb()->getViewCatalog()->lookup(opCtx, nss.ns())) {
@@ -128,6 +140,12 @@ public:
         if (!status.isOK())
             return appendCommandStatus(result, status);
 
+        if (background) {
+            results.warnings.push_back(
+                "Validated a snapshot of the collection without verifying the storage engine's "
+                "data structures or correcting its size counters.");
+        }
+
         if (!full) {
             results.warnings.push_back(
                 "Some checks omitted for speed. use {full:true} option to do more thorough scan.");
@@ -26,6 +26,8 @@
  *    it in the license file.
  */
 
+#include <algorithm>
+
 #include "mongo/base/init.h"
 #include "mongo/bson/mutable/document.h"
 #include "mongo/bson/mutable/element.h"
@@ -87,6 +89,17 @@ Status checkAuthForWriteCommand(Client* client,
     return status;
 }
 
+void checkUpsertAuth(Client* client, const UpdateOp& batch) {
+    const bool containsUpserts = std::any_of(batch.updates.begin(),
+                                             batch.updates.end(),
+                                             [](const auto& update) { return update.upsert; });
+    if (containsUpserts &&
+        !AuthorizationSession::get(client)->isAuthorizedForActionsOnNamespace(batch.ns,
+                                                                              ActionType::insert)) {
+        uasserted(ErrorCodes::Unauthorized, "unauthorized");
+    }
+}
+
 bool shouldSkipOutput(OperationContext* opCtx) {
     const WriteConcernOptions& writeConcern = opCtx->getWriteConcern();
     return writeConcern.wMode.empty() && writeConcern.wNumNodes == 0 &&
@@ -212,8 +225,15 @@ public:
              const BSONObj& cmdObj,
              std::string& errmsg,
              BSONObjBuilder& result) final {
+        return enhancedRun(opCtx, OpMsgRequest::fromDBAndBody(dbname, cmdObj), errmsg, result);
+    }
+
+    bool enhancedRun(OperationContext* opCtx,
+                     const OpMsgRequest& request,
+                     std::string& errmsg,
+                     BSONObjBuilder& result) final {
         try {
-            runImpl(opCtx, dbname, cmdObj, result);
+            runImpl(opCtx, request, result);
             return true;
         } catch (const DBException& ex) {
             LastError::get(opCtx->getClient()).setLastError(ex.getCode(), ex.getInfo().msg);
@@ -222,8 +242,7 @@ public:
     }
 
     virtual void runImpl(OperationContext* opCtx,
-                         const std::string& dbname,
-                         const BSONObj& cmdObj,
+                         const OpMsgRequest& request,
                          BSONObjBuilder& result) = 0;
 };
 
@@ -251,10 +270,9 @@ public:
     }
 
     void runImpl(OperationContext* opCtx,
-                 const std::string& dbname,
-                 const BSONObj& cmdObj,
+                 const OpMsgRequest& request,
                  BSONObjBuilder& result) final {
-        const auto batch = parseInsertCommand(dbname, cmdObj);
+        const auto batch = parseInsertCommand(request);
         const auto reply = performInserts(opCtx, batch);
         serializeReply(opCtx,
                        ReplyStyle::kNotUpdate,
@@ -287,10 +305,14 @@ public:
     }
 
     void runImpl(OperationContext* opCtx,
-                 const std::string& dbname,
-                 const BSONObj& cmdObj,
+                 const OpMsgRequest& request,
                  BSONObjBuilder& result) final {
-        const auto batch = parseUpdateCommand(dbname, cmdObj);
+        const auto batch = parseUpdateCommand(request);
+        if (request.getSequence("updates")) {
+            // checkAuthForCommand() only sees the command body, so upserts sent as a document
+            // sequence need their insert privilege checked here.
+            checkUpsertAuth(opCtx->getClient(), batch);
+        }
         const auto reply = performUpdates(opCtx, batch);
         serializeReply(opCtx,
                        ReplyStyle::kUpdate,
@@ -357,10 +379,9 @@ public:
     }
 
     void runImpl(OperationContext* opCtx,
-                 const std::string& dbname,
-                 const BSONObj& cmdObj,
+                 const OpMsgRequest& request,
                  BSONObjBuilder& result) final {
-        const auto batch = parseDeleteCommand(dbname, cmdObj);
+        const auto batch = parseDeleteCommand(request);
         const auto reply = performDeletes(opCtx, batch);
         serializeReply(opCtx,
                        ReplyStyle::kNotUpdate,
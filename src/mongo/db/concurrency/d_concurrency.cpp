@@ -36,6 +36,7 @@
 #include <vector>
 
 #include "mongo/db/namespace_string.h"
+#include "mongo/db/operation_phases.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/stdx/memory.h"
@@ -155,11 +156,13 @@ void Lock::GlobalLock::_enqueue(LockMode lockMode, unsigned timeoutMs) {
         _pbwm.lock(MODE_IS);
     }
 
+    OperationPhases::Scope lockPhase(_opCtx, OperationPhases::Phase::kLockAcquisition);
     _result = _opCtx->lockState()->lockGlobalBegin(lockMode, Milliseconds(timeoutMs));
 }
 
 void Lock::GlobalLock::waitForLock(unsigned timeoutMs) {
     if (_result == LOCK_WAITING) {
+        OperationPhases::Scope lockPhase(_opCtx, OperationPhases::Phase::kLockAcquisition);
         _result = _opCtx->lockState()->lockGlobalComplete(Milliseconds(timeoutMs));
     }
 
@@ -192,6 +195,7 @@ Lock::DBLock::DBLock(OperationContext* opCtx, StringData db, LockMode mode)
         _mode = MODE_X;
     }
 
+    OperationPhases::Scope lockPhase(_opCtx, OperationPhases::Phase::kLockAcquisition);
     invariant(LOCK_OK == _opCtx->lockState()->lock(_id, _mode));
 }
 
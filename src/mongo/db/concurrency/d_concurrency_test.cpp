@@ -34,6 +34,7 @@
 #include <vector>
 
 #include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/concurrency/flow_control_ticketholder.h"
 #include "mongo/db/concurrency/lock_manager_test_help.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/stdx/functional.h"
@@ -44,6 +45,7 @@
 #include "mongo/util/debug_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/progress_meter.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/time_support.h"
 
 namespace mongo {
@@ -93,6 +95,23 @@ private:
     TicketHolder _holder;
 };
 
+/**
+ * A RAII object that instantiates a TicketHolder of numTickets from which, in addition, low
+ * priority lockers must obtain a ticket for global lock acquisitions.
+ */
+class UseLowPriorityThrottling {
+public:
+    explicit UseLowPriorityThrottling(int numTickets) : _holder(numTickets) {
+        Locker::setLowPriorityThrottling(&_holder, &_holder);
+    }
+    ~UseLowPriorityThrottling() {
+        Locker::setLowPriorityThrottling(nullptr, nullptr);
+    }
+
+private:
+    TicketHolder _holder;
+};
+
 
 class DConcurrencyTestFixture : public unittest::Test {
 public:
@@ -755,6 +774,77 @@ TEST_F(DConcurrencyTestFixture, Throttling) {
     ASSERT(!overlongWait);
 }
 
+TEST_F(DConcurrencyTestFixture, LowPriorityThrottling) {
+    auto clientOpctxPairs = makeKClientsWithLockers<DefaultLockerImpl>(3);
+    auto opctx1 = clientOpctxPairs[0].second.get();
+    auto opctx2 = clientOpctxPairs[1].second.get();
+    auto opctx3 = clientOpctxPairs[2].second.get();
+    TicketHolder regularTickets(2);
+    Locker::setGlobalThrottling(&regularTickets, &regularTickets);
+    ON_BLOCK_EXIT([] { Locker::setGlobalThrottling(nullptr, nullptr); });
+    UseLowPriorityThrottling throttle(1);
+    opctx1->lockState()->setLowPriorityAdmission(true);
+    opctx2->lockState()->setLowPriorityAdmission(true);
+    const Locker::TicketQueueStats statsBefore = Locker::getTicketQueueStats(true);
+
+    {
+        Lock::GlobalRead R1(opctx1, 0);
+        ASSERT(R1.isLocked());
+        ASSERT_EQ(1, regularTickets.used());
+
+        // The only low priority ticket is taken, so a second low priority operation waits even
+        // though a regular ticket is available, and the time it waited is recorded.
+        {
+            Lock::GlobalRead R2(opctx2, 10);
+            ASSERT(!R2.isLocked());
+        }
+        ASSERT_EQ(1, regularTickets.used());
+        Locker::LockerInfo lockerInfo;
+        opctx2->lockState()->getLockerInfo(&lockerInfo);
+        ASSERT(lockerInfo.lowPriorityAdmission);
+        ASSERT_GT(lockerInfo.ticketQueuedMicros, 0);
+        ASSERT_EQ(statsBefore.queued + 1, Locker::getTicketQueueStats(true).queued);
+
+        // It does not hold back operations of normal priority.
+        Lock::GlobalRead R3(opctx3, 0);
+        ASSERT(R3.isLocked());
+    }
+
+    // Both tickets of the low priority operation are released with its lock.
+    ASSERT_EQ(0, regularTickets.used());
+    Lock::GlobalRead R2(opctx2, 0);
+    ASSERT(R2.isLocked());
+}
+
+TEST_F(DConcurrencyTestFixture, FlowControlThrottlesWritesOnly) {
+    auto clientOpctxPairs = makeKClientsWithLockers<DefaultLockerImpl>(3);
+    auto opctx1 = clientOpctxPairs[0].second.get();
+    auto opctx2 = clientOpctxPairs[1].second.get();
+    auto opctx3 = clientOpctxPairs[2].second.get();
+    FlowControlTicketholder flowControl;
+    Locker::setFlowControlTicketholder(&flowControl);
+    ON_BLOCK_EXIT([] { Locker::setFlowControlTicketholder(nullptr); });
+    flowControl.refreshTo(1);
+
+    {
+        Lock::GlobalLock IX1(opctx1, MODE_IX, 0);
+        ASSERT(IX1.isLocked());
+
+        // The allowance is used up, so the next writer times out, while readers are not throttled.
+        {
+            Lock::GlobalLock IX2(opctx2, MODE_IX, 10);
+            ASSERT(!IX2.isLocked());
+        }
+        ASSERT_EQ(1, flowControl.getStats().acquireWaitCount);
+        Lock::GlobalRead R3(opctx3, 0);
+        ASSERT(R3.isLocked());
+    }
+
+    // Writers are admitted again once the allowance is refreshed.
+    flowControl.refreshTo(1);
+    Lock::GlobalLock IX2(opctx2, MODE_IX, 0);
+    ASSERT(IX2.isLocked());
+}
 
 // These tests exercise single- and multi-threaded performance of uncontended lock acquisition. It
 // is neither practical nor useful to run them on debug builds.
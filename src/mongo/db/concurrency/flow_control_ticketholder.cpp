@@ -0,0 +1,96 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/concurrency/flow_control_ticketholder.h"
+
+#include "mongo/util/timer.h"
+
+namespace mongo {
+
+void FlowControlTicketholder::refreshTo(int numTickets) {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _tickets = numTickets;
+        _ticketsPerRefresh = numTickets;
+        _enabled.store(true);
+    }
+    _refreshed.notify_all();
+}
+
+void FlowControlTicketholder::disable() {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _enabled.store(false);
+    }
+    _refreshed.notify_all();
+}
+
+int FlowControlTicketholder::getTicketsPerRefresh() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _ticketsPerRefresh;
+}
+
+bool FlowControlTicketholder::getTicket(Date_t deadline) {
+    _acquireCount.addAndFetch(1);
+    if (!_enabled.load()) {
+        return true;
+    }
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    auto hasTicket = [this] { return !_enabled.load() || _tickets > 0; };
+    if (!hasTicket()) {
+        _acquireWaitCount.addAndFetch(1);
+        Timer timer;
+        if (deadline == Date_t::max()) {
+            _refreshed.wait(lk, hasTicket);
+        } else {
+            _refreshed.wait_until(lk, deadline.toSystemTimePoint(), hasTicket);
+        }
+        _timeAcquiringMicros.addAndFetch(timer.micros());
+        if (!hasTicket()) {
+            return false;
+        }
+    }
+
+    if (_enabled.load()) {
+        --_tickets;
+    }
+    return true;
+}
+
+FlowControlTicketholder::Stats FlowControlTicketholder::getStats() const {
+    Stats stats;
+    stats.acquireCount = _acquireCount.load();
+    stats.acquireWaitCount = _acquireWaitCount.load();
+    stats.timeAcquiringMicros = _timeAcquiringMicros.load();
+    return stats;
+}
+
+}  // namespace mongo
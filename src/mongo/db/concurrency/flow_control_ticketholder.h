@@ -0,0 +1,99 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+/**
+ * Rate limits the writers admitted to the global lock. While enabled, every writer takes one
+ * ticket, which it does not give back, and the tickets are replaced by a new allowance with each
+ * call to refreshTo(). The flow control mechanism calls refreshTo() once a second, so the
+ * allowance is a number of writes per second. While disabled, which is the initial state, tickets
+ * are granted right away.
+ */
+class FlowControlTicketholder {
+    MONGO_DISALLOW_COPYING(FlowControlTicketholder);
+
+public:
+    struct Stats {
+        long long acquireCount = 0;
+        long long acquireWaitCount = 0;
+        long long timeAcquiringMicros = 0;
+    };
+
+    FlowControlTicketholder() = default;
+
+    /**
+     * Enables throttling, if needed, and replaces the tickets left from the previous allowance
+     * with 'numTickets' new ones.
+     */
+    void refreshTo(int numTickets);
+
+    /**
+     * Disables throttling and wakes up the writers waiting for a ticket.
+     */
+    void disable();
+
+    bool isEnabled() const {
+        return _enabled.load();
+    }
+
+    /**
+     * Returns the allowance given to the last call to refreshTo().
+     */
+    int getTicketsPerRefresh() const;
+
+    /**
+     * Obtains a ticket, waiting until 'deadline' at most for the next allowance. Returns false if
+     * the deadline passed without a ticket.
+     */
+    bool getTicket(Date_t deadline);
+
+    Stats getStats() const;
+
+private:
+    AtomicWord<bool> _enabled{false};
+
+    mutable stdx::mutex _mutex;
+    stdx::condition_variable _refreshed;
+    int _tickets = 0;
+    int _ticketsPerRefresh = 0;
+
+    AtomicInt64 _acquireCount;
+    AtomicInt64 _acquireWaitCount;
+    AtomicInt64 _timeAcquiringMicros;
+};
+
+}  // namespace mongo
@@ -0,0 +1,86 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/concurrency/flow_control_ticketholder.h"
+
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(FlowControlTicketholderTest, GrantsTicketsWhileDisabled) {
+    FlowControlTicketholder holder;
+    ASSERT_FALSE(holder.isEnabled());
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_TRUE(holder.getTicket(Date_t::now()));
+    }
+    ASSERT_EQ(10, holder.getStats().acquireCount);
+    ASSERT_EQ(0, holder.getStats().acquireWaitCount);
+}
+
+TEST(FlowControlTicketholderTest, RefreshReplacesTheAllowance) {
+    FlowControlTicketholder holder;
+    holder.refreshTo(2);
+    ASSERT_TRUE(holder.isEnabled());
+    ASSERT_EQ(2, holder.getTicketsPerRefresh());
+    ASSERT_TRUE(holder.getTicket(Date_t::now()));
+    ASSERT_TRUE(holder.getTicket(Date_t::now()));
+    ASSERT_FALSE(holder.getTicket(Date_t::now()));
+    ASSERT_EQ(1, holder.getStats().acquireWaitCount);
+
+    // Unused tickets do not carry over into the next allowance.
+    holder.refreshTo(3);
+    holder.refreshTo(1);
+    ASSERT_TRUE(holder.getTicket(Date_t::now()));
+    ASSERT_FALSE(holder.getTicket(Date_t::now()));
+}
+
+TEST(FlowControlTicketholderTest, WaitersAreWokenByRefreshAndDisable) {
+    FlowControlTicketholder holder;
+    holder.refreshTo(0);
+
+    bool acquired = false;
+    stdx::thread waiter([&] { acquired = holder.getTicket(Date_t::max()); });
+    holder.refreshTo(1);
+    waiter.join();
+    ASSERT_TRUE(acquired);
+
+    acquired = false;
+    holder.refreshTo(0);
+    stdx::thread disabledWaiter([&] { acquired = holder.getTicket(Date_t::max()); });
+    holder.disable();
+    disabledWaiter.join();
+    ASSERT_TRUE(acquired);
+    ASSERT_FALSE(holder.isEnabled());
+}
+
+}  // namespace
+}  // namespace mongo
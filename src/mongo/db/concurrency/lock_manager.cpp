@@ -411,8 +411,9 @@ void LockHead::migratePartitionedLockHeads() {
 const unsigned LockManager::_numLockBuckets(128);
 
 // Balance scalability of intent locks against potential added cost of conflicting locks.
-// The exact value doesn't appear very important, but should be power of two
-const unsigned LockManager::_numPartitions = 32;
+// The exact value doesn't appear very important, but should be power of two. On machines with
+// many cores fewer partitions than cores leaves concurrent lockers sharing partition mutexes.
+const unsigned LockManager::_numPartitions = 64;
 
 LockManager::LockManager() {
     _lockBuckets = new LockBucket[_numLockBuckets];
@@ -138,13 +138,19 @@ private:
     // The lockheads need access to the partitions
     friend struct LockHead;
 
-    // These types describe the locks hash table
+    // These types describe the locks hash table.
+    //
+    // Buckets and partitions are locked by many threads at once, so each ends with a cache line
+    // worth of padding. This keeps the mutex and map of one from sharing a cache line with those
+    // of its neighbour in the array, which would make lockers of different partitions contend.
+    static const size_t kCacheLinePadding = 64;
 
     struct LockBucket {
         SimpleMutex mutex;
         typedef unordered_map<ResourceId, LockHead*> Map;
         Map data;
         LockHead* findOrInsert(ResourceId resId);
+        char padding[kCacheLinePadding];
     };
 
     // Each locker maps to a partition that is used for resources acquired in intent modes
@@ -156,6 +162,7 @@ private:
         typedef unordered_map<ResourceId, PartitionedLockHead*> Map;
         SimpleMutex mutex;
         Map data;
+        char padding[kCacheLinePadding];
     };
 
     /**
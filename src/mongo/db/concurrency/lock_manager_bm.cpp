@@ -0,0 +1,142 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/db/concurrency/lock_manager.h"
+#include "mongo/db/concurrency/lock_manager_test_help.h"
+#include "mongo/db/concurrency/lock_state.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/benchmark.h"
+
+namespace mongo {
+namespace {
+
+using unittest::benchmarkDoNotOptimize;
+
+const ResourceId kDbId(RESOURCE_DATABASE, std::string("BenchmarkDB"));
+const ResourceId kCollId(RESOURCE_COLLECTION, std::string("BenchmarkDB.collection"));
+
+BENCHMARK(LockManager, LockUnlockUncontended) {
+    LockManager lockMgr;
+    MMAPV1LockerImpl locker;
+    TrackingLockGrantNotification notify;
+    LockRequest request;
+    request.initNew(&locker, &notify);
+
+    while (state.keepRunning()) {
+        benchmarkDoNotOptimize(lockMgr.lock(kCollId, &request, MODE_IX));
+        lockMgr.unlock(&request);
+    }
+}
+
+BENCHMARK(LockManager, LockUnlockShared) {
+    // Another holder of a compatible mode is already granted, so every request takes the
+    // compatible-mode path rather than the empty-queue path.
+    LockManager lockMgr;
+    MMAPV1LockerImpl otherLocker;
+    TrackingLockGrantNotification otherNotify;
+    LockRequest otherRequest;
+    otherRequest.initNew(&otherLocker, &otherNotify);
+    invariant(LOCK_OK == lockMgr.lock(kCollId, &otherRequest, MODE_IS));
+
+    MMAPV1LockerImpl locker;
+    TrackingLockGrantNotification notify;
+    LockRequest request;
+    request.initNew(&locker, &notify);
+
+    while (state.keepRunning()) {
+        benchmarkDoNotOptimize(lockMgr.lock(kCollId, &request, MODE_IS));
+        lockMgr.unlock(&request);
+    }
+    lockMgr.unlock(&otherRequest);
+}
+
+/**
+ * Acquires the global, database and collection locks through a Locker, the way a CRUD operation
+ * on a document-locking storage engine does.
+ */
+void lockHierarchy(Locker* locker) {
+    invariant(LOCK_OK == locker->lockGlobal(MODE_IX));
+    invariant(LOCK_OK == locker->lock(kDbId, MODE_IX));
+    invariant(LOCK_OK == locker->lock(kCollId, MODE_IX));
+    locker->unlock(kCollId);
+    locker->unlock(kDbId);
+    locker->unlockGlobal();
+}
+
+BENCHMARK(Locker, LockHierarchy) {
+    DefaultLockerImpl locker;
+    while (state.keepRunning()) {
+        lockHierarchy(&locker);
+    }
+}
+
+/**
+ * Runs the benchmark thread against background threads that acquire the same locks in
+ * compatible modes for the whole repetition.
+ */
+class ContendedLockerBenchmark : public unittest::Benchmark {
+protected:
+    static const int kNumBackgroundThreads = 3;
+
+    void setUp() override {
+        for (int i = 0; i < kNumBackgroundThreads; ++i) {
+            _threads.emplace_back([this] {
+                DefaultLockerImpl locker;
+                while (!_stop.load()) {
+                    lockHierarchy(&locker);
+                }
+            });
+        }
+    }
+
+    void tearDown() override {
+        _stop.store(true);
+        for (auto& thread : _threads) {
+            thread.join();
+        }
+    }
+
+private:
+    AtomicBool _stop{false};
+    std::vector<stdx::thread> _threads;
+};
+
+BENCHMARK_F(ContendedLockerBenchmark, LockHierarchy) {
+    DefaultLockerImpl locker;
+    while (state.keepRunning()) {
+        lockHierarchy(&locker);
+    }
+}
+
+}  // namespace
+}  // namespace mongo
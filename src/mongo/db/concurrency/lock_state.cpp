@@ -34,6 +34,7 @@
 
 #include <vector>
 
+#include "mongo/db/concurrency/flow_control_ticketholder.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/service_context.h"
 #include "mongo/platform/compiler.h"
@@ -42,6 +43,7 @@
 #include "mongo/util/debug_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace {
@@ -238,6 +240,38 @@ void CondVarLockGrantNotification::notify(ResourceId resId, LockResult result) {
 
 namespace {
 TicketHolder* ticketHolders[LockModesCount] = {};
+TicketHolder* lowPriorityTicketHolders[LockModesCount] = {};
+FlowControlTicketholder* flowControlTicketholder = nullptr;
+
+// Indexed by whether the waiting locker was low priority.
+AtomicInt64 ticketQueuedCounts[2];
+AtomicInt64 ticketQueuedMicros[2];
+
+/**
+ * Obtains a ticket from 'holder', waiting until 'deadline' at most. Time is only measured when
+ * there is no ticket available right away.
+ */
+bool acquireTicket(TicketHolder* holder,
+                   Date_t deadline,
+                   bool lowPriority,
+                   AtomicInt64* lockerQueuedMicros) {
+    if (holder->tryAcquire()) {
+        return true;
+    }
+
+    Timer timer;
+    bool acquired = true;
+    if (deadline == Date_t::max()) {
+        holder->waitForTicket();
+    } else {
+        acquired = holder->waitForTicketUntil(deadline);
+    }
+    const long long micros = timer.micros();
+    ticketQueuedCounts[lowPriority].addAndFetch(1);
+    ticketQueuedMicros[lowPriority].addAndFetch(micros);
+    lockerQueuedMicros->addAndFetch(micros);
+    return acquired;
+}
 }  // namespace
 
 
@@ -252,6 +286,26 @@ void Locker::setGlobalThrottling(class TicketHolder* reading, class TicketHolder
     ticketHolders[MODE_IX] = writing;
 }
 
+/* static */
+void Locker::setLowPriorityThrottling(class TicketHolder* reading, class TicketHolder* writing) {
+    lowPriorityTicketHolders[MODE_S] = reading;
+    lowPriorityTicketHolders[MODE_IS] = reading;
+    lowPriorityTicketHolders[MODE_IX] = writing;
+}
+
+/* static */
+void Locker::setFlowControlTicketholder(FlowControlTicketholder* holder) {
+    flowControlTicketholder = holder;
+}
+
+/* static */
+Locker::TicketQueueStats Locker::getTicketQueueStats(bool lowPriority) {
+    TicketQueueStats stats;
+    stats.queued = ticketQueuedCounts[lowPriority].load();
+    stats.queuedMicros = ticketQueuedMicros[lowPriority].load();
+    return stats;
+}
+
 template <bool IsForMMAPV1>
 LockerImpl<IsForMMAPV1>::LockerImpl()
     : _id(idCounter.addAndFetch(1)), _wuowNestingLevel(0), _threadId(stdx::this_thread::get_id()) {}
@@ -307,17 +361,38 @@ LockResult LockerImpl<IsForMMAPV1>::_lockGlobalBegin(LockMode mode, Milliseconds
     if (_modeForTicket == MODE_NONE) {
         const bool reader = isSharedLockMode(mode);
         auto holder = ticketHolders[mode];
-        if (holder) {
+        const bool lowPriority = _lowPriorityAdmission.load();
+        auto lowPriorityHolder = lowPriority ? lowPriorityTicketHolders[mode] : nullptr;
+        auto flowControlHolder = mode == MODE_IX ? flowControlTicketholder : nullptr;
+        if (holder || lowPriorityHolder || flowControlHolder) {
             _clientState.store(reader ? kQueuedReader : kQueuedWriter);
-            if (timeout == Milliseconds::max()) {
-                holder->waitForTicket();
-            } else if (!holder->waitForTicketUntil(Date_t::now() + timeout)) {
+            const Date_t deadline =
+                timeout == Milliseconds::max() ? Date_t::max() : Date_t::now() + timeout;
+            // A writer throttled by flow control waits before taking any other ticket, so that it
+            // does not hold back the writers already admitted.
+            if (flowControlHolder && !flowControlHolder->getTicket(deadline)) {
+                _clientState.store(kInactive);
+                return LOCK_TIMEOUT;
+            }
+            // The low priority ticket is always obtained first, so that a low priority locker
+            // waiting for its low priority ticket holds no regular ticket.
+            if (lowPriorityHolder &&
+                !acquireTicket(lowPriorityHolder, deadline, true, &_ticketQueuedMicros)) {
+                _clientState.store(kInactive);
+                return LOCK_TIMEOUT;
+            }
+            if (holder &&
+                !acquireTicket(holder, deadline, lowPriority, &_ticketQueuedMicros)) {
+                if (lowPriorityHolder) {
+                    lowPriorityHolder->release();
+                }
                 _clientState.store(kInactive);
                 return LOCK_TIMEOUT;
             }
         }
         _clientState.store(reader ? kActiveReader : kActiveWriter);
         _modeForTicket = mode;
+        _hasLowPriorityTicket = lowPriorityHolder != nullptr;
     }
     const LockResult result = lockBegin(resourceIdGlobal, mode);
     if (result == LOCK_OK)
@@ -567,6 +642,8 @@ void LockerImpl<IsForMMAPV1>::getLockerInfo(LockerInfo* lockerInfo) const {
 
     lockerInfo->waitingResource = getWaitingResource();
     lockerInfo->stats.append(_stats);
+    lockerInfo->lowPriorityAdmission = _lowPriorityAdmission.load();
+    lockerInfo->ticketQueuedMicros = _ticketQueuedMicros.load();
 }
 
 template <bool IsForMMAPV1>
@@ -803,10 +880,16 @@ bool LockerImpl<IsForMMAPV1>::_unlockImpl(LockRequestsMap::Iterator* it) {
         if (it->key() == resourceIdGlobal) {
             invariant(_modeForTicket != MODE_NONE);
             auto holder = ticketHolders[_modeForTicket];
+            auto lowPriorityHolder =
+                _hasLowPriorityTicket ? lowPriorityTicketHolders[_modeForTicket] : nullptr;
             _modeForTicket = MODE_NONE;
+            _hasLowPriorityTicket = false;
             if (holder) {
                 holder->release();
             }
+            if (lowPriorityHolder) {
+                lowPriorityHolder->release();
+            }
             _clientState.store(kInactive);
         }
 
@@ -101,6 +101,14 @@ public:
 
     stdx::thread::id getThreadId() const override;
 
+    virtual void setLowPriorityAdmission(bool lowPriority) {
+        _lowPriorityAdmission.store(lowPriority);
+    }
+
+    virtual bool isLowPriorityAdmission() const {
+        return _lowPriorityAdmission.load();
+    }
+
     virtual LockResult lockGlobal(LockMode mode);
     virtual LockResult lockGlobalBegin(LockMode mode, Milliseconds timeout) {
         return _lockGlobalBegin(mode, timeout);
@@ -228,6 +236,13 @@ private:
     // Mode for which the Locker acquired a ticket, or MODE_NONE if no ticket was acquired.
     LockMode _modeForTicket = MODE_NONE;
 
+    // Whether global lock attempts take tickets from the low priority pools, and whether the
+    // ticket held for '_modeForTicket' came with one of those. The priority and the total time
+    // this locker waited for tickets are also read by threads reporting on the operation.
+    AtomicWord<bool> _lowPriorityAdmission{false};
+    bool _hasLowPriorityTicket = false;
+    AtomicInt64 _ticketQueuedMicros{0};
+
     // Indicates whether the client is active reader/writer or is queued.
     AtomicWord<ClientState> _clientState{kInactive};
 
@@ -70,6 +70,42 @@ public:
      */
     static void setGlobalThrottling(class TicketHolder* reading, class TicketHolder* writing);
 
+    /**
+     * Require global lock attempts of low priority lockers to obtain a ticket from 'reading' (for
+     * MODE_S and MODE_IS) or 'writing' (for MODE_IX) before their ticket from the pools given to
+     * setGlobalThrottling(). This bounds the number of regular tickets taken by low priority
+     * operations, such as batch jobs, to the size of these pools, which must have static
+     * lifetimes.
+     */
+    static void setLowPriorityThrottling(class TicketHolder* reading, class TicketHolder* writing);
+
+    /**
+     * Require global lock attempts in MODE_IX to obtain a ticket from 'holder', which rate limits
+     * writes while flow control is engaged, before any other ticket. 'holder' must outlive every
+     * Locker and may be null to remove the limit.
+     */
+    static void setFlowControlTicketholder(class FlowControlTicketholder* holder);
+
+    /**
+     * Cumulative number of global lock attempts of a priority which had to wait for a ticket, and
+     * the time they waited.
+     */
+    struct TicketQueueStats {
+        long long queued = 0;
+        long long queuedMicros = 0;
+    };
+
+    static TicketQueueStats getTicketQueueStats(bool lowPriority);
+
+    /**
+     * Marks the operation of this locker as low priority for admission, which makes its global
+     * lock attempts obtain tickets from the pools given to setLowPriorityThrottling(). Takes
+     * effect from the next time the global lock is acquired.
+     */
+    virtual void setLowPriorityAdmission(bool lowPriority) = 0;
+
+    virtual bool isLowPriorityAdmission() const = 0;
+
     /**
      * State for reporting the number of active and queued reader and writer clients.
      */
@@ -253,6 +289,11 @@ public:
 
         // Lock timing statistics
         SingleThreadedLockStats stats;
+
+        // Whether this locker is low priority for admission, and the time it spent waiting for
+        // tickets
+        bool lowPriorityAdmission = false;
+        long long ticketQueuedMicros = 0;
     };
 
     virtual void getLockerInfo(LockerInfo* lockerInfo) const = 0;
@@ -53,6 +53,14 @@ public:
         invariant(false);
     }
 
+    virtual void setLowPriorityAdmission(bool lowPriority) {
+        invariant(false);
+    }
+
+    virtual bool isLowPriorityAdmission() const {
+        invariant(false);
+    }
+
     stdx::thread::id getThreadId() const override {
         invariant(false);
     }
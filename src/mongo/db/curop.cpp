@@ -34,6 +34,10 @@
 
 #include "mongo/db/curop.h"
 
+#if defined(__linux__)
+#include <pthread.h>
+#endif
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/bson/mutable/document.h"
 #include "mongo/db/client.h"
@@ -53,6 +57,17 @@ using std::string;
 
 namespace {
 
+#if defined(__linux__)
+// Returns the reading of 'clock' in microseconds, or -1 if it cannot be read.
+long long readCpuClockMicros(clockid_t clock) {
+    struct timespec ts;
+    if (clock_gettime(clock, &ts) != 0) {
+        return -1;
+    }
+    return ts.tv_sec * 1000LL * 1000LL + ts.tv_nsec / 1000;
+}
+#endif
+
 // Lists the $-prefixed query options that can be passed alongside a wrapped query predicate for
 // OP_QUERY find. The $orderby field is omitted because "orderby" (no dollar sign) is also allowed,
 // and this requires special handling.
@@ -227,6 +242,11 @@ CurOp* CurOp::get(const OperationContext& opCtx) {
 CurOp::CurOp(OperationContext* opCtx) : CurOp(opCtx, &_curopStack(opCtx)) {}
 
 CurOp::CurOp(OperationContext* opCtx, CurOpStack* stack) : _stack(stack) {
+#if defined(__linux__)
+    if (pthread_getcpuclockid(pthread_self(), &_cpuClock) == 0) {
+        _cpuTimeAtStart = readCpuClockMicros(_cpuClock);
+    }
+#endif
     if (opCtx) {
         _stack->push(opCtx, this);
     } else {
@@ -266,6 +286,23 @@ void CurOp::ensureStarted() {
     }
 }
 
+void CurOp::done() {
+    _end = curTimeMicros64();
+    _debug.cpuTimeMicros = cpuTimeMicros();
+}
+
+long long CurOp::cpuTimeMicros() const {
+#if defined(__linux__)
+    if (_cpuTimeAtStart >= 0) {
+        long long now = readCpuClockMicros(_cpuClock);
+        if (now >= _cpuTimeAtStart) {
+            return now - _cpuTimeAtStart;
+        }
+    }
+#endif
+    return -1;
+}
+
 void CurOp::enter_inlock(const char* ns, boost::optional<int> dbProfileLevel) {
     ensureStarted();
     _ns = ns;
@@ -353,6 +390,11 @@ void CurOp::reportState(BSONObjBuilder* builder) {
         builder->append("microsecs_running", static_cast<long long int>(elapsedMicros()));
     }
 
+    const long long cpuTime = cpuTimeMicros();
+    if (cpuTime >= 0) {
+        builder->append("cpuTimeMicros", cpuTime);
+    }
+
     builder->append("op", logicalOpToString(_logicalOp));
     builder->append("ns", _ns);
 
@@ -500,6 +542,7 @@ string OpDebug::report(Client* client,
     OPDEBUG_TOSTRING_HELP_BOOL(hasSortStage);
     OPDEBUG_TOSTRING_HELP_BOOL(fromMultiPlanner);
     OPDEBUG_TOSTRING_HELP_BOOL(replanned);
+    OPDEBUG_TOSTRING_HELP(planExecutionNanos);
     OPDEBUG_TOSTRING_HELP(nMatched);
     OPDEBUG_TOSTRING_HELP(nModified);
     OPDEBUG_TOSTRING_HELP(ninserted);
@@ -524,6 +567,23 @@ string OpDebug::report(Client* client,
         s << " writeConflicts:" << writeConflicts;
     }
 
+    OPDEBUG_TOSTRING_HELP(cpuTimeMicros);
+    if (ticketQueuedMicros > 0) {
+        s << " ticketQueuedMicros:" << ticketQueuedMicros;
+    }
+
+    if (arenaBytes > 0) {
+        s << " arenaBytes:" << arenaBytes;
+    }
+
+    {
+        BSONObjBuilder phaseMicros;
+        phases.append(&phaseMicros);
+        if (!phaseMicros.asTempObj().isEmpty()) {
+            s << " phaseMicros:" << phaseMicros.obj().toString();
+        }
+    }
+
     if (!exceptionInfo.empty()) {
         s << " exception: " << redact(exceptionInfo.msg);
         if (exceptionInfo.code)
@@ -601,6 +661,7 @@ void OpDebug::append(const CurOp& curop,
     OPDEBUG_APPEND_BOOL(hasSortStage);
     OPDEBUG_APPEND_BOOL(fromMultiPlanner);
     OPDEBUG_APPEND_BOOL(replanned);
+    OPDEBUG_APPEND_NUMBER(planExecutionNanos);
     OPDEBUG_APPEND_NUMBER(nMatched);
     OPDEBUG_APPEND_NUMBER(nModified);
     OPDEBUG_APPEND_NUMBER(ninserted);
@@ -625,6 +686,23 @@ void OpDebug::append(const CurOp& curop,
         b.appendNumber("writeConflicts", writeConflicts);
     }
 
+    OPDEBUG_APPEND_NUMBER(cpuTimeMicros);
+    if (ticketQueuedMicros > 0) {
+        b.appendNumber("ticketQueuedMicros", ticketQueuedMicros);
+    }
+
+    if (arenaBytes > 0) {
+        b.appendNumber("arenaBytes", arenaBytes);
+    }
+
+    {
+        BSONObjBuilder phaseMicros;
+        phases.append(&phaseMicros);
+        if (!phaseMicros.asTempObj().isEmpty()) {
+            b.append("phaseMicros", phaseMicros.obj());
+        }
+    }
+
     b.appendNumber("numYield", curop.numYields());
 
     {
@@ -658,6 +736,7 @@ void OpDebug::setPlanSummaryMetrics(const PlanSummaryStats& planSummaryStats) {
     hasSortStage = planSummaryStats.hasSortStage;
     fromMultiPlanner = planSummaryStats.fromMultiPlanner;
     replanned = planSummaryStats.replanned;
+    planExecutionNanos = planSummaryStats.executionTimeNanos;
 }
 
 }  // namespace mongo
@@ -31,10 +31,15 @@
 
 #pragma once
 
+#if defined(__linux__)
+#include <time.h>
+#endif
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/cursor_id.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/operation_phases.h"
 #include "mongo/db/server_options.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/util/net/message.h"
@@ -102,6 +107,9 @@ public:
     // True if a replan was triggered during the execution of this operation.
     bool replanned{false};
 
+    // Nanoseconds spent executing the query plan of the operation, not counting yields.
+    long long planExecutionNanos{-1};
+
     long long nMatched{-1};   // number of records that match the query
     long long nModified{-1};  // number of records written (no no-ops)
     long long ninserted{-1};
@@ -118,6 +126,20 @@ public:
     long long keysDeleted{0};   // Number of index keys removed.
     long long writeConflicts{0};
 
+    // Resources consumed by the operation. The CPU time of the thread running the operation is
+    // -1 on platforms where it cannot be measured, and the time spent queued for a ticket to
+    // the storage engine only covers the tickets acquired along with the global lock.
+    long long cpuTimeMicros{-1};
+    long long ticketQueuedMicros{0};
+
+    // Memory the operation drew from its OperationArena, copied from the OperationContext when
+    // the operation is reported.
+    long long arenaBytes{0};
+
+    // Time the operation spent in each of the phases which most often explain its latency,
+    // copied from the OperationContext when the operation is reported.
+    OperationPhases phases;
+
     BSONObj execStats;  // Owned here.
 
     // error handling
@@ -285,9 +307,7 @@ public:
         ensureStarted();
         return _start;
     }
-    void done() {
-        _end = curTimeMicros64();
-    }
+    void done();
     bool isDone() const {
         return _end > 0;
     }
@@ -297,6 +317,13 @@ public:
         return _end - startTime();
     }
 
+    /**
+     * Returns the CPU time the thread running this operation has spent on it so far, in
+     * microseconds, or -1 if the platform cannot measure the CPU time of a thread. May be called
+     * from threads other than the one running the operation.
+     */
+    long long cpuTimeMicros() const;
+
     long long elapsedMicros() {
         return curTimeMicros64() - startTime();
     }
@@ -419,6 +446,12 @@ private:
     long long _start{0};
     long long _end{0};
 
+#if defined(__linux__)
+    // The CPU clock of the thread which created this CurOp, and its reading at that time.
+    clockid_t _cpuClock;
+    long long _cpuTimeAtStart{-1};
+#endif
+
     // _networkOp represents the network-level op code: OP_QUERY, OP_GET_MORE, OP_COMMAND, etc.
     NetworkOp _networkOp{opInvalid};  // only set this through setNetworkOp_inlock() to keep synced
     // _logicalOp is the logical operation type, ie 'dbQuery' regardless of whether this is an
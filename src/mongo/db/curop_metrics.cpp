@@ -28,10 +28,15 @@
 
 #include "mongo/platform/basic.h"
 
+#include <array>
+
 #include "mongo/base/counter.h"
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/operation_phases.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/bits.h"
 
 namespace mongo {
 namespace {
@@ -58,6 +63,70 @@ ServerStatusMetricField<Counter64> displayScanAndOrder("operation.scanAndOrder",
 ServerStatusMetricField<Counter64> displayWriteConflicts("operation.writeConflicts",
                                                          &writeConflictsCounter);
 
+/**
+ * Distribution of the time operations spend in each of their phases, in buckets of powers of two
+ * microseconds. Operations which did not go through a phase are not counted in its histogram.
+ */
+class OperationPhaseHistograms final : public ServerStatusMetric {
+public:
+    OperationPhaseHistograms() : ServerStatusMetric("operation.phases") {}
+
+    void record(const OperationPhases& phases) {
+        for (size_t i = 0; i < OperationPhases::kNumPhases; ++i) {
+            const long long micros = phases.micros(static_cast<OperationPhases::Phase>(i));
+            if (micros <= 0) {
+                continue;
+            }
+            Histogram& histogram = _histograms[i];
+            histogram.ops.fetchAndAdd(1);
+            histogram.latency.fetchAndAdd(micros);
+            histogram.buckets[_bucket(micros)].fetchAndAdd(1);
+        }
+    }
+
+    void appendAtLeaf(BSONObjBuilder& b) const final {
+        BSONObjBuilder phasesBuilder(b.subobjStart(_leafName));
+        for (size_t i = 0; i < OperationPhases::kNumPhases; ++i) {
+            const Histogram& histogram = _histograms[i];
+            BSONObjBuilder histogramBuilder(
+                phasesBuilder.subobjStart(OperationPhases::phaseName(
+                    static_cast<OperationPhases::Phase>(i))));
+            {
+                BSONArrayBuilder arrayBuilder(histogramBuilder.subarrayStart("histogram"));
+                for (size_t bucket = 0; bucket < kNumBuckets; ++bucket) {
+                    const long long count = histogram.buckets[bucket].load();
+                    if (count == 0) {
+                        continue;
+                    }
+                    BSONObjBuilder entryBuilder(arrayBuilder.subobjStart());
+                    entryBuilder.append("micros", bucket == 0 ? 0LL : 1LL << bucket);
+                    entryBuilder.append("count", count);
+                }
+            }
+            histogramBuilder.append("latency", histogram.latency.load());
+            histogramBuilder.append("ops", histogram.ops.load());
+        }
+    }
+
+private:
+    // Bucket i > 0 counts the phases which lasted [2^i, 2^(i+1)) microseconds, and the last
+    // bucket every phase longer than that.
+    static const size_t kNumBuckets = 32;
+
+    struct Histogram {
+        AtomicInt64 ops;
+        AtomicInt64 latency;
+        std::array<AtomicInt64, kNumBuckets> buckets;
+    };
+
+    static size_t _bucket(long long micros) {
+        const size_t bucket = 63 - countLeadingZeros64(micros);
+        return bucket < kNumBuckets ? bucket : kNumBuckets - 1;
+    }
+
+    std::array<Histogram, OperationPhases::kNumPhases> _histograms;
+} operationPhaseHistograms;
+
 }  // namespace
 
 void recordCurOpMetrics(OperationContext* opCtx) {
@@ -79,6 +148,8 @@ void recordCurOpMetrics(OperationContext* opCtx) {
         scanAndOrderCounter.increment();
     if (debug.writeConflicts)
         writeConflictsCounter.increment(debug.writeConflicts);
+
+    operationPhaseHistograms.record(OperationPhases::get(opCtx));
 }
 
 }  // namespace mongo
@@ -49,6 +49,7 @@
 #include "mongo/db/auth/authorization_manager.h"
 #include "mongo/db/auth/authorization_manager_global.h"
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/collection_info_cache_impl.h"
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/database_catalog_entry.h"
 #include "mongo/db/catalog/database_holder.h"
@@ -82,6 +83,7 @@
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/repair_database.h"
 #include "mongo/db/repl/drop_pending_collection_reaper.h"
+#include "mongo/db/repl/flow_control.h"
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/repl_settings.h"
 #include "mongo/db/repl/replication_consistency_markers_impl.h"
@@ -121,6 +123,8 @@
 #include "mongo/stdx/future.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/thread.h"
+#include "mongo/transport/service_executor_adaptive.h"
+#include "mongo/transport/transport_layer_asio.h"
 #include "mongo/transport/transport_layer_legacy.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/background.h"
@@ -135,6 +139,8 @@
 #include "mongo/util/net/listen.h"
 #include "mongo/util/net/ssl_manager.h"
 #include "mongo/util/ntservice.h"
+#include "mongo/util/numa.h"
+#include "mongo/util/periodic_runner_impl.h"
 #include "mongo/util/options_parser/startup_options.h"
 #include "mongo/util/quick_exit.h"
 #include "mongo/util/ramlog.h"
@@ -482,24 +488,72 @@ ExitCode _initAndListen(int listenPort) {
 
     logProcessDetails();
 
-    globalServiceContext->createLockFile();
+    // The memory policy is inherited by the threads created from here on, which include those
+    // allocating the storage engine cache and serving clients.
+    if (NumaTopology::shouldInterleaveMemory()) {
+        const auto& numa = NumaTopology::get();
+        Status status = numa.interleaveMemory();
+        if (status.isOK()) {
+            log(LogComponent::kControl) << "Interleaving memory across " << numa.nodes().size()
+                                        << " NUMA node(s)";
+        } else {
+            warning() << status.reason();
+        }
+    }
 
-    transport::TransportLayerLegacy::Options options;
-    options.port = listenPort;
-    options.ipList = serverGlobalParams.bind_ip;
+    globalServiceContext->createLockFile();
 
     globalServiceContext->setServiceEntryPoint(
         stdx::make_unique<ServiceEntryPointMongod>(globalServiceContext->getTransportLayer()));
 
     // Create, start, and attach the TL
-    auto transportLayer = stdx::make_unique<transport::TransportLayerLegacy>(
-        options, globalServiceContext->getServiceEntryPoint());
-    auto res = transportLayer->setup();
+    std::unique_ptr<transport::TransportLayer> transportLayer;
+    Status res = Status::OK();
+    if (serverGlobalParams.transportLayer == "asio") {
+        transport::TransportLayerASIO::Options options;
+        options.port = listenPort;
+        options.ipList = serverGlobalParams.bind_ip;
+
+        auto asioTL = stdx::make_unique<transport::TransportLayerASIO>(
+            options, globalServiceContext->getServiceEntryPoint());
+        res = asioTL->setup();
+        transportLayer = std::move(asioTL);
+    } else {
+        transport::TransportLayerLegacy::Options options;
+        options.port = listenPort;
+        options.ipList = serverGlobalParams.bind_ip;
+
+        auto legacyTL = stdx::make_unique<transport::TransportLayerLegacy>(
+            options, globalServiceContext->getServiceEntryPoint());
+        res = legacyTL->setup();
+        transportLayer = std::move(legacyTL);
+    }
     if (!res.isOK()) {
         error() << "Failed to set up listener: " << res;
         return EXIT_NET_ERROR;
     }
 
+    if (serverGlobalParams.serviceExecutor == "adaptive") {
+        auto exec = stdx::make_unique<transport::ServiceExecutorAdaptive>(
+            globalServiceContext->getTickSource());
+        auto status = exec->start();
+        if (!status.isOK()) {
+            error() << "Failed to start the service executor: " << status;
+            return EXIT_NET_ERROR;
+        }
+        globalServiceContext->setServiceExecutor(std::move(exec));
+    }
+
+    {
+        // The background jobs that wake up periodically share the threads of a single runner.
+        PeriodicRunnerImpl::Options options;
+        options.onCreateThread = [](const std::string& threadName) {
+            Client::initThread(threadName.c_str());
+        };
+        globalServiceContext->setPeriodicRunner(stdx::make_unique<PeriodicRunnerImpl>(
+            globalServiceContext->getPreciseClockSource(), std::move(options)));
+    }
+
     globalServiceContext->initializeGlobalStorageEngine();
 
 #ifdef MONGO_CONFIG_WIREDTIGER_ENABLED
@@ -624,6 +678,13 @@ ExitCode _initAndListen(int listenPort) {
                   << "2.6 and then run the authSchemaUpgrade command.";
             exitCleanly(EXIT_NEED_UPGRADE);
         }
+
+        if (globalAuthzManager->isAuthEnabled()) {
+            status = globalAuthzManager->preloadUserCache(startupOpCtx.get());
+            if (!status.isOK()) {
+                warning() << "Could not preload the user cache: " << redact(status);
+            }
+        }
     } else if (globalAuthzManager->isAuthEnabled()) {
         error() << "Auth must be disabled when starting without auth schema validation";
         exitCleanly(EXIT_BADOPTIONS);
@@ -668,6 +729,7 @@ ExitCode _initAndListen(int listenPort) {
         }
 
         repl::getGlobalReplicationCoordinator()->startup(startupOpCtx.get());
+        repl::FlowControl::get(globalServiceContext)->startup();
 
         const unsigned long long missingRepl =
             checkIfReplMissingFromCommandLine(startupOpCtx.get());
@@ -700,8 +762,10 @@ ExitCode _initAndListen(int listenPort) {
     }
 
     startClientCursorMonitor();
+    CollectionInfoCacheImpl::startIdleEvictor();
 
     PeriodicTask::startRunningPeriodicTasks();
+    uassertStatusOK(globalServiceContext->getPeriodicRunner()->startup());
 
     // MessageServer::run will return when exit code closes its socket and we don't need the
     // operation context anymore
@@ -924,6 +988,7 @@ MONGO_INITIALIZER_WITH_PREREQUISITES(CreateReplicationManager,
         replicationProcess,
         storageInterface,
         static_cast<int64_t>(curTimeMillis64()));
+    repl::FlowControl::set(serviceContext, stdx::make_unique<repl::FlowControl>(replCoord.get()));
     repl::ReplicationCoordinator::set(serviceContext, std::move(replCoord));
     repl::setOplogCollectionName();
     return Status::OK();
@@ -963,15 +1028,26 @@ static void shutdownTask() {
     log(LogComponent::kNetwork) << "shutdown: going to flush diaglog..." << endl;
     _diaglog.flush();
 
+    // Release the writers throttled by flow control, which would otherwise hold up the shutdown.
+    if (auto flowControl = repl::FlowControl::get(serviceContext)) {
+        flowControl->shutdown();
+    }
+
     if (opCtx) {
         // This can wait a long time while we drain the secondary's apply queue, especially if it is
         // building an index.
         repl::ReplicationCoordinator::get(opCtx)->shutdown(opCtx);
     }
 
-    if (serviceContext)
+    if (serviceContext) {
         serviceContext->setKillAllOperations();
 
+        // Wait for the periodic jobs, whose operations are now being interrupted, to finish.
+        if (auto runner = serviceContext->getPeriodicRunner()) {
+            runner->shutdown();
+        }
+    }
+
     ReplicaSetMonitor::shutdown();
     if (auto sr = grid.shardRegistry()) {  // TODO: race: sr is a naked pointer
         sr->shutdown();
@@ -34,12 +34,68 @@
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/client.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/s/collection_sharding_state.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/stats/counters.h"
 #include "mongo/db/stats/top.h"
+#include "mongo/db/storage/storage_engine.h"
 
 namespace mongo {
+namespace {
+
+// When true, reads on a secondary that would otherwise be serialized against the application of
+// each replication batch read from the snapshot taken after the last applied batch instead.
+MONGO_EXPORT_SERVER_PARAMETER(readFromAppliedSnapshotOnSecondaries, bool, false);
+
+Counter64 readsFromAppliedSnapshot;
+Counter64 readsFromAppliedSnapshotFallenBack;
+ServerStatusMetricField<Counter64> displayReadsFromAppliedSnapshot(
+    "repl.appliedSnapshotReads.avoidedBatchLock", &readsFromAppliedSnapshot);
+ServerStatusMetricField<Counter64> displayReadsFromAppliedSnapshotFallenBack(
+    "repl.appliedSnapshotReads.fellBackToBatchLock", &readsFromAppliedSnapshotFallenBack);
+
+/**
+ * Sets up 'opCtx' to read from the last applied snapshot without conflicting with secondary batch
+ * application, if this node is a secondary and the read is eligible to do so. Must be called
+ * before any locks are taken.
+ */
+void readFromAppliedSnapshotIfSecondary(OperationContext* opCtx, const NamespaceString& nss) {
+    if (!readFromAppliedSnapshotOnSecondaries.load()) {
+        return;
+    }
+
+    // Operations already holding locks have a view that is tied to them, and internal operations
+    // such as the oplog applier itself have already opted out of conflicting with batches.
+    Locker* locker = opCtx->lockState();
+    if (locker->isLocked() || !locker->shouldConflictWithSecondaryBatchApplication()) {
+        return;
+    }
+
+    // Readers of the oplog (e.g. chained secondaries) want to see entries as soon as they are
+    // written, not once the batch containing them has been applied.
+    if (nss.isOplog() || opCtx->recoveryUnit()->isReadingFromMajorityCommittedSnapshot()) {
+        return;
+    }
+
+    auto replCoord = repl::ReplicationCoordinator::get(opCtx);
+    if (replCoord->getReplicationMode() != repl::ReplicationCoordinator::modeReplSet ||
+        !replCoord->getMemberState().secondary()) {
+        return;
+    }
+
+    if (!opCtx->recoveryUnit()->setReadFromLastAppliedSnapshot().isOK()) {
+        return;
+    }
+
+    locker->setShouldConflictWithSecondaryBatchApplication(false);
+    readsFromAppliedSnapshot.increment();
+}
+
+}  // namespace
 
 AutoGetDb::AutoGetDb(OperationContext* opCtx, StringData ns, LockMode mode)
     : _dbLock(opCtx, ns, mode), _db(dbHolder().get(opCtx, ns)) {}
@@ -107,6 +163,8 @@ AutoStatsTracker::~AutoStatsTracker() {
 AutoGetCollectionForRead::AutoGetCollectionForRead(OperationContext* opCtx,
                                                    const NamespaceString& nss,
                                                    AutoGetCollection::ViewMode viewMode) {
+    readFromAppliedSnapshotIfSecondary(opCtx, nss);
+
     _autoColl.emplace(opCtx, nss, MODE_IS, MODE_IS, viewMode);
 
     // Note: this can yield.
@@ -124,6 +182,24 @@ void AutoGetCollectionForRead::_ensureMajorityCommittedSnapshotIsValid(const Nam
         if (!minSnapshot) {
             return;
         }
+
+        auto appliedSnapshot = opCtx->recoveryUnit()->getLastAppliedSnapshot();
+        if (appliedSnapshot && *appliedSnapshot < *minSnapshot) {
+            // The catalog changed after the last applied snapshot was taken, so the snapshot
+            // cannot be used to read this collection. Rather than wait for the next batch to be
+            // applied, go back to reading the latest data under the batch lock.
+            _autoColl = boost::none;
+
+            opCtx->setRecoveryUnit(
+                opCtx->getServiceContext()->getGlobalStorageEngine()->newRecoveryUnit(),
+                OperationContext::kNotInUnitOfWork);
+            opCtx->lockState()->setShouldConflictWithSecondaryBatchApplication(true);
+            readsFromAppliedSnapshotFallenBack.increment();
+
+            _autoColl.emplace(opCtx, nss, MODE_IS);
+            return;
+        }
+
         auto mySnapshot = opCtx->recoveryUnit()->getMajorityCommittedSnapshot();
         if (!mySnapshot) {
             return;
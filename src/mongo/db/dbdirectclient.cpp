@@ -127,6 +127,8 @@ bool DBDirectClient::call(Message& toSend, Message& response, bool assertOk, str
     auto dbResponse = assembleResponse(_opCtx, toSend, kHostAndPortForDirectClient);
     invariant(!dbResponse.response.empty());
     response = std::move(dbResponse.response);
+    // Callers read the reply in place, so it can't reference documents it doesn't hold.
+    response.flatten();
 
     return true;
 }
@@ -321,6 +321,7 @@ public:
 struct DbResponse {
     Message response;       // If empty, nothing will be returned to the client.
     std::string exhaustNS;  // Namespace of cursor if exhaust mode, else "".
+    BSONObj nextInvocation;  // getMore to run next if exhausting an OP_MSG cursor, else empty.
 };
 
 /**
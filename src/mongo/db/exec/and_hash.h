@@ -31,11 +31,11 @@
 #include <vector>
 
 #include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/exec/record_id_bitmap.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/record_id.h"
 #include "mongo/platform/unordered_map.h"
-#include "mongo/platform/unordered_set.h"
 
 namespace mongo {
 
@@ -110,8 +110,7 @@ private:
 
     // Keeps track of what elements from _dataMap subsequent children have seen.
     // Only used while _hashingChildren.
-    typedef unordered_set<RecordId, RecordId::Hasher> SeenMap;
-    SeenMap _seenMap;
+    RecordIdBitmap _seenMap;
 
     // True if we're still intersecting _children[0..._children.size()-1].
     bool _hashingChildren;
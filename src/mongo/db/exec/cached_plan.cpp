@@ -36,6 +36,7 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/exec/multi_plan.h"
 #include "mongo/db/exec/scoped_timer.h"
+#include "mongo/db/exec/subplan.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/plan_cache.h"
@@ -72,10 +73,10 @@ CachedPlanStage::CachedPlanStage(OperationContext* opCtx,
 }
 
 Status CachedPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
-    // Adds the amount of time taken by pickBestPlan() to executionTimeMillis. There's lots of
+    // Adds the amount of time taken by pickBestPlan() to executionTimeNanos. There's lots of
     // execution work that happens here, so this is needed for the time accounting to
     // make sense.
-    ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
+    ScopedTimer timer(getTickSource(), &_commonStats.executionTimeNanos);
 
     // If we work this many times during the trial period, then we will replan the
     // query from scratch.
@@ -204,6 +205,35 @@ Status CachedPlanStage::replan(PlanYieldPolicy* yieldPolicy, bool shouldCache) {
 
     _specificStats.replanned = true;
 
+    // The cached plan of a rooted $or query may be a composite solution cached by a SubplanStage,
+    // so plan such queries again the same way, one branch at a time.
+    if (internalQueryPlanOrChildrenIndependently.load() &&
+        SubplanStage::canUseSubplanning(*_canonicalQuery)) {
+        // The SubplanStage may not cache a new composite solution. Make sure to evict the
+        // existing cache entry if requested by the caller.
+        if (shouldCache) {
+            PlanCache* cache = _collection->infoCache()->getPlanCache();
+            cache->remove(*_canonicalQuery);
+        }
+
+        auto cachingMode = shouldCache ? SubplanStage::CachingMode::Replan
+                                       : SubplanStage::CachingMode::NeverCache;
+        _children.emplace_back(new SubplanStage(
+            getOpCtx(), _collection, _ws, _plannerParams, _canonicalQuery, cachingMode));
+        SubplanStage* subplanStage = static_cast<SubplanStage*>(child().get());
+
+        Status subplanStatus = subplanStage->pickBestPlan(yieldPolicy);
+        if (!subplanStatus.isOK()) {
+            return subplanStatus;
+        }
+
+        LOG(1) << "Replanning " << redact(_canonicalQuery->toStringShort())
+               << " by planning each $or branch, plan summary after replan: "
+               << redact(Explain::getPlanSummary(child().get()))
+               << " previous cache entry evicted: " << (shouldCache ? "yes" : "no");
+        return Status::OK();
+    }
+
     // Use the query planning module to plan the whole query.
     std::vector<QuerySolution*> rawSolutions;
     Status status = QueryPlanner::plan(*_canonicalQuery, _plannerParams, &rawSolutions);
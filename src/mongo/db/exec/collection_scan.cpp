@@ -30,6 +30,8 @@
 
 #include "mongo/db/exec/collection_scan.h"
 
+#include <algorithm>
+
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
@@ -39,7 +41,10 @@
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/storage/record_fetcher.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 
@@ -51,6 +56,49 @@ using std::unique_ptr;
 using std::vector;
 using stdx::make_unique;
 
+namespace {
+
+// The most threads any one collection scan will use to evaluate its filter, and the size of the
+// pool shared by all of them.
+const size_t kMaxFilterThreads = 16;
+
+// How many records are read before the filter is evaluated over them in batched mode.
+const size_t kBatchSize = 1024;
+
+// Records are only handed to another thread in groups of at least this many, so that scheduling
+// doesn't cost more than the filtering it saves.
+const size_t kMinRecordsPerThread = 64;
+
+ThreadPool* getFilterThreadPool() {
+    // Intentionally leaked so that no scan can outlive the pool during shutdown.
+    static ThreadPool* pool = [] {
+        ThreadPool::Options options;
+        options.poolName = "CollectionScanFilter";
+        options.minThreads = 0;
+        options.maxThreads = kMaxFilterThreads;
+        auto newPool = new ThreadPool(options);
+        newPool->startup();
+        return newPool;
+    }();
+    return pool;
+}
+
+SharedOplogBuffer* getSharedOplogBuffer(OperationContext* opCtx,
+                                        const CollectionScanParams& params) {
+    if (!params.tailable || params.direction != CollectionScanParams::FORWARD ||
+        !params.collection->ns().isOplog()) {
+        return nullptr;
+    }
+    return &SharedOplogBuffer::get(opCtx->getServiceContext());
+}
+
+bool canBatch(const CollectionScanParams& params, const MatchExpression* filter) {
+    return params.maxParallelism > 1 && filter && !params.tailable && params.start.isNull() &&
+        params.maxScan == 0 && !params.stopApplyingFilterAfterFirstMatch;
+}
+
+}  // namespace
+
 // static
 const char* CollectionScan::kStageType = "COLLSCAN";
 
@@ -61,9 +109,13 @@ CollectionScan::CollectionScan(OperationContext* opCtx,
     : PlanStage(kStageType, opCtx),
       _workingSet(workingSet),
       _filter(filter),
+      _topLevelFieldMatcher(TopLevelFieldMatcher::make(filter)),
       _params(params),
       _isDead(false),
-      _wsidForFetch(_workingSet->allocate()) {
+      _wsidForFetch(_workingSet->allocate()),
+      _maxParallelism(canBatch(params, filter) ? std::min(params.maxParallelism, kMaxFilterThreads)
+                                               : 1),
+      _sharedOplogBuffer(getSharedOplogBuffer(opCtx, params)) {
     // Explain reports the direction of the collection scan.
     _specificStats.direction = params.direction;
 }
@@ -88,6 +140,24 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
         return PlanStage::IS_EOF;
     }
 
+    if (_maxParallelism > 1 && _cursor) {
+        return doWorkBatched(out);
+    }
+
+    if (_sharedOplogBuffer && !_lastSeenId.isNull()) {
+        if (auto entry = nextFromSharedOplogBuffer()) {
+            _lastSeenId = entry->id;
+
+            WorkingSetID id = _workingSet->allocate();
+            WorkingSetMember* member = _workingSet->get(id);
+            member->recordId = entry->id;
+            member->obj = {getOpCtx()->recoveryUnit()->getSnapshotId(), std::move(entry->obj)};
+            _workingSet->transitionToRecordIdAndObj(id);
+
+            return returnIfMatches(member, id, out);
+        }
+    }
+
     boost::optional<Record> record;
     const bool needToMakeCursor = !_cursor;
     try {
@@ -168,25 +238,55 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
         return PlanStage::IS_EOF;
     }
 
+    BSONObj obj = record->data.releaseToBson();
+    if (_sharedOplogBuffer) {
+        // Save the other tailers reading this entry, unless it is only valid until we yield.
+        _sharedOplogBuffer->append(_params.collection->getRecordStore(),
+                                   _lastSeenId,
+                                   record->id,
+                                   obj.isOwned() ? obj : obj.getOwned());
+    }
     _lastSeenId = record->id;
 
     WorkingSetID id = _workingSet->allocate();
     WorkingSetMember* member = _workingSet->get(id);
     member->recordId = record->id;
-    member->obj = {getOpCtx()->recoveryUnit()->getSnapshotId(), record->data.releaseToBson()};
+    member->obj = {getOpCtx()->recoveryUnit()->getSnapshotId(), std::move(obj)};
     _workingSet->transitionToRecordIdAndObj(id);
 
     return returnIfMatches(member, id, out);
 }
 
+boost::optional<SharedOplogBuffer::Entry> CollectionScan::nextFromSharedOplogBuffer() {
+    // Buffered entries were read outside of this operation's snapshot, so a reader which must not
+    // see writes that are not yet majority committed cannot use them.
+    if (getOpCtx()->recoveryUnit()->isReadingFromMajorityCommittedSnapshot()) {
+        return boost::none;
+    }
+
+    auto entry = _sharedOplogBuffer->next(_params.collection->getRecordStore(), _lastSeenId);
+    if (!entry) {
+        return boost::none;
+    }
+
+    // The cursor is now behind. Once the buffer runs out, a new one seeks to '_lastSeenId', which
+    // also checks that our position in the oplog still exists.
+    _cursor.reset();
+    return entry;
+}
+
 PlanStage::StageState CollectionScan::returnIfMatches(WorkingSetMember* member,
                                                       WorkingSetID memberID,
                                                       WorkingSetID* out) {
     ++_specificStats.docsTested;
 
-    if (Filter::passes(member, _filter)) {
+    const bool passes = _topLevelFieldMatcher
+        ? _topLevelFieldMatcher->matches(member->obj.value())
+        : Filter::passes(member, _filter);
+    if (passes) {
         if (_params.stopApplyingFilterAfterFirstMatch) {
             _filter = nullptr;
+            _topLevelFieldMatcher.reset();
         }
         *out = memberID;
         return PlanStage::ADVANCED;
@@ -196,6 +296,119 @@ PlanStage::StageState CollectionScan::returnIfMatches(WorkingSetMember* member,
     }
 }
 
+PlanStage::StageState CollectionScan::doWorkBatched(WorkingSetID* out) {
+    if (!_matched.empty()) {
+        BufferedRecord& next = _matched.front();
+        WorkingSetID id = _workingSet->allocate();
+        WorkingSetMember* member = _workingSet->get(id);
+        member->recordId = next.id;
+        member->obj = std::move(next.obj);
+        _workingSet->transitionToRecordIdAndObj(id);
+        _matched.pop_front();
+
+        *out = id;
+        return PlanStage::ADVANCED;
+    }
+
+    if (_cursorExhausted) {
+        _commonStats.isEOF = true;
+        return PlanStage::IS_EOF;
+    }
+
+    try {
+        while (_batch.size() < kBatchSize) {
+            if (auto fetcher = _cursor->fetcherForNext()) {
+                if (!_batch.empty()) {
+                    // Filter what we have before yielding for the next record.
+                    break;
+                }
+                WorkingSetMember* member = _workingSet->get(_wsidForFetch);
+                member->setFetcher(fetcher.release());
+                *out = _wsidForFetch;
+                return PlanStage::NEED_YIELD;
+            }
+
+            auto record = _cursor->next();
+            if (!record) {
+                _cursorExhausted = true;
+                break;
+            }
+
+            _lastSeenId = record->id;
+            _batch.push_back({record->id,
+                              {getOpCtx()->recoveryUnit()->getSnapshotId(),
+                               record->data.releaseToBson().getOwned()}});
+        }
+    } catch (const WriteConflictException& wce) {
+        // The records we have already read are owned, so keep them and carry on from where the
+        // cursor is after the yield.
+        *out = WorkingSet::INVALID_ID;
+        return PlanStage::NEED_YIELD;
+    }
+
+    filterBatch();
+    return PlanStage::NEED_TIME;
+}
+
+void CollectionScan::filterBatch() {
+    const size_t numRecords = _batch.size();
+    _specificStats.docsTested += numRecords;
+
+    // Not a vector<bool>, as each thread writes to its own elements.
+    std::vector<char> passes(numRecords);
+    const size_t numChunks = std::max<size_t>(
+        1, std::min(_maxParallelism, numRecords / kMinRecordsPerThread));
+
+    stdx::mutex mutex;
+    stdx::condition_variable chunksDone;
+    size_t chunksPending = numChunks;
+    Status filterStatus = Status::OK();
+
+    auto filterChunk = [&](size_t chunk) {
+        Status status = Status::OK();
+        try {
+            const size_t end = numRecords * (chunk + 1) / numChunks;
+            for (size_t i = numRecords * chunk / numChunks; i < end; ++i) {
+                const BSONObj& obj = _batch[i].obj.value();
+                passes[i] = _topLevelFieldMatcher ? _topLevelFieldMatcher->matches(obj)
+                                                  : _filter->matchesBSON(obj);
+            }
+        } catch (const DBException& ex) {
+            status = ex.toStatus();
+        }
+
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        if (!status.isOK() && filterStatus.isOK()) {
+            filterStatus = status;
+        }
+        if (--chunksPending == 0) {
+            chunksDone.notify_one();
+        }
+    };
+
+    // This thread filters the first chunk itself, and any chunk the pool won't take.
+    for (size_t chunk = 1; chunk < numChunks; ++chunk) {
+        auto task = [&filterChunk, chunk] { filterChunk(chunk); };
+        if (!getFilterThreadPool()->schedule(task).isOK()) {
+            filterChunk(chunk);
+        }
+    }
+    filterChunk(0);
+
+    {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        chunksDone.wait(lk, [&] { return chunksPending == 0; });
+    }
+    uassertStatusOK(filterStatus);
+
+    for (size_t i = 0; i < numRecords; ++i) {
+        if (passes[i]) {
+            _matched.push_back(std::move(_batch[i]));
+        }
+    }
+    _batch.clear();
+}
+
 bool CollectionScan::isEOF() {
     return _commonStats.isEOF || _isDead;
 }
@@ -216,6 +429,11 @@ void CollectionScan::doInvalidate(OperationContext* opCtx,
         _cursor->invalidate(opCtx, id);
     }
 
+    // Buffered copies of the record must not be returned once it has been deleted.
+    auto isDeleted = [&id](const BufferedRecord& record) { return record.id == id; };
+    _batch.erase(std::remove_if(_batch.begin(), _batch.end(), isDeleted), _batch.end());
+    _matched.erase(std::remove_if(_matched.begin(), _matched.end(), isDeleted), _matched.end());
+
     if (_params.tailable && id == _lastSeenId) {
         // This means that deletes have caught up to the reader. We want to error in this case
         // so readers don't miss potentially important data.
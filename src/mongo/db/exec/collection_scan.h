@@ -28,12 +28,17 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
+#include <vector>
 
 #include "mongo/db/exec/collection_scan_common.h"
 #include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/exec/shared_oplog_buffer.h"
+#include "mongo/db/exec/top_level_field_matcher.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/record_id.h"
+#include "mongo/db/storage/snapshot.h"
 
 namespace mongo {
 
@@ -80,12 +85,42 @@ private:
      */
     StageState returnIfMatches(WorkingSetMember* member, WorkingSetID memberID, WorkingSetID* out);
 
+    /**
+     * Does the work of doWork() once the cursor exists if the filter is evaluated in parallel.
+     * Returns the next buffered record that passed the filter if there is one, and otherwise reads
+     * and filters the next batch of records.
+     */
+    StageState doWorkBatched(WorkingSetID* out);
+
+    /**
+     * Returns the entry following '_lastSeenId' if another tailing scan of the oplog has already
+     * read it into the shared oplog buffer.
+     */
+    boost::optional<SharedOplogBuffer::Entry> nextFromSharedOplogBuffer();
+
+    /**
+     * Evaluates the filter over '_batch', spreading the work over up to '_maxParallelism' threads,
+     * and moves the records that pass onto the end of '_matched'.
+     */
+    void filterBatch();
+
+    // A record read from the cursor in batched mode, copied so that it outlives the cursor's
+    // position.
+    struct BufferedRecord {
+        RecordId id;
+        Snapshotted<BSONObj> obj;
+    };
+
     // WorkingSet is not owned by us.
     WorkingSet* _workingSet;
 
     // The filter is not owned by us.
     const MatchExpression* _filter;
 
+    // Evaluates '_filter' against documents without walking each predicate's path, if '_filter' is
+    // simple enough. Null otherwise.
+    std::unique_ptr<TopLevelFieldMatcher> _topLevelFieldMatcher;
+
     std::unique_ptr<SeekableRecordCursor> _cursor;
 
     CollectionScanParams _params;
@@ -99,6 +134,24 @@ private:
     // should remain in the INVALID state.
     const WorkingSetID _wsidForFetch;
 
+    // How many threads may evaluate the filter. If 1, records are filtered one at a time as they
+    // are read, and the members below are unused.
+    const size_t _maxParallelism;
+
+    // Records read from the cursor but not yet filtered. Only non-empty across calls to work() if
+    // we had to yield part way through reading a batch.
+    std::vector<BufferedRecord> _batch;
+
+    // Records that passed the filter and have yet to be returned.
+    std::deque<BufferedRecord> _matched;
+
+    // Set once the cursor has returned every record in batched mode; we hit EOF once '_matched'
+    // has been drained.
+    bool _cursorExhausted = false;
+
+    // The entries that tailing scans of the oplog share with each other. Null for other scans.
+    SharedOplogBuffer* const _sharedOplogBuffer;
+
     // Stats
     CollectionScanStats _specificStats;
 };
@@ -59,6 +59,12 @@ struct CollectionScanParams {
 
     // If non-zero, how many documents will we look at?
     size_t maxScan = 0;
+
+    // If greater than one, records are read from the collection in batches and the filter is
+    // evaluated over each batch on up to this many threads. Only honored for non-tailable scans
+    // that start at the beginning of the collection and look at every record. The filter must be
+    // safe to evaluate concurrently, so it must not contain $where.
+    size_t maxParallelism = 1;
 };
 
 }  // namespace mongo
@@ -29,6 +29,7 @@
 #include "mongo/db/exec/count_scan.h"
 
 #include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/exec/filter.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/stdx/memory.h"
@@ -68,11 +69,17 @@ using stdx::make_unique;
 // static
 const char* CountScan::kStageType = "COUNT_SCAN";
 
-CountScan::CountScan(OperationContext* opCtx, const CountScanParams& params, WorkingSet* workingSet)
+CountScan::CountScan(OperationContext* opCtx,
+                     const CountScanParams& params,
+                     WorkingSet* workingSet,
+                     const MatchExpression* filter)
     : PlanStage(kStageType, opCtx),
       _workingSet(workingSet),
       _descriptor(params.descriptor),
       _iam(params.descriptor->getIndexCatalog()->getIndex(params.descriptor)),
+      _keyPattern(params.descriptor->keyPattern().getOwned()),
+      _filter(filter),
+      _needSeek(false),
       _shouldDedup(params.descriptor->isMultikey(opCtx)),
       _params(params) {
     _specificStats.keyPattern = _params.descriptor->keyPattern();
@@ -88,12 +95,33 @@ CountScan::CountScan(OperationContext* opCtx, const CountScanParams& params, Wor
     _specificStats.isPartial = _params.descriptor->isPartial();
     _specificStats.indexVersion = static_cast<int>(_params.descriptor->version());
 
+    if (!_params.bounds.fields.empty()) {
+        _specificStats.indexBounds = _params.bounds.toBSON();
+        return;
+    }
+
     // endKey must be after startKey in index order since we only do forward scans.
     dassert(_params.startKey.woCompare(_params.endKey,
                                        Ordering::make(params.descriptor->keyPattern()),
                                        /*compareFieldNames*/ false) <= 0);
 }
 
+boost::optional<IndexKeyEntry> CountScan::initCursor(
+    SortedDataInterface::Cursor::RequestedInfo parts) {
+    _cursor = _iam->newCursor(getOpCtx());
+
+    if (_params.bounds.fields.empty()) {
+        _cursor->setEndPosition(_params.endKey, _params.endKeyInclusive);
+        return _cursor->seek(_params.startKey, _params.startKeyInclusive, parts);
+    }
+
+    _checker.reset(new IndexBoundsChecker(&_params.bounds, _keyPattern, /*direction*/ 1));
+    if (!_checker->getStartSeekPoint(&_seekPoint)) {
+        return boost::none;
+    }
+    return _cursor->seek(_seekPoint, parts);
+}
+
 
 PlanStage::StageState CountScan::doWork(WorkingSetID* out) {
     if (_commonStats.isEOF)
@@ -102,17 +130,19 @@ PlanStage::StageState CountScan::doWork(WorkingSetID* out) {
     boost::optional<IndexKeyEntry> entry;
     const bool needInit = !_cursor;
     try {
-        // We don't care about the keys.
-        const auto kWantLoc = SortedDataInterface::Cursor::kWantLoc;
+        // We only care about the keys when checking them against the bounds or the filter.
+        const auto parts = (!_params.bounds.fields.empty() || _filter)
+            ? SortedDataInterface::Cursor::kKeyAndLoc
+            : SortedDataInterface::Cursor::kWantLoc;
 
         if (needInit) {
             // First call to work().  Perform cursor init.
-            _cursor = _iam->newCursor(getOpCtx());
-            _cursor->setEndPosition(_params.endKey, _params.endKeyInclusive);
-
-            entry = _cursor->seek(_params.startKey, _params.startKeyInclusive, kWantLoc);
+            entry = initCursor(parts);
+        } else if (_needSeek) {
+            entry = _cursor->seek(_seekPoint, parts);
+            _needSeek = false;
         } else {
-            entry = _cursor->next(kWantLoc);
+            entry = _cursor->next(parts);
         }
     } catch (const WriteConflictException& wce) {
         if (needInit) {
@@ -125,6 +155,21 @@ PlanStage::StageState CountScan::doWork(WorkingSetID* out) {
 
     ++_specificStats.keysExamined;
 
+    if (entry && _checker) {
+        switch (_checker->checkKey(entry->key, &_seekPoint)) {
+            case IndexBoundsChecker::VALID:
+                break;
+
+            case IndexBoundsChecker::DONE:
+                entry = boost::none;
+                break;
+
+            case IndexBoundsChecker::MUST_ADVANCE:
+                _needSeek = true;
+                return PlanStage::NEED_TIME;
+        }
+    }
+
     if (!entry) {
         _commonStats.isEOF = true;
         _cursor.reset();
@@ -136,6 +181,10 @@ PlanStage::StageState CountScan::doWork(WorkingSetID* out) {
         return PlanStage::NEED_TIME;
     }
 
+    if (_filter && !Filter::passes(entry->key, _keyPattern, _filter)) {
+        return PlanStage::NEED_TIME;
+    }
+
     WorkingSetID id = _workingSet->allocate();
     _workingSet->transitionToRecordIdAndObj(id);
     *out = id;
@@ -186,15 +235,24 @@ void CountScan::doInvalidate(OperationContext* opCtx, const RecordId& dl, Invali
 }
 
 unique_ptr<PlanStageStats> CountScan::getStats() {
+    // Add a BSON representation of the filter to the stats tree, if there is one.
+    if (_filter) {
+        BSONObjBuilder bob;
+        _filter->serialize(&bob);
+        _commonStats.filter = bob.obj();
+    }
+
     unique_ptr<PlanStageStats> ret = make_unique<PlanStageStats>(_commonStats, STAGE_COUNT_SCAN);
 
     unique_ptr<CountScanStats> countStats = make_unique<CountScanStats>(_specificStats);
     countStats->keyPattern = _specificStats.keyPattern.getOwned();
 
-    countStats->startKey = replaceBSONFieldNames(_params.startKey, countStats->keyPattern);
-    countStats->startKeyInclusive = _params.startKeyInclusive;
-    countStats->endKey = replaceBSONFieldNames(_params.endKey, countStats->keyPattern);
-    countStats->endKeyInclusive = _params.endKeyInclusive;
+    if (_params.bounds.fields.empty()) {
+        countStats->startKey = replaceBSONFieldNames(_params.startKey, countStats->keyPattern);
+        countStats->startKeyInclusive = _params.startKeyInclusive;
+        countStats->endKey = replaceBSONFieldNames(_params.endKey, countStats->keyPattern);
+        countStats->endKeyInclusive = _params.endKeyInclusive;
+    }
 
     ret->specific = std::move(countStats);
 
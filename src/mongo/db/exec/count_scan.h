@@ -34,6 +34,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/query/index_bounds.h"
 #include "mongo/db/record_id.h"
 #include "mongo/platform/unordered_set.h"
 
@@ -54,20 +55,30 @@ struct CountScanParams {
 
     BSONObj endKey;
     bool endKeyInclusive;
+
+    // If it has any fields, the scan walks these bounds instead, seeking from one interval to the
+    // next, and the keys above are unused.
+    IndexBounds bounds;
 };
 
 /**
- * Used by the count command. Scans an index from a start key to an end key. Creates a
- * WorkingSetMember for each matching index key in RID_AND_OBJ state. It has a null record id and an
- * empty object with a null snapshot id rather than real data. Returning real data is unnecessary
- * since all we need is the count.
+ * Used by the count command. Scans an index from a start key to an end key, or over a set of
+ * index bounds. Creates a WorkingSetMember for each matching index key in RID_AND_OBJ state. It
+ * has a null record id and an empty object with a null snapshot id rather than real data.
+ * Returning real data is unnecessary since all we need is the count.
+ *
+ * If 'filter' is non-null, only the index keys which pass it are counted. It must only depend on
+ * the fields of the index key.
  *
  * Only created through the getExecutorCount() path, as count is the only operation that doesn't
  * care about its data.
  */
 class CountScan final : public PlanStage {
 public:
-    CountScan(OperationContext* opCtx, const CountScanParams& params, WorkingSet* workingSet);
+    CountScan(OperationContext* opCtx,
+              const CountScanParams& params,
+              WorkingSet* workingSet,
+              const MatchExpression* filter = nullptr);
 
     StageState doWork(WorkingSetID* out) final;
     bool isEOF() final;
@@ -88,6 +99,11 @@ public:
     static const char* kStageType;
 
 private:
+    /**
+     * Positions '_cursor' on the first key of the scan.
+     */
+    boost::optional<IndexKeyEntry> initCursor(SortedDataInterface::Cursor::RequestedInfo parts);
+
     // The WorkingSet we annotate with results.  Not owned by us.
     WorkingSet* _workingSet;
 
@@ -95,8 +111,20 @@ private:
     const IndexDescriptor* _descriptor;
     const IndexAccessMethod* _iam;
 
+    // Keeps track of what this count scan is counting.
+    const BSONObj _keyPattern;
+
+    // Contains expressions only over fields in the index key. Not owned by us.
+    const MatchExpression* const _filter;
+
     std::unique_ptr<SortedDataInterface::Cursor> _cursor;
 
+    // Scans over bounds with several intervals check each key against them and are told where to
+    // seek to next rather than moving to the next key. Null for scans over a single interval.
+    std::unique_ptr<IndexBoundsChecker> _checker;
+    IndexSeekPoint _seekPoint;
+    bool _needSeek;
+
     // Could our index have duplicates?  If so, we use _returned to dedup.
     bool _shouldDedup;
     unordered_set<RecordId, RecordId::Hasher> _returned;
@@ -40,6 +40,7 @@
 #include "mongo/db/exec/write_stage_common.h"
 #include "mongo/db/op_observer.h"
 #include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/service_context.h"
 #include "mongo/stdx/memory.h"
@@ -81,7 +82,8 @@ DeleteStage::DeleteStage(OperationContext* opCtx,
       _ws(ws),
       _collection(collection),
       _idRetrying(WorkingSet::INVALID_ID),
-      _idReturning(WorkingSet::INVALID_ID) {
+      _idReturning(WorkingSet::INVALID_ID),
+      _batchSize(std::max(1, internalQueryExecDeleteBatchSize.load())) {
     _children.emplace_back(child);
 }
 
@@ -93,7 +95,7 @@ bool DeleteStage::isEOF() {
         return true;
     }
     return _idRetrying == WorkingSet::INVALID_ID && _idReturning == WorkingSet::INVALID_ID &&
-        child()->isEOF();
+        _batch.empty() && child()->isEOF();
 }
 
 PlanStage::StageState DeleteStage::doWork(WorkingSetID* out) {
@@ -102,6 +104,12 @@ PlanStage::StageState DeleteStage::doWork(WorkingSetID* out) {
     }
     invariant(_collection);  // If isEOF() returns false, we must have a collection.
 
+    // Delete the pending batch once the child has nothing left to add to it. This also retries a
+    // batch which hit a write conflict, as a batch is only deleted when full or at the end.
+    if (!_batch.empty() && (_batch.size() >= _batchSize || child()->isEOF())) {
+        return deleteBatch(out);
+    }
+
     // It is possible that after a delete was executed, a WriteConflictException occurred
     // and prevented us from returning ADVANCED with the old version of the document.
     if (_idReturning != WorkingSet::INVALID_ID) {
@@ -149,7 +157,7 @@ PlanStage::StageState DeleteStage::doWork(WorkingSetID* out) {
                 return status;
 
             case PlanStage::IS_EOF:
-                return status;
+                return _batch.empty() ? status : deleteBatch(out);
 
             default:
                 MONGO_UNREACHABLE;
@@ -172,6 +180,16 @@ PlanStage::StageState DeleteStage::doWork(WorkingSetID* out) {
     // a fetch. We should always get fetched data, and never just key data.
     invariant(member->hasObj());
 
+    if (isBatching()) {
+        // Whether the document still matches is checked when the batch is deleted, against the
+        // snapshot the batch is deleted in. Own the document, as moving the child along is allowed
+        // to free the memory underlying it.
+        member->makeObjOwnedIfNeeded();
+        memberFreer.Dismiss();
+        _batch.push_back(id);
+        return _batch.size() >= _batchSize ? deleteBatch(out) : PlanStage::NEED_TIME;
+    }
+
     // Ensure the document still exists and matches the predicate.
     bool docStillMatches;
     try {
@@ -201,9 +219,6 @@ PlanStage::StageState DeleteStage::doWork(WorkingSetID* out) {
         member->obj.setValue(deletedDoc.getOwned());
     }
 
-    // TODO: Do we want to buffer docs and delete them in a group rather than saving/restoring state
-    // repeatedly?
-
     WorkingSetCommon::prepareForSnapshotChange(_ws);
     try {
         child()->saveState();
@@ -263,6 +278,19 @@ PlanStage::StageState DeleteStage::doWork(WorkingSetID* out) {
     return PlanStage::NEED_TIME;
 }
 
+void DeleteStage::doInvalidate(OperationContext* opCtx,
+                               const RecordId& dl,
+                               InvalidationType type) {
+    // A document in the pending batch may be deleted or moved before the batch is. Fetch it now and
+    // drop its RecordId, so that deleteBatch() skips it, as for the members the child invalidates.
+    for (auto id : _batch) {
+        WorkingSetMember* member = _ws->get(id);
+        if (member->hasRecordId() && member->recordId == dl) {
+            WorkingSetCommon::fetchAndInvalidateRecordId(opCtx, member, _collection);
+        }
+    }
+}
+
 void DeleteStage::doRestoreState() {
     invariant(_collection);
     const NamespaceString& ns(_collection->ns());
@@ -300,4 +328,66 @@ PlanStage::StageState DeleteStage::prepareToRetryWSM(WorkingSetID idToRetry, Wor
     return NEED_YIELD;
 }
 
+bool DeleteStage::isBatching() const {
+    return _params.isMulti && !_params.returnDeleted && !_params.isExplain && _batchSize > 1;
+}
+
+PlanStage::StageState DeleteStage::deleteBatch(WorkingSetID* out) {
+    invariant(!_batch.empty());
+
+    WorkingSetCommon::prepareForSnapshotChange(_ws);
+    try {
+        child()->saveState();
+    } catch (const WriteConflictException& wce) {
+        std::terminate();
+    }
+
+    size_t docsDeleted = 0;
+    size_t invalidateSkips = 0;
+    try {
+        WriteUnitOfWork wunit(getOpCtx());
+        for (auto id : _batch) {
+            WorkingSetMember* member = _ws->get(id);
+            if (!member->hasRecordId()) {
+                // The document was invalidated while it was waiting in the batch.
+                ++invalidateSkips;
+                continue;
+            }
+
+            if (!write_stage_common::ensureStillMatches(
+                    _collection, getOpCtx(), _ws, id, _params.canonicalQuery)) {
+                continue;
+            }
+
+            // Deleting the document may invalidate the member, so don't pass its RecordId.
+            const RecordId recordId = member->recordId;
+            _collection->deleteDocument(getOpCtx(), recordId, _params.opDebug, _params.fromMigrate);
+            ++docsDeleted;
+        }
+        wunit.commit();
+    } catch (const WriteConflictException& wce) {
+        // Keep the batch around so we can retry deleting it.
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
+
+    _specificStats.docsDeleted += docsDeleted;
+    _specificStats.nInvalidateSkips += invalidateSkips;
+    for (auto id : _batch) {
+        _ws->free(id);
+    }
+    _batch.clear();
+
+    // As for a single delete, restore the child outside of the WriteUnitOfWork.
+    try {
+        child()->restoreState();
+    } catch (const WriteConflictException& wce) {
+        // The batch was already committed, so there is nothing to retry.
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
+
+    return PlanStage::NEED_TIME;
+}
+
 }  // namespace mongo
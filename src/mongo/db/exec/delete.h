@@ -77,6 +77,10 @@ struct DeleteStageParams {
  * document was requested to be returned, then ADVANCED is returned after deleting a document.
  * Otherwise, NEED_TIME is returned after deleting a document.
  *
+ * A multi-delete which does not return the deleted documents buffers the RecordIds from its child
+ * and deletes up to internalQueryExecDeleteBatchSize of them in a single WriteUnitOfWork, rather
+ * than saving and restoring its child around a WriteUnitOfWork for every document.
+ *
  * Callers of work() must be holding a write lock (and, for replicated deletes, callers must have
  * had the replication coordinator approve the write).
  */
@@ -94,6 +98,7 @@ public:
     StageState doWork(WorkingSetID* out) final;
 
     void doRestoreState() final;
+    void doInvalidate(OperationContext* opCtx, const RecordId& dl, InvalidationType type) final;
 
     StageType stageType() const final {
         return STAGE_DELETE;
@@ -119,6 +124,18 @@ private:
      */
     StageState prepareToRetryWSM(WorkingSetID idToRetry, WorkingSetID* out);
 
+    /**
+     * Returns true if the documents from the child are deleted in batches.
+     */
+    bool isBatching() const;
+
+    /**
+     * Deletes the documents of '_batch' which still match in a single WriteUnitOfWork. Returns
+     * NEED_YIELD, keeping '_batch' to be retried, if the WriteUnitOfWork hits a write conflict,
+     * and NEED_TIME otherwise.
+     */
+    StageState deleteBatch(WorkingSetID* out);
+
     DeleteStageParams _params;
 
     // Not owned by us.
@@ -135,6 +152,12 @@ private:
     // If not WorkingSet::INVALID_ID, we return this member to our caller.
     WorkingSetID _idReturning;
 
+    // The most documents deleted in a single WriteUnitOfWork when batching.
+    const size_t _batchSize;
+
+    // The members from the child waiting to be deleted together, when batching.
+    std::vector<WorkingSetID> _batch;
+
     // Stats
     DeleteStats _specificStats;
 };
@@ -63,7 +63,7 @@ public:
         // over it.
         for (size_t i = 0; i < _wsm->keyData.size(); ++i) {
             BSONObjIterator keyPatternIt(_wsm->keyData[i].indexKeyPattern);
-            BSONObjIterator keyDataIt(_wsm->keyData[i].keyData);
+            BSONObjIterator keyDataIt(_wsm->keyData[i].keyData());
 
             while (keyPatternIt.more()) {
                 BSONElement keyPatternElt = keyPatternIt.next();
@@ -31,10 +31,12 @@
 
 #include "mongo/db/exec/geo_near.h"
 
+#include <cmath>
 #include <memory>
 #include <vector>
 
 // For s2 search
+#include "third_party/s2/s2cell.h"
 #include "third_party/s2/s2regionintersection.h"
 
 #include "mongo/base/owned_pointer_vector.h"
@@ -266,6 +268,32 @@ static R2Annulus twoDDistanceBounds(const GeoNearParams& nearParams,
     return fullBounds;
 }
 
+// The number of results we aim to return from each search interval.
+static const double kTargetResultsPerInterval = 450;
+
+/**
+ * Returns the width of the next search interval, sized so that it holds about
+ * kTargetResultsPerInterval results if the results are as dense as in 'lastInterval', which was
+ * searched with 'boundsIncrement'.
+ */
+static double nextBoundsIncrement(const IntervalStats& lastInterval, double boundsIncrement) {
+    const double inner = max(0.0, lastInterval.minDistanceAllowed);
+    const double outer = lastInterval.maxDistanceAllowed;
+    const double numResults = lastInterval.numResultsReturned;
+    const double area = M_PI * (outer * outer - inner * inner);
+
+    if (numResults == 0 || !(area > 0)) {
+        // Nothing tells us how far away the results are, so widen quickly through empty space.
+        return boundsIncrement * 4;
+    }
+
+    // The area of our next annulus is about PI * ((outer + increment)^2 - outer^2). Results are
+    // rarely spread evenly, so limit how fast the width changes in either direction.
+    const double nextArea = kTargetResultsPerInterval * area / numResults;
+    const double increment = std::sqrt(outer * outer + nextArea / M_PI) - outer;
+    return std::min(boundsIncrement * 16, std::max(boundsIncrement / 16, increment));
+}
+
 class GeoNear2DStage::DensityEstimator {
 public:
     DensityEstimator(PlanStage::Children* children,
@@ -607,13 +635,8 @@ StatusWith<NearStage::CoveredInterval*>  //
     //
 
     if (!_specificStats.intervalStats.empty()) {
-        const IntervalStats& lastIntervalStats = _specificStats.intervalStats.back();
-
-        // TODO: Generally we want small numbers of results fast, then larger numbers later
-        if (lastIntervalStats.numResultsReturned < 300)
-            _boundsIncrement *= 2;
-        else if (lastIntervalStats.numResultsReturned > 600)
-            _boundsIncrement /= 2;
+        _boundsIncrement =
+            nextBoundsIncrement(_specificStats.intervalStats.back(), _boundsIncrement);
     }
 
     _boundsIncrement =
@@ -775,6 +798,71 @@ static int getFieldPosition(const IndexDescriptor* index, const string& fieldNam
     return fieldPosition;
 }
 
+namespace {
+
+/**
+ * Matches the 2dsphere index keys whose cell may hold a point at a distance within an annulus, so
+ * that documents which certainly lie outside it are never fetched. Only the numeric keys of
+ * version 3 indexes are checked; any other key matches.
+ */
+class TwoDSphereKeyInAnnulusExpression : public LeafMatchExpression {
+public:
+    TwoDSphereKeyInAnnulusExpression(const R2Annulus& annulus, StringData twoDSpherePath)
+        : LeafMatchExpression(INTERNAL_2DSPHERE_KEY_IN_REGION),
+          _center(S2LatLng::FromDegrees(annulus.center().y, annulus.center().x).ToPoint()),
+          _inner(annulus.getInner() / kRadiusOfEarthInMeters - kDistanceSlackRadians),
+          _outer(annulus.getOuter() / kRadiusOfEarthInMeters + kDistanceSlackRadians) {
+        setPath(twoDSpherePath);
+    }
+
+    void serialize(BSONObjBuilder* out) const final {
+        out->append("TwoDSphereKeyInAnnulusExpression", true);
+    }
+
+    bool matchesSingleElement(const BSONElement& e) const final {
+        if (e.type() != NumberLong)
+            return true;
+
+        const S2CellId cellId(static_cast<uint64>(e.numberLong()));
+        if (!cellId.is_valid())
+            return true;
+
+        // Every point of the cell lies within its cap bound, so its distance from our center is
+        // within the cap's angle of the distance to the cap's axis.
+        const S2Cap cap = S2Cell(cellId).GetCapBound();
+        const double distance = S1Angle(_center, cap.axis()).radians();
+        const double capAngle = cap.angle().radians();
+        return distance - capAngle <= _outer && distance + capAngle >= _inner;
+    }
+
+    //
+    // These won't be called.
+    //
+
+    void debugString(StringBuilder& debug, int level = 0) const final {
+        invariant(false);
+    }
+
+    bool equivalent(const MatchExpression* other) const final {
+        invariant(false);
+        return false;
+    }
+
+    unique_ptr<MatchExpression> shallowClone() const final {
+        invariant(false);
+        return NULL;
+    }
+
+private:
+    // Well above the floating point error of the distances computed for fetched documents.
+    static constexpr double kDistanceSlackRadians = 1e-9;
+
+    const S2Point _center;
+    const double _inner;
+    const double _outer;
+};
+}  // namespace
+
 static const string kS2IndexNearStage("GEO_NEAR_2DSPHERE");
 
 GeoNear2DSphereStage::GeoNear2DSphereStage(const GeoNearParams& nearParams,
@@ -798,6 +886,13 @@ GeoNear2DSphereStage::GeoNear2DSphereStage(const GeoNearParams& nearParams,
     // strings, and _nearParams.filter should have the collator.
     const CollatorInterface* collator = nullptr;
     ExpressionParams::initialize2dsphereParams(s2Index->infoObj(), collator, &_indexParams);
+
+    // Prune index keys outside the whole search annulus before fetching their documents.
+    if (_indexParams.indexVersion >= S2_INDEX_VERSION_3 &&
+        (_fullBounds.getInner() > 0 || _fullBounds.getOuter() < kMaxEarthDistanceInMeters)) {
+        _keyFilter = stdx::make_unique<TwoDSphereKeyInAnnulusExpression>(
+            _fullBounds, _nearParams.nearQuery->field);
+    }
 }
 
 GeoNear2DSphereStage::~GeoNear2DSphereStage() {}
@@ -1040,13 +1135,8 @@ StatusWith<NearStage::CoveredInterval*>  //
     //
 
     if (!_specificStats.intervalStats.empty()) {
-        const IntervalStats& lastIntervalStats = _specificStats.intervalStats.back();
-
-        // TODO: Generally we want small numbers of results fast, then larger numbers later
-        if (lastIntervalStats.numResultsReturned < 300)
-            _boundsIncrement *= 2;
-        else if (lastIntervalStats.numResultsReturned > 600)
-            _boundsIncrement /= 2;
+        _boundsIncrement =
+            nextBoundsIncrement(_specificStats.intervalStats.back(), _boundsIncrement);
     }
 
     invariant(_boundsIncrement > 0.0);
@@ -1097,7 +1187,7 @@ StatusWith<NearStage::CoveredInterval*>  //
     OrderedIntervalList* coveredIntervals = &scanParams.bounds.fields[s2FieldPosition];
     ExpressionMapping::S2CellIdsToIntervalsWithParents(cover, _indexParams, coveredIntervals);
 
-    IndexScan* scan = new IndexScan(opCtx, scanParams, workingSet, nullptr);
+    IndexScan* scan = new IndexScan(opCtx, scanParams, workingSet, _keyFilter.get());
 
     // FetchStage owns index scan
     _children.emplace_back(new FetchStage(opCtx, workingSet, scan, _nearParams.filter, collection));
@@ -152,6 +152,9 @@ private:
     // Keeps track of the region that has already been scanned
     S2CellUnion _scannedCells;
 
+    // Filters out the index keys of documents outside _fullBounds, if there are any
+    std::unique_ptr<MatchExpression> _keyFilter;
+
     class DensityEstimator;
     std::unique_ptr<DensityEstimator> _densityEstimator;
 };
@@ -37,6 +37,7 @@
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/exec/working_set_computed_data.h"
 #include "mongo/db/index/btree_access_method.h"
+#include "mongo/db/storage/clustered_key.h"
 #include "mongo/db/storage/record_fetcher.h"
 #include "mongo/stdx/memory.h"
 
@@ -118,16 +119,29 @@ PlanStage::StageState IDHackStage::doWork(WorkingSetID* out) {
 
     WorkingSetID id = WorkingSet::INVALID_ID;
     try {
-        // Look up the key by going directly to the index.
-        RecordId recordId = _accessMethod->findSingle(getOpCtx(), _key);
-
-        // Key not found.
-        if (recordId.isNull()) {
-            _done = true;
-            return PlanStage::IS_EOF;
+        RecordId recordId;
+        if (_collection->getRecordStore()->isClustered()) {
+            // The RecordId is derived from the _id, so the record can be fetched without looking
+            // in the index. An _id which does not map to a RecordId cannot be in the collection.
+            auto swRecordId = clusteredkey::keyForId(_key.firstElement());
+            if (!swRecordId.isOK()) {
+                _done = true;
+                return PlanStage::IS_EOF;
+            }
+            recordId = swRecordId.getValue();
+        } else {
+            // Look up the key by going directly to the index.
+            recordId = _accessMethod->findSingle(getOpCtx(), _key);
+
+            // Key not found.
+            if (recordId.isNull()) {
+                _done = true;
+                return PlanStage::IS_EOF;
+            }
+
+            ++_specificStats.keysExamined;
         }
 
-        ++_specificStats.keysExamined;
         ++_specificStats.docsExamined;
 
         // Create a new WSM for the result document.
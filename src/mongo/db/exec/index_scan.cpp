@@ -103,12 +103,20 @@ boost::optional<IndexKeyEntry> IndexScan::initIndexScan() {
     // We always seek once to establish the cursor position.
     ++_specificStats.seeks;
 
+    // Scans which check their bounds against the position of an end cursor do so on the index's
+    // own encoding of the keys. If nothing else in this stage needs to look at a key either, it is
+    // left encoded until a later stage asks for it.
+    _deferKeyDecoding =
+        _indexCursor->supportsDeferredKeys() && !_filter && !_params.addKeyMetadata;
+    const auto parts = _deferKeyDecoding ? SortedDataInterface::Cursor::kWantLoc
+                                         : SortedDataInterface::Cursor::kKeyAndLoc;
+
     if (_params.bounds.isSimpleRange) {
         // Start at one key, end at another.
         _startKey = _params.bounds.startKey;
         _endKey = _params.bounds.endKey;
         _indexCursor->setEndPosition(_endKey, _endKeyInclusive);
-        return _indexCursor->seek(_startKey, _startKeyInclusive);
+        return _indexCursor->seek(_startKey, _startKeyInclusive, parts);
     } else {
         // For single intervals, we can use an optimized scan which checks against the position
         // of an end cursor.  For all other index scans, we fall back on using
@@ -116,8 +124,11 @@ boost::optional<IndexKeyEntry> IndexScan::initIndexScan() {
         if (IndexBoundsBuilder::isSingleInterval(
                 _params.bounds, &_startKey, &_startKeyInclusive, &_endKey, &_endKeyInclusive)) {
             _indexCursor->setEndPosition(_endKey, _endKeyInclusive);
-            return _indexCursor->seek(_startKey, _startKeyInclusive);
+            return _indexCursor->seek(_startKey, _startKeyInclusive, parts);
         } else {
+            // IndexBoundsChecker works on BSON keys.
+            _deferKeyDecoding = false;
+
             _checker.reset(new IndexBoundsChecker(&_params.bounds, _keyPattern, _params.direction));
 
             if (!_checker->getStartSeekPoint(&_seekPoint))
@@ -137,7 +148,9 @@ PlanStage::StageState IndexScan::doWork(WorkingSetID* out) {
                 kv = initIndexScan();
                 break;
             case GETTING_NEXT:
-                kv = _indexCursor->next();
+                kv = _indexCursor->next(_deferKeyDecoding
+                                            ? SortedDataInterface::Cursor::kWantLoc
+                                            : SortedDataInterface::Cursor::kKeyAndLoc);
                 break;
             case NEED_SEEK:
                 ++_specificStats.seeks;
@@ -151,6 +164,15 @@ PlanStage::StageState IndexScan::doWork(WorkingSetID* out) {
         return PlanStage::NEED_YIELD;
     }
 
+    // Must be taken before the cursor moves again.
+    stdx::function<BSONObj()> decodeKey;
+    if (kv && _deferKeyDecoding) {
+        decodeKey = _indexCursor->deferredKey();
+        if (kDebugBuild) {
+            kv->key = decodeKey();
+        }
+    }
+
     if (kv) {
         // In debug mode, check that the cursor isn't lying to us.
         if (kDebugBuild && !_startKey.isEmpty()) {
@@ -216,14 +238,17 @@ PlanStage::StageState IndexScan::doWork(WorkingSetID* out) {
         }
     }
 
-    if (!kv->key.isOwned())
-        kv->key = kv->key.getOwned();
-
     // We found something to return, so fill out the WSM.
     WorkingSetID id = _workingSet->allocate();
     WorkingSetMember* member = _workingSet->get(id);
     member->recordId = kv->loc;
-    member->keyData.push_back(IndexKeyDatum(_keyPattern, kv->key, _iam));
+    if (decodeKey) {
+        member->keyData.push_back(IndexKeyDatum(_keyPattern, std::move(decodeKey), _iam));
+    } else {
+        if (!kv->key.isOwned())
+            kv->key = kv->key.getOwned();
+        member->keyData.push_back(IndexKeyDatum(_keyPattern, kv->key, _iam));
+    }
     _workingSet->transitionToRecordIdAndIdx(id);
 
     if (_params.addKeyMetadata) {
@@ -174,6 +174,10 @@ private:
     bool _startKeyInclusive;
     // Is the end key included in the range?
     bool _endKeyInclusive;
+
+    // If true, keys are requested from the cursor in its own encoding and only converted to BSON
+    // when a later stage reads them from the WSM. Only possible in case 2) above.
+    bool _deferKeyDecoding = false;
 };
 
 }  // namespace mongo
@@ -45,6 +45,7 @@
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/plan_ranker.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/storage/record_fetcher.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
@@ -58,6 +59,14 @@ using std::unique_ptr;
 using std::vector;
 using stdx::make_unique;
 
+namespace {
+
+// The leading candidate must have returned at least this many results before any other
+// candidate can be considered dominated.
+const size_t kMinResultsForDominance = 10;
+
+}  // namespace
+
 // static
 const char* MultiPlanStage::kStageType = "MULTI_PLAN";
 
@@ -201,10 +210,10 @@ size_t MultiPlanStage::getTrialPeriodNumToReturn(const CanonicalQuery& query) {
 }
 
 Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
-    // Adds the amount of time taken by pickBestPlan() to executionTimeMillis. There's lots of
+    // Adds the amount of time taken by pickBestPlan() to executionTimeNanos. There's lots of
     // execution work that happens here, so this is needed for the time accounting to
     // make sense.
-    ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
+    ScopedTimer timer(getTickSource(), &_commonStats.executionTimeNanos);
 
     size_t numWorks = getTrialPeriodWorks(getOpCtx(), _collection);
     size_t numResults = getTrialPeriodNumToReturn(*_query);
@@ -216,6 +225,7 @@ Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
         if (!moreToDo) {
             break;
         }
+        stopDominatedCandidates(numResults);
     }
 
     if (_failure) {
@@ -335,7 +345,7 @@ bool MultiPlanStage::workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolic
 
     for (size_t ix = 0; ix < _candidates.size(); ++ix) {
         CandidatePlan& candidate = _candidates[ix];
-        if (candidate.failed) {
+        if (candidate.failed || candidate.dominated) {
             continue;
         }
 
@@ -403,6 +413,40 @@ bool MultiPlanStage::workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolic
     return !doneWorking;
 }
 
+void MultiPlanStage::stopDominatedCandidates(size_t numResults) {
+    const double ratio = internalQueryPlanEvaluationDominanceRatio.load();
+    if (ratio <= 0 || internalQueryForceIntersectionPlans.load()) {
+        return;
+    }
+
+    size_t leaderResults = 0;
+    for (auto&& candidate : _candidates) {
+        if (!candidate.failed) {
+            leaderResults = std::max(leaderResults, candidate.results.size());
+        }
+    }
+
+    if (leaderResults < std::max(kMinResultsForDominance, numResults / 4)) {
+        return;
+    }
+
+    for (size_t ix = 0; ix < _candidates.size(); ++ix) {
+        CandidatePlan& candidate = _candidates[ix];
+        // A plan with a blocking stage returns nothing until it has consumed all of its input,
+        // so its result count says nothing about how it will fare.
+        if (candidate.failed || candidate.dominated || candidate.solution->hasBlockingStage) {
+            continue;
+        }
+
+        if (candidate.results.size() * ratio < leaderResults) {
+            LOG(5) << "Candidate " << ix << " is dominated with " << candidate.results.size()
+                   << " results against the leader's " << leaderResults
+                   << ", no longer working it";
+            candidate.dominated = true;
+        }
+    }
+}
+
 namespace {
 
 void invalidateHelper(OperationContext* opCtx,
@@ -168,6 +168,14 @@ private:
      */
     bool workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolicy);
 
+    /**
+     * Marks as dominated every non-blocking candidate whose result count trails the leading
+     * candidate's by more than 'internalQueryPlanEvaluationDominanceRatio', so that the rest of
+     * the trial period is not spent working plans that cannot win. Only takes effect once the
+     * leader has returned a sizeable share of 'numResults'.
+     */
+    void stopDominatedCandidates(size_t numResults);
+
     /**
      * Checks whether we need to perform either a timing-based yield or a yield for a document
      * fetch. If so, then uses 'yieldPolicy' to actually perform the yield.
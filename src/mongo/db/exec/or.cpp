@@ -70,14 +70,12 @@ PlanStage::StageState OrStage::doWork(WorkingSetID* out) {
             ++_specificStats.dupsTested;
 
             // ...and we've seen the RecordId before
-            if (_seen.end() != _seen.find(member->recordId)) {
+            // Note that we've seen it, unless we already have.
+            if (!_seen.insert(member->recordId)) {
                 // ...drop it.
                 ++_specificStats.dupsDropped;
                 _ws->free(id);
                 return PlanStage::NEED_TIME;
-            } else {
-                // Otherwise, note that we've seen it.
-                _seen.insert(member->recordId);
             }
         }
 
@@ -129,10 +127,8 @@ void OrStage::doInvalidate(OperationContext* opCtx, const RecordId& dl, Invalida
     // If we see DL again it is not the same record as it once was so we still want to
     // return it.
     if (_dedup && INVALIDATION_DELETION == type) {
-        unordered_set<RecordId, RecordId::Hasher>::iterator it = _seen.find(dl);
-        if (_seen.end() != it) {
+        if (_seen.erase(dl)) {
             ++_specificStats.recordIdsForgotten;
-            _seen.erase(dl);
         }
     }
 }
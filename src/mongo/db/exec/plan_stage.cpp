@@ -35,12 +35,13 @@
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/service_context.h"
+#include "mongo/util/tsc_tick_source.h"
 
 namespace mongo {
 
 PlanStage::StageState PlanStage::work(WorkingSetID* out) {
     invariant(_opCtx);
-    ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
+    ScopedTimer timer(getTickSource(), &_commonStats.executionTimeNanos);
     ++_commonStats.works;
 
     StageState workResult = doWork(out);
@@ -105,8 +106,8 @@ void PlanStage::reattachToOperationContext(OperationContext* opCtx) {
     doReattachToOperationContext();
 }
 
-ClockSource* PlanStage::getClock() const {
-    return _opCtx->getServiceContext()->getFastClockSource();
+TickSource* PlanStage::getTickSource() const {
+    return TscTickSource::get();
 }
 
 }  // namespace mongo
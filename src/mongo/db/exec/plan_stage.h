@@ -37,7 +37,7 @@
 
 namespace mongo {
 
-class ClockSource;
+class TickSource;
 class Collection;
 class OperationContext;
 class RecordId;
@@ -386,7 +386,11 @@ protected:
      */
     virtual void doInvalidate(OperationContext* opCtx, const RecordId& dl, InvalidationType type) {}
 
-    ClockSource* getClock() const;
+    /**
+     * Returns the tick source timing the work of the stage, which is cheap enough to read on every
+     * call to work().
+     */
+    TickSource* getTickSource() const;
 
     OperationContext* getOpCtx() const {
         return _opCtx;
@@ -64,7 +64,7 @@ struct CommonStats {
           advanced(0),
           needTime(0),
           needYield(0),
-          executionTimeMillis(0),
+          executionTimeNanos(0),
           isEOF(false) {}
     // String giving the type of the stage. Not owned.
     const char* stageTypeStr;
@@ -84,8 +84,8 @@ struct CommonStats {
     // is no filter affixed, then 'filter' should be an empty BSONObj.
     BSONObj filter;
 
-    // Time elapsed while working inside this stage.
-    long long executionTimeMillis;
+    // Time elapsed while working inside this stage, in nanoseconds.
+    long long executionTimeNanos;
 
     // TODO: have some way of tracking WSM sizes (or really any series of #s).  We can measure
     // the size of our inputs and the size of our outputs.  We can do a lot with the WS here.
@@ -242,6 +242,7 @@ struct CountScanStats : public SpecificStats {
         specific->collation = collation.getOwned();
         specific->startKey = startKey.getOwned();
         specific->endKey = endKey.getOwned();
+        specific->indexBounds = indexBounds.getOwned();
         return specific;
     }
 
@@ -260,6 +261,10 @@ struct CountScanStats : public SpecificStats {
     bool startKeyInclusive;
     bool endKeyInclusive;
 
+    // The bounds of a scan over several intervals, in the format of those of an index scan. Empty
+    // when the scan is described by the keys above.
+    BSONObj indexBounds;
+
     int indexVersion;
 
     // Set to true if the index used for the count scan is multikey.
@@ -508,7 +513,7 @@ struct ProjectionStats : public SpecificStats {
 };
 
 struct SortStats : public SpecificStats {
-    SortStats() : forcedFetches(0), memUsage(0), memLimit(0) {}
+    SortStats() : forcedFetches(0), memUsage(0), memLimit(0), usedDisk(false) {}
 
     SpecificStats* clone() const final {
         SortStats* specific = new SortStats(*this);
@@ -524,6 +529,9 @@ struct SortStats : public SpecificStats {
     // What's our memory limit?
     size_t memLimit;
 
+    // Did we exceed the memory limit and spill buffered results to disk?
+    bool usedDisk;
+
     // The number of results to return from the sort.
     size_t limit;
 
@@ -74,6 +74,12 @@ ProjectionStage::ProjectionStage(OperationContext* opCtx,
         // Figure out what fields are in the projection.
         getSimpleInclusionFields(_projObj, &_includedFields);
 
+        std::vector<StringData> includedFieldNames;
+        for (auto&& includedField : _includedFields) {
+            includedFieldNames.push_back(includedField.first);
+        }
+        _simpleInclusion = make_unique<SimpleInclusionProjection>(includedFieldNames);
+
         // If we're pulling data out of one index we can pre-compute the indices of the fields
         // in the key that we pull data from and avoid looking up the field name each time.
         if (ProjectionStageParams::COVERED_ONE_INDEX == params.projImpl) {
@@ -126,22 +132,6 @@ void ProjectionStage::getSimpleInclusionFields(const BSONObj& projObj, FieldSet*
     }
 }
 
-// static
-void ProjectionStage::transformSimpleInclusion(const BSONObj& in,
-                                               const FieldSet& includedFields,
-                                               BSONObjBuilder& bob) {
-    // Look at every field in the source document and see if we're including it.
-    BSONObjIterator inputIt(in);
-    while (inputIt.more()) {
-        BSONElement elt = inputIt.next();
-        auto fieldIt = includedFields.find(elt.fieldNameStringData());
-        if (includedFields.end() != fieldIt) {
-            // If so, add it to the builder.
-            bob.append(elt);
-        }
-    }
-}
-
 Status ProjectionStage::transform(WorkingSetMember* member) {
     // The default no-fast-path case.
     if (ProjectionStageParams::NO_FAST_PATH == _projImpl) {
@@ -161,7 +151,7 @@ Status ProjectionStage::transform(WorkingSetMember* member) {
         invariant(member->hasObj());
 
         // Apply the SIMPLE_DOC projection.
-        transformSimpleInclusion(member->obj.value(), _includedFields, bob);
+        _simpleInclusion->transform(member->obj.value(), &bob);
     } else {
         invariant(ProjectionStageParams::COVERED_ONE_INDEX == _projImpl);
         // We're pulling data out of the key.
@@ -169,7 +159,7 @@ Status ProjectionStage::transform(WorkingSetMember* member) {
         size_t keyIndex = 0;
 
         // Look at every key element...
-        BSONObjIterator keyIterator(member->keyData[0].keyData);
+        BSONObjIterator keyIterator(member->keyData[0].keyData());
         while (keyIterator.more()) {
             BSONElement elt = keyIterator.next();
             // If we're supposed to include it...
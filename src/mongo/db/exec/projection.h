@@ -31,6 +31,7 @@
 
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/exec/projection_exec.h"
+#include "mongo/db/exec/simple_inclusion_projection.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/record_id.h"
@@ -106,16 +107,6 @@ public:
      */
     static void getSimpleInclusionFields(const BSONObj& projObj, FieldSet* includedFields);
 
-    /**
-     * Applies a simple inclusion projection to 'in', including
-     * only the fields specified by 'includedFields'.
-     *
-     * The resulting document is constructed using 'bob'.
-     */
-    static void transformSimpleInclusion(const BSONObj& in,
-                                         const FieldSet& includedFields,
-                                         BSONObjBuilder& bob);
-
     static const char* kStageType;
 
 private:
@@ -139,6 +130,9 @@ private:
     // Has the field names present in the simple projection.
     FieldSet _includedFields;
 
+    // Applies the projection to whole documents.
+    std::unique_ptr<SimpleInclusionProjection> _simpleInclusion;
+
     //
     // Used for the COVERED_ONE_INDEX path.
     //
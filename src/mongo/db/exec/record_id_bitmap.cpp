@@ -0,0 +1,300 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/record_id_bitmap.h"
+
+#include <algorithm>
+#include <bitset>
+
+#include "mongo/platform/bits.h"
+
+namespace mongo {
+
+namespace {
+
+// Returned by Chunk::nextMember() when there is no further member.
+const uint32_t kNoMember = 1 << 16;
+
+// Rough per-chunk overhead of a std::map node.
+const size_t kChunkOverheadBytes = 64;
+
+uint32_t countBits(uint64_t word) {
+    return std::bitset<64>(word).count();
+}
+
+}  // namespace
+
+bool RecordIdBitmap::Chunk::contains(uint16_t low) const {
+    if (isBitmap()) {
+        return (bitmap[low >> 6] >> (low & 63)) & 1;
+    }
+    return std::binary_search(array.begin(), array.end(), low);
+}
+
+uint32_t RecordIdBitmap::Chunk::nextMember(uint32_t low) const {
+    if (low >= kNoMember) {
+        return kNoMember;
+    }
+
+    if (!isBitmap()) {
+        auto it = std::lower_bound(array.begin(), array.end(), static_cast<uint16_t>(low));
+        return it == array.end() ? kNoMember : *it;
+    }
+
+    size_t wordIdx = low >> 6;
+    uint64_t word = bitmap[wordIdx] & (~uint64_t(0) << (low & 63));
+    while (0 == word) {
+        if (++wordIdx == kBitmapWords) {
+            return kNoMember;
+        }
+        word = bitmap[wordIdx];
+    }
+    return (wordIdx << 6) + countTrailingZeros64(word);
+}
+
+void RecordIdBitmap::Chunk::convertToBitmap() {
+    bitmap.assign(kBitmapWords, 0);
+    for (uint16_t low : array) {
+        bitmap[low >> 6] |= uint64_t(1) << (low & 63);
+    }
+    std::vector<uint16_t>().swap(array);
+}
+
+bool RecordIdBitmap::insert(const RecordId& rid) {
+    const uint64_t value = toUnsigned(rid);
+    const uint16_t low = value & 0xFFFF;
+    Chunk& chunk = _chunks[value >> kChunkBits];
+
+    if (chunk.isBitmap()) {
+        uint64_t& word = chunk.bitmap[low >> 6];
+        const uint64_t bit = uint64_t(1) << (low & 63);
+        if (word & bit) {
+            return false;
+        }
+        word |= bit;
+    } else {
+        auto it = std::lower_bound(chunk.array.begin(), chunk.array.end(), low);
+        if (it != chunk.array.end() && *it == low) {
+            return false;
+        }
+        chunk.array.insert(it, low);
+        if (chunk.array.size() > kMaxArrayCardinality) {
+            chunk.convertToBitmap();
+        }
+    }
+
+    ++chunk.cardinality;
+    ++_size;
+    return true;
+}
+
+bool RecordIdBitmap::erase(const RecordId& rid) {
+    const uint64_t value = toUnsigned(rid);
+    const uint16_t low = value & 0xFFFF;
+    auto chunkIt = _chunks.find(value >> kChunkBits);
+    if (chunkIt == _chunks.end()) {
+        return false;
+    }
+
+    Chunk& chunk = chunkIt->second;
+    if (chunk.isBitmap()) {
+        uint64_t& word = chunk.bitmap[low >> 6];
+        const uint64_t bit = uint64_t(1) << (low & 63);
+        if (!(word & bit)) {
+            return false;
+        }
+        word &= ~bit;
+    } else {
+        auto it = std::lower_bound(chunk.array.begin(), chunk.array.end(), low);
+        if (it == chunk.array.end() || *it != low) {
+            return false;
+        }
+        chunk.array.erase(it);
+    }
+
+    --_size;
+    if (0 == --chunk.cardinality) {
+        _chunks.erase(chunkIt);
+    }
+    return true;
+}
+
+bool RecordIdBitmap::contains(const RecordId& rid) const {
+    const uint64_t value = toUnsigned(rid);
+    auto chunkIt = _chunks.find(value >> kChunkBits);
+    return chunkIt != _chunks.end() && chunkIt->second.contains(value & 0xFFFF);
+}
+
+void RecordIdBitmap::clear() {
+    _chunks.clear();
+    _size = 0;
+}
+
+// static
+RecordIdBitmap::Chunk RecordIdBitmap::intersectChunks(const Chunk& lhs, const Chunk& rhs) {
+    Chunk result;
+    if (lhs.isBitmap() && rhs.isBitmap()) {
+        result.bitmap.resize(kBitmapWords);
+        for (size_t i = 0; i < kBitmapWords; ++i) {
+            result.bitmap[i] = lhs.bitmap[i] & rhs.bitmap[i];
+            result.cardinality += countBits(result.bitmap[i]);
+        }
+        return result;
+    }
+
+    if (lhs.isBitmap() || rhs.isBitmap()) {
+        const Chunk& bitmapSide = lhs.isBitmap() ? lhs : rhs;
+        const Chunk& arraySide = lhs.isBitmap() ? rhs : lhs;
+        for (uint16_t low : arraySide.array) {
+            if (bitmapSide.contains(low)) {
+                result.array.push_back(low);
+            }
+        }
+    } else {
+        std::set_intersection(lhs.array.begin(),
+                              lhs.array.end(),
+                              rhs.array.begin(),
+                              rhs.array.end(),
+                              std::back_inserter(result.array));
+    }
+    result.cardinality = result.array.size();
+    return result;
+}
+
+// static
+RecordIdBitmap::Chunk RecordIdBitmap::unionChunks(const Chunk& lhs, const Chunk& rhs) {
+    Chunk result;
+    if (!lhs.isBitmap() && !rhs.isBitmap()) {
+        std::set_union(lhs.array.begin(),
+                       lhs.array.end(),
+                       rhs.array.begin(),
+                       rhs.array.end(),
+                       std::back_inserter(result.array));
+        result.cardinality = result.array.size();
+        if (result.array.size() > kMaxArrayCardinality) {
+            result.convertToBitmap();
+        }
+        return result;
+    }
+
+    const Chunk& bitmapSide = lhs.isBitmap() ? lhs : rhs;
+    const Chunk& otherSide = lhs.isBitmap() ? rhs : lhs;
+    result.bitmap = bitmapSide.bitmap;
+    if (otherSide.isBitmap()) {
+        for (size_t i = 0; i < kBitmapWords; ++i) {
+            result.bitmap[i] |= otherSide.bitmap[i];
+        }
+    } else {
+        for (uint16_t low : otherSide.array) {
+            result.bitmap[low >> 6] |= uint64_t(1) << (low & 63);
+        }
+    }
+    for (uint64_t word : result.bitmap) {
+        result.cardinality += countBits(word);
+    }
+    return result;
+}
+
+void RecordIdBitmap::intersectWith(const RecordIdBitmap& other) {
+    _size = 0;
+    auto it = _chunks.begin();
+    while (it != _chunks.end()) {
+        auto otherIt = other._chunks.find(it->first);
+        if (otherIt != other._chunks.end()) {
+            it->second = intersectChunks(it->second, otherIt->second);
+            if (it->second.cardinality > 0) {
+                _size += it->second.cardinality;
+                ++it;
+                continue;
+            }
+        }
+        it = _chunks.erase(it);
+    }
+}
+
+void RecordIdBitmap::unionWith(const RecordIdBitmap& other) {
+    for (auto&& otherChunk : other._chunks) {
+        auto it = _chunks.find(otherChunk.first);
+        if (it == _chunks.end()) {
+            _chunks.emplace(otherChunk.first, otherChunk.second);
+            _size += otherChunk.second.cardinality;
+        } else {
+            _size -= it->second.cardinality;
+            it->second = unionChunks(it->second, otherChunk.second);
+            _size += it->second.cardinality;
+        }
+    }
+}
+
+size_t RecordIdBitmap::getMemUsage() const {
+    size_t memUsage = 0;
+    for (auto&& chunk : _chunks) {
+        memUsage += kChunkOverheadBytes + chunk.second.array.capacity() * sizeof(uint16_t) +
+            chunk.second.bitmap.capacity() * sizeof(uint64_t);
+    }
+    return memUsage;
+}
+
+RecordIdBitmap::const_iterator RecordIdBitmap::begin() const {
+    return const_iterator(_chunks.begin(), _chunks.end(), 0);
+}
+
+RecordIdBitmap::const_iterator RecordIdBitmap::end() const {
+    return const_iterator(_chunks.end(), _chunks.end(), 0);
+}
+
+RecordIdBitmap::const_iterator::const_iterator(ChunkMap::const_iterator chunk,
+                                               ChunkMap::const_iterator end,
+                                               uint32_t low)
+    : _chunk(chunk), _end(end), _low(low) {
+    _settle();
+}
+
+RecordIdBitmap::const_iterator& RecordIdBitmap::const_iterator::operator++() {
+    ++_low;
+    _settle();
+    return *this;
+}
+
+void RecordIdBitmap::const_iterator::_settle() {
+    while (_chunk != _end) {
+        const uint32_t next = _chunk->second.nextMember(_low);
+        if (next != kNoMember) {
+            _low = next;
+            _current = fromParts(_chunk->first, next);
+            return;
+        }
+        ++_chunk;
+        _low = 0;
+    }
+    _low = 0;
+}
+
+}  // namespace mongo
@@ -0,0 +1,194 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <vector>
+
+#include "mongo/db/record_id.h"
+
+namespace mongo {
+
+/**
+ * A compressed, ordered set of RecordIds in the style of a Roaring bitmap.
+ *
+ * The 64-bit RecordId space is split into chunks of 2^16 consecutive values. Each non-empty chunk
+ * stores its members either as a sorted array of 16-bit offsets, while it is sparse, or as a
+ * 65536-bit bitmap once it holds more than kMaxArrayCardinality members. Densely allocated
+ * RecordIds, as produced by most storage engines, therefore cost about two bits each instead of
+ * a hash table node per member.
+ *
+ * Iteration visits members in ascending RecordId order.
+ */
+class RecordIdBitmap {
+public:
+    // A chunk switches from an array to a bitmap representation beyond this many members. At
+    // this size both take 8KB.
+    static const size_t kMaxArrayCardinality = 4096;
+
+    class const_iterator;
+
+    /**
+     * Adds 'rid'. Returns false if it was already present.
+     */
+    bool insert(const RecordId& rid);
+
+    /**
+     * Removes 'rid'. Returns false if it was not present.
+     */
+    bool erase(const RecordId& rid);
+
+    bool contains(const RecordId& rid) const;
+
+    size_t size() const {
+        return _size;
+    }
+
+    bool empty() const {
+        return 0 == _size;
+    }
+
+    void clear();
+
+    /**
+     * Removes every member that is not also in 'other'.
+     */
+    void intersectWith(const RecordIdBitmap& other);
+
+    /**
+     * Adds every member of 'other'.
+     */
+    void unionWith(const RecordIdBitmap& other);
+
+    /**
+     * Returns an estimate of the heap memory used by this set, in bytes.
+     */
+    size_t getMemUsage() const;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+
+private:
+    static const size_t kChunkBits = 16;
+    static const size_t kBitmapWords = (1 << kChunkBits) / 64;
+
+    /**
+     * The members of one chunk. Exactly one of 'array' and 'bitmap' is in use: 'bitmap' is empty
+     * while the chunk is an array.
+     */
+    struct Chunk {
+        bool isBitmap() const {
+            return !bitmap.empty();
+        }
+
+        bool contains(uint16_t low) const;
+
+        /**
+         * Returns the smallest member greater than or equal to 'low', or a value greater than
+         * 0xFFFF if there is none.
+         */
+        uint32_t nextMember(uint32_t low) const;
+
+        void convertToBitmap();
+
+        std::vector<uint16_t> array;
+        std::vector<uint64_t> bitmap;
+        uint32_t cardinality = 0;
+    };
+
+    typedef std::map<uint64_t, Chunk> ChunkMap;
+
+    /**
+     * RecordIds are signed. Flipping the sign bit maps them to unsigned values with the same
+     * ordering, which are then split into a chunk key and an offset within the chunk.
+     */
+    static uint64_t toUnsigned(const RecordId& rid) {
+        return static_cast<uint64_t>(rid.repr()) ^ (uint64_t(1) << 63);
+    }
+
+    static RecordId fromParts(uint64_t key, uint32_t low) {
+        return RecordId(static_cast<int64_t>(((key << kChunkBits) | low) ^ (uint64_t(1) << 63)));
+    }
+
+    static Chunk intersectChunks(const Chunk& lhs, const Chunk& rhs);
+    static Chunk unionChunks(const Chunk& lhs, const Chunk& rhs);
+
+    ChunkMap _chunks;
+    size_t _size = 0;
+};
+
+/**
+ * Forward iterator over the members of a RecordIdBitmap in ascending order. Invalidated by any
+ * modification of the set.
+ */
+class RecordIdBitmap::const_iterator {
+public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef RecordId value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const RecordId* pointer;
+    typedef const RecordId& reference;
+
+    const RecordId& operator*() const {
+        return _current;
+    }
+
+    const RecordId* operator->() const {
+        return &_current;
+    }
+
+    const_iterator& operator++();
+
+    bool operator==(const const_iterator& other) const {
+        return _chunk == other._chunk && _low == other._low;
+    }
+
+    bool operator!=(const const_iterator& other) const {
+        return !(*this == other);
+    }
+
+private:
+    friend class RecordIdBitmap;
+
+    const_iterator(ChunkMap::const_iterator chunk, ChunkMap::const_iterator end, uint32_t low);
+
+    /**
+     * Moves to the first member at or after the current position, advancing across chunks.
+     */
+    void _settle();
+
+    ChunkMap::const_iterator _chunk;
+    ChunkMap::const_iterator _end;
+    uint32_t _low;
+    RecordId _current;
+};
+
+}  // namespace mongo
@@ -0,0 +1,149 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/record_id_bitmap.h"
+
+#include <set>
+
+#include "mongo/platform/random.h"
+#include "mongo/unittest/unittest.h"
+
+namespace {
+
+using namespace mongo;
+
+std::vector<RecordId> toVector(const RecordIdBitmap& bitmap) {
+    return std::vector<RecordId>(bitmap.begin(), bitmap.end());
+}
+
+std::vector<RecordId> toVector(const std::set<int64_t>& reprs) {
+    std::vector<RecordId> rids;
+    for (auto repr : reprs) {
+        rids.push_back(RecordId(repr));
+    }
+    return rids;
+}
+
+TEST(RecordIdBitmapTest, InsertContainsErase) {
+    RecordIdBitmap bitmap;
+    ASSERT_TRUE(bitmap.empty());
+    ASSERT(bitmap.begin() == bitmap.end());
+
+    ASSERT_TRUE(bitmap.insert(RecordId(5)));
+    ASSERT_FALSE(bitmap.insert(RecordId(5)));
+    ASSERT_TRUE(bitmap.insert(RecordId(1 << 20)));
+    ASSERT_EQUALS(bitmap.size(), 2U);
+
+    ASSERT_TRUE(bitmap.contains(RecordId(5)));
+    ASSERT_TRUE(bitmap.contains(RecordId(1 << 20)));
+    ASSERT_FALSE(bitmap.contains(RecordId(6)));
+
+    ASSERT_TRUE(bitmap.erase(RecordId(5)));
+    ASSERT_FALSE(bitmap.erase(RecordId(5)));
+    ASSERT_FALSE(bitmap.contains(RecordId(5)));
+    ASSERT_EQUALS(bitmap.size(), 1U);
+
+    bitmap.clear();
+    ASSERT_TRUE(bitmap.empty());
+    ASSERT_FALSE(bitmap.contains(RecordId(1 << 20)));
+}
+
+TEST(RecordIdBitmapTest, IteratesInRecordIdOrder) {
+    RecordIdBitmap bitmap;
+    std::set<int64_t> expected;
+    for (int64_t repr : {int64_t(100), int64_t(-3), int64_t(1) << 40, int64_t(7), int64_t(65536)}) {
+        bitmap.insert(RecordId(repr));
+        expected.insert(repr);
+    }
+    bitmap.insert(RecordId::min());
+    bitmap.insert(RecordId::max());
+    expected.insert(RecordId::min().repr());
+    expected.insert(RecordId::max().repr());
+
+    ASSERT(toVector(bitmap) == toVector(expected));
+}
+
+TEST(RecordIdBitmapTest, DenseChunksSwitchToBitmaps) {
+    RecordIdBitmap bitmap;
+    std::set<int64_t> expected;
+    for (int64_t repr = 1; repr <= 3 * int64_t(RecordIdBitmap::kMaxArrayCardinality); ++repr) {
+        bitmap.insert(RecordId(repr));
+        expected.insert(repr);
+    }
+    ASSERT_EQUALS(bitmap.size(), expected.size());
+
+    // A dense chunk is stored in 8KB regardless of how many members it holds.
+    ASSERT_LTE(bitmap.getMemUsage(), 9 * 1024U);
+
+    ASSERT_TRUE(bitmap.erase(RecordId(10)));
+    expected.erase(10);
+    ASSERT_FALSE(bitmap.contains(RecordId(10)));
+    ASSERT(toVector(bitmap) == toVector(expected));
+}
+
+TEST(RecordIdBitmapTest, IntersectAndUnionMatchStdSet) {
+    PseudoRandom random(12345);
+    for (int round = 0; round < 8; ++round) {
+        // Alternate between sparse and dense inputs so every pair of chunk representations is
+        // combined.
+        const int64_t span = (round % 2) ? 1000 * 1000 : 20 * 1000;
+        const int numValues = 10 * 1000;
+
+        RecordIdBitmap lhs, rhs;
+        std::set<int64_t> lhsExpected, rhsExpected;
+        for (int i = 0; i < numValues; ++i) {
+            const int64_t lhsRepr = random.nextInt64(span);
+            const int64_t rhsRepr = random.nextInt64((round % 4 < 2) ? span : 20 * 1000);
+            ASSERT_EQUALS(lhs.insert(RecordId(lhsRepr)), lhsExpected.insert(lhsRepr).second);
+            ASSERT_EQUALS(rhs.insert(RecordId(rhsRepr)), rhsExpected.insert(rhsRepr).second);
+        }
+
+        std::set<int64_t> intersection;
+        for (auto repr : lhsExpected) {
+            if (rhsExpected.count(repr)) {
+                intersection.insert(repr);
+            }
+        }
+        std::set<int64_t> unionSet = lhsExpected;
+        unionSet.insert(rhsExpected.begin(), rhsExpected.end());
+
+        RecordIdBitmap intersected = lhs;
+        intersected.intersectWith(rhs);
+        ASSERT_EQUALS(intersected.size(), intersection.size());
+        ASSERT(toVector(intersected) == toVector(intersection));
+
+        RecordIdBitmap unioned = lhs;
+        unioned.unionWith(rhs);
+        ASSERT_EQUALS(unioned.size(), unionSet.size());
+        ASSERT(toVector(unioned) == toVector(unionSet));
+    }
+}
+
+}  // namespace
@@ -29,16 +29,18 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/exec/scoped_timer.h"
-#include "mongo/util/clock_source.h"
 
 namespace mongo {
 
-ScopedTimer::ScopedTimer(ClockSource* cs, long long* counter)
-    : _clock(cs), _counter(counter), _start(cs->now()) {}
+ScopedTimer::ScopedTimer(TickSource* tickSource, long long* nanosCounter)
+    : _tickSource(tickSource), _counter(nanosCounter), _start(tickSource->getTicks()) {}
 
 ScopedTimer::~ScopedTimer() {
-    long long elapsed = durationCount<Milliseconds>(_clock->now() - _start);
-    *_counter += elapsed;
+    // Converting each interval rather than rounding it to a coarser unit keeps the many short
+    // intervals of a stage from adding up to nothing.
+    const TickSource::Tick elapsed = _tickSource->getTicks() - _start;
+    *_counter += static_cast<long long>(static_cast<double>(elapsed) * 1000 * 1000 * 1000 /
+                                        _tickSource->getTicksPerSecond());
 }
 
 }  // namespace mongo
@@ -30,31 +30,29 @@
 
 #include "mongo/base/disallow_copying.h"
 
-#include "mongo/util/time_support.h"
+#include "mongo/util/tick_source.h"
 
 namespace mongo {
 
-class ClockSource;
-
 /**
- * This class increments a counter by a rough estimate of the time elapsed since its
- * construction when it goes out of scope.
+ * This class increments a counter by the number of nanoseconds elapsed since its construction,
+ * as measured by 'tickSource', when it goes out of scope.
  */
 class ScopedTimer {
     MONGO_DISALLOW_COPYING(ScopedTimer);
 
 public:
-    ScopedTimer(ClockSource* cs, long long* counter);
+    ScopedTimer(TickSource* tickSource, long long* nanosCounter);
 
     ~ScopedTimer();
 
 private:
-    ClockSource* const _clock;
+    TickSource* const _tickSource;
     // Reference to the counter that we are incrementing with the elapsed time.
     long long* _counter;
 
-    // Time at which the timer was constructed.
-    const Date_t _start;
+    // Ticks at which the timer was constructed.
+    const TickSource::Tick _start;
 };
 
 }  // namespace mongo
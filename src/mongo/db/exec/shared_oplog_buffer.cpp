@@ -0,0 +1,114 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/shared_oplog_buffer.h"
+
+#include <algorithm>
+
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+
+namespace {
+
+const auto getSharedOplogBuffer = ServiceContext::declareDecoration<SharedOplogBuffer>();
+
+}  // namespace
+
+SharedOplogBuffer& SharedOplogBuffer::get(ServiceContext* service) {
+    return getSharedOplogBuffer(service);
+}
+
+boost::optional<SharedOplogBuffer::Entry> SharedOplogBuffer::next(const RecordStore* oplog,
+                                                                  const RecordId& previous) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (oplog != _oplog) {
+        return boost::none;
+    }
+
+    auto it = std::lower_bound(
+        _entries.begin(), _entries.end(), previous, [](const Entry& entry, const RecordId& id) {
+            return entry.id < id;
+        });
+    if (it == _entries.end() || it->id != previous || ++it == _entries.end()) {
+        return boost::none;
+    }
+    return *it;
+}
+
+void SharedOplogBuffer::append(const RecordStore* oplog,
+                               const RecordId& previous,
+                               const RecordId& id,
+                               const BSONObj& obj) {
+    const int maxBytes = internalQueryExecSharedOplogBufferMaxBytes.load();
+    if (maxBytes <= 0) {
+        return;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (oplog != _oplog) {
+        _clear_inlock();
+        _oplog = oplog;
+    }
+
+    if (!_entries.empty() && previous != _entries.back().id) {
+        // Readers behind the end of the buffered run, or racing to extend it, have nothing to add.
+        // A reader past it starts a new run, so that the buffer follows the leading tailers.
+        if (previous.isNull() || previous < _entries.back().id) {
+            return;
+        }
+        _clear_inlock();
+    }
+
+    _entries.push_back({id, obj.getOwned()});
+    _bytes += obj.objsize();
+    while (_bytes > static_cast<size_t>(maxBytes)) {
+        _bytes -= _entries.front().obj.objsize();
+        _entries.pop_front();
+    }
+}
+
+void SharedOplogBuffer::clear() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _clear_inlock();
+}
+
+size_t SharedOplogBuffer::size() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _entries.size();
+}
+
+void SharedOplogBuffer::_clear_inlock() {
+    _entries.clear();
+    _bytes = 0;
+}
+
+}  // namespace mongo
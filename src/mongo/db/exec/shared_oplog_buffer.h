@@ -0,0 +1,107 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <deque>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/record_id.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+class RecordStore;
+class ServiceContext;
+
+/**
+ * The most recently read entries of the oplog, shared by all the tailing scans of it. Whichever
+ * tailer reads the next entry from storage first appends it here, and the others take it from
+ * here instead of reading and copying it themselves.
+ *
+ * The buffered entries are a contiguous run of the oplog. The buffer is bounded by
+ * internalQueryExecSharedOplogBufferMaxBytes: once full it forgets its oldest entries, and tailers
+ * which have fallen behind read from storage again rather than holding back the others.
+ *
+ * Buffered entries bypass the storage engine's snapshots, so only readers which see every
+ * committed write may use them. The buffer must be cleared whenever oplog entries are removed
+ * other than from its oldest end.
+ *
+ * This class is thread-safe.
+ */
+class SharedOplogBuffer {
+    MONGO_DISALLOW_COPYING(SharedOplogBuffer);
+
+public:
+    struct Entry {
+        RecordId id;
+        BSONObj obj;
+    };
+
+    SharedOplogBuffer() = default;
+
+    static SharedOplogBuffer& get(ServiceContext* service);
+
+    /**
+     * Returns the entry which follows 'previous' in 'oplog', if both are buffered.
+     */
+    boost::optional<Entry> next(const RecordStore* oplog, const RecordId& previous) const;
+
+    /**
+     * Records that the entry 'id' of 'oplog', whose contents are 'obj', directly follows
+     * 'previous', which is null if the reader does not know what precedes 'id'. Does nothing
+     * unless this extends the buffered run or starts a new one past it.
+     */
+    void append(const RecordStore* oplog,
+                const RecordId& previous,
+                const RecordId& id,
+                const BSONObj& obj);
+
+    /**
+     * Forgets all buffered entries.
+     */
+    void clear();
+
+    size_t size() const;
+
+private:
+    void _clear_inlock();
+
+    mutable stdx::mutex _mutex;
+
+    // The oplog whose entries are buffered.
+    const RecordStore* _oplog = nullptr;
+
+    // In increasing order of RecordId.
+    std::deque<Entry> _entries;
+    size_t _bytes = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,164 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/shared_oplog_buffer.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/unittest/unittest.h"
+
+namespace {
+
+using namespace mongo;
+
+// The buffer only compares RecordStore pointers, so these never need to point at a real one.
+char oplogStorage[2];
+const RecordStore* const kOplog = reinterpret_cast<const RecordStore*>(&oplogStorage[0]);
+const RecordStore* const kOtherOplog = reinterpret_cast<const RecordStore*>(&oplogStorage[1]);
+
+BSONObj entry(int i) {
+    return BSON("ts" << i << "o" << BSON("x" << i));
+}
+
+void assertNext(const SharedOplogBuffer& buffer, int previous, int expected) {
+    auto next = buffer.next(kOplog, RecordId(previous));
+    ASSERT(next);
+    ASSERT_EQ(RecordId(expected), next->id);
+    ASSERT_BSONOBJ_EQ(entry(expected), next->obj);
+}
+
+class MaxBytesGuard {
+public:
+    explicit MaxBytesGuard(int maxBytes)
+        : _saved(internalQueryExecSharedOplogBufferMaxBytes.load()) {
+        internalQueryExecSharedOplogBufferMaxBytes.store(maxBytes);
+    }
+
+    ~MaxBytesGuard() {
+        internalQueryExecSharedOplogBufferMaxBytes.store(_saved);
+    }
+
+private:
+    const int _saved;
+};
+
+TEST(SharedOplogBufferTest, NextFollowsContiguousAppends) {
+    SharedOplogBuffer buffer;
+    ASSERT_FALSE(buffer.next(kOplog, RecordId(1)));
+
+    buffer.append(kOplog, RecordId(), RecordId(1), entry(1));
+    buffer.append(kOplog, RecordId(1), RecordId(3), entry(3));
+    buffer.append(kOplog, RecordId(3), RecordId(4), entry(4));
+    ASSERT_EQ(3U, buffer.size());
+
+    assertNext(buffer, 1, 3);
+    assertNext(buffer, 3, 4);
+    ASSERT_FALSE(buffer.next(kOplog, RecordId(4)));
+    ASSERT_FALSE(buffer.next(kOplog, RecordId(2)));
+    ASSERT_FALSE(buffer.next(kOtherOplog, RecordId(1)));
+}
+
+TEST(SharedOplogBufferTest, AppendsBehindTheEndAreIgnored) {
+    SharedOplogBuffer buffer;
+    buffer.append(kOplog, RecordId(), RecordId(5), entry(5));
+    buffer.append(kOplog, RecordId(5), RecordId(6), entry(6));
+
+    // A reader which does not know its previous entry, a reader which has fallen behind, and a
+    // reader which lost the race to extend the run must not disturb it.
+    buffer.append(kOplog, RecordId(), RecordId(2), entry(2));
+    buffer.append(kOplog, RecordId(1), RecordId(2), entry(2));
+    buffer.append(kOplog, RecordId(5), RecordId(6), entry(6));
+    ASSERT_EQ(2U, buffer.size());
+    assertNext(buffer, 5, 6);
+}
+
+TEST(SharedOplogBufferTest, AppendPastTheEndStartsANewRun) {
+    SharedOplogBuffer buffer;
+    buffer.append(kOplog, RecordId(), RecordId(1), entry(1));
+    buffer.append(kOplog, RecordId(1), RecordId(2), entry(2));
+
+    buffer.append(kOplog, RecordId(7), RecordId(8), entry(8));
+    ASSERT_EQ(1U, buffer.size());
+    ASSERT_FALSE(buffer.next(kOplog, RecordId(1)));
+    ASSERT_FALSE(buffer.next(kOplog, RecordId(7)));
+
+    buffer.append(kOplog, RecordId(8), RecordId(9), entry(9));
+    assertNext(buffer, 8, 9);
+}
+
+TEST(SharedOplogBufferTest, OldestEntriesAreEvictedPastTheByteLimit) {
+    MaxBytesGuard guard(3 * entry(0).objsize());
+    SharedOplogBuffer buffer;
+    buffer.append(kOplog, RecordId(), RecordId(1), entry(1));
+    for (int i = 2; i <= 5; ++i) {
+        buffer.append(kOplog, RecordId(i - 1), RecordId(i), entry(i));
+    }
+    ASSERT_EQ(3U, buffer.size());
+    ASSERT_FALSE(buffer.next(kOplog, RecordId(2)));
+    assertNext(buffer, 3, 4);
+    assertNext(buffer, 4, 5);
+}
+
+TEST(SharedOplogBufferTest, AppendToADifferentOplogReplacesTheBufferedEntries) {
+    SharedOplogBuffer buffer;
+    buffer.append(kOplog, RecordId(), RecordId(1), entry(1));
+    buffer.append(kOplog, RecordId(1), RecordId(2), entry(2));
+
+    buffer.append(kOtherOplog, RecordId(), RecordId(1), entry(1));
+    buffer.append(kOtherOplog, RecordId(1), RecordId(2), entry(2));
+    ASSERT_EQ(2U, buffer.size());
+    ASSERT_FALSE(buffer.next(kOplog, RecordId(1)));
+    ASSERT(buffer.next(kOtherOplog, RecordId(1)));
+}
+
+TEST(SharedOplogBufferTest, ClearForgetsAllEntries) {
+    SharedOplogBuffer buffer;
+    buffer.append(kOplog, RecordId(), RecordId(1), entry(1));
+    buffer.append(kOplog, RecordId(1), RecordId(2), entry(2));
+    buffer.clear();
+    ASSERT_EQ(0U, buffer.size());
+    ASSERT_FALSE(buffer.next(kOplog, RecordId(1)));
+
+    // The next append starts a new run.
+    buffer.append(kOplog, RecordId(1), RecordId(2), entry(2));
+    buffer.append(kOplog, RecordId(2), RecordId(3), entry(3));
+    assertNext(buffer, 2, 3);
+}
+
+TEST(SharedOplogBufferTest, ZeroByteLimitDisablesTheBuffer) {
+    MaxBytesGuard guard(0);
+    SharedOplogBuffer buffer;
+    buffer.append(kOplog, RecordId(), RecordId(1), entry(1));
+    buffer.append(kOplog, RecordId(1), RecordId(2), entry(2));
+    ASSERT_EQ(0U, buffer.size());
+    ASSERT_FALSE(buffer.next(kOplog, RecordId(1)));
+}
+
+}  // namespace
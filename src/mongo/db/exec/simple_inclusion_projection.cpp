@@ -0,0 +1,134 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/simple_inclusion_projection.h"
+
+#include <algorithm>
+
+namespace mongo {
+
+namespace {
+
+// How many hash seeds to try at each table size before doubling it, and how much larger than the
+// number of fields the table may grow while looking for a layout without collisions.
+const uint32_t kSeedsPerTableSize = 16;
+const size_t kMaxTableSizeFactor = 16;
+
+}  // namespace
+
+SimpleInclusionProjection::SimpleInclusionProjection(const std::vector<StringData>& fieldNames) {
+    // Leave at least half of the table unused so that unsuccessful lookups end quickly.
+    size_t minTableSize = 2;
+    while (minTableSize < 2 * fieldNames.size()) {
+        minTableSize *= 2;
+    }
+
+    for (size_t tableSize = minTableSize;
+         tableSize <= std::max(minTableSize, kMaxTableSizeFactor * fieldNames.size());
+         tableSize *= 2) {
+        for (uint32_t seed = 0; seed < kSeedsPerTableSize; ++seed) {
+            if (fillTable(fieldNames, tableSize, seed)) {
+                return;
+            }
+        }
+    }
+
+    // Some names always collide, so settle for linear probing in the smallest table.
+    fillTable(fieldNames, minTableSize, 0);
+}
+
+bool SimpleInclusionProjection::fillTable(const std::vector<StringData>& fieldNames,
+                                          size_t tableSize,
+                                          uint32_t seed) {
+    _used.assign(tableSize, false);
+    _slots.assign(tableSize, std::string());
+    _seed = seed;
+    _collisionFree = true;
+    for (auto&& fieldName : fieldNames) {
+        size_t slot = slotFor(fieldName);
+        while (_used[slot] && _slots[slot] != fieldName) {
+            _collisionFree = false;
+            slot = (slot + 1) & (tableSize - 1);
+        }
+        _used[slot] = true;
+        _slots[slot] = fieldName.toString();
+    }
+    return _collisionFree;
+}
+
+uint32_t SimpleInclusionProjection::hash(StringData fieldName, uint32_t seed) {
+    // FNV-1a. Field names are short, so hashing every byte is cheaper than anything cleverer.
+    uint32_t h = 2166136261u ^ (seed * 16777619u);
+    for (char c : fieldName) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+bool SimpleInclusionProjection::includes(StringData fieldName) const {
+    for (size_t slot = slotFor(fieldName); _used[slot]; slot = (slot + 1) & (_slots.size() - 1)) {
+        if (_slots[slot] == fieldName) {
+            return true;
+        }
+        if (_collisionFree) {
+            // No other field hashes to this slot.
+            return false;
+        }
+    }
+    return false;
+}
+
+void SimpleInclusionProjection::transform(const BSONObj& in, BSONObjBuilder* bob) const {
+    // The elements of 'in' are contiguous, so a run of included elements is a single range of
+    // bytes, which we copy when the run ends.
+    const char* runStart = nullptr;
+    const char* runEnd = nullptr;
+
+    BSONObjIterator inputIt(in);
+    while (inputIt.more()) {
+        BSONElement elt = inputIt.next();
+        if (includes(elt.fieldNameStringData())) {
+            if (!runStart) {
+                runStart = elt.rawdata();
+            }
+            runEnd = elt.rawdata() + elt.size();
+        } else if (runStart) {
+            bob->bb().appendBuf(runStart, runEnd - runStart);
+            runStart = nullptr;
+        }
+    }
+
+    if (runStart) {
+        bob->bb().appendBuf(runStart, runEnd - runStart);
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,95 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobjbuilder.h"
+
+namespace mongo {
+
+/**
+ * Applies an inclusion projection of top-level fields, such as {a: 1, b: 1}, to whole documents.
+ *
+ * The projected field names are laid out in an open addressing table whose hash seed and size are
+ * chosen, when possible, so that no two of them share a slot, making each lookup a single hash
+ * and comparison. Included elements that are adjacent in the input are copied to the output as
+ * one block of bytes instead of one element at a time.
+ */
+class SimpleInclusionProjection {
+public:
+    /**
+     * 'fieldNames' are the names of the top-level fields to include. The names are copied.
+     */
+    explicit SimpleInclusionProjection(const std::vector<StringData>& fieldNames);
+
+    /**
+     * Returns true if 'fieldName' is one of the included fields.
+     */
+    bool includes(StringData fieldName) const;
+
+    /**
+     * Appends each field of 'in' that is included to 'bob', in the order they appear in 'in'.
+     */
+    void transform(const BSONObj& in, BSONObjBuilder* bob) const;
+
+    /**
+     * Returns true if every included field has a slot of its own, so that no lookup has to probe
+     * past the slot its hash selects.
+     */
+    bool isCollisionFree() const {
+        return _collisionFree;
+    }
+
+private:
+    static uint32_t hash(StringData fieldName, uint32_t seed);
+
+    /**
+     * Lays out 'fieldNames' in a table of 'tableSize' slots using 'seed', and returns whether
+     * they all landed in the slot their hash selects.
+     */
+    bool fillTable(const std::vector<StringData>& fieldNames, size_t tableSize, uint32_t seed);
+
+    size_t slotFor(StringData fieldName) const {
+        return hash(fieldName, _seed) & (_slots.size() - 1);
+    }
+
+    // Whether each slot is in use, and the field name in it. The table size is a power of two with
+    // at least one unused slot, which ends unsuccessful lookups.
+    std::vector<bool> _used;
+    std::vector<std::string> _slots;
+    uint32_t _seed = 0;
+    bool _collisionFree = false;
+};
+
+}  // namespace mongo
@@ -0,0 +1,108 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/simple_inclusion_projection.h"
+
+#include "mongo/db/json.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+BSONObj transform(const SimpleInclusionProjection& projection, const char* json) {
+    BSONObjBuilder bob;
+    projection.transform(fromjson(json), &bob);
+    return bob.obj();
+}
+
+TEST(SimpleInclusionProjectionTest, IncludesOnlyListedFields) {
+    SimpleInclusionProjection projection({"_id", "a", "c"});
+    ASSERT(projection.includes("_id"));
+    ASSERT(projection.includes("a"));
+    ASSERT(projection.includes("c"));
+    ASSERT_FALSE(projection.includes("b"));
+    ASSERT_FALSE(projection.includes(""));
+    ASSERT_FALSE(projection.includes("aa"));
+}
+
+TEST(SimpleInclusionProjectionTest, CopiesIncludedFieldsInDocumentOrder) {
+    SimpleInclusionProjection projection({"_id", "a", "c"});
+    ASSERT_BSONOBJ_EQ(fromjson("{_id: 1, a: 2, c: 4}"),
+                      transform(projection, "{_id: 1, a: 2, b: 3, c: 4, d: 5}"));
+    ASSERT_BSONOBJ_EQ(fromjson("{c: {x: [1, 2]}, a: 'str', _id: 1}"),
+                      transform(projection, "{b: 0, c: {x: [1, 2]}, a: 'str', d: 1, _id: 1}"));
+    ASSERT_BSONOBJ_EQ(fromjson("{a: 1, a: 2}"), transform(projection, "{a: 1, b: 1, a: 2}"));
+    ASSERT_BSONOBJ_EQ(BSONObj(), transform(projection, "{b: 1, d: 2}"));
+    ASSERT_BSONOBJ_EQ(BSONObj(), transform(projection, "{}"));
+}
+
+TEST(SimpleInclusionProjectionTest, AppendsAfterExistingFields) {
+    SimpleInclusionProjection projection({"a", "b"});
+    BSONObjBuilder bob;
+    bob.append("x", 1);
+    projection.transform(fromjson("{a: 1, b: 2, c: 3}"), &bob);
+    bob.append("y", 2);
+    ASSERT_BSONOBJ_EQ(fromjson("{x: 1, a: 1, b: 2, y: 2}"), bob.obj());
+}
+
+TEST(SimpleInclusionProjectionTest, EmptyProjectionIncludesNothing) {
+    SimpleInclusionProjection projection({});
+    ASSERT_FALSE(projection.includes("a"));
+    ASSERT_BSONOBJ_EQ(BSONObj(), transform(projection, "{a: 1, b: 2}"));
+}
+
+TEST(SimpleInclusionProjectionTest, ManyFields) {
+    std::vector<std::string> names;
+    for (int i = 0; i < 200; i += 2) {
+        names.push_back(str::stream() << "field" << i);
+    }
+    std::vector<StringData> fieldNames(names.begin(), names.end());
+    SimpleInclusionProjection projection(fieldNames);
+    ASSERT(projection.isCollisionFree());
+
+    BSONObjBuilder input;
+    BSONObjBuilder expected;
+    for (int i = 0; i < 200; i++) {
+        std::string name = str::stream() << "field" << i;
+        ASSERT_EQ(i % 2 == 0, projection.includes(name)) << name;
+        input.append(name, i);
+        if (i % 2 == 0) {
+            expected.append(name, i);
+        }
+    }
+
+    BSONObjBuilder bob;
+    projection.transform(input.obj(), &bob);
+    ASSERT_BSONOBJ_EQ(expected.obj(), bob.obj());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -31,6 +31,7 @@
 #include "mongo/db/exec/sort.h"
 
 #include <algorithm>
+#include <cstring>
 
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/exec/scoped_timer.h"
@@ -41,6 +42,7 @@
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
+#include "mongo/db/storage/storage_options.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 
@@ -54,12 +56,35 @@ using stdx::make_unique;
 // static
 const char* SortStage::kStageType = "SORT";
 
-SortStage::WorkingSetComparator::WorkingSetComparator(BSONObj p) : pattern(p) {}
+namespace {
+
+// Ordering::make() refuses patterns with more fields than it has bits for.
+const int kMaxOrderingFields = 32;
+
+int compareBytes(const char* lhs, size_t lhsSize, const char* rhs, size_t rhsSize) {
+    int result = memcmp(lhs, rhs, std::min(lhsSize, rhsSize));
+    if (result != 0) {
+        return result;
+    }
+    return lhsSize < rhsSize ? -1 : (lhsSize > rhsSize ? 1 : 0);
+}
+
+}  // namespace
+
+SortStage::WorkingSetComparator::WorkingSetComparator(BSONObj p)
+    : pattern(p),
+      useKeyStrings(p.nFields() <= kMaxOrderingFields),
+      ordering(useKeyStrings ? Ordering::make(p) : Ordering::make(BSONObj())) {}
 
 bool SortStage::WorkingSetComparator::operator()(const SortableDataItem& lhs,
                                                  const SortableDataItem& rhs) const {
     // False means ignore field names.
-    int result = lhs.sortKey.woCompare(rhs.sortKey, pattern, false);
+    int result = useKeyStrings
+        ? compareBytes(lhs.sortKeyString.data(),
+                       lhs.sortKeyString.size(),
+                       rhs.sortKeyString.data(),
+                       rhs.sortKeyString.size())
+        : lhs.sortKey.woCompare(rhs.sortKey, pattern, false);
     if (0 != result) {
         return result < 0;
     }
@@ -67,6 +92,28 @@ bool SortStage::WorkingSetComparator::operator()(const SortableDataItem& lhs,
     return lhs.recordId < rhs.recordId;
 }
 
+int SortStage::SpillComparator::operator()(const std::pair<BSONObj, BSONObj>& lhs,
+                                           const std::pair<BSONObj, BSONObj>& rhs) const {
+    int result;
+    if (useKeyStrings) {
+        int lhsSize;
+        int rhsSize;
+        const char* lhsData = lhs.first.firstElement().binData(lhsSize);
+        const char* rhsData = rhs.first.firstElement().binData(rhsSize);
+        result = compareBytes(lhsData, lhsSize, rhsData, rhsSize);
+    } else {
+        // False means ignore field names.
+        result = lhs.first.woCompare(rhs.first, pattern, false);
+    }
+    if (0 != result) {
+        return result;
+    }
+    // Break ties on RecordId, which is always the first field of the spilled value.
+    const long long lhsId = lhs.second.firstElement().numberLong();
+    const long long rhsId = rhs.second.firstElement().numberLong();
+    return lhsId < rhsId ? -1 : (lhsId > rhsId ? 1 : 0);
+}
+
 SortStage::SortStage(OperationContext* opCtx,
                      const SortStageParams& params,
                      WorkingSet* ws,
@@ -76,9 +123,12 @@ SortStage::SortStage(OperationContext* opCtx,
       _ws(ws),
       _pattern(params.pattern),
       _limit(params.limit),
+      _allowDiskUse(params.allowDiskUse),
       _sorted(false),
       _resultIterator(_data.end()),
-      _memUsage(0) {
+      _sortKeyStringBuilder(KeyString::Version::V1),
+      _memUsage(0),
+      _memoryReservation(opCtx) {
     _children.emplace_back(child);
 
     BSONObj sortComparator = FindCommon::transformSortSpec(_pattern);
@@ -97,12 +147,17 @@ SortStage::~SortStage() {}
 bool SortStage::isEOF() {
     // We're done when our child has no more results, we've sorted the child's results, and
     // we've returned all sorted results.
-    return child()->isEOF() && _sorted && (_data.end() == _resultIterator);
+    if (!child()->isEOF() || !_sorted) {
+        return false;
+    }
+    return _spillIterator ? !_spillIterator->more() : (_data.end() == _resultIterator);
 }
 
 PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
     const size_t maxBytes = static_cast<size_t>(internalQueryExecMaxBlockingSortBytes.load());
-    if (_memUsage > maxBytes) {
+    if (_memUsage > maxBytes && _allowDiskUse && !_sorted) {
+        spillToSorter();
+    } else if (_memUsage > maxBytes) {
         mongoutils::str::stream ss;
         ss << "Sort operation used more than the maximum " << maxBytes
            << " bytes of RAM. Add an index, or specify a smaller limit.";
@@ -111,6 +166,27 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
         return PlanStage::FAILURE;
     }
 
+    if (!_sorted && !_memoryReservation.tryResize(memoryInUse())) {
+        // The process is short of query memory, so spill early if we may, or else wait for other
+        // operations to release some.
+        if (_allowDiskUse) {
+            if (_memUsage > 0) {
+                if (!_spillSorter) {
+                    QueryMemoryBudget::recordSpill();
+                }
+                spillToSorter();
+            }
+            _memoryReservation.resize(memoryInUse());
+        } else {
+            try {
+                _memoryReservation.resizeOrWait(memoryInUse(), "Sort");
+            } catch (const DBException& ex) {
+                *out = WorkingSetCommon::allocateStatusMember(_ws, ex.toStatus());
+                return PlanStage::FAILURE;
+            }
+        }
+    }
+
     if (isEOF()) {
         return PlanStage::IS_EOF;
     }
@@ -142,6 +218,11 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
             auto sortKeyComputedData =
                 static_cast<const SortKeyComputedData*>(member->getComputed(WSM_SORT_KEY));
             item.sortKey = sortKeyComputedData->getSortKey();
+            if (_sortKeyComparator->useKeyStrings) {
+                _sortKeyStringBuilder.resetToKey(item.sortKey, _sortKeyComparator->ordering);
+                item.sortKeyString.assign(_sortKeyStringBuilder.getBuffer(),
+                                          _sortKeyStringBuilder.getSize());
+            }
 
             if (member->hasRecordId()) {
                 // The RecordId breaks ties when sorting two WSMs with the same sort key.
@@ -154,7 +235,13 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
         } else if (PlanStage::IS_EOF == code) {
             // TODO: We don't need the lock for this.  We could ask for a yield and do this work
             // unlocked.  Also, this is performing a lot of work for one call to work(...)
-            sortBuffer();
+            if (_spillSorter) {
+                spillToSorter();
+                _spillIterator.reset(_spillSorter->done());
+                _spillSorter.reset();
+            } else {
+                sortBuffer();
+            }
             _resultIterator = _data.begin();
             _sorted = true;
             return PlanStage::NEED_TIME;
@@ -178,8 +265,13 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
     }
 
     // Returning results.
-    verify(_resultIterator != _data.end());
     verify(_sorted);
+    if (_spillIterator) {
+        *out = nextFromSorter();
+        return PlanStage::ADVANCED;
+    }
+
+    verify(_resultIterator != _data.end());
     *out = _resultIterator->wsid;
     _resultIterator++;
 
@@ -256,6 +348,11 @@ const SpecificStats* SortStage::getSpecificStats() const {
  *     sortBuffer() - Copies items from set to vectors.
  */
 void SortStage::addToBuffer(const SortableDataItem& item) {
+    if (_spillSorter) {
+        addToSorter(item);
+        return;
+    }
+
     // Holds ID of working set member to be freed at end of this function.
     WorkingSetID wsidToFree = WorkingSet::INVALID_ID;
 
@@ -264,12 +361,12 @@ void SortStage::addToBuffer(const SortableDataItem& item) {
         // Ensure that the BSONObj underlying the WorkingSetMember is owned in case we yield.
         member->makeObjOwnedIfNeeded();
         _data.push_back(item);
-        _memUsage += member->getMemUsage();
+        _memUsage += member->getMemUsage() + item.sortKeyString.size();
     } else if (_limit == 1) {
         if (_data.empty()) {
             member->makeObjOwnedIfNeeded();
             _data.push_back(item);
-            _memUsage = member->getMemUsage();
+            _memUsage = member->getMemUsage() + item.sortKeyString.size();
             return;
         }
         wsidToFree = item.wsid;
@@ -279,7 +376,7 @@ void SortStage::addToBuffer(const SortableDataItem& item) {
             wsidToFree = _data[0].wsid;
             member->makeObjOwnedIfNeeded();
             _data[0] = item;
-            _memUsage = member->getMemUsage();
+            _memUsage = member->getMemUsage() + item.sortKeyString.size();
         }
     } else {
         // Update data item set instead of vector
@@ -288,7 +385,7 @@ void SortStage::addToBuffer(const SortableDataItem& item) {
         if (_dataSet->size() < limit) {
             member->makeObjOwnedIfNeeded();
             _dataSet->insert(item);
-            _memUsage += member->getMemUsage();
+            _memUsage += member->getMemUsage() + item.sortKeyString.size();
             return;
         }
         // Limit will be exceeded - compare with item with lowest key
@@ -299,8 +396,8 @@ void SortStage::addToBuffer(const SortableDataItem& item) {
         const SortableDataItem& lastItem = *lastItemIt;
         const WorkingSetComparator& cmp = *_sortKeyComparator;
         if (cmp(item, lastItem)) {
-            _memUsage -= _ws->get(lastItem.wsid)->getMemUsage();
-            _memUsage += member->getMemUsage();
+            _memUsage -= _ws->get(lastItem.wsid)->getMemUsage() + lastItem.sortKeyString.size();
+            _memUsage += member->getMemUsage() + item.sortKeyString.size();
             wsidToFree = lastItem.wsid;
             // According to std::set iterator validity rules,
             // it does not matter which of erase()/insert() happens first.
@@ -340,4 +437,87 @@ void SortStage::sortBuffer() {
     }
 }
 
+size_t SortStage::memoryInUse() const {
+    return _memUsage + (_spillSorter ? _spillSorter->memUsed() : 0);
+}
+
+void SortStage::doDetachFromOperationContext() {
+    _memoryReservation.detachFromOperationContext();
+}
+
+void SortStage::doReattachToOperationContext() {
+    _memoryReservation.reattachToOperationContext(getOpCtx());
+}
+
+void SortStage::spillToSorter() {
+    if (!_spillSorter) {
+        SortOptions opts;
+        opts.limit = _limit;
+        opts.maxMemoryUsageBytes =
+            static_cast<size_t>(internalQueryExecMaxBlockingSortBytes.load());
+        opts.extSortAllowed = true;
+        opts.tempDir = storageGlobalParams.dbpath + "/_tmp";
+        _spillSorter.reset(SpillSorter::make(opts, SpillComparator(*_sortKeyComparator)));
+        _specificStats.usedDisk = true;
+    }
+
+    if (_dataSet) {
+        for (auto&& item : *_dataSet) {
+            addToSorter(item);
+        }
+        _dataSet->clear();
+    }
+    for (auto&& item : _data) {
+        addToSorter(item);
+    }
+    _data.clear();
+    _memUsage = 0;
+}
+
+void SortStage::addToSorter(const SortableDataItem& item) {
+    WorkingSetMember* member = _ws->get(item.wsid);
+
+    BSONObjBuilder spilled;
+    spilled.append("r", static_cast<long long>(item.recordId.repr()));
+    spilled.append("o", member->obj.value());
+    if (member->hasComputed(WSM_COMPUTED_TEXT_SCORE)) {
+        auto score = static_cast<const TextScoreComputedData*>(
+            member->getComputed(WSM_COMPUTED_TEXT_SCORE));
+        spilled.append("s", score->getScore());
+    }
+    if (_sortKeyComparator->useKeyStrings) {
+        spilled.append("k", item.sortKey);
+        BSONObjBuilder spilledKey;
+        spilledKey.appendBinData(
+            "", item.sortKeyString.size(), BinDataGeneral, item.sortKeyString.data());
+        _spillSorter->add(spilledKey.obj(), spilled.obj());
+    } else {
+        _spillSorter->add(item.sortKey, spilled.obj());
+    }
+
+    if (member->hasRecordId()) {
+        _wsidByRecordId.erase(member->recordId);
+    }
+    _ws->free(item.wsid);
+}
+
+WorkingSetID SortStage::nextFromSorter() {
+    auto next = _spillIterator->next();
+    BSONObj spilled = next.second.getOwned();
+
+    WorkingSetID id = _ws->allocate();
+    WorkingSetMember* member = _ws->get(id);
+    member->obj = Snapshotted<BSONObj>(SnapshotId(), spilled["o"].Obj().getOwned());
+    member->addComputed(new SortKeyComputedData(
+        _sortKeyComparator->useKeyStrings ? spilled["k"].Obj().getOwned() : next.first));
+    if (BSONElement score = spilled["s"]) {
+        member->addComputed(new TextScoreComputedData(score.numberDouble()));
+    }
+    _ws->transitionToOwnedObj(id);
+    return id;
+}
+
 }  // namespace mongo
+
+#include "mongo/db/sorter/sorter.cpp"
+// Explicit instantiation unneeded since we aren't exposing Sorter outside of this file.
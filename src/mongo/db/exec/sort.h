@@ -29,6 +29,7 @@
 #pragma once
 
 #include <set>
+#include <string>
 #include <vector>
 
 #include "mongo/db/exec/plan_stage.h"
@@ -36,7 +37,10 @@
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/query/index_bounds.h"
+#include "mongo/db/query/query_memory_budget.h"
 #include "mongo/db/record_id.h"
+#include "mongo/db/sorter/sorter.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/platform/unordered_map.h"
 
 namespace mongo {
@@ -46,7 +50,7 @@ class BtreeKeyGenerator;
 // Parameters that must be provided to a SortStage
 class SortStageParams {
 public:
-    SortStageParams() : collection(NULL), limit(0) {}
+    SortStageParams() : collection(NULL), limit(0), allowDiskUse(false) {}
 
     // Used for resolving RecordIds to BSON
     const Collection* collection;
@@ -56,6 +60,10 @@ public:
 
     // Equal to 0 for no limit.
     size_t limit;
+
+    // If true, buffered results are spilled to disk once the memory limit is exceeded instead of
+    // failing the query.
+    bool allowDiskUse;
 };
 
 /**
@@ -78,6 +86,8 @@ public:
     StageState doWork(WorkingSetID* out) final;
 
     void doInvalidate(OperationContext* opCtx, const RecordId& dl, InvalidationType type) final;
+    void doDetachFromOperationContext() final;
+    void doReattachToOperationContext() final;
 
     StageType stageType() const final {
         return STAGE_SORT;
@@ -106,6 +116,8 @@ private:
     // Equal to 0 for no limit.
     size_t _limit;
 
+    bool _allowDiskUse;
+
     //
     // Data storage
     //
@@ -118,6 +130,10 @@ private:
     struct SortableDataItem {
         WorkingSetID wsid;
         BSONObj sortKey;
+        // The KeyString encoding of 'sortKey' under the sort pattern's Ordering, which compares
+        // with memcmp in the same order as 'sortKey' does with BSONObj::woCompare(). Empty if the
+        // comparator isn't using KeyStrings.
+        std::string sortKeyString;
         // Since we must replicate the behavior of a covered sort as much as possible we use the
         // RecordId to break sortKey ties.
         // See sorta.js.
@@ -125,8 +141,9 @@ private:
     };
 
     // Comparison object for data buffers (vector and set). Items are compared on (sortKey, loc).
-    // This is also how the items are ordered in the indices. Keys are compared using
-    // BSONObj::woCompare() with RecordId as a tie-breaker.
+    // This is also how the items are ordered in the indices. Keys are compared by their KeyString
+    // encodings, or using BSONObj::woCompare() if the pattern is too long for an Ordering, with
+    // RecordId as a tie-breaker.
     //
     // We are comparing keys generated by the SortKeyGenerator, which are already ordered with
     // respect the collation. Therefore, we explicitly avoid comparing using a collator here.
@@ -136,6 +153,14 @@ private:
         bool operator()(const SortableDataItem& lhs, const SortableDataItem& rhs) const;
 
         BSONObj pattern;
+
+        // Whether items carry a 'sortKeyString' to compare on. This is the case unless the pattern
+        // has more fields than an Ordering can describe.
+        bool useKeyStrings;
+
+        // The sort directions of 'pattern', used to encode sort keys. Only valid if
+        // 'useKeyStrings' is true.
+        Ordering ordering;
     };
 
     /**
@@ -152,6 +177,28 @@ private:
      */
     void sortBuffer();
 
+    /**
+     * Moves every buffered item into the external sorter and frees its working set member. Once
+     * this has been called, all subsequent input goes directly to the external sorter.
+     */
+    void spillToSorter();
+
+    /**
+     * Serializes the data item and its working set member into the external sorter and frees
+     * the member.
+     */
+    void addToSorter(const SortableDataItem& item);
+
+    /**
+     * Materializes the next result of the external sort as a new owned-object working set member.
+     */
+    WorkingSetID nextFromSorter();
+
+    /**
+     * Returns the bytes held in memory by this stage, including the buffers of the external sorter.
+     */
+    size_t memoryInUse() const;
+
     // Comparator for data buffer
     // Initialization follows sort key generator
     std::unique_ptr<WorkingSetComparator> _sortKeyComparator;
@@ -174,10 +221,37 @@ private:
     typedef unordered_map<RecordId, WorkingSetID, RecordId::Hasher> DataMap;
     DataMap _wsidByRecordId;
 
+    // Once the memory limit has been exceeded with 'allowDiskUse' set, items are serialized as
+    // (sort key, {r: <RecordId>, o: <document>, s: <text score>, k: <sort key>}) pairs and sorted
+    // externally. When the comparator uses KeyStrings, the key spilled is {"": BinData} holding
+    // the item's 'sortKeyString' and the original sort key is carried in 'k'; otherwise the sort
+    // key itself is spilled and 'k' is omitted. Spilled items are returned as owned objects with
+    // no RecordId, just as if they had been invalidated.
+    struct SpillComparator {
+        explicit SpillComparator(const WorkingSetComparator& cmp)
+            : pattern(cmp.pattern), useKeyStrings(cmp.useKeyStrings) {}
+
+        int operator()(const std::pair<BSONObj, BSONObj>& lhs,
+                       const std::pair<BSONObj, BSONObj>& rhs) const;
+
+        BSONObj pattern;
+        bool useKeyStrings;
+    };
+
+    typedef Sorter<BSONObj, BSONObj> SpillSorter;
+    std::unique_ptr<SpillSorter> _spillSorter;
+    std::unique_ptr<SpillSorter::Iterator> _spillIterator;
+
     SortStats _specificStats;
 
+    // Scratch space for encoding each item's 'sortKeyString'.
+    KeyString _sortKeyStringBuilder;
+
     // The usage in bytes of all buffered data that we're sorting.
     size_t _memUsage;
+
+    // Our share of the process-wide query memory budget, which covers memoryInUse().
+    QueryMemoryBudget::Reservation _memoryReservation;
 };
 
 }  // namespace mongo
@@ -44,6 +44,7 @@
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/clock_source_mock.h"
+#include "mongo/util/mongoutils/str.h"
 
 using namespace mongo;
 
@@ -240,6 +241,44 @@ TEST_F(SortStageTest, SortIrrelevantSortKey) {
              "{output: [{a: 2}, {a: 1}, {a: 3}]}");
 }
 
+TEST_F(SortStageTest, SortCompoundMixedDirections) {
+    testWork("{a: 1, b: -1}",
+             nullptr,
+             "{}",
+             0,
+             "{input: [{a: 2, b: 1}, {a: 1, b: 1}, {a: 2, b: 2}, {a: 1, b: 3}]}",
+             "{output: [{a: 1, b: 3}, {a: 1, b: 1}, {a: 2, b: 2}, {a: 2, b: 1}]}");
+}
+
+TEST_F(SortStageTest, SortMixedTypes) {
+    testWork("{a: 1}",
+             nullptr,
+             "{}",
+             0,
+             "{input: [{a: 'x'}, {a: 2.5}, {a: null}, {a: {$numberLong: '1'}}, {a: {b: 1}}, "
+             "{a: ''}, {a: -1}]}",
+             "{output: [{a: null}, {a: -1}, {a: {$numberLong: '1'}}, {a: 2.5}, {a: ''}, {a: 'x'}, "
+             "{a: {b: 1}}]}");
+}
+
+TEST_F(SortStageTest, SortPatternWithMoreFieldsThanOrderingSupports) {
+    // Sort on 33 fields where only the descending last one differs between documents.
+    str::stream pattern;
+    str::stream prefix;
+    pattern << "{";
+    for (int i = 0; i < 32; ++i) {
+        pattern << "f" << i << ": 1, ";
+        prefix << "f" << i << ": 0, ";
+    }
+    pattern << "last: -1}";
+    const std::string p = prefix;
+    const std::string input = str::stream() << "{input: [{" << p << "last: 1}, {" << p
+                                            << "last: 3}, {" << p << "last: 2}]}";
+    const std::string output = str::stream() << "{output: [{" << p << "last: 3}, {" << p
+                                              << "last: 2}, {" << p << "last: 1}]}";
+    testWork(std::string(pattern).c_str(), nullptr, "{}", 0, input.c_str(), output.c_str());
+}
+
 //
 // Sorting with limit > 1
 // Implementation should retain top N items
@@ -64,12 +64,14 @@ SubplanStage::SubplanStage(OperationContext* opCtx,
                            Collection* collection,
                            WorkingSet* ws,
                            const QueryPlannerParams& params,
-                           CanonicalQuery* cq)
+                           CanonicalQuery* cq,
+                           CachingMode cachingMode)
     : PlanStage(kStageType, opCtx),
       _collection(collection),
       _ws(ws),
       _plannerParams(params),
-      _query(cq) {
+      _query(cq),
+      _cachingMode(cachingMode) {
     invariant(_collection);
 }
 
@@ -204,7 +206,8 @@ Status SubplanStage::planSubqueries() {
         // Plan the i-th child. We might be able to find a plan for the i-th child in the plan
         // cache. If there's no cached plan, then we generate and rank plans using the MPS.
         CachedSolution* rawCS;
-        if (PlanCache::shouldCacheQuery(*branchResult->canonicalQuery) &&
+        if (_cachingMode == CachingMode::UseCache &&
+            PlanCache::shouldCacheQuery(*branchResult->canonicalQuery) &&
             _collection->infoCache()
                 ->getPlanCache()
                 ->get(*branchResult->canonicalQuery, &rawCS)
@@ -294,6 +297,9 @@ Status SubplanStage::choosePlanForSubqueries(PlanYieldPolicy* yieldPolicy) {
     // This is the skeleton of index selections that is inserted into the cache.
     std::unique_ptr<PlanCacheIndexTree> cacheData(new PlanCacheIndexTree());
 
+    // How many work cycles ranking the plans of the branches took, now or when they were cached.
+    size_t decisionWorks = 0;
+
     for (size_t i = 0; i < _orExpression->numChildren(); ++i) {
         MatchExpression* orChild = _orExpression->getChild(i);
         BranchPlanningResult* branchResult = _branchResults[i].get();
@@ -305,6 +311,7 @@ Status SubplanStage::choosePlanForSubqueries(PlanYieldPolicy* yieldPolicy) {
             if (!tagStatus.isOK()) {
                 return tagStatus;
             }
+            decisionWorks += branchResult->cachedSolution->decisionWorks;
         } else if (1 == branchResult->solutions.size()) {
             QuerySolution* soln = branchResult->solutions.front().get();
             Status tagStatus = tagOrChildAccordingToCache(
@@ -320,17 +327,20 @@ Status SubplanStage::choosePlanForSubqueries(PlanYieldPolicy* yieldPolicy) {
 
             _ws->clear();
 
-            // We pass the SometimesCache option to the MPS because the SubplanStage currently does
-            // not use the CachedPlanStage's eviction mechanism. We therefore are more conservative
-            // about putting a potentially bad plan into the cache in the subplan path.
+            // We pass the SometimesCache option to the MPS because the branch plans are cached as
+            // queries of their own, and no CachedPlanStage judges them when they are used as part
+            // of a composite solution. We therefore are more conservative about putting a
+            // potentially bad plan into the cache in the subplan path.
             // We temporarily add the MPS to _children to ensure that we pass down all
             // save/restore/invalidate messages that can be generated if pickBestPlan yields.
             invariant(_children.empty());
-            _children.emplace_back(
-                stdx::make_unique<MultiPlanStage>(getOpCtx(),
-                                                  _collection,
-                                                  branchResult->canonicalQuery.get(),
-                                                  MultiPlanStage::CachingMode::SometimesCache));
+            _children.emplace_back(stdx::make_unique<MultiPlanStage>(
+                getOpCtx(),
+                _collection,
+                branchResult->canonicalQuery.get(),
+                _cachingMode == CachingMode::NeverCache
+                    ? MultiPlanStage::CachingMode::NeverCache
+                    : MultiPlanStage::CachingMode::SometimesCache));
             ON_BLOCK_EXIT([&] {
                 invariant(_children.size() == 1);  // Make sure nothing else was added to _children.
                 _children.pop_back();
@@ -364,6 +374,8 @@ Status SubplanStage::choosePlanForSubqueries(PlanYieldPolicy* yieldPolicy) {
             }
 
             QuerySolution* bestSoln = multiPlanStage->bestSolution();
+            decisionWorks +=
+                multiPlanStage->getStats()->children[multiPlanStage->bestPlanIdx()]->common.works;
 
             // Check that we have good cache data. For example, we don't cache things
             // for 2d indices.
@@ -429,9 +441,39 @@ Status SubplanStage::choosePlanForSubqueries(PlanYieldPolicy* yieldPolicy) {
     invariant(_children.empty());
     _children.emplace_back(root);
 
+    // A composite solution which needed no plan ranking is cheap to recompute, and there would be
+    // nothing to judge its cached plan against.
+    if (_cachingMode != CachingMode::NeverCache && decisionWorks > 0 &&
+        PlanCache::shouldCacheQuery(*_query)) {
+        cacheCompositeSolution(std::move(cacheData), decisionWorks);
+    }
+
     return Status::OK();
 }
 
+void SubplanStage::cacheCompositeSolution(std::unique_ptr<PlanCacheIndexTree> cacheData,
+                                          size_t decisionWorks) {
+    // The index assignments of each branch, beneath the $or at the root of the query, are all
+    // QueryPlanner::planFromCache() needs to build the composite solution again.
+    auto solnCacheData = stdx::make_unique<SolutionCacheData>();
+    solnCacheData->tree = std::move(cacheData);
+    solnCacheData->solnType = SolutionCacheData::USE_INDEX_TAGS_SOLN;
+    solnCacheData->indexFilterApplied = _plannerParams.indexFiltersApplied;
+    _compositeSolution->cacheData = std::move(solnCacheData);
+
+    // The composite solution was never ranked against alternatives, so it is the sole candidate.
+    auto decision = stdx::make_unique<PlanRankingDecision>();
+    std::unique_ptr<PlanStageStats> stats = child()->getStats();
+    stats->common.works = decisionWorks;
+    decision->stats.push_back(std::move(stats));
+    decision->scores.push_back(0);
+    decision->candidateOrder.push_back(0);
+
+    LOG(5) << "Subplanner: caching composite solution for " << redact(_query->toStringShort());
+    _collection->infoCache()->getPlanCache()->add(
+        *_query, {_compositeSolution.get()}, decision.release());
+}
+
 Status SubplanStage::choosePlanWholeQuery(PlanYieldPolicy* yieldPolicy) {
     // Clear out the working set. We'll start with a fresh working set.
     _ws->clear();
@@ -471,7 +513,12 @@ Status SubplanStage::choosePlanWholeQuery(PlanYieldPolicy* yieldPolicy) {
         // Many solutions. Create a MultiPlanStage to pick the best, update the cache,
         // and so on. The working set will be shared by all candidate plans.
         invariant(_children.empty());
-        _children.emplace_back(new MultiPlanStage(getOpCtx(), _collection, _query));
+        _children.emplace_back(new MultiPlanStage(getOpCtx(),
+                                                  _collection,
+                                                  _query,
+                                                  _cachingMode == CachingMode::NeverCache
+                                                      ? MultiPlanStage::CachingMode::NeverCache
+                                                      : MultiPlanStage::CachingMode::AlwaysCache));
         MultiPlanStage* multiPlanStage = static_cast<MultiPlanStage*>(child().get());
 
         for (size_t ix = 0; ix < solutions.size(); ++ix) {
@@ -499,9 +546,9 @@ Status SubplanStage::choosePlanWholeQuery(PlanYieldPolicy* yieldPolicy) {
 }
 
 Status SubplanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
-    // Adds the amount of time taken by pickBestPlan() to executionTimeMillis. There's lots of
+    // Adds the amount of time taken by pickBestPlan() to executionTimeNanos. There's lots of
     // work that happens here, so this is needed for the time accounting to make sense.
-    ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
+    ScopedTimer timer(getTickSource(), &_commonStats.executionTimeNanos);
 
     // Plan each branch of the $or.
     Status subplanningStatus = planSubqueries();
@@ -65,15 +65,35 @@ class OperationContext;
  *   executions of C. These subsequent executions of shape C could be either as a clause in
  *   another rooted $or query, or shape C as its own query.
  *
- *   --Plans for entire rooted $or queries are neither written to nor read from the plan cache.
+ *   --The composite solution for the entire rooted $or query is also written to the plan cache,
+ *   so that later executions of the query can skip subplanning altogether. Like any other cache
+ *   entry, it is run by a CachedPlanStage, which evicts it and plans the query again through a
+ *   SubplanStage if it performs much worse than its planning suggested. A composite solution
+ *   whose clauses each had a single candidate plan is not cached, as it cost no plan ranking.
  */
 class SubplanStage final : public PlanStage {
 public:
+    /**
+     * Callers use this to specify how the SubplanStage should interact with the plan cache.
+     */
+    enum class CachingMode {
+        // Plan the clauses which have a cache entry from it, and cache the plans of the other
+        // clauses and the composite solution.
+        UseCache,
+
+        // Plan every clause from scratch, but cache the plans as if there were no cache entries.
+        Replan,
+
+        // Plan every clause from scratch and do not write to the plan cache.
+        NeverCache,
+    };
+
     SubplanStage(OperationContext* opCtx,
                  Collection* collection,
                  WorkingSet* ws,
                  const QueryPlannerParams& params,
-                 CanonicalQuery* cq);
+                 CanonicalQuery* cq,
+                 CachingMode cachingMode = CachingMode::UseCache);
 
     static bool canUseSubplanning(const CanonicalQuery& query);
 
@@ -184,6 +204,14 @@ private:
      */
     Status choosePlanWholeQuery(PlanYieldPolicy* yieldPolicy);
 
+    /**
+     * Writes '_compositeSolution', whose index assignments are 'cacheData', to the plan cache.
+     * 'decisionWorks' is how many work cycles choosing the plans of the clauses took; a
+     * CachedPlanStage running the cached plan judges it against this.
+     */
+    void cacheCompositeSolution(std::unique_ptr<PlanCacheIndexTree> cacheData,
+                                size_t decisionWorks);
+
     // Not owned here. Must be non-null.
     Collection* _collection;
 
@@ -195,6 +223,8 @@ private:
     // Not owned here.
     CanonicalQuery* _query;
 
+    const CachingMode _cachingMode;
+
     // The copy of the query that we will annotate with tags and use to construct the composite
     // solution. Must be a rooted $or query, or a contained $or that has been rewritten to a
     // rooted $or.
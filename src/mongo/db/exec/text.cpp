@@ -95,7 +95,15 @@ const SpecificStats* TextStage::getSpecificStats() const {
 unique_ptr<PlanStage> TextStage::buildTextTree(OperationContext* opCtx,
                                                WorkingSet* ws,
                                                const MatchExpression* filter) const {
-    auto textScorer = make_unique<TextOrStage>(opCtx, _params.spec, ws, filter, _params.index);
+    // The TEXT_OR stage can only drop documents scoring below the top 'limit' if every document it
+    // returns is also passed on by the TEXT_MATCH stage. That is the case when the query has no
+    // negations or phrases, and the index lookup alone decides which documents contain a term.
+    const FTSQueryImpl& query = _params.query;
+    const bool canLimit = query.getNegatedTerms().empty() && query.getPositivePhr().empty() &&
+        query.getNegatedPhr().empty() && !query.getCaseSensitive() &&
+        !query.getDiacriticSensitive();
+    auto textScorer = make_unique<TextOrStage>(
+        opCtx, _params.spec, ws, filter, _params.index, canLimit ? _params.limit : 0);
 
     // Get all the index scans for each term in our query.
     for (const auto& term : _params.query.getTermsForBounds()) {
@@ -110,7 +118,7 @@ unique_ptr<PlanStage> TextStage::buildTextTree(OperationContext* opCtx,
         ixparams.descriptor = _params.index;
         ixparams.direction = -1;
 
-        textScorer->addChild(make_unique<IndexScan>(opCtx, ixparams, ws, nullptr));
+        textScorer->addChild(make_unique<IndexScan>(opCtx, ixparams, ws, nullptr), term);
     }
 
     auto matcher =
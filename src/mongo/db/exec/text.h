@@ -62,6 +62,9 @@ struct TextStageParams {
 
     // The text query.
     FTSQueryImpl query;
+
+    // If nonzero, only the 'limit' highest scoring documents need to be returned.
+    size_t limit = 0;
 };
 
 /**
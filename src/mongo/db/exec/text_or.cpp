@@ -28,6 +28,8 @@
 
 #include "mongo/db/exec/text_or.h"
 
+#include <algorithm>
+#include <functional>
 #include <map>
 #include <vector>
 
@@ -51,6 +53,8 @@ using std::string;
 using stdx::make_unique;
 
 using fts::FTSSpec;
+using fts::MAX_WEIGHT;
+using fts::TermFrequencyMap;
 
 const char* TextOrStage::kStageType = "TEXT_OR";
 
@@ -58,10 +62,12 @@ TextOrStage::TextOrStage(OperationContext* opCtx,
                          const FTSSpec& ftsSpec,
                          WorkingSet* ws,
                          const MatchExpression* filter,
-                         IndexDescriptor* index)
+                         IndexDescriptor* index,
+                         size_t limit)
     : PlanStage(kStageType, opCtx),
       _ftsSpec(ftsSpec),
       _ws(ws),
+      _limit(limit),
       _scoreIterator(_scores.end()),
       _filter(filter),
       _idRetrying(WorkingSet::INVALID_ID),
@@ -69,8 +75,9 @@ TextOrStage::TextOrStage(OperationContext* opCtx,
 
 TextOrStage::~TextOrStage() {}
 
-void TextOrStage::addChild(unique_ptr<PlanStage> child) {
+void TextOrStage::addChild(unique_ptr<PlanStage> child, std::string term) {
     _children.push_back(std::move(child));
+    _terms.push_back(std::move(term));
 }
 
 bool TextOrStage::isEOF() {
@@ -103,6 +110,16 @@ void TextOrStage::doInvalidate(OperationContext* opCtx, const RecordId& dl, Inva
     // Remove the RecordID from the ScoreMap.
     ScoreMap::iterator scoreIt = _scores.find(dl);
     if (scoreIt != _scores.end()) {
+        if (_limit && scoreIt->second.wsid != WorkingSet::INVALID_ID) {
+            // Also remove it from the top-k documents.
+            auto topKIt = std::find_if(_topK.begin(), _topK.end(), [&](const ScoredRecord& r) {
+                return r.second == dl;
+            });
+            if (topKIt != _topK.end()) {
+                _topK.erase(topKIt);
+                std::make_heap(_topK.begin(), _topK.end(), std::greater<ScoredRecord>());
+            }
+        }
         if (scoreIt == _scoreIterator) {
             _scoreIterator++;
         }
@@ -163,6 +180,9 @@ PlanStage::StageState TextOrStage::initStage(WorkingSetID* out) {
     *out = WorkingSet::INVALID_ID;
     try {
         _recordCursor = _index->getCollection()->getCursor(getOpCtx());
+        if (_limit) {
+            _childScoreBounds.assign(_children.size(), MAX_WEIGHT);
+        }
         _internalState = State::kReadingTerms;
         return PlanStage::NEED_TIME;
     } catch (const WriteConflictException& wce) {
@@ -192,8 +212,20 @@ PlanStage::StageState TextOrStage::readFromChildren(WorkingSetID* out) {
     }
 
     if (PlanStage::ADVANCED == childState) {
-        return addTerm(id, out);
+        StageState addTermState = addTerm(id, out);
+        if (!_limit || _idRetrying != WorkingSet::INVALID_ID) {
+            return addTermState;
+        }
+
+        // In top-k mode, move on to the next child after every index entry.
+        invariant(PlanStage::NEED_TIME == addTermState);
+        return nextTopKChild();
     } else if (PlanStage::IS_EOF == childState) {
+        if (_limit) {
+            _childScoreBounds[_currentChild] = 0;
+            return nextTopKChild();
+        }
+
         // Done with this child.
         ++_currentChild;
 
@@ -227,6 +259,78 @@ PlanStage::StageState TextOrStage::readFromChildren(WorkingSetID* out) {
     }
 }
 
+PlanStage::StageState TextOrStage::nextTopKChild() {
+    if (!topKComplete()) {
+        for (size_t i = 1; i <= _children.size(); ++i) {
+            size_t child = (_currentChild + i) % _children.size();
+            if (!_children[child]->isEOF()) {
+                _currentChild = child;
+                return PlanStage::NEED_TIME;
+            }
+        }
+    }
+
+    // Either no unread index entry can change the result, or there are none left.
+    _scoreIterator = _scores.begin();
+    _internalState = State::kReturningResults;
+    return PlanStage::NEED_TIME;
+}
+
+bool TextOrStage::topKComplete() const {
+    if (_topK.size() < _limit) {
+        return false;
+    }
+
+    // A document that hasn't been seen yet scores at most the sum of the last scores read from
+    // every child. Summing the bounds in the same order as the terms of a document's score
+    // ensures that rounding can't make the bound smaller than such a score.
+    double bound = 0;
+    for (double childScoreBound : _childScoreBounds) {
+        bound += childScoreBound;
+    }
+    return _topK.front().first >= bound;
+}
+
+double TextOrStage::scoreFetchedDocument(WorkingSetMember* wsm, double keyScore) const {
+    if (_terms.size() == 1) {
+        // The index entry holds the full score.
+        return keyScore;
+    }
+
+    TermFrequencyMap termFrequencies;
+    _ftsSpec.scoreDocument(wsm->obj.value(), &termFrequencies);
+
+    // Add up the term scores in the same order as reading every child would.
+    double score = 0;
+    for (auto&& term : _terms) {
+        auto it = termFrequencies.find(term);
+        if (it != termFrequencies.end()) {
+            score += it->second;
+        }
+    }
+    return score;
+}
+
+bool TextOrStage::addToTopK(const RecordId& recordId, double score) {
+    if (_topK.size() == _limit) {
+        if (score <= _topK.front().first) {
+            return false;
+        }
+
+        std::pop_heap(_topK.begin(), _topK.end(), std::greater<ScoredRecord>());
+        ScoreMap::iterator displaced = _scores.find(_topK.back().second);
+        invariant(displaced != _scores.end());
+        _ws->free(displaced->second.wsid);
+        displaced->second.wsid = WorkingSet::INVALID_ID;
+        displaced->second.score = -1;
+        _topK.pop_back();
+    }
+
+    _topK.emplace_back(score, recordId);
+    std::push_heap(_topK.begin(), _topK.end(), std::greater<ScoredRecord>());
+    return true;
+}
+
 PlanStage::StageState TextOrStage::returnResults(WorkingSetID* out) {
     if (_scoreIterator == _scores.end()) {
         _internalState = State::kDone;
@@ -333,6 +437,22 @@ PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out)
     const IndexKeyDatum newKeyData = wsm->keyData.back();  // copy to keep it around.
     TextRecordData* textRecordData = &_scores[wsm->recordId];
 
+    // Locate score within possibly compound key: {prefix,term,score,suffix}.
+    BSONObjIterator keyIt(newKeyData.keyData());
+    for (unsigned i = 0; i < _ftsSpec.numExtraBefore(); i++) {
+        keyIt.next();
+    }
+
+    keyIt.next();  // Skip past 'term'.
+
+    BSONElement scoreElement = keyIt.next();
+    double documentTermScore = scoreElement.number();
+
+    if (_limit) {
+        // The child scans in order of descending score.
+        _childScoreBounds[_currentChild] = documentTermScore;
+    }
+
     if (textRecordData->score < 0) {
         // We have already rejected this document for not matching the filter.
         invariant(WorkingSet::INVALID_ID == textRecordData->wsid);
@@ -350,7 +470,7 @@ PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out)
             try {
                 TextMatchableDocument tdoc(getOpCtx(),
                                            newKeyData.indexKeyPattern,
-                                           newKeyData.keyData,
+                                           newKeyData.keyData(),
                                            _ws,
                                            wsid,
                                            _recordCursor);
@@ -394,6 +514,17 @@ PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out)
             return NEED_TIME;
         }
 
+        if (_limit) {
+            const double score = scoreFetchedDocument(wsm, documentTermScore);
+            if (!addToTopK(wsm->recordId, score)) {
+                // Any other index entries for this document can be skipped as well.
+                _ws->free(wsid);
+                textRecordData->score = -1;
+                return NEED_TIME;
+            }
+            textRecordData->score = score;
+        }
+
         textRecordData->wsid = wsid;
 
         // Ensure that the BSONObj underlying the WorkingSetMember is owned in case we yield.
@@ -408,17 +539,11 @@ PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out)
         wsm = _ws->get(textRecordData->wsid);
     }
 
-    // Locate score within possibly compound key: {prefix,term,score,suffix}.
-    BSONObjIterator keyIt(newKeyData.keyData);
-    for (unsigned i = 0; i < _ftsSpec.numExtraBefore(); i++) {
-        keyIt.next();
+    if (_limit) {
+        // The full score was computed when the document was first seen.
+        return NEED_TIME;
     }
 
-    keyIt.next();  // Skip past 'term'.
-
-    BSONElement scoreElement = keyIt.next();
-    double documentTermScore = scoreElement.number();
-
     // Aggregate relevance score, term keys.
     textRecordData->score += documentTermScore;
     return NEED_TIME;
@@ -51,6 +51,13 @@ class OperationContext;
  * A blocking stage that returns the set of WSMs with RecordIDs of all of the documents that contain
  * the positive terms in the search query, as well as their scores.
  *
+ * If constructed with a nonzero 'limit', the stage only returns the 'limit' highest scoring
+ * documents. The children, which scan each term in order of descending score, are then read in
+ * turn, and the full score of a document is computed from the document itself when it is first
+ * seen. The sum of the scores last read from each child bounds the score of any document not seen
+ * yet, so reading stops as soon as 'limit' documents score at least that much (the threshold
+ * algorithm of Fagin, Lotem and Naor).
+ *
  * The WorkingSetMembers returned are fetched and in the LOC_AND_OBJ state.
  */
 class TextOrStage final : public PlanStage {
@@ -76,10 +83,14 @@ public:
                 const FTSSpec& ftsSpec,
                 WorkingSet* ws,
                 const MatchExpression* filter,
-                IndexDescriptor* index);
+                IndexDescriptor* index,
+                size_t limit = 0);
     ~TextOrStage();
 
-    void addChild(unique_ptr<PlanStage> child);
+    /**
+     * Adds a child scanning the index entries for 'term'.
+     */
+    void addChild(unique_ptr<PlanStage> child, std::string term);
 
     bool isEOF() final;
 
@@ -120,6 +131,30 @@ private:
      */
     StageState addTerm(WorkingSetID wsid, WorkingSetID* out);
 
+    /**
+     * Helper called from addTerm in top-k mode to compute the full score of the fetched document
+     * in 'wsm' from its contents. 'keyScore' is the score of the index entry that found it.
+     */
+    double scoreFetchedDocument(WorkingSetMember* wsm, double keyScore) const;
+
+    /**
+     * Helper called from addTerm in top-k mode. Returns false if a document scoring 'score' is not
+     * among the '_limit' highest scoring documents found so far. Otherwise adds it to them, and
+     * drops the document it displaces, if any.
+     */
+    bool addToTopK(const RecordId& recordId, double score);
+
+    /**
+     * Helper called from readFromChildren in top-k mode to pick the child to read from next, or to
+     * finish reading once no unread index entry can change the result.
+     */
+    StageState nextTopKChild();
+
+    /**
+     * Returns whether reading more index entries can't change the top-k result.
+     */
+    bool topKComplete() const;
+
     /**
      * Worker for kReturningResults. Returns a wsm with RecordID and Score.
      */
@@ -137,6 +172,12 @@ private:
     // Which of _children are we calling work(...) on now?
     size_t _currentChild = 0;
 
+    // The term scanned by each child.
+    std::vector<std::string> _terms;
+
+    // If nonzero, only the '_limit' highest scoring documents are returned.
+    const size_t _limit;
+
     /**
      *  Temporary score data filled out by children.
      *  Maps from RecordID -> (aggregate score for doc, wsid).
@@ -152,6 +193,12 @@ private:
     ScoreMap _scores;
     ScoreMap::const_iterator _scoreIterator;
 
+    // Top-k mode only. A min-heap of the scores of the best documents found so far, and the
+    // score of the last index entry read from each child, or 0 once a child is exhausted.
+    using ScoredRecord = std::pair<double, RecordId>;
+    std::vector<ScoredRecord> _topK;
+    std::vector<double> _childScoreBounds;
+
     TextOrStats _specificStats;
 
     // Members needed only for using the TextMatchableDocument.
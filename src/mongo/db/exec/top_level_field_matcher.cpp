@@ -0,0 +1,127 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/top_level_field_matcher.h"
+
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/matcher/expression_tree.h"
+
+namespace mongo {
+
+namespace {
+
+bool isSupportedPredicate(const MatchExpression* expr) {
+    switch (expr->matchType()) {
+        case MatchExpression::EQ:
+        case MatchExpression::LT:
+        case MatchExpression::LTE:
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+        case MatchExpression::MATCH_IN:
+            break;
+        default:
+            return false;
+    }
+
+    const StringData path = expr->path();
+    return !path.empty() && path.find('.') == std::string::npos;
+}
+
+}  // namespace
+
+// static
+std::unique_ptr<TopLevelFieldMatcher> TopLevelFieldMatcher::make(const MatchExpression* filter) {
+    if (!filter) {
+        return nullptr;
+    }
+
+    std::vector<const MatchExpression*> leaves;
+    if (filter->matchType() == MatchExpression::AND) {
+        for (size_t i = 0; i < filter->numChildren(); ++i) {
+            leaves.push_back(filter->getChild(i));
+        }
+    } else {
+        leaves.push_back(filter);
+    }
+
+    if (leaves.empty()) {
+        return nullptr;
+    }
+
+    std::vector<Predicate> predicates;
+    for (auto leaf : leaves) {
+        if (!isSupportedPredicate(leaf)) {
+            return nullptr;
+        }
+        predicates.push_back({leaf->path(), static_cast<const LeafMatchExpression*>(leaf)});
+    }
+
+    return std::unique_ptr<TopLevelFieldMatcher>(new TopLevelFieldMatcher(std::move(predicates)));
+}
+
+TopLevelFieldMatcher::TopLevelFieldMatcher(std::vector<Predicate> predicates)
+    : _predicates(std::move(predicates)) {}
+
+bool TopLevelFieldMatcher::matches(const BSONObj& obj) const {
+    // Filters are small, so a linear search of the predicates for each field beats hashing.
+    const size_t numPredicates = _predicates.size();
+    std::vector<BSONElement> elements(numPredicates);
+    size_t numFound = 0;
+
+    BSONObjIterator it(obj);
+    while (numFound < numPredicates && it.more()) {
+        const BSONElement elem = it.next();
+        const StringData fieldName = elem.fieldNameStringData();
+        for (size_t i = 0; i < numPredicates; ++i) {
+            // Like BSONObj::getField(), only the first occurrence of a field name counts.
+            if (elements[i].eoo() && _predicates[i].fieldName == fieldName) {
+                elements[i] = elem;
+                ++numFound;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < numPredicates; ++i) {
+        const BSONElement& elem = elements[i];
+        const LeafMatchExpression* expr = _predicates[i].expr;
+
+        // Missing fields and arrays have special matching semantics that the general matcher
+        // implements.
+        const bool matched = (elem.eoo() || elem.type() == Array)
+            ? expr->matchesBSON(obj, nullptr)
+            : expr->matchesSingleElement(elem);
+        if (!matched) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace mongo
@@ -0,0 +1,78 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+
+namespace mongo {
+
+class LeafMatchExpression;
+class MatchExpression;
+
+/**
+ * A faster way to evaluate filters made only of comparisons ($eq, $lt, $lte, $gt, $gte) and $in
+ * on top-level fields, such as {a: 5, b: {$gt: 3}, c: {$in: [1, 2]}}, against whole documents.
+ *
+ * The general matcher walks each predicate's path through the document separately, allocating an
+ * ElementIterator per predicate. Instead, this locates every referenced field in a single pass over
+ * the document and hands the element straight to the predicate. Documents where a referenced
+ * field is missing or is an array are passed to the general matcher, so results are identical.
+ */
+class TopLevelFieldMatcher {
+    MONGO_DISALLOW_COPYING(TopLevelFieldMatcher);
+
+public:
+    /**
+     * Returns null if 'filter' is null or is not a supported predicate or conjunction of them.
+     * The returned object refers to, but does not own, 'filter'.
+     */
+    static std::unique_ptr<TopLevelFieldMatcher> make(const MatchExpression* filter);
+
+    /**
+     * Returns true if 'obj' matches the filter this was made from.
+     */
+    bool matches(const BSONObj& obj) const;
+
+private:
+    struct Predicate {
+        StringData fieldName;
+        const LeafMatchExpression* expr;
+    };
+
+    explicit TopLevelFieldMatcher(std::vector<Predicate> predicates);
+
+    const std::vector<Predicate> _predicates;
+};
+
+}  // namespace mongo
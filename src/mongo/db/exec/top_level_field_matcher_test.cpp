@@ -0,0 +1,117 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/top_level_field_matcher.h"
+
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/matcher/extensions_callback_disallow_extensions.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::unique_ptr<MatchExpression> parse(const char* json,
+                                       const CollatorInterface* collator = nullptr) {
+    auto expr = MatchExpressionParser::parse(
+        fromjson(json), ExtensionsCallbackDisallowExtensions(), collator);
+    ASSERT_OK(expr.getStatus());
+    return std::move(expr.getValue());
+}
+
+/**
+ * Asserts that a TopLevelFieldMatcher can be made for 'filter' and that it agrees with the
+ * general matcher on each of 'docs'.
+ */
+void assertMatchesLikeMatcher(const char* filter, const std::vector<const char*>& docs) {
+    auto expr = parse(filter);
+    auto matcher = TopLevelFieldMatcher::make(expr.get());
+    ASSERT(matcher);
+    for (auto doc : docs) {
+        BSONObj obj = fromjson(doc);
+        ASSERT_EQ(expr->matchesBSON(obj), matcher->matches(obj)) << filter << " on " << obj;
+    }
+}
+
+TEST(TopLevelFieldMatcherTest, RejectsUnsupportedFilters) {
+    ASSERT_FALSE(TopLevelFieldMatcher::make(nullptr));
+    ASSERT_FALSE(TopLevelFieldMatcher::make(parse("{'a.b': 1}").get()));
+    ASSERT_FALSE(TopLevelFieldMatcher::make(parse("{a: 1, 'b.c': 1}").get()));
+    ASSERT_FALSE(TopLevelFieldMatcher::make(parse("{$or: [{a: 1}, {b: 1}]}").get()));
+    ASSERT_FALSE(TopLevelFieldMatcher::make(parse("{a: {$exists: true}}").get()));
+    ASSERT_FALSE(TopLevelFieldMatcher::make(parse("{a: {$ne: 1}}").get()));
+}
+
+TEST(TopLevelFieldMatcherTest, Comparisons) {
+    assertMatchesLikeMatcher("{a: 5, b: {$gt: 1, $lte: 10}, c: {$lt: 'z'}}",
+                             {"{a: 5, b: 2, c: 'a'}",
+                              "{c: 'a', b: 10, a: 5}",
+                              "{a: 5, b: 11, c: 'a'}",
+                              "{a: 5.0, b: 2, c: 'a'}",
+                              "{a: '5', b: 2, c: 'a'}",
+                              "{a: 5, b: 2}",
+                              "{}"});
+}
+
+TEST(TopLevelFieldMatcherTest, In) {
+    assertMatchesLikeMatcher("{a: {$in: [1, 'x', null, /^y/]}}",
+                             {"{a: 1}", "{a: 'x'}", "{a: 'yes'}", "{a: 2}", "{a: null}", "{b: 1}"});
+}
+
+TEST(TopLevelFieldMatcherTest, MissingAndArrayFieldsUseGeneralMatcher) {
+    assertMatchesLikeMatcher("{a: null, b: {$gte: 2}}",
+                             {"{b: 2}",
+                              "{a: null, b: 2}",
+                              "{a: 1, b: 2}",
+                              "{a: [1, null], b: [1, 3]}",
+                              "{a: [1], b: [1, 3]}",
+                              "{b: [[3]]}"});
+}
+
+TEST(TopLevelFieldMatcherTest, OnlyFirstOccurrenceOfFieldCounts) {
+    auto expr = parse("{a: 1}");
+    auto matcher = TopLevelFieldMatcher::make(expr.get());
+    ASSERT(matcher);
+    ASSERT_TRUE(matcher->matches(BSON("a" << 1 << "a" << 2)));
+    ASSERT_FALSE(matcher->matches(BSON("a" << 2 << "a" << 1)));
+    ASSERT_FALSE(expr->matchesBSON(BSON("a" << 2 << "a" << 1)));
+}
+
+TEST(TopLevelFieldMatcherTest, RespectsCollation) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kAlwaysEqual);
+    auto expr = parse("{a: 'foo'}", &collator);
+    auto matcher = TopLevelFieldMatcher::make(expr.get());
+    ASSERT(matcher);
+    ASSERT_TRUE(matcher->matches(fromjson("{a: 'bar'}")));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -48,7 +48,9 @@
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/s/collection_metadata.h"
 #include "mongo/db/s/collection_sharding_state.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/update/document_diff.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
@@ -69,6 +71,14 @@ namespace {
 const char idFieldName[] = "_id";
 const FieldRef idFieldRef(idFieldName);
 
+// When enabled, updates that rewrite the whole document are logged as a diff against the old
+// document whenever that is smaller than the $set/$unset entry. Only enable this once every member
+// of the replica set understands delta oplog entries.
+MONGO_EXPORT_SERVER_PARAMETER(useDeltaOplogUpdates, bool, false);
+
+// Oplog entries smaller than this are logged as they are; a diff could not save much.
+const int kMinLogSizeForDelta = 256;
+
 StatusWith<std::uint32_t> storageValid(const mb::Document&,
                                        bool deep,
                                        std::uint32_t recursionLevel);
@@ -527,6 +537,49 @@ const std::vector<std::unique_ptr<FieldRef>>* getImmutableFields(OperationContex
     return NULL;
 }
 
+/**
+ * Returns true if any of 'updatedFields' is, or is a prefix or an extension of, one of
+ * 'immutableFields'.
+ */
+bool updatesImmutableField(const FieldRefSet& updatedFields,
+                           const std::vector<std::unique_ptr<FieldRef>>* immutableFields) {
+    if (!immutableFields) {
+        return false;
+    }
+
+    FieldRefSet immutableFieldRef;
+    immutableFieldRef.fillFrom(transitional_tools_do_not_use::unspool_vector(*immutableFields));
+    for (auto&& field : updatedFields) {
+        if (immutableFieldRef.findConflicts(field, NULL)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Returns the update to record in the oplog for a write that replaced 'oldObj' with 'newObj'.
+ * This is a delta oplog entry when those are enabled and the diff is smaller than 'logObj',
+ * otherwise 'logObj' itself.
+ */
+BSONObj makeOplogUpdate(const NamespaceString& nss,
+                        const BSONObj& oldObj,
+                        const BSONObj& newObj,
+                        const BSONObj& logObj) {
+    if (!useDeltaOplogUpdates.load() || logObj.objsize() < kMinLogSizeForDelta ||
+        nss.isOnInternalDb() || nss.isSystem()) {
+        return logObj;
+    }
+
+    BSONObj diff = documentdiff::computeDiff(oldObj, newObj, logObj.objsize());
+    if (diff.isEmpty()) {
+        return logObj;
+    }
+
+    BSONObj delta = documentdiff::makeDeltaOplogEntryUpdate(diff);
+    return delta.objsize() < logObj.objsize() ? delta : logObj;
+}
+
 }  // namespace
 
 const char* UpdateStage::kStageType = "UPDATE";
@@ -562,83 +615,119 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
     // If asked to return new doc, default to the oldObj, in case nothing changes.
     BSONObj newObj = oldObj.value();
 
-    // Ask the driver to apply the mods. It may be that the driver can apply those "in
-    // place", that is, some values of the old document just get adjusted without any
-    // change to the binary layout on the bson layer. It may be that a whole new document
-    // is needed to accomodate the new bson layout of the resulting document. In any event,
-    // only enable in-place mutations if the underlying storage engine offers support for
-    // writing damage events.
-    _doc.reset(oldObj.value(),
-               (_collection->updateWithDamagesSupported()
-                    ? mutablebson::Document::kInPlaceEnabled
-                    : mutablebson::Document::kInPlaceDisabled));
-
     BSONObj logObj;
 
     FieldRefSet updatedFields;
     bool docWasModified = false;
 
-    Status status = Status::OK();
-    if (!driver->needMatchDetails()) {
-        // If we don't need match details, avoid doing the rematch
-        status = driver->update(StringData(), &_doc, &logObj, &updatedFields, &docWasModified);
-    } else {
-        // If there was a matched field, obtain it.
-        MatchDetails matchDetails;
-        matchDetails.requestElemMatchKey();
+    // Validation only applies to writes that are replicated and not part of a migration.
+    const bool shouldValidate =
+        getOpCtx()->writesAreReplicated() && !request->isFromMigration();
+
+    // When the storage engine cannot apply the update in place anyway, the simplest shapes of
+    // update are applied directly to the BSON of the old document instead of a mutable document.
+    // These mods cannot touch _id or produce fields that are invalid for storage, so there is
+    // nothing for validate() to check unless they update a shard key field.
+    bool updatedDirectly = false;
+    if (driver->canUpdateDirect() && !_collection->updateWithDamagesSupported() &&
+        oldObj.value().firstElement().fieldNameStringData() == idFieldName) {
+        Status status = driver->updateDirect(
+            oldObj.value(), &newObj, &logObj, &updatedFields, &docWasModified);
+        if (!status.isOK()) {
+            uasserted(16837, status.reason());
+        }
 
-        dassert(cq);
-        verify(cq->root()->matchesBSON(oldObj.value(), &matchDetails));
+        const bool mustValidate = docWasModified && shouldValidate && lifecycle &&
+            updatesImmutableField(updatedFields,
+                                  getImmutableFields(getOpCtx(), request->getNamespaceString()));
+        updatedDirectly = !mustValidate;
+        if (!updatedDirectly) {
+            // Redo the update through a mutable document so that validate() can compare the old
+            // and new values of the immutable fields.
+            newObj = oldObj.value();
+            logObj = BSONObj();
+            updatedFields.clear();
+            docWasModified = false;
+        }
+    }
 
-        string matchedField;
-        if (matchDetails.hasElemMatchKey())
-            matchedField = matchDetails.elemMatchKey();
+    bool addedIdField = false;
+    bool inPlace = false;
+    const char* source = NULL;
+    if (!updatedDirectly) {
+        // Ask the driver to apply the mods. It may be that the driver can apply those "in
+        // place", that is, some values of the old document just get adjusted without any
+        // change to the binary layout on the bson layer. It may be that a whole new document
+        // is needed to accomodate the new bson layout of the resulting document. In any event,
+        // only enable in-place mutations if the underlying storage engine offers support for
+        // writing damage events.
+        _doc.reset(oldObj.value(),
+                   (_collection->updateWithDamagesSupported()
+                        ? mutablebson::Document::kInPlaceEnabled
+                        : mutablebson::Document::kInPlaceDisabled));
+
+        Status status = Status::OK();
+        if (!driver->needMatchDetails()) {
+            // If we don't need match details, avoid doing the rematch
+            status = driver->update(StringData(), &_doc, &logObj, &updatedFields, &docWasModified);
+        } else {
+            // If there was a matched field, obtain it.
+            MatchDetails matchDetails;
+            matchDetails.requestElemMatchKey();
 
-        // TODO: Right now, each mod checks in 'prepare' that if it needs positional
-        // data, that a non-empty StringData() was provided. In principle, we could do
-        // that check here in an else clause to the above conditional and remove the
-        // checks from the mods.
+            dassert(cq);
+            verify(cq->root()->matchesBSON(oldObj.value(), &matchDetails));
 
-        status = driver->update(matchedField, &_doc, &logObj, &updatedFields, &docWasModified);
-    }
+            string matchedField;
+            if (matchDetails.hasElemMatchKey())
+                matchedField = matchDetails.elemMatchKey();
 
-    if (!status.isOK()) {
-        uasserted(16837, status.reason());
-    }
+            // TODO: Right now, each mod checks in 'prepare' that if it needs positional
+            // data, that a non-empty StringData() was provided. In principle, we could do
+            // that check here in an else clause to the above conditional and remove the
+            // checks from the mods.
 
-    // Skip adding _id field if the collection is capped (since capped collection documents can
-    // neither grow nor shrink).
-    const auto createIdField = !_collection->isCapped();
+            status = driver->update(matchedField, &_doc, &logObj, &updatedFields, &docWasModified);
+        }
 
-    // Ensure if _id exists it is first
-    status = ensureIdFieldIsFirst(&_doc);
-    if (status.code() == ErrorCodes::InvalidIdField) {
-        // Create ObjectId _id field if we are doing that
-        if (createIdField) {
-            uassertStatusOK(addObjectIDIdField(&_doc));
+        if (!status.isOK()) {
+            uasserted(16837, status.reason());
         }
-    } else {
-        uassertStatusOK(status);
-    }
 
-    // See if the changes were applied in place
-    const char* source = NULL;
-    const bool inPlace = _doc.getInPlaceUpdates(&_damages, &source);
+        // Skip adding _id field if the collection is capped (since capped collection documents
+        // can neither grow nor shrink).
+        const auto createIdField = !_collection->isCapped();
+
+        // Ensure if _id exists it is first
+        status = ensureIdFieldIsFirst(&_doc);
+        if (status.code() == ErrorCodes::InvalidIdField) {
+            // Create ObjectId _id field if we are doing that
+            if (createIdField) {
+                uassertStatusOK(addObjectIDIdField(&_doc));
+                addedIdField = true;
+            }
+        } else {
+            uassertStatusOK(status);
+        }
 
-    if (inPlace && _damages.empty()) {
-        // An interesting edge case. A modifier didn't notice that it was really a no-op
-        // during its 'prepare' phase. That represents a missed optimization, but we still
-        // shouldn't do any real work. Toggle 'docWasModified' to 'false'.
-        //
-        // Currently, an example of this is '{ $pushAll : { x : [] } }' when the 'x' array
-        // exists.
-        docWasModified = false;
+        // See if the changes were applied in place
+        inPlace = _doc.getInPlaceUpdates(&_damages, &source);
+
+        if (inPlace && _damages.empty()) {
+            // An interesting edge case. A modifier didn't notice that it was really a no-op
+            // during its 'prepare' phase. That represents a missed optimization, but we still
+            // shouldn't do any real work. Toggle 'docWasModified' to 'false'.
+            //
+            // Currently, an example of this is '{ $pushAll : { x : [] } }' when the 'x' array
+            // exists.
+            docWasModified = false;
+        }
     }
 
     if (docWasModified) {
         // Verify that no immutable fields were changed and data is valid for storage.
 
-        if (!(!getOpCtx()->writesAreReplicated() || request->isFromMigration())) {
+        if (!updatedDirectly && shouldValidate) {
             const std::vector<std::unique_ptr<FieldRef>>* immutableFields = nullptr;
             if (lifecycle)
                 immutableFields = getImmutableFields(getOpCtx(), request->getNamespaceString());
@@ -678,7 +767,9 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
         } else {
             // The updates were not in place. Apply them through the file manager.
 
-            newObj = _doc.getObject();
+            if (!updatedDirectly) {
+                newObj = _doc.getObject();
+            }
             uassert(17419,
                     str::stream() << "Resulting document after update is larger than "
                                   << BSONObjMaxUserSize,
@@ -691,17 +782,22 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
                 OplogUpdateEntryArgs args;
                 args.nss = _collection->ns();
                 args.uuid = _collection->uuid();
-                args.update = logObj;
+                args.update = makeOplogUpdate(_collection->ns(), oldObj.value(), newObj, logObj);
                 args.criteria = idQuery;
                 args.fromMigrate = request->isFromMigration();
-                StatusWith<RecordId> res = _collection->updateDocument(getOpCtx(),
-                                                                       recordId,
-                                                                       oldObj,
-                                                                       newObj,
-                                                                       true,
-                                                                       driver->modsAffectIndices(),
-                                                                       _params.opDebug,
-                                                                       &args);
+                // Only the indexes on the paths the mods touched need new keys. A replacement,
+                // or a generated _id, may change any path.
+                const bool allFieldsMayChange = driver->isDocReplacement() || addedIdField;
+                StatusWith<RecordId> res =
+                    _collection->updateDocument(getOpCtx(),
+                                                recordId,
+                                                oldObj,
+                                                newObj,
+                                                true,
+                                                driver->modsAffectIndices(),
+                                                _params.opDebug,
+                                                &args,
+                                                allFieldsMayChange ? nullptr : &updatedFields);
                 uassertStatusOK(res.getStatus());
                 newRecordId = res.getValue();
             }
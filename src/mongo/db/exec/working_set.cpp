@@ -28,6 +28,8 @@
 
 #include "mongo/db/exec/working_set.h"
 
+#include <algorithm>
+
 #include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/service_context.h"
@@ -39,15 +41,30 @@ using std::string;
 
 namespace dps = ::mongo::dotted_path_support;
 
+namespace {
+
+// Slab sizes start small, since most working sets only ever hold a handful of members, and double
+// up to the maximum.
+const size_t kInitialSlabSize = 4;
+const size_t kMaxSlabSize = 256;
+
+}  // namespace
+
 WorkingSet::MemberHolder::MemberHolder() : member(NULL) {}
 WorkingSet::MemberHolder::~MemberHolder() {}
 
 WorkingSet::WorkingSet() : _freeList(INVALID_ID) {}
 
-WorkingSet::~WorkingSet() {
-    for (size_t i = 0; i < _data.size(); i++) {
-        delete _data[i].member;
+WorkingSet::~WorkingSet() {}
+
+WorkingSetMember* WorkingSet::allocateFromSlab() {
+    if (_currentSlabUsed == _currentSlabSize) {
+        _currentSlabSize =
+            _slabs.empty() ? kInitialSlabSize : std::min(_currentSlabSize * 2, kMaxSlabSize);
+        _slabs.emplace_back(new WorkingSetMember[_currentSlabSize]);
+        _currentSlabUsed = 0;
     }
+    return &_slabs.back()[_currentSlabUsed++];
 }
 
 WorkingSetID WorkingSet::allocate() {
@@ -58,7 +75,7 @@ WorkingSetID WorkingSet::allocate() {
         WorkingSetID id = _data.size();
         _data.resize(_data.size() + 1);
         _data.back().nextFreeOrSelf = id;
-        _data.back().member = new WorkingSetMember();
+        _data.back().member = allocateFromSlab();
         return id;
     }
 
@@ -96,10 +113,10 @@ bool WorkingSet::isFlagged(WorkingSetID id) const {
 }
 
 void WorkingSet::clear() {
-    for (size_t i = 0; i < _data.size(); i++) {
-        delete _data[i].member;
-    }
     _data.clear();
+    _slabs.clear();
+    _currentSlabSize = 0;
+    _currentSlabUsed = 0;
 
     // Since working set is now empty, the free list pointer should
     // point to nothing.
@@ -215,7 +232,7 @@ bool WorkingSetMember::getFieldDotted(const string& field, BSONElement* out) con
     // Our state should be such that we have index data/are covered.
     for (size_t i = 0; i < keyData.size(); ++i) {
         BSONObjIterator keyPatternIt(keyData[i].indexKeyPattern);
-        BSONObjIterator keyDataIt(keyData[i].keyData);
+        BSONObjIterator keyDataIt(keyData[i].keyData());
 
         while (keyPatternIt.more()) {
             BSONElement keyPatternElt = keyPatternIt.next();
@@ -247,7 +264,7 @@ size_t WorkingSetMember::getMemUsage() const {
 
     for (size_t i = 0; i < keyData.size(); ++i) {
         const IndexKeyDatum& keyDatum = keyData[i];
-        memUsage += keyDatum.keyData.objsize();
+        memUsage += keyDatum.keyData().objsize();
     }
 
     return memUsage;
@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+#include <memory>
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
@@ -35,6 +37,7 @@
 #include "mongo/db/record_id.h"
 #include "mongo/db/storage/snapshot.h"
 #include "mongo/platform/unordered_set.h"
+#include "mongo/stdx/functional.h"
 #include "mongo/stdx/unordered_set.h"
 
 namespace mongo {
@@ -147,10 +150,17 @@ private:
         // Free list link if freed. Points to self if in use.
         WorkingSetID nextFreeOrSelf;
 
-        // Owning pointer
+        // Points into one of '_slabs'.
         WorkingSetMember* member;
     };
 
+    /**
+     * Returns a member from the current slab, first allocating a new slab if the current one has
+     * been used up. Members are never handed back to a slab; freed members are recycled through
+     * the free list instead.
+     */
+    WorkingSetMember* allocateFromSlab();
+
     // All WorkingSetIDs are indexes into this, except for INVALID_ID.
     // Elements are added to _freeList rather than removed when freed.
     std::vector<MemberHolder> _data;
@@ -160,6 +170,16 @@ private:
     // If _freeList == INVALID_ID, the free list is empty and all elements in _data are in use.
     WorkingSetID _freeList;
 
+    // Storage for every member in '_data'. Members are allocated in slabs whose size doubles up to
+    // a fixed maximum so that a working set holding many results, such as one under a blocking
+    // sort, does not make a heap allocation per member, and so that clear() and destruction free
+    // them in bulk. Slabs are never reallocated, so pointers returned by get() remain valid.
+    std::vector<std::unique_ptr<WorkingSetMember[]>> _slabs;
+
+    // The size of _slabs.back(), and how many of its members have been handed out.
+    size_t _currentSlabSize = 0;
+    size_t _currentSlabUsed = 0;
+
     // An insert-only set of WorkingSetIDs that have been flagged for review.
     stdx::unordered_set<WorkingSetID> _flagged;
 
@@ -174,15 +194,92 @@ private:
  */
 struct IndexKeyDatum {
     IndexKeyDatum(const BSONObj& keyPattern, const BSONObj& key, const IndexAccessMethod* index)
-        : indexKeyPattern(keyPattern), keyData(key), index(index) {}
+        : indexKeyPattern(keyPattern), index(index), _keyData(key) {}
+
+    /**
+     * Defers producing the key until keyData() is first called, at which point 'decodeKey' is
+     * called to produce it. Used by index scans whose keys may never be looked at, such as those
+     * below a fetch, so that the storage engine's encoding of each key is only converted to BSON
+     * when some stage needs it.
+     */
+    IndexKeyDatum(const BSONObj& keyPattern,
+                  stdx::function<BSONObj()> decodeKey,
+                  const IndexAccessMethod* index)
+        : indexKeyPattern(keyPattern), index(index), _decodeKey(std::move(decodeKey)) {}
+
+    /**
+     * Returns the BSONObj for the key that we put into the index.
+     */
+    const BSONObj& keyData() const {
+        if (_decodeKey) {
+            _keyData = _decodeKey();
+            _decodeKey = nullptr;
+        }
+        return _keyData;
+    }
 
     // This is not owned and points into the IndexDescriptor's data.
     BSONObj indexKeyPattern;
 
-    // This is the BSONObj for the key that we put into the index.  Owned by us.
-    BSONObj keyData;
-
     const IndexAccessMethod* index;
+
+private:
+    // Owned by us. Not yet set if '_decodeKey' is.
+    mutable BSONObj _keyData;
+    mutable stdx::function<BSONObj()> _decodeKey;
+};
+
+/**
+ * The index keys held by a WorkingSetMember. Nearly every member holds at most one key, so the
+ * first is stored inline and only members with keys from several indices, as produced by index
+ * intersection, allocate storage for the rest.
+ */
+class IndexKeyDataList {
+public:
+    void push_back(IndexKeyDatum datum) {
+        if (!_first) {
+            _first.emplace(std::move(datum));
+        } else {
+            _rest.push_back(std::move(datum));
+        }
+    }
+
+    size_t size() const {
+        return _first ? 1 + _rest.size() : 0;
+    }
+
+    bool empty() const {
+        return !_first;
+    }
+
+    /**
+     * Removes all keys. Storage for keys beyond the first is kept for reuse when the member is
+     * recycled.
+     */
+    void clear() {
+        _first = boost::none;
+        _rest.clear();
+    }
+
+    IndexKeyDatum& operator[](size_t i) {
+        return i == 0 ? *_first : _rest[i - 1];
+    }
+
+    const IndexKeyDatum& operator[](size_t i) const {
+        return i == 0 ? *_first : _rest[i - 1];
+    }
+
+    IndexKeyDatum& back() {
+        return _rest.empty() ? *_first : _rest.back();
+    }
+
+    const IndexKeyDatum& back() const {
+        return _rest.empty() ? *_first : _rest.back();
+    }
+
+private:
+    boost::optional<IndexKeyDatum> _first;
+    std::vector<IndexKeyDatum> _rest;
 };
 
 /**
@@ -280,7 +377,7 @@ public:
 
     RecordId recordId;
     Snapshotted<BSONObj> obj;
-    std::vector<IndexKeyDatum> keyData;
+    IndexKeyDataList keyData;
 
     // True if this WSM has survived a yield in RID_AND_IDX state.
     // TODO consider replacing by tracking SnapshotIds for IndexKeyDatums.
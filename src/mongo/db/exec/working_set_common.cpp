@@ -122,7 +122,7 @@ bool WorkingSetCommon::fetch(OperationContext* opCtx,
                                               IndexAccessMethod::GetKeysMode::kEnforceConstraints,
                                               &keys,
                                               multikeyPaths);
-            if (!keys.count(member->keyData[i].keyData)) {
+            if (!keys.count(member->keyData[i].keyData())) {
                 // document would no longer be at this position in the index.
                 return false;
             }
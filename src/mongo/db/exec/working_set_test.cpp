@@ -154,4 +154,73 @@ TEST_F(WorkingSetFixture, getDottedFieldFromIndex) {
     ASSERT_FALSE(member->getFieldDotted("y", &elt));
 }
 
+TEST_F(WorkingSetFixture, getFieldFromDeferredIndexKey) {
+    string firstName = "x";
+    int firstValue = 5;
+
+    int numDecodes = 0;
+    member->keyData.push_back(IndexKeyDatum(BSON(firstName << 1),
+                                            [&] {
+                                                ++numDecodes;
+                                                return BSON("" << firstValue);
+                                            },
+                                            NULL));
+    ws->transitionToRecordIdAndIdx(id);
+    ASSERT_EQUALS(numDecodes, 0);
+
+    BSONElement elt;
+    ASSERT_TRUE(member->getFieldDotted(firstName, &elt));
+    ASSERT_EQUALS(elt.numberInt(), firstValue);
+    ASSERT_TRUE(member->getFieldDotted(firstName, &elt));
+    ASSERT_EQUALS(elt.numberInt(), firstValue);
+    ASSERT_BSONOBJ_EQ(member->keyData[0].keyData(), BSON("" << firstValue));
+    // The key is only decoded the first time it is needed.
+    ASSERT_EQUALS(numDecodes, 1);
+}
+
+TEST_F(WorkingSetFixture, MembersKeepTheirAddressesAsTheWorkingSetGrows) {
+    member->recordId = RecordId(0);
+    std::vector<std::pair<WorkingSetID, WorkingSetMember*>> allocated{{id, member}};
+    for (int i = 1; i < 1000; ++i) {
+        WorkingSetID newId = ws->allocate();
+        WorkingSetMember* newMember = ws->get(newId);
+        ASSERT_EQUALS(WorkingSetMember::INVALID, newMember->getState());
+        newMember->recordId = RecordId(i);
+        allocated.emplace_back(newId, newMember);
+    }
+
+    for (size_t i = 0; i < allocated.size(); ++i) {
+        ASSERT_EQUALS(allocated[i].second, ws->get(allocated[i].first));
+        ASSERT_EQUALS(RecordId(i), allocated[i].second->recordId);
+    }
+}
+
+TEST_F(WorkingSetFixture, FreedMembersAreRecycledWithoutTheirOldData) {
+    member->keyData.push_back(IndexKeyDatum(BSON("x" << 1), BSON("" << 1), NULL));
+    member->keyData.push_back(IndexKeyDatum(BSON("y" << 1), BSON("" << 2), NULL));
+    ws->transitionToRecordIdAndIdx(id);
+    ws->free(id);
+
+    WorkingSetID recycledId = ws->allocate();
+    ASSERT_EQUALS(id, recycledId);
+    ASSERT_EQUALS(member, ws->get(recycledId));
+    ASSERT_EQUALS(WorkingSetMember::INVALID, member->getState());
+    ASSERT_TRUE(member->keyData.empty());
+
+    member->keyData.push_back(IndexKeyDatum(BSON("z" << 1), BSON("" << 3), NULL));
+    ASSERT_EQUALS(1U, member->keyData.size());
+    ASSERT_BSONOBJ_EQ(BSON("z" << 1), member->keyData.back().indexKeyPattern);
+}
+
+TEST_F(WorkingSetFixture, ClearReleasesAllMembers) {
+    for (int i = 0; i < 100; ++i) {
+        ws->allocate();
+    }
+    ws->clear();
+
+    WorkingSetID newId = ws->allocate();
+    ASSERT_EQUALS(WorkingSetID(0), newId);
+    ASSERT_EQUALS(WorkingSetMember::INVALID, ws->get(newId)->getState());
+}
+
 }  // namespace
@@ -30,6 +30,8 @@
 
 #include "mongo/db/ftdc/collector.h"
 
+#include <algorithm>
+
 #include "mongo/base/string_data.h"
 #include "mongo/bson/bsonmisc.h"
 #include "mongo/bson/bsonobjbuilder.h"
@@ -38,22 +40,85 @@
 #include "mongo/db/ftdc/util.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/service_context.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
+namespace {
+
+/**
+ * Appends the start date, data, end date and duration of a sample from collector to builder, and
+ * returns the end date.
+ */
+Date_t collectFrom(FTDCCollectorInterface* collector,
+                   OperationContext* opCtx,
+                   Date_t start,
+                   BSONObjBuilder& builder) {
+    ServiceContext* serviceContext = opCtx->getServiceContext();
+    Timer timer(serviceContext->getTickSource());
+
+    builder.appendDate(kFTDCCollectStartField, start);
+
+    collector->collect(opCtx, builder);
+
+    Date_t end = serviceContext->getPreciseClockSource()->now();
+    builder.appendDate(kFTDCCollectEndField, end);
+    builder.append(kFTDCCollectDurationField, timer.micros());
+
+    return end;
+}
+
+}  // namespace
+
+struct FTDCCollectorCollection::CollectorState {
+    explicit CollectorState(std::unique_ptr<FTDCCollectorInterface> collector)
+        : collector(std::move(collector)), name(this->collector->name()) {}
+
+    const std::unique_ptr<FTDCCollectorInterface> collector;
+
+    const std::string name;
+
+    // True while the collector is running on the pool, guarded by FTDCCollectorCollection::_mutex
+    bool inProgress{false};
+
+    // Last sample completed on the pool, guarded by FTDCCollectorCollection::_mutex
+    BSONObj lastSample;
+};
+
+FTDCCollectorCollection::FTDCCollectorCollection() = default;
+
+FTDCCollectorCollection::~FTDCCollectorCollection() {
+    // Wait for any collector still running after missing its timeout.
+    if (_pool) {
+        _pool->shutdown();
+        _pool->join();
+    }
+}
+
 void FTDCCollectorCollection::add(std::unique_ptr<FTDCCollectorInterface> collector) {
     // TODO: ensure the collectors all have unique names.
-    _collectors.emplace_back(std::move(collector));
+    _collectors.emplace_back(stdx::make_unique<CollectorState>(std::move(collector)));
 }
 
-std::tuple<BSONObj, Date_t> FTDCCollectorCollection::collect(Client* client) {
+std::tuple<BSONObj, Date_t> FTDCCollectorCollection::collect(Client* client, Milliseconds timeout) {
     // If there are no collectors, just return an empty BSONObj so that that are caller knows we did
     // not collect anything
     if (_collectors.empty()) {
         return std::tuple<BSONObj, Date_t>(BSONObj(), Date_t());
     }
 
+    if (timeout > Milliseconds(0)) {
+        return _collectConcurrently(client, timeout);
+    }
+
+    return _collectSequentially(client);
+}
+
+std::tuple<BSONObj, Date_t> FTDCCollectorCollection::_collectSequentially(Client* client) {
     BSONObjBuilder builder;
 
     Date_t start = client->getServiceContext()->getPreciseClockSource()->now();
@@ -68,8 +133,8 @@ std::tuple<BSONObj, Date_t> FTDCCollectorCollection::collect(Client* client) {
     auto opCtx = client->makeOperationContext();
     opCtx->lockState()->setShouldConflictWithSecondaryBatchApplication(false);
 
-    for (auto& collector : _collectors) {
-        BSONObjBuilder subObjBuilder(builder.subobjStart(collector->name()));
+    for (auto& state : _collectors) {
+        BSONObjBuilder subObjBuilder(builder.subobjStart(state->name));
 
         // Add a Date_t before and after each BSON is collected so that we can track timing of the
         // collector.
@@ -81,17 +146,87 @@ std::tuple<BSONObj, Date_t> FTDCCollectorCollection::collect(Client* client) {
 
         firstLoop = false;
 
-        subObjBuilder.appendDate(kFTDCCollectStartField, now);
+        end = collectFrom(state->collector.get(), opCtx.get(), now, subObjBuilder);
+    }
+
+    builder.appendDate(kFTDCCollectEndField, end);
 
-        collector->collect(opCtx.get(), subObjBuilder);
+    return std::tuple<BSONObj, Date_t>(builder.obj(), start);
+}
 
-        end = client->getServiceContext()->getPreciseClockSource()->now();
-        subObjBuilder.appendDate(kFTDCCollectEndField, end);
+std::tuple<BSONObj, Date_t> FTDCCollectorCollection::_collectConcurrently(Client* client,
+                                                                          Milliseconds timeout) {
+    ClockSource* clockSource = client->getServiceContext()->getPreciseClockSource();
+
+    if (!_pool) {
+        ThreadPool::Options options;
+        options.poolName = "FTDCCollectors";
+        options.minThreads = 0;
+        options.maxThreads = _collectors.size();
+        options.onCreateThread = [](const std::string& threadName) {
+            Client::initThread(threadName);
+        };
+        _pool = stdx::make_unique<ThreadPool>(options);
+        _pool->startup();
     }
 
-    builder.appendDate(kFTDCCollectEndField, end);
+    Date_t start = clockSource->now();
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+
+    for (auto& state : _collectors) {
+        // A collector still working on an earlier sample is not asked for another one.
+        if (state->inProgress) {
+            continue;
+        }
+
+        auto statePtr = state.get();
+        Status status = _pool->schedule([this, statePtr] { _collectOnPoolThread(statePtr); });
+        if (status.isOK()) {
+            state->inProgress = true;
+        }
+    }
+
+    _condvar.wait_for(lk, timeout.toSystemDuration(), [this] {
+        return std::none_of(_collectors.begin(),
+                            _collectors.end(),
+                            [](const std::unique_ptr<CollectorState>& state) {
+                                return state->inProgress;
+                            });
+    });
+
+    BSONObjBuilder builder;
+
+    builder.appendDate(kFTDCCollectStartField, start);
+
+    for (auto& state : _collectors) {
+        // Collectors that have never completed a sample are left out until they do.
+        if (!state->lastSample.isEmpty()) {
+            builder.append(state->name, state->lastSample);
+        }
+    }
+
+    builder.appendDate(kFTDCCollectEndField, clockSource->now());
 
     return std::tuple<BSONObj, Date_t>(builder.obj(), start);
 }
 
+void FTDCCollectorCollection::_collectOnPoolThread(CollectorState* state) {
+    BSONObjBuilder builder;
+
+    {
+        // See _collectSequentially.
+        auto opCtx = cc().makeOperationContext();
+        opCtx->lockState()->setShouldConflictWithSecondaryBatchApplication(false);
+
+        Date_t start = opCtx->getServiceContext()->getPreciseClockSource()->now();
+        collectFrom(state->collector.get(), opCtx.get(), start, builder);
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    state->lastSample = builder.obj();
+    state->inProgress = false;
+    _condvar.notify_all();
+}
+
 }  // namespace mongo
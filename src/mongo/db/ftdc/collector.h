@@ -33,14 +33,17 @@
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
 class BSONObj;
 class BSONObjBuilder;
-class Date_t;
 class Client;
 class OperationContext;
+class ThreadPool;
 
 /**
  * BSON Collector interface
@@ -65,6 +68,9 @@ public:
      *
      * If a collector fails to collect data, it should update builder with the result of the
      * failure.
+     *
+     * A collector is never asked for a sample while it is still collecting the previous one, but
+     * successive samples may be collected on different threads.
      */
     virtual void collect(OperationContext* opCtx, BSONObjBuilder& builder) = 0;
 
@@ -81,7 +87,8 @@ class FTDCCollectorCollection {
     MONGO_DISALLOW_COPYING(FTDCCollectorCollection);
 
 public:
-    FTDCCollectorCollection() = default;
+    FTDCCollectorCollection();
+    ~FTDCCollectorCollection();
 
     /**
      * Add a metric collector to the collection.
@@ -100,16 +107,47 @@ public:
      *       "start" : Date_t, <- Time at which name() collection started
      *       "data" : { ... }  <- data comes from collect() in FTDCCollectorInterface
      *       "end" : Date_t,   <- Time at which name() collection ended
+     *       "durationMicros" : long long, <- Time spent in collect() for name()
      *    },
      *    ...
      *    "end" : Date_t,      <- Time at which all collecting ended
      * }
+     *
+     * If timeout is zero, the collectors run one after the other on the calling thread. Otherwise
+     * they run concurrently on a pool of threads owned by the collection, and the sample is
+     * assembled from whatever they have produced once all of them are done or the timeout has
+     * elapsed. A collector that misses the timeout is represented by the last sample it completed,
+     * recognizable by its start date being older than the start of the sample, and is left to
+     * finish in the background instead of being asked for another sample.
+     */
+    std::tuple<BSONObj, Date_t> collect(Client* client, Milliseconds timeout = Milliseconds(0));
+
+private:
+    struct CollectorState;
+
+    std::tuple<BSONObj, Date_t> _collectSequentially(Client* client);
+
+    std::tuple<BSONObj, Date_t> _collectConcurrently(Client* client, Milliseconds timeout);
+
+    /**
+     * Collects one sample from the collector of state on a pool thread, and publishes it as the
+     * collector's last sample.
      */
-    std::tuple<BSONObj, Date_t> collect(Client* client);
+    void _collectOnPoolThread(CollectorState* state);
 
 private:
     // collection of collectors
-    std::vector<std::unique_ptr<FTDCCollectorInterface>> _collectors;
+    std::vector<std::unique_ptr<CollectorState>> _collectors;
+
+    // Guards the progress and last samples of the collectors when collecting concurrently
+    stdx::mutex _mutex;
+
+    // Signalled when a collector running on the pool finishes
+    stdx::condition_variable _condvar;
+
+    // Threads for concurrent collection, created on first use. Declared after the collectors so
+    // that it is joined before they are destroyed.
+    std::unique_ptr<ThreadPool> _pool;
 };
 
 }  // namespace mongo
@@ -46,7 +46,10 @@ struct FTDCConfig {
           maxFileSizeBytes(kMaxFileSizeBytesDefault),
           period(kPeriodMillisDefault),
           maxSamplesPerArchiveMetricChunk(kMaxSamplesPerArchiveMetricChunkDefault),
-          maxSamplesPerInterimMetricChunk(kMaxSamplesPerInterimMetricChunkDefault) {}
+          maxSamplesPerInterimMetricChunk(kMaxSamplesPerInterimMetricChunkDefault),
+          downsampleEnabled(kDownsampleEnabledDefault),
+          fullResolutionRetention(kFullResolutionRetentionSecsDefault),
+          collectorTimeout(kCollectorTimeoutMillisDefault) {}
 
     /**
      * True if FTDC is collecting data. False otherwise
@@ -83,6 +86,26 @@ struct FTDCConfig {
      */
     std::uint32_t maxSamplesPerInterimMetricChunk;
 
+    /**
+     * True if samples are also written at 10 and 60 second resolution, each in its own
+     * subdirectory. The full resolution files are then only kept for fullResolutionRetention, and
+     * the directory quota is shared between the resolutions so that it covers a much longer time.
+     */
+    bool downsampleEnabled;
+
+    /**
+     * How long full resolution files are kept if downsampleEnabled is true. Zero keeps them until
+     * their share of the directory quota is used up.
+     */
+    Seconds fullResolutionRetention;
+
+    /**
+     * If non-zero, the periodic collectors run concurrently, and a sample is written once they
+     * have all finished or this much time has passed, so that one slow collector does not delay
+     * the others. Zero runs them one after the other.
+     */
+    Milliseconds collectorTimeout;
+
     static const bool kEnabledDefault = true;
 
     static const std::int64_t kPeriodMillisDefault;
@@ -93,6 +116,10 @@ struct FTDCConfig {
 
     static const std::uint32_t kMaxSamplesPerArchiveMetricChunkDefault = 300;
     static const std::uint32_t kMaxSamplesPerInterimMetricChunkDefault = 10;
+
+    static const bool kDownsampleEnabledDefault = false;
+    static const std::int64_t kFullResolutionRetentionSecsDefault = 60 * 60;
+    static const std::int64_t kCollectorTimeoutMillisDefault = 0;
 };
 
 }  // namespace mongo
@@ -41,5 +41,6 @@ extern const char kFTDCDocsField[];
 
 extern const char kFTDCCollectStartField[];
 extern const char kFTDCCollectEndField[];
+extern const char kFTDCCollectDurationField[];
 
 }  // namespace mongo
@@ -214,7 +214,7 @@ void FTDCController::doLoop() {
                     _mgr = uassertStatusOK(std::move(swMgr));
                 }
 
-                auto collectSample = _periodicCollectors.collect(client);
+                auto collectSample = _periodicCollectors.collect(client, _config.collectorTimeout);
 
                 Status s = _mgr->writeSampleAndRotateIfNeeded(
                     client, std::get<0>(collectSample), std::get<1>(collectSample));
@@ -80,6 +80,9 @@ public:
 
                 subObjBuilder.appendDate(kFTDCCollectEndField,
                                          getGlobalServiceContext()->getPreciseClockSource()->now());
+
+                // The tick source is mocked, so no time passes while collecting
+                subObjBuilder.append(kFTDCCollectDurationField, 0LL);
             }
 
             b2.appendDate(kFTDCCollectEndField,
@@ -277,4 +280,83 @@ TEST(FTDCControllerTest, TestStartAsDisabled) {
     ValidateDocumentList(alog, allDocs);
 }
 
+// Collector that blocks in collect() until released
+class FTDCCollectorBlocking : public FTDCCollectorInterface {
+public:
+    void collect(OperationContext* opCtx, BSONObjBuilder& builder) final {
+        stdx::unique_lock<stdx::mutex> lck(_mutex);
+        while (!_released) {
+            _condvar.wait(lck);
+        }
+
+        builder.append("count", ++_count);
+    }
+
+    std::string name() const final {
+        return "blocking";
+    }
+
+    void release() {
+        stdx::lock_guard<stdx::mutex> lck(_mutex);
+        _released = true;
+        _condvar.notify_all();
+    }
+
+private:
+    stdx::mutex _mutex;
+    stdx::condition_variable _condvar;
+    bool _released{false};
+    int _count{0};
+};
+
+class FTDCCollectorImmediate : public FTDCCollectorInterface {
+public:
+    void collect(OperationContext* opCtx, BSONObjBuilder& builder) final {
+        builder.append("count", ++_count);
+    }
+
+    std::string name() const final {
+        return "immediate";
+    }
+
+private:
+    int _count{0};
+};
+
+// Test that a collector missing the timeout does not hold back the others when collecting
+// concurrently
+TEST(FTDCControllerTest, TestConcurrentCollectTimeout) {
+    Client* client = &cc();
+
+    FTDCCollectorCollection collectors;
+
+    auto blocking = stdx::make_unique<FTDCCollectorBlocking>();
+    auto blockingPtr = blocking.get();
+
+    collectors.add(std::move(blocking));
+    collectors.add(stdx::make_unique<FTDCCollectorImmediate>());
+
+    // The blocking collector has not produced anything yet, so it is left out of the sample
+    auto sample = std::get<0>(collectors.collect(client, Milliseconds(50)));
+    ASSERT_FALSE(sample.hasField("blocking"));
+    ASSERT_EQUALS(1, sample["immediate"]["count"].numberInt());
+    ASSERT_TRUE(sample["immediate"].Obj().hasField(kFTDCCollectDurationField));
+
+    // The blocking collector is still busy with the first sample and is not asked for another
+    sample = std::get<0>(collectors.collect(client, Milliseconds(50)));
+    ASSERT_FALSE(sample.hasField("blocking"));
+    ASSERT_EQUALS(2, sample["immediate"]["count"].numberInt());
+
+    // Once released, the blocking collector finishes its first sample within the timeout, and then
+    // produces the next one.
+    blockingPtr->release();
+    sample = std::get<0>(collectors.collect(client, Seconds(60)));
+    ASSERT_EQUALS(1, sample["blocking"]["count"].numberInt());
+    ASSERT_EQUALS(3, sample["immediate"]["count"].numberInt());
+
+    sample = std::get<0>(collectors.collect(client, Seconds(60)));
+    ASSERT_EQUALS(2, sample["blocking"]["count"].numberInt());
+    ASSERT_TRUE(sample["blocking"].Obj().hasField(kFTDCCollectDurationField));
+}
+
 }  // namespace mongo
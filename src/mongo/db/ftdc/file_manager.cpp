@@ -32,7 +32,9 @@
 
 #include "mongo/db/ftdc/file_manager.h"
 
+#include <algorithm>
 #include <boost/filesystem.hpp>
+#include <ctime>
 #include <string>
 
 #include "mongo/base/string_data.h"
@@ -49,6 +51,66 @@
 
 namespace mongo {
 
+namespace {
+
+/**
+ * A resolution the samples are downsampled to. Downsampling keeps one sample per interval, so the
+ * counters, which make up most of the metrics, remain exact and still delta-compress well; only
+ * the detail of the gauges between the kept samples is lost.
+ */
+struct DownsampleTierSpec {
+    // Time between two kept samples
+    Seconds interval;
+
+    // How long files are kept, zero keeps them until the tier's quota is used up
+    Seconds retention;
+
+    // Percentage of FTDCConfig::maxDirectorySizeBytes the tier may use
+    std::uint64_t quotaPercent;
+
+    // Subdirectory of the metrics directory holding the tier's files
+    const char* directory;
+};
+
+// Finest first. Each tier retains its data for longer than the one before it, and the last one
+// keeps as much history as fits in its quota.
+const DownsampleTierSpec kDownsampleTiers[] = {
+    {Seconds(10), Seconds(24 * 60 * 60), 25, "downsampled.10s"},
+    {Seconds(60), Seconds(0), 50, "downsampled.60s"},
+};
+
+// Percentage of FTDCConfig::maxDirectorySizeBytes left to the full resolution files when
+// downsampling is enabled.
+const std::uint64_t kFullResolutionQuotaPercent = 25;
+
+}  // namespace
+
+struct FTDCFileManager::DownsampleTier {
+    explicit DownsampleTier(const DownsampleTierSpec* spec) : spec(spec) {}
+
+    /**
+     * Derives the tier's configuration from the configuration of the full resolution files.
+     */
+    void updateConfig(const FTDCConfig& fullResolutionConfig) {
+        config = fullResolutionConfig;
+        config.downsampleEnabled = false;
+        config.maxDirectorySizeBytes =
+            fullResolutionConfig.maxDirectorySizeBytes * spec->quotaPercent / 100;
+        config.maxFileSizeBytes =
+            std::min(fullResolutionConfig.maxFileSizeBytes, config.maxDirectorySizeBytes);
+    }
+
+    const DownsampleTierSpec* const spec;
+
+    // Referenced by the tier's file manager, so it must not move
+    FTDCConfig config;
+
+    std::unique_ptr<FTDCFileManager> manager;
+
+    // The next sample written at or after this time is cascaded into the tier
+    Date_t nextSampleDate;
+};
+
 FTDCFileManager::FTDCFileManager(const FTDCConfig* config,
                                  const boost::filesystem::path& path,
                                  FTDCCollectorCollection* collection)
@@ -100,12 +162,40 @@ StatusWith<std::unique_ptr<FTDCFileManager>> FTDCFileManager::create(
         return s;
     }
 
+    if (config->downsampleEnabled) {
+        mgr->_retention = config->fullResolutionRetention;
+
+        s = mgr->openDownsampleTiers(client);
+        if (!s.isOK()) {
+            return s;
+        }
+    }
+
     // Rotate as needed after we appended interim data to the archive file
     mgr->trimDirectory(files);
 
     return {std::move(mgr)};
 }
 
+Status FTDCFileManager::openDownsampleTiers(Client* client) {
+    for (const auto& spec : kDownsampleTiers) {
+        auto tier = stdx::make_unique<DownsampleTier>(&spec);
+        tier->updateConfig(*_config);
+
+        auto swMgr = create(&tier->config, _path / spec.directory, _rotateCollectors, client);
+        if (!swMgr.isOK()) {
+            return swMgr.getStatus();
+        }
+
+        tier->manager = std::move(swMgr.getValue());
+        tier->manager->_retention = spec.retention;
+
+        _downsampleTiers.push_back(std::move(tier));
+    }
+
+    return Status::OK();
+}
+
 std::vector<boost::filesystem::path> FTDCFileManager::scanDirectory() {
     std::vector<boost::filesystem::path> files;
 
@@ -205,10 +295,20 @@ Status FTDCFileManager::openArchiveFile(
     return Status::OK();
 }
 
+std::uint64_t FTDCFileManager::getMaxDirectorySizeBytes() const {
+    if (_downsampleTiers.empty()) {
+        return _config->maxDirectorySizeBytes;
+    }
+
+    return _config->maxDirectorySizeBytes * kFullResolutionQuotaPercent / 100;
+}
+
 void FTDCFileManager::trimDirectory(std::vector<boost::filesystem::path>& files) {
-    std::uint64_t maxSize = _config->maxDirectorySizeBytes;
+    std::uint64_t maxSize = getMaxDirectorySizeBytes();
     std::uint64_t size = 0;
 
+    std::time_t retainAfter = std::time(nullptr) - durationCount<Seconds>(_retention);
+
     dassert(std::is_sorted(files.begin(), files.end()));
 
     for (auto it = files.rbegin(); it != files.rend(); ++it) {
@@ -219,6 +319,17 @@ void FTDCFileManager::trimDirectory(std::vector<boost::filesystem::path>& files)
             LOG(1) << "Cleaning file over full-time diagnostic data capture quota, file: "
                    << (*it).generic_string() << " with size " << fileSize;
             boost::filesystem::remove(*it);
+            continue;
+        }
+
+        if (_retention > Seconds(0)) {
+            boost::system::error_code ec;
+            std::time_t lastWrite = boost::filesystem::last_write_time(*it, ec);
+            if (!ec && lastWrite < retainAfter) {
+                LOG(1) << "Cleaning file past full-time diagnostic data capture retention, file: "
+                       << (*it).generic_string();
+                boost::filesystem::remove(*it);
+            }
         }
     }
 }
@@ -299,6 +410,20 @@ Status FTDCFileManager::writeSampleAndRotateIfNeeded(Client* client,
         return s;
     }
 
+    for (auto& tier : _downsampleTiers) {
+        if (date < tier->nextSampleDate) {
+            continue;
+        }
+
+        tier->nextSampleDate = FTDCUtil::roundTime(date, tier->spec->interval);
+        tier->updateConfig(*_config);
+
+        s = tier->manager->writeSampleAndRotateIfNeeded(client, sample, date);
+        if (!s.isOK()) {
+            return s;
+        }
+    }
+
     if (_writer.getSize() > _config->maxFileSizeBytes) {
         return rotate(client);
     }
@@ -307,7 +432,16 @@ Status FTDCFileManager::writeSampleAndRotateIfNeeded(Client* client,
 }
 
 Status FTDCFileManager::close() {
-    return _writer.close();
+    Status status = _writer.close();
+
+    for (auto& tier : _downsampleTiers) {
+        Status s = tier->manager->close();
+        if (status.isOK()) {
+            status = s;
+        }
+    }
+
+    return status;
 }
 
 }  // namespace mongo
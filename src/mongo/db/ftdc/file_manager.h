@@ -50,6 +50,10 @@ class Client;
  * Manages a directory full of archive files, and an interim file.
  *
  * Manages file rotation, and directory size management.
+ *
+ * If FTDCConfig::downsampleEnabled is set, it also maintains one nested FTDCFileManager per
+ * downsampled resolution, each in its own subdirectory, and cascades every sample that starts a new
+ * interval of a resolution into it.
  */
 class FTDCFileManager {
     MONGO_DISALLOW_COPYING(FTDCFileManager);
@@ -116,10 +120,21 @@ private:
     std::vector<std::tuple<FTDCBSONUtil::FTDCType, BSONObj, Date_t>> recoverInterimFile();
 
     /**
-     * Removes the oldest files if the directory is over quota
+     * Removes the oldest files if the directory is over quota, and any files last written more than
+     * the retention period ago.
      */
     void trimDirectory(std::vector<boost::filesystem::path>& files);
 
+    /**
+     * Gets the part of the directory quota available to the files managed by this instance.
+     */
+    std::uint64_t getMaxDirectorySizeBytes() const;
+
+    /**
+     * Creates the file managers for the downsampled resolutions.
+     */
+    Status openDownsampleTiers(Client* client);
+
     /**
      * Open a new file for writing.
      *
@@ -153,6 +168,13 @@ private:
 
     // collection of collectors to add to new files on rotation, and server restart
     FTDCCollectorCollection* const _rotateCollectors;
+
+    // Files last written longer ago than this are removed on rotation, zero disables
+    Seconds _retention{0};
+
+    // File managers for the downsampled resolutions, finest first
+    struct DownsampleTier;
+    std::vector<std::unique_ptr<DownsampleTier>> _downsampleTiers;
 };
 
 }  // namespace mongo
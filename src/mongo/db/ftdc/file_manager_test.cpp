@@ -41,6 +41,7 @@
 #include "mongo/db/ftdc/collector.h"
 #include "mongo/db/ftdc/config.h"
 #include "mongo/db/ftdc/file_manager.h"
+#include "mongo/db/ftdc/file_reader.h"
 #include "mongo/db/ftdc/file_writer.h"
 #include "mongo/db/ftdc/ftdc_test.h"
 #include "mongo/db/jsobj.h"
@@ -385,4 +386,75 @@ TEST(FTDCFileManagerTest, TestNormalCrashInterim) {
     ValidateDocumentList(files[1], docs2);
 }
 
+// Read back the metric samples of all the archive files in a directory
+std::vector<BSONObj> readMetricSamples(const boost::filesystem::path& dir) {
+    std::vector<BSONObj> samples;
+
+    for (auto& file : scanDirectory(dir)) {
+        if (boost::filesystem::is_directory(file) ||
+            file.generic_string().find("interim") != std::string::npos) {
+            continue;
+        }
+
+        FTDCFileReader reader;
+        ASSERT_OK(reader.open(file));
+
+        auto sw = reader.hasNext();
+        for (; sw.isOK() && sw.getValue(); sw = reader.hasNext()) {
+            auto triplet = reader.next();
+            if (std::get<0>(triplet) == FTDCBSONUtil::FTDCType::kMetricChunk) {
+                samples.push_back(std::get<1>(triplet).getOwned());
+            }
+        }
+        ASSERT_OK(sw.getStatus());
+    }
+
+    return samples;
+}
+
+// Test that downsampling cascades one sample per interval into each downsampled resolution
+TEST(FTDCFileManagerTest, TestDownsample) {
+    Client* client = &cc();
+    FTDCConfig c;
+    c.downsampleEnabled = true;
+
+    unittest::TempDir tempdir("metrics_testpath");
+    boost::filesystem::path dir(tempdir.path());
+    createDirectoryClean(dir);
+
+    {
+        FTDCCollectorCollection rotate;
+        auto swMgr = FTDCFileManager::create(&c, dir, &rotate, client);
+        ASSERT_OK(swMgr.getStatus());
+        auto mgr = std::move(swMgr.getValue());
+
+        // Ten minutes of one second samples
+        for (int i = 0; i < 600; i++) {
+            ASSERT_OK(mgr->writeSampleAndRotateIfNeeded(
+                client,
+                BSON("name"
+                     << "joe"
+                     << "key1"
+                     << i),
+                Date_t::fromMillisSinceEpoch(i * 1000LL)));
+        }
+
+        ASSERT_OK(mgr->close());
+    }
+
+    ASSERT_EQUALS(600U, readMetricSamples(dir).size());
+
+    auto tenSecondSamples = readMetricSamples(dir / "downsampled.10s");
+    ASSERT_EQUALS(60U, tenSecondSamples.size());
+    for (size_t i = 0; i < tenSecondSamples.size(); i++) {
+        ASSERT_EQUALS(static_cast<int>(i * 10), tenSecondSamples[i]["key1"].numberInt());
+    }
+
+    auto minuteSamples = readMetricSamples(dir / "downsampled.60s");
+    ASSERT_EQUALS(10U, minuteSamples.size());
+    for (size_t i = 0; i < minuteSamples.size(); i++) {
+        ASSERT_EQUALS(static_cast<int>(i * 60), minuteSamples[i]["key1"].numberInt());
+    }
+}
+
 }  // namespace mongo
@@ -41,6 +41,7 @@
 #include "mongo/db/ftdc/collector.h"
 #include "mongo/db/ftdc/config.h"
 #include "mongo/db/ftdc/controller.h"
+#include "mongo/db/ftdc/ftdc_stack_sampler.h"
 #include "mongo/db/ftdc/ftdc_system_stats.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/repl/replication_coordinator.h"
@@ -245,6 +246,57 @@ public:
 
 } exportedFTDCInterimChunkSizeParameter;
 
+bool localDownsampleEnabled = FTDCConfig::kDownsampleEnabledDefault;
+
+ExportedServerParameter<bool, ServerParameterType::kStartupOnly> exportedFTDCDownsampleParameter(
+    ServerParameterSet::getGlobal(), "diagnosticDataCollectionDownsample", &localDownsampleEnabled);
+
+int localFullResolutionRetentionSecs = FTDCConfig::kFullResolutionRetentionSecsDefault;
+
+class ExportedFTDCFullResolutionRetentionParameter
+    : public ExportedServerParameter<int, ServerParameterType::kStartupOnly> {
+public:
+    ExportedFTDCFullResolutionRetentionParameter()
+        : ExportedServerParameter<int, ServerParameterType::kStartupOnly>(
+              ServerParameterSet::getGlobal(),
+              "diagnosticDataCollectionFullResolutionRetentionSecs",
+              &localFullResolutionRetentionSecs) {}
+
+    virtual Status validate(const int& potentialNewValue) {
+        if (potentialNewValue < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "diagnosticDataCollectionFullResolutionRetentionSecs must be greater "
+                          "than or equal to 0");
+        }
+
+        return Status::OK();
+    }
+
+} exportedFTDCFullResolutionRetentionParameter;
+
+int localCollectorTimeoutMillis = FTDCConfig::kCollectorTimeoutMillisDefault;
+
+class ExportedFTDCCollectorTimeoutParameter
+    : public ExportedServerParameter<int, ServerParameterType::kStartupOnly> {
+public:
+    ExportedFTDCCollectorTimeoutParameter()
+        : ExportedServerParameter<int, ServerParameterType::kStartupOnly>(
+              ServerParameterSet::getGlobal(),
+              "diagnosticDataCollectionCollectorTimeoutMillis",
+              &localCollectorTimeoutMillis) {}
+
+    virtual Status validate(const int& potentialNewValue) {
+        if (potentialNewValue < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "diagnosticDataCollectionCollectorTimeoutMillis must be greater than or "
+                          "equal to 0");
+        }
+
+        return Status::OK();
+    }
+
+} exportedFTDCCollectorTimeoutParameter;
+
 class FTDCSimpleInternalCommandCollector final : public FTDCCollectorInterface {
 public:
     FTDCSimpleInternalCommandCollector(StringData command,
@@ -299,6 +351,9 @@ void startFTDC() {
     config.maxDirectorySizeBytes = localMaxDirectorySizeMB.load() * 1024 * 1024;
     config.maxSamplesPerArchiveMetricChunk = localMaxSamplesPerArchiveMetricChunk.load();
     config.maxSamplesPerInterimMetricChunk = localMaxSamplesPerInterimMetricChunk.load();
+    config.downsampleEnabled = localDownsampleEnabled;
+    config.fullResolutionRetention = Seconds(localFullResolutionRetentionSecs);
+    config.collectorTimeout = Milliseconds(localCollectorTimeoutMillis);
 
     auto controller = stdx::make_unique<FTDCController>(dir, config);
 
@@ -312,11 +367,15 @@ void startFTDC() {
     // migration status. This section triggers too many schema changes in the serverStatus which
     // hurt ftdc compression efficiency, because its output varies depending on the list of active
     // migrations.
+    // The "collectionCache" section is empty unless collectionCacheStatsTopN is set. It reports a
+    // fixed number of collections with the same fields each, so it keeps the schema stable until
+    // the set of collections changes.
     controller->addPeriodicCollector(stdx::make_unique<FTDCSimpleInternalCommandCollector>(
         "serverStatus",
         "serverStatus",
         "",
-        BSON("serverStatus" << 1 << "tcMalloc" << true << "sharding" << false)));
+        BSON("serverStatus" << 1 << "tcMalloc" << true << "sharding" << false << "collectionCache"
+                            << true)));
 
     // These metrics are only collected if replication is enabled
     if (repl::getGlobalReplicationCoordinator()->getReplicationMode() !=
@@ -337,6 +396,9 @@ void startFTDC() {
     // Install System Metric Collector as a periodic collector
     installSystemMetricsCollector(controller.get());
 
+    // Install the stack sampler as a periodic collector if it was enabled
+    installStackSamplerCollector(controller.get());
+
     // Install file rotation collectors
     // These are collected on each file rotation.
 
@@ -361,6 +423,8 @@ void startFTDC() {
 }
 
 void stopFTDC() {
+    stopStackSampler();
+
     auto controller = getGlobalFTDCController();
 
     if (controller) {
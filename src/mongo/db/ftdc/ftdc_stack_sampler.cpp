@@ -0,0 +1,381 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kFTDC
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/ftdc/ftdc_stack_sampler.h"
+
+#include <algorithm>
+#include <array>
+#include <unordered_map>
+#include <utility>
+
+#include "mongo/config.h"
+#include "mongo/db/ftdc/collector.h"
+#include "mongo/db/ftdc/controller.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/hex.h"
+#include "mongo/util/log.h"
+#include "mongo/util/time_support.h"
+
+#if defined(__linux__) && defined(MONGO_CONFIG_HAVE_EXECINFO_BACKTRACE)
+#include <cerrno>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <signal.h>
+#include <sys/time.h>
+#include <time.h>
+#define MONGO_FTDC_STACK_SAMPLER_SUPPORTED
+#endif
+
+namespace mongo {
+
+namespace {
+
+class ExportedStackSamplingHzParameter
+    : public ExportedServerParameter<int, ServerParameterType::kStartupOnly> {
+public:
+    ExportedStackSamplingHzParameter()
+        : ExportedServerParameter<int, ServerParameterType::kStartupOnly>(
+              ServerParameterSet::getGlobal(),
+              "diagnosticDataCollectionStackSamplingHz",
+              &_value) {}
+
+    Status validate(const int& potentialNewValue) override {
+        if (potentialNewValue < 0 || potentialNewValue > 1000) {
+            return Status(ErrorCodes::BadValue,
+                          "diagnosticDataCollectionStackSamplingHz must be between 0 and 1000");
+        }
+        return Status::OK();
+    }
+
+    int value() const {
+        return _value;
+    }
+
+private:
+    // Stack sampling is disabled by default.
+    int _value = 0;
+} stackSamplingHz;
+
+// The CPU time the sampler may use, as a percentage of one core. The sampling rate is halved
+// whenever a collection finds it was exceeded.
+MONGO_EXPORT_SERVER_PARAMETER(diagnosticDataCollectionStackSamplingMaxCpuPercent, double, 1.0);
+
+// The length of the windows over which samples are aggregated before their stacks are reported.
+// Stacks are only reported once per window to limit the schema changes of the FTDC documents.
+MONGO_EXPORT_SERVER_PARAMETER(diagnosticDataCollectionStackSamplingWindowSecs, int, 60);
+
+}  // namespace
+
+FoldedStackTable::FoldedStackTable(size_t maxStacks) : _maxStacks(maxStacks) {}
+
+void FoldedStackTable::add(const std::vector<std::string>& frames) {
+    std::string folded;
+    for (const auto& frame : frames) {
+        if (!folded.empty()) {
+            folded += ';';
+        }
+        folded += frame;
+    }
+
+    ++_samples;
+    auto it = _counts.find(folded);
+    if (it != _counts.end()) {
+        ++it->second;
+    } else if (_counts.size() < _maxStacks * 8) {
+        _counts[folded] = 1;
+    } else {
+        ++_untrackedSamples;
+    }
+}
+
+void FoldedStackTable::append(BSONObjBuilder* builder) const {
+    std::vector<std::pair<StringData, long long>> sorted;
+    for (const auto& entry : _counts) {
+        sorted.emplace_back(entry.first, entry.second);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    });
+
+    long long otherSamples = _untrackedSamples;
+    BSONObjBuilder stacksBuilder(builder->subobjStart("stacks"));
+    for (size_t i = 0; i < sorted.size(); ++i) {
+        if (i < _maxStacks) {
+            stacksBuilder.appendNumber(sorted[i].first, sorted[i].second);
+        } else {
+            otherSamples += sorted[i].second;
+        }
+    }
+    stacksBuilder.doneFast();
+    builder->appendNumber("otherSamples", otherSamples);
+}
+
+void FoldedStackTable::clear() {
+    _counts.clear();
+    _samples = 0;
+    _untrackedSamples = 0;
+}
+
+#if defined(MONGO_FTDC_STACK_SAMPLER_SUPPORTED)
+
+namespace {
+
+// The number of stacks reported at the end of each window.
+const size_t kMaxReportedStacks = 100;
+
+const int kMaxFrames = 32;
+
+// The frames of the signal handler and of the signal trampoline which are left out of samples.
+const int kSkipFrames = 2;
+
+const size_t kMaxPendingSamples = 512;
+
+enum SlotState : int { kFree, kWriting, kReady };
+
+/**
+ * A sample written by the signal handler and not yet consumed by the collector. The state of the
+ * slot hands it over between the two, so that the handler never blocks.
+ */
+struct PendingSample {
+    AtomicInt32 state{kFree};
+    int numFrames{0};
+    void* frames[kMaxFrames];
+};
+
+std::array<PendingSample, kMaxPendingSamples> pendingSamples;
+AtomicUInt32 nextPendingSample;
+AtomicInt64 droppedSamples;
+AtomicInt64 sampleHandlerNanos;
+
+long long clockNanos(clockid_t clock) {
+    struct timespec ts;
+    if (clock_gettime(clock, &ts) != 0) {
+        return 0;
+    }
+    return ts.tv_sec * 1000LL * 1000LL * 1000LL + ts.tv_nsec;
+}
+
+/**
+ * SIGPROF is delivered to the thread whose CPU time expired the profiling timer, so the samples
+ * are distributed across threads in proportion to the CPU they consume.
+ *
+ * Only uses async-signal-safe operations, assuming backtrace() was already called once outside of
+ * a signal handler to load the unwinder.
+ */
+void sampleHandler(int) {
+    const int savedErrno = errno;
+    const long long start = clockNanos(CLOCK_MONOTONIC);
+
+    auto& slot = pendingSamples[nextPendingSample.fetchAndAdd(1) % kMaxPendingSamples];
+    if (slot.state.compareAndSwap(kFree, kWriting) == kFree) {
+        void* frames[kMaxFrames + kSkipFrames];
+        const int numFrames = backtrace(frames, kMaxFrames + kSkipFrames) - kSkipFrames;
+        slot.numFrames = std::max(numFrames, 0);
+        std::copy(frames + kSkipFrames, frames + kSkipFrames + slot.numFrames, slot.frames);
+        slot.state.store(kReady);
+    } else {
+        droppedSamples.fetchAndAdd(1);
+    }
+
+    sampleHandlerNanos.fetchAndAdd(clockNanos(CLOCK_MONOTONIC) - start);
+    errno = savedErrno;
+}
+
+void setSamplingRate(int hz) {
+    struct itimerval timer = {};
+    if (hz > 0) {
+        timer.it_interval.tv_sec = 0;
+        timer.it_interval.tv_usec = 1000 * 1000 / hz;
+        timer.it_value = timer.it_interval;
+    }
+    if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+        const int savedErrno = errno;
+        warning() << "Failed to set the stack sampling rate to " << hz
+                  << "Hz: " << errnoWithDescription(savedErrno);
+    }
+}
+
+/**
+ * Consumes the samples taken by the signal handler on every FTDC collection, and reports them in
+ * folded stack form once per window.
+ */
+class StackSamplerCollector final : public FTDCCollectorInterface {
+public:
+    explicit StackSamplerCollector(int hz)
+        : _maxHz(hz), _hz(hz), _stacks(kMaxReportedStacks), _windowStart(Date_t::now()) {
+        _lastCollect = _windowStart;
+    }
+
+    std::string name() const override {
+        return "stackSamples";
+    }
+
+    void collect(OperationContext* opCtx, BSONObjBuilder& builder) override {
+        const long long collectStart = clockNanos(CLOCK_THREAD_CPUTIME_ID);
+        const Date_t now = Date_t::now();
+
+        long long samples = 0;
+        for (auto& slot : pendingSamples) {
+            if (slot.state.load() != kReady) {
+                continue;
+            }
+
+            std::vector<std::string> frames;
+            for (int i = slot.numFrames - 1; i >= 0; --i) {
+                frames.push_back(_symbolize(slot.frames[i]));
+            }
+            slot.state.store(kFree);
+
+            _stacks.add(frames);
+            ++samples;
+        }
+
+        builder.appendNumber("samples", samples);
+        builder.appendNumber("dropped", droppedSamples.swap(0));
+
+        if (now - _windowStart >= Seconds(diagnosticDataCollectionStackSamplingWindowSecs.load())) {
+            _stacks.append(&builder);
+            _stacks.clear();
+            _windowStart = now;
+        }
+
+        // Enforce the CPU budget over both the signal handler and the collection itself.
+        const long long spentNanos =
+            sampleHandlerNanos.swap(0) + clockNanos(CLOCK_THREAD_CPUTIME_ID) - collectStart;
+        const double budgetNanos = durationCount<Milliseconds>(now - _lastCollect) * 1000.0 *
+            1000.0 * diagnosticDataCollectionStackSamplingMaxCpuPercent.load() / 100.0;
+        _lastCollect = now;
+
+        if (spentNanos > budgetNanos && _hz > 1) {
+            _hz /= 2;
+            ++_throttled;
+            setSamplingRate(_hz);
+        } else if (spentNanos * 4 < budgetNanos && _hz < _maxHz) {
+            _hz = std::min(_hz * 2, _maxHz);
+            setSamplingRate(_hz);
+        }
+
+        builder.append("hz", _hz);
+        builder.appendNumber("throttled", _throttled);
+    }
+
+private:
+    // Bounds the memory used by the symbol cache, whose entries are never reused once stacks
+    // through dynamically generated code stop being sampled.
+    static const size_t kMaxCachedSymbols = 64 * 1024;
+
+    const std::string& _symbolize(void* address) {
+        auto it = _symbols.find(address);
+        if (it != _symbols.end()) {
+            return it->second;
+        }
+
+        if (_symbols.size() >= kMaxCachedSymbols) {
+            _symbols.clear();
+        }
+
+        std::string symbol;
+        Dl_info info;
+        const bool found = dladdr(address, &info) != 0;
+        if (found && info.dli_sname) {
+            symbol = info.dli_sname;
+        } else if (found && info.dli_fname) {
+            StringData file(info.dli_fname);
+            symbol = file.substr(file.rfind('/') + 1).toString() + "+0x" +
+                integerToHex(reinterpret_cast<uintptr_t>(address) -
+                             reinterpret_cast<uintptr_t>(info.dli_fbase));
+        } else {
+            symbol = "0x" + integerToHex(reinterpret_cast<uintptr_t>(address));
+        }
+        return _symbols[address] = std::move(symbol);
+    }
+
+    const int _maxHz;
+    int _hz;
+    long long _throttled{0};
+
+    FoldedStackTable _stacks;
+    Date_t _windowStart;
+    Date_t _lastCollect;
+
+    std::unordered_map<void*, std::string> _symbols;
+};
+
+}  // namespace
+
+void installStackSamplerCollector(FTDCController* controller) {
+    const int hz = stackSamplingHz.value();
+    if (hz == 0) {
+        return;
+    }
+
+    // The first call to backtrace() loads the unwinder, which is not async-signal-safe.
+    void* frames[1];
+    backtrace(frames, 1);
+
+    struct sigaction action = {};
+    action.sa_handler = sampleHandler;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGPROF, &action, nullptr) != 0) {
+        const int savedErrno = errno;
+        warning() << "Failed to install the stack sampling signal handler: "
+                  << errnoWithDescription(savedErrno);
+        return;
+    }
+
+    controller->addPeriodicCollector(stdx::make_unique<StackSamplerCollector>(hz));
+    setSamplingRate(hz);
+}
+
+void stopStackSampler() {
+    if (stackSamplingHz.value() > 0) {
+        setSamplingRate(0);
+    }
+}
+
+#else
+
+void installStackSamplerCollector(FTDCController* controller) {
+    if (stackSamplingHz.value() > 0) {
+        warning() << "diagnosticDataCollectionStackSamplingHz is ignored, stack sampling is not "
+                     "supported on this platform";
+    }
+}
+
+void stopStackSampler() {}
+
+#endif
+
+}  // namespace mongo
@@ -0,0 +1,98 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+class FTDCController;
+
+/**
+ * Counts stack samples by their folded form, the frames of the stack from the outermost caller to
+ * the innermost callee joined by ';', which is the input format of flame graph tools.
+ *
+ * Only a bounded number of distinct stacks are tracked. Samples of further stacks are counted as
+ * "other" samples.
+ *
+ * Not Thread-Safe.
+ */
+class FoldedStackTable {
+public:
+    /**
+     * 'maxStacks' is the number of stacks reported by append(). Eight times as many are tracked.
+     */
+    explicit FoldedStackTable(size_t maxStacks);
+
+    /**
+     * Adds one sample of the stack made of 'frames', ordered from the outermost caller to the
+     * innermost callee.
+     */
+    void add(const std::vector<std::string>& frames);
+
+    /**
+     * Appends the 'maxStacks' stacks sampled most often as a "stacks" subobject mapping each
+     * folded stack to its count, and the count of all other samples as "otherSamples".
+     */
+    void append(BSONObjBuilder* builder) const;
+
+    /**
+     * Forgets every sample.
+     */
+    void clear();
+
+    long long samples() const {
+        return _samples;
+    }
+
+private:
+    const size_t _maxStacks;
+    StringMap<long long> _counts;
+    long long _samples{0};
+    long long _untrackedSamples{0};
+};
+
+/**
+ * Installs a periodic collector which reports folded stacks of the threads consuming CPU, if stack
+ * sampling was enabled with the diagnosticDataCollectionStackSamplingHz startup parameter and the
+ * platform supports it.
+ */
+void installStackSamplerCollector(FTDCController* controller);
+
+/**
+ * Stops sampling stacks, if sampling was started.
+ */
+void stopStackSampler();
+
+}  // namespace mongo
@@ -0,0 +1,101 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/ftdc/ftdc_stack_sampler.h"
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(FoldedStackTableTest, FoldsFramesFromCallerToCallee) {
+    FoldedStackTable table(10);
+    table.add({"main", "run", "find"});
+    table.add({"main", "run", "find"});
+    table.add({"main", "run", "insert"});
+    ASSERT_EQUALS(3, table.samples());
+
+    BSONObjBuilder builder;
+    table.append(&builder);
+    BSONObj obj = builder.obj();
+    ASSERT_BSONOBJ_EQ(BSON("main;run;find" << 2 << "main;run;insert" << 1),
+                      obj["stacks"].Obj());
+    ASSERT_EQUALS(0, obj["otherSamples"].numberLong());
+}
+
+TEST(FoldedStackTableTest, ReportsOnlyTheMostSampledStacks) {
+    FoldedStackTable table(2);
+    for (int i = 0; i < 3; ++i) {
+        table.add({"a"});
+    }
+    for (int i = 0; i < 2; ++i) {
+        table.add({"b"});
+    }
+    table.add({"c"});
+
+    BSONObjBuilder builder;
+    table.append(&builder);
+    BSONObj obj = builder.obj();
+    ASSERT_BSONOBJ_EQ(BSON("a" << 3 << "b" << 2), obj["stacks"].Obj());
+    ASSERT_EQUALS(1, obj["otherSamples"].numberLong());
+}
+
+TEST(FoldedStackTableTest, CountsSamplesOfUntrackedStacksAsOther) {
+    FoldedStackTable table(1);
+    for (int i = 0; i < 8; ++i) {
+        table.add({std::to_string(i)});
+    }
+    table.add({"untracked"});
+    table.add({"0"});
+    ASSERT_EQUALS(10, table.samples());
+
+    BSONObjBuilder builder;
+    table.append(&builder);
+    BSONObj obj = builder.obj();
+    ASSERT_BSONOBJ_EQ(BSON("0" << 2), obj["stacks"].Obj());
+    ASSERT_EQUALS(8, obj["otherSamples"].numberLong());
+}
+
+TEST(FoldedStackTableTest, ClearForgetsEverySample) {
+    FoldedStackTable table(10);
+    table.add({"main"});
+    table.clear();
+    ASSERT_EQUALS(0, table.samples());
+
+    BSONObjBuilder builder;
+    table.append(&builder);
+    BSONObj obj = builder.obj();
+    ASSERT_TRUE(obj["stacks"].Obj().isEmpty());
+    ASSERT_EQUALS(0, obj["otherSamples"].numberLong());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -62,6 +62,7 @@ const char kFTDCDocsField[] = "docs";
 
 const char kFTDCCollectStartField[] = "start";
 const char kFTDCCollectEndField[] = "end";
+const char kFTDCCollectDurationField[] = "durationMicros";
 
 const std::int64_t FTDCConfig::kPeriodMillisDefault = 1000;
 
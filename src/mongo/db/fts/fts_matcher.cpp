@@ -80,7 +80,7 @@ bool FTSMatcher::hasPositiveTerm(const BSONObj& obj) const {
 }
 
 bool FTSMatcher::_hasPositiveTerm_string(const FTSLanguage* language, const string& raw) const {
-    std::unique_ptr<FTSTokenizer> tokenizer(language->createTokenizer());
+    FTSTokenizer* tokenizer = _getTokenizer(language);
     tokenizer->reset(raw.c_str(), _getTokenizerOptions());
 
     while (tokenizer->moveNext()) {
@@ -110,7 +110,7 @@ bool FTSMatcher::hasNegativeTerm(const BSONObj& obj) const {
 }
 
 bool FTSMatcher::_hasNegativeTerm_string(const FTSLanguage* language, const string& raw) const {
-    std::unique_ptr<FTSTokenizer> tokenizer(language->createTokenizer());
+    FTSTokenizer* tokenizer = _getTokenizer(language);
     tokenizer->reset(raw.c_str(), _getTokenizerOptions());
 
     while (tokenizer->moveNext()) {
@@ -165,6 +165,14 @@ bool FTSMatcher::_phraseMatch(const string& phrase, const BSONObj& obj) const {
     return false;
 }
 
+FTSTokenizer* FTSMatcher::_getTokenizer(const FTSLanguage* language) const {
+    std::unique_ptr<FTSTokenizer>& tokenizer = _tokenizers[language];
+    if (!tokenizer) {
+        tokenizer = language->createTokenizer();
+    }
+    return tokenizer.get();
+}
+
 FTSTokenizer::Options FTSMatcher::_getTokenizerOptions() const {
     FTSTokenizer::Options tokenizerOptions = FTSTokenizer::kNone;
 
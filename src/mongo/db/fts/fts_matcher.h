@@ -30,6 +30,9 @@
 
 #pragma once
 
+#include <map>
+#include <memory>
+
 #include "mongo/db/fts/fts_query_impl.h"
 #include "mongo/db/fts/fts_spec.h"
 #include "mongo/db/fts/fts_tokenizer.h"
@@ -108,9 +111,18 @@ private:
      */
     FTSTokenizer::Options _getTokenizerOptions() const;
 
+    /**
+     * Returns a tokenizer for 'language', creating one the first time a language is seen. Reusing
+     * them avoids setting up a new stemmer for every string matched.
+     */
+    FTSTokenizer* _getTokenizer(const FTSLanguage* language) const;
+
     // TODO These should be unowned pointers instead of owned copies.
     const FTSQueryImpl _query;
     const FTSSpec _spec;
+
+    // Tokenizers for each document language seen so far.
+    mutable std::map<const FTSLanguage*, std::unique_ptr<FTSTokenizer>> _tokenizers;
 };
 }
 }
@@ -131,6 +131,35 @@ TEST(FTSMatcher, ParsesUsingDocLanguage) {
                                   << "gladly")));
 }
 
+// Test that a matcher gives the same answers when it sees documents in several languages, in any
+// order.
+TEST(FTSMatcher, MatchesDocumentsInSeveralLanguages) {
+    FTSQueryImpl q;
+    q.setQuery("-run");
+    q.setLanguage("english");
+    q.setCaseSensitive(false);
+    q.setDiacriticSensitive(false);
+    ASSERT(q.parse(TEXT_INDEX_VERSION_3).isOK());
+    FTSMatcher m(q,
+                 FTSSpec(assertGet(FTSSpec::fixSpec(BSON("key" << BSON("x"
+                                                                       << "text"))))));
+
+    for (int i = 0; i < 3; i++) {
+        ASSERT(m.hasNegativeTerm(BSON("x"
+                                      << "running")));
+        ASSERT_FALSE(m.hasNegativeTerm(BSON("x"
+                                            << "running"
+                                            << "language"
+                                            << "none")));
+        ASSERT_FALSE(m.hasNegativeTerm(BSON("x"
+                                            << "walking")));
+        ASSERT_FALSE(m.hasNegativeTerm(BSON("x"
+                                            << "the dog runs"
+                                            << "language"
+                                            << "none")));
+    }
+}
+
 // Test the matcher does not filter out stop words from positive terms
 TEST(FTSMatcher, MatcherDoesNotFilterStopWordsNeg) {
     FTSQueryImpl q;
@@ -181,9 +181,16 @@ void FTSSpec::scoreDocument(const BSONObj& obj, TermFrequencyMap* term_freqs) co
 
     FTSElementIterator it(*this, obj);
 
+    // Reuse the tokenizer, and its stemmer, while the language doesn't change.
+    const FTSLanguage* tokenizerLanguage = nullptr;
+    std::unique_ptr<FTSTokenizer> tokenizer;
+
     while (it.more()) {
         FTSIteratorValue val = it.next();
-        std::unique_ptr<FTSTokenizer> tokenizer(val._language->createTokenizer());
+        if (val._language != tokenizerLanguage) {
+            tokenizer = val._language->createTokenizer();
+            tokenizerLanguage = val._language;
+        }
         _scoreStringV2(tokenizer.get(), val._text, term_freqs, val._weight);
     }
 }
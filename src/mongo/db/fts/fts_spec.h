@@ -52,7 +52,7 @@ extern const double MAX_WORD_WEIGHT;
 extern const double DEFAULT_WEIGHT;
 
 typedef std::map<std::string, double> Weights;  // TODO cool map
-typedef unordered_map<std::string, double> TermFrequencyMap;
+typedef StringMap<double> TermFrequencyMap;
 
 struct ScoreHelperStruct {
     ScoreHelperStruct() : freq(0), count(0), exp(0) {}
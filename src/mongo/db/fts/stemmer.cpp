@@ -54,6 +54,10 @@ StringData Stemmer::stem(StringData word) const {
     if (!_stemmer)
         return word;
 
+    StringMap<std::string>::const_iterator cached = _cache.find(word);
+    if (cached != _cache.end())
+        return cached->second;
+
     const sb_symbol* sb_sym =
         sb_stemmer_stem(_stemmer, (const sb_symbol*)word.rawData(), word.size());
 
@@ -62,7 +66,12 @@ StringData Stemmer::stem(StringData word) const {
         invariant(false);
     }
 
-    return StringData((const char*)(sb_sym), sb_stemmer_length(_stemmer));
+    if (_cache.size() >= kMaxCachedStems)
+        _cache.clear();
+
+    std::string& stemmed = _cache[word];
+    stemmed.assign(reinterpret_cast<const char*>(sb_sym), sb_stemmer_length(_stemmer));
+    return stemmed;
 }
 }
 }
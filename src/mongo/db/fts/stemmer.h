@@ -31,8 +31,11 @@
 
 #pragma once
 
+#include <string>
+
 #include "mongo/base/string_data.h"
 #include "mongo/db/fts/fts_language.h"
+#include "mongo/util/string_map.h"
 #include "third_party/libstemmer_c/include/libstemmer.h"
 
 namespace mongo {
@@ -61,7 +64,14 @@ public:
     StringData stem(StringData word) const;
 
 private:
+    // The number of stems to remember before the cache is emptied.
+    static const size_t kMaxCachedStems = 4096;
+
     struct sb_stemmer* _stemmer;
+
+    // Maps recently stemmed words to their stems. Words repeat often within and across the
+    // documents a stemmer sees, and a lookup is much cheaper than running the stemmer.
+    mutable StringMap<std::string> _cache;
 };
 }
 }
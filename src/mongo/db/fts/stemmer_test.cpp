@@ -48,5 +48,25 @@ TEST(English, Caps) {
     ASSERT_EQUALS("unit", s.stem("united"));
     ASSERT_EQUALS("Unite", s.stem("United"));
 }
+
+TEST(English, RepeatedWords) {
+    Stemmer s(&languageEnglishV2);
+    for (int i = 0; i < 3; i++) {
+        ASSERT_EQUALS("run", s.stem("running"));
+        ASSERT_EQUALS("Run", s.stem("Running"));
+        ASSERT_EQUALS("unit", s.stem("united"));
+    }
+}
+
+TEST(English, ManyDistinctWords) {
+    // Stem more distinct words than the stemmer caches, and check that results stay correct
+    // after its cache is emptied.
+    Stemmer s(&languageEnglishV2);
+    for (int i = 0; i < 10000; i++) {
+        std::string word = "running" + std::to_string(i);
+        ASSERT_EQUALS(word, s.stem(word));
+        ASSERT_EQUALS("run", s.stem("running"));
+    }
+}
 }
 }
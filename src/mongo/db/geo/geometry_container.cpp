@@ -227,7 +227,7 @@ const R2Region& GeometryContainer::getR2Region() const {
     return *_r2Region;
 }
 
-bool GeometryContainer::contains(const GeometryContainer& otherContainer) const {
+bool GeometryContainer::contains(const PointWithCRS& otherPoint) const {
     // First let's deal with the FLAT cases
 
     if (_point && FLAT == _point->crs) {
@@ -235,36 +235,50 @@ bool GeometryContainer::contains(const GeometryContainer& otherContainer) const
     }
 
     if (NULL != _polygon && (FLAT == _polygon->crs)) {
-        if (NULL == otherContainer._point) {
-            return false;
-        }
-        return _polygon->oldPolygon.contains(otherContainer._point->oldPoint);
+        return _polygon->oldPolygon.contains(otherPoint.oldPoint);
     }
 
     if (NULL != _box) {
         verify(FLAT == _box->crs);
-        if (NULL == otherContainer._point) {
-            return false;
-        }
-        return _box->box.inside(otherContainer._point->oldPoint);
+        return _box->box.inside(otherPoint.oldPoint);
     }
 
     if (NULL != _cap && (FLAT == _cap->crs)) {
-        if (NULL == otherContainer._point) {
-            return false;
-        }
         // Let's be as consistent epsilon-wise as we can with the '2d' indextype.
-        return distanceWithin(
-            _cap->circle.center, otherContainer._point->oldPoint, _cap->circle.radius);
+        return distanceWithin(_cap->circle.center, otherPoint.oldPoint, _cap->circle.radius);
     }
 
     // Now we deal with all the SPHERE stuff.
+    return contains(otherPoint.cell, otherPoint.point);
+}
 
-    // Iterate over the other thing and see if we contain it all.
+bool GeometryContainer::contains(const GeometryContainer& otherContainer) const {
     if (NULL != otherContainer._point) {
-        return contains(otherContainer._point->cell, otherContainer._point->point);
+        return contains(*otherContainer._point);
+    }
+
+    // First let's deal with the FLAT cases. Only points can be within a FLAT geometry.
+
+    if (_point && FLAT == _point->crs) {
+        return false;
     }
 
+    if (NULL != _polygon && (FLAT == _polygon->crs)) {
+        return false;
+    }
+
+    if (NULL != _box) {
+        verify(FLAT == _box->crs);
+        return false;
+    }
+
+    if (NULL != _cap && (FLAT == _cap->crs)) {
+        return false;
+    }
+
+    // Now we deal with all the SPHERE stuff.
+
+    // Iterate over the other thing and see if we contain it all.
     if (NULL != otherContainer._line) {
         return contains(otherContainer._line->line);
     }
@@ -525,9 +539,13 @@ bool GeometryContainer::contains(const S2Polygon& otherPolygon) const {
     return false;
 }
 
+bool GeometryContainer::intersects(const PointWithCRS& otherPoint) const {
+    return intersects(otherPoint.cell);
+}
+
 bool GeometryContainer::intersects(const GeometryContainer& otherContainer) const {
     if (NULL != otherContainer._point) {
-        return intersects(otherContainer._point->cell);
+        return intersects(*otherContainer._point);
     } else if (NULL != otherContainer._line) {
         return intersects(otherContainer._line->line);
     } else if (NULL != otherContainer._polygon) {
@@ -101,6 +101,12 @@ public:
      */
     bool contains(const GeometryContainer& otherContainer) const;
 
+    /**
+     * Same as contains(const GeometryContainer&) for a container holding only 'otherPoint', which
+     * must be in the CRS of this geometry or in FLAT if this geometry is.
+     */
+    bool contains(const PointWithCRS& otherPoint) const;
+
     /**
      * To check intersection, we iterate over the otherContainer's geometries, checking each
      * geometry to see if we intersect it.  If we intersect one geometry, we intersect the
@@ -108,6 +114,11 @@ public:
      */
     bool intersects(const GeometryContainer& otherContainer) const;
 
+    /**
+     * Same as intersects(const GeometryContainer&) for a container holding only 'otherPoint'.
+     */
+    bool intersects(const PointWithCRS& otherPoint) const;
+
     // Region which can be used to generate a covering of the query object in the S2 space.
     bool hasS2Region() const;
     const S2Region& getS2Region() const;
@@ -427,6 +427,19 @@ Status GeoParser::parseStoredPoint(const BSONElement& elem, PointWithCRS* out) {
     return parsePoint(elem, out, true);
 }
 
+bool GeoParser::parseStoredPointOnly(const BSONElement& elem, PointWithCRS* out) {
+    if (!elem.isABSONObj())
+        return false;
+
+    BSONObj obj = elem.Obj();
+    if (Array == elem.type() || obj.firstElement().isNumber()) {
+        // Stored legacy points may have additional fields, as in parseFromStorage().
+        return parseLegacyPoint(elem, out, true).isOK();
+    }
+
+    return GEOJSON_POINT == parseGeoJSONType(obj) && parseGeoJSONPoint(obj, out).isOK();
+}
+
 Status GeoParser::parseQueryPoint(const BSONElement& elem, PointWithCRS* out) {
     return parsePoint(elem, out, false);
 }
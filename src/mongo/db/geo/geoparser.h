@@ -96,6 +96,11 @@ public:
     static Status parseQueryPoint(const BSONElement& elem, PointWithCRS* out);
     static Status parseStoredPoint(const BSONElement& elem, PointWithCRS* out);
     static bool parsePointWithMaxDistance(const BSONObj& obj, PointWithCRS* out, double* maxOut);
+
+    // Parses a stored legacy or GeoJSON point exactly as GeometryContainer::parseFromStorage()
+    // would. Returns false if 'elem' is any other geometry or is not valid, in which case callers
+    // should fall back to a GeometryContainer.
+    static bool parseStoredPointOnly(const BSONElement& elem, PointWithCRS* out);
 };
 
 }  // namespace mongo
@@ -35,9 +35,12 @@
 #include "mongo/db/hasher.h"
 
 
+#include "mongo/bson/util/builder.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/util/assert_util.h"
 #include "mongo/util/md5.hpp"
 #include "mongo/util/startup_test.h"
+#include "third_party/murmurhash3/MurmurHash3.h"
 
 namespace mongo {
 
@@ -79,7 +82,31 @@ void Hasher::finish(HashDigest out) {
     md5_finish(&_md5State, out);
 }
 
-void recursiveHash(Hasher* h, const BSONElement& e, bool includeFieldName) {
+/**
+ * Collects the canonicalized input to hash it with MurmurHash3 at once, since the bundled
+ * implementation can't be fed incrementally. Small keys never leave the stack.
+ */
+class Murmur3Hasher {
+    MONGO_DISALLOW_COPYING(Murmur3Hasher);
+
+public:
+    explicit Murmur3Hasher(HashSeed seed) : _seed(seed) {}
+
+    void addData(const void* keyData, size_t numBytes) {
+        _buf.appendBuf(keyData, numBytes);
+    }
+
+    void finish(HashDigest out) {
+        MurmurHash3_x64_128(_buf.buf(), _buf.len(), static_cast<uint32_t>(_seed), out);
+    }
+
+private:
+    StackBufBuilder _buf;
+    HashSeed _seed;
+};
+
+template <typename H>
+void recursiveHash(H* h, const BSONElement& e, bool includeFieldName) {
     int canonicalType = endian::nativeToLittle(e.canonicalType());
     h->addData(&canonicalType, sizeof(canonicalType));
 
@@ -122,6 +149,9 @@ struct HasherUnitTest : public StartupTest {
         // Hard-coded check to ensure the hash function is consistent across platforms
         BSONObj o = BSON("check" << 42);
         verify(BSONElementHasher::hash64(o.firstElement(), 0) == -944302157085130861LL);
+        verify(BSONElementHasher::hash64(
+                   o.firstElement(), 0, BSONElementHasher::MURMUR3_HASH_VERSION) ==
+               8715208212397937794LL);
     }
 } hasherUnitTest;
 
@@ -137,4 +167,20 @@ long long int BSONElementHasher::hash64(const BSONElement& e, HashSeed seed) {
     return digestView.read<LittleEndian<long long int>>();
 }
 
+long long int BSONElementHasher::hash64(const BSONElement& e, HashSeed seed, int hashVersion) {
+    if (hashVersion == MD5_HASH_VERSION) {
+        return hash64(e, seed);
+    }
+    invariant(hashVersion == MURMUR3_HASH_VERSION);
+
+    Murmur3Hasher h(seed);
+    recursiveHash(&h, e, false);
+    HashDigest d;
+    h.finish(d);
+    // MurmurHash3 stores its two 64-bit halves in native byte order, so read the first one back
+    // the same way to get the same value on every platform.
+    ConstDataView digestView(reinterpret_cast<const char*>(d));
+    return digestView.read<long long int>();
+}
+
 }  // namespace mongo
@@ -54,6 +54,17 @@ public:
      */
     static const int DEFAULT_HASH_SEED = 0;
 
+    /* The hash functions that hashed indexes may use, recorded as "hashVersion" in the index
+     * spec. Version 0 is an MD5 digest and remains the default, so that existing hashed indexes
+     * and hashed shard keys keep their values. Version 1 is the much cheaper MurmurHash3.
+     */
+    static const int MD5_HASH_VERSION = 0;
+    static const int MURMUR3_HASH_VERSION = 1;
+
+    static bool isSupportedHashVersion(int hashVersion) {
+        return hashVersion == MD5_HASH_VERSION || hashVersion == MURMUR3_HASH_VERSION;
+    }
+
     /* This computes a 64-bit hash of the value part of BSONElement "e",
      * preceded by the seed "seed".  Squashes element (and any sub-elements)
      * of the same canonical type, so hash({a:{b:4}}) will be the same
@@ -68,6 +79,11 @@ public:
      */
     static long long int hash64(const BSONElement& e, HashSeed seed);
 
+    /* Like the above, but with the hash function of 'hashVersion', which must be supported.
+     * Both versions hash the same canonicalized bytes, so they squash the same values.
+     */
+    static long long int hash64(const BSONElement& e, HashSeed seed, int hashVersion);
+
 private:
     BSONElementHasher();
 };
@@ -359,5 +359,49 @@ TEST(BSONElementHasher, HashCodeWScope) {
     ASSERT_EQUALS(hashIt(o), 501342939894575968LL);
 }
 
+long long murmur3HashIt(const BSONObj& object, int seed = 0) {
+    return BSONElementHasher::hash64(
+        object.firstElement(), seed, BSONElementHasher::MURMUR3_HASH_VERSION);
+}
+
+TEST(BSONElementHasher, DefaultHashVersionIsMD5) {
+    BSONObj o = BSON("check" << 42);
+    ASSERT_EQUALS(
+        hashIt(o),
+        BSONElementHasher::hash64(o.firstElement(), 0, BSONElementHasher::MD5_HASH_VERSION));
+}
+
+TEST(BSONElementHasher, Murmur3HashIsStable) {
+    ASSERT_EQUALS(murmur3HashIt(BSON("check" << 42)), 8715208212397937794LL);
+}
+
+TEST(BSONElementHasher, Murmur3HashDiffersFromMD5Hash) {
+    BSONObj o = BSON("check" << 42);
+    ASSERT_NOT_EQUALS(hashIt(o), murmur3HashIt(o));
+}
+
+TEST(BSONElementHasher, Murmur3HashSquashesNumericTypes) {
+    ASSERT_EQUALS(murmur3HashIt(BSON("a" << 3)), murmur3HashIt(BSON("a" << 3LL)));
+    ASSERT_EQUALS(murmur3HashIt(BSON("a" << 3)), murmur3HashIt(BSON("a" << 3.1)));
+    ASSERT_NOT_EQUALS(murmur3HashIt(BSON("a" << 3)), murmur3HashIt(BSON("a" << 4)));
+}
+
+TEST(BSONElementHasher, Murmur3HashIgnoresFieldNameButNotSubobjectFieldNames) {
+    ASSERT_EQUALS(murmur3HashIt(BSON("a" << 1)), murmur3HashIt(BSON("b" << 1)));
+    ASSERT_NOT_EQUALS(murmur3HashIt(BSON("a" << BSON("b" << 1))),
+                      murmur3HashIt(BSON("a" << BSON("c" << 1))));
+}
+
+TEST(BSONElementHasher, Murmur3SeedMatters) {
+    ASSERT_NOT_EQUALS(murmur3HashIt(BSON("a" << 4), 0), murmur3HashIt(BSON("a" << 4), 1));
+}
+
+TEST(BSONElementHasher, Murmur3HashesLargeValues) {
+    // Larger than the stack buffer the input is collected in.
+    const std::string big(10 * 1024, 'x');
+    ASSERT_NOT_EQUALS(murmur3HashIt(BSON("a" << big)), murmur3HashIt(BSON("a" << big + "y")));
+    ASSERT_EQUALS(murmur3HashIt(BSON("a" << big)), murmur3HashIt(BSON("b" << big)));
+}
+
 }  // namespace
 }  // namespace mongo
@@ -32,6 +32,7 @@
 
 #include "mongo/base/status.h"
 #include "mongo/base/status_with.h"
+#include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/keypattern.h"
 
@@ -39,6 +40,8 @@ namespace mongo {
 
 using std::vector;
 
+namespace dps = ::mongo::dotted_path_support;
+
 // Standard Btree implementation below.
 BtreeAccessMethod::BtreeAccessMethod(IndexCatalogEntry* btreeState, SortedDataInterface* btree)
     : IndexAccessMethod(btreeState, btree) {
@@ -59,6 +62,10 @@ BtreeAccessMethod::BtreeAccessMethod(IndexCatalogEntry* btreeState, SortedDataIn
                                             _descriptor->isSparse(),
                                             btreeState->getCollator());
     massert(16745, "Invalid index version for key generation.", _keyGenerator);
+
+    const size_t lookupsPerField =
+        _descriptor->version() == IndexDescriptor::IndexVersion::kV0 ? 1 : 2;
+    _numTopLevelFieldLookups = lookupsPerField * fieldNames.size();
 }
 
 void BtreeAccessMethod::doGetKeys(const BSONObj& obj,
@@ -67,4 +74,10 @@ void BtreeAccessMethod::doGetKeys(const BSONObj& obj,
     _keyGenerator->getKeys(obj, keys, multikeyPaths);
 }
 
+void BtreeAccessMethod::doGetKeysFromFieldTable(const dps::TopLevelFieldTable& fields,
+                                                BSONObjSet* keys,
+                                                MultikeyPaths* multikeyPaths) const {
+    _keyGenerator->getKeys(fields, keys, multikeyPaths);
+}
+
 }  // namespace mongo
@@ -47,11 +47,23 @@ class BtreeAccessMethod : public IndexAccessMethod {
 public:
     BtreeAccessMethod(IndexCatalogEntry* btreeState, SortedDataInterface* btree);
 
+    size_t numTopLevelFieldLookups() const final {
+        return _numTopLevelFieldLookups;
+    }
+
 private:
     void doGetKeys(const BSONObj& obj, BSONObjSet* keys, MultikeyPaths* multikeyPaths) const final;
 
+    void doGetKeysFromFieldTable(const dotted_path_support::TopLevelFieldTable& fields,
+                                 BSONObjSet* keys,
+                                 MultikeyPaths* multikeyPaths) const final;
+
     // Our keys differ for V0 and V1.
     std::unique_ptr<BtreeKeyGenerator> _keyGenerator;
+
+    // Key generation looks up the first component of each indexed field in the document, and V1
+    // key generation looks it up twice.
+    size_t _numTopLevelFieldLookups;
 };
 
 }  // namespace mongo
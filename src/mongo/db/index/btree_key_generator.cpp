@@ -85,9 +85,22 @@ std::unique_ptr<BtreeKeyGenerator> BtreeKeyGenerator::make(IndexVersion indexVer
 void BtreeKeyGenerator::getKeys(const BSONObj& obj,
                                 BSONObjSet* keys,
                                 MultikeyPaths* multikeyPaths) const {
+    _getKeys(obj, nullptr, keys, multikeyPaths);
+}
+
+void BtreeKeyGenerator::getKeys(const dps::TopLevelFieldTable& fields,
+                                BSONObjSet* keys,
+                                MultikeyPaths* multikeyPaths) const {
+    _getKeys(fields.obj(), &fields, keys, multikeyPaths);
+}
+
+void BtreeKeyGenerator::_getKeys(const BSONObj& obj,
+                                 const dps::TopLevelFieldTable* fields,
+                                 BSONObjSet* keys,
+                                 MultikeyPaths* multikeyPaths) const {
     // '_fieldNames' and '_fixed' are passed by value so that they can be mutated as part of the
     // getKeys call.  :|
-    getKeysImpl(_fieldNames, _fixed, obj, keys, multikeyPaths);
+    getKeysImpl(_fieldNames, _fixed, obj, fields, keys, multikeyPaths);
     if (keys->empty() && !_isSparse) {
         keys->insert(_nullKey);
     }
@@ -107,6 +120,7 @@ BtreeKeyGeneratorV0::BtreeKeyGeneratorV0(std::vector<const char*> fieldNames,
 void BtreeKeyGeneratorV0::getKeysImpl(std::vector<const char*> fieldNames,
                                       std::vector<BSONElement> fixed,
                                       const BSONObj& obj,
+                                      const dps::TopLevelFieldTable* fields,
                                       BSONObjSet* keys,
                                       MultikeyPaths* multikeyPaths) const {
     if (_isIdIndex) {
@@ -128,11 +142,18 @@ void BtreeKeyGeneratorV0::getKeysImpl(std::vector<const char*> fieldNames,
     unsigned arrIdx = ~0;
     unsigned numNotFound = 0;
 
+    boost::optional<dps::TopLevelFieldTable> ownFields;
+    if (!fields && dps::TopLevelFieldTable::shouldBuild(obj, fieldNames.size())) {
+        ownFields.emplace(obj);
+        fields = ownFields.get_ptr();
+    }
+
     for (unsigned i = 0; i < fieldNames.size(); ++i) {
         if (*fieldNames[i] == '\0')
             continue;
 
-        BSONElement e = dps::extractElementAtPathOrArrayAlongPath(obj, fieldNames[i]);
+        BSONElement e = fields ? dps::extractElementAtPathOrArrayAlongPath(*fields, fieldNames[i])
+                               : dps::extractElementAtPathOrArrayAlongPath(obj, fieldNames[i]);
 
         if (e.eoo()) {
             e = nullElt;  // no matching field
@@ -208,7 +229,8 @@ void BtreeKeyGeneratorV0::getKeysImpl(std::vector<const char*> fieldNames,
             while (i.more()) {
                 BSONElement e = i.next();
                 if (e.type() == Object) {
-                    getKeysImpl(fieldNames, fixed, e.embeddedObject(), keys, multikeyPaths);
+                    getKeysImpl(
+                        fieldNames, fixed, e.embeddedObject(), nullptr, keys, multikeyPaths);
                 }
             }
         } else {
@@ -249,11 +271,13 @@ BtreeKeyGeneratorV1::BtreeKeyGeneratorV1(std::vector<const char*> fieldNames,
 }
 
 BSONElement BtreeKeyGeneratorV1::extractNextElement(const BSONObj& obj,
+                                                    const dps::TopLevelFieldTable* fields,
                                                     const PositionalPathInfo& positionalInfo,
                                                     const char** field,
                                                     bool* arrayNestedArray) const {
-    std::string firstField = mongoutils::str::before(*field, '.');
-    bool haveObjField = !obj.getField(firstField).eoo();
+    StringData firstField = *field;
+    firstField = firstField.substr(0, firstField.find('.'));
+    bool haveObjField = !(fields ? fields->getField(firstField) : obj.getField(firstField)).eoo();
     BSONElement arrField = positionalInfo.positionallyIndexedElt;
 
     // An index component field name cannot exist in both a document
@@ -269,7 +293,8 @@ BSONElement BtreeKeyGeneratorV1::extractNextElement(const BSONObj& obj,
 
     *arrayNestedArray = false;
     if (haveObjField) {
-        return dps::extractElementAtPathOrArrayAlongPath(obj, *field);
+        return fields ? dps::extractElementAtPathOrArrayAlongPath(*fields, *field)
+                      : dps::extractElementAtPathOrArrayAlongPath(obj, *field);
     } else if (positionalInfo.hasPositionallyIndexedElt()) {
         if (arrField.type() == Array) {
             *arrayNestedArray = true;
@@ -301,6 +326,7 @@ void BtreeKeyGeneratorV1::_getKeysArrEltFixed(std::vector<const char*>* fieldNam
     getKeysImplWithArray(*fieldNames,
                          *fixed,
                          arrEntry.type() == Object ? arrEntry.embeddedObject() : BSONObj(),
+                         nullptr,
                          keys,
                          numNotFound,
                          positionalInfo,
@@ -310,6 +336,7 @@ void BtreeKeyGeneratorV1::_getKeysArrEltFixed(std::vector<const char*>* fieldNam
 void BtreeKeyGeneratorV1::getKeysImpl(std::vector<const char*> fieldNames,
                                       std::vector<BSONElement> fixed,
                                       const BSONObj& obj,
+                                      const dps::TopLevelFieldTable* fields,
                                       BSONObjSet* keys,
                                       MultikeyPaths* multikeyPaths) const {
     if (_isIdIndex) {
@@ -343,14 +370,21 @@ void BtreeKeyGeneratorV1::getKeysImpl(std::vector<const char*> fieldNames,
         invariant(multikeyPaths->empty());
         multikeyPaths->resize(fieldNames.size());
     }
-    getKeysImplWithArray(
-        std::move(fieldNames), std::move(fixed), obj, keys, 0, _emptyPositionalInfo, multikeyPaths);
+    getKeysImplWithArray(std::move(fieldNames),
+                         std::move(fixed),
+                         obj,
+                         fields,
+                         keys,
+                         0,
+                         _emptyPositionalInfo,
+                         multikeyPaths);
 }
 
 void BtreeKeyGeneratorV1::getKeysImplWithArray(
     std::vector<const char*> fieldNames,
     std::vector<BSONElement> fixed,
     const BSONObj& obj,
+    const dps::TopLevelFieldTable* fields,
     BSONObjSet* keys,
     unsigned numNotFound,
     const std::vector<PositionalPathInfo>& positionalInfo,
@@ -383,6 +417,19 @@ void BtreeKeyGeneratorV1::getKeysImplWithArray(
     // std::vector<boost::optional<size_t>>{{1U}, boost::none}.
     std::vector<boost::optional<size_t>> arrComponents(fieldNames.size());
 
+    boost::optional<dps::TopLevelFieldTable> ownFields;
+    if (!fields) {
+        // Each indexed field still to be extracted from 'obj' looks up its first component twice.
+        size_t numLookups = 0;
+        for (const char* fieldName : fieldNames) {
+            numLookups += *fieldName == '\0' ? 0 : 2;
+        }
+        if (dps::TopLevelFieldTable::shouldBuild(obj, numLookups)) {
+            ownFields.emplace(obj);
+            fields = ownFields.get_ptr();
+        }
+    }
+
     bool mayExpandArrayUnembedded = true;
     for (size_t i = 0; i < fieldNames.size(); ++i) {
         if (*fieldNames[i] == '\0') {
@@ -392,7 +439,7 @@ void BtreeKeyGeneratorV1::getKeysImplWithArray(
         bool arrayNestedArray;
         // Extract element matching fieldName[ i ] from object xor array.
         BSONElement e =
-            extractNextElement(obj, positionalInfo[i], &fieldNames[i], &arrayNestedArray);
+            extractNextElement(obj, fields, positionalInfo[i], &fieldNames[i], &arrayNestedArray);
 
         if (e.eoo()) {
             // if field not present, set to null
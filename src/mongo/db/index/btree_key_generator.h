@@ -39,6 +39,10 @@
 
 namespace mongo {
 
+namespace dotted_path_support {
+class TopLevelFieldTable;
+}  // namespace dotted_path_support
+
 class CollatorInterface;
 
 /**
@@ -61,6 +65,15 @@ public:
 
     void getKeys(const BSONObj& obj, BSONObjSet* keys, MultikeyPaths* multikeyPaths) const;
 
+    /**
+     * Same as above for the object 'fields.obj()', looking up its top-level fields in 'fields'.
+     * This lets a caller generating the keys of one document for several indexes pay for a single
+     * pass over the document's fields.
+     */
+    void getKeys(const dotted_path_support::TopLevelFieldTable& fields,
+                 BSONObjSet* keys,
+                 MultikeyPaths* multikeyPaths) const;
+
 protected:
     // These are used by the getKeysImpl(s) below.
     std::vector<const char*> _fieldNames;
@@ -70,9 +83,18 @@ protected:
     BSONSizeTracker _sizeTracker;
 
 private:
+    void _getKeys(const BSONObj& obj,
+                  const dotted_path_support::TopLevelFieldTable* fields,
+                  BSONObjSet* keys,
+                  MultikeyPaths* multikeyPaths) const;
+
+    /**
+     * If 'fields' is not null, it is a table of the top-level fields of 'obj'.
+     */
     virtual void getKeysImpl(std::vector<const char*> fieldNames,
                              std::vector<BSONElement> fixed,
                              const BSONObj& obj,
+                             const dotted_path_support::TopLevelFieldTable* fields,
                              BSONObjSet* keys,
                              MultikeyPaths* multikeyPaths) const = 0;
 
@@ -98,6 +120,7 @@ private:
     void getKeysImpl(std::vector<const char*> fieldNames,
                      std::vector<BSONElement> fixed,
                      const BSONObj& obj,
+                     const dotted_path_support::TopLevelFieldTable* fields,
                      BSONObjSet* keys,
                      MultikeyPaths* multikeyPaths) const final;
 };
@@ -182,6 +205,7 @@ private:
     void getKeysImpl(std::vector<const char*> fieldNames,
                      std::vector<BSONElement> fixed,
                      const BSONObj& obj,
+                     const dotted_path_support::TopLevelFieldTable* fields,
                      BSONObjSet* keys,
                      MultikeyPaths* multikeyPaths) const final;
 
@@ -191,6 +215,7 @@ private:
     void getKeysImplWithArray(std::vector<const char*> fieldNames,
                               std::vector<BSONElement> fixed,
                               const BSONObj& obj,
+                              const dotted_path_support::TopLevelFieldTable* fields,
                               BSONObjSet* keys,
                               unsigned numNotFound,
                               const std::vector<PositionalPathInfo>& positionalInfo,
@@ -200,6 +225,9 @@ private:
      * traverses the path '*field' in 'obj' until either reaching the end of the path or an array
      * element.
      *
+     * If 'fields' is not null, it is a table of the top-level fields of 'obj' and is used to look
+     * up the first component of '*field'.
+     *
      * The 'positionalInfo' arg is used for handling a field path where 'obj' has an
      * array indexed by position. See the comments for PositionalPathInfo for more detail.
      *
@@ -229,6 +257,7 @@ private:
      *   the second array element.
      */
     BSONElement extractNextElement(const BSONObj& obj,
+                                   const dotted_path_support::TopLevelFieldTable* fields,
                                    const PositionalPathInfo& positionalInfo,
                                    const char** field,
                                    bool* arrayNestedArray) const;
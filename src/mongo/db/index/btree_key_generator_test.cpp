@@ -36,10 +36,12 @@
 #include <iostream>
 
 #include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/json.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
 
 using namespace mongo;
 using std::unique_ptr;
@@ -47,6 +49,8 @@ using std::cout;
 using std::endl;
 using std::vector;
 
+namespace dps = ::mongo::dotted_path_support;
+
 namespace {
 
 //
@@ -171,6 +175,56 @@ TEST(BtreeKeyGeneratorTest, GetKeysFromObjectSimple) {
     ASSERT(testKeygen(keyPattern, genKeysFrom, expectedKeys, expectedMultikeyPaths));
 }
 
+TEST(BtreeKeyGeneratorTest, GetKeysFromObjectWithManyFields) {
+    BSONObjBuilder bob;
+    for (int i = 0; i < 500; ++i) {
+        bob.append(str::stream() << "f" << i, i);
+    }
+    bob.append("a", BSON("b" << 1));
+    bob.append("arr", BSON_ARRAY(BSON("c" << 1) << BSON("c" << 2)));
+    BSONObj genKeysFrom = bob.obj();
+
+    BSONObj keyPattern = fromjson("{f499: 1, 'a.b': 1, f0: 1, missing: 1, 'arr.c': 1}");
+    BSONObjSet expectedKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    expectedKeys.insert(fromjson("{'': 499, '': 1, '': 0, '': null, '': 1}"));
+    expectedKeys.insert(fromjson("{'': 499, '': 1, '': 0, '': null, '': 2}"));
+    MultikeyPaths expectedMultikeyPaths{
+        std::set<size_t>{}, std::set<size_t>{}, std::set<size_t>{}, std::set<size_t>{}, {0U}};
+    ASSERT(testKeygen(keyPattern, genKeysFrom, expectedKeys, expectedMultikeyPaths));
+}
+
+TEST(BtreeKeyGeneratorTest, GetKeysFromSharedFieldTable) {
+    BSONObj genKeysFrom = fromjson(
+        "{x: 1, a: {b: [1, 2]}, c: [{d: 1}, {d: [3, 4]}], e: 'foo', f: {g: {h: 5}}, i: null}");
+    dps::TopLevelFieldTable fields(genKeysFrom);
+
+    // Keys generated through a table of the document's fields, shared by all of the indexes, are
+    // the same as the keys each index generates on its own.
+    for (auto&& keyPattern : {fromjson("{'a.b': 1, e: 1}"),
+                              fromjson("{'c.d': 1, 'f.g.h': 1, x: 1}"),
+                              fromjson("{'c.1.d': 1, missing: 1}"),
+                              fromjson("{i: 1, 'i.j': 1, 'e.k': 1}")}) {
+        vector<const char*> fieldNames;
+        vector<BSONElement> fixed;
+        for (auto&& elt : keyPattern) {
+            fieldNames.push_back(elt.fieldName());
+            fixed.push_back(BSONElement());
+        }
+        BtreeKeyGeneratorV1 keyGen(fieldNames, fixed, false, nullptr);
+
+        BSONObjSet expectedKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        MultikeyPaths expectedMultikeyPaths;
+        keyGen.getKeys(genKeysFrom, &expectedKeys, &expectedMultikeyPaths);
+
+        BSONObjSet actualKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        MultikeyPaths actualMultikeyPaths;
+        keyGen.getKeys(fields, &actualKeys, &actualMultikeyPaths);
+
+        ASSERT(keysetsEqual(expectedKeys, actualKeys)) << keyPattern;
+        ASSERT(expectedMultikeyPaths == actualMultikeyPaths) << keyPattern;
+    }
+}
+
 TEST(BtreeKeyGeneratorTest, GetKeysFromObjectDotted) {
     BSONObj keyPattern = fromjson("{'a.b': 1}");
     BSONObj genKeysFrom = fromjson("{a: {b: 4}, c: 'foo'}");
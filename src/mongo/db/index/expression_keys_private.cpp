@@ -84,6 +84,17 @@ void addKey(const string& root, const BSONElement& e, BSONObjSet* keys) {
 Status S2GetKeysForElement(const BSONElement& element,
                            const S2IndexingParams& params,
                            vector<S2CellId>* out) {
+    // Since version 3, a point is indexed by the leaf cell holding it, which is all a covering of
+    // it at kPointIndexedLevel would give. Skip the container and the coverer for points.
+    PointWithCRS point;
+    if (params.indexVersion >= S2_INDEX_VERSION_3 &&
+        GeoParser::parseStoredPointOnly(element, &point) &&
+        ShapeProjection::supportsProject(point, SPHERE)) {
+        ShapeProjection::projectInto(&point, SPHERE);
+        out->push_back(point.cell.id());
+        return Status::OK();
+    }
+
     GeometryContainer geoContainer;
     Status status = geoContainer.parseFromStorage(element);
     if (!status.isOK())
@@ -375,8 +386,10 @@ void ExpressionKeysPrivate::getHashKeys(const BSONObj& obj,
 
 // static
 long long int ExpressionKeysPrivate::makeSingleHashKey(const BSONElement& e, HashSeed seed, int v) {
-    massert(16767, "Only HashVersion 0 has been defined", v == 0);
-    return BSONElementHasher::hash64(e, seed);
+    massert(16767,
+            str::stream() << "Unsupported hashVersion " << v,
+            BSONElementHasher::isSupportedHashVersion(v));
+    return BSONElementHasher::hash64(e, seed, v);
 }
 
 // static
@@ -44,6 +44,13 @@ public:
         return _ftsSpec;
     }
 
+    /**
+     * Tokenizing and stemming every text field dominates inserting into a text index.
+     */
+    bool hasExpensiveKeyGeneration() const final {
+        return true;
+    }
+
 private:
     /**
      * Fills 'keys' with the keys that should be generated for 'obj' on this index.
@@ -30,6 +30,7 @@
 #include "mongo/db/hasher.h"
 #include "mongo/db/index/expression_keys_private.h"
 #include "mongo/db/index/expression_params.h"
+#include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
 
@@ -48,6 +49,13 @@ HashAccessMethod::HashAccessMethod(IndexCatalogEntry* btreeState, SortedDataInte
 
     ExpressionParams::parseHashParams(descriptor->infoObj(), &_seed, &_hashVersion, &_hashedField);
 
+    uassert(40663,
+            str::stream() << "Unsupported hashVersion " << _hashVersion
+                          << " for a hashed index. Supported versions are "
+                          << BSONElementHasher::MD5_HASH_VERSION << " (MD5) and "
+                          << BSONElementHasher::MURMUR3_HASH_VERSION << " (MurmurHash3).",
+            BSONElementHasher::isSupportedHashVersion(_hashVersion));
+
     _collator = btreeState->getCollator();
 }
 
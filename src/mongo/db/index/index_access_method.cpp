@@ -32,22 +32,31 @@
 
 #include "mongo/db/index/btree_access_method.h"
 
+#include <algorithm>
+#include <exception>
+#include <system_error>
 #include <utility>
 #include <vector>
 
 #include "mongo/base/error_codes.h"
 #include "mongo/base/status.h"
+#include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/client.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop.h"
+#include "mongo/db/index/index_build_side_writes.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/keypattern.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/db/storage/record_store.h"
 #include "mongo/db/storage/storage_options.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/processinfo.h"
 #include "mongo/util/progress_meter.h"
 
 namespace mongo {
@@ -59,6 +68,8 @@ using std::vector;
 
 using IndexVersion = IndexDescriptor::IndexVersion;
 
+namespace dps = ::mongo::dotted_path_support;
+
 namespace {
 
 /**
@@ -71,10 +82,18 @@ bool isMultikeyFromPaths(const MultikeyPaths& multikeyPaths) {
                        [](const std::set<std::size_t>& components) { return !components.empty(); });
 }
 
+// Each thread generating the keys of a batch of inserted documents should get at least this many
+// bytes of documents, so that starting the thread pays off.
+const size_t kMinBytesPerKeyGenerationThread = 256 * 1024;
+
 }  // namespace
 
 MONGO_EXPORT_SERVER_PARAMETER(failIndexKeyTooLong, bool, true);
 
+// Maximum number of threads generating the keys of a batch of inserted documents for an index
+// with expensive key generation, such as a text index
+MONGO_EXPORT_SERVER_PARAMETER(maxInsertKeyGenerationThreads, int, 4);
+
 //
 // Comparison for external sorter interface
 //
@@ -125,13 +144,23 @@ Status IndexAccessMethod::insert(OperationContext* opCtx,
                                  const BSONObj& obj,
                                  const RecordId& loc,
                                  const InsertDeleteOptions& options,
-                                 int64_t* numInserted) {
+                                 int64_t* numInserted,
+                                 const dps::TopLevelFieldTable* fields) {
     invariant(numInserted);
     *numInserted = 0;
     BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
     MultikeyPaths multikeyPaths;
     // Delegate to the subclass.
-    getKeys(obj, options.getKeysMode, &keys, &multikeyPaths);
+    _getKeys(obj, fields, options.getKeysMode, &keys, &multikeyPaths);
+
+    if (_sideWrites) {
+        _recordSideWrites(opCtx, {}, std::vector<BSONObj>(keys.begin(), keys.end()), loc);
+        *numInserted = keys.size();
+        if (*numInserted > 1 || isMultikeyFromPaths(multikeyPaths)) {
+            _btreeState->setMultikey(opCtx, multikeyPaths);
+        }
+        return Status::OK();
+    }
 
     Status ret = Status::OK();
     for (BSONObjSet::const_iterator i = keys.begin(); i != keys.end(); ++i) {
@@ -174,6 +203,117 @@ Status IndexAccessMethod::insert(OperationContext* opCtx,
     return ret;
 }
 
+Status IndexAccessMethod::insertBatch(
+    OperationContext* opCtx,
+    const std::vector<BsonRecord>& bsonRecords,
+    const InsertDeleteOptions& options,
+    int64_t* numInserted,
+    const std::vector<const dps::TopLevelFieldTable*>* fieldTables) {
+    invariant(numInserted);
+    invariant(!fieldTables || fieldTables->size() == bsonRecords.size());
+    *numInserted = 0;
+
+    if (_sideWrites) {
+        // The keys are recorded rather than inserted, so there is nothing to order.
+        for (size_t i = 0; i < bsonRecords.size(); ++i) {
+            int64_t recordKeysInserted;
+            Status status = insert(opCtx,
+                                   *bsonRecords[i].docPtr,
+                                   bsonRecords[i].id,
+                                   options,
+                                   &recordKeysInserted,
+                                   fieldTables ? (*fieldTables)[i] : nullptr);
+            if (!status.isOK()) {
+                return status;
+            }
+            *numInserted += recordKeysInserted;
+        }
+        return Status::OK();
+    }
+
+    // Generate the keys of every document, remembering which document each key came from.
+    std::vector<BSONObjSet> docKeys(bsonRecords.size(),
+                                    SimpleBSONObjComparator::kInstance.makeBSONObjSet());
+    std::vector<MultikeyPaths> multikeyPaths(bsonRecords.size());
+    _getKeysForBatch(bsonRecords, fieldTables, options.getKeysMode, &docKeys, &multikeyPaths);
+
+    std::vector<BtreeExternalSortComparison::Data> keys;
+    std::vector<size_t> keyRecords;
+    for (size_t i = 0; i < bsonRecords.size(); ++i) {
+        for (const auto& key : docKeys[i]) {
+            keys.emplace_back(key, bsonRecords[i].id);
+            keyRecords.push_back(i);
+        }
+    }
+
+    // Put the keys in index order, so that the storage engine sees monotonic inserts.
+    std::vector<size_t> order(keys.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    const BtreeExternalSortComparison comparator(_descriptor->keyPattern(),
+                                                 _descriptor->version());
+    std::sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+        return comparator(keys[lhs], keys[rhs]) < 0;
+    });
+
+    std::vector<IndexKeyEntry> entries;
+    entries.reserve(order.size());
+    for (size_t i : order) {
+        entries.emplace_back(keys[i].first, keys[i].second);
+    }
+
+    std::vector<Status> statuses;
+    _newInterface->insertKeys(opCtx, entries, options.dupsAllowed, &statuses);
+    invariant(statuses.size() == entries.size());
+
+    std::vector<int64_t> recordKeysInserted(bsonRecords.size(), 0);
+    for (size_t i = 0; i < entries.size(); ++i) {
+        const Status& status = statuses[i];
+
+        // Everything's OK, carry on.
+        if (status.isOK()) {
+            ++recordKeysInserted[keyRecords[order[i]]];
+            continue;
+        }
+
+        // Error cases.
+
+        if (status.code() == ErrorCodes::KeyTooLong && ignoreKeyTooLong(opCtx)) {
+            continue;
+        }
+
+        if (status.code() == ErrorCodes::DuplicateKeyValue) {
+            // A document might be indexed multiple times during a background index build
+            // if it moves ahead of the collection scan cursor (e.g. via an update).
+            if (!_btreeState->isReady(opCtx)) {
+                LOG(3) << "key " << entries[i].key
+                       << " already in index during background indexing (ok)";
+                continue;
+            }
+        }
+
+        // Clean up after ourselves. Every key was attempted, so this includes the keys ordered
+        // after the failed one.
+        for (size_t j = 0; j < entries.size(); ++j) {
+            if (statuses[j].isOK()) {
+                removeOneKey(opCtx, entries[j].key, entries[j].loc, options.dupsAllowed);
+            }
+        }
+
+        return status;
+    }
+
+    for (size_t i = 0; i < bsonRecords.size(); ++i) {
+        if (recordKeysInserted[i] > 1 || isMultikeyFromPaths(multikeyPaths[i])) {
+            _btreeState->setMultikey(opCtx, multikeyPaths[i]);
+        }
+        *numInserted += recordKeysInserted[i];
+    }
+
+    return Status::OK();
+}
+
 void IndexAccessMethod::removeOneKey(OperationContext* opCtx,
                                      const BSONObj& key,
                                      const RecordId& loc,
@@ -213,6 +353,12 @@ Status IndexAccessMethod::remove(OperationContext* opCtx,
     MultikeyPaths* multikeyPaths = nullptr;
     getKeys(obj, options.getKeysMode, &keys, multikeyPaths);
 
+    if (_sideWrites) {
+        _recordSideWrites(opCtx, std::vector<BSONObj>(keys.begin(), keys.end()), {}, loc);
+        *numDeleted = keys.size();
+        return Status::OK();
+    }
+
     for (BSONObjSet::const_iterator i = keys.begin(); i != keys.end(); ++i) {
         removeOneKey(opCtx, *i, loc, options.dupsAllowed);
         ++*numDeleted;
@@ -289,6 +435,10 @@ bool IndexAccessMethod::appendCustomStats(OperationContext* opCtx,
     return _newInterface->appendCustomStats(opCtx, output, scale);
 }
 
+bool IndexAccessMethod::appendCacheStats(OperationContext* opCtx, BSONObjBuilder* output) const {
+    return _newInterface->appendCacheStats(opCtx, output);
+}
+
 long long IndexAccessMethod::getSpaceUsedBytes(OperationContext* opCtx) const {
     return _newInterface->getSpaceUsedBytes(opCtx);
 }
@@ -335,17 +485,20 @@ Status IndexAccessMethod::validateUpdate(OperationContext* opCtx,
                                          const RecordId& record,
                                          const InsertDeleteOptions& options,
                                          UpdateTicket* ticket,
-                                         const MatchExpression* indexFilter) {
+                                         const MatchExpression* indexFilter,
+                                         const dps::TopLevelFieldTable* fromFields,
+                                         const dps::TopLevelFieldTable* toFields) {
     if (!indexFilter || indexFilter->matchesBSON(from)) {
         // There's no need to compute the prefixes of the indexed fields that possibly caused the
         // index to be multikey when the old version of the document was written since the index
         // metadata isn't updated when keys are deleted.
         MultikeyPaths* multikeyPaths = nullptr;
-        getKeys(from, options.getKeysMode, &ticket->oldKeys, multikeyPaths);
+        _getKeys(from, fromFields, options.getKeysMode, &ticket->oldKeys, multikeyPaths);
     }
 
     if (!indexFilter || indexFilter->matchesBSON(to)) {
-        getKeys(to, options.getKeysMode, &ticket->newKeys, &ticket->newMultikeyPaths);
+        _getKeys(
+            to, toFields, options.getKeysMode, &ticket->newKeys, &ticket->newMultikeyPaths);
     }
 
     ticket->loc = record;
@@ -377,6 +530,13 @@ Status IndexAccessMethod::update(OperationContext* opCtx,
         _btreeState->setMultikey(opCtx, ticket.newMultikeyPaths);
     }
 
+    if (_sideWrites) {
+        _recordSideWrites(opCtx, ticket.removed, ticket.added, ticket.loc);
+        *numInserted = ticket.added.size();
+        *numDeleted = ticket.removed.size();
+        return Status::OK();
+    }
+
     for (size_t i = 0; i < ticket.removed.size(); ++i) {
         _newInterface->unindex(opCtx, ticket.removed[i], ticket.loc, ticket.dupsAllowed);
     }
@@ -461,14 +621,62 @@ Status IndexAccessMethod::commitBulk(OperationContext* opCtx,
                                      bool mayInterrupt,
                                      bool dupsAllowed,
                                      set<RecordId>* dupsToDrop) {
+    std::vector<std::unique_ptr<BulkBuilder>> bulks;
+    bulks.push_back(std::move(bulk));
+    return commitBulk(opCtx, std::move(bulks), mayInterrupt, dupsAllowed, dupsToDrop);
+}
+
+Status IndexAccessMethod::commitBulk(OperationContext* opCtx,
+                                     std::vector<std::unique_ptr<BulkBuilder>> bulks,
+                                     bool mayInterrupt,
+                                     bool dupsAllowed,
+                                     set<RecordId>* dupsToDrop,
+                                     BSONObjSet* duplicateKeys) {
+    invariant(!bulks.empty());
+
     Timer timer;
 
-    std::unique_ptr<BulkBuilder::Sorter::Iterator> i(bulk->_sorter->done());
+    int64_t keysInserted = 0;
+    bool everGeneratedMultipleKeys = false;
+    MultikeyPaths indexMultikeyPaths;
+
+    std::vector<std::shared_ptr<BulkBuilder::Sorter::Iterator>> sortedRuns;
+    for (const auto& bulk : bulks) {
+        sortedRuns.emplace_back(bulk->_sorter->done());
+
+        keysInserted += bulk->_keysInserted;
+        everGeneratedMultipleKeys = everGeneratedMultipleKeys || bulk->_everGeneratedMultipleKeys;
+
+        if (bulk->_indexMultikeyPaths.empty()) {
+            continue;
+        }
+        if (indexMultikeyPaths.empty()) {
+            indexMultikeyPaths = bulk->_indexMultikeyPaths;
+            continue;
+        }
+        invariant(indexMultikeyPaths.size() == bulk->_indexMultikeyPaths.size());
+        for (size_t j = 0; j < indexMultikeyPaths.size(); ++j) {
+            indexMultikeyPaths[j].insert(bulk->_indexMultikeyPaths[j].begin(),
+                                         bulk->_indexMultikeyPaths[j].end());
+        }
+    }
+
+    // The keys of each builder are sorted independently, so if there is more than one they need to
+    // be merged in order to be fed to the index in key order
+    std::shared_ptr<BulkBuilder::Sorter::Iterator> i;
+    if (sortedRuns.size() == 1) {
+        i = std::move(sortedRuns.front());
+    } else {
+        i.reset(BulkBuilder::Sorter::Iterator::merge(
+            sortedRuns,
+            SortOptions(),
+            BtreeExternalSortComparison(_descriptor->keyPattern(), _descriptor->version())));
+    }
 
     stdx::unique_lock<Client> lk(*opCtx->getClient());
     ProgressMeterHolder pm(*opCtx->setMessage_inlock("Index Bulk Build: (2/3) btree bottom up",
                                                      "Index: (2/3) BTree Bottom Up Progress",
-                                                     bulk->_keysInserted,
+                                                     keysInserted,
                                                      10));
     lk.unlock();
 
@@ -477,8 +685,8 @@ Status IndexAccessMethod::commitBulk(OperationContext* opCtx,
     MONGO_WRITE_CONFLICT_RETRY_LOOP_BEGIN {
         WriteUnitOfWork wunit(opCtx);
 
-        if (bulk->_everGeneratedMultipleKeys || isMultikeyFromPaths(bulk->_indexMultikeyPaths)) {
-            _btreeState->setMultikey(opCtx, bulk->_indexMultikeyPaths);
+        if (everGeneratedMultipleKeys || isMultikeyFromPaths(indexMultikeyPaths)) {
+            _btreeState->setMultikey(opCtx, indexMultikeyPaths);
         }
 
         builder.reset(_newInterface->getBulkBuilder(opCtx, dupsAllowed));
@@ -486,6 +694,9 @@ Status IndexAccessMethod::commitBulk(OperationContext* opCtx,
     }
     MONGO_WRITE_CONFLICT_RETRY_LOOP_END(opCtx, "setting index multikey flag", "");
 
+    const Ordering ordering = Ordering::make(_descriptor->keyPattern());
+    boost::optional<BSONObj> previousKey;
+
     while (i->more()) {
         if (mayInterrupt) {
             opCtx->checkForInterrupt();
@@ -521,6 +732,14 @@ Status IndexAccessMethod::commitBulk(OperationContext* opCtx,
             return status;
         }
 
+        // The keys arrive in index order, so the keys of a duplicated value are adjacent.
+        if (duplicateKeys) {
+            if (previousKey && d.first.woCompare(*previousKey, ordering, false) == 0) {
+                duplicateKeys->insert(d.first);
+            }
+            previousKey = d.first;
+        }
+
         // If we're here either it's a dup and we're cool with it or the addKey went just
         // fine.
         pm.hit();
@@ -541,10 +760,229 @@ Status IndexAccessMethod::commitBulk(OperationContext* opCtx,
     return Status::OK();
 }
 
+void IndexAccessMethod::setSideWrites(std::shared_ptr<IndexBuildSideWrites> sideWrites) {
+    _sideWrites = std::move(sideWrites);
+}
+
+void IndexAccessMethod::_recordSideWrites(OperationContext* opCtx,
+                                          const std::vector<BSONObj>& removed,
+                                          const std::vector<BSONObj>& added,
+                                          const RecordId& loc) {
+    _sideWrites->record(opCtx, IndexBuildSideWrites::Op::kDelete, removed, loc);
+    _sideWrites->record(opCtx, IndexBuildSideWrites::Op::kInsert, added, loc);
+}
+
+Status IndexAccessMethod::drainSideWrites(OperationContext* opCtx,
+                                          bool mayInterrupt,
+                                          bool dupsAllowed,
+                                          BSONObjSet* duplicateKeys) {
+    invariant(_sideWrites);
+
+    // Number of writes applied per unit of work
+    const size_t kBatchSize = 1000;
+
+    Timer timer;
+    int64_t numApplied = 0;
+
+    while (true) {
+        if (mayInterrupt) {
+            opCtx->checkForInterrupt();
+        }
+
+        const auto writes = _sideWrites->take(kBatchSize);
+        if (writes.empty()) {
+            break;
+        }
+
+        BSONObjSet batchDuplicateKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+
+        // The writes are idempotent, so the batch can be applied again after a write conflict.
+        MONGO_WRITE_CONFLICT_RETRY_LOOP_BEGIN {
+            batchDuplicateKeys.clear();
+            WriteUnitOfWork wunit(opCtx);
+
+            for (const auto& write : writes) {
+                if (write.op == IndexBuildSideWrites::Op::kDelete) {
+                    // Allowing duplicates makes unique indexes only remove the entry of this
+                    // RecordId, in case the key is briefly indexed for several.
+                    _newInterface->unindex(opCtx, write.key, write.loc, true);
+                    continue;
+                }
+
+                Status status = _newInterface->insert(opCtx, write.key, write.loc, dupsAllowed);
+                if (status.code() == ErrorCodes::DuplicateKey && duplicateKeys) {
+                    batchDuplicateKeys.insert(write.key);
+                    status = _newInterface->insert(opCtx, write.key, write.loc, true);
+                }
+
+                // The bulk load may already have indexed the document.
+                if (status.isOK() || status.code() == ErrorCodes::DuplicateKeyValue) {
+                    continue;
+                }
+
+                if (status.code() == ErrorCodes::KeyTooLong && ignoreKeyTooLong(opCtx)) {
+                    continue;
+                }
+
+                return status;
+            }
+
+            wunit.commit();
+        }
+        MONGO_WRITE_CONFLICT_RETRY_LOOP_END(
+            opCtx, "applying index build side writes", _btreeState->ns());
+
+        if (duplicateKeys) {
+            duplicateKeys->insert(batchDuplicateKeys.begin(), batchDuplicateKeys.end());
+        }
+        numApplied += writes.size();
+    }
+
+    LOG(timer.seconds() > 10 ? 0 : 1) << "\t applied " << numApplied
+                                      << " side writes to index " << _descriptor->indexName()
+                                      << " in " << timer.millis() << "ms";
+    return Status::OK();
+}
+
+Status IndexAccessMethod::checkDuplicateKeys(OperationContext* opCtx,
+                                             const BSONObjSet& keys,
+                                             std::set<RecordId>* dups) {
+    const Ordering ordering = Ordering::make(_descriptor->keyPattern());
+    auto cursor = _newInterface->newCursor(opCtx);
+
+    for (const auto& key : keys) {
+        std::vector<RecordId> locs;
+        for (auto entry = cursor->seek(key, true);
+             entry && entry->key.woCompare(key, ordering, false) == 0;
+             entry = cursor->next()) {
+            locs.push_back(entry->loc);
+        }
+
+        if (locs.size() <= 1) {
+            continue;
+        }
+
+        if (!dups) {
+            return Status(ErrorCodes::DuplicateKey,
+                          str::stream() << "E11000 duplicate key error index: "
+                                        << _descriptor->indexNamespace()
+                                        << " dup key: "
+                                        << key);
+        }
+
+        dups->insert(std::next(locs.begin()), locs.end());
+    }
+
+    return Status::OK();
+}
+
 void IndexAccessMethod::getKeys(const BSONObj& obj,
                                 GetKeysMode mode,
                                 BSONObjSet* keys,
                                 MultikeyPaths* multikeyPaths) const {
+    _getKeys(obj, nullptr, mode, keys, multikeyPaths);
+}
+
+void IndexAccessMethod::getKeys(const dps::TopLevelFieldTable& fields,
+                                GetKeysMode mode,
+                                BSONObjSet* keys,
+                                MultikeyPaths* multikeyPaths) const {
+    _getKeys(fields.obj(), &fields, mode, keys, multikeyPaths);
+}
+
+void IndexAccessMethod::doGetKeysFromFieldTable(const dps::TopLevelFieldTable& fields,
+                                                BSONObjSet* keys,
+                                                MultikeyPaths* multikeyPaths) const {
+    doGetKeys(fields.obj(), keys, multikeyPaths);
+}
+
+void IndexAccessMethod::_getKeysForBatch(
+    const std::vector<BsonRecord>& bsonRecords,
+    const std::vector<const dps::TopLevelFieldTable*>* fieldTables,
+    GetKeysMode mode,
+    std::vector<BSONObjSet>* keys,
+    std::vector<MultikeyPaths>* multikeyPaths) const {
+    auto getKeysForRange = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            _getKeys(*bsonRecords[i].docPtr,
+                     fieldTables ? (*fieldTables)[i] : nullptr,
+                     mode,
+                     &(*keys)[i],
+                     &(*multikeyPaths)[i]);
+        }
+    };
+
+    size_t numThreads = 1;
+    size_t totalBytes = 0;
+    const int maxThreads = maxInsertKeyGenerationThreads.load();
+    if (hasExpensiveKeyGeneration() && maxThreads > 1) {
+        for (const auto& bsonRecord : bsonRecords) {
+            totalBytes += bsonRecord.docPtr->objsize();
+        }
+        numThreads = std::min({static_cast<size_t>(maxThreads),
+                               static_cast<size_t>(ProcessInfo().getNumCores()),
+                               bsonRecords.size(),
+                               totalBytes / kMinBytesPerKeyGenerationThread});
+    }
+
+    if (numThreads <= 1) {
+        getKeysForRange(0, bsonRecords.size());
+        return;
+    }
+
+    // Split the documents into one contiguous range per thread, of about equal size in bytes.
+    std::vector<size_t> rangeStarts{0};
+    size_t bytes = 0;
+    for (size_t i = 0; i < bsonRecords.size() && rangeStarts.size() < numThreads; ++i) {
+        bytes += bsonRecords[i].docPtr->objsize();
+        if (bytes * numThreads >= totalBytes * rangeStarts.size()) {
+            rangeStarts.push_back(i + 1);
+        }
+    }
+    rangeStarts.push_back(bsonRecords.size());
+
+    // This thread takes the first range. A range no thread could be started for is done here too.
+    const size_t numRanges = rangeStarts.size() - 1;
+    std::vector<std::exception_ptr> errors(numRanges);
+    auto runRange = [&](size_t range) {
+        try {
+            getKeysForRange(rangeStarts[range], rangeStarts[range + 1]);
+        } catch (...) {
+            errors[range] = std::current_exception();
+        }
+    };
+
+    std::vector<stdx::thread> threads;
+    size_t numStarted = 1;
+    try {
+        for (; numStarted < numRanges; ++numStarted) {
+            threads.emplace_back([&runRange, numStarted] { runRange(numStarted); });
+        }
+    } catch (const std::system_error& ex) {
+        LOG(1) << "Could not start a thread to generate index keys: " << ex.what();
+    }
+
+    runRange(0);
+    for (size_t range = numStarted; range < numRanges; ++range) {
+        runRange(range);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // Report the error of the first range that failed, as generating the keys in order would.
+    for (auto&& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+void IndexAccessMethod::_getKeys(const BSONObj& obj,
+                                 const dps::TopLevelFieldTable* fields,
+                                 GetKeysMode mode,
+                                 BSONObjSet* keys,
+                                 MultikeyPaths* multikeyPaths) const {
     static stdx::unordered_set<int> whiteList{ErrorCodes::CannotBuildIndexKeys,
                                               // Btree
                                               ErrorCodes::KeyTooLong,
@@ -570,7 +1008,11 @@ void IndexAccessMethod::getKeys(const BSONObj& obj,
                                               13026,
                                               13027};
     try {
-        doGetKeys(obj, keys, multikeyPaths);
+        if (fields) {
+            doGetKeysFromFieldTable(*fields, keys, multikeyPaths);
+        } else {
+            doGetKeys(obj, keys, multikeyPaths);
+        }
     } catch (const UserException& ex) {
         if (mode == GetKeysMode::kEnforceConstraints) {
             throw;
@@ -45,10 +45,16 @@ namespace mongo {
 extern AtomicBool failIndexKeyTooLong;
 
 class BSONObjBuilder;
+class IndexBuildSideWrites;
 class MatchExpression;
 class UpdateTicket;
+struct BsonRecord;
 struct InsertDeleteOptions;
 
+namespace dotted_path_support {
+class TopLevelFieldTable;
+}  // namespace dotted_path_support
+
 /**
  * An IndexAccessMethod is the interface through which all the mutation, lookup, and
  * traversal of index entries is done. The class is designed so that the underlying index
@@ -77,12 +83,16 @@ public:
      * there is more than one key for 'obj', either all keys will be inserted or none will.
      *
      * The behavior of the insertion can be specified through 'options'.
+     *
+     * If 'fields' is not null, it is a table of the top-level fields of 'obj', shared by all of
+     * the indexes the document is being inserted into. See numTopLevelFieldLookups().
      */
     Status insert(OperationContext* opCtx,
                   const BSONObj& obj,
                   const RecordId& loc,
                   const InsertDeleteOptions& options,
-                  int64_t* numInserted);
+                  int64_t* numInserted,
+                  const dotted_path_support::TopLevelFieldTable* fields = nullptr);
 
     /**
      * Analogous to above, but remove the records instead of inserting them.
@@ -94,6 +104,24 @@ public:
                   const InsertDeleteOptions& options,
                   int64_t* numDeleted);
 
+    /**
+     * Batched form of insert() for the documents in 'bsonRecords'. The keys of all of the
+     * documents are generated up front and inserted in index order, so that the storage engine
+     * sees a monotonic sequence of writes. 'numInserted' will be set to the number of keys added
+     * to the index for all of the documents. Either all keys will be inserted or none will.
+     *
+     * The behavior of the insertion can be specified through 'options'.
+     *
+     * If 'fieldTables' is not null, it holds a table of the top-level fields, or null, for each
+     * document in 'bsonRecords', as for insert().
+     */
+    Status insertBatch(
+        OperationContext* opCtx,
+        const std::vector<BsonRecord>& bsonRecords,
+        const InsertDeleteOptions& options,
+        int64_t* numInserted,
+        const std::vector<const dotted_path_support::TopLevelFieldTable*>* fieldTables = nullptr);
+
     /**
      * Checks whether the index entries for the document 'from', which is placed at location
      * 'loc' on disk, can be changed to the index entries for the doc 'to'. Provides a ticket
@@ -103,6 +131,9 @@ public:
      * Returns OK if the update should proceed without error.  The ticket is marked as valid.
      *
      * There is no obligation to perform the update after performing validation.
+     *
+     * If 'fromFields' or 'toFields' is not null, it is a table of the top-level fields of 'from' or
+     * 'to', as for insert().
      */
     Status validateUpdate(OperationContext* opCtx,
                           const BSONObj& from,
@@ -110,7 +141,9 @@ public:
                           const RecordId& loc,
                           const InsertDeleteOptions& options,
                           UpdateTicket* ticket,
-                          const MatchExpression* indexFilter);
+                          const MatchExpression* indexFilter,
+                          const dotted_path_support::TopLevelFieldTable* fromFields = nullptr,
+                          const dotted_path_support::TopLevelFieldTable* toFields = nullptr);
 
     /**
      * Perform a validated update.  The keys for the 'from' object will be removed, and the keys
@@ -178,6 +211,13 @@ public:
      */
     bool appendCustomStats(OperationContext* opCtx, BSONObjBuilder* result, double scale) const;
 
+    /**
+     * Appends the storage engine's cache statistics for this index, if any.
+     *
+     * Returns true if stats were appended.
+     */
+    bool appendCacheStats(OperationContext* opCtx, BSONObjBuilder* result) const;
+
     /**
      * @return The number of bytes consumed by this index.
      *         Exactly what is counted is not defined based on padding, re-use, etc...
@@ -256,6 +296,60 @@ public:
                       bool dupsAllowed,
                       std::set<RecordId>* dups);
 
+    /**
+     * Same as above, but for several BulkBuilders of this index, which have been filled
+     * independently (for example, each by a different thread) and whose sorted keys are merged
+     * while building the index.
+     *
+     * If 'duplicateKeys' is not NULL, the keys which were inserted for more than one RecordId are
+     * added to it. This can only happen if 'dupsAllowed' is true.
+     */
+    Status commitBulk(OperationContext* opCtx,
+                      std::vector<std::unique_ptr<BulkBuilder>> bulks,
+                      bool mayInterrupt,
+                      bool dupsAllowed,
+                      std::set<RecordId>* dups,
+                      BSONObjSet* duplicateKeys = nullptr);
+
+    //
+    // Background bulk build support
+    //
+
+    /**
+     * Makes insert(), insertBatch(), remove() and update() record the key writes they make in
+     * 'sideWrites' rather than applying them to the index, or apply them to the index again if
+     * 'sideWrites' is null. This lets a background index build bulk load the index while the
+     * collection keeps being written to. The multikey state of the index is still updated by the
+     * writers.
+     *
+     * Requires holding an exclusive lock on the collection, so that no write is in progress.
+     */
+    void setSideWrites(std::shared_ptr<IndexBuildSideWrites> sideWrites);
+
+    /**
+     * Applies the committed writes recorded in the side writes set on this index to the index, in
+     * the order in which they were made. The writes are idempotent, so documents which the bulk
+     * load already indexed can be written again.
+     *
+     * If 'dupsAllowed' is false, the keys inserted for a RecordId while another one was indexed
+     * under the same key are added to 'duplicateKeys' rather than failing, unless it is NULL.
+     * As the writes of later transactions may remove the other RecordId, callers must check the
+     * keys with checkDuplicateKeys() once all the writes are applied.
+     */
+    Status drainSideWrites(OperationContext* opCtx,
+                           bool mayInterrupt,
+                           bool dupsAllowed,
+                           BSONObjSet* duplicateKeys);
+
+    /**
+     * Checks that each of 'keys' is indexed for at most one RecordId. If 'dups' is not NULL, all
+     * but the first RecordId of the duplicated keys are added to it, otherwise DuplicateKey is
+     * returned for the first duplicated key.
+     */
+    Status checkDuplicateKeys(OperationContext* opCtx,
+                              const BSONObjSet& keys,
+                              std::set<RecordId>* dups);
+
     /**
      * Specifies whether getKeys should relax the index constraints or not.
      */
@@ -278,6 +372,32 @@ public:
                  BSONObjSet* keys,
                  MultikeyPaths* multikeyPaths) const;
 
+    /**
+     * Same as above for the document 'fields.obj()', looking up its top-level fields in 'fields'.
+     */
+    void getKeys(const dotted_path_support::TopLevelFieldTable& fields,
+                 GetKeysMode mode,
+                 BSONObjSet* keys,
+                 MultikeyPaths* multikeyPaths) const;
+
+    /**
+     * Returns how many lookups of top-level fields of a document generating its keys through
+     * getKeys(const TopLevelFieldTable&, ...) saves. A caller maintaining several indexes adds
+     * these up to decide whether a table of the document's fields shared by all of them pays off.
+     */
+    virtual size_t numTopLevelFieldLookups() const {
+        return 0;
+    }
+
+    /**
+     * Returns whether generating the keys of a document costs so much more than inserting them
+     * that insertBatch() should generate the keys of a large batch on several threads. doGetKeys()
+     * must be safe to call concurrently if it does.
+     */
+    virtual bool hasExpensiveKeyGeneration() const {
+        return false;
+    }
+
     /**
      * Splits the sets 'left' and 'right' into two vectors, the first containing the elements that
      * only appeared in 'left', and the second containing only elements that appeared in 'right'.
@@ -303,6 +423,15 @@ protected:
                            BSONObjSet* keys,
                            MultikeyPaths* multikeyPaths) const = 0;
 
+    /**
+     * Same as doGetKeys() for the document 'fields.obj()'. Index types that look up top-level
+     * fields of the document override this to look them up in 'fields'; by default the table is
+     * ignored.
+     */
+    virtual void doGetKeysFromFieldTable(const dotted_path_support::TopLevelFieldTable& fields,
+                                         BSONObjSet* keys,
+                                         MultikeyPaths* multikeyPaths) const;
+
     /**
      * Determines whether it's OK to ignore ErrorCodes::KeyTooLong for this OperationContext
      */
@@ -312,12 +441,43 @@ protected:
     const IndexDescriptor* _descriptor;
 
 private:
+    /**
+     * Calls _getKeys() for every document of 'bsonRecords', filling the corresponding elements of
+     * 'keys' and 'multikeyPaths', which must have as many elements. Documents are split over
+     * several threads if this index has expensive key generation and the batch is large enough.
+     */
+    void _getKeysForBatch(
+        const std::vector<BsonRecord>& bsonRecords,
+        const std::vector<const dotted_path_support::TopLevelFieldTable*>* fieldTables,
+        GetKeysMode mode,
+        std::vector<BSONObjSet>* keys,
+        std::vector<MultikeyPaths>* multikeyPaths) const;
+
+    void _getKeys(const BSONObj& obj,
+                  const dotted_path_support::TopLevelFieldTable* fields,
+                  GetKeysMode mode,
+                  BSONObjSet* keys,
+                  MultikeyPaths* multikeyPaths) const;
+
     void removeOneKey(OperationContext* opCtx,
                       const BSONObj& key,
                       const RecordId& loc,
                       bool dupsAllowed);
 
+    /**
+     * Records the keys of a write made while a background bulk build is in progress in
+     * '_sideWrites'.
+     */
+    void _recordSideWrites(OperationContext* opCtx,
+                           const std::vector<BSONObj>& removed,
+                           const std::vector<BSONObj>& added,
+                           const RecordId& loc);
+
     const std::unique_ptr<SortedDataInterface> _newInterface;
+
+    // Set while a background bulk build of this index is in progress. Only changes while the
+    // collection is locked exclusively.
+    std::shared_ptr<IndexBuildSideWrites> _sideWrites;
 };
 
 /**
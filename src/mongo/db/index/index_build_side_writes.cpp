@@ -0,0 +1,99 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/index/index_build_side_writes.h"
+
+#include <iterator>
+
+#include "mongo/db/operation_context.h"
+
+namespace mongo {
+
+void IndexBuildSideWrites::record(OperationContext* opCtx,
+                                  Op op,
+                                  const std::vector<BSONObj>& keys,
+                                  const RecordId& loc) {
+    if (keys.empty()) {
+        return;
+    }
+
+    EntryList newEntries;
+    for (const auto& key : keys) {
+        newEntries.emplace_back(Write(op, key.getOwned(), loc));
+    }
+
+    EntryList::iterator first;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        first = newEntries.begin();
+        _entries.splice(_entries.end(), newEntries);
+    }
+
+    // The entries are only ever removed by take() once committed, or by the rollback below, so the
+    // iterators stay valid until the unit of work ends.
+    const auto numKeys = keys.size();
+    auto self = shared_from_this();
+    opCtx->recoveryUnit()->onCommit([self, first, numKeys] {
+        stdx::lock_guard<stdx::mutex> lk(self->_mutex);
+        auto it = first;
+        for (std::size_t i = 0; i < numKeys; ++i, ++it) {
+            it->committed = true;
+        }
+    });
+    opCtx->recoveryUnit()->onRollback([self, first, numKeys] {
+        stdx::lock_guard<stdx::mutex> lk(self->_mutex);
+        self->_entries.erase(first, std::next(first, numKeys));
+    });
+}
+
+std::vector<IndexBuildSideWrites::Write> IndexBuildSideWrites::take(std::size_t maxWrites) {
+    std::vector<Write> writes;
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _entries.begin();
+    while (it != _entries.end() && writes.size() < maxWrites) {
+        if (!it->committed) {
+            ++it;
+            continue;
+        }
+
+        writes.push_back(std::move(it->write));
+        it = _entries.erase(it);
+    }
+
+    return writes;
+}
+
+std::size_t IndexBuildSideWrites::size() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _entries.size();
+}
+
+}  // namespace mongo
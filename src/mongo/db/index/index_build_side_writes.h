@@ -0,0 +1,107 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/record_id.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+class OperationContext;
+
+/**
+ * Buffers the index key writes made to an index while a background build bulk loads it, so that
+ * they can be applied to the index once the bulk load is done.
+ *
+ * The writes are kept in the order in which they were made. They only become visible to take()
+ * once the unit of work that made them commits, and they are discarded if it rolls back. The
+ * writes to the same document are serialized by the storage engine, so applying the committed
+ * writes in this order reproduces the effects of committed transactions on the index.
+ *
+ * This class is thread safe. It must be owned by a std::shared_ptr, which the pending units of
+ * work share.
+ */
+class IndexBuildSideWrites : public std::enable_shared_from_this<IndexBuildSideWrites> {
+    MONGO_DISALLOW_COPYING(IndexBuildSideWrites);
+
+public:
+    enum class Op { kInsert, kDelete };
+
+    struct Write {
+        Write(Op op, BSONObj key, RecordId loc) : op(op), key(std::move(key)), loc(loc) {}
+
+        Op op;
+        BSONObj key;
+        RecordId loc;
+    };
+
+    IndexBuildSideWrites() = default;
+
+    /**
+     * Records the writes of 'keys' for the document at 'loc' as part of the current unit of work
+     * of 'opCtx', which must be active. The keys are copied.
+     */
+    void record(OperationContext* opCtx,
+                Op op,
+                const std::vector<BSONObj>& keys,
+                const RecordId& loc);
+
+    /**
+     * Removes and returns, in the order in which they were made, up to 'maxWrites' of the writes
+     * whose unit of work has committed.
+     */
+    std::vector<Write> take(std::size_t maxWrites);
+
+    /**
+     * Returns the number of recorded writes, committed or not.
+     */
+    std::size_t size() const;
+
+private:
+    struct Entry {
+        Entry(Write write) : write(std::move(write)) {}
+
+        Write write;
+        bool committed = false;
+    };
+
+    using EntryList = std::list<Entry>;
+
+    mutable stdx::mutex _mutex;
+    EntryList _entries;
+};
+
+}  // namespace mongo
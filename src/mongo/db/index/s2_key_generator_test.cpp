@@ -36,6 +36,7 @@
 
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/geo/geometry_container.h"
 #include "mongo/db/index/expression_params.h"
 #include "mongo/db/index/s2_common.h"
 #include "mongo/db/json.h"
@@ -43,6 +44,7 @@
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "third_party/s2/s2regioncoverer.h"
 
 using namespace mongo;
 
@@ -493,4 +495,71 @@ TEST(S2KeyGeneratorTest, MidPathSingleElementArrayIsConsideredMultikey) {
     assertMultikeyPathsEqual(MultikeyPaths{{0U}, std::set<size_t>{}}, actualMultikeyPaths);
 }
 
+TEST(S2KeyGeneratorTest, PointKeysMatchLeafCellCovering) {
+    BSONObj keyPattern = fromjson("{a: '2dsphere'}");
+    BSONObj infoObj = fromjson("{key: {a: '2dsphere'}, '2dsphereIndexVersion': 3}");
+    S2IndexingParams params;
+    const CollatorInterface* collator = nullptr;
+    ExpressionParams::initialize2dsphereParams(infoObj, collator, &params);
+
+    const char* points[] = {"{a: {type: 'Point', coordinates: [0, 0]}}",
+                            "{a: {type: 'Point', coordinates: [-73.97, 40.77]}}",
+                            "{a: {type: 'Point', coordinates: [180, -90]}}",
+                            "{a: {type: 'Point', coordinates: [12.5, 41.9, 21.0]}}",
+                            "{a: [-122.42, 37.77]}",
+                            "{a: [-122.42, 37.77, 16]}",
+                            "{a: {x: 151.2, y: -33.87}}",
+                            "{a: {lng: 2.35, lat: 48.86, type: 'Point'}}"};
+
+    for (const char* point : points) {
+        BSONObj obj = fromjson(point);
+
+        // Cover the point as every other geometry is covered.
+        GeometryContainer geoContainer;
+        ASSERT_OK(geoContainer.parseFromStorage(obj.firstElement()));
+        ASSERT_TRUE(geoContainer.isPoint());
+        geoContainer.projectInto(SPHERE);
+        S2RegionCoverer coverer;
+        params.configureCoverer(geoContainer, &coverer);
+        std::vector<S2CellId> covering;
+        coverer.GetCovering(geoContainer.getS2Region(), &covering);
+
+        BSONObjSet expectedKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        for (const S2CellId& cellId : covering) {
+            expectedKeys.insert(S2CellIdToIndexKey(cellId, params.indexVersion));
+        }
+
+        BSONObjSet actualKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        MultikeyPaths actualMultikeyPaths;
+        ExpressionKeysPrivate::getS2Keys(
+            obj, keyPattern, params, &actualKeys, &actualMultikeyPaths);
+
+        ASSERT_EQUALS(1U, actualKeys.size()) << point;
+        ASSERT_TRUE(assertKeysetsEqual(expectedKeys, actualKeys)) << point;
+    }
+}
+
+TEST(S2KeyGeneratorTest, InvalidPointsAreStillRejected) {
+    BSONObj keyPattern = fromjson("{a: '2dsphere'}");
+    BSONObj infoObj = fromjson("{key: {a: '2dsphere'}, '2dsphereIndexVersion': 3}");
+    S2IndexingParams params;
+    const CollatorInterface* collator = nullptr;
+    ExpressionParams::initialize2dsphereParams(infoObj, collator, &params);
+
+    const char* points[] = {"{a: {type: 'Point', coordinates: [200, 0]}}",
+                            "{a: [0, 100]}",
+                            "{a: {type: 'Point', coordinates: ['0', 0]}}",
+                            "{a: {type: 'Polygon', coordinates: [0, 0]}}"};
+
+    for (const char* point : points) {
+        BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        MultikeyPaths multikeyPaths;
+        ASSERT_THROWS_CODE(
+            ExpressionKeysPrivate::getS2Keys(
+                fromjson(point), keyPattern, params, &keys, &multikeyPaths),
+            UserException,
+            16755);
+    }
+}
+
 }  // namespace
@@ -67,10 +67,17 @@ void _setBgIndexStarting() {
 }  // namespace
 
 IndexBuilder::IndexBuilder(const BSONObj& index, bool relaxConstraints)
+    : IndexBuilder(std::vector<BSONObj>{index}, relaxConstraints) {}
+
+IndexBuilder::IndexBuilder(const std::vector<BSONObj>& indexes, bool relaxConstraints)
     : BackgroundJob(true /* self-delete */),
-      _index(index.getOwned()),
       _relaxConstraints(relaxConstraints),
-      _name(str::stream() << "repl index builder " << _indexBuildCount.addAndFetch(1)) {}
+      _name(str::stream() << "repl index builder " << _indexBuildCount.addAndFetch(1)) {
+    invariant(!indexes.empty());
+    for (const auto& index : indexes) {
+        _indexes.push_back(index.getOwned());
+    }
+}
 
 IndexBuilder::~IndexBuilder() {}
 
@@ -80,7 +87,7 @@ std::string IndexBuilder::name() const {
 
 void IndexBuilder::run() {
     Client::initThread(name().c_str());
-    LOG(2) << "IndexBuilder building index " << _index;
+    LOG(2) << "IndexBuilder building index " << _describeIndexes();
 
     const ServiceContext::UniqueOperationContext opCtxPtr = cc().makeOperationContext();
     OperationContext& opCtx = *opCtxPtr;
@@ -92,7 +99,7 @@ void IndexBuilder::run() {
         stdx::lock_guard<Client> lk(*opCtx.getClient());
         CurOp::get(opCtx)->setNetworkOp_inlock(dbInsert);
     }
-    NamespaceString ns(_index["ns"].String());
+    NamespaceString ns(_indexes.front()["ns"].String());
 
     Lock::DBLock dlk(&opCtx, ns.db(), MODE_X);
     OldClientContext ctx(&opCtx, ns.getSystemIndexesCollection());
@@ -119,11 +126,25 @@ void IndexBuilder::waitForBgIndexStarting() {
     _bgIndexStarting = false;
 }
 
+BSONObj IndexBuilder::_describeIndexes() const {
+    if (_indexes.size() == 1) {
+        return _indexes.front();
+    }
+
+    BSONObjBuilder builder;
+    BSONArrayBuilder specs(builder.subarrayStart("indexes"));
+    for (const auto& index : _indexes) {
+        specs.append(index);
+    }
+    specs.done();
+    return builder.obj();
+}
+
 Status IndexBuilder::_build(OperationContext* opCtx,
                             Database* db,
                             bool allowBackgroundBuilding,
                             Lock::DBLock* dbLock) const {
-    const NamespaceString ns(_index["ns"].String());
+    const NamespaceString ns(_indexes.front()["ns"].String());
 
     Collection* c = db->getCollection(opCtx, ns);
 
@@ -133,7 +154,7 @@ Status IndexBuilder::_build(OperationContext* opCtx,
     {
         stdx::lock_guard<Client> lk(*opCtx->getClient());
         // Show which index we're building in the curop display.
-        CurOp::get(opCtx)->setOpDescription_inlock(_index);
+        CurOp::get(opCtx)->setOpDescription_inlock(_describeIndexes());
     }
 
     bool haveSetBgIndexStarting = false;
@@ -148,9 +169,20 @@ Status IndexBuilder::_build(OperationContext* opCtx,
 
 
             try {
-                status = indexer.init(_index).getStatus();
+                std::vector<BSONObj> specs = _indexes;
+                if (specs.size() > 1) {
+                    // Only the indexes which don't exist yet are built together. A conflict with
+                    // an existing index fails all of them, so that their oplog entries are
+                    // applied one by one instead.
+                    indexer.removeExistingIndexes(&specs);
+                }
+
+                status = specs.empty()
+                    ? Status(ErrorCodes::IndexAlreadyExists, "all indexes already exist")
+                    : indexer.init(specs).getStatus();
                 if (status == ErrorCodes::IndexAlreadyExists ||
-                    (status == ErrorCodes::IndexOptionsConflict && _relaxConstraints)) {
+                    (status == ErrorCodes::IndexOptionsConflict && _relaxConstraints &&
+                     _indexes.size() == 1)) {
                     LOG(1) << "Ignoring indexing error: " << redact(status);
                     if (allowBackgroundBuilding) {
                         // Must set this in case anyone is waiting for this build.
@@ -173,10 +205,12 @@ Status IndexBuilder::_build(OperationContext* opCtx,
                     status = indexer.insertAllDocumentsInCollection();
                 }
 
+                if (status.isOK() && allowBackgroundBuilding) {
+                    dbLock->relockWithMode(MODE_X);
+                    status = indexer.drainBackgroundWrites();
+                }
+
                 if (status.isOK()) {
-                    if (allowBackgroundBuilding) {
-                        dbLock->relockWithMode(MODE_X);
-                    }
                     WriteUnitOfWork wunit(opCtx);
                     indexer.commit();
                     wunit.commit();
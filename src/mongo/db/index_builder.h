@@ -29,6 +29,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "mongo/base/status.h"
 #include "mongo/db/catalog/index_catalog.h"
@@ -66,6 +67,12 @@ class OperationContext;
 class IndexBuilder : public BackgroundJob {
 public:
     IndexBuilder(const BSONObj& index, bool relaxConstraints);
+
+    /**
+     * Builds all of 'indexes', which must be on the same collection, with a single scan of it.
+     */
+    IndexBuilder(const std::vector<BSONObj>& indexes, bool relaxConstraints);
+
     virtual ~IndexBuilder();
 
     virtual void run();
@@ -90,7 +97,13 @@ private:
                   bool allowBackgroundBuilding,
                   Lock::DBLock* dbLock) const;
 
-    const BSONObj _index;
+    /**
+     * Returns the spec of the index being built, or an object listing the specs if there are
+     * several, for logging and for the curop display.
+     */
+    BSONObj _describeIndexes() const;
+
+    std::vector<BSONObj> _indexes;
     const bool _relaxConstraints;
     std::string _name;  // name of this builder, not related to the index
     static AtomicUInt32 _indexBuildCount;
@@ -41,6 +41,7 @@
 #include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/operation_arena.h"
 #include "mongo/rpc/metadata/client_metadata.h"
 #include "mongo/rpc/metadata/client_metadata_ismaster.h"
 #include "mongo/util/log.h"
@@ -91,6 +92,9 @@ void profile(OperationContext* opCtx, NetworkOp op) {
     {
         Locker::LockerInfo lockerInfo;
         opCtx->lockState()->getLockerInfo(&lockerInfo);
+        CurOp::get(opCtx)->debug().ticketQueuedMicros = lockerInfo.ticketQueuedMicros;
+        CurOp::get(opCtx)->debug().phases = OperationPhases::get(opCtx);
+        CurOp::get(opCtx)->debug().arenaBytes = OperationArena::get(opCtx).bytesReserved();
         CurOp::get(opCtx)->debug().append(*CurOp::get(opCtx), lockerInfo.stats, b);
     }
 
@@ -0,0 +1,115 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/matcher/extensions_callback_disallow_extensions.h"
+#include "mongo/unittest/benchmark.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace {
+
+using unittest::benchmarkDoNotOptimize;
+
+std::unique_ptr<MatchExpression> parseOrDie(const BSONObj& query) {
+    const CollatorInterface* collator = nullptr;
+    auto status =
+        MatchExpressionParser::parse(query, ExtensionsCallbackDisallowExtensions(), collator);
+    uassertStatusOK(status.getStatus());
+    return std::move(status.getValue());
+}
+
+const BSONObj kSimpleQuery = BSON("x" << 2);
+
+const BSONObj kCompoundQuery =
+    fromjson("{a: {$gt: 5, $lt: 100}, b: 'foo', c: {$in: [1, 2, 3, 4, 5]}, "
+             "'d.e': {$exists: true}}");
+
+const BSONObj kOrQuery =
+    fromjson("{$or: [{a: 1}, {b: {$gte: 10}}, {c: {$elemMatch: {x: 1, y: {$ne: 2}}}}]}");
+
+const BSONObj kMatchingDocument =
+    fromjson("{_id: 1, a: 50, b: 'foo', c: [{x: 1, y: 3}, 4], d: {e: 'present'}, x: 2}");
+
+const BSONObj kArrayDocument =
+    fromjson("{_id: 1, a: [1, 2, 3, 4, 5, 6, 7, 8, 9, 60], b: ['bar', 'baz', 'foo'], c: 2, "
+             "d: [{e: 1}, {e: 2}], x: [1, 2]}");
+
+BENCHMARK(MatchExpression, ParseSimple) {
+    while (state.keepRunning()) {
+        benchmarkDoNotOptimize(parseOrDie(kSimpleQuery));
+    }
+}
+
+BENCHMARK(MatchExpression, ParseCompound) {
+    while (state.keepRunning()) {
+        benchmarkDoNotOptimize(parseOrDie(kCompoundQuery));
+    }
+}
+
+BENCHMARK(MatchExpression, ParseOr) {
+    while (state.keepRunning()) {
+        benchmarkDoNotOptimize(parseOrDie(kOrQuery));
+    }
+}
+
+BENCHMARK(MatchExpression, MatchSimple) {
+    const auto expr = parseOrDie(kSimpleQuery);
+    while (state.keepRunning()) {
+        benchmarkDoNotOptimize(expr->matchesBSON(kMatchingDocument));
+    }
+}
+
+BENCHMARK(MatchExpression, MatchCompound) {
+    const auto expr = parseOrDie(kCompoundQuery);
+    while (state.keepRunning()) {
+        benchmarkDoNotOptimize(expr->matchesBSON(kMatchingDocument));
+    }
+}
+
+BENCHMARK(MatchExpression, MatchCompoundArrays) {
+    const auto expr = parseOrDie(kCompoundQuery);
+    while (state.keepRunning()) {
+        benchmarkDoNotOptimize(expr->matchesBSON(kArrayDocument));
+    }
+}
+
+BENCHMARK(MatchExpression, MatchOr) {
+    const auto expr = parseOrDie(kOrQuery);
+    while (state.keepRunning()) {
+        benchmarkDoNotOptimize(expr->matchesBSON(kArrayDocument));
+    }
+}
+
+}  // namespace
+}  // namespace mongo
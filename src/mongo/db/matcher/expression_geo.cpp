@@ -339,6 +339,23 @@ bool GeoMatchExpression::matchesSingleElement(const BSONElement& e) const {
     if (!e.isABSONObj())
         return false;
 
+    // Most stored geometries are points, which we can match without building a container.
+    PointWithCRS point;
+    if (GeoParser::parseStoredPointOnly(e, &point)) {
+        const CRS queryCRS = _query->getGeometry().getNativeCRS();
+        if (!ShapeProjection::supportsProject(point, queryCRS))
+            return false;
+
+        ShapeProjection::projectInto(&point, queryCRS);
+
+        if (GeoExpression::WITHIN == _query->getPred()) {
+            return _query->getGeometry().contains(point);
+        } else {
+            verify(GeoExpression::INTERSECT == _query->getPred());
+            return _query->getGeometry().intersects(point);
+        }
+    }
+
     GeometryContainer geometry;
 
     if (!geometry.parseFromStorage(e, _canSkipValidation).isOK())
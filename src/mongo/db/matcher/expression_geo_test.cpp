@@ -185,4 +185,54 @@ TEST(ExpressionGeoTest, GeoNearNotEquivalent) {
         gne2(makeGeoNearMatchExpression(query2));
     ASSERT(!gne1->equivalent(gne2.get()));
 }
+
+TEST(ExpressionGeoTest, GeoWithinPolygonMatchesPointsAndOtherGeometries) {
+    BSONObj query = fromjson(
+        "{$geoWithin: {$geometry: {type: 'Polygon', coordinates: "
+        "[[[0, 0], [0, 10], [10, 10], [10, 0], [0, 0]]]}}}");
+    std::unique_ptr<GeoMatchExpression> ge(makeGeoMatchExpression(query));
+
+    ASSERT(ge->matchesBSON(fromjson("{a: {type: 'Point', coordinates: [5, 5]}}")));
+    ASSERT(ge->matchesBSON(fromjson("{a: {type: 'Point', coordinates: [5, 5, 100]}}")));
+    ASSERT(ge->matchesBSON(fromjson("{a: [5, 5]}")));
+    ASSERT(ge->matchesBSON(fromjson("{a: {x: 5, y: 5}}")));
+    ASSERT(!ge->matchesBSON(fromjson("{a: {type: 'Point', coordinates: [15, 5]}}")));
+    ASSERT(!ge->matchesBSON(fromjson("{a: [15, 5]}")));
+    ASSERT(!ge->matchesBSON(fromjson("{a: [5, 100]}")));
+    ASSERT(!ge->matchesBSON(fromjson("{a: {type: 'Point', coordinates: ['5', 5]}}")));
+
+    ASSERT(ge->matchesBSON(fromjson("{a: {type: 'LineString', coordinates: [[1, 1], [2, 2]]}}")));
+    ASSERT(!ge->matchesBSON(fromjson("{a: {type: 'LineString', coordinates: [[1, 1], [20, 2]]}}")));
+    ASSERT(ge->matchesBSON(fromjson("{a: {type: 'MultiPoint', coordinates: [[1, 1], [2, 2]]}}")));
+}
+
+TEST(ExpressionGeoTest, LegacyGeoWithinMatchesPoints) {
+    std::unique_ptr<GeoMatchExpression> box(
+        makeGeoMatchExpression(fromjson("{$within: {$box: [[4, 4], [6, 6]]}}")));
+    ASSERT(box->matchesBSON(fromjson("{a: [5, 5]}")));
+    ASSERT(box->matchesBSON(fromjson("{a: {type: 'Point', coordinates: [5, 5]}}")));
+    ASSERT(!box->matchesBSON(fromjson("{a: {type: 'Point', coordinates: [7, 5]}}")));
+
+    std::unique_ptr<GeoMatchExpression> center(
+        makeGeoMatchExpression(fromjson("{$within: {$center: [[0, 0], 1]}}")));
+    ASSERT(center->matchesBSON(fromjson("{a: [0.5, 0.5]}")));
+    ASSERT(!center->matchesBSON(fromjson("{a: [1, 1]}")));
+
+    std::unique_ptr<GeoMatchExpression> centerSphere(
+        makeGeoMatchExpression(fromjson("{$within: {$centerSphere: [[0, 0], 0.1]}}")));
+    ASSERT(centerSphere->matchesBSON(fromjson("{a: [1, 1]}")));
+    ASSERT(!centerSphere->matchesBSON(fromjson("{a: [10, 10]}")));
+}
+
+TEST(ExpressionGeoTest, GeoIntersectsMatchesPoints) {
+    BSONObj query = fromjson(
+        "{$geoIntersects: {$geometry: {type: 'Polygon', coordinates: "
+        "[[[0, 0], [0, 10], [10, 10], [10, 0], [0, 0]]]}}}");
+    std::unique_ptr<GeoMatchExpression> ge(makeGeoMatchExpression(query));
+
+    ASSERT(ge->matchesBSON(fromjson("{a: {type: 'Point', coordinates: [5, 5]}}")));
+    ASSERT(ge->matchesBSON(fromjson("{a: [5, 5]}")));
+    ASSERT(!ge->matchesBSON(fromjson("{a: {type: 'Point', coordinates: [-5, 5]}}")));
+    ASSERT(ge->matchesBSON(fromjson("{a: {type: 'LineString', coordinates: [[-5, 5], [5, 5]]}}")));
+}
 }
@@ -31,7 +31,6 @@
 #include "mongo/db/matcher/expression_leaf.h"
 
 #include <cmath>
-#include <pcrecpp.h>
 
 #include "mongo/bson/bsonelement_comparator.h"
 #include "mongo/bson/bsonmisc.h"
@@ -40,6 +39,7 @@
 #include "mongo/db/field_ref.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/path.h"
+#include "mongo/db/matcher/regex_cache.h"
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/mongoutils/str.h"
@@ -86,6 +86,8 @@ bool ComparisonMatchExpression::equivalent(const MatchExpression* other) const {
 
 Status ComparisonMatchExpression::init(StringData path, const BSONElement& rhs) {
     _rhs = rhs;
+    _rhsCanonicalType = rhs.canonicalType();
+    _rhsIsNaN = rhs.isNumber() && std::isnan(rhs.numberDouble());
 
     if (rhs.eoo()) {
         return Status(ErrorCodes::BadValue, "need a real operand");
@@ -111,11 +113,11 @@ Status ComparisonMatchExpression::init(StringData path, const BSONElement& rhs)
 
 
 bool ComparisonMatchExpression::matchesSingleElement(const BSONElement& e) const {
-
-    if (e.canonicalType() != _rhs.canonicalType()) {
+    const int eCanonicalType = e.canonicalType();
+    if (eCanonicalType != _rhsCanonicalType) {
         // some special cases
         //  jstNULL and undefined are treated the same
-        if (e.canonicalType() + _rhs.canonicalType() == 5) {
+        if (eCanonicalType + _rhsCanonicalType == 5) {
             return matchType() == EQ || matchType() == LTE || matchType() == GTE;
         }
 
@@ -126,10 +128,17 @@ bool ComparisonMatchExpression::matchesSingleElement(const BSONElement& e) const
         return false;
     }
 
-    // Special case handling for NaN. NaN is equal to NaN but
-    // otherwise always compares to false.
-    if (std::isnan(e.numberDouble()) || std::isnan(_rhs.numberDouble())) {
-        bool bothNaN = std::isnan(e.numberDouble()) && std::isnan(_rhs.numberDouble());
+    int x;
+    if (e.type() == NumberInt && _rhs.type() == NumberInt) {
+        // The most common numeric comparison needs neither conversion nor NaN handling.
+        const int lhs = e._numberInt();
+        const int rhs = _rhs._numberInt();
+        x = lhs < rhs ? -1 : (lhs == rhs ? 0 : 1);
+    } else if (e.isNumber() && (_rhsIsNaN || std::isnan(e.numberDouble()))) {
+        // Special case handling for NaN. NaN is equal to NaN but
+        // otherwise always compares to false. Only numbers can be NaN, and since 'e' has the
+        // same canonical type as '_rhs', both are numbers here.
+        bool bothNaN = _rhsIsNaN && std::isnan(e.numberDouble());
         switch (matchType()) {
             case LT:
                 return false;
@@ -146,10 +155,10 @@ bool ComparisonMatchExpression::matchesSingleElement(const BSONElement& e) const
                 // a $lt, $lte, $gt, $gte, or equality expression.
                 fassertFailed(17448);
         }
+    } else {
+        x = compareElementValues(e, _rhs, _collator);
     }
 
-    int x = compareElementValues(e, _rhs, _collator);
-
     switch (matchType()) {
         case LT:
             return x < 0;
@@ -202,7 +211,7 @@ void ComparisonMatchExpression::debugString(StringBuilder& debug, int level) con
 }
 
 void ComparisonMatchExpression::serialize(BSONObjBuilder* out) const {
-    string opString = "";
+    std::string opString = "";
     switch (matchType()) {
         case LT:
             opString = "$lt";
@@ -228,24 +237,6 @@ void ComparisonMatchExpression::serialize(BSONObjBuilder* out) const {
 
 // ---------------
 
-// TODO: move
-inline pcrecpp::RE_Options flags2options(const char* flags) {
-    pcrecpp::RE_Options options;
-    options.set_utf8(true);
-    while (flags && *flags) {
-        if (*flags == 'i')
-            options.set_caseless(true);
-        else if (*flags == 'm')
-            options.set_multiline(true);
-        else if (*flags == 'x')
-            options.set_extended(true);
-        else if (*flags == 's')
-            options.set_dotall(true);
-        flags++;
-    }
-    return options;
-}
-
 RegexMatchExpression::RegexMatchExpression() : LeafMatchExpression(REGEX) {}
 
 RegexMatchExpression::~RegexMatchExpression() {}
@@ -284,7 +275,7 @@ Status RegexMatchExpression::init(StringData path, StringData regex, StringData
 
     _regex = regex.toString();
     _flags = options.toString();
-    _re.reset(new pcrecpp::RE(_regex.c_str(), flags2options(_flags.c_str())));
+    _re = RegexCache::get()->getOrCompile(_regex, _flags);
 
     return setPath(path);
 }
@@ -293,11 +284,10 @@ bool RegexMatchExpression::matchesSingleElement(const BSONElement& e) const {
     switch (e.type()) {
         case String:
         case Symbol: {
-            // String values stored in documents can contain embedded NUL bytes. We construct a
-            // pcrecpp::StringPiece instance using the full length of the string to avoid truncating
-            // 'data' early.
-            pcrecpp::StringPiece data(e.valuestr(), e.valuestrsize() - 1);
-            return _re->PartialMatch(data);
+            // String values stored in documents can contain embedded NUL bytes. We match against
+            // the full length of the string to avoid truncating 'data' early.
+            StringData data(e.valuestr(), e.valuestrsize() - 1);
+            return _re->partialMatch(data);
         }
         case RegEx:
             return _regex == e.regex() && _flags == e.regexFlags();
@@ -522,6 +512,7 @@ std::unique_ptr<MatchExpression> InMatchExpression::shallowClone() const {
     next->_hasEmptyArray = _hasEmptyArray;
     next->_equalitySet = _equalitySet;
     next->_originalEqualityVector = _originalEqualityVector;
+    next->_rebuildHashedEqualitySet();
     for (auto&& regex : _regexes) {
         std::unique_ptr<RegexMatchExpression> clonedRegex(
             static_cast<RegexMatchExpression*>(regex->shallowClone().release()));
@@ -534,7 +525,9 @@ bool InMatchExpression::matchesSingleElement(const BSONElement& e) const {
     if (_hasNull && e.eoo()) {
         return true;
     }
-    if (_equalitySet.find(e) != _equalitySet.end()) {
+    const bool isEquality = _hashedEqualitySet ? _hashedEqualitySet->count(e) != 0
+                                               : _equalitySet.find(e) != _equalitySet.end();
+    if (isEquality) {
         return true;
     }
     for (auto&& regex : _regexes) {
@@ -627,6 +620,22 @@ void InMatchExpression::_doSetCollator(const CollatorInterface* collator) {
     BSONElementSet equalitiesWithNewComparator(
         _originalEqualityVector.begin(), _originalEqualityVector.end(), collator);
     _equalitySet = std::move(equalitiesWithNewComparator);
+    _rebuildHashedEqualitySet();
+}
+
+void InMatchExpression::_rebuildHashedEqualitySet() {
+    _hashedEqualitySet.reset();
+    _hashedEqualityComparator.reset();
+    if (_equalitySet.size() < kMinEqualitiesForHashedLookup) {
+        return;
+    }
+
+    _hashedEqualityComparator = stdx::make_unique<BSONElementComparator>(
+        BSONElementComparator::FieldNamesMode::kIgnore, _collator);
+    _hashedEqualitySet = stdx::make_unique<BSONEltUnorderedSet>(
+        _hashedEqualityComparator->makeBSONEltUnorderedSet());
+    _hashedEqualitySet->reserve(_equalitySet.size());
+    _hashedEqualitySet->insert(_equalitySet.begin(), _equalitySet.end());
 }
 
 Status InMatchExpression::addEquality(const BSONElement& elt) {
@@ -645,6 +654,11 @@ Status InMatchExpression::addEquality(const BSONElement& elt) {
     }
     _equalitySet.insert(elt);
     _originalEqualityVector.push_back(elt);
+    if (_hashedEqualitySet) {
+        _hashedEqualitySet->insert(elt);
+    } else if (_equalitySet.size() >= kMinEqualitiesForHashedLookup) {
+        _rebuildHashedEqualitySet();
+    }
     return Status::OK();
 }
 
@@ -850,7 +864,7 @@ void BitTestMatchExpression::debugString(StringBuilder& debug, int level) const
 }
 
 void BitTestMatchExpression::serialize(BSONObjBuilder* out) const {
-    string opString = "";
+    std::string opString = "";
 
     switch (matchType()) {
         case BITS_ALL_SET:
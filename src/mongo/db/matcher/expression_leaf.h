@@ -30,19 +30,17 @@
 
 #pragma once
 
+#include "mongo/bson/bsonelement_comparator.h"
 #include "mongo/bson/bsonmisc.h"
 #include "mongo/bson/bsonobj.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/unordered_map.h"
 
-namespace pcrecpp {
-class RE;
-}  // namespace pcrecpp;
-
 namespace mongo {
 
 class CollatorInterface;
+class CompiledRegex;
 
 /**
  * This file contains leaves in the parse tree that are not array-based.
@@ -133,6 +131,12 @@ protected:
 
     // Collator used to compare elements. By default, simple binary comparison will be used.
     const CollatorInterface* _collator = nullptr;
+
+private:
+    // Properties of '_rhs' that matchesSingleElement() would otherwise recompute for every
+    // element it is given. Set by init().
+    int _rhsCanonicalType = 0;
+    bool _rhsIsNaN = false;
 };
 
 //
@@ -259,7 +263,7 @@ public:
 private:
     std::string _regex;
     std::string _flags;
-    std::unique_ptr<pcrecpp::RE> _re;
+    std::shared_ptr<const CompiledRegex> _re;  // Shared with other expressions via RegexCache.
 };
 
 class ModMatchExpression : public LeafMatchExpression {
@@ -370,6 +374,15 @@ public:
     }
 
 private:
+    // Once '_equalitySet' reaches this size, lookups go through '_hashedEqualitySet' instead.
+    static const size_t kMinEqualitiesForHashedLookup = 64;
+
+    /**
+     * Rebuilds '_hashedEqualitySet' from '_equalitySet' using the current '_collator', or discards
+     * it if '_equalitySet' is too small to benefit.
+     */
+    void _rebuildHashedEqualitySet();
+
     // Whether or not '_equalities' has a jstNULL element in it.
     bool _hasNull = false;
 
@@ -387,6 +400,12 @@ private:
     // '_equalitySet' in case '_collator' changes after elements have been added.
     std::vector<BSONElement> _originalEqualityVector;
 
+    // The same elements as '_equalitySet', hashed consistently with '_collator' so that large $in
+    // lists are searched in constant time. Null while '_equalitySet' is small. The set refers to
+    // '_hashedEqualityComparator', which therefore must outlive it.
+    std::unique_ptr<BSONElementComparator> _hashedEqualityComparator;
+    std::unique_ptr<BSONEltUnorderedSet> _hashedEqualitySet;
+
     // Container of regex elements this object owns.
     std::vector<std::unique_ptr<RegexMatchExpression>> _regexes;
 };
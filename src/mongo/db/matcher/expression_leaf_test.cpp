@@ -83,6 +83,27 @@ TEST(ComparisonMatchExpression, StringMatchingRespectsCollation) {
                           NULL));
 }
 
+TEST(ComparisonMatchExpression, NumericComparisonsAcrossTypes) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    BSONObj operand = BSON("a" << 5);
+    LTMatchExpression lt;
+    ASSERT(lt.init("", operand["a"]).isOK());
+    ASSERT(lt.matchesSingleElement(BSON("a" << 4).firstElement()));
+    ASSERT(lt.matchesSingleElement(BSON("a" << std::numeric_limits<int>::min()).firstElement()));
+    ASSERT(!lt.matchesSingleElement(BSON("a" << 5).firstElement()));
+    ASSERT(lt.matchesSingleElement(BSON("a" << 4.5).firstElement()));
+    ASSERT(lt.matchesSingleElement(BSON("a" << 4LL).firstElement()));
+    ASSERT(!lt.matchesSingleElement(BSON("a" << 5LL).firstElement()));
+    ASSERT(!lt.matchesSingleElement(BSON("a" << nan).firstElement()));
+
+    BSONObj nanOperand = BSON("a" << nan);
+    GTEMatchExpression gte;
+    ASSERT(gte.init("", nanOperand["a"]).isOK());
+    ASSERT(gte.matchesSingleElement(BSON("a" << nan).firstElement()));
+    ASSERT(!gte.matchesSingleElement(BSON("a" << 5).firstElement()));
+    ASSERT(!gte.matchesSingleElement(BSON("a" << 5.0).firstElement()));
+}
+
 TEST(EqOp, MatchesElement) {
     BSONObj operand = BSON("a" << 5);
     BSONObj match = BSON("a" << 5.0);
@@ -1707,6 +1728,44 @@ TEST(InMatchExpression, ChangingCollationAfterAddingEqualitiesPreservesEqualitie
     ASSERT(in.getEqualities().count(obj2.firstElement()));
 }
 
+TEST(InMatchExpression, LargeEqualityListMatchesLikeSmallOne) {
+    BSONArrayBuilder operandBuilder;
+    for (int i = 0; i < 200; ++i) {
+        operandBuilder.append(i * 2);
+    }
+    operandBuilder.append("string");
+    BSONArray operand = operandBuilder.arr();
+
+    InMatchExpression in;
+    for (auto&& elt : operand) {
+        ASSERT_OK(in.addEquality(elt));
+    }
+    ASSERT(in.matchesSingleElement(BSON("a" << 150).firstElement()));
+    ASSERT(in.matchesSingleElement(BSON("a" << 150.0).firstElement()));
+    ASSERT(in.matchesSingleElement(BSON("a" << 150LL).firstElement()));
+    ASSERT(in.matchesSingleElement(BSON("a" << Decimal128(150)).firstElement()));
+    ASSERT(!in.matchesSingleElement(BSON("a" << 151).firstElement()));
+    ASSERT(!in.matchesSingleElement(BSON("a" << 400).firstElement()));
+    ASSERT(in.matchesSingleElement(BSON("a"
+                                        << "string")
+                                       .firstElement()));
+    ASSERT(!in.matchesSingleElement(BSON("a"
+                                         << "string2")
+                                        .firstElement()));
+
+    // Clones and collation changes keep the equalities searchable.
+    auto clone = in.shallowClone();
+    ASSERT(clone->matchesSingleElement(BSON("a" << 150).firstElement()));
+
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kAlwaysEqual);
+    in.setCollator(&collator);
+    ASSERT(in.matchesSingleElement(BSON("a"
+                                        << "string2")
+                                       .firstElement()));
+    ASSERT(in.matchesSingleElement(BSON("a" << 150).firstElement()));
+    ASSERT(!in.matchesSingleElement(BSON("a" << 151).firstElement()));
+}
+
 std::vector<uint32_t> bsonArrayToBitPositions(const BSONArray& ba) {
     std::vector<uint32_t> bitPositions;
 
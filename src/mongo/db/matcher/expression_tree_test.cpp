@@ -36,6 +36,7 @@
 #include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/matcher/expression_tree.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
 
@@ -161,6 +162,35 @@ TEST(AndOp, MatchesElementThreeClauses) {
     ASSERT(!andOp.matchesBSON(notMatch3));
 }
 
+TEST(AndOp, MatchesManyClausesInDocumentWithManyFields) {
+    BSONObjBuilder bob;
+    for (int i = 0; i < 500; ++i) {
+        bob.append(str::stream() << "f" << i, i);
+    }
+    BSONObj match = bob.obj();
+    BSONObj notMatch = BSON("f499" << 0);
+
+    // After the first few clauses, the remaining ones look up their fields in a table of the
+    // document's top-level fields.
+    BSONObj operands = BSON("f499" << 499 << "f0" << 0 << "f250" << 250 << "f1" << 1 << "f2" << 2
+                                   << "f3"
+                                   << 3);
+    AndMatchExpression andOp;
+    for (auto&& operand : operands) {
+        unique_ptr<ComparisonMatchExpression> eq(new EqualityMatchExpression());
+        ASSERT(eq->init(operand.fieldNameStringData(), operand).isOK());
+        andOp.add(eq.release());
+    }
+
+    ASSERT(andOp.matchesBSON(match));
+    ASSERT(!andOp.matchesBSON(notMatch));
+
+    unique_ptr<ComparisonMatchExpression> eq(new EqualityMatchExpression());
+    ASSERT(eq->init("f498", BSON("" << 0).firstElement()).isOK());
+    andOp.add(eq.release());
+    ASSERT(!andOp.matchesBSON(match));
+}
+
 TEST(AndOp, MatchesSingleClause) {
     BSONObj baseOperand = BSON("$ne" << 5);
     unique_ptr<ComparisonMatchExpression> eq(new EqualityMatchExpression());
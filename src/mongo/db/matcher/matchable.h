@@ -32,8 +32,10 @@
 
 #include "mongo/bson/bsonobj.h"
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/field_ref.h"
 #include "mongo/db/matcher/path.h"
+#include "mongo/stdx/memory.h"
 
 namespace mongo {
 
@@ -85,10 +87,17 @@ public:
     }
 
     virtual ElementIterator* allocateIterator(const ElementPath* path) const {
-        if (_iteratorUsed)
-            return new BSONElementIterator(path, _obj);
+        const dotted_path_support::TopLevelFieldTable* fields = _getFieldTable();
+        if (_iteratorUsed) {
+            return fields ? new BSONElementIterator(path, *fields)
+                          : new BSONElementIterator(path, _obj);
+        }
         _iteratorUsed = true;
-        _iterator.reset(path, _obj);
+        if (fields) {
+            _iterator.reset(path, *fields);
+        } else {
+            _iterator.reset(path, _obj);
+        }
         return &_iterator;
     }
 
@@ -101,9 +110,23 @@ public:
     }
 
 private:
+    /**
+     * Counts a lookup of a path in '_obj'. Returns a table of the top-level fields of '_obj' once
+     * enough paths have been looked up for building one to pay off, and null until then.
+     */
+    const dotted_path_support::TopLevelFieldTable* _getFieldTable() const {
+        if (!_fields &&
+            dotted_path_support::TopLevelFieldTable::shouldBuild(_obj, ++_numLookups)) {
+            _fields = stdx::make_unique<dotted_path_support::TopLevelFieldTable>(_obj);
+        }
+        return _fields.get();
+    }
+
     BSONObj _obj;
     mutable BSONElementIterator _iterator;
     mutable bool _iteratorUsed;
+    mutable size_t _numLookups = 0;
+    mutable std::unique_ptr<dotted_path_support::TopLevelFieldTable> _fields;
 };
 
 /**
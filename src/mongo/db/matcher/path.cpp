@@ -29,6 +29,7 @@
  */
 
 #include "mongo/db/matcher/path.h"
+#include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/path_internal.h"
 #include "mongo/platform/basic.h"
@@ -96,6 +97,12 @@ BSONElementIterator::BSONElementIterator(const ElementPath* path, const BSONObj&
         getFieldDottedOrArray(objectToIterate, _path->fieldRef(), &_traversalStartIndex);
 }
 
+BSONElementIterator::BSONElementIterator(const ElementPath* path,
+                                         const dotted_path_support::TopLevelFieldTable& fields)
+    : _path(path), _state(BEGIN) {
+    _traversalStart = getFieldDottedOrArray(fields, _path->fieldRef(), &_traversalStartIndex);
+}
+
 BSONElementIterator::~BSONElementIterator() {}
 
 void BSONElementIterator::reset(const ElementPath* path,
@@ -124,6 +131,18 @@ void BSONElementIterator::reset(const ElementPath* path, const BSONObj& objectTo
     _subCursorPath.reset();
 }
 
+void BSONElementIterator::reset(const ElementPath* path,
+                                const dotted_path_support::TopLevelFieldTable& fields) {
+    _path = path;
+    _traversalStartIndex = 0;
+    _traversalStart = getFieldDottedOrArray(fields, _path->fieldRef(), &_traversalStartIndex);
+    _state = BEGIN;
+    _next.reset();
+
+    _subCursor.reset();
+    _subCursorPath.reset();
+}
+
 void BSONElementIterator::_setTraversalStart(size_t suffixIndex, BSONElement elementToIterate) {
     invariant(_path->fieldRef().numParts() >= suffixIndex);
 
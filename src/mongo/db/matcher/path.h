@@ -38,6 +38,10 @@
 
 namespace mongo {
 
+namespace dotted_path_support {
+class TopLevelFieldTable;
+}  // namespace dotted_path_support
+
 class ElementPath {
 public:
     Status init(StringData path);
@@ -152,10 +156,18 @@ public:
      */
     BSONElementIterator(const ElementPath* path, const BSONObj& objectToIterate);
 
+    /**
+     * Constructs an iterator over the object whose top-level fields are in 'fields', looking up the
+     * first component of 'path' in 'fields'. 'fields' must outlive the iterator.
+     */
+    BSONElementIterator(const ElementPath* path,
+                        const dotted_path_support::TopLevelFieldTable& fields);
+
     virtual ~BSONElementIterator();
 
     void reset(const ElementPath* path, size_t suffixIndex, BSONElement elementToIterate);
     void reset(const ElementPath* path, const BSONObj& objectToIterate);
+    void reset(const ElementPath* path, const dotted_path_support::TopLevelFieldTable& fields);
 
     bool more();
     Context next();
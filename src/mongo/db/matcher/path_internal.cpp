@@ -81,5 +81,25 @@ BSONElement getFieldDottedOrArray(const BSONObj& doc,
     return res;
 }
 
+BSONElement getFieldDottedOrArray(const dotted_path_support::TopLevelFieldTable& fields,
+                                  const FieldRef& path,
+                                  size_t* idxPath) {
+    if (path.numParts() == 0)
+        return getFieldDottedOrArray(fields.obj(), path, idxPath);
+
+    BSONElement res = fields.getField(path.getPart(0));
+    if (res.type() == Object) {
+        if (path.numParts() > 1)
+            return getFieldDottedOrArray(res.Obj(), path, idxPath, 1);
+        *idxPath = 1;
+        return res;
+    }
+
+    *idxPath = 0;
+    if (res.type() != Array && path.numParts() > 1)
+        return BSONElement();
+    return res;
+}
+
 
 }  // namespace mongo
@@ -33,6 +33,7 @@
 #include <cstdint>
 
 #include "mongo/base/string_data.h"
+#include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/field_ref.h"
 #include "mongo/db/jsobj.h"
 
@@ -50,4 +51,12 @@ BSONElement getFieldDottedOrArray(const BSONObj& doc,
                                   size_t* idxPath,
                                   size_t startIndex = 0);
 
+/**
+ * Same as above, starting at the beginning of 'path', but looks up the first component of 'path'
+ * in 'fields' instead of scanning the object.
+ */
+BSONElement getFieldDottedOrArray(const dotted_path_support::TopLevelFieldTable& fields,
+                                  const FieldRef& path,
+                                  size_t* idxPath);
+
 }  // namespace mongo
@@ -31,6 +31,7 @@
 
 #include "mongo/unittest/unittest.h"
 
+#include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/json.h"
 #include "mongo/db/matcher/path.h"
@@ -404,6 +405,31 @@ TEST(Path, ArrayOffsetWithImplicitAndExplicitTraversal) {
     ASSERT(!cursor.more());
 }
 
+TEST(Path, IteratorOverFieldTableMatchesIteratorOverObject) {
+    BSONObj doc = fromjson(
+        "{x: 4, a: 5, b: {c: [1, {d: 2}], e: {f: 3}}, g: [{h: 1}, {h: [2, 3]}], i: {}, j: []}");
+    dotted_path_support::TopLevelFieldTable fields(doc);
+
+    for (StringData path :
+         {"a", "a.x", "b", "b.c", "b.c.d", "b.c.1.d", "b.e.f", "g.h", "g.1.h", "i", "i.x", "j",
+          "j.0", "y", "y.z"}) {
+        ElementPath p;
+        ASSERT(p.init(path).isOK());
+
+        BSONElementIterator objCursor(&p, doc);
+        BSONElementIterator tableCursor(&p, fields);
+        while (objCursor.more()) {
+            ASSERT(tableCursor.more()) << path;
+            ElementIterator::Context objElt = objCursor.next();
+            ElementIterator::Context tableElt = tableCursor.next();
+            ASSERT_EQUALS(objElt.element().rawdata(), tableElt.element().rawdata()) << path;
+            ASSERT_EQUALS(objElt.arrayOffset().rawdata(), tableElt.arrayOffset().rawdata())
+                << path;
+        }
+        ASSERT(!tableCursor.more()) << path;
+    }
+}
+
 TEST(SimpleArrayElementIterator, SimpleNoArrayLast1) {
     BSONObj obj = BSON("a" << BSON_ARRAY(5 << BSON("x" << 6) << BSON_ARRAY(7 << 9) << 11));
     SimpleArrayElementIterator i(obj["a"], false);
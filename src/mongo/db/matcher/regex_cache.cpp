@@ -0,0 +1,156 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/regex_cache.h"
+
+#include <pcre.h>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/server_parameters.h"
+
+namespace mongo {
+
+// The maximum number of compiled regular expressions held by the process-wide cache.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(internalQueryRegexCacheSize, int, 1000);
+
+namespace {
+
+int flagsToOptions(const std::string& flags) {
+    int options = PCRE_UTF8;
+    for (const char flag : flags) {
+        if (flag == 'i')
+            options |= PCRE_CASELESS;
+        else if (flag == 'm')
+            options |= PCRE_MULTILINE;
+        else if (flag == 'x')
+            options |= PCRE_EXTENDED;
+        else if (flag == 's')
+            options |= PCRE_DOTALL;
+    }
+    return options;
+}
+
+class RegexCacheMetric : public ServerStatusMetric {
+public:
+    RegexCacheMetric() : ServerStatusMetric("query.regexCache") {}
+
+    void appendAtLeaf(BSONObjBuilder& b) const final {
+        BSONObjBuilder cacheBuilder(b.subobjStart(_leafName));
+        RegexCache::get()->appendStats(&cacheBuilder);
+    }
+} regexCacheMetric;
+
+}  // namespace
+
+CompiledRegex::CompiledRegex(const std::string& pattern, const std::string& flags) {
+    const char* error;
+    int errorOffset;
+    _re = pcre_compile(pattern.c_str(), flagsToOptions(flags), &error, &errorOffset, nullptr);
+    if (!_re) {
+        return;
+    }
+
+    // JIT compilation is silently skipped when PCRE was built without JIT support. Studying may
+    // still find a set of possible starting bytes which speeds up unanchored matching.
+    _extra = pcre_study(_re, PCRE_STUDY_JIT_COMPILE, &error);
+
+    int jit = 0;
+    _jitCompiled = _extra && pcre_fullinfo(_re, _extra, PCRE_INFO_JIT, &jit) == 0 && jit;
+}
+
+CompiledRegex::~CompiledRegex() {
+    if (_extra) {
+        pcre_free_study(_extra);
+    }
+    if (_re) {
+        pcre_free(_re);
+    }
+}
+
+bool CompiledRegex::partialMatch(StringData input) const {
+    if (!_re) {
+        return false;
+    }
+
+    // A return value of 0 still means the pattern matched; we just asked for no captures.
+    const int rc = pcre_exec(_re,
+                             _extra,
+                             input.rawData() ? input.rawData() : "",
+                             input.size(),
+                             0,
+                             0,
+                             nullptr,
+                             0);
+    return rc >= 0;
+}
+
+RegexCache* RegexCache::get() {
+    static RegexCache* cache = new RegexCache(std::max(internalQueryRegexCacheSize, 0));
+    return cache;
+}
+
+RegexCache::RegexCache(size_t capacity) : _capacity(capacity), _cache(capacity) {}
+
+std::shared_ptr<const CompiledRegex> RegexCache::getOrCompile(const std::string& pattern,
+                                                             const std::string& flags) {
+    // Neither patterns nor flags can contain a null byte, so this key is unambiguous.
+    std::string key = flags;
+    key.push_back('\0');
+    key.append(pattern);
+
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto it = _cache.find(key);  // Also marks the entry as most recently used.
+        if (it != _cache.end()) {
+            ++_hits;
+            return it->second;
+        }
+        ++_misses;
+    }
+
+    // Compile without holding the lock. If another thread compiled the same pattern meanwhile,
+    // replacing its entry is harmless since both are equivalent.
+    auto compiled = std::make_shared<const CompiledRegex>(pattern, flags);
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _cache.add(key, compiled);
+    return compiled;
+}
+
+void RegexCache::appendStats(BSONObjBuilder* builder) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    builder->appendNumber("size", static_cast<long long>(_cache.size()));
+    builder->appendNumber("capacity", static_cast<long long>(_capacity));
+    builder->append("hits", _hits);
+    builder->append("misses", _misses);
+}
+
+}  // namespace mongo
@@ -0,0 +1,117 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/lru_cache.h"
+
+struct real_pcre;
+struct pcre_extra;
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * A regular expression compiled once with the $regex option letters 'i', 'm', 'x' and 's', and
+ * studied so that matching can use PCRE's JIT when the linked PCRE library was built with it.
+ *
+ * A pattern which fails to compile never matches anything, as with pcrecpp::RE. Matching is
+ * const and thread-safe, so one instance can be shared by any number of expressions.
+ */
+class CompiledRegex {
+    MONGO_DISALLOW_COPYING(CompiledRegex);
+
+public:
+    CompiledRegex(const std::string& pattern, const std::string& flags);
+    ~CompiledRegex();
+
+    /**
+     * Returns true if the pattern matches anywhere in 'input'.
+     */
+    bool partialMatch(StringData input) const;
+
+    bool isValid() const {
+        return _re != nullptr;
+    }
+
+    bool isJitCompiled() const {
+        return _jitCompiled;
+    }
+
+private:
+    real_pcre* _re = nullptr;
+    pcre_extra* _extra = nullptr;
+    bool _jitCompiled = false;
+};
+
+/**
+ * A bounded, least recently used cache of compiled regular expressions keyed by pattern and
+ * flags, so that the same $regex in many queries is only compiled once.
+ *
+ * This class is thread-safe.
+ */
+class RegexCache {
+    MONGO_DISALLOW_COPYING(RegexCache);
+
+public:
+    /**
+     * Returns the process-wide cache, which holds up to internalQueryRegexCacheSize entries.
+     */
+    static RegexCache* get();
+
+    explicit RegexCache(size_t capacity);
+
+    /**
+     * Returns the cached compilation of 'pattern' with 'flags', compiling and caching it first if
+     * it is not already present.
+     */
+    std::shared_ptr<const CompiledRegex> getOrCompile(const std::string& pattern,
+                                                     const std::string& flags);
+
+    /**
+     * Appends the size, capacity, and hit and miss counts of this cache to 'builder'.
+     */
+    void appendStats(BSONObjBuilder* builder) const;
+
+private:
+    const size_t _capacity;
+
+    mutable stdx::mutex _mutex;
+    LRUCache<std::string, std::shared_ptr<const CompiledRegex>> _cache;
+    long long _hits = 0;
+    long long _misses = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,121 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/regex_cache.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(CompiledRegexTest, MatchesAnywhereInInput) {
+    CompiledRegex re("b+c", "");
+    ASSERT(re.isValid());
+    ASSERT(re.partialMatch("abbcd"));
+    ASSERT(re.partialMatch("bc"));
+    ASSERT_FALSE(re.partialMatch("ac"));
+    ASSERT_FALSE(re.partialMatch(""));
+}
+
+TEST(CompiledRegexTest, HonorsFlags) {
+    ASSERT_FALSE(CompiledRegex("^abc$", "").partialMatch("ABC"));
+    ASSERT(CompiledRegex("^abc$", "i").partialMatch("ABC"));
+
+    ASSERT_FALSE(CompiledRegex("^b", "").partialMatch("a\nb"));
+    ASSERT(CompiledRegex("^b", "m").partialMatch("a\nb"));
+
+    ASSERT_FALSE(CompiledRegex("a.b", "").partialMatch("a\nb"));
+    ASSERT(CompiledRegex("a.b", "s").partialMatch("a\nb"));
+
+    ASSERT_FALSE(CompiledRegex("a b # comment", "").partialMatch("ab"));
+    ASSERT(CompiledRegex("a b # comment", "x").partialMatch("ab"));
+}
+
+TEST(CompiledRegexTest, MatchesUtf8Characters) {
+    CompiledRegex re("^.$", "");
+    ASSERT(re.partialMatch("\xc3\xa9"));
+}
+
+TEST(CompiledRegexTest, MatchesPastEmbeddedNullBytes) {
+    CompiledRegex re("b$", "");
+    ASSERT(re.partialMatch(StringData("a\0b", 3)));
+}
+
+TEST(CompiledRegexTest, InvalidPatternNeverMatches) {
+    CompiledRegex re("a(", "");
+    ASSERT_FALSE(re.isValid());
+    ASSERT_FALSE(re.partialMatch("a("));
+}
+
+TEST(RegexCacheTest, ReturnsCachedEntryForSamePatternAndFlags) {
+    RegexCache cache(10);
+    auto first = cache.getOrCompile("abc", "i");
+    ASSERT(first == cache.getOrCompile("abc", "i"));
+    ASSERT(first != cache.getOrCompile("abc", ""));
+    ASSERT(first != cache.getOrCompile("abcd", "i"));
+
+    BSONObjBuilder builder;
+    cache.appendStats(&builder);
+    ASSERT_BSONOBJ_EQ(BSON("size" << 3 << "capacity" << 10 << "hits" << 1LL << "misses" << 3LL),
+                      builder.obj());
+}
+
+TEST(RegexCacheTest, FlagsAndPatternDoNotCollide) {
+    RegexCache cache(10);
+    auto re = cache.getOrCompile("i", "");
+    ASSERT(re != cache.getOrCompile("", "i"));
+    ASSERT(re->partialMatch("i"));
+}
+
+TEST(RegexCacheTest, EvictsLeastRecentlyUsedEntry) {
+    RegexCache cache(2);
+    auto a = cache.getOrCompile("a", "");
+    auto b = cache.getOrCompile("b", "");
+
+    // Using 'a' again makes 'b' the entry evicted by 'c'.
+    ASSERT(a == cache.getOrCompile("a", ""));
+    cache.getOrCompile("c", "");
+    ASSERT(a == cache.getOrCompile("a", ""));
+    ASSERT(b != cache.getOrCompile("b", ""));
+
+    // Evicted entries stay usable by whoever still holds them.
+    ASSERT(b->partialMatch("b"));
+}
+
+TEST(RegexCacheTest, ZeroCapacityDisablesCaching) {
+    RegexCache cache(0);
+    auto re = cache.getOrCompile("a", "");
+    ASSERT(re != cache.getOrCompile("a", ""));
+    ASSERT(re->partialMatch("a"));
+}
+
+}  // namespace
+}  // namespace mongo
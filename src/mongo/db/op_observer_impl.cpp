@@ -33,19 +33,50 @@
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/auth/authorization_manager_global.h"
 #include "mongo/db/catalog/collection_options.h"
+#include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/commands/feature_compatibility_version.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/query/query_result_cache.h"
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/server_options.h"
 #include "mongo/db/views/durable_view_catalog.h"
+#include "mongo/db/views/view_catalog.h"
 #include "mongo/scripting/engine.h"
 #include "mongo/util/namespace_uuid_cache.h"
 #include "mongo/util/uuid_catalog.h"
 
 namespace mongo {
+namespace {
+
+/**
+ * Lets the view catalog of the database of 'nss' know that the contents of 'nss' are changing, or
+ * that 'nss' is going away if 'dropped' is true, so that it can tell when the views materialized
+ * from 'nss' become stale.
+ */
+void onMaterializedViewSourceChange(OperationContext* opCtx,
+                                    const NamespaceString& nss,
+                                    bool dropped) {
+    if (!ViewCatalog::anyMaterializedViews()) {
+        return;
+    }
+
+    Database* db = dbHolder().get(opCtx, nss.db());
+    if (!db) {
+        return;
+    }
+
+    if (dropped) {
+        db->getViewCatalog()->onCollectionDrop(opCtx, nss);
+    } else {
+        db->getViewCatalog()->onSourceChange(opCtx, nss);
+    }
+}
+
+}  // namespace
 
 void OpObserverImpl::onCreateIndex(OperationContext* opCtx,
                                    const NamespaceString& nss,
@@ -103,6 +134,8 @@ void OpObserverImpl::onInserts(OperationContext* opCtx,
     if (nss.coll() == DurableViewCatalog::viewsCollectionName()) {
         DurableViewCatalog::onExternalChange(opCtx, nss);
     }
+    onMaterializedViewSourceChange(opCtx, nss, false);
+    QueryResultCache::onCollectionWrite(opCtx, nss);
 }
 
 void OpObserverImpl::onUpdate(OperationContext* opCtx, const OplogUpdateEntryArgs& args) {
@@ -131,6 +164,8 @@ void OpObserverImpl::onUpdate(OperationContext* opCtx, const OplogUpdateEntryArg
     if (args.nss.ns() == FeatureCompatibilityVersion::kCollection) {
         FeatureCompatibilityVersion::onInsertOrUpdate(args.updatedDoc);
     }
+    onMaterializedViewSourceChange(opCtx, args.nss, false);
+    QueryResultCache::onCollectionWrite(opCtx, args.nss);
 }
 
 CollectionShardingState::DeleteState OpObserverImpl::aboutToDelete(OperationContext* opCtx,
@@ -153,6 +188,8 @@ void OpObserverImpl::onDelete(OperationContext* opCtx,
                               OptionalCollectionUUID uuid,
                               CollectionShardingState::DeleteState deleteState,
                               bool fromMigrate) {
+    QueryResultCache::onCollectionWrite(opCtx, nss);
+
     if (deleteState.idDoc.isEmpty())
         return;
 
@@ -174,6 +211,7 @@ void OpObserverImpl::onDelete(OperationContext* opCtx,
     if (nss.ns() == FeatureCompatibilityVersion::kCollection) {
         FeatureCompatibilityVersion::onDelete(deleteState.idDoc);
     }
+    onMaterializedViewSourceChange(opCtx, nss, false);
 }
 
 void OpObserverImpl::onOpMessage(OperationContext* opCtx, const BSONObj& msgObj) {
@@ -291,6 +329,7 @@ void OpObserverImpl::onDropDatabase(OperationContext* opCtx, const std::string&
     if (dbName == FeatureCompatibilityVersion::kDatabase) {
         FeatureCompatibilityVersion::onDropCollection();
     }
+    QueryResultCache::onDatabaseWrite(opCtx, dbName);
 
     getGlobalAuthorizationManager()->logOp(opCtx, "c", cmdNss, cmdObj, nullptr);
 }
@@ -314,6 +353,8 @@ repl::OpTime OpObserverImpl::onDropCollection(OperationContext* opCtx,
     if (collectionName.ns() == FeatureCompatibilityVersion::kCollection) {
         FeatureCompatibilityVersion::onDropCollection();
     }
+    onMaterializedViewSourceChange(opCtx, collectionName, true);
+    QueryResultCache::onCollectionWrite(opCtx, collectionName);
 
     getGlobalAuthorizationManager()->logOp(opCtx, "c", dbName, cmdObj, nullptr);
 
@@ -342,6 +383,9 @@ void OpObserverImpl::onDropIndex(OperationContext* opCtx,
     auto commandNS = nss.getCommandNS();
     repl::logOp(opCtx, "c", commandNS, uuid, cmdObj, &indexInfo, false);
 
+    // Queries hinting or needing the index fail from now on, so their results must be forgotten.
+    QueryResultCache::onCollectionWrite(opCtx, nss);
+
     getGlobalAuthorizationManager()->logOp(opCtx, "c", commandNS, cmdObj, &indexInfo);
 }
 
@@ -374,6 +418,10 @@ void OpObserverImpl::onRenameCollection(OperationContext* opCtx,
         DurableViewCatalog::onExternalChange(
             opCtx, NamespaceString(DurableViewCatalog::viewsCollectionName()));
     }
+    onMaterializedViewSourceChange(opCtx, fromCollection, true);
+    onMaterializedViewSourceChange(opCtx, toCollection, false);
+    QueryResultCache::onCollectionWrite(opCtx, fromCollection);
+    QueryResultCache::onCollectionWrite(opCtx, toCollection);
 
     getGlobalAuthorizationManager()->logOp(opCtx, "c", cmdNss, cmdObj, nullptr);
 
@@ -402,6 +450,7 @@ void OpObserverImpl::onConvertToCapped(OperationContext* opCtx,
         // do not replicate system.profile modifications
         repl::logOp(opCtx, "c", cmdNss, uuid, cmdObj, nullptr, false);
     }
+    QueryResultCache::onCollectionWrite(opCtx, collectionName);
 
     getGlobalAuthorizationManager()->logOp(opCtx, "c", cmdNss, cmdObj, nullptr);
 }
@@ -417,6 +466,9 @@ void OpObserverImpl::onEmptyCapped(OperationContext* opCtx,
         repl::logOp(opCtx, "c", cmdNss, uuid, cmdObj, nullptr, false);
     }
 
+    onMaterializedViewSourceChange(opCtx, collectionName, false);
+    QueryResultCache::onCollectionWrite(opCtx, collectionName);
+
     getGlobalAuthorizationManager()->logOp(opCtx, "c", cmdNss, cmdObj, nullptr);
 }
 
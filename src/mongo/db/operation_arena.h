@@ -0,0 +1,52 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/util/arena.h"
+
+namespace mongo {
+
+class OperationContext;
+
+/**
+ * Gives access to the Arena of an operation, from which the operation can draw memory for
+ * transient buffers and have it released wholesale when its OperationContext is destroyed.
+ *
+ * Memory from it must not outlive the OperationContext. In particular, nothing which is kept by
+ * a cursor across getMores may be allocated from it, since each getMore runs under a new
+ * OperationContext.
+ *
+ * Only accessed by the thread running the operation.
+ */
+class OperationArena {
+public:
+    static Arena& get(OperationContext* opCtx);
+};
+
+}  // namespace mongo
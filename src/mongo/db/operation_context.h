@@ -36,6 +36,7 @@
 #include "mongo/db/client.h"
 #include "mongo/db/concurrency/locker.h"
 #include "mongo/db/logical_session_id.h"
+#include "mongo/db/operation_phases.h"
 #include "mongo/db/storage/recovery_unit.h"
 #include "mongo/db/storage/recovery_unit.h"
 #include "mongo/db/storage/storage_options.h"
@@ -500,6 +501,7 @@ public:
         invariant(!_committed);
         invariant(_opCtx->_ruState == OperationContext::kActiveUnitOfWork);
         if (_toplevel) {
+            OperationPhases::Scope commitPhase(_opCtx, OperationPhases::Phase::kStorageCommit);
             _opCtx->recoveryUnit()->commitUnitOfWork();
             _opCtx->_ruState = OperationContext::kNotInUnitOfWork;
         }
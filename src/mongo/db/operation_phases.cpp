@@ -0,0 +1,103 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/operation_phases.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+namespace {
+
+const auto getOperationPhases = OperationContext::declareDecoration<OperationPhases>();
+
+}  // namespace
+
+OperationPhases::Scope::Scope(OperationContext* opCtx, Phase phase)
+    : _phases(opCtx ? &get(opCtx) : nullptr) {
+    if (_phases) {
+        _interrupted = _phases->_current;
+        _phases->_transitionTo(static_cast<int>(phase));
+    }
+}
+
+OperationPhases::Scope::~Scope() {
+    if (_phases) {
+        _phases->_transitionTo(_interrupted);
+    }
+}
+
+OperationPhases& OperationPhases::get(OperationContext* opCtx) {
+    return getOperationPhases(opCtx);
+}
+
+StringData OperationPhases::phaseName(Phase phase) {
+    switch (phase) {
+        case Phase::kParse:
+            return "parse"_sd;
+        case Phase::kAuthorization:
+            return "authorization"_sd;
+        case Phase::kLockAcquisition:
+            return "lockAcquisition"_sd;
+        case Phase::kPlanning:
+            return "planning"_sd;
+        case Phase::kYield:
+            return "yield"_sd;
+        case Phase::kStorageCommit:
+            return "storageCommit"_sd;
+        case Phase::kWriteConcern:
+            return "writeConcern"_sd;
+        case Phase::kResponse:
+            return "response"_sd;
+    }
+    MONGO_UNREACHABLE;
+}
+
+void OperationPhases::append(BSONObjBuilder* builder) const {
+    for (size_t i = 0; i < kNumPhases; ++i) {
+        if (_micros[i] > 0) {
+            builder->append(phaseName(static_cast<Phase>(i)), _micros[i]);
+        }
+    }
+}
+
+void OperationPhases::_transitionTo(int phase) {
+    const unsigned long long now = curTimeMicros64();
+    if (_current >= 0 && now > _currentStart) {
+        _micros[_current] += now - _currentStart;
+    }
+    _current = phase;
+    _currentStart = now;
+}
+
+}  // namespace mongo
@@ -0,0 +1,109 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class OperationContext;
+
+/**
+ * Accumulates the time an operation spends in each of the phases which most often explain its
+ * latency. Phases nest: while a phase is active, the time of the phase it interrupted is not
+ * counted, so the phases of an operation never overlap, and the rest of its time was spent
+ * executing it.
+ *
+ * Kept on the OperationContext so that the locking and storage layers, which do not see the
+ * CurOp of the operation, can mark their phases.
+ *
+ * Only accessed by the thread running the operation.
+ */
+class OperationPhases {
+public:
+    enum class Phase {
+        kParse,
+        kAuthorization,
+        kLockAcquisition,
+        kPlanning,
+        kYield,
+        kStorageCommit,
+        kWriteConcern,
+        kResponse,
+    };
+
+    static const size_t kNumPhases = 8;
+
+    /**
+     * Charges the time elapsed during its lifetime to 'phase' of the operation of 'opCtx', which
+     * may be null, in which case nothing is recorded.
+     */
+    class Scope {
+        MONGO_DISALLOW_COPYING(Scope);
+
+    public:
+        Scope(OperationContext* opCtx, Phase phase);
+        ~Scope();
+
+    private:
+        OperationPhases* const _phases;
+        int _interrupted;
+    };
+
+    static OperationPhases& get(OperationContext* opCtx);
+
+    static StringData phaseName(Phase phase);
+
+    long long micros(Phase phase) const {
+        return _micros[static_cast<size_t>(phase)];
+    }
+
+    /**
+     * Appends the time spent in each phase the operation went through, in microseconds.
+     */
+    void append(BSONObjBuilder* builder) const;
+
+private:
+    /**
+     * Charges the time since the last transition to the current phase, if any, and then makes
+     * 'phase' current, or no phase if it is negative.
+     */
+    void _transitionTo(int phase);
+
+    std::array<long long, kNumPhases> _micros{};
+    int _current = -1;
+    unsigned long long _currentStart = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,123 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/operation_phases.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/client.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/service_context_noop.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+using Phase = OperationPhases::Phase;
+
+class OperationPhasesTest : public unittest::Test {
+protected:
+    OperationPhasesTest()
+        : _serviceCtx(stdx::make_unique<ServiceContextNoop>()),
+          _client(_serviceCtx->makeClient("OperationPhasesTest")),
+          _opCtx(_client->makeOperationContext()) {}
+
+    OperationContext* opCtx() {
+        return _opCtx.get();
+    }
+
+private:
+    std::unique_ptr<ServiceContextNoop> _serviceCtx;
+    ServiceContext::UniqueClient _client;
+    ServiceContext::UniqueOperationContext _opCtx;
+};
+
+TEST_F(OperationPhasesTest, NoPhaseIsChargedByDefault) {
+    const auto& phases = OperationPhases::get(opCtx());
+    for (size_t i = 0; i < OperationPhases::kNumPhases; ++i) {
+        ASSERT_EQ(0, phases.micros(static_cast<Phase>(i)));
+    }
+
+    BSONObjBuilder builder;
+    phases.append(&builder);
+    ASSERT_BSONOBJ_EQ(BSONObj(), builder.obj());
+}
+
+TEST_F(OperationPhasesTest, ScopeChargesItsPhase) {
+    {
+        OperationPhases::Scope scope(opCtx(), Phase::kParse);
+        sleepmillis(2);
+    }
+
+    const auto& phases = OperationPhases::get(opCtx());
+    ASSERT_GTE(phases.micros(Phase::kParse), 2000);
+    ASSERT_EQ(0, phases.micros(Phase::kResponse));
+
+    BSONObjBuilder builder;
+    phases.append(&builder);
+    BSONObj obj = builder.obj();
+    ASSERT_EQ(1, obj.nFields());
+    ASSERT_EQ(phases.micros(Phase::kParse), obj["parse"].numberLong());
+}
+
+TEST_F(OperationPhasesTest, NestedPhaseIsNotChargedToItsParent) {
+    const long long start = curTimeMicros64();
+    {
+        OperationPhases::Scope planning(opCtx(), Phase::kPlanning);
+        {
+            OperationPhases::Scope yield(opCtx(), Phase::kYield);
+            sleepmillis(20);
+        }
+        sleepmillis(2);
+    }
+    const long long elapsed = curTimeMicros64() - start;
+
+    const auto& phases = OperationPhases::get(opCtx());
+    ASSERT_GTE(phases.micros(Phase::kYield), 20000);
+    ASSERT_GTE(phases.micros(Phase::kPlanning), 2000);
+    ASSERT_LT(phases.micros(Phase::kPlanning), phases.micros(Phase::kYield));
+    ASSERT_LTE(phases.micros(Phase::kPlanning) + phases.micros(Phase::kYield), elapsed);
+}
+
+TEST_F(OperationPhasesTest, RepeatedPhasesAccumulate) {
+    for (int i = 0; i < 3; ++i) {
+        OperationPhases::Scope scope(opCtx(), Phase::kLockAcquisition);
+        sleepmillis(1);
+    }
+    ASSERT_GTE(OperationPhases::get(opCtx()).micros(Phase::kLockAcquisition), 3000);
+}
+
+TEST_F(OperationPhasesTest, ScopeWithoutOperationContextRecordsNothing) {
+    OperationPhases::Scope scope(nullptr, Phase::kWriteConcern);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -33,11 +33,13 @@
 
 #include <vector>
 
+#include "mongo/base/data_view.h"
 #include "mongo/bson/bson_depth.h"
 #include "mongo/db/logical_clock.h"
 #include "mongo/db/logical_time.h"
 #include "mongo/db/views/durable_view_catalog.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/shared_buffer.h"
 
 namespace mongo {
 
@@ -75,105 +77,201 @@ Status validateDepth(const BSONObj& obj) {
 
     return Status::OK();
 }
-}  // namespace
 
-StatusWith<BSONObj> fixDocumentForInsert(ServiceContext* service, const BSONObj& doc) {
+/**
+ * What validateForInsert() learned about a document, which decides how it has to be fixed.
+ */
+struct InsertDocumentInfo {
+    bool firstElementIsId = false;
+    bool hasTimestampToFix = false;
+    bool hadId = false;
+
+    bool needsRebuild() const {
+        return !firstElementIsId || hasTimestampToFix;
+    }
+
+    int fixedSize(const BSONObj& doc) const {
+        return doc.objsize() + (hadId ? 0 : kGeneratedIdSize);
+    }
+
+    // Size of the {_id: ObjectId} element added to documents without an _id.
+    static const int kGeneratedIdSize = 1 + sizeof("_id") + OID::kOIDSize;
+};
+
+Status validateForInsert(const BSONObj& doc, InsertDocumentInfo* info) {
     if (doc.objsize() > BSONObjMaxUserSize)
-        return StatusWith<BSONObj>(ErrorCodes::BadValue,
-                                   str::stream() << "object to insert too large"
-                                                 << ". size in bytes: "
-                                                 << doc.objsize()
-                                                 << ", max size: "
-                                                 << BSONObjMaxUserSize);
+        return Status(ErrorCodes::BadValue,
+                      str::stream() << "object to insert too large"
+                                    << ". size in bytes: "
+                                    << doc.objsize()
+                                    << ", max size: "
+                                    << BSONObjMaxUserSize);
 
     auto depthStatus = validateDepth(doc);
     if (!depthStatus.isOK()) {
         return depthStatus;
     }
 
-    bool firstElementIsId = false;
-    bool hasTimestampToFix = false;
-    bool hadId = false;
-    {
-        BSONObjIterator i(doc);
-        for (bool isFirstElement = true; i.more(); isFirstElement = false) {
-            BSONElement e = i.next();
-
-            if (e.type() == bsonTimestamp && e.timestampValue() == 0) {
-                // we replace Timestamp(0,0) at the top level with a correct value
-                // in the fast pass, we just mark that we want to swap
-                hasTimestampToFix = true;
-            }
+    BSONObjIterator i(doc);
+    for (bool isFirstElement = true; i.more(); isFirstElement = false) {
+        BSONElement e = i.next();
 
-            auto fieldName = e.fieldNameStringData();
+        if (e.type() == bsonTimestamp && e.timestampValue() == 0) {
+            // we replace Timestamp(0,0) at the top level with a correct value
+            // in the fast pass, we just mark that we want to swap
+            info->hasTimestampToFix = true;
+        }
 
-            if (fieldName[0] == '$') {
-                return StatusWith<BSONObj>(
-                    ErrorCodes::BadValue,
-                    str::stream() << "Document can't have $ prefixed field names: " << fieldName);
-            }
+        auto fieldName = e.fieldNameStringData();
 
-            // check no regexp for _id (SERVER-9502)
-            // also, disallow undefined and arrays
-            // Make sure _id isn't duplicated (SERVER-19361).
-            if (fieldName == "_id") {
-                if (e.type() == RegEx) {
-                    return StatusWith<BSONObj>(ErrorCodes::BadValue, "can't use a regex for _id");
-                }
-                if (e.type() == Undefined) {
-                    return StatusWith<BSONObj>(ErrorCodes::BadValue,
-                                               "can't use a undefined for _id");
-                }
-                if (e.type() == Array) {
-                    return StatusWith<BSONObj>(ErrorCodes::BadValue, "can't use an array for _id");
-                }
-                if (e.type() == Object) {
-                    BSONObj o = e.Obj();
-                    Status s = o.storageValidEmbedded();
-                    if (!s.isOK())
-                        return StatusWith<BSONObj>(s);
-                }
-                if (hadId) {
-                    return StatusWith<BSONObj>(ErrorCodes::BadValue,
-                                               "can't have multiple _id fields in one document");
-                } else {
-                    hadId = true;
-                    firstElementIsId = isFirstElement;
-                }
+        if (fieldName[0] == '$') {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << "Document can't have $ prefixed field names: "
+                                        << fieldName);
+        }
+
+        // check no regexp for _id (SERVER-9502)
+        // also, disallow undefined and arrays
+        // Make sure _id isn't duplicated (SERVER-19361).
+        if (fieldName == "_id") {
+            if (e.type() == RegEx) {
+                return Status(ErrorCodes::BadValue, "can't use a regex for _id");
+            }
+            if (e.type() == Undefined) {
+                return Status(ErrorCodes::BadValue, "can't use a undefined for _id");
+            }
+            if (e.type() == Array) {
+                return Status(ErrorCodes::BadValue, "can't use an array for _id");
+            }
+            if (e.type() == Object) {
+                BSONObj o = e.Obj();
+                Status s = o.storageValidEmbedded();
+                if (!s.isOK())
+                    return s;
+            }
+            if (info->hadId) {
+                return Status(ErrorCodes::BadValue,
+                              "can't have multiple _id fields in one document");
+            } else {
+                info->hadId = true;
+                info->firstElementIsId = isFirstElement;
             }
         }
     }
 
-    if (firstElementIsId && !hasTimestampToFix)
-        return StatusWith<BSONObj>(BSONObj());
+    return Status::OK();
+}
 
-    BSONObjIterator i(doc);
+/**
+ * Writes the fixed version of 'doc' at 'out', which must have room for info.fixedSize(doc) bytes:
+ * _id is moved to the front, or 'generatedId' is put there if 'doc' has no _id, and top-level
+ * Timestamp(0, 0) values are replaced with the reserved cluster times.
+ */
+void writeFixedDocument(ServiceContext* service,
+                        const BSONObj& doc,
+                        const InsertDocumentInfo& info,
+                        const OID& generatedId,
+                        char* out) {
+    char* const start = out;
+    out += sizeof(int32_t);
+
+    const auto appendElement = [&out](const BSONElement& e) {
+        memcpy(out, e.rawdata(), e.size());
+        out += e.size();
+    };
 
-    BSONObjBuilder b(doc.objsize() + 16);
-    if (firstElementIsId) {
-        b.append(doc.firstElement());
-        i.next();
+    BSONObjIterator i(doc);
+    if (info.firstElementIsId) {
+        appendElement(i.next());
+    } else if (info.hadId) {
+        appendElement(doc["_id"]);
     } else {
-        BSONElement e = doc["_id"];
-        if (e.type()) {
-            b.append(e);
-        } else {
-            b.appendOID("_id", NULL, true);
-        }
+        *out++ = static_cast<char>(jstOID);
+        memcpy(out, "_id", sizeof("_id"));
+        out += sizeof("_id");
+        memcpy(out, generatedId.view().view(), OID::kOIDSize);
+        out += OID::kOIDSize;
     }
 
     while (i.more()) {
         BSONElement e = i.next();
-        if (hadId && e.fieldNameStringData() == "_id") {
+        if (info.hadId && e.fieldNameStringData() == "_id") {
             // no-op
-        } else if (e.type() == bsonTimestamp && e.timestampValue() == 0) {
+            continue;
+        }
+        appendElement(e);
+        if (e.type() == bsonTimestamp && e.timestampValue() == 0) {
+            // The timestamp is the last thing in the element.
             auto nextTime = LogicalClock::get(service)->reserveTicks(1);
-            b.append(e.fieldName(), nextTime.asTimestamp());
-        } else {
-            b.append(e);
+            DataView(out - sizeof(unsigned long long))
+                .write<LittleEndian<unsigned long long>>(nextTime.asTimestamp().asULL());
+        }
+    }
+    *out++ = EOO;
+
+    invariant(out - start == info.fixedSize(doc));
+    DataView(start).write<LittleEndian<int32_t>>(out - start);
+}
+}  // namespace
+
+StatusWith<BSONObj> fixDocumentForInsert(ServiceContext* service, const BSONObj& doc) {
+    InsertDocumentInfo info;
+    Status status = validateForInsert(doc, &info);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    if (!info.needsRebuild())
+        return StatusWith<BSONObj>(BSONObj());
+
+    auto buffer = SharedBuffer::allocate(info.fixedSize(doc));
+    writeFixedDocument(service, doc, info, info.hadId ? OID() : OID::gen(), buffer.get());
+    return StatusWith<BSONObj>(BSONObj(std::move(buffer)));
+}
+
+std::vector<StatusWith<BSONObj>> fixDocumentsForInsert(ServiceContext* service,
+                                                       const std::vector<BSONObj>& docs) {
+    std::vector<InsertDocumentInfo> infos(docs.size());
+    std::vector<StatusWith<BSONObj>> results;
+    results.reserve(docs.size());
+
+    size_t bufferSize = 0;
+    size_t idsNeeded = 0;
+    for (size_t i = 0; i < docs.size(); ++i) {
+        Status status = validateForInsert(docs[i], &infos[i]);
+        if (!status.isOK()) {
+            results.emplace_back(std::move(status));
+            continue;
+        }
+        results.emplace_back(BSONObj());
+        if (infos[i].needsRebuild()) {
+            bufferSize += infos[i].fixedSize(docs[i]);
+            idsNeeded += infos[i].hadId ? 0 : 1;
+        }
+    }
+
+    if (bufferSize == 0) {
+        return results;
+    }
+
+    std::vector<OID> ids(idsNeeded);
+    OID::gen(ids.data(), ids.size());
+    auto nextId = ids.begin();
+
+    // Every rebuilt document is a view into this one buffer, which they all share ownership of.
+    ConstSharedBuffer buffer = SharedBuffer::allocate(bufferSize);
+    char* out = const_cast<char*>(buffer.get());
+    for (size_t i = 0; i < docs.size(); ++i) {
+        if (!results[i].isOK() || !infos[i].needsRebuild()) {
+            continue;
         }
+        writeFixedDocument(service, docs[i], infos[i], infos[i].hadId ? OID() : *nextId++, out);
+        BSONObj fixed(out);
+        fixed.shareOwnershipWith(buffer);
+        results[i] = std::move(fixed);
+        out += infos[i].fixedSize(docs[i]);
     }
-    return StatusWith<BSONObj>(b.obj());
+    return results;
 }
 
 Status userAllowedWriteNS(StringData ns) {
@@ -28,6 +28,8 @@
  *    it in the license file.
  */
 
+#include <vector>
+
 #include "mongo/db/jsobj.h"
 #include "mongo/db/namespace_string.h"
 
@@ -45,6 +47,15 @@ class ServiceContext;
  */
 StatusWith<BSONObj> fixDocumentForInsert(ServiceContext* service, const BSONObj& doc);
 
+/**
+ * Same as fixDocumentForInsert() for each of 'docs', returning one result per document in the
+ * same order. Documents which have to be modified are all written into a single buffer that they
+ * share ownership of, and the _ids generated for them are reserved in one block, so fixing a batch
+ * costs one allocation rather than one per document.
+ */
+std::vector<StatusWith<BSONObj>> fixDocumentsForInsert(ServiceContext* service,
+                                                       const std::vector<BSONObj>& docs);
+
 
 /**
  * Returns Status::OK() if this namespace is valid for user write operations.  If not, returns
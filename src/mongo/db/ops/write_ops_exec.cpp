@@ -46,6 +46,7 @@
 #include "mongo/db/exec/update.h"
 #include "mongo/db/introspect.h"
 #include "mongo/db/lasterror.h"
+#include "mongo/db/operation_arena.h"
 #include "mongo/db/ops/delete_request.h"
 #include "mongo/db/ops/insert.h"
 #include "mongo/db/ops/parsed_delete.h"
@@ -112,6 +113,9 @@ void finishCurOp(OperationContext* opCtx, CurOp* curOp) {
         if (logAll || (shouldSample && logSlow)) {
             Locker::LockerInfo lockerInfo;
             opCtx->lockState()->getLockerInfo(&lockerInfo);
+            curOp->debug().ticketQueuedMicros = lockerInfo.ticketQueuedMicros;
+            curOp->debug().phases = OperationPhases::get(opCtx);
+            curOp->debug().arenaBytes = OperationArena::get(opCtx).bytesReserved();
             log() << curOp->debug().report(opCtx->getClient(), *curOp, lockerInfo.stats);
         }
 
@@ -436,9 +440,11 @@ WriteResult performInserts(OperationContext* opCtx, const InsertOp& wholeOp) {
     const size_t maxBatchSize = internalInsertMaxBatchSize.load();
     batch.reserve(std::min(wholeOp.documents.size(), maxBatchSize));
 
+    auto fixedDocs = fixDocumentsForInsert(opCtx->getServiceContext(), wholeOp.documents);
+    auto fixedDocIt = fixedDocs.begin();
     for (auto&& doc : wholeOp.documents) {
         const bool isLastDoc = (&doc == &wholeOp.documents.back());
-        auto fixedDoc = fixDocumentForInsert(opCtx->getServiceContext(), doc);
+        auto& fixedDoc = *fixedDocIt++;
         if (!fixedDoc.isOK()) {
             // Handled after we insert anything in the batch to be sure we report errors in the
             // correct order. In an ordered insert, if one of the docs ahead of us fails, we should
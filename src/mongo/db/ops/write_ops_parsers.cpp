@@ -73,13 +73,15 @@ void checkOpCountForCommand(size_t numOps) {
 /**
  * Parses the fields common to all write commands and sets uniqueField to the element named
  * uniqueFieldName. The uniqueField is the only top-level field that is unique to the specific type
- * of write command.
+ * of write command. If the operations were sent as an OP_MSG document sequence,
+ * uniqueFieldInSequence must be true and the body is not required to contain uniqueFieldName.
  */
 void parseWriteCommand(StringData dbName,
                        const BSONObj& cmd,
                        StringData uniqueFieldName,
                        BSONElement* uniqueField,
-                       ParsedWriteOp* op) {
+                       ParsedWriteOp* op,
+                       bool uniqueFieldInSequence = false) {
     // Command dispatch wouldn't get here with an empty object because the first field indicates
     // which command to run.
     invariant(!cmd.isEmpty());
@@ -119,10 +121,99 @@ void parseWriteCommand(StringData dbName,
             str::stream() << "The " << uniqueFieldName << " option is required to the "
                           << cmd.firstElementFieldName()
                           << " command.",
-            haveUniqueField);
+            haveUniqueField || uniqueFieldInSequence);
 }
+
+void checkInsertBatch(const InsertOp& op) {
+    checkOpCountForCommand(op.documents.size());
+
+    if (op.ns.isSystemDotIndexes()) {
+        // This is only for consistency with sharding.
+        uassert(ErrorCodes::InvalidLength,
+                "Insert commands to system.indexes are limited to a single insert",
+                op.documents.size() == 1);
+    }
 }
 
+UpdateOp::SingleUpdate parseSingleUpdate(const BSONObj& doc) {
+    UpdateOp::SingleUpdate update;
+    bool haveQ = false;
+    bool haveU = false;
+    for (auto field : doc) {
+        const StringData fieldName = field.fieldNameStringData();
+        if (fieldName == "q") {
+            haveQ = true;
+            checkBSONType(Object, field);
+            update.query = field.Obj();
+        } else if (fieldName == "u") {
+            haveU = true;
+            checkBSONType(Object, field);
+            update.update = field.Obj();
+        } else if (fieldName == "collation") {
+            checkBSONType(Object, field);
+            update.collation = field.Obj();
+        } else if (fieldName == "arrayFilters") {
+            checkBSONType(Array, field);
+            for (auto arrayFilter : field.Obj()) {
+                checkBSONType(Object, arrayFilter);
+                update.arrayFilters.push_back(arrayFilter.Obj());
+            }
+        } else if (fieldName == "multi") {
+            checkBSONType(Bool, field);
+            update.multi = field.Bool();
+        } else if (fieldName == "upsert") {
+            checkBSONType(Bool, field);
+            update.upsert = field.Bool();
+        } else {
+            uasserted(ErrorCodes::FailedToParse,
+                      str::stream() << "Unrecognized field in update operation: " << fieldName);
+        }
+    }
+
+    uassert(ErrorCodes::FailedToParse, "The 'q' field is required for all updates", haveQ);
+    uassert(ErrorCodes::FailedToParse, "The 'u' field is required for all updates", haveU);
+    return update;
+}
+
+DeleteOp::SingleDelete parseSingleDelete(const BSONObj& doc) {
+    DeleteOp::SingleDelete del;  // delete is a reserved word.
+    bool haveQ = false;
+    bool haveLimit = false;
+    for (auto field : doc) {
+        const StringData fieldName = field.fieldNameStringData();
+        if (fieldName == "q") {
+            haveQ = true;
+            checkBSONType(Object, field);
+            del.query = field.Obj();
+        } else if (fieldName == "collation") {
+            checkBSONType(Object, field);
+            del.collation = field.Obj();
+        } else if (fieldName == "limit") {
+            haveLimit = true;
+            uassert(ErrorCodes::TypeMismatch,
+                    str::stream() << "The limit field in delete objects must be a number. Got a "
+                                  << typeName(field.type()),
+                    field.isNumber());
+
+            // Using a double to avoid throwing away illegal fractional portion. Don't want to
+            // accept 0.5 here.
+            const double limit = field.numberDouble();
+            uassert(ErrorCodes::FailedToParse,
+                    str::stream() << "The limit field in delete objects must be 0 or 1. Got "
+                                  << limit,
+                    limit == 0 || limit == 1);
+            del.multi = (limit == 0);
+        } else {
+            uasserted(ErrorCodes::FailedToParse,
+                      str::stream() << "Unrecognized field in delete operation: " << fieldName);
+        }
+    }
+    uassert(ErrorCodes::FailedToParse, "The 'q' field is required for all deletes", haveQ);
+    uassert(ErrorCodes::FailedToParse, "The 'limit' field is required for all deletes", haveLimit);
+    return del;
+}
+}  // namespace
+
 InsertOp parseInsertCommand(StringData dbName, const BSONObj& cmd) {
     BSONElement documents;
     InsertOp op;
@@ -132,15 +223,22 @@ InsertOp parseInsertCommand(StringData dbName, const BSONObj& cmd) {
         checkTypeInArray(Object, doc, documents);
         op.documents.push_back(doc.Obj());
     }
-    checkOpCountForCommand(op.documents.size());
+    checkInsertBatch(op);
+    return op;
+}
 
-    if (op.ns.isSystemDotIndexes()) {
-        // This is only for consistency with sharding.
-        uassert(ErrorCodes::InvalidLength,
-                "Insert commands to system.indexes are limited to a single insert",
-                op.documents.size() == 1);
-    }
+InsertOp parseInsertCommand(const OpMsgRequest& request) {
+    const auto sequence = request.getSequence("documents");
+    if (!sequence)
+        return parseInsertCommand(request.getDatabase(), request.body);
 
+    BSONElement unused;
+    InsertOp op;
+    parseWriteCommand(request.getDatabase(), request.body, "documents", &unused, &op, true);
+    // The sequence holds validated documents pointing into the request message, so this only
+    // copies the BSONObj handles.
+    op.documents = sequence->objs;
+    checkInsertBatch(op);
     return op;
 }
 
@@ -151,43 +249,23 @@ UpdateOp parseUpdateCommand(StringData dbName, const BSONObj& cmd) {
     checkBSONType(Array, updates);
     for (auto doc : updates.Obj()) {
         checkTypeInArray(Object, doc, updates);
-        op.updates.emplace_back();
-        auto& update = op.updates.back();
-        bool haveQ = false;
-        bool haveU = false;
-        for (auto field : doc.Obj()) {
-            const StringData fieldName = field.fieldNameStringData();
-            if (fieldName == "q") {
-                haveQ = true;
-                checkBSONType(Object, field);
-                update.query = field.Obj();
-            } else if (fieldName == "u") {
-                haveU = true;
-                checkBSONType(Object, field);
-                update.update = field.Obj();
-            } else if (fieldName == "collation") {
-                checkBSONType(Object, field);
-                update.collation = field.Obj();
-            } else if (fieldName == "arrayFilters") {
-                checkBSONType(Array, field);
-                for (auto arrayFilter : field.Obj()) {
-                    checkBSONType(Object, arrayFilter);
-                    update.arrayFilters.push_back(arrayFilter.Obj());
-                }
-            } else if (fieldName == "multi") {
-                checkBSONType(Bool, field);
-                update.multi = field.Bool();
-            } else if (fieldName == "upsert") {
-                checkBSONType(Bool, field);
-                update.upsert = field.Bool();
-            } else {
-                uasserted(ErrorCodes::FailedToParse,
-                          str::stream() << "Unrecognized field in update operation: " << fieldName);
-            }
-        }
+        op.updates.push_back(parseSingleUpdate(doc.Obj()));
+    }
+    checkOpCountForCommand(op.updates.size());
+    return op;
+}
 
-        uassert(ErrorCodes::FailedToParse, "The 'q' field is required for all updates", haveQ);
-        uassert(ErrorCodes::FailedToParse, "The 'u' field is required for all updates", haveU);
+UpdateOp parseUpdateCommand(const OpMsgRequest& request) {
+    const auto sequence = request.getSequence("updates");
+    if (!sequence)
+        return parseUpdateCommand(request.getDatabase(), request.body);
+
+    BSONElement unused;
+    UpdateOp op;
+    parseWriteCommand(request.getDatabase(), request.body, "updates", &unused, &op, true);
+    op.updates.reserve(sequence->objs.size());
+    for (auto&& doc : sequence->objs) {
+        op.updates.push_back(parseSingleUpdate(doc));
     }
     checkOpCountForCommand(op.updates.size());
     return op;
@@ -200,43 +278,23 @@ DeleteOp parseDeleteCommand(StringData dbName, const BSONObj& cmd) {
     checkBSONType(Array, deletes);
     for (auto doc : deletes.Obj()) {
         checkTypeInArray(Object, doc, deletes);
-        op.deletes.emplace_back();
-        auto& del = op.deletes.back();  // delete is a reserved word.
-        bool haveQ = false;
-        bool haveLimit = false;
-        for (auto field : doc.Obj()) {
-            const StringData fieldName = field.fieldNameStringData();
-            if (fieldName == "q") {
-                haveQ = true;
-                checkBSONType(Object, field);
-                del.query = field.Obj();
-            } else if (fieldName == "collation") {
-                checkBSONType(Object, field);
-                del.collation = field.Obj();
-            } else if (fieldName == "limit") {
-                haveLimit = true;
-                uassert(ErrorCodes::TypeMismatch,
-                        str::stream()
-                            << "The limit field in delete objects must be a number. Got a "
-                            << typeName(field.type()),
-                        field.isNumber());
-
-                // Using a double to avoid throwing away illegal fractional portion. Don't want to
-                // accept 0.5 here.
-                const double limit = field.numberDouble();
-                uassert(ErrorCodes::FailedToParse,
-                        str::stream() << "The limit field in delete objects must be 0 or 1. Got "
-                                      << limit,
-                        limit == 0 || limit == 1);
-                del.multi = (limit == 0);
-            } else {
-                uasserted(ErrorCodes::FailedToParse,
-                          str::stream() << "Unrecognized field in delete operation: " << fieldName);
-            }
-        }
-        uassert(ErrorCodes::FailedToParse, "The 'q' field is required for all deletes", haveQ);
-        uassert(
-            ErrorCodes::FailedToParse, "The 'limit' field is required for all deletes", haveLimit);
+        op.deletes.push_back(parseSingleDelete(doc.Obj()));
+    }
+    checkOpCountForCommand(op.deletes.size());
+    return op;
+}
+
+DeleteOp parseDeleteCommand(const OpMsgRequest& request) {
+    const auto sequence = request.getSequence("deletes");
+    if (!sequence)
+        return parseDeleteCommand(request.getDatabase(), request.body);
+
+    BSONElement unused;
+    DeleteOp op;
+    parseWriteCommand(request.getDatabase(), request.body, "deletes", &unused, &op, true);
+    op.deletes.reserve(sequence->objs.size());
+    for (auto&& doc : sequence->objs) {
+        op.deletes.push_back(parseSingleDelete(doc));
     }
     checkOpCountForCommand(op.deletes.size());
     return op;
@@ -31,6 +31,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/ops/write_ops.h"
 #include "mongo/util/net/message.h"
+#include "mongo/util/net/op_msg.h"
 
 namespace mongo {
 
@@ -47,6 +48,16 @@ InsertOp parseInsertCommand(StringData dbName, const BSONObj& cmd);
 UpdateOp parseUpdateCommand(StringData dbName, const BSONObj& cmd);
 DeleteOp parseDeleteCommand(StringData dbName, const BSONObj& cmd);
 
+/**
+ * Variants of the above that also accept the operations as an OP_MSG document sequence named
+ * "documents", "updates" or "deletes" rather than as an array in the command body. Operations from
+ * a sequence are parsed directly out of the request message, so the returned op must not outlive
+ * the request unless the request owns its BSON.
+ */
+InsertOp parseInsertCommand(const OpMsgRequest& request);
+UpdateOp parseUpdateCommand(const OpMsgRequest& request);
+DeleteOp parseDeleteCommand(const OpMsgRequest& request);
+
 InsertOp parseLegacyInsert(const Message& msg);
 UpdateOp parseLegacyUpdate(const Message& msg);
 DeleteOp parseLegacyDelete(const Message& msg);
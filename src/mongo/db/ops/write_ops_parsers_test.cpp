@@ -233,6 +233,82 @@ TEST(CommandWriteOpsParsers, RemoveErrorsWithBadLimit) {
     }
 }
 
+TEST(CommandWriteOpsParsers, InsertFromDocumentSequence) {
+    const auto ns = NamespaceString("test", "foo");
+    const BSONObj obj0 = BSON("x" << 0);
+    const BSONObj obj1 = BSON("x" << 1);
+    OpMsgRequest request;
+    request.body = BSON("insert" << ns.coll() << "ordered" << false << "$db" << ns.db());
+    request.sequences.push_back({"documents", {obj0, obj1}});
+    const auto op = parseInsertCommand(request);
+    ASSERT_EQ(op.ns.ns(), ns.ns());
+    ASSERT(op.continueOnError);
+    ASSERT_EQ(op.documents.size(), 2u);
+
+    // The documents are not copied out of the sequence.
+    ASSERT_EQ(op.documents[0].objdata(), obj0.objdata());
+    ASSERT_EQ(op.documents[1].objdata(), obj1.objdata());
+}
+
+TEST(CommandWriteOpsParsers, UpdateFromDocumentSequence) {
+    const auto ns = NamespaceString("test", "foo");
+    const BSONObj rawUpdate = BSON("q" << BSON("x" << 1) << "u" << BSON("$inc" << BSON("x" << 1))
+                                       << "multi"
+                                       << false
+                                       << "upsert"
+                                       << true);
+    OpMsgRequest request;
+    request.body = BSON("update" << ns.coll() << "$db" << ns.db());
+    request.sequences.push_back({"updates", {rawUpdate, rawUpdate}});
+    const auto op = parseUpdateCommand(request);
+    ASSERT_EQ(op.ns.ns(), ns.ns());
+    ASSERT_EQ(op.updates.size(), 2u);
+    ASSERT_BSONOBJ_EQ(op.updates[0].toBSON(), rawUpdate);
+    ASSERT_BSONOBJ_EQ(op.updates[1].toBSON(), rawUpdate);
+}
+
+TEST(CommandWriteOpsParsers, RemoveFromDocumentSequence) {
+    const auto ns = NamespaceString("test", "foo");
+    const BSONObj rawDelete = BSON("q" << BSON("x" << 1) << "limit" << 0);
+    OpMsgRequest request;
+    request.body = BSON("delete" << ns.coll() << "$db" << ns.db());
+    request.sequences.push_back({"deletes", {rawDelete}});
+    const auto op = parseDeleteCommand(request);
+    ASSERT_EQ(op.ns.ns(), ns.ns());
+    ASSERT_EQ(op.deletes.size(), 1u);
+    ASSERT_BSONOBJ_EQ(op.deletes[0].toBSON(), rawDelete);
+}
+
+TEST(CommandWriteOpsParsers, GarbageFieldsInDocumentSequence) {
+    OpMsgRequest request;
+    request.body = BSON("update"
+                        << "bar"
+                        << "$db"
+                        << "foo");
+    request.sequences.push_back(
+        {"updates", {BSON("q" << BSONObj() << "u" << BSONObj() << "x" << 1)}});
+    ASSERT_THROWS_CODE(parseUpdateCommand(request), UserException, ErrorCodes::FailedToParse);
+}
+
+TEST(CommandWriteOpsParsers, EmptyDocumentSequenceFails) {
+    OpMsgRequest request;
+    request.body = BSON("insert"
+                        << "bar"
+                        << "$db"
+                        << "foo");
+    request.sequences.push_back({"documents", {}});
+    ASSERT_THROWS_CODE(parseInsertCommand(request), UserException, ErrorCodes::InvalidLength);
+}
+
+TEST(CommandWriteOpsParsers, MissingOperationsWithoutDocumentSequenceFails) {
+    OpMsgRequest request;
+    request.body = BSON("delete"
+                        << "bar"
+                        << "$db"
+                        << "foo");
+    ASSERT_THROWS_CODE(parseDeleteCommand(request), UserException, ErrorCodes::FailedToParse);
+}
+
 namespace {
 /**
  * A mock DBClient that just captures the Message that is sent for legacy writes.
@@ -184,7 +184,7 @@ public:
 private:
     BSONType totalType = NumberInt;
     DoubleDoubleSummation nonDecimalTotal;
-    Decimal128 decimalTotal;
+    DecimalSummation decimalTotal;
 };
 
 
@@ -270,7 +270,7 @@ private:
 
     bool _isDecimal;
     DoubleDoubleSummation _nonDecimalTotal;
-    Decimal128 _decimalTotal;
+    DecimalSummation _decimalTotal;
     long long _count;
 };
 
@@ -74,7 +74,7 @@ void AccumulatorAvg::processInternal(const Value& input, bool merging) {
 
     switch (input.getType()) {
         case NumberDecimal:
-            _decimalTotal = _decimalTotal.add(input.getDecimal());
+            _decimalTotal.add(input.getDecimal());
             _isDecimal = true;
             break;
         case NumberLong:
@@ -98,7 +98,7 @@ intrusive_ptr<Accumulator> AccumulatorAvg::create(
 }
 
 Decimal128 AccumulatorAvg::_getDecimalTotal() const {
-    return _decimalTotal.add(_nonDecimalTotal.getDecimal());
+    return _decimalTotal.getDecimal().add(_nonDecimalTotal.getDecimal());
 }
 
 Value AccumulatorAvg::getValue(bool toBeMerged) {
@@ -77,7 +77,7 @@ void AccumulatorSum::processInternal(const Value& input, bool merging) {
             nonDecimalTotal.addDouble(input.getDouble());
             break;
         case NumberDecimal:
-            decimalTotal = decimalTotal.add(input.coerceToDecimal());
+            decimalTotal.add(input.coerceToDecimal());
             break;
         default:
             MONGO_UNREACHABLE;
@@ -126,7 +126,7 @@ Value AccumulatorSum::getValue(bool toBeMerged) {
                 total = total.add(Decimal128(sum, Decimal128::kRoundTo34Digits));
                 total = total.add(Decimal128(error, Decimal128::kRoundTo34Digits));
             }
-            total = total.add(decimalTotal);
+            total = total.add(decimalTotal.getDecimal());
             return Value(total);
         }
         default:
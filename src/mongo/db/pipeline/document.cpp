@@ -62,18 +62,42 @@ Position DocumentStorage::findField(StringData requested) const {
             pos = elem.nextCollision;
         }
     } else {  // linear scan
-        for (DocumentStorageIterator it = iteratorAll(); !it.atEnd(); it.advance()) {
+        for (DocumentStorageIterator it = loadedFieldsIteratorAll(); !it.atEnd(); it.advance()) {
             if (it->nameLen == reqSize && memcmp(requested.rawData(), it->_name, reqSize) == 0) {
                 return it.position();
             }
         }
     }
 
+    // The field may be among those not yet read from the source BSON.
+    if (_bsonIt) {
+        return const_cast<DocumentStorage*>(this)->loadBsonFieldsUntil(&requested);
+    }
+
     // if we got here, there's no such field
     return Position();
 }
 
-Value& DocumentStorage::appendField(StringData name) {
+Position DocumentStorage::loadBsonFieldsUntil(const StringData* name) {
+    while (_bsonIt) {
+        BSONElement bsonElement(_bsonIt);
+        if (bsonElement.eoo()) {
+            _bsonIt = nullptr;
+            break;
+        }
+        _bsonIt += bsonElement.size();
+
+        const StringData fieldName = bsonElement.fieldNameStringData();
+        const Position pos = getNextPosition();
+        appendFieldToBuffer(fieldName) = Value(bsonElement);
+        if (name && fieldName == *name) {
+            return pos;
+        }
+    }
+    return Position();
+}
+
+Value& DocumentStorage::appendFieldToBuffer(StringData name) {
     Position pos = getNextPosition();
     const int nameSize = name.size();
 
@@ -182,6 +206,25 @@ void DocumentStorage::reserveFields(size_t expectedFields) {
     _bufferEnd = _buffer + newSize;
 }
 
+void DocumentStorage::initFromBson(BSONObj bson, size_t nFields, size_t bytesNeeded) {
+    invariant(!_buffer);
+    invariant(bson.isOwned());
+
+    // Enough buckets that adding all nFields never triggers a rehash.
+    unsigned buckets = HASH_TAB_INIT_SIZE;
+    while (buckets < nFields * 2)
+        buckets *= 2;
+    _hashTabMask = buckets - 1;
+
+    uassert(40632, "Tried to make oversized document", bytesNeeded <= size_t(BufferMaxSize));
+
+    _buffer = new char[bytesNeeded + hashTabBytes()];
+    _bufferEnd = _buffer + bytesNeeded;
+
+    _bson = std::move(bson);
+    _bsonIt = _bson.objdata() + sizeof(int);
+}
+
 intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
     intrusive_ptr<DocumentStorage> out(new DocumentStorage());
 
@@ -202,8 +245,13 @@ intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
     out->_textScore = _textScore;
     out->_randVal = _randVal;
 
+    // The clone shares the source BSON, so points into it at the same place.
+    out->_bson = _bson;
+    out->_bsonIt = _bsonIt;
+    out->_modified = _modified;
+
     // Tell values that they have been memcpyed (updates ref counts)
-    for (DocumentStorageIterator it = out->iteratorAll(); !it.atEnd(); it.advance()) {
+    for (DocumentStorageIterator it = out->loadedFieldsIteratorAll(); !it.atEnd(); it.advance()) {
         it->val.memcpyed();
     }
 
@@ -213,7 +261,7 @@ intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
 DocumentStorage::~DocumentStorage() {
     std::unique_ptr<char[]> deleteBufferAtScopeEnd(_buffer);
 
-    for (DocumentStorageIterator it = iteratorAll(); !it.atEnd(); it.advance()) {
+    for (DocumentStorageIterator it = loadedFieldsIteratorAll(); !it.atEnd(); it.advance()) {
         it->val.~Value();  // explicit destructor call
     }
 }
@@ -254,12 +302,26 @@ void Document::toBson(BSONObjBuilder* builder, size_t recursionLevel) const {
                           << " levels of nesting",
             recursionLevel <= BSONDepth::getMaxAllowableDepth());
 
+    // Unchanged top-level documents read from BSON can be copied out as they are.
+    if (recursionLevel == 1) {
+        BSONObj bson = storage().unmodifiedBson();
+        if (!bson.isEmpty()) {
+            builder->appendElements(bson);
+            return;
+        }
+    }
+
     for (DocumentStorageIterator it = storage().iterator(); !it.atEnd(); it.advance()) {
         it->val.addToBsonObj(builder, it->nameSD(), recursionLevel);
     }
 }
 
 BSONObj Document::toBson() const {
+    BSONObj bson = storage().unmodifiedBson();
+    if (!bson.isEmpty()) {
+        return bson;
+    }
+
     BSONObjBuilder bb;
     toBson(&bb);
     return bb.obj();
@@ -302,6 +364,36 @@ Document Document::fromBsonWithMetaData(const BSONObj& bson) {
     return md.freeze();
 }
 
+Document Document::fromBsonWithMetaDataLazily(BSONObj bson) {
+    size_t nFields = 0;
+    size_t bytesNeeded = 0;
+
+    BSONObjIterator it(bson);
+    while (it.more()) {
+        auto fieldName = it.next().fieldNameStringData();
+        if (fieldName[0] == '$' &&
+            (fieldName == metaFieldTextScore || fieldName == metaFieldRandVal)) {
+            // Metadata has to be known up front, so parse these eagerly.
+            return fromBsonWithMetaData(bson);
+        }
+
+        ++nFields;
+        bytesNeeded += ValueElement::align(sizeof(ValueElement) + fieldName.size());
+    }
+
+    if (nFields == 0) {
+        return Document();
+    }
+
+    intrusive_ptr<DocumentStorage> storage(new DocumentStorage());
+    storage->initFromBson(bson.getOwned(), nFields, bytesNeeded);
+    return Document(storage.get());
+}
+
+void Document::loadAllFields() const {
+    storage().loadAllBsonFields();
+}
+
 MutableDocument::MutableDocument(size_t expectedFields)
     : _storageHolder(NULL), _storage(_storageHolder) {
     if (expectedFields) {
@@ -372,8 +464,11 @@ size_t Document::getApproximateSize() const {
 
     size_t size = sizeof(DocumentStorage);
     size += storage().allocatedBytes();
+    size += storage().bsonBytes();
 
-    for (DocumentStorageIterator it = storage().iterator(); !it.atEnd(); it.advance()) {
+    // Fields still held only as BSON are accounted for by bsonBytes().
+    for (DocumentStorageIterator it = storage().loadedFieldsIterator(); !it.atEnd();
+         it.advance()) {
         size += it->val.getApproximateSize();
         size -= sizeof(Value);  // already accounted for above
     }
@@ -64,6 +64,10 @@ class Position;
  *  pass and return by Value. Note that the data in a Document is
  *  immutable, but you can replace a Document instance with assignment.
  *
+ *  A Document created by fromBsonWithMetaDataLazily() converts each field from BSON the
+ *  first time it is read, so it must not be read from several threads at once until after
+ *  loadAllFields() has been called.
+ *
  *  See Also: Value class in Value.h
  */
 class Document {
@@ -210,6 +214,16 @@ public:
      */
     static Document fromBsonWithMetaData(const BSONObj& bson);
 
+    /**
+     * Like fromBsonWithMetaData, but keeps a reference to 'bson', which is made owned if it isn't
+     * already, and only converts a top-level field into a Value the first time it is read. While
+     * none of its fields have been changed, toBson() returns 'bson' itself.
+     */
+    static Document fromBsonWithMetaDataLazily(BSONObj bson);
+
+    /// Converts any fields a lazily created Document hasn't read from its BSON yet.
+    void loadAllFields() const;
+
     // Support BSONObjBuilder and BSONArrayBuilder "stream" API
     friend BSONObjBuilder& operator<<(BSONObjBuilderValueStream& builder, const Document& d);
 
@@ -546,7 +560,9 @@ private:
             return clonedStorage();
 
         // This function exists to ensure this is safe
-        return const_cast<DocumentStorage&>(*storagePtr());
+        auto& storage = const_cast<DocumentStorage&>(*storagePtr());
+        storage.markModified();
+        return storage;
     }
     DocumentStorage& newStorage() {
         reset(new DocumentStorage);
@@ -554,7 +570,9 @@ private:
     }
     DocumentStorage& clonedStorage() {
         reset(storagePtr()->clone());
-        return const_cast<DocumentStorage&>(*storagePtr());
+        auto& storage = const_cast<DocumentStorage&>(*storagePtr());
+        storage.markModified();
+        return storage;
     }
 
     // recursive helpers for same-named public methods
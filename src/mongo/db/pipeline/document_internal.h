@@ -34,6 +34,7 @@
 #include <boost/intrusive_ptr.hpp>
 
 #include "mongo/base/static_assert.h"
+#include "mongo/bson/bsonobj.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/util/intrusive_counter.h"
 
@@ -189,7 +190,9 @@ public:
           _hashTabMask(0),
           _metaFields(),
           _textScore(0),
-          _randVal(0) {}
+          _randVal(0),
+          _bsonIt(nullptr),
+          _modified(false) {}
 
     ~DocumentStorage();
 
@@ -206,6 +209,7 @@ public:
 
     size_t size() const {
         // can't use _numFields because it includes removed Fields
+        loadAllBsonFields();
         size_t count = 0;
         for (DocumentStorageIterator it = iterator(); !it.atEnd(); it.advance())
             count++;
@@ -245,23 +249,65 @@ public:
     }
 
     /// Adds a new field with missing Value at the end of the document
-    Value& appendField(StringData name);
+    Value& appendField(StringData name) {
+        loadAllBsonFields();
+        return appendFieldToBuffer(name);
+    }
 
     /** Preallocates space for fields. Use this to attempt to prevent buffer growth.
      *  This is only valid to call before anything is added to the document.
      */
     void reserveFields(size_t expectedFields);
 
+    /** Makes the owned 'bson' the source of this document's fields. Each one is only converted to
+     *  a Value and added to _buffer the first time it is looked up or iterated over.
+     *  'nFields' and 'bytesNeeded' must be the number of fields in 'bson' and the space they need
+     *  in _buffer, which is allocated here so that loading a field never moves the others.
+     *  This is only valid to call before anything is added to the document.
+     */
+    void initFromBson(BSONObj bson, size_t nFields, size_t bytesNeeded);
+
+    /// Converts every field not yet read from the source BSON, if there is one.
+    void loadAllBsonFields() const {
+        if (MONGO_unlikely(_bsonIt != nullptr)) {
+            const_cast<DocumentStorage*>(this)->loadBsonFieldsUntil(nullptr);
+        }
+    }
+
+    /** Returns the BSON this document was created from, or an empty BSONObj if it wasn't created
+     *  from BSON or has been modified since.
+     */
+    BSONObj unmodifiedBson() const {
+        return _modified ? BSONObj() : _bson;
+    }
+
+    /// Called by MutableDocument before it changes anything.
+    void markModified() {
+        _modified = true;
+    }
+
+    /// The size of the BSON this document was created from, which it holds on to.
+    size_t bsonBytes() const {
+        return _bson.isEmpty() ? 0 : _bson.objsize();
+    }
+
     /// This skips missing values
     DocumentStorageIterator iterator() const {
+        loadAllBsonFields();
         return DocumentStorageIterator(_firstElement, end(), false);
     }
 
     /// This includes missing values
     DocumentStorageIterator iteratorAll() const {
+        loadAllBsonFields();
         return DocumentStorageIterator(_firstElement, end(), true);
     }
 
+    /// Like iterator(), but skips fields that haven't been read from the source BSON yet.
+    DocumentStorageIterator loadedFieldsIterator() const {
+        return DocumentStorageIterator(_firstElement, end(), false);
+    }
+
     /// Shallow copy of this. Caller owns memory.
     boost::intrusive_ptr<DocumentStorage> clone() const;
 
@@ -310,6 +356,19 @@ private:
         return _firstElement ? _firstElement->plusBytes(_usedBytes) : nullptr;
     }
 
+    /// Includes missing values, and doesn't read any more fields from the source BSON.
+    DocumentStorageIterator loadedFieldsIteratorAll() const {
+        return DocumentStorageIterator(_firstElement, end(), true);
+    }
+
+    /// Adds a new field with missing Value at the end of _buffer.
+    Value& appendFieldToBuffer(StringData name);
+
+    /** Converts fields from the source BSON until one named '*name' has been added, returning its
+     *  position, or until there are none left if 'name' is null.
+     */
+    Position loadBsonFieldsUntil(const StringData* name);
+
     /// Allocates space in _buffer. Copies existing data if there is any.
     void alloc(unsigned newSize);
 
@@ -348,7 +407,7 @@ private:
     /// Adds all fields to the hash table
     void rehash() {
         hashTabInit();
-        for (DocumentStorageIterator it = iteratorAll(); !it.atEnd(); it.advance())
+        for (DocumentStorageIterator it = loadedFieldsIteratorAll(); !it.atEnd(); it.advance())
             addFieldToHashTable(it.position());
     }
 
@@ -385,6 +444,12 @@ private:
     std::bitset<MetaType::NUM_FIELDS> _metaFields;
     double _textScore;
     double _randVal;
+
+    // The BSON this document was created from, if any. _bsonIt points at the first of its
+    // elements that hasn't been added to _buffer yet, or is null once they all have been.
+    BSONObj _bson;
+    const char* _bsonIt;
+    bool _modified;  // true once a MutableDocument may have changed a field or metadata
     // When adding a field, make sure to update clone() method
 
     // Defined in document.cpp
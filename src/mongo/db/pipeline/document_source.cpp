@@ -31,7 +31,9 @@
 #include "mongo/db/pipeline/document_source.h"
 
 #include "mongo/db/matcher/expression_algo.h"
+#include "mongo/db/pipeline/document_source_limit.h"
 #include "mongo/db/pipeline/document_source_match.h"
+#include "mongo/db/pipeline/document_source_skip.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/field_path.h"
 #include "mongo/db/pipeline/value.h"
@@ -189,6 +191,16 @@ Pipeline::SourceContainer::iterator DocumentSource::optimizeAt(
                                                         : std::prev(std::prev(itr));
         }
     }
+
+    auto nextSkip = dynamic_cast<DocumentSourceSkip*>((*std::next(itr)).get());
+    auto nextLimit = dynamic_cast<DocumentSourceLimit*>((*std::next(itr)).get());
+    if (canSwapWithSkipOrLimit() && (nextSkip || nextLimit)) {
+        // Since we neither add nor remove documents, skipping or limiting our input has the same
+        // effect as skipping or limiting our output. The stage before us may be able to absorb the
+        // moved stage, for example a $sort absorbing a $limit to perform a top-k sort.
+        std::swap(*itr, *std::next(itr));
+        return itr == container->begin() ? itr : std::prev(itr);
+    }
     return doOptimizeAt(itr, container);
 }
 
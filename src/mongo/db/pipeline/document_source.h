@@ -438,6 +438,18 @@ public:
         return false;
     }
 
+    /**
+     * Returns whether a subsequent $skip or $limit stage can be moved before this stage. This is
+     * true of stages which produce exactly one output document for each input document, without
+     * changing their order.
+     *
+     * Moving a $skip or $limit earlier lets it reach a $sort, which can then perform a top-k sort,
+     * and means this stage does no work for documents which would be discarded anyway.
+     */
+    virtual bool canSwapWithSkipOrLimit() const {
+        return false;
+    }
+
     enum GetDepsReturn {
         // The full object and all metadata may be required.
         NOT_SUPPORTED = 0x0,
@@ -556,6 +568,35 @@ public:
         enum class CurrentOpConnectionsMode { kIncludeIdle, kExcludeIdle };
         enum class CurrentOpUserMode { kIncludeAll, kExcludeOthers };
 
+        /**
+         * What a stage needs to know about a collection to estimate the cost of reading all of it
+         * against the cost of querying it repeatedly.
+         */
+        struct CollectionSummary {
+            long long numRecords = 0;
+            long long dataSizeBytes = 0;
+
+            // The key pattern of each index on the collection.
+            std::vector<BSONObj> indexKeyPatterns;
+        };
+
+        /**
+         * A query for the documents of a collection holding any of a set of values at a field,
+         * prepared once to be run for many different sets of values.
+         */
+        class PreparedEqualityQuery {
+        public:
+            virtual ~PreparedEqualityQuery() = default;
+
+            /**
+             * Calls 'onMatch' with each document holding any of 'values', which must not be
+             * empty, and returns true. Returns false without calling 'onMatch' if the query can't
+             * be run for these values, or at all any more, and the caller must query another way.
+             */
+            virtual bool execute(const std::vector<Value>& values,
+                                 const stdx::function<void(Document)>& onMatch) = 0;
+        };
+
         virtual ~MongodInterface(){};
 
         /**
@@ -581,9 +622,25 @@ public:
          */
         virtual BSONObj insert(const NamespaceString& ns, const std::vector<BSONObj>& objs) = 0;
 
+        /**
+         * Applies to 'ns', in order, the update of each document matching 'queries[i]' with
+         * 'updates[i]'. Returns the first error encountered, after which no more updates are
+         * applied.
+         */
+        virtual Status update(const NamespaceString& ns,
+                              const std::vector<BSONObj>& queries,
+                              const std::vector<BSONObj>& updates,
+                              bool upsert,
+                              bool multi) = 0;
+
         virtual CollectionIndexUsageMap getIndexStats(OperationContext* opCtx,
                                                       const NamespaceString& ns) = 0;
 
+        /**
+         * Returns the execution statistics of each query shape of collection 'ns'.
+         */
+        virtual std::vector<BSONObj> getQueryStats(const NamespaceString& ns) const = 0;
+
         /**
          * Appends operation latency statistics for collection "nss" to "builder"
          */
@@ -598,6 +655,31 @@ public:
                                           const BSONObj& param,
                                           BSONObjBuilder* builder) const = 0;
 
+        /**
+         * Appends the storage engine cache statistics for collection "nss" and its indexes to
+         * "builder".
+         */
+        virtual Status appendCacheStats(const NamespaceString& nss,
+                                        BSONObjBuilder* builder) const = 0;
+
+        /**
+         * Returns a summary of the collection 'nss', or boost::none if it does not exist or is a
+         * view.
+         */
+        virtual boost::optional<CollectionSummary> getCollectionSummary(
+            const NamespaceString& nss) = 0;
+
+        /**
+         * Prepares the query {$and: [{<fieldName>: {$in: [<values>]}}, <filter>]} against 'nss'
+         * for the ExpressionContext 'expCtx', which must outlive it. Returns nullptr if the query
+         * can't be prepared, such as when it has no single obvious plan.
+         */
+        virtual std::unique_ptr<PreparedEqualityQuery> prepareEqualityQuery(
+            const NamespaceString& nss,
+            const std::string& fieldName,
+            const BSONObj& filter,
+            const boost::intrusive_ptr<ExpressionContext>& expCtx) = 0;
+
         /**
          * Gets the collection options for the collection given by 'nss'.
          */
@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+
 #include "mongo/db/pipeline/accumulation_statement.h"
 #include "mongo/db/pipeline/accumulator.h"
 #include "mongo/db/pipeline/document_source.h"
@@ -116,9 +118,20 @@ private:
     Value extractKey(const Document& doc);
 
     /**
-     * Calculates the bucket boundaries for the input documents and places them into buckets.
+     * Finishes populating the sorter and prepares to read its output in sorted order, computing
+     * how many documents to place in each bucket.
      */
-    void populateBuckets();
+    void initializeBucketIteration();
+
+    /**
+     * Places the next documents of the sorted input into a new bucket and returns it, or returns
+     * boost::none if all documents have been placed into buckets. Since buckets are filled in
+     * order, only the bucket being filled and the one before it are held in memory at once.
+     *
+     * The returned bucket's maximum boundary is not final until the next bucket has been passed to
+     * adjustBoundaries(), or until this returns boost::none for the last bucket.
+     */
+    boost::optional<Bucket> populateNextBucket();
 
     /**
      * Adds the document in 'entry' to 'bucket' by updating the accumulators in 'bucket'.
@@ -126,9 +139,10 @@ private:
     void addDocumentToBucket(const std::pair<Value, Document>& entry, Bucket& bucket);
 
     /**
-     * Adds 'newBucket' to _buckets and updates any boundaries if necessary.
+     * Updates the boundaries of 'previous' and 'next', two consecutive buckets, so that they share
+     * a boundary.
      */
-    void addBucket(Bucket& newBucket);
+    void adjustBoundaries(Bucket& previous, Bucket& next);
 
     /**
      * Makes a document using the information from bucket. This is what is returned when getNext()
@@ -144,11 +158,17 @@ private:
     int _nBuckets;
     uint64_t _maxMemoryUsageBytes;
     bool _populated = false;
-    std::vector<Bucket> _buckets;
-    std::vector<Bucket>::iterator _bucketsIterator;
     boost::intrusive_ptr<Expression> _groupByExpression;
     boost::intrusive_ptr<GranularityRounder> _granularityRounder;
     long long _nDocuments = 0;
+
+    // The following members are used to produce buckets from '_sortedInput' one at a time.
+    long long _approxBucketSize = 0;
+    int _nBucketsPopulated = 0;
+    boost::optional<std::pair<Value, Document>> _firstEntryInNextBucket;
+
+    // The most recently populated bucket, which is returned once the bucket after it is known.
+    boost::optional<Bucket> _currentBucket;
 };
 
 }  // namespace mongo
@@ -37,6 +37,7 @@
 #include "mongo/bson/bsonobj.h"
 #include "mongo/bson/bsontypes.h"
 #include "mongo/bson/json.h"
+#include "mongo/db/pipeline/accumulation_statement.h"
 #include "mongo/db/pipeline/aggregation_context_fixture.h"
 #include "mongo/db/pipeline/dependencies.h"
 #include "mongo/db/pipeline/document.h"
@@ -425,6 +426,49 @@ TEST_F(BucketAutoTests, ShouldBeAbleToPauseLoadingWhileSpilled) {
     ASSERT_TRUE(bucketAutoStage->getNext().isEOF());
 }
 
+TEST_F(BucketAutoTests, ShouldProduceContiguousBucketsFromSpilledInput) {
+    auto expCtx = getExpCtx();
+    unittest::TempDir tempDir("DocumentSourceBucketAutoTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->extSortAllowed = true;
+    const size_t maxMemoryUsageBytes = 1000;
+
+    VariablesParseState vps = expCtx->variablesParseState;
+    AccumulationStatement pushStatement{"values",
+                                        ExpressionFieldPath::parse(expCtx, "$a", vps),
+                                        AccumulationStatement::getFactory("$push")};
+    auto groupByExpression = ExpressionFieldPath::parse(expCtx, "$a", vps);
+
+    const int numBuckets = 5;
+    auto bucketAutoStage = DocumentSourceBucketAuto::create(
+        expCtx, groupByExpression, numBuckets, {pushStatement}, nullptr, maxMemoryUsageBytes);
+
+    // Insert the values 0 through 19 out of order, each with a string large enough to force the
+    // sorter to spill.
+    string largeStr(maxMemoryUsageBytes / 2, 'x');
+    deque<DocumentSource::GetNextResult> inputs;
+    for (int i = 0; i < 20; ++i) {
+        inputs.emplace_back(Document{{"a", (i * 7) % 20}, {"largeStr", largeStr}});
+    }
+    auto mock = DocumentSourceMock::create(std::move(inputs));
+    bucketAutoStage->setSource(mock.get());
+
+    for (int i = 0; i < numBuckets; ++i) {
+        auto next = bucketAutoStage->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+        const int min = 4 * i;
+        const int max = i == numBuckets - 1 ? 19 : 4 * (i + 1);
+        ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                           (Document{{"_id", Document{{"min", min}, {"max", max}}},
+                                     {"values", vector<Value>{Value(min),
+                                                              Value(min + 1),
+                                                              Value(min + 2),
+                                                              Value(min + 3)}}}));
+    }
+
+    ASSERT_TRUE(bucketAutoStage->getNext().isEOF());
+}
+
 TEST_F(BucketAutoTests, SourceNameIsBucketAuto) {
     auto bucketAuto = createBucketAuto(fromjson("{$bucketAuto : {groupBy : '$x', buckets : 2}}"));
     ASSERT_EQUALS(string(bucketAuto->getSourceName()), "$bucketAuto");
@@ -77,6 +77,18 @@ intrusive_ptr<DocumentSource> DocumentSourceCollStats::createFromBson(
                                   << " of type "
                                   << typeName(elem.type()),
                     elem.type() == BSONType::Object);
+        } else if ("count" == fieldName) {
+            uassert(40666,
+                    str::stream() << "count argument must be an object, but got " << elem
+                                  << " of type "
+                                  << typeName(elem.type()),
+                    elem.type() == BSONType::Object);
+        } else if ("cacheStats" == fieldName) {
+            uassert(40664,
+                    str::stream() << "cacheStats argument must be an object, but got " << elem
+                                  << " of type "
+                                  << typeName(elem.type()),
+                    elem.type() == BSONType::Object);
         } else {
             uasserted(40168, str::stream() << "unrecognized option to $collStats: " << fieldName);
         }
@@ -119,6 +131,23 @@ DocumentSource::GetNextResult DocumentSourceCollStats::getNext() {
         }
     }
 
+    if (_collStatsSpec.hasField("count")) {
+        // A collection that does not exist on this node holds no documents.
+        auto summary = _mongod->getCollectionSummary(pExpCtx->ns);
+        builder.appendNumber("count", summary ? summary->numRecords : 0LL);
+    }
+
+    if (_collStatsSpec.hasField("cacheStats")) {
+        BSONObjBuilder cacheBuilder(builder.subobjStart("cacheStats"));
+        Status status = _mongod->appendCacheStats(pExpCtx->ns, &cacheBuilder);
+        cacheBuilder.doneFast();
+        if (!status.isOK()) {
+            uasserted(40665,
+                      str::stream() << "Unable to retrieve cacheStats in $collStats stage: "
+                                    << status.reason());
+        }
+    }
+
     return {Document(builder.obj())};
 }
 
@@ -87,7 +87,9 @@ void DocumentSourceCursor::loadBatch() {
                 } else if (_dependencies) {
                     _currentBatch.push_back(_dependencies->extractFields(resultObj));
                 } else {
-                    _currentBatch.push_back(Document::fromBsonWithMetaData(resultObj));
+                    // Nothing has told us which fields are needed, so only convert each one
+                    // when a later stage reads it.
+                    _currentBatch.push_back(Document::fromBsonWithMetaDataLazily(resultObj));
                 }
 
                 if (_limit) {
@@ -30,6 +30,7 @@
 
 #include "mongo/db/pipeline/document_source_facet.h"
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 
@@ -44,9 +45,14 @@
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/pipeline/tee_buffer.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -62,12 +68,43 @@ DocumentSourceFacet::DocumentSourceFacet(std::vector<FacetPipeline> facetPipelin
       _facets(std::move(facetPipelines)) {
     for (size_t facetId = 0; facetId < _facets.size(); ++facetId) {
         auto& facet = _facets[facetId];
-        facet.pipeline->addInitialSource(
-            DocumentSourceTeeConsumer::create(pExpCtx, facetId, _teeBuffer));
+        facet.pipeline->addInitialSource(DocumentSourceTeeConsumer::create(
+            facet.pipeline->getContext(), facetId, _teeBuffer));
     }
 }
 
 namespace {
+
+// The most threads any one $facet stage will run its sub-pipelines on, and the size of the pool
+// shared by all of them.
+const size_t kMaxFacetThreads = 16;
+
+ThreadPool* getFacetThreadPool() {
+    // Intentionally leaked so that no $facet can outlive the pool during shutdown.
+    static ThreadPool* pool = [] {
+        ThreadPool::Options options;
+        options.poolName = "FacetPipeline";
+        options.minThreads = 0;
+        options.maxThreads = kMaxFacetThreads;
+        auto newPool = new ThreadPool(options);
+        newPool->startup();
+        return newPool;
+    }();
+    return pool;
+}
+
+/**
+ * Appends to 'results' everything 'pipeline' returns until it pauses or reaches EOF. Returns true
+ * if it reached EOF.
+ */
+bool runUntilPaused(Pipeline* pipeline, vector<Value>* results) {
+    auto next = pipeline->getSources().back()->getNext();
+    for (; next.isAdvanced(); next = pipeline->getSources().back()->getNext()) {
+        results->emplace_back(next.releaseDocument());
+    }
+    return next.isEOF();
+}
+
 /**
  * Extracts the names of the facets and the vectors of raw BSONObjs representing the stages within
  * that facet's pipeline.
@@ -164,16 +201,23 @@ DocumentSource::GetNextResult DocumentSourceFacet::getNext() {
     }
 
     vector<vector<Value>> results(_facets.size());
-    bool allPipelinesEOF = false;
-    while (!allPipelinesEOF) {
-        allPipelinesEOF = true;  // Set this to false if any pipeline isn't EOF.
-        for (size_t facetId = 0; facetId < _facets.size(); ++facetId) {
-            const auto& pipeline = _facets[facetId].pipeline;
-            auto next = pipeline->getSources().back()->getNext();
-            for (; next.isAdvanced(); next = pipeline->getSources().back()->getNext()) {
-                results[facetId].emplace_back(next.releaseDocument());
+    const size_t maxParallelism = std::min(
+        static_cast<size_t>(std::max(1, internalQueryFacetMaxParallelism.load())),
+        kMaxFacetThreads);
+    if (maxParallelism > 1 &&
+        std::any_of(_facets.begin(), _facets.end(), [this](const FacetPipeline& facet) {
+            return canRunOnWorkerThread(facet);
+        })) {
+        runFacetsInParallel(maxParallelism, &results);
+    } else {
+        bool allPipelinesEOF = false;
+        while (!allPipelinesEOF) {
+            allPipelinesEOF = true;  // Set this to false if any pipeline isn't EOF.
+            for (size_t facetId = 0; facetId < _facets.size(); ++facetId) {
+                const auto& pipeline = _facets[facetId].pipeline;
+                const bool isEOF = runUntilPaused(pipeline.get(), &results[facetId]);
+                allPipelinesEOF = allPipelinesEOF && isEOF;
             }
-            allPipelinesEOF = allPipelinesEOF && next.isEOF();
         }
     }
 
@@ -186,6 +230,98 @@ DocumentSource::GetNextResult DocumentSourceFacet::getNext() {
     return resultDoc.freeze();
 }
 
+bool DocumentSourceFacet::canRunOnWorkerThread(const FacetPipeline& facet) const {
+    // Sub-pipelines sharing our ExpressionContext would share its variables and interrupt counter.
+    if (facet.pipeline->getContext() == pExpCtx) {
+        return false;
+    }
+
+    // Stages that talk to mongod use the operation's locks and storage, which belong to its thread.
+    for (auto&& stage : facet.pipeline->getSources()) {
+        if (dynamic_cast<DocumentSourceNeedsMongod*>(stage.get())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void DocumentSourceFacet::runFacetsInParallel(size_t maxParallelism,
+                                              vector<vector<Value>>* results) {
+    // Deal the sub-pipelines out to 'maxParallelism' slots. Slot 0 runs on this thread, and also
+    // takes every sub-pipeline that can't leave it.
+    vector<vector<size_t>> slots(maxParallelism);
+    size_t nextSlot = 0;
+    for (size_t facetId = 0; facetId < _facets.size(); ++facetId) {
+        if (canRunOnWorkerThread(_facets[facetId])) {
+            slots[nextSlot++ % maxParallelism].push_back(facetId);
+        } else {
+            slots[0].push_back(facetId);
+        }
+    }
+    slots.erase(std::remove_if(slots.begin() + 1,
+                               slots.end(),
+                               [](const vector<size_t>& slot) { return slot.empty(); }),
+                slots.end());
+
+    // Only this thread reads from the source. While the sub-pipelines run, the TeeBuffer hands
+    // each of them the current batch and pauses it at the end, rather than loading the next one.
+    _teeBuffer->setLoadsOnDemand(false);
+    ON_BLOCK_EXIT([this] { _teeBuffer->setLoadsOnDemand(true); });
+
+    // Not a vector<bool>, as each thread writes to the elements of its own sub-pipelines.
+    vector<char> pipelineEOF(_facets.size(), false);
+    bool allPipelinesEOF = false;
+    while (!allPipelinesEOF) {
+        pExpCtx->checkForInterrupt();
+        _teeBuffer->loadBatchForConsumers();
+
+        stdx::mutex mutex;
+        stdx::condition_variable slotsDone;
+        size_t slotsPending = slots.size();
+        Status runStatus = Status::OK();
+
+        auto runSlot = [&](size_t slot) {
+            Status status = Status::OK();
+            try {
+                for (size_t facetId : slots[slot]) {
+                    if (!pipelineEOF[facetId]) {
+                        pipelineEOF[facetId] =
+                            runUntilPaused(_facets[facetId].pipeline.get(), &(*results)[facetId]);
+                    }
+                }
+            } catch (const DBException& ex) {
+                status = ex.toStatus();
+            }
+
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            if (!status.isOK() && runStatus.isOK()) {
+                runStatus = status;
+            }
+            if (--slotsPending == 0) {
+                slotsDone.notify_one();
+            }
+        };
+
+        // This thread runs slot 0 itself, and any slot the pool won't take.
+        for (size_t slot = 1; slot < slots.size(); ++slot) {
+            auto task = [&runSlot, slot] { runSlot(slot); };
+            if (!getFacetThreadPool()->schedule(task).isOK()) {
+                runSlot(slot);
+            }
+        }
+        runSlot(0);
+
+        {
+            stdx::unique_lock<stdx::mutex> lk(mutex);
+            slotsDone.wait(lk, [&] { return slotsPending == 0; });
+        }
+        uassertStatusOK(runStatus);
+
+        allPipelinesEOF = std::all_of(
+            pipelineEOF.begin(), pipelineEOF.end(), [](char isEOF) { return isEOF; });
+    }
+}
+
 Value DocumentSourceFacet::serialize(boost::optional<ExplainOptions::Verbosity> explain) const {
     MutableDocument serialized;
     for (auto&& facet : _facets) {
@@ -270,7 +406,10 @@ intrusive_ptr<DocumentSource> DocumentSourceFacet::createFromBson(
     for (auto&& rawFacet : extractRawPipelines(elem)) {
         const auto facetName = rawFacet.first;
 
-        auto pipeline = uassertStatusOK(Pipeline::parse(rawFacet.second, expCtx));
+        // A sub-pipeline with an ExpressionContext of its own may run on another thread.
+        auto pipeline = uassertStatusOK(Pipeline::parse(
+            rawFacet.second,
+            internalQueryFacetMaxParallelism.load() > 1 ? expCtx->copyWith(expCtx->ns) : expCtx));
 
         uassert(40172,
                 str::stream() << "sub-pipeline in $facet stage cannot be empty: " << facetName,
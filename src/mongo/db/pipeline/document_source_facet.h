@@ -140,6 +140,19 @@ private:
 
     Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
 
+    /**
+     * Returns true if 'facet' may run on a thread other than the operation's own. That requires
+     * the sub-pipeline to have an ExpressionContext of its own, and no stage that talks to mongod.
+     */
+    bool canRunOnWorkerThread(const FacetPipeline& facet) const;
+
+    /**
+     * Feeds the input through all sub-pipelines, running those that can on up to 'maxParallelism'
+     * threads. The input is still read on the operation's own thread, one TeeBuffer batch at a
+     * time, and each batch is shared by all of the sub-pipelines.
+     */
+    void runFacetsInParallel(size_t maxParallelism, std::vector<std::vector<Value>>* results);
+
     boost::intrusive_ptr<TeeBuffer> _teeBuffer;
     std::vector<FacetPipeline> _facets;
 
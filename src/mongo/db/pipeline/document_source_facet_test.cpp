@@ -43,8 +43,10 @@
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/document_source_skip.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 using std::deque;
@@ -290,6 +292,103 @@ TEST_F(DocumentSourceFacetTest,
     ASSERT(facetStage->getNext().isEOF());
 }
 
+/**
+ * A DocumentSource which fails as soon as it is asked for a result.
+ */
+class DocumentSourceThrowing : public DocumentSourceMock {
+public:
+    DocumentSourceThrowing() : DocumentSourceMock({}) {}
+
+    InitialSourceType getInitialSourceType() const final {
+        return InitialSourceType::kNotInitialSource;
+    }
+
+    DocumentSource::GetNextResult getNext() final {
+        uasserted(ErrorCodes::InternalError, "DocumentSourceThrowing always fails");
+    }
+
+    static boost::intrusive_ptr<DocumentSourceThrowing> create() {
+        return new DocumentSourceThrowing();
+    }
+};
+
+TEST_F(DocumentSourceFacetTest, ShouldReturnTheSameResultsWhenRunningSubPipelinesInParallel) {
+    const auto oldParallelism = internalQueryFacetMaxParallelism.load();
+    const auto oldBufferSize = internalQueryFacetBufferSizeBytes.load();
+    ON_BLOCK_EXIT([&] {
+        internalQueryFacetMaxParallelism.store(oldParallelism);
+        internalQueryFacetBufferSizeBytes.store(oldBufferSize);
+    });
+    internalQueryFacetMaxParallelism.store(4);
+    // Each batch the sub-pipelines share holds a single document.
+    internalQueryFacetBufferSizeBytes.store(1);
+
+    auto ctx = getExpCtx();
+
+    deque<DocumentSource::GetNextResult> inputs;
+    vector<Value> expectedOutput;
+    for (int i = 0; i < 20; ++i) {
+        inputs.emplace_back(Document{{"_id", i}});
+        expectedOutput.emplace_back(Document{{"_id", i}});
+    }
+    auto mock = DocumentSourceMock::create(inputs);
+
+    // Sub-pipelines with their own ExpressionContext may run on another thread. The one sharing
+    // the $facet's context stays on this one.
+    std::vector<DocumentSourceFacet::FacetPipeline> facets;
+    for (auto&& name : {"first", "second", "third"}) {
+        auto subCtx = ctx->copyWith(ctx->ns);
+        facets.emplace_back(
+            name, uassertStatusOK(Pipeline::create({DocumentSourcePassthrough::create()}, subCtx)));
+    }
+    auto limitCtx = ctx->copyWith(ctx->ns);
+    facets.emplace_back(
+        "limited",
+        uassertStatusOK(Pipeline::create({DocumentSourceLimit::create(limitCtx, 3)}, limitCtx)));
+    facets.emplace_back(
+        "shared", uassertStatusOK(Pipeline::create({DocumentSourcePassthrough::create()}, ctx)));
+    auto facetStage = DocumentSourceFacet::create(std::move(facets), ctx);
+
+    facetStage->setSource(mock.get());
+
+    auto output = facetStage->getNext();
+    ASSERT(output.isAdvanced());
+    ASSERT_EQ(output.getDocument().size(), 5UL);
+    for (auto&& name : {"first", "second", "third", "shared"}) {
+        ASSERT_VALUE_EQ(output.getDocument()[name], Value(expectedOutput));
+    }
+    ASSERT_VALUE_EQ(output.getDocument()["limited"],
+                    Value(vector<Value>(expectedOutput.begin(), expectedOutput.begin() + 3)));
+
+    // Should be exhausted now.
+    ASSERT(facetStage->getNext().isEOF());
+    ASSERT(facetStage->getNext().isEOF());
+}
+
+TEST_F(DocumentSourceFacetTest, ShouldPropagateErrorsFromSubPipelinesRunningInParallel) {
+    const auto oldParallelism = internalQueryFacetMaxParallelism.load();
+    ON_BLOCK_EXIT([&] { internalQueryFacetMaxParallelism.store(oldParallelism); });
+    internalQueryFacetMaxParallelism.store(2);
+
+    auto ctx = getExpCtx();
+    auto mock = DocumentSourceMock::create({Document{{"_id", 0}}, Document{{"_id", 1}}});
+
+    auto passthroughCtx = ctx->copyWith(ctx->ns);
+    auto throwingCtx = ctx->copyWith(ctx->ns);
+    std::vector<DocumentSourceFacet::FacetPipeline> facets;
+    facets.emplace_back(
+        "passthrough",
+        uassertStatusOK(Pipeline::create({DocumentSourcePassthrough::create()}, passthroughCtx)));
+    facets.emplace_back(
+        "throwing",
+        uassertStatusOK(Pipeline::create({DocumentSourceThrowing::create()}, throwingCtx)));
+    auto facetStage = DocumentSourceFacet::create(std::move(facets), ctx);
+
+    facetStage->setSource(mock.get());
+
+    ASSERT_THROWS_CODE(facetStage->getNext(), UserException, ErrorCodes::InternalError);
+}
+
 TEST_F(DocumentSourceFacetTest, ShouldBeAbleToEvaluateMultipleStagesWithinOneSubPipeline) {
     auto ctx = getExpCtx();
 
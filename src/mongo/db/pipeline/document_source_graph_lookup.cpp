@@ -30,6 +30,9 @@
 
 #include "mongo/db/pipeline/document_source_graph_lookup.h"
 
+#include <algorithm>
+#include <cctype>
+
 #include "mongo/base/init.h"
 #include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/jsobj.h"
@@ -41,6 +44,7 @@
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/db/query/query_planner_common.h"
+#include "mongo/db/sorter/sorter.h"
 #include "mongo/stdx/memory.h"
 
 namespace mongo {
@@ -98,11 +102,9 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNext() {
     performSearch();
 
     std::vector<Value> results;
-    while (!_visited.empty()) {
+    while (hasVisited()) {
         // Remove elements one at a time to avoid consuming more memory.
-        auto it = _visited.begin();
-        results.push_back(Value(it->second));
-        _visited.erase(it);
+        results.push_back(Value(popVisited()));
     }
 
     MutableDocument output(*_input);
@@ -121,7 +123,7 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
     // If the unwind is not preserving empty arrays, we might have to process multiple inputs before
     // we get one that will produce an output.
     while (true) {
-        if (_visited.empty()) {
+        if (!hasVisited()) {
             // No results are left for the current input, so we should move on to the next one and
             // perform a new search.
 
@@ -137,7 +139,7 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
         }
         MutableDocument unwound(*_input);
 
-        if (_visited.empty()) {
+        if (!hasVisited()) {
             if ((*_unwind)->preserveNullAndEmptyArrays()) {
                 // Since "preserveNullAndEmptyArrays" was specified, output a document even though
                 // we had no result.
@@ -151,23 +153,40 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
                 continue;
             }
         } else {
-            auto it = _visited.begin();
-            unwound.setNestedField(_as, Value(it->second));
+            unwound.setNestedField(_as, Value(popVisited()));
             if (indexPath) {
                 unwound.setNestedField(*indexPath, Value(_outputIndex));
                 ++_outputIndex;
             }
-            _visited.erase(it);
         }
 
         return unwound.freeze();
     }
 }
 
+Document DocumentSourceGraphLookUp::popVisited() {
+    if (!_visited.empty()) {
+        auto it = _visited.begin();
+        Document result = std::move(it->second);
+        _visited.erase(it);
+        return result;
+    }
+
+    invariant(!_spilledFiles.empty());
+    Document result = _spilledFiles.front()->next().second;
+    while (!_spilledFiles.empty() && !_spilledFiles.front()->more()) {
+        _spilledFiles.pop_front();
+    }
+    return result;
+}
+
 void DocumentSourceGraphLookUp::doDispose() {
     _cache.clear();
     _frontier.clear();
     _visited.clear();
+    _spilledIds.clear();
+    _spilledFiles.clear();
+    _memoryReservation.resize(0);
 }
 
 void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
@@ -211,6 +230,15 @@ void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
                 shouldPerformAnotherQuery =
                     addToVisitedAndFrontier(*next, depth) || shouldPerformAnotherQuery;
                 addToCache(std::move(*next), queried);
+                checkMemoryUsage();
+            }
+
+            // Also cache the values that matched nothing, so that no later level or input queries
+            // for them again. This saves a query for every leaf of the graph.
+            for (auto&& value : queried) {
+                if (canCacheWithoutResults(value)) {
+                    _cache.insertKey(value);
+                }
             }
             checkMemoryUsage();
         }
@@ -221,12 +249,15 @@ void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
 
     _frontier.clear();
     _frontierUsageBytes = 0;
+
+    // The spilled documents are still to be returned, but no longer need de-duplicating.
+    _spilledIds.clear();
 }
 
 bool DocumentSourceGraphLookUp::addToVisitedAndFrontier(Document result, long long depth) {
     auto id = result.getField("_id");
 
-    if (_visited.find(id) != _visited.end()) {
+    if (_visited.find(id) != _visited.end() || _spilledIds.find(id) != _spilledIds.end()) {
         // We've already seen this object, don't repeat any work.
         return false;
     }
@@ -273,6 +304,24 @@ void DocumentSourceGraphLookUp::addToCache(const Document& result,
         });
 }
 
+bool DocumentSourceGraphLookUp::canCacheWithoutResults(const Value& queried) const {
+    // Arrays, nullish values and regular expressions can match documents in which they don't
+    // appear as a value of '_connectToField', so addToCache() may not have recorded those matches.
+    if (queried.isArray() || queried.nullish() || queried.getType() == BSONType::RegEx) {
+        return false;
+    }
+
+    // Neither can positional path components be followed by visitAllValuesAtPath().
+    for (size_t i = 0; i < _connectToField.getPathLength(); ++i) {
+        auto fieldName = _connectToField.getFieldName(i);
+        auto isDigit = [](char c) { return std::isdigit(static_cast<unsigned char>(c)); };
+        if (std::all_of(fieldName.begin(), fieldName.end(), isDigit)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 boost::optional<BSONObj> DocumentSourceGraphLookUp::makeMatchStageFromFrontier(
     DocumentUnorderedSet* cached) {
     // Add any cached values to 'cached' and remove them from '_frontier'.
@@ -381,13 +430,43 @@ BSONObjSet DocumentSourceGraphLookUp::getOutputSorts() {
 }
 
 void DocumentSourceGraphLookUp::checkMemoryUsage() {
-    // TODO SERVER-23980: Implement spilling to disk if allowDiskUse is specified.
+    if ((_visitedUsageBytes + _frontierUsageBytes) >= _maxMemoryUsageBytes && _extSortAllowed &&
+        !_visited.empty()) {
+        spill();
+    } else if (!_memoryReservation.tryResize(_visitedUsageBytes + _frontierUsageBytes) &&
+               _extSortAllowed && !_visited.empty()) {
+        // The process is short of query memory, so spill early.
+        QueryMemoryBudget::recordSpill();
+        spill();
+    }
+
     uassert(40099,
-            "$graphLookup reached maximum memory consumption",
+            _extSortAllowed ? "$graphLookup reached maximum memory consumption"
+                            : "$graphLookup reached maximum memory consumption. Pass "
+                              "allowDiskUse:true to opt in to spilling discovered documents to "
+                              "disk.",
             (_visitedUsageBytes + _frontierUsageBytes) < _maxMemoryUsageBytes);
+    // Unless spilling made room, wait for other operations to release the memory we need.
+    _memoryReservation.resizeOrWait(_visitedUsageBytes + _frontierUsageBytes, "$graphLookup");
     _cache.evictDownTo(_maxMemoryUsageBytes - _frontierUsageBytes - _visitedUsageBytes);
 }
 
+void DocumentSourceGraphLookUp::spill() {
+    // The documents are read back in the order they were written, so need not be sorted.
+    SortedFileWriter<Value, Document> writer(SortOptions().TempDir(pExpCtx->tempDir));
+    for (auto&& entry : _visited) {
+        const size_t docSize = entry.second.getApproximateSize();
+        invariant(docSize <= _visitedUsageBytes);
+        _visitedUsageBytes -= docSize;
+
+        writer.addAlreadySorted(entry.first, entry.second);
+        _spilledIds.insert(entry.first);
+    }
+    _visited.clear();
+
+    _spilledFiles.emplace_back(writer.done());
+}
+
 void DocumentSourceGraphLookUp::serializeToArray(
     std::vector<Value>& array, boost::optional<ExplainOptions::Verbosity> explain) const {
     // Serialize default options.
@@ -431,10 +510,12 @@ void DocumentSourceGraphLookUp::serializeToArray(
 
 void DocumentSourceGraphLookUp::doDetachFromOperationContext() {
     _fromExpCtx->opCtx = nullptr;
+    _memoryReservation.detachFromOperationContext();
 }
 
 void DocumentSourceGraphLookUp::doReattachToOperationContext(OperationContext* opCtx) {
     _fromExpCtx->opCtx = opCtx;
+    _memoryReservation.reattachToOperationContext(opCtx);
 }
 
 DocumentSourceGraphLookUp::DocumentSourceGraphLookUp(
@@ -447,7 +528,8 @@ DocumentSourceGraphLookUp::DocumentSourceGraphLookUp(
     boost::optional<BSONObj> additionalFilter,
     boost::optional<FieldPath> depthField,
     boost::optional<long long> maxDepth,
-    boost::optional<boost::intrusive_ptr<DocumentSourceUnwind>> unwindSrc)
+    boost::optional<boost::intrusive_ptr<DocumentSourceUnwind>> unwindSrc,
+    size_t maxMemoryUsageBytes)
     : DocumentSourceNeedsMongod(expCtx),
       _from(std::move(from)),
       _as(std::move(as)),
@@ -457,10 +539,14 @@ DocumentSourceGraphLookUp::DocumentSourceGraphLookUp(
       _additionalFilter(additionalFilter),
       _depthField(depthField),
       _maxDepth(maxDepth),
+      _maxMemoryUsageBytes(maxMemoryUsageBytes),
+      _extSortAllowed(pExpCtx->extSortAllowed && !pExpCtx->inRouter),
       _frontier(pExpCtx->getValueComparator().makeUnorderedValueSet()),
       _visited(ValueComparator::kInstance.makeUnorderedValueMap<Document>()),
+      _spilledIds(ValueComparator::kInstance.makeUnorderedValueSet()),
       _cache(pExpCtx->getValueComparator()),
-      _unwind(unwindSrc) {
+      _unwind(unwindSrc),
+      _memoryReservation(pExpCtx->opCtx) {
     const auto& resolvedNamespace = pExpCtx->getResolvedNamespace(_from);
     _fromExpCtx = pExpCtx->copyWith(resolvedNamespace.ns);
     _fromPipeline = resolvedNamespace.pipeline;
@@ -481,7 +567,8 @@ intrusive_ptr<DocumentSourceGraphLookUp> DocumentSourceGraphLookUp::create(
     boost::optional<BSONObj> additionalFilter,
     boost::optional<FieldPath> depthField,
     boost::optional<long long> maxDepth,
-    boost::optional<boost::intrusive_ptr<DocumentSourceUnwind>> unwindSrc) {
+    boost::optional<boost::intrusive_ptr<DocumentSourceUnwind>> unwindSrc,
+    size_t maxMemoryUsageBytes) {
     intrusive_ptr<DocumentSourceGraphLookUp> source(
         new DocumentSourceGraphLookUp(expCtx,
                                       std::move(fromNs),
@@ -492,7 +579,8 @@ intrusive_ptr<DocumentSourceGraphLookUp> DocumentSourceGraphLookUp::create(
                                       additionalFilter,
                                       depthField,
                                       maxDepth,
-                                      unwindSrc));
+                                      unwindSrc,
+                                      maxMemoryUsageBytes));
     return source;
 }
 
@@ -602,8 +690,12 @@ intrusive_ptr<DocumentSource> DocumentSourceGraphLookUp::createFromBson(
                                       additionalFilter,
                                       depthField,
                                       maxDepth,
-                                      boost::none));
+                                      boost::none,
+                                      kDefaultMaxMemoryUsageBytes));
 
     return std::move(newSource);
 }
 }  // namespace mongo
+
+#include "mongo/db/sorter/sorter.cpp"
+// Explicit instantiation unneeded since we aren't exposing Sorter outside of this file.
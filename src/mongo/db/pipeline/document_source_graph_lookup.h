@@ -28,16 +28,23 @@
 
 #pragma once
 
+#include <deque>
+#include <memory>
+
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_unwind.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/lookup_set_cache.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/query/query_memory_budget.h"
+#include "mongo/db/sorter/sorter.h"
 
 namespace mongo {
 
 class DocumentSourceGraphLookUp final : public DocumentSourceNeedsMongod {
 public:
+    static const size_t kDefaultMaxMemoryUsageBytes = 100 * 1024 * 1024;
+
     static std::unique_ptr<LiteParsedDocumentSourceOneForeignCollection> liteParse(
         const AggregationRequest& request, const BSONElement& spec);
 
@@ -57,6 +64,14 @@ public:
         return true;
     }
 
+    /**
+     * Each input document produces exactly one output document unless we have absorbed an
+     * $unwind.
+     */
+    bool canSwapWithSkipOrLimit() const final {
+        return !_unwind;
+    }
+
     GetDepsReturn getDependencies(DepsTracker* deps) const final {
         _startWith->addDependencies(deps);
         return SEE_NEXT;
@@ -84,7 +99,8 @@ public:
         boost::optional<BSONObj> additionalFilter,
         boost::optional<FieldPath> depthField,
         boost::optional<long long> maxDepth,
-        boost::optional<boost::intrusive_ptr<DocumentSourceUnwind>> unwindSrc);
+        boost::optional<boost::intrusive_ptr<DocumentSourceUnwind>> unwindSrc,
+        size_t maxMemoryUsageBytes = kDefaultMaxMemoryUsageBytes);
 
     static boost::intrusive_ptr<DocumentSource> createFromBson(
         BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& pExpCtx);
@@ -109,7 +125,8 @@ private:
         boost::optional<BSONObj> additionalFilter,
         boost::optional<FieldPath> depthField,
         boost::optional<long long> maxDepth,
-        boost::optional<boost::intrusive_ptr<DocumentSourceUnwind>> unwindSrc);
+        boost::optional<boost::intrusive_ptr<DocumentSourceUnwind>> unwindSrc,
+        size_t maxMemoryUsageBytes);
 
     Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final {
         // Should not be called; use serializeToArray instead.
@@ -152,11 +169,37 @@ private:
     void addToCache(const Document& result, const ValueUnorderedSet& queried);
 
     /**
-     * Assert that '_visited' and '_frontier' have not exceeded the maximum meory usage, and then
-     * evict from '_cache' until this source is using less than '_maxMemoryUsageBytes'.
+     * Returns whether 'queried' may be cached as matching nothing when a query for it returned no
+     * documents that addToCache() recorded under it.
+     */
+    bool canCacheWithoutResults(const Value& queried) const;
+
+    /**
+     * Assert that '_visited' and '_frontier' have not exceeded the maximum meory usage, spilling
+     * the documents in '_visited' to disk first if that is allowed, and then evict from '_cache'
+     * until this source is using less than '_maxMemoryUsageBytes'.
      */
     void checkMemoryUsage();
 
+    /**
+     * Writes the documents in '_visited' to a temporary file, keeping only their '_id's in memory
+     * in '_spilledIds' so that they are still de-duplicated against.
+     */
+    void spill();
+
+    /**
+     * Returns whether any of the documents discovered for '_input' are left to return.
+     */
+    bool hasVisited() const {
+        return !_visited.empty() || !_spilledFiles.empty();
+    }
+
+    /**
+     * Removes and returns one of the documents discovered for '_input', from memory first and then
+     * from any that were spilled. Must only be called if hasVisited().
+     */
+    Document popVisited();
+
     /**
      * Process 'result', adding it to '_visited' with the given 'depth', and updating '_frontier'
      * with the object's 'connectTo' values.
@@ -182,9 +225,13 @@ private:
     // The aggregation pipeline to perform against the '_from' namespace.
     std::vector<BSONObj> _fromPipeline;
 
-    size_t _maxMemoryUsageBytes = 100 * 1024 * 1024;
+    const size_t _maxMemoryUsageBytes;
+
+    // Whether '_visited' may be spilled to disk once it exceeds '_maxMemoryUsageBytes'.
+    const bool _extSortAllowed;
 
-    // Track memory usage to ensure we don't exceed '_maxMemoryUsageBytes'.
+    // Track memory usage to ensure we don't exceed '_maxMemoryUsageBytes'. Once '_visited' has
+    // been spilled, '_visitedUsageBytes' includes the size of '_spilledIds'.
     size_t _visitedUsageBytes = 0;
     size_t _frontierUsageBytes = 0;
 
@@ -196,6 +243,12 @@ private:
     // using the simple collation.
     ValueUnorderedMap<Document> _visited;
 
+    // The '_id's of the nodes discovered for the current input that have been spilled to disk, and
+    // the files holding them, in the order in which they were written. Exhausted files are
+    // removed, so '_spilledFiles' is empty once every spilled document has been returned.
+    ValueUnorderedSet _spilledIds;
+    std::deque<std::shared_ptr<Sorter<Value, Document>::Iterator>> _spilledFiles;
+
     // Caches query results to avoid repeating any work. This structure is maintained across calls
     // to getNext().
     LookupSetCache _cache;
@@ -207,6 +260,10 @@ private:
     // Keep track of a $unwind that was absorbed into this stage.
     boost::optional<boost::intrusive_ptr<DocumentSourceUnwind>> _unwind;
 
+    // Our share of the process-wide query memory budget, which covers '_visitedUsageBytes' and
+    // '_frontierUsageBytes'.
+    QueryMemoryBudget::Reservation _memoryReservation;
+
     // If we absorbed a $unwind that specified 'includeArrayIndex', this is used to populate that
     // field, tracking how many results we've returned so far for the current input document.
     long long _outputIndex;
@@ -37,6 +37,7 @@
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
 #include "mongo/db/pipeline/stub_mongod_interface.h"
+#include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/mongoutils/str.h"
@@ -72,11 +73,17 @@ public:
         pipeline.getValue()->addInitialSource(DocumentSourceMock::create(_results));
         pipeline.getValue()->optimizePipeline();
 
+        ++_numPipelinesMade;
         return pipeline;
     }
 
+    int numPipelinesMade() const {
+        return _numPipelinesMade;
+    }
+
 private:
     std::deque<DocumentSource::GetNextResult> _results;
+    int _numPipelinesMade = 0;
 };
 
 TEST_F(DocumentSourceGraphLookUpTest,
@@ -612,5 +619,133 @@ TEST_F(DocumentSourceGraphLookUpTest, ShouldNotExpandArraysWithinArraysAtEndOfCo
     ASSERT(graphLookupStage->getNext().isEOF());
 }
 
+/**
+ * Returns the chain 0 -> 1 -> ... -> 'length' - 1 of documents each holding 'padding' bytes.
+ */
+std::deque<DocumentSource::GetNextResult> makeChain(int length, size_t padding) {
+    std::deque<DocumentSource::GetNextResult> chain;
+    for (int i = 0; i < length; ++i) {
+        chain.push_back(
+            Document{{"_id", i}, {"to", i + 1}, {"padding", std::string(padding, 'x')}});
+    }
+    return chain;
+}
+
+TEST_F(DocumentSourceGraphLookUpTest, ShouldSpillVisitedDocumentsWhenAllowedToUseDisk) {
+    auto expCtx = getExpCtx();
+    unittest::TempDir tempDir("DocumentSourceGraphLookUpTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->extSortAllowed = true;
+    const size_t maxMemoryUsageBytes = 1000;
+
+    std::deque<DocumentSource::GetNextResult> inputs{Document{{"_id", 0}}};
+    auto inputMock = DocumentSourceMock::create(std::move(inputs));
+
+    NamespaceString fromNs("test", "graph_lookup");
+    expCtx->setResolvedNamespace(fromNs, {fromNs, std::vector<BSONObj>{}});
+    const bool preserveNullAndEmptyArrays = false;
+    const boost::optional<std::string> includeArrayIndex = std::string("index");
+    auto unwindStage = DocumentSourceUnwind::create(
+        expCtx, "results", preserveNullAndEmptyArrays, includeArrayIndex);
+    auto graphLookupStage =
+        DocumentSourceGraphLookUp::create(expCtx,
+                                          fromNs,
+                                          "results",
+                                          "to",
+                                          "_id",
+                                          ExpressionFieldPath::create(expCtx, "_id"),
+                                          boost::none,
+                                          boost::none,
+                                          boost::none,
+                                          unwindStage,
+                                          maxMemoryUsageBytes);
+    graphLookupStage->setSource(inputMock.get());
+    graphLookupStage->injectMongodInterface(
+        std::make_shared<MockMongodImplementation>(makeChain(10, maxMemoryUsageBytes / 4)));
+
+    // Every node of the chain is returned exactly once, although they can't all be held in memory.
+    std::vector<int> discovered;
+    for (long long index = 0; index < 10; ++index) {
+        auto next = graphLookupStage->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+        ASSERT_VALUE_EQ(Value(index), next.getDocument()["index"]);
+        discovered.push_back(next.getDocument()["results"]["_id"].getInt());
+    }
+    ASSERT_TRUE(graphLookupStage->getNext().isEOF());
+
+    std::sort(discovered.begin(), discovered.end());
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_EQ(i, discovered[i]);
+    }
+}
+
+TEST_F(DocumentSourceGraphLookUpTest, ShouldErrorWhenVisitedDocumentsExceedMemoryWithoutDiskUse) {
+    auto expCtx = getExpCtx();
+    expCtx->extSortAllowed = false;
+    const size_t maxMemoryUsageBytes = 1000;
+
+    std::deque<DocumentSource::GetNextResult> inputs{Document{{"_id", 0}}};
+    auto inputMock = DocumentSourceMock::create(std::move(inputs));
+
+    NamespaceString fromNs("test", "graph_lookup");
+    expCtx->setResolvedNamespace(fromNs, {fromNs, std::vector<BSONObj>{}});
+    auto graphLookupStage =
+        DocumentSourceGraphLookUp::create(expCtx,
+                                          fromNs,
+                                          "results",
+                                          "to",
+                                          "_id",
+                                          ExpressionFieldPath::create(expCtx, "_id"),
+                                          boost::none,
+                                          boost::none,
+                                          boost::none,
+                                          boost::none,
+                                          maxMemoryUsageBytes);
+    graphLookupStage->setSource(inputMock.get());
+    graphLookupStage->injectMongodInterface(
+        std::make_shared<MockMongodImplementation>(makeChain(10, maxMemoryUsageBytes / 4)));
+
+    ASSERT_THROWS_CODE(graphLookupStage->getNext(), UserException, 40099);
+}
+
+TEST_F(DocumentSourceGraphLookUpTest, ShouldNotQueryAgainForValuesThatMatchedNothing) {
+    auto expCtx = getExpCtx();
+
+    // Both inputs start at the same node, whose 'to' value matches no other node.
+    std::deque<DocumentSource::GetNextResult> inputs{Document{{"_id", 0}, {"start", 1}},
+                                                     Document{{"_id", 1}, {"start", 1}}};
+    auto inputMock = DocumentSourceMock::create(std::move(inputs));
+
+    Document leaf{{"_id", 1}, {"to", 2}};
+    std::deque<DocumentSource::GetNextResult> fromContents{Document(leaf)};
+
+    NamespaceString fromNs("test", "graph_lookup");
+    expCtx->setResolvedNamespace(fromNs, {fromNs, std::vector<BSONObj>{}});
+    auto graphLookupStage =
+        DocumentSourceGraphLookUp::create(expCtx,
+                                          fromNs,
+                                          "results",
+                                          "to",
+                                          "_id",
+                                          ExpressionFieldPath::create(expCtx, "start"),
+                                          boost::none,
+                                          boost::none,
+                                          boost::none,
+                                          boost::none);
+    graphLookupStage->setSource(inputMock.get());
+    auto mongod = std::make_shared<MockMongodImplementation>(std::move(fromContents));
+    graphLookupStage->injectMongodInterface(mongod);
+
+    for (int i = 0; i < 2; ++i) {
+        auto next = graphLookupStage->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+        ASSERT_VALUE_EQ(Value(std::vector<Value>{Value(leaf)}), next.getDocument()["results"]);
+    }
+    ASSERT_TRUE(graphLookupStage->getNext().isEOF());
+
+    // The first input queries for 1 and then 2. The second finds both in the cache.
+    ASSERT_EQ(2, mongod->numPipelinesMade());
+}
+
 }  // namespace
 }  // namespace mongo
@@ -127,47 +127,95 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextStandard() {
 }
 
 DocumentSource::GetNextResult DocumentSourceGroup::getNextStreaming() {
-    // Streaming optimization is active.
-    if (!_firstDocOfNextGroup) {
-        auto nextInput = pSource->getNext();
-        if (!nextInput.isAdvanced()) {
-            return nextInput;
-        }
-        _firstDocOfNextGroup = nextInput.releaseDocument();
-    }
+    // Streaming optimization is active. The input arrives in runs of documents with equal values
+    // for the sort fields, so once a run ends its groups are final and can be returned.
+    if (!_streamingRunComplete) {
+        const size_t numAccumulators = _accumulatedFields.size();
+        while (!_streamingInputExhausted) {
+            if (!_firstDocOfNextGroup) {
+                auto nextInput = pSource->getNext();
+                if (nextInput.isPaused()) {
+                    // Everything accumulated so far stays in '_groups' until we are resumed.
+                    return nextInput;
+                }
+                if (nextInput.isEOF()) {
+                    _streamingInputExhausted = true;
+                    break;
+                }
+                _firstDocOfNextGroup = nextInput.releaseDocument();
+            }
+
+            Value runKey = computeRunKey(*_firstDocOfNextGroup);
+            if (!_groups->empty() &&
+                !pExpCtx->getValueComparator().evaluate(_currentId == runKey)) {
+                // This document starts the next run. Leave it in '_firstDocOfNextGroup'.
+                break;
+            }
+            _currentId = std::move(runKey);
 
-    Value id;
-    do {
-        // Add to the current accumulator(s).
-        for (size_t i = 0; i < _currentAccumulators.size(); i++) {
-            _currentAccumulators[i]->process(
-                _accumulatedFields[i].expression->evaluate(*_firstDocOfNextGroup), _doingMerge);
+            const size_t oldSize = _groups->size();
+            Accumulators& group = (*_groups)[computeId(*_firstDocOfNextGroup)];
+            if (_groups->size() != oldSize) {
+                group.reserve(numAccumulators);
+                for (auto&& accumulatedField : _accumulatedFields) {
+                    group.push_back(accumulatedField.makeAccumulator(pExpCtx));
+                }
+            }
+
+            for (size_t i = 0; i < numAccumulators; i++) {
+                group[i]->process(
+                    _accumulatedFields[i].expression->evaluate(*_firstDocOfNextGroup),
+                    _doingMerge);
+            }
+            _firstDocOfNextGroup = boost::none;
         }
 
-        // Retrieve the next document.
-        auto nextInput = pSource->getNext();
-        if (!nextInput.isAdvanced()) {
-            return nextInput;
+        if (_groups->empty()) {
+            invariant(_streamingInputExhausted);
+            return GetNextResult::makeEOF();
         }
+        _streamingRunComplete = true;
+        groupsIterator = _groups->begin();
+    }
+
+    Document out = makeDocument(groupsIterator->first, groupsIterator->second, pExpCtx->inShard);
 
-        _firstDocOfNextGroup = nextInput.releaseDocument();
+    if (++groupsIterator == _groups->end()) {
+        _groups->clear();
+        _streamingRunComplete = false;
+    }
 
+    return std::move(out);
+}
 
-        // Compute the id. If it does not match _currentId, we will exit the loop, leaving
-        // _firstDocOfNextGroup set for the next time getNext() is called.
-        id = computeId(*_firstDocOfNextGroup);
-    } while (pExpCtx->getValueComparator().evaluate(_currentId == id));
+Value DocumentSourceGroup::computeRunKey(const Document& root) const {
+    vector<Value> key;
+    key.reserve(_inputSortPaths.size());
+    for (auto&& path : _inputSortPaths) {
+        Value val = root.getNestedField(path);
+        uassert(40631,
+                str::stream() << "$group expected its input to be sorted on '" << path.fullPath()
+                              << "', but found an array there. The index providing the sort may "
+                                 "have become multikey.",
+                !val.isArray());
+        key.push_back(val.missing() ? Value(BSONNULL) : std::move(val));
+    }
+    return Value(std::move(key));
+}
 
-    Document out = makeDocument(_currentId, _currentAccumulators, pExpCtx->inShard);
-    _currentId = std::move(id);
+void DocumentSourceGroup::detachFromOperationContext() {
+    _memoryReservation.detachFromOperationContext();
+}
 
-    return std::move(out);
+void DocumentSourceGroup::reattachToOperationContext(OperationContext* opCtx) {
+    _memoryReservation.reattachToOperationContext(opCtx);
 }
 
 void DocumentSourceGroup::doDispose() {
     // Free our resources.
-    _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
+    _groups = GroupsMap(pExpCtx->getValueComparator());
     _sorterIterator.reset();
+    _memoryReservation.resize(0);
 
     // Make us look done.
     groupsIterator = _groups->end();
@@ -221,13 +269,32 @@ Value DocumentSourceGroup::serialize(boost::optional<ExplainOptions::Verbosity>
         insides["$doingMerge"] = Value(true);
     }
 
+    if (explain && _unwindSrc) {
+        // Our explain output does not have to be parseable, so report the absorbed $unwind here.
+        insides["$unwinding"] = _unwindSrc->serialize(explain)[_unwindSrc->getSourceName()];
+    }
+
     if (explain && findRelevantInputSort()) {
         return Value(DOC("$streamingGroup" << insides.freeze()));
     }
     return Value(DOC(getSourceName() << insides.freeze()));
 }
 
+void DocumentSourceGroup::serializeToArray(
+    std::vector<Value>& array, boost::optional<ExplainOptions::Verbosity> explain) const {
+    if (_unwindSrc && !explain) {
+        // Re-create the pipeline we absorbed, so that a shard parsing it can absorb it again.
+        _unwindSrc->serializeToArray(array);
+    }
+    DocumentSource::serializeToArray(array, explain);
+}
+
 DocumentSource::GetDepsReturn DocumentSourceGroup::getDependencies(DepsTracker* deps) const {
+    if (_unwindSrc) {
+        // Every element of the unwound array is an input, whatever our expressions read from it.
+        _unwindSrc->getDependencies(deps);
+    }
+
     // add the _id
     for (size_t i = 0; i < _idExpressions.size(); i++) {
         _idExpressions[i]->addDependencies(deps);
@@ -264,9 +331,10 @@ DocumentSourceGroup::DocumentSourceGroup(const intrusive_ptr<ExpressionContext>&
       _inputSort(BSONObj()),
       _streaming(false),
       _initialized(false),
-      _groups(pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>()),
+      _groups(GroupsMap(pExpCtx->getValueComparator())),
       _spilled(false),
-      _extSortAllowed(pExpCtx->extSortAllowed && !pExpCtx->inRouter) {}
+      _extSortAllowed(pExpCtx->extSortAllowed && !pExpCtx->inRouter),
+      _memoryReservation(pExpCtx->opCtx) {}
 
 void DocumentSourceGroup::addAccumulator(AccumulationStatement accumulationStatement) {
     _accumulatedFields.push_back(accumulationStatement);
@@ -448,95 +516,224 @@ void getFieldPathListForSpilled(ExpressionObject* expressionObj,
 }
 }  // namespace
 
-DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
+template <typename EvaluateInput>
+void DocumentSourceGroup::accumulate(Value id, const EvaluateInput& evaluateInput) {
     const size_t numAccumulators = _accumulatedFields.size();
 
-    boost::optional<BSONObj> inputSort = findRelevantInputSort();
-    if (inputSort) {
-        // We can convert to streaming.
-        _streaming = true;
-        _inputSort = *inputSort;
+    if (_memoryUsageBytes > _maxMemoryUsageBytes) {
+        uassert(16945,
+                "Exceeded memory limit for $group, but didn't allow external sort."
+                " Pass allowDiskUse:true to opt in.",
+                _extSortAllowed);
+        _sortedFiles.push_back(spill());
+        _memoryUsageBytes = 0;
+    } else if (!_memoryReservation.tryResize(_memoryUsageBytes)) {
+        // The process is short of query memory, so spill early if we may, or else wait for
+        // other operations to release some.
+        if (_extSortAllowed) {
+            QueryMemoryBudget::recordSpill();
+            _sortedFiles.push_back(spill());
+            _memoryUsageBytes = 0;
+        }
+        _memoryReservation.resizeOrWait(_memoryUsageBytes, "$group");
+    }
+
+    // Look for the _id value in the map. If it's not there, add a new entry with a blank
+    // accumulator. This is done in a somewhat odd way in order to avoid hashing 'id' and
+    // looking it up in '_groups' multiple times.
+    const size_t oldSize = _groups->size();
+    vector<intrusive_ptr<Accumulator>>& group = (*_groups)[id];
+    const bool inserted = _groups->size() != oldSize;
 
-        // Set up accumulators.
-        _currentAccumulators.reserve(numAccumulators);
+    if (inserted) {
+        _memoryUsageBytes += id.getApproximateSize();
+
+        // Add the accumulators
+        group.reserve(numAccumulators);
         for (auto&& accumulatedField : _accumulatedFields) {
-            _currentAccumulators.push_back(accumulatedField.makeAccumulator(pExpCtx));
+            group.push_back(accumulatedField.makeAccumulator(pExpCtx));
         }
-
-        // We only need to load the first document.
-        auto firstInput = pSource->getNext();
-        if (!firstInput.isAdvanced()) {
-            // Leave '_firstDocOfNextGroup' uninitialized and return.
-            return firstInput;
+    } else {
+        for (auto&& groupObj : group) {
+            // subtract old mem usage. New usage added back after processing.
+            _memoryUsageBytes -= groupObj->memUsageForSorter();
         }
-        _firstDocOfNextGroup = firstInput.releaseDocument();
+    }
 
-        // Compute the _id value.
-        _currentId = computeId(*_firstDocOfNextGroup);
-        _initialized = true;
-        return DocumentSource::GetNextResult::makeEOF();
+    /* tickle all the accumulators for the group we found */
+    dassert(numAccumulators == group.size());
+
+    for (size_t i = 0; i < numAccumulators; i++) {
+        group[i]->process(evaluateInput(i), _doingMerge);
+
+        _memoryUsageBytes += group[i]->memUsageForSorter();
     }
 
+    if (kDebugBuild && !storageGlobalParams.readOnly) {
+        // In debug mode, spill every time we have a duplicate id to stress merge logic.
+        if (!inserted &&                 // is a dup
+            !pExpCtx->inRouter &&        // can't spill to disk in router
+            !_extSortAllowed &&          // don't change behavior when testing external sort
+            _sortedFiles.size() < 20) {  // don't open too many FDs
 
-    // Barring any pausing, this loop exhausts 'pSource' and populates '_groups'.
-    GetNextResult input = pSource->getNext();
-    for (; input.isAdvanced(); input = pSource->getNext()) {
-        if (_memoryUsageBytes > _maxMemoryUsageBytes) {
-            uassert(16945,
-                    "Exceeded memory limit for $group, but didn't allow external sort."
-                    " Pass allowDiskUse:true to opt in.",
-                    _extSortAllowed);
             _sortedFiles.push_back(spill());
-            _memoryUsageBytes = 0;
         }
+    }
+}
 
-        // We release the result document here so that it does not outlive the end of this loop
-        // iteration. Not releasing could lead to an array copy when this group follows an unwind.
-        auto rootDocument = input.releaseDocument();
-        Value id = computeId(rootDocument);
-
-        // Look for the _id value in the map. If it's not there, add a new entry with a blank
-        // accumulator. This is done in a somewhat odd way in order to avoid hashing 'id' and
-        // looking it up in '_groups' multiple times.
-        const size_t oldSize = _groups->size();
-        vector<intrusive_ptr<Accumulator>>& group = (*_groups)[id];
-        const bool inserted = _groups->size() != oldSize;
-
-        if (inserted) {
-            _memoryUsageBytes += id.getApproximateSize();
-
-            // Add the accumulators
-            group.reserve(numAccumulators);
-            for (auto&& accumulatedField : _accumulatedFields) {
-                group.push_back(accumulatedField.makeAccumulator(pExpCtx));
+bool DocumentSourceGroup::absorbUnwind(const intrusive_ptr<DocumentSourceUnwind>& unwind) {
+    if (_unwindSrc || unwind->preserveNullAndEmptyArrays() || unwind->indexPath()) {
+        return false;
+    }
+
+    _unwindSrc = unwind;
+    _unwindPath = FieldPath(unwind->getUnwindPath());
+
+    bool canAbsorb = true;
+    for (auto&& idExpression : _idExpressions) {
+        canAbsorb = canAbsorb && makeUnwoundInput(idExpression);
+    }
+    for (auto&& accumulatedField : _accumulatedFields) {
+        canAbsorb = canAbsorb && makeUnwoundInput(accumulatedField.expression);
+    }
+
+    if (!canAbsorb) {
+        _unwindSrc.reset();
+        _unwindPath = boost::none;
+    }
+    return canAbsorb;
+}
+
+boost::optional<DocumentSourceGroup::UnwoundInput> DocumentSourceGroup::makeUnwoundInput(
+    const intrusive_ptr<Expression>& expression) const {
+    UnwoundInput input;
+    input.expression = expression;
+    if (dynamic_cast<ExpressionConstant*>(expression.get())) {
+        return input;
+    }
+
+    auto fieldPath = dynamic_cast<ExpressionFieldPath*>(expression.get());
+    if (!fieldPath || fieldPath->getVariableId() != Variables::kRootId ||
+        fieldPath->getFieldPath().getPathLength() == 1) {
+        // Anything else might read the unwound array through something other than a path into it,
+        // such as $$ROOT, which would need the whole unwound document.
+        return boost::none;
+    }
+
+    // Compare the path, after its leading ROOT or CURRENT, with the unwound path.
+    const FieldPath& path = fieldPath->getFieldPath();
+    const size_t pathLength = path.getPathLength() - 1;
+    const size_t unwindPathLength = _unwindPath->getPathLength();
+    for (size_t i = 0; i < std::min(pathLength, unwindPathLength); i++) {
+        if (path.getFieldName(i + 1) != _unwindPath->getFieldName(i)) {
+            // The path leaves the unwound path, so its value is the same for every element.
+            return input;
+        }
+    }
+
+    if (pathLength < unwindPathLength) {
+        // The path leads to a document containing the unwound array, which would hold a
+        // different element for each unwound document.
+        return boost::none;
+    }
+
+    input.elementPath = fieldPath;
+    input.elementPathIndex = unwindPathLength + 1;
+    return input;
+}
+
+void DocumentSourceGroup::accumulateUnwound(const Document& root) {
+    // The inputs which do not depend on the unwound element are the same for all of them.
+    for (auto&& input : _unwoundIdInputs) {
+        if (!input.elementPath) {
+            input.documentValue = input.expression->evaluate(root);
+        }
+    }
+    for (auto&& input : _unwoundAccumulatorInputs) {
+        if (!input.elementPath) {
+            input.documentValue = input.expression->evaluate(root);
+        }
+    }
+
+    auto accumulateElement = [&](const Value& element) {
+        // Mirrors computeId().
+        Value id;
+        if (_unwoundIdInputs.size() == 1) {
+            id = _unwoundIdInputs[0].evaluate(element);
+            if (id.missing()) {
+                id = Value(BSONNULL);
             }
         } else {
-            for (auto&& groupObj : group) {
-                // subtract old mem usage. New usage added back after processing.
-                _memoryUsageBytes -= groupObj->memUsageForSorter();
+            vector<Value> vals;
+            vals.reserve(_unwoundIdInputs.size());
+            for (auto&& input : _unwoundIdInputs) {
+                vals.push_back(input.evaluate(element));
             }
+            id = Value(std::move(vals));
         }
 
-        /* tickle all the accumulators for the group we found */
-        dassert(numAccumulators == group.size());
+        accumulate(std::move(id),
+                   [&](size_t i) { return _unwoundAccumulatorInputs[i].evaluate(element); });
+    };
+
+    // Like $unwind, skip a document whose array is nullish or empty, and treat any other value as
+    // an array holding just that value.
+    Value array = root.getNestedField(*_unwindPath);
+    if (array.nullish()) {
+        return;
+    }
+    if (!array.isArray()) {
+        accumulateElement(array);
+        return;
+    }
+    for (auto&& element : array.getArray()) {
+        accumulateElement(element);
+    }
+}
 
-        for (size_t i = 0; i < numAccumulators; i++) {
-            group[i]->process(_accumulatedFields[i].expression->evaluate(rootDocument),
-                              _doingMerge);
+DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
+    const size_t numAccumulators = _accumulatedFields.size();
 
-            _memoryUsageBytes += group[i]->memUsageForSorter();
+    boost::optional<BSONObj> inputSort = findRelevantInputSort();
+    if (inputSort) {
+        // We can convert to streaming. getNextStreaming() reads the input one run at a time.
+        _streaming = true;
+        _inputSort = *inputSort;
+        for (auto&& sortField : _inputSort) {
+            _inputSortPaths.emplace_back(sortField.fieldName());
         }
+        _initialized = true;
+        return DocumentSource::GetNextResult::makeEOF();
+    }
 
-        if (kDebugBuild && !storageGlobalParams.readOnly) {
-            // In debug mode, spill every time we have a duplicate id to stress merge logic.
-            if (!inserted &&                 // is a dup
-                !pExpCtx->inRouter &&        // can't spill to disk in router
-                !_extSortAllowed &&          // don't change behavior when testing external sort
-                _sortedFiles.size() < 20) {  // don't open too many FDs
 
-                _sortedFiles.push_back(spill());
-            }
+    if (_unwindSrc && _unwoundIdInputs.empty()) {
+        for (auto&& idExpression : _idExpressions) {
+            auto unwoundInput = makeUnwoundInput(idExpression);
+            invariant(unwoundInput);
+            _unwoundIdInputs.push_back(std::move(*unwoundInput));
+        }
+        for (auto&& accumulatedField : _accumulatedFields) {
+            auto unwoundInput = makeUnwoundInput(accumulatedField.expression);
+            invariant(unwoundInput);
+            _unwoundAccumulatorInputs.push_back(std::move(*unwoundInput));
+        }
+    }
+
+    // Barring any pausing, this loop exhausts 'pSource' and populates '_groups'.
+    GetNextResult input = pSource->getNext();
+    for (; input.isAdvanced(); input = pSource->getNext()) {
+        // We release the result document here so that it does not outlive the end of this loop
+        // iteration. Not releasing could lead to an array copy when this group follows an unwind.
+        auto rootDocument = input.releaseDocument();
+        if (_unwindSrc) {
+            accumulateUnwound(rootDocument);
+            continue;
         }
+
+        accumulate(computeId(rootDocument), [&](size_t i) {
+            return _accumulatedFields[i].expression->evaluate(rootDocument);
+        });
     }
 
     switch (input.getStatus()) {
@@ -555,7 +752,8 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
                 }
 
                 // We won't be using groups again so free its memory.
-                _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
+                _groups = GroupsMap(pExpCtx->getValueComparator());
+                _memoryReservation.resize(0);
 
                 _sorterIterator.reset(Sorter<Value, Value>::Iterator::merge(
                     _sortedFiles, SortOptions(), SorterComparator(pExpCtx->getValueComparator())));
@@ -623,9 +821,15 @@ shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
 }
 
 boost::optional<BSONObj> DocumentSourceGroup::findRelevantInputSort() const {
-    if (true) {
-        // Until streaming $group correctly handles nullish values, the streaming behavior is
-        // disabled. See SERVER-23318.
+    if (_unwindSrc) {
+        // Our input is sorted before it is unwound, which says nothing about the order of the
+        // elements we group.
+        return boost::none;
+    }
+
+    if (!_streamingAllowed) {
+        // Only the caller knows whether documents with equal sort keys are adjacent in the input.
+        // See allowStreaming().
         return boost::none;
     }
 
@@ -688,6 +892,27 @@ boost::optional<BSONObj> DocumentSourceGroup::findRelevantInputSort() const {
     return boost::none;
 }
 
+boost::optional<std::string> DocumentSourceGroup::getDistinctScanField() const {
+    if (!_accumulatedFields.empty() || !_idFieldNames.empty() || _doingMerge || _unwindSrc) {
+        return boost::none;
+    }
+
+    invariant(_idExpressions.size() == 1);
+    auto fieldPath = dynamic_cast<ExpressionFieldPath*>(_idExpressions[0].get());
+    if (!fieldPath) {
+        return boost::none;
+    }
+
+    // Only paths like "$a" or "$$ROOT.a" qualify. A dotted path would be returned by a covered
+    // projection as a literal dotted field name.
+    const FieldPath& path = fieldPath->getFieldPath();
+    if (path.getPathLength() != 2 ||
+        (path.getFieldName(0) != "CURRENT" && path.getFieldName(0) != "ROOT")) {
+        return boost::none;
+    }
+    return path.getFieldName(1).toString();
+}
+
 BSONObjSet DocumentSourceGroup::getOutputSorts() {
     if (!_initialized) {
         initialize();  // Note this might not finish initializing, but that's OK. We just want to
@@ -708,11 +933,8 @@ BSONObjSet DocumentSourceGroup::getOutputSorts() {
             // We have an expression like {_id: "$a"}. Check if this is a FieldPath, and if it is,
             // get the sort order out of it.
             if (auto obj = dynamic_cast<ExpressionFieldPath*>(_idExpressions[0].get())) {
-                FieldPath _idSort = obj->getFieldPath();
-
-                sortOrder.append(
-                    "_id",
-                    _inputSort.getIntField(_idSort.getFieldName(_idSort.getPathLength() - 1)));
+                sortOrder.append("_id",
+                                 _inputSort.getIntField(obj->getFieldPath().tail().fullPath()));
             }
         }
     } else if (_streaming) {
@@ -730,9 +952,7 @@ BSONObjSet DocumentSourceGroup::getOutputSorts() {
                 // _id is an object containing a nested document, such as: {_id: {x: {y: "$b"}}}.
                 getFieldPathMap(obj, "_id." + _idFieldNames[i], &fieldMap);
             } else if (auto fieldPath = dynamic_cast<ExpressionFieldPath*>(exp.get())) {
-                FieldPath _idSort = fieldPath->getFieldPath();
-                fieldMap[_idSort.getFieldName(_idSort.getPathLength() - 1)] =
-                    "_id." + _idFieldNames[i];
+                fieldMap[fieldPath->getFieldPath().tail().fullPath()] = "_id." + _idFieldNames[i];
             }
         }
 
@@ -34,6 +34,11 @@
 #include "mongo/db/pipeline/accumulation_statement.h"
 #include "mongo/db/pipeline/accumulator.h"
 #include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/pipeline/document_source_unwind.h"
+#include "mongo/db/pipeline/expression.h"
+#include "mongo/db/pipeline/field_path.h"
+#include "mongo/db/pipeline/group_table.h"
+#include "mongo/db/query/query_memory_budget.h"
 #include "mongo/db/sorter/sorter.h"
 
 namespace mongo {
@@ -41,7 +46,7 @@ namespace mongo {
 class DocumentSourceGroup final : public DocumentSource, public SplittableDocumentSource {
 public:
     using Accumulators = std::vector<boost::intrusive_ptr<Accumulator>>;
-    using GroupsMap = ValueUnorderedMap<Accumulators>;
+    using GroupsMap = GroupTable<Accumulators>;
 
     static const size_t kDefaultMaxMemoryUsageBytes = 100 * 1024 * 1024;
 
@@ -49,6 +54,9 @@ public:
     boost::intrusive_ptr<DocumentSource> optimize() final;
     GetDepsReturn getDependencies(DepsTracker* deps) const final;
     Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+    void serializeToArray(
+        std::vector<Value>& array,
+        boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
     GetNextResult getNext() final;
     const char* getSourceName() const final;
     BSONObjSet getOutputSorts() final;
@@ -90,6 +98,39 @@ public:
         return _streaming;
     }
 
+    /**
+     * Permits this stage to group its input in streaming mode when 'pSource' reports an output
+     * sort on the fields of the _id. The caller must know that the source places all documents
+     * with equal values for those fields next to each other, as a scan of an index that is not
+     * multikey does. A sort produced by $sort does not qualify, since it orders an array by one of
+     * its elements.
+     */
+    void allowStreaming() {
+        _streamingAllowed = true;
+    }
+
+    /**
+     * If this stage groups by a single top-level field and computes nothing but the _id, as in
+     * {$group: {_id: "$a"}}, returns that field. One document per distinct value of the field is
+     * then enough input to produce the same output.
+     */
+    boost::optional<std::string> getDistinctScanField() const;
+
+    /**
+     * Takes over the work of 'unwind', which must immediately precede this stage, if the _id and
+     * every accumulator of this stage is a constant or a field path, and 'unwind' neither
+     * preserves null and empty arrays nor includes the array index. The elements of each unwound
+     * array are then fed to the accumulators in place, instead of a document being built for each
+     * of them.
+     *
+     * Returns whether 'unwind' was absorbed, in which case the caller must remove it from the
+     * pipeline.
+     */
+    bool absorbUnwind(const boost::intrusive_ptr<DocumentSourceUnwind>& unwind);
+
+    void detachFromOperationContext() final;
+    void reattachToOperationContext(OperationContext* opCtx) final;
+
     // Virtuals for SplittableDocumentSource.
     boost::intrusive_ptr<DocumentSource> getShardSource() final;
     boost::intrusive_ptr<DocumentSource> getMergeSource() final;
@@ -118,9 +159,9 @@ private:
 
     /**
      * Before returning anything, this source must prepare itself. In a streaming $group,
-     * initialize() requests the first document from the previous source, and uses it to prepare the
-     * accumulators. In an unsorted $group, initialize() exhausts the previous source before
-     * returning. The '_initialized' boolean indicates that initialize() has finished.
+     * initialize() only records the input sort; documents are read by getNextStreaming(). In an
+     * unsorted $group, initialize() exhausts the previous source before returning. The
+     * '_initialized' boolean indicates that initialize() has finished.
      *
      * This method may not be able to finish initialization in a single call if 'pSource' returns a
      * DocumentSource::GetNextResult::kPauseExecution, so it returns the last GetNextResult
@@ -137,11 +178,55 @@ private:
 
     Document makeDocument(const Value& id, const Accumulators& accums, bool mergeableOutput);
 
+    /**
+     * Adds one input to the group with key 'id', spilling first if the groups have outgrown their
+     * memory limit. 'evaluateInput(i)' returns the value to feed to the i-th accumulator.
+     */
+    template <typename EvaluateInput>
+    void accumulate(Value id, const EvaluateInput& evaluateInput);
+
+    /**
+     * How an expression of this stage is evaluated against an element of the array unwound by
+     * '_unwindSrc'. A field path into the unwound array continues from the element, at component
+     * 'elementPathIndex'. Any other expression does not depend on the element, and is evaluated
+     * once per input document into 'documentValue'.
+     */
+    struct UnwoundInput {
+        boost::intrusive_ptr<Expression> expression;
+        const ExpressionFieldPath* elementPath = nullptr;
+        size_t elementPathIndex = 0;
+        Value documentValue;
+
+        Value evaluate(const Value& element) const {
+            return elementPath ? elementPath->evaluatePathFrom(elementPathIndex, element)
+                               : documentValue;
+        }
+    };
+
+    /**
+     * Returns how 'expression' is evaluated against an unwound element, or boost::none if it is
+     * neither a constant nor a field path that is either within the unwound path or disjoint from
+     * it.
+     */
+    boost::optional<UnwoundInput> makeUnwoundInput(
+        const boost::intrusive_ptr<Expression>& expression) const;
+
+    /**
+     * Unwinds 'root' as '_unwindSrc' would and accumulates each element of the array.
+     */
+    void accumulateUnwound(const Document& root);
+
     /**
      * Computes the internal representation of the group key.
      */
     Value computeId(const Document& root);
 
+    /**
+     * Computes the values of the '_inputSort' fields in 'root', which are equal for all documents
+     * of one run of a streaming $group. A missing field is treated as null, as an index does.
+     */
+    Value computeRunKey(const Document& root) const;
+
     /**
      * Converts the internal representation of the group key to the _id shape specified by the
      * user.
@@ -157,12 +242,24 @@ private:
     std::vector<boost::intrusive_ptr<Expression>> _idExpressions;
 
     BSONObj _inputSort;
+    std::vector<FieldPath> _inputSortPaths;
+    bool _streamingAllowed = false;
     bool _streaming;
     bool _initialized;
 
+    // When streaming, the run key of the documents being accumulated. Otherwise, the _id of the
+    // group being merged from spilled files.
     Value _currentId;
     Accumulators _currentAccumulators;
 
+    // A $unwind immediately preceding this stage whose work we do as part of accumulating. It is
+    // not part of the pipeline, and is only used for its options and for serialization. The
+    // expressions of this stage are prepared for it in initialize(), once they are optimized.
+    boost::intrusive_ptr<DocumentSourceUnwind> _unwindSrc;
+    boost::optional<FieldPath> _unwindPath;
+    std::vector<UnwoundInput> _unwoundIdInputs;
+    std::vector<UnwoundInput> _unwoundAccumulatorInputs;
+
     // We use boost::optional to defer initialization until the ExpressionContext containing the
     // correct comparator is injected, since the groups must be built using the comparator's
     // definition of equality.
@@ -179,8 +276,17 @@ private:
     const bool _extSortAllowed;
 
     std::pair<Value, Value> _firstPartOfNextGroup;
-    // Only used when '_sorted' is true.
+
+    // Only used when '_streaming' is true. '_groups' then holds the groups of a single run, since
+    // documents with a null sort key may still belong to different groups when some of them are
+    // missing an _id field. '_firstDocOfNextGroup' is the first document of the next run, once it
+    // has been read.
     boost::optional<Document> _firstDocOfNextGroup;
+    bool _streamingRunComplete = false;
+    bool _streamingInputExhausted = false;
+
+    // Our share of the process-wide query memory budget, which covers '_memoryUsageBytes'.
+    QueryMemoryBudget::Reservation _memoryReservation;
 };
 
 }  // namespace mongo
@@ -778,6 +778,7 @@ public:
         createGroup(BSON("_id"
                          << "$a"));
         group()->setSource(source.get());
+        group()->allowStreaming();
 
         auto res = group()->getNext();
         ASSERT_TRUE(res.isAdvanced());
@@ -813,6 +814,7 @@ public:
 
         createGroup(fromjson("{_id: {x: '$a', y: '$b'}}"));
         group()->setSource(source.get());
+        group()->allowStreaming();
 
         auto res = group()->getNext();
         ASSERT_TRUE(res.isAdvanced());
@@ -853,6 +855,7 @@ public:
 
         createGroup(fromjson("{_id: {x: {y: {z: '$a.b.c', q: '$a.b.d'}}, v: '$d'}}"));
         group()->setSource(source.get());
+        group()->allowStreaming();
 
         auto res = group()->getNext();
         ASSERT_TRUE(res.isAdvanced());
@@ -889,6 +892,7 @@ public:
 
         createGroup(fromjson("{_id: {sub: {x: '$a', y: '$b', z: '$a'}}}"));
         group()->setSource(source.get());
+        group()->allowStreaming();
 
         auto res = group()->getNext();
         ASSERT_TRUE(res.isAdvanced());
@@ -924,6 +928,7 @@ public:
 
         createGroup(fromjson("{_id: {sub: {x: '$a', y: '$b', z: {$literal: 'c'}}}}"));
         group()->setSource(source.get());
+        group()->allowStreaming();
 
         auto res = group()->getNext();
         ASSERT_TRUE(res.isAdvanced());
@@ -957,6 +962,7 @@ public:
 
         createGroup(fromjson("{_id: '$$ROOT.a'}"));
         group()->setSource(source.get());
+        group()->allowStreaming();
 
         group()->getNext();
         ASSERT_TRUE(group()->isStreaming());
@@ -977,6 +983,7 @@ public:
 
         createGroup(fromjson("{_id: 1}"));
         group()->setSource(source.get());
+        group()->allowStreaming();
 
         group()->getNext();
         ASSERT_TRUE(group()->isStreaming());
@@ -994,6 +1001,7 @@ public:
 
         createGroup(fromjson("{_id: {}}"));
         group()->setSource(source.get());
+        group()->allowStreaming();
 
         group()->getNext();
         ASSERT_TRUE(group()->isStreaming());
@@ -1021,6 +1029,7 @@ public:
                     inShard,
                     inRouter);
         group()->setSource(source.get());
+        group()->allowStreaming();
 
         group()->getNext();
         ASSERT_FALSE(group()->isStreaming());
@@ -1048,6 +1057,7 @@ public:
                     inShard,
                     inRouter);
         group()->setSource(source.get());
+        group()->allowStreaming();
 
         group()->getNext();
         ASSERT_FALSE(group()->isStreaming());
@@ -1070,6 +1080,7 @@ public:
 
         createGroup(fromjson("{_id: {$sum: ['$a', '$b']}}"), inShard, inRouter);
         group()->setSource(source.get());
+        group()->allowStreaming();
 
         group()->getNext();
         ASSERT_FALSE(group()->isStreaming());
@@ -1079,6 +1090,137 @@ public:
     }
 };
 
+class StreamingKeepsNullAndMissingIdsApart : public Base {
+public:
+    void run() {
+        // An index orders a missing field as null, so these documents form one run, but a missing
+        // _id field and a null one are different groups.
+        auto source = DocumentSourceMock::create(
+            {"{b: 1}", "{a: null, b: 1}", "{b: 1}", "{a: 1, b: 1}", "{a: 1, b: 1}"});
+        source->sorts = {BSON("a" << 1 << "b" << 1)};
+
+        createGroup(fromjson("{_id: {x: '$a', y: '$b'}, count: {$sum: 1}}"));
+        group()->setSource(source.get());
+        group()->allowStreaming();
+
+        auto res = group()->getNext();
+        ASSERT_TRUE(group()->isStreaming());
+        ASSERT_TRUE(res.isAdvanced());
+        ASSERT_DOCUMENT_EQ(res.getDocument(), Document(fromjson("{_id: {y: 1}, count: 2}")));
+
+        res = group()->getNext();
+        ASSERT_TRUE(res.isAdvanced());
+        ASSERT_DOCUMENT_EQ(res.getDocument(),
+                           Document(fromjson("{_id: {x: null, y: 1}, count: 1}")));
+
+        // The run for {a: 1} has been started but not finished.
+        res = source->getNext();
+        ASSERT_TRUE(res.isAdvanced());
+        ASSERT_DOCUMENT_EQ(res.getDocument(), Document(fromjson("{a: 1, b: 1}")));
+        assertEOF(source);
+
+        res = group()->getNext();
+        ASSERT_TRUE(res.isAdvanced());
+        ASSERT_DOCUMENT_EQ(res.getDocument(), Document(fromjson("{_id: {x: 1, y: 1}, count: 1}")));
+
+        assertEOF(group());
+    }
+};
+
+class StreamingPropagatesPausesWithinARun : public Base {
+public:
+    void run() {
+        auto source =
+            DocumentSourceMock::create({Document{{"a", 1}},
+                                        DocumentSource::GetNextResult::makePauseExecution(),
+                                        Document{{"a", 1}},
+                                        Document{{"a", 2}},
+                                        DocumentSource::GetNextResult::makePauseExecution()});
+        source->sorts = {BSON("a" << 1)};
+
+        createGroup(fromjson("{_id: '$a', count: {$sum: 1}}"));
+        group()->setSource(source.get());
+        group()->allowStreaming();
+
+        ASSERT_TRUE(group()->getNext().isPaused());
+
+        auto res = group()->getNext();
+        ASSERT_TRUE(res.isAdvanced());
+        ASSERT_DOCUMENT_EQ(res.getDocument(), Document(fromjson("{_id: 1, count: 2}")));
+
+        ASSERT_TRUE(group()->getNext().isPaused());
+
+        // The last run is returned at the end of the input.
+        res = group()->getNext();
+        ASSERT_TRUE(res.isAdvanced());
+        ASSERT_DOCUMENT_EQ(res.getDocument(), Document(fromjson("{_id: 2, count: 1}")));
+
+        assertEOF(group());
+    }
+};
+
+class StreamingFailsOnArrayInSortedField : public Base {
+public:
+    void run() {
+        auto source = DocumentSourceMock::create({"{a: 1}", "{a: [1, 2]}"});
+        source->sorts = {BSON("a" << 1)};
+
+        createGroup(BSON("_id"
+                         << "$a"));
+        group()->setSource(source.get());
+        group()->allowStreaming();
+
+        ASSERT_THROWS_CODE(group()->getNext(), UserException, 40631);
+    }
+};
+
+class NoStreamingUnlessAllowed : public Base {
+public:
+    void run() {
+        auto source = DocumentSourceMock::create({"{a: [2, 3]}", "{a: 1}", "{a: [2, 3]}"});
+        source->sorts = {BSON("a" << 1)};
+
+        // We pretend to be in the router so that we don't spill to disk, because this produces
+        // inconsistent output on debug vs. non-debug builds.
+        const bool inRouter = true;
+        const bool inShard = false;
+
+        createGroup(BSON("_id"
+                         << "$a"),
+                    inShard,
+                    inRouter);
+        group()->setSource(source.get());
+
+        auto res = group()->getNext();
+        ASSERT_FALSE(group()->isStreaming());
+        ASSERT_TRUE(res.isAdvanced());
+        ASSERT_VALUE_EQ(res.getDocument().getField("_id"), Value(BSON_ARRAY(2 << 3)));
+    }
+};
+
+class DistinctScanField : public Base {
+public:
+    void run() {
+        createGroup(BSON("_id"
+                         << "$a"));
+        ASSERT_EQ(group()->getDistinctScanField().value_or(""), "a");
+
+        createGroup(BSON("_id"
+                         << "$$ROOT.a"));
+        ASSERT_EQ(group()->getDistinctScanField().value_or(""), "a");
+
+        createGroup(BSON("_id"
+                         << "$a.b"));
+        ASSERT_FALSE(group()->getDistinctScanField());
+
+        createGroup(fromjson("{_id: '$a', first: {$first: '$b'}}"));
+        ASSERT_FALSE(group()->getDistinctScanField());
+
+        createGroup(fromjson("{_id: {a: '$a'}}"));
+        ASSERT_FALSE(group()->getDistinctScanField());
+    }
+};
+
 /**
  * A string constant (not a field path) as an _id expression and passed to an accumulator.
  * SERVER-6766
@@ -1155,8 +1297,6 @@ public:
         add<Dependencies>();
         add<StringConstantIdAndAccumulatorExpressions>();
         add<ArrayConstantAccumulatorExpression>();
-#if 0
-        // Disabled tests until SERVER-23318 is implemented.
         add<StreamingOptimization>();
         add<StreamingWithMultipleIdFields>();
         add<NoOptimizationIfMissingDoubleSort>();
@@ -1168,7 +1308,11 @@ public:
         add<StreamingWithRootSubfield>();
         add<StreamingWithConstantAndFieldPath>();
         add<StreamingWithFieldRepeated>();
-#endif
+        add<StreamingKeepsNullAndMissingIdsApart>();
+        add<StreamingPropagatesPausesWithinARun>();
+        add<StreamingFailsOnArrayInSortedField>();
+        add<NoStreamingUnlessAllowed>();
+        add<DistinctScanField>();
     }
 };
 
@@ -52,6 +52,12 @@ DocumentSource::GetNextResult DocumentSourceIndexStats::getNext() {
     if (_indexStatsMap.empty()) {
         _indexStatsMap = _mongod->getIndexStats(pExpCtx->opCtx, pExpCtx->ns);
         _indexStatsIter = _indexStatsMap.begin();
+
+        BSONObjBuilder cacheStats;
+        if (!_indexStatsMap.empty() &&
+            _mongod->appendCacheStats(pExpCtx->ns, &cacheStats).isOK()) {
+            _indexCacheStats = cacheStats.obj()["indexes"].Obj().getOwned();
+        }
     }
 
     if (_indexStatsIter != _indexStatsMap.end()) {
@@ -62,6 +68,10 @@ DocumentSource::GetNextResult DocumentSourceIndexStats::getNext() {
         doc["host"] = Value(_processName);
         doc["accesses"]["ops"] = Value(stats.accesses.loadRelaxed());
         doc["accesses"]["since"] = Value(stats.trackerStartTime);
+        BSONElement cache = _indexCacheStats[_indexStatsIter->first];
+        if (cache.type() == BSONType::Object) {
+            doc["cache"] = Value(cache.Obj());
+        }
         ++_indexStatsIter;
         return doc.freeze();
     }
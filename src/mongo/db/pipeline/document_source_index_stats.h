@@ -56,6 +56,9 @@ private:
 
     CollectionIndexUsageMap _indexStatsMap;
     CollectionIndexUsageMap::const_iterator _indexStatsIter;
+    // The storage engine cache statistics of each index, by name. Empty if the storage engine does
+    // not report them.
+    BSONObj _indexCacheStats;
     std::string _processName;
 };
 
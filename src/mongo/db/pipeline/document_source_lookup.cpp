@@ -30,6 +30,9 @@
 
 #include "mongo/db/pipeline/document_source_lookup.h"
 
+#include <algorithm>
+#include <cctype>
+
 #include "mongo/base/init.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression_algo.h"
@@ -38,6 +41,7 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/stdx/memory.h"
 
 namespace mongo {
@@ -46,6 +50,11 @@ using boost::intrusive_ptr;
 using std::vector;
 
 namespace {
+
+// Running a query through the query layer costs roughly as much as examining this many documents,
+// on top of the documents the query examines.
+const long long kQueryOverheadDocs = 50;
+
 std::string pipelineToString(const vector<BSONObj>& pipeline) {
     StringBuilder sb;
     sb << "[";
@@ -162,7 +171,8 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
         return unwindResult();
     }
 
-    auto nextInput = pSource->getNext();
+    boost::optional<std::vector<Document>> matches;
+    auto nextInput = getNextInput(&matches);
     if (!nextInput.isAdvanced()) {
         return nextInput;
     }
@@ -172,27 +182,30 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
     // '_unwindSrc' would be non-null, and we would not have made it here.
     invariant(!_matchSrc);
 
-    if (!wasConstructedWithPipelineSyntax()) {
-        auto matchStage =
-            makeMatchStageFromInput(inputDoc, *_localField, _foreignField->fullPath(), BSONObj());
-        // We've already allocated space for the trailing $match stage in '_fromPipeline'.
-        _fromPipeline.back() = matchStage;
-    }
-
-    auto pipeline = uassertStatusOK(_mongod->makePipeline(_fromPipeline, _fromExpCtx));
-
     std::vector<Value> results;
     int objsize = 0;
 
-    while (auto result = pipeline->getNext()) {
-        objsize += result->getApproximateSize();
-        uassert(4568,
-                str::stream() << "Total size of documents in " << _fromNs.coll()
-                              << " matching pipeline "
-                              << getUserPipelineDefinition()
-                              << " exceeds maximum document size",
-                objsize <= BSONObjMaxInternalSize);
-        results.emplace_back(std::move(*result));
+    if (matches) {
+        for (auto&& match : *matches) {
+            objsize += match.getApproximateSize();
+            assertJoinedSizeWithinLimit(objsize);
+            results.emplace_back(std::move(match));
+        }
+    } else {
+        if (!wasConstructedWithPipelineSyntax()) {
+            auto matchStage = makeMatchStageFromInput(
+                inputDoc, *_localField, _foreignField->fullPath(), BSONObj());
+            // We've already allocated space for the trailing $match stage in '_fromPipeline'.
+            _fromPipeline.back() = matchStage;
+        }
+
+        ++_numJoinQueries;
+        auto pipeline = uassertStatusOK(_mongod->makePipeline(_fromPipeline, _fromExpCtx));
+        while (auto result = pipeline->getNext()) {
+            objsize += result->getApproximateSize();
+            assertJoinedSizeWithinLimit(objsize);
+            results.emplace_back(std::move(*result));
+        }
     }
 
     MutableDocument output(std::move(inputDoc));
@@ -200,6 +213,15 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
     return output.freeze();
 }
 
+void DocumentSourceLookUp::assertJoinedSizeWithinLimit(int totalSize) {
+    uassert(4568,
+            str::stream() << "Total size of documents in " << _fromNs.coll()
+                          << " matching pipeline "
+                          << getUserPipelineDefinition()
+                          << " exceeds maximum document size",
+            totalSize <= BSONObjMaxInternalSize);
+}
+
 DocumentSource::GetModPathsReturn DocumentSourceLookUp::getModifiedPaths() const {
     std::set<std::string> modifiedPaths{_as.fullPath()};
     if (_unwindSrc) {
@@ -325,6 +347,329 @@ Pipeline::SourceContainer::iterator DocumentSourceLookUp::doOptimizeAt(
     return itr;
 }
 
+DocumentSourceLookUp::JoinPlan DocumentSourceLookUp::planJoin() const {
+    JoinPlan plan;
+    if (wasConstructedWithPipelineSyntax() || !_mongod) {
+        return plan;
+    }
+
+    // '_fromPipeline' holds a view's pipeline ahead of the placeholder for our $match.
+    if (_fromPipeline.size() > 1) {
+        return plan;
+    }
+
+    // Positional path components traverse arrays in ways that matching by value can't reproduce.
+    for (size_t i = 0; i < _foreignField->getPathLength(); ++i) {
+        auto fieldName = _foreignField->getFieldName(i);
+        auto isDigit = [](char c) { return std::isdigit(static_cast<unsigned char>(c)); };
+        if (std::all_of(fieldName.begin(), fieldName.end(), isDigit)) {
+            return plan;
+        }
+    }
+
+    auto summary = _mongod->getCollectionSummary(_resolvedNs);
+    if (!summary) {
+        return plan;
+    }
+
+    plan.batchSize = std::max(1, internalDocumentSourceLookupBatchSize.load());
+    plan.prepareQueries = internalDocumentSourceLookupPrepareQueries.load();
+
+    if (internalDocumentSourceLookupEnableHashJoin.load() &&
+        summary->dataSizeBytes <= internalDocumentSourceLookupHashJoinMaxMemoryBytes.load()) {
+        const bool foreignFieldIsIndexed = std::any_of(
+            summary->indexKeyPatterns.begin(),
+            summary->indexKeyPatterns.end(),
+            [&](const BSONObj& keyPattern) {
+                return keyPattern.firstElementFieldName() == _foreignField->fullPath();
+            });
+
+        HashJoinCost cost;
+        cost.buildCost = kQueryOverheadDocs + summary->numRecords;
+        cost.queryCost =
+            kQueryOverheadDocs + (foreignFieldIsIndexed ? plan.batchSize : summary->numRecords);
+        plan.hashJoinCost = cost;
+    }
+    return plan;
+}
+
+DocumentSource::GetNextResult DocumentSourceLookUp::getNextInput(
+    boost::optional<std::vector<Document>>* matches) {
+    if (_batch.empty() && !_pendingPause) {
+        maybeBuildHashTable();
+        if (_hashJoinState != HashJoinState::kBuilt && _joinPlan->batchSize > 1) {
+            fillBatch();
+        }
+    }
+
+    if (!_batch.empty()) {
+        auto next = std::move(_batch.front());
+        _batch.pop_front();
+        *matches = std::move(next.matches);
+        return std::move(next.input);
+    }
+
+    if (_pendingPause) {
+        auto pause = std::move(*_pendingPause);
+        _pendingPause = boost::none;
+        return pause;
+    }
+
+    auto nextInput = pSource->getNext();
+    if (!nextInput.isAdvanced()) {
+        return nextInput;
+    }
+    auto inputDoc = nextInput.releaseDocument();
+    *matches = probeHashTable(inputDoc);
+    if (*matches || !_joinPlan->prepareQueries) {
+        return std::move(inputDoc);
+    }
+
+    // Answer the document with the prepared query if it can be answered by value.
+    std::vector<Value> localValues;
+    bool canPrepare = true;
+    document_path_support::visitAllValuesAtPath(
+        inputDoc, *_localField, [&](const Value& nextValue) {
+            localValues.push_back(nextValue);
+            canPrepare = canPrepare && !nextValue.nullish() && !nextValue.isArray() &&
+                nextValue.getType() != BSONType::RegEx;
+        });
+    if (!canPrepare || localValues.empty()) {
+        return std::move(inputDoc);
+    }
+
+    std::vector<Document> preparedMatches;
+    int joinedSize = 0;
+    if (runPreparedQuery(localValues, [&](Document foreignDoc) {
+            joinedSize += foreignDoc.getApproximateSize();
+            assertJoinedSizeWithinLimit(joinedSize);
+            preparedMatches.push_back(std::move(foreignDoc));
+        })) {
+        ++_numJoinQueries;
+        *matches = std::move(preparedMatches);
+    }
+    return std::move(inputDoc);
+}
+
+void DocumentSourceLookUp::maybeBuildHashTable() {
+    if (_hashJoinState == HashJoinState::kUndecided) {
+        _joinPlan = planJoin();
+        _hashJoinState =
+            _joinPlan->hashJoinCost ? HashJoinState::kDeferred : HashJoinState::kUnavailable;
+    }
+
+    if (_hashJoinState == HashJoinState::kDeferred &&
+        _numJoinQueries >= _joinPlan->hashJoinCost->queriesBeforeBuild()) {
+        _hashJoinState = buildHashTable() ? HashJoinState::kBuilt : HashJoinState::kUnavailable;
+    }
+}
+
+boost::optional<std::vector<Document>> DocumentSourceLookUp::probeHashTable(
+    const Document& input) {
+    if (_hashJoinState != HashJoinState::kBuilt) {
+        return boost::none;
+    }
+
+    std::vector<Value> localValues;
+    bool canProbe = true;
+    document_path_support::visitAllValuesAtPath(input, *_localField, [&](const Value& nextValue) {
+        localValues.push_back(nextValue);
+        canProbe = canProbe && !nextValue.nullish() && !nextValue.isArray();
+    });
+
+    if (!canProbe || localValues.empty()) {
+        return boost::none;
+    }
+
+    std::vector<size_t> matchIndices;
+    for (auto&& localValue : localValues) {
+        auto it = _hashTable->find(localValue);
+        if (it != _hashTable->end()) {
+            matchIndices.insert(matchIndices.end(), it->second.begin(), it->second.end());
+        }
+    }
+
+    if (localValues.size() > 1) {
+        // A foreign document matching several of the local values is only joined once.
+        std::sort(matchIndices.begin(), matchIndices.end());
+        matchIndices.erase(std::unique(matchIndices.begin(), matchIndices.end()),
+                           matchIndices.end());
+    }
+
+    std::vector<Document> matches;
+    matches.reserve(matchIndices.size());
+    for (auto&& index : matchIndices) {
+        matches.push_back(_hashJoinDocs[index]);
+    }
+    return matches;
+}
+
+void DocumentSourceLookUp::fillBatch() {
+    invariant(_batch.empty());
+
+    // Which of the batched inputs hold each local value that can be queried by value.
+    auto inputsByValue =
+        _fromExpCtx->getValueComparator().makeUnorderedValueMap<std::vector<size_t>>();
+
+    while (_batch.size() < static_cast<size_t>(_joinPlan->batchSize)) {
+        auto nextInput = pSource->getNext();
+        if (nextInput.isPaused()) {
+            _pendingPause = std::move(nextInput);
+            break;
+        }
+        if (!nextInput.isAdvanced()) {
+            break;
+        }
+
+        const size_t inputIndex = _batch.size();
+        _batch.push_back({nextInput.releaseDocument(), boost::none});
+
+        std::vector<Value> localValues;
+        bool canBatch = true;
+        document_path_support::visitAllValuesAtPath(
+            _batch.back().input, *_localField, [&](const Value& nextValue) {
+                localValues.push_back(nextValue);
+                canBatch = canBatch && !nextValue.nullish() && !nextValue.isArray() &&
+                    nextValue.getType() != BSONType::RegEx;
+            });
+        if (!canBatch || localValues.empty()) {
+            continue;
+        }
+
+        _batch.back().matches.emplace();
+        for (auto&& localValue : localValues) {
+            auto& inputsWithValue = inputsByValue[localValue];
+            if (inputsWithValue.empty() || inputsWithValue.back() != inputIndex) {
+                inputsWithValue.push_back(inputIndex);
+            }
+        }
+    }
+
+    if (inputsByValue.empty()) {
+        return;
+    }
+
+    // Scatter each foreign document to every batched input holding one of its foreign values, once
+    // per input even if it holds several of them.
+    std::vector<long long> lastJoinedDoc(_batch.size(), -1);
+    std::vector<int> joinedSize(_batch.size(), 0);
+    long long docNumber = 0;
+    auto scatter = [&](const Document& foreignDoc) {
+        document_path_support::visitAllValuesAtPath(
+            foreignDoc, *_foreignField, [&](const Value& foreignValue) {
+                auto it = inputsByValue.find(foreignValue);
+                if (it == inputsByValue.end()) {
+                    return;
+                }
+                for (auto&& inputIndex : it->second) {
+                    if (lastJoinedDoc[inputIndex] == docNumber) {
+                        continue;
+                    }
+                    lastJoinedDoc[inputIndex] = docNumber;
+                    joinedSize[inputIndex] += foreignDoc.getApproximateSize();
+                    assertJoinedSizeWithinLimit(joinedSize[inputIndex]);
+                    _batch[inputIndex].matches->push_back(foreignDoc);
+                }
+            });
+        ++docNumber;
+    };
+
+    ++_numJoinQueries;
+
+    std::vector<Value> values;
+    values.reserve(inputsByValue.size());
+    for (auto&& entry : inputsByValue) {
+        values.push_back(entry.first);
+    }
+    if (runPreparedQuery(values, scatter)) {
+        return;
+    }
+
+    // Query for all of the batched values at once:
+    //   {$and: [{<foreignFieldName>: {$in: [<value>, <value>, ...]}}, <additionalFilter>]}
+    BSONObjBuilder match;
+    {
+        BSONObjBuilder query(match.subobjStart("$match"));
+        BSONArrayBuilder andObj(query.subarrayStart("$and"));
+        {
+            BSONObjBuilder joiningObj(andObj.subobjStart());
+            BSONObjBuilder inObj(joiningObj.subobjStart(_foreignField->fullPath()));
+            BSONArrayBuilder values(inObj.subarrayStart("$in"));
+            for (auto&& entry : inputsByValue) {
+                values << entry.first;
+            }
+        }
+        andObj << _additionalFilter.value_or(BSONObj());
+    }
+    _fromPipeline.back() = match.obj();
+
+    auto pipeline = uassertStatusOK(_mongod->makePipeline(_fromPipeline, _fromExpCtx));
+    while (auto foreignDoc = pipeline->getNext()) {
+        scatter(*foreignDoc);
+    }
+}
+
+bool DocumentSourceLookUp::runPreparedQuery(const std::vector<Value>& values,
+                                            const stdx::function<void(Document)>& onMatch) {
+    if (!_joinPlan->prepareQueries) {
+        return false;
+    }
+
+    if (!_preparedQuery) {
+        _preparedQuery = _mongod->prepareEqualityQuery(_resolvedNs,
+                                                       _foreignField->fullPath(),
+                                                       _additionalFilter.value_or(BSONObj()),
+                                                       _fromExpCtx);
+        if (!_preparedQuery) {
+            _joinPlan->prepareQueries = false;
+            return false;
+        }
+    }
+    return _preparedQuery->execute(values, onMatch);
+}
+
+bool DocumentSourceLookUp::buildHashTable() {
+    std::vector<BSONObj> buildPipeline;
+    if (_additionalFilter) {
+        buildPipeline.push_back(BSON("$match" << *_additionalFilter));
+    }
+    auto pipeline = uassertStatusOK(_mongod->makePipeline(buildPipeline, _fromExpCtx));
+
+    const long long maxMemoryBytes = internalDocumentSourceLookupHashJoinMaxMemoryBytes.load();
+    long long memoryBytes = 0;
+
+    _hashTable = _fromExpCtx->getValueComparator().makeUnorderedValueMap<std::vector<size_t>>();
+    while (auto foreignDoc = pipeline->getNext()) {
+        memoryBytes += foreignDoc->getApproximateSize();
+        if (memoryBytes > maxMemoryBytes) {
+            _hashJoinDocs.clear();
+            _hashTable = boost::none;
+            return false;
+        }
+
+        const size_t index = _hashJoinDocs.size();
+        document_path_support::visitAllValuesAtPath(
+            *foreignDoc, *_foreignField, [&](const Value& foreignValue) {
+                auto& docsWithValue = (*_hashTable)[foreignValue];
+                if (docsWithValue.empty() || docsWithValue.back() != index) {
+                    docsWithValue.push_back(index);
+                }
+            });
+        _hashJoinDocs.push_back(std::move(*foreignDoc));
+    }
+    return true;
+}
+
+boost::optional<Document> DocumentSourceLookUp::nextUnwindMatch() {
+    if (_pipeline) {
+        return _pipeline->getNext();
+    }
+    if (_unwindMatchIndex < _unwindMatches.size()) {
+        return _unwindMatches[_unwindMatchIndex++];
+    }
+    return boost::none;
+}
+
 std::string DocumentSourceLookUp::getUserPipelineDefinition() {
     if (wasConstructedWithPipelineSyntax()) {
         return pipelineToString(_userPipeline);
@@ -338,6 +683,10 @@ void DocumentSourceLookUp::doDispose() {
         _pipeline->dispose(pExpCtx->opCtx);
         _pipeline.reset();
     }
+    _hashJoinDocs.clear();
+    _hashTable = boost::none;
+    _batch.clear();
+    _preparedQuery.reset();
 }
 
 BSONObj DocumentSourceLookUp::makeMatchStageFromInput(const Document& input,
@@ -430,34 +779,43 @@ DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
     // Loop until we get a document that has at least one match.
     // Note we may return early from this loop if our source stage is exhausted or if the unwind
     // source was asked to return empty arrays and we get a document without a match.
-    while (!_pipeline || !_nextValue) {
-        auto nextInput = pSource->getNext();
+    while (!_nextValue) {
+        boost::optional<std::vector<Document>> matches;
+        auto nextInput = getNextInput(&matches);
         if (!nextInput.isAdvanced()) {
             return nextInput;
         }
 
         _input = nextInput.releaseDocument();
 
-        if (!wasConstructedWithPipelineSyntax()) {
-            BSONObj filter = _additionalFilter.value_or(BSONObj());
-            auto matchStage =
-                makeMatchStageFromInput(*_input, *_localField, _foreignField->fullPath(), filter);
-            // We've already allocated space for the trailing $match stage in '_fromPipeline'.
-            _fromPipeline.back() = matchStage;
-        }
-
         if (_pipeline) {
             _pipeline->dispose(pExpCtx->opCtx);
+            _pipeline.reset();
         }
-        _pipeline = uassertStatusOK(_mongod->makePipeline(_fromPipeline, _fromExpCtx));
 
-        // The $lookup stage takes responsibility for disposing of its Pipeline, since it will
-        // potentially be used by multiple OperationContexts, and the $lookup stage is part of an
-        // outer Pipeline that will propagate dispose() calls before being destroyed.
-        _pipeline.get_deleter().dismissDisposal();
+        if (matches) {
+            _unwindMatches = std::move(*matches);
+            _unwindMatchIndex = 0;
+        } else {
+            if (!wasConstructedWithPipelineSyntax()) {
+                BSONObj filter = _additionalFilter.value_or(BSONObj());
+                auto matchStage = makeMatchStageFromInput(
+                    *_input, *_localField, _foreignField->fullPath(), filter);
+                // We've already allocated space for the trailing $match stage in '_fromPipeline'.
+                _fromPipeline.back() = matchStage;
+            }
+
+            ++_numJoinQueries;
+            _pipeline = uassertStatusOK(_mongod->makePipeline(_fromPipeline, _fromExpCtx));
+
+            // The $lookup stage takes responsibility for disposing of its Pipeline, since it will
+            // potentially be used by multiple OperationContexts, and the $lookup stage is part of
+            // an outer Pipeline that will propagate dispose() calls before being destroyed.
+            _pipeline.get_deleter().dismissDisposal();
+        }
 
         _cursorIndex = 0;
-        _nextValue = _pipeline->getNext();
+        _nextValue = nextUnwindMatch();
 
         if (_unwindSrc->preserveNullAndEmptyArrays() && !_nextValue) {
             // There were no results for this cursor, but the $unwind was asked to preserve empty
@@ -475,7 +833,7 @@ DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
 
     invariant(bool(_input) && bool(_nextValue));
     auto currentValue = *_nextValue;
-    _nextValue = _pipeline->getNext();
+    _nextValue = nextUnwindMatch();
 
     // Move input document into output if this is the last or only result, otherwise perform a copy.
     MutableDocument output(_nextValue ? *_input : std::move(*_input));
@@ -525,6 +883,24 @@ void DocumentSourceLookUp::serializeToArray(
             output[getSourceName()]["matching"] = Value(*_additionalFilter);
         }
 
+        if (!wasConstructedWithPipelineSyntax()) {
+            // Report how joins are being answered: how many input documents each query of the
+            // foreign collection covers, and if a hash join is possible but not yet built, after
+            // how many queries it will be.
+            const bool built = _hashJoinState == HashJoinState::kBuilt;
+            output[getSourceName()]["strategy"] = Value(built ? "hashJoin"_sd : "nestedLoop"_sd);
+            auto plan = _joinPlan ? *_joinPlan : planJoin();
+            if (!built && plan.batchSize > 1) {
+                output[getSourceName()]["batchSize"] = Value(plan.batchSize);
+            }
+            if ((_hashJoinState == HashJoinState::kDeferred ||
+                 _hashJoinState == HashJoinState::kUndecided) &&
+                plan.hashJoinCost) {
+                output[getSourceName()]["hashJoinAfterQueries"] =
+                    Value(plan.hashJoinCost->queriesBeforeBuild());
+            }
+        }
+
         array.push_back(Value(output.freeze()));
     } else {
         array.push_back(Value(output.freeze()));
@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <deque>
+
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_match.h"
 #include "mongo/db/pipeline/document_source_unwind.h"
@@ -62,6 +64,14 @@ public:
         return true;
     }
 
+    /**
+     * Each input document produces exactly one output document unless we have absorbed an
+     * $unwind.
+     */
+    bool canSwapWithSkipOrLimit() const final {
+        return !_unwindSrc;
+    }
+
     GetDepsReturn getDependencies(DepsTracker* deps) const final;
 
     BSONObjSet getOutputSorts() final {
@@ -162,6 +172,102 @@ private:
 
     GetNextResult unwindResult();
 
+    /**
+     * Estimated costs of the two ways of answering a localField/foreignField join, in units of
+     * documents examined.
+     */
+    struct HashJoinCost {
+        // Reading the whole foreign collection once to build a hash table.
+        long long buildCost;
+
+        // Querying the foreign collection for a single input document.
+        long long queryCost;
+
+        /**
+         * Returns how many queries must have been run before building the hash table is expected to
+         * pay off. Deferring the build until then bounds the total cost at twice that of the better
+         * strategy without knowing how many input documents there will be.
+         */
+        long long queriesBeforeBuild() const {
+            return (buildCost + queryCost - 1) / queryCost;
+        }
+    };
+
+    /**
+     * How joins specified with localField/foreignField are answered, decided before the first.
+     */
+    struct JoinPlan {
+        // The estimated cost of a hash join, or boost::none if one isn't possible.
+        boost::optional<HashJoinCost> hashJoinCost;
+
+        // How many input documents each query of the foreign collection answers.
+        long long batchSize = 1;
+
+        // Whether to try running those queries through a query prepared once for all of them.
+        bool prepareQueries = false;
+    };
+
+    /**
+     * Decides how to answer this stage's joins. Neither hash joins nor batched queries are used
+     * with pipeline syntax or against a view.
+     */
+    JoinPlan planJoin() const;
+
+    /**
+     * Returns the next input document. If its matches are already known, from the hash table, a
+     * batched query or the prepared query, sets '*matches' to them. Otherwise leaves '*matches'
+     * unset, and the caller must query the foreign collection for the document.
+     */
+    GetNextResult getNextInput(boost::optional<std::vector<Document>>* matches);
+
+    /**
+     * Builds the hash table once the queries run so far have cost as much as building it is
+     * estimated to, if a hash join is possible.
+     */
+    void maybeBuildHashTable();
+
+    /**
+     * Returns the foreign documents that join with 'input' from the hash table, in the order in
+     * which they were read, or boost::none if the hash table isn't built or can't answer 'input'.
+     *
+     * Inputs whose local field is null, missing or holds nested arrays can never be answered by
+     * value, as their match semantics depend on more than equality of values. Neither can those
+     * holding regular expressions when batching, since $in pattern-matches them.
+     */
+    boost::optional<std::vector<Document>> probeHashTable(const Document& input);
+
+    /**
+     * Reads up to the planned batch size of input documents into '_batch', and answers all of
+     * those that can be answered by value with a single $in query of the foreign collection.
+     */
+    void fillBatch();
+
+    /**
+     * Calls 'onMatch' with each foreign document holding any of 'values' at the foreign field, and
+     * matching '_additionalFilter', using '_preparedQuery'. Returns false without calling 'onMatch'
+     * if the join plan doesn't prepare queries or the prepared query can't answer 'values'.
+     */
+    bool runPreparedQuery(const std::vector<Value>& values,
+                          const stdx::function<void(Document)>& onMatch);
+
+    /**
+     * Reads the foreign collection into '_hashJoinDocs' and '_hashTable', keyed on every value of
+     * the foreign field. Returns false, leaving both empty, if that would use more than
+     * internalDocumentSourceLookupHashJoinMaxMemoryBytes.
+     */
+    bool buildHashTable();
+
+    /**
+     * Returns the next foreign document that joins with '_input' while unwinding, either from
+     * '_pipeline' or from '_unwindMatches'.
+     */
+    boost::optional<Document> nextUnwindMatch();
+
+    /**
+     * Throws if 'totalSize' bytes of foreign documents are too many to join with one document.
+     */
+    void assertJoinedSizeWithinLimit(int totalSize);
+
     /**
      * The pipeline supplied via the $lookup 'pipeline' argument. This may differ from pipeline that
      * is executed in that it will not include optimizations or resolved views.
@@ -196,6 +302,42 @@ private:
     std::unique_ptr<Pipeline, Pipeline::Deleter> _pipeline;
     boost::optional<Document> _input;
     boost::optional<Document> _nextValue;
+
+    // Whether joins are answered by querying the foreign collection or by probing a hash table
+    // built from it. Starts undecided, and becomes deferred once '_joinPlan' is set and a hash join
+    // is possible but not yet worth building.
+    enum class HashJoinState { kUndecided, kDeferred, kUnavailable, kBuilt };
+    HashJoinState _hashJoinState = HashJoinState::kUndecided;
+
+    // Set once '_hashJoinState' is no longer kUndecided.
+    boost::optional<JoinPlan> _joinPlan;
+
+    // How many times the foreign collection has been queried to answer joins.
+    long long _numJoinQueries = 0;
+
+    // When '_hashJoinState' is kBuilt, every document read from the foreign collection, and a map
+    // from each value of the foreign field to the indices of the documents holding it.
+    std::vector<Document> _hashJoinDocs;
+    boost::optional<ValueUnorderedMap<std::vector<size_t>>> _hashTable;
+
+    // Input documents read ahead to be answered by a batched query, with their matches if the
+    // batched query could answer them.
+    struct BatchedInput {
+        Document input;
+        boost::optional<std::vector<Document>> matches;
+    };
+    std::deque<BatchedInput> _batch;
+
+    // Answers queries by value for the same foreign field and filter without planning each of
+    // them, once '_joinPlan' allows it.
+    std::unique_ptr<MongodInterface::PreparedEqualityQuery> _preparedQuery;
+
+    // A pause read from our source while filling '_batch', to return once '_batch' is drained.
+    boost::optional<GetNextResult> _pendingPause;
+
+    // The already known matches for '_input' while unwinding, and the next to return.
+    std::vector<Document> _unwindMatches;
+    size_t _unwindMatchIndex = 0;
 };
 
 }  // namespace mongo
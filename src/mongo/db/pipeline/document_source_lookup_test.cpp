@@ -38,11 +38,14 @@
 #include "mongo/db/pipeline/aggregation_context_fixture.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/document_source_lookup.h"
+#include "mongo/db/pipeline/document_path_support.h"
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
 #include "mongo/db/pipeline/field_path.h"
 #include "mongo/db/pipeline/stub_mongod_interface.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -245,18 +248,74 @@ TEST(MakeMatchStageFromInput, ArrayValueWithRegexUsesOrQuery) {
 // Execution tests.
 //
 
+/**
+ * A mock prepared query, which answers from the mocked foreign documents holding a value given to
+ * it at 'fieldName', and refuses to answer values it has been told to.
+ */
+class MockPreparedEqualityQuery final
+    : public DocumentSourceNeedsMongod::MongodInterface::PreparedEqualityQuery {
+public:
+    MockPreparedEqualityQuery(const deque<DocumentSource::GetNextResult>& mockResults,
+                              FieldPath fieldName,
+                              const vector<Value>& refusedValues,
+                              int* numExecutions)
+        : _mockResults(mockResults),
+          _fieldName(std::move(fieldName)),
+          _refusedValues(refusedValues),
+          _numExecutions(numExecutions) {}
+
+    bool execute(const std::vector<Value>& values,
+                 const stdx::function<void(Document)>& onMatch) final {
+        const ValueComparator comparator;
+        for (auto&& value : values) {
+            for (auto&& refused : _refusedValues) {
+                if (comparator.evaluate(value == refused)) {
+                    return false;
+                }
+            }
+        }
+
+        ++*_numExecutions;
+        for (auto&& result : _mockResults) {
+            const Document foreignDoc = result.getDocument();
+            bool matches = false;
+            document_path_support::visitAllValuesAtPath(
+                foreignDoc, _fieldName, [&](const Value& foreignValue) {
+                    for (auto&& value : values) {
+                        matches = matches || comparator.evaluate(foreignValue == value);
+                    }
+                });
+            if (matches) {
+                onMatch(foreignDoc);
+            }
+        }
+        return true;
+    }
+
+private:
+    const deque<DocumentSource::GetNextResult>& _mockResults;
+    const FieldPath _fieldName;
+    const vector<Value>& _refusedValues;
+    int* _numExecutions;
+};
+
 /**
  * A mock MongodInterface which allows mocking a foreign pipeline.
  */
 class MockMongodInterface final : public StubMongodInterface {
 public:
-    MockMongodInterface(deque<DocumentSource::GetNextResult> mockResults)
-        : _mockResults(std::move(mockResults)) {}
+    MockMongodInterface(deque<DocumentSource::GetNextResult> mockResults,
+                        boost::optional<CollectionSummary> summary = boost::none)
+        : _mockResults(std::move(mockResults)), _summary(std::move(summary)) {}
 
     bool isSharded(const NamespaceString& ns) final {
         return false;
     }
 
+    boost::optional<CollectionSummary> getCollectionSummary(const NamespaceString& nss) final {
+        return _summary;
+    }
+
     StatusWith<std::unique_ptr<Pipeline, Pipeline::Deleter>> makePipeline(
         const std::vector<BSONObj>& rawPipeline,
         const boost::intrusive_ptr<ExpressionContext>& expCtx) final {
@@ -268,11 +327,46 @@ public:
         pipeline.getValue()->addInitialSource(DocumentSourceMock::create(_mockResults));
         pipeline.getValue()->optimizePipeline();
 
+        ++_numPipelinesMade;
         return pipeline;
     }
 
+    std::unique_ptr<PreparedEqualityQuery> prepareEqualityQuery(
+        const NamespaceString& nss,
+        const std::string& fieldName,
+        const BSONObj& filter,
+        const boost::intrusive_ptr<ExpressionContext>& expCtx) final {
+        if (!_preparesQueries) {
+            return nullptr;
+        }
+        return stdx::make_unique<MockPreparedEqualityQuery>(
+            _mockResults, FieldPath(fieldName), _refusedValues, &_numPreparedExecutions);
+    }
+
+    /**
+     * Makes prepareEqualityQuery() return queries which refuse to answer 'refusedValues'.
+     */
+    void preparesQueries(vector<Value> refusedValues) {
+        _preparesQueries = true;
+        _refusedValues = std::move(refusedValues);
+    }
+
+    int numPipelinesMade() const {
+        return _numPipelinesMade;
+    }
+
+    int numPreparedExecutions() const {
+        return _numPreparedExecutions;
+    }
+
 private:
     deque<DocumentSource::GetNextResult> _mockResults;
+    boost::optional<CollectionSummary> _summary;
+    int _numPipelinesMade = 0;
+
+    bool _preparesQueries = false;
+    vector<Value> _refusedValues;
+    int _numPreparedExecutions = 0;
 };
 
 TEST_F(DocumentSourceLookUpTest, ShouldPropagatePauses) {
@@ -429,5 +523,305 @@ TEST_F(DocumentSourceLookUpTest, LookupReportsFieldsModifiedByAbsorbedUnwind) {
     lookup->dispose();
 }
 
+using CollectionSummary = DocumentSourceNeedsMongod::MongodInterface::CollectionSummary;
+
+/**
+ * Returns a summary of an unindexed collection holding 'numRecords' documents, which makes
+ * $lookup build a hash table after querying it once.
+ */
+CollectionSummary unindexedSummary(long long numRecords) {
+    CollectionSummary summary;
+    summary.numRecords = numRecords;
+    summary.dataSizeBytes = numRecords * 32;
+    return summary;
+}
+
+/**
+ * Returns a summary of a large collection indexed on 'a', for which $lookup keeps querying the
+ * index rather than building a hash table.
+ */
+CollectionSummary indexedSummary() {
+    CollectionSummary summary;
+    summary.numRecords = 1000 * 1000;
+    summary.dataSizeBytes = summary.numRecords * 32;
+    summary.indexKeyPatterns.push_back(BSON("a" << 1));
+    return summary;
+}
+
+Value getExplainedLookup(DocumentSourceLookUp* lookup) {
+    vector<Value> explainedStages;
+    lookup->serializeToArray(explainedStages, ExplainOptions::Verbosity::kQueryPlanner);
+    ASSERT_EQ(1U, explainedStages.size());
+    return explainedStages[0]["$lookup"];
+}
+
+TEST_F(DocumentSourceLookUpTest, HashJoinReturnsSameMatchesAsQueries) {
+    // Query for one input document at a time, so that the hash table is built after the first.
+    const int originalBatchSize = internalDocumentSourceLookupBatchSize.load();
+    internalDocumentSourceLookupBatchSize.store(1);
+    ON_BLOCK_EXIT([&] { internalDocumentSourceLookupBatchSize.store(originalBatchSize); });
+
+    auto expCtx = getExpCtx();
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespace(fromNs, {fromNs, std::vector<BSONObj>{}});
+
+    auto lookupSpec = Document{{"$lookup",
+                                Document{{"from", fromNs.coll()},
+                                         {"localField", "x"_sd},
+                                         {"foreignField", "a"_sd},
+                                         {"as", "joined"_sd}}}}
+                          .toBson();
+    auto parsed = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+    auto lookup = static_cast<DocumentSourceLookUp*>(parsed.get());
+
+    auto mockLocalSource =
+        DocumentSourceMock::create({Document{{"x", 1}},
+                                    Document{{"x", 2}},
+                                    Document{{"x", vector<Value>{Value(1), Value(3)}}},
+                                    Document{{"x", BSONNULL}},
+                                    Document{{"x", 5}}});
+    lookup->setSource(mockLocalSource.get());
+
+    const Document foreign0{{"_id", 0}, {"a", 1}};
+    const Document foreign1{{"_id", 1}, {"a", vector<Value>{Value(1), Value(2)}}};
+    const Document foreign2{{"_id", 2}, {"a", 3}};
+    const Document foreign3{{"_id", 3}};
+    deque<DocumentSource::GetNextResult> mockForeignContents;
+    for (auto&& doc : {foreign0, foreign1, foreign2, foreign3}) {
+        mockForeignContents.emplace_back(Document(doc));
+    }
+    lookup->injectMongodInterface(std::make_shared<MockMongodInterface>(
+        std::move(mockForeignContents), unindexedSummary(4)));
+
+    auto explained = getExplainedLookup(lookup);
+    ASSERT_VALUE_EQ(Value("nestedLoop"_sd), explained["strategy"]);
+    ASSERT_VALUE_EQ(Value(1LL), explained["hashJoinAfterQueries"]);
+
+    auto expectJoined = [&](vector<Value> expected) {
+        auto next = lookup->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+        ASSERT_VALUE_EQ(Value(expected), next.releaseDocument()["joined"]);
+    };
+
+    // The first document is answered by a query, and the rest from the hash table, except for the
+    // null one, which must also match the foreign document missing the field.
+    expectJoined({Value(foreign0), Value(foreign1)});
+    expectJoined({Value(foreign1)});
+    expectJoined({Value(foreign0), Value(foreign1), Value(foreign2)});
+    expectJoined({Value(foreign3)});
+    expectJoined({});
+    ASSERT_TRUE(lookup->getNext().isEOF());
+
+    explained = getExplainedLookup(lookup);
+    ASSERT_VALUE_EQ(Value("hashJoin"_sd), explained["strategy"]);
+    ASSERT_TRUE(explained["hashJoinAfterQueries"].missing());
+    lookup->dispose();
+}
+
+TEST_F(DocumentSourceLookUpTest, HashJoinReturnsSameMatchesAsQueriesWhileUnwinding) {
+    // Query for one input document at a time, so that the hash table is built after the first.
+    const int originalBatchSize = internalDocumentSourceLookupBatchSize.load();
+    internalDocumentSourceLookupBatchSize.store(1);
+    ON_BLOCK_EXIT([&] { internalDocumentSourceLookupBatchSize.store(originalBatchSize); });
+
+    auto expCtx = getExpCtx();
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespace(fromNs, {fromNs, std::vector<BSONObj>{}});
+
+    auto lookupSpec = Document{{"$lookup",
+                                Document{{"from", fromNs.coll()},
+                                         {"localField", "x"_sd},
+                                         {"foreignField", "a"_sd},
+                                         {"as", "joined"_sd}}}}
+                          .toBson();
+    auto parsed = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+    auto lookup = static_cast<DocumentSourceLookUp*>(parsed.get());
+
+    const bool preserveNullAndEmptyArrays = true;
+    const boost::optional<std::string> includeArrayIndex = std::string("index");
+    lookup->setUnwindStage(DocumentSourceUnwind::create(
+        expCtx, "joined", preserveNullAndEmptyArrays, includeArrayIndex));
+
+    auto mockLocalSource =
+        DocumentSourceMock::create({Document{{"x", 2}}, Document{{"x", 1}}, Document{{"x", 5}}});
+    lookup->setSource(mockLocalSource.get());
+
+    const Document foreign0{{"_id", 0}, {"a", 1}};
+    const Document foreign1{{"_id", 1}, {"a", vector<Value>{Value(1), Value(2)}}};
+    deque<DocumentSource::GetNextResult> mockForeignContents;
+    for (auto&& doc : {foreign0, foreign1}) {
+        mockForeignContents.emplace_back(Document(doc));
+    }
+    lookup->injectMongodInterface(std::make_shared<MockMongodInterface>(
+        std::move(mockForeignContents), unindexedSummary(2)));
+
+    auto expectNext = [&](Document expected) {
+        auto next = lookup->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+        ASSERT_DOCUMENT_EQ(expected, next.releaseDocument());
+    };
+
+    expectNext(Document{{"x", 2}, {"joined", foreign1}, {"index", 0LL}});
+    expectNext(Document{{"x", 1}, {"joined", foreign0}, {"index", 0LL}});
+    expectNext(Document{{"x", 1}, {"joined", foreign1}, {"index", 1LL}});
+    expectNext(Document{{"x", 5}, {"index", BSONNULL}});
+    ASSERT_TRUE(lookup->getNext().isEOF());
+
+    ASSERT_VALUE_EQ(Value("hashJoin"_sd), getExplainedLookup(lookup)["strategy"]);
+    lookup->dispose();
+}
+
+TEST_F(DocumentSourceLookUpTest, BatchedQueriesReturnSameMatchesAsSingleQueries) {
+    auto expCtx = getExpCtx();
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespace(fromNs, {fromNs, std::vector<BSONObj>{}});
+
+    auto lookupSpec = Document{{"$lookup",
+                                Document{{"from", fromNs.coll()},
+                                         {"localField", "x"_sd},
+                                         {"foreignField", "a"_sd},
+                                         {"as", "joined"_sd}}}}
+                          .toBson();
+    auto parsed = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+    auto lookup = static_cast<DocumentSourceLookUp*>(parsed.get());
+
+    // The pause ends the first batch early, and the null input is queried on its own.
+    auto mockLocalSource =
+        DocumentSourceMock::create({Document{{"x", 1}},
+                                    Document{{"x", vector<Value>{Value(1), Value(2)}}},
+                                    Document{{"x", BSONNULL}},
+                                    Document{{"x", 1}},
+                                    DocumentSource::GetNextResult::makePauseExecution(),
+                                    Document{{"x", 3}}});
+    lookup->setSource(mockLocalSource.get());
+
+    const Document foreign0{{"_id", 0}, {"a", 1}};
+    const Document foreign1{{"_id", 1}, {"a", vector<Value>{Value(1), Value(2)}}};
+    const Document foreign2{{"_id", 2}, {"a", 3}};
+    const Document foreign3{{"_id", 3}};
+    deque<DocumentSource::GetNextResult> mockForeignContents;
+    for (auto&& doc : {foreign0, foreign1, foreign2, foreign3}) {
+        mockForeignContents.emplace_back(Document(doc));
+    }
+    auto mongod =
+        std::make_shared<MockMongodInterface>(std::move(mockForeignContents), indexedSummary());
+    lookup->injectMongodInterface(mongod);
+
+    auto explained = getExplainedLookup(lookup);
+    ASSERT_VALUE_EQ(Value("nestedLoop"_sd), explained["strategy"]);
+    ASSERT_VALUE_EQ(Value(static_cast<long long>(internalDocumentSourceLookupBatchSize.load())),
+                    explained["batchSize"]);
+
+    auto expectJoined = [&](vector<Value> expected) {
+        auto next = lookup->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+        ASSERT_VALUE_EQ(Value(expected), next.releaseDocument()["joined"]);
+    };
+
+    expectJoined({Value(foreign0), Value(foreign1)});
+    expectJoined({Value(foreign0), Value(foreign1)});
+    expectJoined({Value(foreign3)});
+    expectJoined({Value(foreign0), Value(foreign1)});
+    ASSERT_TRUE(lookup->getNext().isPaused());
+    expectJoined({Value(foreign2)});
+    ASSERT_TRUE(lookup->getNext().isEOF());
+
+    // One query for each batch, and one for the null input.
+    ASSERT_EQ(3, mongod->numPipelinesMade());
+    lookup->dispose();
+}
+
+TEST_F(DocumentSourceLookUpTest, PreparedQueriesReturnSameMatchesAsPipelines) {
+    auto expCtx = getExpCtx();
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespace(fromNs, {fromNs, std::vector<BSONObj>{}});
+
+    auto lookupSpec = Document{{"$lookup",
+                                Document{{"from", fromNs.coll()},
+                                         {"localField", "x"_sd},
+                                         {"foreignField", "a"_sd},
+                                         {"as", "joined"_sd}}}}
+                          .toBson();
+    auto parsed = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+    auto lookup = static_cast<DocumentSourceLookUp*>(parsed.get());
+
+    // The pause ends the first batch early, the null input is queried on its own, and the batch
+    // holding the refused value falls back to a pipeline.
+    auto mockLocalSource =
+        DocumentSourceMock::create({Document{{"x", 1}},
+                                    Document{{"x", vector<Value>{Value(1), Value(2)}}},
+                                    Document{{"x", BSONNULL}},
+                                    DocumentSource::GetNextResult::makePauseExecution(),
+                                    Document{{"x", 3}},
+                                    DocumentSource::GetNextResult::makePauseExecution(),
+                                    Document{{"x", 4}}});
+    lookup->setSource(mockLocalSource.get());
+
+    const Document foreign0{{"_id", 0}, {"a", 1}};
+    const Document foreign1{{"_id", 1}, {"a", vector<Value>{Value(1), Value(2)}}};
+    const Document foreign2{{"_id", 2}, {"a", 3}};
+    const Document foreign3{{"_id", 3}};
+    const Document foreign4{{"_id", 4}, {"a", 4}};
+    deque<DocumentSource::GetNextResult> mockForeignContents;
+    for (auto&& doc : {foreign0, foreign1, foreign2, foreign3, foreign4}) {
+        mockForeignContents.emplace_back(Document(doc));
+    }
+    auto mongod =
+        std::make_shared<MockMongodInterface>(std::move(mockForeignContents), indexedSummary());
+    mongod->preparesQueries({Value(4)});
+    lookup->injectMongodInterface(mongod);
+
+    auto expectJoined = [&](vector<Value> expected) {
+        auto next = lookup->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+        ASSERT_VALUE_EQ(Value(expected), next.releaseDocument()["joined"]);
+    };
+
+    expectJoined({Value(foreign0), Value(foreign1)});
+    expectJoined({Value(foreign0), Value(foreign1)});
+    expectJoined({Value(foreign3)});
+    ASSERT_TRUE(lookup->getNext().isPaused());
+    expectJoined({Value(foreign2)});
+    ASSERT_TRUE(lookup->getNext().isPaused());
+    expectJoined({Value(foreign4)});
+    ASSERT_TRUE(lookup->getNext().isEOF());
+
+    // The first two batches are answered by the prepared query, and the rest by pipelines.
+    ASSERT_EQ(2, mongod->numPreparedExecutions());
+    ASSERT_EQ(2, mongod->numPipelinesMade());
+    lookup->dispose();
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldNotHashJoinWhenForeignCollectionIsUnknown) {
+    auto expCtx = getExpCtx();
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespace(fromNs, {fromNs, std::vector<BSONObj>{}});
+
+    auto lookupSpec = Document{{"$lookup",
+                                Document{{"from", fromNs.coll()},
+                                         {"localField", "x"_sd},
+                                         {"foreignField", "a"_sd},
+                                         {"as", "joined"_sd}}}}
+                          .toBson();
+    auto parsed = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+    auto lookup = static_cast<DocumentSourceLookUp*>(parsed.get());
+
+    auto mockLocalSource = DocumentSourceMock::create({Document{{"x", 1}}, Document{{"x", 1}}});
+    lookup->setSource(mockLocalSource.get());
+
+    deque<DocumentSource::GetNextResult> mockForeignContents{Document{{"a", 1}}};
+    lookup->injectMongodInterface(
+        std::make_shared<MockMongodInterface>(std::move(mockForeignContents)));
+
+    ASSERT_TRUE(lookup->getNext().isAdvanced());
+    ASSERT_TRUE(lookup->getNext().isAdvanced());
+    ASSERT_TRUE(lookup->getNext().isEOF());
+
+    auto explained = getExplainedLookup(lookup);
+    ASSERT_VALUE_EQ(Value("nestedLoop"_sd), explained["strategy"]);
+    ASSERT_TRUE(explained["hashJoinAfterQueries"].missing());
+    lookup->dispose();
+}
+
 }  // namespace
 }  // namespace mongo
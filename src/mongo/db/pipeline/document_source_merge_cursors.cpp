@@ -30,7 +30,11 @@
 
 #include "mongo/db/pipeline/document_source_merge_cursors.h"
 
+#include <algorithm>
+
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -39,11 +43,37 @@ using std::make_pair;
 using std::string;
 using std::vector;
 
+namespace {
+
+// The most getMores that are waited on at once, across all $mergeCursors stages.
+const size_t kMaxFetchThreads = 16;
+
+ThreadPool* getFetchThreadPool() {
+    // Intentionally leaked so that no $mergeCursors can outlive the pool during shutdown.
+    static ThreadPool* pool = [] {
+        ThreadPool::Options options;
+        options.poolName = "MergeCursorsFetch";
+        options.minThreads = 0;
+        options.maxThreads = kMaxFetchThreads;
+        auto newPool = new ThreadPool(options);
+        newPool->startup();
+        return newPool;
+    }();
+    return pool;
+}
+
+}  // namespace
+
 DocumentSourceMergeCursors::DocumentSourceMergeCursors(
     std::vector<CursorDescriptor> cursorDescriptors,
     const intrusive_ptr<ExpressionContext>& pExpCtx)
     : DocumentSource(pExpCtx), _cursorDescriptors(std::move(cursorDescriptors)), _unstarted(true) {}
 
+DocumentSourceMergeCursors::~DocumentSourceMergeCursors() {
+    // A fetch refers to this stage, so it must finish before the stage is destroyed.
+    waitForFetches();
+}
+
 REGISTER_DOCUMENT_SOURCE(mergeCursors,
                          LiteParsedDocumentSourceDefault::parse,
                          DocumentSourceMergeCursors::createFromBson);
@@ -135,8 +165,42 @@ void DocumentSourceMergeCursors::start() {
             17028, "error reading response from " + _cursors.back()->connection->toString(), ok);
         verify(!retry);
     }
+}
+
+void DocumentSourceMergeCursors::scheduleFetch(const std::shared_ptr<CursorAndConnection>& cursor) {
+    invariant(!cursor->fetching);
+    cursor->fetching = true;
+
+    auto fetch = [this, cursor] {
+        Status status = Status::OK();
+        try {
+            // Issues the getMore, since the current batch is exhausted.
+            cursor->cursor.more();
+        } catch (const DBException& ex) {
+            status = ex.toStatus();
+        }
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        cursor->fetching = false;
+        cursor->fetchStatus = std::move(status);
+        _fetchDone.notify_all();
+    };
+
+    if (!getFetchThreadPool()->schedule(fetch).isOK()) {
+        // The pool is shutting down, so fetch on this thread instead.
+        _mutex.unlock();
+        ON_BLOCK_EXIT([this] { _mutex.lock(); });
+        fetch();
+    }
+}
 
-    _currentCursor = _cursors.begin();
+void DocumentSourceMergeCursors::waitForFetches() {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _fetchDone.wait(lk, [this] {
+        return std::none_of(_cursors.begin(), _cursors.end(), [](const auto& cursor) {
+            return cursor->fetching;
+        });
+    });
 }
 
 Document DocumentSourceMergeCursors::nextSafeFrom(DBClientCursor* cursor) {
@@ -155,34 +219,59 @@ DocumentSource::GetNextResult DocumentSourceMergeCursors::getNext() {
     if (_unstarted)
         start();
 
-    // purge eof cursors and release their connections
-    while (!_cursors.empty() && !(*_currentCursor)->cursor.more()) {
-        (*_currentCursor)->connection.done();
-        _cursors.erase(_currentCursor);
-        _currentCursor = _cursors.begin();
-    }
-
-    if (_cursors.empty())
-        return GetNextResult::makeEOF();
+    std::shared_ptr<CursorAndConnection> ready;
+    {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        while (!ready) {
+            bool anyFetching = false;
+            for (auto it = _cursors.begin(); it != _cursors.end();) {
+                auto& cursor = *it;
+                if (cursor->fetching) {
+                    anyFetching = true;
+                    ++it;
+                    continue;
+                }
+                uassertStatusOK(cursor->fetchStatus);
 
-    auto next = nextSafeFrom(&((*_currentCursor)->cursor));
+                if (cursor->cursor.moreInCurrentBatch()) {
+                    if (!ready) {
+                        ready = cursor;
+                    }
+                    ++it;
+                } else if (cursor->cursor.isDead()) {
+                    // Purge eof cursors and release their connections.
+                    cursor->connection.done();
+                    it = _cursors.erase(it);
+                } else {
+                    // Fetch the next batch while we return documents from the other cursors.
+                    scheduleFetch(cursor);
+                    anyFetching = true;
+                    ++it;
+                }
+            }
 
-    // advance _currentCursor, wrapping if needed
-    if (++_currentCursor == _cursors.end())
-        _currentCursor = _cursors.begin();
+            if (!ready) {
+                if (!anyFetching) {
+                    return GetNextResult::makeEOF();
+                }
+                _fetchDone.wait(lk);
+            }
+        }
+    }
 
-    return std::move(next);
+    // No fetch can start on 'ready' until it is found to have exhausted its batch, so it is safe to
+    // read from without holding the mutex.
+    return nextSafeFrom(&ready->cursor);
 }
 
 void DocumentSourceMergeCursors::doDispose() {
     // Note it is an error to call done() on a connection before consuming the response from a
-    // request. Therefore it is an error to call dispose() if there are any outstanding connections
-    // which have not received a reply.
+    // request. Therefore we wait for any getMore which is in progress to receive its reply.
+    waitForFetches();
     for (auto&& cursorAndConn : _cursors) {
         cursorAndConn->cursor.kill();
         cursorAndConn->connection.done();
     }
     _cursors.clear();
-    _currentCursor = _cursors.end();
 }
 }
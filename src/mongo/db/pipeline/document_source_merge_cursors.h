@@ -32,9 +32,18 @@
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/cursor_id.h"
 #include "mongo/db/pipeline/document_source.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
 
 namespace mongo {
 
+/**
+ * Returns the documents from a set of cursors established on the shards, in no particular order.
+ *
+ * Documents are returned from whichever cursor has some buffered. Once a cursor's batch has been
+ * consumed, the getMore for its next batch is issued from a thread pool while the other cursors
+ * are read, so batches are fetched from all shards concurrently rather than one after another.
+ */
 class DocumentSourceMergeCursors : public DocumentSource {
 public:
     struct CursorDescriptor {
@@ -48,6 +57,8 @@ public:
         CursorId cursorId;
     };
 
+    ~DocumentSourceMergeCursors();
+
     // virtuals from DocumentSource
     GetNextResult getNext() final;
     const char* getSourceName() const final;
@@ -83,6 +94,13 @@ private:
         CursorAndConnection(const CursorDescriptor& cursorDescriptor);
         ScopedDbConnection connection;
         DBClientCursor cursor;
+
+        // True while a thread is fetching the cursor's next batch, during which nothing else may
+        // use 'cursor' or 'connection'. Guarded by '_mutex'.
+        bool fetching = false;
+
+        // The outcome of the last fetch. Guarded by '_mutex'.
+        Status fetchStatus = Status::OK();
     };
 
     // using list to enable removing arbitrary elements
@@ -94,14 +112,25 @@ private:
     // Converts _cursorDescriptors into active _cursors.
     void start();
 
+    // Issues the getMore for the next batch of 'cursor' from a thread pool. Must be called with
+    // '_mutex' held.
+    void scheduleFetch(const std::shared_ptr<CursorAndConnection>& cursor);
+
+    // Blocks until no cursor is being fetched.
+    void waitForFetches();
+
     // This is the description of cursors to merge.
     const std::vector<CursorDescriptor> _cursorDescriptors;
 
     // These are the actual cursors we are merging. Created lazily.
     Cursors _cursors;
-    Cursors::iterator _currentCursor;
 
     bool _unstarted;
+
+    stdx::mutex _mutex;
+
+    // Signalled whenever a fetch completes.
+    stdx::condition_variable _fetchDone;
 };
 
 }  // namespace mongo
@@ -46,14 +46,51 @@ DocumentSourceOut::~DocumentSourceOut() {
         if (_mongod && _tempNs.size()) _mongod->directClient()->dropCollection(_tempNs.ns());)
 }
 
-std::unique_ptr<LiteParsedDocumentSourceOneForeignCollection> DocumentSourceOut::liteParse(
-    const AggregationRequest& request, const BSONElement& spec) {
+std::pair<std::string, DocumentSourceOut::Mode> DocumentSourceOut::parseSpec(
+    const BSONElement& spec) {
+    if (spec.type() == BSONType::String) {
+        return {spec.str(), Mode::kReplaceCollection};
+    }
     uassert(40325,
-            str::stream() << "$out stage requires a string argument, but found "
+            str::stream() << "$out stage requires a string or object argument, but found "
                           << typeName(spec.type()),
-            spec.type() == BSONType::String);
+            spec.type() == BSONType::Object);
+
+    std::string targetColl;
+    Mode mode = Mode::kReplaceCollection;
+    for (auto&& option : spec.embeddedObject()) {
+        const auto optionName = option.fieldNameStringData();
+        if (optionName == "to") {
+            uassert(40633,
+                    str::stream() << "'to' option to $out must be a string, but found "
+                                  << typeName(option.type()),
+                    option.type() == BSONType::String);
+            targetColl = option.str();
+        } else if (optionName == "mode") {
+            uassert(40634,
+                    str::stream() << "'mode' option to $out must be a string, but found "
+                                  << typeName(option.type()),
+                    option.type() == BSONType::String);
+            if (option.valueStringData() == "replaceCollection") {
+                mode = Mode::kReplaceCollection;
+            } else if (option.valueStringData() == "replaceDocuments") {
+                mode = Mode::kReplaceDocuments;
+            } else {
+                uasserted(40635,
+                          str::stream() << "unknown 'mode' option to $out: "
+                                        << option.valueStringData());
+            }
+        } else {
+            uasserted(40636, str::stream() << "unknown option to $out: " << optionName);
+        }
+    }
+    uassert(40637, "$out requires a 'to' option naming the target collection", !targetColl.empty());
+    return {targetColl, mode};
+}
 
-    NamespaceString targetNss(request.getNamespaceString().db(), spec.valueStringData());
+std::unique_ptr<LiteParsedDocumentSourceOneForeignCollection> DocumentSourceOut::liteParse(
+    const AggregationRequest& request, const BSONElement& spec) {
+    NamespaceString targetNss(request.getNamespaceString().db(), parseSpec(spec).first);
     uassert(40326,
             str::stream() << "Invalid $out target namespace, " << targetNss.ns(),
             targetNss.isValid());
@@ -90,6 +127,12 @@ void DocumentSourceOut::initialize() {
                           << "' is capped so it can't be used for $out",
             _originalOutOptions["capped"].eoo());
 
+    if (_mode == Mode::kReplaceDocuments) {
+        // We write directly into the target collection.
+        _initialized = true;
+        return;
+    }
+
     // We will write all results into a temporary collection, then rename the temporary collection
     // to be the target collection once we are done.
     _tempNs = NamespaceString(str::stream() << _outputNs.db() << ".tmp.agg_out."
@@ -111,29 +154,58 @@ void DocumentSourceOut::initialize() {
                 ok);
     }
 
-    // copy indexes to _tempNs
-    for (std::list<BSONObj>::const_iterator it = _originalIndexes.begin();
-         it != _originalIndexes.end();
-         ++it) {
-        MutableDocument index((Document(*it)));
+    _initialized = true;
+}
+
+void DocumentSourceOut::buildIndexes() {
+    if (_originalIndexes.empty()) {
+        return;
+    }
+
+    // Building the indexes once the temporary collection is populated lets each of them be built
+    // in bulk from sorted keys, rather than updating every index on each insert.
+    BSONObjBuilder cmd;
+    cmd << "createIndexes" << _tempNs.coll();
+    BSONArrayBuilder indexes(cmd.subarrayStart("indexes"));
+    for (auto&& originalIndex : _originalIndexes) {
+        MutableDocument index((Document(originalIndex)));
         index.remove("_id");  // indexes shouldn't have _ids but some existing ones do
         index["ns"] = Value(_tempNs.ns());
-
-        BSONObj indexBson = index.freeze().toBson();
-        conn->insert(_tempNs.getSystemIndexesCollection(), indexBson);
-        BSONObj err = conn->getLastErrorDetailed();
-        uassert(16995,
-                str::stream() << "copying index for $out failed."
-                              << " index: "
-                              << indexBson
-                              << " error: "
-                              << err,
-                DBClientWithCommands::getLastErrorString(err).empty());
+        indexes.append(index.freeze().toBson());
     }
-    _initialized = true;
+    indexes.done();
+
+    BSONObj cmdObj = cmd.obj();
+    BSONObj info;
+    bool ok = _mongod->directClient()->runCommand(_tempNs.db().toString(), cmdObj, info);
+    uassert(16995,
+            str::stream() << "copying indexes for $out failed. command: " << cmdObj << " error: "
+                          << info,
+            ok);
 }
 
 void DocumentSourceOut::spill(const vector<BSONObj>& toInsert) {
+    if (_mode == Mode::kReplaceDocuments) {
+        vector<BSONObj> queries;
+        queries.reserve(toInsert.size());
+        for (auto&& obj : toInsert) {
+            BSONElement id = obj["_id"];
+            uassert(40638,
+                    "$out in 'replaceDocuments' mode requires every document to have an _id",
+                    !id.eoo());
+            queries.push_back(BSON("_id" << BSON("$eq" << id)));
+        }
+
+        // A replacement which is identical to the existing document is a no-op, so only new and
+        // changed documents are written.
+        const bool upsert = true;
+        const bool multi = false;
+        auto status = _mongod->update(_outputNs, queries, toInsert, upsert, multi);
+        uassert(
+            40639, str::stream() << "update for $out failed: " << status.reason(), status.isOK());
+        return;
+    }
+
     BSONObj err = _mongod->insert(_tempNs, toInsert);
     uassert(16996,
             str::stream() << "insert for $out failed: " << err,
@@ -178,6 +250,12 @@ DocumentSource::GetNextResult DocumentSourceOut::getNext() {
             return nextInput;  // Propagate the pause.
         }
         case GetNextResult::ReturnStatus::kEOF: {
+            if (_mode == Mode::kReplaceDocuments) {
+                _done = true;
+                return nextInput;
+            }
+
+            buildIndexes();
 
             auto renameCommandObj =
                 BSON("renameCollection" << _tempNs.ns() << "to" << _outputNs.ns() << "dropTarget"
@@ -199,31 +277,35 @@ DocumentSource::GetNextResult DocumentSourceOut::getNext() {
 }
 
 DocumentSourceOut::DocumentSourceOut(const NamespaceString& outputNs,
+                                     Mode mode,
                                      const intrusive_ptr<ExpressionContext>& pExpCtx)
     : DocumentSourceNeedsMongod(pExpCtx),
       _done(false),
       _tempNs(""),  // Filled in during getNext().
-      _outputNs(outputNs) {}
+      _outputNs(outputNs),
+      _mode(mode) {}
 
 intrusive_ptr<DocumentSource> DocumentSourceOut::createFromBson(
     BSONElement elem, const intrusive_ptr<ExpressionContext>& pExpCtx) {
-    uassert(16990,
-            str::stream() << "$out only supports a string argument, not " << typeName(elem.type()),
-            elem.type() == String);
+    auto spec = parseSpec(elem);
 
     uassert(ErrorCodes::InvalidOptions,
             "$out can only be used with the 'local' read concern level",
             !pExpCtx->opCtx->recoveryUnit()->isReadingFromMajorityCommittedSnapshot());
 
-    NamespaceString outputNs(pExpCtx->ns.db().toString() + '.' + elem.str());
-    uassert(17385, "Can't $out to special collection: " + elem.str(), !outputNs.isSpecial());
-    return new DocumentSourceOut(outputNs, pExpCtx);
+    NamespaceString outputNs(pExpCtx->ns.db().toString() + '.' + spec.first);
+    uassert(17385, "Can't $out to special collection: " + spec.first, !outputNs.isSpecial());
+    return new DocumentSourceOut(outputNs, spec.second, pExpCtx);
 }
 
 Value DocumentSourceOut::serialize(boost::optional<ExplainOptions::Verbosity> explain) const {
     massert(
         17000, "$out shouldn't have different db than input", _outputNs.db() == pExpCtx->ns.db());
 
+    if (_mode == Mode::kReplaceDocuments) {
+        return Value(DOC(getSourceName() << DOC("to" << _outputNs.coll() << "mode"
+                                                     << "replaceDocuments"_sd)));
+    }
     return Value(DOC(getSourceName() << _outputNs.coll()));
 }
 
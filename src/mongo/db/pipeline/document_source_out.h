@@ -34,6 +34,22 @@ namespace mongo {
 
 class DocumentSourceOut final : public DocumentSourceNeedsMongod, public SplittableDocumentSource {
 public:
+    /**
+     * How the output documents are written to the target collection.
+     */
+    enum class Mode {
+        // The output replaces the whole target collection. It is written to a temporary collection
+        // which is renamed over the target collection once complete. This is the mode of the
+        // string form of the stage, {$out: <collection>}.
+        kReplaceCollection,
+
+        // Each output document replaces, or is inserted as, the document with the same _id in the
+        // target collection. Documents of the target collection which are not in the output are
+        // left as they are, and documents which are unchanged are not written. Specified as
+        // {$out: {to: <collection>, mode: "replaceDocuments"}}.
+        kReplaceDocuments,
+    };
+
     static std::unique_ptr<LiteParsedDocumentSourceOneForeignCollection> liteParse(
         const AggregationRequest& request, const BSONElement& spec);
 
@@ -59,6 +75,10 @@ public:
         return _outputNs;
     }
 
+    Mode getMode() const {
+        return _mode;
+    }
+
     /**
       Create a document source for output and pass-through.
 
@@ -74,20 +94,37 @@ public:
 
 private:
     DocumentSourceOut(const NamespaceString& outputNs,
+                      Mode mode,
                       const boost::intrusive_ptr<ExpressionContext>& pExpCtx);
 
     /**
-     * Sets '_tempNs' to a unique temporary namespace, makes sure the output collection isn't
-     * sharded or capped, and saves the collection options and indexes of the target collection.
-     * Then creates the temporary collection we will insert into by copying the collection options
-     * and indexes from the target collection.
+     * Parses the specification of the stage, either a collection name or an object of the form
+     * {to: <collection>, mode: <mode>}, returning the name of the target collection and the mode.
+     */
+    static std::pair<std::string, Mode> parseSpec(const BSONElement& spec);
+
+    /**
+     * Makes sure the output collection isn't sharded or capped, and saves the collection options
+     * and indexes of the target collection.
+     *
+     * In kReplaceCollection mode, also sets '_tempNs' to a unique temporary namespace and creates
+     * the temporary collection we will insert into by copying the collection options from the
+     * target collection. Its indexes are copied by buildIndexes() once all documents have been
+     * inserted.
      *
      * Sets '_initialized' to true upon completion.
      */
     void initialize();
 
     /**
-     * Inserts all of 'toInsert' into the temporary collection.
+     * Builds the indexes of the target collection on the temporary collection, all in a single
+     * pass over the inserted documents.
+     */
+    void buildIndexes();
+
+    /**
+     * Writes all of 'toInsert' to the temporary collection, or to the target collection in
+     * kReplaceDocuments mode.
      */
     void spill(const std::vector<BSONObj>& toInsert);
 
@@ -101,6 +138,7 @@ private:
 
     NamespaceString _tempNs;          // output goes here as it is being processed.
     const NamespaceString _outputNs;  // output will go here after all data is processed.
+    const Mode _mode;
 };
 
 }  // namespace mongo
@@ -30,6 +30,9 @@
 
 #include "mongo/db/pipeline/document_source_sample.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include "mongo/db/client.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/expression.h"
@@ -117,6 +120,24 @@ intrusive_ptr<DocumentSource> DocumentSourceSample::createFromBson(
     return sample;
 }
 
+long long DocumentSourceSample::getShardSampleSize(long long sampleSize,
+                                                   long long shardCount,
+                                                   long long totalCount) {
+    const double kOversampleStdDevs = 4.0;
+
+    if (sampleSize == 0 || totalCount <= 0) {
+        return sampleSize;
+    }
+
+    const double fraction =
+        std::min(1.0, static_cast<double>(std::max(shardCount, 0LL)) / totalCount);
+    const double mean = sampleSize * fraction;
+    const double stdDev = std::sqrt(sampleSize * fraction * (1.0 - fraction));
+    const long long shardSampleSize =
+        static_cast<long long>(std::ceil(mean + kOversampleStdDevs * stdDev)) + 1;
+    return std::min(sampleSize, shardSampleSize);
+}
+
 intrusive_ptr<DocumentSource> DocumentSourceSample::getShardSource() {
     return this;
 }
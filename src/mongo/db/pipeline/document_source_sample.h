@@ -50,6 +50,20 @@ public:
         return _size;
     }
 
+    /**
+     * Returns how many documents a shard holding 'shardCount' of the collection's 'totalCount'
+     * documents needs to contribute to a sharded $sample of 'sampleSize' documents.
+     *
+     * Shards assign random values as the largest order statistics of a uniform sample the size of
+     * their collection, so merging the top 'sampleSize' values across shards is a uniform sample
+     * as long as no shard runs out. The number the merge takes from a shard is hypergeometric, so
+     * the shard's proportional share is padded by a few standard deviations to make running out
+     * negligibly unlikely. The result is never capped at 'shardCount', which is only approximate.
+     */
+    static long long getShardSampleSize(long long sampleSize,
+                                        long long shardCount,
+                                        long long totalCount);
+
     static boost::intrusive_ptr<DocumentSource> createFromBson(
         BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& expCtx);
 
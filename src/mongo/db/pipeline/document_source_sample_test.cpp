@@ -248,6 +248,42 @@ TEST_F(InvalidSampleSpec, MissingSize) {
     ASSERT_THROWS_CODE(createSample(createSpec(BSONObj())), UserException, 28749);
 }
 
+//
+// Test how a sharded $sample splits its size across shards.
+//
+
+TEST(ShardSampleSizeTest, ZeroSizeStaysZero) {
+    ASSERT_EQ(0, DocumentSourceSample::getShardSampleSize(0, 50, 100));
+}
+
+TEST(ShardSampleSizeTest, UnknownTotalAsksForTheFullSize) {
+    ASSERT_EQ(10, DocumentSourceSample::getShardSampleSize(10, 0, 0));
+}
+
+TEST(ShardSampleSizeTest, ShardHoldingEverythingAsksForTheFullSize) {
+    ASSERT_EQ(1000, DocumentSourceSample::getShardSampleSize(1000, 5000, 5000));
+    ASSERT_EQ(1000, DocumentSourceSample::getShardSampleSize(1000, 6000, 5000));
+}
+
+TEST(ShardSampleSizeTest, EmptyShardStillAsksForOneDocument) {
+    ASSERT_EQ(1, DocumentSourceSample::getShardSampleSize(1000, 0, 5000));
+}
+
+TEST(ShardSampleSizeTest, ShardsAskForTheirShareWithASmallOversample) {
+    // A tenth of the collection: the share is 1000, with a standard deviation of 30.
+    long long shardSize = DocumentSourceSample::getShardSampleSize(10000, 100000, 1000000);
+    ASSERT_GT(shardSize, 1000);
+    ASSERT_LTE(shardSize, 1125);
+
+    // Across many equal shards the total stays within a small multiple of the sample size.
+    long long total = 0;
+    for (int i = 0; i < 100; ++i) {
+        total += DocumentSourceSample::getShardSampleSize(10000, 10000, 1000000);
+    }
+    ASSERT_GT(total, 10000);
+    ASSERT_LT(total, 15000);
+}
+
 //
 // Test the implementation that gets results from a random cursor.
 //
@@ -33,8 +33,6 @@
 #include <boost/smart_ptr/intrusive_ptr.hpp>
 
 #include "mongo/db/pipeline/document.h"
-#include "mongo/db/pipeline/document_source_limit.h"
-#include "mongo/db/pipeline/document_source_skip.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/value.h"
 
@@ -79,19 +77,6 @@ Value DocumentSourceSingleDocumentTransformation::serialize(
     return Value(Document{{getSourceName(), _parsedTransform->serialize(explain)}});
 }
 
-Pipeline::SourceContainer::iterator DocumentSourceSingleDocumentTransformation::doOptimizeAt(
-    Pipeline::SourceContainer::iterator itr, Pipeline::SourceContainer* container) {
-    invariant(*itr == this);
-    auto nextSkip = dynamic_cast<DocumentSourceSkip*>((*std::next(itr)).get());
-    auto nextLimit = dynamic_cast<DocumentSourceLimit*>((*std::next(itr)).get());
-
-    if (nextSkip || nextLimit) {
-        std::swap(*itr, *std::next(itr));
-        return itr == container->begin() ? itr : std::prev(itr);
-    }
-    return std::next(itr);
-}
-
 DocumentSource::GetDepsReturn DocumentSourceSingleDocumentTransformation::getDependencies(
     DepsTracker* deps) const {
     // Each parsed transformation is responsible for adding its own dependencies, and returning
@@ -98,6 +98,10 @@ public:
         return true;
     }
 
+    bool canSwapWithSkipOrLimit() const final {
+        return true;
+    }
+
     TransformerInterface::TransformerType getType() const {
         return _parsedTransform->getType();
     }
@@ -109,9 +113,6 @@ public:
 protected:
     void doDispose() final;
 
-    Pipeline::SourceContainer::iterator doOptimizeAt(Pipeline::SourceContainer::iterator itr,
-                                                     Pipeline::SourceContainer* container) final;
-
 private:
     // Stores transformation logic.
     std::unique_ptr<TransformerInterface> _parsedTransform;
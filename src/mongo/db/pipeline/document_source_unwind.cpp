@@ -32,6 +32,7 @@
 
 #include "mongo/db/jsobj.h"
 #include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/document_source_group.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
 #include "mongo/db/pipeline/value.h"
@@ -252,6 +253,20 @@ DocumentSource::GetDepsReturn DocumentSourceUnwind::getDependencies(DepsTracker*
     return SEE_NEXT;
 }
 
+Pipeline::SourceContainer::iterator DocumentSourceUnwind::doOptimizeAt(
+    Pipeline::SourceContainer::iterator itr, Pipeline::SourceContainer* container) {
+    invariant(*itr == this);
+
+    auto nextGroup = dynamic_cast<DocumentSourceGroup*>((*std::next(itr)).get());
+    if (nextGroup && nextGroup->absorbUnwind(this)) {
+        // The stage before us may be able to optimize further with the $group, if there is such a
+        // stage.
+        itr = container->erase(itr);
+        return itr == container->begin() ? itr : std::prev(itr);
+    }
+    return std::next(itr);
+}
+
 intrusive_ptr<DocumentSource> DocumentSourceUnwind::createFromBson(
     BSONElement elem, const intrusive_ptr<ExpressionContext>& pExpCtx) {
     // $unwind accepts either the legacy "{$unwind: '$path'}" syntax, or a nested document with
@@ -52,6 +52,13 @@ public:
 
     GetDepsReturn getDependencies(DepsTracker* deps) const final;
 
+    /**
+     * Attempts to hand this stage over to a subsequent $group, which can then accumulate the
+     * elements of the unwound array without a document being built for each of them.
+     */
+    Pipeline::SourceContainer::iterator doOptimizeAt(Pipeline::SourceContainer::iterator itr,
+                                                     Pipeline::SourceContainer* container) final;
+
     /**
      * Creates a new $unwind DocumentSource from a BSON specification.
      */
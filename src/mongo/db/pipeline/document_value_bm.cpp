@@ -0,0 +1,141 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/json.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/field_path.h"
+#include "mongo/db/pipeline/value.h"
+#include "mongo/unittest/benchmark.h"
+
+namespace mongo {
+namespace {
+
+using unittest::benchmarkDoNotOptimize;
+
+const BSONObj kDocument = fromjson(
+    "{_id: 1, a: 1, b: 'a short string', c: 2.5, d: {e: {f: 'nested'}, g: [1, 2, 3]}, "
+    "h: [{i: 1}, {i: 2}, {i: 3}], j: true, k: null, l: 'another string value'}");
+
+BENCHMARK(Document, FromBson) {
+    while (state.keepRunning()) {
+        benchmarkDoNotOptimize(Document(kDocument));
+    }
+    state.setBytesProcessed(state.iterations() * kDocument.objsize());
+}
+
+BENCHMARK(Document, ToBson) {
+    const Document doc(kDocument);
+    while (state.keepRunning()) {
+        benchmarkDoNotOptimize(doc.toBson());
+    }
+    state.setBytesProcessed(state.iterations() * kDocument.objsize());
+}
+
+BENCHMARK(Document, GetField) {
+    const Document doc(kDocument);
+    while (state.keepRunning()) {
+        benchmarkDoNotOptimize(doc["l"]);
+    }
+}
+
+BENCHMARK(Document, GetNestedField) {
+    const Document doc(kDocument);
+    const FieldPath path("d.e.f");
+    while (state.keepRunning()) {
+        benchmarkDoNotOptimize(doc.getNestedField(path));
+    }
+}
+
+BENCHMARK(Document, MutableDocumentBuild) {
+    while (state.keepRunning()) {
+        MutableDocument md;
+        md.addField("a", Value(1));
+        md.addField("b", Value(StringData("a short string")));
+        md.addField("c", Value(2.5));
+        md.addField("d", Value(Document{{"e", 1}, {"f", 2}}));
+        benchmarkDoNotOptimize(md.freeze());
+    }
+}
+
+BENCHMARK(Document, ModifyCopy) {
+    const Document doc(kDocument);
+    while (state.keepRunning()) {
+        MutableDocument md(doc);
+        md.setField("a", Value(2));
+        benchmarkDoNotOptimize(md.freeze());
+    }
+}
+
+BENCHMARK(Document, Compare) {
+    const Document lhs(kDocument);
+    const Document rhs(kDocument);
+    while (state.keepRunning()) {
+        benchmarkDoNotOptimize(Document::compare(lhs, rhs, nullptr));
+    }
+}
+
+BENCHMARK(Document, Hash) {
+    const Document doc(kDocument);
+    while (state.keepRunning()) {
+        size_t seed = 0;
+        doc.hash_combine(seed, nullptr);
+        benchmarkDoNotOptimize(seed);
+    }
+}
+
+BENCHMARK(Value, CompareStrings) {
+    const Value lhs(StringData("a string that shares a long prefix 1"));
+    const Value rhs(StringData("a string that shares a long prefix 2"));
+    while (state.keepRunning()) {
+        benchmarkDoNotOptimize(Value::compare(lhs, rhs, nullptr));
+    }
+}
+
+BENCHMARK(Value, CompareMixedNumbers) {
+    const Value lhs(5);
+    const Value rhs(5.5);
+    while (state.keepRunning()) {
+        benchmarkDoNotOptimize(Value::compare(lhs, rhs, nullptr));
+    }
+}
+
+BENCHMARK(Value, BuildArray) {
+    while (state.keepRunning()) {
+        std::vector<Value> values;
+        for (int i = 0; i < 10; ++i) {
+            values.push_back(Value(i));
+        }
+        benchmarkDoNotOptimize(Value(std::move(values)));
+    }
+}
+
+}  // namespace
+}  // namespace mongo
@@ -147,6 +147,105 @@ TEST(DocumentSerialization, CannotSerializeDocumentThatExceedsDepthLimit) {
     throwaway.abandon();
 }
 
+TEST(LazyDocumentConstruction, FieldsAreReadOnDemandFromBson) {
+    BSONObj bson = BSON("a" << 1 << "b"
+                            << "q"
+                            << "c"
+                            << BSON("d" << 2));
+    Document document = Document::fromBsonWithMetaDataLazily(bson);
+    ASSERT_VALUE_EQ(Value(BSON("d" << 2)), document["c"]);
+    ASSERT_VALUE_EQ(Value(1), document["a"]);
+    ASSERT(document["z"].missing());
+    ASSERT_EQUALS(3U, document.size());
+    ASSERT_EQUALS("a", getNthField(document, 0).first.toString());
+    ASSERT_EQUALS("b", getNthField(document, 1).first.toString());
+    ASSERT_EQUALS("q", getNthField(document, 1).second.getString());
+    ASSERT_EQUALS("c", getNthField(document, 2).first.toString());
+    ASSERT_DOCUMENT_EQ(Document(bson), document);
+}
+
+TEST(LazyDocumentConstruction, ManyFieldsCanBeLookedUpInAnyOrder) {
+    BSONObjBuilder builder;
+    for (int i = 0; i < 100; ++i) {
+        builder.append("field" + std::to_string(i), i);
+    }
+    BSONObj bson = builder.obj();
+
+    Document document = Document::fromBsonWithMetaDataLazily(bson);
+    for (int i = 99; i >= 0; i -= 3) {
+        ASSERT_VALUE_EQ(Value(i), document["field" + std::to_string(i)]);
+    }
+    ASSERT(document["field100"].missing());
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_VALUE_EQ(Value(i), document["field" + std::to_string(i)]);
+    }
+    ASSERT_DOCUMENT_EQ(Document(bson), document);
+}
+
+TEST(LazyDocumentConstruction, UnmodifiedDocumentSerializesToItsOwnBson) {
+    BSONObj bson = BSON("a" << 1 << "b" << BSON_ARRAY(1 << 2));
+    Document document = Document::fromBsonWithMetaDataLazily(bson);
+    ASSERT_EQUALS(1.0, document["a"].coerceToDouble());
+    ASSERT_EQUALS(bson.objdata(), document.toBson().objdata());
+
+    BSONObjBuilder builder;
+    document.toBson(&builder);
+    ASSERT_BSONOBJ_EQ(bson, builder.obj());
+}
+
+TEST(LazyDocumentConstruction, ModifyingDocumentDoesNotChangeTheOriginal) {
+    BSONObj bson = BSON("a" << 1 << "b" << 2 << "c" << 3);
+    Document document = Document::fromBsonWithMetaDataLazily(bson);
+
+    MutableDocument md(document);
+    md["b"] = Value(20);
+    md.addField("d", Value(4));
+    md.remove("a");
+    Document modified = md.freeze();
+
+    ASSERT_BSONOBJ_EQ(BSON("b" << 20 << "c" << 3 << "d" << 4), modified.toBson());
+    ASSERT_BSONOBJ_EQ(bson, document.toBson());
+    ASSERT_EQUALS(bson.objdata(), document.toBson().objdata());
+}
+
+TEST(LazyDocumentConstruction, AddedFieldsFollowFieldsNotYetReadFromBson) {
+    MutableDocument md(Document::fromBsonWithMetaDataLazily(BSON("a" << 1 << "b" << 2)));
+    md.setField("c", Value(3));
+    ASSERT_BSONOBJ_EQ(BSON("a" << 1 << "b" << 2 << "c" << 3), md.freeze().toBson());
+}
+
+TEST(LazyDocumentConstruction, FirstOfDuplicateFieldsIsFound) {
+    BSONObj bson = BSON("a" << 1 << "b" << 2 << "b" << 3);
+    Document document = Document::fromBsonWithMetaDataLazily(bson);
+    ASSERT_VALUE_EQ(Value(2), document["b"]);
+    ASSERT_EQUALS(3U, document.size());
+}
+
+TEST(LazyDocumentConstruction, UnownedBsonIsCopied) {
+    BSONObj owned = BSON("x" << BSON("a" << 1 << "b" << 2));
+    BSONObj unowned = owned["x"].embeddedObject();
+    ASSERT_FALSE(unowned.isOwned());
+
+    Document document = Document::fromBsonWithMetaDataLazily(unowned);
+    owned = BSONObj();
+    ASSERT_VALUE_EQ(Value(2), document["b"]);
+    ASSERT_BSONOBJ_EQ(BSON("a" << 1 << "b" << 2), document.toBson());
+}
+
+TEST(LazyDocumentConstruction, MetadataIsParsed) {
+    BSONObj bson = BSON("a" << 1 << Document::metaFieldTextScore << 10.0);
+    Document document = Document::fromBsonWithMetaDataLazily(bson);
+    ASSERT_TRUE(document.hasTextScore());
+    ASSERT_EQUALS(10.0, document.getTextScore());
+    ASSERT_BSONOBJ_EQ(BSON("a" << 1), document.toBson());
+}
+
+TEST(LazyDocumentConstruction, ApproximateSizeIncludesUnreadBson) {
+    BSONObj bson = BSON("a" << std::string(1000, 'x'));
+    Document document = Document::fromBsonWithMetaDataLazily(bson);
+    ASSERT_GTE(document.getApproximateSize(), size_t(bson.objsize()));
+}
+
 /** Add Document fields. */
 class AddField {
 public:
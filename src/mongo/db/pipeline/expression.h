@@ -45,6 +45,7 @@
 #include "mongo/stdx/functional.h"
 #include "mongo/util/intrusive_counter.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/summation.h"
 
 namespace mongo {
 
@@ -254,6 +255,10 @@ public:
                                            BSONElement bsonExpr,
                                            const VariablesParseState& vps);
 
+    const ExpressionVector& getOperandList() const {
+        return vpOperand;
+    }
+
 protected:
     explicit ExpressionNary(const boost::intrusive_ptr<ExpressionContext>& expCtx)
         : Expression(expCtx) {}
@@ -423,6 +428,32 @@ public:
 
 class ExpressionAdd final : public ExpressionVariadic<ExpressionAdd> {
 public:
+    /**
+     * Sums the operands of an $add one at a time, in order. Shared by evaluate() and by compiled
+     * ExpressionPrograms so that both follow the same rules.
+     */
+    class Sum {
+    public:
+        /**
+         * Adds 'val' to the sum. Returns false if 'val' is nullish, in which case the result of
+         * the $add is null and the remaining operands must not be evaluated. Throws if 'val' is
+         * neither numeric nor a date.
+         */
+        bool add(const Value& val);
+
+        Value getValue() const;
+
+    private:
+        // We'll try to return the narrowest possible result value while avoiding overflow, loss
+        // of precision due to intermediate rounding or implicit use of decimal types. To do that,
+        // compute a compensated sum for non-decimal values and a separate decimal sum for decimal
+        // values, and track the current narrowest type.
+        DoubleDoubleSummation _nonDecimalTotal;
+        Decimal128 _decimalTotal;
+        BSONType _totalType = NumberInt;
+        bool _haveDate = false;
+    };
+
     explicit ExpressionAdd(const boost::intrusive_ptr<ExpressionContext>& expCtx)
         : ExpressionVariadic<ExpressionAdd>(expCtx) {}
 
@@ -537,6 +568,10 @@ public:
         const boost::intrusive_ptr<ExpressionContext>& expCtx,
         const boost::intrusive_ptr<Expression>& pExpression);
 
+    const boost::intrusive_ptr<Expression>& getOperand() const {
+        return pExpression;
+    }
+
 private:
     ExpressionCoerceToBool(const boost::intrusive_ptr<ExpressionContext>& expCtx,
                            const boost::intrusive_ptr<Expression>& pExpression);
@@ -565,6 +600,12 @@ public:
         : ExpressionFixedArity<ExpressionCompare, 2>(expCtx), cmpOp(cmpOp) {}
 
     Value evaluate(const Document& root) const final;
+
+    /**
+     * Returns the result of this comparison given the already evaluated operands.
+     */
+    Value apply(const Value& lhs, const Value& rhs) const;
+
     const char* getOpName() const final;
 
     static boost::intrusive_ptr<Expression> parse(
@@ -741,6 +782,12 @@ public:
         : ExpressionFixedArity<ExpressionDivide, 2>(expCtx) {}
 
     Value evaluate(const Document& root) const final;
+
+    /**
+     * Returns 'lhs' divided by 'rhs', following the rules of $divide.
+     */
+    static Value apply(const Value& lhs, const Value& rhs);
+
     const char* getOpName() const final;
 };
 
@@ -788,6 +835,16 @@ public:
         return _fieldPath;
     }
 
+    Variables::Id getVariableId() const {
+        return _variable;
+    }
+
+    /**
+     * Returns what evaluate() would return for a document in which the first 'index' components
+     * of the path lead to 'value'. An 'index' equal to the path length returns 'value' itself.
+     */
+    Value evaluatePathFrom(size_t index, const Value& value) const;
+
     ComputedPaths getComputedPaths(const std::string& exprFieldPath,
                                    Variables::Id renamingVar) const final;
 
@@ -1074,6 +1131,31 @@ public:
 
 class ExpressionMultiply final : public ExpressionVariadic<ExpressionMultiply> {
 public:
+    /**
+     * Multiplies the operands of a $multiply one at a time, in order. Shared by evaluate() and by
+     * compiled ExpressionPrograms so that both follow the same rules.
+     */
+    class Product {
+    public:
+        /**
+         * Multiplies the product by 'val'. Returns false if 'val' is nullish, in which case the
+         * result of the $multiply is null and the remaining operands must not be evaluated.
+         * Throws if 'val' is not numeric.
+         */
+        bool multiply(const Value& val);
+
+        Value getValue() const;
+
+    private:
+        // We'll try to return the narrowest possible result value. To do that without creating
+        // intermediate Values, do the arithmetic for double and integral types in parallel,
+        // tracking the current narrowest type.
+        double _doubleProduct = 1;
+        long long _longProduct = 1;
+        Decimal128 _decimalProduct;  // This will be initialized on encountering the first decimal.
+        BSONType _productType = NumberInt;
+    };
+
     explicit ExpressionMultiply(const boost::intrusive_ptr<ExpressionContext>& expCtx)
         : ExpressionVariadic<ExpressionMultiply>(expCtx) {}
 
@@ -1432,6 +1514,12 @@ public:
         : ExpressionFixedArity<ExpressionSubtract, 2>(expCtx) {}
 
     Value evaluate(const Document& root) const final;
+
+    /**
+     * Returns 'lhs' minus 'rhs', following the rules of $subtract.
+     */
+    static Value apply(const Value& lhs, const Value& rhs);
+
     const char* getOpName() const final;
 };
 
@@ -30,11 +30,20 @@
 
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/query/collation/collator_factory_interface.h"
+#include "mongo/stdx/memory.h"
 
 namespace mongo {
 
 using boost::intrusive_ptr;
 
+namespace {
+
+std::unique_ptr<CollationKeyCache> makeCollationKeyCache(const CollatorInterface* collator) {
+    return collator ? stdx::make_unique<CollationKeyCache>(collator) : nullptr;
+}
+
+}  // namespace
+
 ExpressionContext::ResolvedNamespace::ResolvedNamespace(NamespaceString ns,
                                                         std::vector<BSONObj> pipeline)
     : ns(std::move(ns)), pipeline(std::move(pipeline)) {}
@@ -52,8 +61,9 @@ ExpressionContext::ExpressionContext(OperationContext* opCtx,
       collation(request.getCollation()),
       variablesParseState(variables.useIdGenerator()),
       _collator(std::move(collator)),
-      _documentComparator(_collator.get()),
-      _valueComparator(_collator.get()),
+      _collationKeyCache(makeCollationKeyCache(_collator.get())),
+      _documentComparator(_collationKeyCache.get()),
+      _valueComparator(_collationKeyCache.get()),
       _resolvedNamespaces(std::move(resolvedNamespaces)) {}
 
 void ExpressionContext::checkForInterrupt() {
@@ -66,10 +76,11 @@ void ExpressionContext::checkForInterrupt() {
 
 void ExpressionContext::setCollator(std::unique_ptr<CollatorInterface> coll) {
     _collator = std::move(coll);
+    _collationKeyCache = makeCollationKeyCache(_collator.get());
 
     // Document/Value comparisons must be aware of the collation.
-    _documentComparator = DocumentComparator(_collator.get());
-    _valueComparator = ValueComparator(_collator.get());
+    _documentComparator = DocumentComparator(_collationKeyCache.get());
+    _valueComparator = ValueComparator(_collationKeyCache.get());
 }
 
 intrusive_ptr<ExpressionContext> ExpressionContext::copyWith(NamespaceString ns) const {
@@ -41,6 +41,7 @@
 #include "mongo/db/pipeline/document_comparator.h"
 #include "mongo/db/pipeline/value_comparator.h"
 #include "mongo/db/pipeline/variables.h"
+#include "mongo/db/query/collation/collation_key_cache.h"
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/query/explain_options.h"
 #include "mongo/util/intrusive_counter.h"
@@ -127,7 +128,8 @@ protected:
     ExpressionContext() : variablesParseState(variables.useIdGenerator()) {}
 
     /**
-     * Sets '_collator' and resets '_documentComparator' and '_valueComparator'.
+     * Sets '_collator' and resets '_collationKeyCache', '_documentComparator' and
+     * '_valueComparator'.
      *
      * Use with caution - it is illegal to change the collation once a Pipeline has been parsed with
      * this ExpressionContext.
@@ -137,6 +139,10 @@ protected:
     // Collator used for comparisons.
     std::unique_ptr<CollatorInterface> _collator;
 
+    // Remembers the comparison keys of the strings compared under '_collator', so that sorting and
+    // grouping compute the key of each distinct string only once. Null if there is no collator.
+    std::unique_ptr<CollationKeyCache> _collationKeyCache;
+
     // Used for all comparisons of Document/Value during execution of the aggregation operation.
     // Must not be changed after parsing a Pipeline with this ExpressionContext.
     DocumentComparator _documentComparator;
@@ -0,0 +1,305 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/expression_program.h"
+
+namespace mongo {
+
+using boost::intrusive_ptr;
+
+namespace {
+bool canLower(const Expression* expression) {
+    return dynamic_cast<const ExpressionAdd*>(expression) ||
+        dynamic_cast<const ExpressionSubtract*>(expression) ||
+        dynamic_cast<const ExpressionMultiply*>(expression) ||
+        dynamic_cast<const ExpressionDivide*>(expression) ||
+        dynamic_cast<const ExpressionCompare*>(expression) ||
+        dynamic_cast<const ExpressionAnd*>(expression) ||
+        dynamic_cast<const ExpressionOr*>(expression) ||
+        dynamic_cast<const ExpressionNot*>(expression) ||
+        dynamic_cast<const ExpressionCoerceToBool*>(expression) ||
+        dynamic_cast<const ExpressionCond*>(expression);
+}
+}  // namespace
+
+std::unique_ptr<ExpressionProgram> ExpressionProgram::compile(
+    intrusive_ptr<Expression> expression) {
+    const Expression* root = expression.get();
+    if (!canLower(root)) {
+        return nullptr;
+    }
+
+    std::unique_ptr<ExpressionProgram> program(new ExpressionProgram(std::move(expression)));
+    program->_resultRegister = program->compileNode(root);
+    return program;
+}
+
+size_t ExpressionProgram::compileNode(const Expression* expression) {
+    if (auto constant = dynamic_cast<const ExpressionConstant*>(expression)) {
+        // Nothing ever writes to a constant's register.
+        return newRegister(constant->getValue());
+    }
+
+    if (auto fieldPath = dynamic_cast<const ExpressionFieldPath*>(expression)) {
+        const auto& path = fieldPath->getFieldPath();
+        if (fieldPath->getVariableId() == Variables::kRootId && path.getPathLength() == 2) {
+            const size_t result = newRegister();
+            auto& instruction = emit(OpCode::kGetRootField);
+            instruction.dest = result;
+            instruction.index = _fieldNames.size();
+            _fieldNames.push_back(path.getFieldName(1).toString());
+            return result;
+        }
+    }
+
+    // Compiles the operands of a binary operator and emits it.
+    auto emitBinary = [&](OpCode op, const ExpressionNary* nary) {
+        const auto& operands = nary->getOperandList();
+        invariant(operands.size() == 2);
+        const size_t lhs = compileNode(operands[0].get());
+        const size_t rhs = compileNode(operands[1].get());
+        const size_t result = newRegister();
+        auto& instruction = emit(op);
+        instruction.dest = result;
+        instruction.lhs = lhs;
+        instruction.rhs = rhs;
+        instruction.expression = nary;
+        return result;
+    };
+
+    // Compiles an $add or $multiply, which stops at the first nullish operand.
+    auto emitAccumulation = [&](OpCode start,
+                                OpCode accumulate,
+                                OpCode finish,
+                                size_t index,
+                                const ExpressionNary* nary) {
+        const size_t result = newRegister();
+        emit(start).index = index;
+
+        std::vector<size_t> jumpsToEnd;
+        for (auto&& operand : nary->getOperandList()) {
+            const size_t operandRegister = compileNode(operand.get());
+            jumpsToEnd.push_back(_instructions.size());
+            auto& instruction = emit(accumulate);
+            instruction.dest = result;
+            instruction.lhs = operandRegister;
+            instruction.index = index;
+        }
+
+        auto& instruction = emit(finish);
+        instruction.dest = result;
+        instruction.index = index;
+
+        for (size_t jump : jumpsToEnd) {
+            _instructions[jump].target = _instructions.size();
+        }
+        return result;
+    };
+
+    // Compiles an $and or $or, which stops at the first operand that is false or true
+    // respectively.
+    auto emitShortCircuit = [&](
+        OpCode jumpOp, bool shortCircuitResult, const ExpressionNary* nary) {
+        const size_t result = newRegister();
+        const size_t shortCircuitRegister = newRegister(Value(shortCircuitResult));
+        const size_t otherRegister = newRegister(Value(!shortCircuitResult));
+
+        std::vector<size_t> jumpsToShortCircuit;
+        for (auto&& operand : nary->getOperandList()) {
+            const size_t operandRegister = compileNode(operand.get());
+            jumpsToShortCircuit.push_back(_instructions.size());
+            emit(jumpOp).lhs = operandRegister;
+        }
+
+        auto& moveOther = emit(OpCode::kMove);
+        moveOther.dest = result;
+        moveOther.lhs = otherRegister;
+        const size_t jumpToEnd = _instructions.size();
+        emit(OpCode::kJump);
+
+        for (size_t jump : jumpsToShortCircuit) {
+            _instructions[jump].target = _instructions.size();
+        }
+        auto& moveShortCircuit = emit(OpCode::kMove);
+        moveShortCircuit.dest = result;
+        moveShortCircuit.lhs = shortCircuitRegister;
+
+        _instructions[jumpToEnd].target = _instructions.size();
+        return result;
+    };
+
+    // Compiles the single operand of a unary operator and emits it.
+    auto emitUnary = [&](OpCode op, const Expression* operand) {
+        const size_t operandRegister = compileNode(operand);
+        const size_t result = newRegister();
+        auto& instruction = emit(op);
+        instruction.dest = result;
+        instruction.lhs = operandRegister;
+        return result;
+    };
+
+    if (auto add = dynamic_cast<const ExpressionAdd*>(expression)) {
+        _sums.emplace_back();
+        return emitAccumulation(
+            OpCode::kStartSum, OpCode::kAddToSum, OpCode::kFinishSum, _sums.size() - 1, add);
+    } else if (auto multiply = dynamic_cast<const ExpressionMultiply*>(expression)) {
+        _products.emplace_back();
+        return emitAccumulation(OpCode::kStartProduct,
+                                OpCode::kMultiplyProduct,
+                                OpCode::kFinishProduct,
+                                _products.size() - 1,
+                                multiply);
+    } else if (auto subtract = dynamic_cast<const ExpressionSubtract*>(expression)) {
+        return emitBinary(OpCode::kSubtract, subtract);
+    } else if (auto divide = dynamic_cast<const ExpressionDivide*>(expression)) {
+        return emitBinary(OpCode::kDivide, divide);
+    } else if (auto compare = dynamic_cast<const ExpressionCompare*>(expression)) {
+        return emitBinary(OpCode::kCompare, compare);
+    } else if (auto andExpr = dynamic_cast<const ExpressionAnd*>(expression)) {
+        return emitShortCircuit(OpCode::kJumpIfFalse, false, andExpr);
+    } else if (auto orExpr = dynamic_cast<const ExpressionOr*>(expression)) {
+        return emitShortCircuit(OpCode::kJumpIfTrue, true, orExpr);
+    } else if (auto notExpr = dynamic_cast<const ExpressionNot*>(expression)) {
+        return emitUnary(OpCode::kNot, notExpr->getOperandList()[0].get());
+    } else if (auto coerceToBool = dynamic_cast<const ExpressionCoerceToBool*>(expression)) {
+        return emitUnary(OpCode::kCoerceToBool, coerceToBool->getOperand().get());
+    } else if (auto cond = dynamic_cast<const ExpressionCond*>(expression)) {
+        const auto& operands = cond->getOperandList();
+        invariant(operands.size() == 3);
+        const size_t ifRegister = compileNode(operands[0].get());
+        const size_t result = newRegister();
+        const size_t jumpToElse = _instructions.size();
+        emit(OpCode::kJumpIfFalse).lhs = ifRegister;
+
+        const size_t thenRegister = compileNode(operands[1].get());
+        auto& moveThen = emit(OpCode::kMove);
+        moveThen.dest = result;
+        moveThen.lhs = thenRegister;
+        const size_t jumpToEnd = _instructions.size();
+        emit(OpCode::kJump);
+
+        _instructions[jumpToElse].target = _instructions.size();
+        const size_t elseRegister = compileNode(operands[2].get());
+        auto& moveElse = emit(OpCode::kMove);
+        moveElse.dest = result;
+        moveElse.lhs = elseRegister;
+
+        _instructions[jumpToEnd].target = _instructions.size();
+        return result;
+    }
+
+    // Everything else is evaluated as a tree.
+    const size_t result = newRegister();
+    auto& instruction = emit(OpCode::kEvaluate);
+    instruction.dest = result;
+    instruction.expression = expression;
+    return result;
+}
+
+Value ExpressionProgram::evaluate(const Document& root) const {
+    const size_t nInstructions = _instructions.size();
+    size_t next = 0;
+    while (next < nInstructions) {
+        const Instruction& instruction = _instructions[next++];
+        Value& dest = _registers[instruction.dest];
+        const Value& lhs = _registers[instruction.lhs];
+        const Value& rhs = _registers[instruction.rhs];
+
+        switch (instruction.op) {
+            case OpCode::kEvaluate:
+                dest = instruction.expression->evaluate(root);
+                break;
+            case OpCode::kGetRootField:
+                dest = root[_fieldNames[instruction.index]];
+                break;
+            case OpCode::kMove:
+                dest = lhs;
+                break;
+            case OpCode::kStartSum:
+                _sums[instruction.index] = ExpressionAdd::Sum();
+                break;
+            case OpCode::kAddToSum:
+                if (!_sums[instruction.index].add(lhs)) {
+                    dest = Value(BSONNULL);
+                    next = instruction.target;
+                }
+                break;
+            case OpCode::kFinishSum:
+                dest = _sums[instruction.index].getValue();
+                break;
+            case OpCode::kStartProduct:
+                _products[instruction.index] = ExpressionMultiply::Product();
+                break;
+            case OpCode::kMultiplyProduct:
+                if (!_products[instruction.index].multiply(lhs)) {
+                    dest = Value(BSONNULL);
+                    next = instruction.target;
+                }
+                break;
+            case OpCode::kFinishProduct:
+                dest = _products[instruction.index].getValue();
+                break;
+            case OpCode::kSubtract:
+                dest = ExpressionSubtract::apply(lhs, rhs);
+                break;
+            case OpCode::kDivide:
+                dest = ExpressionDivide::apply(lhs, rhs);
+                break;
+            case OpCode::kCompare: {
+                auto compare = static_cast<const ExpressionCompare*>(instruction.expression);
+                dest = compare->apply(lhs, rhs);
+                break;
+            }
+            case OpCode::kNot:
+                dest = Value(!lhs.coerceToBool());
+                break;
+            case OpCode::kCoerceToBool:
+                dest = Value(lhs.coerceToBool());
+                break;
+            case OpCode::kJump:
+                next = instruction.target;
+                break;
+            case OpCode::kJumpIfFalse:
+                if (!lhs.coerceToBool()) {
+                    next = instruction.target;
+                }
+                break;
+            case OpCode::kJumpIfTrue:
+                if (lhs.coerceToBool()) {
+                    next = instruction.target;
+                }
+                break;
+        }
+    }
+
+    return _registers[_resultRegister];
+}
+
+}  // namespace mongo
@@ -0,0 +1,135 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/intrusive_ptr.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/db/pipeline/expression.h"
+#include "mongo/db/pipeline/value.h"
+
+namespace mongo {
+
+/**
+ * An optimized Expression tree lowered into a flat program over a fixed set of registers, for
+ * callers that evaluate the same expression against many documents.
+ *
+ * The arithmetic ($add, $subtract, $multiply, $divide), comparison, boolean ($and, $or, $not) and
+ * $cond operators in the tree become instructions that read their operands from registers and
+ * write their result to another, so evaluating them takes neither a virtual call nor a Value
+ * returned up through the tree. Since numbers and booleans are stored inline in a Value, none of
+ * their intermediate results allocate. Constants are loaded into registers once, when the
+ * program is compiled, and top-level fields of the root document are read without going through
+ * Variables. Any other subtree is evaluated as a tree by a single instruction.
+ *
+ * Operands are evaluated in the same order as by the tree, including short-circuiting, so the
+ * program returns the same results and raises the same errors.
+ *
+ * The registers are reused from one call to evaluate() to the next, so a program must not be
+ * evaluated from several threads at once.
+ */
+class ExpressionProgram {
+public:
+    /**
+     * Lowers 'expression', which should already have been optimized. Returns nullptr if its root
+     * isn't one of the operators that can be lowered, since the program wouldn't be any faster.
+     */
+    static std::unique_ptr<ExpressionProgram> compile(boost::intrusive_ptr<Expression> expression);
+
+    /**
+     * Returns the same as evaluating the compiled expression against 'root'.
+     */
+    Value evaluate(const Document& root) const;
+
+private:
+    enum class OpCode {
+        kEvaluate,         // dest = expression->evaluate(root)
+        kGetRootField,     // dest = root[fieldNames[index]]
+        kMove,             // dest = lhs
+        kStartSum,         // sums[index] = empty sum
+        kAddToSum,         // add lhs to sums[index], or set dest to null and jump if it is nullish
+        kFinishSum,        // dest = sums[index]
+        kStartProduct,     // products[index] = empty product
+        kMultiplyProduct,  // multiply products[index] by lhs, or set dest to null and jump
+        kFinishProduct,    // dest = products[index]
+        kSubtract,         // dest = lhs - rhs
+        kDivide,           // dest = lhs / rhs
+        kCompare,          // dest = expression's comparison of lhs and rhs
+        kNot,              // dest = !lhs
+        kCoerceToBool,     // dest = bool(lhs)
+        kJump,             // jump
+        kJumpIfFalse,      // jump if !lhs
+        kJumpIfTrue,       // jump if lhs
+    };
+
+    struct Instruction {
+        OpCode op;
+        size_t dest = 0;
+        size_t lhs = 0;
+        size_t rhs = 0;
+        size_t index = 0;   // into _fieldNames, _sums or _products
+        size_t target = 0;  // the instruction to jump to
+        const Expression* expression = nullptr;
+    };
+
+    explicit ExpressionProgram(boost::intrusive_ptr<Expression> expression)
+        : _expression(std::move(expression)) {}
+
+    /**
+     * Appends instructions computing 'expression' and returns the register that holds its result
+     * once they have run.
+     */
+    size_t compileNode(const Expression* expression);
+
+    size_t newRegister(Value initialValue = Value()) {
+        _registers.push_back(std::move(initialValue));
+        return _registers.size() - 1;
+    }
+
+    Instruction& emit(OpCode op) {
+        _instructions.emplace_back();
+        _instructions.back().op = op;
+        return _instructions.back();
+    }
+
+    // Keeps every Expression referred to by '_instructions' alive.
+    boost::intrusive_ptr<Expression> _expression;
+
+    std::vector<Instruction> _instructions;
+    size_t _resultRegister = 0;
+    std::vector<std::string> _fieldNames;
+
+    mutable std::vector<Value> _registers;
+    mutable std::vector<ExpressionAdd::Sum> _sums;
+    mutable std::vector<ExpressionMultiply::Product> _products;
+};
+
+}  // namespace mongo
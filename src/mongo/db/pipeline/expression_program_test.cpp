@@ -0,0 +1,213 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/expression_program.h"
+
+#include <limits>
+#include <vector>
+
+#include "mongo/bson/json.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/pipeline/expression.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using boost::intrusive_ptr;
+using std::vector;
+
+/**
+ * Parses and optimizes the expression in 'spec', which must be of the form {expr: <expression>}.
+ */
+intrusive_ptr<Expression> parseExpression(const intrusive_ptr<ExpressionContext>& expCtx,
+                                          const BSONObj& spec) {
+    return Expression::parseOperand(expCtx, spec.firstElement(), expCtx->variablesParseState)
+        ->optimize();
+}
+
+/**
+ * Asserts that the expression in 'spec' compiles, and that the program returns the same values,
+ * of the same types, and throws the same errors as the tree does for each of 'inputs'.
+ */
+void assertProgramMatchesTree(const BSONObj& spec, const vector<Document>& inputs) {
+    intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto expression = parseExpression(expCtx, spec);
+    auto program = ExpressionProgram::compile(expression);
+    ASSERT(program);
+
+    for (auto&& input : inputs) {
+        Value expected;
+        Status expectedStatus = Status::OK();
+        try {
+            expected = expression->evaluate(input);
+        } catch (const DBException& ex) {
+            expectedStatus = ex.toStatus();
+        }
+
+        Value actual;
+        Status actualStatus = Status::OK();
+        try {
+            actual = program->evaluate(input);
+        } catch (const DBException& ex) {
+            actualStatus = ex.toStatus();
+        }
+
+        ASSERT_EQ(expectedStatus.code(), actualStatus.code()) << spec << " on " << input;
+        ASSERT_VALUE_EQ(expected, actual);
+        ASSERT_EQ(expected.getType(), actual.getType()) << spec << " on " << input;
+    }
+}
+
+const vector<Document> kNumericInputs = {
+    Document{{"a", 1}, {"b", 2}},
+    Document{{"a", 1}, {"b", 2LL}},
+    Document{{"a", 1.5}, {"b", -2}},
+    Document{{"a", Decimal128("1.1")}, {"b", 3}},
+    Document{{"a", std::numeric_limits<int>::max()}, {"b", std::numeric_limits<int>::max()}},
+    Document{{"a", std::numeric_limits<long long>::max()}, {"b", 2LL}},
+    Document{{"a", 0}, {"b", 0}},
+    Document{{"a", BSONNULL}, {"b", 1}},
+    Document{{"b", 1}},
+    Document{{"a", "string"_sd}, {"b", 1}},
+    Document{{"a", Date_t::fromMillisSinceEpoch(1000)}, {"b", 5}},
+    Document{{"a", Date_t::fromMillisSinceEpoch(1000)}, {"b", Date_t::fromMillisSinceEpoch(10)}},
+};
+
+TEST(ExpressionProgramTest, DoesNotCompileExpressionsWhoseRootCannotBeLowered) {
+    intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    ASSERT_FALSE(ExpressionProgram::compile(parseExpression(expCtx, fromjson("{expr: '$a'}"))));
+    ASSERT_FALSE(ExpressionProgram::compile(parseExpression(expCtx, fromjson("{expr: 1}"))));
+    ASSERT_FALSE(ExpressionProgram::compile(
+        parseExpression(expCtx, fromjson("{expr: {$concat: ['$a', {$substr: ['$b', 0, 1]}]}}"))));
+}
+
+TEST(ExpressionProgramTest, ArithmeticMatchesTree) {
+    for (auto&& spec : {"{expr: {$add: ['$a', '$b', 1]}}",
+                        "{expr: {$add: ['$a', {$multiply: ['$b', 2.5]}]}}",
+                        "{expr: {$subtract: ['$a', '$b']}}",
+                        "{expr: {$multiply: ['$a', '$b', 3]}}",
+                        "{expr: {$divide: ['$a', '$b']}}",
+                        "{expr: {$divide: [{$subtract: ['$a', 1]}, {$add: ['$b', 0.5]}]}}"}) {
+        assertProgramMatchesTree(fromjson(spec), kNumericInputs);
+    }
+}
+
+TEST(ExpressionProgramTest, ComparisonsAndBooleansMatchTree) {
+    for (auto&& spec : {"{expr: {$gt: ['$a', '$b']}}",
+                        "{expr: {$cmp: ['$a', '$b']}}",
+                        "{expr: {$and: [{$gte: ['$a', 1]}, {$lt: ['$b', 3]}]}}",
+                        "{expr: {$or: [{$eq: ['$a', null]}, {$ne: ['$b', 2]}]}}",
+                        "{expr: {$not: [{$lte: ['$a', '$b']}]}}",
+                        "{expr: {$and: ['$a']}}",
+                        "{expr: {$or: ['$a', '$b']}}"}) {
+        assertProgramMatchesTree(fromjson(spec), kNumericInputs);
+    }
+}
+
+TEST(ExpressionProgramTest, CondMatchesTree) {
+    assertProgramMatchesTree(
+        fromjson("{expr: {$cond: [{$gt: ['$a', 1]}, {$multiply: ['$a', 2]}, {$add: ['$b', 1]}]}}"),
+        kNumericInputs);
+    assertProgramMatchesTree(
+        fromjson("{expr: {$cond: {if: '$a', then: {$concat: ['x', 'y']}, else: '$$REMOVE'}}}"),
+        kNumericInputs);
+}
+
+TEST(ExpressionProgramTest, NestedSubtreesThatCannotBeLoweredAreEvaluated) {
+    assertProgramMatchesTree(
+        fromjson("{expr: {$add: [{$size: {$ifNull: ['$arr', []]}}, '$a.b', '$$ROOT.a.b']}}"),
+        {Document{{"arr", vector<Value>{Value(1), Value(2)}}, {"a", Document{{"b", 3}}}},
+         Document{{"a", vector<Value>{Value(Document{{"b", 1}})}}},
+         Document{}});
+}
+
+TEST(ExpressionProgramTest, StopsEvaluatingOperandsAfterANullishOneLikeTheTree) {
+    // The $divide would fail, but is never evaluated.
+    intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    for (auto&& spec : {"{expr: {$add: ['$missing', {$divide: [1, '$zero']}]}}",
+                        "{expr: {$multiply: ['$missing', {$divide: [1, '$zero']}]}}"}) {
+        auto program = ExpressionProgram::compile(parseExpression(expCtx, fromjson(spec)));
+        ASSERT(program);
+        ASSERT_VALUE_EQ(Value(BSONNULL), program->evaluate(Document{{"zero", 0}}));
+    }
+
+    assertProgramMatchesTree(fromjson("{expr: {$add: ['$a', {$divide: [1, '$b']}]}}"),
+                             kNumericInputs);
+}
+
+TEST(ExpressionProgramTest, ShortCircuitsLikeTheTree) {
+    intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto program = ExpressionProgram::compile(
+        parseExpression(expCtx, fromjson("{expr: {$and: ['$flag', {$divide: [1, '$zero']}]}}")));
+    ASSERT(program);
+    ASSERT_VALUE_EQ(Value(false), program->evaluate(Document{{"flag", false}, {"zero", 0}}));
+    ASSERT_THROWS_CODE(program->evaluate(Document{{"flag", true}, {"zero", 0}}),
+                       UserException,
+                       16608);
+
+    program = ExpressionProgram::compile(
+        parseExpression(expCtx, fromjson("{expr: {$or: ['$flag', {$divide: [1, '$zero']}]}}")));
+    ASSERT(program);
+    ASSERT_VALUE_EQ(Value(true), program->evaluate(Document{{"flag", true}, {"zero", 0}}));
+
+    program = ExpressionProgram::compile(parseExpression(
+        expCtx, fromjson("{expr: {$cond: ['$flag', 1, {$divide: [1, '$zero']}]}}")));
+    ASSERT(program);
+    ASSERT_VALUE_EQ(Value(1), program->evaluate(Document{{"flag", true}, {"zero", 0}}));
+}
+
+TEST(ExpressionProgramTest, ComparisonsRespectTheCollation) {
+    intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    expCtx->setCollator(
+        stdx::make_unique<CollatorInterfaceMock>(CollatorInterfaceMock::MockType::kAlwaysEqual));
+    auto program = ExpressionProgram::compile(
+        parseExpression(expCtx, fromjson("{expr: {$and: [{$eq: ['$a', 'foo']}, '$b']}}")));
+    ASSERT(program);
+    ASSERT_VALUE_EQ(Value(true), program->evaluate(Document{{"a", "bar"_sd}, {"b", 1}}));
+}
+
+TEST(ExpressionProgramTest, CanBeEvaluatedAgainstManyDocuments) {
+    intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto program = ExpressionProgram::compile(parseExpression(
+        expCtx, fromjson("{expr: {$cond: [{$gt: ['$x', 5]}, {$multiply: ['$x', 2]}, null]}}")));
+    ASSERT(program);
+    for (int i = 0; i < 10; ++i) {
+        Value expected = i > 5 ? Value(i * 2) : Value(BSONNULL);
+        ASSERT_VALUE_EQ(expected, program->evaluate(Document{{"x", i}}));
+    }
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,190 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "mongo/db/pipeline/value.h"
+#include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+/**
+ * A hash table from group key to per-group state, specialized for the access pattern of $group:
+ * many lookups and insertions, iteration over every group, and no removal of single groups.
+ *
+ * Entries are stored contiguously in insertion order, and each key is hashed only once, when it is
+ * inserted. The table itself uses open addressing with linear probing over an array of slots,
+ * each holding an entry's index and the high bits of its hash, so that probing for a key rarely
+ * touches an entry other than the one it finds. Growing the table only rebuilds the slots.
+ *
+ * Keys are compared and hashed with the given ValueComparator, which must outlive the table.
+ * References and iterators to entries are invalidated by the insertion of a new key.
+ */
+template <typename T>
+class GroupTable {
+public:
+    using value_type = std::pair<Value, T>;
+    using iterator = typename std::vector<value_type>::iterator;
+    using const_iterator = typename std::vector<value_type>::const_iterator;
+
+    explicit GroupTable(const ValueComparator& comparator) : _comparator(&comparator) {}
+
+    /**
+     * Returns the state for 'key', inserting a default-constructed one if 'key' isn't present.
+     */
+    T& operator[](Value key) {
+        const size_t hash = _comparator->hash(key);
+        if ((_entries.size() + 1) * kMaxLoadDenominator > _slots.size() * kMaxLoadNumerator) {
+            grow();
+        }
+
+        const size_t mask = _slots.size() - 1;
+        for (size_t pos = hash & mask;; pos = (pos + 1) & mask) {
+            Slot& slot = _slots[pos];
+            if (slot.index == kEmptySlot) {
+                invariant(_entries.size() < kEmptySlot);
+                slot = {static_cast<uint32_t>(_entries.size()), hashTag(hash)};
+                _entries.emplace_back(std::move(key), T());
+                _hashes.push_back(hash);
+                return _entries.back().second;
+            }
+            if (slot.hashTag == hashTag(hash) && _hashes[slot.index] == hash &&
+                _comparator->evaluate(_entries[slot.index].first == key)) {
+                return _entries[slot.index].second;
+            }
+        }
+    }
+
+    /**
+     * Returns the entry for 'key', or end() if there is none.
+     */
+    iterator find(const Value& key) {
+        if (_entries.empty()) {
+            return end();
+        }
+
+        const size_t hash = _comparator->hash(key);
+        const size_t mask = _slots.size() - 1;
+        for (size_t pos = hash & mask;; pos = (pos + 1) & mask) {
+            const Slot& slot = _slots[pos];
+            if (slot.index == kEmptySlot) {
+                return end();
+            }
+            if (slot.hashTag == hashTag(hash) && _hashes[slot.index] == hash &&
+                _comparator->evaluate(_entries[slot.index].first == key)) {
+                return _entries.begin() + slot.index;
+            }
+        }
+    }
+
+    iterator begin() {
+        return _entries.begin();
+    }
+
+    iterator end() {
+        return _entries.end();
+    }
+
+    const_iterator begin() const {
+        return _entries.begin();
+    }
+
+    const_iterator end() const {
+        return _entries.end();
+    }
+
+    size_t size() const {
+        return _entries.size();
+    }
+
+    bool empty() const {
+        return _entries.empty();
+    }
+
+    /**
+     * Removes every entry and releases the table's memory.
+     */
+    void clear() {
+        std::vector<value_type>().swap(_entries);
+        std::vector<size_t>().swap(_hashes);
+        std::vector<Slot>().swap(_slots);
+    }
+
+private:
+    struct Slot {
+        uint32_t index;
+        uint32_t hashTag;
+    };
+
+    static const uint32_t kEmptySlot = UINT32_MAX;
+    static const size_t kInitialSlots = 16;
+
+    // The table grows once more than 3/4 of its slots are in use.
+    static const size_t kMaxLoadNumerator = 3;
+    static const size_t kMaxLoadDenominator = 4;
+
+    /**
+     * The bits of 'hash' not used to pick the initial slot in any table smaller than 2^32 slots.
+     */
+    static uint32_t hashTag(size_t hash) {
+        return static_cast<uint32_t>(static_cast<uint64_t>(hash) >> 32);
+    }
+
+    /**
+     * Doubles the number of slots and reinserts every entry using its saved hash.
+     */
+    void grow() {
+        const size_t numSlots = _slots.empty() ? kInitialSlots : _slots.size() * 2;
+        std::vector<Slot>(numSlots, Slot{kEmptySlot, 0}).swap(_slots);
+
+        const size_t mask = numSlots - 1;
+        for (size_t index = 0; index < _entries.size(); ++index) {
+            size_t pos = _hashes[index] & mask;
+            while (_slots[pos].index != kEmptySlot) {
+                pos = (pos + 1) & mask;
+            }
+            _slots[pos] = {static_cast<uint32_t>(index), hashTag(_hashes[index])};
+        }
+    }
+
+    const ValueComparator* _comparator;
+
+    // The entries, in insertion order, and the hash of each entry's key.
+    std::vector<value_type> _entries;
+    std::vector<size_t> _hashes;
+
+    // A power of two number of slots, or none before the first insertion.
+    std::vector<Slot> _slots;
+};
+
+}  // namespace mongo
@@ -0,0 +1,121 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+
+#include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/pipeline/group_table.h"
+#include "mongo/db/pipeline/value.h"
+#include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const ValueComparator defaultComparator{nullptr};
+
+TEST(GroupTableTest, InsertAndRetrieveWorksCorrectly) {
+    GroupTable<int> table(defaultComparator);
+    ASSERT_TRUE(table.empty());
+    ASSERT_TRUE(table.find(Value(0)) == table.end());
+
+    table[Value(0)] = 1;
+    table[Value("a"_sd)] = 2;
+    table[Value(0)] += 10;
+
+    ASSERT_EQ(2U, table.size());
+    ASSERT_EQ(11, table.find(Value(0))->second);
+    ASSERT_EQ(2, table.find(Value("a"_sd))->second);
+    ASSERT_TRUE(table.find(Value(1)) == table.end());
+}
+
+TEST(GroupTableTest, NumericKeysOfDifferentTypesAreTheSameGroup) {
+    GroupTable<int> table(defaultComparator);
+    ++table[Value(1)];
+    ++table[Value(1LL)];
+    ++table[Value(1.0)];
+
+    ASSERT_EQ(1U, table.size());
+    ASSERT_EQ(3, table.find(Value(1))->second);
+}
+
+TEST(GroupTableTest, EntriesSurviveGrowthInInsertionOrder) {
+    GroupTable<int> table(defaultComparator);
+    const int numGroups = 10000;
+    for (int i = 0; i < numGroups; ++i) {
+        table[Value(i)] = i * 2;
+    }
+    for (int i = 0; i < numGroups; ++i) {
+        ++table[Value(i)];
+    }
+
+    ASSERT_EQ(static_cast<size_t>(numGroups), table.size());
+    int expected = 0;
+    for (auto&& entry : table) {
+        ASSERT_VALUE_EQ(Value(expected), entry.first);
+        ASSERT_EQ(expected * 2 + 1, entry.second);
+        ++expected;
+    }
+    ASSERT_EQ(numGroups, expected);
+}
+
+TEST(GroupTableTest, KeysRespectCollation) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kToLowerString);
+    ValueComparator comparator{&collator};
+    GroupTable<int> table(comparator);
+
+    ++table[Value("foo"_sd)];
+    ++table[Value("FOO"_sd)];
+    ++table[Value("FOOz"_sd)];
+
+    ASSERT_EQ(2U, table.size());
+    ASSERT_EQ(2, table.find(Value("FoO"_sd))->second);
+    ASSERT_EQ(1, table.find(Value("fooZ"_sd))->second);
+}
+
+TEST(GroupTableTest, ClearRemovesAllEntries) {
+    GroupTable<int> table(defaultComparator);
+    for (int i = 0; i < 100; ++i) {
+        table[Value(i)] = i;
+    }
+    table.clear();
+
+    ASSERT_TRUE(table.empty());
+    ASSERT_TRUE(table.begin() == table.end());
+    ASSERT_TRUE(table.find(Value(5)) == table.end());
+
+    table[Value(5)] = 7;
+    ASSERT_EQ(1U, table.size());
+    ASSERT_EQ(7, table.find(Value(5))->second);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -96,31 +96,25 @@ public:
      * likely we don't want to evict it (i.e., we want to make sure it isn't at the back).
      */
     void insert(Value key, Document doc) {
-        // Get an iterator to the middle of the container.
-        size_t middle = size() / 2;
-        auto it = _container.begin();
-        std::advance(it, middle);
-        const auto keySize = key.getApproximateSize();
         const auto docSize = doc.getApproximateSize();
-
-        // Find the cache entry, or create one if it doesn't exist yet.
-        auto insertionResult = _container.insert(it, {std::move(key), {}});
-        if (insertionResult.second) {
-            _memoryUsage += keySize;
-        } else {
-            // We did not insert due to a duplicate key. Update the cached doc, moving it to the
-            // middle of the cache.
-            _container.relocate(it, insertionResult.first);
-        }
+        auto entry = insertKeyInMiddle(std::move(key));
 
         // Add the doc to the cache entry.
-        _container.modify(insertionResult.first,
-                          [&doc](std::pair<Value, std::vector<Document>>& entry) {
-                              entry.second.push_back(std::move(doc));
-                          });
+        _container.modify(entry, [&doc](std::pair<Value, std::vector<Document>>& entry) {
+            entry.second.push_back(std::move(doc));
+        });
         _memoryUsage += docSize;
     }
 
+    /**
+     * Insert "key" into the cache with no values, recording that nothing is associated with it, or
+     * if "key" is already present, leave its values as they are. Either way the key is moved to the
+     * middle of the cache, as with insert().
+     */
+    void insertKey(Value key) {
+        insertKeyInMiddle(std::move(key));
+    }
+
     /**
      * Evict the least-recently-used item.
      */
@@ -191,6 +185,28 @@ public:
     }
 
 private:
+    /**
+     * Finds the entry for "key", or creates an empty one, and moves it to the middle of the cache.
+     */
+    IndexedContainer::iterator insertKeyInMiddle(Value key) {
+        // Get an iterator to the middle of the container.
+        size_t middle = size() / 2;
+        auto it = _container.begin();
+        std::advance(it, middle);
+        const auto keySize = key.getApproximateSize();
+
+        // Find the cache entry, or create one if it doesn't exist yet.
+        auto insertionResult = _container.insert(it, {std::move(key), {}});
+        if (insertionResult.second) {
+            _memoryUsage += keySize;
+        } else {
+            // We did not insert due to a duplicate key. Move the existing entry to the middle of
+            // the cache.
+            _container.relocate(it, insertionResult.first);
+        }
+        return insertionResult.first;
+    }
+
     IndexedContainer _container;
 
     size_t _memoryUsage = 0;
@@ -72,6 +72,19 @@ TEST(LookupSetCacheTest, InsertAndRetrieveWorksCorrectly) {
     ASSERT_FALSE(vectorContains(cache[Value(0)], intToDoc(5)));
 }
 
+TEST(LookupSetCacheTest, InsertKeyRecordsKeyWithNoValues) {
+    LookupSetCache cache(defaultComparator);
+    cache.insertKey(Value(0));
+    cache.insert(Value(1), intToDoc(1));
+    cache.insertKey(Value(1));
+
+    ASSERT(cache[Value(0)]);
+    ASSERT_TRUE(cache[Value(0)]->empty());
+    ASSERT_EQ(1U, cache[Value(1)]->size());
+    ASSERT_TRUE(vectorContains(cache[Value(1)], intToDoc(1)));
+    ASSERT_FALSE(cache[Value(2)]);
+}
+
 TEST(LookupSetCacheTest, CacheDoesEvictInExpectedOrder) {
     LookupSetCache cache(defaultComparator);
 
@@ -283,6 +283,29 @@ TEST(ParsedAddFieldsExecutionTest, AddsNewFieldToEndOfDocument) {
 }
 
 // Verify that an existing field is replaced and stays in the same order in the document.
+TEST(ParsedAddFieldsExecutionTest, ComputesOptimizedExpressionsForEachDocument) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    ParsedAddFields addition(expCtx);
+    addition.parse(fromjson(
+        "{total: {$add: ['$a', {$multiply: ['$b', 2]}]}, 'x.big': {$cond: [{$gt: ['$a', 1]}, "
+        "true, false]}}"));
+    addition.optimize();
+
+    auto result = addition.applyProjection(Document{{"a", 1}, {"b", 2}});
+    auto expectedResult =
+        Document{{"a", 1}, {"b", 2}, {"total", 5}, {"x", Document{{"big", false}}}};
+    ASSERT_DOCUMENT_EQ(result, expectedResult);
+
+    result = addition.applyProjection(Document{{"a", 3}, {"b", 0.5}, {"x", Document{{"y", 1}}}});
+    expectedResult =
+        Document{{"a", 3}, {"b", 0.5}, {"x", Document{{"y", 1}, {"big", true}}}, {"total", 4.0}};
+    ASSERT_DOCUMENT_EQ(result, expectedResult);
+
+    result = addition.applyProjection(Document{{"b", 1}});
+    expectedResult = Document{{"b", 1}, {"total", BSONNULL}, {"x", Document{{"big", false}}}};
+    ASSERT_DOCUMENT_EQ(result, expectedResult);
+}
+
 TEST(ParsedAddFieldsExecutionTest, ReplacesFieldThatAlreadyExistsInDocument) {
     boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
     ParsedAddFields addition(expCtx);
@@ -46,8 +46,12 @@ using std::unique_ptr;
 InclusionNode::InclusionNode(std::string pathToNode) : _pathToNode(std::move(pathToNode)) {}
 
 void InclusionNode::optimize() {
+    _programs.clear();
     for (auto&& expressionIt : _expressions) {
         _expressions[expressionIt.first] = expressionIt.second->optimize();
+        if (auto program = ExpressionProgram::compile(_expressions[expressionIt.first])) {
+            _programs[expressionIt.first] = std::move(program);
+        }
     }
     for (auto&& childPair : _children) {
         childPair.second->optimize();
@@ -148,6 +152,12 @@ void InclusionNode::addComputedFields(MutableDocument* outputDoc, const Document
             outputDoc->setField(field,
                                 childIt->second->addComputedFields(outputDoc->peek()[field], root));
         } else {
+            auto programIt = _programs.find(field);
+            if (programIt != _programs.end()) {
+                outputDoc->setField(field, programIt->second->evaluate(root));
+                continue;
+            }
+
             auto expressionIt = _expressions.find(field);
             invariant(expressionIt != _expressions.end());
             outputDoc->setField(field, expressionIt->second->evaluate(root));
@@ -194,6 +204,7 @@ void InclusionNode::addComputedField(const FieldPath& path, boost::intrusive_ptr
     if (path.getPathLength() == 1) {
         auto fieldName = path.fullPath();
         _expressions[fieldName] = expr;
+        _programs.erase(fieldName);
         _orderToProcessAdditionsAndChildren.push_back(fieldName);
         return;
     }
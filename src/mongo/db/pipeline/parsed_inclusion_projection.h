@@ -32,6 +32,7 @@
 
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/expression_program.h"
 #include "mongo/db/pipeline/parsed_aggregation_projection.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/unordered_map.h"
@@ -55,7 +56,7 @@ public:
     InclusionNode(std::string pathToNode = "");
 
     /**
-     * Optimize any computed expressions.
+     * Optimize any computed expressions, and compile those that can be into ExpressionPrograms.
      */
     void optimize();
 
@@ -169,6 +170,11 @@ private:
     std::vector<std::string> _orderToProcessAdditionsAndChildren;
 
     StringMap<boost::intrusive_ptr<Expression>> _expressions;
+
+    // Compiled forms of the optimized '_expressions', used in their place to compute each field.
+    // Only present for expressions that ExpressionProgram::compile() could lower.
+    stdx::unordered_map<std::string, std::unique_ptr<ExpressionProgram>> _programs;
+
     stdx::unordered_set<std::string> _inclusions;
 
     // TODO use StringMap once SERVER-23700 is resolved.
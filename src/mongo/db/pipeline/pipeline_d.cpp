@@ -38,6 +38,7 @@
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/document_validation.h"
+#include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
@@ -47,11 +48,14 @@
 #include "mongo/db/exec/multi_iterator.h"
 #include "mongo/db/exec/shard_filter.h"
 #include "mongo/db/exec/working_set.h"
+#include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/index/index_access_method.h"
+#include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/matcher/extensions_callback_real.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_cursor.h"
+#include "mongo/db/pipeline/document_source_group.h"
 #include "mongo/db/pipeline/document_source_match.h"
 #include "mongo/db/pipeline/document_source_merge_cursors.h"
 #include "mongo/db/pipeline/document_source_sample.h"
@@ -60,9 +64,14 @@
 #include "mongo/db/pipeline/document_source_sort.h"
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/db/query/explain.h"
 #include "mongo/db/query/get_executor.h"
+#include "mongo/db/query/parameterized_equality_plan.h"
+#include "mongo/db/query/parsed_distinct.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_memory_budget.h"
 #include "mongo/db/query/query_planner.h"
+#include "mongo/db/query/query_stats_store.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/sharded_connection_info.h"
 #include "mongo/db/s/sharding_state.h"
@@ -72,6 +81,7 @@
 #include "mongo/db/stats/top.h"
 #include "mongo/db/storage/record_store.h"
 #include "mongo/db/storage/sorted_data_interface.h"
+#include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/rpc/metadata/client_metadata_ismaster.h"
 #include "mongo/s/chunk_version.h"
 #include "mongo/stdx/memory.h"
@@ -85,6 +95,91 @@ using std::string;
 using std::unique_ptr;
 
 namespace {
+/**
+ * Runs equality queries by rebinding their values into a ParameterizedEqualityPlan, which is made
+ * when the query first runs and made again whenever the indexes it was made for change.
+ */
+class PreparedEqualityQueryImpl final
+    : public DocumentSourceNeedsMongod::MongodInterface::PreparedEqualityQuery {
+public:
+    PreparedEqualityQueryImpl(NamespaceString nss,
+                              std::string fieldName,
+                              BSONObj filter,
+                              intrusive_ptr<ExpressionContext> expCtx)
+        : _nss(std::move(nss)),
+          _fieldName(std::move(fieldName)),
+          _filter(filter.getOwned()),
+          _expCtx(std::move(expCtx)) {}
+
+    bool execute(const std::vector<Value>& values,
+                 const stdx::function<void(Document)>& onMatch) final {
+        invariant(!values.empty());
+        OperationContext* opCtx = _expCtx->opCtx;
+        AutoGetCollectionForReadCommand autoColl(opCtx, _nss);
+
+        // Sharded collections are refused by the query the caller falls back to.
+        Collection* collection = autoColl.getCollection();
+        if (!collection || CollectionShardingState::get(opCtx, _nss)->getMetadata()) {
+            return false;
+        }
+
+        BSONArrayBuilder valuesBuilder;
+        for (auto&& value : values) {
+            valuesBuilder << value;
+        }
+        const BSONObj valuesObj = valuesBuilder.arr();
+
+        if (_plan && !_plan->isValid(opCtx, collection)) {
+            _plan.reset();
+        }
+        if (!_plan) {
+            // Don't try planning again for every query until the number of indexes changes.
+            const int numIndexes = collection->getIndexCatalog()->numIndexesTotal(opCtx);
+            if (numIndexes == _numIndexesWithoutPlan) {
+                return false;
+            }
+
+            // Use the collation of the pipeline, as attemptToGetExecutor() does.
+            const BSONObj collation = _expCtx->getCollator()
+                ? _expCtx->getCollator()->getSpec().toBSON()
+                : _expCtx->collation;
+            _plan = ParameterizedEqualityPlan::make(
+                opCtx, collection, _fieldName, valuesObj.firstElement(), _filter, collation);
+            if (!_plan) {
+                _numIndexesWithoutPlan = numIndexes;
+                return false;
+            }
+        }
+
+        auto exec = _plan->bind(opCtx, collection, valuesObj, PlanExecutor::YIELD_AUTO);
+        if (!exec) {
+            return false;
+        }
+
+        BSONObj obj;
+        PlanExecutor::ExecState state;
+        while (PlanExecutor::ADVANCED == (state = exec->getNext(&obj, nullptr))) {
+            onMatch(Document(obj));
+        }
+        uassert(ErrorCodes::OperationFailed,
+                str::stream() << "Executor error during $lookup: "
+                              << WorkingSetCommon::toStatusString(obj),
+                state != PlanExecutor::FAILURE && state != PlanExecutor::DEAD);
+        return true;
+    }
+
+private:
+    const NamespaceString _nss;
+    const std::string _fieldName;
+    const BSONObj _filter;
+    const intrusive_ptr<ExpressionContext> _expCtx;
+
+    std::unique_ptr<ParameterizedEqualityPlan> _plan;
+
+    // How many indexes the collection had when a plan last couldn't be made, or -1.
+    int _numIndexesWithoutPlan = -1;
+};
+
 class MongodImplementation final : public DocumentSourceNeedsMongod::MongodInterface {
 public:
     MongodImplementation(const intrusive_ptr<ExpressionContext>& ctx)
@@ -116,6 +211,53 @@ public:
         return _client.getLastErrorDetailed();
     }
 
+    Status update(const NamespaceString& ns,
+                  const std::vector<BSONObj>& queries,
+                  const std::vector<BSONObj>& updates,
+                  bool upsert,
+                  bool multi) final {
+        invariant(queries.size() == updates.size());
+        boost::optional<DisableDocumentValidation> maybeDisableValidation;
+        if (_ctx->bypassDocumentValidation)
+            maybeDisableValidation.emplace(_ctx->opCtx);
+
+        // The largest number of statements a single write command may hold.
+        const size_t kMaxWriteBatchSize = 1000;
+
+        size_t next = 0;
+        while (next < queries.size()) {
+            BSONObjBuilder cmd;
+            cmd.append("update", ns.coll());
+            cmd.append("ordered", true);
+            BSONArrayBuilder statements(cmd.subarrayStart("updates"));
+            const size_t batchStart = next;
+            while (next < queries.size() && next - batchStart < kMaxWriteBatchSize &&
+                   (next == batchStart ||
+                    statements.len() + queries[next].objsize() + updates[next].objsize() <
+                        BSONObjMaxUserSize)) {
+                statements.append(BSON("q" << queries[next] << "u" << updates[next] << "upsert"
+                                           << upsert
+                                           << "multi"
+                                           << multi));
+                ++next;
+            }
+            statements.done();
+
+            BSONObj reply;
+            _client.runCommand(ns.db().toString(), cmd.done(), reply);
+            auto status = getStatusFromCommandResult(reply);
+            if (!status.isOK()) {
+                return status;
+            }
+            if (auto writeErrors = reply["writeErrors"]) {
+                BSONObj firstError = writeErrors.Obj().firstElement().Obj();
+                return {ErrorCodes::fromInt(firstError["code"].numberInt()),
+                        firstError["errmsg"].str()};
+            }
+        }
+        return Status::OK();
+    }
+
     CollectionIndexUsageMap getIndexStats(OperationContext* opCtx,
                                           const NamespaceString& ns) final {
         AutoGetCollectionForReadCommand autoColl(opCtx, ns);
@@ -129,6 +271,15 @@ public:
         return collection->infoCache()->getIndexUsageStats();
     }
 
+    std::vector<BSONObj> getQueryStats(const NamespaceString& ns) const final {
+        std::vector<BSONObj> stats;
+        for (const auto& shape :
+             QueryStatsStore::get(_ctx->opCtx->getServiceContext()).getStats(ns)) {
+            stats.push_back(shape.toBSON());
+        }
+        return stats;
+    }
+
     void appendLatencyStats(const NamespaceString& nss,
                             bool includeHistograms,
                             BSONObjBuilder* builder) const final {
@@ -142,6 +293,38 @@ public:
         return appendCollectionStorageStats(_ctx->opCtx, nss, param, builder);
     }
 
+    Status appendCacheStats(const NamespaceString& nss, BSONObjBuilder* builder) const final {
+        return appendCollectionCacheStats(_ctx->opCtx, nss, builder);
+    }
+
+    boost::optional<CollectionSummary> getCollectionSummary(const NamespaceString& nss) final {
+        AutoGetCollectionForReadCommand autoColl(_ctx->opCtx, nss);
+
+        Collection* collection = autoColl.getCollection();
+        if (!collection) {
+            return boost::none;
+        }
+
+        CollectionSummary summary;
+        summary.numRecords = collection->numRecords(_ctx->opCtx);
+        summary.dataSizeBytes = collection->dataSize(_ctx->opCtx);
+        IndexCatalog::IndexIterator it =
+            collection->getIndexCatalog()->getIndexIterator(_ctx->opCtx, false);
+        while (it.more()) {
+            summary.indexKeyPatterns.push_back(it.next()->keyPattern().getOwned());
+        }
+        return summary;
+    }
+
+    std::unique_ptr<PreparedEqualityQuery> prepareEqualityQuery(
+        const NamespaceString& nss,
+        const std::string& fieldName,
+        const BSONObj& filter,
+        const boost::intrusive_ptr<ExpressionContext>& expCtx) final {
+        invariant(_ctx->opCtx == expCtx->opCtx);
+        return stdx::make_unique<PreparedEqualityQueryImpl>(nss, fieldName, filter, expCtx);
+    }
+
     BSONObj getCollectionOptions(const NamespaceString& nss) final {
         const auto infos =
             _client.getCollectionInfos(nss.db().toString(), BSON("name" << nss.coll()));
@@ -267,6 +450,7 @@ public:
                 }
 
                 CurOp::get(clientOpCtx)->reportState(&infoBuilder);
+                QueryMemoryBudget::appendOperationUsage(clientOpCtx, &infoBuilder);
 
                 Locker::LockerInfo lockerInfo;
                 clientOpCtx->lockState()->getLockerInfo(&lockerInfo);
@@ -409,6 +593,83 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> attemptToGetExe
     return getExecutor(
         opCtx, collection, std::move(cq.getValue()), PlanExecutor::YIELD_AUTO, plannerOpts);
 }
+
+bool containsStage(PlanStage* root, StageType type) {
+    if (root->stageType() == type) {
+        return true;
+    }
+    for (auto&& child : root->getChildren()) {
+        if (containsStage(child.get(), type)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Returns true if 'exec' reads at least one index and none of the indexes it reads is multikey
+ * or, when 'rejectSparse' is true, sparse.
+ */
+bool usesOnlyIndexesWithOneKeyPerDocument(OperationContext* opCtx,
+                                          Collection* collection,
+                                          const PlanExecutor& exec,
+                                          bool rejectSparse) {
+    PlanSummaryStats stats;
+    Explain::getSummaryStats(exec, &stats);
+    if (stats.indexesUsed.empty()) {
+        return false;
+    }
+
+    for (auto&& indexName : stats.indexesUsed) {
+        const IndexDescriptor* desc =
+            collection->getIndexCatalog()->findIndexByName(opCtx, indexName);
+        if (!desc || desc->isMultikey(opCtx) || (rejectSparse && desc->isSparse())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Attempts to build a PlanExecutor that returns one document for each distinct value of 'field'
+ * among the documents matching 'queryObj', by skipping through an index with a DISTINCT_SCAN.
+ * Returns nullptr if the query system cannot answer the query this way.
+ *
+ * Unlike the distinct command, a $group keeps documents missing 'field' as a null group, so the
+ * index must not be sparse; and it groups an array as a whole, so the index must not be multikey.
+ */
+std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> attemptToGetDistinctScanExecutor(
+    OperationContext* opCtx,
+    Collection* collection,
+    const intrusive_ptr<ExpressionContext>& pExpCtx,
+    const BSONObj& queryObj,
+    const std::string& field) {
+    auto qr = stdx::make_unique<QueryRequest>(pExpCtx->ns);
+    qr->setFilter(queryObj);
+    qr->setCollation(pExpCtx->getCollator() ? pExpCtx->getCollator()->getSpec().toBSON()
+                                            : pExpCtx->collation);
+
+    const ExtensionsCallbackReal extensionsCallback(pExpCtx->opCtx, &pExpCtx->ns);
+
+    auto cq = CanonicalQuery::canonicalize(opCtx, std::move(qr), extensionsCallback);
+    if (!cq.isOK()) {
+        return nullptr;
+    }
+
+    ParsedDistinct parsedDistinct(std::move(cq.getValue()), field);
+    auto swExec = getExecutorDistinct(
+        opCtx, collection, pExpCtx->ns.ns(), &parsedDistinct, PlanExecutor::YIELD_AUTO);
+    if (!swExec.isOK()) {
+        return nullptr;
+    }
+
+    auto exec = std::move(swExec.getValue());
+    if (!containsStage(exec->getRootStage(), STAGE_DISTINCT_SCAN) ||
+        !usesOnlyIndexesWithOneKeyPerDocument(opCtx, collection, *exec, true)) {
+        return nullptr;
+    }
+    return exec;
+}
 }  // namespace
 
 void PipelineD::prepareCursorSource(Collection* collection,
@@ -481,6 +742,25 @@ void PipelineD::prepareCursorSource(Collection* collection,
 
     BSONObj projForQuery = deps.toProjection();
 
+    // A $group that only computes distinct values of one field needs a single document per value,
+    // which a DISTINCT_SCAN can deliver without visiting the rest of the index. The distinct
+    // planner neither applies a hint nor filters out orphaned documents, so it is not used when
+    // either matters.
+    const bool hasHint = aggRequest && !aggRequest->getHint().isEmpty();
+    if (collection && !sources.empty() && !hasHint &&
+        !ShardingState::get(expCtx->opCtx)->needCollectionMetadata(expCtx->opCtx,
+                                                                    expCtx->ns.ns())) {
+        auto groupStage = dynamic_cast<DocumentSourceGroup*>(sources.front().get());
+        auto distinctField = groupStage ? groupStage->getDistinctScanField() : boost::none;
+        if (distinctField) {
+            if (auto exec = attemptToGetDistinctScanExecutor(
+                    expCtx->opCtx, collection, expCtx, queryObj, *distinctField)) {
+                addCursorSource(collection, pipeline, expCtx, std::move(exec), deps, queryObj);
+                return;
+            }
+        }
+    }
+
     /*
       Look for an initial sort; we'll try to add this to the
       Cursor we create.  If we're successful in doing that (further down),
@@ -522,6 +802,17 @@ void PipelineD::prepareCursorSource(Collection* collection,
         }
     }
 
+    // A $group reading input sorted on its _id fields can return each group as soon as the next
+    // one starts, instead of holding all groups in memory. This depends on documents with equal
+    // sort keys being adjacent, which only holds for indexes with a single key per document.
+    if (!sources.empty()) {
+        auto groupStage = dynamic_cast<DocumentSourceGroup*>(sources.front().get());
+        if (groupStage &&
+            usesOnlyIndexesWithOneKeyPerDocument(expCtx->opCtx, collection, *exec, false)) {
+            groupStage->allowStreaming();
+        }
+    }
+
     addCursorSource(
         collection, pipeline, expCtx, std::move(exec), deps, queryObj, sortObj, projForQuery);
 }
@@ -570,6 +861,12 @@ StatusWith<std::unique_ptr<PlanExecutor, PlanExecutor::Deleter>> PipelineD::prep
         plannerOpts |= QueryPlannerParams::IS_COUNT;
     }
 
+    // An initial $match that can't use an index means filtering every document in the collection,
+    // which the collection scan may spread over several threads.
+    if (!queryObj.isEmpty()) {
+        plannerOpts |= QueryPlannerParams::PARALLEL_COLLSCAN;
+    }
+
     // The only way to get a text score is to let the query system handle the projection. In all
     // other cases, unless the query system can do an index-covered projection and avoid going to
     // the raw record at all, it is faster to have ParsedDeps filter the fields we need.
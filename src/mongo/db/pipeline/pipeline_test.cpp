@@ -113,6 +113,24 @@ TEST(PipelineOptimizationTest, MoveMultipleSkipsAndLimitsBeforeProject) {
                               "[{$limit : 5}, {$skip : 3}, {$project: {_id: true, a : true}}]");
 }
 
+TEST(PipelineOptimizationTest, SortAddFieldsLimitBecomesTopKSortAddFields) {
+    std::string inputPipe =
+        "[{$sort: {a: 1}}"
+        ",{$addFields: {b: '$a'}}"
+        ",{$limit: 5}"
+        "]";
+    std::string outputPipe =
+        "[{$sort: {sortKey: {a: 1}, limit: 5}}"
+        ",{$addFields: {b: '$a'}}"
+        "]";
+    std::string serializedPipe =
+        "[{$sort: {a: 1}}"
+        ",{$limit: 5}"
+        ",{$addFields: {b: '$a'}}"
+        "]";
+    assertPipelineOptimizesAndSerializesTo(inputPipe, outputPipe, serializedPipe);
+}
+
 TEST(PipelineOptimizationTest, MoveMatchBeforeAddFieldsIfInvolvedFieldsNotRelated) {
     assertPipelineOptimizesTo("[{$addFields : {a : 1}}, {$match : {b : 1}}]",
                               "[{$match : {b : 1}}, {$addFields : {a : {$const : 1}}}]");
@@ -325,6 +343,41 @@ TEST(PipelineOptimizationTest, LookupWithPipelineSyntaxShouldSwapWithMatch) {
     assertPipelineOptimizesTo(inputPipe, outputPipe);
 }
 
+TEST(PipelineOptimizationTest, LookupShouldSwapWithSkipAndLimit) {
+    string inputPipe =
+        "[{$lookup: {from: 'lookupColl', as: 'asField', localField: 'y', foreignField: "
+        "'z'}}, "
+        " {$skip: 2}, "
+        " {$limit: 3}]";
+    string outputPipe =
+        "[{$limit: 5}, "
+        " {$skip: 2}, "
+        " {$lookup: {from: 'lookupColl', as: 'asField', localField: 'y', foreignField: "
+        "'z'}}]";
+    assertPipelineOptimizesTo(inputPipe, outputPipe);
+}
+
+TEST(PipelineOptimizationTest, LookupCoalescedWithUnwindShouldNotSwapWithLimit) {
+    string inputPipe =
+        "[{$lookup: {from : 'lookupColl', as : 'same', localField: 'left', foreignField: "
+        "'right'}}"
+        ",{$unwind: {path: '$same'}}"
+        ",{$limit: 3}"
+        "]";
+    string outputPipe =
+        "[{$lookup: {from : 'lookupColl', as : 'same', localField: 'left', foreignField: "
+        "'right', unwinding: {preserveNullAndEmptyArrays: false}}}"
+        ",{$limit: 3}"
+        "]";
+    string serializedPipe =
+        "[{$lookup: {from : 'lookupColl', as : 'same', localField: 'left', foreignField: "
+        "'right'}}"
+        ",{$unwind: {path: '$same'}}"
+        ",{$limit: 3}"
+        "]";
+    assertPipelineOptimizesAndSerializesTo(inputPipe, outputPipe, serializedPipe);
+}
+
 TEST(PipelineOptimizationTest, LookupShouldSplitMatch) {
     string inputPipe =
         "[{$lookup: {from: 'lookupColl', as: 'asField', localField: 'y', foreignField: "
@@ -642,6 +695,57 @@ TEST(PipelineOptimizationTest, UnwindBeforeDoubleMatchShouldRepeatedlyOptimize)
     assertPipelineOptimizesTo(inputPipe, outputPipe);
 }
 
+TEST(PipelineOptimizationTest, GroupShouldAbsorbUnwindWhenReadingOnlyPathsIntoAndBesideIt) {
+    string inputPipe =
+        "[{$unwind: '$a'}, "
+        "{$group: {_id: '$a.b', total: {$sum: '$a.c'}, xs: {$addToSet: '$x'}}}]";
+    string outputPipe =
+        "[{$group: {_id: '$a.b', total: {$sum: '$a.c'}, xs: {$addToSet: '$x'}, "
+        "$unwinding: {path: '$a'}}}]";
+    string serializedPipe =
+        "[{$unwind: {path: '$a'}}, "
+        "{$group: {_id: '$a.b', total: {$sum: '$a.c'}, xs: {$addToSet: '$x'}}}]";
+    assertPipelineOptimizesAndSerializesTo(inputPipe, outputPipe, serializedPipe);
+}
+
+TEST(PipelineOptimizationTest, GroupShouldNotAbsorbUnwindWhenReadingAPrefixOfTheUnwoundPath) {
+    string inputPipe = "[{$unwind: '$a.b'}, {$group: {_id: '$a'}}]";
+    string outputPipe = "[{$unwind: {path: '$a.b'}}, {$group: {_id: '$a'}}]";
+    assertPipelineOptimizesTo(inputPipe, outputPipe);
+}
+
+TEST(PipelineOptimizationTest, GroupShouldNotAbsorbUnwindWhenReadingTheWholeDocument) {
+    string inputPipe = "[{$unwind: '$a'}, {$group: {_id: '$$ROOT'}}]";
+    string outputPipe = "[{$unwind: {path: '$a'}}, {$group: {_id: '$$ROOT'}}]";
+    assertPipelineOptimizesTo(inputPipe, outputPipe);
+}
+
+TEST(PipelineOptimizationTest, GroupShouldNotAbsorbUnwindWithIncludeArrayIndex) {
+    string inputPipe = "[{$unwind: {path: '$a', includeArrayIndex: 'i'}}, {$group: {_id: '$a'}}]";
+    string outputPipe = "[{$unwind: {path: '$a', includeArrayIndex: 'i'}}, {$group: {_id: '$a'}}]";
+    assertPipelineOptimizesTo(inputPipe, outputPipe);
+}
+
+TEST(PipelineOptimizationTest, SortGraphLookupLimitBecomesTopKSortGraphLookup) {
+    string inputPipe =
+        "[{$sort: {a: 1}}, "
+        " {$graphLookup: {from: 'lookupColl', as: 'out', connectToField: 'b', "
+        "                 connectFromField: 'c', startWith: '$d'}}, "
+        " {$limit: 4}]";
+
+    string outputPipe =
+        "[{$sort: {sortKey: {a: 1}, limit: 4}}, "
+        " {$graphLookup: {from: 'lookupColl', as: 'out', connectToField: 'b', "
+        "                 connectFromField: 'c', startWith: '$d'}}]";
+
+    string serializedPipe =
+        "[{$sort: {a: 1}}, "
+        " {$limit: 4}, "
+        " {$graphLookup: {from: 'lookupColl', as: 'out', connectToField: 'b', "
+        "                 connectFromField: 'c', startWith: '$d'}}]";
+    assertPipelineOptimizesAndSerializesTo(inputPipe, outputPipe, serializedPipe);
+}
+
 TEST(PipelineOptimizationTest, GraphLookupShouldCoalesceWithUnwindOnAs) {
     string inputPipe =
         "[{$graphLookup: {from: 'lookupColl', as: 'out', connectToField: 'b', "
@@ -58,11 +58,23 @@ public:
         MONGO_UNREACHABLE;
     }
 
+    Status update(const NamespaceString& ns,
+                  const std::vector<BSONObj>& queries,
+                  const std::vector<BSONObj>& updates,
+                  bool upsert,
+                  bool multi) override {
+        MONGO_UNREACHABLE;
+    }
+
     CollectionIndexUsageMap getIndexStats(OperationContext* opCtx,
                                           const NamespaceString& ns) override {
         MONGO_UNREACHABLE;
     }
 
+    std::vector<BSONObj> getQueryStats(const NamespaceString& ns) const override {
+        MONGO_UNREACHABLE;
+    }
+
     void appendLatencyStats(const NamespaceString& nss,
                             bool includeHistograms,
                             BSONObjBuilder* builder) const override {
@@ -75,6 +87,22 @@ public:
         MONGO_UNREACHABLE;
     }
 
+    Status appendCacheStats(const NamespaceString& nss, BSONObjBuilder* builder) const override {
+        MONGO_UNREACHABLE;
+    }
+
+    boost::optional<CollectionSummary> getCollectionSummary(const NamespaceString& nss) override {
+        MONGO_UNREACHABLE;
+    }
+
+    std::unique_ptr<PreparedEqualityQuery> prepareEqualityQuery(
+        const NamespaceString& nss,
+        const std::string& fieldName,
+        const BSONObj& filter,
+        const boost::intrusive_ptr<ExpressionContext>& expCtx) override {
+        MONGO_UNREACHABLE;
+    }
+
     BSONObj getCollectionOptions(const NamespaceString& nss) override {
         MONGO_UNREACHABLE;
     }
@@ -65,16 +65,30 @@ public:
     void dispose(size_t consumerId) {
         _consumers[consumerId].stillInUse = false;
         _consumers[consumerId].nLeftToReturn = 0;
-        if (std::none_of(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
-                return info.stillInUse;
-            })) {
-            _buffer.clear();
-            if (_source) {
-                _source->dispose();
-            }
+        if (_loadsOnDemand) {
+            disposeSourceIfUnused();
         }
     }
 
+    /**
+     * When 'loadsOnDemand' is false, getNext() stops loading batches itself. Once a consumer has
+     * returned the whole batch it pauses until the next call to loadBatchForConsumers(), and it
+     * returns EOF once that call finds the input exhausted. getNext() and dispose() then only
+     * touch the calling consumer's own state and read the shared batch, which lets consumers run
+     * on other threads while the source is only used from the thread calling
+     * loadBatchForConsumers().
+     */
+    void setLoadsOnDemand(bool loadsOnDemand) {
+        _loadsOnDemand = loadsOnDemand;
+    }
+
+    /**
+     * For use while getNext() does not load on demand, and no consumer is running. Disposes of
+     * the source if no consumer is still in use, and otherwise replaces the batch with the next
+     * one. Returns false once the input is exhausted.
+     */
+    bool loadBatchForConsumers();
+
     /**
      * Retrieves the next document meant to be consumed by the pipeline given by 'consumerId'.
      * Returns GetNextState::ResultState::kPauseExecution if this pipeline has consumed the whole
@@ -92,8 +106,13 @@ private:
      */
     void loadNextBatch();
 
+    void disposeSourceIfUnused();
+
     DocumentSource* _source = nullptr;
 
+    bool _loadsOnDemand = true;
+    bool _exhausted = false;
+
     const size_t _bufferSizeBytes;
     std::vector<DocumentSource::GetNextResult> _buffer;
 
@@ -43,6 +43,7 @@
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
 #include "mongo/db/stats/timer_stats.h"
 #include "mongo/db/storage/mmap_v1/mmap.h"
 #include "mongo/util/log.h"
@@ -170,10 +171,11 @@ void prefetchPagesForReplicatedOp(OperationContext* opCtx, Database* db, const B
     BSONObj obj = op.getObjectField(opField);
     const char* ns = op.getStringField("ns");
 
-    // This will have to change for engines other than MMAP V1, because they might not have
-    // means for directly prefetching pages from the collection. For this purpose, acquire S
-    // lock on the database, instead of optimizing with IS.
-    Lock::CollectionLock collLock(opCtx->lockState(), ns, MODE_S);
+    // MMAPv1 has no means of directly prefetching pages from the collection, so it takes an S lock
+    // to keep the collection stable while faulting them in. Document-level locking engines only
+    // issue cursor searches into the indexes and the record store, for which IS is sufficient and
+    // does not block the writer threads applying the batch.
+    Lock::CollectionLock collLock(opCtx->lockState(), ns, supportsDocLocking() ? MODE_IS : MODE_S);
 
     Collection* collection = db->getCollection(opCtx, ns);
     if (!collection) {
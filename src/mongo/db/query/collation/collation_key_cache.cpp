@@ -0,0 +1,83 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/collation/collation_key_cache.h"
+
+#include "mongo/base/simple_string_data_comparator.h"
+#include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+CollationKeyCache::CollationKeyCache(const CollatorInterface* collator) : _collator(collator) {
+    invariant(_collator);
+}
+
+void CollationKeyCache::_makeRoom() const {
+    if (_cachedBytes >= kMaxCachedBytes) {
+        _keys.clear();
+        _cachedBytes = 0;
+    }
+}
+
+void CollationKeyCache::_cache(const StringMap<std::string>::HashedKey& str) const {
+    if (_keys.find(str) != _keys.end()) {
+        return;
+    }
+
+    std::string& key = _keys[str];
+    key = _collator->getComparisonKey(str.key()).getKeyData().toString();
+    _cachedBytes += str.key().size() + key.size();
+}
+
+int CollationKeyCache::compare(StringData left, StringData right) const {
+    // Equal strings are equal under every collation.
+    if (left == right) {
+        return 0;
+    }
+
+    _makeRoom();
+    const StringMap<std::string>::HashedKey leftKey(left);
+    const StringMap<std::string>::HashedKey rightKey(right);
+    _cache(leftKey);
+    _cache(rightKey);
+
+    // Caching 'rightKey' may have moved the key of 'leftKey', so look both up only now.
+    return StringData(_keys.find(leftKey)->second).compare(_keys.find(rightKey)->second);
+}
+
+void CollationKeyCache::hash_combine(size_t& seed, StringData stringToHash) const {
+    _makeRoom();
+    const StringMap<std::string>::HashedKey key(stringToHash);
+    _cache(key);
+    SimpleStringDataComparator::kInstance.hash_combine(seed, _keys.find(key)->second);
+}
+
+}  // namespace mongo
@@ -0,0 +1,91 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/base/string_data_comparator_interface.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+class CollatorInterface;
+
+/**
+ * A string comparator which compares and hashes strings exactly like a collator does, but through
+ * their comparison keys, computing the key of each distinct string only once. Comparing two cached
+ * strings then costs a couple of hash lookups and a memcmp() instead of a collation comparison.
+ *
+ * Meant to live as long as a single operation. This class is not thread safe.
+ */
+class CollationKeyCache final : public StringData::ComparatorInterface {
+    MONGO_DISALLOW_COPYING(CollationKeyCache);
+
+public:
+    // The cache forgets all keys once it holds about this many bytes of strings and keys.
+    static const size_t kMaxCachedBytes = 16 * 1024 * 1024;
+
+    /**
+     * 'collator' must outlive this cache.
+     */
+    explicit CollationKeyCache(const CollatorInterface* collator);
+
+    int compare(StringData left, StringData right) const final;
+
+    void hash_combine(size_t& seed, StringData stringToHash) const final;
+
+    const CollatorInterface* getCollator() const {
+        return _collator;
+    }
+
+    size_t size() const {
+        return _keys.size();
+    }
+
+private:
+    /**
+     * Makes sure that the comparison key of 'str' is cached.
+     */
+    void _cache(const StringMap<std::string>::HashedKey& str) const;
+
+    /**
+     * Forgets all cached keys once they use too much memory. Call it before caching keys that
+     * must all be looked up afterwards, since it invalidates every cached key.
+     */
+    void _makeRoom() const;
+
+    const CollatorInterface* const _collator;
+
+    mutable StringMap<std::string> _keys;
+    mutable size_t _cachedBytes = 0;
+};
+
+}  // namespace mongo
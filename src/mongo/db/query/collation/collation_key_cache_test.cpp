@@ -0,0 +1,105 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/collation/collation_key_cache.h"
+
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/unittest.h"
+
+namespace {
+
+using namespace mongo;
+
+size_t hashOf(const StringData::ComparatorInterface& comparator, StringData str) {
+    size_t seed = 0;
+    comparator.hash_combine(seed, str);
+    return seed;
+}
+
+int sign(int cmp) {
+    return cmp < 0 ? -1 : (cmp > 0 ? 1 : 0);
+}
+
+TEST(CollationKeyCacheTest, ComparesLikeTheCollator) {
+    for (auto type : {CollatorInterfaceMock::MockType::kReverseString,
+                      CollatorInterfaceMock::MockType::kAlwaysEqual,
+                      CollatorInterfaceMock::MockType::kToLowerString}) {
+        CollatorInterfaceMock collator(type);
+        CollationKeyCache cache(&collator);
+        const StringData strs[] = {"", "a", "A", "ab", "ba", "AB", "abc", "b", "zzz"};
+        for (auto left : strs) {
+            for (auto right : strs) {
+                ASSERT_EQ(sign(collator.compare(left, right)), sign(cache.compare(left, right)));
+                // Compare again now that both keys are cached.
+                ASSERT_EQ(sign(collator.compare(left, right)), sign(cache.compare(left, right)));
+            }
+            ASSERT_EQ(hashOf(collator, left), hashOf(cache, left));
+        }
+    }
+}
+
+TEST(CollationKeyCacheTest, EqualStringsHashTheSame) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kToLowerString);
+    CollationKeyCache cache(&collator);
+    ASSERT_EQ(0, cache.compare("abc", "ABC"));
+    ASSERT_EQ(hashOf(cache, "abc"), hashOf(cache, "ABC"));
+    ASSERT_NE(hashOf(cache, "abc"), hashOf(cache, "abd"));
+}
+
+TEST(CollationKeyCacheTest, CachesOneKeyPerDistinctString) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
+    CollationKeyCache cache(&collator);
+    ASSERT_EQ(0, cache.compare("same", "same"));
+    ASSERT_EQ(0U, cache.size());
+
+    ASSERT_LT(cache.compare("ba", "ab"), 0);
+    ASSERT_GT(cache.compare("ab", "ba"), 0);
+    ASSERT_EQ(2U, cache.size());
+
+    hashOf(cache, "ab");
+    hashOf(cache, "cd");
+    ASSERT_EQ(3U, cache.size());
+}
+
+TEST(CollationKeyCacheTest, StaysCorrectWhenTheCacheIsFlushed) {
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
+    CollationKeyCache cache(&collator);
+    const std::string big(1024 * 1024, 'x');
+    std::string prev = "a" + big;
+    for (char c = 'b'; c <= 'z'; ++c) {
+        std::string next = c + big;
+        // Reversed, the strings differ in their last character.
+        ASSERT_LT(cache.compare(prev, next), 0);
+        prev = std::move(next);
+    }
+    ASSERT_LT(cache.size(), 26U);
+}
+
+}  // namespace
@@ -0,0 +1,200 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/collection_statistics.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/bson/dotted_path_support.h"
+
+namespace mongo {
+
+namespace dps = ::mongo::dotted_path_support;
+
+namespace {
+
+bool elementLessThan(const BSONElement& lhs, const BSONElement& rhs) {
+    return lhs.woCompare(rhs, false) < 0;
+}
+
+bool isNullPoint(const Interval& interval) {
+    return interval.isPoint() && jstNULL == interval.start.type();
+}
+
+}  // namespace
+
+FieldHistogram FieldHistogram::make(std::vector<BSONElement> values,
+                                    size_t numSampledDocs,
+                                    size_t numDocsWithField,
+                                    long long numRecords,
+                                    size_t numBuckets) {
+    FieldHistogram histogram;
+    if (values.empty() || 0 == numSampledDocs || 0 == numBuckets) {
+        return histogram;
+    }
+
+    std::sort(values.begin(), values.end(), elementLessThan);
+    histogram._fractionPresent = static_cast<double>(numDocsWithField) / numSampledDocs;
+
+    // Equi-depth boundaries: the minimum, then the value at the end of each of 'numBuckets'
+    // equally sized slices of the sorted sample.
+    numBuckets = std::min(numBuckets, values.size());
+    BSONArrayBuilder boundaries;
+    boundaries.append(values.front());
+    for (size_t i = 1; i <= numBuckets; ++i) {
+        boundaries.append(values[(i * values.size()) / numBuckets - 1]);
+    }
+    histogram._boundariesObj = boundaries.obj();
+    for (auto&& elem : histogram._boundariesObj) {
+        histogram._boundaries.push_back(elem);
+    }
+
+    // Estimate the number of distinct values with the "guaranteed error estimator": values seen
+    // more than once are assumed to be all there is of them, while values seen exactly once stand
+    // in for sqrt(N / n) distinct values each.
+    size_t numDistinct = 0;
+    size_t numSingletons = 0;
+    for (size_t i = 0; i < values.size();) {
+        size_t j = i + 1;
+        while (j < values.size() && values[i].woCompare(values[j], false) == 0) {
+            ++j;
+        }
+        ++numDistinct;
+        if (j - i == 1) {
+            ++numSingletons;
+        }
+        i = j;
+    }
+
+    const double numValues = static_cast<double>(values.size());
+    const double populationValues =
+        std::max(numValues, numValues * std::max(numRecords, 1LL) / numSampledDocs);
+    const double estimate = std::sqrt(populationValues / numValues) * numSingletons +
+        (numDistinct - numSingletons);
+    histogram._numDistinctValues =
+        std::min(std::max(estimate, static_cast<double>(numDistinct)), populationValues);
+    return histogram;
+}
+
+double FieldHistogram::_estimateRank(const BSONElement& value, bool inclusive) const {
+    size_t numBelow = 0;
+    for (auto&& boundary : _boundaries) {
+        const int cmp = boundary.woCompare(value, false);
+        if (cmp < 0 || (inclusive && cmp == 0)) {
+            ++numBelow;
+        }
+    }
+
+    // A value between boundaries j and j + 1 is assumed to sit in the middle of bucket j.
+    const double numBuckets = getNumBuckets();
+    return std::min(std::max((numBelow - 0.5) / numBuckets, 0.0), 1.0);
+}
+
+double FieldHistogram::estimateSelectivity(const Interval& interval) const {
+    if (_boundaries.empty()) {
+        // The field was never seen, so only a lookup of null can match.
+        return isNullPoint(interval) ? 1.0 : 0.0;
+    }
+
+    BSONElement low = interval.start;
+    BSONElement high = interval.end;
+    bool lowInclusive = interval.startInclusive;
+    bool highInclusive = interval.endInclusive;
+    if (low.woCompare(high, false) > 0) {
+        // Descending index scans list their intervals from high to low.
+        std::swap(low, high);
+        std::swap(lowInclusive, highInclusive);
+    }
+
+    double selectivity = _estimateRank(high, highInclusive) - _estimateRank(low, !lowInclusive);
+    if (interval.isPoint() && _boundaries.front().woCompare(low, false) <= 0 &&
+        _boundaries.back().woCompare(low, false) >= 0) {
+        // A value within the sampled range that does not show up across several buckets is
+        // assumed to be no more common than the average distinct value.
+        selectivity = std::max(selectivity, 1.0 / std::max(_numDistinctValues, 1.0));
+    }
+    selectivity = std::min(std::max(selectivity, 0.0), 1.0) * _fractionPresent;
+
+    // Documents missing the field are indexed as null.
+    if (isNullPoint(interval)) {
+        selectivity += 1 - _fractionPresent;
+    }
+    return selectivity;
+}
+
+void FieldHistogram::appendTo(BSONObjBuilder* builder) const {
+    builder->append("fractionPresent", _fractionPresent);
+    builder->append("numDistinctValues", _numDistinctValues);
+    builder->append("bucketBoundaries", BSONArray(_boundariesObj));
+}
+
+CollectionStatistics CollectionStatistics::make(const std::vector<BSONObj>& sample,
+                                                const std::vector<std::string>& fields,
+                                                long long numRecords,
+                                                size_t numBuckets) {
+    CollectionStatistics stats;
+    stats._numRecords = numRecords;
+    stats._numSampled = sample.size();
+
+    for (auto&& field : fields) {
+        std::vector<BSONElement> values;
+        size_t numDocsWithField = 0;
+        for (auto&& doc : sample) {
+            BSONElementSet docValues;
+            dps::extractAllElementsAlongPath(doc, field, docValues);
+            if (!docValues.empty()) {
+                ++numDocsWithField;
+            }
+            values.insert(values.end(), docValues.begin(), docValues.end());
+        }
+        stats._fields[field] = FieldHistogram::make(
+            std::move(values), sample.size(), numDocsWithField, numRecords, numBuckets);
+    }
+    return stats;
+}
+
+const FieldHistogram* CollectionStatistics::getField(StringData path) const {
+    auto it = _fields.find(path);
+    return it == _fields.end() ? nullptr : &it->second;
+}
+
+void CollectionStatistics::appendTo(BSONObjBuilder* builder) const {
+    builder->append("numRecords", _numRecords);
+    builder->append("numSampled", static_cast<long long>(_numSampled));
+    BSONObjBuilder fieldsBuilder(builder->subobjStart("fields"));
+    for (auto&& field : _fields) {
+        BSONObjBuilder fieldBuilder(fieldsBuilder.subobjStart(field.first));
+        field.second.appendTo(&fieldBuilder);
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,143 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/query/interval.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * An equi-depth histogram and distinct value estimate for one field path, built from a sample of
+ * a collection's documents. Values are ordered the way index keys are, without regard to any
+ * collation, and array values contribute each of their elements.
+ */
+class FieldHistogram {
+public:
+    static const size_t kDefaultNumBuckets = 32;
+
+    /**
+     * Builds a histogram with up to 'numBuckets' buckets.
+     *
+     * 'values' holds every value of the field found in the sample and need not be sorted.
+     * 'numSampledDocs' is the size of the sample and 'numDocsWithField' how many of those
+     * documents contained the field. 'numRecords' is the size of the collection, which is used
+     * to scale the number of distinct values seen in the sample up to the whole collection.
+     */
+    static FieldHistogram make(std::vector<BSONElement> values,
+                               size_t numSampledDocs,
+                               size_t numDocsWithField,
+                               long long numRecords,
+                               size_t numBuckets = kDefaultNumBuckets);
+
+    /**
+     * Returns the estimated fraction, in [0, 1], of the collection's documents with a value of
+     * this field that falls within 'interval'.
+     */
+    double estimateSelectivity(const Interval& interval) const;
+
+    /**
+     * Returns the estimated number of distinct values of this field in the collection.
+     */
+    double getNumDistinctValues() const {
+        return _numDistinctValues;
+    }
+
+    size_t getNumBuckets() const {
+        return _boundaries.empty() ? 0 : _boundaries.size() - 1;
+    }
+
+    void appendTo(BSONObjBuilder* builder) const;
+
+private:
+    /**
+     * Returns the estimated fraction of values less than 'value', or less than or equal to it if
+     * 'inclusive' is true.
+     */
+    double _estimateRank(const BSONElement& value, bool inclusive) const;
+
+    // Owns the data that '_boundaries' points into. Empty if the field was never seen.
+    BSONObj _boundariesObj;
+
+    // The minimum value followed by the upper bound of each bucket, in ascending order. Each
+    // bucket holds the same share of the sampled values.
+    std::vector<BSONElement> _boundaries;
+
+    // The fraction of sampled documents in which the field was present.
+    double _fractionPresent = 0;
+
+    double _numDistinctValues = 0;
+};
+
+/**
+ * Per-field statistics for a collection, as gathered by the 'analyze' command. Instances are
+ * immutable once built and shared between the collection's info cache and query planning.
+ */
+class CollectionStatistics {
+public:
+    /**
+     * Builds histograms for each path in 'fields' from the documents in 'sample', which were
+     * drawn from a collection holding 'numRecords' documents.
+     */
+    static CollectionStatistics make(const std::vector<BSONObj>& sample,
+                                     const std::vector<std::string>& fields,
+                                     long long numRecords,
+                                     size_t numBuckets = FieldHistogram::kDefaultNumBuckets);
+
+    /**
+     * Returns the histogram for 'path', or nullptr if it was not analyzed.
+     */
+    const FieldHistogram* getField(StringData path) const;
+
+    long long getNumRecords() const {
+        return _numRecords;
+    }
+
+    size_t getNumSampled() const {
+        return _numSampled;
+    }
+
+    /**
+     * Appends a summary of every field's histogram, keyed by field path.
+     */
+    void appendTo(BSONObjBuilder* builder) const;
+
+private:
+    long long _numRecords = 0;
+    size_t _numSampled = 0;
+    StringMap<FieldHistogram> _fields;
+};
+
+}  // namespace mongo
@@ -0,0 +1,146 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/collection_statistics.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/json.h"
+#include "mongo/db/query/index_bounds_builder.h"
+#include "mongo/unittest/unittest.h"
+
+namespace {
+
+using namespace mongo;
+
+/**
+ * Builds 'numDocs' documents of the form {a: i % numDistinct, b: i}.
+ */
+std::vector<BSONObj> makeSample(int numDocs, int numDistinct) {
+    std::vector<BSONObj> sample;
+    for (int i = 0; i < numDocs; ++i) {
+        sample.push_back(BSON("a" << i % numDistinct << "b" << i));
+    }
+    return sample;
+}
+
+Interval pointInterval(int value) {
+    return IndexBoundsBuilder::makePointInterval(BSON("" << value));
+}
+
+Interval rangeInterval(int start, int end) {
+    return IndexBoundsBuilder::makeRangeInterval(BSON("" << start << "" << end),
+                                                 BoundInclusion::kIncludeBothStartAndEndKeys);
+}
+
+TEST(CollectionStatisticsTest, DistinctValuesOfFullSample) {
+    auto stats = CollectionStatistics::make(makeSample(100, 10), {"a", "b"}, 100);
+    ASSERT_EQUALS(stats.getNumSampled(), 100U);
+
+    const FieldHistogram* a = stats.getField("a");
+    ASSERT(a);
+    ASSERT_EQUALS(a->getNumDistinctValues(), 10.0);
+
+    const FieldHistogram* b = stats.getField("b");
+    ASSERT(b);
+    ASSERT_EQUALS(b->getNumDistinctValues(), 100.0);
+
+    ASSERT_FALSE(stats.getField("c"));
+}
+
+TEST(CollectionStatisticsTest, DistinctValuesScaleWithCollectionSize) {
+    // Every sampled value of 'b' is unique, so a collection ten times the size of the sample is
+    // assumed to hold more distinct values than the sample does.
+    auto stats = CollectionStatistics::make(makeSample(100, 10), {"b"}, 1000);
+    ASSERT_GT(stats.getField("b")->getNumDistinctValues(), 100.0);
+    ASSERT_LTE(stats.getField("b")->getNumDistinctValues(), 1000.0);
+}
+
+TEST(CollectionStatisticsTest, RangeSelectivityFollowsDistribution) {
+    auto stats = CollectionStatistics::make(makeSample(1000, 10), {"b"}, 1000);
+    const FieldHistogram* b = stats.getField("b");
+    ASSERT_EQUALS(b->getNumBuckets(), FieldHistogram::kDefaultNumBuckets);
+
+    ASSERT_APPROX_EQUAL(b->estimateSelectivity(rangeInterval(0, 499)), 0.5, 0.05);
+    ASSERT_APPROX_EQUAL(b->estimateSelectivity(rangeInterval(0, 99)), 0.1, 0.05);
+    ASSERT_APPROX_EQUAL(b->estimateSelectivity(rangeInterval(-100, 2000)), 1.0, 1e-9);
+    ASSERT_EQUALS(b->estimateSelectivity(rangeInterval(2000, 3000)), 0.0);
+
+    // Descending scans give their intervals in reverse.
+    ASSERT_EQUALS(b->estimateSelectivity(rangeInterval(499, 0)),
+                  b->estimateSelectivity(rangeInterval(0, 499)));
+}
+
+TEST(CollectionStatisticsTest, PointSelectivity) {
+    // Half of the documents have a == 0, the rest are spread over 50 other values.
+    std::vector<BSONObj> sample;
+    for (int i = 0; i < 1000; ++i) {
+        sample.push_back(BSON("a" << (i % 2 == 0 ? 0 : 1 + i % 50)));
+    }
+    auto stats = CollectionStatistics::make(sample, {"a"}, 1000);
+    const FieldHistogram* a = stats.getField("a");
+
+    ASSERT_APPROX_EQUAL(a->estimateSelectivity(pointInterval(0)), 0.5, 0.05);
+    ASSERT_LT(a->estimateSelectivity(pointInterval(7)), 0.1);
+    ASSERT_GT(a->estimateSelectivity(pointInterval(7)), 0.0);
+}
+
+TEST(CollectionStatisticsTest, MissingFieldsAndArrays) {
+    std::vector<BSONObj> sample;
+    sample.push_back(fromjson("{a: [1, 2, 3]}"));
+    sample.push_back(fromjson("{a: 4}"));
+    sample.push_back(fromjson("{b: 1}"));
+    sample.push_back(fromjson("{b: 2}"));
+    auto stats = CollectionStatistics::make(sample, {"a", "missing"}, 4);
+
+    const FieldHistogram* a = stats.getField("a");
+    ASSERT_EQUALS(a->getNumDistinctValues(), 4.0);
+    ASSERT_APPROX_EQUAL(a->estimateSelectivity(rangeInterval(0, 10)), 0.5, 1e-9);
+
+    // Documents without the field are indexed, and found, as null.
+    ASSERT_APPROX_EQUAL(
+        a->estimateSelectivity(IndexBoundsBuilder::makePointInterval(BSON("" << BSONNULL))),
+        0.5,
+        1e-9);
+
+    const FieldHistogram* missing = stats.getField("missing");
+    ASSERT_EQUALS(missing->getNumBuckets(), 0U);
+    ASSERT_EQUALS(missing->estimateSelectivity(pointInterval(1)), 0.0);
+}
+
+TEST(CollectionStatisticsTest, AppendTo) {
+    auto stats = CollectionStatistics::make(makeSample(4, 2), {"a"}, 4, 2);
+    BSONObjBuilder bob;
+    stats.appendTo(&bob);
+    ASSERT_BSONOBJ_EQ(bob.obj(),
+                      fromjson("{numRecords: 4, numSampled: 4, fields: {a: {fractionPresent: 1.0, "
+                               "numDistinctValues: 2.0, bucketBoundaries: [0, 0, 1]}}}"));
+}
+
+}  // namespace
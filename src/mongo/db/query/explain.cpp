@@ -270,7 +270,9 @@ void Explain::statsToBSON(const PlanStageStats& stats,
     // Some top-level exec stats get pulled out of the root stage.
     if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
         bob->appendNumber("nReturned", stats.common.advanced);
-        bob->appendNumber("executionTimeMillisEstimate", stats.common.executionTimeMillis);
+        bob->appendNumber("executionTimeMillisEstimate",
+                          stats.common.executionTimeNanos / (1000 * 1000));
+        bob->appendNumber("executionTimeNanosEstimate", stats.common.executionTimeNanos);
         bob->appendNumber("works", stats.common.works);
         bob->appendNumber("advanced", stats.common.advanced);
         bob->appendNumber("needTime", stats.common.needTime);
@@ -339,12 +341,16 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         bob->appendBool("isPartial", spec->isPartial);
         bob->append("indexVersion", spec->indexVersion);
 
-        BSONObjBuilder indexBoundsBob;
-        indexBoundsBob.append("startKey", spec->startKey);
-        indexBoundsBob.append("startKeyInclusive", spec->startKeyInclusive);
-        indexBoundsBob.append("endKey", spec->endKey);
-        indexBoundsBob.append("endKeyInclusive", spec->endKeyInclusive);
-        bob->append("indexBounds", indexBoundsBob.obj());
+        if (!spec->indexBounds.isEmpty()) {
+            bob->append("indexBounds", spec->indexBounds);
+        } else {
+            BSONObjBuilder indexBoundsBob;
+            indexBoundsBob.append("startKey", spec->startKey);
+            indexBoundsBob.append("startKeyInclusive", spec->startKeyInclusive);
+            indexBoundsBob.append("endKey", spec->endKey);
+            indexBoundsBob.append("endKeyInclusive", spec->endKeyInclusive);
+            bob->append("indexBounds", indexBoundsBob.obj());
+        }
     } else if (STAGE_DELETE == stats.stageType) {
         DeleteStats* spec = static_cast<DeleteStats*>(stats.specific.get());
 
@@ -484,6 +490,9 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("memUsage", spec->memUsage);
             bob->appendNumber("memLimit", spec->memLimit);
+            if (spec->usedDisk) {
+                bob->appendBool("usedDisk", true);
+            }
         }
 
         if (spec->limit > 0) {
@@ -652,7 +661,8 @@ void Explain::generateExecStats(PlanStageStats* stats,
     if (totalTimeMillis) {
         out->appendNumber("executionTimeMillis", *totalTimeMillis);
     } else {
-        out->appendNumber("executionTimeMillisEstimate", stats->common.executionTimeMillis);
+        out->appendNumber("executionTimeMillisEstimate",
+                          stats->common.executionTimeNanos / (1000 * 1000));
     }
 
     // Flatten the stats tree into a list.
@@ -844,7 +854,7 @@ void Explain::getSummaryStats(const PlanExecutor& exec, PlanSummaryStats* statsO
     // root stage of the plan tree.
     const CommonStats* common = root->getCommonStats();
     statsOut->nReturned = common->advanced;
-    statsOut->executionTimeMillis = common->executionTimeMillis;
+    statsOut->executionTimeNanos = common->executionTimeNanos;
 
     // The other fields are aggregations over the stages in the plan tree. We flatten
     // the tree into a list and then compute these aggregations.
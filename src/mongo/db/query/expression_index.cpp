@@ -28,15 +28,20 @@
 
 #include "mongo/db/query/expression_index.h"
 
+#include <boost/functional/hash.hpp>
 #include <iostream>
+#include <memory>
 #include <unordered_set>
 
+#include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/geo/geoconstants.h"
 #include "mongo/db/geo/r2_region_coverer.h"
 #include "mongo/db/hasher.h"
 #include "mongo/db/index/expression_params.h"
 #include "mongo/db/query/expression_index_knobs.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/lru_cache.h"
 #include "third_party/s2/s2cellid.h"
 #include "third_party/s2/s2region.h"
 #include "third_party/s2/s2regioncoverer.h"
@@ -46,8 +51,13 @@ namespace mongo {
 using std::set;
 
 BSONObj ExpressionMapping::hash(const BSONElement& value) {
+    return hash(
+        value, BSONElementHasher::DEFAULT_HASH_SEED, BSONElementHasher::MD5_HASH_VERSION);
+}
+
+BSONObj ExpressionMapping::hash(const BSONElement& value, HashSeed seed, int hashVersion) {
     BSONObjBuilder bob;
-    bob.append("", BSONElementHasher::hash64(value, BSONElementHasher::DEFAULT_HASH_SEED));
+    bob.append("", BSONElementHasher::hash64(value, seed, hashVersion));
     return bob.obj();
 }
 
@@ -133,6 +143,112 @@ void ExpressionMapping::cover2dsphere(const S2Region& region,
     S2CellIdsToIntervalsWithParents(cover, indexingParams, oilOut);
 }
 
+namespace {
+
+/**
+ * Everything the 2dsphere intervals of a query geometry depend on.
+ */
+struct S2CoveringCacheKey {
+    BSONObj geometryObj;
+    int coarsestLevel;
+    int finestLevel;
+    int maxCells;
+    int coarsestIndexedLevel;
+    S2IndexVersion indexVersion;
+
+    bool operator==(const S2CoveringCacheKey& other) const {
+        return coarsestLevel == other.coarsestLevel && finestLevel == other.finestLevel &&
+            maxCells == other.maxCells && coarsestIndexedLevel == other.coarsestIndexedLevel &&
+            indexVersion == other.indexVersion && geometryObj.binaryEqual(other.geometryObj);
+    }
+
+    struct Hasher {
+        size_t operator()(const S2CoveringCacheKey& key) const {
+            size_t seed = 0;
+            boost::hash_combine(seed, key.coarsestLevel);
+            boost::hash_combine(seed, key.finestLevel);
+            boost::hash_combine(seed, key.maxCells);
+            boost::hash_combine(seed, key.coarsestIndexedLevel);
+            boost::hash_combine(seed, static_cast<int>(key.indexVersion));
+            SimpleBSONObjComparator::kInstance.hash_combine(seed, key.geometryObj);
+            return seed;
+        }
+    };
+};
+
+/**
+ * The intervals of recently queried geometries, shared by all queries. Geometries are compared
+ * by their binary representation, so the same polygon written with different field order or
+ * number types is cached separately.
+ */
+class S2CoveringCache {
+public:
+    explicit S2CoveringCache(size_t maxSize) : _cache(maxSize) {}
+
+    std::shared_ptr<const std::vector<Interval>> find(const S2CoveringCacheKey& key) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto it = _cache.find(key);
+        return it == _cache.end() ? nullptr : it->second;
+    }
+
+    void add(const S2CoveringCacheKey& key, std::shared_ptr<const std::vector<Interval>> entry) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _cache.add(key, std::move(entry));
+    }
+
+    void clear() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _cache.clear();
+    }
+
+private:
+    stdx::mutex _mutex;
+    LRUCache<S2CoveringCacheKey,
+             std::shared_ptr<const std::vector<Interval>>,
+             S2CoveringCacheKey::Hasher>
+        _cache;
+};
+
+S2CoveringCache* getS2CoveringCache() {
+    static S2CoveringCache* cache =
+        internalQueryS2CoveringCacheSize > 0 ? new S2CoveringCache(internalQueryS2CoveringCacheSize)
+                                             : nullptr;
+    return cache;
+}
+
+}  // namespace
+
+void ExpressionMapping::cover2dsphere(const S2Region& region,
+                                      const BSONObj& geometryObj,
+                                      const S2IndexingParams& indexingParams,
+                                      OrderedIntervalList* oilOut) {
+    S2CoveringCache* cache = getS2CoveringCache();
+    if (!cache || !oilOut->intervals.empty()) {
+        cover2dsphere(region, indexingParams, oilOut);
+        return;
+    }
+
+    S2CoveringCacheKey key{geometryObj.getOwned(),
+                           internalQueryS2GeoCoarsestLevel.load(),
+                           internalQueryS2GeoFinestLevel.load(),
+                           internalQueryS2GeoMaxCells.load(),
+                           indexingParams.coarsestIndexedLevel,
+                           indexingParams.indexVersion};
+    if (auto intervals = cache->find(key)) {
+        oilOut->intervals = *intervals;
+        return;
+    }
+
+    cover2dsphere(region, indexingParams, oilOut);
+    cache->add(key, std::make_shared<const std::vector<Interval>>(oilOut->intervals));
+}
+
+void ExpressionMapping::clearS2CoveringCache() {
+    if (S2CoveringCache* cache = getS2CoveringCache()) {
+        cache->clear();
+    }
+}
+
 namespace {
 bool compareIntervals(const Interval& a, const Interval& b) {
     return a.precedes(b);
@@ -32,6 +32,7 @@
 
 #include "mongo/db/geo/hash.h"
 #include "mongo/db/geo/shapes.h"
+#include "mongo/db/hasher.h"
 #include "mongo/db/index/s2_common.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/query/index_bounds_builder.h"  // For OrderedIntervalList
@@ -50,6 +51,11 @@ class ExpressionMapping {
 public:
     static BSONObj hash(const BSONElement& value);
 
+    /**
+     * Hashes 'value' the way a hashed index with the given "seed" and "hashVersion" does.
+     */
+    static BSONObj hash(const BSONElement& value, HashSeed seed, int hashVersion);
+
     static std::vector<GeoHash> get2dCovering(const R2Region& region,
                                               const BSONObj& indexInfoObj,
                                               int maxCoveringCells);
@@ -77,6 +83,21 @@ public:
     static void cover2dsphere(const S2Region& region,
                               const S2IndexingParams& indexParams,
                               OrderedIntervalList* oilOut);
+
+    /**
+     * Like cover2dsphere() above, for a 'region' parsed from the query object 'geometryObj'. The
+     * intervals of recently queried geometries are cached, so repeating a query with the same
+     * geometry does not compute its covering again.
+     */
+    static void cover2dsphere(const S2Region& region,
+                              const BSONObj& geometryObj,
+                              const S2IndexingParams& indexParams,
+                              OrderedIntervalList* oilOut);
+
+    /**
+     * Forgets all cached 2dsphere intervals. For testing.
+     */
+    static void clearS2CoveringCache();
 };
 
 }  // namespace mongo
@@ -59,4 +59,8 @@ extern AtomicInt32 internalQueryS2GeoCoarsestLevel;
 // What is the maximum cell count that we want? (advisory, not a hard threshold)
 extern AtomicInt32 internalQueryS2GeoMaxCells;
 
+// How many recently queried geometries do we remember the 2dsphere index intervals of? Zero
+// disables the cache.
+extern int internalQueryS2CoveringCacheSize;
+
 }  // namespace mongo
@@ -50,8 +50,11 @@
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/internal_plans.h"
+#include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner_params.h"
+#include "mongo/db/query/query_stats_store.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/server_options.h"
@@ -65,6 +68,7 @@
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/net/message.h"
 #include "mongo/util/scopeguard.h"
 
 namespace mongo {
@@ -157,6 +161,28 @@ void endQueryOp(OperationContext* opCtx,
         collection->infoCache()->notifyOfQuery(opCtx, summaryStats.indexesUsed);
     }
 
+    // Aggregate the statistics of the first batch by query shape. The shape is only computed when
+    // the store is enabled, since it costs as much as a plan cache lookup.
+    const CanonicalQuery* cq = exec.getCanonicalQuery();
+    if (collection && cq && internalQueryStatsStoreSize.load() > 0) {
+        QueryStatsStore::Execution execution;
+        execution.latencyMicros = curOp->elapsedMicros();
+        execution.keysExamined = summaryStats.totalKeysExamined;
+        execution.docsExamined = summaryStats.totalDocsExamined;
+        execution.nReturned = numResults;
+        execution.planExecutionNanos = summaryStats.executionTimeNanos;
+        execution.planSummary = Explain::getPlanSummary(&exec);
+
+        const QueryRequest& qr = cq->getQueryRequest();
+        QueryStatsStore::get(opCtx->getServiceContext())
+            .record(collection->ns(),
+                    collection->infoCache()->getPlanCache()->computeKey(*cq),
+                    qr.getFilter(),
+                    qr.getSort(),
+                    qr.getProj(),
+                    execution);
+    }
+
     if (curOp->shouldDBProfile()) {
         BSONObjBuilder statsBob;
         Explain::getWinningPlanStats(&exec, &statsBob);
@@ -166,6 +192,19 @@ void endQueryOp(OperationContext* opCtx,
 
 namespace {
 
+/**
+ * Appends 'obj' to a reply. Documents the executor already owns, such as those read by a
+ * collection scan, are referenced rather than copied: the reply keeps their buffers alive until it
+ * is sent.
+ */
+void appendResult(const BSONObj& obj, GatherBufBuilder* bb) {
+    if (obj.isOwned()) {
+        bb->appendShared(obj.sharedBuffer(), obj.objdata(), obj.objsize());
+    } else {
+        bb->appendBuf(obj.objdata(), obj.objsize());
+    }
+}
+
 /**
  * Uses 'cursor' to fill out 'bb' with the batch of result documents to
  * be returned by this getMore.
@@ -180,7 +219,7 @@ namespace {
  */
 void generateBatch(int ntoreturn,
                    ClientCursor* cursor,
-                   BufBuilder* bb,
+                   GatherBufBuilder* bb,
                    int* numResults,
                    Timestamp* slaveReadTill,
                    PlanExecutor::ExecState* state) {
@@ -196,7 +235,7 @@ void generateBatch(int ntoreturn,
         }
 
         // Add result to output buffer.
-        bb->appendBuf((void*)obj.objdata(), obj.objsize());
+        appendResult(obj, bb);
 
         // Count the result.
         (*numResults)++;
@@ -313,7 +352,7 @@ Message getMore(OperationContext* opCtx,
     const int InitialBufSize =
         512 + sizeof(QueryResult::Value) + FindCommon::kMaxBytesToReturnToClientAtOnce;
 
-    BufBuilder bb(InitialBufSize);
+    GatherBufBuilder bb(InitialBufSize);
     bb.skip(sizeof(QueryResult::Value));
 
     if (!ccPin.isOK()) {
@@ -495,7 +534,7 @@ Message getMore(OperationContext* opCtx,
     qr.setStartingFrom(startingResult);
     qr.setNReturned(numResults);
     LOG(5) << "getMore returned " << numResults << " results\n";
-    return Message(bb.release());
+    return bb.release();
 }
 
 std::string runQuery(OperationContext* opCtx,
@@ -591,7 +630,7 @@ std::string runQuery(OperationContext* opCtx,
     // bb is used to hold query results
     // this buffer should contain either requested documents per query or
     // explain information, but not both
-    BufBuilder bb(FindCommon::kInitReplyBufferSize);
+    GatherBufBuilder bb(FindCommon::kInitReplyBufferSize);
     bb.skip(sizeof(QueryResult::Value));
 
     // How many results have we obtained from the executor?
@@ -617,7 +656,7 @@ std::string runQuery(OperationContext* opCtx,
         }
 
         // Add result to output buffer.
-        bb.appendBuf((void*)obj.objdata(), obj.objsize());
+        appendResult(obj, &bb);
 
         // Count the result.
         ++numResults;
@@ -650,6 +689,10 @@ std::string runQuery(OperationContext* opCtx,
     auto css = CollectionShardingState::get(opCtx, nss);
     css->checkShardVersionOrThrow(opCtx);
 
+    if (exec->getCanonicalQuery()) {
+        css->onQueryOp(opCtx, *exec->getCanonicalQuery());
+    }
+
     // Fill out CurOp based on query results. If we have a cursorid, we will fill out CurOp with
     // this cursorid later.
     long long ccId = 0;
@@ -704,7 +747,7 @@ std::string runQuery(OperationContext* opCtx,
     queryResultView.setNReturned(numResults);
 
     // Add the results from the query into the output buffer.
-    result.setData(bb.release());
+    result = bb.release();
 
     // curOp.debug().exhaust is set above.
     return curOp.debug().exhaust ? nss.ns() : "";
@@ -47,7 +47,10 @@ bool FindCommon::enoughForFirstBatch(const QueryRequest& qr, long long numDocs)
     return numDocs >= qr.getEffectiveBatchSize().value();
 }
 
-bool FindCommon::haveSpaceForNext(const BSONObj& nextDoc, long long numDocs, int bytesBuffered) {
+bool FindCommon::haveSpaceForNext(const BSONObj& nextDoc,
+                                  long long numDocs,
+                                  int bytesBuffered,
+                                  int maxBytes) {
     invariant(numDocs >= 0);
     if (!numDocs) {
         // Allow the first output document to exceed the limit to ensure we can always make
@@ -55,7 +58,7 @@ bool FindCommon::haveSpaceForNext(const BSONObj& nextDoc, long long numDocs, int
         return true;
     }
 
-    return (bytesBuffered + nextDoc.objsize()) <= kMaxBytesToReturnToClientAtOnce;
+    return (bytesBuffered + nextDoc.objsize()) <= maxBytes;
 }
 
 BSONObj FindCommon::transformSortSpec(const BSONObj& sortSpec) {
@@ -75,9 +75,12 @@ public:
     /**
      * Given the number of docs ('numDocs') and bytes ('bytesBuffered') currently buffered as a
      * response to a cursor-generating command, returns true if there are enough remaining bytes in
-     * our budget to fit 'nextDoc'.
+     * our budget of 'maxBytes' to fit 'nextDoc'.
      */
-    static bool haveSpaceForNext(const BSONObj& nextDoc, long long numDocs, int bytesBuffered);
+    static bool haveSpaceForNext(const BSONObj& nextDoc,
+                                 long long numDocs,
+                                 int bytesBuffered,
+                                 int maxBytes = kMaxBytesToReturnToClientAtOnce);
 
     /**
      * Transforms the raw sort spec into one suitable for use as the ordering specification in
@@ -64,6 +64,7 @@
 #include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/query/plan_cache.h"
+#include "mongo/db/query/plan_cost_estimator.h"
 #include "mongo/db/query/plan_executor.h"
 #include "mongo/db/query/planner_access.h"
 #include "mongo/db/query/planner_analysis.h"
@@ -257,6 +258,9 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
             std::move(canonicalQuery), std::move(querySolution), std::move(root));
     }
 
+    // The plan cache keys depend on the indexes, so the plan cache must know about them first.
+    collection->infoCache()->ensureIndexDataBuilt(opCtx);
+
     // Fill out the planning params.  We use these for both cached solutions and non-cached.
     QueryPlannerParams plannerParams;
     plannerParams.options = plannerOptions;
@@ -434,6 +438,18 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
         return PrepareExecutionResult(
             std::move(canonicalQuery), std::move(querySolution), std::move(root));
     } else {
+        // Racing every candidate is expensive when there are many of them, so discard the ones
+        // which a cheap bounds-based estimate says are clearly worse before the trial period.
+        const int maxCandidates = internalQueryPlanEvaluationMaxCandidates.load();
+        const auto stats = collection->infoCache()->getStatistics();
+        const size_t numPruned = PlanCostEstimator::pruneCandidates(
+            collection->numRecords(opCtx), std::max(maxCandidates, 0), &solutions, stats.get());
+        if (numPruned > 0) {
+            LOG(2) << "Pruned " << numPruned << " of " << solutions.size() + numPruned
+                   << " candidate plans by estimated cost for query "
+                   << redact(canonicalQuery->toStringShort());
+        }
+
         // Many solutions. Create a MultiPlanStage to pick the best, update the cache,
         // and so on. The working set will be shared by all candidate plans.
         auto multiPlanStage = make_unique<MultiPlanStage>(opCtx, collection, canonicalQuery.get());
@@ -1072,31 +1088,39 @@ bool turnIxscanIntoCount(QuerySolution* soln) {
 
     IndexScanNode* isn = static_cast<IndexScanNode*>(root->children[0]);
 
-    // No filters allowed and side-stepping isSimpleRange for now.  TODO: do we ever see
-    // isSimpleRange here?  because we could well use it.  I just don't think we ever do see
-    // it.
-
-    if (NULL != isn->filter.get() || isn->bounds.isSimpleRange) {
+    // Side-stepping isSimpleRange for now.  TODO: do we ever see isSimpleRange here?  because we
+    // could well use it.  I just don't think we ever do see it.
+    if (isn->bounds.isSimpleRange) {
         return false;
     }
 
-    // Make sure the bounds are OK.
     BSONObj startKey;
     bool startKeyInclusive;
     BSONObj endKey;
     bool endKeyInclusive;
+    const bool isSingleInterval = IndexBoundsBuilder::isSingleInterval(
+        isn->bounds, &startKey, &startKeyInclusive, &endKey, &endKeyInclusive);
 
-    if (!IndexBoundsBuilder::isSingleInterval(
-            isn->bounds, &startKey, &startKeyInclusive, &endKey, &endKeyInclusive)) {
+    // The count scan walks any other bounds the way a forward index scan would have.
+    if (!isSingleInterval && isn->direction != 1) {
         return false;
     }
 
     // Make the count node that we replace the fetch + ixscan with.
     CountScanNode* csn = new CountScanNode(isn->index);
-    csn->startKey = startKey;
-    csn->startKeyInclusive = startKeyInclusive;
-    csn->endKey = endKey;
-    csn->endKeyInclusive = endKeyInclusive;
+    if (isSingleInterval) {
+        csn->startKey = startKey;
+        csn->startKeyInclusive = startKeyInclusive;
+        csn->endKey = endKey;
+        csn->endKeyInclusive = endKeyInclusive;
+    } else {
+        csn->bounds = isn->bounds;
+    }
+
+    // The filter of the index scan only depends on the index keys, so the count scan can apply it
+    // without fetching the documents.
+    csn->filter = std::move(isn->filter);
+
     // Takes ownership of 'cn' and deletes the old root.
     soln->root.reset(csn);
     return true;
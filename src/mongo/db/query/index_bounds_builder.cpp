@@ -36,6 +36,7 @@
 #include "mongo/base/string_data.h"
 #include "mongo/db/geo/geoconstants.h"
 #include "mongo/db/geo/s2.h"
+#include "mongo/db/hasher.h"
 #include "mongo/db/index/expression_params.h"
 #include "mongo/db/index/s2_common.h"
 #include "mongo/db/matcher/expression_geo.h"
@@ -588,7 +589,7 @@ void IndexBoundsBuilder::translate(const MatchExpression* expr,
             const S2Region& region = gme->getGeoExpression().getGeometry().getS2Region();
             S2IndexingParams indexParams;
             ExpressionParams::initialize2dsphereParams(index.infoObj, index.collator, &indexParams);
-            ExpressionMapping::cover2dsphere(region, indexParams, oilOut);
+            ExpressionMapping::cover2dsphere(region, gme->getRawObj(), indexParams, oilOut);
             *tightnessOut = IndexBoundsBuilder::INEXACT_FETCH;
         } else if (mongoutils::str::equals("2d", elt.valuestrsafe())) {
             verify(gme->getGeoExpression().getGeometry().hasR2Region());
@@ -817,7 +818,12 @@ void IndexBoundsBuilder::translateEquality(const BSONElement& data,
     if (Array != data.type()) {
         BSONObj dataObj = objFromElement(data, index.collator);
         if (isHashed) {
-            dataObj = ExpressionMapping::hash(dataObj.firstElement());
+            // Hash the value the way the index hashed its keys. Missing fields mean the defaults,
+            // as in ExpressionParams::parseHashParams().
+            const HashSeed seed = index.infoObj["seed"].eoo() ? BSONElementHasher::DEFAULT_HASH_SEED
+                                                              : index.infoObj["seed"].numberInt();
+            const int hashVersion = index.infoObj["hashVersion"].numberInt();
+            dataObj = ExpressionMapping::hash(dataObj.firstElement(), seed, hashVersion);
         }
 
         verify(dataObj.isOwned());
@@ -33,11 +33,14 @@
 #include <limits>
 #include <memory>
 
+#include "mongo/db/index/expression_params.h"
 #include "mongo/db/json.h"
+#include "mongo/db/matcher/expression_geo.h"
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/matcher/extensions_callback_disallow_extensions.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
 #include "mongo/db/query/expression_index.h"
+#include "mongo/db/query/expression_index_knobs.h"
 #include "mongo/unittest/unittest.h"
 
 using namespace mongo;
@@ -2155,4 +2158,78 @@ TEST(IndexBoundsBuilderTest, InWithStringAgainstHashedIndexWithCollatorUsesHashO
     ASSERT_EQUALS(tightness, IndexBoundsBuilder::INEXACT_FETCH);
 }
 
+//
+// 2dsphere bounds
+//
+
+/**
+ * Translates 'obj' against a 2dsphere index on 'a' with the given index info.
+ */
+OrderedIntervalList translateGeo(const BSONObj& obj, const BSONObj& infoObj) {
+    BSONObj keyPattern = fromjson("{a: '2dsphere'}");
+    IndexEntry testIndex = IndexEntry(keyPattern);
+    testIndex.infoObj = infoObj;
+    unique_ptr<MatchExpression> expr(parseMatchExpression(obj));
+
+    OrderedIntervalList oil;
+    IndexBoundsBuilder::BoundsTightness tightness;
+    IndexBoundsBuilder::translate(
+        expr.get(), keyPattern.firstElement(), testIndex, &oil, &tightness);
+    ASSERT_EQUALS(tightness, IndexBoundsBuilder::INEXACT_FETCH);
+    return oil;
+}
+
+void assertSameIntervals(const OrderedIntervalList& expected, const OrderedIntervalList& actual) {
+    ASSERT_EQUALS(expected.name, actual.name);
+    ASSERT_EQUALS(expected.intervals.size(), actual.intervals.size());
+    for (size_t i = 0; i < expected.intervals.size(); ++i) {
+        ASSERT_EQUALS(Interval::INTERVAL_EQUALS,
+                      expected.intervals[i].compare(actual.intervals[i]));
+    }
+}
+
+TEST(IndexBoundsBuilderTest, RepeatedGeoWithinReusesCachedCovering) {
+    ExpressionMapping::clearS2CoveringCache();
+    BSONObj query = fromjson(
+        "{a: {$geoWithin: {$geometry: {type: 'Polygon', coordinates: "
+        "[[[0, 0], [0, 1], [1, 1], [1, 0], [0, 0]]]}}}}");
+    BSONObj infoObj = fromjson("{'2dsphereIndexVersion': 3}");
+
+    unique_ptr<MatchExpression> expr(parseMatchExpression(query));
+    const GeoMatchExpression* gme = static_cast<GeoMatchExpression*>(expr.get());
+    const S2Region& region = gme->getGeoExpression().getGeometry().getS2Region();
+    S2IndexingParams indexParams;
+    ExpressionParams::initialize2dsphereParams(infoObj, nullptr, &indexParams);
+    OrderedIntervalList expected("a");
+    ExpressionMapping::cover2dsphere(region, indexParams, &expected);
+
+    OrderedIntervalList first = translateGeo(query, infoObj);
+    assertSameIntervals(expected, first);
+    OrderedIntervalList second = translateGeo(query, infoObj);
+    assertSameIntervals(expected, second);
+
+    // Version 2 indexes key cells by string rather than by number.
+    OrderedIntervalList v2 = translateGeo(query, fromjson("{'2dsphereIndexVersion': 2}"));
+    ASSERT_EQUALS(String, v2.intervals[0].start.type());
+    ASSERT_EQUALS(NumberLong, first.intervals[0].start.type());
+}
+
+TEST(IndexBoundsBuilderTest, GeoCoveringCacheRespectsCoveringKnobs) {
+    ExpressionMapping::clearS2CoveringCache();
+    BSONObj query = fromjson(
+        "{a: {$geoIntersects: {$geometry: {type: 'Polygon', coordinates: "
+        "[[[0, 0], [0, 10], [10, 10], [10, 0], [0, 0]]]}}}}");
+    BSONObj infoObj = fromjson("{'2dsphereIndexVersion': 3}");
+
+    OrderedIntervalList fine = translateGeo(query, infoObj);
+
+    const int oldMaxCells = internalQueryS2GeoMaxCells.load();
+    internalQueryS2GeoMaxCells.store(4);
+    OrderedIntervalList coarse = translateGeo(query, infoObj);
+    internalQueryS2GeoMaxCells.store(oldMaxCells);
+
+    ASSERT_LESS_THAN(coarse.intervals.size(), fine.intervals.size());
+    assertSameIntervals(fine, translateGeo(query, infoObj));
+}
+
 }  // namespace
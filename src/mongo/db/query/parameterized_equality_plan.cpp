@@ -0,0 +1,223 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/parameterized_equality_plan.h"
+
+#include <vector>
+
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/catalog/index_catalog_entry.h"
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/matcher/expression_algo.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/matcher/extensions_callback_noop.h"
+#include "mongo/db/matcher/extensions_callback_real.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/db/query/get_executor.h"
+#include "mongo/db/query/index_bounds_builder.h"
+#include "mongo/db/query/query_planner.h"
+#include "mongo/db/query/query_planner_common.h"
+#include "mongo/db/query/query_planner_params.h"
+#include "mongo/db/query/query_solution.h"
+#include "mongo/db/query/stage_builder.h"
+#include "mongo/stdx/memory.h"
+
+namespace mongo {
+
+ParameterizedEqualityPlan::~ParameterizedEqualityPlan() = default;
+
+std::unique_ptr<ParameterizedEqualityPlan> ParameterizedEqualityPlan::make(
+    OperationContext* opCtx,
+    Collection* collection,
+    StringData path,
+    const BSONElement& sampleValue,
+    const BSONObj& filter,
+    const BSONObj& collation) {
+    const std::set<std::string> paths{path.toString()};
+
+    // Any other predicate on 'path' would be folded into the bounds we replace.
+    auto filterExpr = MatchExpressionParser::parse(filter, ExtensionsCallbackNoop(), nullptr);
+    if (!filterExpr.isOK() || !expression::isIndependentOf(*filterExpr.getValue(), paths)) {
+        return nullptr;
+    }
+
+    BSONObjBuilder query;
+    {
+        BSONArrayBuilder andObj(query.subarrayStart("$and"));
+        {
+            BSONObjBuilder equality(andObj.subobjStart());
+            BSONObjBuilder eqObj(equality.subobjStart(path));
+            eqObj.appendAs(sampleValue, "$eq");
+        }
+        andObj << filter;
+    }
+
+    auto qr = stdx::make_unique<QueryRequest>(collection->ns());
+    qr->setFilter(query.obj());
+    qr->setCollation(collation);
+    const ExtensionsCallbackReal extensionsCallback(opCtx, &collection->ns());
+    auto statusWithCQ = CanonicalQuery::canonicalize(opCtx, std::move(qr), extensionsCallback);
+    if (!statusWithCQ.isOK()) {
+        return nullptr;
+    }
+    std::unique_ptr<CanonicalQuery> cq = std::move(statusWithCQ.getValue());
+
+    // $where and $text predicates hold state across their execution.
+    if (QueryPlannerCommon::hasNode(cq->root(), MatchExpression::WHERE) ||
+        QueryPlannerCommon::hasNode(cq->root(), MatchExpression::TEXT)) {
+        return nullptr;
+    }
+
+    QueryPlannerParams plannerParams;
+    fillOutPlannerParams(opCtx, collection, cq.get(), &plannerParams);
+
+    std::vector<QuerySolution*> rawSolutions;
+    if (!QueryPlanner::plan(*cq, plannerParams, &rawSolutions).isOK()) {
+        return nullptr;
+    }
+    std::vector<std::unique_ptr<QuerySolution>> solutions;
+    for (auto&& solution : rawSolutions) {
+        solutions.emplace_back(solution);
+    }
+
+    // Choosing between several solutions takes running them, which depends on the values bound.
+    if (solutions.size() != 1 || solutions[0]->hasBlockingStage) {
+        return nullptr;
+    }
+
+    QuerySolutionNode* root = solutions[0]->root.get();
+    if (root->getType() != STAGE_FETCH || root->children.size() != 1 ||
+        root->children[0]->getType() != STAGE_IXSCAN) {
+        return nullptr;
+    }
+    auto indexScan = static_cast<IndexScanNode*>(root->children[0]);
+    const IndexEntry& index = indexScan->index;
+
+    if (index.type != INDEX_BTREE || index.filterExpr ||
+        index.keyPattern.firstElementFieldName() != path ||
+        !CollatorInterface::collatorsMatch(index.collator, cq->getCollator())) {
+        return nullptr;
+    }
+
+    // The equality must have been answered exactly by a point on the leading field, and by nothing
+    // else, for new points to answer it for other values.
+    const IndexBounds& bounds = indexScan->bounds;
+    if (bounds.isSimpleRange || bounds.fields.empty() || bounds.fields[0].intervals.size() != 1 ||
+        !bounds.fields[0].intervals[0].isPoint()) {
+        return nullptr;
+    }
+    for (auto&& node : {root, root->children[0]}) {
+        if (node->filter && !expression::isIndependentOf(*node->filter, paths)) {
+            return nullptr;
+        }
+    }
+
+    IndexCatalog* indexCatalog = collection->getIndexCatalog();
+    const IndexDescriptor* desc = indexCatalog->findIndexByName(opCtx, index.name);
+    invariant(desc);
+
+    std::unique_ptr<ParameterizedEqualityPlan> plan(new ParameterizedEqualityPlan());
+    plan->_indexInfo = desc->infoObj();
+    plan->_multikey = index.multikey;
+    plan->_multikeyPaths = index.multikeyPaths;
+    plan->_numIndexes = indexCatalog->numIndexesTotal(opCtx);
+    plan->_indexScan = indexScan;
+    plan->_cq = std::move(cq);
+    plan->_solution = std::move(solutions[0]);
+    return plan;
+}
+
+bool ParameterizedEqualityPlan::isValid(OperationContext* opCtx, Collection* collection) const {
+    IndexCatalog* indexCatalog = collection->getIndexCatalog();
+    if (indexCatalog->numIndexesTotal(opCtx) != _numIndexes) {
+        return false;
+    }
+
+    const IndexDescriptor* desc = indexCatalog->findIndexByName(opCtx, _indexScan->index.name);
+    if (!desc || SimpleBSONObjComparator::kInstance.evaluate(desc->infoObj() != _indexInfo)) {
+        return false;
+    }
+
+    // An index becoming multikey changes which bounds and filters are correct for it.
+    const IndexCatalogEntry* entry = indexCatalog->getEntry(desc);
+    return entry->isMultikey() == _multikey && entry->getMultikeyPaths(opCtx) == _multikeyPaths;
+}
+
+std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> ParameterizedEqualityPlan::bind(
+    OperationContext* opCtx,
+    Collection* collection,
+    const BSONObj& values,
+    PlanExecutor::YieldPolicy yieldPolicy) {
+    invariant(!values.isEmpty());
+
+    // The index may have been rebuilt with the same spec, so refresh our pointer to its collator.
+    IndexCatalog* indexCatalog = collection->getIndexCatalog();
+    const IndexDescriptor* desc = indexCatalog->findIndexByName(opCtx, _indexScan->index.name);
+    invariant(desc);
+    _indexScan->index.collator = indexCatalog->getEntry(desc)->getCollator();
+
+    IndexBounds leadingBounds;
+    leadingBounds.fields.emplace_back(_indexScan->bounds.fields[0].name);
+    OrderedIntervalList* points = &leadingBounds.fields.back();
+    for (auto&& value : values) {
+        switch (value.type()) {
+            case jstNULL:
+            case Undefined:
+            case Array:
+            case RegEx:
+                return nullptr;
+            default:
+                break;
+        }
+
+        IndexBoundsBuilder::BoundsTightness tightness;
+        IndexBoundsBuilder::translateEquality(value, _indexScan->index, false, points, &tightness);
+        if (tightness != IndexBoundsBuilder::EXACT) {
+            return nullptr;
+        }
+    }
+    IndexBoundsBuilder::unionize(points);
+    IndexBoundsBuilder::alignBounds(&leadingBounds,
+                                    _indexScan->index.keyPattern.firstElement().wrap(),
+                                    _indexScan->direction);
+    _indexScan->bounds.fields[0] = std::move(*points);
+
+    auto ws = stdx::make_unique<WorkingSet>();
+    PlanStage* root;
+    invariant(StageBuilder::build(opCtx, collection, *_cq, *_solution, ws.get(), &root));
+    return uassertStatusOK(PlanExecutor::make(
+        opCtx, std::move(ws), std::unique_ptr<PlanStage>(root), collection, yieldPolicy));
+}
+
+}  // namespace mongo
@@ -0,0 +1,115 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/index/multikey_paths.h"
+#include "mongo/db/query/plan_executor.h"
+
+namespace mongo {
+
+class CanonicalQuery;
+class Collection;
+class IndexScanNode;
+class OperationContext;
+class QuerySolution;
+
+/**
+ * A plan for queries of the form {$and: [{<path>: {$in: [<values>]}}, <filter>]}, planned once and
+ * then executed for any number of different sets of values by rebinding them into the bounds of
+ * its index scan.
+ *
+ * Only queries whose sole solution is a fetch of a single btree index scan, with an exact point
+ * interval on 'path' as the leading field of the index, are parameterized. Everything else about
+ * the plan, such as the bounds of the other fields of the index and the residual filter, must not
+ * depend on the values of 'path'.
+ *
+ * The plan bakes in the indexes of the collection at planning time, so callers must check
+ * isValid() whenever they have released and reacquired their collection lock.
+ */
+class ParameterizedEqualityPlan {
+    MONGO_DISALLOW_COPYING(ParameterizedEqualityPlan);
+
+public:
+    ~ParameterizedEqualityPlan();
+
+    /**
+     * Plans the query {$and: [{<path>: {$eq: <sampleValue>}}, <filter>]} against 'collection'
+     * using the collation 'collation'. Returns nullptr if its plan can't be parameterized.
+     *
+     * 'sampleValue' only serves to plan the query and should be typical of the values to be bound.
+     */
+    static std::unique_ptr<ParameterizedEqualityPlan> make(OperationContext* opCtx,
+                                                           Collection* collection,
+                                                           StringData path,
+                                                           const BSONElement& sampleValue,
+                                                           const BSONObj& filter,
+                                                           const BSONObj& collation);
+
+    /**
+     * Returns whether the indexes of 'collection' are still those this plan was made for.
+     */
+    bool isValid(OperationContext* opCtx, Collection* collection) const;
+
+    /**
+     * Returns an executor for the documents of 'collection' matching the filter and holding any of
+     * the elements of 'values' at 'path', each returned once. Returns nullptr if one of 'values'
+     * can't be looked up by value in the index: null, undefined, arrays and regular expressions
+     * all match more than equal index keys.
+     *
+     * The executor must be destroyed before bind() is called again, or this plan is destroyed.
+     */
+    std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> bind(
+        OperationContext* opCtx,
+        Collection* collection,
+        const BSONObj& values,
+        PlanExecutor::YieldPolicy yieldPolicy);
+
+private:
+    ParameterizedEqualityPlan() = default;
+
+    std::unique_ptr<CanonicalQuery> _cq;
+    std::unique_ptr<QuerySolution> _solution;
+
+    // The index scan in '_solution' whose leading bounds are rebound.
+    IndexScanNode* _indexScan = nullptr;
+
+    // What the index scanned looked like, and how many indexes the collection had, when planning.
+    BSONObj _indexInfo;
+    bool _multikey = false;
+    MultikeyPaths _multikeyPaths;
+    int _numIndexes = 0;
+};
+
+}  // namespace mongo
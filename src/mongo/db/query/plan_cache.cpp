@@ -45,6 +45,7 @@
 #include "mongo/db/query/plan_ranker.h"
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_solution.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
@@ -498,12 +499,45 @@ std::string SolutionCacheData::toString() const {
 // PlanCache
 //
 
-PlanCache::PlanCache() : _cache(internalQueryCacheSize.load()) {}
+PlanCache::PlanCache() {
+    _initPartitions();
+}
 
-PlanCache::PlanCache(const std::string& ns) : _cache(internalQueryCacheSize.load()), _ns(ns) {}
+PlanCache::PlanCache(const std::string& ns) : _ns(ns) {
+    _initPartitions();
+}
 
 PlanCache::~PlanCache() {}
 
+Counter64& PlanCache::lockContentionCounter() {
+    static Counter64 counter;
+    return counter;
+}
+
+void PlanCache::_initPartitions() {
+    const size_t maxSize = internalQueryCacheSize.load();
+    const size_t numPartitions = maxSize < kNumPartitions ? 1 : kNumPartitions;
+    const size_t partitionSize = (maxSize + numPartitions - 1) / numPartitions;
+
+    _partitions.reserve(numPartitions);
+    for (size_t i = 0; i < numPartitions; ++i) {
+        _partitions.push_back(stdx::make_unique<Partition>(partitionSize));
+    }
+}
+
+PlanCache::Partition& PlanCache::_partitionFor(const PlanCacheKey& key) const {
+    return *_partitions[std::hash<PlanCacheKey>()(key) % _partitions.size()];
+}
+
+stdx::unique_lock<stdx::mutex> PlanCache::_lockPartition(const Partition& partition) {
+    stdx::unique_lock<stdx::mutex> lk(partition.mutex, stdx::try_to_lock);
+    if (!lk.owns_lock()) {
+        lockContentionCounter().increment();
+        lk.lock();
+    }
+    return lk;
+}
+
 /**
  * Traverses expression tree pre-order.
  * Appends an encoding of each node's match type and path name
@@ -677,8 +711,10 @@ Status PlanCache::add(const CanonicalQuery& query,
     }
     entry->projection = projBuilder.obj();
 
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    std::unique_ptr<PlanCacheEntry> evictedEntry = _cache.add(computeKey(query), entry);
+    PlanCacheKey key = computeKey(query);
+    Partition& partition = _partitionFor(key);
+    auto cacheLock = _lockPartition(partition);
+    std::unique_ptr<PlanCacheEntry> evictedEntry = partition.cache.add(key, entry);
 
     if (NULL != evictedEntry.get()) {
         LOG(1) << _ns << ": plan cache maximum size exceeded - "
@@ -692,9 +728,10 @@ Status PlanCache::get(const CanonicalQuery& query, CachedSolution** crOut) const
     PlanCacheKey key = computeKey(query);
     verify(crOut);
 
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    const Partition& partition = _partitionFor(key);
+    auto cacheLock = _lockPartition(partition);
     PlanCacheEntry* entry;
-    Status cacheStatus = _cache.get(key, &entry);
+    Status cacheStatus = partition.cache.get(key, &entry);
     if (!cacheStatus.isOK()) {
         return cacheStatus;
     }
@@ -712,9 +749,10 @@ Status PlanCache::feedback(const CanonicalQuery& cq, PlanCacheEntryFeedback* fee
     std::unique_ptr<PlanCacheEntryFeedback> autoFeedback(feedback);
     PlanCacheKey ck = computeKey(cq);
 
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    const Partition& partition = _partitionFor(ck);
+    auto cacheLock = _lockPartition(partition);
     PlanCacheEntry* entry;
-    Status cacheStatus = _cache.get(ck, &entry);
+    Status cacheStatus = partition.cache.get(ck, &entry);
     if (!cacheStatus.isOK()) {
         return cacheStatus;
     }
@@ -729,13 +767,17 @@ Status PlanCache::feedback(const CanonicalQuery& cq, PlanCacheEntryFeedback* fee
 }
 
 Status PlanCache::remove(const CanonicalQuery& canonicalQuery) {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    return _cache.remove(computeKey(canonicalQuery));
+    PlanCacheKey key = computeKey(canonicalQuery);
+    Partition& partition = _partitionFor(key);
+    auto cacheLock = _lockPartition(partition);
+    return partition.cache.remove(key);
 }
 
 void PlanCache::clear() {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    _cache.clear();
+    for (auto&& partition : _partitions) {
+        auto cacheLock = _lockPartition(*partition);
+        partition->cache.clear();
+    }
 }
 
 PlanCacheKey PlanCache::computeKey(const CanonicalQuery& cq) const {
@@ -750,9 +792,10 @@ Status PlanCache::getEntry(const CanonicalQuery& query, PlanCacheEntry** entryOu
     PlanCacheKey key = computeKey(query);
     verify(entryOut);
 
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    const Partition& partition = _partitionFor(key);
+    auto cacheLock = _lockPartition(partition);
     PlanCacheEntry* entry;
-    Status cacheStatus = _cache.get(key, &entry);
+    Status cacheStatus = partition.cache.get(key, &entry);
     if (!cacheStatus.isOK()) {
         return cacheStatus;
     }
@@ -764,25 +807,33 @@ Status PlanCache::getEntry(const CanonicalQuery& query, PlanCacheEntry** entryOu
 }
 
 std::vector<PlanCacheEntry*> PlanCache::getAllEntries() const {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
     std::vector<PlanCacheEntry*> entries;
     typedef std::list<std::pair<PlanCacheKey, PlanCacheEntry*>>::const_iterator ConstIterator;
-    for (ConstIterator i = _cache.begin(); i != _cache.end(); i++) {
-        PlanCacheEntry* entry = i->second;
-        entries.push_back(entry->clone());
+    for (auto&& partition : _partitions) {
+        auto cacheLock = _lockPartition(*partition);
+        for (ConstIterator i = partition->cache.begin(); i != partition->cache.end(); i++) {
+            PlanCacheEntry* entry = i->second;
+            entries.push_back(entry->clone());
+        }
     }
 
     return entries;
 }
 
 bool PlanCache::contains(const CanonicalQuery& cq) const {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    return _cache.hasKey(computeKey(cq));
+    PlanCacheKey key = computeKey(cq);
+    const Partition& partition = _partitionFor(key);
+    auto cacheLock = _lockPartition(partition);
+    return partition.cache.hasKey(key);
 }
 
 size_t PlanCache::size() const {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    return _cache.size();
+    size_t total = 0;
+    for (auto&& partition : _partitions) {
+        auto cacheLock = _lockPartition(*partition);
+        total += partition->cache.size();
+    }
+    return total;
 }
 
 void PlanCache::notifyOfIndexEntries(const std::vector<IndexEntry>& indexEntries) {
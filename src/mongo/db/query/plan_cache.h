@@ -31,6 +31,7 @@
 #include <boost/optional/optional.hpp>
 #include <set>
 
+#include "mongo/base/counter.h"
 #include "mongo/db/exec/plan_stats.h"
 #include "mongo/db/query/canonical_query.h"
 #include "mongo/db/query/index_tag.h"
@@ -410,15 +411,50 @@ public:
      */
     void notifyOfIndexEntries(const std::vector<IndexEntry>& indexEntries);
 
+    /**
+     * Number of times, across all plan caches, that a thread had to wait for another thread to
+     * release a cache partition's mutex. Reported in serverStatus.
+     */
+    static Counter64& lockContentionCounter();
+
+    // The cache is split into this many independently locked partitions, unless the configured
+    // cache size is smaller than this, in which case a single partition is used.
+    static const size_t kNumPartitions = 16;
+
 private:
+    /**
+     * A slice of the plan cache with its own LRU ordering and its own mutex. Each key always
+     * maps to the same partition, so operations on different query shapes rarely contend.
+     */
+    struct Partition {
+        explicit Partition(size_t maxSize) : cache(maxSize) {}
+
+        // Protects 'cache'.
+        mutable stdx::mutex mutex;
+        LRUKeyValue<PlanCacheKey, PlanCacheEntry> cache;
+    };
+
     void encodeKeyForMatch(const MatchExpression* tree, StringBuilder* keyBuilder) const;
     void encodeKeyForSort(const BSONObj& sortObj, StringBuilder* keyBuilder) const;
     void encodeKeyForProj(const BSONObj& projObj, StringBuilder* keyBuilder) const;
 
-    LRUKeyValue<PlanCacheKey, PlanCacheEntry> _cache;
+    /**
+     * Builds the partitions, dividing 'internalQueryCacheSize' evenly between them.
+     */
+    void _initPartitions();
+
+    /**
+     * Returns the partition responsible for 'key'.
+     */
+    Partition& _partitionFor(const PlanCacheKey& key) const;
+
+    /**
+     * Locks 'partition', counting the acquisition in lockContentionCounter() if the mutex was
+     * already held by another thread.
+     */
+    static stdx::unique_lock<stdx::mutex> _lockPartition(const Partition& partition);
 
-    // Protects _cache.
-    mutable stdx::mutex _cacheMutex;
+    std::vector<std::unique_ptr<Partition>> _partitions;
 
     // Full namespace of collection.
     std::string _ns;
@@ -46,6 +46,7 @@
 #include "mongo/db/query/query_planner_test_lib.h"
 #include "mongo/db/query/query_solution.h"
 #include "mongo/db/query/query_test_service_context.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/scopeguard.h"
@@ -423,6 +424,96 @@ TEST(PlanCacheTest, AddValidSolution) {
     ASSERT_EQUALS(planCache.size(), 1U);
 }
 
+/**
+ * Builds 'numShapes' queries with distinct shapes, {f0: 1}, {f1: 1}, ...
+ */
+std::vector<unique_ptr<CanonicalQuery>> makeDistinctShapes(size_t numShapes) {
+    std::vector<unique_ptr<CanonicalQuery>> queries;
+    for (size_t i = 0; i < numShapes; ++i) {
+        const std::string fieldName = str::stream() << "f" << i;
+        queries.push_back(canonicalize(BSON(fieldName << 1)));
+    }
+    return queries;
+}
+
+TEST(PlanCacheTest, SizeLimitIsSpreadAcrossPartitions) {
+    const int oldCacheSize = internalQueryCacheSize.load();
+    internalQueryCacheSize.store(32);
+    ON_BLOCK_EXIT([oldCacheSize] { internalQueryCacheSize.store(oldCacheSize); });
+
+    PlanCache planCache;
+    QuerySolution qs;
+    qs.cacheData.reset(new SolutionCacheData());
+    qs.cacheData->tree.reset(new PlanCacheIndexTree());
+    std::vector<QuerySolution*> solns;
+    solns.push_back(&qs);
+
+    auto queries = makeDistinctShapes(200);
+    for (auto&& cq : queries) {
+        ASSERT_OK(planCache.add(*cq, solns, createDecision(1U)));
+    }
+
+    // Every partition evicts independently, so the cache never holds more than the configured
+    // number of entries in total.
+    ASSERT_LTE(planCache.size(), 32U);
+    ASSERT_GT(planCache.size(), 0U);
+
+    // The most recently added shape is always the newest entry of its partition.
+    ASSERT_TRUE(planCache.contains(*queries.back()));
+
+    std::vector<PlanCacheEntry*> entries = planCache.getAllEntries();
+    ASSERT_EQUALS(entries.size(), planCache.size());
+    for (auto entry : entries) {
+        delete entry;
+    }
+
+    planCache.clear();
+    ASSERT_EQUALS(planCache.size(), 0U);
+}
+
+TEST(PlanCacheTest, ConcurrentLookupsOfDistinctShapes) {
+    PlanCache planCache;
+    QuerySolution qs;
+    qs.cacheData.reset(new SolutionCacheData());
+    qs.cacheData->tree.reset(new PlanCacheIndexTree());
+    std::vector<QuerySolution*> solns;
+    solns.push_back(&qs);
+
+    auto queries = makeDistinctShapes(64);
+    for (auto&& cq : queries) {
+        ASSERT_OK(planCache.add(*cq, solns, createDecision(1U)));
+    }
+
+    // Each thread repeatedly looks up every shape, starting at a different offset so that the
+    // threads touch different partitions at any given moment.
+    const size_t kNumThreads = 8;
+    const size_t kIterations = 200;
+    std::vector<size_t> numFound(kNumThreads, 0);
+    std::vector<stdx::thread> threads;
+    for (size_t t = 0; t < kNumThreads; ++t) {
+        threads.emplace_back([&, t] {
+            for (size_t iter = 0; iter < kIterations; ++iter) {
+                for (size_t i = 0; i < queries.size(); ++i) {
+                    const auto& cq = queries[(i + t * 8) % queries.size()];
+                    CachedSolution* cs;
+                    if (planCache.get(*cq, &cs).isOK()) {
+                        delete cs;
+                        ++numFound[t];
+                    }
+                }
+            }
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+
+    for (size_t t = 0; t < kNumThreads; ++t) {
+        ASSERT_EQUALS(numFound[t], kIterations * queries.size());
+    }
+    ASSERT_EQUALS(planCache.size(), queries.size());
+}
+
 /**
  * Each test in the CachePlanSelectionTest suite goes through
  * the following flow:
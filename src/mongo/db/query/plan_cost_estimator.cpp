@@ -0,0 +1,198 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/plan_cost_estimator.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace mongo {
+
+constexpr double PlanCostEstimator::kPointSelectivity;
+constexpr double PlanCostEstimator::kRangeSelectivity;
+
+namespace {
+
+// Fetching a document costs more than examining an index key, so each FETCH charges its
+// input again on top of the cost of producing it.
+const double kFetchCostFactor = 2.0;
+
+// A blocking sort has to consume all of its input before returning anything.
+const double kBlockingSortCostFactor = 1.5;
+
+bool isMinToMax(const Interval& interval) {
+    return (interval.start.type() == MinKey && interval.end.type() == MaxKey) ||
+        (interval.start.type() == MaxKey && interval.end.type() == MinKey);
+}
+
+double estimateFieldSelectivity(const OrderedIntervalList& oil,
+                                const CollectionStatistics* stats) {
+    const FieldHistogram* histogram = stats ? stats->getField(oil.name) : nullptr;
+
+    double selectivity = 0;
+    for (auto&& interval : oil.intervals) {
+        if (isMinToMax(interval)) {
+            return 1.0;
+        }
+        if (histogram) {
+            selectivity += histogram->estimateSelectivity(interval);
+        } else {
+            selectivity += interval.isPoint() ? PlanCostEstimator::kPointSelectivity
+                                              : PlanCostEstimator::kRangeSelectivity;
+        }
+    }
+    return std::min(selectivity, 1.0);
+}
+
+/**
+ * Returns the estimated cost of the subtree rooted at 'node', or boost::none if it cannot be
+ * estimated.
+ */
+boost::optional<double> estimateNodeCost(const QuerySolutionNode* node,
+                                         double numRecords,
+                                         const CollectionStatistics* stats) {
+    switch (node->getType()) {
+        case STAGE_COLLSCAN:
+            return numRecords;
+        case STAGE_IXSCAN: {
+            const auto* ixscan = static_cast<const IndexScanNode*>(node);
+            return numRecords *
+                PlanCostEstimator::estimateBoundsSelectivity(ixscan->bounds, stats);
+        }
+        case STAGE_GEO_NEAR_2D:
+        case STAGE_GEO_NEAR_2DSPHERE:
+        case STAGE_TEXT:
+            return boost::none;
+        default:
+            break;
+    }
+
+    if (node->children.empty()) {
+        return boost::none;
+    }
+
+    double cost = 0;
+    for (auto&& child : node->children) {
+        auto childCost = estimateNodeCost(child, numRecords, stats);
+        if (!childCost) {
+            return boost::none;
+        }
+        cost += *childCost;
+    }
+
+    if (STAGE_FETCH == node->getType()) {
+        cost *= kFetchCostFactor;
+    } else if (STAGE_SORT == node->getType()) {
+        cost *= kBlockingSortCostFactor;
+    }
+    return cost;
+}
+
+}  // namespace
+
+double PlanCostEstimator::estimateBoundsSelectivity(const IndexBounds& bounds,
+                                                    const CollectionStatistics* stats) {
+    if (bounds.isSimpleRange) {
+        return kRangeSelectivity;
+    }
+
+    double selectivity = 1.0;
+    for (auto&& oil : bounds.fields) {
+        selectivity *= estimateFieldSelectivity(oil, stats);
+    }
+    return selectivity;
+}
+
+boost::optional<double> PlanCostEstimator::estimateCost(const QuerySolution& solution,
+                                                        long long numRecords,
+                                                        const CollectionStatistics* stats) {
+    if (!solution.root) {
+        return boost::none;
+    }
+    // Never let an empty collection make every plan look equally free.
+    return estimateNodeCost(solution.root.get(), std::max(numRecords, 1LL), stats);
+}
+
+size_t PlanCostEstimator::pruneCandidates(long long numRecords,
+                                          size_t maxCandidates,
+                                          std::vector<QuerySolution*>* solutions,
+                                          const CollectionStatistics* stats) {
+    if (0 == maxCandidates || solutions->size() <= maxCandidates) {
+        return 0;
+    }
+
+    std::vector<double> costs;
+    for (auto solution : *solutions) {
+        auto cost = estimateCost(*solution, numRecords, stats);
+        if (!cost) {
+            return 0;
+        }
+        costs.push_back(*cost);
+    }
+
+    std::vector<size_t> order(solutions->size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+        return costs[lhs] < costs[rhs];
+    });
+
+    std::vector<bool> keep(solutions->size(), false);
+    bool keptNonBlocking = false;
+    for (size_t i = 0; i < maxCandidates; ++i) {
+        keep[order[i]] = true;
+        keptNonBlocking = keptNonBlocking || !(*solutions)[order[i]]->hasBlockingStage;
+    }
+
+    if (!keptNonBlocking) {
+        // Swap the most expensive kept solution for the cheapest non-blocking one, if any.
+        for (size_t i = maxCandidates; i < order.size(); ++i) {
+            if (!(*solutions)[order[i]]->hasBlockingStage) {
+                keep[order[maxCandidates - 1]] = false;
+                keep[order[i]] = true;
+                break;
+            }
+        }
+    }
+
+    std::vector<QuerySolution*> kept;
+    for (size_t i = 0; i < solutions->size(); ++i) {
+        if (keep[i]) {
+            kept.push_back((*solutions)[i]);
+        } else {
+            delete (*solutions)[i];
+        }
+    }
+
+    const size_t numPruned = solutions->size() - kept.size();
+    solutions->swap(kept);
+    return numPruned;
+}
+
+}  // namespace mongo
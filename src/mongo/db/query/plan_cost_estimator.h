@@ -0,0 +1,88 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <vector>
+
+#include "mongo/db/query/collection_statistics.h"
+#include "mongo/db/query/index_bounds.h"
+#include "mongo/db/query/query_solution.h"
+
+namespace mongo {
+
+/**
+ * Produces rough, relative cost estimates for query solutions without executing them. The
+ * estimate is derived from the width of each index scan's bounds and the number of records in
+ * the collection. Fields with statistics gathered by the 'analyze' command are estimated from
+ * their histograms; other fields fall back to fixed selectivities. It is only good enough to
+ * discard candidates that are obviously worse than others before the multi-planner's trial
+ * period; the trial remains the arbiter between the remaining plans.
+ */
+class PlanCostEstimator {
+public:
+    // Assumed fraction of the collection matched by a single point interval on one field.
+    static constexpr double kPointSelectivity = 0.01;
+
+    // Assumed fraction of the collection matched by a single non-point interval on one field.
+    static constexpr double kRangeSelectivity = 0.3;
+
+    /**
+     * Returns the estimated fraction, in [0, 1], of an index's keys that a scan over 'bounds'
+     * examines. Fields are assumed to be independent. 'stats' may be null.
+     */
+    static double estimateBoundsSelectivity(const IndexBounds& bounds,
+                                            const CollectionStatistics* stats = nullptr);
+
+    /**
+     * Returns an estimate of the number of keys and documents examined by 'solution' against a
+     * collection of 'numRecords' documents. Returns boost::none if the solution contains a leaf
+     * stage, such as a text or geo stage, for which no estimate can be made. 'stats' may be null.
+     */
+    static boost::optional<double> estimateCost(const QuerySolution& solution,
+                                                long long numRecords,
+                                                const CollectionStatistics* stats = nullptr);
+
+    /**
+     * If there are more than 'maxCandidates' solutions in 'solutions', deletes all but the
+     * 'maxCandidates' cheapest ones according to estimateCost(). If any solution avoids a
+     * blocking stage, at least one such solution is kept so that the multi-planner can still
+     * pick a backup plan. The relative order of the remaining solutions is preserved.
+     *
+     * Does nothing if 'maxCandidates' is zero or if any solution cannot be estimated.
+     *
+     * Returns the number of solutions removed.
+     */
+    static size_t pruneCandidates(long long numRecords,
+                                  size_t maxCandidates,
+                                  std::vector<QuerySolution*>* solutions,
+                                  const CollectionStatistics* stats = nullptr);
+};
+
+}  // namespace mongo
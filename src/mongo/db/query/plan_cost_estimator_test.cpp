@@ -0,0 +1,213 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/plan_cost_estimator.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/query/index_bounds_builder.h"
+#include "mongo/db/query/index_entry.h"
+#include "mongo/db/query/query_solution.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/unittest.h"
+
+namespace {
+
+using namespace mongo;
+
+const long long kNumRecords = 10000;
+
+OrderedIntervalList pointsOIL(const std::string& name, int numPoints) {
+    OrderedIntervalList oil(name);
+    for (int i = 0; i < numPoints; ++i) {
+        oil.intervals.push_back(IndexBoundsBuilder::makePointInterval(BSON("" << i)));
+    }
+    return oil;
+}
+
+OrderedIntervalList rangeOIL(const std::string& name, int start, int end) {
+    OrderedIntervalList oil(name);
+    oil.intervals.push_back(IndexBoundsBuilder::makeRangeInterval(
+        BSON("" << start << "" << end), BoundInclusion::kIncludeBothStartAndEndKeys));
+    return oil;
+}
+
+OrderedIntervalList allValuesOIL(const std::string& name) {
+    OrderedIntervalList oil(name);
+    oil.intervals.push_back(IndexBoundsBuilder::allValues());
+    return oil;
+}
+
+/**
+ * Builds FETCH -> IXSCAN over an index on 'field' with the given bounds.
+ */
+std::unique_ptr<QuerySolution> makeIndexedSolution(const std::string& field,
+                                                   const OrderedIntervalList& oil,
+                                                   bool blockingSort = false) {
+    auto ixscan = stdx::make_unique<IndexScanNode>(IndexEntry(BSON(field << 1)));
+    ixscan->bounds.fields.push_back(oil);
+
+    auto fetch = stdx::make_unique<FetchNode>();
+    fetch->children.push_back(ixscan.release());
+
+    auto solution = stdx::make_unique<QuerySolution>();
+    if (blockingSort) {
+        auto sort = stdx::make_unique<SortNode>();
+        sort->children.push_back(fetch.release());
+        solution->root = std::move(sort);
+        solution->hasBlockingStage = true;
+    } else {
+        solution->root = std::move(fetch);
+    }
+    return solution;
+}
+
+std::unique_ptr<QuerySolution> makeCollScanSolution() {
+    auto solution = stdx::make_unique<QuerySolution>();
+    solution->root = stdx::make_unique<CollectionScanNode>();
+    return solution;
+}
+
+TEST(PlanCostEstimatorTest, BoundsSelectivity) {
+    IndexBounds points;
+    points.fields.push_back(pointsOIL("a", 3));
+    ASSERT_APPROX_EQUAL(PlanCostEstimator::estimateBoundsSelectivity(points),
+                        3 * PlanCostEstimator::kPointSelectivity,
+                        1e-9);
+
+    IndexBounds range;
+    range.fields.push_back(rangeOIL("a", 1, 5));
+    ASSERT_APPROX_EQUAL(PlanCostEstimator::estimateBoundsSelectivity(range),
+                        PlanCostEstimator::kRangeSelectivity,
+                        1e-9);
+
+    IndexBounds compound;
+    compound.fields.push_back(pointsOIL("a", 1));
+    compound.fields.push_back(rangeOIL("b", 1, 5));
+    compound.fields.push_back(allValuesOIL("c"));
+    ASSERT_APPROX_EQUAL(PlanCostEstimator::estimateBoundsSelectivity(compound),
+                        PlanCostEstimator::kPointSelectivity * PlanCostEstimator::kRangeSelectivity,
+                        1e-9);
+
+    IndexBounds all;
+    all.fields.push_back(allValuesOIL("a"));
+    ASSERT_EQUALS(PlanCostEstimator::estimateBoundsSelectivity(all), 1.0);
+}
+
+TEST(PlanCostEstimatorTest, NarrowerBoundsAreCheaper) {
+    auto point = makeIndexedSolution("a", pointsOIL("a", 1));
+    auto range = makeIndexedSolution("b", rangeOIL("b", 1, 100));
+    auto collScan = makeCollScanSolution();
+
+    auto pointCost = PlanCostEstimator::estimateCost(*point, kNumRecords);
+    auto rangeCost = PlanCostEstimator::estimateCost(*range, kNumRecords);
+    auto collScanCost = PlanCostEstimator::estimateCost(*collScan, kNumRecords);
+    ASSERT(pointCost);
+    ASSERT(rangeCost);
+    ASSERT(collScanCost);
+    ASSERT_LT(*pointCost, *rangeCost);
+    ASSERT_EQUALS(*collScanCost, static_cast<double>(kNumRecords));
+}
+
+TEST(PlanCostEstimatorTest, StatisticsOverrideDefaultSelectivities) {
+    // Every document has a == 0 while b is unique, so an equality on 'a' is far less selective
+    // than a short range on 'b', contrary to the defaults.
+    std::vector<BSONObj> sample;
+    for (int i = 0; i < 1000; ++i) {
+        sample.push_back(BSON("a" << 0 << "b" << i));
+    }
+    auto stats = CollectionStatistics::make(sample, {"a", "b"}, kNumRecords);
+
+    auto pointA = makeIndexedSolution("a", pointsOIL("a", 1));
+    auto rangeB = makeIndexedSolution("b", rangeOIL("b", 1, 5));
+
+    ASSERT_LT(*PlanCostEstimator::estimateCost(*pointA, kNumRecords),
+              *PlanCostEstimator::estimateCost(*rangeB, kNumRecords));
+    ASSERT_GT(*PlanCostEstimator::estimateCost(*pointA, kNumRecords, &stats),
+              *PlanCostEstimator::estimateCost(*rangeB, kNumRecords, &stats));
+}
+
+TEST(PlanCostEstimatorTest, UnknownLeafCannotBeEstimated) {
+    QuerySolution solution;
+    solution.root = stdx::make_unique<TextNode>(IndexEntry(BSON("_fts" << "text" << "_ftsx" << 1)));
+    ASSERT_FALSE(PlanCostEstimator::estimateCost(solution, kNumRecords));
+}
+
+TEST(PlanCostEstimatorTest, PruneKeepsCheapestInOriginalOrder) {
+    std::vector<QuerySolution*> solutions;
+    solutions.push_back(makeCollScanSolution().release());
+    solutions.push_back(makeIndexedSolution("a", pointsOIL("a", 1)).release());
+    solutions.push_back(makeIndexedSolution("b", rangeOIL("b", 1, 5)).release());
+    solutions.push_back(makeIndexedSolution("c", pointsOIL("c", 2)).release());
+    QuerySolution* pointA = solutions[1];
+    QuerySolution* pointsC = solutions[3];
+
+    ASSERT_EQUALS(PlanCostEstimator::pruneCandidates(kNumRecords, 2, &solutions), 2U);
+    ASSERT_EQUALS(solutions.size(), 2U);
+    ASSERT_EQUALS(solutions[0], pointA);
+    ASSERT_EQUALS(solutions[1], pointsC);
+
+    for (auto solution : solutions) {
+        delete solution;
+    }
+}
+
+TEST(PlanCostEstimatorTest, PruneKeepsANonBlockingCandidate) {
+    std::vector<QuerySolution*> solutions;
+    solutions.push_back(makeIndexedSolution("a", pointsOIL("a", 1), true).release());
+    solutions.push_back(makeIndexedSolution("b", pointsOIL("b", 2), true).release());
+    solutions.push_back(makeIndexedSolution("c", allValuesOIL("c")).release());
+    QuerySolution* blockingA = solutions[0];
+    QuerySolution* nonBlockingC = solutions[2];
+
+    ASSERT_EQUALS(PlanCostEstimator::pruneCandidates(kNumRecords, 2, &solutions), 1U);
+    ASSERT_EQUALS(solutions.size(), 2U);
+    ASSERT_EQUALS(solutions[0], blockingA);
+    ASSERT_EQUALS(solutions[1], nonBlockingC);
+
+    for (auto solution : solutions) {
+        delete solution;
+    }
+}
+
+TEST(PlanCostEstimatorTest, PruneIsDisabledByZeroOrSmallCandidateSets) {
+    std::vector<QuerySolution*> solutions;
+    solutions.push_back(makeCollScanSolution().release());
+    solutions.push_back(makeIndexedSolution("a", pointsOIL("a", 1)).release());
+
+    ASSERT_EQUALS(PlanCostEstimator::pruneCandidates(kNumRecords, 0, &solutions), 0U);
+    ASSERT_EQUALS(PlanCostEstimator::pruneCandidates(kNumRecords, 2, &solutions), 0U);
+    ASSERT_EQUALS(solutions.size(), 2U);
+
+    for (auto solution : solutions) {
+        delete solution;
+    }
+}
+
+}  // namespace
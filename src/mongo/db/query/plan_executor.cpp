@@ -42,6 +42,7 @@
 #include "mongo/db/exec/subplan.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/operation_phases.h"
 #include "mongo/db/query/plan_yield_policy.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/record_fetcher.h"
@@ -207,6 +208,7 @@ PlanExecutor::PlanExecutor(OperationContext* opCtx,
 
 Status PlanExecutor::pickBestPlan(const Collection* collection) {
     invariant(_currentState == kUsable);
+    OperationPhases::Scope planningPhase(_opCtx, OperationPhases::Phase::kPlanning);
 
     // First check if we need to do subplanning.
     PlanStage* foundStage = getStageByType(_root.get(), STAGE_SUBPLAN);
@@ -461,7 +463,7 @@ PlanExecutor::ExecState PlanExecutor::getNextImpl(Snapshotted<BSONObj>* objOut,
                     } else {
                         // TODO: currently snapshot ids are only associated with documents, and
                         // not with index keys.
-                        *objOut = Snapshotted<BSONObj>(SnapshotId(), member->keyData[0].keyData);
+                        *objOut = Snapshotted<BSONObj>(SnapshotId(), member->keyData[0].keyData());
                     }
                 } else if (member->hasObj()) {
                     *objOut = member->obj;
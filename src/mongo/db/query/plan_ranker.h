@@ -70,7 +70,7 @@ public:
  */
 struct CandidatePlan {
     CandidatePlan(QuerySolution* s, PlanStage* r, WorkingSet* w)
-        : solution(s), root(r), ws(w), failed(false) {}
+        : solution(s), root(r), ws(w), failed(false), dominated(false) {}
 
     std::unique_ptr<QuerySolution> solution;
     PlanStage* root;  // Not owned here.
@@ -80,6 +80,10 @@ struct CandidatePlan {
     std::list<WorkingSetID> results;
 
     bool failed;
+
+    // Set when the trial period stops working this plan because another candidate returned far
+    // more results. A dominated plan keeps its state and may still be used as a backup plan.
+    bool dominated;
 };
 
 /**
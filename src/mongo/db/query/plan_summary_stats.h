@@ -45,8 +45,8 @@ struct PlanSummaryStats {
     // The total number of documents examined by the plan.
     size_t totalDocsExamined = 0U;
 
-    // The number of milliseconds spent inside the root stage's work() method.
-    long long executionTimeMillis = 0;
+    // The number of nanoseconds spent inside the root stage's work() method.
+    long long executionTimeNanos = 0;
 
     // Did this plan use an in-memory sort stage?
     bool hasSortStage = false;
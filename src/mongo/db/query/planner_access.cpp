@@ -134,6 +134,22 @@ std::vector<bool> canProvideSortWithMergeSort(const std::vector<QuerySolutionNod
     return shouldReverseScan;
 }
 
+/**
+ * Returns true if 'expr' can be matched against several documents at once from different threads.
+ * $where runs in a JavaScript scope that belongs to the operation, so it cannot be.
+ */
+bool canMatchConcurrently(const MatchExpression* expr) {
+    if (MatchExpression::WHERE == expr->matchType()) {
+        return false;
+    }
+    for (size_t i = 0; i < expr->numChildren(); ++i) {
+        if (!canMatchConcurrently(expr->getChild(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
 }  // namespace
 
 namespace mongo {
@@ -152,6 +168,13 @@ std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::makeCollectionScan(
     csn->tailable = tailable;
     csn->maxScan = query.getQueryRequest().getMaxScan();
 
+    // Collation-aware comparisons are left on the operation's own thread, as the collator's
+    // thread safety is up to its implementation.
+    if ((params.options & QueryPlannerParams::PARALLEL_COLLSCAN) && !tailable && !csn->maxScan &&
+        !query.getCollator() && canMatchConcurrently(csn->filter.get())) {
+        csn->maxParallelism = std::max(1, internalQueryExecCollScanMaxParallelism.load());
+    }
+
     // If the hint is {$natural: +-1} this changes the direction of the collection scan.
     if (!query.getQueryRequest().getHint().isEmpty()) {
         BSONElement natural =
@@ -599,6 +599,14 @@ QuerySolutionNode* QueryPlannerAnalysis::analyzeSort(const CanonicalQuery& query
         sort->limit = 0;
     }
 
+    // A text node directly beneath a limited sort on the text score needs to produce only the
+    // highest scoring documents.
+    const QuerySolutionNode* sortInput = keyGenNode->children[0];
+    if (sort->limit && STAGE_TEXT == sortInput->getType() && 1 == sortObj.nFields() &&
+        QueryRequest::isTextScoreMeta(sortObj.firstElement())) {
+        static_cast<TextNode*>(keyGenNode->children[0])->limit = sort->limit;
+    }
+
     *blockingSortOut = true;
 
     return solnRoot;
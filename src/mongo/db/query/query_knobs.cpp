@@ -38,10 +38,16 @@ MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationCollFraction, double, 0
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationMaxResults, int, 101);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationMaxCandidates, int, 16);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationDominanceRatio, double, 10.0);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheSize, int, 5000);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheFeedbacksStored, int, 20);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryStatsStoreSize, int, 1000);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheEvictionRatio, double, 10.0);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerMaxIndexedSolutions, int, 64);
@@ -66,12 +72,30 @@ MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecMaxBlockingSortBytes, int, 32 * 1
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldIterations, int, 128);
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldPeriodMS, int, 10);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecCollScanMaxParallelism, int, 1);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecSharedOplogBufferMaxBytes, int, 16 * 1024 * 1024);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecDeleteBatchSize, int, 64);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryFacetBufferSizeBytes, int, 100 * 1024 * 1024);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryFacetMaxParallelism, int, 1);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalInsertMaxBatchSize,
                               int,
                               internalQueryExecYieldIterations.load() / 2);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceCursorBatchSizeBytes, int, 4 * 1024 * 1024);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookupEnableHashJoin, bool, true);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookupHashJoinMaxMemoryBytes,
+                              int,
+                              100 * 1024 * 1024);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookupBatchSize, int, 100);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookupPrepareQueries, bool, true);
+
 }  // namespace mongo
@@ -48,6 +48,14 @@ extern AtomicDouble internalQueryPlanEvaluationCollFraction;
 // Stop working plans once a plan returns this many results.
 extern AtomicInt32 internalQueryPlanEvaluationMaxResults;
 
+// If the planner generates more candidates than this, only this many of the cheapest ones, by a
+// bounds-based cost estimate, are raced against each other. Zero disables the pruning.
+extern AtomicInt32 internalQueryPlanEvaluationMaxCandidates;
+
+// During the trial period, stop working a candidate once the leading candidate has returned
+// this many times more results. Zero disables early termination of dominated candidates.
+extern AtomicDouble internalQueryPlanEvaluationDominanceRatio;
+
 // Do we give a big ranking bonus to intersection plans?
 extern AtomicBool internalQueryForceIntersectionPlans;
 
@@ -68,6 +76,10 @@ extern AtomicInt32 internalQueryCacheSize;
 // performance?
 extern AtomicInt32 internalQueryCacheFeedbacksStored;
 
+// How many query shapes, across all collections, have their execution statistics tracked for
+// $queryStats? Zero disables tracking.
+extern AtomicInt32 internalQueryStatsStoreSize;
+
 // How many times more works must we perform in order to justify plan cache eviction
 // and replanning?
 extern AtomicDouble internalQueryCacheEvictionRatio;
@@ -104,14 +116,46 @@ extern AtomicInt32 internalQueryExecYieldIterations;
 // Yield if it's been at least this many milliseconds since we last yielded.
 extern AtomicInt32 internalQueryExecYieldPeriodMS;
 
+// How many threads a collection scan beneath an aggregation may use to evaluate its filter. A value
+// of 1 keeps all filtering on the operation's own thread.
+extern AtomicInt32 internalQueryExecCollScanMaxParallelism;
+
+// The most bytes of recently read oplog entries that tailing scans of the oplog keep for each
+// other, so that each entry is read from storage once rather than once per tailer. 0 disables
+// sharing.
+extern AtomicInt32 internalQueryExecSharedOplogBufferMaxBytes;
+
+// How many documents a multi-delete which does not return the deleted documents removes in each
+// WriteUnitOfWork. A value of 1 deletes every document in a WriteUnitOfWork of its own.
+extern AtomicInt32 internalQueryExecDeleteBatchSize;
+
 // Limit the size that we write without yielding to 16MB / 64 (max expected number of indexes)
 const int64_t insertVectorMaxBytes = 256 * 1024;
 
 // The number of bytes to buffer at once during a $facet stage.
 extern AtomicInt32 internalQueryFacetBufferSizeBytes;
 
+// How many threads a $facet stage may use to run its sub-pipelines over each buffered batch. A
+// value of 1 runs them all on the operation's own thread.
+extern AtomicInt32 internalQueryFacetMaxParallelism;
+
 extern AtomicInt32 internalInsertMaxBatchSize;
 
 extern AtomicInt32 internalDocumentSourceCursorBatchSizeBytes;
 
+// Whether $lookup may answer a localField/foreignField join from an in-memory hash table of the
+// foreign collection once that is estimated to be cheaper than querying it for each document.
+extern AtomicBool internalDocumentSourceLookupEnableHashJoin;
+
+// The most memory, in bytes, that the hash table built by a $lookup may use.
+extern AtomicInt32 internalDocumentSourceLookupHashJoinMaxMemoryBytes;
+
+// How many input documents a $lookup answers with each query of the foreign collection, asking for
+// all of their local values at once with an $in.
+extern AtomicInt32 internalDocumentSourceLookupBatchSize;
+
+// Whether $lookup plans its queries of the foreign collection once, and then only rebinds the local
+// values into the index bounds of that plan for each query, when the plan allows it.
+extern AtomicBool internalDocumentSourceLookupPrepareQueries;
+
 }  // namespace mongo
@@ -0,0 +1,212 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/query_memory_budget.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryMaxProcessMemoryBytes, long long, 0);
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryMemoryWaitMS, int, 1000);
+
+namespace {
+
+struct OperationUsage {
+    AtomicInt64 bytes;
+    AtomicInt64 peakBytes;
+};
+
+const auto getOperationUsage = OperationContext::declareDecoration<OperationUsage>();
+
+AtomicInt64 reservedBytes;
+AtomicInt64 numSpills;
+AtomicInt64 numWaits;
+AtomicInt64 numFailures;
+
+// Stages waiting for memory sleep on 'memoryReleased'; whoever releases memory while some are
+// waiting wakes them all up to try again.
+stdx::mutex waitMutex;
+stdx::condition_variable memoryReleased;
+AtomicInt32 numWaiting;
+
+bool tryReserve(long long delta) {
+    if (delta <= 0) {
+        reservedBytes.fetchAndAdd(delta);
+        return true;
+    }
+
+    long long current = reservedBytes.load();
+    while (true) {
+        const long long limit = internalQueryMaxProcessMemoryBytes.load();
+        if (limit > 0 && current + delta > limit) {
+            return false;
+        }
+        const long long observed = reservedBytes.compareAndSwap(current, current + delta);
+        if (observed == current) {
+            return true;
+        }
+        current = observed;
+    }
+}
+
+void notifyWaiters() {
+    if (numWaiting.load() > 0) {
+        stdx::lock_guard<stdx::mutex> lk(waitMutex);
+        memoryReleased.notify_all();
+    }
+}
+
+class QueryMemoryMetric final : public ServerStatusMetric {
+public:
+    QueryMemoryMetric() : ServerStatusMetric(".queryMemory") {}
+
+    void appendAtLeaf(BSONObjBuilder& b) const final {
+        BSONObjBuilder section(b.subobjStart(_leafName));
+        section.append("limitBytes", internalQueryMaxProcessMemoryBytes.load());
+        section.append("reservedBytes", reservedBytes.load());
+        section.append("waitingStages", numWaiting.load());
+        section.append("earlySpills", numSpills.load());
+        section.append("waits", numWaits.load());
+        section.append("failures", numFailures.load());
+    }
+} queryMemoryMetric;
+
+}  // namespace
+
+QueryMemoryBudget::Reservation::Reservation(OperationContext* opCtx) : _opCtx(opCtx) {}
+
+QueryMemoryBudget::Reservation::~Reservation() {
+    resize(0);
+}
+
+void QueryMemoryBudget::Reservation::_adjust(long long delta) {
+    _bytes += delta;
+    if (delta < 0) {
+        notifyWaiters();
+    }
+    if (!_opCtx) {
+        return;
+    }
+
+    auto& usage = getOperationUsage(_opCtx);
+    const long long bytes = usage.bytes.addAndFetch(delta);
+    long long peak = usage.peakBytes.load();
+    while (bytes > peak) {
+        const long long observed = usage.peakBytes.compareAndSwap(peak, bytes);
+        if (observed == peak) {
+            break;
+        }
+        peak = observed;
+    }
+}
+
+bool QueryMemoryBudget::Reservation::tryResize(size_t bytes) {
+    const long long delta = static_cast<long long>(bytes) - static_cast<long long>(_bytes);
+    if (!tryReserve(delta)) {
+        return false;
+    }
+    _adjust(delta);
+    return true;
+}
+
+void QueryMemoryBudget::Reservation::resize(size_t bytes) {
+    const long long delta = static_cast<long long>(bytes) - static_cast<long long>(_bytes);
+    reservedBytes.fetchAndAdd(delta);
+    _adjust(delta);
+}
+
+void QueryMemoryBudget::Reservation::resizeOrWait(size_t bytes, StringData stageName) {
+    if (tryResize(bytes)) {
+        return;
+    }
+
+    numWaits.fetchAndAdd(1);
+    const Date_t deadline = Date_t::now() + Milliseconds(internalQueryMemoryWaitMS.load());
+    stdx::unique_lock<stdx::mutex> lk(waitMutex);
+    // Counting ourselves as waiting before trying again guarantees that memory released after the
+    // attempt fails wakes us up.
+    numWaiting.fetchAndAdd(1);
+    ON_BLOCK_EXIT([] { numWaiting.fetchAndSubtract(1); });
+
+    const auto reserved = [&] { return tryResize(bytes); };
+    const bool succeeded = _opCtx
+        ? _opCtx->waitForConditionOrInterruptUntil(memoryReleased, lk, deadline, reserved)
+        : memoryReleased.wait_until(lk, deadline.toSystemTimePoint(), reserved);
+    if (!succeeded) {
+        numFailures.fetchAndAdd(1);
+        uasserted(ErrorCodes::ExceededMemoryLimit,
+                  str::stream() << stageName << " could not reserve " << bytes
+                                << " bytes of query memory within "
+                                << internalQueryMemoryWaitMS.load()
+                                << "ms; the process limit internalQueryMaxProcessMemoryBytes is "
+                                << internalQueryMaxProcessMemoryBytes.load() << " bytes");
+    }
+}
+
+void QueryMemoryBudget::Reservation::detachFromOperationContext() {
+    if (_opCtx) {
+        getOperationUsage(_opCtx).bytes.fetchAndSubtract(_bytes);
+        _opCtx = nullptr;
+    }
+}
+
+void QueryMemoryBudget::Reservation::reattachToOperationContext(OperationContext* opCtx) {
+    detachFromOperationContext();
+    _opCtx = opCtx;
+    const size_t bytes = _bytes;
+    _bytes = 0;
+    _adjust(bytes);
+}
+
+void QueryMemoryBudget::recordSpill() {
+    numSpills.fetchAndAdd(1);
+}
+
+void QueryMemoryBudget::appendOperationUsage(const OperationContext* opCtx,
+                                             BSONObjBuilder* builder) {
+    const auto& usage = getOperationUsage(opCtx);
+    const long long peakBytes = usage.peakBytes.load();
+    if (peakBytes > 0) {
+        builder->append("queryMemoryBytes", usage.bytes.load());
+        builder->append("queryMemoryPeakBytes", peakBytes);
+    }
+}
+
+}  // namespace mongo
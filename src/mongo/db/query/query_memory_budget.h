@@ -0,0 +1,123 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class OperationContext;
+
+// The most bytes that the blocking stages of all queries together may reserve. 0 is unbounded.
+extern AtomicWord<long long> internalQueryMaxProcessMemoryBytes;
+
+// How long a stage that cannot spill waits for query memory to be released before failing.
+extern AtomicInt32 internalQueryMemoryWaitMS;
+
+/**
+ * A process-wide budget for the memory held by the blocking stages of queries, such as sorts,
+ * groups and graph lookups, which would otherwise each enforce only their own limit.
+ *
+ * Each stage holds a Reservation that it resizes as its data grows and shrinks. When growing a
+ * reservation would overrun the budget, a stage that can spill to disk does so early, and one that
+ * cannot waits for other operations to release memory before failing with ExceededMemoryLimit.
+ *
+ * The budget is set by the internalQueryMaxProcessMemoryBytes server parameter. A value of 0
+ * leaves the process unbounded, but reservations are still tracked so that they can be reported
+ * by serverStatus and $currentOp.
+ */
+class QueryMemoryBudget {
+public:
+    /**
+     * The memory reserved by one stage, which is attributed to the operation the stage is running
+     * in and released when the reservation is destroyed.
+     */
+    class Reservation {
+        MONGO_DISALLOW_COPYING(Reservation);
+
+    public:
+        explicit Reservation(OperationContext* opCtx);
+        ~Reservation();
+
+        /**
+         * Resizes the reservation to 'bytes', unless growing it would overrun the budget, in which
+         * case returns false and leaves it unchanged. Shrinking always succeeds.
+         */
+        bool tryResize(size_t bytes);
+
+        /**
+         * Resizes the reservation to 'bytes' whether or not the budget can hold it. For stages
+         * which have already given up all the memory they can.
+         */
+        void resize(size_t bytes);
+
+        /**
+         * Resizes the reservation to 'bytes', waiting up to internalQueryMemoryWaitMS for other
+         * operations to release memory if the budget cannot hold it yet. Throws a DBException with
+         * ExceededMemoryLimit, naming 'stageName', if the memory does not become available in time,
+         * or the operation's interruption error if it is interrupted while waiting.
+         */
+        void resizeOrWait(size_t bytes, StringData stageName);
+
+        /**
+         * Moves the attribution of the reservation between operations, for stages which outlive
+         * the operation that created them, such as those of cursors.
+         */
+        void detachFromOperationContext();
+        void reattachToOperationContext(OperationContext* opCtx);
+
+        size_t bytes() const {
+            return _bytes;
+        }
+
+    private:
+        void _adjust(long long delta);
+
+        OperationContext* _opCtx;
+        size_t _bytes = 0;
+    };
+
+    /**
+     * Counts a stage spilling to disk earlier than it would have because the budget was short.
+     */
+    static void recordSpill();
+
+    /**
+     * Appends the memory currently and at most reserved by the stages of 'opCtx', for $currentOp.
+     * Appends nothing if the operation has not reserved any.
+     */
+    static void appendOperationUsage(const OperationContext* opCtx, BSONObjBuilder* builder);
+};
+
+}  // namespace mongo
@@ -0,0 +1,152 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/query_memory_budget.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/query/query_test_service_context.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+class QueryMemoryBudgetTest : public unittest::Test {
+public:
+    void setUp() override {
+        _oldLimit = internalQueryMaxProcessMemoryBytes.load();
+        _oldWaitMS = internalQueryMemoryWaitMS.load();
+        internalQueryMaxProcessMemoryBytes.store(1000);
+        internalQueryMemoryWaitMS.store(10);
+    }
+
+    void tearDown() override {
+        internalQueryMaxProcessMemoryBytes.store(_oldLimit);
+        internalQueryMemoryWaitMS.store(_oldWaitMS);
+    }
+
+private:
+    long long _oldLimit;
+    int _oldWaitMS;
+};
+
+TEST_F(QueryMemoryBudgetTest, ReservationsShareTheBudget) {
+    QueryMemoryBudget::Reservation first(nullptr);
+    QueryMemoryBudget::Reservation second(nullptr);
+
+    ASSERT_TRUE(first.tryResize(600));
+    ASSERT_FALSE(second.tryResize(600));
+    ASSERT_EQ(0U, second.bytes());
+    ASSERT_TRUE(second.tryResize(400));
+
+    // Shrinking always succeeds, and makes room for others.
+    ASSERT_TRUE(first.tryResize(100));
+    ASSERT_TRUE(second.tryResize(900));
+    ASSERT_FALSE(first.tryResize(101));
+}
+
+TEST_F(QueryMemoryBudgetTest, DestroyingAReservationReleasesItsMemory) {
+    {
+        QueryMemoryBudget::Reservation reservation(nullptr);
+        ASSERT_TRUE(reservation.tryResize(1000));
+    }
+    QueryMemoryBudget::Reservation reservation(nullptr);
+    ASSERT_TRUE(reservation.tryResize(1000));
+}
+
+TEST_F(QueryMemoryBudgetTest, ResizeMayOvercommit) {
+    QueryMemoryBudget::Reservation first(nullptr);
+    QueryMemoryBudget::Reservation second(nullptr);
+    first.resize(1500);
+    ASSERT_EQ(1500U, first.bytes());
+    ASSERT_FALSE(second.tryResize(1));
+}
+
+TEST_F(QueryMemoryBudgetTest, NoLimitMeansUnbounded) {
+    internalQueryMaxProcessMemoryBytes.store(0);
+    QueryMemoryBudget::Reservation reservation(nullptr);
+    ASSERT_TRUE(reservation.tryResize(1ULL << 40));
+}
+
+TEST_F(QueryMemoryBudgetTest, ResizeOrWaitFailsWhenMemoryIsNotReleased) {
+    QueryMemoryBudget::Reservation first(nullptr);
+    QueryMemoryBudget::Reservation second(nullptr);
+    ASSERT_TRUE(first.tryResize(1000));
+    ASSERT_THROWS_CODE(
+        second.resizeOrWait(1, "test"), UserException, ErrorCodes::ExceededMemoryLimit);
+    ASSERT_EQ(0U, second.bytes());
+}
+
+TEST_F(QueryMemoryBudgetTest, ResizeOrWaitSucceedsOnceMemoryIsReleased) {
+    internalQueryMemoryWaitMS.store(60 * 1000);
+    QueryMemoryBudget::Reservation first(nullptr);
+    ASSERT_TRUE(first.tryResize(1000));
+
+    size_t reservedBytes = 0;
+    stdx::thread waiter([&reservedBytes] {
+        QueryMemoryBudget::Reservation second(nullptr);
+        second.resizeOrWait(500, "test");
+        reservedBytes = second.bytes();
+    });
+    first.resize(0);
+    waiter.join();
+    ASSERT_EQ(500U, reservedBytes);
+}
+
+TEST_F(QueryMemoryBudgetTest, UsageIsReportedPerOperation) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+
+    BSONObjBuilder before;
+    QueryMemoryBudget::appendOperationUsage(opCtx.get(), &before);
+    ASSERT_BSONOBJ_EQ(BSONObj(), before.obj());
+
+    QueryMemoryBudget::Reservation reservation(opCtx.get());
+    ASSERT_TRUE(reservation.tryResize(700));
+    ASSERT_TRUE(reservation.tryResize(200));
+
+    BSONObjBuilder during;
+    QueryMemoryBudget::appendOperationUsage(opCtx.get(), &during);
+    ASSERT_BSONOBJ_EQ(BSON("queryMemoryBytes" << 200LL << "queryMemoryPeakBytes" << 700LL),
+                      during.obj());
+
+    // A detached reservation no longer counts towards the operation, but still holds its memory.
+    reservation.detachFromOperationContext();
+    BSONObjBuilder detached;
+    QueryMemoryBudget::appendOperationUsage(opCtx.get(), &detached);
+    ASSERT_BSONOBJ_EQ(BSON("queryMemoryBytes" << 0LL << "queryMemoryPeakBytes" << 700LL),
+                      detached.obj());
+
+    QueryMemoryBudget::Reservation other(nullptr);
+    ASSERT_FALSE(other.tryResize(801));
+}
+
+}  // namespace
+}  // namespace mongo
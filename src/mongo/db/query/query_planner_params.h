@@ -95,6 +95,11 @@ struct QueryPlannerParams {
         // Set this if you don't want any plans with a non-covered projection stage. All projections
         // must be provided/covered by an index.
         NO_UNCOVERED_PROJECTIONS = 1 << 10,
+
+        // Set this to let collection scans evaluate their filter on several threads, up to
+        // internalQueryExecCollScanMaxParallelism. Only worthwhile for scans that read the whole
+        // collection, such as those beneath an aggregation.
+        PARALLEL_COLLSCAN = 1 << 11,
     };
 
     // See Options enum above.
@@ -414,6 +414,14 @@ bool QueryPlannerTestLib::solutionMatches(const BSONObj& testSoln,
             }
         }
 
+        BSONElement limitElt = textObj["limit"];
+        if (!limitElt.eoo()) {
+            if (!limitElt.isNumber() ||
+                limitElt.numberLong() != static_cast<long long>(node->limit)) {
+                return false;
+            }
+        }
+
         BSONObj collation;
         if (BSONElement collationElt = textObj["collation"]) {
             if (!collationElt.isABSONObj()) {
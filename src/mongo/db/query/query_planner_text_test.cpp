@@ -472,4 +472,54 @@ TEST_F(QueryPlannerTest, SortKeyMetaProjectionWithTextScoreMetaSort) {
         "{sortKeyGen: {node: {text: {search: 'foo'}}}}}}}}");
 }
 
+TEST_F(QueryPlannerTest, TextScoreSortWithLimitIsPushedToTextNode) {
+    addIndex(BSON("_fts"
+                  << "text"
+                  << "_ftsx"
+                  << 1));
+
+    runQueryAsCommand(fromjson(
+        "{find: 'testns', filter: {$text: {$search: 'foo bar'}}, sort: {a: {$meta: 'textScore'}},"
+        "projection: {a: {$meta: 'textScore'}}, skip: 2, limit: 3}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{skip: {n: 2, node: {proj: {spec: {a: {$meta: 'textScore'}}, node: "
+        "{sort: {limit: 5, pattern: {a: {$meta: 'textScore'}}, node: "
+        "{sortKeyGen: {node: {text: {search: 'foo bar', limit: 5}}}}}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, TextScoreSortWithoutLimitIsNotPushedToTextNode) {
+    addIndex(BSON("_fts"
+                  << "text"
+                  << "_ftsx"
+                  << 1));
+
+    runQuerySortProj(fromjson("{$text: {$search: 'foo'}}"),
+                     fromjson("{a: {$meta: 'textScore'}}"),
+                     fromjson("{a: {$meta: 'textScore'}}"));
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{proj: {spec: {a: {$meta: 'textScore'}}, node: "
+        "{sort: {limit: 0, pattern: {a: {$meta: 'textScore'}}, node: "
+        "{sortKeyGen: {node: {text: {search: 'foo', limit: 0}}}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, CompoundSortWithLimitIsNotPushedToTextNode) {
+    addIndex(BSON("_fts"
+                  << "text"
+                  << "_ftsx"
+                  << 1));
+
+    runQueryAsCommand(fromjson(
+        "{find: 'testns', filter: {$text: {$search: 'foo'}}, sort: {a: {$meta: 'textScore'}, b: 1},"
+        "projection: {a: {$meta: 'textScore'}}, limit: 3}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{proj: {spec: {a: {$meta: 'textScore'}}, node: "
+        "{sort: {limit: 3, pattern: {a: {$meta: 'textScore'}, b: 1}, node: "
+        "{sortKeyGen: {node: {text: {search: 'foo', limit: 0}}}}}}}}");
+}
+
 }  // namespace
@@ -378,6 +378,14 @@ public:
         _allowPartialResults = allowPartialResults;
     }
 
+    bool allowDiskUse() const {
+        return _allowDiskUse;
+    }
+
+    void setAllowDiskUse(bool allowDiskUse) {
+        _allowDiskUse = allowDiskUse;
+    }
+
     boost::optional<long long> getReplicationTerm() const {
         return _replicationTerm;
     }
@@ -506,6 +514,8 @@ private:
     bool _awaitData = false;
     bool _exhaust = false;
     bool _allowPartialResults = false;
+    // Allows blocking sorts to spill to disk rather than fail once they exceed the memory limit.
+    bool _allowDiskUse = false;
 
     boost::optional<long long> _replicationTerm;
 };
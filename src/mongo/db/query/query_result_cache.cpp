@@ -0,0 +1,326 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/query_result_cache.h"
+
+#include <functional>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/concurrency/locker.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/query_planner_common.h"
+#include "mongo/db/repl/read_concern_args.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+
+namespace {
+
+/**
+ * Drops every cached result whenever the size of the cache is changed. Besides releasing the
+ * memory of a disabled cache, this keeps writes which committed while it was disabled, and so did
+ * not bump any version, from letting in the results of queries which started before.
+ */
+class QueryResultCacheSizeBytesParameter
+    : public ExportedServerParameter<long long, ServerParameterType::kStartupAndRuntime> {
+public:
+    QueryResultCacheSizeBytesParameter()
+        : ExportedServerParameter<long long, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "internalQueryResultCacheSizeBytes",
+              &internalQueryResultCacheSizeBytes) {}
+
+    using ExportedServerParameter<long long, ServerParameterType::kStartupAndRuntime>::set;
+
+    Status set(const long long& newValue) override {
+        Status status =
+            ExportedServerParameter<long long, ServerParameterType::kStartupAndRuntime>::set(
+                newValue);
+        if (status.isOK() && hasGlobalServiceContext()) {
+            QueryResultCache::get(getGlobalServiceContext()).invalidateAll();
+        }
+        return status;
+    }
+
+protected:
+    Status validate(const long long& potentialNewValue) override {
+        if (potentialNewValue < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "internalQueryResultCacheSizeBytes must be greater than or equal to 0");
+        }
+        return Status::OK();
+    }
+} queryResultCacheSizeBytesParameter;
+
+const auto getQueryResultCache = ServiceContext::declareDecoration<QueryResultCache>();
+
+// Namespaces cannot contain NUL, so it separates the namespace from the query in cache keys.
+std::string makeFullKey(const NamespaceString& nss, const std::string& key) {
+    std::string fullKey = nss.ns();
+    fullKey.push_back('\0');
+    fullKey += key;
+    return fullKey;
+}
+
+// Accounts for the list node, the index node and the allocations of an entry besides its key and
+// documents.
+const long long kEntryOverheadBytes = 128;
+
+class QueryResultCacheMetric final : public ServerStatusMetric {
+public:
+    QueryResultCacheMetric() : ServerStatusMetric("query.resultCache") {}
+
+    void appendAtLeaf(BSONObjBuilder& b) const final {
+        BSONObjBuilder section(b.subobjStart(_leafName));
+        QueryResultCache::get(getGlobalServiceContext()).appendStats(&section);
+    }
+} queryResultCacheMetric;
+
+}  // namespace
+
+AtomicWord<long long> internalQueryResultCacheSizeBytes(0);
+
+QueryResultCache& QueryResultCache::get(ServiceContext* service) {
+    return getQueryResultCache(service);
+}
+
+QueryResultCache& QueryResultCache::get(OperationContext* opCtx) {
+    return get(opCtx->getServiceContext());
+}
+
+boost::optional<std::string> QueryResultCache::makeKey(
+    const CanonicalQuery& cq, const repl::ReadConcernArgs& readConcernArgs) {
+    // Majority and linearizable reads see a snapshot which moves without the collection being
+    // written to, and a read after an optime must wait for it whether or not the results are known.
+    if (readConcernArgs.getLevel() != repl::ReadConcernLevel::kLocalReadConcern ||
+        readConcernArgs.getArgsOpTime() || readConcernArgs.getArgsClusterTime()) {
+        return boost::none;
+    }
+
+    const QueryRequest& qr = cq.getQueryRequest();
+    if (qr.isExplain() || qr.isTailable() || qr.isOplogReplay() || qr.isExhaust()) {
+        return boost::none;
+    }
+
+    // The JavaScript of a $where may depend on more than the documents it is matching.
+    if (QueryPlannerCommon::hasNode(cq.root(), MatchExpression::WHERE)) {
+        return boost::none;
+    }
+
+    // Everything that shapes the results, as given by the client. Queries which only differ by the
+    // order of their predicates get separate entries, but different queries never share one.
+    BSONObjBuilder keyBuilder;
+    keyBuilder.append("filter", qr.getFilter());
+    keyBuilder.append("projection", qr.getProj());
+    keyBuilder.append("sort", qr.getSort());
+    keyBuilder.append("hint", qr.getHint());
+    keyBuilder.append("collation", qr.getCollation());
+    keyBuilder.append("min", qr.getMin());
+    keyBuilder.append("max", qr.getMax());
+    keyBuilder.append("skip", qr.getSkip().value_or(0));
+    keyBuilder.append("limit", qr.getLimit().value_or(0));
+    keyBuilder.append("batchSize", qr.getBatchSize().value_or(-1));
+    keyBuilder.append("ntoreturn", qr.getNToReturn().value_or(0));
+    keyBuilder.append("singleBatch", !qr.wantMore());
+    keyBuilder.append("returnKey", qr.returnKey());
+    keyBuilder.append("showRecordId", qr.showRecordId());
+    keyBuilder.append("maxScan", qr.getMaxScan());
+    keyBuilder.append("snapshot", qr.isSnapshot());
+    keyBuilder.append("readConcern", readConcernArgs.toBSON());
+    BSONObj keyObj = keyBuilder.done();
+    return std::string(keyObj.objdata(), keyObj.objsize());
+}
+
+AtomicUInt64& QueryResultCache::_versionSlot(const NamespaceString& nss) {
+    return _versions[std::hash<std::string>()(nss.ns()) % kNumVersionSlots];
+}
+
+const AtomicUInt64& QueryResultCache::_versionSlot(const NamespaceString& nss) const {
+    return _versions[std::hash<std::string>()(nss.ns()) % kNumVersionSlots];
+}
+
+QueryResultCache::Version QueryResultCache::getCollectionVersion(
+    const NamespaceString& nss) const {
+    return _versionSlot(nss).load();
+}
+
+bool QueryResultCache::lookup(const NamespaceString& nss,
+                              const std::string& key,
+                              Results* results) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _index.find(makeFullKey(nss, key));
+    if (it == _index.end()) {
+        _misses.fetchAndAdd(1);
+        return false;
+    }
+
+    _entries.splice(_entries.begin(), _entries, it->second);
+    results->documents = it->second->documents;
+    results->numDocuments = it->second->numDocuments;
+    _hits.fetchAndAdd(1);
+    return true;
+}
+
+bool QueryResultCache::insert(const NamespaceString& nss,
+                              const std::string& key,
+                              Version version,
+                              const Results& results) {
+    const long long limit = internalQueryResultCacheSizeBytes.load();
+    std::string fullKey = makeFullKey(nss, key);
+    const long long bytes = kEntryOverheadBytes + 2 * static_cast<long long>(fullKey.size()) +
+        results.documents.objsize();
+    if (bytes > maxEntryBytes()) {
+        return false;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    // Checking the version under the mutex orders this against invalidateCollection(), which
+    // bumps the version before dropping the entries of the collection under the mutex.
+    if (getCollectionVersion(nss) != version) {
+        return false;
+    }
+
+    auto it = _index.find(fullKey);
+    if (it != _index.end()) {
+        _erase_inlock(it);
+    }
+
+    _entries.push_front({fullKey, results.documents.getOwned(), results.numDocuments, bytes});
+    _index.emplace(std::move(fullKey), _entries.begin());
+    _bytes += bytes;
+    _numEntries.fetchAndAdd(1);
+    _inserts.fetchAndAdd(1);
+    _evict_inlock(limit);
+    return true;
+}
+
+void QueryResultCache::_erase_inlock(std::map<std::string, EntryList::iterator>::iterator it) {
+    _bytes -= it->second->bytes;
+    _entries.erase(it->second);
+    _index.erase(it);
+    _numEntries.fetchAndSubtract(1);
+}
+
+void QueryResultCache::_evict_inlock(long long limit) {
+    while (_bytes > limit && !_entries.empty()) {
+        _erase_inlock(_index.find(_entries.back().key));
+        _evictions.fetchAndAdd(1);
+    }
+}
+
+void QueryResultCache::onCollectionWrite(OperationContext* opCtx, const NamespaceString& nss) {
+    if (!enabled()) {
+        return;
+    }
+    auto& cache = get(opCtx);
+    if (!opCtx->lockState()->inAWriteUnitOfWork()) {
+        cache.invalidateCollection(nss);
+        return;
+    }
+    opCtx->recoveryUnit()->onCommit([&cache, nss] { cache.invalidateCollection(nss); });
+}
+
+void QueryResultCache::onDatabaseWrite(OperationContext* opCtx, StringData dbName) {
+    if (!enabled()) {
+        return;
+    }
+    auto& cache = get(opCtx);
+    if (!opCtx->lockState()->inAWriteUnitOfWork()) {
+        cache.invalidateDatabase(dbName);
+        return;
+    }
+    opCtx->recoveryUnit()->onCommit(
+        [&cache, dbName = dbName.toString()] { cache.invalidateDatabase(dbName); });
+}
+
+void QueryResultCache::invalidateCollection(const NamespaceString& nss) {
+    _versionSlot(nss).fetchAndAdd(1);
+    if (_numEntries.load() == 0) {
+        return;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _erasePrefix_inlock(makeFullKey(nss, ""));
+}
+
+void QueryResultCache::invalidateDatabase(StringData dbName) {
+    // The slots do not tell which collections belong to the database, so bump them all.
+    for (auto&& version : _versions) {
+        version.fetchAndAdd(1);
+    }
+    if (_numEntries.load() == 0) {
+        return;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _erasePrefix_inlock(dbName + ".");
+}
+
+void QueryResultCache::_erasePrefix_inlock(const std::string& prefix) {
+    auto it = _index.lower_bound(prefix);
+    while (it != _index.end() && StringData(it->first).startsWith(prefix)) {
+        _erase_inlock(it++);
+        _invalidations.fetchAndAdd(1);
+    }
+}
+
+void QueryResultCache::invalidateAll() {
+    for (auto&& version : _versions) {
+        version.fetchAndAdd(1);
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _invalidations.fetchAndAdd(_entries.size());
+    _entries.clear();
+    _index.clear();
+    _bytes = 0;
+    _numEntries.store(0);
+}
+
+void QueryResultCache::appendStats(BSONObjBuilder* builder) const {
+    long long bytes;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        bytes = _bytes;
+    }
+    builder->append("limitBytes", internalQueryResultCacheSizeBytes.load());
+    builder->append("bytes", bytes);
+    builder->append("entries", _numEntries.load());
+    builder->append("hits", _hits.load());
+    builder->append("misses", _misses.load());
+    builder->append("inserts", _inserts.load());
+    builder->append("invalidations", _invalidations.load());
+    builder->append("evictions", _evictions.load());
+}
+
+}  // namespace mongo
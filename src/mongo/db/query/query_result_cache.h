@@ -0,0 +1,213 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <list>
+#include <map>
+#include <string>
+
+#include <boost/optional.hpp>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class CanonicalQuery;
+class OperationContext;
+class ServiceContext;
+
+namespace repl {
+class ReadConcernArgs;
+}  // namespace repl
+
+// How many bytes of find command results may be cached. Zero disables the cache.
+extern AtomicWord<long long> internalQueryResultCacheSizeBytes;
+
+/**
+ * Caches the complete results of find commands, so that identical queries against collections
+ * which have not changed are answered without planning or executing them again.
+ *
+ * Entries are keyed by namespace, canonical query and read concern, and are only created for
+ * queries whose results fit in their first batch. Each collection has a version, which writes
+ * bump once they commit. A query captures the version of its collection before it reads
+ * anything, and its results are only cached if the version is still the same afterwards, so an
+ * entry never predates a committed write. Bumping a version also drops the entries of the
+ * collection. Versions are kept in a fixed number of slots shared by the namespaces which hash
+ * to them, so a write may needlessly fail the caching of a query on another collection, but
+ * never lets a stale result in.
+ *
+ * The cache holds at most 'internalQueryResultCacheSizeBytes', evicting the least recently used
+ * entries when it is full.
+ *
+ * Thread-safe.
+ */
+class QueryResultCache {
+    MONGO_DISALLOW_COPYING(QueryResultCache);
+
+public:
+    using Version = unsigned long long;
+
+    // The number of slots holding the versions of collections.
+    static const size_t kNumVersionSlots = 1024;
+
+    // A result set larger than this fraction of the cache is not cached, so that a single query
+    // cannot flush all the others.
+    static const long long kMaxEntryFraction = 16;
+
+    /**
+     * A cached result set.
+     */
+    struct Results {
+        // The documents of the first batch, as the elements of an array.
+        BSONObj documents;
+        long long numDocuments = 0;
+    };
+
+    QueryResultCache() = default;
+
+    static QueryResultCache& get(ServiceContext* service);
+    static QueryResultCache& get(OperationContext* opCtx);
+
+    static bool enabled() {
+        return internalQueryResultCacheSizeBytes.load() > 0;
+    }
+
+    /**
+     * Returns how many bytes of documents a query may return and still have them cached.
+     */
+    static long long maxEntryBytes() {
+        return internalQueryResultCacheSizeBytes.load() / kMaxEntryFraction;
+    }
+
+    /**
+     * Returns the key of the results of 'cq' under 'readConcernArgs', or boost::none if they cannot
+     * be cached, either because they may differ without the collection changing, as with $where or
+     * majority reads, or because the query does not return them all at once, as with tailable
+     * cursors.
+     */
+    static boost::optional<std::string> makeKey(const CanonicalQuery& cq,
+                                                const repl::ReadConcernArgs& readConcernArgs);
+
+    /**
+     * Returns the version of collection 'nss', to be passed to insert() by a query which is about
+     * to read it.
+     */
+    Version getCollectionVersion(const NamespaceString& nss) const;
+
+    /**
+     * Returns the results cached for 'key' of collection 'nss', if any, and counts a hit or a
+     * miss.
+     */
+    bool lookup(const NamespaceString& nss, const std::string& key, Results* results);
+
+    /**
+     * Caches 'results' for 'key' of collection 'nss', unless the collection was written to since
+     * it had 'version', or the results are too large. Returns whether they were cached.
+     */
+    bool insert(const NamespaceString& nss,
+                const std::string& key,
+                Version version,
+                const Results& results);
+
+    /**
+     * Registers that the documents of collection 'nss' are changing in the current unit of work
+     * of 'opCtx', so that its version is bumped and its entries dropped once the unit of work
+     * commits, or right away outside of a unit of work. A no-op if the cache is disabled.
+     */
+    static void onCollectionWrite(OperationContext* opCtx, const NamespaceString& nss);
+
+    /**
+     * Like onCollectionWrite(), for a change to every collection of database 'dbName'.
+     */
+    static void onDatabaseWrite(OperationContext* opCtx, StringData dbName);
+
+    /**
+     * Bumps the version of collection 'nss' and drops its entries.
+     */
+    void invalidateCollection(const NamespaceString& nss);
+
+    /**
+     * Bumps the version of every collection of database 'dbName' and drops their entries.
+     */
+    void invalidateDatabase(StringData dbName);
+
+    /**
+     * Bumps the version of every collection and drops every entry.
+     */
+    void invalidateAll();
+
+    /**
+     * Appends the counters of the cache, for serverStatus.
+     */
+    void appendStats(BSONObjBuilder* builder) const;
+
+private:
+    struct Entry {
+        std::string key;
+        BSONObj documents;
+        long long numDocuments;
+        long long bytes;
+    };
+
+    using EntryList = std::list<Entry>;
+
+    AtomicUInt64& _versionSlot(const NamespaceString& nss);
+    const AtomicUInt64& _versionSlot(const NamespaceString& nss) const;
+
+    void _erase_inlock(std::map<std::string, EntryList::iterator>::iterator it);
+    void _erasePrefix_inlock(const std::string& prefix);
+    void _evict_inlock(long long limit);
+
+    std::array<AtomicUInt64, kNumVersionSlots> _versions;
+
+    // Protects the members below.
+    mutable stdx::mutex _mutex;
+
+    // The entries, most recently used first, and indexed by key. Keys start with the namespace of
+    // the entry and a NUL, so the entries of a collection are contiguous in the index.
+    EntryList _entries;
+    std::map<std::string, EntryList::iterator> _index;
+    long long _bytes = 0;
+
+    AtomicInt64 _numEntries;
+    AtomicInt64 _hits;
+    AtomicInt64 _misses;
+    AtomicInt64 _inserts;
+    AtomicInt64 _invalidations;
+    AtomicInt64 _evictions;
+};
+
+}  // namespace mongo
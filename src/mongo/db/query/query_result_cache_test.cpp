@@ -0,0 +1,231 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/query_result_cache.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/extensions_callback_noop.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/query_test_service_context.h"
+#include "mongo/db/repl/read_concern_args.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kTestNss("test.coll");
+const NamespaceString kOtherNss("test.other");
+const NamespaceString kOtherDbNss("other.coll");
+
+QueryResultCache::Results makeResults(int numDocuments, int docBytes = 10) {
+    BSONArrayBuilder documents;
+    for (int i = 0; i < numDocuments; ++i) {
+        documents.append(BSON("_id" << i << "s" << std::string(docBytes, 'x')));
+    }
+    QueryResultCache::Results results;
+    results.documents = documents.arr();
+    results.numDocuments = numDocuments;
+    return results;
+}
+
+/**
+ * Enables the cache for the duration of a test.
+ */
+class QueryResultCacheTest : public unittest::Test {
+protected:
+    void setUp() override {
+        internalQueryResultCacheSizeBytes.store(1024 * 1024);
+    }
+
+    void tearDown() override {
+        internalQueryResultCacheSizeBytes.store(_savedSizeBytes);
+    }
+
+    bool insert(const NamespaceString& nss, const std::string& key, int numDocuments) {
+        return cache.insert(nss, key, cache.getCollectionVersion(nss), makeResults(numDocuments));
+    }
+
+    bool has(const NamespaceString& nss, const std::string& key) {
+        QueryResultCache::Results results;
+        return cache.lookup(nss, key, &results);
+    }
+
+    boost::optional<std::string> makeKey(const char* findCmd,
+                                         const char* readConcern = "{readConcern: {}}") {
+        auto opCtx = serviceContext.makeOperationContext();
+        const bool isExplain = false;
+        auto qr = unittest::assertGet(
+            QueryRequest::makeFromFindCommand(kTestNss, fromjson(findCmd), isExplain));
+        auto cq = unittest::assertGet(
+            CanonicalQuery::canonicalize(opCtx.get(), std::move(qr), ExtensionsCallbackNoop()));
+        repl::ReadConcernArgs readConcernArgs;
+        ASSERT_OK(readConcernArgs.initialize(fromjson(readConcern)));
+        return QueryResultCache::makeKey(*cq, readConcernArgs);
+    }
+
+    QueryResultCache cache;
+    QueryTestServiceContext serviceContext;
+
+private:
+    const long long _savedSizeBytes = internalQueryResultCacheSizeBytes.load();
+};
+
+TEST_F(QueryResultCacheTest, ReturnsCachedResults) {
+    ASSERT_FALSE(has(kTestNss, "a"));
+    ASSERT_TRUE(insert(kTestNss, "a", 3));
+
+    QueryResultCache::Results results;
+    ASSERT_TRUE(cache.lookup(kTestNss, "a", &results));
+    ASSERT_EQUALS(3, results.numDocuments);
+    ASSERT_BSONOBJ_EQ(makeResults(3).documents, results.documents);
+
+    // The same key of another collection is another entry.
+    ASSERT_FALSE(has(kOtherNss, "a"));
+}
+
+TEST_F(QueryResultCacheTest, RejectsResultsReadBeforeAWrite) {
+    const auto version = cache.getCollectionVersion(kTestNss);
+    cache.invalidateCollection(kTestNss);
+    ASSERT_FALSE(cache.insert(kTestNss, "a", version, makeResults(1)));
+    ASSERT_FALSE(has(kTestNss, "a"));
+}
+
+TEST_F(QueryResultCacheTest, InvalidatingACollectionOnlyDropsItsEntries) {
+    ASSERT_TRUE(insert(kTestNss, "a", 1));
+    ASSERT_TRUE(insert(kTestNss, "b", 1));
+    ASSERT_TRUE(insert(kOtherNss, "a", 1));
+
+    cache.invalidateCollection(kTestNss);
+    ASSERT_FALSE(has(kTestNss, "a"));
+    ASSERT_FALSE(has(kTestNss, "b"));
+    ASSERT_TRUE(has(kOtherNss, "a"));
+
+    BSONObjBuilder stats;
+    cache.appendStats(&stats);
+    ASSERT_EQUALS(2, stats.obj()["invalidations"].numberLong());
+}
+
+TEST_F(QueryResultCacheTest, InvalidatingADatabaseOnlyDropsItsEntries) {
+    ASSERT_TRUE(insert(kTestNss, "a", 1));
+    ASSERT_TRUE(insert(kOtherNss, "a", 1));
+    ASSERT_TRUE(insert(kOtherDbNss, "a", 1));
+
+    const auto otherDbVersion = cache.getCollectionVersion(kOtherDbNss);
+    cache.invalidateDatabase("test");
+    ASSERT_FALSE(has(kTestNss, "a"));
+    ASSERT_FALSE(has(kOtherNss, "a"));
+    ASSERT_TRUE(has(kOtherDbNss, "a"));
+
+    // Every version is bumped, since the cache cannot tell which collections belong to the
+    // database.
+    ASSERT_NOT_EQUALS(otherDbVersion, cache.getCollectionVersion(kOtherDbNss));
+}
+
+TEST_F(QueryResultCacheTest, InvalidatingAllDropsEveryEntry) {
+    ASSERT_TRUE(insert(kTestNss, "a", 1));
+    ASSERT_TRUE(insert(kOtherDbNss, "a", 1));
+
+    cache.invalidateAll();
+    ASSERT_FALSE(has(kTestNss, "a"));
+    ASSERT_FALSE(has(kOtherDbNss, "a"));
+}
+
+TEST_F(QueryResultCacheTest, EvictsLeastRecentlyUsedEntriesWhenFull) {
+    internalQueryResultCacheSizeBytes.store(16 * 1024);
+    for (int i = 0; i < 32; ++i) {
+        ASSERT_TRUE(insert(kTestNss, std::to_string(i), 20));
+        // Keep the first entry in use.
+        ASSERT_TRUE(has(kTestNss, "0"));
+    }
+
+    ASSERT_TRUE(has(kTestNss, "0"));
+    ASSERT_FALSE(has(kTestNss, "1"));
+    ASSERT_TRUE(has(kTestNss, "31"));
+
+    BSONObjBuilder statsBuilder;
+    cache.appendStats(&statsBuilder);
+    BSONObj stats = statsBuilder.obj();
+    ASSERT_LESS_THAN_OR_EQUALS(stats["bytes"].numberLong(), 16 * 1024);
+    ASSERT_GREATER_THAN(stats["evictions"].numberLong(), 0);
+}
+
+TEST_F(QueryResultCacheTest, DoesNotCacheResultsLargerThanAFractionOfTheCache) {
+    internalQueryResultCacheSizeBytes.store(16 * 1024);
+    ASSERT_FALSE(cache.insert(
+        kTestNss, "a", cache.getCollectionVersion(kTestNss), makeResults(1, 2 * 1024)));
+    ASSERT_FALSE(has(kTestNss, "a"));
+}
+
+TEST_F(QueryResultCacheTest, DoesNotCacheWhenDisabled) {
+    internalQueryResultCacheSizeBytes.store(0);
+    ASSERT_FALSE(insert(kTestNss, "a", 1));
+}
+
+TEST_F(QueryResultCacheTest, CountsHitsAndMisses) {
+    ASSERT_FALSE(has(kTestNss, "a"));
+    ASSERT_TRUE(insert(kTestNss, "a", 1));
+    ASSERT_TRUE(has(kTestNss, "a"));
+    ASSERT_TRUE(has(kTestNss, "a"));
+
+    BSONObjBuilder statsBuilder;
+    cache.appendStats(&statsBuilder);
+    BSONObj stats = statsBuilder.obj();
+    ASSERT_EQUALS(2, stats["hits"].numberLong());
+    ASSERT_EQUALS(1, stats["misses"].numberLong());
+    ASSERT_EQUALS(1, stats["inserts"].numberLong());
+    ASSERT_EQUALS(1, stats["entries"].numberLong());
+}
+
+TEST_F(QueryResultCacheTest, KeysDependOnTheWholeQuery) {
+    auto key = makeKey("{find: 'coll', filter: {a: 1}}");
+    ASSERT(key);
+    ASSERT_EQUALS(*key, *makeKey("{find: 'coll', filter: {a: 1}, maxTimeMS: 100}"));
+    ASSERT_NOT_EQUALS(*key, *makeKey("{find: 'coll', filter: {a: 2}}"));
+    ASSERT_NOT_EQUALS(*key, *makeKey("{find: 'coll', filter: {a: 1}, limit: 1}"));
+    ASSERT_NOT_EQUALS(*key, *makeKey("{find: 'coll', filter: {a: 1}, batchSize: 1}"));
+    ASSERT_NOT_EQUALS(*key, *makeKey("{find: 'coll', filter: {a: 1}, projection: {a: 1}}"));
+    ASSERT_NOT_EQUALS(*key, *makeKey("{find: 'coll', filter: {a: 1}, sort: {b: 1}}"));
+    ASSERT_NOT_EQUALS(*key,
+                      *makeKey("{find: 'coll', filter: {a: 1}, collation: {locale: 'fr'}}"));
+}
+
+TEST_F(QueryResultCacheTest, DoesNotMakeKeysForQueriesWhoseResultsCannotBeCached) {
+    ASSERT_FALSE(makeKey("{find: 'coll', filter: {$where: 'this.a == 1'}}"));
+    ASSERT_FALSE(makeKey("{find: 'coll', filter: {}, tailable: true}"));
+    ASSERT_FALSE(
+        makeKey("{find: 'coll', filter: {a: 1}}", "{readConcern: {level: 'majority'}}"));
+    ASSERT_FALSE(makeKey("{find: 'coll', filter: {a: 1}}",
+                         "{readConcern: {afterOpTime: {ts: Timestamp(1, 1), t: 1}}}"));
+    ASSERT(makeKey("{find: 'coll', filter: {a: 1}}", "{readConcern: {level: 'local'}}"));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -198,6 +198,8 @@ void TextNode::appendToString(mongoutils::str::stream* ss, int indent) const {
     *ss << "diacriticSensitive= " << ftsQuery->getDiacriticSensitive() << '\n';
     addIndent(ss, indent + 1);
     *ss << "indexPrefix = " << indexPrefix.toString() << '\n';
+    addIndent(ss, indent + 1);
+    *ss << "limit = " << limit << '\n';
     if (NULL != filter) {
         addIndent(ss, indent + 1);
         *ss << " filter = " << filter->toString();
@@ -212,6 +214,7 @@ QuerySolutionNode* TextNode::clone() const {
     copy->_sort = this->_sort;
     copy->ftsQuery = this->ftsQuery->clone();
     copy->indexPrefix = this->indexPrefix;
+    copy->limit = this->limit;
 
     return copy;
 }
@@ -235,6 +238,10 @@ void CollectionScanNode::appendToString(mongoutils::str::stream* ss, int indent)
         addIndent(ss, indent + 1);
         *ss << "filter = " << filter->toString();
     }
+    if (maxParallelism > 1) {
+        addIndent(ss, indent + 1);
+        *ss << "maxParallelism = " << maxParallelism << '\n';
+    }
     addCommon(ss, indent);
 }
 
@@ -247,6 +254,7 @@ QuerySolutionNode* CollectionScanNode::clone() const {
     copy->tailable = this->tailable;
     copy->direction = this->direction;
     copy->maxScan = this->maxScan;
+    copy->maxParallelism = this->maxParallelism;
 
     return copy;
 }
@@ -1095,10 +1103,19 @@ void CountScanNode::appendToString(mongoutils::str::stream* ss, int indent) cons
     *ss << "name = " << index.name << '\n';
     addIndent(ss, indent + 1);
     *ss << "keyPattern = " << index.keyPattern << '\n';
-    addIndent(ss, indent + 1);
-    *ss << "startKey = " << startKey << '\n';
-    addIndent(ss, indent + 1);
-    *ss << "endKey = " << endKey << '\n';
+    if (!bounds.fields.empty()) {
+        addIndent(ss, indent + 1);
+        *ss << "bounds = " << bounds.toString() << '\n';
+    } else {
+        addIndent(ss, indent + 1);
+        *ss << "startKey = " << startKey << '\n';
+        addIndent(ss, indent + 1);
+        *ss << "endKey = " << endKey << '\n';
+    }
+    if (NULL != filter) {
+        addIndent(ss, indent + 1);
+        *ss << "filter = " << filter->toString();
+    }
 }
 
 QuerySolutionNode* CountScanNode::clone() const {
@@ -1110,6 +1127,7 @@ QuerySolutionNode* CountScanNode::clone() const {
     copy->startKeyInclusive = this->startKeyInclusive;
     copy->endKey = this->endKey;
     copy->endKeyInclusive = this->endKeyInclusive;
+    copy->bounds = this->bounds;
 
     return copy;
 }
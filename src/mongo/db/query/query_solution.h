@@ -254,6 +254,10 @@ struct TextNode : public QuerySolutionNode {
     // text node while creating the text leaf node and convert them into a BSONObj index prefix
     // when we finish the text leaf node.
     BSONObj indexPrefix;
+
+    // If nonzero, the text node is consumed by a sort on the text score alone that keeps only
+    // 'limit' results, so it only needs to produce the 'limit' highest scoring documents.
+    size_t limit = 0;
 };
 
 struct CollectionScanNode : public QuerySolutionNode {
@@ -293,6 +297,9 @@ struct CollectionScanNode : public QuerySolutionNode {
 
     // maxScan option to .find() limits how many docs we look at.
     int maxScan;
+
+    // How many threads may evaluate the filter. See CollectionScanParams::maxParallelism.
+    size_t maxParallelism = 1;
 };
 
 struct AndHashNode : public QuerySolutionNode {
@@ -938,6 +945,9 @@ struct CountScanNode : public QuerySolutionNode {
 
     BSONObj endKey;
     bool endKeyInclusive;
+
+    // If it has any fields, these bounds are scanned instead of the range between the keys above.
+    IndexBounds bounds;
 };
 
 /**
@@ -0,0 +1,175 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/query_stats_store.h"
+
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/service_context.h"
+#include "mongo/stdx/memory.h"
+
+namespace mongo {
+
+namespace {
+
+const auto getQueryStatsStore = ServiceContext::declareDecoration<QueryStatsStore>();
+
+// Namespaces cannot contain NUL, so it separates the namespace from the shape in store keys.
+std::string makeKey(StringData ns, const std::string& shapeKey) {
+    std::string key = ns.toString();
+    key.push_back('\0');
+    key += shapeKey;
+    return key;
+}
+
+double perReturned(long long examined, long long nReturned) {
+    return static_cast<double>(examined) / std::max(nReturned, 1LL);
+}
+
+}  // namespace
+
+BSONObj QueryStatsStore::ShapeStats::toBSON() const {
+    BSONObjBuilder builder;
+    builder.append("ns", ns);
+    {
+        BSONObjBuilder shapeBuilder(builder.subobjStart("shape"));
+        shapeBuilder.append("query", query);
+        shapeBuilder.append("sort", sort);
+        shapeBuilder.append("projection", projection);
+    }
+    builder.append("shapeKey", shapeKey);
+    builder.append("count", count);
+    {
+        BSONObjBuilder latencyBuilder(builder.subobjStart("latencyStats"));
+        latency.append(true, &latencyBuilder);
+    }
+    builder.append("keysExamined", keysExamined);
+    builder.append("docsExamined", docsExamined);
+    builder.append("nReturned", nReturned);
+    builder.append("planExecutionNanos", planExecutionNanos);
+    builder.append("keysExaminedPerReturned", perReturned(keysExamined, nReturned));
+    builder.append("docsExaminedPerReturned", perReturned(docsExamined, nReturned));
+    builder.append("planSummary", planSummary);
+    builder.append("firstExecuted", firstExecuted);
+    builder.append("lastExecuted", lastExecuted);
+    return builder.obj();
+}
+
+QueryStatsStore::QueryStatsStore() {
+    for (size_t i = 0; i < kNumPartitions; ++i) {
+        _partitions.push_back(stdx::make_unique<Partition>());
+    }
+}
+
+QueryStatsStore& QueryStatsStore::get(ServiceContext* service) {
+    return getQueryStatsStore(service);
+}
+
+QueryStatsStore::Partition& QueryStatsStore::_partitionFor(const std::string& key) {
+    return *_partitions[std::hash<std::string>()(key) % _partitions.size()];
+}
+
+void QueryStatsStore::record(const NamespaceString& nss,
+                             const std::string& shapeKey,
+                             const BSONObj& query,
+                             const BSONObj& sort,
+                             const BSONObj& projection,
+                             const Execution& execution) {
+    // The size is read on every execution so that it can be changed at runtime. Each partition
+    // holds an equal share of it, but at least one shape.
+    const int storeSize = internalQueryStatsStoreSize.load();
+    if (storeSize <= 0) {
+        return;
+    }
+    const size_t partitionSize = std::max(static_cast<size_t>(storeSize) / kNumPartitions,
+                                          static_cast<size_t>(1));
+
+    const std::string key = makeKey(nss.ns(), shapeKey);
+    const Date_t now = Date_t::now();
+    Partition& partition = _partitionFor(key);
+    stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+
+    auto it = partition.index.find(key);
+    if (it != partition.index.end()) {
+        partition.shapes.splice(partition.shapes.begin(), partition.shapes, it->second);
+    } else {
+        while (partition.shapes.size() >= partitionSize) {
+            partition.index.erase(
+                makeKey(partition.shapes.back().ns, partition.shapes.back().shapeKey));
+            partition.shapes.pop_back();
+        }
+
+        ShapeStats shape;
+        shape.ns = nss.ns();
+        shape.shapeKey = shapeKey;
+        shape.query = query.getOwned();
+        shape.sort = sort.getOwned();
+        shape.projection = projection.getOwned();
+        shape.firstExecuted = now;
+        partition.shapes.push_front(std::move(shape));
+        partition.index[key] = partition.shapes.begin();
+    }
+
+    ShapeStats& stats = partition.shapes.front();
+    stats.planSummary = execution.planSummary;
+    stats.count++;
+    stats.keysExamined += execution.keysExamined;
+    stats.docsExamined += execution.docsExamined;
+    stats.nReturned += execution.nReturned;
+    stats.planExecutionNanos += execution.planExecutionNanos;
+    stats.latency.increment(execution.latencyMicros, Command::ReadWriteType::kRead);
+    stats.lastExecuted = now;
+}
+
+std::vector<QueryStatsStore::ShapeStats> QueryStatsStore::getStats(
+    const NamespaceString& nss) const {
+    std::vector<ShapeStats> stats;
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition->mutex);
+        for (const auto& shape : partition->shapes) {
+            if (shape.ns == nss.ns()) {
+                stats.push_back(shape);
+            }
+        }
+    }
+    return stats;
+}
+
+void QueryStatsStore::clear() {
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition->mutex);
+        partition->shapes.clear();
+        partition->index.clear();
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,150 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/stats/operation_latency_histogram.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class ServiceContext;
+
+/**
+ * Aggregates the execution statistics of queries by collection and query shape, as encoded by the
+ * plan cache key of the query. Reported by the $queryStats aggregation stage.
+ *
+ * The store holds at most 'internalQueryStatsStoreSize' shapes. It is split into independently
+ * locked partitions, each evicting its least recently executed shape when it is full.
+ *
+ * Thread-safe.
+ */
+class QueryStatsStore {
+    MONGO_DISALLOW_COPYING(QueryStatsStore);
+
+public:
+    // The store is split into this many partitions.
+    static const size_t kNumPartitions = 16;
+
+    /**
+     * Describes one execution of a query.
+     */
+    struct Execution {
+        long long latencyMicros = 0;
+        long long keysExamined = 0;
+        long long docsExamined = 0;
+        long long nReturned = 0;
+        long long planExecutionNanos = 0;
+        std::string planSummary;
+    };
+
+    /**
+     * The statistics of one query shape.
+     */
+    struct ShapeStats {
+        std::string ns;
+        std::string shapeKey;
+
+        // The query, sort and projection of the first execution of the shape.
+        BSONObj query;
+        BSONObj sort;
+        BSONObj projection;
+
+        // The plan summary of the latest execution of the shape.
+        std::string planSummary;
+
+        long long count = 0;
+        long long keysExamined = 0;
+        long long docsExamined = 0;
+        long long nReturned = 0;
+        long long planExecutionNanos = 0;
+        OperationLatencyHistogram latency;
+        Date_t firstExecuted;
+        Date_t lastExecuted;
+
+        /**
+         * Returns the statistics of the shape in the format reported by $queryStats.
+         */
+        BSONObj toBSON() const;
+    };
+
+    QueryStatsStore();
+
+    static QueryStatsStore& get(ServiceContext* service);
+
+    /**
+     * Adds 'execution' to the statistics of the query shape 'shapeKey' of collection 'nss'. The
+     * 'query', 'sort' and 'projection' describe the shape if it is new.
+     */
+    void record(const NamespaceString& nss,
+                const std::string& shapeKey,
+                const BSONObj& query,
+                const BSONObj& sort,
+                const BSONObj& projection,
+                const Execution& execution);
+
+    /**
+     * Returns the statistics of every query shape of collection 'nss', in no particular order.
+     */
+    std::vector<ShapeStats> getStats(const NamespaceString& nss) const;
+
+    /**
+     * Forgets the statistics of every query shape.
+     */
+    void clear();
+
+private:
+    /**
+     * A slice of the store with its own mutex and its own LRU ordering of shapes, most recently
+     * executed first.
+     */
+    struct Partition {
+        using ShapeList = std::list<ShapeStats>;
+
+        // Protects 'shapes' and 'index'.
+        mutable stdx::mutex mutex;
+        ShapeList shapes;
+        stdx::unordered_map<std::string, ShapeList::iterator> index;
+    };
+
+    Partition& _partitionFor(const std::string& key);
+
+    std::vector<std::unique_ptr<Partition>> _partitions;
+};
+
+}  // namespace mongo
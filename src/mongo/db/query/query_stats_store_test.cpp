@@ -0,0 +1,136 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/query_stats_store.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kTestNss("test.coll");
+
+QueryStatsStore::Execution makeExecution(long long latencyMicros,
+                                         long long docsExamined,
+                                         long long nReturned) {
+    QueryStatsStore::Execution execution;
+    execution.latencyMicros = latencyMicros;
+    execution.keysExamined = docsExamined;
+    execution.docsExamined = docsExamined;
+    execution.nReturned = nReturned;
+    execution.planSummary = "IXSCAN { a: 1 }";
+    return execution;
+}
+
+/**
+ * Restores the size of the store when a test completes.
+ */
+class QueryStatsStoreTest : public unittest::Test {
+protected:
+    void tearDown() override {
+        internalQueryStatsStoreSize.store(_savedStoreSize);
+    }
+
+    QueryStatsStore store;
+
+private:
+    const int _savedStoreSize = internalQueryStatsStoreSize.load();
+};
+
+TEST_F(QueryStatsStoreTest, AggregatesExecutionsOfTheSameShape) {
+    store.record(kTestNss, "eqa", BSON("a" << 1), BSONObj(), BSONObj(), makeExecution(10, 4, 2));
+    store.record(kTestNss, "eqa", BSON("a" << 2), BSONObj(), BSONObj(), makeExecution(30, 6, 0));
+
+    auto stats = store.getStats(kTestNss);
+    ASSERT_EQUALS(1U, stats.size());
+    ASSERT_EQUALS(2, stats[0].count);
+    ASSERT_EQUALS(10, stats[0].docsExamined);
+    ASSERT_EQUALS(2, stats[0].nReturned);
+    // The shape is described by its first execution.
+    ASSERT_BSONOBJ_EQ(BSON("a" << 1), stats[0].query);
+
+    BSONObj obj = stats[0].toBSON();
+    ASSERT_EQUALS("test.coll", obj["ns"].str());
+    ASSERT_EQUALS("IXSCAN { a: 1 }", obj["planSummary"].str());
+    ASSERT_EQUALS(5.0, obj["docsExaminedPerReturned"].numberDouble());
+    ASSERT_EQUALS(2, obj["latencyStats"]["reads"]["ops"].numberLong());
+    ASSERT_EQUALS(40, obj["latencyStats"]["reads"]["latency"].numberLong());
+}
+
+TEST_F(QueryStatsStoreTest, SeparatesShapesAndNamespaces) {
+    const NamespaceString otherNss("test.other");
+    store.record(kTestNss, "eqa", BSON("a" << 1), BSONObj(), BSONObj(), makeExecution(1, 1, 1));
+    store.record(kTestNss, "eqb", BSON("b" << 1), BSONObj(), BSONObj(), makeExecution(1, 1, 1));
+    store.record(otherNss, "eqa", BSON("a" << 1), BSONObj(), BSONObj(), makeExecution(1, 1, 1));
+
+    ASSERT_EQUALS(2U, store.getStats(kTestNss).size());
+    ASSERT_EQUALS(1U, store.getStats(otherNss).size());
+
+    store.clear();
+    ASSERT_TRUE(store.getStats(kTestNss).empty());
+    ASSERT_TRUE(store.getStats(otherNss).empty());
+}
+
+TEST_F(QueryStatsStoreTest, EvictsLeastRecentlyExecutedShapes) {
+    // Every partition holds a single shape.
+    internalQueryStatsStoreSize.store(QueryStatsStore::kNumPartitions);
+
+    const size_t numShapes = 10 * QueryStatsStore::kNumPartitions;
+    for (size_t i = 0; i < numShapes; ++i) {
+        store.record(kTestNss,
+                     std::to_string(i),
+                     BSON("a" << 1),
+                     BSONObj(),
+                     BSONObj(),
+                     makeExecution(1, 1, 1));
+    }
+
+    auto stats = store.getStats(kTestNss);
+    ASSERT_LTE(stats.size(), QueryStatsStore::kNumPartitions);
+    ASSERT_GT(stats.size(), 0U);
+
+    // The most recently executed shape is always retained.
+    bool foundLast = false;
+    for (const auto& shape : stats) {
+        foundLast = foundLast || shape.shapeKey == std::to_string(numShapes - 1);
+    }
+    ASSERT_TRUE(foundLast);
+}
+
+TEST_F(QueryStatsStoreTest, RecordsNothingWhenDisabled) {
+    internalQueryStatsStoreSize.store(0);
+    store.record(kTestNss, "eqa", BSON("a" << 1), BSONObj(), BSONObj(), makeExecution(1, 1, 1));
+    ASSERT_TRUE(store.getStats(kTestNss).empty());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -33,6 +33,7 @@
 #include "mongo/bson/bsonobj.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/operation_phases.h"
 #include "mongo/db/storage/record_fetcher.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/time_support.h"
@@ -55,6 +56,7 @@ void QueryYield::yieldAllLocks(OperationContext* opCtx,
     //   4) Touch the record we're yielding on, if there is one (RecordFetcher::fetch)
     //   5) Reacquire lock mgr locks
 
+    OperationPhases::Scope yieldPhase(opCtx, OperationPhases::Phase::kYield);
     Locker* locker = opCtx->lockState();
 
     Locker::LockSnapshot snapshot;
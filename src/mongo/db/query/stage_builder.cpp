@@ -79,6 +79,7 @@ PlanStage* buildStages(OperationContext* opCtx,
         params.direction =
             (csn->direction == 1) ? CollectionScanParams::FORWARD : CollectionScanParams::BACKWARD;
         params.maxScan = csn->maxScan;
+        params.maxParallelism = csn->maxParallelism;
         return new CollectionScan(opCtx, params, ws, csn->filter.get());
     } else if (STAGE_IXSCAN == root->getType()) {
         const IndexScanNode* ixn = static_cast<const IndexScanNode*>(root);
@@ -115,6 +116,7 @@ PlanStage* buildStages(OperationContext* opCtx,
         params.collection = collection;
         params.pattern = sn->pattern;
         params.limit = sn->limit;
+        params.allowDiskUse = cq.getQueryRequest().allowDiskUse();
         return new SortStage(opCtx, params, ws, childStage);
     } else if (STAGE_SORT_KEY_GENERATOR == root->getType()) {
         const SortKeyGeneratorNode* keyGenNode = static_cast<const SortKeyGeneratorNode*>(root);
@@ -256,6 +258,7 @@ PlanStage* buildStages(OperationContext* opCtx,
         TextStageParams params(fam->getSpec());
         params.index = desc;
         params.indexPrefix = node->indexPrefix;
+        params.limit = node->limit;
         // We assume here that node->ftsQuery is an FTSQueryImpl, not an FTSQueryNoop. In practice,
         // this means that it is illegal to use the StageBuilder on a QuerySolution created by
         // planning a query that contains "no-op" expressions. TODO: make StageBuilder::build()
@@ -312,8 +315,9 @@ PlanStage* buildStages(OperationContext* opCtx,
         params.startKeyInclusive = csn->startKeyInclusive;
         params.endKey = csn->endKey;
         params.endKeyInclusive = csn->endKeyInclusive;
+        params.bounds = csn->bounds;
 
-        return new CountScan(opCtx, params, ws);
+        return new CountScan(opCtx, params, ws, csn->filter.get());
     } else if (STAGE_ENSURE_SORTED == root->getType()) {
         const EnsureSortedNode* esn = static_cast<const EnsureSortedNode*>(root);
         PlanStage* childStage = buildStages(opCtx, collection, cq, qsol, esn->children[0], ws);
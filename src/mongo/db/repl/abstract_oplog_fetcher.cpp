@@ -284,9 +284,14 @@ void AbstractOplogFetcher::_callback(const Fetcher::QueryResponseStatus& result,
     getMoreBob->appendElements(batchResult.getValue());
 }
 
+Status AbstractOplogFetcher::_onFinish(Status status) {
+    return status;
+}
+
 void AbstractOplogFetcher::_finishCallback(Status status) {
     invariant(isActive());
 
+    status = _onFinish(std::move(status));
     _onShutdownCallbackFn(status);
 
     decltype(_onShutdownCallbackFn) onShutdownCallbackFn;
@@ -171,6 +171,13 @@ private:
      */
     virtual StatusWith<BSONObj> _onSuccessfulBatch(const Fetcher::QueryResponse& queryResponse) = 0;
 
+    /**
+     * Called with the final status of the abstract oplog fetcher, right before it is passed to the
+     * "_onShutdownCallbackFn". Subclasses that process batches asynchronously must complete or
+     * abandon that work here. The returned status replaces the one passed in.
+     */
+    virtual Status _onFinish(Status status);
+
     /**
      * This function creates a Fetcher with the given `find` command and metadata.
      */
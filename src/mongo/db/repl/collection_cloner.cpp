@@ -32,6 +32,7 @@
 
 #include "mongo/db/repl/collection_cloner.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "mongo/base/string_data.h"
@@ -70,6 +71,11 @@ MONGO_EXPORT_SERVER_PARAMETER(numInitialSyncCollectionCountAttempts, int, 3);
 MONGO_EXPORT_SERVER_PARAMETER(numInitialSyncListIndexesAttempts, int, 3);
 // The number of attempts for the find command, which gets the data.
 MONGO_EXPORT_SERVER_PARAMETER(numInitialSyncCollectionFindAttempts, int, 3);
+// The number of _id ranges a large collection may be split into and cloned concurrently. 1 disables
+// range splitting.
+MONGO_EXPORT_SERVER_PARAMETER(initialSyncMaxRangesPerCollection, int, 1);
+// The minimum number of documents in each _id range of a split collection.
+MONGO_EXPORT_SERVER_PARAMETER(initialSyncMinDocumentsPerRange, long long, 1000000);
 }  // namespace
 
 // Failpoint which causes initial sync to hang when it has cloned 'numDocsToClone' documents to
@@ -119,7 +125,6 @@ CollectionCloner::CollectionCloner(executor::TaskExecutor* executor,
                               executor::RemoteCommandRequest::kNoTimeout,
                               RemoteCommandRetryScheduler::kAllRetriableErrors)),
       _indexSpecs(),
-      _documents(),
       _dbWorkTaskRunner(_dbWorkThreadPool),
       _scheduleDbWorkFn([this](const executor::TaskExecutor::CallbackFn& work) {
           auto task = [work](OperationContext* opCtx,
@@ -216,8 +221,16 @@ void CollectionCloner::shutdown() {
 void CollectionCloner::_cancelRemainingWork_inlock() {
     _countScheduler.shutdown();
     _listIndexesFetcher.shutdown();
-    if (_findFetcher) {
-        _findFetcher->shutdown();
+    if (_collStatsScheduler) {
+        _collStatsScheduler->shutdown();
+    }
+    if (_splitVectorScheduler) {
+        _splitVectorScheduler->shutdown();
+    }
+    for (auto&& range : _ranges) {
+        if (range.findFetcher) {
+            range.findFetcher->shutdown();
+        }
     }
     _dbWorkTaskRunner.cancel();
 }
@@ -377,6 +390,155 @@ void CollectionCloner::_listIndexesCallback(const Fetcher::QueryResponseStatus&
     }
 
     // We have all of the indexes now, so we can start cloning the collection data.
+    _splitCollectionIntoRanges();
+}
+
+size_t CollectionCloner::_getNumRangesToClone_inlock() const {
+    const long long maxRanges = initialSyncMaxRangesPerCollection.load();
+    if (maxRanges < 2) {
+        return 1U;
+    }
+
+    // Documents of a capped collection must be inserted in their natural order, and ranges are
+    // defined over the _id index.
+    if (_options.capped || _idIndexSpec.isEmpty()) {
+        return 1U;
+    }
+
+    const long long minDocumentsPerRange = std::max(1LL, initialSyncMinDocumentsPerRange.load());
+    const long long numRanges =
+        static_cast<long long>(_stats.documentToCopy) / minDocumentsPerRange;
+    return static_cast<size_t>(std::max(1LL, std::min(maxRanges, numRanges)));
+}
+
+void CollectionCloner::_splitCollectionIntoRanges() {
+    UniqueLock lk(_mutex);
+    const auto numRanges = _getNumRangesToClone_inlock();
+    if (numRanges < 2U) {
+        lk.unlock();
+        _scheduleBeginCollection();
+        return;
+    }
+
+    _collStatsScheduler = stdx::make_unique<RemoteCommandRetryScheduler>(
+        _executor,
+        RemoteCommandRequest(_source,
+                             _sourceNss.db().toString(),
+                             BSON("collStats" << _sourceNss.coll()),
+                             ReadPreferenceSetting::secondaryPreferredMetadata(),
+                             nullptr,
+                             RemoteCommandRequest::kNoTimeout),
+        stdx::bind(&CollectionCloner::_collStatsCallback, this, stdx::placeholders::_1, numRanges),
+        RemoteCommandRetryScheduler::makeRetryPolicy(
+            numInitialSyncCollectionCountAttempts.load(),
+            executor::RemoteCommandRequest::kNoTimeout,
+            RemoteCommandRetryScheduler::kAllRetriableErrors));
+    auto scheduleStatus = _collStatsScheduler->startup();
+    lk.unlock();
+
+    if (!scheduleStatus.isOK()) {
+        _finishCallback(scheduleStatus);
+    }
+}
+
+void CollectionCloner::_collStatsCallback(
+    const executor::TaskExecutor::RemoteCommandCallbackArgs& args, size_t numRanges) {
+    if (ErrorCodes::CallbackCanceled == args.response.status) {
+        _finishCallback(args.response.status);
+        return;
+    }
+
+    // Range splitting is an optimization. Clone the collection as a single range if the sync
+    // source cannot tell us how to split it.
+    Status status = args.response.status;
+    if (status.isOK()) {
+        status = getStatusFromCommandResult(args.response.data);
+    }
+    long long size = 0;
+    if (status.isOK()) {
+        status = bsonExtractIntegerField(args.response.data, "size", &size);
+    }
+    if (!status.isOK() || size <= 0) {
+        warning() << "Cloning collection " << _sourceNss.ns() << " as a single range because "
+                  << "collStats on " << _source << " did not return its size: " << redact(status);
+        _scheduleBeginCollection();
+        return;
+    }
+
+    // splitVector places a split point every maxChunkSizeBytes / (2 * average document size)
+    // documents. This size yields 'numRanges' ranges with about the same number of documents.
+    const long long maxChunkSizeBytes =
+        std::max(1LL, 2 * size / static_cast<long long>(numRanges));
+
+    UniqueLock lk(_mutex);
+    _splitVectorScheduler = stdx::make_unique<RemoteCommandRetryScheduler>(
+        _executor,
+        RemoteCommandRequest(_source,
+                             _sourceNss.db().toString(),
+                             BSON("splitVector" << _sourceNss.ns() << "keyPattern"
+                                                << BSON("_id" << 1)
+                                                << "maxChunkSizeBytes"
+                                                << maxChunkSizeBytes
+                                                << "maxSplitPoints"
+                                                << static_cast<long long>(numRanges - 1)),
+                             ReadPreferenceSetting::secondaryPreferredMetadata(),
+                             nullptr,
+                             RemoteCommandRequest::kNoTimeout),
+        stdx::bind(&CollectionCloner::_splitVectorCallback, this, stdx::placeholders::_1),
+        RemoteCommandRetryScheduler::makeRetryPolicy(
+            numInitialSyncCollectionCountAttempts.load(),
+            executor::RemoteCommandRequest::kNoTimeout,
+            RemoteCommandRetryScheduler::kAllRetriableErrors));
+    auto scheduleStatus = _splitVectorScheduler->startup();
+    lk.unlock();
+
+    if (!scheduleStatus.isOK()) {
+        _finishCallback(scheduleStatus);
+    }
+}
+
+void CollectionCloner::_splitVectorCallback(
+    const executor::TaskExecutor::RemoteCommandCallbackArgs& args) {
+    if (ErrorCodes::CallbackCanceled == args.response.status) {
+        _finishCallback(args.response.status);
+        return;
+    }
+
+    Status status = args.response.status;
+    if (status.isOK()) {
+        status = getStatusFromCommandResult(args.response.data);
+    }
+
+    std::vector<BSONObj> splitKeys;
+    if (status.isOK()) {
+        BSONElement splitKeysElement;
+        status = bsonExtractTypedField(args.response.data, "splitKeys", Array, &splitKeysElement);
+        if (status.isOK()) {
+            for (auto&& splitKey : splitKeysElement.Obj()) {
+                if (!splitKey.isABSONObj() || !splitKey.Obj().hasField("_id")) {
+                    status = {ErrorCodes::FailedToParse,
+                              str::stream() << "invalid split key: " << splitKey};
+                    break;
+                }
+                splitKeys.push_back(splitKey.Obj().getOwned());
+            }
+        }
+    }
+
+    if (!status.isOK()) {
+        warning() << "Cloning collection " << _sourceNss.ns() << " as a single range because "
+                  << "splitVector on " << _source << " failed: " << redact(status);
+        splitKeys.clear();
+    }
+
+    {
+        LockGuard lk(_mutex);
+        _splitKeys = std::move(splitKeys);
+    }
+    _scheduleBeginCollection();
+}
+
+void CollectionCloner::_scheduleBeginCollection() {
     auto&& scheduleResult = _scheduleDbWorkFn(
         stdx::bind(&CollectionCloner::_beginCollectionCallback, this, stdx::placeholders::_1));
     if (!scheduleResult.isOK()) {
@@ -388,6 +550,7 @@ void CollectionCloner::_listIndexesCallback(const Fetcher::QueryResponseStatus&
 void CollectionCloner::_findCallback(const StatusWith<Fetcher::QueryResponse>& fetchResult,
                                      Fetcher::NextAction* nextAction,
                                      BSONObjBuilder* getMoreBob,
+                                     size_t rangeIndex,
                                      std::shared_ptr<OnCompletionGuard> onCompletionGuard) {
     if (!fetchResult.isOK()) {
         // Wait for active inserts to complete.
@@ -408,7 +571,8 @@ void CollectionCloner::_findCallback(const StatusWith<Fetcher::QueryResponse>& f
     bool lastBatch = *nextAction == Fetcher::NextAction::kNoAction;
     if (batchData.documents.size() > 0) {
         LockGuard lk(_mutex);
-        _documents.insert(_documents.end(), batchData.documents.begin(), batchData.documents.end());
+        auto&& documents = _ranges[rangeIndex].documents;
+        documents.insert(documents.end(), batchData.documents.begin(), batchData.documents.end());
     } else if (!batchData.first) {
         warning() << "No documents returned in batch; ns: " << _sourceNss
                   << ", cursorId:" << batchData.cursorId << ", isLastBatch:" << lastBatch;
@@ -418,6 +582,7 @@ void CollectionCloner::_findCallback(const StatusWith<Fetcher::QueryResponse>& f
         _scheduleDbWorkFn(stdx::bind(&CollectionCloner::_insertDocumentsCallback,
                                      this,
                                      stdx::placeholders::_1,
+                                     rangeIndex,
                                      lastBatch,
                                      onCompletionGuard));
     if (!scheduleResult.isOK()) {
@@ -476,35 +641,69 @@ void CollectionCloner::_beginCollectionCallback(const executor::TaskExecutor::Ca
 
     _collLoader = std::move(status.getValue());
 
-    _findFetcher = stdx::make_unique<Fetcher>(
-        _executor,
-        _source,
-        _sourceNss.db().toString(),
+    // Every range feeds the same collection loader. Inserts are serialized by the database worker,
+    // so only the find commands run concurrently.
+    const auto numRanges = _splitKeys.size() + 1;
+    _ranges.resize(numRanges);
+    _stats.ranges.resize(numRanges);
+    for (size_t i = 0; i < numRanges; ++i) {
+        BSONObjBuilder cmdBob;
         // noCursorTimeout true, large batchSize (for older server versions to get larger batch)
-        BSON("find" << _sourceNss.coll() << "noCursorTimeout" << true << "batchSize" << batchSize),
-        stdx::bind(&CollectionCloner::_findCallback,
-                   this,
-                   stdx::placeholders::_1,
-                   stdx::placeholders::_2,
-                   stdx::placeholders::_3,
-                   onCompletionGuard),
-        ReadPreferenceSetting::secondaryPreferredMetadata(),
-        RemoteCommandRequest::kNoTimeout,
-        RemoteCommandRetryScheduler::makeRetryPolicy(
-            numInitialSyncCollectionFindAttempts.load(),
-            executor::RemoteCommandRequest::kNoTimeout,
-            RemoteCommandRetryScheduler::kAllRetriableErrors));
+        cmdBob.append("find", _sourceNss.coll());
+        cmdBob.append("noCursorTimeout", true);
+        cmdBob.append("batchSize", batchSize);
+        if (numRanges > 1) {
+            // 'min' and 'max' bound the scan of the _id index rather than the _id values, so
+            // documents with _ids of any type fall into exactly one range.
+            auto&& rangeStats = _stats.ranges[i];
+            cmdBob.append("hint", BSON("_id" << 1));
+            if (i > 0) {
+                rangeStats.min = _splitKeys[i - 1];
+                cmdBob.append("min", rangeStats.min);
+            }
+            if (i < numRanges - 1) {
+                rangeStats.max = _splitKeys[i];
+                cmdBob.append("max", rangeStats.max);
+            }
+        }
 
-    Status scheduleStatus = _findFetcher->schedule();
-    if (!scheduleStatus.isOK()) {
-        _findFetcher.reset();
-        onCompletionGuard->setResultAndCancelRemainingWork_inlock(lock, scheduleStatus);
-        return;
+        _ranges[i].findFetcher = stdx::make_unique<Fetcher>(
+            _executor,
+            _source,
+            _sourceNss.db().toString(),
+            cmdBob.obj(),
+            stdx::bind(&CollectionCloner::_findCallback,
+                       this,
+                       stdx::placeholders::_1,
+                       stdx::placeholders::_2,
+                       stdx::placeholders::_3,
+                       i,
+                       onCompletionGuard),
+            ReadPreferenceSetting::secondaryPreferredMetadata(),
+            RemoteCommandRequest::kNoTimeout,
+            RemoteCommandRetryScheduler::makeRetryPolicy(
+                numInitialSyncCollectionFindAttempts.load(),
+                executor::RemoteCommandRequest::kNoTimeout,
+                RemoteCommandRetryScheduler::kAllRetriableErrors));
+    }
+
+    if (numRanges > 1) {
+        log() << "Cloning collection " << _sourceNss.ns() << " as " << numRanges
+              << " concurrent _id ranges";
+    }
+
+    for (auto&& range : _ranges) {
+        Status scheduleStatus = range.findFetcher->schedule();
+        if (!scheduleStatus.isOK()) {
+            onCompletionGuard->setResultAndCancelRemainingWork_inlock(lock, scheduleStatus);
+            return;
+        }
     }
 }
 
 void CollectionCloner::_insertDocumentsCallback(
     const executor::TaskExecutor::CallbackArgs& cbd,
+    size_t rangeIndex,
     bool lastBatch,
     std::shared_ptr<OnCompletionGuard> onCompletionGuard) {
     if (!cbd.status.isOK()) {
@@ -515,18 +714,35 @@ void CollectionCloner::_insertDocumentsCallback(
 
     std::vector<BSONObj> docs;
     UniqueLock lk(_mutex);
-    if (_documents.size() == 0) {
+    auto&& rangeStats = _stats.ranges[rangeIndex];
+
+    // Returns true once the last batch of every range has been inserted.
+    auto finishRange = [&]() {
+        rangeStats.done = true;
+        if (_ranges.size() > 1) {
+            LOG(1) << "    collection: " << _destNss << ", finished cloning range "
+                   << (rangeIndex + 1) << " of " << _ranges.size() << " with "
+                   << rangeStats.documentsCopied << " documents";
+        }
+        return std::all_of(_stats.ranges.cbegin(),
+                           _stats.ranges.cend(),
+                           [](const Stats::RangeStats& range) { return range.done; });
+    };
+
+    if (_ranges[rangeIndex].documents.size() == 0) {
         warning() << "_insertDocumentsCallback, but no documents to insert for ns:" << _destNss;
 
-        if (lastBatch) {
+        if (lastBatch && finishRange()) {
             onCompletionGuard->setResultAndCancelRemainingWork_inlock(lk, Status::OK());
         }
         return;
     }
 
-    _documents.swap(docs);
+    _ranges[rangeIndex].documents.swap(docs);
     _stats.documentsCopied += docs.size();
     ++_stats.fetchBatches;
+    rangeStats.documentsCopied += docs.size();
+    ++rangeStats.fetchBatches;
     _progressMeter.hit(int(docs.size()));
     invariant(_collLoader);
     const auto status = _collLoader->insertDocuments(docs.cbegin(), docs.cend());
@@ -550,11 +766,12 @@ void CollectionCloner::_insertDocumentsCallback(
         }
     }
 
-    if (!lastBatch) {
+    if (!lastBatch || !finishRange()) {
         return;
     }
 
-    // Done with last batch and time to set result in completion guard to Status::OK().
+    // Done with last batch of every range and time to set result in completion guard to
+    // Status::OK().
     onCompletionGuard->setResultAndCancelRemainingWork_inlock(lk, Status::OK());
 }
 
@@ -626,6 +843,13 @@ void CollectionCloner::Stats::append(BSONObjBuilder* builder) const {
     builder->appendNumber(kDocumentsCopiedFieldName, documentsCopied);
     builder->appendNumber("indexes", indexes);
     builder->appendNumber("fetchedBatches", fetchBatches);
+    if (ranges.size() > 1) {
+        BSONArrayBuilder rangesBuilder(builder->subarrayStart("ranges"));
+        for (auto&& range : ranges) {
+            BSONObjBuilder rangeBuilder(rangesBuilder.subobjStart());
+            range.append(&rangeBuilder);
+        }
+    }
     if (start != Date_t()) {
         builder->appendDate("start", start);
         if (end != Date_t()) {
@@ -636,5 +860,17 @@ void CollectionCloner::Stats::append(BSONObjBuilder* builder) const {
         }
     }
 }
+
+void CollectionCloner::Stats::RangeStats::append(BSONObjBuilder* builder) const {
+    if (!min.isEmpty()) {
+        builder->append("min", min);
+    }
+    if (!max.isEmpty()) {
+        builder->append("max", max);
+    }
+    builder->appendNumber("documentsCopied", documentsCopied);
+    builder->appendNumber("fetchedBatches", fetchBatches);
+    builder->append("done", done);
+}
 }  // namespace repl
 }  // namespace mongo
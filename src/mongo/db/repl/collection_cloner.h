@@ -74,6 +74,20 @@ public:
         static constexpr StringData kDocumentsToCopyFieldName = "documentsToCopy"_sd;
         static constexpr StringData kDocumentsCopiedFieldName = "documentsCopied"_sd;
 
+        /**
+         * Progress of one _id range of a collection that was split for concurrent cloning.
+         * An empty 'min' or 'max' means the range is unbounded on that side.
+         */
+        struct RangeStats {
+            BSONObj min;
+            BSONObj max;
+            size_t documentsCopied{0};
+            size_t fetchBatches{0};
+            bool done{false};
+
+            void append(BSONObjBuilder* builder) const;
+        };
+
         std::string ns;
         Date_t start;
         Date_t end;
@@ -81,6 +95,7 @@ public:
         size_t documentsCopied{0};
         size_t indexes{0};
         size_t fetchBatches{0};
+        std::vector<RangeStats> ranges;
 
         std::string toString() const;
         BSONObj toBSON() const;
@@ -171,11 +186,40 @@ private:
                               BSONObjBuilder* getMoreBob);
 
     /**
-     * Read collection documents from find result.
+     * Returns the number of _id ranges the collection should be split into for cloning.
+     */
+    size_t _getNumRangesToClone_inlock() const;
+
+    /**
+     * Splits a large collection into _id ranges by asking the sync source for the collection size
+     * (collStats) and then for split points (splitVector). Collections that are not worth
+     * splitting go straight to _scheduleBeginCollection().
+     */
+    void _splitCollectionIntoRanges();
+
+    /**
+     * Reads the collection size from the collStats result and schedules splitVector.
+     */
+    void _collStatsCallback(const executor::TaskExecutor::RemoteCommandCallbackArgs& args,
+                            size_t numRanges);
+
+    /**
+     * Reads the range boundaries from the splitVector result.
+     */
+    void _splitVectorCallback(const executor::TaskExecutor::RemoteCommandCallbackArgs& args);
+
+    /**
+     * Schedules _beginCollectionCallback with the database worker.
+     */
+    void _scheduleBeginCollection();
+
+    /**
+     * Read collection documents from find result for the range at 'rangeIndex'.
      */
     void _findCallback(const StatusWith<Fetcher::QueryResponse>& fetchResult,
                        Fetcher::NextAction* nextAction,
                        BSONObjBuilder* getMoreBob,
+                       size_t rangeIndex,
                        std::shared_ptr<OnCompletionGuard> onCompletionGuard);
 
     /**
@@ -197,6 +241,7 @@ private:
      * interface.
      */
     void _insertDocumentsCallback(const executor::TaskExecutor::CallbackArgs& callbackData,
+                                  size_t rangeIndex,
                                   bool lastBatch,
                                   std::shared_ptr<OnCompletionGuard> onCompletionGuard);
 
@@ -229,11 +274,19 @@ private:
     StorageInterface* _storageInterface;  // (R) Not owned by us.
     RemoteCommandRetryScheduler _countScheduler;  // (S)
     Fetcher _listIndexesFetcher;                  // (S)
-    std::unique_ptr<Fetcher> _findFetcher;        // (M)
-    std::vector<BSONObj> _indexSpecs;             // (M)
-    BSONObj _idIndexSpec;                         // (M)
-    std::vector<BSONObj> _documents;              // (M) Documents read from fetcher to insert.
-    TaskRunner _dbWorkTaskRunner;                 // (R)
+    std::unique_ptr<RemoteCommandRetryScheduler> _collStatsScheduler;    // (M)
+    std::unique_ptr<RemoteCommandRetryScheduler> _splitVectorScheduler;  // (M)
+    std::vector<BSONObj> _indexSpecs;                                    // (M)
+    BSONObj _idIndexSpec;                                                // (M)
+    std::vector<BSONObj> _splitKeys;  // (M) Boundaries between the _id ranges, in index order.
+
+    // State of the find for one _id range. Without range splitting there is a single range.
+    struct Range {
+        std::unique_ptr<Fetcher> findFetcher;
+        std::vector<BSONObj> documents;  // Documents read from fetcher to insert.
+    };
+    std::vector<Range> _ranges;    // (M)
+    TaskRunner _dbWorkTaskRunner;  // (R)
     ScheduleDbWorkFn
         _scheduleDbWorkFn;         // (RT) Function for scheduling database work using the executor.
     Stats _stats;                  // (M) stats for this instance.
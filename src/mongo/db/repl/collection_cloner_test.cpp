@@ -37,10 +37,12 @@
 #include "mongo/db/repl/collection_cloner.h"
 #include "mongo/db/repl/storage_interface.h"
 #include "mongo/db/repl/storage_interface_mock.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/task_executor_proxy.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace {
 
@@ -1061,6 +1063,110 @@ TEST_F(CollectionClonerTest, MiddleBatchContainsNoDocuments) {
     ASSERT_FALSE(collectionCloner->isActive());
 }
 
+TEST_F(CollectionClonerTest, LargeCollectionIsClonedAsConcurrentIdRanges) {
+    auto&& params = ServerParameterSet::getGlobal()->getMap();
+    auto maxRanges = params.find("initialSyncMaxRangesPerCollection");
+    auto minDocuments = params.find("initialSyncMinDocumentsPerRange");
+    ASSERT_TRUE(maxRanges != params.end());
+    ASSERT_TRUE(minDocuments != params.end());
+    ASSERT_OK(maxRanges->second->setFromString("2"));
+    ASSERT_OK(minDocuments->second->setFromString("1"));
+    ON_BLOCK_EXIT([&] {
+        ASSERT_OK(maxRanges->second->setFromString("1"));
+        ASSERT_OK(minDocuments->second->setFromString("1000000"));
+    });
+
+    ASSERT_OK(collectionCloner->startup());
+    {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(getNet());
+        processNetworkResponse(createCountResponse(2));
+        processNetworkResponse(createListIndexesResponse(0, BSON_ARRAY(idIndexSpec)));
+        processNetworkResponse(BSON("size" << 100 << "ok" << 1));
+
+        auto noi = getNet()->getNextReadyRequest();
+        auto splitVectorCmd = noi->getRequest().cmdObj;
+        ASSERT_EQUALS("splitVector", splitVectorCmd.firstElementFieldName());
+        ASSERT_EQUALS(1LL, splitVectorCmd["maxSplitPoints"].numberLong());
+        scheduleNetworkResponse(noi,
+                                BSON("splitKeys" << BSON_ARRAY(BSON("_id" << 2)) << "ok" << 1));
+        finishProcessingNetworkResponse();
+    }
+
+    collectionCloner->waitForDbWorker();
+    ASSERT_TRUE(collectionStats.initCalled);
+
+    {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(getNet());
+        auto noi = getNet()->getNextReadyRequest();
+        auto lowerRangeCmd = noi->getRequest().cmdObj;
+        ASSERT_EQUALS("find", lowerRangeCmd.firstElementFieldName());
+        ASSERT_FALSE(lowerRangeCmd.hasField("min"));
+        ASSERT_BSONOBJ_EQ(BSON("_id" << 2), lowerRangeCmd["max"].Obj());
+        scheduleNetworkResponse(noi, createCursorResponse(0, BSON_ARRAY(BSON("_id" << 1))));
+
+        noi = getNet()->getNextReadyRequest();
+        auto upperRangeCmd = noi->getRequest().cmdObj;
+        ASSERT_BSONOBJ_EQ(BSON("_id" << 2), upperRangeCmd["min"].Obj());
+        ASSERT_FALSE(upperRangeCmd.hasField("max"));
+        scheduleNetworkResponse(noi, createCursorResponse(0, BSON_ARRAY(BSON("_id" << 2))));
+        finishProcessingNetworkResponse();
+    }
+
+    collectionCloner->join();
+    ASSERT_OK(getStatus());
+    ASSERT_EQUALS(2, collectionStats.insertCount);
+    ASSERT_TRUE(collectionStats.commitCalled);
+
+    auto stats = collectionCloner->getStats();
+    ASSERT_EQUALS(2U, stats.documentsCopied);
+    ASSERT_EQUALS(2U, stats.ranges.size());
+    for (auto&& range : stats.ranges) {
+        ASSERT_EQUALS(1U, range.documentsCopied);
+        ASSERT_TRUE(range.done);
+    }
+}
+
+TEST_F(CollectionClonerTest, SplitVectorFailureClonesCollectionAsSingleRange) {
+    auto&& params = ServerParameterSet::getGlobal()->getMap();
+    auto maxRanges = params.find("initialSyncMaxRangesPerCollection");
+    auto minDocuments = params.find("initialSyncMinDocumentsPerRange");
+    ASSERT_OK(maxRanges->second->setFromString("2"));
+    ASSERT_OK(minDocuments->second->setFromString("1"));
+    ON_BLOCK_EXIT([&] {
+        ASSERT_OK(maxRanges->second->setFromString("1"));
+        ASSERT_OK(minDocuments->second->setFromString("1000000"));
+    });
+
+    ASSERT_OK(collectionCloner->startup());
+    {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(getNet());
+        processNetworkResponse(createCountResponse(2));
+        processNetworkResponse(createListIndexesResponse(0, BSON_ARRAY(idIndexSpec)));
+        processNetworkResponse(BSON("size" << 100 << "ok" << 1));
+        processNetworkResponse(BSON("ok" << 0 << "errmsg"
+                                         << "splitVector failed"
+                                         << "code"
+                                         << ErrorCodes::OperationFailed));
+    }
+
+    collectionCloner->waitForDbWorker();
+    {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(getNet());
+        auto noi = getNet()->getNextReadyRequest();
+        auto findCmd = noi->getRequest().cmdObj;
+        ASSERT_FALSE(findCmd.hasField("min"));
+        ASSERT_FALSE(findCmd.hasField("max"));
+        scheduleNetworkResponse(
+            noi, createCursorResponse(0, BSON_ARRAY(BSON("_id" << 1) << BSON("_id" << 2))));
+        finishProcessingNetworkResponse();
+    }
+
+    collectionCloner->join();
+    ASSERT_OK(getStatus());
+    ASSERT_EQUALS(2, collectionStats.insertCount);
+    ASSERT_EQUALS(1U, collectionCloner->getStats().ranges.size());
+}
+
 TEST_F(CollectionClonerTest, CollectionClonerTransitionsToCompleteIfShutdownBeforeStartup) {
     collectionCloner->shutdown();
     ASSERT_EQUALS(ErrorCodes::ShutdownInProgress, collectionCloner->startup());
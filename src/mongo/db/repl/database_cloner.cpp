@@ -63,6 +63,9 @@ const char* kUUIDFieldName = "uuid";
 // The number of attempts for the listCollections commands.
 MONGO_EXPORT_SERVER_PARAMETER(numInitialSyncListCollectionsAttempts, int, 3);
 
+// The number of collections of a single database that may be cloned at the same time.
+MONGO_EXPORT_SERVER_PARAMETER(initialSyncMaxConcurrentCollectionClones, int, 1);
+
 /**
  * Default listCollections predicate.
  */
@@ -371,20 +374,42 @@ void DatabaseCloner::_listCollectionsCallback(const StatusWith<Fetcher::QueryRes
         }
     }
 
-    // Start first collection cloner.
-    _currentCollectionClonerIter = _collectionCloners.begin();
-
-    LOG(1) << "    cloning collection " << _currentCollectionClonerIter->getSourceNamespace();
+    // Start as many collection cloners as we are allowed to run at once.
+    _maxActiveCollectionCloners =
+        static_cast<size_t>(std::max(1, initialSyncMaxConcurrentCollectionClones.load()));
+    _nextCollectionClonerIter = _collectionCloners.begin();
 
-    Status startStatus = _startCollectionCloner(*_currentCollectionClonerIter);
-    if (!startStatus.isOK()) {
-        LOG(1) << "    failed to start collection cloning on "
-               << _currentCollectionClonerIter->getSourceNamespace() << ": " << redact(startStatus);
-        _finishCallback_inlock(lk, startStatus);
+    _startCollectionCloners_inlock();
+    if (!_startCollectionClonersStatus.isOK() && _activeCollectionCloners == 0) {
+        _finishCallback_inlock(lk, _startCollectionClonersStatus);
         return;
     }
 }
 
+void DatabaseCloner::_startCollectionCloners_inlock() {
+    while (_startCollectionClonersStatus.isOK() &&
+           _activeCollectionCloners < _maxActiveCollectionCloners &&
+           _nextCollectionClonerIter != _collectionCloners.end()) {
+        auto&& collectionCloner = *_nextCollectionClonerIter++;
+
+        LOG(1) << "    cloning collection " << collectionCloner.getSourceNamespace();
+
+        Status startStatus = _startCollectionCloner(collectionCloner);
+        if (!startStatus.isOK()) {
+            LOG(1) << "    failed to start collection cloning on "
+                   << collectionCloner.getSourceNamespace() << ": " << redact(startStatus);
+            _startCollectionClonersStatus = startStatus;
+
+            // Stop the cloners that are still running so that we report the error promptly.
+            for (auto&& cloner : _collectionCloners) {
+                cloner.shutdown();
+            }
+            return;
+        }
+        ++_activeCollectionCloners;
+    }
+}
+
 void DatabaseCloner::_collectionClonerCallback(const Status& status, const NamespaceString& nss) {
     auto newStatus = status;
 
@@ -405,17 +430,18 @@ void DatabaseCloner::_collectionClonerCallback(const Status& status, const Names
     lk.unlock();
     _collectionWork(newStatus, nss);
     lk.lock();
-    _currentCollectionClonerIter++;
+    invariant(_activeCollectionCloners > 0);
+    --_activeCollectionCloners;
 
-    if (_currentCollectionClonerIter != _collectionCloners.end()) {
-        Status startStatus = _startCollectionCloner(*_currentCollectionClonerIter);
-        if (!startStatus.isOK()) {
-            LOG(1) << "    failed to start collection cloning on "
-                   << _currentCollectionClonerIter->getSourceNamespace() << ": "
-                   << redact(startStatus);
-            _finishCallback_inlock(lk, startStatus);
-            return;
-        }
+    _startCollectionCloners_inlock();
+
+    // Wait for the remaining collection cloners to report back before finishing.
+    if (_activeCollectionCloners > 0) {
+        return;
+    }
+
+    if (!_startCollectionClonersStatus.isOK()) {
+        _finishCallback_inlock(lk, _startCollectionClonersStatus);
         return;
     }
 
@@ -184,6 +184,14 @@ private:
                                   Fetcher::NextAction* nextAction,
                                   BSONObjBuilder* getMoreBob);
 
+    /**
+     * Starts collection cloners until '_maxActiveCollectionCloners' are running or there are no
+     * collections left to clone.
+     * On failure, saves the error in '_startCollectionClonersStatus' and shuts down the cloners
+     * that are still running.
+     */
+    void _startCollectionCloners_inlock();
+
     /**
      * Forwards collection cloner result to client.
      * Starts a new cloner on a different collection.
@@ -233,7 +241,10 @@ private:
     std::vector<BSONObj> _collectionInfos;                               // (M)
     std::vector<NamespaceString> _collectionNamespaces;                  // (M)
     std::list<CollectionCloner> _collectionCloners;                      // (M)
-    std::list<CollectionCloner>::iterator _currentCollectionClonerIter;  // (M)
+    std::list<CollectionCloner>::iterator _nextCollectionClonerIter;     // (M)
+    size_t _maxActiveCollectionCloners = 1;                              // (M)
+    size_t _activeCollectionCloners = 0;                                 // (M)
+    Status _startCollectionClonersStatus = Status::OK();                 // (M)
     std::vector<std::pair<Status, NamespaceString>> _failedNamespaces;   // (M)
     CollectionCloner::ScheduleDbWorkFn
         _scheduleDbWorkFn;  // (RT) Function for scheduling database work using the executor.
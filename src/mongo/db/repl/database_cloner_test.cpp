@@ -38,9 +38,11 @@
 #include "mongo/db/repl/base_cloner_test_fixture.h"
 #include "mongo/db/repl/database_cloner.h"
 #include "mongo/db/repl/storage_interface.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/unittest/task_executor_proxy.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/uuid.h"
 
 namespace {
@@ -738,6 +740,49 @@ TEST_F(DatabaseClonerTest, StartSecondCollectionClonerFailed) {
     ASSERT_EQUALS(DatabaseCloner::State::kComplete, _databaseCloner->getState_forTest());
 }
 
+TEST_F(DatabaseClonerTest, StartsCollectionClonersConcurrentlyUpToConfiguredLimit) {
+    auto param = ServerParameterSet::getGlobal()->getMap().find(
+        "initialSyncMaxConcurrentCollectionClones");
+    ASSERT_TRUE(param != ServerParameterSet::getGlobal()->getMap().end());
+    ASSERT_OK(param->second->setFromString("2"));
+    ON_BLOCK_EXIT([param] { ASSERT_OK(param->second->setFromString("1")); });
+
+    std::vector<std::string> started;
+    _databaseCloner->setStartCollectionClonerFn([&started](CollectionCloner& cloner) -> Status {
+        started.push_back(cloner.getSourceNamespace().coll().toString());
+        return cloner.startup();
+    });
+
+    ASSERT_OK(_databaseCloner->startup());
+    {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(getNet());
+        processNetworkResponse(createListCollectionsResponse(
+            0,
+            BSON_ARRAY(BSON("name"
+                            << "a"
+                            << "options"
+                            << BSONObj())
+                       << BSON("name"
+                               << "b"
+                               << "options"
+                               << BSONObj())
+                       << BSON("name"
+                               << "c"
+                               << "options"
+                               << BSONObj()))));
+    }
+
+    // The third collection waits for one of the first two to finish.
+    ASSERT_EQUALS(2U, started.size());
+    ASSERT_EQUALS("a", started[0]);
+    ASSERT_EQUALS("b", started[1]);
+
+    _databaseCloner->shutdown();
+    _databaseCloner->join();
+    ASSERT_EQUALS(ErrorCodes::ShutdownInProgress, getStatus());
+    ASSERT_EQUALS(DatabaseCloner::State::kComplete, _databaseCloner->getState_forTest());
+}
+
 TEST_F(DatabaseClonerTest, ShutdownCancelsCollectionCloning) {
     ASSERT_EQUALS(DatabaseCloner::State::kPreStart, _databaseCloner->getState_forTest());
 
@@ -0,0 +1,90 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/election_phase_stats.h"
+
+#include <algorithm>
+
+#include "mongo/db/commands/server_status_metric.h"
+
+namespace mongo {
+namespace repl {
+
+const std::array<long long, ElectionPhaseStats::kNumBuckets>
+    ElectionPhaseStats::kLowerBoundsMillis = {0, 50, 100, 250, 500, 1000, 2000, 5000, 10000, 30000};
+
+ElectionPhaseStats electionDryRunStats;
+ElectionPhaseStats electionVoteStats;
+ElectionPhaseStats electionCatchUpStats;
+ElectionPhaseStats electionTotalStats;
+
+namespace {
+
+ServerStatusMetricField<ElectionPhaseStats> displayElectionDryRun("repl.election.dryRun",
+                                                                  &electionDryRunStats);
+ServerStatusMetricField<ElectionPhaseStats> displayElectionVote("repl.election.vote",
+                                                                &electionVoteStats);
+ServerStatusMetricField<ElectionPhaseStats> displayElectionCatchUp("repl.election.catchUp",
+                                                                   &electionCatchUpStats);
+ServerStatusMetricField<ElectionPhaseStats> displayElectionTotal("repl.election.total",
+                                                                 &electionTotalStats);
+
+}  // namespace
+
+void ElectionPhaseStats::record(Milliseconds duration) {
+    const long long millis = std::max(durationCount<Milliseconds>(duration), 0LL);
+    const auto bucket =
+        std::upper_bound(kLowerBoundsMillis.begin(), kLowerBoundsMillis.end(), millis) - 1;
+    _buckets[bucket - kLowerBoundsMillis.begin()].fetchAndAdd(1);
+    _num.fetchAndAdd(1);
+    _totalMillis.fetchAndAdd(millis);
+}
+
+BSONObj ElectionPhaseStats::getReport() const {
+    BSONObjBuilder builder;
+    builder.appendNumber("num", _num.loadRelaxed());
+    builder.appendNumber("totalMillis", _totalMillis.loadRelaxed());
+
+    BSONArrayBuilder histogramBuilder(builder.subarrayStart("histogram"));
+    for (int i = 0; i < kNumBuckets; i++) {
+        const long long count = _buckets[i].loadRelaxed();
+        if (count == 0)
+            continue;
+        BSONObjBuilder entryBuilder(histogramBuilder.subobjStart());
+        entryBuilder.appendNumber("millis", kLowerBoundsMillis[i]);
+        entryBuilder.appendNumber("count", count);
+        entryBuilder.doneFast();
+    }
+    histogramBuilder.doneFast();
+    return builder.obj();
+}
+
+}  // namespace repl
+}  // namespace mongo
@@ -0,0 +1,79 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace repl {
+
+/**
+ * A histogram of how long one phase of this node's elections took, reported in serverStatus under
+ * metrics.repl.election.
+ *
+ * This class is thread-safe.
+ */
+class ElectionPhaseStats {
+public:
+    static const int kNumBuckets = 10;
+
+    // Inclusive lower bounds of the histogram buckets, in milliseconds.
+    static const std::array<long long, kNumBuckets> kLowerBoundsMillis;
+
+    void record(Milliseconds duration);
+
+    BSONObj getReport() const;
+    operator BSONObj() const {
+        return getReport();
+    }
+
+private:
+    std::array<AtomicInt64, kNumBuckets> _buckets;
+    AtomicInt64 _num;
+    AtomicInt64 _totalMillis;
+};
+
+// Requesting votes in the dry run.
+extern ElectionPhaseStats electionDryRunStats;
+
+// From winning the dry run to winning the election, including storing our vote for ourself.
+extern ElectionPhaseStats electionVoteStats;
+
+// Catching up to the other nodes as a newly elected primary.
+extern ElectionPhaseStats electionCatchUpStats;
+
+// From starting the dry run to leaving catch-up, in elections this node won.
+extern ElectionPhaseStats electionTotalStats;
+
+}  // namespace repl
+}  // namespace mongo
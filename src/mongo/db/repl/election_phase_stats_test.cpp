@@ -0,0 +1,72 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/election_phase_stats.h"
+
+#include "mongo/unittest/unittest.h"
+
+namespace {
+
+using namespace mongo;
+using namespace mongo::repl;
+
+TEST(ElectionPhaseStatsTest, EmptyReport) {
+    ElectionPhaseStats stats;
+    ASSERT_BSONOBJ_EQ(BSON("num" << 0 << "totalMillis" << 0 << "histogram" << BSONArray()),
+                      stats.getReport());
+}
+
+TEST(ElectionPhaseStatsTest, RecordsIntoBucketsByLowerBound) {
+    ElectionPhaseStats stats;
+    stats.record(Milliseconds(0));
+    stats.record(Milliseconds(49));
+    stats.record(Milliseconds(50));
+    stats.record(Milliseconds(1999));
+    stats.record(Milliseconds(2000));
+    stats.record(Milliseconds(60000));
+
+    ASSERT_BSONOBJ_EQ(BSON("num" << 6 << "totalMillis" << 64098 << "histogram"
+                                 << BSON_ARRAY(BSON("millis" << 0 << "count" << 2)
+                                               << BSON("millis" << 50 << "count" << 1)
+                                               << BSON("millis" << 1000 << "count" << 1)
+                                               << BSON("millis" << 2000 << "count" << 1)
+                                               << BSON("millis" << 30000 << "count" << 1))),
+                      stats.getReport());
+}
+
+TEST(ElectionPhaseStatsTest, NegativeDurationsCountAsZero) {
+    ElectionPhaseStats stats;
+    stats.record(Milliseconds(-5));
+    ASSERT_BSONOBJ_EQ(BSON("num" << 1 << "totalMillis" << 0 << "histogram"
+                                 << BSON_ARRAY(BSON("millis" << 0 << "count" << 1))),
+                      stats.getReport());
+}
+
+}  // namespace
@@ -0,0 +1,224 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kReplication
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/flow_control.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/client.h"
+#include "mongo/db/commands/server_status.h"
+#include "mongo/db/concurrency/locker.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+namespace repl {
+
+namespace {
+
+MONGO_EXPORT_SERVER_PARAMETER(enableFlowControl, bool, false);
+
+// The majority commit lag above which writes are throttled.
+MONGO_EXPORT_SERVER_PARAMETER(flowControlTargetLagSeconds, int, 10);
+
+const auto getFlowControl = ServiceContext::declareDecoration<std::unique_ptr<FlowControl>>();
+
+const Seconds kRefreshPeriod(1);
+
+int clampToInt(double value) {
+    return static_cast<int>(std::min(value, static_cast<double>(std::numeric_limits<int>::max())));
+}
+
+}  // namespace
+
+const int FlowControl::kMinTicketsPerSecond;
+
+FlowControl::FlowControl(ReplicationCoordinator* replCoord) : _replCoord(replCoord) {}
+
+FlowControl::~FlowControl() {
+    shutdown();
+}
+
+FlowControl* FlowControl::get(ServiceContext* service) {
+    return getFlowControl(service).get();
+}
+
+void FlowControl::set(ServiceContext* service, std::unique_ptr<FlowControl> flowControl) {
+    getFlowControl(service) = std::move(flowControl);
+}
+
+void FlowControl::startup() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    invariant(!_thread.joinable());
+    Locker::setFlowControlTicketholder(&_ticketholder);
+    _thread = stdx::thread([this] { _run(); });
+}
+
+void FlowControl::shutdown() {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    if (!_thread.joinable()) {
+        return;
+    }
+    _inShutdown = true;
+    _shutdownCV.notify_all();
+    lk.unlock();
+    _thread.join();
+
+    // The ticketholder stays registered, as lockers may be about to use it, but no longer
+    // throttles them.
+    _ticketholder.disable();
+}
+
+int FlowControl::computeTicketsPerSecond(int lagSecs,
+                                         int targetLagSecs,
+                                         long long admittedLastSecond,
+                                         int lastTicketsPerSecond) {
+    if (lagSecs >= targetLagSecs) {
+        // Cut the rate from what the writers actually used, which may be less than they were
+        // allowed, and cut it harder once the lag is well past the target.
+        double rate = admittedLastSecond;
+        if (lastTicketsPerSecond >= 0) {
+            rate = std::min(rate, static_cast<double>(lastTicketsPerSecond));
+        }
+        rate *= lagSecs >= 2 * targetLagSecs ? 0.5 : 0.8;
+        return std::max(kMinTicketsPerSecond, clampToInt(rate));
+    }
+
+    if (lastTicketsPerSecond < 0 || 2 * lagSecs < targetLagSecs) {
+        return -1;
+    }
+
+    // The lag is under the target but not by much yet, so let the rate recover gradually.
+    const double increase = std::max(kMinTicketsPerSecond, lastTicketsPerSecond / 10);
+    return clampToInt(static_cast<double>(lastTicketsPerSecond) + increase);
+}
+
+void FlowControl::appendStats(BSONObjBuilder* builder) const {
+    const bool isLagged = _ticketholder.isEnabled();
+    builder->append("enabled", enableFlowControl.load());
+    builder->append("targetLagSeconds", flowControlTargetLagSeconds.load());
+    builder->append("lagSeconds", _lagSecs.load());
+    builder->append("isLagged", isLagged);
+    if (isLagged) {
+        builder->append("ticketsPerSecond", _ticketholder.getTicketsPerRefresh());
+    }
+
+    const FlowControlTicketholder::Stats stats = _ticketholder.getStats();
+    builder->append("acquireCount", stats.acquireCount);
+    builder->append("acquireWaitCount", stats.acquireWaitCount);
+    builder->append("timeAcquiringMicros", stats.timeAcquiringMicros);
+}
+
+void FlowControl::_run() {
+    Client::initThread("FlowControlRefresher");
+    while (true) {
+        {
+            stdx::unique_lock<stdx::mutex> lk(_mutex);
+            MONGO_IDLE_THREAD_BLOCK;
+            _shutdownCV.wait_for(
+                lk, kRefreshPeriod.toSystemDuration(), [this] { return _inShutdown; });
+            if (_inShutdown) {
+                return;
+            }
+        }
+        _refresh();
+    }
+}
+
+void FlowControl::_refresh() {
+    const long long acquireCount = _ticketholder.getStats().acquireCount;
+    const long long admitted = acquireCount - _lastAcquireCount;
+    _lastAcquireCount = acquireCount;
+
+    const int targetLagSecs = flowControlTargetLagSeconds.load();
+    if (!enableFlowControl.load() || targetLagSecs <= 0 ||
+        _replCoord->getReplicationMode() != ReplicationCoordinator::modeReplSet ||
+        !_replCoord->getMemberState().primary()) {
+        _lagSecs.store(0);
+        _ticketholder.disable();
+        return;
+    }
+
+    const long long lastApplied = _replCoord->getMyLastAppliedOpTime().getTimestamp().getSecs();
+    const long long lastCommitted = _replCoord->getLastCommittedOpTime().getTimestamp().getSecs();
+    const int lagSecs = static_cast<int>(std::max(0LL, lastApplied - lastCommitted));
+    _lagSecs.store(lagSecs);
+
+    const bool wasLagged = _ticketholder.isEnabled();
+    const int tickets = computeTicketsPerSecond(
+        lagSecs, targetLagSecs, admitted, wasLagged ? _ticketholder.getTicketsPerRefresh() : -1);
+    if (tickets < 0) {
+        if (wasLagged) {
+            log() << "Majority commit lag is down to " << lagSecs
+                  << " seconds, no longer throttling writes";
+        }
+        _ticketholder.disable();
+        return;
+    }
+
+    if (!wasLagged) {
+        log() << "Majority commit lag of " << lagSecs << " seconds is above the target of "
+              << targetLagSecs << " seconds, throttling writes to " << tickets << " per second";
+    }
+    _ticketholder.refreshTo(tickets);
+}
+
+namespace {
+
+class FlowControlServerStatus final : public ServerStatusSection {
+public:
+    FlowControlServerStatus() : ServerStatusSection("flowControl") {}
+
+    bool includeByDefault() const final {
+        return true;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx, const BSONElement& configElement) const final {
+        auto flowControl = FlowControl::get(opCtx->getServiceContext());
+        if (!flowControl) {
+            return BSONObj();
+        }
+
+        BSONObjBuilder builder;
+        flowControl->appendStats(&builder);
+        return builder.obj();
+    }
+} flowControlServerStatus;
+
+}  // namespace
+}  // namespace repl
+}  // namespace mongo
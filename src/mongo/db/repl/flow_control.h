@@ -0,0 +1,117 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/concurrency/flow_control_ticketholder.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class ServiceContext;
+
+namespace repl {
+
+class ReplicationCoordinator;
+
+/**
+ * Throttles writes on a primary whose majority commit point falls behind, so that the secondaries
+ * can catch up before w:majority writes time out and the storage engine runs out of cache for the
+ * history pinned by the committed snapshot.
+ *
+ * Once a second, FlowControl compares the majority commit lag, the distance between the last
+ * committed and the last applied optimes, to the flowControlTargetLagSeconds server parameter.
+ * While the lag is above the target, the writes admitted per second are cut to a fraction of the
+ * writes admitted in the previous second. Once the lag is back under the target, the rate grows
+ * again, and the throttle is lifted when the lag falls under half the target.
+ */
+class FlowControl {
+    MONGO_DISALLOW_COPYING(FlowControl);
+
+public:
+    explicit FlowControl(ReplicationCoordinator* replCoord);
+    ~FlowControl();
+
+    static FlowControl* get(ServiceContext* service);
+    static void set(ServiceContext* service, std::unique_ptr<FlowControl> flowControl);
+
+    /**
+     * Makes global write locks take tickets from this FlowControl and starts adjusting their
+     * rate.
+     */
+    void startup();
+
+    /**
+     * Stops adjusting the rate and lifts the throttle. Idempotent.
+     */
+    void shutdown();
+
+    // The throttle never admits fewer writes per second than this, so that writers always make
+    // progress.
+    static const int kMinTicketsPerSecond = 100;
+
+    /**
+     * Returns the number of writes to admit in the next second, or a negative number if writes
+     * should not be throttled. 'lastTicketsPerSecond' is the last number returned, negative if
+     * writes are not being throttled.
+     */
+    static int computeTicketsPerSecond(int lagSecs,
+                                       int targetLagSecs,
+                                       long long admittedLastSecond,
+                                       int lastTicketsPerSecond);
+
+    void appendStats(BSONObjBuilder* builder) const;
+
+private:
+    void _run();
+
+    void _refresh();
+
+    ReplicationCoordinator* const _replCoord;
+
+    FlowControlTicketholder _ticketholder;
+
+    // Only used by the refresher thread.
+    long long _lastAcquireCount = 0;
+
+    AtomicInt32 _lagSecs;
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _shutdownCV;
+    bool _inShutdown = false;
+    stdx::thread _thread;
+};
+
+}  // namespace repl
+}  // namespace mongo
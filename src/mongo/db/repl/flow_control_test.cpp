@@ -0,0 +1,76 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/flow_control.h"
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace repl {
+namespace {
+
+const int kTarget = 10;
+const int kNotThrottling = -1;
+
+TEST(FlowControlTest, DoesNotThrottleUnderTheTarget) {
+    ASSERT_LT(FlowControl::computeTicketsPerSecond(0, kTarget, 5000, kNotThrottling), 0);
+    ASSERT_LT(FlowControl::computeTicketsPerSecond(kTarget - 1, kTarget, 5000, kNotThrottling), 0);
+}
+
+TEST(FlowControlTest, CutsTheAdmittedRateAboveTheTarget) {
+    ASSERT_EQ(4000, FlowControl::computeTicketsPerSecond(kTarget, kTarget, 5000, kNotThrottling));
+    ASSERT_EQ(2500,
+              FlowControl::computeTicketsPerSecond(2 * kTarget, kTarget, 5000, kNotThrottling));
+
+    // The cut applies to the lower of the allowance and what the writers used of it.
+    ASSERT_EQ(800, FlowControl::computeTicketsPerSecond(kTarget, kTarget, 5000, 1000));
+    ASSERT_EQ(400, FlowControl::computeTicketsPerSecond(kTarget, kTarget, 500, 1000));
+}
+
+TEST(FlowControlTest, NeverGoesUnderTheMinimum) {
+    ASSERT_EQ(FlowControl::kMinTicketsPerSecond,
+              FlowControl::computeTicketsPerSecond(3 * kTarget, kTarget, 0, kNotThrottling));
+    ASSERT_EQ(FlowControl::kMinTicketsPerSecond,
+              FlowControl::computeTicketsPerSecond(
+                  3 * kTarget, kTarget, 10, FlowControl::kMinTicketsPerSecond));
+}
+
+TEST(FlowControlTest, RecoversGraduallyUnderTheTarget) {
+    ASSERT_EQ(1100, FlowControl::computeTicketsPerSecond(kTarget - 1, kTarget, 1000, 1000));
+    ASSERT_EQ(FlowControl::kMinTicketsPerSecond + 200,
+              FlowControl::computeTicketsPerSecond(kTarget / 2, kTarget, 200, 200));
+
+    // The throttle is lifted under half the target.
+    ASSERT_LT(FlowControl::computeTicketsPerSecond(kTarget / 2 - 1, kTarget, 1000, 1000), 0);
+}
+
+}  // namespace
+}  // namespace repl
+}  // namespace mongo
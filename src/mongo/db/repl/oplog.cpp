@@ -84,6 +84,7 @@
 #include "mongo/db/stats/counters.h"
 #include "mongo/db/storage/storage_engine.h"
 #include "mongo/db/storage/storage_options.h"
+#include "mongo/db/update/document_diff.h"
 #include "mongo/platform/random.h"
 #include "mongo/scripting/engine.h"
 #include "mongo/stdx/memory.h"
@@ -664,6 +665,64 @@ std::map<std::string, ApplyOpMetadata> opsMap = {
      }}},
 };
 
+/**
+ * Applies the update oplog entry 'op', whose "o" field 'update' is a delta update carrying
+ * 'diff', to the document matching 'criteria'. The diff must have been computed from the
+ * document as it is now, so unlike modifier updates a delta update cannot be upserted.
+ */
+Status applyDeltaUpdate_inlock(OperationContext* opCtx,
+                               Collection* collection,
+                               const NamespaceString& nss,
+                               const BSONObj& op,
+                               const BSONObj& update,
+                               const BSONObj& criteria,
+                               const BSONObj& diff) {
+    RecordId recordId;
+    if (collection) {
+        recordId = collection->getIndexCatalog()->haveIdIndex(opCtx)
+            ? Helpers::findById(opCtx, collection, criteria)
+            : Helpers::findOne(opCtx, collection, criteria, false);
+    }
+    if (recordId.isNull()) {
+        std::string msg = str::stream() << "couldn't find doc: " << redact(op);
+        error() << msg;
+        return Status(ErrorCodes::OperationFailed, msg);
+    }
+
+    Snapshotted<BSONObj> oldDoc = collection->docFor(opCtx, recordId);
+    auto newDoc = documentdiff::applyDiff(oldDoc.value(), diff);
+    if (!newDoc.isOK()) {
+        std::string msg = str::stream() << "failed to apply update: " << redact(op) << ": "
+                                        << newDoc.getStatus().reason();
+        error() << msg;
+        return Status(ErrorCodes::OperationFailed, msg);
+    }
+
+    WriteUnitOfWork wuow(opCtx);
+    OplogUpdateEntryArgs args;
+    args.nss = nss;
+    args.uuid = collection->uuid();
+    args.update = update;
+    args.criteria = criteria;
+    args.fromMigrate = false;
+    // The diff does not say which index keys it changes, so every index is maintained.
+    auto status = collection->updateDocument(opCtx,
+                                             recordId,
+                                             oldDoc,
+                                             newDoc.getValue(),
+                                             true,
+                                             true,
+                                             nullptr,
+                                             &args,
+                                             nullptr)
+                      .getStatus();
+    if (!status.isOK()) {
+        return status;
+    }
+    wuow.commit();
+    return Status::OK();
+}
+
 }  // namespace
 
 std::pair<BSONObj, NamespaceString> prepForApplyOpsIndexInsert(const BSONElement& fieldO,
@@ -712,18 +771,25 @@ Status applyOperation_inlock(OperationContext* opCtx,
                              const BSONObj& op,
                              bool inSteadyStateReplication,
                              IncrementOpsAppliedStatsFn incrementOpsAppliedStats) {
+    return applyOperation_inlock(
+        opCtx, db, OplogEntryView(op), inSteadyStateReplication, incrementOpsAppliedStats);
+}
+
+Status applyOperation_inlock(OperationContext* opCtx,
+                             Database* db,
+                             const OplogEntryView& entry,
+                             bool inSteadyStateReplication,
+                             IncrementOpsAppliedStatsFn incrementOpsAppliedStats) {
+    const BSONObj& op = entry.raw;
     LOG(3) << "applying op: " << redact(op);
 
     OpCounters* opCounters = opCtx->writesAreReplicated() ? &globalOpCounters : &replOpCounters;
 
-    const char* names[] = {"o", "ns", "op", "b", "o2"};
-    BSONElement fields[5];
-    op.getFields(5, names, fields);
-    BSONElement& fieldO = fields[0];
-    BSONElement& fieldNs = fields[1];
-    BSONElement& fieldOp = fields[2];
-    BSONElement& fieldB = fields[3];
-    BSONElement& fieldO2 = fields[4];
+    const BSONElement& fieldO = entry.o;
+    const BSONElement& fieldNs = entry.ns;
+    const BSONElement& fieldOp = entry.opType;
+    const BSONElement& fieldB = entry.b;
+    const BSONElement& fieldO2 = entry.o2;
 
     BSONObj o;
     if (fieldO.isABSONObj())
@@ -764,6 +830,52 @@ Status applyOperation_inlock(OperationContext* opCtx,
     invariant(*opType != 'c');  // commands are processed in applyCommand_inlock()
 
     if (*opType == 'i') {
+        if (requestNss.isSystemDotIndexes() && fieldO.type() == Array) {
+            // Grouped foreground index builds on the same collection, which are built with a
+            // single scan of it.
+            std::vector<BSONObj> indexSpecs;
+            NamespaceString indexNss;
+            for (auto elem : fieldO.Obj()) {
+                BSONObj indexSpec;
+                NamespaceString specNss;
+                std::tie(indexSpec, specNss) =
+                    repl::prepForApplyOpsIndexInsert(elem, op, requestNss);
+                uassert(ErrorCodes::InvalidOptions,
+                        str::stream() << "Grouped index builds must be on the same collection: "
+                                      << op.toString(),
+                        indexSpecs.empty() || specNss == indexNss);
+                uassert(ErrorCodes::InvalidOptions,
+                        str::stream() << "Grouped index builds must be foreground builds: "
+                                      << op.toString(),
+                        !indexSpec["background"].trueValue());
+                indexSpecs.push_back(std::move(indexSpec));
+                indexNss = std::move(specNss);
+            }
+            uassert(ErrorCodes::OperationFailed,
+                    str::stream() << "Failed to create indexes due to empty array element: "
+                                  << op.toString(),
+                    !indexSpecs.empty());
+
+            // Check if collection exists.
+            uassert(ErrorCodes::NamespaceNotFound,
+                    str::stream() << "Failed to create indexes due to missing collection: "
+                                  << op.toString(),
+                    db->getCollection(opCtx, indexNss));
+
+            bool relaxIndexConstraints =
+                ReplicationCoordinator::get(opCtx)->shouldRelaxIndexConstraints(opCtx, indexNss);
+            IndexBuilder builder(indexSpecs, relaxIndexConstraints);
+            uassertStatusOK(builder.buildInForeground(opCtx, db));
+
+            for (size_t i = 0; i < indexSpecs.size(); ++i) {
+                opCounters->gotInsert();
+                if (incrementOpsAppliedStats) {
+                    incrementOpsAppliedStats();
+                }
+            }
+            return Status::OK();
+        }
+
         if (requestNss.isSystemDotIndexes()) {
             BSONObj indexSpec;
             NamespaceString indexNss;
@@ -914,6 +1026,19 @@ Status applyOperation_inlock(OperationContext* opCtx,
                 str::stream() << "Failed to apply update due to missing _id: " << op.toString(),
                 updateCriteria.hasField("_id"));
 
+        BSONObj diff;
+        if (documentdiff::isDeltaOplogEntryUpdate(o, &diff)) {
+            Status status = applyDeltaUpdate_inlock(
+                opCtx, collection, requestNss, op, o, updateCriteria, diff);
+            if (!status.isOK()) {
+                return status;
+            }
+            if (incrementOpsAppliedStats) {
+                incrementOpsAppliedStats();
+            }
+            return Status::OK();
+        }
+
         UpdateRequest request(requestNss);
 
         request.setQuery(updateCriteria);
@@ -35,6 +35,7 @@
 #include "mongo/bson/bsonobj.h"
 #include "mongo/bson/timestamp.h"
 #include "mongo/db/catalog/collection_options.h"
+#include "mongo/db/repl/oplog_entry.h"
 #include "mongo/db/repl/optime.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/stdx/functional.h"
@@ -131,6 +132,15 @@ Status applyOperation_inlock(OperationContext* opCtx,
                              bool inSteadyStateReplication = false,
                              IncrementOpsAppliedStatsFn incrementOpsAppliedStats = {});
 
+/**
+ * As above, but reads the fields of the op from 'entry' instead of searching its BSON again.
+ */
+Status applyOperation_inlock(OperationContext* opCtx,
+                             Database* db,
+                             const OplogEntryView& entry,
+                             bool inSteadyStateReplication = false,
+                             IncrementOpsAppliedStatsFn incrementOpsAppliedStats = {});
+
 /**
  * Take a command op and apply it locally
  * Used for applying from an oplog
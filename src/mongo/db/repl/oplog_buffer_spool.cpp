@@ -0,0 +1,330 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kReplication
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/oplog_buffer_spool.h"
+
+#include <boost/filesystem/operations.hpp>
+#include <limits>
+#include <memory>
+#include <snappy.h>
+
+#include "mongo/bson/util/builder.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/destructor_guard.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace repl {
+
+namespace {
+
+// Distinguishes the spool files of buffers that exist at the same time.
+AtomicUInt32 fileNumber;
+
+std::size_t getDocumentSize(const BSONObj& o) {
+    return static_cast<std::size_t>(o.objsize());
+}
+
+}  // namespace
+
+OplogBufferSpool::OplogBufferSpool(Options options) : _options(std::move(options)) {
+    uassert(ErrorCodes::BadValue,
+            "oplog buffer spool directory cannot be empty",
+            !_options.directory.empty());
+    uassert(ErrorCodes::BadValue,
+            "oplog buffer spool frame size must be positive",
+            _options.frameSize > 0);
+}
+
+OplogBufferSpool::~OplogBufferSpool() {
+    DESTRUCTOR_GUARD(shutdown(nullptr););
+}
+
+std::string OplogBufferSpool::getFileName() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _fileName;
+}
+
+std::size_t OplogBufferSpool::getSpooledFrameCount() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _spooledFrames;
+}
+
+void OplogBufferSpool::startup(OperationContext*) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    invariant(!_file.is_open());
+
+    boost::filesystem::create_directories(_options.directory);
+    _fileName = str::stream() << _options.directory << "/oplogBufferSpool."
+                              << fileNumber.fetchAndAdd(1);
+
+    _file.open(_fileName.c_str(),
+               std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
+    uassert(40649,
+            str::stream() << "error opening oplog buffer spool file \"" << _fileName
+                          << "\": " << errnoWithDescription(),
+            _file.good());
+}
+
+void OplogBufferSpool::shutdown(OperationContext*) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (!_file.is_open()) {
+        return;
+    }
+
+    _clear_inlock();
+    _file.close();
+    boost::system::error_code ec;
+    boost::filesystem::remove(_fileName, ec);
+    if (ec) {
+        warning() << "unable to remove oplog buffer spool file " << _fileName << ": "
+                  << ec.message();
+    }
+}
+
+void OplogBufferSpool::pushEvenIfFull(OperationContext*, const Value& value) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _push_inlock(value);
+}
+
+void OplogBufferSpool::push(OperationContext*, const Value& value) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _waitForSpace_inlock(lk, getDocumentSize(value));
+    _push_inlock(value);
+}
+
+void OplogBufferSpool::pushAllNonBlocking(OperationContext*,
+                                          Batch::const_iterator begin,
+                                          Batch::const_iterator end) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    for (auto it = begin; it != end; ++it) {
+        _push_inlock(*it);
+    }
+}
+
+void OplogBufferSpool::waitForSpace(OperationContext*, std::size_t size) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _waitForSpace_inlock(lk, size);
+}
+
+bool OplogBufferSpool::isEmpty() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _count == 0;
+}
+
+std::size_t OplogBufferSpool::getMaxSize() const {
+    return _options.maxSize;
+}
+
+std::size_t OplogBufferSpool::getSize() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _size;
+}
+
+std::size_t OplogBufferSpool::getCount() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _count;
+}
+
+void OplogBufferSpool::clear(OperationContext*) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _clear_inlock();
+}
+
+bool OplogBufferSpool::tryPop(OperationContext*, Value* value) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (!_fillReadFrame_inlock()) {
+        return false;
+    }
+
+    *value = std::move(_readFrame.front());
+    _readFrame.pop_front();
+    _size -= getDocumentSize(*value);
+    --_count;
+    _notFullCondition.notify_all();
+    return true;
+}
+
+bool OplogBufferSpool::waitForData(Seconds waitDuration) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _notEmptyCondition.wait_for(
+        lk, waitDuration.toSystemDuration(), [this] { return _count > 0; });
+    return _count > 0;
+}
+
+bool OplogBufferSpool::peek(OperationContext*, Value* value) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (!_fillReadFrame_inlock()) {
+        return false;
+    }
+
+    *value = _readFrame.front();
+    return true;
+}
+
+boost::optional<OplogBuffer::Value> OplogBufferSpool::lastObjectPushed(OperationContext*) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_count == 0) {
+        return boost::none;
+    }
+    return _lastPushed;
+}
+
+void OplogBufferSpool::_push_inlock(const Value& value) {
+    invariant(_file.is_open());
+
+    const auto size = getDocumentSize(value);
+    _writeFrame.push_back(value);
+    _writeFrameSize += size;
+    _size += size;
+    ++_count;
+    _lastPushed = value;
+
+    if (_writeFrameSize >= _options.frameSize) {
+        _spillFrame_inlock();
+    }
+
+    _notEmptyCondition.notify_all();
+}
+
+void OplogBufferSpool::_waitForSpace_inlock(stdx::unique_lock<stdx::mutex>& lk, std::size_t size) {
+    if (_options.maxSize == 0) {
+        return;
+    }
+    _notFullCondition.wait(lk, [&] { return _size + size <= _options.maxSize; });
+}
+
+void OplogBufferSpool::_spillFrame_inlock() {
+    if (_writeFrame.empty()) {
+        return;
+    }
+
+    BufBuilder frame(_writeFrameSize);
+    for (auto&& value : _writeFrame) {
+        frame.appendBuf(value.objdata(), value.objsize());
+    }
+
+    std::string compressed;
+    snappy::Compress(frame.buf(), frame.len(), &compressed);
+    invariant(compressed.size() <= std::size_t(std::numeric_limits<int32_t>::max()));
+    const int32_t compressedSize = compressed.size();
+
+    _file.seekp(_writeOffset);
+    _file.write(reinterpret_cast<const char*>(&compressedSize), sizeof(compressedSize));
+    _file.write(compressed.data(), compressedSize);
+    _file.flush();
+    uassert(40650,
+            str::stream() << "error writing to oplog buffer spool file \"" << _fileName
+                          << "\": " << errnoWithDescription(),
+            _file.good());
+
+    _writeOffset += sizeof(compressedSize) + compressedSize;
+    ++_spooledFrames;
+    _writeFrame.clear();
+    _writeFrameSize = 0;
+}
+
+bool OplogBufferSpool::_fillReadFrame_inlock() {
+    if (!_readFrame.empty()) {
+        return true;
+    }
+
+    if (_spooledFrames == 0) {
+        // Nothing is waiting on disk, so the frame being filled holds the oldest entries.
+        if (_writeFrame.empty()) {
+            return false;
+        }
+        _readFrame.assign(std::make_move_iterator(_writeFrame.begin()),
+                          std::make_move_iterator(_writeFrame.end()));
+        _writeFrame.clear();
+        _writeFrameSize = 0;
+        return true;
+    }
+
+    int32_t compressedSize;
+    _file.seekg(_readOffset);
+    _file.read(reinterpret_cast<char*>(&compressedSize), sizeof(compressedSize));
+    std::unique_ptr<char[]> compressed(new char[compressedSize]);
+    _file.read(compressed.get(), compressedSize);
+    uassert(40651,
+            str::stream() << "error reading from oplog buffer spool file \"" << _fileName
+                          << "\": " << errnoWithDescription(),
+            _file.good());
+
+    std::size_t uncompressedSize;
+    uassert(40652,
+            str::stream() << "corrupt frame in oplog buffer spool file " << _fileName,
+            snappy::GetUncompressedLength(compressed.get(), compressedSize, &uncompressedSize));
+    std::unique_ptr<char[]> frame(new char[uncompressedSize]);
+    uassert(40652,
+            str::stream() << "corrupt frame in oplog buffer spool file " << _fileName,
+            snappy::RawUncompress(compressed.get(), compressedSize, frame.get()));
+
+    for (std::size_t offset = 0; offset < uncompressedSize;) {
+        BSONObj value(frame.get() + offset);
+        offset += value.objsize();
+        _readFrame.push_back(value.getOwned());
+    }
+
+    _readOffset += sizeof(compressedSize) + compressedSize;
+    if (--_spooledFrames == 0) {
+        // The reader has caught up with the writer; give the disk space back.
+        _readOffset = 0;
+        _writeOffset = 0;
+        boost::system::error_code ec;
+        boost::filesystem::resize_file(_fileName, 0, ec);
+    }
+    return true;
+}
+
+void OplogBufferSpool::_clear_inlock() {
+    _readFrame.clear();
+    _writeFrame.clear();
+    _writeFrameSize = 0;
+    _size = 0;
+    _count = 0;
+    _lastPushed = boost::none;
+
+    if (_spooledFrames > 0) {
+        _spooledFrames = 0;
+        _readOffset = 0;
+        _writeOffset = 0;
+        boost::system::error_code ec;
+        boost::filesystem::resize_file(_fileName, 0, ec);
+    }
+    _notFullCondition.notify_all();
+}
+
+}  // namespace repl
+}  // namespace mongo
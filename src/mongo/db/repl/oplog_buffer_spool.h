@@ -0,0 +1,166 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "mongo/db/repl/oplog_buffer.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+namespace repl {
+
+/**
+ * Oplog buffer backed by an append-only spool file. Pushed entries are collected in memory into
+ * frames of about Options::frameSize bytes; each full frame is compressed with snappy and appended
+ * to the file. Entries are popped in push order: frames are read back from the file one at a time
+ * and, once the file has been drained, directly from the frame still being filled. The file is
+ * truncated whenever the reader catches up with the writer so disk use tracks the current lag.
+ *
+ * Only the frame being filled and the frame being read are held in memory, so a fetcher can run
+ * far ahead of the applier without the memory limit of OplogBufferBlockingQueue or the insert and
+ * index maintenance cost of OplogBufferCollection.
+ *
+ * The spool file is created in startup() and removed in shutdown().
+ */
+class OplogBufferSpool final : public OplogBuffer {
+public:
+    /**
+     * Structure used to configure an instance of OplogBufferSpool.
+     */
+    struct Options {
+        // Directory in which the spool file is created.
+        std::string directory;
+
+        // Pushed entries are compressed and written out in frames of at least this many bytes.
+        std::size_t frameSize = 1024 * 1024;
+
+        // Maximum total size of buffered entries. If equal to 0, the buffer has no size limit.
+        std::size_t maxSize = 0;
+
+        Options() {}
+    };
+
+    explicit OplogBufferSpool(Options options);
+    ~OplogBufferSpool();
+
+    /**
+     * Returns the path of the spool file. Empty until startup() has been called.
+     */
+    std::string getFileName() const;
+
+    /**
+     * Returns the number of frames written to the spool file that have not been read back yet.
+     */
+    std::size_t getSpooledFrameCount() const;
+
+    void startup(OperationContext* opCtx) override;
+    void shutdown(OperationContext* opCtx) override;
+    void pushEvenIfFull(OperationContext* opCtx, const Value& value) override;
+    void push(OperationContext* opCtx, const Value& value) override;
+    void pushAllNonBlocking(OperationContext* opCtx,
+                            Batch::const_iterator begin,
+                            Batch::const_iterator end) override;
+    void waitForSpace(OperationContext* opCtx, std::size_t size) override;
+    bool isEmpty() const override;
+    std::size_t getMaxSize() const override;
+    std::size_t getSize() const override;
+    std::size_t getCount() const override;
+    void clear(OperationContext* opCtx) override;
+    bool tryPop(OperationContext* opCtx, Value* value) override;
+    bool waitForData(Seconds waitDuration) override;
+    bool peek(OperationContext* opCtx, Value* value) override;
+    boost::optional<Value> lastObjectPushed(OperationContext* opCtx) const override;
+
+private:
+    /**
+     * Adds 'value' to the frame being filled, spilling the frame to disk once it is full.
+     */
+    void _push_inlock(const Value& value);
+
+    /**
+     * Blocks until the buffer has room for 'size' more bytes.
+     */
+    void _waitForSpace_inlock(stdx::unique_lock<stdx::mutex>& lk, std::size_t size);
+
+    /**
+     * Compresses the frame being filled and appends it to the spool file.
+     */
+    void _spillFrame_inlock();
+
+    /**
+     * Makes sure the next entry to pop is in '_readFrame' if the buffer is not empty. Returns
+     * false if the buffer is empty.
+     */
+    bool _fillReadFrame_inlock();
+
+    /**
+     * Discards all buffered entries and truncates the spool file.
+     */
+    void _clear_inlock();
+
+    const Options _options;
+
+    // Path of the spool file.
+    std::string _fileName;
+
+    // Guards the members declared below.
+    mutable stdx::mutex _mutex;
+    stdx::condition_variable _notEmptyCondition;
+    stdx::condition_variable _notFullCondition;
+
+    // Spool file, opened for both reading and writing. '_readOffset' is the start of the oldest
+    // frame that has not been read back; '_writeOffset' is the end of the newest frame.
+    std::fstream _file;
+    std::uint64_t _readOffset = 0;
+    std::uint64_t _writeOffset = 0;
+    std::size_t _spooledFrames = 0;
+
+    // Entries of the frame currently being popped from, oldest first.
+    std::deque<Value> _readFrame;
+
+    // Entries pushed since the last frame was spilled, and their total size.
+    std::vector<Value> _writeFrame;
+    std::size_t _writeFrameSize = 0;
+
+    // Totals over all buffered entries, in memory or on disk.
+    std::size_t _size = 0;
+    std::size_t _count = 0;
+
+    boost::optional<Value> _lastPushed;
+};
+
+}  // namespace repl
+}  // namespace mongo
@@ -0,0 +1,193 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <boost/filesystem/operations.hpp>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/repl/oplog_buffer_spool.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+
+namespace {
+
+using namespace mongo;
+using namespace mongo::repl;
+
+class OplogBufferSpoolTest : public unittest::Test {
+protected:
+    /**
+     * Returns a spool that writes a frame to disk on every push when 'frameSize' is 1.
+     */
+    std::unique_ptr<OplogBufferSpool> makeSpool(std::size_t frameSize,
+                                                std::size_t maxSize = 0) {
+        OplogBufferSpool::Options options;
+        options.directory = _tempDir.path();
+        options.frameSize = frameSize;
+        options.maxSize = maxSize;
+        auto spool = stdx::make_unique<OplogBufferSpool>(options);
+        spool->startup(nullptr);
+        return spool;
+    }
+
+private:
+    unittest::TempDir _tempDir{"oplog_buffer_spool_test"};
+};
+
+BSONObj makeOplogEntry(int t) {
+    return BSON("ts" << Timestamp(t, t) << "h" << t << "ns"
+                     << "a.a"
+                     << "v"
+                     << 2
+                     << "op"
+                     << "i"
+                     << "o"
+                     << BSON("_id" << t << "a" << t));
+}
+
+TEST_F(OplogBufferSpoolTest, InvalidOptions) {
+    OplogBufferSpool::Options options;
+    ASSERT_THROWS_CODE(OplogBufferSpool{options}, UserException, ErrorCodes::BadValue);
+
+    options.directory = "dir";
+    options.frameSize = 0;
+    ASSERT_THROWS_CODE(OplogBufferSpool{options}, UserException, ErrorCodes::BadValue);
+}
+
+TEST_F(OplogBufferSpoolTest, StartupCreatesSpoolFileAndShutdownRemovesIt) {
+    auto spool = makeSpool(1);
+    auto fileName = spool->getFileName();
+    ASSERT_TRUE(boost::filesystem::exists(fileName));
+
+    spool->push(nullptr, makeOplogEntry(1));
+    spool->shutdown(nullptr);
+    ASSERT_FALSE(boost::filesystem::exists(fileName));
+}
+
+TEST_F(OplogBufferSpoolTest, PopReturnsEntriesInPushOrderAcrossSpilledFrames) {
+    auto spool = makeSpool(1);
+    std::size_t size = 0;
+    for (int i = 1; i <= 100; ++i) {
+        auto entry = makeOplogEntry(i);
+        size += entry.objsize();
+        spool->push(nullptr, entry);
+    }
+    ASSERT_EQUALS(100U, spool->getSpooledFrameCount());
+    ASSERT_EQUALS(100U, spool->getCount());
+    ASSERT_EQUALS(size, spool->getSize());
+    ASSERT_BSONOBJ_EQ(makeOplogEntry(100), *spool->lastObjectPushed(nullptr));
+
+    BSONObj doc;
+    for (int i = 1; i <= 100; ++i) {
+        ASSERT_TRUE(spool->peek(nullptr, &doc));
+        ASSERT_BSONOBJ_EQ(makeOplogEntry(i), doc);
+        ASSERT_TRUE(spool->tryPop(nullptr, &doc));
+        ASSERT_BSONOBJ_EQ(makeOplogEntry(i), doc);
+    }
+
+    ASSERT_TRUE(spool->isEmpty());
+    ASSERT_EQUALS(0U, spool->getSize());
+    ASSERT_FALSE(spool->tryPop(nullptr, &doc));
+    ASSERT_FALSE(spool->lastObjectPushed(nullptr));
+
+    // The spool file is emptied once the reader catches up with the writer.
+    ASSERT_EQUALS(0U, boost::filesystem::file_size(spool->getFileName()));
+    spool->shutdown(nullptr);
+}
+
+TEST_F(OplogBufferSpoolTest, EntriesOnDiskArePoppedBeforeEntriesInTheFrameBeingFilled) {
+    auto entrySize = std::size_t(makeOplogEntry(1).objsize());
+    auto spool = makeSpool(entrySize * 3);
+
+    OplogBuffer::Batch batch;
+    for (int i = 1; i <= 5; ++i) {
+        batch.push_back(makeOplogEntry(i));
+    }
+    spool->pushAllNonBlocking(nullptr, batch.cbegin(), batch.cend());
+
+    // The first three entries were spilled as one frame; the last two are still in memory.
+    ASSERT_EQUALS(1U, spool->getSpooledFrameCount());
+
+    BSONObj doc;
+    ASSERT_TRUE(spool->tryPop(nullptr, &doc));
+    ASSERT_BSONOBJ_EQ(makeOplogEntry(1), doc);
+    ASSERT_EQUALS(0U, spool->getSpooledFrameCount());
+
+    spool->pushEvenIfFull(nullptr, makeOplogEntry(6));
+    for (int i = 2; i <= 6; ++i) {
+        ASSERT_TRUE(spool->tryPop(nullptr, &doc));
+        ASSERT_BSONOBJ_EQ(makeOplogEntry(i), doc);
+    }
+    ASSERT_TRUE(spool->isEmpty());
+    spool->shutdown(nullptr);
+}
+
+TEST_F(OplogBufferSpoolTest, ClearDiscardsEntriesInMemoryAndOnDisk) {
+    auto spool = makeSpool(1);
+    spool->push(nullptr, makeOplogEntry(1));
+    spool->push(nullptr, makeOplogEntry(2));
+    ASSERT_EQUALS(2U, spool->getSpooledFrameCount());
+
+    spool->clear(nullptr);
+    ASSERT_TRUE(spool->isEmpty());
+    ASSERT_EQUALS(0U, spool->getSize());
+    ASSERT_EQUALS(0U, spool->getSpooledFrameCount());
+    ASSERT_EQUALS(0U, boost::filesystem::file_size(spool->getFileName()));
+
+    BSONObj doc;
+    ASSERT_FALSE(spool->peek(nullptr, &doc));
+
+    spool->push(nullptr, makeOplogEntry(3));
+    ASSERT_TRUE(spool->tryPop(nullptr, &doc));
+    ASSERT_BSONOBJ_EQ(makeOplogEntry(3), doc);
+    spool->shutdown(nullptr);
+}
+
+TEST_F(OplogBufferSpoolTest, WaitForDataReturnsFalseOnlyWhenEmpty) {
+    auto spool = makeSpool(1024);
+    ASSERT_FALSE(spool->waitForData(Seconds(0)));
+    spool->push(nullptr, makeOplogEntry(1));
+    ASSERT_TRUE(spool->waitForData(Seconds(0)));
+    spool->shutdown(nullptr);
+}
+
+TEST_F(OplogBufferSpoolTest, MaxSizeIsReportedAndWaitForSpaceReturnsWhenThereIsRoom) {
+    auto entrySize = std::size_t(makeOplogEntry(1).objsize());
+    auto spool = makeSpool(1, entrySize * 2);
+    ASSERT_EQUALS(entrySize * 2, spool->getMaxSize());
+
+    spool->push(nullptr, makeOplogEntry(1));
+    spool->waitForSpace(nullptr, entrySize);
+    spool->push(nullptr, makeOplogEntry(2));
+    ASSERT_EQUALS(entrySize * 2, spool->getSize());
+    spool->shutdown(nullptr);
+}
+
+}  // namespace
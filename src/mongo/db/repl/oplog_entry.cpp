@@ -34,6 +34,7 @@
 
 #include "mongo/db/namespace_string.h"
 #include "mongo/util/log.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 namespace repl {
@@ -74,6 +75,32 @@ OplogEntry::CommandType parseCommandType(const BSONObj& objectField) {
 
 }  // namespace
 
+OplogEntryView::OplogEntryView(const BSONObj& op) : raw(op) {
+    const char* names[] = {"o", "ns", "op", "b", "o2"};
+    BSONElement fields[5];
+    raw.getFields(5, names, fields);
+    o = fields[0];
+    ns = fields[1];
+    opType = fields[2];
+    b = fields[3];
+    o2 = fields[4];
+
+    if (ns.type() == String) {
+        nsHash = StringMapTraits::hash(ns.valueStringData());
+    }
+
+    const char* type = opType.valuestrsafe();
+    if (type[0] == 'i' || type[0] == 'd') {
+        if (o.type() == Object) {
+            id = o.Obj()["_id"];
+        }
+    } else if (type[0] == 'u') {
+        if (o2.type() == Object) {
+            id = o2.Obj()["_id"];
+        }
+    }
+}
+
 const int OplogEntry::kOplogVersion = 2;
 
 // Static
@@ -96,6 +123,8 @@ OplogEntry::OplogEntry(BSONObj rawInput)
     if (isCommand()) {
         _commandType = parseCommandType(getObject());
     }
+
+    _view = OplogEntryView(raw);
 }
 OplogEntry::OplogEntry(OpTime opTime,
                        long long hash,
@@ -115,6 +144,7 @@ OplogEntry::OplogEntry(OpTime opTime,
 
     // This is necessary until we remove `raw` in SERVER-29200.
     raw = toBSON();
+    _view = OplogEntryView(raw);
 }
 
 OplogEntry::OplogEntry(OpTime opTime,
@@ -156,11 +186,15 @@ bool OplogEntry::isCrudOpType() const {
 
 BSONElement OplogEntry::getIdElement() const {
     invariant(isCrudOpType());
-    if (getOpType() == OpTypeEnum::kUpdate) {
-        return getObject2()->getField("_id");
-    } else {
-        return getObject()["_id"];
-    }
+    return _view.id;
+}
+
+uint32_t OplogEntry::getNamespaceHash() const {
+    return _view.nsHash;
+}
+
+const OplogEntryView& OplogEntry::getView() const {
+    return _view;
 }
 
 OplogEntry::CommandType OplogEntry::getCommandType() const {
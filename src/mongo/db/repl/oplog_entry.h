@@ -36,6 +36,33 @@
 namespace mongo {
 namespace repl {
 
+/**
+ * The fields of an oplog entry that the appliers read, found with a single pass over its BSON so
+ * that no later stage of application has to search the object again. Nothing is copied: the
+ * elements point into 'raw', whose buffer must outlive the view.
+ *
+ * Fields that are missing or of the wrong type are left for the consumer to reject, so a view can
+ * be built from any object.
+ */
+struct OplogEntryView {
+    OplogEntryView() = default;
+    explicit OplogEntryView(const BSONObj& op);
+
+    BSONObj raw;
+    BSONElement o;
+    BSONElement o2;
+    BSONElement ns;
+    BSONElement opType;
+    BSONElement b;
+
+    // The _id of the document modified by an insert, update or delete. EOO for other ops, and for
+    // CRUD ops that do not carry an _id.
+    BSONElement id;
+
+    // StringMapTraits hash of 'ns', or 0 if 'ns' is not a string.
+    uint32_t nsHash = 0;
+};
+
 /**
  * A parsed oplog entry that inherits from the OplogEntryBase parsed by the IDL.
  */
@@ -90,9 +117,13 @@ public:
 
     OplogEntry() = delete;
 
-    // This member is not parsed from the BSON and is instead populated by fillWriterVectors.
+    // These members are not parsed from the BSON and are instead populated by fillWriterVectors.
     bool isForCappedCollection = false;
 
+    // True if this is an insert that may be applied ahead of earlier ops on other documents in
+    // the same collection.
+    bool isReorderableInsert = false;
+
     /**
      * Returns if the oplog entry is for a command operation.
      */
@@ -108,6 +139,16 @@ public:
      */
     BSONElement getIdElement() const;
 
+    /**
+     * Returns the StringMapTraits hash of the namespace, computed when the entry was parsed.
+     */
+    uint32_t getNamespaceHash() const;
+
+    /**
+     * Returns the fields used to apply this entry. The view points into 'raw'.
+     */
+    const OplogEntryView& getView() const;
+
     /**
      * Returns the type of command of the oplog entry. Must be called on a command op.
      */
@@ -128,6 +169,9 @@ public:
 
 private:
     CommandType _commandType;
+
+    // Built from 'raw' by every constructor.
+    OplogEntryView _view;
 };
 
 std::ostream& operator<<(std::ostream& s, const OplogEntry& o);
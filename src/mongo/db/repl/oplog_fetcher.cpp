@@ -36,12 +36,15 @@
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/stats/timer_stats.h"
 #include "mongo/rpc/metadata/oplog_query_metadata.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_name.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 #include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace repl {
@@ -63,6 +66,70 @@ ServerStatusMetricField<Counter64> displayOpsRead("repl.network.ops", &opsReadSt
 Counter64 networkByteStats;
 ServerStatusMetricField<Counter64> displayBytesRead("repl.network.bytes", &networkByteStats);
 
+// The number of received batches that may wait to be validated and enqueued while the next batch is
+// being fetched. 0 disables pipelining.
+MONGO_EXPORT_SERVER_PARAMETER(oplogFetcherMaxPendingBatches, int, 0);
+
+/**
+ * Time spent in each stage of oplog fetching, reported by replSetGetStatus.
+ */
+class FetcherStageStats {
+public:
+    void recordReceive(Milliseconds elapsed, long long bytes) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _batches++;
+        _bytes += bytes;
+        _receiveTime += elapsed;
+
+        // Measure throughput over windows of at least a second.
+        const auto now = Date_t::now();
+        if (_windowStart == Date_t()) {
+            _windowStart = now;
+        }
+        _windowBytes += bytes;
+        const auto windowLength = now - _windowStart;
+        if (windowLength >= Seconds(1)) {
+            _bytesPerSecond = _windowBytes * 1000 / durationCount<Milliseconds>(windowLength);
+            _windowStart = now;
+            _windowBytes = 0;
+        }
+    }
+
+    void recordValidate(long long micros) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _validateMicros += micros;
+    }
+
+    void recordEnqueue(long long micros) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _enqueueMicros += micros;
+    }
+
+    void append(BSONObjBuilder* bob) const {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        bob->append("batches", _batches);
+        bob->append("bytes", _bytes);
+        bob->append("bytesPerSecond", _bytesPerSecond);
+        bob->append("receiveMillis", durationCount<Milliseconds>(_receiveTime));
+        bob->append("validateMicros", _validateMicros);
+        bob->append("enqueueMicros", _enqueueMicros);
+        bob->append("pendingBatches", pendingBatches.load());
+    }
+
+    AtomicInt64 pendingBatches{0};
+
+private:
+    mutable stdx::mutex _mutex;
+    long long _batches = 0;
+    long long _bytes = 0;
+    Milliseconds _receiveTime{0};
+    long long _validateMicros = 0;
+    long long _enqueueMicros = 0;
+    Date_t _windowStart;
+    long long _windowBytes = 0;
+    long long _bytesPerSecond = 0;
+} fetcherStageStats;
+
 /**
  * Calculates await data timeout based on the current replica set configuration.
  */
@@ -324,7 +391,8 @@ OplogFetcher::OplogFetcher(executor::TaskExecutor* executor,
       _requireFresherSyncSource(requireFresherSyncSource),
       _dataReplicatorExternalState(dataReplicatorExternalState),
       _enqueueDocumentsFn(enqueueDocumentsFn),
-      _awaitDataTimeout(calculateAwaitDataTimeout(config)) {
+      _awaitDataTimeout(calculateAwaitDataTimeout(config)),
+      _maxPendingBatches(std::max(0, oplogFetcherMaxPendingBatches.load())) {
 
     invariant(config.isInitialized());
     invariant(enqueueDocumentsFn);
@@ -333,6 +401,11 @@ OplogFetcher::OplogFetcher(executor::TaskExecutor* executor,
 OplogFetcher::~OplogFetcher() {
     shutdown();
     join();
+    invariant(!_decodeThread.joinable());
+}
+
+void OplogFetcher::appendStats(BSONObjBuilder* bob) {
+    fetcherStageStats.append(bob);
 }
 
 BSONObj OplogFetcher::_makeFindCommandObject(const NamespaceString& nss,
@@ -397,8 +470,23 @@ StatusWith<BSONObj> OplogFetcher::_onSuccessfulBatch(const Fetcher::QueryRespons
     // This lastFetched value is the last OpTime from the previous batch.
     auto lastFetched = _getLastOpTimeWithHashFetched();
 
+    long long batchBytes = 0;
+    for (auto&& doc : documents) {
+        batchBytes += doc.objsize();
+    }
+    fetcherStageStats.recordReceive(queryResponse.elapsedMillis, batchBytes);
+
+    const bool pipelined = _maxPendingBatches > 0 && !queryResponse.first;
+
     // Check start of remote oplog and, if necessary, stop fetcher to execute rollback.
     if (queryResponse.first) {
+        // A restarted query must not enqueue anything ahead of the batches that the previous query
+        // left with the decode thread.
+        auto pipelineStatus = _waitForPendingBatches();
+        if (!pipelineStatus.isOK()) {
+            return pipelineStatus;
+        }
+
         auto remoteRBID = oqMetadata ? boost::make_optional(oqMetadata->getRBID()) : boost::none;
         auto remoteLastApplied =
             oqMetadata ? boost::make_optional(oqMetadata->getLastOpApplied()) : boost::none;
@@ -419,12 +507,15 @@ StatusWith<BSONObj> OplogFetcher::_onSuccessfulBatch(const Fetcher::QueryRespons
         firstDocToApply++;
     }
 
-    auto validateResult = OplogFetcher::validateDocuments(
-        documents, queryResponse.first, lastFetched.opTime.getTimestamp());
-    if (!validateResult.isOK()) {
-        return validateResult.getStatus();
+    DocumentsInfo info;
+    if (!pipelined) {
+        auto validateResult =
+            _validateBatch(documents, queryResponse.first, lastFetched.opTime.getTimestamp());
+        if (!validateResult.isOK()) {
+            return validateResult.getStatus();
+        }
+        info = validateResult.getValue();
     }
-    auto info = validateResult.getValue();
 
     // Process replset metadata.  It is important that this happen after we've validated the
     // first batch, so we don't progress our knowledge of the commit point from a
@@ -447,15 +538,13 @@ StatusWith<BSONObj> OplogFetcher::_onSuccessfulBatch(const Fetcher::QueryRespons
         _dataReplicatorExternalState->processMetadata(replSetMetadata, oqMetadata);
     }
 
-    // Increment stats. We read all of the docs in the query.
-    opsReadStats.increment(info.networkDocumentCount);
-    networkByteStats.increment(info.networkDocumentBytes);
-
     // Record time for each batch.
     getmoreReplStats.recordMillis(durationCount<Milliseconds>(queryResponse.elapsedMillis));
 
     // TODO: back pressure handling will be added in SERVER-23499.
-    auto status = _enqueueDocumentsFn(firstDocToApply, documents.cend(), info);
+    auto status = pipelined
+        ? _schedulePendingBatch(documents, lastFetched.opTime.getTimestamp())
+        : _enqueueBatch(firstDocToApply, documents.cend(), info);
     if (!status.isOK()) {
         return status;
     }
@@ -485,5 +574,117 @@ StatusWith<BSONObj> OplogFetcher::_onSuccessfulBatch(const Fetcher::QueryRespons
     return makeGetMoreCommandObject(
         queryResponse.nss, queryResponse.cursorId, lastCommittedWithCurrentTerm, _awaitDataTimeout);
 }
+
+StatusWith<OplogFetcher::DocumentsInfo> OplogFetcher::_validateBatch(
+    const Fetcher::Documents& documents, bool first, Timestamp lastTS) {
+    Timer timer;
+    auto result = validateDocuments(documents, first, lastTS);
+    fetcherStageStats.recordValidate(timer.micros());
+    return result;
+}
+
+Status OplogFetcher::_enqueueBatch(Fetcher::Documents::const_iterator begin,
+                                   Fetcher::Documents::const_iterator end,
+                                   const DocumentsInfo& info) {
+    // Increment stats. We read all of the docs in the query.
+    opsReadStats.increment(info.networkDocumentCount);
+    networkByteStats.increment(info.networkDocumentBytes);
+
+    Timer timer;
+    auto status = _enqueueDocumentsFn(begin, end, info);
+    fetcherStageStats.recordEnqueue(timer.micros());
+    return status;
+}
+
+Status OplogFetcher::_schedulePendingBatch(Fetcher::Documents documents, Timestamp lastTS) {
+    stdx::unique_lock<stdx::mutex> lk(_pipelineMutex);
+    if (!_decodeThread.joinable()) {
+        _stopDecoding = false;
+        _decodeThread = stdx::thread([this] { _decodeThreadRoutine(); });
+    }
+
+    _pipelineCondition.wait(lk, [&] {
+        return !_pipelineStatus.isOK() ||
+            _pendingBatches.size() < static_cast<size_t>(_maxPendingBatches);
+    });
+    if (!_pipelineStatus.isOK()) {
+        return _pipelineStatus;
+    }
+
+    _pendingBatches.push_back({std::move(documents), lastTS});
+    fetcherStageStats.pendingBatches.fetchAndAdd(1);
+    _pipelineCondition.notify_all();
+    return Status::OK();
+}
+
+Status OplogFetcher::_waitForPendingBatches() {
+    stdx::unique_lock<stdx::mutex> lk(_pipelineMutex);
+    _pipelineCondition.wait(lk, [this] { return _pendingBatches.empty() && !_decoding; });
+    return _pipelineStatus;
+}
+
+void OplogFetcher::_decodeThreadRoutine() {
+    setThreadName("oplogFetcherDecode");
+
+    stdx::unique_lock<stdx::mutex> lk(_pipelineMutex);
+    while (true) {
+        _pipelineCondition.wait(lk, [this] { return _stopDecoding || !_pendingBatches.empty(); });
+        if (_pendingBatches.empty()) {
+            return;
+        }
+
+        auto batch = std::move(_pendingBatches.front());
+        _pendingBatches.pop_front();
+        fetcherStageStats.pendingBatches.fetchAndSubtract(1);
+        _decoding = true;
+        lk.unlock();
+
+        Status status = Status::OK();
+        auto validateResult = _validateBatch(batch.documents, false, batch.lastTS);
+        if (validateResult.isOK()) {
+            status = _enqueueBatch(
+                batch.documents.cbegin(), batch.documents.cend(), validateResult.getValue());
+        } else {
+            status = validateResult.getStatus();
+        }
+
+        lk.lock();
+        _decoding = false;
+        if (!status.isOK()) {
+            // Nothing after a bad batch may be enqueued. The error is returned from the next
+            // fetcher callback, or from _onFinish.
+            error() << "oplog fetcher failed to process batch from " << _getSource() << ": "
+                    << redact(status);
+            _pipelineStatus = status;
+            fetcherStageStats.pendingBatches.fetchAndSubtract(_pendingBatches.size());
+            _pendingBatches.clear();
+        }
+        _pipelineCondition.notify_all();
+    }
+}
+
+Status OplogFetcher::_onFinish(Status status) {
+    stdx::unique_lock<stdx::mutex> lk(_pipelineMutex);
+    if (!_decodeThread.joinable()) {
+        return status;
+    }
+
+    // Batches that were received before the query ended are still valid and must be enqueued,
+    // unless we are shutting down.
+    if (status == ErrorCodes::CallbackCanceled) {
+        fetcherStageStats.pendingBatches.fetchAndSubtract(_pendingBatches.size());
+        _pendingBatches.clear();
+    }
+    _stopDecoding = true;
+    _pipelineCondition.notify_all();
+    lk.unlock();
+
+    _decodeThread.join();
+
+    lk.lock();
+    invariant(_pendingBatches.empty());
+    return _pipelineStatus.isOK() ? status : _pipelineStatus;
+}
+
 }  // namespace repl
 }  // namespace mongo
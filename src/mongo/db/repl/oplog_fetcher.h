@@ -29,6 +29,7 @@
 #pragma once
 
 #include <cstddef>
+#include <deque>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/status_with.h"
@@ -38,7 +39,10 @@
 #include "mongo/db/repl/abstract_oplog_fetcher.h"
 #include "mongo/db/repl/data_replicator_external_state.h"
 #include "mongo/db/repl/repl_set_config.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/fail_point_service.h"
 
 namespace mongo {
@@ -64,6 +68,13 @@ MONGO_FP_FORWARD_DECLARE(stopReplProducer);
  *
  * Issues a getMore command after successfully processing each batch of operations.
  *
+ * If the oplogFetcherMaxPendingBatches server parameter is positive, batches after the first are
+ * instead handed to a separate decode thread which validates and enqueues them, and the getMore for
+ * the next batch is issued right away. Up to that many received batches may be waiting for the
+ * decode thread, so the network round trip overlaps validation and enqueueing. The first batch of
+ * each query is always processed synchronously, after all pending batches, since it may trigger
+ * rollback.
+ *
  * When there is an error or when it is not possible to issue another getMore request, calls
  * "onShutdownCallbackFn" to signal the end of processing.
  *
@@ -126,6 +137,13 @@ public:
 
     virtual ~OplogFetcher();
 
+    /**
+     * Appends the time spent in each stage of oplog fetching (receiving, validating, enqueueing)
+     * and the recent network throughput, aggregated over all oplog fetchers in this process. Used
+     * by replSetGetStatus.
+     */
+    static void appendStats(BSONObjBuilder* bob);
+
     // ================== Test support API ===================
 
     /**
@@ -154,6 +172,41 @@ private:
      */
     StatusWith<BSONObj> _onSuccessfulBatch(const Fetcher::QueryResponse& queryResponse) override;
 
+    /**
+     * Finishes enqueueing the pending batches (or discards them if we are shutting down) and stops
+     * the decode thread. Any error from the decode thread replaces 'status'.
+     */
+    Status _onFinish(Status status) override;
+
+    /**
+     * Validates a batch of documents, recording the time taken.
+     */
+    StatusWith<DocumentsInfo> _validateBatch(const Fetcher::Documents& documents,
+                                             bool first,
+                                             Timestamp lastTS);
+
+    /**
+     * Updates counters and passes the documents to apply to "_enqueueDocumentsFn", recording the
+     * time taken.
+     */
+    Status _enqueueBatch(Fetcher::Documents::const_iterator begin,
+                         Fetcher::Documents::const_iterator end,
+                         const DocumentsInfo& info);
+
+    /**
+     * Hands a batch to the decode thread, starting it if necessary. Blocks while the maximum
+     * number of batches are already pending. Returns the decode thread's error, if it has failed.
+     */
+    Status _schedulePendingBatch(Fetcher::Documents documents, Timestamp lastTS);
+
+    /**
+     * Blocks until the decode thread has processed every pending batch. Returns the first error
+     * hit by the decode thread, if any.
+     */
+    Status _waitForPendingBatches();
+
+    void _decodeThreadRoutine();
+
     // The metadata object sent with the Fetcher queries.
     const BSONObj _metadataObject;
 
@@ -169,6 +222,26 @@ private:
     DataReplicatorExternalState* const _dataReplicatorExternalState;
     const EnqueueDocumentsFn _enqueueDocumentsFn;
     const Milliseconds _awaitDataTimeout;
+
+    // The number of received batches that may be waiting for the decode thread. 0 means batches are
+    // processed synchronously in the fetcher callback.
+    const int _maxPendingBatches;
+
+    struct PendingBatch {
+        Fetcher::Documents documents;
+
+        // The timestamp of the last document of the previous batch.
+        Timestamp lastTS;
+    };
+
+    // Protects the members below, which are used to pass batches to the decode thread.
+    stdx::mutex _pipelineMutex;
+    stdx::condition_variable _pipelineCondition;
+    std::deque<PendingBatch> _pendingBatches;
+    bool _decoding = false;
+    bool _stopDecoding = false;
+    Status _pipelineStatus = Status::OK();
+    stdx::thread _decodeThread;
 };
 
 }  // namespace repl
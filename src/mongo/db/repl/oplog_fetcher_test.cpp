@@ -937,4 +937,21 @@ TEST_F(OplogFetcherTest,
     ASSERT_EQUALS(0LL, info.lastDocument.value);
     ASSERT_EQUALS(OpTime(), info.lastDocument.opTime);
 }
+
+TEST_F(OplogFetcherTest, AppendStatsReportsEveryFetcherStage) {
+    BSONObjBuilder bob;
+    OplogFetcher::appendStats(&bob);
+    auto stats = bob.obj();
+
+    for (auto&& field : {"batches",
+                         "bytes",
+                         "bytesPerSecond",
+                         "receiveMillis",
+                         "validateMicros",
+                         "enqueueMicros",
+                         "pendingBatches"}) {
+        ASSERT_TRUE(stats.hasField(field)) << field << " missing from " << stats;
+    }
+    ASSERT_EQUALS(0LL, stats["pendingBatches"].numberLong());
+}
 }  // namespace
@@ -36,6 +36,7 @@
 #include "mongo/db/repl/member_state.h"
 #include "mongo/db/repl/repl_settings.h"
 #include "mongo/db/repl/sync_source_selector.h"
+#include "mongo/stdx/functional.h"
 #include "mongo/util/net/hostandport.h"
 #include "mongo/util/time_support.h"
 
@@ -207,6 +208,25 @@ public:
     virtual StatusAndDuration awaitReplicationOfLastOpForClient(
         OperationContext* opCtx, const WriteConcernOptions& writeConcern) = 0;
 
+    using ReplicationCompletionFn = stdx::function<void(const Status&)>;
+
+    /**
+     * Like awaitReplication(), above, but without blocking the calling thread, so that an
+     * operation waiting for its write concern does not hold on to a thread meanwhile. Calls
+     * "onCompletion" exactly once with the status awaitReplication() would have returned, as
+     * soon as the wait is over: when replication progress satisfies "writeConcern" for
+     * "opTime", when the wtimeout of "writeConcern" expires, or when the wait is abandoned
+     * because of a step down or shutdown. The wtimeout is the only time limit, as there is no
+     * operation to interrupt.
+     *
+     * Waits which are over right away complete on the calling thread, and all others on a thread
+     * of the replication executor. "onCompletion" must not block or call back into the
+     * ReplicationCoordinator.
+     */
+    virtual void awaitReplicationAsync(const OpTime& opTime,
+                                       const WriteConcernOptions& writeConcern,
+                                       ReplicationCompletionFn onCompletion) = 0;
+
     /**
      * Causes this node to relinquish being primary for at least 'stepdownTime'.  If 'force' is
      * false, before doing so it will wait for 'waitTime' for one other node to be within 10
@@ -62,6 +62,7 @@
 #include "mongo/db/repl/oplog_buffer_blocking_queue.h"
 #include "mongo/db/repl/oplog_buffer_collection.h"
 #include "mongo/db/repl/oplog_buffer_proxy.h"
+#include "mongo/db/repl/oplog_buffer_spool.h"
 #include "mongo/db/repl/repl_settings.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/repl/replication_process.h"
@@ -75,6 +76,7 @@
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/storage_engine.h"
+#include "mongo/db/storage/storage_options.h"
 #include "mongo/executor/network_connection_hook.h"
 #include "mongo/executor/network_interface.h"
 #include "mongo/executor/network_interface_factory.h"
@@ -118,6 +120,7 @@ const char tsFieldName[] = "ts";
 
 const char kCollectionOplogBufferName[] = "collection";
 const char kBlockingQueueOplogBufferName[] = "inMemoryBlockingQueue";
+const char kSpoolOplogBufferName[] = "spool";
 
 // Set this to true to force background creation of snapshots even if --enableMajorityReadConcern
 // isn't specified. This can be used for A-B benchmarking to find how much overhead
@@ -133,6 +136,17 @@ MONGO_EXPORT_STARTUP_SERVER_PARAMETER(initialSyncOplogBuffer,
 // Set this to specify size of read ahead buffer in the OplogBufferCollection.
 MONGO_EXPORT_STARTUP_SERVER_PARAMETER(initialSyncOplogBufferPeekCacheSize, int, 10000);
 
+// Set this to "spool" to buffer fetched oplog entries in a compressed file on disk during steady
+// state replication, so that a lagging secondary keeps fetching instead of stalling once the
+// in-memory buffer is full.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(steadyStateOplogBuffer,
+                                      std::string,
+                                      kBlockingQueueOplogBufferName);
+
+// Set this to specify the maximum size, in megabytes, of fetched oplog entries held by a spool
+// oplog buffer. 0 means no limit.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(oplogBufferSpoolMaxSizeMB, int, 10 * 1024);
+
 // Set this to specify maximum number of times the oplog fetcher will consecutively restart the
 // oplog tailing query on non-cancellation errors.
 server_parameter_storage_type<int, ServerParameterType::kStartupAndRuntime>::value_type
@@ -162,13 +176,34 @@ Status ExportedOplogFetcherMaxFetcherRestartsServerParameter::validate(
 
 MONGO_INITIALIZER(initialSyncOplogBuffer)(InitializerContext*) {
     if ((initialSyncOplogBuffer != kCollectionOplogBufferName) &&
-        (initialSyncOplogBuffer != kBlockingQueueOplogBufferName)) {
+        (initialSyncOplogBuffer != kBlockingQueueOplogBufferName) &&
+        (initialSyncOplogBuffer != kSpoolOplogBufferName)) {
         return Status(ErrorCodes::BadValue,
                       "unsupported initial sync oplog buffer option: " + initialSyncOplogBuffer);
     }
+    if ((steadyStateOplogBuffer != kBlockingQueueOplogBufferName) &&
+        (steadyStateOplogBuffer != kSpoolOplogBufferName)) {
+        return Status(ErrorCodes::BadValue,
+                      "unsupported steady state oplog buffer option: " + steadyStateOplogBuffer);
+    }
+    if (oplogBufferSpoolMaxSizeMB < 0) {
+        return Status(ErrorCodes::BadValue,
+                      "oplogBufferSpoolMaxSizeMB must be greater than or equal to 0");
+    }
     return Status::OK();
 }
 
+/**
+ * Returns new oplog buffer that spools fetched entries to a file under the dbpath's temporary
+ * directory, which is emptied at startup.
+ */
+std::unique_ptr<OplogBuffer> makeSpoolOplogBuffer() {
+    OplogBufferSpool::Options options;
+    options.directory = storageGlobalParams.dbpath + "/_tmp";
+    options.maxSize = std::size_t(oplogBufferSpoolMaxSizeMB) * 1024 * 1024;
+    return stdx::make_unique<OplogBufferSpool>(options);
+}
+
 /**
  * Returns new thread pool for thread pool task executor.
  */
@@ -935,6 +970,8 @@ std::unique_ptr<OplogBuffer> ReplicationCoordinatorExternalStateImpl::makeInitia
         options.peekCacheSize = std::size_t(initialSyncOplogBufferPeekCacheSize);
         return stdx::make_unique<OplogBufferProxy>(
             stdx::make_unique<OplogBufferCollection>(StorageInterface::get(opCtx), options));
+    } else if (initialSyncOplogBuffer == kSpoolOplogBufferName) {
+        return makeSpoolOplogBuffer();
     } else {
         return stdx::make_unique<OplogBufferBlockingQueue>();
     }
@@ -942,6 +979,9 @@ std::unique_ptr<OplogBuffer> ReplicationCoordinatorExternalStateImpl::makeInitia
 
 std::unique_ptr<OplogBuffer> ReplicationCoordinatorExternalStateImpl::makeSteadyStateOplogBuffer(
     OperationContext* opCtx) const {
+    if (steadyStateOplogBuffer == kSpoolOplogBufferName) {
+        return makeSpoolOplogBuffer();
+    }
     return stdx::make_unique<OplogBufferBlockingQueue>();
 }
 
@@ -47,12 +47,14 @@
 #include "mongo/db/repl/check_quorum_for_config_change.h"
 #include "mongo/db/repl/data_replicator_external_state_initial_sync.h"
 #include "mongo/db/repl/elect_cmd_runner.h"
+#include "mongo/db/repl/election_phase_stats.h"
 #include "mongo/db/repl/freshness_checker.h"
 #include "mongo/db/repl/handshake_args.h"
 #include "mongo/db/repl/is_master_response.h"
 #include "mongo/db/repl/last_vote.h"
 #include "mongo/db/repl/member_data.h"
 #include "mongo/db/repl/old_update_position_args.h"
+#include "mongo/db/repl/oplog_fetcher.h"
 #include "mongo/db/repl/read_concern_args.h"
 #include "mongo/db/repl/repl_client_info.h"
 #include "mongo/db/repl/repl_set_config_checks.h"
@@ -171,6 +173,21 @@ void ReplicationCoordinatorImpl::CallbackWaiter::notify_inlock() {
     finishCallback();
 }
 
+ReplicationCoordinatorImpl::AsyncWaiter::AsyncWaiter(ReplicationCoordinatorImpl* _replCoord,
+                                                     uint64_t _id,
+                                                     OpTime _opTime,
+                                                     const WriteConcernOptions& _writeConcern,
+                                                     ReplicationCompletionFn _onCompletion)
+    : Waiter(_opTime, &ownedWriteConcern),
+      replCoord(_replCoord),
+      id(_id),
+      ownedWriteConcern(_writeConcern),
+      onCompletion(std::move(_onCompletion)) {}
+
+void ReplicationCoordinatorImpl::AsyncWaiter::notify_inlock() {
+    replCoord->_onAsyncWaiterSignaled_inlock(this);
+}
+
 
 class ReplicationCoordinatorImpl::WaiterGuard {
 public:
@@ -1206,7 +1223,8 @@ Status ReplicationCoordinatorImpl::setLastDurableOptime_forTest(long long cfgVer
 
     const UpdatePositionArgs::UpdateInfo update(OpTime(), opTime, cfgVer, memberId);
     long long configVersion;
-    const auto status = _setLastOptime_inlock(update, &configVersion);
+    bool advancedOpTime;
+    const auto status = _setLastOptime_inlock(update, &configVersion, &advancedOpTime);
     _updateLastCommittedOpTime_inlock();
     return status;
 }
@@ -1219,13 +1237,15 @@ Status ReplicationCoordinatorImpl::setLastAppliedOptime_forTest(long long cfgVer
 
     const UpdatePositionArgs::UpdateInfo update(opTime, OpTime(), cfgVer, memberId);
     long long configVersion;
-    const auto status = _setLastOptime_inlock(update, &configVersion);
+    bool advancedOpTime;
+    const auto status = _setLastOptime_inlock(update, &configVersion, &advancedOpTime);
     _updateLastCommittedOpTime_inlock();
     return status;
 }
 
 Status ReplicationCoordinatorImpl::_setLastOptime_inlock(
-    const OldUpdatePositionArgs::UpdateInfo& args, long long* configVersion) {
+    const OldUpdatePositionArgs::UpdateInfo& args, long long* configVersion, bool* advancedOpTime) {
+    *advancedOpTime = false;
     if (_selfIndex == -1) {
         // Ignore updates when we're in state REMOVED
         return Status(ErrorCodes::NotMasterOrSecondary,
@@ -1279,20 +1299,17 @@ Status ReplicationCoordinatorImpl::_setLastOptime_inlock(
            << "; updating to new durable operation with timestamp " << args.ts;
 
     auto now(_replExecutor->now());
-    bool advancedOpTime = memberData->advanceLastAppliedOpTime(args.ts, now);
-    advancedOpTime = memberData->advanceLastDurableOpTime(args.ts, now) || advancedOpTime;
-
-    // Only update committed optime if the remote optimes increased.
-    if (advancedOpTime) {
-        _updateLastCommittedOpTime_inlock();
-    }
+    *advancedOpTime = memberData->advanceLastAppliedOpTime(args.ts, now);
+    *advancedOpTime = memberData->advanceLastDurableOpTime(args.ts, now) || *advancedOpTime;
 
     _cancelAndRescheduleLivenessUpdate_inlock(args.memberId);
     return Status::OK();
 }
 
 Status ReplicationCoordinatorImpl::_setLastOptime_inlock(const UpdatePositionArgs::UpdateInfo& args,
-                                                         long long* configVersion) {
+                                                         long long* configVersion,
+                                                         bool* advancedOpTime) {
+    *advancedOpTime = false;
     if (_selfIndex == -1) {
         // Ignore updates when we're in state REMOVED.
         return Status(ErrorCodes::NotMasterOrSecondary,
@@ -1348,14 +1365,9 @@ Status ReplicationCoordinatorImpl::_setLastOptime_inlock(const UpdatePositionArg
 
 
     auto now(_replExecutor->now());
-    bool advancedOpTime = memberData->advanceLastAppliedOpTime(args.appliedOpTime, now);
-    advancedOpTime =
-        memberData->advanceLastDurableOpTime(args.durableOpTime, now) || advancedOpTime;
-
-    // Only update committed optime if the remote optimes increased.
-    if (advancedOpTime) {
-        _updateLastCommittedOpTime_inlock();
-    }
+    *advancedOpTime = memberData->advanceLastAppliedOpTime(args.appliedOpTime, now);
+    *advancedOpTime =
+        memberData->advanceLastDurableOpTime(args.durableOpTime, now) || *advancedOpTime;
 
     _cancelAndRescheduleLivenessUpdate_inlock(args.memberId);
     return Status::OK();
@@ -1462,29 +1474,7 @@ Status ReplicationCoordinatorImpl::_awaitReplication_inlock(
         return Status::OK();
     }
 
-    auto checkForStepDown = [&]() -> Status {
-        if (replMode == modeReplSet && !_memberState.primary()) {
-            return {ErrorCodes::PrimarySteppedDown,
-                    "Primary stepped down while waiting for replication"};
-        }
-
-        if (opTime.getTerm() != _topCoord->getTerm()) {
-            return {
-                ErrorCodes::PrimarySteppedDown,
-                str::stream() << "Term changed from " << opTime.getTerm() << " to "
-                              << _topCoord->getTerm()
-                              << " while waiting for replication, indicating that this node must "
-                                 "have stepped down."};
-        }
-
-        if (_topCoord->isStepDownPending()) {
-            return {ErrorCodes::PrimarySteppedDown,
-                    "Received stepdown request while waiting for replication"};
-        }
-        return Status::OK();
-    };
-
-    Status stepdownStatus = checkForStepDown();
+    Status stepdownStatus = _checkForStepDownWhileAwaitingReplication_inlock(opTime);
     if (!stepdownStatus.isOK()) {
         return stepdownStatus;
     }
@@ -1541,7 +1531,7 @@ Status ReplicationCoordinatorImpl::_awaitReplication_inlock(
             return {ErrorCodes::WriteConcernFailed, "waiting for replication timed out"};
         }
 
-        stepdownStatus = checkForStepDown();
+        stepdownStatus = _checkForStepDownWhileAwaitingReplication_inlock(opTime);
         if (!stepdownStatus.isOK()) {
             return stepdownStatus;
         }
@@ -1550,6 +1540,170 @@ Status ReplicationCoordinatorImpl::_awaitReplication_inlock(
     return _checkIfWriteConcernCanBeSatisfied_inlock(writeConcern);
 }
 
+Status ReplicationCoordinatorImpl::_checkForStepDownWhileAwaitingReplication_inlock(
+    const OpTime& opTime) const {
+    if (getReplicationMode() == modeReplSet && !_memberState.primary()) {
+        return {ErrorCodes::PrimarySteppedDown,
+                "Primary stepped down while waiting for replication"};
+    }
+
+    if (opTime.getTerm() != _topCoord->getTerm()) {
+        return {ErrorCodes::PrimarySteppedDown,
+                str::stream() << "Term changed from " << opTime.getTerm() << " to "
+                              << _topCoord->getTerm()
+                              << " while waiting for replication, indicating that this node must "
+                                 "have stepped down."};
+    }
+
+    if (_topCoord->isStepDownPending()) {
+        return {ErrorCodes::PrimarySteppedDown,
+                "Received stepdown request while waiting for replication"};
+    }
+    return Status::OK();
+}
+
+void ReplicationCoordinatorImpl::awaitReplicationAsync(const OpTime& opTime,
+                                                       const WriteConcernOptions& writeConcern,
+                                                       ReplicationCompletionFn onCompletion) {
+    const WriteConcernOptions fixedWriteConcern =
+        populateUnsetWriteConcernOptionsSyncMode(writeConcern);
+    stdx::unique_lock<stdx::mutex> lock(_mutex);
+
+    auto completeNow = [&](const Status& status) {
+        lock.unlock();
+        onCompletion(status);
+    };
+
+    // The same shortcuts as _awaitReplication_inlock().
+    const Mode replMode = getReplicationMode();
+    const bool majorityOnMasterSlave = replMode == modeMasterSlave &&
+        fixedWriteConcern.wMode == WriteConcernOptions::kMajority;
+    if (replMode == modeNone || majorityOnMasterSlave || opTime.isNull()) {
+        return completeNow(Status::OK());
+    }
+
+    if (_inShutdown) {
+        return completeNow({ErrorCodes::ShutdownInProgress, "Replication is being shut down"});
+    }
+
+    Status stepdownStatus = _checkForStepDownWhileAwaitingReplication_inlock(opTime);
+    if (!stepdownStatus.isOK()) {
+        return completeNow(stepdownStatus);
+    }
+
+    if (fixedWriteConcern.wMode.empty()) {
+        if (fixedWriteConcern.wNumNodes < 1) {
+            return completeNow(Status::OK());
+        } else if (fixedWriteConcern.wNumNodes == 1 && _getMyLastAppliedOpTime_inlock() >= opTime) {
+            return completeNow(Status::OK());
+        }
+    }
+
+    if (_doneWaitingForReplication_inlock(opTime, SnapshotName::min(), fixedWriteConcern)) {
+        return completeNow(_checkIfWriteConcernCanBeSatisfied_inlock(fixedWriteConcern));
+    }
+
+    const uint64_t id = _nextAsyncReplicationWaiterId++;
+    auto waiter = stdx::make_unique<AsyncWaiter>(
+        this, id, opTime, fixedWriteConcern, std::move(onCompletion));
+
+    const Date_t wTimeoutDate = [&] {
+        if (fixedWriteConcern.wDeadline != Date_t::max()) {
+            return fixedWriteConcern.wDeadline;
+        }
+        if (fixedWriteConcern.wTimeout == WriteConcernOptions::kNoTimeout) {
+            return Date_t::max();
+        }
+        return _replExecutor->now() + Milliseconds{fixedWriteConcern.wTimeout};
+    }();
+    if (wTimeoutDate != Date_t::max()) {
+        auto timeoutHandle = _replExecutor->scheduleWorkAt(
+            wTimeoutDate, [this, id](const executor::TaskExecutor::CallbackArgs& args) {
+                if (!args.status.isOK()) {
+                    return;
+                }
+                stdx::lock_guard<stdx::mutex> lk(_mutex);
+                _completeAsyncWaiter_inlock(
+                    id, {ErrorCodes::WriteConcernFailed, "waiting for replication timed out"});
+            });
+        if (!timeoutHandle.isOK()) {
+            auto completion = std::move(waiter->onCompletion);
+            lock.unlock();
+            return completion(timeoutHandle.getStatus());
+        }
+        waiter->timeoutHandle = timeoutHandle.getValue();
+    }
+
+    _replicationWaiterList.add_inlock(waiter.get());
+    _asyncReplicationWaiters.emplace(id, std::move(waiter));
+}
+
+void ReplicationCoordinatorImpl::_onAsyncWaiterSignaled_inlock(AsyncWaiter* waiter) {
+    // Waiters are signaled before the change of state which woke them up is complete, so decide
+    // whether the wait is over once _mutex is released, like a ThreadWaiter would.
+    const uint64_t id = waiter->id;
+    auto scheduleResult =
+        _replExecutor->scheduleWork([this, id](const executor::TaskExecutor::CallbackArgs&) {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _resumeAsyncWaiter_inlock(id);
+        });
+    if (!scheduleResult.isOK()) {
+        _resumeAsyncWaiter_inlock(id);
+    }
+}
+
+void ReplicationCoordinatorImpl::_resumeAsyncWaiter_inlock(uint64_t id) {
+    auto it = _asyncReplicationWaiters.find(id);
+    if (it == _asyncReplicationWaiters.end()) {
+        return;
+    }
+    AsyncWaiter* waiter = it->second.get();
+
+    if (_inShutdown) {
+        return _completeAsyncWaiter_inlock(
+            waiter->id, {ErrorCodes::ShutdownInProgress, "Replication is being shut down"});
+    }
+
+    if (_doneWaitingForReplication_inlock(
+            waiter->opTime, SnapshotName::min(), waiter->ownedWriteConcern)) {
+        return _completeAsyncWaiter_inlock(
+            waiter->id, _checkIfWriteConcernCanBeSatisfied_inlock(waiter->ownedWriteConcern));
+    }
+
+    Status stepdownStatus = _checkForStepDownWhileAwaitingReplication_inlock(waiter->opTime);
+    if (!stepdownStatus.isOK()) {
+        return _completeAsyncWaiter_inlock(waiter->id, stepdownStatus);
+    }
+
+    // Signaled without its wait being over, so keep waiting.
+    _replicationWaiterList.add_inlock(waiter);
+}
+
+void ReplicationCoordinatorImpl::_completeAsyncWaiter_inlock(uint64_t id, const Status& status) {
+    auto it = _asyncReplicationWaiters.find(id);
+    if (it == _asyncReplicationWaiters.end()) {
+        // Already completed, by a timeout racing with replication progress for instance.
+        return;
+    }
+    std::unique_ptr<AsyncWaiter> waiter = std::move(it->second);
+    _asyncReplicationWaiters.erase(it);
+
+    _replicationWaiterList.remove_inlock(waiter.get());
+    if (waiter->timeoutHandle.isValid()) {
+        _replExecutor->cancel(waiter->timeoutHandle);
+    }
+
+    // Run the completion outside of _mutex, unless the executor is gone and no thread is left.
+    auto onCompletion = std::move(waiter->onCompletion);
+    auto scheduleResult = _replExecutor->scheduleWork(
+        [onCompletion, status](const executor::TaskExecutor::CallbackArgs&) {
+            onCompletion(status);
+        });
+    if (!scheduleResult.isOK()) {
+        onCompletion(status);
+    }
+}
+
 Status ReplicationCoordinatorImpl::stepDown(OperationContext* opCtx,
                                             const bool force,
                                             const Milliseconds& waitTime,
@@ -1883,6 +2037,11 @@ Status ReplicationCoordinatorImpl::processReplSetGetStatus(
             initialSyncProgress},
         response,
         &result);
+
+    if (result.isOK()) {
+        BSONObjBuilder fetcherStats(response->subobjStart("oplogFetcher"));
+        OplogFetcher::appendStats(&fetcherStats);
+    }
     return result;
 }
 
@@ -2491,6 +2650,7 @@ void ReplicationCoordinatorImpl::_performPostMemberStateUpdateAction(
 
 void ReplicationCoordinatorImpl::CatchupState::start_inlock() {
     log() << "Entering primary catch-up mode.";
+    _startTime = _repl->_replExecutor->now();
 
     // No catchup in single node replica set.
     if (_repl->_rsConfig.getNumMembers() == 1) {
@@ -2528,6 +2688,13 @@ void ReplicationCoordinatorImpl::CatchupState::abort_inlock() {
     invariant(_repl->_getMemberState_inlock().primary());
 
     log() << "Exited primary catch-up mode.";
+    const Date_t now = _repl->_replExecutor->now();
+    electionCatchUpStats.record(now - _startTime);
+    if (_repl->_electionStartTime != Date_t()) {
+        electionTotalStats.record(now - _repl->_electionStartTime);
+        _repl->_electionStartTime = Date_t();
+    }
+
     // Clean up its own members.
     if (_timeoutCbh) {
         _repl->_replExecutor->cancel(_timeoutCbh);
@@ -2675,16 +2842,25 @@ Status ReplicationCoordinatorImpl::processReplSetUpdatePosition(
     stdx::unique_lock<stdx::mutex> lock(_mutex);
     Status status = Status::OK();
     bool somethingChanged = false;
+    bool anyAdvancedOpTime = false;
     for (OldUpdatePositionArgs::UpdateIterator update = updates.updatesBegin();
          update != updates.updatesEnd();
          ++update) {
-        status = _setLastOptime_inlock(*update, configVersion);
+        bool advancedOpTime;
+        status = _setLastOptime_inlock(*update, configVersion, &advancedOpTime);
+        anyAdvancedOpTime = anyAdvancedOpTime || advancedOpTime;
         if (!status.isOK()) {
             break;
         }
         somethingChanged = true;
     }
 
+    // Recompute the commit point and wake the replication waiters once for the whole batch,
+    // rather than once for each member whose position advanced.
+    if (anyAdvancedOpTime) {
+        _updateLastCommittedOpTime_inlock();
+    }
+
     if (somethingChanged && !_getMemberState_inlock().primary()) {
         lock.unlock();
         // Must do this outside _mutex
@@ -2698,16 +2874,25 @@ Status ReplicationCoordinatorImpl::processReplSetUpdatePosition(const UpdatePosi
     stdx::unique_lock<stdx::mutex> lock(_mutex);
     Status status = Status::OK();
     bool somethingChanged = false;
+    bool anyAdvancedOpTime = false;
     for (UpdatePositionArgs::UpdateIterator update = updates.updatesBegin();
          update != updates.updatesEnd();
          ++update) {
-        status = _setLastOptime_inlock(*update, configVersion);
+        bool advancedOpTime;
+        status = _setLastOptime_inlock(*update, configVersion, &advancedOpTime);
+        anyAdvancedOpTime = anyAdvancedOpTime || advancedOpTime;
         if (!status.isOK()) {
             break;
         }
         somethingChanged = true;
     }
 
+    // Recompute the commit point and wake the replication waiters once for the whole batch,
+    // rather than once for each member whose position advanced.
+    if (anyAdvancedOpTime) {
+        _updateLastCommittedOpTime_inlock();
+    }
+
     if (somethingChanged && !_getMemberState_inlock().primary()) {
         lock.unlock();
         // Must do this outside _mutex
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <map>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -127,6 +128,10 @@ public:
     virtual ReplicationCoordinator::StatusAndDuration awaitReplicationOfLastOpForClient(
         OperationContext* opCtx, const WriteConcernOptions& writeConcern);
 
+    virtual void awaitReplicationAsync(const OpTime& opTime,
+                                       const WriteConcernOptions& writeConcern,
+                                       ReplicationCompletionFn onCompletion);
+
     virtual Status stepDown(OperationContext* opCtx,
                             bool force,
                             const Milliseconds& waitTime,
@@ -511,6 +516,26 @@ private:
         FinishFunc finishCallback = nullptr;
     };
 
+    // When an AsyncWaiter gets notified, the ReplicationCoordinator decides whether its wait is
+    // over and, if so, schedules its completion with the outcome.
+    //
+    // This is used by awaitReplicationAsync() to wait for a write concern without a thread.
+    struct AsyncWaiter : public Waiter {
+        AsyncWaiter(ReplicationCoordinatorImpl* replCoord,
+                    uint64_t id,
+                    OpTime _opTime,
+                    const WriteConcernOptions& _writeConcern,
+                    ReplicationCompletionFn _onCompletion);
+        void notify_inlock() override;
+
+        ReplicationCoordinatorImpl* const replCoord;
+        const uint64_t id;
+        const WriteConcernOptions ownedWriteConcern;
+        ReplicationCompletionFn onCompletion;
+        // Handle of the callback enforcing the wtimeout, if there is one.
+        executor::TaskExecutor::CallbackHandle timeoutHandle;
+    };
+
     class WaiterGuard;
 
     class WaiterList {
@@ -563,6 +588,8 @@ private:
 
     private:
         ReplicationCoordinatorImpl* _repl;  // Not owned.
+        // When we entered catchup mode.
+        Date_t _startTime;
         // Callback handle used to cancel a scheduled catchup timeout callback.
         executor::TaskExecutor::CallbackHandle _timeoutCbh;
         // Handle to a Waiter that contains the current target optime to reach after which
@@ -624,6 +651,31 @@ private:
                                     SnapshotName minSnapshot,
                                     const WriteConcernOptions& writeConcern);
 
+    /**
+     * Returns PrimarySteppedDown if this node stepped down, or is about to, since it started to
+     * wait for the replication of "opTime" as a primary, and Status::OK() otherwise.
+     */
+    Status _checkForStepDownWhileAwaitingReplication_inlock(const OpTime& opTime) const;
+
+    /**
+     * Called when an AsyncWaiter is signaled, on progress of replication or on a change of state
+     * which abandons waits, after it was removed from the waiter list. Schedules
+     * _resumeAsyncWaiter_inlock() for it.
+     */
+    void _onAsyncWaiterSignaled_inlock(AsyncWaiter* waiter);
+
+    /**
+     * Completes the AsyncWaiter "id" if its wait is over, or puts it back in the waiter list.
+     * Does nothing if it has already completed.
+     */
+    void _resumeAsyncWaiter_inlock(uint64_t id);
+
+    /**
+     * Removes the AsyncWaiter "id" from the waiter list, if it is still waiting, and schedules
+     * its completion with "status" on the replication executor.
+     */
+    void _completeAsyncWaiter_inlock(uint64_t id, const Status& status);
+
     /**
      * Returns true if the given writeConcern is satisfied up to "optime" or is unsatisfiable.
      *
@@ -664,13 +716,19 @@ private:
      * "configVersion" will be populated with our config version if it and the configVersion
      * of "args" differ.
      *
+     * "advancedOpTime" is set to whether the member's optimes advanced, in which case the caller
+     * must update the commit point with _updateLastCommittedOpTime_inlock(). Callers processing
+     * several updates do so once, after all of them.
+     *
      * The OldUpdatePositionArgs version provides support for the pre-3.2.4 format of
      * UpdatePositionArgs.
      */
     Status _setLastOptime_inlock(const OldUpdatePositionArgs::UpdateInfo& args,
-                                 long long* configVersion);
+                                 long long* configVersion,
+                                 bool* advancedOpTime);
     Status _setLastOptime_inlock(const UpdatePositionArgs::UpdateInfo& args,
-                                 long long* configVersion);
+                                 long long* configVersion,
+                                 bool* advancedOpTime);
 
     /**
      * This function will report our position externally (like upstream) if necessary.
@@ -1167,6 +1225,11 @@ private:
     // Does *not* own the WaiterInfos.
     WaiterList _opTimeWaiterList;  // (M)
 
+    // Owns the AsyncWaiters of awaitReplicationAsync() which have not completed yet, by id. They
+    // are in _replicationWaiterList while they wait.
+    std::map<uint64_t, std::unique_ptr<AsyncWaiter>> _asyncReplicationWaiters;  // (M)
+    uint64_t _nextAsyncReplicationWaiterId = 0;                                 // (M)
+
     // Set to true when we are in the process of shutting down replication.
     bool _inShutdown;  // (M)
 
@@ -1221,6 +1284,12 @@ private:
     // which includes writing the last vote and scheduling the real election.
     executor::TaskExecutor::EventHandle _electionDryRunFinishedEvent;  // (M)
 
+    // When the in-progress election started its dry run, and when its current phase started, for
+    // the serverStatus election metrics. The start of the election is kept until the newly elected
+    // primary leaves catchup mode.
+    Date_t _electionStartTime;       // (M)
+    Date_t _electionPhaseStartTime;  // (M)
+
     // Whether we slept last time we attempted an election but possibly tied with other nodes.
     bool _sleptLastElection;  // (M)
 
@@ -33,6 +33,7 @@
 #include <memory>
 
 #include "mongo/base/disallow_copying.h"
+#include "mongo/db/repl/election_phase_stats.h"
 #include "mongo/db/repl/replication_coordinator_impl.h"
 #include "mongo/db/repl/topology_coordinator_impl.h"
 #include "mongo/db/repl/vote_requester.h"
@@ -136,6 +137,7 @@ void ReplicationCoordinatorImpl::_startElectSelfV1_inlock() {
 
     log() << "conducting a dry run election to see if we could be elected";
     _voteRequester.reset(new VoteRequester);
+    _electionStartTime = _electionPhaseStartTime = _replExecutor->now();
 
     long long term = _topCoord->getTerm();
     StatusWith<executor::TaskExecutor::EventHandle> nextPhaseEvh =
@@ -159,6 +161,8 @@ void ReplicationCoordinatorImpl::_onDryRunComplete(long long originalTerm) {
     LoseElectionDryRunGuardV1 lossGuard(this);
 
     invariant(_voteRequester);
+    const Date_t now = _replExecutor->now();
+    electionDryRunStats.record(now - _electionPhaseStartTime);
 
     if (_topCoord->getTerm() != originalTerm) {
         log() << "not running for primary, we have been superceded already";
@@ -179,6 +183,7 @@ void ReplicationCoordinatorImpl::_onDryRunComplete(long long originalTerm) {
     }
 
     log() << "dry election run succeeded, running for election";
+    _electionPhaseStartTime = now;
     // Stepdown is impossible from this term update.
     TopologyCoordinator::UpdateTermResult updateTermResult;
     _updateTerm_inlock(originalTerm + 1, &updateTermResult);
@@ -254,6 +259,7 @@ void ReplicationCoordinatorImpl::_onVoteRequestComplete(long long originalTerm)
     LoseElectionGuardV1 lossGuard(this);
 
     invariant(_voteRequester);
+    electionVoteStats.record(_replExecutor->now() - _electionPhaseStartTime);
 
     if (_topCoord->getTerm() != originalTerm) {
         log() << "not becoming primary, we have been superceded already";
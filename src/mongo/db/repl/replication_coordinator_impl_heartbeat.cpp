@@ -80,7 +80,18 @@ Milliseconds ReplicationCoordinatorImpl::_getRandomizedElectionOffset_inlock() {
         return Milliseconds(0);
     }
 
-    return Milliseconds{_nextRandomInt64_inlock(randomOffsetUpperBound)};
+    // Split the range so that a node which knows of a fresher electable peer always waits longer
+    // than that peer does. The freshest node then tends to stand first, and the new primary has
+    // less to catch up on and fewer writes of the other nodes to roll back.
+    const long long fresherPeerOffset = randomOffsetUpperBound / 2;
+    if (fresherPeerOffset == 0) {
+        return Milliseconds{_nextRandomInt64_inlock(randomOffsetUpperBound)};
+    }
+    if (_topCoord->hasFresherElectablePeer()) {
+        return Milliseconds{fresherPeerOffset +
+                            _nextRandomInt64_inlock(randomOffsetUpperBound - fresherPeerOffset)};
+    }
+    return Milliseconds{_nextRandomInt64_inlock(fresherPeerOffset)};
 }
 
 void ReplicationCoordinatorImpl::_doMemberHeartbeat(executor::TaskExecutor::CallbackArgs cbData,
@@ -137,6 +148,11 @@ void ReplicationCoordinatorImpl::_scheduleHeartbeatToTarget_inlock(const HostAnd
 
 void ReplicationCoordinatorImpl::_handleHeartbeatResponse(
     const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData, int targetIndex) {
+    // Parse the metadata before taking _mutex, which the responses from every member contend on.
+    StatusWith<rpc::ReplSetMetadata> replMetadata = cbData.response.status.isOK()
+        ? rpc::ReplSetMetadata::readFromMetadata(cbData.response.metadata)
+        : StatusWith<rpc::ReplSetMetadata>(cbData.response.status);
+
     stdx::unique_lock<stdx::mutex> lk(_mutex);
 
     // remove handle from queued heartbeats
@@ -158,8 +174,6 @@ void ReplicationCoordinatorImpl::_handleHeartbeatResponse(
     if (responseStatus.isOK()) {
         resp = cbData.response.data;
         responseStatus = hbResponse.initialize(resp, _topCoord->getTerm());
-        StatusWith<rpc::ReplSetMetadata> replMetadata =
-            rpc::ReplSetMetadata::readFromMetadata(cbData.response.metadata);
 
         LOG_FOR_HEARTBEATS(2) << "Received response to heartbeat (requestId: " << cbData.request.id
                               << ") from " << target << ", " << resp;
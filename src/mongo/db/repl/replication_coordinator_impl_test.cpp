@@ -1369,6 +1369,150 @@ TEST_F(ReplCoordTest,
     awaiter.reset();
 }
 
+ReplicationCoordinator::ReplicationCompletionFn makeCompletionFn(stdx::promise<Status>* promise) {
+    return [promise](const Status& status) { promise->set_value(status); };
+}
+
+TEST_F(ReplCoordTest, AsyncAwaitReplicationCompletesOnceAWriteConcernIsSatisfied) {
+    assertStartSuccess(BSON("_id"
+                            << "mySet"
+                            << "version"
+                            << 2
+                            << "members"
+                            << BSON_ARRAY(BSON("host"
+                                               << "node1:12345"
+                                               << "_id"
+                                               << 0)
+                                          << BSON("host"
+                                                  << "node2:12345"
+                                                  << "_id"
+                                                  << 1)
+                                          << BSON("host"
+                                                  << "node3:12345"
+                                                  << "_id"
+                                                  << 2))),
+                       HostAndPort("node1", 12345));
+    ASSERT(getReplCoord()->setFollowerMode(MemberState::RS_SECONDARY));
+    getReplCoord()->setMyLastAppliedOpTime(OpTimeWithTermOne(100, 0));
+    getReplCoord()->setMyLastDurableOpTime(OpTimeWithTermOne(100, 0));
+    simulateSuccessfulV1Election();
+
+    OpTimeWithTermOne time1(100, 1);
+    OpTimeWithTermOne time2(100, 2);
+
+    WriteConcernOptions writeConcern;
+    writeConcern.wTimeout = WriteConcernOptions::kNoTimeout;
+    writeConcern.wNumNodes = 2;
+
+    // An op time this node has not applied yet needs to wait for a secondary.
+    getReplCoord()->setMyLastAppliedOpTime(time2);
+    getReplCoord()->setMyLastDurableOpTime(time2);
+    stdx::promise<Status> promise;
+    auto future = promise.get_future();
+    getReplCoord()->awaitReplicationAsync(time2, writeConcern, makeCompletionFn(&promise));
+    ASSERT(stdx::future_status::timeout == future.wait_for(stdx::chrono::milliseconds(0)));
+
+    ASSERT_OK(getReplCoord()->setLastAppliedOptime_forTest(2, 1, time1));
+    ASSERT(stdx::future_status::timeout == future.wait_for(stdx::chrono::milliseconds(10)));
+    ASSERT_OK(getReplCoord()->setLastAppliedOptime_forTest(2, 1, time2));
+    ASSERT_OK(future.get());
+
+    // A write concern which is already satisfied completes right away.
+    stdx::promise<Status> satisfiedPromise;
+    auto satisfiedFuture = satisfiedPromise.get_future();
+    getReplCoord()->awaitReplicationAsync(time1, writeConcern, makeCompletionFn(&satisfiedPromise));
+    ASSERT(stdx::future_status::ready ==
+           satisfiedFuture.wait_for(stdx::chrono::milliseconds(0)));
+    ASSERT_OK(satisfiedFuture.get());
+}
+
+TEST_F(ReplCoordTest, AsyncAwaitReplicationReturnsWriteConcernFailedOnTimeout) {
+    assertStartSuccess(BSON("_id"
+                            << "mySet"
+                            << "version"
+                            << 2
+                            << "members"
+                            << BSON_ARRAY(BSON("host"
+                                               << "node1:12345"
+                                               << "_id"
+                                               << 0)
+                                          << BSON("host"
+                                                  << "node2:12345"
+                                                  << "_id"
+                                                  << 1)
+                                          << BSON("host"
+                                                  << "node3:12345"
+                                                  << "_id"
+                                                  << 2))),
+                       HostAndPort("node1", 12345));
+    ASSERT(getReplCoord()->setFollowerMode(MemberState::RS_SECONDARY));
+    getReplCoord()->setMyLastAppliedOpTime(OpTimeWithTermOne(100, 0));
+    getReplCoord()->setMyLastDurableOpTime(OpTimeWithTermOne(100, 0));
+    simulateSuccessfulV1Election();
+
+    OpTimeWithTermOne time1(100, 1);
+    OpTimeWithTermOne time2(100, 2);
+
+    WriteConcernOptions writeConcern;
+    writeConcern.wDeadline = getNet()->now() + Milliseconds(50);
+    writeConcern.wNumNodes = 2;
+
+    getReplCoord()->setMyLastAppliedOpTime(time2);
+    getReplCoord()->setMyLastDurableOpTime(time2);
+    stdx::promise<Status> promise;
+    auto future = promise.get_future();
+    getReplCoord()->awaitReplicationAsync(time2, writeConcern, makeCompletionFn(&promise));
+    ASSERT_OK(getReplCoord()->setLastAppliedOptime_forTest(2, 1, time1));
+    {
+        NetworkInterfaceMock::InNetworkGuard inNet(getNet());
+        getNet()->runUntil(writeConcern.wDeadline);
+        ASSERT_EQUALS(writeConcern.wDeadline, getNet()->now());
+    }
+    ASSERT_EQUALS(ErrorCodes::WriteConcernFailed, future.get());
+}
+
+TEST_F(ReplCoordTest, AsyncAwaitReplicationReturnsPrimarySteppedDownOnStepDown) {
+    assertStartSuccess(BSON("_id"
+                            << "mySet"
+                            << "version"
+                            << 2
+                            << "members"
+                            << BSON_ARRAY(BSON("host"
+                                               << "node1:12345"
+                                               << "_id"
+                                               << 0)
+                                          << BSON("host"
+                                                  << "node2:12345"
+                                                  << "_id"
+                                                  << 1)
+                                          << BSON("host"
+                                                  << "node3:12345"
+                                                  << "_id"
+                                                  << 2))),
+                       HostAndPort("node1", 12345));
+    ASSERT(getReplCoord()->setFollowerMode(MemberState::RS_SECONDARY));
+    getReplCoord()->setMyLastAppliedOpTime(OpTimeWithTermOne(100, 0));
+    getReplCoord()->setMyLastDurableOpTime(OpTimeWithTermOne(100, 0));
+    simulateSuccessfulV1Election();
+
+    const auto opCtx = makeOperationContext();
+
+    OpTimeWithTermOne time1(100, 1);
+    OpTimeWithTermOne time2(100, 2);
+
+    WriteConcernOptions writeConcern;
+    writeConcern.wTimeout = WriteConcernOptions::kNoTimeout;
+    writeConcern.wNumNodes = 2;
+
+    stdx::promise<Status> promise;
+    auto future = promise.get_future();
+    getReplCoord()->awaitReplicationAsync(time2, writeConcern, makeCompletionFn(&promise));
+    ASSERT_OK(getReplCoord()->setLastAppliedOptime_forTest(2, 1, time1));
+    ASSERT_OK(getReplCoord()->setLastAppliedOptime_forTest(2, 2, time1));
+    ASSERT_OK(getReplCoord()->stepDown(opCtx.get(), true, Milliseconds(0), Milliseconds(1000)));
+    ASSERT_EQUALS(ErrorCodes::PrimarySteppedDown, future.get());
+}
+
 class StepDownTest : public ReplCoordTest {
 protected:
     struct SharedClientAndOperation {
@@ -123,6 +123,12 @@ ReplicationCoordinatorMock::awaitReplicationOfLastOpForClient(
     return StatusAndDuration(Status::OK(), Milliseconds(0));
 }
 
+void ReplicationCoordinatorMock::awaitReplicationAsync(const OpTime& opTime,
+                                                       const WriteConcernOptions& writeConcern,
+                                                       ReplicationCompletionFn onCompletion) {
+    onCompletion(Status::OK());
+}
+
 Status ReplicationCoordinatorMock::stepDown(OperationContext* opCtx,
                                             bool force,
                                             const Milliseconds& waitTime,
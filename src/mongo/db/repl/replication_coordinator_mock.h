@@ -87,6 +87,10 @@ public:
     virtual ReplicationCoordinator::StatusAndDuration awaitReplicationOfLastOpForClient(
         OperationContext* opCtx, const WriteConcernOptions& writeConcern);
 
+    virtual void awaitReplicationAsync(const OpTime& opTime,
+                                       const WriteConcernOptions& writeConcern,
+                                       ReplicationCompletionFn onCompletion);
+
     virtual Status stepDown(OperationContext* opCtx,
                             bool force,
                             const Milliseconds& waitTime,
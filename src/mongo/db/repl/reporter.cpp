@@ -94,11 +94,13 @@ bool _isTargetConfigNewerThanRequest(
 Reporter::Reporter(executor::TaskExecutor* executor,
                    PrepareReplSetUpdatePositionCommandFn prepareReplSetUpdatePositionCommandFn,
                    const HostAndPort& target,
-                   Milliseconds keepAliveInterval)
+                   Milliseconds keepAliveInterval,
+                   Milliseconds coalesceInterval)
     : _executor(executor),
       _prepareReplSetUpdatePositionCommandFn(prepareReplSetUpdatePositionCommandFn),
       _target(target),
-      _keepAliveInterval(keepAliveInterval) {
+      _keepAliveInterval(keepAliveInterval),
+      _coalesceInterval(coalesceInterval) {
     uassert(ErrorCodes::BadValue, "null task executor", executor);
     uassert(ErrorCodes::BadValue,
             "null function to create replSetUpdatePosition command object",
@@ -107,6 +109,9 @@ Reporter::Reporter(executor::TaskExecutor* executor,
     uassert(ErrorCodes::BadValue,
             "keep alive interval must be positive",
             keepAliveInterval > Milliseconds(0));
+    uassert(ErrorCodes::BadValue,
+            "coalesce interval cannot be negative",
+            coalesceInterval >= Milliseconds(0));
 }
 
 Reporter::~Reporter() {
@@ -127,6 +132,11 @@ Milliseconds Reporter::getKeepAliveInterval() const {
     return _keepAliveInterval;
 }
 
+Milliseconds Reporter::getCoalesceInterval() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _coalesceInterval;
+}
+
 void Reporter::shutdown() {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
 
@@ -171,6 +181,8 @@ Status Reporter::trigger() {
         _keepAliveTimeoutWhen = Date_t();
         _executor->cancel(_prepareAndSendCommandCallbackHandle);
         return Status::OK();
+    } else if (_isCoalescing) {
+        return Status::OK();
     } else if (_isActive_inlock()) {
         _isWaitingToSendReporter = true;
         return Status::OK();
@@ -242,6 +254,7 @@ void Reporter::_sendCommand_inlock(BSONObj commandRequest) {
     }
 
     _remoteCommandCallbackHandle = scheduleResult.getValue();
+    _lastSentWhen = _executor->now();
 }
 
 void Reporter::_processResponseCallback(
@@ -346,15 +359,40 @@ void Reporter::_prepareAndSendCommandCallback(const executor::TaskExecutor::Call
         _status = args.status;
 
         // Ignore CallbackCanceled status if keep alive was canceled by triggered.
+        bool canceledByTrigger = false;
         if (!fromTrigger && _status == ErrorCodes::CallbackCanceled &&
             _keepAliveTimeoutWhen == Date_t()) {
             _status = Status::OK();
+            canceledByTrigger = true;
         }
 
         if (!_status.isOK()) {
             _onShutdown_inlock();
             return;
         }
+
+        _isCoalescing = false;
+
+        // If the previous command went out very recently, hold this update back until the
+        // coalesce interval has elapsed so that a burst of triggers is sent as one command.
+        auto coalesceUntil = _lastSentWhen + _coalesceInterval;
+        if (canceledByTrigger && _executor->now() < coalesceUntil) {
+            auto scheduleResult = _executor->scheduleWorkAt(
+                coalesceUntil,
+                stdx::bind(
+                    &Reporter::_prepareAndSendCommandCallback, this, stdx::placeholders::_1, true));
+
+            _status = scheduleResult.getStatus();
+            if (!_status.isOK()) {
+                _onShutdown_inlock();
+                return;
+            }
+
+            _prepareAndSendCommandCallbackHandle = scheduleResult.getValue();
+            _isCoalescing = true;
+            _isWaitingToSendReporter = false;
+            return;
+        }
     }
 
     // Must call without holding the lock.
@@ -379,6 +417,7 @@ void Reporter::_prepareAndSendCommandCallback(const executor::TaskExecutor::Call
 
 void Reporter::_onShutdown_inlock() {
     _isWaitingToSendReporter = false;
+    _isCoalescing = false;
     _remoteCommandCallbackHandle = executor::TaskExecutor::CallbackHandle();
     _prepareAndSendCommandCallbackHandle = executor::TaskExecutor::CallbackHandle();
     _keepAliveTimeoutWhen = Date_t();
@@ -60,6 +60,10 @@ namespace repl {
  *
  * Calling trigger() while it is in state 3 sends a command upstream and cancels the current
  * keep alive timeout, resetting the keep alive schedule.
+ *
+ * If "coalesceInterval" is positive, a trigger() that arrives in state 3 less than
+ * "coalesceInterval" ms after the previous command was sent is deferred until that interval has
+ * elapsed, so that a burst of progress updates is folded into a single command.
  */
 class Reporter {
     MONGO_DISALLOW_COPYING(Reporter);
@@ -77,7 +81,8 @@ public:
     Reporter(executor::TaskExecutor* executor,
              PrepareReplSetUpdatePositionCommandFn prepareReplSetUpdatePositionCommandFn,
              const HostAndPort& target,
-             Milliseconds keepAliveInterval);
+             Milliseconds keepAliveInterval,
+             Milliseconds coalesceInterval = Milliseconds(0));
 
     virtual ~Reporter();
 
@@ -98,6 +103,11 @@ public:
      */
     Milliseconds getKeepAliveInterval() const;
 
+    /**
+     * Returns the minimum gap between a sent command and a triggered one.
+     */
+    Milliseconds getCoalesceInterval() const;
+
     /**
      * Returns true if a remote command has been scheduled (but not completed)
      * with the executor.
@@ -180,6 +190,9 @@ private:
     // encounters an error.
     const Milliseconds _keepAliveInterval;
 
+    // Triggered updates are not sent sooner than "_coalesceInterval" ms after the previous command.
+    const Milliseconds _coalesceInterval;
+
     // Protects member data of this Reporter declared below.
     mutable stdx::mutex _mutex;
 
@@ -206,6 +219,13 @@ private:
     // If this date is Date_t(), the callback is either unscheduled or canceled.
     // Used for testing only.
     Date_t _keepAliveTimeoutWhen;
+
+    // Time at which the most recent remote command was scheduled.
+    Date_t _lastSentWhen;
+
+    // True while a triggered update is held back by the coalesce interval. Further triggers are
+    // no-ops because the pending command will pick up their progress when it is prepared.
+    bool _isCoalescing = false;
 };
 
 }  // namespace repl
@@ -285,6 +285,15 @@ TEST_F(ReporterTestNoTriggerAtSetUp, InvalidConstruction) {
             &getExecutor(), prepareReplSetUpdatePositionCommandFn, HostAndPort("h1"), Seconds(-1)),
         UserException,
         "keep alive interval must be positive");
+
+    // negative coalesce interval.
+    ASSERT_THROWS_WHAT(Reporter(&getExecutor(),
+                                prepareReplSetUpdatePositionCommandFn,
+                                HostAndPort("h1"),
+                                Seconds(1),
+                                Milliseconds(-1)),
+                       UserException,
+                       "coalesce interval cannot be negative");
 }
 
 TEST_F(ReporterTestNoTriggerAtSetUp, GetTarget) {
@@ -752,4 +761,37 @@ TEST_F(ReporterTest, ShutdownImmediatelyAfterTriggerWhileKeepAliveTimeoutIsSched
     assertReporterDone();
 }
 
+TEST_F(ReporterTestNoTriggerAtSetUp,
+       TriggersSoonAfterPreviousCommandShouldBeSentAsOneUpdateAfterCoalesceInterval) {
+    Reporter coalescingReporter(&getExecutor(),
+                                prepareReplSetUpdatePositionCommandFn,
+                                HostAndPort("h1"),
+                                Milliseconds(1000),
+                                Milliseconds(100));
+    ASSERT_OK(coalescingReporter.trigger());
+    auto sentWhen = getExecutor().now();
+    processNetworkResponse(BSON("ok" << 1));
+
+    ASSERT_EQUALS(sentWhen + coalescingReporter.getKeepAliveInterval(),
+                  coalescingReporter.getKeepAliveTimeoutWhen_forTest());
+
+    // Both triggers fall inside the coalesce interval and should produce a single command.
+    ASSERT_OK(coalescingReporter.trigger());
+    ASSERT_OK(coalescingReporter.trigger());
+    ASSERT_TRUE(coalescingReporter.isActive());
+
+    auto net = getNet();
+    net->enterNetwork();
+    ASSERT_FALSE(net->hasReadyRequests());
+    net->exitNetwork();
+
+    runUntil(sentWhen + coalescingReporter.getCoalesceInterval(), true);
+    processNetworkResponse(BSON("ok" << 1));
+    ASSERT_FALSE(coalescingReporter.isWaitingToSendReport());
+
+    coalescingReporter.shutdown();
+    ASSERT_EQUALS(ErrorCodes::CallbackCanceled, coalescingReporter.join());
+    ASSERT_FALSE(coalescingReporter.isActive());
+}
+
 }  // namespace
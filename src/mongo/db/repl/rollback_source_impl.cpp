@@ -68,6 +68,28 @@ BSONObj RollbackSourceImpl::findOne(const NamespaceString& nss, const BSONObj& f
     return _getConnection()->findOne(nss.toString(), filter, NULL, QueryOption_SlaveOk).getOwned();
 }
 
+std::vector<BSONObj> RollbackSourceImpl::findByIds(const NamespaceString& nss,
+                                                   const std::vector<BSONElement>& ids) const {
+    BSONObjBuilder filter;
+    {
+        BSONObjBuilder idBuilder(filter.subobjStart("_id"));
+        BSONArrayBuilder inBuilder(idBuilder.subarrayStart("$in"));
+        for (const auto& id : ids) {
+            inBuilder.append(id);
+        }
+    }
+
+    auto cursor =
+        _getConnection()->query(nss.toString(), filter.obj(), 0, 0, nullptr, QueryOption_SlaveOk);
+    uassert(40648, str::stream() << "failed to query " << nss.ns() << " on " << _source, cursor);
+
+    std::vector<BSONObj> docs;
+    while (cursor->more()) {
+        docs.push_back(cursor->nextSafe().getOwned());
+    }
+    return docs;
+}
+
 void RollbackSourceImpl::copyCollectionFromRemote(OperationContext* opCtx,
                                                   const NamespaceString& nss) const {
     std::string errmsg;
@@ -64,6 +64,9 @@ public:
 
     BSONObj findOne(const NamespaceString& nss, const BSONObj& filter) const override;
 
+    std::vector<BSONObj> findByIds(const NamespaceString& nss,
+                                   const std::vector<BSONElement>& ids) const override;
+
     void copyCollectionFromRemote(OperationContext* opCtx,
                                   const NamespaceString& nss) const override;
 
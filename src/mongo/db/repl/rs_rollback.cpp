@@ -34,12 +34,14 @@
 #include "mongo/db/repl/rs_rollback.h"
 
 #include <algorithm>
+#include <exception>
 #include <memory>
 
 #include "mongo/bson/bsonelement_comparator.h"
 #include "mongo/bson/util/bson_extract.h"
 #include "mongo/db/auth/authorization_manager.h"
 #include "mongo/db/auth/authorization_manager_global.h"
+#include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/collection_catalog_entry.h"
 #include "mongo/db/catalog/document_validation.h"
@@ -54,6 +56,7 @@
 #include "mongo/db/ops/update_lifecycle_impl.h"
 #include "mongo/db/ops/update_request.h"
 #include "mongo/db/query/internal_plans.h"
+#include "mongo/db/query/query_result_cache.h"
 #include "mongo/db/repl/bgsync.h"
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/oplog_interface.h"
@@ -64,6 +67,10 @@
 #include "mongo/db/repl/rollback_source.h"
 #include "mongo/db/repl/rslog.h"
 #include "mongo/db/s/shard_identity_rollback_notifier.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/old_thread_pool.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
@@ -125,6 +132,21 @@ namespace repl {
 MONGO_FP_DECLARE(rollbackHangBeforeFinish);
 MONGO_FP_DECLARE(rollbackHangThenFailAfterWritingMinValid);
 
+// The number of threads restoring refetched documents, each working on a different collection.
+MONGO_EXPORT_SERVER_PARAMETER(rollbackRestoreThreadCount, int, 4);
+
+namespace {
+
+// The most documents refetched from the sync source in a single query, and the most bytes of
+// their _ids, which keeps the query well below the maximum BSON size.
+const size_t kRefetchBatchSize = 1000;
+const int kRefetchBatchMaxIdBytes = 4 * 1024 * 1024;
+
+// How often rollback reports its progress refetching and restoring documents.
+const time_t kProgressUpdateGapSecs = 10;
+
+}  // namespace
+
 using namespace rollback_internal;
 
 bool DocID::operator<(const DocID& other) const {
@@ -375,6 +397,168 @@ void checkRbidAndUpdateMinValid(OperationContext* opCtx,
     }
 }
 
+/**
+ * Counts the documents restored by rollback, and periodically reports how far along it is.
+ * Shared by all the threads restoring documents.
+ */
+class RestoreProgress {
+public:
+    explicit RestoreProgress(size_t total) : _total(total), _lastUpdate(time(0)) {}
+
+    void report() {
+        time_t now = time(0);
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (now - _lastUpdate > kProgressUpdateGapSecs) {
+            log() << deletes.load() << " delete and " << updates.load()
+                  << " update operations processed out of " << _total << " total operations";
+            _lastUpdate = now;
+        }
+    }
+
+    AtomicUInt32 deletes;
+    AtomicUInt32 updates;
+
+private:
+    const size_t _total;
+
+    stdx::mutex _mutex;
+    time_t _lastUpdate;
+};
+
+/**
+ * Replaces the documents of 'ns' in 'goodVersionsByDocID' with their versions refetched from the
+ * sync source, deleting those which were not found there.
+ */
+void restoreDocuments(OperationContext* opCtx,
+                      const FixUpInfo& fixUpInfo,
+                      const std::string& ns,
+                      const map<DocID, BSONObj>& goodVersionsByDocID,
+                      RestoreProgress* progress) {
+    // Keep an archive of items rolled back if the collection has not been dropped
+    // while rolling back createCollection operations.
+    unique_ptr<Helpers::RemoveSaver> removeSaver;
+    removeSaver.reset(new Helpers::RemoveSaver("rollback", "", ns));
+
+    invariant(!fixUpInfo.collectionsToResyncData.count(ns));
+    const NamespaceString docNss(ns);
+    Lock::DBLock docDbLock(opCtx, docNss.db(), MODE_X);
+    OldClientContext ctx(opCtx, ns);
+
+    for (const auto& idAndDoc : goodVersionsByDocID) {
+        progress->report();
+        const DocID& doc = idAndDoc.first;
+        BSONObj pattern = doc._id.wrap();  // { _id : ... }
+        try {
+            verify(doc.ns && *doc.ns);
+
+            // An upsert below may have created the collection, so look it up for each document.
+            Collection* collection = ctx.db()->getCollection(opCtx, docNss);
+
+            // Add the doc to our rollback file if the collection was not dropped while
+            // rolling back createCollection operations.
+            // Do not log an error when undoing an insert on a no longer existent
+            // collection.
+            // It is likely that the collection was dropped as part of rolling back a
+            // createCollection command and regardless, the document no longer exists.
+            if (collection && removeSaver) {
+                BSONObj obj;
+                bool found = Helpers::findOne(opCtx, collection, pattern, obj, false);
+                if (found) {
+                    auto status = removeSaver->goingToDelete(obj);
+                    if (!status.isOK()) {
+                        severe() << "rollback cannot write document in namespace " << doc.ns
+                                 << " to archive file: " << redact(status);
+                        throw RSFatalException();
+                    }
+                } else {
+                    error() << "rollback cannot find object: " << pattern << " in namespace "
+                            << doc.ns;
+                }
+            }
+
+            if (idAndDoc.second.isEmpty()) {
+                // wasn't on the primary; delete.
+                // TODO 1.6 : can't delete from a capped collection.  need to handle that
+                // here.
+                progress->deletes.fetchAndAdd(1);
+
+                if (collection) {
+                    if (collection->isCapped()) {
+                        // can't delete from a capped collection - so we truncate instead.
+                        // if
+                        // this item must go, so must all successors!!!
+                        try {
+                            // TODO: IIRC cappedTruncateAfter does not handle completely
+                            // empty.
+                            // this will crazy slow if no _id index.
+                            const auto clock = opCtx->getServiceContext()->getFastClockSource();
+                            const auto findOneStart = clock->now();
+                            RecordId loc = Helpers::findOne(opCtx, collection, pattern, false);
+                            if (clock->now() - findOneStart > Milliseconds(200))
+                                warning() << "roll back slow no _id index for " << doc.ns
+                                          << " perhaps?";
+                            // would be faster but requires index:
+                            // RecordId loc = Helpers::findById(nsd, pattern);
+                            if (!loc.isNull()) {
+                                try {
+                                    collection->cappedTruncateAfter(opCtx, loc, true);
+                                } catch (const DBException& e) {
+                                    if (e.getCode() == 13415) {
+                                        // hack: need to just make cappedTruncate do this...
+                                        MONGO_WRITE_CONFLICT_RETRY_LOOP_BEGIN {
+                                            WriteUnitOfWork wunit(opCtx);
+                                            uassertStatusOK(collection->truncate(opCtx));
+                                            wunit.commit();
+                                        }
+                                        MONGO_WRITE_CONFLICT_RETRY_LOOP_END(
+                                            opCtx, "truncate", collection->ns().ns());
+                                    } else {
+                                        throw e;
+                                    }
+                                }
+                            }
+                        } catch (const DBException& e) {
+                            // Replicated capped collections have many ways to become
+                            // inconsistent. We rely on age-out to make these problems go away
+                            // eventually.
+                            warning() << "ignoring failure to roll back change to capped "
+                                      << "collection " << doc.ns << " with _id "
+                                      << redact(idAndDoc.first._id.toString(
+                                             /*includeFieldName*/ false))
+                                      << ": " << redact(e);
+                        }
+                    } else {
+                        deleteObjects(opCtx,
+                                      collection,
+                                      docNss,
+                                      pattern,
+                                      true,   // justone
+                                      true);  // god
+                    }
+                }
+            } else {
+                // TODO faster...
+                progress->updates.fetchAndAdd(1);
+
+                UpdateRequest request(docNss);
+
+                request.setQuery(pattern);
+                request.setUpdates(idAndDoc.second);
+                request.setGod();
+                request.setUpsert();
+                UpdateLifecycleImpl updateLifecycle(docNss);
+                request.setLifecycle(&updateLifecycle);
+
+                update(opCtx, ctx.db(), request);
+            }
+        } catch (const DBException& e) {
+            log() << "exception in rollback ns:" << doc.ns << ' ' << pattern.toString() << ' '
+                  << redact(e) << " ndeletes:" << progress->deletes.load();
+            throw;
+        }
+    }
+}
+
 void syncFixUp(OperationContext* opCtx,
                const FixUpInfo& fixUpInfo,
                const RollbackSource& rollbackSource,
@@ -387,34 +571,72 @@ void syncFixUp(OperationContext* opCtx,
     // namespace -> doc id -> doc
     map<string, map<DocID, BSONObj>> goodVersions;
 
-    // fetch all the goodVersions of each document from current primary
+    // fetch all the goodVersions of each document from current primary, a batch of each
+    // collection's documents at a time
     unsigned long long numFetched = 0;
-    for (auto&& doc : fixUpInfo.docsToRefetch) {
-        invariant(!doc._id.eoo());  // This is checked when we insert to the set.
-
+    time_t lastProgressUpdate = time(0);
+    auto docIt = fixUpInfo.docsToRefetch.begin();
+    while (docIt != fixUpInfo.docsToRefetch.end()) {
+        const char* const ns = docIt->ns;
+        const auto batchBegin = docIt;
+        std::vector<BSONElement> ids;
+        int idBytes = 0;
+        do {
+            invariant(!docIt->_id.eoo());  // This is checked when we insert to the set.
+            ids.push_back(docIt->_id);
+            idBytes += docIt->_id.size();
+            ++docIt;
+        } while (docIt != fixUpInfo.docsToRefetch.end() && strcmp(docIt->ns, ns) == 0 &&
+                 ids.size() < kRefetchBatchSize && idBytes < kRefetchBatchMaxIdBytes);
+
+        auto& goodVersionsByDocID = goodVersions[ns];
         try {
-            // TODO : slow.  lots of round trips.
-            numFetched++;
-            BSONObj good = rollbackSource.findOne(NamespaceString(doc.ns), doc._id.wrap());
-            totalSize += good.objsize();
-            if (totalSize >= 300 * 1024 * 1024) {
-                throw RSFatalException("replSet too much data to roll back");
+            // Documents which are not on the sync source stay empty, indicating we should delete
+            // them.
+            for (auto it = batchBegin; it != docIt; ++it) {
+                goodVersionsByDocID[*it] = BSONObj();
             }
 
-            // Note good might be empty, indicating we should delete it.
-            goodVersions[doc.ns][doc] = good;
+            for (auto&& good : rollbackSource.findByIds(NamespaceString(ns), ids)) {
+                // A collation on the sync source may match documents we did not ask for.
+                auto it = goodVersionsByDocID.find(DocID{good, ns, good["_id"]});
+                if (it == goodVersionsByDocID.end()) {
+                    continue;
+                }
+
+                totalSize += good.objsize();
+                if (totalSize >= 300 * 1024 * 1024) {
+                    throw RSFatalException("replSet too much data to roll back");
+                }
+                it->second = good;
+            }
+            numFetched += ids.size();
         } catch (const DBException& ex) {
             // If the collection turned into a view, we might get an error trying to
             // refetch documents, but these errors should be ignored, as we'll be creating
             // the view during oplog replay.
-            if (ex.getCode() == ErrorCodes::CommandNotSupportedOnView)
+            if (ex.getCode() == ErrorCodes::CommandNotSupportedOnView) {
+                for (auto it = batchBegin; it != docIt; ++it) {
+                    goodVersionsByDocID.erase(*it);
+                }
+                if (goodVersionsByDocID.empty()) {
+                    goodVersions.erase(ns);
+                }
                 continue;
+            }
 
-            log() << "rollback couldn't re-get from ns: " << doc.ns << " _id: " << redact(doc._id)
+            log() << "rollback couldn't re-get " << ids.size() << " documents from ns: " << ns
                   << ' ' << numFetched << '/' << fixUpInfo.docsToRefetch.size() << ": "
                   << redact(ex);
             throw;
         }
+
+        time_t now = time(0);
+        if (now - lastProgressUpdate > kProgressUpdateGapSecs) {
+            log() << "rollback refetched " << numFetched << " of "
+                  << fixUpInfo.docsToRefetch.size() << " documents";
+            lastProgressUpdate = now;
+        }
     }
 
     log() << "rollback 3.5";
@@ -609,144 +831,63 @@ void syncFixUp(OperationContext* opCtx,
     }
 
     log() << "rollback 4.7";
-    unsigned deletes = 0, updates = 0;
-    time_t lastProgressUpdate = time(0);
-    time_t progressUpdateGap = 10;
+    size_t numDocsToRestore = 0;
     for (const auto& nsAndGoodVersionsByDocID : goodVersions) {
-        // Keep an archive of items rolled back if the collection has not been dropped
-        // while rolling back createCollection operations.
-        const auto& ns = nsAndGoodVersionsByDocID.first;
-        unique_ptr<Helpers::RemoveSaver> removeSaver;
-        invariant(!fixUpInfo.collectionsToDrop.count(ns));
-        removeSaver.reset(new Helpers::RemoveSaver("rollback", "", ns));
-
-        const auto& goodVersionsByDocID = nsAndGoodVersionsByDocID.second;
-        for (const auto& idAndDoc : goodVersionsByDocID) {
-            time_t now = time(0);
-            if (now - lastProgressUpdate > progressUpdateGap) {
-                log() << deletes << " delete and " << updates
-                      << " update operations processed out of " << goodVersions.size()
-                      << " total operations";
-                lastProgressUpdate = now;
-            }
-            const DocID& doc = idAndDoc.first;
-            BSONObj pattern = doc._id.wrap();  // { _id : ... }
-            try {
-                verify(doc.ns && *doc.ns);
-                invariant(!fixUpInfo.collectionsToResyncData.count(doc.ns));
-
-                // TODO: Lots of overhead in context. This can be faster.
-                const NamespaceString docNss(doc.ns);
-                Lock::DBLock docDbLock(opCtx, docNss.db(), MODE_X);
-                OldClientContext ctx(opCtx, doc.ns);
-
-                Collection* collection = ctx.db()->getCollection(opCtx, docNss);
-
-                // Add the doc to our rollback file if the collection was not dropped while
-                // rolling back createCollection operations.
-                // Do not log an error when undoing an insert on a no longer existent
-                // collection.
-                // It is likely that the collection was dropped as part of rolling back a
-                // createCollection command and regardless, the document no longer exists.
-                if (collection && removeSaver) {
-                    BSONObj obj;
-                    bool found = Helpers::findOne(opCtx, collection, pattern, obj, false);
-                    if (found) {
-                        auto status = removeSaver->goingToDelete(obj);
-                        if (!status.isOK()) {
-                            severe() << "rollback cannot write document in namespace " << doc.ns
-                                     << " to archive file: " << redact(status);
-                            throw RSFatalException();
-                        }
-                    } else {
-                        error() << "rollback cannot find object: " << pattern << " in namespace "
-                                << doc.ns;
+        invariant(!fixUpInfo.collectionsToDrop.count(nsAndGoodVersionsByDocID.first));
+        numDocsToRestore += nsAndGoodVersionsByDocID.second.size();
+    }
+    RestoreProgress progress(numDocsToRestore);
+
+    // Collections are independent of each other, so restore several at once.
+    const size_t numThreads =
+        std::min(goodVersions.size(), size_t(std::max(rollbackRestoreThreadCount.load(), 1)));
+    if (numThreads <= 1) {
+        for (const auto& nsAndGoodVersionsByDocID : goodVersions) {
+            restoreDocuments(opCtx,
+                             fixUpInfo,
+                             nsAndGoodVersionsByDocID.first,
+                             nsAndGoodVersionsByDocID.second,
+                             &progress);
+        }
+    } else {
+        OldThreadPool restorePool(numThreads, "rollback restore worker ");
+        stdx::mutex errorMutex;
+        std::exception_ptr firstError;
+        for (const auto& nsAndGoodVersionsByDocID : goodVersions) {
+            const auto* nsAndDocs = &nsAndGoodVersionsByDocID;
+            restorePool.schedule([&, nsAndDocs] {
+                {
+                    stdx::lock_guard<stdx::mutex> lk(errorMutex);
+                    if (firstError) {
+                        return;
                     }
                 }
 
-                if (idAndDoc.second.isEmpty()) {
-                    // wasn't on the primary; delete.
-                    // TODO 1.6 : can't delete from a capped collection.  need to handle that
-                    // here.
-                    deletes++;
-
-                    if (collection) {
-                        if (collection->isCapped()) {
-                            // can't delete from a capped collection - so we truncate instead.
-                            // if
-                            // this item must go, so must all successors!!!
-                            try {
-                                // TODO: IIRC cappedTruncateAfter does not handle completely
-                                // empty.
-                                // this will crazy slow if no _id index.
-                                const auto clock = opCtx->getServiceContext()->getFastClockSource();
-                                const auto findOneStart = clock->now();
-                                RecordId loc = Helpers::findOne(opCtx, collection, pattern, false);
-                                if (clock->now() - findOneStart > Milliseconds(200))
-                                    warning() << "roll back slow no _id index for " << doc.ns
-                                              << " perhaps?";
-                                // would be faster but requires index:
-                                // RecordId loc = Helpers::findById(nsd, pattern);
-                                if (!loc.isNull()) {
-                                    try {
-                                        collection->cappedTruncateAfter(opCtx, loc, true);
-                                    } catch (const DBException& e) {
-                                        if (e.getCode() == 13415) {
-                                            // hack: need to just make cappedTruncate do this...
-                                            MONGO_WRITE_CONFLICT_RETRY_LOOP_BEGIN {
-                                                WriteUnitOfWork wunit(opCtx);
-                                                uassertStatusOK(collection->truncate(opCtx));
-                                                wunit.commit();
-                                            }
-                                            MONGO_WRITE_CONFLICT_RETRY_LOOP_END(
-                                                opCtx, "truncate", collection->ns().ns());
-                                        } else {
-                                            throw e;
-                                        }
-                                    }
-                                }
-                            } catch (const DBException& e) {
-                                // Replicated capped collections have many ways to become
-                                // inconsistent. We rely on age-out to make these problems go away
-                                // eventually.
-                                warning() << "ignoring failure to roll back change to capped "
-                                          << "collection " << doc.ns << " with _id "
-                                          << redact(idAndDoc.first._id.toString(
-                                                 /*includeFieldName*/ false))
-                                          << ": " << redact(e);
-                            }
-                        } else {
-                            deleteObjects(opCtx,
-                                          collection,
-                                          docNss,
-                                          pattern,
-                                          true,   // justone
-                                          true);  // god
-                        }
+                try {
+                    Client::initThreadIfNotAlready();
+                    AuthorizationSession::get(cc())->grantInternalAuthorization();
+                    const auto workerOpCtxHolder = cc().makeOperationContext();
+                    const auto workerOpCtx = workerOpCtxHolder.get();
+                    DisableDocumentValidation validationDisabler(workerOpCtx);
+                    UnreplicatedWritesBlock replicationDisabler(workerOpCtx);
+                    restoreDocuments(
+                        workerOpCtx, fixUpInfo, nsAndDocs->first, nsAndDocs->second, &progress);
+                } catch (...) {
+                    stdx::lock_guard<stdx::mutex> lk(errorMutex);
+                    if (!firstError) {
+                        firstError = std::current_exception();
                     }
-                } else {
-                    // TODO faster...
-                    updates++;
-
-                    UpdateRequest request(docNss);
-
-                    request.setQuery(pattern);
-                    request.setUpdates(idAndDoc.second);
-                    request.setGod();
-                    request.setUpsert();
-                    UpdateLifecycleImpl updateLifecycle(docNss);
-                    request.setLifecycle(&updateLifecycle);
-
-                    update(opCtx, ctx.db(), request);
                 }
-            } catch (const DBException& e) {
-                log() << "exception in rollback ns:" << doc.ns << ' ' << pattern.toString() << ' '
-                      << redact(e) << " ndeletes:" << deletes;
-                throw;
-            }
+            });
+        }
+        restorePool.join();
+        if (firstError) {
+            std::rethrow_exception(firstError);
         }
     }
 
+    const unsigned deletes = progress.deletes.load();
+    const unsigned updates = progress.updates.load();
     log() << "rollback 5 d:" << deletes << " u:" << updates;
     log() << "rollback 6";
 
@@ -866,6 +1007,10 @@ Status syncRollback(OperationContext* opCtx,
     Status status = _syncRollback(
         opCtx, localOplog, rollbackSource, requiredRBID, replCoord, replicationProcess);
 
+    // Rollback truncates collections and refetches documents without always going through the
+    // OpObserver, so none of the cached query results can be trusted anymore.
+    QueryResultCache::get(opCtx).invalidateAll();
+
     log() << "rollback finished" << rsLog;
     return status;
 }
@@ -70,6 +70,8 @@ public:
     const OplogInterface& getOplog() const override;
     BSONObj getLastOperation() const override;
     BSONObj findOne(const NamespaceString& nss, const BSONObj& filter) const override;
+    std::vector<BSONObj> findByIds(const NamespaceString& nss,
+                                   const std::vector<BSONElement>& ids) const override;
     void copyCollectionFromRemote(OperationContext* opCtx,
                                   const NamespaceString& nss) const override;
     StatusWith<BSONObj> getCollectionInfo(const NamespaceString& nss) const override;
@@ -100,6 +102,19 @@ BSONObj RollbackSourceMock::findOne(const NamespaceString& nss, const BSONObj& f
     return BSONObj();
 }
 
+std::vector<BSONObj> RollbackSourceMock::findByIds(const NamespaceString& nss,
+                                                   const std::vector<BSONElement>& ids) const {
+    // Tests override findOne() to supply the sync source's documents.
+    std::vector<BSONObj> docs;
+    for (const auto& id : ids) {
+        auto doc = findOne(nss, id.wrap("_id"));
+        if (!doc.isEmpty()) {
+            docs.push_back(doc);
+        }
+    }
+    return docs;
+}
+
 void RollbackSourceMock::copyCollectionFromRemote(OperationContext* opCtx,
                                                   const NamespaceString& nss) const {}
 
@@ -1043,6 +1058,89 @@ TEST_F(RSRollbackTest, RollbackApplyOpsCommand) {
         << result;
 }
 
+TEST_F(RSRollbackTest, RollbackRefetchesDocumentsInOneBatchPerCollection) {
+    createOplog(_opCtx.get());
+    _createCollection(_opCtx.get(), "test.a", CollectionOptions());
+    _createCollection(_opCtx.get(), "other.b", CollectionOptions());
+    {
+        AutoGetCollection autoColl(_opCtx.get(), NamespaceString("test.a"), MODE_IX);
+        mongo::WriteUnitOfWork wuow(_opCtx.get());
+        OpDebug* const nullOpDebug = nullptr;
+        ASSERT_OK(autoColl.getCollection()->insertDocument(
+            _opCtx.get(), BSON("_id" << 2 << "v" << 0), nullOpDebug, false));
+        wuow.commit();
+    }
+
+    const auto commonOperation =
+        std::make_pair(BSON("ts" << Timestamp(Seconds(1), 0) << "h" << 1LL), RecordId(1));
+    auto makeOperation = [](int seconds, const char* op, const char* ns, int id) {
+        return std::make_pair(BSON("ts" << Timestamp(Seconds(seconds), 0) << "h" << 1LL << "op"
+                                        << op
+                                        << "ns"
+                                        << ns
+                                        << "o"
+                                        << BSON("_id" << id)),
+                              RecordId(seconds));
+    };
+
+    class RollbackSourceLocal : public RollbackSourceMock {
+    public:
+        RollbackSourceLocal(std::unique_ptr<OplogInterface> oplog)
+            : RollbackSourceMock(std::move(oplog)) {}
+
+        BSONObj findOne(const NamespaceString& nss, const BSONObj& filter) const override {
+            FAIL("Unexpected findOne request") << filter;
+            return {};
+        }
+
+        std::vector<BSONObj> findByIds(const NamespaceString& nss,
+                                       const std::vector<BSONElement>& ids) const override {
+            searchedNamespaces.push_back(nss.ns());
+            std::vector<BSONObj> docs;
+            for (const auto& id : ids) {
+                // Only the even documents exist on the sync source.
+                if (id.numberInt() % 2 == 0) {
+                    docs.push_back(BSON("_id" << id.numberInt() << "v" << 1));
+                }
+            }
+            return docs;
+        }
+
+        mutable std::vector<std::string> searchedNamespaces;
+    } rollbackSource(std::unique_ptr<OplogInterface>(new OplogInterfaceMock({commonOperation})));
+
+    ASSERT_OK(syncRollback(_opCtx.get(),
+                           OplogInterfaceMock({makeOperation(5, "i", "other.b", 3),
+                                               makeOperation(4, "d", "other.b", 4),
+                                               makeOperation(3, "i", "test.a", 2),
+                                               makeOperation(2, "d", "test.a", 1),
+                                               commonOperation}),
+                           rollbackSource,
+                           {},
+                           _coordinator,
+                           _replicationProcess.get()));
+    std::sort(rollbackSource.searchedNamespaces.begin(), rollbackSource.searchedNamespaces.end());
+    ASSERT_EQUALS(2U, rollbackSource.searchedNamespaces.size());
+    ASSERT_EQUALS("other.b", rollbackSource.searchedNamespaces[0]);
+    ASSERT_EQUALS("test.a", rollbackSource.searchedNamespaces[1]);
+
+    BSONObj result;
+    {
+        AutoGetCollectionForReadCommand acr(_opCtx.get(), NamespaceString("test.a"));
+        ASSERT_FALSE(Helpers::findOne(_opCtx.get(), acr.getCollection(), BSON("_id" << 1), result))
+            << result;
+        ASSERT(Helpers::findOne(_opCtx.get(), acr.getCollection(), BSON("_id" << 2), result));
+        ASSERT_EQUALS(1, result["v"].numberInt()) << result;
+    }
+    {
+        AutoGetCollectionForReadCommand acr(_opCtx.get(), NamespaceString("other.b"));
+        ASSERT_FALSE(Helpers::findOne(_opCtx.get(), acr.getCollection(), BSON("_id" << 3), result))
+            << result;
+        ASSERT(Helpers::findOne(_opCtx.get(), acr.getCollection(), BSON("_id" << 4), result));
+        ASSERT_EQUALS(1, result["v"].numberInt()) << result;
+    }
+}
+
 TEST_F(RSRollbackTest, RollbackCreateCollectionCommand) {
     createOplog(_opCtx.get());
     auto commonOperation =
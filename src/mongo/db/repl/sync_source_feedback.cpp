@@ -37,6 +37,7 @@
 #include "mongo/db/repl/repl_set_config.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/reporter.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/log.h"
@@ -49,6 +50,11 @@ namespace repl {
 
 namespace {
 
+// Minimum gap, in milliseconds, between replSetUpdatePosition commands sent in response to
+// progress. Updates arriving inside the window are folded into one command, which keeps a burst
+// of applied batches from fanning out into a command per batch at the sync source.
+MONGO_EXPORT_SERVER_PARAMETER(replUpdatePositionCoalesceMillis, int, 5);
+
 /**
  * Calculates the keep alive interval based on the current configuration in the replication
  * coordinator.
@@ -217,7 +223,8 @@ void SyncSourceFeedback::run(executor::TaskExecutor* executor, BackgroundSync* b
             executor,
             makePrepareReplSetUpdatePositionCommandFn(opCtx.get(), syncTarget, bgsync),
             syncTarget,
-            keepAliveInterval);
+            keepAliveInterval,
+            Milliseconds(std::max(0, replUpdatePositionCoalesceMillis.load())));
         {
             stdx::lock_guard<stdx::mutex> lock(_mtx);
             if (_shutdownSignaled) {
@@ -34,16 +34,20 @@
 #include "mongo/db/repl/sync_tail.h"
 
 #include "third_party/murmurhash3/MurmurHash3.h"
+#include <algorithm>
 #include <boost/functional/hash.hpp>
+#include <boost/optional.hpp>
 #include <memory>
 
 #include "mongo/base/counter.h"
 #include "mongo/bson/bsonelement_comparator.h"
+#include "mongo/bson/simple_bsonelement_comparator.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/catalog/document_validation.h"
+#include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/client.h"
 #include "mongo/db/commands/fsync.h"
 #include "mongo/db/commands/server_status_metric.h"
@@ -51,6 +55,7 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/prefetch.h"
 #include "mongo/db/query/query_knobs.h"
@@ -67,13 +72,17 @@
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/stats/timer_stats.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/unordered_map.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/net/socket_exception.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -133,6 +142,16 @@ public:
     }
 } exportedBatchLimitOperationsParam;
 
+// When a writer thread is at least this many seconds behind the primary, inserts are moved ahead of
+// unrelated ops on the same namespace so that they can be applied as grouped inserts. 0 reorders
+// every batch and -1 disables reordering.
+MONGO_EXPORT_SERVER_PARAMETER(replInsertReorderingLagThresholdSecs, int, 10);
+
+// When set, storage engines other than MMAPv1 prefetch the _id and secondary index entries of each
+// op on a separate pool while the writer threads apply the batch, so that the pages the writers
+// need are already cached by the time they get to each op.
+MONGO_EXPORT_SERVER_PARAMETER(replPrefetchAheadOfApply, bool, false);
+
 // The oplog entries applied
 Counter64 opsAppliedStats;
 ServerStatusMetricField<Counter64> displayOpsApplied("repl.apply.ops", &opsAppliedStats);
@@ -142,9 +161,56 @@ Counter64 attemptsToBecomeSecondary;
 ServerStatusMetricField<Counter64> displayAttemptsToBecomeSecondary(
     "repl.apply.attemptsToBecomeSecondary", &attemptsToBecomeSecondary);
 
+// The insert ops applied as part of a grouped insert
+Counter64 insertsCoalescedStats;
+ServerStatusMetricField<Counter64> displayInsertsCoalesced("repl.apply.insertsCoalesced",
+                                                           &insertsCoalescedStats);
+
 // Number and time of each ApplyOps worker pool round
 TimerStats applyBatchStats;
 ServerStatusMetricField<TimerStats> displayOpBatchesApplied("repl.apply.batches", &applyBatchStats);
+
+/**
+ * Reports, for each writer thread, how many batches and ops it has applied and how long it spent
+ * applying them, as repl.apply.writers. Lets us see whether the batch planner is keeping the
+ * writers evenly loaded.
+ */
+class WriterApplyStats final : public ServerStatusMetric {
+public:
+    WriterApplyStats() : ServerStatusMetric("repl.apply.writers") {}
+
+    void record(size_t writer, size_t numOps, int millis) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_writers.size() <= writer) {
+            _writers.resize(writer + 1);
+        }
+        auto& stats = _writers[writer];
+        stats.batches++;
+        stats.ops += numOps;
+        stats.totalMillis += millis;
+    }
+
+    void appendAtLeaf(BSONObjBuilder& b) const final {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        BSONArrayBuilder writers(b.subarrayStart(_leafName));
+        for (auto&& stats : _writers) {
+            BSONObjBuilder writer(writers.subobjStart());
+            writer.append("batches", stats.batches);
+            writer.append("ops", stats.ops);
+            writer.append("totalMillis", stats.totalMillis);
+        }
+    }
+
+private:
+    struct Stats {
+        long long batches = 0;
+        long long ops = 0;
+        long long totalMillis = 0;
+    };
+
+    mutable stdx::mutex _mutex;
+    std::vector<Stats> _writers;
+} writerApplyStats;
 void initializePrefetchThread() {
     if (!Client::getCurrent()) {
         Client::initThreadIfNotAlready();
@@ -282,7 +348,7 @@ bool SyncTail::peek(OperationContext* opCtx, BSONObj* op) {
 
 // static
 Status SyncTail::syncApply(OperationContext* opCtx,
-                           const BSONObj& op,
+                           const OplogEntryView& entry,
                            bool inSteadyStateReplication,
                            ApplyOperationInLockFn applyOperationInLock,
                            ApplyCommandInLockFn applyCommandInLock,
@@ -290,10 +356,10 @@ Status SyncTail::syncApply(OperationContext* opCtx,
     // Count each log op application as a separate operation, for reporting purposes
     CurOp individualOp(opCtx);
 
-    const char* ns = op.getStringField("ns");
-    verify(ns);
+    const BSONObj& op = entry.raw;
+    const char* ns = entry.ns.type() == String ? entry.ns.valuestr() : "";
 
-    const char* opType = op["op"].valuestrsafe();
+    const char* opType = entry.opType.valuestrsafe();
 
     bool isCommand(opType[0] == 'c');
     bool isNoOp(opType[0] == 'n');
@@ -328,8 +394,8 @@ Status SyncTail::syncApply(OperationContext* opCtx,
         UnreplicatedWritesBlock uwb(opCtx);
         DisableDocumentValidation validationDisabler(opCtx);
 
-        Status status =
-            applyOperationInLock(opCtx, db, op, inSteadyStateReplication, incrementOpsAppliedStats);
+        Status status = applyOperationInLock(
+            opCtx, db, entry, inSteadyStateReplication, incrementOpsAppliedStats);
         if (!status.isOK() && status.code() == ErrorCodes::WriteConflict) {
             throw WriteConflictException();
         }
@@ -396,20 +462,50 @@ Status SyncTail::syncApply(OperationContext* opCtx,
 
 Status SyncTail::syncApply(OperationContext* opCtx,
                            const BSONObj& op,
-                           bool inSteadyStateReplication) {
+                           bool inSteadyStateReplication,
+                           ApplyOperationInLockFn applyOperationInLock,
+                           ApplyCommandInLockFn applyCommandInLock,
+                           IncrementOpsAppliedStatsFn incrementOpsAppliedStats) {
     return SyncTail::syncApply(opCtx,
-                               op,
+                               OplogEntryView(op),
                                inSteadyStateReplication,
-                               applyOperation_inlock,
-                               applyCommand_inlock,
-                               stdx::bind(&Counter64::increment, &opsAppliedStats, 1ULL));
+                               applyOperationInLock,
+                               applyCommandInLock,
+                               incrementOpsAppliedStats);
+}
+
+Status SyncTail::syncApply(OperationContext* opCtx,
+                           const OplogEntryView& entry,
+                           bool inSteadyStateReplication) {
+    return SyncTail::syncApply(
+        opCtx,
+        entry,
+        inSteadyStateReplication,
+        [](OperationContext* opCtx,
+           Database* db,
+           const OplogEntryView& entry,
+           bool inSteadyStateReplication,
+           IncrementOpsAppliedStatsFn incrementOpsAppliedStats) {
+            return applyOperation_inlock(
+                opCtx, db, entry, inSteadyStateReplication, incrementOpsAppliedStats);
+        },
+        applyCommand_inlock,
+        stdx::bind(&Counter64::increment, &opsAppliedStats, 1ULL));
+}
+
+Status SyncTail::syncApply(OperationContext* opCtx,
+                           const BSONObj& op,
+                           bool inSteadyStateReplication) {
+    return SyncTail::syncApply(opCtx, OplogEntryView(op), inSteadyStateReplication);
 }
 
 
 namespace {
 
-// The pool threads call this to prefetch each op
-void prefetchOp(const BSONObj& op) {
+// The pool threads call this to prefetch each op. 'duringApplication' is true when the op is
+// prefetched concurrently with the application of its batch; the prefetcher must then neither wait
+// for nor be blocked by the ParallelBatchWriterMode lock held by the applier.
+void prefetchOp(const BSONObj& op, bool duringApplication) {
     initializePrefetchThread();
 
     const char* ns = op.getStringField("ns");
@@ -419,6 +515,9 @@ void prefetchOp(const BSONObj& op) {
             // for multiple prefetches if they are for the same database.
             const ServiceContext::UniqueOperationContext opCtxPtr = cc().makeOperationContext();
             OperationContext& opCtx = *opCtxPtr;
+            if (duringApplication) {
+                opCtx.lockState()->setShouldConflictWithSecondaryBatchApplication(false);
+            }
             AutoGetCollectionForReadCommand ctx(&opCtx, NamespaceString(ns));
             Database* db = ctx.getDb();
             if (db) {
@@ -437,11 +536,53 @@ void prefetchOp(const BSONObj& op) {
 void prefetchOps(const MultiApplier::Operations& ops, OldThreadPool* prefetcherPool) {
     invariant(prefetcherPool);
     for (auto&& op : ops) {
-        prefetcherPool->schedule(&prefetchOp, op.raw);
+        prefetcherPool->schedule(&prefetchOp, op.raw, false);
     }
     prefetcherPool->join();
 }
 
+OldThreadPool* getConcurrentPrefetcherPool() {
+    // Leaked, like the other pools owned by replication, so that it outlives any batch in flight at
+    // shutdown.
+    static OldThreadPool* pool = new OldThreadPool(replWriterThreadCount, "repl prefetch worker ");
+    return pool;
+}
+
+/**
+ * Prefetches the CRUD ops of a batch on a pool separate from the writer threads while the batch is
+ * being applied. Each op's index and record lookups are independent, so the prefetchers can run
+ * ahead of writers that are still working through earlier ops on the same namespace. Destroying
+ * the prefetcher drops any prefetches that have not started yet and waits for the rest.
+ */
+class ConcurrentPrefetcher {
+    MONGO_DISALLOW_COPYING(ConcurrentPrefetcher);
+
+public:
+    explicit ConcurrentPrefetcher(const MultiApplier::Operations& ops)
+        : _pool(getConcurrentPrefetcherPool()) {
+        for (auto&& op : ops) {
+            if (!op.isCrudOpType()) {
+                continue;
+            }
+            BSONObj raw = op.raw;
+            _pool->schedule([this, raw] {
+                if (!_batchDone.load()) {
+                    prefetchOp(raw, true);
+                }
+            });
+        }
+    }
+
+    ~ConcurrentPrefetcher() {
+        _batchDone.store(true);
+        _pool->join();
+    }
+
+private:
+    OldThreadPool* const _pool;
+    AtomicBool _batchDone{false};
+};
+
 // Doles out all the work to the writer pool threads.
 // Does not modify writerVectors, but passes non-const pointers to inner vectors into func.
 void applyOps(std::vector<MultiApplier::OperationPtrs>& writerVectors,
@@ -453,7 +594,9 @@ void applyOps(std::vector<MultiApplier::OperationPtrs>& writerVectors,
     for (size_t i = 0; i < writerVectors.size(); i++) {
         if (!writerVectors[i].empty()) {
             writerPool->schedule([&func, &writerVectors, statusVector, i] {
+                Timer timer;
                 (*statusVector)[i] = func(&writerVectors[i]);
+                writerApplyStats.record(i, writerVectors[i].size(), timer.millis());
             });
         }
     }
@@ -535,6 +678,12 @@ public:
     struct CollectionProperties {
         bool isCapped = false;
         const CollatorInterface* collator = nullptr;
+        int numIndexes = 0;
+        bool hasUniqueSecondaryIndex = false;
+
+        // Hashes _id values under the collection's default collation. Built once per collection
+        // rather than once per op.
+        std::shared_ptr<const BSONElementComparator> elementHasher;
     };
 
     CollectionProperties getCollectionProperties(OperationContext* opCtx,
@@ -545,6 +694,8 @@ public:
         }
 
         auto collProperties = getCollectionPropertiesImpl(opCtx, ns.key());
+        collProperties.elementHasher = std::make_shared<BSONElementComparator>(
+            BSONElementComparator::FieldNamesMode::kIgnore, collProperties.collator);
         _cache[ns] = collProperties;
         return collProperties;
     }
@@ -566,14 +717,34 @@ private:
 
         collProperties.isCapped = collection->isCapped();
         collProperties.collator = collection->getDefaultCollator();
+        auto indexCatalog = collection->getIndexCatalog();
+        collProperties.numIndexes = indexCatalog->numIndexesTotal(opCtx);
+        auto ii = indexCatalog->getIndexIterator(opCtx, true);
+        while (ii.more()) {
+            auto desc = ii.next();
+            if (desc->unique() && !desc->isIdIndex()) {
+                collProperties.hasUniqueSecondaryIndex = true;
+            }
+        }
         return collProperties;
     }
 
     StringMap<CollectionProperties> _cache;
 };
 
-// This only modifies the isForCappedCollection field on each op. It does not alter the ops vector
-// in any other way.
+/**
+ * Distributes the ops in a batch across the writer vectors.
+ *
+ * Ops that must be applied in order relative to each other share a partition key: the namespace
+ * plus, for doc-locking engines and non-capped collections, the document's _id. The first time a
+ * key is seen in the batch it is assigned to the writer with the least estimated work so far, and
+ * every later op with that key goes to the same writer. An op's estimated cost is its size times
+ * the number of indexes it has to maintain, so that a hot collection with large documents is
+ * spread over all writers instead of saturating a few of them.
+ *
+ * Apart from setting isForCappedCollection and isReorderableInsert, this does not modify the ops
+ * vector.
+ */
 void fillWriterVectors(OperationContext* opCtx,
                        MultiApplier::Operations* ops,
                        std::vector<MultiApplier::OperationPtrs>* writerVectors) {
@@ -582,10 +753,13 @@ void fillWriterVectors(OperationContext* opCtx,
     const uint32_t numWriters = writerVectors->size();
 
     CachedCollectionProperties collPropertiesCache;
+    unordered_map<uint32_t, uint32_t> writerByKey;
+    std::vector<long long> writerCost(numWriters, 0);
 
     for (auto&& op : *ops) {
-        StringMapTraits::HashedKey hashedNs(op.getNamespace().ns());
+        StringMapTraits::HashedKey hashedNs(op.getNamespace().ns(), op.getNamespaceHash());
         uint32_t hash = hashedNs.hash();
+        long long cost = op.raw.objsize();
 
         if (op.isCrudOpType()) {
             auto collProperties = collPropertiesCache.getCollectionProperties(opCtx, hashedNs);
@@ -597,20 +771,34 @@ void fillWriterVectors(OperationContext* opCtx,
             // insertion order.
             if (supportsDocLocking && !collProperties.isCapped) {
                 BSONElement id = op.getIdElement();
-                BSONElementComparator elementHasher(BSONElementComparator::FieldNamesMode::kIgnore,
-                                                    collProperties.collator);
-                const size_t idHash = elementHasher.hash(id);
+                const size_t idHash = collProperties.elementHasher->hash(id);
                 MurmurHash3_x86_32(&idHash, sizeof(idHash), hash, &hash);
             }
 
+            // Every index on the collection is another write.
+            cost *= 1 + collProperties.numIndexes;
+
             if (op.getOpType() == OpTypeEnum::kInsert && collProperties.isCapped) {
                 // Mark capped collection ops before storing them to ensure we do not attempt to
                 // bulk insert them.
                 op.isForCappedCollection = true;
             }
+
+            // An insert may only be moved past other ops on different documents if nothing but
+            // the _id can conflict, and _id equality is plain binary comparison.
+            op.isReorderableInsert = op.getOpType() == OpTypeEnum::kInsert &&
+                !collProperties.isCapped && !collProperties.hasUniqueSecondaryIndex &&
+                !collProperties.collator;
         }
 
-        auto& writer = (*writerVectors)[hash % numWriters];
+        auto it = writerByKey.find(hash);
+        if (it == writerByKey.end()) {
+            const auto leastLoaded = std::min_element(writerCost.begin(), writerCost.end());
+            it = writerByKey.emplace(hash, leastLoaded - writerCost.begin()).first;
+        }
+        writerCost[it->second] += cost;
+
+        auto& writer = (*writerVectors)[it->second];
         if (writer.empty())
             writer.reserve(8);  // skip a few growth rounds.
         writer.push_back(&op);
@@ -826,6 +1014,30 @@ void SyncTail::oplogApplication(ReplicationCoordinator* replCoord) {
     }
 }
 
+namespace {
+
+/**
+ * Returns true if 'entry' builds an index in the foreground. Such entries are inserts into the
+ * system.indexes collection of the database.
+ */
+bool isForegroundIndexBuild(const OplogEntry& entry) {
+    return entry.getOpType() == OpTypeEnum::kInsert && !entry.getNamespace().isEmpty() &&
+        entry.getNamespace().coll() == "system.indexes" &&
+        entry.getObject()["ns"].type() == String && !entry.getObject()["background"].trueValue();
+}
+
+/**
+ * Returns true if the index builds 'first' and 'entry' can be applied as a single build, which
+ * scans the collection once for all of the indexes. This is the case for foreground builds on the
+ * same collection.
+ */
+bool canBuildIndexesTogether(const OplogEntry& first, const OplogEntry& entry) {
+    return isForegroundIndexBuild(first) && isForegroundIndexBuild(entry) &&
+        first.getObject()["ns"].valueStringData() == entry.getObject()["ns"].valueStringData();
+}
+
+}  // namespace
+
 // Copies ops out of the bgsync queue into the deque passed in as a parameter.
 // Returns true if the batch should be ended early.
 // Batch should end early if we encounter a command, or if
@@ -893,6 +1105,19 @@ bool SyncTail::tryPopAndWaitForMore(OperationContext* opCtx,
         return true;
     }
 
+    // A foreground index build is batched with the following ones on the same collection, which
+    // are grouped when applied so that the collection is only scanned once, as on the primary.
+    if (ops->getCount() > 1 && isForegroundIndexBuild(ops->front())) {
+        if (!canBuildIndexesTogether(ops->front(), entry)) {
+            // Apply the index builds we have so far.
+            ops->pop_back();
+            return true;
+        }
+
+        _networkQueue->consume(opCtx);
+        return ops->getCount() >= limits.ops;
+    }
+
     // Check for ops that must be processed one at a time.
     if (entry.isCommand() ||  // commands.
         // Index builds are achieved through the use of an insert op, not a command op.
@@ -901,6 +1126,11 @@ bool SyncTail::tryPopAndWaitForMore(OperationContext* opCtx,
         if (ops->getCount() == 1) {
             // apply commands one-at-a-time
             _networkQueue->consume(opCtx);
+
+            // Unless more index builds on the same collection follow.
+            if (isForegroundIndexBuild(entry)) {
+                return ops->getCount() >= limits.ops;
+            }
         } else {
             // This op must be processed alone, but we already had ops in the queue so we can't
             // include it in this batch. Since we didn't call consume(), we'll see this again next
@@ -1044,13 +1274,84 @@ bool SyncTail::shouldRetry(OperationContext* opCtx, const BSONObj& o) {
 void multiSyncApply(MultiApplier::OperationPtrs* ops, SyncTail*) {
     initializeWriterThread();
     auto opCtx = cc().makeOperationContext();
-    auto syncApply = [](OperationContext* opCtx, const BSONObj& op, bool inSteadyStateReplication) {
-        return SyncTail::syncApply(opCtx, op, inSteadyStateReplication);
+    auto syncApply = [](
+        OperationContext* opCtx, const OplogEntryView& entry, bool inSteadyStateReplication) {
+        return SyncTail::syncApply(opCtx, entry, inSteadyStateReplication);
     };
 
     fassertNoTrace(16359, multiSyncApply_noAbort(opCtx.get(), ops, syncApply));
 }
 
+namespace {
+
+/**
+ * Within each run of ops on the same namespace, moves reorderable inserts ahead of the other ops so
+ * that interleaved workloads can still be applied as grouped inserts. An insert is only moved if no
+ * earlier op in the run touches the same _id, and never past an op that is not a CRUD op, so the
+ * order of ops on any one document is preserved. Expects 'ops' to be sorted by namespace.
+ */
+void reorderInsertsForGrouping(MultiApplier::OperationPtrs* ops) {
+    MultiApplier::OperationPtrs inserts;
+    MultiApplier::OperationPtrs others;
+
+    auto runStart = ops->begin();
+    while (runStart != ops->end()) {
+        const auto& nss = (*runStart)->getNamespace();
+        const auto runEnd = std::find_if(
+            runStart, ops->end(), [&](const OplogEntry* op) { return op->getNamespace() != nss; });
+
+        auto touchedIds = SimpleBSONElementComparator::kInstance.makeBSONEltUnorderedSet();
+        bool sawBarrier = false;
+        for (auto it = runStart; it != runEnd; ++it) {
+            const OplogEntry* op = *it;
+            if (!op->isCrudOpType()) {
+                sawBarrier = true;
+                others.push_back(op);
+                continue;
+            }
+
+            BSONElement id = op->getIdElement();
+            if (op->isReorderableInsert && !sawBarrier && !id.eoo() && !touchedIds.count(id)) {
+                inserts.push_back(op);
+                continue;
+            }
+
+            if (id.eoo()) {
+                sawBarrier = true;
+            } else {
+                touchedIds.insert(id);
+            }
+            others.push_back(op);
+        }
+
+        auto out = std::copy(inserts.begin(), inserts.end(), runStart);
+        std::copy(others.begin(), others.end(), out);
+        inserts.clear();
+        others.clear();
+        runStart = runEnd;
+    }
+}
+
+/**
+ * Returns true if 'ops' are far enough behind the wall clock that inserts should be reordered for
+ * grouping, according to replInsertReorderingLagThresholdSecs.
+ */
+bool shouldReorderInserts(const MultiApplier::OperationPtrs& ops) {
+    const int threshold = replInsertReorderingLagThresholdSecs.load();
+    if (threshold < 0 || ops.size() < 2) {
+        return false;
+    }
+
+    const long long nowSecs = durationCount<Seconds>(Date_t::now().toDurationSinceEpoch());
+    long long oldestSecs = nowSecs;
+    for (auto&& op : ops) {
+        oldestSecs = std::min(oldestSecs, static_cast<long long>(op->getTimestamp().getSecs()));
+    }
+    return nowSecs - oldestSecs >= threshold;
+}
+
+}  // namespace
+
 Status multiSyncApply_noAbort(OperationContext* opCtx,
                               MultiApplier::OperationPtrs* oplogEntryPointers,
                               SyncApplyFn syncApply) {
@@ -1066,6 +1367,10 @@ Status multiSyncApply_noAbort(OperationContext* opCtx,
                          [](const OplogEntry* l, const OplogEntry* r) {
                              return l->getNamespace() < r->getNamespace();
                          });
+
+        if (shouldReorderInserts(*oplogEntryPointers)) {
+            reorderInsertsForGrouping(oplogEntryPointers);
+        }
     }
 
     // This function is only called in steady state replication.
@@ -1119,8 +1424,11 @@ Status multiSyncApply_noAbort(OperationContext* opCtx,
 
                 try {
                     // Apply the group of inserts.
-                    uassertStatusOK(
-                        syncApply(opCtx, groupedInsertBuilder.done(), inSteadyStateReplication));
+                    uassertStatusOK(syncApply(opCtx,
+                                              OplogEntryView(groupedInsertBuilder.done()),
+                                              inSteadyStateReplication));
+                    insertsCoalescedStats.increment(
+                        endOfGroupableOpsIterator - oplogEntriesIterator);
                     // It succeeded, advance the oplogEntriesIterator to the end of the
                     // group of inserts.
                     oplogEntriesIterator = endOfGroupableOpsIterator - 1;
@@ -1140,7 +1448,7 @@ Status multiSyncApply_noAbort(OperationContext* opCtx,
 
         try {
             // Apply an individual (non-grouped) op.
-            const Status status = syncApply(opCtx, entry->raw, inSteadyStateReplication);
+            const Status status = syncApply(opCtx, entry->getView(), inSteadyStateReplication);
 
             if (!status.isOK()) {
                 severe() << "Error applying operation (" << redact(entry->raw)
@@ -1189,7 +1497,7 @@ Status multiInitialSyncApply_noAbort(OperationContext* opCtx,
     for (auto it = ops->begin(); it != ops->end(); ++it) {
         auto& entry = **it;
         try {
-            const Status s = SyncTail::syncApply(opCtx, entry.raw, inSteadyStateReplication);
+            const Status s = SyncTail::syncApply(opCtx, entry.getView(), inSteadyStateReplication);
             if (!s.isOK()) {
                 // Don't retry on commands.
                 if (entry.isCommand()) {
@@ -1202,7 +1510,7 @@ Status multiInitialSyncApply_noAbort(OperationContext* opCtx,
                 fetchCount->fetchAndAdd(1);
                 if (st->shouldRetry(opCtx, entry.raw)) {
                     const Status s2 =
-                        SyncTail::syncApply(opCtx, entry.raw, inSteadyStateReplication);
+                        SyncTail::syncApply(opCtx, entry.getView(), inSteadyStateReplication);
                     if (!s2.isOK()) {
                         severe() << "Error applying operation (" << redact(entry.raw)
                                  << "): " << redact(s2);
@@ -1250,7 +1558,8 @@ StatusWith<OpTime> multiApply(OperationContext* opCtx,
         return {ErrorCodes::BadValue, "invalid apply operation function"};
     }
 
-    if (getGlobalServiceContext()->getGlobalStorageEngine()->isMmapV1()) {
+    const bool isMmapV1 = getGlobalServiceContext()->getGlobalStorageEngine()->isMmapV1();
+    if (isMmapV1) {
         // Use a ThreadPool to prefetch all the operations in a batch.
         prefetchOps(ops, workerPool);
     }
@@ -1274,8 +1583,15 @@ StatusWith<OpTime> multiApply(OperationContext* opCtx,
         // We must wait for the all work we've dispatched to complete before leaving this block
         // because the spawned threads refer to objects on our stack, including writerVectors.
         std::vector<MultiApplier::OperationPtrs> writerVectors(workerPool->getNumThreads());
+        // Declared before the guard below so that it is only destroyed, stopping any outstanding
+        // prefetches for this batch, once the writers have been joined.
+        boost::optional<ConcurrentPrefetcher> concurrentPrefetcher;
         ON_BLOCK_EXIT([&] { workerPool->join(); });
 
+        if (!isMmapV1 && replPrefetchAheadOfApply.load()) {
+            concurrentPrefetcher.emplace(ops);
+        }
+
         consistencyMarkers->setOplogDeleteFromPoint(opCtx, ops.front().getTimestamp());
         scheduleWritesToOplog(opCtx, workerPool, ops);
         fillWriterVectors(opCtx, &ops, &writerVectors);
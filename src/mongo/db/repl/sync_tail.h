@@ -64,7 +64,7 @@ public:
      * Type of function that takes a non-command op and applies it locally.
      * Used for applying from an oplog.
      * 'db' is the database where the op will be applied.
-     * 'opObj' is a BSONObj describing the op to be applied.
+     * 'entry' holds the fields of the op to be applied.
      * 'inSteadyStateReplication' indicates to convert some updates to upserts for idempotency
      * reasons.
      * 'opCounter' is used to update server status metrics.
@@ -72,7 +72,7 @@ public:
      */
     using ApplyOperationInLockFn = stdx::function<Status(OperationContext* opCtx,
                                                          Database* db,
-                                                         const BSONObj& opObj,
+                                                         const OplogEntryView& entry,
                                                          bool inSteadyStateReplication,
                                                          IncrementOpsAppliedStatsFn opCounter)>;
 
@@ -100,6 +100,13 @@ public:
      * Functions for applying operations/commands and increment server status counters may
      * be overridden for testing.
      */
+    static Status syncApply(OperationContext* opCtx,
+                            const OplogEntryView& entry,
+                            bool inSteadyStateReplication,
+                            ApplyOperationInLockFn applyOperationInLock,
+                            ApplyCommandInLockFn applyCommandInLock,
+                            IncrementOpsAppliedStatsFn incrementOpsAppliedStats);
+
     static Status syncApply(OperationContext* opCtx,
                             const BSONObj& o,
                             bool inSteadyStateReplication,
@@ -107,6 +114,10 @@ public:
                             ApplyCommandInLockFn applyCommandInLock,
                             IncrementOpsAppliedStatsFn incrementOpsAppliedStats);
 
+    static Status syncApply(OperationContext* opCtx,
+                            const OplogEntryView& entry,
+                            bool inSteadyStateReplication);
+
     static Status syncApply(OperationContext* opCtx,
                             const BSONObj& o,
                             bool inSteadyStateReplication);
@@ -274,7 +285,7 @@ Status multiInitialSyncApply(MultiApplier::OperationPtrs* ops,
  * SyncTail::syncApply.
  */
 using SyncApplyFn = stdx::function<Status(
-    OperationContext* opCtx, const BSONObj& o, bool inSteadyStateReplication)>;
+    OperationContext* opCtx, const OplogEntryView& entry, bool inSteadyStateReplication)>;
 Status multiSyncApply_noAbort(OperationContext* opCtx,
                               MultiApplier::OperationPtrs* ops,
                               SyncApplyFn syncApply);
@@ -134,7 +134,7 @@ void SyncTailTest::setUp() {
     _opsApplied = 0;
     _applyOp = [](OperationContext* opCtx,
                   Database* db,
-                  const BSONObj& op,
+                  const OplogEntryView& op,
                   bool inSteadyStateReplication,
                   stdx::function<void()>) { return Status::OK(); };
     _applyCmd = [](OperationContext* opCtx, const BSONObj& op, bool) { return Status::OK(); };
@@ -240,6 +240,15 @@ OplogEntry makeUpdateDocumentOplogEntry(OpTime opTime,
     return OplogEntry(opTime, 1LL, OpTypeEnum::kUpdate, nss, updatedDocument, documentToUpdate);
 }
 
+/**
+ * Creates a delete oplog entry with given optime and namespace.
+ */
+OplogEntry makeDeleteDocumentOplogEntry(OpTime opTime,
+                                        const NamespaceString& nss,
+                                        const BSONObj& documentToDelete) {
+    return OplogEntry(opTime, 1LL, OpTypeEnum::kDelete, nss, documentToDelete);
+}
+
 /**
  * Creates an index creation entry with given optime and namespace.
  */
@@ -287,6 +296,27 @@ TEST_F(SyncTailTest, SyncApplyBadOp) {
     ASSERT_EQUALS(0U, _opsApplied);
 }
 
+TEST_F(SyncTailTest, OplogEntryViewExtractsIdAndNamespaceHashInOnePass) {
+    auto update = makeUpdateDocumentOplogEntry({Timestamp(Seconds(1), 0), 1LL},
+                                               NamespaceString("test.t"),
+                                               BSON("_id" << 7),
+                                               BSON("$set" << BSON("x" << 1)));
+    const auto& view = update.getView();
+    ASSERT_BSONOBJ_EQ(update.raw, view.raw);
+    ASSERT_EQUALS("u", view.opType.String());
+    ASSERT_EQUALS(StringMapTraits::hash("test.t"), view.nsHash);
+    ASSERT_EQUALS(7, view.id.numberInt());
+    ASSERT_EQUALS(7, update.getIdElement().numberInt());
+
+    // Views tolerate malformed ops, leaving the consumer to reject them.
+    OplogEntryView malformed(BSON("op"
+                                  << "i"
+                                  << "ns" << 1));
+    ASSERT_EQUALS(0U, malformed.nsHash);
+    ASSERT_TRUE(malformed.o.eoo());
+    ASSERT_TRUE(malformed.id.eoo());
+}
+
 TEST_F(SyncTailTest, SyncApplyNoOp) {
     const BSONObj op = BSON("op"
                             << "n"
@@ -295,7 +325,7 @@ TEST_F(SyncTailTest, SyncApplyNoOp) {
     bool applyOpCalled = false;
     SyncTail::ApplyOperationInLockFn applyOp = [&](OperationContext* opCtx,
                                                    Database* db,
-                                                   const BSONObj& theOperation,
+                                                   const OplogEntryView& theOperation,
                                                    bool inSteadyStateReplication,
                                                    stdx::function<void()>) {
         applyOpCalled = true;
@@ -304,7 +334,7 @@ TEST_F(SyncTailTest, SyncApplyNoOp) {
         ASSERT_FALSE(opCtx->writesAreReplicated());
         ASSERT_TRUE(documentValidationDisabled(opCtx));
         ASSERT_TRUE(db);
-        ASSERT_BSONOBJ_EQ(op, theOperation);
+        ASSERT_BSONOBJ_EQ(op, theOperation.raw);
         ASSERT_FALSE(inSteadyStateReplication);
         return Status::OK();
     };
@@ -322,7 +352,7 @@ TEST_F(SyncTailTest, SyncApplyNoOpApplyOpThrowsException) {
     int applyOpCalled = 0;
     SyncTail::ApplyOperationInLockFn applyOp = [&](OperationContext* opCtx,
                                                    Database* db,
-                                                   const BSONObj& theOperation,
+                                                   const OplogEntryView& theOperation,
                                                    bool inSteadyStateReplication,
                                                    stdx::function<void()>) {
         applyOpCalled++;
@@ -343,7 +373,7 @@ void SyncTailTest::_testSyncApplyInsertDocument(LockMode expectedMode) {
     bool applyOpCalled = false;
     SyncTail::ApplyOperationInLockFn applyOp = [&](OperationContext* opCtx,
                                                    Database* db,
-                                                   const BSONObj& theOperation,
+                                                   const OplogEntryView& theOperation,
                                                    bool inSteadyStateReplication,
                                                    stdx::function<void()>) {
         applyOpCalled = true;
@@ -353,7 +383,7 @@ void SyncTailTest::_testSyncApplyInsertDocument(LockMode expectedMode) {
         ASSERT_FALSE(opCtx->writesAreReplicated());
         ASSERT_TRUE(documentValidationDisabled(opCtx));
         ASSERT_TRUE(db);
-        ASSERT_BSONOBJ_EQ(op, theOperation);
+        ASSERT_BSONOBJ_EQ(op, theOperation.raw);
         ASSERT_TRUE(inSteadyStateReplication);
         return Status::OK();
     };
@@ -399,7 +429,7 @@ TEST_F(SyncTailTest, SyncApplyIndexBuild) {
     bool applyOpCalled = false;
     SyncTail::ApplyOperationInLockFn applyOp = [&](OperationContext* opCtx,
                                                    Database* db,
-                                                   const BSONObj& theOperation,
+                                                   const OplogEntryView& theOperation,
                                                    bool inSteadyStateReplication,
                                                    stdx::function<void()>) {
         applyOpCalled = true;
@@ -408,7 +438,7 @@ TEST_F(SyncTailTest, SyncApplyIndexBuild) {
         ASSERT_FALSE(opCtx->writesAreReplicated());
         ASSERT_TRUE(documentValidationDisabled(opCtx));
         ASSERT_TRUE(db);
-        ASSERT_BSONOBJ_EQ(op, theOperation);
+        ASSERT_BSONOBJ_EQ(op, theOperation.raw);
         ASSERT_FALSE(inSteadyStateReplication);
         return Status::OK();
     };
@@ -426,7 +456,7 @@ TEST_F(SyncTailTest, SyncApplyCommand) {
     bool applyCmdCalled = false;
     SyncTail::ApplyOperationInLockFn applyOp = [&](OperationContext* opCtx,
                                                    Database* db,
-                                                   const BSONObj& theOperation,
+                                                   const OplogEntryView& theOperation,
                                                    bool inSteadyStateReplication,
                                                    stdx::function<void()>) {
         FAIL("applyOperation unexpectedly invoked.");
@@ -457,7 +487,7 @@ TEST_F(SyncTailTest, SyncApplyCommandThrowsException) {
     int applyCmdCalled = 0;
     SyncTail::ApplyOperationInLockFn applyOp = [&](OperationContext* opCtx,
                                                    Database* db,
-                                                   const BSONObj& theOperation,
+                                                   const OplogEntryView& theOperation,
                                                    bool inSteadyStateReplication,
                                                    stdx::function<void()>) {
         FAIL("applyOperation unexpectedly invoked.");
@@ -611,6 +641,89 @@ TEST_F(SyncTailTest, MultiApplyAssignsOperationsToWriterThreadsBasedOnNamespaceH
     ASSERT_BSONOBJ_EQ(op2.raw, operationsWrittenToOplog[1]);
 }
 
+TEST_F(SyncTailTest, MultiApplyBalancesOperationsAcrossWriterThreads) {
+    // Each op is for a different namespace, so each should be assigned to a writer that has no work
+    // yet, regardless of how the namespaces hash.
+    OldThreadPool writerPool(4);
+
+    stdx::mutex mutex;
+    std::vector<MultiApplier::Operations> operationsApplied;
+    auto applyOperationFn = [&mutex, &operationsApplied](
+        MultiApplier::OperationPtrs* operationsForWriterThreadToApply) -> Status {
+        stdx::lock_guard<stdx::mutex> lock(mutex);
+        operationsApplied.emplace_back();
+        for (auto&& opPtr : *operationsForWriterThreadToApply) {
+            operationsApplied.back().push_back(*opPtr);
+        }
+        return Status::OK();
+    };
+
+    MultiApplier::Operations ops;
+    for (int i = 0; i < 4; ++i) {
+        NamespaceString nss(str::stream() << "test.t" << i);
+        ops.push_back(makeInsertDocumentOplogEntry(
+            {Timestamp(Seconds(i + 1), 0), 1LL}, nss, BSON("_id" << i)));
+    }
+
+    _storageInterface->insertDocumentsFn =
+        [](OperationContext*, const NamespaceString&, const std::vector<BSONObj>&) {
+            return Status::OK();
+        };
+
+    auto lastOpTime =
+        unittest::assertGet(multiApply(_opCtx.get(), &writerPool, ops, applyOperationFn));
+    ASSERT_EQUALS(ops.back().getOpTime(), lastOpTime);
+
+    stdx::lock_guard<stdx::mutex> lock(mutex);
+    ASSERT_EQUALS(operationsApplied.size(), 4U);
+    for (auto&& operationsAppliedByThread : operationsApplied) {
+        ASSERT_EQUALS(1U, operationsAppliedByThread.size());
+    }
+}
+
+TEST_F(SyncTailTest, MultiApplyAssignsOperationsOnTheSameDocumentToOneWriterThread) {
+    NamespaceString nss("test.t");
+    OldThreadPool writerPool(4);
+
+    stdx::mutex mutex;
+    std::vector<MultiApplier::Operations> operationsApplied;
+    auto applyOperationFn = [&mutex, &operationsApplied](
+        MultiApplier::OperationPtrs* operationsForWriterThreadToApply) -> Status {
+        stdx::lock_guard<stdx::mutex> lock(mutex);
+        operationsApplied.emplace_back();
+        for (auto&& opPtr : *operationsForWriterThreadToApply) {
+            operationsApplied.back().push_back(*opPtr);
+        }
+        return Status::OK();
+    };
+
+    auto op1 = makeInsertDocumentOplogEntry(
+        {Timestamp(Seconds(1), 0), 1LL}, nss, BSON("_id" << 0 << "x" << 1));
+    auto op2 = makeUpdateDocumentOplogEntry({Timestamp(Seconds(2), 0), 1LL},
+                                            nss,
+                                            BSON("_id" << 0),
+                                            BSON("$set" << BSON("x" << 2)));
+    auto op3 = makeUpdateDocumentOplogEntry({Timestamp(Seconds(3), 0), 1LL},
+                                            nss,
+                                            BSON("_id" << 0),
+                                            BSON("$set" << BSON("x" << 3)));
+
+    _storageInterface->insertDocumentsFn =
+        [](OperationContext*, const NamespaceString&, const std::vector<BSONObj>&) {
+            return Status::OK();
+        };
+
+    unittest::assertGet(multiApply(_opCtx.get(), &writerPool, {op1, op2, op3}, applyOperationFn));
+
+    // All three ops must be applied, in order, by the same writer thread.
+    stdx::lock_guard<stdx::mutex> lock(mutex);
+    ASSERT_EQUALS(operationsApplied.size(), 1U);
+    ASSERT_EQUALS(3U, operationsApplied.front().size());
+    ASSERT_EQUALS(op1.getOpTime(), operationsApplied.front()[0].getOpTime());
+    ASSERT_EQUALS(op2.getOpTime(), operationsApplied.front()[1].getOpTime());
+    ASSERT_EQUALS(op3.getOpTime(), operationsApplied.front()[2].getOpTime());
+}
+
 TEST_F(SyncTailTest, MultiSyncApplyUsesSyncApplyToApplyOperation) {
     NamespaceString nss("local." + _agent.getSuiteName() + "_" + _agent.getTestName());
     auto op = makeCreateCollectionOplogEntry({Timestamp(Seconds(1), 0), 1LL}, nss);
@@ -625,13 +738,14 @@ TEST_F(SyncTailTest, MultiSyncApplyUsesSyncApplyToApplyOperation) {
 
 TEST_F(SyncTailTest, MultiSyncApplyDisablesDocumentValidationWhileApplyingOperations) {
     NamespaceString nss("local." + _agent.getSuiteName() + "_" + _agent.getTestName());
-    auto syncApply = [](OperationContext* opCtx, const BSONObj&, bool convertUpdatesToUpserts) {
-        ASSERT_FALSE(opCtx->writesAreReplicated());
-        ASSERT_FALSE(opCtx->lockState()->shouldConflictWithSecondaryBatchApplication());
-        ASSERT_TRUE(documentValidationDisabled(opCtx));
-        ASSERT_TRUE(convertUpdatesToUpserts);
-        return Status::OK();
-    };
+    auto syncApply =
+        [](OperationContext* opCtx, const OplogEntryView&, bool convertUpdatesToUpserts) {
+            ASSERT_FALSE(opCtx->writesAreReplicated());
+            ASSERT_FALSE(opCtx->lockState()->shouldConflictWithSecondaryBatchApplication());
+            ASSERT_TRUE(documentValidationDisabled(opCtx));
+            ASSERT_TRUE(convertUpdatesToUpserts);
+            return Status::OK();
+        };
     auto op = makeUpdateDocumentOplogEntry(
         {Timestamp(Seconds(1), 0), 1LL}, nss, BSON("_id" << 0), BSON("_id" << 0 << "x" << 2));
     MultiApplier::OperationPtrs ops = {&op};
@@ -641,7 +755,7 @@ TEST_F(SyncTailTest, MultiSyncApplyDisablesDocumentValidationWhileApplyingOperat
 TEST_F(SyncTailTest, MultiSyncApplyPassesThroughSyncApplyErrorAfterFailingToApplyOperation) {
     NamespaceString nss("local." + _agent.getSuiteName() + "_" + _agent.getTestName());
     OplogEntry op(OpTime(Timestamp(1, 1), 1), 1LL, OpTypeEnum::kDelete, nss, BSONObj());
-    auto syncApply = [](OperationContext*, const BSONObj&, bool) -> Status {
+    auto syncApply = [](OperationContext*, const OplogEntryView&, bool) -> Status {
         return {ErrorCodes::OperationFailed, ""};
     };
     MultiApplier::OperationPtrs ops = {&op};
@@ -652,7 +766,7 @@ TEST_F(SyncTailTest, MultiSyncApplyPassesThroughSyncApplyErrorAfterFailingToAppl
 TEST_F(SyncTailTest, MultiSyncApplyPassesThroughSyncApplyException) {
     NamespaceString nss("local." + _agent.getSuiteName() + "_" + _agent.getTestName());
     OplogEntry op(OpTime(Timestamp(1, 1), 1), 1LL, OpTypeEnum::kDelete, nss, BSONObj());
-    auto syncApply = [](OperationContext*, const BSONObj&, bool) -> Status {
+    auto syncApply = [](OperationContext*, const OplogEntryView&, bool) -> Status {
         uasserted(ErrorCodes::OperationFailed, "");
         MONGO_UNREACHABLE;
     };
@@ -672,8 +786,8 @@ TEST_F(SyncTailTest, MultiSyncApplySortsOperationsStablyByNamespaceBeforeApplyin
     auto op3 = makeOp("test.t2");
     auto op4 = makeOp("test.t3");
     MultiApplier::Operations operationsApplied;
-    auto syncApply = [&operationsApplied](OperationContext*, const BSONObj& op, bool) {
-        operationsApplied.push_back(OplogEntry(op));
+    auto syncApply = [&operationsApplied](OperationContext*, const OplogEntryView& op, bool) {
+        operationsApplied.push_back(OplogEntry(op.raw));
         return Status::OK();
     };
     MultiApplier::OperationPtrs ops = {&op4, &op1, &op3, &op2};
@@ -700,8 +814,8 @@ TEST_F(SyncTailTest, MultiSyncApplyGroupsInsertOperationByNamespaceBeforeApplyin
     auto insertOp2a = makeOp(nss2);
     auto insertOp2b = makeOp(nss2);
     std::vector<BSONObj> operationsApplied;
-    auto syncApply = [&operationsApplied](OperationContext*, const BSONObj& op, bool) {
-        operationsApplied.push_back(op.copy());
+    auto syncApply = [&operationsApplied](OperationContext*, const OplogEntryView& op, bool) {
+        operationsApplied.push_back(op.raw.copy());
         return Status::OK();
     };
 
@@ -732,6 +846,73 @@ TEST_F(SyncTailTest, MultiSyncApplyGroupsInsertOperationByNamespaceBeforeApplyin
     ASSERT_BSONOBJ_EQ(insertOp2b.getObject(), group2[1].Obj());
 }
 
+TEST_F(SyncTailTest, MultiSyncApplyReordersIndependentInsertsIntoOneGroup) {
+    NamespaceString nss("test." + _agent.getSuiteName() + "_" + _agent.getTestName());
+    auto makeInsert = [&nss](int seconds, int id) {
+        auto op = makeInsertDocumentOplogEntry(
+            {Timestamp(Seconds(seconds), 0), 1LL}, nss, BSON("_id" << id));
+        op.isReorderableInsert = true;
+        return op;
+    };
+    auto insertOp1 = makeInsert(1, 1);
+    auto updateOp1 = makeUpdateDocumentOplogEntry({Timestamp(Seconds(2), 0), 1LL},
+                                                  nss,
+                                                  BSON("_id" << 1),
+                                                  BSON("$set" << BSON("x" << 1)));
+    auto insertOp2 = makeInsert(3, 2);
+    auto updateOp2 = makeUpdateDocumentOplogEntry({Timestamp(Seconds(4), 0), 1LL},
+                                                  nss,
+                                                  BSON("_id" << 1),
+                                                  BSON("$set" << BSON("x" << 2)));
+    auto insertOp3 = makeInsert(5, 3);
+
+    std::vector<BSONObj> operationsApplied;
+    auto syncApply = [&operationsApplied](OperationContext*, const OplogEntryView& op, bool) {
+        operationsApplied.push_back(op.raw.copy());
+        return Status::OK();
+    };
+
+    MultiApplier::OperationPtrs ops = {&insertOp1, &updateOp1, &insertOp2, &updateOp2, &insertOp3};
+    ASSERT_OK(multiSyncApply_noAbort(_opCtx.get(), &ops, syncApply));
+
+    // The three inserts are applied as one group, followed by the updates in their original order.
+    ASSERT_EQUALS(3U, operationsApplied.size());
+    ASSERT_EQUALS(BSONType::Array, operationsApplied[0]["o"].type());
+    auto group = operationsApplied[0]["o"].Array();
+    ASSERT_EQUALS(3U, group.size());
+    ASSERT_BSONOBJ_EQ(insertOp1.getObject(), group[0].Obj());
+    ASSERT_BSONOBJ_EQ(insertOp2.getObject(), group[1].Obj());
+    ASSERT_BSONOBJ_EQ(insertOp3.getObject(), group[2].Obj());
+    ASSERT_BSONOBJ_EQ(updateOp1.raw, operationsApplied[1]);
+    ASSERT_BSONOBJ_EQ(updateOp2.raw, operationsApplied[2]);
+}
+
+TEST_F(SyncTailTest, MultiSyncApplyDoesNotReorderInsertPastOpOnTheSameDocument) {
+    NamespaceString nss("test." + _agent.getSuiteName() + "_" + _agent.getTestName());
+    auto insertOp1 = makeInsertDocumentOplogEntry(
+        {Timestamp(Seconds(1), 0), 1LL}, nss, BSON("_id" << 1));
+    insertOp1.isReorderableInsert = true;
+    auto deleteOp =
+        makeDeleteDocumentOplogEntry({Timestamp(Seconds(2), 0), 1LL}, nss, BSON("_id" << 2));
+    auto insertOp2 = makeInsertDocumentOplogEntry(
+        {Timestamp(Seconds(3), 0), 1LL}, nss, BSON("_id" << 2));
+    insertOp2.isReorderableInsert = true;
+
+    std::vector<BSONObj> operationsApplied;
+    auto syncApply = [&operationsApplied](OperationContext*, const OplogEntryView& op, bool) {
+        operationsApplied.push_back(op.raw.copy());
+        return Status::OK();
+    };
+
+    MultiApplier::OperationPtrs ops = {&insertOp1, &deleteOp, &insertOp2};
+    ASSERT_OK(multiSyncApply_noAbort(_opCtx.get(), &ops, syncApply));
+
+    ASSERT_EQUALS(3U, operationsApplied.size());
+    ASSERT_BSONOBJ_EQ(insertOp1.raw, operationsApplied[0]);
+    ASSERT_BSONOBJ_EQ(deleteOp.raw, operationsApplied[1]);
+    ASSERT_BSONOBJ_EQ(insertOp2.raw, operationsApplied[2]);
+}
+
 TEST_F(SyncTailTest, MultiSyncApplyUsesLimitWhenGroupingInsertOperation) {
     int seconds = 0;
     auto makeOp = [&seconds](const NamespaceString& nss) {
@@ -752,8 +933,8 @@ TEST_F(SyncTailTest, MultiSyncApplyUsesLimitWhenGroupingInsertOperation) {
     operationsToApply.push_back(createOp);
     std::copy(insertOps.begin(), insertOps.end(), std::back_inserter(operationsToApply));
     std::vector<BSONObj> operationsApplied;
-    auto syncApply = [&operationsApplied](OperationContext*, const BSONObj& op, bool) {
-        operationsApplied.push_back(op.copy());
+    auto syncApply = [&operationsApplied](OperationContext*, const OplogEntryView& op, bool) {
+        operationsApplied.push_back(op.raw.copy());
         return Status::OK();
     };
 
@@ -805,14 +986,14 @@ TEST_F(SyncTailTest, MultiSyncApplyFallsBackOnApplyingInsertsIndividuallyWhenGro
 
     std::size_t numFailedGroupedInserts = 0;
     MultiApplier::Operations operationsApplied;
-    auto syncApply = [&numFailedGroupedInserts,
-                      &operationsApplied](OperationContext*, const BSONObj& op, bool) -> Status {
+    auto syncApply = [&numFailedGroupedInserts, &operationsApplied](
+        OperationContext*, const OplogEntryView& op, bool) -> Status {
         // Reject grouped insert operations.
-        if (op["o"].type() == BSONType::Array) {
+        if (op.o.type() == BSONType::Array) {
             numFailedGroupedInserts++;
             return {ErrorCodes::OperationFailed, "grouped inserts not supported"};
         }
-        operationsApplied.push_back(OplogEntry(op));
+        operationsApplied.push_back(OplogEntry(op.raw));
         return Status::OK();
     };
 
@@ -838,6 +1019,43 @@ TEST_F(SyncTailTest, MultiSyncApplyFallsBackOnApplyingInsertsIndividuallyWhenGro
     ASSERT_EQUALS(1U, numFailedGroupedInserts);
 }
 
+TEST_F(SyncTailTest, MultiSyncApplyBuildsGroupedForegroundIndexesOnTheSameCollectionTogether) {
+    NamespaceString nss("test." + _agent.getSuiteName() + "_" + _agent.getTestName());
+    {
+        Lock::GlobalWrite globalLock(_opCtx.get());
+        bool justCreated = false;
+        Database* db = dbHolder().openDb(_opCtx.get(), nss.db(), &justCreated);
+        ASSERT_TRUE(db);
+        Collection* collection = db->createCollection(_opCtx.get(), nss.ns());
+        ASSERT_TRUE(collection);
+    }
+
+    auto indexOp1 =
+        makeCreateIndexOplogEntry({Timestamp(Seconds(1), 0), 1LL}, nss, "a_1", BSON("a" << 1));
+    auto indexOp2 =
+        makeCreateIndexOplogEntry({Timestamp(Seconds(2), 0), 1LL}, nss, "b_1", BSON("b" << 1));
+
+    std::size_t numGroupedIndexBuilds = 0;
+    auto syncApply = [&numGroupedIndexBuilds](
+        OperationContext* opCtx, const OplogEntryView& op, bool inSteadyStateReplication) {
+        if (op.o.type() == BSONType::Array) {
+            ASSERT_EQUALS(2, op.o.Obj().nFields());
+            numGroupedIndexBuilds++;
+        }
+        return SyncTail::syncApply(opCtx, op, inSteadyStateReplication);
+    };
+
+    MultiApplier::OperationPtrs ops = {&indexOp1, &indexOp2};
+    ASSERT_OK(multiSyncApply_noAbort(_opCtx.get(), &ops, syncApply));
+    ASSERT_EQUALS(1U, numGroupedIndexBuilds);
+
+    AutoGetCollectionForReadCommand autoColl(_opCtx.get(), nss);
+    ASSERT_TRUE(autoColl.getCollection());
+    auto indexCatalog = autoColl.getCollection()->getIndexCatalog();
+    ASSERT_TRUE(indexCatalog->findIndexByName(_opCtx.get(), "a_1"));
+    ASSERT_TRUE(indexCatalog->findIndexByName(_opCtx.get(), "b_1"));
+}
+
 TEST_F(SyncTailTest, MultiInitialSyncApplyDisablesDocumentValidationWhileApplyingOperations) {
     SyncTailWithOperationContextChecker syncTail;
     NamespaceString nss("local." + _agent.getSuiteName() + "_" + _agent.getTestName());
@@ -613,6 +613,12 @@ public:
      */
     virtual boost::optional<OpTime> latestKnownOpTimeSinceHeartbeatRestart() const = 0;
 
+    /**
+     * Returns true if, according to the latest heartbeats, an electable member which is up has
+     * applied a later optime than we have.
+     */
+    virtual bool hasFresherElectablePeer() const = 0;
+
 protected:
     TopologyCoordinator() {}
 };
@@ -32,6 +32,7 @@
 
 #include "mongo/db/repl/topology_coordinator_impl.h"
 
+#include <algorithm>
 #include <limits>
 
 #include "mongo/db/audit.h"
@@ -3022,5 +3023,21 @@ boost::optional<OpTime> TopologyCoordinatorImpl::latestKnownOpTimeSinceHeartbeat
     return latest;
 }
 
+bool TopologyCoordinatorImpl::hasFresherElectablePeer() const {
+    const OpTime myLastAppliedOpTime = getMyLastAppliedOpTime();
+    const int numMembers =
+        std::min(static_cast<int>(_memberData.size()), _rsConfig.getNumMembers());
+    for (int i = 0; i < numMembers; i++) {
+        const auto& peer = _memberData[i];
+        if (i == _selfIndex || !peer.up() || !_rsConfig.getMemberAt(i).isElectable()) {
+            continue;
+        }
+        if (peer.getHeartbeatAppliedOpTime() > myLastAppliedOpTime) {
+            return true;
+        }
+    }
+    return false;
+}
+
 }  // namespace repl
 }  // namespace mongo
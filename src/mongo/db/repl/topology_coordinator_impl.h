@@ -254,6 +254,8 @@ public:
 
     virtual boost::optional<OpTime> latestKnownOpTimeSinceHeartbeatRestart() const;
 
+    virtual bool hasFresherElectablePeer() const;
+
     ////////////////////////////////////////////////////////////
     //
     // Test support methods
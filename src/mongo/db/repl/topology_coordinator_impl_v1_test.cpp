@@ -501,6 +501,41 @@ TEST_F(TopoCoordTest, NodeReturnsClosestValidSyncSourceAsSyncSource) {
     ASSERT(getTopoCoord().getSyncSourceAddress().empty());
 }
 
+TEST_F(TopoCoordTest, NodeKnowsOfFresherElectablePeerOnlyFromUpElectableMembers) {
+    updateConfig(BSON("_id"
+                      << "rs0"
+                      << "version"
+                      << 1
+                      << "members"
+                      << BSON_ARRAY(BSON("_id" << 10 << "host"
+                                               << "hself")
+                                    << BSON("_id" << 20 << "host"
+                                                  << "h2"
+                                                  << "priority"
+                                                  << 0)
+                                    << BSON("_id" << 30 << "host"
+                                                  << "h3"))),
+                 0);
+    setSelfMemberState(MemberState::RS_SECONDARY);
+    getTopoCoord().getMyMemberData()->setLastAppliedOpTime(OpTime(Timestamp(2, 0), 0), Date_t());
+    ASSERT_FALSE(getTopoCoord().hasFresherElectablePeer());
+
+    // h2 is ahead of us, but cannot be elected.
+    heartbeatFromMember(
+        HostAndPort("h2"), "rs0", MemberState::RS_SECONDARY, OpTime(Timestamp(3, 0), 0));
+    heartbeatFromMember(
+        HostAndPort("h3"), "rs0", MemberState::RS_SECONDARY, OpTime(Timestamp(2, 0), 0));
+    ASSERT_FALSE(getTopoCoord().hasFresherElectablePeer());
+
+    heartbeatFromMember(
+        HostAndPort("h3"), "rs0", MemberState::RS_SECONDARY, OpTime(Timestamp(3, 0), 0));
+    ASSERT_TRUE(getTopoCoord().hasFresherElectablePeer());
+
+    // A peer which is down is not standing for election.
+    receiveDownHeartbeat(HostAndPort("h3"), "rs0");
+    ASSERT_FALSE(getTopoCoord().hasFresherElectablePeer());
+}
+
 TEST_F(TopoCoordTest, NodeWontChooseSyncSourceFromOlderTerm) {
     updateConfig(BSON("_id"
                       << "rs0"
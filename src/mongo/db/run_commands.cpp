@@ -38,6 +38,7 @@
 #include "mongo/db/lasterror.h"
 #include "mongo/db/logical_clock.h"
 #include "mongo/db/logical_time_validator.h"
+#include "mongo/db/operation_phases.h"
 #include "mongo/db/read_concern.h"
 #include "mongo/db/repl/repl_client_info.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
@@ -344,7 +345,7 @@ bool runCommandImpl(OperationContext* opCtx,
         }
 
         // TODO: remove queryOptions parameter from command's run method.
-        result = command->run(opCtx, db, cmd, errmsg, inPlaceReplyBob);
+        result = command->enhancedRun(opCtx, request, errmsg, inPlaceReplyBob);
     } else {
         auto wcResult = extractWriteConcern(opCtx, cmd, db);
         if (!wcResult.isOK()) {
@@ -363,7 +364,7 @@ bool runCommandImpl(OperationContext* opCtx,
                 opCtx, command->getName(), &inPlaceReplyBob);
         });
 
-        result = command->run(opCtx, db, cmd, errmsg, inPlaceReplyBob);
+        result = command->enhancedRun(opCtx, request, errmsg, inPlaceReplyBob);
 
         // Nothing in run() should change the writeConcern.
         dassert(SimpleBSONObjComparator::kInstance.evaluate(opCtx->getWriteConcern().toBSON() ==
@@ -473,7 +474,10 @@ void execCommandDatabase(OperationContext* opCtx,
         }
 
         ImpersonationSessionGuard guard(opCtx);
-        uassertStatusOK(Command::checkAuthorization(command, opCtx, dbname, request.body));
+        {
+            OperationPhases::Scope authPhase(opCtx, OperationPhases::Phase::kAuthorization);
+            uassertStatusOK(Command::checkAuthorization(command, opCtx, dbname, request.body));
+        }
 
         repl::ReplicationCoordinator* replCoord =
             repl::ReplicationCoordinator::get(opCtx->getClient()->getServiceContext());
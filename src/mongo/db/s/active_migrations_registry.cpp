@@ -35,14 +35,17 @@
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/migration_session_id.h"
 #include "mongo/db/s/migration_source_manager.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/util/assert_util.h"
 
 namespace mongo {
 
+MONGO_EXPORT_SERVER_PARAMETER(maxConcurrentChunkDonations, int, 1);
+
 ActiveMigrationsRegistry::ActiveMigrationsRegistry() = default;
 
 ActiveMigrationsRegistry::~ActiveMigrationsRegistry() {
-    invariant(!_activeMoveChunkState);
+    invariant(_activeMoveChunkStates.empty());
 }
 
 StatusWith<ScopedRegisterDonateChunk> ActiveMigrationsRegistry::registerDonateChunk(
@@ -52,17 +55,25 @@ StatusWith<ScopedRegisterDonateChunk> ActiveMigrationsRegistry::registerDonateCh
         return _activeReceiveChunkState->constructErrorStatus();
     }
 
-    if (_activeMoveChunkState) {
-        if (_activeMoveChunkState->args == args) {
-            return {ScopedRegisterDonateChunk(nullptr, false, _activeMoveChunkState->notification)};
+    auto it = _activeMoveChunkStates.find(args.getNss().ns());
+    if (it != _activeMoveChunkStates.end()) {
+        if (it->second.args == args) {
+            return {ScopedRegisterDonateChunk(
+                nullptr, args.getNss(), false, it->second.notification)};
         }
 
-        return _activeMoveChunkState->constructErrorStatus();
+        return it->second.constructErrorStatus();
+    }
+
+    if (!_activeMoveChunkStates.empty() &&
+        _activeMoveChunkStates.size() >=
+            static_cast<size_t>(std::max(1, maxConcurrentChunkDonations.load()))) {
+        return _activeMoveChunkStates.begin()->second.constructErrorStatus();
     }
 
-    _activeMoveChunkState.emplace(args);
+    it = _activeMoveChunkStates.emplace(args.getNss().ns(), ActiveMoveChunkState(args)).first;
 
-    return {ScopedRegisterDonateChunk(this, true, _activeMoveChunkState->notification)};
+    return {ScopedRegisterDonateChunk(this, args.getNss(), true, it->second.notification)};
 }
 
 StatusWith<ScopedRegisterReceiveChunk> ActiveMigrationsRegistry::registerReceiveChunk(
@@ -72,8 +83,8 @@ StatusWith<ScopedRegisterReceiveChunk> ActiveMigrationsRegistry::registerReceive
         return _activeReceiveChunkState->constructErrorStatus();
     }
 
-    if (_activeMoveChunkState) {
-        return _activeMoveChunkState->constructErrorStatus();
+    if (!_activeMoveChunkStates.empty()) {
+        return _activeMoveChunkStates.begin()->second.constructErrorStatus();
     }
 
     _activeReceiveChunkState.emplace(nss, chunkRange, fromShardId);
@@ -81,34 +92,28 @@ StatusWith<ScopedRegisterReceiveChunk> ActiveMigrationsRegistry::registerReceive
     return {ScopedRegisterReceiveChunk(this)};
 }
 
-boost::optional<NamespaceString> ActiveMigrationsRegistry::getActiveDonateChunkNss() {
+std::vector<NamespaceString> ActiveMigrationsRegistry::getActiveDonateChunkNamespaces() {
+    std::vector<NamespaceString> namespaces;
+
     stdx::lock_guard<stdx::mutex> lk(_mutex);
-    if (_activeMoveChunkState) {
-        return _activeMoveChunkState->args.getNss();
+    for (const auto& activeMoveChunkState : _activeMoveChunkStates) {
+        namespaces.push_back(activeMoveChunkState.second.args.getNss());
     }
 
-    return boost::none;
+    return namespaces;
 }
 
 BSONObj ActiveMigrationsRegistry::getActiveMigrationStatusReport(OperationContext* opCtx) {
-    boost::optional<NamespaceString> nss;
-    {
-        stdx::lock_guard<stdx::mutex> lk(_mutex);
-
-        if (_activeMoveChunkState) {
-            nss = _activeMoveChunkState->args.getNss();
-        }
-    }
-
     // The state of the MigrationSourceManager could change between taking and releasing the mutex
-    // above and then taking the collection lock here, but that's fine because it isn't important to
-    // return information on a migration that just ended or started. This is just best effort and
-    // desireable for reporting, and then diagnosing, migrations that are stuck.
-    if (nss) {
+    // in getActiveDonateChunkNamespaces and then taking the collection lock here, but that's fine
+    // because it isn't important to return information on a migration that just ended or started.
+    // This is just best effort and desireable for reporting, and then diagnosing, migrations that
+    // are stuck.
+    for (const auto& nss : getActiveDonateChunkNamespaces()) {
         // Lock the collection so nothing changes while we're getting the migration report.
-        AutoGetCollection autoColl(opCtx, nss.get(), MODE_IS);
+        AutoGetCollection autoColl(opCtx, nss, MODE_IS);
 
-        auto css = CollectionShardingState::get(opCtx, nss.get());
+        auto css = CollectionShardingState::get(opCtx, nss);
         if (css && css->getMigrationSourceManager()) {
             return css->getMigrationSourceManager()->getMigrationStatusReport();
         }
@@ -117,10 +122,9 @@ BSONObj ActiveMigrationsRegistry::getActiveMigrationStatusReport(OperationContex
     return BSONObj();
 }
 
-void ActiveMigrationsRegistry::_clearDonateChunk() {
+void ActiveMigrationsRegistry::_clearDonateChunk(const NamespaceString& nss) {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
-    invariant(_activeMoveChunkState);
-    _activeMoveChunkState.reset();
+    invariant(_activeMoveChunkStates.erase(nss.ns()));
 }
 
 void ActiveMigrationsRegistry::_clearReceiveChunk() {
@@ -153,9 +157,11 @@ Status ActiveMigrationsRegistry::ActiveReceiveChunkState::constructErrorStatus()
 
 ScopedRegisterDonateChunk::ScopedRegisterDonateChunk(
     ActiveMigrationsRegistry* registry,
+    NamespaceString nss,
     bool forUnregister,
     std::shared_ptr<Notification<Status>> completionNotification)
     : _registry(registry),
+      _nss(std::move(nss)),
       _forUnregister(forUnregister),
       _completionNotification(std::move(completionNotification)) {}
 
@@ -163,7 +169,7 @@ ScopedRegisterDonateChunk::~ScopedRegisterDonateChunk() {
     if (_registry && _forUnregister) {
         // If this is a newly started migration the caller must always signal on completion
         invariant(*_completionNotification);
-        _registry->_clearDonateChunk();
+        _registry->_clearDonateChunk(_nss);
     }
 }
 
@@ -175,6 +181,7 @@ ScopedRegisterDonateChunk& ScopedRegisterDonateChunk::operator=(ScopedRegisterDo
     if (&other != this) {
         _registry = other._registry;
         other._registry = nullptr;
+        _nss = std::move(other._nss);
         _forUnregister = other._forUnregister;
         _completionNotification = std::move(other._completionNotification);
     }
@@ -29,9 +29,12 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <map>
+#include <vector>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/s/migration_session_id.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/s/move_chunk_request.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/mutex.h"
@@ -45,9 +48,15 @@ class ScopedRegisterReceiveChunk;
 template <typename T>
 class StatusWith;
 
+// Maximum number of chunks this shard may donate at the same time. Each of them must be for a
+// different collection.
+extern AtomicInt32 maxConcurrentChunkDonations;
+
 /**
  * Thread-safe object, which keeps track of the active migrations running on a node and limits them
- * to only one per-shard. There is only one instance of this object per shard.
+ * to at most one per-collection and maxConcurrentChunkDonations per-shard. A shard can only receive
+ * one chunk at a time and cannot donate and receive chunks at the same time. There is only one
+ * instance of this object per shard.
  */
 class ActiveMigrationsRegistry {
     MONGO_DISALLOW_COPYING(ActiveMigrationsRegistry);
@@ -57,11 +66,12 @@ public:
     ~ActiveMigrationsRegistry();
 
     /**
-     * If there are no migrations running on this shard, registers an active migration with the
-     * specified arguments and returns a ScopedRegisterDonateChunk, which must be signaled by the
-     * caller before it goes out of scope.
+     * If there are no migrations running for the collection of the request and this shard has not
+     * reached its limit of concurrent donations, registers an active migration with the specified
+     * arguments and returns a ScopedRegisterDonateChunk, which must be signaled by the caller
+     * before it goes out of scope.
      *
-     * If there is an active migration already running on this shard and it has the exact same
+     * If there is an active migration already running for the collection and it has the exact same
      * arguments, returns a ScopedRegisterDonateChunk, which can be used to join the already running
      * migration.
      *
@@ -81,16 +91,16 @@ public:
                                                                 const ShardId& fromShardId);
 
     /**
-     * If a migration has been previously registered through a call to registerDonateChunk returns
-     * that namespace. Otherwise returns boost::none.
+     * Returns the namespaces of all the migrations, which have been previously registered through a
+     * call to registerDonateChunk and are still active.
      */
-    boost::optional<NamespaceString> getActiveDonateChunkNss();
+    std::vector<NamespaceString> getActiveDonateChunkNamespaces();
 
     /**
-     * Returns a report on the active migration if there currently is one. Otherwise, returns an
-     * empty BSONObj.
+     * Returns a report on one of the active migrations if there currently is one. Otherwise,
+     * returns an empty BSONObj.
      *
-     * Takes an IS lock on the namespace of the active migration, if one is active.
+     * Takes an IS lock on the namespace of the reported migration, if one is active.
      */
     BSONObj getActiveMigrationStatusReport(OperationContext* opCtx);
 
@@ -137,9 +147,9 @@ private:
 
     /**
      * Unregisters a previously registered namespace with ongoing migration. Must only be called if
-     * a previous call to registerDonateChunk has succeeded.
+     * a previous call to registerDonateChunk for that namespace has succeeded.
      */
-    void _clearDonateChunk();
+    void _clearDonateChunk(const NamespaceString& nss);
 
     /**
      * Unregisters a previously registered incoming migration. Must only be called if a previous
@@ -150,9 +160,9 @@ private:
     // Protects the state below
     stdx::mutex _mutex;
 
-    // If there is an active moveChunk operation going on, this field contains the request, which
-    // initiated it
-    boost::optional<ActiveMoveChunkState> _activeMoveChunkState;
+    // Contains the requests, which initiated the active moveChunk operations, keyed by the
+    // namespace of each of them
+    std::map<std::string, ActiveMoveChunkState> _activeMoveChunkStates;
 
     // If there is an active receive of a chunk going on, this field contains the session id, which
     // initiated it
@@ -169,6 +179,7 @@ class ScopedRegisterDonateChunk {
 
 public:
     ScopedRegisterDonateChunk(ActiveMigrationsRegistry* registry,
+                              NamespaceString nss,
                               bool forUnregister,
                               std::shared_ptr<Notification<Status>> completionNotification);
     ~ScopedRegisterDonateChunk();
@@ -200,6 +211,9 @@ private:
     // Registry from which to unregister the migration. Not owned.
     ActiveMigrationsRegistry* _registry;
 
+    // Namespace under which the migration is registered
+    NamespaceString _nss;
+
     // Whether this is a newly started migration (in which case the destructor must unregister) or
     // joining an existing one (in which case the caller must wait for completion).
     bool _forUnregister;
@@ -35,6 +35,7 @@
 #include "mongo/db/service_context_noop.h"
 #include "mongo/s/move_chunk_request.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -99,14 +100,16 @@ TEST_F(MoveChunkRegistration, ScopedRegisterDonateChunkMoveConstructorAndAssignm
 }
 
 TEST_F(MoveChunkRegistration, GetActiveMigrationNamespace) {
-    ASSERT(!_registry.getActiveDonateChunkNss());
+    ASSERT(_registry.getActiveDonateChunkNamespaces().empty());
 
     const NamespaceString nss("TestDB", "TestColl");
 
     auto originalScopedRegisterDonateChunk =
         assertGet(_registry.registerDonateChunk(createMoveChunkRequest(nss)));
 
-    ASSERT_EQ(nss.ns(), _registry.getActiveDonateChunkNss()->ns());
+    const auto namespaces = _registry.getActiveDonateChunkNamespaces();
+    ASSERT_EQ(1U, namespaces.size());
+    ASSERT_EQ(nss.ns(), namespaces[0].ns());
 
     // Need to signal the registered migration so the destructor doesn't invariant
     originalScopedRegisterDonateChunk.complete(Status::OK());
@@ -124,6 +127,28 @@ TEST_F(MoveChunkRegistration, SecondMigrationReturnsConflictingOperationInProgre
     originalScopedRegisterDonateChunk.complete(Status::OK());
 }
 
+TEST_F(MoveChunkRegistration, ConcurrentMigrationsForDifferentCollections) {
+    const int originalMaxConcurrentChunkDonations = maxConcurrentChunkDonations.load();
+    ON_BLOCK_EXIT([&] { maxConcurrentChunkDonations.store(originalMaxConcurrentChunkDonations); });
+    maxConcurrentChunkDonations.store(2);
+
+    auto firstScopedRegisterDonateChunk = assertGet(_registry.registerDonateChunk(
+        createMoveChunkRequest(NamespaceString("TestDB", "TestColl1"))));
+    auto secondScopedRegisterDonateChunk = assertGet(_registry.registerDonateChunk(
+        createMoveChunkRequest(NamespaceString("TestDB", "TestColl2"))));
+    ASSERT(secondScopedRegisterDonateChunk.mustExecute());
+    ASSERT_EQ(2U, _registry.getActiveDonateChunkNamespaces().size());
+
+    // Only one migration per collection and no more than the limit per shard are allowed
+    auto thirdScopedRegisterDonateChunkStatus = _registry.registerDonateChunk(
+        createMoveChunkRequest(NamespaceString("TestDB", "TestColl3")));
+    ASSERT_EQ(ErrorCodes::ConflictingOperationInProgress,
+              thirdScopedRegisterDonateChunkStatus.getStatus());
+
+    firstScopedRegisterDonateChunk.complete(Status::OK());
+    secondScopedRegisterDonateChunk.complete(Status::OK());
+}
+
 TEST_F(MoveChunkRegistration, SecondMigrationWithSameArgumentsJoinsFirst) {
     auto originalScopedRegisterDonateChunk = assertGet(_registry.registerDonateChunk(
         createMoveChunkRequest(NamespaceString("TestDB", "TestColl"))));
@@ -37,6 +37,7 @@
 
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj_comparator_interface.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/s/catalog/sharding_catalog_client.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/catalog/type_collection.h"
@@ -57,6 +58,15 @@ using std::vector;
 
 namespace {
 
+// Maximum number of collections for which the balancer schedules chunk donations from the same
+// shard in a single round. Shards only accept more than one if their maxConcurrentChunkDonations
+// parameter allows it.
+MONGO_EXPORT_SERVER_PARAMETER(balancerMaxConcurrentDonationsPerShard, int, 1);
+
+// Shards, whose majority committed writes lag behind by more than this many seconds, are only given
+// one migration at a time.
+MONGO_EXPORT_SERVER_PARAMETER(balancerMaxReplicationLagSecs, int, 10);
+
 /**
  * Does a linear pass over the information cached in the specified chunk manager and extracts chunk
  * distrubution and chunk placement information which is needed by the balancer policy.
@@ -259,6 +269,10 @@ StatusWith<MigrateInfoVector> BalancerChunkSelectionPolicyImpl::selectChunksToMo
 
     MigrateInfoVector candidateChunks;
 
+    ShardMigrationSlots migrationSlots(
+        std::max(1, balancerMaxConcurrentDonationsPerShard.load()),
+        Seconds(std::max(0, balancerMaxReplicationLagSecs.load())));
+
     for (const auto& coll : collections) {
         if (coll.getDropped()) {
             continue;
@@ -271,8 +285,8 @@ StatusWith<MigrateInfoVector> BalancerChunkSelectionPolicyImpl::selectChunksToMo
             continue;
         }
 
-        auto candidatesStatus =
-            _getMigrateCandidatesForCollection(opCtx, nss, shardStats, aggressiveBalanceHint);
+        auto candidatesStatus = _getMigrateCandidatesForCollection(
+            opCtx, nss, shardStats, aggressiveBalanceHint, &migrationSlots);
         if (candidatesStatus == ErrorCodes::NamespaceNotFound) {
             // Namespace got dropped before we managed to get to it, so just skip it
             continue;
@@ -416,7 +430,8 @@ StatusWith<MigrateInfoVector> BalancerChunkSelectionPolicyImpl::_getMigrateCandi
     OperationContext* opCtx,
     const NamespaceString& nss,
     const ShardStatisticsVector& shardStats,
-    bool aggressiveBalanceHint) {
+    bool aggressiveBalanceHint,
+    ShardMigrationSlots* migrationSlots) {
     auto routingInfoStatus =
         Grid::get(opCtx)->catalogCache()->getShardedCollectionRoutingInfoWithRefresh(opCtx, nss);
     if (!routingInfoStatus.isOK()) {
@@ -475,7 +490,8 @@ StatusWith<MigrateInfoVector> BalancerChunkSelectionPolicyImpl::_getMigrateCandi
         }
     }
 
-    return BalancerPolicy::balance(shardStats, distribution, aggressiveBalanceHint);
+    return BalancerPolicy::balance(
+        shardStats, distribution, aggressiveBalanceHint, migrationSlots);
 }
 
 }  // namespace mongo
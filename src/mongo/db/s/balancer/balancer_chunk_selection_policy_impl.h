@@ -63,13 +63,15 @@ private:
 
     /**
      * Synchronous method, which iterates the collection's chunks and uses the cluster statistics to
-     * figure out where to place them.
+     * figure out where to place them. Only uses the shard migration slots, which are still
+     * available in this round.
      */
     StatusWith<MigrateInfoVector> _getMigrateCandidatesForCollection(
         OperationContext* opCtx,
         const NamespaceString& nss,
         const ShardStatisticsVector& shardStats,
-        bool aggressiveBalanceHint);
+        bool aggressiveBalanceHint,
+        ShardMigrationSlots* migrationSlots);
 
     // Source for obtaining cluster statistics. Not owned and must not be destroyed before the
     // policy object is destroyed.
@@ -32,7 +32,10 @@
 
 #include "mongo/db/s/balancer/balancer_policy.h"
 
+#include <algorithm>
+
 #include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/s/catalog/type_shard.h"
 #include "mongo/s/catalog/type_tags.h"
 #include "mongo/util/log.h"
@@ -53,6 +56,10 @@ namespace {
 const size_t kDefaultImbalanceThreshold = 2;
 const size_t kAggressiveImbalanceThreshold = 1;
 
+// Chunks are moved off a shard, whose load for a collection is more than this many times the
+// average load of the collection across all shards. Zero disables the load based balancing.
+MONGO_EXPORT_SERVER_PARAMETER(balancerLoadImbalanceRatio, double, 2.0);
+
 }  // namespace
 
 DistributionStatus::DistributionStatus(NamespaceString nss, ShardToChunksMap shardToChunksMap)
@@ -218,6 +225,69 @@ string DistributionStatus::toString() const {
     return builder.obj().toString();
 }
 
+ShardMigrationSlots::ShardMigrationSlots(size_t maxDonationsPerShard, Seconds maxReplicationLag)
+    : _maxDonationsPerShard(std::max<size_t>(1, maxDonationsPerShard)),
+      _maxReplicationLag(maxReplicationLag) {}
+
+bool ShardMigrationSlots::canDonate(const ClusterStatistics::ShardStatistics& stat,
+                                    const NamespaceString& nss) const {
+    if (_recipients.count(stat.shardId))
+        return false;
+
+    auto it = _donations.find(stat.shardId);
+    if (it == _donations.end())
+        return true;
+
+    if (it->second.count(nss.ns()) || _isLagging(stat))
+        return false;
+
+    return it->second.size() < _maxDonationsPerShard;
+}
+
+bool ShardMigrationSlots::canReceive(const ClusterStatistics::ShardStatistics& stat,
+                                     const ShardId& donor) const {
+    if (_recipients.count(stat.shardId) || _donations.count(stat.shardId))
+        return false;
+
+    // Do not add to the load of a lagging shard with the donor's additional migrations
+    return !_isLagging(stat) || !_donations.count(donor);
+}
+
+set<ShardId> ShardMigrationSlots::getUnavailableDonors(const ShardStatisticsVector& shardStats,
+                                                       const NamespaceString& nss) const {
+    set<ShardId> unavailableDonors;
+    for (const auto& stat : shardStats) {
+        if (!canDonate(stat, nss)) {
+            unavailableDonors.insert(stat.shardId);
+        }
+    }
+
+    return unavailableDonors;
+}
+
+set<ShardId> ShardMigrationSlots::getUnavailableRecipients(const ShardStatisticsVector& shardStats,
+                                                           const ShardId& donor) const {
+    set<ShardId> unavailableRecipients;
+    for (const auto& stat : shardStats) {
+        if (!canReceive(stat, donor)) {
+            unavailableRecipients.insert(stat.shardId);
+        }
+    }
+
+    return unavailableRecipients;
+}
+
+void ShardMigrationSlots::add(const MigrateInfo& migrateInfo) {
+    invariant(!_recipients.count(migrateInfo.from));
+    invariant(!_donations.count(migrateInfo.to));
+    invariant(_donations[migrateInfo.from].insert(migrateInfo.ns).second);
+    invariant(_recipients.insert(migrateInfo.to).second);
+}
+
+bool ShardMigrationSlots::_isLagging(const ClusterStatistics::ShardStatistics& stat) const {
+    return stat.replicationLag > _maxReplicationLag;
+}
+
 Status BalancerPolicy::isShardSuitableReceiver(const ClusterStatistics::ShardStatistics& stat,
                                                const string& chunkTag) {
     if (stat.isSizeMaxed()) {
@@ -293,11 +363,15 @@ ShardId BalancerPolicy::_getMostOverloadedShard(const ShardStatisticsVector& sha
 vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardStats,
                                             const DistributionStatus& distribution,
                                             bool shouldAggressivelyBalance) {
-    vector<MigrateInfo> migrations;
+    ShardMigrationSlots migrationSlots(1, Seconds::max());
+    return balance(shardStats, distribution, shouldAggressivelyBalance, &migrationSlots);
+}
 
-    // Set of shards, which have already been used for migrations. Used so we don't return multiple
-    // migrations for the same shard.
-    set<ShardId> usedShards;
+vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardStats,
+                                            const DistributionStatus& distribution,
+                                            bool shouldAggressivelyBalance,
+                                            ShardMigrationSlots* migrationSlots) {
+    vector<MigrateInfo> migrations;
 
     // 1) Check for shards, which are in draining mode or are above the size limit and must have
     // chunks moved off of them
@@ -306,7 +380,7 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
             if (!stat.isDraining && !stat.isSizeExceeded())
                 continue;
 
-            if (usedShards.count(stat.shardId))
+            if (!migrationSlots->canDonate(stat, distribution.nss()))
                 continue;
 
             const vector<ChunkType>& chunks = distribution.getChunks(stat.shardId);
@@ -327,8 +401,11 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
 
                 const string tag = distribution.getTagForChunk(chunk);
 
-                const ShardId to =
-                    _getLeastLoadedReceiverShard(shardStats, distribution, tag, usedShards);
+                const ShardId to = _getLeastLoadedReceiverShard(
+                    shardStats,
+                    distribution,
+                    tag,
+                    migrationSlots->getUnavailableRecipients(shardStats, stat.shardId));
                 if (!to.isValid()) {
                     if (migrations.empty()) {
                         warning() << "Chunk " << redact(chunk.toString())
@@ -339,8 +416,7 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
 
                 invariant(to != stat.shardId);
                 migrations.emplace_back(to, chunk);
-                invariant(usedShards.insert(stat.shardId).second);
-                invariant(usedShards.insert(to).second);
+                migrationSlots->add(migrations.back());
                 break;
             }
 
@@ -354,7 +430,7 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
     // 2) Check for chunks, which are on the wrong shard and must be moved off of it
     if (!distribution.tags().empty()) {
         for (const auto& stat : shardStats) {
-            if (usedShards.count(stat.shardId))
+            if (!migrationSlots->canDonate(stat, distribution.nss()))
                 continue;
 
             const vector<ChunkType>& chunks = distribution.getChunks(stat.shardId);
@@ -374,8 +450,11 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
                     continue;
                 }
 
-                const ShardId to =
-                    _getLeastLoadedReceiverShard(shardStats, distribution, tag, usedShards);
+                const ShardId to = _getLeastLoadedReceiverShard(
+                    shardStats,
+                    distribution,
+                    tag,
+                    migrationSlots->getUnavailableRecipients(shardStats, stat.shardId));
                 if (!to.isValid()) {
                     if (migrations.empty()) {
                         warning() << "Chunk " << redact(chunk.toString()) << " violates zone "
@@ -386,8 +465,7 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
 
                 invariant(to != stat.shardId);
                 migrations.emplace_back(to, chunk);
-                invariant(usedShards.insert(stat.shardId).second);
-                invariant(usedShards.insert(to).second);
+                migrationSlots->add(migrations.back());
                 break;
             }
         }
@@ -436,10 +514,13 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
                                   idealNumberOfChunksPerShardForTag,
                                   imbalanceThreshold,
                                   &migrations,
-                                  &usedShards))
+                                  migrationSlots))
             ;
     }
 
+    // 4) Move load off shards, which serve a disproportionate share of the collection's operations
+    _loadBalance(shardStats, distribution, &migrations, migrationSlots);
+
     return migrations;
 }
 
@@ -464,8 +545,12 @@ bool BalancerPolicy::_singleZoneBalance(const ShardStatisticsVector& shardStats,
                                         size_t idealNumberOfChunksPerShardForTag,
                                         size_t imbalanceThreshold,
                                         vector<MigrateInfo>* migrations,
-                                        set<ShardId>* usedShards) {
-    const ShardId from = _getMostOverloadedShard(shardStats, distribution, tag, *usedShards);
+                                        ShardMigrationSlots* migrationSlots) {
+    const ShardId from = _getMostOverloadedShard(
+        shardStats,
+        distribution,
+        tag,
+        migrationSlots->getUnavailableDonors(shardStats, distribution.nss()));
     if (!from.isValid())
         return false;
 
@@ -475,7 +560,8 @@ bool BalancerPolicy::_singleZoneBalance(const ShardStatisticsVector& shardStats,
     if (max <= idealNumberOfChunksPerShardForTag)
         return false;
 
-    const ShardId to = _getLeastLoadedReceiverShard(shardStats, distribution, tag, *usedShards);
+    const ShardId to = _getLeastLoadedReceiverShard(
+        shardStats, distribution, tag, migrationSlots->getUnavailableRecipients(shardStats, from));
     if (!to.isValid()) {
         if (migrations->empty()) {
             log() << "No available shards to take chunks for zone [" << tag << "]";
@@ -516,8 +602,7 @@ bool BalancerPolicy::_singleZoneBalance(const ShardStatisticsVector& shardStats,
         }
 
         migrations->emplace_back(to, chunk);
-        invariant(usedShards->insert(chunk.getShard()).second);
-        invariant(usedShards->insert(to).second);
+        migrationSlots->add(migrations->back());
         return true;
     }
 
@@ -530,6 +615,88 @@ bool BalancerPolicy::_singleZoneBalance(const ShardStatisticsVector& shardStats,
     return false;
 }
 
+bool BalancerPolicy::_loadBalance(const ShardStatisticsVector& shardStats,
+                                  const DistributionStatus& distribution,
+                                  vector<MigrateInfo>* migrations,
+                                  ShardMigrationSlots* migrationSlots) {
+    const double imbalanceRatio = balancerLoadImbalanceRatio.load();
+    if (imbalanceRatio <= 0 || shardStats.empty())
+        return false;
+
+    const string& ns = distribution.nss().ns();
+
+    double totalLoad = 0;
+    const ClusterStatistics::ShardStatistics* from = nullptr;
+    for (const auto& stat : shardStats) {
+        const double load = stat.getCollectionLoad(ns);
+        totalLoad += load;
+
+        if (!migrationSlots->canDonate(stat, distribution.nss()))
+            continue;
+
+        if (!from || load > from->getCollectionLoad(ns)) {
+            from = &stat;
+        }
+    }
+
+    if (!from || totalLoad <= 0)
+        return false;
+
+    const double averageLoad = totalLoad / shardStats.size();
+    const double fromLoad = from->getCollectionLoad(ns);
+
+    // Check whether it is necessary to balance the load
+    if (fromLoad <= averageLoad * imbalanceRatio)
+        return false;
+
+    const vector<ChunkType>& chunks = distribution.getChunks(from->shardId);
+
+    for (const auto& chunkLoad : from->collectionLoads.find(ns)->second.mostLoadedChunks) {
+        const auto chunkIt =
+            std::find_if(chunks.begin(), chunks.end(), [&chunkLoad](const ChunkType& chunk) {
+                return !chunk.getMin().woCompare(chunkLoad.first);
+            });
+
+        // The chunk may have been split or moved since its load was sampled
+        if (chunkIt == chunks.end() || chunkIt->getJumbo())
+            continue;
+
+        const string tag = distribution.getTagForChunk(*chunkIt);
+
+        const ClusterStatistics::ShardStatistics* to = nullptr;
+        for (const auto& stat : shardStats) {
+            if (stat.shardId == from->shardId || !migrationSlots->canReceive(stat, from->shardId))
+                continue;
+
+            if (!isShardSuitableReceiver(stat, tag).isOK())
+                continue;
+
+            if (!to || stat.getCollectionLoad(ns) < to->getCollectionLoad(ns)) {
+                to = &stat;
+            }
+        }
+
+        if (!to)
+            return false;
+
+        // Moving a chunk, which does not lower the highest load, would only move the hot spot
+        if (to->getCollectionLoad(ns) + chunkLoad.second >= fromLoad)
+            continue;
+
+        LOG(1) << "collection : " << ns;
+        LOG(1) << "donor      : " << from->shardId << " load " << fromLoad;
+        LOG(1) << "receiver   : " << to->shardId << " load " << to->getCollectionLoad(ns);
+        LOG(1) << "average    : " << averageLoad;
+        LOG(1) << "chunk      : " << redact(chunkIt->toString()) << " load " << chunkLoad.second;
+
+        migrations->emplace_back(to->shardId, *chunkIt);
+        migrationSlots->add(migrations->back());
+        return true;
+    }
+
+    return false;
+}
+
 ZoneRange::ZoneRange(const BSONObj& a_min, const BSONObj& a_max, const std::string& _zone)
     : min(a_min.getOwned()), max(a_max.getOwned()), zone(_zone) {}
 
@@ -34,6 +34,7 @@
 #include "mongo/db/s/balancer/cluster_statistics.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/client/shard.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -156,6 +157,65 @@ private:
     std::set<std::string> _allTags;
 };
 
+/**
+ * Keeps track of the migrations, which have already been selected for each shard during a balancing
+ * round, so that the collections can be balanced in parallel without scheduling more concurrent
+ * migrations on a shard than it is able to run.
+ *
+ * A shard can donate chunks of up to 'maxDonationsPerShard' different collections at a time, but
+ * only one chunk per collection. It can only receive one chunk at a time and cannot donate and
+ * receive chunks at the same time. Only one migration is scheduled on a shard, whose replication
+ * lag exceeds 'maxReplicationLag', and additional donations are never scheduled to such shards.
+ */
+class ShardMigrationSlots {
+public:
+    ShardMigrationSlots(size_t maxDonationsPerShard, Seconds maxReplicationLag);
+
+    /**
+     * Returns whether the specified shard can be the donor of a chunk for the given collection.
+     */
+    bool canDonate(const ClusterStatistics::ShardStatistics& stat,
+                   const NamespaceString& nss) const;
+
+    /**
+     * Returns whether the specified shard can receive a chunk from the given donor.
+     */
+    bool canReceive(const ClusterStatistics::ShardStatistics& stat, const ShardId& donor) const;
+
+    /**
+     * Returns the shards, which cannot be the donor of a chunk for the given collection.
+     */
+    std::set<ShardId> getUnavailableDonors(const ShardStatisticsVector& shardStats,
+                                           const NamespaceString& nss) const;
+
+    /**
+     * Returns the shards, which cannot receive a chunk from the given donor.
+     */
+    std::set<ShardId> getUnavailableRecipients(const ShardStatisticsVector& shardStats,
+                                               const ShardId& donor) const;
+
+    /**
+     * Occupies the slots on the donor and the recipient of the specified migration. The caller must
+     * have checked that they are available.
+     */
+    void add(const MigrateInfo& migrateInfo);
+
+private:
+    bool _isLagging(const ClusterStatistics::ShardStatistics& stat) const;
+
+    // Maximum number of collections a shard, which is not lagging, can donate chunks for at a time
+    const size_t _maxDonationsPerShard;
+
+    // Shards lagging by more than this are only given a single migration
+    const Seconds _maxReplicationLag;
+
+    // Namespaces of the collections each shard has been selected to donate chunks for
+    std::map<ShardId, std::set<std::string>> _donations;
+
+    // Shards, which have been selected to receive a chunk
+    std::set<ShardId> _recipients;
+};
+
 class BalancerPolicy {
 public:
     /**
@@ -179,10 +239,18 @@ public:
      *
      * The shouldAggressivelyBalance parameter causes the threshold for chunk could disparity
      * between shards to be lowered.
+     *
+     * The migrationSlots parameter accounts for the migrations, which have already been selected
+     * for other collections in the same round and is updated with the ones returned. The overload
+     * without it only allows a single migration per shard.
      */
     static std::vector<MigrateInfo> balance(const ShardStatisticsVector& shardStats,
                                             const DistributionStatus& distribution,
                                             bool shouldAggressivelyBalance);
+    static std::vector<MigrateInfo> balance(const ShardStatisticsVector& shardStats,
+                                            const DistributionStatus& distribution,
+                                            bool shouldAggressivelyBalance,
+                                            ShardMigrationSlots* migrationSlots);
 
     /**
      * Using the specified distribution information, returns a suggested better location for the
@@ -229,7 +297,20 @@ private:
                                    size_t idealNumberOfChunksPerShardForTag,
                                    size_t imbalanceThreshold,
                                    std::vector<MigrateInfo>* migrations,
-                                   std::set<ShardId>* usedShards);
+                                   ShardMigrationSlots* migrationSlots);
+
+    /**
+     * Selects the most loaded chunk of the shard, which has the highest load for the collection,
+     * to be moved to the least loaded shard, which can take it, if the shard's load exceeds the
+     * average load by more than balancerLoadImbalanceRatio and the move lowers the highest load.
+     * Takes into account and updates the shards, which have already been used for migrations.
+     *
+     * Returns true if a migration was suggested, false otherwise.
+     */
+    static bool _loadBalance(const ShardStatisticsVector& shardStats,
+                             const DistributionStatus& distribution,
+                             std::vector<MigrateInfo>* migrations,
+                             ShardMigrationSlots* migrationSlots);
 };
 
 }  // namespace mongo
@@ -190,6 +190,107 @@ TEST(BalancerPolicy, ParallelBalancing) {
     ASSERT_BSONOBJ_EQ(cluster.second[kShardId1][0].getMax(), migrations[1].maxKey);
 }
 
+/**
+ * Returns a copy of the specified chunk mapping, which is for the given namespace.
+ */
+ShardToChunksMap copyChunksForNamespace(const ShardToChunksMap& chunkMap,
+                                        const NamespaceString& nss) {
+    ShardToChunksMap chunkMapCopy(chunkMap);
+    for (auto& entry : chunkMapCopy) {
+        for (auto& chunk : entry.second) {
+            chunk.setNS(nss.ns());
+        }
+    }
+
+    return chunkMapCopy;
+}
+
+TEST(BalancerPolicy, ParallelBalancingOfDifferentCollectionsFromTheSameDonor) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 4, false, emptyTagSet, emptyShardVersion), 4},
+         {ShardStatistics(kShardId1, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 0},
+         {ShardStatistics(kShardId2, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 0}});
+
+    const NamespaceString otherNamespace("TestDB", "OtherTestColl");
+
+    ShardMigrationSlots migrationSlots(2, Seconds(10));
+
+    const auto migrations(BalancerPolicy::balance(
+        cluster.first, DistributionStatus(kNamespace, cluster.second), false, &migrationSlots));
+    ASSERT_EQ(1U, migrations.size());
+    ASSERT_EQ(kShardId0, migrations[0].from);
+
+    const auto otherMigrations(BalancerPolicy::balance(
+        cluster.first,
+        DistributionStatus(otherNamespace, copyChunksForNamespace(cluster.second, otherNamespace)),
+        false,
+        &migrationSlots));
+    ASSERT_EQ(1U, otherMigrations.size());
+    ASSERT_EQ(kShardId0, otherMigrations[0].from);
+    ASSERT_EQ(otherNamespace.ns(), otherMigrations[0].ns);
+    ASSERT_NE(migrations[0].to, otherMigrations[0].to);
+}
+
+TEST(BalancerPolicy, ParallelBalancingOfDifferentCollectionsThrottledByReplicationLag) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 4, false, emptyTagSet, emptyShardVersion), 4},
+         {ShardStatistics(kShardId1, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 0},
+         {ShardStatistics(kShardId2, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion), 0}});
+    cluster.first[0].replicationLag = Seconds(60);
+
+    const NamespaceString otherNamespace("TestDB", "OtherTestColl");
+
+    ShardMigrationSlots migrationSlots(2, Seconds(10));
+
+    const auto migrations(BalancerPolicy::balance(
+        cluster.first, DistributionStatus(kNamespace, cluster.second), false, &migrationSlots));
+    ASSERT_EQ(1U, migrations.size());
+    ASSERT_EQ(kShardId0, migrations[0].from);
+
+    ASSERT(BalancerPolicy::balance(
+               cluster.first,
+               DistributionStatus(otherNamespace,
+                                  copyChunksForNamespace(cluster.second, otherNamespace)),
+               false,
+               &migrationSlots)
+               .empty());
+}
+
+TEST(BalancerPolicy, MostLoadedChunkMovedOffOverloadedShard) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 2, false, emptyTagSet, emptyShardVersion), 2},
+         {ShardStatistics(kShardId1, kNoMaxSize, 2, false, emptyTagSet, emptyShardVersion), 2},
+         {ShardStatistics(kShardId2, kNoMaxSize, 2, false, emptyTagSet, emptyShardVersion), 2}});
+
+    auto& collectionLoad = cluster.first[0].collectionLoads[kNamespace.ns()];
+    collectionLoad.load = 100;
+    collectionLoad.mostLoadedChunks = {{cluster.second[kShardId0][1].getMin(), 80},
+                                       {cluster.second[kShardId0][0].getMin(), 20}};
+
+    const auto migrations(BalancerPolicy::balance(
+        cluster.first, DistributionStatus(kNamespace, cluster.second), false));
+    ASSERT_EQ(1U, migrations.size());
+    ASSERT_EQ(kShardId0, migrations[0].from);
+    ASSERT_EQ(kShardId1, migrations[0].to);
+    ASSERT_BSONOBJ_EQ(cluster.second[kShardId0][1].getMin(), migrations[0].minKey);
+    ASSERT_BSONOBJ_EQ(cluster.second[kShardId0][1].getMax(), migrations[0].maxKey);
+}
+
+TEST(BalancerPolicy, SingleHotChunkNotMovedBetweenShards) {
+    auto cluster = generateCluster(
+        {{ShardStatistics(kShardId0, kNoMaxSize, 2, false, emptyTagSet, emptyShardVersion), 2},
+         {ShardStatistics(kShardId1, kNoMaxSize, 2, false, emptyTagSet, emptyShardVersion), 2},
+         {ShardStatistics(kShardId2, kNoMaxSize, 2, false, emptyTagSet, emptyShardVersion), 2}});
+
+    auto& collectionLoad = cluster.first[0].collectionLoads[kNamespace.ns()];
+    collectionLoad.load = 100;
+    collectionLoad.mostLoadedChunks = {{cluster.second[kShardId0][1].getMin(), 100}};
+
+    ASSERT(BalancerPolicy::balance(
+               cluster.first, DistributionStatus(kNamespace, cluster.second), false)
+               .empty());
+}
+
 TEST(BalancerPolicy, ParallelBalancingDoesNotPutChunksOnShardsAboveTheOptimal) {
     auto cluster = generateCluster(
         {{ShardStatistics(kShardId0, kNoMaxSize, 100, false, emptyTagSet, emptyShardVersion), 100},
@@ -68,6 +68,15 @@ bool ClusterStatistics::ShardStatistics::isSizeExceeded() const {
     return currSizeMB > maxSizeMB;
 }
 
+double ClusterStatistics::ShardStatistics::getCollectionLoad(const std::string& ns) const {
+    auto it = collectionLoads.find(ns);
+    if (it == collectionLoads.end()) {
+        return 0;
+    }
+
+    return it->second.load;
+}
+
 BSONObj ClusterStatistics::ShardStatistics::toBSON() const {
     BSONObjBuilder builder;
     builder.append("id", shardId.toString());
@@ -80,6 +89,7 @@ BSONObj ClusterStatistics::ShardStatistics::toBSON() const {
     }
 
     builder.append("version", mongoVersion);
+    builder.append("replicationLagSecs", durationCount<Seconds>(replicationLag));
     return builder.obj();
 }
 
@@ -28,13 +28,16 @@
 
 #pragma once
 
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
 #include "mongo/s/client/shard.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -52,6 +55,18 @@ class ClusterStatistics {
     MONGO_DISALLOW_COPYING(ClusterStatistics);
 
 public:
+    /**
+     * Structure, which describes the load which the chunks of a collection put on a shard. The load
+     * is the cost per second of the sampled operations against the chunks.
+     */
+    struct CollectionLoad {
+        // Load of all the chunks of the collection, which live on the shard
+        double load{0};
+
+        // Min keys and loads of the most loaded chunks, in decreasing order of load
+        std::vector<std::pair<BSONObj, double>> mostLoadedChunks;
+    };
+
     /**
      * Structure, which describes the statistics of a single shard host.
      */
@@ -76,6 +91,12 @@ public:
          */
         bool isSizeExceeded() const;
 
+        /**
+         * Returns the load, which the chunks of the specified collection put on this shard. Zero if
+         * no load has been reported for it.
+         */
+        double getCollectionLoad(const std::string& ns) const;
+
         /**
          * Returns BSON representation of this shard's statistics, for reporting purposes.
          */
@@ -98,6 +119,12 @@ public:
 
         // Version of mongod, which runs on this shard's primary
         std::string mongoVersion;
+
+        // How far the majority of this shard's replica set members lag behind its primary
+        Seconds replicationLag{0};
+
+        // Load of the chunks on this shard for the collections, which reported any
+        std::map<std::string, CollectionLoad> collectionLoads;
     };
 
     virtual ~ClusterStatistics();
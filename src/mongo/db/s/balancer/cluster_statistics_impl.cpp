@@ -32,9 +32,12 @@
 
 #include "mongo/db/s/balancer/cluster_statistics_impl.h"
 
+#include <algorithm>
+
 #include "mongo/base/status_with.h"
 #include "mongo/bson/util/bson_extract.h"
 #include "mongo/client/read_preference.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/s/catalog/sharding_catalog_client.h"
 #include "mongo/s/catalog/type_shard.h"
 #include "mongo/s/client/shard_registry.h"
@@ -50,17 +53,31 @@ using std::vector;
 
 namespace {
 
+// Cost of a single read and write against a chunk, used to compute the load of the chunks based on
+// the operations sampled by the shards.
+MONGO_EXPORT_SERVER_PARAMETER(balancerChunkReadCost, double, 1.0);
+MONGO_EXPORT_SERVER_PARAMETER(balancerChunkWriteCost, double, 1.0);
+
 const char kVersionField[] = "version";
+const char kReplField[] = "repl";
+const char kLastWriteField[] = "lastWrite";
+const char kLastWriteDateField[] = "lastWriteDate";
+const char kMajorityWriteDateField[] = "majorityWriteDate";
+const char kChunkLoadField[] = "chunkLoad";
+const char kCollectionsField[] = "collections";
+const char kNsField[] = "ns";
+const char kChunksField[] = "chunks";
+const char kMinField[] = "min";
+const char kReadsField[] = "reads";
+const char kWritesField[] = "writes";
 
 /**
- * Executes the serverStatus command against the specified shard and obtains the version of the
- * running MongoD service.
+ * Executes the serverStatus command against the specified shard and returns its response.
  *
- * Returns the MongoD version in strig format or an error. Known error codes are:
+ * Known error codes are:
  *  ShardNotFound if shard by that id is not available on the registry
- *  NoSuchKey if the version could not be retrieved
  */
-StatusWith<string> retrieveShardMongoDVersion(OperationContext* opCtx, ShardId shardId) {
+StatusWith<BSONObj> retrieveShardServerStatus(OperationContext* opCtx, ShardId shardId) {
     auto shardRegistry = Grid::get(opCtx)->shardRegistry();
     auto shardStatus = shardRegistry->getShard(opCtx, shardId);
     if (!shardStatus.isOK()) {
@@ -72,7 +89,7 @@ StatusWith<string> retrieveShardMongoDVersion(OperationContext* opCtx, ShardId s
         shard->runCommandWithFixedRetryAttempts(opCtx,
                                                 ReadPreferenceSetting{ReadPreference::PrimaryOnly},
                                                 "admin",
-                                                BSON("serverStatus" << 1),
+                                                BSON("serverStatus" << 1 << kChunkLoadField << 1),
                                                 Shard::RetryPolicy::kIdempotent);
     if (!commandResponse.isOK()) {
         return commandResponse.getStatus();
@@ -81,8 +98,16 @@ StatusWith<string> retrieveShardMongoDVersion(OperationContext* opCtx, ShardId s
         return commandResponse.getValue().commandStatus;
     }
 
-    BSONObj serverStatus = std::move(commandResponse.getValue().response);
+    return std::move(commandResponse.getValue().response);
+}
 
+/**
+ * Obtains the version of the running MongoD service from the specified serverStatus response.
+ *
+ * Returns the MongoD version in strig format or an error. Known error codes are:
+ *  NoSuchKey if the version could not be retrieved
+ */
+StatusWith<string> extractShardMongoDVersion(const BSONObj& serverStatus) {
     string version;
     Status status = bsonExtractStringField(serverStatus, kVersionField, &version);
     if (!status.isOK()) {
@@ -92,8 +117,79 @@ StatusWith<string> retrieveShardMongoDVersion(OperationContext* opCtx, ShardId s
     return version;
 }
 
+/**
+ * Obtains from the specified serverStatus response how far the majority committed write of the
+ * shard's replica set is behind the last write on its primary. Returns zero if the shard is not a
+ * replica set or the information is not available.
+ */
+Seconds extractShardReplicationLag(const BSONObj& serverStatus) {
+    const BSONElement lastWriteElem = serverStatus[kReplField][kLastWriteField];
+    if (lastWriteElem.type() != Object) {
+        return Seconds(0);
+    }
+
+    const BSONObj lastWrite = lastWriteElem.Obj();
+    if (lastWrite[kLastWriteDateField].type() != Date ||
+        lastWrite[kMajorityWriteDateField].type() != Date) {
+        return Seconds(0);
+    }
+
+    const auto lag = duration_cast<Seconds>(lastWrite[kLastWriteDateField].Date() -
+                                            lastWrite[kMajorityWriteDateField].Date());
+    return std::max(lag, Seconds(0));
+}
+
+/**
+ * Obtains from the specified serverStatus response the load, which the chunks of each collection
+ * put on the shard. Shards, which do not sample their operations, do not report any load.
+ */
+std::map<string, ClusterStatistics::CollectionLoad> extractShardCollectionLoads(
+    const BSONObj& serverStatus) {
+    std::map<string, ClusterStatistics::CollectionLoad> collectionLoads;
+
+    const BSONElement collectionsElem = serverStatus[kChunkLoadField][kCollectionsField];
+    if (collectionsElem.type() != Array) {
+        return collectionLoads;
+    }
+
+    const double readCost = balancerChunkReadCost.load();
+    const double writeCost = balancerChunkWriteCost.load();
+
+    for (const auto& collectionElem : collectionsElem.Obj()) {
+        if (collectionElem.type() != Object)
+            continue;
+
+        const BSONObj collection = collectionElem.Obj();
+        auto& collectionLoad = collectionLoads[collection[kNsField].str()];
+        collectionLoad.load = readCost * collection[kReadsField].numberDouble() +
+            writeCost * collection[kWritesField].numberDouble();
+
+        if (collection[kChunksField].type() != Array)
+            continue;
+
+        for (const auto& chunkElem : collection[kChunksField].Obj()) {
+            if (chunkElem.type() != Object || chunkElem[kMinField].type() != Object)
+                continue;
+
+            collectionLoad.mostLoadedChunks.emplace_back(
+                chunkElem[kMinField].Obj().getOwned(),
+                readCost * chunkElem[kReadsField].numberDouble() +
+                    writeCost * chunkElem[kWritesField].numberDouble());
+        }
+
+        std::sort(collectionLoad.mostLoadedChunks.begin(),
+                  collectionLoad.mostLoadedChunks.end(),
+                  [](const std::pair<BSONObj, double>& lhs, const std::pair<BSONObj, double>& rhs) {
+                      return lhs.second > rhs.second;
+                  });
+    }
+
+    return collectionLoads;
+}
+
 }  // namespace
 
+using CollectionLoad = ClusterStatistics::CollectionLoad;
 using ShardStatistics = ClusterStatistics::ShardStatistics;
 
 ClusterStatisticsImpl::ClusterStatisticsImpl() = default;
@@ -129,8 +225,12 @@ StatusWith<vector<ShardStatistics>> ClusterStatisticsImpl::getStats(OperationCon
         }
 
         string mongoDVersion;
+        Seconds replicationLag(0);
 
-        auto mongoDVersionStatus = retrieveShardMongoDVersion(opCtx, shard.getName());
+        auto serverStatus = retrieveShardServerStatus(opCtx, shard.getName());
+        auto mongoDVersionStatus = serverStatus.isOK()
+            ? extractShardMongoDVersion(serverStatus.getValue())
+            : StatusWith<string>(serverStatus.getStatus());
         if (mongoDVersionStatus.isOK()) {
             mongoDVersion = std::move(mongoDVersionStatus.getValue());
         } else {
@@ -140,6 +240,15 @@ StatusWith<vector<ShardStatistics>> ClusterStatisticsImpl::getStats(OperationCon
                   << causedBy(mongoDVersionStatus.getStatus());
         }
 
+        // The replication lag is only used to throttle concurrent migrations and the load only
+        // refines the chunk count based balancing, so if they cannot be retrieved the shard is
+        // treated as neither lagging nor loaded
+        std::map<string, CollectionLoad> collectionLoads;
+        if (serverStatus.isOK()) {
+            replicationLag = extractShardReplicationLag(serverStatus.getValue());
+            collectionLoads = extractShardCollectionLoads(serverStatus.getValue());
+        }
+
         std::set<string> shardTags;
 
         for (const auto& shardTag : shard.getTags()) {
@@ -152,6 +261,8 @@ StatusWith<vector<ShardStatistics>> ClusterStatisticsImpl::getStats(OperationCon
                            shard.getDraining(),
                            std::move(shardTags),
                            std::move(mongoDVersion));
+        stats.back().replicationLag = replicationLag;
+        stats.back().collectionLoads = std::move(collectionLoads);
     }
 
     return stats;
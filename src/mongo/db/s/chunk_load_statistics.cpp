@@ -0,0 +1,213 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/s/chunk_load_statistics.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+namespace {
+
+// One in this many of the operations, which target a single chunk, are recorded. Zero disables the
+// sampling.
+MONGO_EXPORT_SERVER_PARAMETER(chunkLoadSampleRate, int, 100);
+
+const auto getChunkLoadStatistics = ServiceContext::declareDecoration<ChunkLoadStatistics>();
+
+}  // namespace
+
+const Seconds ChunkLoadStatistics::kWindow{60};
+
+const size_t ChunkLoadStatistics::kMaxReportedChunksPerCollection = 50;
+
+ChunkLoadStatistics::ChunkLoadStatistics() = default;
+
+ChunkLoadStatistics* ChunkLoadStatistics::get(ServiceContext* serviceContext) {
+    return &getChunkLoadStatistics(serviceContext);
+}
+
+ChunkLoadStatistics* ChunkLoadStatistics::get(OperationContext* opCtx) {
+    return get(opCtx->getServiceContext());
+}
+
+bool ChunkLoadStatistics::shouldSample() {
+    const int sampleRate = chunkLoadSampleRate.load();
+    if (sampleRate <= 0) {
+        return false;
+    }
+
+    return _sampleCounter.fetchAndAdd(1) % sampleRate == 0;
+}
+
+int ChunkLoadStatistics::getSampleRate() const {
+    return std::max(1, chunkLoadSampleRate.load());
+}
+
+void ChunkLoadStatistics::recordRead(const NamespaceString& nss,
+                                     const BSONObj& chunkMin,
+                                     Date_t now) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _getCurrent_inlock(nss, chunkMin, now).reads += getSampleRate();
+}
+
+void ChunkLoadStatistics::recordWrite(const NamespaceString& nss,
+                                      const BSONObj& chunkMin,
+                                      Date_t now) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _getCurrent_inlock(nss, chunkMin, now).writes += getSampleRate();
+}
+
+void ChunkLoadStatistics::report(BSONObjBuilder* builder, Date_t now) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _rotate_inlock(now);
+
+    const Milliseconds elapsed = (now - _windowStart) + (_hasPreviousWindow ? kWindow : Seconds(0));
+    const double elapsedSecs =
+        std::max(1.0, static_cast<double>(durationCount<Milliseconds>(elapsed)) / 1000);
+
+    builder->append("windowSecs", durationCount<Seconds>(kWindow));
+
+    BSONArrayBuilder collectionsArr(builder->subarrayStart("collections"));
+    for (const auto& collection : _collections) {
+        OperationCounts collectionCounts;
+
+        std::vector<std::pair<long long, CollectionLoad::const_iterator>> chunks;
+        for (auto it = collection.second.begin(); it != collection.second.end(); ++it) {
+            const auto& chunkLoad = it->second;
+            const long long reads = chunkLoad.current.reads + chunkLoad.previous.reads;
+            const long long writes = chunkLoad.current.writes + chunkLoad.previous.writes;
+
+            collectionCounts.reads += reads;
+            collectionCounts.writes += writes;
+            chunks.emplace_back(reads + writes, it);
+        }
+
+        const size_t numReported = std::min(chunks.size(), kMaxReportedChunksPerCollection);
+        std::partial_sort(
+            chunks.begin(),
+            chunks.begin() + numReported,
+            chunks.end(),
+            [](const std::pair<long long, CollectionLoad::const_iterator>& lhs,
+               const std::pair<long long, CollectionLoad::const_iterator>& rhs) {
+                return lhs.first > rhs.first;
+            });
+
+        BSONObjBuilder collectionBuilder(collectionsArr.subobjStart());
+        collectionBuilder.append("ns", collection.first);
+        collectionBuilder.append("reads", collectionCounts.reads / elapsedSecs);
+        collectionBuilder.append("writes", collectionCounts.writes / elapsedSecs);
+
+        BSONArrayBuilder chunksArr(collectionBuilder.subarrayStart("chunks"));
+        for (size_t i = 0; i < numReported; i++) {
+            const auto& chunkLoad = chunks[i].second->second;
+
+            BSONObjBuilder chunkBuilder(chunksArr.subobjStart());
+            chunkBuilder.append("min", chunks[i].second->first);
+            chunkBuilder.append("reads",
+                                (chunkLoad.current.reads + chunkLoad.previous.reads) / elapsedSecs);
+            chunkBuilder.append(
+                "writes", (chunkLoad.current.writes + chunkLoad.previous.writes) / elapsedSecs);
+            chunkBuilder.doneFast();
+        }
+        chunksArr.doneFast();
+
+        collectionBuilder.doneFast();
+    }
+    collectionsArr.doneFast();
+}
+
+ChunkLoadStatistics::OperationCounts& ChunkLoadStatistics::_getCurrent_inlock(
+    const NamespaceString& nss, const BSONObj& chunkMin, Date_t now) {
+    _rotate_inlock(now);
+
+    auto collectionIt = _collections.find(nss.ns());
+    if (collectionIt == _collections.end()) {
+        collectionIt = _collections
+                           .emplace(nss.ns(),
+                                    SimpleBSONObjComparator::kInstance
+                                        .makeBSONObjIndexedMap<ChunkLoad>())
+                           .first;
+    }
+
+    auto chunkIt = collectionIt->second.find(chunkMin);
+    if (chunkIt == collectionIt->second.end()) {
+        chunkIt = collectionIt->second.emplace(chunkMin.getOwned(), ChunkLoad()).first;
+    }
+
+    return chunkIt->second.current;
+}
+
+void ChunkLoadStatistics::_rotate_inlock(Date_t now) {
+    if (_windowStart == Date_t()) {
+        _windowStart = now;
+        return;
+    }
+
+    if (now - _windowStart < kWindow) {
+        return;
+    }
+
+    // If more than a whole window has passed without rotation, the current counts are too old to
+    // be used as the previous window
+    const bool keepCurrent = (now - _windowStart < kWindow * 2);
+
+    for (auto collectionIt = _collections.begin(); collectionIt != _collections.end();) {
+        auto& chunks = collectionIt->second;
+        for (auto chunkIt = chunks.begin(); chunkIt != chunks.end();) {
+            auto& chunkLoad = chunkIt->second;
+            chunkLoad.previous = keepCurrent ? chunkLoad.current : OperationCounts();
+            chunkLoad.current = OperationCounts();
+
+            if (!chunkLoad.previous.reads && !chunkLoad.previous.writes) {
+                chunkIt = chunks.erase(chunkIt);
+            } else {
+                ++chunkIt;
+            }
+        }
+
+        if (chunks.empty()) {
+            collectionIt = _collections.erase(collectionIt);
+        } else {
+            ++collectionIt;
+        }
+    }
+
+    _hasPreviousWindow = keepCurrent;
+    _windowStart = now;
+}
+
+}  // namespace mongo
@@ -0,0 +1,146 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <map>
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class NamespaceString;
+class OperationContext;
+class ServiceContext;
+
+/**
+ * Keeps the recent rates of the operations, which target individual chunks of the sharded
+ * collections on this shard, so that the balancer can take the load of the chunks into account.
+ * Only one in every chunkLoadSampleRate operations is recorded and it counts for all of them.
+ *
+ * The rates are computed over the current and the previous window of kWindow length, so reporting
+ * them does not reset any state and they can be reported to any number of callers.
+ *
+ * There is one instance of this object per service context and it is thread-safe.
+ */
+class ChunkLoadStatistics {
+    MONGO_DISALLOW_COPYING(ChunkLoadStatistics);
+
+public:
+    // Length of the window over which operations are counted
+    static const Seconds kWindow;
+
+    // Maximum number of chunks per collection, for which the rates are reported
+    static const size_t kMaxReportedChunksPerCollection;
+
+    ChunkLoadStatistics();
+
+    /**
+     * Retrieves the ChunkLoadStatistics associated with the specified service context.
+     */
+    static ChunkLoadStatistics* get(ServiceContext* serviceContext);
+    static ChunkLoadStatistics* get(OperationContext* opCtx);
+
+    /**
+     * Returns whether the current operation should be recorded. Cheap enough to be called on every
+     * operation.
+     */
+    bool shouldSample();
+
+    /**
+     * Returns the number of operations, which every sampled operation stands for.
+     */
+    int getSampleRate() const;
+
+    /**
+     * Records one sampled read or write against the chunk starting at 'chunkMin' of the specified
+     * collection.
+     */
+    void recordRead(const NamespaceString& nss, const BSONObj& chunkMin, Date_t now);
+    void recordWrite(const NamespaceString& nss, const BSONObj& chunkMin, Date_t now);
+
+    /**
+     * Appends the per second rates of reads and writes against every collection and the most
+     * loaded of its chunks in the following format:
+     *
+     * { windowSecs: <seconds>, collections: [ { ns: <ns>, reads: <rate>, writes: <rate>,
+     *                                           chunks: [ { min: <key>, reads: <rate>,
+     *                                                       writes: <rate> }, ... ] }, ... ] }
+     */
+    void report(BSONObjBuilder* builder, Date_t now);
+
+private:
+    struct OperationCounts {
+        long long reads{0};
+        long long writes{0};
+    };
+
+    struct ChunkLoad {
+        OperationCounts current;
+        OperationCounts previous;
+    };
+
+    using CollectionLoad = BSONObjIndexedMap<ChunkLoad>;
+
+    /**
+     * Returns the counts of the chunk starting at 'chunkMin', creating them if needed.
+     */
+    OperationCounts& _getCurrent_inlock(const NamespaceString& nss,
+                                        const BSONObj& chunkMin,
+                                        Date_t now);
+
+    /**
+     * Starts a new window if the current one has ended and drops the chunks, which have not seen
+     * any operations in the last two windows.
+     */
+    void _rotate_inlock(Date_t now);
+
+    // Used to pick which operations are sampled
+    AtomicUInt64 _sampleCounter;
+
+    // Protects the state below
+    stdx::mutex _mutex;
+
+    // When the current window started
+    Date_t _windowStart;
+
+    // Whether the previous window contains any counts
+    bool _hasPreviousWindow{false};
+
+    // Per collection map of chunk min key to the operations counted against the chunk
+    std::map<std::string, CollectionLoad> _collections;
+};
+
+}  // namespace mongo
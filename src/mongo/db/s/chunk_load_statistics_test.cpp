@@ -0,0 +1,89 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/s/chunk_load_statistics.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("TestDB", "TestColl");
+
+BSONObj report(ChunkLoadStatistics* stats, Date_t now) {
+    BSONObjBuilder builder;
+    stats->report(&builder, now);
+    return builder.obj();
+}
+
+TEST(ChunkLoadStatistics, ReportsMostLoadedChunksFirst) {
+    ChunkLoadStatistics stats;
+    const Date_t start = Date_t::fromMillisSinceEpoch(1000000);
+
+    stats.recordRead(kNss, BSON("x" << 0), start);
+    stats.recordWrite(kNss, BSON("x" << 10), start);
+    stats.recordWrite(kNss, BSON("x" << 10), start);
+
+    const BSONObj result = report(&stats, start + Seconds(10));
+    ASSERT_EQ(ChunkLoadStatistics::kWindow.count(), result["windowSecs"].numberLong());
+
+    const auto collections = result["collections"].Array();
+    ASSERT_EQ(1U, collections.size());
+    ASSERT_EQ(kNss.ns(), collections[0]["ns"].String());
+    ASSERT_GT(collections[0]["writes"].numberDouble(), collections[0]["reads"].numberDouble());
+
+    const auto chunks = collections[0]["chunks"].Array();
+    ASSERT_EQ(2U, chunks.size());
+    ASSERT_BSONOBJ_EQ(BSON("x" << 10), chunks[0]["min"].Obj());
+    ASSERT_EQ(0, chunks[0]["reads"].numberDouble());
+    ASSERT_GT(chunks[0]["writes"].numberDouble(), 0);
+    ASSERT_BSONOBJ_EQ(BSON("x" << 0), chunks[1]["min"].Obj());
+    ASSERT_GT(chunks[1]["reads"].numberDouble(), 0);
+}
+
+TEST(ChunkLoadStatistics, ForgetsChunksWithoutRecentOperations) {
+    ChunkLoadStatistics stats;
+    const Date_t start = Date_t::fromMillisSinceEpoch(1000000);
+
+    stats.recordRead(kNss, BSON("x" << 0), start);
+
+    // The operations of the previous window are still accounted for
+    auto collections = report(&stats, start + ChunkLoadStatistics::kWindow)["collections"].Array();
+    ASSERT_EQ(1U, collections.size());
+    ASSERT_GT(collections[0]["reads"].numberDouble(), 0);
+
+    collections =
+        report(&stats, start + ChunkLoadStatistics::kWindow * 2)["collections"].Array();
+    ASSERT(collections.empty());
+}
+
+}  // namespace
+}  // namespace mongo
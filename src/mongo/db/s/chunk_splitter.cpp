@@ -0,0 +1,375 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kSharding
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/s/chunk_splitter.h"
+
+#include "mongo/client/dbclientcursor.h"
+#include "mongo/client/query.h"
+#include "mongo/db/auth/authorization_manager_global.h"
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/client.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/keypattern.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/s/collection_metadata.h"
+#include "mongo/db/s/sharding_state.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+#include "mongo/s/balancer_configuration.h"
+#include "mongo/s/catalog/sharding_catalog_client.h"
+#include "mongo/s/catalog/type_chunk.h"
+#include "mongo/s/catalog/type_collection.h"
+#include "mongo/s/catalog_cache.h"
+#include "mongo/s/config_server_client.h"
+#include "mongo/s/grid.h"
+#include "mongo/s/shard_key_pattern.h"
+#include "mongo/s/shard_util.h"
+#include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+// Whether the shard primary tracks the data written to its chunks and splits them when they grow
+// too big. Should be turned off only if mongos is still relied on to make the auto-split decisions.
+MONGO_EXPORT_SERVER_PARAMETER(shardAutoSplit, bool, true);
+
+// Test whether we should split once data * splitTestFactor > chunkSize (approximately)
+const long long kSplitTestFactor = 5;
+
+const auto getChunkSplitter = ServiceContext::declareDecoration<ChunkSplitter>();
+
+/**
+ * Constructs the options for the auto-split thread pool.
+ */
+ThreadPool::Options makeDefaultThreadPoolOptions() {
+    ThreadPool::Options options;
+    options.poolName = "ChunkSplitter";
+    options.minThreads = 0;
+    options.maxThreads = 4;
+
+    // Ensure all threads have a client.
+    options.onCreateThread = [](const std::string& threadName) {
+        Client::initThread(threadName.c_str());
+    };
+
+    return options;
+}
+
+/**
+ * Returns the split point that will result in one of the chunks having exactly one document, if the
+ * chunk is the first or the last chunk of the collection. Otherwise, or if the split point cannot
+ * be determined, returns an empty document.
+ *
+ * The assumption is that such a chunk is likely to see more insertions if the shard key is
+ * monotonically increasing or decreasing, so the split leaves most of the data in a chunk, which
+ * will not grow further. This heuristic is skipped for "special" shard key patterns that are not
+ * likely to produce such values (e.g. hashed shard keys).
+ */
+BSONObj findExtremeKeyForChunk(OperationContext* opCtx,
+                               const NamespaceString& nss,
+                               const ShardKeyPattern& shardKeyPattern,
+                               const ChunkRange& chunkRange) {
+    if (!KeyPattern::isOrderedKeyPattern(shardKeyPattern.toBSON())) {
+        return BSONObj();
+    }
+
+    const KeyPattern& keyPattern = shardKeyPattern.getKeyPattern();
+    const bool minIsInf = (0 == keyPattern.globalMin().woCompare(chunkRange.getMin()));
+    const bool maxIsInf = (0 == keyPattern.globalMax().woCompare(chunkRange.getMax()));
+    if (!minIsInf && !maxIsInf) {
+        return BSONObj();
+    }
+
+    Query q;
+
+    if (minIsInf) {
+        q.sort(shardKeyPattern.toBSON());
+    } else {
+        // need to invert shard key pattern to sort backwards
+        BSONObjBuilder r;
+
+        BSONObjIterator i(shardKeyPattern.toBSON());
+        while (i.more()) {
+            BSONElement e = i.next();
+            uassert(40644, "can only handle numbers here - which i think is correct", e.isNumber());
+            r.append(e.fieldName(), -1 * e.number());
+        }
+
+        q.sort(r.obj());
+    }
+
+    DBDirectClient client(opCtx);
+
+    BSONObj end;
+
+    if (minIsInf) {
+        // Splitting close to the lower bound means that the split point will be the upper bound.
+        // Chunk range upper bounds are exclusive so skip a document to make the lower half of the
+        // split end up with a single document.
+        std::unique_ptr<DBClientCursor> cursor = client.query(nss.ns(),
+                                                              q,
+                                                              1, /* nToReturn */
+                                                              1 /* nToSkip */);
+
+        if (cursor && cursor->more()) {
+            end = cursor->next().getOwned();
+        }
+    } else {
+        end = client.findOne(nss.ns(), q);
+    }
+
+    if (end.isEmpty()) {
+        return BSONObj();
+    }
+
+    return shardKeyPattern.extractShardKeyFromDoc(end);
+}
+
+/**
+ * Returns whether the chunks of the collection resulting from an auto-split may be balanced.
+ */
+bool isAutoSplitBalancingAllowed(OperationContext* opCtx, const NamespaceString& nss) {
+    if (!Grid::get(opCtx)->getBalancerConfiguration()->shouldBalanceForAutoSplit())
+        return false;
+
+    auto collStatus = Grid::get(opCtx)->catalogClient(opCtx)->getCollection(opCtx, nss.ns());
+    if (!collStatus.isOK()) {
+        log() << "Auto-split for " << nss << " failed to load collection metadata"
+              << causedBy(redact(collStatus.getStatus()));
+        return false;
+    }
+
+    return collStatus.getValue().value.getAllowBalance();
+}
+
+}  // namespace
+
+ChunkSplitter::ChunkSplitter() : _threadPool(makeDefaultThreadPoolOptions()) {}
+
+ChunkSplitter::~ChunkSplitter() {
+    _threadPool.shutdown();
+    _threadPool.join();
+}
+
+ChunkSplitter* ChunkSplitter::get(ServiceContext* serviceContext) {
+    return &getChunkSplitter(serviceContext);
+}
+
+ChunkSplitter* ChunkSplitter::get(OperationContext* opCtx) {
+    return get(opCtx->getServiceContext());
+}
+
+void ChunkSplitter::trackChunkWrite(OperationContext* opCtx,
+                                    const NamespaceString& nss,
+                                    const CollectionMetadata& metadata,
+                                    const ChunkType& chunk,
+                                    long long bytesWritten) {
+    if (!shardAutoSplit.load()) {
+        return;
+    }
+
+    if (!repl::ReplicationCoordinator::get(opCtx)->canAcceptWritesFor(opCtx, nss)) {
+        return;
+    }
+
+    const long long maxChunkSizeBytes =
+        Grid::get(opCtx)->getBalancerConfiguration()->getMaxChunkSizeBytes();
+
+    long long chunkBytesWritten;
+
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+        auto collIt = _bytesWritten.find(nss.ns());
+        if (collIt == _bytesWritten.end()) {
+            collIt = _bytesWritten
+                         .emplace(nss.ns(),
+                                  SimpleBSONObjComparator::kInstance
+                                      .makeBSONObjIndexedMap<long long>())
+                         .first;
+        }
+
+        auto chunkIt = collIt->second.find(chunk.getMin());
+        if (chunkIt == collIt->second.end()) {
+            chunkIt = collIt->second.emplace(chunk.getMin().getOwned(), 0).first;
+        }
+
+        chunkIt->second += bytesWritten;
+
+        // Check if there are enough bytes written to warrant a split
+        if (chunkIt->second < maxChunkSizeBytes / kSplitTestFactor) {
+            return;
+        }
+
+        if (!_collectionsBeingSplit.insert(nss.ns()).second) {
+            LOG(1) << "won't auto split " << nss << " because a split is already in progress";
+            return;
+        }
+
+        chunkBytesWritten = chunkIt->second;
+        chunkIt->second = 0;
+
+        if (!_threadPoolStarted) {
+            _threadPool.startup();
+            _threadPoolStarted = true;
+        }
+    }
+
+    const ChunkRange chunkRange(chunk.getMin(), chunk.getMax());
+    const BSONObj keyPattern = metadata.getKeyPattern().getOwned();
+    const ChunkVersion collectionVersion = metadata.getCollVersion();
+
+    Status scheduleStatus =
+        _threadPool.schedule([this, nss, keyPattern, chunkRange, collectionVersion,
+                              chunkBytesWritten] {
+            _runAutosplit(nss, keyPattern, chunkRange, collectionVersion, chunkBytesWritten);
+        });
+
+    if (!scheduleStatus.isOK()) {
+        warning() << "Unable to schedule auto-split of " << nss << " chunk "
+                  << redact(chunkRange.toString()) << causedBy(redact(scheduleStatus));
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _collectionsBeingSplit.erase(nss.ns());
+    }
+}
+
+void ChunkSplitter::_runAutosplit(const NamespaceString& nss,
+                                  const BSONObj& keyPattern,
+                                  const ChunkRange& chunkRange,
+                                  ChunkVersion collectionVersion,
+                                  long long bytesWritten) {
+    ON_BLOCK_EXIT([&] {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _collectionsBeingSplit.erase(nss.ns());
+    });
+
+    auto opCtx = cc().makeOperationContext();
+
+    if (getGlobalAuthorizationManager()->isAuthEnabled()) {
+        AuthorizationSession::get(opCtx->getClient())->grantInternalAuthorization();
+    }
+
+    const ShardKeyPattern shardKeyPattern(keyPattern);
+
+    try {
+        const auto balancerConfig = Grid::get(opCtx.get())->getBalancerConfiguration();
+
+        // Ensure we have the most up-to-date balancer configuration
+        uassertStatusOK(balancerConfig->refreshAndCheck(opCtx.get()));
+
+        if (!balancerConfig->getShouldAutoSplit()) {
+            return;
+        }
+
+        const ShardId shardId(ShardingState::get(opCtx.get())->getShardName());
+        const long long maxChunkSizeBytes = balancerConfig->getMaxChunkSizeBytes();
+
+        LOG(1) << "about to initiate autosplit of " << nss << " chunk "
+               << redact(chunkRange.toString()) << " dataWritten: " << bytesWritten
+               << " maxChunkSizeBytes: " << maxChunkSizeBytes;
+
+        auto splitPoints = uassertStatusOK(shardutil::selectChunkSplitPoints(opCtx.get(),
+                                                                             shardId,
+                                                                             nss,
+                                                                             shardKeyPattern,
+                                                                             chunkRange,
+                                                                             maxChunkSizeBytes,
+                                                                             boost::none));
+
+        if (splitPoints.size() <= 1) {
+            // No split points means there isn't enough data to split on; 1 split point means we
+            // have between half the chunk size to full chunk size so there is no need to split yet
+            return;
+        }
+
+        const bool minIsInf =
+            (0 == shardKeyPattern.getKeyPattern().globalMin().woCompare(chunkRange.getMin()));
+        BSONObj extremeKey =
+            findExtremeKeyForChunk(opCtx.get(), nss, shardKeyPattern, chunkRange);
+        if (!extremeKey.isEmpty()) {
+            if (minIsInf) {
+                splitPoints.front() = extremeKey.getOwned();
+            } else {
+                splitPoints.back() = extremeKey.getOwned();
+            }
+        }
+
+        const auto suggestedMigrateChunk =
+            uassertStatusOK(shardutil::splitChunkAtMultiplePoints(opCtx.get(),
+                                                                  shardId,
+                                                                  nss,
+                                                                  shardKeyPattern,
+                                                                  collectionVersion,
+                                                                  chunkRange,
+                                                                  splitPoints));
+
+        const bool shouldBalance = isAutoSplitBalancingAllowed(opCtx.get(), nss);
+
+        log() << "autosplitted " << nss << " chunk: " << redact(chunkRange.toString()) << " into "
+              << (splitPoints.size() + 1) << " parts (dataWritten " << bytesWritten << ")"
+              << (suggestedMigrateChunk ? "" : (std::string) " (migrate suggested" +
+                          (shouldBalance ? ")" : ", but no migrations allowed)"));
+
+        if (!shouldBalance || !suggestedMigrateChunk) {
+            return;
+        }
+
+        // Top chunk optimization - try to move the top chunk out of this shard to prevent the hot
+        // spot from staying on a single shard. This is based on the assumption that succeeding
+        // inserts will fall on the top chunk.
+        auto routingInfo = uassertStatusOK(
+            Grid::get(opCtx.get())
+                ->catalogCache()
+                ->getShardedCollectionRoutingInfoWithRefresh(opCtx.get(), nss));
+
+        auto suggestedChunk = routingInfo.cm()->findIntersectingChunkWithSimpleCollation(
+            suggestedMigrateChunk->getMin());
+
+        ChunkType chunkToMove;
+        chunkToMove.setNS(nss.ns());
+        chunkToMove.setShard(suggestedChunk->getShardId());
+        chunkToMove.setMin(suggestedChunk->getMin());
+        chunkToMove.setMax(suggestedChunk->getMax());
+        chunkToMove.setVersion(suggestedChunk->getLastmod());
+
+        uassertStatusOK(configsvr_client::rebalanceChunk(opCtx.get(), chunkToMove));
+    } catch (const DBException& ex) {
+        log() << "Unable to auto-split " << nss << " chunk " << redact(chunkRange.toString())
+              << causedBy(redact(ex));
+    }
+}
+
+}  // namespace mongo
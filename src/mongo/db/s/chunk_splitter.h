@@ -0,0 +1,114 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <map>
+#include <set>
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/s/chunk_version.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
+
+namespace mongo {
+
+class ChunkRange;
+class ChunkType;
+class CollectionMetadata;
+class NamespaceString;
+class OperationContext;
+class ServiceContext;
+
+/**
+ * Tracks the number of bytes written to each chunk of the sharded collections, for which this shard
+ * is the primary, and splits the chunks which grow past the configured chunk size. This replaces
+ * the per-router estimates kept by each mongos, which grow more inaccurate the more routers there
+ * are in the cluster.
+ *
+ * The split point selection and the split itself run asynchronously on a dedicated thread pool and
+ * at most one split per collection is scheduled at a time.
+ *
+ * There is one instance of this object per service context and it is thread-safe.
+ */
+class ChunkSplitter {
+    MONGO_DISALLOW_COPYING(ChunkSplitter);
+
+public:
+    ChunkSplitter();
+    ~ChunkSplitter();
+
+    /**
+     * Retrieves the ChunkSplitter associated with the specified service context.
+     */
+    static ChunkSplitter* get(ServiceContext* serviceContext);
+    static ChunkSplitter* get(OperationContext* opCtx);
+
+    /**
+     * Adds 'bytesWritten' to the chunk of the specified collection and schedules an auto-split of
+     * the chunk if enough data was written to it to warrant one. Does nothing if auto-splitting on
+     * the shard is disabled or if this node is not the primary.
+     */
+    void trackChunkWrite(OperationContext* opCtx,
+                         const NamespaceString& nss,
+                         const CollectionMetadata& metadata,
+                         const ChunkType& chunk,
+                         long long bytesWritten);
+
+private:
+    /**
+     * Looks up the split points of the chunk and splits it, if there are enough of them. Runs on
+     * the thread pool and never throws.
+     */
+    void _runAutosplit(const NamespaceString& nss,
+                       const BSONObj& keyPattern,
+                       const ChunkRange& chunkRange,
+                       ChunkVersion collectionVersion,
+                       long long bytesWritten);
+
+    // Protects the state below
+    stdx::mutex _mutex;
+
+    // Per collection map of chunk min key to the number of bytes written to the chunk since it was
+    // last checked for split
+    std::map<std::string, BSONObjIndexedMap<long long>> _bytesWritten;
+
+    // Collections, for which an auto-split is currently scheduled or running
+    std::set<std::string> _collectionsBeingSplit;
+
+    // Whether the thread pool has been started. It is only started when the first split is needed.
+    bool _threadPoolStarted{false};
+
+    // Runs the auto-split tasks
+    ThreadPool _threadPool;
+};
+
+}  // namespace mongo
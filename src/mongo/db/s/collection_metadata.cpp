@@ -108,6 +108,45 @@ std::unique_ptr<CollectionMetadata> CollectionMetadata::clone() const {
         _shardKeyPattern.toBSON(), getCollVersion(), getShardVersion(), getChunks());
 }
 
+std::unique_ptr<CollectionMetadata> CollectionMetadata::makeUpdated(
+    ChunkVersion collectionVersion,
+    ChunkVersion shardVersion,
+    const ShardId& shardId,
+    const std::vector<ChunkType>& changedChunks) const {
+    invariant(collectionVersion.epoch() == _collVersion.epoch());
+    invariant(collectionVersion >= _collVersion);
+
+    RangeMap updatedChunksMap = _chunksMap;
+
+    for (const auto& chunk : changedChunks) {
+        invariant(chunk.getVersion() > _collVersion);
+
+        // Remove all the chunks which overlap with the changed chunk, starting with the one which
+        // may straddle its min key
+        auto it = updatedChunksMap.upper_bound(chunk.getMin());
+        if (it != updatedChunksMap.begin()) {
+            auto prevIt = std::prev(it);
+            if (prevIt->second.getMaxKey().woCompare(chunk.getMin()) > 0) {
+                it = prevIt;
+            }
+        }
+
+        while (it != updatedChunksMap.end() && it->first.woCompare(chunk.getMax()) < 0) {
+            it = updatedChunksMap.erase(it);
+        }
+
+        if (chunk.getShard() == shardId) {
+            updatedChunksMap.emplace(chunk.getMin(),
+                                     CachedChunkInfo(chunk.getMax(), chunk.getVersion()));
+        }
+    }
+
+    return stdx::make_unique<CollectionMetadata>(_shardKeyPattern.toBSON(),
+                                                 collectionVersion,
+                                                 shardVersion,
+                                                 std::move(updatedChunksMap));
+}
+
 bool CollectionMetadata::keyBelongsToMe(const BSONObj& key) const {
     if (_rangesMap.empty()) {
         return false;
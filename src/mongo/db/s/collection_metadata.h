@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "mongo/db/range_arithmetic.h"
 #include "mongo/db/s/collection_range_deleter.h"
 #include "mongo/s/catalog/type_chunk.h"
@@ -68,6 +70,24 @@ public:
      */
     std::unique_ptr<CollectionMetadata> clone() const;
 
+    /**
+     * Returns a new metadata instance at 'collectionVersion'/'shardVersion', obtained by applying
+     * 'changedChunks' on top of 'this's chunks. The changed chunks must include every chunk of
+     * the collection whose version is newer than getCollVersion(), so that any range which has
+     * been split, merged or migrated since is covered by them. Only the changed chunks, which
+     * are owned by 'shardId' are added to the new metadata, all others only remove what they
+     * overlap.
+     *
+     * This is cheaper than constructing the metadata from the complete chunk list of the
+     * collection, because the work done is proportional to the chunks owned by this shard
+     * rather than to all chunks of the collection.
+     */
+    std::unique_ptr<CollectionMetadata> makeUpdated(
+        ChunkVersion collectionVersion,
+        ChunkVersion shardVersion,
+        const ShardId& shardId,
+        const std::vector<ChunkType>& changedChunks) const;
+
     /**
      * Returns true if the document key 'key' is a valid instance of a shard key for this
      * metadata.  The 'key' must contain exactly the same fields as the shard key pattern.
@@ -144,6 +164,10 @@ public:
         return _shardKeyPattern.getKeyPatternFields();
     }
 
+    const ShardKeyPattern& getShardKeyPattern() const {
+        return _shardKeyPattern;
+    }
+
     BSONObj getMinKey() const;
 
     BSONObj getMaxKey() const;
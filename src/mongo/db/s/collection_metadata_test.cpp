@@ -208,6 +208,47 @@ TEST_F(SingleChunkFixture, ChunkOrphanedDataRanges) {
     ASSERT(!makeCollectionMetadata()->getNextOrphanRange(pending, keyRange->maxKey));
 }
 
+TEST_F(SingleChunkFixture, MakeUpdatedAppliesSplitAndMigratedChunks) {
+    auto metadata(makeCollectionMetadata());
+    const OID epoch = metadata->getCollVersion().epoch();
+
+    // [10, 20) was split into [10, 15) and [15, 20), after which [15, 20) moved to another shard
+    // and chunk [30, 40) was received from it
+    std::vector<ChunkType> changedChunks(3);
+    changedChunks[0].setMin(BSON("a" << 10));
+    changedChunks[0].setMax(BSON("a" << 15));
+    changedChunks[0].setVersion(ChunkVersion(2, 1, epoch));
+    changedChunks[0].setShard(ShardId("thisShard"));
+    changedChunks[1].setMin(BSON("a" << 15));
+    changedChunks[1].setMax(BSON("a" << 20));
+    changedChunks[1].setVersion(ChunkVersion(2, 0, epoch));
+    changedChunks[1].setShard(ShardId("otherShard"));
+    changedChunks[2].setMin(BSON("a" << 30));
+    changedChunks[2].setMax(BSON("a" << 40));
+    changedChunks[2].setVersion(ChunkVersion(3, 0, epoch));
+    changedChunks[2].setShard(ShardId("thisShard"));
+
+    auto updatedMetadata = metadata->makeUpdated(ChunkVersion(3, 0, epoch),
+                                                 ChunkVersion(3, 0, epoch),
+                                                 ShardId("thisShard"),
+                                                 changedChunks);
+
+    ASSERT_EQUALS(ChunkVersion(3, 0, epoch), updatedMetadata->getCollVersion());
+    ASSERT_EQUALS(ChunkVersion(3, 0, epoch), updatedMetadata->getShardVersion());
+    ASSERT_EQUALS(2U, updatedMetadata->getNumChunks());
+
+    ASSERT(updatedMetadata->keyBelongsToMe(BSON("a" << 10)));
+    ASSERT(updatedMetadata->keyBelongsToMe(BSON("a" << 14)));
+    ASSERT_FALSE(updatedMetadata->keyBelongsToMe(BSON("a" << 15)));
+    ASSERT_FALSE(updatedMetadata->keyBelongsToMe(BSON("a" << 19)));
+    ASSERT(updatedMetadata->keyBelongsToMe(BSON("a" << 30)));
+    ASSERT_FALSE(updatedMetadata->keyBelongsToMe(BSON("a" << 40)));
+
+    // The original metadata must not have been modified
+    ASSERT_EQUALS(1U, metadata->getNumChunks());
+    ASSERT(metadata->keyBelongsToMe(BSON("a" << 19)));
+}
+
 /**
  * Fixture with single chunk containing:
  * [(min, min)->(max, max))
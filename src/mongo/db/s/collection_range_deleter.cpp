@@ -34,6 +34,7 @@
 
 #include <algorithm>
 #include <utility>
+#include <vector>
 
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/client.h"
@@ -52,12 +53,14 @@
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/metadata_manager.h"
 #include "mongo/db/s/sharding_state.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/write_concern.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -71,8 +74,102 @@ namespace {
 const WriteConcernOptions kMajorityWriteConcern(WriteConcernOptions::kMajority,
                                                 WriteConcernOptions::SyncMode::UNSET,
                                                 Seconds(60));
+
+// Upper bound on the number of documents deleted by a single range deletion task, before waiting
+// for the deletions to replicate
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterMaxDocumentsPerTask, int, 4096);
+
+// The range deletion tasks adjust the number of documents they delete, so that waiting for the
+// deletions to replicate to a majority takes about this long
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterTargetReplicationWaitMS, int, 500);
+
+/**
+ * Adjusts the number of documents deleted by each range deletion task to how fast the deletions
+ * replicate, so that orphan cleanup goes as fast as the secondaries can keep up with, but does not
+ * build up replication lag, which would compete with the user writes. Also keeps the progress
+ * metrics of the range deletions, which are reported in serverStatus.
+ */
+class RangeDeletionRateController {
+public:
+    int getMaxToDelete() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        return std::min(_maxToDelete, std::max(rangeDeleterMaxDocumentsPerTask.load(), 1));
+    }
+
+    void onTaskComplete(int numDeleted, Milliseconds deletionTime, Milliseconds replicationWait) {
+        const Milliseconds target(std::max(rangeDeleterTargetReplicationWaitMS.load(), 1));
+        const int maxDocumentsPerTask = std::max(rangeDeleterMaxDocumentsPerTask.load(), 1);
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _totalDocsDeleted += numDeleted;
+        _totalDeletionTime += deletionTime;
+        _totalReplicationWait += replicationWait;
+        _lastDocsDeleted = numDeleted;
+        _lastDeletionTime = deletionTime;
+        _lastReplicationWait = replicationWait;
+
+        // Only the tasks, which deleted as many documents as they were allowed to, tell anything
+        // about whether the secondaries would keep up with larger ones
+        if (numDeleted < _maxToDelete && replicationWait <= target) {
+            return;
+        }
+
+        if (replicationWait > target) {
+            _maxToDelete = std::max(_maxToDelete / 2, 1);
+        } else if (replicationWait < target / 2) {
+            _maxToDelete = std::min(_maxToDelete + std::max(_maxToDelete / 2, 1),
+                                    maxDocumentsPerTask);
+        }
+    }
+
+    void onRangeComplete(bool succeeded) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (succeeded) {
+            _totalRangesDeleted++;
+        } else {
+            _totalRangesFailed++;
+        }
+    }
+
+    void append(BSONObjBuilder* builder) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        builder->append("maxDocumentsPerTask", _maxToDelete);
+        builder->append("totalDocsDeleted", _totalDocsDeleted);
+        builder->append("totalRangesDeleted", _totalRangesDeleted);
+        builder->append("totalRangesFailed", _totalRangesFailed);
+        builder->append("totalDeletionTimeMillis", durationCount<Milliseconds>(_totalDeletionTime));
+        builder->append("totalReplicationWaitMillis",
+                        durationCount<Milliseconds>(_totalReplicationWait));
+        builder->append("lastTaskDocsDeleted", _lastDocsDeleted);
+        builder->append("lastTaskDeletionTimeMillis",
+                        durationCount<Milliseconds>(_lastDeletionTime));
+        builder->append("lastTaskReplicationWaitMillis",
+                        durationCount<Milliseconds>(_lastReplicationWait));
+    }
+
+private:
+    stdx::mutex _mutex;
+
+    int _maxToDelete{128};
+
+    long long _totalDocsDeleted{0};
+    long long _totalRangesDeleted{0};
+    long long _totalRangesFailed{0};
+    Milliseconds _totalDeletionTime{0};
+    Milliseconds _totalReplicationWait{0};
+
+    int _lastDocsDeleted{0};
+    Milliseconds _lastDeletionTime{0};
+    Milliseconds _lastReplicationWait{0};
+};
+
+RangeDeletionRateController rangeDeletionRateController;
+
 }  // unnamed namespace
 
+// Number of documents deleted under a single WriteUnitOfWork
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterBatchSize, int, 64);
+
 CollectionRangeDeleter::~CollectionRangeDeleter() {
     // notify anybody still sleeping on orphan ranges
     clear(Status{ErrorCodes::InterruptedDueToReplStateChange,
@@ -89,6 +186,7 @@ auto CollectionRangeDeleter::cleanUpNextRange(OperationContext* opCtx,
     StatusWith<int> wrote = 0;
     auto range = boost::optional<ChunkRange>(boost::none);
     auto notification = DeleteNotification();
+    Milliseconds deletionTime(0);
     {
         AutoGetCollection autoColl(opCtx, nss, MODE_IX);
         auto* collection = autoColl.getCollection();
@@ -145,6 +243,7 @@ auto CollectionRangeDeleter::cleanUpNextRange(OperationContext* opCtx,
                 // clang-format on
             }
 
+            Timer deletionTimer;
             try {
                 auto keyPattern = scopedCollectionMetadata->getKeyPattern();
 
@@ -153,11 +252,14 @@ auto CollectionRangeDeleter::cleanUpNextRange(OperationContext* opCtx,
                 wrote = e.toStatus();
                 warning() << e.what();
             }
+            deletionTime = Milliseconds(deletionTimer.millis());
             if (!wrote.isOK() || wrote.getValue() == 0) {
                 if (wrote.isOK()) {
                     log() << "No documents remain to delete in " << nss << " range "
                           << redact(range->toString());
                 }
+                rangeDeletionRateController.onRangeComplete(wrote.isOK());
+
                 stdx::lock_guard<stdx::mutex> scopedLock(css->_metadataManager->_managerLock);
                 self->_pop(wrote.getStatus());
                 return Action::kWriteOpLog;
@@ -175,11 +277,16 @@ auto CollectionRangeDeleter::cleanUpNextRange(OperationContext* opCtx,
     // Wait for replication outside the lock
     WriteConcernResult unusedWCResult;
     Status status = Status::OK();
+    Timer replicationTimer;
     try {
         status = waitForWriteConcern(opCtx, clientOpTime, kMajorityWriteConcern, &unusedWCResult);
     } catch (const DBException& e) {
         status = e.toStatus();
     }
+
+    rangeDeletionRateController.onTaskComplete(
+        wrote.getValue(), deletionTime, Milliseconds(replicationTimer.millis()));
+
     if (!status.isOK()) {
         log() << "Error when waiting for write concern after removing " << nss << " range "
               << redact(range->toString()) << " : " << redact(status.reason());
@@ -195,6 +302,7 @@ auto CollectionRangeDeleter::cleanUpNextRange(OperationContext* opCtx,
             invariant(!self->isEmpty() && self->_orphans.front().notification == notification);
             log() << "Abandoning deletion of latest range in " << nss.ns() << " after "
                   << wrote.getValue() << " local deletions because of replication failure";
+            rangeDeletionRateController.onRangeComplete(false);
             self->_pop(status);
         }
     } else {
@@ -206,6 +314,14 @@ auto CollectionRangeDeleter::cleanUpNextRange(OperationContext* opCtx,
     return Action::kMore;
 }
 
+int CollectionRangeDeleter::getMaxToDelete() {
+    return rangeDeletionRateController.getMaxToDelete();
+}
+
+void CollectionRangeDeleter::appendStats(BSONObjBuilder* builder) {
+    rangeDeletionRateController.append(builder);
+}
+
 StatusWith<int> CollectionRangeDeleter::_doDeletion(OperationContext* opCtx,
                                                     Collection* collection,
                                                     BSONObj const& keyPattern,
@@ -251,42 +367,69 @@ StatusWith<int> CollectionRangeDeleter::_doDeletion(OperationContext* opCtx,
         saver.emplace("moveChunk", nss.ns(), "cleaning");
     }
 
+    const int batchSize = std::max(rangeDeleterBatchSize.load(), 1);
+
     int numDeleted = 0;
-    do {
-        auto halfOpen = BoundInclusion::kIncludeStartKeyOnly;
-        auto manual = PlanExecutor::YIELD_MANUAL;
-        auto forward = InternalPlanner::FORWARD;
-        auto fetch = InternalPlanner::IXSCAN_FETCH;
-
-        auto exec = InternalPlanner::indexScan(
-            opCtx, collection, descriptor, min, max, halfOpen, manual, forward, fetch);
-
-        RecordId rloc;
-        BSONObj obj;
-        PlanExecutor::ExecState state = exec->getNext(&obj, &rloc);
-        if (state == PlanExecutor::IS_EOF) {
-            break;
+    while (numDeleted < maxToDelete) {
+        const int numToFetch = std::min(batchSize, maxToDelete - numDeleted);
+
+        // Only the record ids of the batch are looked up through the index, so that the documents
+        // can be deleted together under a single WriteUnitOfWork
+        std::vector<RecordId> recordIds;
+        recordIds.reserve(numToFetch);
+
+        {
+            auto halfOpen = BoundInclusion::kIncludeStartKeyOnly;
+            auto manual = PlanExecutor::YIELD_MANUAL;
+            auto forward = InternalPlanner::FORWARD;
+
+            auto exec = InternalPlanner::indexScan(
+                opCtx, collection, descriptor, min, max, halfOpen, manual, forward);
+
+            RecordId rloc;
+            BSONObj obj;
+            PlanExecutor::ExecState state = PlanExecutor::IS_EOF;
+            while (int(recordIds.size()) < numToFetch &&
+                   PlanExecutor::ADVANCED == (state = exec->getNext(&obj, &rloc))) {
+                recordIds.push_back(rloc);
+            }
+
+            if (state == PlanExecutor::FAILURE || state == PlanExecutor::DEAD) {
+                warning(LogComponent::kSharding)
+                    << PlanExecutor::statestr(state) << " - cursor error while trying to delete "
+                    << min << " to " << max << " in " << nss << ": "
+                    << WorkingSetCommon::toStatusString(obj)
+                    << ", stats: " << Explain::getWinningPlanStats(exec.get());
+            }
         }
-        if (state == PlanExecutor::FAILURE || state == PlanExecutor::DEAD) {
-            warning(LogComponent::kSharding)
-                << PlanExecutor::statestr(state) << " - cursor error while trying to delete " << min
-                << " to " << max << " in " << nss << ": " << WorkingSetCommon::toStatusString(obj)
-                << ", stats: " << Explain::getWinningPlanStats(exec.get());
+
+        if (recordIds.empty()) {
             break;
         }
-        invariant(PlanExecutor::ADVANCED == state);
 
         MONGO_WRITE_CONFLICT_RETRY_LOOP_BEGIN {
             WriteUnitOfWork wuow(opCtx);
-            if (saver) {
-                saver->goingToDelete(obj);
+            for (const auto& recordId : recordIds) {
+                Snapshotted<BSONObj> doc;
+                if (!collection->findDoc(opCtx, recordId, &doc)) {
+                    continue;
+                }
+                if (saver) {
+                    saver->goingToDelete(doc.value());
+                }
+                collection->deleteDocument(opCtx, recordId, nullptr, true);
             }
-            collection->deleteDocument(opCtx, rloc, nullptr, true);
             wuow.commit();
         }
         MONGO_WRITE_CONFLICT_RETRY_LOOP_END(opCtx, "delete range", nss.ns());
 
-    } while (++numDeleted < maxToDelete);
+        numDeleted += recordIds.size();
+
+        // A short batch means that the scan reached the end of the range
+        if (int(recordIds.size()) < numToFetch) {
+            break;
+        }
+    }
 
     return numDeleted;
 }
@@ -30,15 +30,20 @@
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/executor/task_executor.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/util/concurrency/notification.h"
 
 namespace mongo {
 
 class BSONObj;
+class BSONObjBuilder;
 class Collection;
 class OperationContext;
 
+// Number of documents, which cleanUpNextRange deletes under a single WriteUnitOfWork
+extern AtomicInt32 rangeDeleterBatchSize;
+
 class CollectionRangeDeleter {
     MONGO_DISALLOW_COPYING(CollectionRangeDeleter);
 
@@ -162,10 +167,22 @@ public:
                                    int maxToDelete,
                                    CollectionRangeDeleter* forTestOnly = nullptr);
 
+    /**
+     * Returns how many documents the next call to cleanUpNextRange should delete. This is adjusted
+     * after every call according to how long its deletions took to replicate to a majority.
+     */
+    static int getMaxToDelete();
+
+    /**
+     * Appends the progress and rate metrics of the range deletions done by this process.
+     */
+    static void appendStats(BSONObjBuilder* builder);
+
 private:
     /**
-     * Performs the deletion of up to maxToDelete entries within the range in progress. Must be
-     * called under the collection lock.
+     * Performs the deletion of up to maxToDelete entries within the range in progress, in batches
+     * of rangeDeleterBatchSize documents per WriteUnitOfWork. Must be called under the collection
+     * lock.
      *
      * Returns the number of documents deleted, 0 if done with the range, or bad status if deleting
      * the range failed.
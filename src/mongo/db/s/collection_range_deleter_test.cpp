@@ -50,6 +50,7 @@
 #include "mongo/s/chunk_version.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/sharding_mongod_test_fixture.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -219,6 +220,42 @@ TEST_F(CollectionRangeDeleterTest, MultipleDocumentsInOneRangeToClean) {
     ASSERT_EQ(Action::kFinished, next(rangeDeleter, Action::kWriteOpLog, 100));
 }
 
+// Tests the case that the documents to delete in one run span several WriteUnitOfWork batches.
+TEST_F(CollectionRangeDeleterTest, MultipleBatchesInOneCleanupNextRangeCall) {
+    const int originalBatchSize = rangeDeleterBatchSize.load();
+    rangeDeleterBatchSize.store(2);
+    ON_BLOCK_EXIT([&] { rangeDeleterBatchSize.store(originalBatchSize); });
+
+    CollectionRangeDeleter rangeDeleter;
+    DBDirectClient dbclient(operationContext());
+    for (int i = 1; i <= 5; i++) {
+        dbclient.insert(kNss.toString(), BSON(kPattern << i));
+    }
+    dbclient.insert(kNss.toString(), BSON(kPattern << 15));
+    ASSERT_EQUALS(6ULL, dbclient.count(kNss.toString(), BSON(kPattern << LT << 20)));
+
+    std::list<Deletion> ranges;
+    ranges.emplace_back(Deletion{ChunkRange(BSON(kPattern << 0), BSON(kPattern << 10))});
+    ASSERT_TRUE(rangeDeleter.add(std::move(ranges)));
+
+    BSONObjBuilder statsBefore;
+    CollectionRangeDeleter::appendStats(&statsBefore);
+    const long long docsDeletedBefore = statsBefore.obj()["totalDocsDeleted"].numberLong();
+
+    ASSERT_EQ(Action::kMore, next(rangeDeleter, Action::kWriteOpLog, 100));
+    ASSERT_EQUALS(0ULL, dbclient.count(kNss.toString(), BSON(kPattern << LT << 10)));
+    ASSERT_EQUALS(1ULL, dbclient.count(kNss.toString(), BSON(kPattern << LT << 20)));
+
+    BSONObjBuilder statsAfter;
+    CollectionRangeDeleter::appendStats(&statsAfter);
+    const BSONObj stats = statsAfter.obj();
+    ASSERT_EQ(docsDeletedBefore + 5, stats["totalDocsDeleted"].numberLong());
+    ASSERT_EQ(5, stats["lastTaskDocsDeleted"].numberInt());
+
+    ASSERT_EQ(Action::kWriteOpLog, next(rangeDeleter, Action::kMore, 100));
+    ASSERT_EQ(Action::kFinished, next(rangeDeleter, Action::kWriteOpLog, 100));
+}
+
 // Tests the case that there are multiple documents within a range to clean, and the range deleter
 // has a max deletion rate of one document per run.
 TEST_F(CollectionRangeDeleterTest, MultipleCleanupNextRangeCalls) {
@@ -36,7 +36,10 @@
 #include "mongo/db/concurrency/lock_state.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/query/canonical_query.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
+#include "mongo/db/s/chunk_load_statistics.h"
+#include "mongo/db/s/chunk_splitter.h"
 #include "mongo/db/s/collection_metadata.h"
 #include "mongo/db/s/migration_chunk_cloner_source.h"
 #include "mongo/db/s/migration_source_manager.h"
@@ -236,6 +239,23 @@ boost::optional<KeyRange> CollectionShardingState::getNextOrphanRange(BSONObj co
     return _metadataManager->getNextOrphanRange(from);
 }
 
+void CollectionShardingState::onQueryOp(OperationContext* opCtx, const CanonicalQuery& query) {
+    if (!ChunkLoadStatistics::get(opCtx)->shouldSample()) {
+        return;
+    }
+
+    auto metadata = getMetadata();
+    if (!metadata) {
+        return;
+    }
+
+    _recordChunkLoad(opCtx,
+                     *metadata.getMetadata(),
+                     metadata->getShardKeyPattern().extractShardKeyFromQuery(query),
+                     false,
+                     0);
+}
+
 bool CollectionShardingState::isDocumentInMigratingChunk(OperationContext* opCtx,
                                                          const BSONObj& doc) {
     dassert(opCtx->lockState()->isCollectionLockedForMode(_nss.ns(), MODE_IX));
@@ -267,6 +287,8 @@ void CollectionShardingState::onInsertOp(OperationContext* opCtx, const BSONObj&
     if (_sourceMgr) {
         _sourceMgr->getCloner()->onInsertOp(opCtx, insertedDoc);
     }
+
+    _sampleWriteOp(opCtx, insertedDoc, insertedDoc.objsize());
 }
 
 void CollectionShardingState::onUpdateOp(OperationContext* opCtx, const BSONObj& updatedDoc) {
@@ -277,6 +299,8 @@ void CollectionShardingState::onUpdateOp(OperationContext* opCtx, const BSONObj&
     if (_sourceMgr) {
         _sourceMgr->getCloner()->onUpdateOp(opCtx, updatedDoc);
     }
+
+    _sampleWriteOp(opCtx, updatedDoc, updatedDoc.objsize());
 }
 
 void CollectionShardingState::onDeleteOp(OperationContext* opCtx,
@@ -320,6 +344,9 @@ void CollectionShardingState::onDeleteOp(OperationContext* opCtx,
     if (_sourceMgr && deleteState.isMigrating) {
         _sourceMgr->getCloner()->onDeleteOp(opCtx, deleteState.idDoc);
     }
+
+    // The deleted document's _id only identifies its chunk if the shard key is the _id
+    _sampleWriteOp(opCtx, deleteState.idDoc, 0);
 }
 
 void CollectionShardingState::onDropCollection(OperationContext* opCtx,
@@ -441,4 +468,52 @@ bool CollectionShardingState::_checkShardVersionOk(OperationContext* opCtx,
     MONGO_UNREACHABLE;
 }
 
+void CollectionShardingState::_sampleWriteOp(OperationContext* opCtx,
+                                             const BSONObj& doc,
+                                             long long bytesWritten) {
+    if (!ChunkLoadStatistics::get(opCtx)->shouldSample()) {
+        return;
+    }
+
+    auto metadata = getMetadata();
+    if (!metadata) {
+        return;
+    }
+
+    _recordChunkLoad(opCtx,
+                     *metadata.getMetadata(),
+                     metadata->getShardKeyPattern().extractShardKeyFromDoc(doc),
+                     true,
+                     bytesWritten);
+}
+
+void CollectionShardingState::_recordChunkLoad(OperationContext* opCtx,
+                                               const CollectionMetadata& metadata,
+                                               const BSONObj& shardKey,
+                                               bool isWrite,
+                                               long long bytesWritten) {
+    if (shardKey.isEmpty()) {
+        return;
+    }
+
+    ChunkType chunk;
+    if (!metadata.getNextChunk(shardKey, &chunk) || shardKey.woCompare(chunk.getMin()) < 0) {
+        return;
+    }
+
+    auto chunkLoadStats = ChunkLoadStatistics::get(opCtx);
+    const Date_t now = opCtx->getServiceContext()->getFastClockSource()->now();
+    if (isWrite) {
+        chunkLoadStats->recordWrite(_nss, chunk.getMin(), now);
+
+        if (bytesWritten > 0) {
+            // The sampled write stands for all the writes, which were not sampled
+            ChunkSplitter::get(opCtx)->trackChunkWrite(
+                opCtx, _nss, metadata, chunk, bytesWritten * chunkLoadStats->getSampleRate());
+        }
+    } else {
+        chunkLoadStats->recordRead(_nss, chunk.getMin(), now);
+    }
+}
+
 }  // namespace mongo
@@ -41,6 +41,7 @@
 namespace mongo {
 
 class BSONObj;
+class CanonicalQuery;
 struct ChunkVersion;
 class CollectionMetadata;
 class MigrationSourceManager;
@@ -205,8 +206,15 @@ public:
      */
     boost::optional<KeyRange> getNextOrphanRange(BSONObj const& startingFrom);
 
+    /**
+     * Samples a query against this collection for the chunk load statistics, if it targets a
+     * single chunk through an exact shard key match.
+     */
+    void onQueryOp(OperationContext* opCtx, const CanonicalQuery& query);
+
     // Replication subsystem hooks. If this collection is serving as a source for migration, these
-    // methods inform it of any changes to its contents.
+    // methods inform it of any changes to its contents. They also sample the writes for the chunk
+    // load statistics.
 
     bool isDocumentInMigratingChunk(OperationContext* opCtx, const BSONObj& doc);
 
@@ -237,6 +245,23 @@ private:
                               ChunkVersion* expectedShardVersion,
                               ChunkVersion* actualShardVersion);
 
+    /**
+     * Records a write to the document with the specified contents in the chunk load statistics,
+     * if the write is sampled and the document contains the full shard key. The 'bytesWritten' of
+     * the sampled writes are also tracked by the chunk splitter.
+     */
+    void _sampleWriteOp(OperationContext* opCtx, const BSONObj& doc, long long bytesWritten);
+
+    /**
+     * Records a read or write against the chunk, which owns the specified shard key, in the chunk
+     * load statistics. Does nothing if the shard key is empty or no chunk owns it.
+     */
+    void _recordChunkLoad(OperationContext* opCtx,
+                          const CollectionMetadata& metadata,
+                          const BSONObj& shardKey,
+                          bool isWrite,
+                          long long bytesWritten);
+
     // Namespace this state belongs to.
     const NamespaceString _nss;
 
@@ -361,7 +361,7 @@ void MetadataManager::_scheduleCleanup(executor::TaskExecutor* executor,
                                        NamespaceString nss,
                                        CollectionRangeDeleter::Action action) {
     executor->scheduleWork([executor, nss, action](auto&) {
-        const int maxToDelete = std::max(int(internalQueryExecYieldIterations.load()), 1);
+        const int maxToDelete = CollectionRangeDeleter::getMaxToDelete();
         Client::initThreadIfNotAlready("Collection Range Deleter");
         auto UniqueOpCtx = Client::getCurrent()->makeOperationContext();
         auto opCtx = UniqueOpCtx.get();
@@ -408,31 +408,72 @@ Status MigrationChunkClonerSourceLegacy::nextCloneBatch(OperationContext* opCtx,
                            internalQueryExecYieldIterations.load(),
                            Milliseconds(internalQueryExecYieldPeriodMS.load()));
 
-    stdx::lock_guard<stdx::mutex> sl(_mutex);
+    // Take the documents which are expected to fit in the batch out of _cloneLocs, so that
+    // concurrent clone streams read disjoint sets of documents without holding _mutex while doing
+    // so. The ones left over are put back before returning, while the collection lock is still
+    // held, so deletions can never miss them.
+    std::vector<RecordId> reserved;
+    {
+        stdx::lock_guard<stdx::mutex> sl(_mutex);
 
-    std::set<RecordId>::iterator it;
+        const uint64_t remainingBytes = BSONObjMaxUserSize - arrBuilder->len();
+        const uint64_t averageObjectSize = std::max<uint64_t>(1, _averageObjectSizeForCloneLocs);
+        const uint64_t count = std::max<uint64_t>(1, remainingBytes / averageObjectSize);
 
-    for (it = _cloneLocs.begin(); it != _cloneLocs.end(); ++it) {
+        auto end = _cloneLocs.begin();
+        for (uint64_t i = 0; i < count && end != _cloneLocs.end(); ++i) {
+            ++end;
+        }
+        reserved.assign(_cloneLocs.begin(), end);
+        _cloneLocs.erase(_cloneLocs.begin(), end);
+    }
+
+    // Read the reserved documents in RecordId order through a single cursor. Documents of a chunk
+    // are often adjacent in the record store, in which case stepping the cursor is cheaper than
+    // seeking it.
+    auto cursor = collection->getCursor(opCtx);
+    boost::optional<Record> following;
+
+    auto it = reserved.begin();
+    for (; it != reserved.end(); ++it) {
         // We must always make progress in this method by at least one document because empty return
         // indicates there is no more initial clone data.
         if (arrBuilder->arrSize() && tracker.intervalHasElapsed()) {
             break;
         }
 
-        Snapshotted<BSONObj> doc;
-        if (collection->findDoc(opCtx, *it, &doc)) {
-            // Use the builder size instead of accumulating the document sizes directly so that we
-            // take into consideration the overhead of BSONArray indices.
-            if (arrBuilder->arrSize() &&
-                (arrBuilder->len() + doc.value().objsize() + 1024) > BSONObjMaxUserSize) {
-                break;
-            }
+        boost::optional<Record> record;
+        if (following && following->id == *it) {
+            record = std::move(following);
+            following = boost::none;
+        } else if (following && *it < following->id) {
+            // Nothing lies between the previous document and 'following', so this one is gone.
+            continue;
+        } else {
+            record = cursor->seekExact(*it);
+        }
+
+        if (!record) {
+            following = boost::none;
+            continue;
+        }
+
+        const BSONObj doc = record->data.toBson();
 
-            arrBuilder->append(doc.value());
+        // Use the builder size instead of accumulating the document sizes directly so that we
+        // take into consideration the overhead of BSONArray indices.
+        if (arrBuilder->arrSize() &&
+            (arrBuilder->len() + doc.objsize() + 1024) > BSONObjMaxUserSize) {
+            break;
         }
+
+        arrBuilder->append(doc);
+        following = cursor->next();
     }
 
-    _cloneLocs.erase(_cloneLocs.begin(), it);
+    stdx::lock_guard<stdx::mutex> sl(_mutex);
+
+    _cloneLocs.insert(it, reserved.end());
 
     // If we have drained all the cloned data, there is no need to keep the delete notify executor
     // around
@@ -106,6 +106,9 @@ public:
      * give a chance to the caller to perform some form of yielding. It does not free or acquire any
      * locks on its own.
      *
+     * May be called concurrently by several clone streams of the recipient, which then receive
+     * disjoint sets of documents.
+     *
      * NOTE: Must be called with the collection lock held in at least IS mode.
      */
     Status nextCloneBatch(OperationContext* opCtx,
@@ -41,6 +41,7 @@
 #include "mongo/db/s/migration_chunk_cloner_source_legacy.h"
 #include "mongo/db/s/migration_source_manager.h"
 #include "mongo/db/s/sharding_state.h"
+#include "mongo/util/mongoutils/str.h"
 
 /**
  * This file contains commands, which are specific to the legacy chunk cloner source.
@@ -50,8 +51,8 @@ namespace {
 
 /**
  * Shortcut class to perform the appropriate checks and acquire the cloner associated with the
- * currently active migration. Uses the currently registered migration for this shard and ensures
- * the session ids match.
+ * currently active migration. Uses the migrations currently registered for this shard and picks the
+ * one, whose session id matches.
  */
 class AutoGetActiveCloner {
     MONGO_DISALLOW_COPYING(AutoGetActiveCloner);
@@ -60,32 +61,43 @@ public:
     AutoGetActiveCloner(OperationContext* opCtx, const MigrationSessionId& migrationSessionId) {
         ShardingState* const gss = ShardingState::get(opCtx);
 
-        const auto nss = gss->getActiveDonateChunkNss();
-        uassert(ErrorCodes::NotYetInitialized, "No active migrations were found", nss);
+        const auto namespaces = gss->getActiveDonateChunkNamespaces();
+        uassert(ErrorCodes::NotYetInitialized,
+                "No active migrations were found",
+                !namespaces.empty());
 
-        // Once the collection is locked, the migration status cannot change
-        _autoColl.emplace(opCtx, *nss, MODE_IS);
+        str::stream activeSessionIds;
 
-        uassert(ErrorCodes::NamespaceNotFound,
-                str::stream() << "Collection " << nss->ns() << " does not exist",
-                _autoColl->getCollection());
+        for (const auto& nss : namespaces) {
+            // Once the collection is locked, the migration status cannot change
+            _autoColl.emplace(opCtx, nss, MODE_IS);
 
-        auto css = CollectionShardingState::get(opCtx, *nss);
-        uassert(ErrorCodes::IllegalOperation,
-                str::stream() << "No active migrations were found for collection " << nss->ns(),
-                css && css->getMigrationSourceManager());
+            auto css = CollectionShardingState::get(opCtx, nss);
+            if (!_autoColl->getCollection() || !css || !css->getMigrationSourceManager()) {
+                _autoColl.reset();
+                continue;
+            }
 
-        // It is now safe to access the cloner
-        _chunkCloner = dynamic_cast<MigrationChunkClonerSourceLegacy*>(
-            css->getMigrationSourceManager()->getCloner());
-        invariant(_chunkCloner);
+            // It is now safe to access the cloner
+            auto chunkCloner = dynamic_cast<MigrationChunkClonerSourceLegacy*>(
+                css->getMigrationSourceManager()->getCloner());
+            invariant(chunkCloner);
+
+            if (migrationSessionId.matches(chunkCloner->getSessionId())) {
+                _chunkCloner = chunkCloner;
+                return;
+            }
+
+            activeSessionIds << " " << chunkCloner->getSessionId().toString();
+            _autoColl.reset();
+        }
 
-        // Ensure the session ids are correct
-        uassert(ErrorCodes::IllegalOperation,
-                str::stream() << "Requested migration session id " << migrationSessionId.toString()
-                              << " does not match active session id "
-                              << _chunkCloner->getSessionId().toString(),
-                migrationSessionId.matches(_chunkCloner->getSessionId()));
+        // None of the session ids are correct
+        uasserted(ErrorCodes::IllegalOperation,
+                  str::stream() << "Requested migration session id "
+                                << migrationSessionId.toString()
+                                << " does not match any of the active session ids:"
+                                << std::string(activeSessionIds));
     }
 
     Database* getDb() const {
@@ -108,7 +120,7 @@ private:
     boost::optional<AutoGetCollection> _autoColl;
 
     // Contains the active cloner for the namespace
-    MigrationChunkClonerSourceLegacy* _chunkCloner;
+    MigrationChunkClonerSourceLegacy* _chunkCloner{nullptr};
 };
 
 class InitialCloneCommand : public Command {
@@ -55,7 +55,9 @@
 #include "mongo/db/s/migration_util.h"
 #include "mongo/db/s/move_timing_helper.h"
 #include "mongo/db/s/sharding_state.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/shard_key_pattern.h"
 #include "mongo/stdx/chrono.h"
@@ -80,6 +82,10 @@ const WriteConcernOptions kMajorityWriteConcern(WriteConcernOptions::kMajority,
                                                 WriteConcernOptions::SyncMode::UNSET,
                                                 -1);
 
+// Number of concurrent _migrateClone streams used by the recipient of a migration to fetch and
+// insert the initial copy of the chunk's documents.
+MONGO_EXPORT_SERVER_PARAMETER(migrationCloneStreams, int, 4);
+
 /**
  * Returns a human-readabale name of the migration manager's state.
  */
@@ -628,79 +634,171 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* opCtx,
 
         _chunkMarkedPending = true;  // no lock needed, only the migrate thread looks.
 
-        while (true) {
-            BSONObj res;
-            if (!conn->runCommand("admin",
-                                  migrateCloneRequest,
-                                  res)) {  // gets array of objects to copy, in disk order
-                setStateFail(str::stream() << "_migrateClone failed: " << redact(res.toString()));
-                conn.done();
-                return;
-            }
-
-            BSONObj arr = res["objects"].Obj();
-            int thisTime = 0;
-
-            BSONObjIterator i(arr);
-            while (i.more()) {
-                opCtx->checkForInterrupt();
-
-                if (getState() == ABORT) {
-                    log() << "Migration aborted while copying documents";
-                    return;
+        // Set once any clone stream fails, so that the others stop early.
+        AtomicBool cloneFailed(false);
+
+        // Fetches batches of documents over 'cloneConn' and inserts them until the donor has no
+        // more to hand out. Every stream runs this concurrently on its own connection and client.
+        auto runCloneStream = [&](OperationContext* streamCtx, DBClientBase* cloneConn) -> Status {
+            while (true) {
+                BSONObj res;
+                if (!cloneConn->runCommand("admin",
+                                           migrateCloneRequest,
+                                           res)) {  // gets array of objects to copy, in disk order
+                    return {ErrorCodes::CommandFailed,
+                            str::stream() << "_migrateClone failed: " << redact(res.toString())};
                 }
 
-                BSONObj docToClone = i.next().Obj();
+                BSONObj arr = res["objects"].Obj();
+                int thisTime = 0;
+                long long thisTimeBytes = 0;
+
                 {
-                    OldClientWriteContext cx(opCtx, _nss.ns());
-
-                    BSONObj localDoc;
-                    if (willOverrideLocalId(opCtx,
-                                            _nss,
-                                            min,
-                                            max,
-                                            shardKeyPattern,
-                                            cx.db(),
-                                            docToClone,
-                                            &localDoc)) {
-                        string errMsg = str::stream() << "cannot migrate chunk, local document "
-                                                      << redact(localDoc)
-                                                      << " has same _id as cloned "
-                                                      << "remote document " << redact(docToClone);
-
-                        warning() << errMsg;
-
-                        // Exception will abort migration cleanly
-                        uasserted(16976, errMsg);
+                    // Take the write locks once for the whole batch rather than for every document.
+                    OldClientWriteContext cx(streamCtx, _nss.ns());
+
+                    BSONObjIterator i(arr);
+                    while (i.more()) {
+                        streamCtx->checkForInterrupt();
+
+                        if (getState() == ABORT) {
+                            log() << "Migration aborted while copying documents";
+                            return Status::OK();
+                        }
+
+                        if (cloneFailed.load()) {
+                            return Status::OK();
+                        }
+
+                        BSONObj docToClone = i.next().Obj();
+
+                        BSONObj localDoc;
+                        if (willOverrideLocalId(streamCtx,
+                                                _nss,
+                                                min,
+                                                max,
+                                                shardKeyPattern,
+                                                cx.db(),
+                                                docToClone,
+                                                &localDoc)) {
+                            string errMsg = str::stream()
+                                << "cannot migrate chunk, local document " << redact(localDoc)
+                                << " has same _id as cloned "
+                                << "remote document " << redact(docToClone);
+
+                            warning() << errMsg;
+
+                            // Exception will abort migration cleanly
+                            uasserted(16976, errMsg);
+                        }
+
+                        Helpers::upsert(streamCtx, _nss.ns(), docToClone, true);
+
+                        thisTime++;
+                        thisTimeBytes += docToClone.objsize();
                     }
-
-                    Helpers::upsert(opCtx, _nss.ns(), docToClone, true);
                 }
-                thisTime++;
 
                 {
                     stdx::lock_guard<stdx::mutex> statsLock(_mutex);
-                    _numCloned++;
-                    _clonedBytes += docToClone.objsize();
+                    _numCloned += thisTime;
+                    _clonedBytes += thisTimeBytes;
                 }
 
+                if (thisTime == 0)
+                    return Status::OK();
+
                 if (writeConcern.shouldWaitForOtherNodes()) {
                     repl::ReplicationCoordinator::StatusAndDuration replStatus =
                         repl::getGlobalReplicationCoordinator()->awaitReplication(
-                            opCtx,
-                            repl::ReplClientInfo::forClient(opCtx->getClient()).getLastOp(),
+                            streamCtx,
+                            repl::ReplClientInfo::forClient(streamCtx->getClient()).getLastOp(),
                             writeConcern);
                     if (replStatus.status.code() == ErrorCodes::WriteConcernFailed) {
-                        warning() << "secondaryThrottle on, but doc insert timed out; "
+                        warning() << "secondaryThrottle on, but batch insert timed out; "
                                      "continuing";
                     } else {
                         massertStatusOK(replStatus.status);
                     }
                 }
             }
+        };
+
+        auto runCloneStreamNoThrow = [&](OperationContext* streamCtx,
+                                         DBClientBase* cloneConn) -> Status {
+            Status status = Status::OK();
+            try {
+                status = runCloneStream(streamCtx, cloneConn);
+            } catch (const DBException& ex) {
+                status = ex.toStatus();
+            } catch (const std::exception& ex) {
+                status = {ErrorCodes::UnknownError, ex.what()};
+            }
 
-            if (thisTime == 0)
-                break;
+            if (!status.isOK()) {
+                cloneFailed.store(true);
+            }
+            return status;
+        };
+
+        // The migrate thread runs the first stream on its own connection, the others each get a
+        // thread, client and donor connection of their own.
+        const size_t numStreams = std::max(1, migrationCloneStreams.load());
+        std::vector<Status> streamStatuses(numStreams, Status::OK());
+        std::vector<stdx::thread> streamThreads;
+        for (size_t streamId = 1; streamId < numStreams; ++streamId) {
+            streamThreads.emplace_back([&, streamId] {
+                Client::initThread(str::stream() << "migrateCloneStream-" << streamId);
+                auto streamCtx = cc().makeOperationContext();
+
+                if (getGlobalAuthorizationManager()->isAuthEnabled()) {
+                    AuthorizationSession::get(streamCtx->getClient())
+                        ->grantInternalAuthorization();
+                }
+
+                DisableDocumentValidation streamValidationDisabler(streamCtx.get());
+
+                try {
+                    ScopedDbConnection streamConn(fromShardConnString);
+                    streamStatuses[streamId] =
+                        runCloneStreamNoThrow(streamCtx.get(), streamConn.get());
+                    if (streamStatuses[streamId].isOK()) {
+                        streamConn.done();
+                    }
+                } catch (const DBException& ex) {
+                    streamStatuses[streamId] = ex.toStatus();
+                    cloneFailed.store(true);
+                }
+
+                // All writes of the stream must be covered when the migrate thread later waits
+                // for the cloned data to replicate.
+                repl::ReplClientInfo::forClient(cc()).setLastOpToSystemLastOpTime(
+                    streamCtx.get());
+            });
+        }
+
+        streamStatuses[0] = runCloneStreamNoThrow(opCtx, conn.get());
+
+        for (auto& streamThread : streamThreads) {
+            streamThread.join();
+        }
+
+        // Cover the writes of the other streams in this client's last optime, which is used below
+        // to wait for the cloned documents to replicate.
+        repl::ReplClientInfo::forClient(opCtx->getClient()).setLastOpToSystemLastOpTime(opCtx);
+
+        for (const auto& streamStatus : streamStatuses) {
+            if (!streamStatus.isOK()) {
+                setStateFail(streamStatus.reason());
+                if (streamStatus == ErrorCodes::CommandFailed) {
+                    conn.done();
+                }
+                return;
+            }
+        }
+
+        if (getState() == ABORT) {
+            return;
         }
 
         timing.done(3);
@@ -30,7 +30,10 @@
 
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/commands/server_status.h"
+#include "mongo/db/s/chunk_load_statistics.h"
+#include "mongo/db/s/collection_range_deleter.h"
 #include "mongo/db/s/sharding_state.h"
+#include "mongo/db/service_context.h"
 #include "mongo/db/server_options.h"
 #include "mongo/s/grid.h"
 
@@ -64,6 +67,10 @@ public:
             if (!migrationStatus.isEmpty()) {
                 result.append("migrations", migrationStatus);
             }
+
+            BSONObjBuilder rangeDeleterBuilder(result.subobjStart("rangeDeleter"));
+            CollectionRangeDeleter::appendStats(&rangeDeleterBuilder);
+            rangeDeleterBuilder.doneFast();
         }
 
         return result.obj();
@@ -71,5 +78,27 @@ public:
 
 } shardingServerStatus;
 
+class ChunkLoadServerStatus : public ServerStatusSection {
+public:
+    ChunkLoadServerStatus() : ServerStatusSection("chunkLoad") {}
+
+    bool includeByDefault() const final {
+        return false;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx, const BSONElement& configElement) const final {
+        if (!ShardingState::get(opCtx)->enabled() ||
+            serverGlobalParams.clusterRole == ClusterRole::ConfigServer) {
+            return BSONObj();
+        }
+
+        BSONObjBuilder result;
+        ChunkLoadStatistics::get(opCtx)->report(
+            &result, opCtx->getServiceContext()->getFastClockSource()->now());
+        return result.obj();
+    }
+
+} chunkLoadServerStatus;
+
 }  // namespace
 }  // namespace mongo
@@ -66,6 +66,7 @@
 #include "mongo/s/sharding_initialization.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/timer.h"
 
 #include <chrono>
 #include <ctime>
@@ -478,6 +479,11 @@ ChunkVersion ShardingState::_refreshMetadata(OperationContext* opCtx, const Name
                           << " before shard name has been set",
             shardId.isValid());
 
+    Timer refreshTimer;
+
+    bool isIncremental = false;
+    size_t numChangedChunks = 0;
+
     auto newCollectionMetadata = [&]() -> std::unique_ptr<CollectionMetadata> {
         auto const catalogCache = Grid::get(opCtx)->catalogCache();
         catalogCache->invalidateShardedCollection(nss);
@@ -489,6 +495,39 @@ ChunkVersion ShardingState::_refreshMetadata(OperationContext* opCtx, const Name
             return nullptr;
         }
 
+        // If the collection has not been dropped and recreated since the installed metadata was
+        // created, only the chunks modified since then need to be applied on top of it
+        {
+            AutoGetCollection autoColl(opCtx, nss, MODE_IS);
+
+            auto currentMetadata = CollectionShardingState::get(opCtx, nss)->getMetadata();
+            if (currentMetadata &&
+                currentMetadata->getCollVersion().epoch() == cm->getVersion().epoch() &&
+                currentMetadata->getCollVersion() <= cm->getVersion()) {
+                const auto baseVersion = currentMetadata->getCollVersion();
+
+                std::vector<ChunkType> changedChunks;
+                for (const auto& chunkMapEntry : cm->chunkMap()) {
+                    const auto& chunk = chunkMapEntry.second;
+
+                    if (chunk->getLastmod() > baseVersion) {
+                        ChunkType changedChunk;
+                        changedChunk.setMin(chunk->getMin());
+                        changedChunk.setMax(chunk->getMax());
+                        changedChunk.setVersion(chunk->getLastmod());
+                        changedChunk.setShard(chunk->getShardId());
+                        changedChunks.push_back(std::move(changedChunk));
+                    }
+                }
+
+                isIncremental = true;
+                numChangedChunks = changedChunks.size();
+
+                return currentMetadata->makeUpdated(
+                    cm->getVersion(), cm->getVersion(shardId), shardId, changedChunks);
+            }
+        }
+
         RangeMap shardChunksMap =
             SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<CachedChunkInfo>();
 
@@ -502,12 +541,16 @@ ChunkVersion ShardingState::_refreshMetadata(OperationContext* opCtx, const Name
                                    CachedChunkInfo(chunk->getMax(), chunk->getLastmod()));
         }
 
+        numChangedChunks = cm->numChunks();
+
         return stdx::make_unique<CollectionMetadata>(cm->getShardKeyPattern().toBSON(),
                                                      cm->getVersion(),
                                                      cm->getVersion(shardId),
                                                      std::move(shardChunksMap));
     }();
 
+    _recordMetadataRefresh(nss, isIncremental, numChangedChunks, refreshTimer.millis());
+
     // Exclusive collection lock needed since we're now changing the metadata
     AutoGetCollection autoColl(opCtx, nss, MODE_IX, MODE_X);
 
@@ -521,6 +564,27 @@ ChunkVersion ShardingState::_refreshMetadata(OperationContext* opCtx, const Name
     return css->getMetadata()->getShardVersion();
 }
 
+void ShardingState::_recordMetadataRefresh(const NamespaceString& nss,
+                                           bool isIncremental,
+                                           size_t numChangedChunks,
+                                           long long elapsedMillis) {
+    LOG(1) << "Refreshed " << (isIncremental ? "incrementally " : "") << "metadata for "
+           << nss.ns() << " applying " << numChangedChunks << " chunks in " << elapsedMillis
+           << " ms";
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto& stats = _metadataRefreshStats[nss.ns()];
+    stats.count++;
+    if (isIncremental) {
+        stats.incrementalCount++;
+    }
+    stats.lastNumChunks = numChangedChunks;
+    stats.lastMillis = elapsedMillis;
+    stats.totalMillis += elapsedMillis;
+    stats.maxMillis = std::max(stats.maxMillis, elapsedMillis);
+}
+
 StatusWith<ScopedRegisterDonateChunk> ShardingState::registerDonateChunk(
     const MoveChunkRequest& args) {
     return _activeMigrationsRegistry.registerDonateChunk(args);
@@ -531,8 +595,8 @@ StatusWith<ScopedRegisterReceiveChunk> ShardingState::registerReceiveChunk(
     return _activeMigrationsRegistry.registerReceiveChunk(nss, chunkRange, fromShardId);
 }
 
-boost::optional<NamespaceString> ShardingState::getActiveDonateChunkNss() {
-    return _activeMigrationsRegistry.getActiveDonateChunkNss();
+std::vector<NamespaceString> ShardingState::getActiveDonateChunkNamespaces() {
+    return _activeMigrationsRegistry.getActiveDonateChunkNamespaces();
 }
 
 BSONObj ShardingState::getActiveMigrationStatusReport(OperationContext* opCtx) {
@@ -565,6 +629,22 @@ void ShardingState::appendInfo(OperationContext* opCtx, BSONObjBuilder& builder)
     }
 
     versionB.done();
+
+    BSONObjBuilder refreshesB(builder.subobjStart("metadataRefreshes"));
+    for (const auto& entry : _metadataRefreshStats) {
+        const auto& stats = entry.second;
+
+        BSONObjBuilder collB(refreshesB.subobjStart(entry.first));
+        collB.append("count", stats.count);
+        collB.append("incremental", stats.incrementalCount);
+        collB.append("lastNumChunks", stats.lastNumChunks);
+        collB.append("lastMillis", stats.lastMillis);
+        collB.append("totalMillis", stats.totalMillis);
+        collB.append("maxMillis", stats.maxMillis);
+        collB.done();
+    }
+
+    refreshesB.done();
 }
 
 bool ShardingState::needCollectionMetadata(OperationContext* opCtx, const string& ns) {
@@ -213,19 +213,19 @@ public:
                                                                 const ShardId& fromShardId);
 
     /**
-     * If a migration has been previously registered through a call to registerDonateChunk returns
-     * that namespace. Otherwise returns boost::none.
+     * Returns the namespaces of all the migrations, which have been previously registered through a
+     * call to registerDonateChunk and are still active.
      *
-     * This method can be called without any locks, but once the namespace is fetched it needs to be
+     * This method can be called without any locks, but once a namespace is fetched it needs to be
      * re-checked after acquiring some intent lock on that namespace.
      */
-    boost::optional<NamespaceString> getActiveDonateChunkNss();
+    std::vector<NamespaceString> getActiveDonateChunkNamespaces();
 
     /**
      * Get a migration status report from the migration registry. If no migration is active, this
      * returns an empty BSONObj.
      *
-     * Takes an IS lock on the namespace of the active migration, if one is active.
+     * Takes an IS lock on the namespace of the reported migration, if one is active.
      */
     BSONObj getActiveMigrationStatusReport(OperationContext* opCtx);
 
@@ -299,6 +299,16 @@ private:
      */
     ChunkVersion _refreshMetadata(OperationContext* opCtx, const NamespaceString& nss);
 
+    /**
+     * Accumulates the latency statistics of a metadata refresh for the specified collection.
+     * 'numChangedChunks' is the number of chunks which were applied for the refresh, which for a
+     * non-incremental refresh is the total number of chunks of the collection.
+     */
+    void _recordMetadataRefresh(const NamespaceString& nss,
+                                bool isIncremental,
+                                size_t numChangedChunks,
+                                long long elapsedMillis);
+
     // Manages the state of the migration recipient shard
     MigrationDestinationManager _migrationDestManager;
 
@@ -325,6 +335,18 @@ private:
     // holding X lock on the respective namespace.
     CollectionShardingStateMap _collections;
 
+    // Latency statistics of the metadata refreshes done for each collection, reported as part of
+    // the sharding section of serverStatus
+    struct MetadataRefreshStats {
+        long long count{0};
+        long long incrementalCount{0};
+        long long lastNumChunks{0};
+        long long lastMillis{0};
+        long long totalMillis{0};
+        long long maxMillis{0};
+    };
+    stdx::unordered_map<std::string, MetadataRefreshStats> _metadataRefreshStats;
+
     // The id for the cluster this shard belongs to.
     OID _clusterId;
 
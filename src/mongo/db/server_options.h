@@ -76,6 +76,9 @@ struct ServerGlobalParams {
 
     int unixSocketPermissions = DEFAULT_UNIX_PERMS;  // permissions for the UNIX domain socket
 
+    std::string transportLayer = "legacy";  // --transportLayer (legacy or asio)
+    std::string serviceExecutor = "synchronous";  // --serviceExecutor (synchronous or adaptive)
+
     std::string keyFile;  // Path to keyfile, or empty if none.
     std::string pidFile;  // Path to pid file, or empty if none.
 
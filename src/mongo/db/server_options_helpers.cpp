@@ -202,6 +202,20 @@ Status addGeneralServerOptions(moe::OptionSection* options) {
     options->addOptionChaining(
         "net.maxIncomingConnections", "maxConns", moe::Int, maxConnInfoBuilder.str().c_str());
 
+    options
+        ->addOptionChaining("net.transportLayer",
+                            "transportLayer",
+                            moe::String,
+                            "sets the transport layer implementation (legacy/asio)")
+        .format("(:?legacy)|(:?asio)", "(legacy/asio)");
+
+    options
+        ->addOptionChaining("net.serviceExecutor",
+                            "serviceExecutor",
+                            moe::String,
+                            "sets the service executor implementation (synchronous/adaptive)")
+        .format("(:?synchronous)|(:?adaptive)", "(synchronous/adaptive)");
+
     options
         ->addOptionChaining(
             "logpath",
@@ -826,6 +840,19 @@ Status storeServerOptions(const moe::Environment& params) {
         }
     }
 
+    if (params.count("net.transportLayer")) {
+        serverGlobalParams.transportLayer = params["net.transportLayer"].as<std::string>();
+    }
+
+    if (params.count("net.serviceExecutor")) {
+        serverGlobalParams.serviceExecutor = params["net.serviceExecutor"].as<std::string>();
+        if (serverGlobalParams.serviceExecutor != "synchronous" &&
+            serverGlobalParams.transportLayer != "asio") {
+            return Status(ErrorCodes::BadValue,
+                          "serviceExecutor must be synchronous unless transportLayer is asio");
+        }
+    }
+
     if (params.count("net.wireObjectCheck")) {
         serverGlobalParams.objcheck = params["net.wireObjectCheck"].as<bool>();
     }
@@ -35,11 +35,13 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/transport/service_entry_point.h"
+#include "mongo/transport/service_executor.h"
 #include "mongo/transport/session.h"
 #include "mongo/transport/transport_layer.h"
 #include "mongo/transport/transport_layer_manager.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/periodic_runner.h"
 #include "mongo/util/system_clock_source.h"
 #include "mongo/util/system_tick_source.h"
 
@@ -163,6 +165,14 @@ ServiceEntryPoint* ServiceContext::getServiceEntryPoint() const {
     return _serviceEntryPoint.get();
 }
 
+transport::ServiceExecutor* ServiceContext::getServiceExecutor() const {
+    return _serviceExecutor.get();
+}
+
+PeriodicRunner* ServiceContext::getPeriodicRunner() const {
+    return _periodicRunner.get();
+}
+
 Status ServiceContext::addAndStartTransportLayer(std::unique_ptr<transport::TransportLayer> tl) {
     return _transportLayerManager->addAndStartTransportLayer(std::move(tl));
 }
@@ -195,6 +205,14 @@ void ServiceContext::setServiceEntryPoint(std::unique_ptr<ServiceEntryPoint> sep
     _serviceEntryPoint = std::move(sep);
 }
 
+void ServiceContext::setServiceExecutor(std::unique_ptr<transport::ServiceExecutor> exec) {
+    _serviceExecutor = std::move(exec);
+}
+
+void ServiceContext::setPeriodicRunner(std::unique_ptr<PeriodicRunner> runner) {
+    _periodicRunner = std::move(runner);
+}
+
 void ServiceContext::ClientDeleter::operator()(Client* client) const {
     ServiceContext* const service = client->getServiceContext();
     {
@@ -50,9 +50,11 @@ class AbstractMessagingPort;
 class Client;
 class OperationContext;
 class OpObserver;
+class PeriodicRunner;
 class ServiceEntryPoint;
 
 namespace transport {
+class ServiceExecutor;
 class TransportLayer;
 class TransportLayerManager;
 }  // namespace transport
@@ -332,6 +334,20 @@ public:
      */
     ServiceEntryPoint* getServiceEntryPoint() const;
 
+    /**
+     * Get the service executor for the service context. May return nullptr, in which case each
+     * request is processed on the thread that received it.
+     *
+     * See ServiceExecutor for more details.
+     */
+    transport::ServiceExecutor* getServiceExecutor() const;
+
+    /**
+     * Get the PeriodicRunner that background jobs of this service schedule their periodic work
+     * on, or nullptr if none has been set.
+     */
+    PeriodicRunner* getPeriodicRunner() const;
+
     /**
      * Add a new TransportLayer to this service context. The new TransportLayer will
      * be added to the TransportLayerManager accessible via getTransportLayer().
@@ -393,6 +409,16 @@ public:
      */
     void setServiceEntryPoint(std::unique_ptr<ServiceEntryPoint> sep);
 
+    /**
+     * Binds the service executor to the service context
+     */
+    void setServiceExecutor(std::unique_ptr<transport::ServiceExecutor> exec);
+
+    /**
+     * Binds the periodic runner to the service context
+     */
+    void setPeriodicRunner(std::unique_ptr<PeriodicRunner> runner);
+
 protected:
     ServiceContext();
 
@@ -428,6 +454,16 @@ private:
      */
     std::unique_ptr<ServiceEntryPoint> _serviceEntryPoint;
 
+    /**
+     * The ServiceExecutor
+     */
+    std::unique_ptr<transport::ServiceExecutor> _serviceExecutor;
+
+    /**
+     * The PeriodicRunner
+     */
+    std::unique_ptr<PeriodicRunner> _periodicRunner;
+
     /**
      * Vector of registered observers.
      */
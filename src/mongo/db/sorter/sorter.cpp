@@ -47,10 +47,18 @@
 
 #include "mongo/db/sorter/sorter.h"
 
+#include <algorithm>
 #include <boost/filesystem/operations.hpp>
+#include <cstdio>
 #include <snappy.h>
 #include <vector>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#endif
+
+#include <third_party/murmurhash3/MurmurHash3.h>
+
 #include "mongo/base/string_data.h"
 #include "mongo/config.h"
 #include "mongo/db/jsobj.h"
@@ -114,6 +122,129 @@ private:
     const std::string _fileName;
 };
 
+// Bounds on the read buffer each spilled run gets while it is being merged.
+const size_t kMinReadAheadBytes = 64 * 1024;
+const size_t kMaxReadAheadBytes = 1024 * 1024;
+
+/**
+ * Each run that can be merged at once gets an equal share of the sort's memory for its read
+ * buffer, so that a wide merge does large sequential reads rather than one small read per block.
+ */
+inline size_t readAheadBytesForRun(const SortOptions& opts) {
+    const size_t share = opts.maxMemoryUsageBytes / std::max(opts.mergeFanIn, size_t(1));
+    return std::min(std::max(share, kMinReadAheadBytes), kMaxReadAheadBytes);
+}
+
+/**
+ * Reads a spill file front to back through a private buffer that is refilled 'bufferSize' bytes
+ * at a time. The file is only opened on the first read and is closed, and the buffer freed, once
+ * it has been read to the end, so runs that are not being merged yet hold neither a descriptor
+ * nor memory. Where the platform supports it, the kernel is asked to start loading the next
+ * window in the background as soon as the current one has been read.
+ */
+class SpillFileReader {
+public:
+    SpillFileReader(const std::string& fileName, size_t bufferSize)
+        : _fileName(fileName), _bufferSize(bufferSize) {}
+
+    ~SpillFileReader() {
+        close();
+    }
+
+    /**
+     * Copies up to 'size' bytes into 'out' and returns how many were copied, which is less than
+     * 'size' only at the end of the file. Asserts on any other error.
+     */
+    size_t read(char* out, size_t size) {
+        size_t copied = 0;
+        while (copied < size) {
+            if (_pos == _end) {
+                if (_eof) {
+                    _buffer.reset();
+                    break;
+                }
+
+                // Don't stage reads through the buffer that would fill it more than once anyway.
+                if (size - copied >= _bufferSize) {
+                    copied += readRaw(out + copied, size - copied);
+                    continue;
+                }
+
+                refill();
+                continue;
+            }
+
+            const size_t n = std::min(size - copied, _end - _pos);
+            memcpy(out + copied, _buffer.get() + _pos, n);
+            _pos += n;
+            copied += n;
+        }
+        return copied;
+    }
+
+private:
+    void open() {
+        _file = fopen(_fileName.c_str(), "rb");
+        massert(16814,
+                str::stream() << "error opening file \"" << _fileName << "\": "
+                              << myErrnoWithDescription(),
+                _file);
+
+        // All buffering is done here, so that refills read straight into _buffer.
+        setvbuf(_file, nullptr, _IONBF, 0);
+        _buffer.reset(new char[_bufferSize]);
+#if defined(POSIX_FADV_SEQUENTIAL)
+        posix_fadvise(fileno(_file), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    }
+
+    void close() {
+        if (_file) {
+            fclose(_file);
+            _file = nullptr;
+        }
+    }
+
+    void refill() {
+        if (!_file)
+            open();
+
+        _pos = 0;
+        _end = readRaw(_buffer.get(), _bufferSize);
+    }
+
+    size_t readRaw(char* out, size_t size) {
+        if (!_file)
+            open();
+
+        const size_t n = fread(out, 1, size, _file);
+        if (n < size) {
+            massert(16817,
+                    str::stream() << "error reading file \"" << _fileName << "\": "
+                                  << myErrnoWithDescription(),
+                    !ferror(_file));
+            _eof = true;
+            close();
+            return n;
+        }
+
+        _offset += n;
+#if defined(POSIX_FADV_WILLNEED)
+        posix_fadvise(fileno(_file), _offset, _bufferSize, POSIX_FADV_WILLNEED);
+#endif
+        return n;
+    }
+
+    const std::string _fileName;
+    const size_t _bufferSize;
+    FILE* _file = nullptr;
+    bool _eof = false;
+    int64_t _offset = 0;  // File position of the next read.
+    std::unique_ptr<char[]> _buffer;
+    size_t _pos = 0;  // Bytes of _buffer already returned.
+    size_t _end = 0;  // Bytes of _buffer that are valid.
+};
+
 /** Returns results from sorted in-memory storage */
 template <typename Key, typename Value>
 class InMemIterator : public SortIteratorInterface<Key, Value> {
@@ -154,17 +285,13 @@ public:
 
     FileIterator(const std::string& fileName,
                  const Settings& settings,
-                 std::shared_ptr<FileDeleter> fileDeleter)
+                 std::shared_ptr<FileDeleter> fileDeleter,
+                 size_t readAheadBytes)
         : _settings(settings),
           _done(false),
           _fileName(fileName),
           _fileDeleter(fileDeleter),
-          _file(_fileName.c_str(), std::ios::in | std::ios::binary) {
-        massert(16814,
-                str::stream() << "error opening file \"" << _fileName << "\": "
-                              << myErrnoWithDescription(),
-                _file.good());
-
+          _file(_fileName, readAheadBytes) {
         massert(16815,
                 str::stream() << "unexpected empty file: " << _fileName,
                 boost::filesystem::file_size(_fileName) != 0);
@@ -204,10 +331,19 @@ private:
         const bool compressed = rawSize < 0;
         int32_t blockSize = std::abs(rawSize);
 
+        uint32_t checksum;
+        read(&checksum, sizeof(checksum));
+
         _buffer.reset(new char[blockSize]);
         read(_buffer.get(), blockSize);
         massert(16816, "file too short?", !_done);
 
+        uint32_t actualChecksum;
+        MurmurHash3_x86_32(_buffer.get(), blockSize, 0, &actualChecksum);
+        massert(40662,
+                str::stream() << "checksum mismatch in file \"" << _fileName << "\"",
+                actualChecksum == checksum);
+
         auto encryptionHooks = EncryptionHooks::get(getGlobalServiceContext());
         if (encryptionHooks->enabled()) {
             std::unique_ptr<char[]> out(new char[blockSize]);
@@ -249,18 +385,8 @@ private:
 
     // sets _done to true on EOF - asserts on any other error
     void read(void* out, size_t size) {
-        _file.read(reinterpret_cast<char*>(out), size);
-        if (!_file.good()) {
-            if (_file.eof()) {
-                _done = true;
-                return;
-            }
-
-            msgasserted(16817,
-                        str::stream() << "error reading file \"" << _fileName << "\": "
-                                      << myErrnoWithDescription());
-        }
-        verify(_file.gcount() == static_cast<std::streamsize>(size));
+        if (_file.read(reinterpret_cast<char*>(out), size) != size)
+            _done = true;
     }
 
     const Settings _settings;
@@ -269,7 +395,7 @@ private:
     std::unique_ptr<BufReader> _reader;
     std::string _fileName;
     std::shared_ptr<FileDeleter> _fileDeleter;  // Must outlive _file
-    std::ifstream _file;
+    SpillFileReader _file;
 };
 
 /** Merge-sorts results from 0 or more FileIterators */
@@ -396,6 +522,48 @@ private:
     STLComparator _greater;                      // named so calls make sense
 };
 
+/**
+ * Merges consecutive groups of 'opts.mergeFanIn' spilled runs into new runs until no more than
+ * that many remain, so that the final merge reads from a bounded number of files at once. Only
+ * adjacent runs are merged together, which keeps equal keys in the order they were added.
+ */
+template <typename Key, typename Value, typename Comparator>
+void mergeRunsToFanIn(std::vector<std::shared_ptr<SortIteratorInterface<Key, Value>>>* runs,
+                      const SortOptions& opts,
+                      const Comparator& comp,
+                      const typename Sorter<Key, Value>::Settings& settings) {
+    typedef SortIteratorInterface<Key, Value> Iterator;
+
+    const size_t fanIn = std::max(opts.mergeFanIn, size_t(2));
+    while (runs->size() > fanIn) {
+        std::vector<std::shared_ptr<Iterator>> merged;
+        for (size_t begin = 0; begin < runs->size(); begin += fanIn) {
+            const size_t end = std::min(begin + fanIn, runs->size());
+
+            // Drop our references as we go so each input file is deleted once it is merged.
+            std::vector<std::shared_ptr<Iterator>> group;
+            for (size_t i = begin; i < end; ++i)
+                group.push_back(std::move((*runs)[i]));
+
+            if (group.size() == 1) {
+                merged.push_back(std::move(group.front()));
+                continue;
+            }
+
+            std::unique_ptr<Iterator> it(Iterator::merge(group, opts, comp));
+            group.clear();
+
+            SortedFileWriter<Key, Value> writer(opts, settings);
+            while (it->more()) {
+                const std::pair<Key, Value> next = it->next();
+                writer.addAlreadySorted(next.first, next.second);
+            }
+            merged.push_back(std::shared_ptr<Iterator>(writer.done()));
+        }
+        runs->swap(merged);
+    }
+}
+
 template <typename Key, typename Value, typename Comparator>
 class NoLimitSorter : public Sorter<Key, Value> {
 public:
@@ -429,6 +597,7 @@ public:
         }
 
         spill();
+        mergeRunsToFanIn(&_iters, _opts, _comp, _settings);
         return Iterator::merge(_iters, _opts, _comp);
     }
 
@@ -570,12 +739,7 @@ public:
         // This also *works* with limit==1 but LimitOneSorter should be used instead
         verify(_opts.limit > 1);
 
-        // Preallocate a fixed sized vector of the required size if we
-        // don't expect it to have a major impact on our memory budget.
-        // This is the common case with small limits.
-        if ((sizeof(Data) * opts.limit) < opts.maxMemoryUsageBytes / 10) {
-            _data.reserve(opts.limit);
-        }
+        reserveHeap();
     }
 
     void add(const Key& key, const Value& val) {
@@ -628,6 +792,7 @@ public:
         }
 
         spill();
+        mergeRunsToFanIn(&_iters, _opts, _comp, _settings);
         return Iterator::merge(_iters, _opts, _comp);
     }
 
@@ -652,6 +817,15 @@ private:
         const Comparator& _comp;
     };
 
+    // Preallocate a fixed sized vector of the required size if we
+    // don't expect it to have a major impact on our memory budget.
+    // This is the common case with small limits.
+    void reserveHeap() {
+        if ((sizeof(Data) * _opts.limit) < _opts.maxMemoryUsageBytes / 10) {
+            _data.reserve(_opts.limit);
+        }
+    }
+
     void sort() {
         STLComparator less(_comp);
 
@@ -771,6 +945,10 @@ private:
         // clear _data and release backing array's memory
         std::vector<Data>().swap(_data);
 
+        // The next batch is again collected into a heap of at most '_opts.limit' values, so
+        // restore the preallocation rather than growing the vector one reallocation at a time.
+        reserveHeap();
+
         _iters.push_back(std::shared_ptr<Iterator>(writer.done()));
 
         _memUsed = 0;
@@ -806,7 +984,7 @@ inline unsigned nextFileNumber() {
 
 template <typename Key, typename Value>
 SortedFileWriter<Key, Value>::SortedFileWriter(const SortOptions& opts, const Settings& settings)
-    : _settings(settings) {
+    : _settings(settings), _readAheadBytes(sorter::readAheadBytesForRun(opts)) {
     namespace str = mongoutils::str;
 
     // This should be checked by consumers, but if we get here don't allow writes.
@@ -884,10 +1062,15 @@ void SortedFileWriter<Key, Value>::spill() {
         size = resultLen;
     }
 
+    // Covers the bytes exactly as written, so it catches corruption of encrypted data too.
+    uint32_t checksum;
+    MurmurHash3_x86_32(outBuffer, size, 0, &checksum);
+
     // negative size means compressed
     size = shouldCompress ? -size : size;
     try {
         _file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        _file.write(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
         _file.write(outBuffer, std::abs(size));
 
     } catch (const std::exception&) {
@@ -903,7 +1086,8 @@ template <typename Key, typename Value>
 SortIteratorInterface<Key, Value>* SortedFileWriter<Key, Value>::done() {
     spill();
     _file.close();
-    return new sorter::FileIterator<Key, Value>(_fileName, _settings, _fileDeleter);
+    return new sorter::FileIterator<Key, Value>(
+        _fileName, _settings, _fileDeleter, _readAheadBytes);
 }
 
 //
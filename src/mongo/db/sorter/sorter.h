@@ -98,8 +98,11 @@ struct SortOptions {
     bool extSortAllowed;         /// If false, uassert if more mem needed than allowed.
     std::string tempDir;         /// Directory to directly place files in.
                                  /// Must be explicitly set if extSortAllowed is true.
+    size_t mergeFanIn;           /// Max number of spilled runs read from at once by a merge.
+                                 /// Runs beyond this are first merged in several passes.
 
-    SortOptions() : limit(0), maxMemoryUsageBytes(64 * 1024 * 1024), extSortAllowed(false) {}
+    SortOptions()
+        : limit(0), maxMemoryUsageBytes(64 * 1024 * 1024), extSortAllowed(false), mergeFanIn(128) {}
 
     /// Fluent API to support expressions like SortOptions().Limit(1000).ExtSortAllowed(true)
 
@@ -122,6 +125,11 @@ struct SortOptions {
         tempDir = newTempDir;
         return *this;
     }
+
+    SortOptions& MergeFanIn(size_t newMergeFanIn) {
+        mergeFanIn = newMergeFanIn;
+        return *this;
+    }
 };
 
 /// This is the output from the sorting framework
@@ -200,6 +208,7 @@ private:
     void spill();
 
     const Settings _settings;
+    const size_t _readAheadBytes;  // Read buffer size of the FileIterator returned by done().
     std::string _fileName;
     std::shared_ptr<sorter::FileDeleter> _fileDeleter;  // Must outlive _file
     std::ofstream _file;
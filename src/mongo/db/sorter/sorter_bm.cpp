@@ -0,0 +1,150 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/sorter/sorter.h"
+
+#include "mongo/base/data_type_endian.h"
+#include "mongo/base/init.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/service_context_noop.h"
+#include "mongo/platform/random.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/benchmark.h"
+#include "mongo/unittest/temp_dir.h"
+
+// Need access to internal classes
+#include "mongo/db/sorter/sorter.cpp"
+
+namespace mongo {
+namespace {
+
+using unittest::benchmarkDoNotOptimize;
+
+// Stub to avoid including the server environment library.
+MONGO_INITIALIZER(SetGlobalEnvironment)(InitializerContext* context) {
+    setGlobalServiceContext(stdx::make_unique<ServiceContextNoop>());
+    return Status::OK();
+}
+
+class IntWrapper {
+public:
+    IntWrapper(int i = 0) : _i(i) {}
+    operator const int&() const {
+        return _i;
+    }
+
+    /// members for Sorter
+    struct SorterDeserializeSettings {};  // unused
+    void serializeForSorter(BufBuilder& buf) const {
+        buf.appendNum(_i);
+    }
+    static IntWrapper deserializeForSorter(BufReader& buf, const SorterDeserializeSettings&) {
+        return buf.read<LittleEndian<int>>().value;
+    }
+    int memUsageForSorter() const {
+        return sizeof(IntWrapper);
+    }
+    IntWrapper getOwned() const {
+        return *this;
+    }
+
+private:
+    int _i;
+};
+
+typedef std::pair<IntWrapper, IntWrapper> IWPair;
+typedef Sorter<IntWrapper, IntWrapper> IWSorter;
+
+class IWComparator {
+public:
+    int operator()(const IWPair& lhs, const IWPair& rhs) const {
+        if (lhs.first == rhs.first)
+            return 0;
+        return lhs.first < rhs.first ? -1 : 1;
+    }
+};
+
+const int kNumItems = 100 * 1000;
+
+/**
+ * Generates the same pseudo-random input for every repetition and sorts all of it per iteration.
+ */
+class SorterBenchmark : public unittest::Benchmark {
+protected:
+    void setUp() override {
+        PseudoRandom random(12345);
+        _input.reserve(kNumItems);
+        for (int i = 0; i < kNumItems; ++i) {
+            _input.push_back(random.nextInt32());
+        }
+    }
+
+    void sortAll(unittest::BenchmarkState& state, const SortOptions& opts) {
+        while (state.keepRunning()) {
+            std::unique_ptr<IWSorter> sorter(IWSorter::make(opts, IWComparator()));
+            for (int key : _input) {
+                sorter->add(key, -key);
+            }
+            std::unique_ptr<IWSorter::Iterator> it(sorter->done());
+            long long sum = 0;
+            while (it->more()) {
+                sum += it->next().first;
+            }
+            benchmarkDoNotOptimize(sum);
+        }
+        state.setItemsProcessed(state.iterations() * kNumItems);
+    }
+
+private:
+    std::vector<int> _input;
+};
+
+BENCHMARK_F(SorterBenchmark, InMemory) {
+    sortAll(state, SortOptions());
+}
+
+BENCHMARK_F(SorterBenchmark, Limit1) {
+    sortAll(state, SortOptions().Limit(1));
+}
+
+BENCHMARK_F(SorterBenchmark, Limit100) {
+    sortAll(state, SortOptions().Limit(100));
+}
+
+BENCHMARK_F(SorterBenchmark, External) {
+    unittest::TempDir tempDir("sorterBenchmark");
+    // Small enough that the input is spilled to roughly ten files.
+    const size_t memLimit = kNumItems * 2 * sizeof(IntWrapper) / 10;
+    sortAll(state,
+            SortOptions().TempDir(tempDir.path()).ExtSortAllowed().MaxMemoryUsageBytes(memLimit));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -271,6 +271,30 @@ public:
             ASSERT_ITERATORS_EQUIVALENT(std::shared_ptr<IWIterator>(sorter.done()),
                                         make_shared<IntIterator>(0, 10 * 1000 * 1000));
         }
+        {  // corrupted
+            SortedFileWriter<IntWrapper, IntWrapper> sorter(opts);
+            for (int i = 0; i < 100 * 1000; i++)
+                sorter.addAlreadySorted(i, -i);
+            std::shared_ptr<IWIterator> iter(sorter.done());
+
+            // Flip one byte partway into the only file, which is not read until iteration starts.
+            boost::filesystem::directory_iterator file(tempDir.path());
+            std::fstream stream(file->path().string(),
+                                std::ios::in | std::ios::out | std::ios::binary);
+            stream.seekg(boost::filesystem::file_size(file->path()) / 2);
+            const char byte = stream.get();
+            stream.seekp(boost::filesystem::file_size(file->path()) / 2);
+            stream.put(~byte);
+            stream.close();
+
+            ASSERT_THROWS_CODE(
+                [&] {
+                    while (iter->more())
+                        iter->next();
+                }(),
+                DBException,
+                40662);
+        }
 
         ASSERT(boost::filesystem::is_empty(tempDir.path()));
     }
@@ -518,6 +542,13 @@ public:
 };
 
 
+// Spills more runs than may be merged at once, so they are merged in several passes.
+class LotsOfDataNarrowMerge : public LotsOfDataLittleMemory</*random=*/true> {
+    SortOptions adjustSortOptions(SortOptions opts) {
+        return LotsOfDataLittleMemory::adjustSortOptions(opts).MergeFanIn(4);
+    }
+};
+
 template <long long Limit, bool Random = true>
 class LotsOfDataWithLimit : public LotsOfDataLittleMemory<Random> {
     typedef LotsOfDataLittleMemory<Random> Parent;
@@ -556,6 +587,7 @@ public:
         add<SorterTests::Dupes>();
         add<SorterTests::LotsOfDataLittleMemory</*random=*/false>>();
         add<SorterTests::LotsOfDataLittleMemory</*random=*/true>>();
+        add<SorterTests::LotsOfDataNarrowMerge>();
         add<SorterTests::LotsOfDataWithLimit<1, /*random=*/false>>();     // limit=1 is special case
         add<SorterTests::LotsOfDataWithLimit<1, /*random=*/true>>();      // limit=1 is special case
         add<SorterTests::LotsOfDataWithLimit<100, /*random=*/false>>();   // fits in mem
@@ -41,6 +41,7 @@
 #include "mongo/db/server_options.h"
 #include "mongo/db/startup_warnings_common.h"
 #include "mongo/db/storage/storage_options.h"
+#include "mongo/util/huge_page_arena.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/processinfo.h"
@@ -287,6 +288,17 @@ void logMongodStartupWarnings(const StorageGlobalParams& storageParams,
     }
 #endif  // __linux__
 
+    Status hugePageReservationStatus = HugePageArena::get().getReservationStatus();
+    if (!hugePageReservationStatus.isOK()) {
+        log() << startupWarningsLog;
+        log() << "** WARNING: Could not reserve the explicit huge pages requested by "
+                 "hugePageReservationMB."
+              << startupWarningsLog;
+        log() << "**          " << hugePageReservationStatus.reason() << startupWarningsLog;
+        log() << "**          Memory will be allocated from normal pages." << startupWarningsLog;
+        warned = true;
+    }
+
 #ifndef _WIN32
     // Check that # of files rlmit >= 1000
     const unsigned int minNumFiles = 1000;
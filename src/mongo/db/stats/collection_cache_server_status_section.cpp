@@ -0,0 +1,73 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/commands/server_status.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/stats/storage_stats.h"
+
+namespace mongo {
+namespace {
+
+// The number of collections serverStatus, and therefore FTDC, reports cache statistics for. Each
+// sample opens a statistics cursor on every collection and index, so this is off by default.
+MONGO_EXPORT_SERVER_PARAMETER(collectionCacheStatsTopN, int, 0);
+
+/**
+ * Reports the collections holding the most bytes in the storage engine's cache. It is requested by
+ * the FTDC serverStatus collector, and is empty unless collectionCacheStatsTopN is positive or a
+ * positive limit is given as the section's value.
+ */
+class CollectionCacheServerStatusSection final : public ServerStatusSection {
+public:
+    CollectionCacheServerStatusSection() : ServerStatusSection("collectionCache") {}
+
+    bool includeByDefault() const final {
+        return false;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx, const BSONElement& configElem) const final {
+        int limit =
+            configElem.isNumber() ? configElem.numberInt() : collectionCacheStatsTopN.load();
+        if (limit <= 0) {
+            return BSONObj();
+        }
+
+        BSONObjBuilder result;
+        BSONArrayBuilder collections(result.subarrayStart("collections"));
+        appendTopCollectionCacheStats(opCtx, static_cast<size_t>(limit), &collections);
+        collections.doneFast();
+        return result.obj();
+    }
+} collectionCacheServerStatusSection;
+
+}  // namespace
+}  // namespace mongo
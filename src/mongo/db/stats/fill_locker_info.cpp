@@ -74,6 +74,14 @@ void fillLockerInfo(const Locker::LockerInfo& lockerInfo, BSONObjBuilder& infoBu
         lockerInfo.stats.report(&lockStats);
         lockStats.done();
     }
+
+    // "admission" section
+    {
+        BSONObjBuilder admission(infoBuilder.subobjStart("admission"));
+        admission.append("priority", lockerInfo.lowPriorityAdmission ? "low" : "normal");
+        admission.append("ticketQueuedMicros", lockerInfo.ticketQueuedMicros);
+        admission.done();
+    }
 }
 
 }  // namespace mongo
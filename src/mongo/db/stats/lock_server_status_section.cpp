@@ -33,6 +33,7 @@
 #include "mongo/db/client.h"
 #include "mongo/db/commands/server_status.h"
 #include "mongo/db/concurrency/lock_stats.h"
+#include "mongo/db/concurrency/locker.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
 
@@ -91,6 +92,19 @@ public:
             activeClientsBuilder.done();
         }
 
+        {
+            BSONObjBuilder ticketQueueBuilder(ret.subobjStart("ticketQueue"));
+            for (bool lowPriority : {false, true}) {
+                const Locker::TicketQueueStats stats = Locker::getTicketQueueStats(lowPriority);
+                BSONObjBuilder priorityBuilder(
+                    ticketQueueBuilder.subobjStart(lowPriority ? "lowPriority" : "normal"));
+                priorityBuilder.append("queued", stats.queued);
+                priorityBuilder.append("queuedMicros", stats.queuedMicros);
+                priorityBuilder.done();
+            }
+            ticketQueueBuilder.done();
+        }
+
         ret.done();
 
         return ret.obj();
@@ -52,6 +52,11 @@ public:
      */
     void increment(uint64_t latency, Command::ReadWriteType type);
 
+    /**
+     * Adds the bucket counts, latency totals and operation counts of 'other' to this histogram.
+     */
+    void add(const OperationLatencyHistogram& other);
+
     /**
      * Appends the three histograms with latency totals and operation counts.
      */
@@ -75,6 +80,8 @@ private:
 
     void _incrementData(uint64_t latency, int bucket, HistogramData* data);
 
+    static void _addData(const HistogramData& other, HistogramData* data);
+
     HistogramData _reads, _writes, _commands;
 };
 }  // namespace mongo
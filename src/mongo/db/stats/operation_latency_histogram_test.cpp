@@ -89,4 +89,29 @@ TEST(OperationLatencyHistogram, CheckBucketCountsAndTotalLatency) {
         ASSERT_EQUALS(bucket["count"].Long(), (i < kMaxBuckets - 1) ? 3 : 2);
     }
 }
+
+TEST(OperationLatencyHistogram, AddMergesBucketsOfEachOperationType) {
+    OperationLatencyHistogram first;
+    OperationLatencyHistogram second;
+    first.increment(1, Command::ReadWriteType::kRead);
+    first.increment(100, Command::ReadWriteType::kWrite);
+    second.increment(1, Command::ReadWriteType::kRead);
+    second.increment(5000, Command::ReadWriteType::kCommand);
+    first.add(second);
+
+    BSONObjBuilder outBuilder;
+    first.append(true, &outBuilder);
+    BSONObj out = outBuilder.done();
+    ASSERT_EQUALS(out["reads"]["ops"].Long(), 2);
+    ASSERT_EQUALS(out["reads"]["latency"].Long(), 2);
+    ASSERT_EQUALS(out["writes"]["ops"].Long(), 1);
+    ASSERT_EQUALS(out["writes"]["latency"].Long(), 100);
+    ASSERT_EQUALS(out["commands"]["ops"].Long(), 1);
+    ASSERT_EQUALS(out["commands"]["latency"].Long(), 5000);
+
+    std::vector<BSONElement> readBuckets = out["reads"]["histogram"].Array();
+    ASSERT_EQUALS(readBuckets.size(), 1U);
+    ASSERT_EQUALS(readBuckets[0]["micros"].Long(), 0);
+    ASSERT_EQUALS(readBuckets[0]["count"].Long(), 2);
+}
 }  // namespace mongo
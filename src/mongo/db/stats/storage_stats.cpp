@@ -28,16 +28,53 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
+
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/storage_engine.h"
 
 #include "mongo/db/stats/storage_stats.h"
 
 namespace mongo {
 
+namespace {
+
+/**
+ * Appends the cache statistics of 'collection' and, under "indexes", of each of its ready indexes.
+ * Returns false if the storage engine does not track its cache per collection.
+ */
+bool appendCacheStatsForCollection(OperationContext* opCtx,
+                                   Collection* collection,
+                                   BSONObjBuilder* result) {
+    if (!collection->getRecordStore()->appendCacheStats(opCtx, result)) {
+        return false;
+    }
+
+    BSONObjBuilder indexes(result->subobjStart("indexes"));
+    IndexCatalog* indexCatalog = collection->getIndexCatalog();
+    IndexCatalog::IndexIterator i = indexCatalog->getIndexIterator(opCtx, false);
+    while (i.more()) {
+        const IndexDescriptor* descriptor = i.next();
+        IndexAccessMethod* iam = indexCatalog->getIndex(descriptor);
+        invariant(iam);
+
+        BSONObjBuilder bob;
+        if (iam->appendCacheStats(opCtx, &bob)) {
+            indexes.append(descriptor->indexName(), bob.obj());
+        }
+    }
+    indexes.doneFast();
+    return true;
+}
+
+}  // namespace
+
 Status appendCollectionStorageStats(OperationContext* opCtx,
                                     const NamespaceString& nss,
                                     const BSONObj& param,
@@ -108,4 +145,83 @@ Status appendCollectionStorageStats(OperationContext* opCtx,
 
     return Status::OK();
 }
+
+Status appendCollectionCacheStats(OperationContext* opCtx,
+                                  const NamespaceString& nss,
+                                  BSONObjBuilder* result) {
+    AutoGetCollectionForReadCommand ctx(opCtx, nss);
+    if (!ctx.getDb()) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "Database [" << nss.db().toString() << "] not found."};
+    }
+
+    Collection* collection = ctx.getCollection();
+    if (!collection) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "Collection [" << nss.toString() << "] not found."};
+    }
+
+    if (!appendCacheStatsForCollection(opCtx, collection, result)) {
+        return {ErrorCodes::CommandNotSupported,
+                "this storage engine does not report cache statistics per collection"};
+    }
+    return Status::OK();
+}
+
+void appendTopCollectionCacheStats(OperationContext* opCtx,
+                                   size_t limit,
+                                   BSONArrayBuilder* builder) {
+    struct CollectionCacheStats {
+        long long totalBytesInCache;
+        std::string ns;
+        BSONObj stats;
+    };
+    std::vector<CollectionCacheStats> all;
+
+    std::vector<std::string> dbNames;
+    opCtx->getServiceContext()->getGlobalStorageEngine()->listDatabases(&dbNames);
+    for (const auto& dbName : dbNames) {
+        // A database lock is enough to keep its collections from being dropped while we read
+        // their statistics, and avoids taking a lock per collection.
+        AutoGetDb autoDb(opCtx, dbName, MODE_IS);
+        Database* db = autoDb.getDb();
+        if (!db) {
+            continue;
+        }
+
+        for (auto&& collection : *db) {
+            BSONObjBuilder bob;
+            if (!appendCacheStatsForCollection(opCtx, collection, &bob)) {
+                return;
+            }
+            BSONObj stats = bob.obj();
+
+            long long indexBytesInCache = 0;
+            for (auto&& index : stats["indexes"].Obj()) {
+                indexBytesInCache += index.Obj()["bytesInCache"].safeNumberLong();
+            }
+            all.push_back({stats["bytesInCache"].safeNumberLong() + indexBytesInCache,
+                           collection->ns().ns(),
+                           stats.removeField("indexes")});
+        }
+    }
+
+    const size_t count = std::min(limit, all.size());
+    std::partial_sort(all.begin(),
+                      all.begin() + count,
+                      all.end(),
+                      [](const CollectionCacheStats& lhs, const CollectionCacheStats& rhs) {
+                          return lhs.totalBytesInCache > rhs.totalBytesInCache;
+                      });
+
+    for (size_t i = 0; i < count; ++i) {
+        const auto& entry = all[i];
+        BSONObjBuilder bob(builder->subobjStart());
+        bob.append("ns", entry.ns);
+        bob.appendElements(entry.stats);
+        bob.appendNumber("indexBytesInCache",
+                         entry.totalBytesInCache - entry.stats["bytesInCache"].safeNumberLong());
+    }
+}
+
 }  // namespace mongo
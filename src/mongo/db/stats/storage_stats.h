@@ -44,4 +44,25 @@ Status appendCollectionStorageStats(OperationContext* opCtx,
                                     const NamespaceString& nss,
                                     const BSONObj& param,
                                     BSONObjBuilder* builder);
+
+/**
+ * Appends to 'builder' how much of the collection represented by 'nss' and, under "indexes", of
+ * each of its indexes is resident in the storage engine's cache, along with the bytes and pages
+ * read into and evicted from it. Used by the $collStats and $indexStats aggregation stages.
+ *
+ * Returns CommandNotSupported if the storage engine does not track its cache per collection.
+ */
+Status appendCollectionCacheStats(OperationContext* opCtx,
+                                  const NamespaceString& nss,
+                                  BSONObjBuilder* builder);
+
+/**
+ * Appends to 'builder' the cache statistics of at most 'limit' collections, ordered by the number
+ * of bytes the collection and its indexes hold in the storage engine's cache, most first. Each
+ * entry reports only the collection level statistics plus the indexes' total bytes in cache, so
+ * that its shape does not depend on which indexes a collection has.
+ */
+void appendTopCollectionCacheStats(OperationContext* opCtx,
+                                   size_t limit,
+                                   BSONArrayBuilder* builder);
 };  // namespace mongo
@@ -35,6 +35,8 @@
 
 #include "mongo/db/jsobj.h"
 #include "mongo/db/service_context.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/concurrency/threadlocal.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -48,6 +50,11 @@ namespace {
 
 const auto getTop = ServiceContext::declareDecoration<Top>();
 
+// Threads are assigned stripes round robin the first time they record an operation.
+AtomicUInt32 nextStripe;
+MONGO_TRIVIALLY_CONSTRUCTIBLE_THREAD_LOCAL size_t threadStripe = 0;
+MONGO_TRIVIALLY_CONSTRUCTIBLE_THREAD_LOCAL bool threadStripeAssigned = false;
+
 }  // namespace
 
 Top::UsageData::UsageData(const UsageData& older, const UsageData& newer) {
@@ -67,11 +74,42 @@ Top::CollectionData::CollectionData(const CollectionData& older, const Collectio
       remove(older.remove, newer.remove),
       commands(older.commands, newer.commands) {}
 
+void Top::CollectionData::add(const CollectionData& other) {
+    total.add(other.total);
+    readLock.add(other.readLock);
+    writeLock.add(other.writeLock);
+    queries.add(other.queries);
+    getmore.add(other.getmore);
+    insert.add(other.insert);
+    update.add(other.update);
+    remove.add(other.remove);
+    commands.add(other.commands);
+    opLatencyHistogram.add(other.opLatencyHistogram);
+}
+
 // static
 Top& Top::get(ServiceContext* service) {
     return getTop(service);
 }
 
+Top::Stripe& Top::_getStripe() {
+    if (!threadStripeAssigned) {
+        threadStripe = nextStripe.fetchAndAdd(1) % kNumStripes;
+        threadStripeAssigned = true;
+    }
+    return _stripes[threadStripe];
+}
+
+void Top::_mergeStripes(UsageMap* out) const {
+    out->clear();
+    for (const auto& stripe : _stripes) {
+        stdx::lock_guard<SimpleMutex> lk(stripe.lock);
+        for (const auto& entry : stripe.usage) {
+            (*out)[entry.first].add(entry.second);
+        }
+    }
+}
+
 void Top::record(OperationContext* opCtx,
                  StringData ns,
                  LogicalOp logicalOp,
@@ -83,14 +121,15 @@ void Top::record(OperationContext* opCtx,
         return;
 
     auto hashedNs = UsageMap::HashedKey(ns);
-    stdx::lock_guard<SimpleMutex> lk(_lock);
+    Stripe& stripe = _getStripe();
+    stdx::lock_guard<SimpleMutex> lk(stripe.lock);
 
-    if ((command || logicalOp == LogicalOp::opQuery) && ns == _lastDropped) {
-        _lastDropped = "";
+    if ((command || logicalOp == LogicalOp::opQuery) && ns == stripe.lastDropped) {
+        stripe.lastDropped = "";
         return;
     }
 
-    CollectionData& coll = _usage[hashedNs];
+    CollectionData& coll = stripe.usage[hashedNs];
     _record(opCtx, coll, logicalOp, lockType, micros, readWriteType);
 }
 
@@ -140,23 +179,28 @@ void Top::_record(OperationContext* opCtx,
 }
 
 void Top::collectionDropped(StringData ns, bool databaseDropped) {
-    stdx::lock_guard<SimpleMutex> lk(_lock);
-    _usage.erase(ns);
-    if (!databaseDropped) {
-        // If a collection drop occurred, there will be a subsequent call to record for this
-        // collection namespace which must be ignored. This does not apply to a database drop.
-        _lastDropped = ns.toString();
+    Stripe& ownStripe = _getStripe();
+    for (auto& stripe : _stripes) {
+        stdx::lock_guard<SimpleMutex> lk(stripe.lock);
+        stripe.usage.erase(ns);
+        if (!databaseDropped && &stripe == &ownStripe) {
+            // If a collection drop occurred, there will be a subsequent call to record for this
+            // collection namespace which must be ignored. This does not apply to a database drop.
+            // That call is made by the thread which dropped the collection, so it is only
+            // remembered in the stripe of that thread.
+            stripe.lastDropped = ns.toString();
+        }
     }
 }
 
 void Top::cloneMap(Top::UsageMap& out) const {
-    stdx::lock_guard<SimpleMutex> lk(_lock);
-    out = _usage;
+    _mergeStripes(&out);
 }
 
 void Top::append(BSONObjBuilder& b) {
-    stdx::lock_guard<SimpleMutex> lk(_lock);
-    _appendToUsageMap(b, _usage);
+    UsageMap usage;
+    _mergeStripes(&usage);
+    _appendToUsageMap(b, usage);
 }
 
 void Top::_appendToUsageMap(BSONObjBuilder& b, const UsageMap& map) const {
@@ -199,9 +243,16 @@ void Top::_appendStatsEntry(BSONObjBuilder& b, const char* statsName, const Usag
 
 void Top::appendLatencyStats(StringData ns, bool includeHistograms, BSONObjBuilder* builder) {
     auto hashedNs = UsageMap::HashedKey(ns);
-    stdx::lock_guard<SimpleMutex> lk(_lock);
+    OperationLatencyHistogram histogram;
+    for (const auto& stripe : _stripes) {
+        stdx::lock_guard<SimpleMutex> lk(stripe.lock);
+        auto it = stripe.usage.find(hashedNs);
+        if (it != stripe.usage.end()) {
+            histogram.add(it->second.opLatencyHistogram);
+        }
+    }
     BSONObjBuilder latencyStatsBuilder;
-    _usage[hashedNs].opLatencyHistogram.append(includeHistograms, &latencyStatsBuilder);
+    histogram.append(includeHistograms, &latencyStatsBuilder);
     builder->append("ns", ns);
     builder->append("latencyStats", latencyStatsBuilder.obj());
 }
@@ -209,13 +260,18 @@ void Top::appendLatencyStats(StringData ns, bool includeHistograms, BSONObjBuild
 void Top::incrementGlobalLatencyStats(OperationContext* opCtx,
                                       uint64_t latency,
                                       Command::ReadWriteType readWriteType) {
-    stdx::lock_guard<SimpleMutex> guard(_lock);
-    _incrementHistogram(opCtx, latency, &_globalHistogramStats, readWriteType);
+    Stripe& stripe = _getStripe();
+    stdx::lock_guard<SimpleMutex> guard(stripe.lock);
+    _incrementHistogram(opCtx, latency, &stripe.globalHistogramStats, readWriteType);
 }
 
 void Top::appendGlobalLatencyStats(bool includeHistograms, BSONObjBuilder* builder) {
-    stdx::lock_guard<SimpleMutex> guard(_lock);
-    _globalHistogramStats.append(includeHistograms, builder);
+    OperationLatencyHistogram histogram;
+    for (const auto& stripe : _stripes) {
+        stdx::lock_guard<SimpleMutex> guard(stripe.lock);
+        histogram.add(stripe.globalHistogramStats);
+    }
+    histogram.append(includeHistograms, builder);
 }
 
 void Top::_incrementHistogram(OperationContext* opCtx,
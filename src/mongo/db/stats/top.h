@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <array>
 #include <boost/date_time/posix_time/posix_time.hpp>
 
 #include "mongo/db/commands.h"
@@ -44,6 +45,10 @@ class ServiceContext;
 
 /**
  * tracks usage by collection
+ *
+ * The counters are split into stripes, each with its own mutex, so that threads recording
+ * operations concurrently do not contend on a single lock. Each thread always records into the
+ * same stripe, and readers aggregate the stripes when the statistics are reported.
  */
 class Top {
 public:
@@ -61,6 +66,11 @@ public:
             count++;
             time += micros;
         }
+
+        void add(const UsageData& other) {
+            count += other.count;
+            time += other.time;
+        }
     };
 
     struct CollectionData {
@@ -70,6 +80,11 @@ public:
         CollectionData() {}
         CollectionData(const CollectionData& older, const CollectionData& newer);
 
+        /**
+         * Adds the counters of 'other' to this collection's counters.
+         */
+        void add(const CollectionData& other);
+
         UsageData total;
 
         UsageData readLock;
@@ -124,7 +139,31 @@ public:
      */
     void appendGlobalLatencyStats(bool includeHistograms, BSONObjBuilder* builder);
 
+    // The number of stripes the counters are split into.
+    static const size_t kNumStripes = 16;
+
 private:
+    // Keeps the stripes written by different threads on separate cache lines.
+    static const size_t kCacheLinePadding = 64;
+
+    struct Stripe {
+        mutable SimpleMutex lock;
+        OperationLatencyHistogram globalHistogramStats;
+        UsageMap usage;
+        std::string lastDropped;
+        char padding[kCacheLinePadding];
+    };
+
+    /**
+     * Returns the stripe the calling thread records into.
+     */
+    Stripe& _getStripe();
+
+    /**
+     * Fills 'out' with the counters of every stripe, aggregated by collection.
+     */
+    void _mergeStripes(UsageMap* out) const;
+
     void _appendToUsageMap(BSONObjBuilder& b, const UsageMap& map) const;
 
     void _appendStatsEntry(BSONObjBuilder& b, const char* statsName, const UsageData& map) const;
@@ -141,10 +180,7 @@ private:
                              OperationLatencyHistogram* histogram,
                              Command::ReadWriteType readWriteType);
 
-    mutable SimpleMutex _lock;
-    OperationLatencyHistogram _globalHistogramStats;
-    UsageMap _usage;
-    std::string _lastDropped;
+    std::array<Stripe, kNumStripes> _stripes;
 };
 
 }  // namespace mongo
@@ -29,6 +29,8 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/stats/top.h"
+
+#include "mongo/db/jsobj.h"
 #include "mongo/unittest/unittest.h"
 
 namespace {
@@ -39,4 +41,44 @@ TEST(TopTest, CollectionDropped) {
     Top().collectionDropped("coll");
 }
 
+TEST(TopTest, CollectionDataAddSumsEveryCounter) {
+    Top::CollectionData merged;
+    Top::CollectionData other;
+    merged.total.inc(10);
+    merged.queries.inc(10);
+    merged.opLatencyHistogram.increment(10, Command::ReadWriteType::kRead);
+    other.total.inc(5);
+    other.writeLock.inc(5);
+    other.insert.inc(5);
+    other.opLatencyHistogram.increment(5, Command::ReadWriteType::kWrite);
+    merged.add(other);
+
+    ASSERT_EQUALS(merged.total.count, 2);
+    ASSERT_EQUALS(merged.total.time, 15);
+    ASSERT_EQUALS(merged.queries.count, 1);
+    ASSERT_EQUALS(merged.writeLock.count, 1);
+    ASSERT_EQUALS(merged.insert.time, 5);
+    ASSERT_EQUALS(merged.readLock.count, 0);
+
+    BSONObjBuilder builder;
+    merged.opLatencyHistogram.append(false, &builder);
+    BSONObj latencyStats = builder.obj();
+    ASSERT_EQUALS(latencyStats["reads"]["ops"].Long(), 1);
+    ASSERT_EQUALS(latencyStats["writes"]["ops"].Long(), 1);
+}
+
+TEST(TopTest, GlobalLatencyStatsAreEmptyAcrossAllStripes) {
+    Top top;
+    BSONObjBuilder builder;
+    top.appendGlobalLatencyStats(false, &builder);
+    BSONObj latencyStats = builder.obj();
+    ASSERT_EQUALS(latencyStats["reads"]["ops"].Long(), 0);
+    ASSERT_EQUALS(latencyStats["writes"]["ops"].Long(), 0);
+    ASSERT_EQUALS(latencyStats["commands"]["ops"].Long(), 0);
+
+    Top::UsageMap usage;
+    top.cloneMap(usage);
+    ASSERT_TRUE(usage.empty());
+}
+
 }  // namespace
@@ -0,0 +1,92 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/clustered_key.h"
+
+#include "mongo/bson/bson_validate.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/record_id.h"
+#include "mongo/util/debug_util.h"
+
+namespace mongo {
+namespace clusteredkey {
+
+StatusWith<RecordId> keyForId(const BSONElement& id) {
+    long long repr;
+    switch (id.type()) {
+        case NumberInt:
+        case NumberLong:
+            repr = id.numberLong();
+            break;
+        case NumberDouble: {
+            // Doubles compare equal to the integers they represent exactly, so they have to map to
+            // the same RecordId as those.
+            const double value = id.numberDouble();
+            if (!(value > 0 && value < static_cast<double>(RecordId::max().repr())) ||
+                value != static_cast<double>(static_cast<long long>(value))) {
+                return {ErrorCodes::BadValue,
+                        str::stream() << "_id of a clustered collection must be a positive "
+                                         "integer, but found "
+                                      << id};
+            }
+            repr = static_cast<long long>(value);
+            break;
+        }
+        default:
+            return {ErrorCodes::BadValue,
+                    str::stream() << "_id of a clustered collection must be a positive integer, "
+                                     "but found a value of type "
+                                  << typeName(id.type())};
+    }
+
+    const RecordId out(repr);
+    if (out <= RecordId::min() || out >= RecordId::max()) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "_id of a clustered collection must be a positive integer below "
+                              << RecordId::max().repr()
+                              << ", but found "
+                              << id};
+    }
+    return out;
+}
+
+StatusWith<RecordId> extractKey(const char* data, int len) {
+    DEV invariant(validateBSON(data, len, BSONVersion::kLatest).isOK());
+
+    const BSONObj obj(data);
+    const BSONElement elem = obj["_id"];
+    if (elem.eoo())
+        return StatusWith<RecordId>(ErrorCodes::BadValue, "no _id field");
+
+    return keyForId(elem);
+}
+
+}  // namespace clusteredkey
+}  // namespace mongo
@@ -32,8 +32,10 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/base/init.h"
+#include "mongo/db/commands/server_status.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/ephemeral_for_test/ephemeral_for_test_engine.h"
+#include "mongo/db/storage/ephemeral_for_test/ephemeral_for_test_record_store.h"
 #include "mongo/db/storage/kv/kv_storage_engine.h"
 #include "mongo/db/storage/storage_options.h"
 
@@ -41,6 +43,28 @@ namespace mongo {
 
 namespace {
 
+/**
+ * Adds "ephemeralForTest" to the results of db.serverStatus().
+ */
+class EphemeralForTestServerStatusSection : public ServerStatusSection {
+public:
+    EphemeralForTestServerStatusSection() : ServerStatusSection("ephemeralForTest") {}
+
+    bool includeByDefault() const override {
+        return true;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override {
+        BSONObjBuilder bob;
+        bob.append("dataSizeBytes",
+                   static_cast<long long>(EphemeralForTestRecordStore::totalDataSize()));
+        bob.append("maxDataSizeBytes",
+                   static_cast<long long>(EphemeralForTestRecordStore::maxDataSize()));
+        return bob.obj();
+    }
+};
+
 class EphemeralForTestFactory : public StorageEngine::Factory {
 public:
     virtual ~EphemeralForTestFactory() {}
@@ -53,6 +77,10 @@ public:
         KVStorageEngineOptions options;
         options.directoryPerDB = params.directoryperdb;
         options.forRepair = params.repair;
+
+        // Intentionally leaked.
+        new EphemeralForTestServerStatusSection();
+
         return new KVStorageEngine(new EphemeralForTestEngine(), options);
     }
 
@@ -36,8 +36,10 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/oplog_hack.h"
 #include "mongo/db/storage/recovery_unit.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
@@ -47,6 +49,32 @@ namespace mongo {
 
 using std::shared_ptr;
 
+namespace {
+
+// Upper bound, in bytes, on the record data held by all non-capped collections. Capped
+// collections are bounded by their own size and are not subject to this limit. Zero means
+// unlimited.
+MONGO_EXPORT_SERVER_PARAMETER(ephemeralForTestMaxDataSizeBytes, long long, 0);
+
+AtomicInt64 totalDataSizeBytes;
+
+}  // namespace
+
+void EphemeralForTestRecordStore::Data::changeDataSize(int64_t delta) {
+    dataSize += delta;
+    totalDataSizeBytes.fetchAndAdd(delta);
+}
+
+// static
+int64_t EphemeralForTestRecordStore::totalDataSize() {
+    return totalDataSizeBytes.load();
+}
+
+// static
+int64_t EphemeralForTestRecordStore::maxDataSize() {
+    return std::max(0LL, ephemeralForTestMaxDataSizeBytes.load());
+}
+
 class EphemeralForTestRecordStore::InsertChange : public RecoveryUnit::Change {
 public:
     InsertChange(OperationContext* opCtx, Data* data, RecordId loc)
@@ -57,7 +85,7 @@ public:
 
         Records::iterator it = _data->records.find(_loc);
         if (it != _data->records.end()) {
-            _data->dataSize -= it->second.size;
+            _data->changeDataSize(-it->second.size);
             _data->records.erase(it);
         }
     }
@@ -83,10 +111,10 @@ public:
 
         Records::iterator it = _data->records.find(_loc);
         if (it != _data->records.end()) {
-            _data->dataSize -= it->second.size;
+            _data->changeDataSize(-it->second.size);
         }
 
-        _data->dataSize += _rec.size;
+        _data->changeDataSize(_rec.size);
         _data->records[_loc] = _rec;
     }
 
@@ -99,11 +127,12 @@ private:
 
 class EphemeralForTestRecordStore::TruncateChange : public RecoveryUnit::Change {
 public:
-    TruncateChange(OperationContext* opCtx, Data* data) : _opCtx(opCtx), _data(data), _dataSize(0) {
+    TruncateChange(OperationContext* opCtx, Data* data)
+        : _opCtx(opCtx), _data(data), _dataSize(data->dataSize) {
         using std::swap;
 
         stdx::lock_guard<stdx::mutex> lock(_data->recordsMutex);
-        swap(_dataSize, _data->dataSize);
+        _data->changeDataSize(-_dataSize);
         swap(_records, _data->records);
     }
 
@@ -112,7 +141,7 @@ public:
         using std::swap;
 
         stdx::lock_guard<stdx::mutex> lock(_data->recordsMutex);
-        swap(_dataSize, _data->dataSize);
+        _data->changeDataSize(_dataSize - _data->dataSize);
         swap(_records, _data->records);
     }
 
@@ -347,7 +376,7 @@ void EphemeralForTestRecordStore::deleteRecord_inlock(OperationContext* opCtx,
                                                       const RecordId& loc) {
     EphemeralForTestRecord* rec = recordFor(loc);
     opCtx->recoveryUnit()->registerChange(new RemoveChange(opCtx, _data, loc, *rec));
-    _data->dataSize -= rec->size;
+    _data->changeDataSize(-rec->size);
     invariant(_data->records.erase(loc) == 1);
 }
 
@@ -379,6 +408,22 @@ void EphemeralForTestRecordStore::cappedDeleteAsNeeded_inlock(OperationContext*
     }
 }
 
+Status EphemeralForTestRecordStore::checkMemoryLimit_inlock(int64_t delta) const {
+    const int64_t limit = maxDataSize();
+    if (_isCapped || limit == 0 || delta <= 0)
+        return Status::OK();
+
+    const int64_t total = totalDataSizeBytes.load();
+    if (total + delta > limit) {
+        return Status(ErrorCodes::ExceededMemoryLimit,
+                      str::stream() << "cannot grow " << ns() << " by " << delta
+                                    << " bytes; in-memory data size is " << total
+                                    << " bytes and ephemeralForTestMaxDataSizeBytes is "
+                                    << limit);
+    }
+    return Status::OK();
+}
+
 StatusWith<RecordId> EphemeralForTestRecordStore::extractAndCheckLocForOplog(const char* data,
                                                                              int len) const {
     StatusWith<RecordId> status = oploghack::extractKey(data, len);
@@ -402,6 +447,10 @@ StatusWith<RecordId> EphemeralForTestRecordStore::insertRecord(OperationContext*
     }
 
     stdx::lock_guard<stdx::mutex> lock(_data->recordsMutex);
+    Status memoryStatus = checkMemoryLimit_inlock(len);
+    if (!memoryStatus.isOK())
+        return memoryStatus;
+
     EphemeralForTestRecord rec(len);
     memcpy(rec.data.get(), data, len);
 
@@ -416,7 +465,7 @@ StatusWith<RecordId> EphemeralForTestRecordStore::insertRecord(OperationContext*
     }
 
     opCtx->recoveryUnit()->registerChange(new InsertChange(opCtx, _data, loc));
-    _data->dataSize += len;
+    _data->changeDataSize(len);
     _data->records[loc] = rec;
 
     cappedDeleteAsNeeded_inlock(opCtx);
@@ -438,6 +487,10 @@ Status EphemeralForTestRecordStore::insertRecordsWithDocWriter(OperationContext*
             return Status(ErrorCodes::BadValue, "object to insert exceeds cappedMaxSize");
         }
 
+        Status memoryStatus = checkMemoryLimit_inlock(len);
+        if (!memoryStatus.isOK())
+            return memoryStatus;
+
         EphemeralForTestRecord rec(len);
         docs[i]->writeDocument(rec.data.get());
 
@@ -452,7 +505,7 @@ Status EphemeralForTestRecordStore::insertRecordsWithDocWriter(OperationContext*
         }
 
         opCtx->recoveryUnit()->registerChange(new InsertChange(opCtx, _data, loc));
-        _data->dataSize += len;
+        _data->changeDataSize(len);
         _data->records[loc] = rec;
 
         cappedDeleteAsNeeded_inlock(opCtx);
@@ -488,11 +541,15 @@ Status EphemeralForTestRecordStore::updateRecord(OperationContext* opCtx,
         lock.lock();
     }
 
+    Status memoryStatus = checkMemoryLimit_inlock(len - oldLen);
+    if (!memoryStatus.isOK())
+        return memoryStatus;
+
     EphemeralForTestRecord newRecord(len);
     memcpy(newRecord.data.get(), data, len);
 
     opCtx->recoveryUnit()->registerChange(new RemoveChange(opCtx, _data, loc, *oldRecord));
-    _data->dataSize += len - oldLen;
+    _data->changeDataSize(len - oldLen);
     *oldRecord = newRecord;
 
     cappedDeleteAsNeeded_inlock(opCtx);
@@ -560,7 +617,7 @@ void EphemeralForTestRecordStore::cappedTruncateAfter(OperationContext* opCtx,
     while (it != _data->records.end()) {
         opCtx->recoveryUnit()->registerChange(
             new RemoveChange(opCtx, _data, it->first, it->second));
-        _data->dataSize -= it->second.size;
+        _data->changeDataSize(-it->second.size);
         _data->records.erase(it++);
     }
 }
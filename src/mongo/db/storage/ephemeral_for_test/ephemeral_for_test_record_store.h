@@ -129,7 +129,7 @@ public:
                                         long long numRecords,
                                         long long dataSize) {
         invariant(_data->records.size() == size_t(numRecords));
-        _data->dataSize = dataSize;
+        _data->changeDataSize(dataSize - _data->dataSize);
     }
 
 protected:
@@ -170,6 +170,18 @@ public:
         return _cappedMaxSize;
     }
 
+    /**
+     * Returns the number of bytes of record data held by all EphemeralForTestRecordStores in this
+     * process.
+     */
+    static int64_t totalDataSize();
+
+    /**
+     * Returns the configured limit on totalDataSize() for non-capped collections, or zero if
+     * there is none.
+     */
+    static int64_t maxDataSize();
+
 private:
     class InsertChange;
     class RemoveChange;
@@ -180,6 +192,12 @@ private:
 
     StatusWith<RecordId> extractAndCheckLocForOplog(const char* data, int len) const;
 
+    /**
+     * Returns ExceededMemoryLimit if growing this non-capped record store by 'delta' bytes would
+     * take the process over the 'ephemeralForTestMaxDataSizeBytes' limit.
+     */
+    Status checkMemoryLimit_inlock(int64_t delta) const;
+
     RecordId allocateLoc();
     bool cappedAndNeedDelete_inlock(OperationContext* opCtx) const;
     void cappedDeleteAsNeeded_inlock(OperationContext* opCtx);
@@ -196,6 +214,15 @@ private:
         Data(StringData ns, bool isOplog)
             : dataSize(0), recordsMutex(), nextId(1), isOplog(isOplog) {}
 
+        ~Data() {
+            changeDataSize(-dataSize);
+        }
+
+        /**
+         * Adjusts 'dataSize' by 'delta', keeping the process-wide total in sync.
+         */
+        void changeDataSize(int64_t delta);
+
         int64_t dataSize;
         stdx::mutex recordsMutex;
         Records records;
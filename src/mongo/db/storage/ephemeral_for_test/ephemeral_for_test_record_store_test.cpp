@@ -33,10 +33,12 @@
 #include "mongo/db/storage/ephemeral_for_test/ephemeral_for_test_record_store.h"
 
 #include "mongo/base/init.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/ephemeral_for_test/ephemeral_for_test_recovery_unit.h"
 #include "mongo/db/storage/record_store_test_harness.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -84,5 +86,50 @@ MONGO_INITIALIZER(RegisterHarnessFactory)(InitializerContext* const) {
     mongo::registerHarnessHelperFactory(makeHarnessHelper);
     return Status::OK();
 }
+
+TEST(EphemeralForTestRecordStoreTest, MaxDataSizeLimitsNonCappedGrowth) {
+    auto&& params = ServerParameterSet::getGlobal()->getMap();
+    auto maxDataSize = params.find("ephemeralForTestMaxDataSizeBytes");
+    ASSERT_TRUE(maxDataSize != params.end());
+
+    EphemeralForTestHarnessHelper harnessHelper;
+    auto rs = harnessHelper.newNonCappedRecordStore();
+    std::shared_ptr<void> cappedData;
+    EphemeralForTestRecordStore capped("a.capped", &cappedData, true, 1000, -1);
+
+    const std::string data(100, 'x');
+    const int64_t initialSize = EphemeralForTestRecordStore::totalDataSize();
+    ASSERT_OK(maxDataSize->second->setFromString(
+        std::to_string(initialSize + static_cast<int64_t>(data.size()) + 10)));
+    ON_BLOCK_EXIT([&] { ASSERT_OK(maxDataSize->second->setFromString("0")); });
+
+    auto opCtx = harnessHelper.newOperationContext();
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        ASSERT_OK(rs->insertRecord(opCtx.get(), data.c_str(), data.size(), false).getStatus());
+        uow.commit();
+    }
+    ASSERT_EQ(initialSize + static_cast<int64_t>(data.size()),
+              EphemeralForTestRecordStore::totalDataSize());
+
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        ASSERT_EQ(ErrorCodes::ExceededMemoryLimit,
+                  rs->insertRecord(opCtx.get(), data.c_str(), data.size(), false).getStatus());
+
+        // Capped collections bound their own size and are not subject to the limit.
+        ASSERT_OK(capped.insertRecord(opCtx.get(), data.c_str(), data.size(), false).getStatus());
+        // Rolled back.
+    }
+    ASSERT_EQ(initialSize + static_cast<int64_t>(data.size()),
+              EphemeralForTestRecordStore::totalDataSize());
+
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        ASSERT_OK(rs->truncate(opCtx.get()));
+        uow.commit();
+    }
+    ASSERT_EQ(initialSize, EphemeralForTestRecordStore::totalDataSize());
+}
 }  // namespace
 }  // namespace mongo
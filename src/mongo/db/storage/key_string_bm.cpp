@@ -0,0 +1,110 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/storage/key_string.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/benchmark.h"
+
+namespace mongo {
+namespace {
+
+using unittest::benchmarkDoNotOptimize;
+
+const Ordering kAllAscending = Ordering::make(BSONObj());
+
+BSONObj makeCompoundKey() {
+    return BSON("" << 12345 << "" << "a moderately long string key" << "" << 2.5 << ""
+                   << OID("0123456789abcdef01234567"));
+}
+
+class KeyStringBenchmark : public unittest::Benchmark {
+protected:
+    void setUp() override {
+        key = makeCompoundKey();
+        encoded = stdx::make_unique<KeyString>(
+            KeyString::Version::V1, key, kAllAscending, RecordId(42));
+    }
+
+    BSONObj key;
+    std::unique_ptr<KeyString> encoded;
+};
+
+BENCHMARK_F(KeyStringBenchmark, EncodeV0) {
+    while (state.keepRunning()) {
+        KeyString ks(KeyString::Version::V0, key, kAllAscending, RecordId(42));
+        benchmarkDoNotOptimize(ks.getBuffer());
+    }
+    state.setBytesProcessed(state.iterations() * key.objsize());
+}
+
+BENCHMARK_F(KeyStringBenchmark, EncodeV1) {
+    while (state.keepRunning()) {
+        KeyString ks(KeyString::Version::V1, key, kAllAscending, RecordId(42));
+        benchmarkDoNotOptimize(ks.getBuffer());
+    }
+    state.setBytesProcessed(state.iterations() * key.objsize());
+}
+
+BENCHMARK_F(KeyStringBenchmark, ResetToKey) {
+    KeyString ks(KeyString::Version::V1);
+    while (state.keepRunning()) {
+        ks.resetToKey(key, kAllAscending, RecordId(42));
+        benchmarkDoNotOptimize(ks.getBuffer());
+    }
+    state.setBytesProcessed(state.iterations() * key.objsize());
+}
+
+BENCHMARK_F(KeyStringBenchmark, Decode) {
+    while (state.keepRunning()) {
+        benchmarkDoNotOptimize(KeyString::toBson(encoded->getBuffer(),
+                                                 encoded->getSize(),
+                                                 kAllAscending,
+                                                 encoded->getTypeBits()));
+    }
+    state.setBytesProcessed(state.iterations() * encoded->getSize());
+}
+
+BENCHMARK_F(KeyStringBenchmark, DecodeRecordId) {
+    while (state.keepRunning()) {
+        benchmarkDoNotOptimize(
+            KeyString::decodeRecordIdAtEnd(encoded->getBuffer(), encoded->getSize()));
+    }
+}
+
+BENCHMARK_F(KeyStringBenchmark, Compare) {
+    const KeyString other(KeyString::Version::V1, key, kAllAscending, RecordId(43));
+    while (state.keepRunning()) {
+        benchmarkDoNotOptimize(encoded->compare(other));
+    }
+}
+
+}  // namespace
+}  // namespace mongo
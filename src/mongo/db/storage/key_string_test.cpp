@@ -1136,8 +1136,64 @@ void perfTest(KeyString::Version version, const Numbers& numbers) {
           << (kDebugBuild ? " (DEBUG BUILD!)" : "") << " min " << (*minmax.first)[""] << ", max"
           << (*minmax.second)[""];
 }
+
+/**
+ * Returns 'count' random strings of up to 'maxLength' bytes. Their bytes are drawn from
+ * [minByte, maxByte], so that the strings can be made to need escaping or not.
+ */
+std::vector<BSONObj> randomStrings(size_t count, size_t maxLength, int minByte, int maxByte) {
+    std::mt19937 gen(newSeed());
+    std::uniform_int_distribution<size_t> length(0, maxLength);
+    std::uniform_int_distribution<int> byte(minByte, maxByte);
+
+    std::vector<BSONObj> strings;
+    for (size_t x = 0; x < count; x++) {
+        std::string str(length(gen), '\0');
+        for (auto&& c : str) {
+            c = static_cast<char>(byte(gen));
+        }
+        strings.push_back(BSON("" << str));
+    }
+    return strings;
+}
+
 }  // namespace
 
+TEST_F(KeyStringTest, StringsRoundtripAndCompareWithAndWithoutEscaping) {
+    // Short and long strings, with NUL and 0xFF bytes among the others in one of the sets.
+    auto plain = randomStrings(1000, 100, 'a', 'z');
+    auto escaped = randomStrings(1000, 100, 0, 255);
+    std::vector<BSONObj> strings(plain.begin(), plain.end());
+    strings.insert(strings.end(), escaped.begin(), escaped.end());
+
+    for (const auto& str : strings) {
+        ROUNDTRIP(version, str);
+    }
+
+    for (size_t i = 1; i < strings.size(); i++) {
+        const BSONObj& x = strings[i - 1];
+        const BSONObj& y = strings[i];
+        for (const auto& order : {ONE_ASCENDING, ONE_DESCENDING}) {
+            const int bsonCmp = x.woCompare(y, order);
+            const int ksCmp = KeyString(version, x, order).compare(KeyString(version, y, order));
+            ASSERT_EQ(bsonCmp < 0, ksCmp < 0);
+            ASSERT_EQ(bsonCmp == 0, ksCmp == 0);
+        }
+    }
+}
+
+TEST_F(KeyStringTest, ShortAsciiStringPerf) {
+    perfTest(version, randomStrings(kMinPerfSamples, 16, 'a', 'z'));
+}
+
+TEST_F(KeyStringTest, LongAsciiStringPerf) {
+    perfTest(version, randomStrings(kMinPerfSamples / 10, 1000, ' ', '~'));
+}
+
+TEST_F(KeyStringTest, StringWithNulsPerf) {
+    perfTest(version, randomStrings(kMinPerfSamples, 64, 0, 3));
+}
+
 TEST_F(KeyStringTest, CommonIntPerf) {
     // Exponential distribution, so skewed towards smaller integers.
     std::mt19937 gen(newSeed());
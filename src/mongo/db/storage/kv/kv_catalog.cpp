@@ -39,7 +39,9 @@
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/kv/kv_catalog_feature_tracker.h"
+#include "mongo/db/storage/kv/kv_engine.h"
 #include "mongo/db/storage/record_store.h"
 #include "mongo/db/storage/recovery_unit.h"
 #include "mongo/platform/bits.h"
@@ -54,6 +56,13 @@ namespace {
 // It is never used with KVEngines that support doc-level locking so this should never conflict
 // with anything else.
 
+// The number of shared tables per database and kind that grouped collections and indexes are
+// spread over. Changing it only affects where new collections and indexes are placed.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(groupCollectionsTablesPerDatabase, int, 16);
+
+// Marks the idents of the tables shared by grouped collections and indexes.
+const char kGroupedIdentMarker[] = "group-";
+
 const char kIsFeatureDocumentFieldName[] = "isFeatureDoc";
 const char kNamespaceFieldName[] = "ns";
 const char kNonRepairableFeaturesFieldName[] = "nonRepairable";
@@ -294,6 +303,19 @@ std::string KVCatalog::_newUniqueIdent(StringData ns, const char* kind) {
     return buf.str();
 }
 
+std::string KVCatalog::_groupedIdent(StringData ns, StringData kind, KVPrefix prefix) const {
+    invariant(prefix.isPrefixed());
+    const int64_t tables = std::max(groupCollectionsTablesPerDatabase, 1);
+    StringBuilder buf;
+    if (_directoryPerDb) {
+        buf << NamespaceString::escapeDbName(nsToDatabaseSubstring(ns)) << '/';
+    }
+    buf << kind;
+    buf << (_directoryForIndexes ? '/' : '-');
+    buf << kGroupedIdentMarker << (prefix.repr() % tables);
+    return buf.str();
+}
+
 void KVCatalog::init(OperationContext* opCtx) {
     // No locking needed since called single threaded.
     auto cursor = _rs->getCursor(opCtx);
@@ -342,7 +364,8 @@ Status KVCatalog::newCollection(OperationContext* opCtx,
     invariant(opCtx->lockState() == NULL ||
               opCtx->lockState()->isDbLockedForMode(nsToDatabaseSubstring(ns), MODE_X));
 
-    const string ident = _newUniqueIdent(ns, "collection");
+    const string ident = prefix.isPrefixed() ? _groupedIdent(ns, "collection", prefix)
+                                             : _newUniqueIdent(ns, "collection");
 
     stdx::lock_guard<stdx::mutex> lk(_identsLock);
     Entry& old = _idents[ns.toString()];
@@ -451,7 +474,15 @@ void KVCatalog::putMetaData(OperationContext* opCtx,
                 continue;
             }
             // missing, create new
-            newIdentMap.append(name, _newUniqueIdent(ns, "index"));
+            const KVPrefix prefix = md.indexes[i].prefix;
+            if (!prefix.isPrefixed()) {
+                newIdentMap.append(name, _newUniqueIdent(ns, "index"));
+                continue;
+            }
+            // Indexes of different versions use different key formats, so they never share.
+            const std::string kind = str::stream() << "index-v"
+                                                   << md.indexes[i].spec["v"].numberInt();
+            newIdentMap.append(name, _groupedIdent(ns, kind, prefix));
         }
         b.append("idxIdent", newIdentMap.obj());
 
@@ -565,6 +596,23 @@ std::vector<std::string> KVCatalog::getAllIdents(OperationContext* opCtx) const
     return v;
 }
 
+bool KVCatalog::isGroupedIdent(StringData ident) {
+    const size_t slash = ident.rfind('/');
+    const StringData name = slash == std::string::npos ? ident : ident.substr(slash + 1);
+    return name.startsWith(kGroupedIdentMarker) ||
+        name.find(std::string("-") + kGroupedIdentMarker) != std::string::npos;
+}
+
+Status KVCatalog::dropIdent(OperationContext* opCtx,
+                            KVEngine* engine,
+                            StringData ident,
+                            KVPrefix prefix) {
+    if (prefix.isPrefixed() && isGroupedIdent(ident)) {
+        return engine->dropGroupedIdent(opCtx, ident, prefix);
+    }
+    return engine->dropIdent(opCtx, ident);
+}
+
 bool KVCatalog::isUserDataIdent(StringData ident) const {
     return ident.find("index-") != std::string::npos || ident.find("index/") != std::string::npos ||
         ident.find("collection-") != std::string::npos ||
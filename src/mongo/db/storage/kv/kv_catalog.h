@@ -43,6 +43,7 @@
 
 namespace mongo {
 
+class KVEngine;
 class OperationContext;
 class RecordStore;
 
@@ -92,6 +93,21 @@ public:
 
     bool isUserDataIdent(StringData ident) const;
 
+    /**
+     * Returns true if 'ident' names a table shared by the prefixed collections or indexes of
+     * several namespaces. Dropping one of them must only remove the keys under its own prefix.
+     */
+    static bool isGroupedIdent(StringData ident);
+
+    /**
+     * Drops the data of the collection or index stored under 'ident' and 'prefix'. Unlike
+     * KVEngine::dropIdent(), this leaves the other prefixes of a grouped ident in place.
+     */
+    static Status dropIdent(OperationContext* opCtx,
+                            KVEngine* engine,
+                            StringData ident,
+                            KVPrefix prefix);
+
     FeatureTracker* getFeatureTracker() const {
         invariant(_featureTracker);
         return _featureTracker.get();
@@ -110,6 +126,12 @@ private:
      */
     std::string _newUniqueIdent(StringData ns, const char* kind);
 
+    /**
+     * Returns the ident of the shared table that stores the "things" of 'kind' under 'prefix'.
+     * Prefixes are spread over a fixed number of tables per database.
+     */
+    std::string _groupedIdent(StringData ns, StringData kind, KVPrefix prefix) const;
+
     // Helpers only used by constructor and init(). Don't call from elsewhere.
     static std::string _newRand();
     bool _hasEntryCollidingWithRand() const;
@@ -51,35 +51,43 @@ bool indexTypeSupportsPathLevelMultikeyTracking(StringData accessMethod) {
 
 class KVCollectionCatalogEntry::AddIndexChange : public RecoveryUnit::Change {
 public:
-    AddIndexChange(OperationContext* opCtx, KVCollectionCatalogEntry* cce, StringData ident)
-        : _opCtx(opCtx), _cce(cce), _ident(ident.toString()) {}
+    AddIndexChange(OperationContext* opCtx,
+                   KVCollectionCatalogEntry* cce,
+                   StringData ident,
+                   KVPrefix prefix)
+        : _opCtx(opCtx), _cce(cce), _ident(ident.toString()), _prefix(prefix) {}
 
     virtual void commit() {}
     virtual void rollback() {
         // Intentionally ignoring failure.
-        _cce->_engine->dropIdent(_opCtx, _ident);
+        KVCatalog::dropIdent(_opCtx, _cce->_engine, _ident, _prefix);
     }
 
     OperationContext* const _opCtx;
     KVCollectionCatalogEntry* const _cce;
     const std::string _ident;
+    const KVPrefix _prefix;
 };
 
 class KVCollectionCatalogEntry::RemoveIndexChange : public RecoveryUnit::Change {
 public:
-    RemoveIndexChange(OperationContext* opCtx, KVCollectionCatalogEntry* cce, StringData ident)
-        : _opCtx(opCtx), _cce(cce), _ident(ident.toString()) {}
+    RemoveIndexChange(OperationContext* opCtx,
+                      KVCollectionCatalogEntry* cce,
+                      StringData ident,
+                      KVPrefix prefix)
+        : _opCtx(opCtx), _cce(cce), _ident(ident.toString()), _prefix(prefix) {}
 
     virtual void rollback() {}
     virtual void commit() {
         // Intentionally ignoring failure here. Since we've removed the metadata pointing to the
         // index, we should never see it again anyway.
-        _cce->_engine->dropIdent(_opCtx, _ident);
+        KVCatalog::dropIdent(_opCtx, _cce->_engine, _ident, _prefix);
     }
 
     OperationContext* const _opCtx;
     KVCollectionCatalogEntry* const _cce;
     const std::string _ident;
+    const KVPrefix _prefix;
 };
 
 
@@ -167,12 +175,13 @@ Status KVCollectionCatalogEntry::removeIndex(OperationContext* opCtx, StringData
         return Status::OK();  // never had the index so nothing to do.
 
     const string ident = _catalog->getIndexIdent(opCtx, ns().ns(), indexName);
+    const KVPrefix prefix = md.indexes[md.findIndexOffset(indexName)].prefix;
 
     md.eraseIndex(indexName);
     _catalog->putMetaData(opCtx, ns().toString(), md);
 
     // Lazily remove to isolate underlying engine from rollback.
-    opCtx->recoveryUnit()->registerChange(new RemoveIndexChange(opCtx, this, ident));
+    opCtx->recoveryUnit()->registerChange(new RemoveIndexChange(opCtx, this, ident, prefix));
     return Status::OK();
 }
 
@@ -180,7 +189,11 @@ Status KVCollectionCatalogEntry::prepareForIndexBuild(OperationContext* opCtx,
                                                       const IndexDescriptor* spec) {
     MetaData md = _getMetaData(opCtx);
 
-    KVPrefix prefix = KVPrefix::getNextPrefix(ns());
+    // Indexes configured for a storage engine of their own keep a table of their own.
+    const bool hasStorageEngineOptions = spec->infoObj().hasField("storageEngine") ||
+        md.options.indexOptionDefaults.hasField("storageEngine");
+    KVPrefix prefix =
+        hasStorageEngineOptions ? KVPrefix::kNotPrefixed : KVPrefix::getNextPrefix(ns());
     IndexMetaData imd(spec->infoObj(), false, RecordId(), false, prefix);
     if (indexTypeSupportsPathLevelMultikeyTracking(spec->getAccessMethodName())) {
         const auto feature =
@@ -206,7 +219,7 @@ Status KVCollectionCatalogEntry::prepareForIndexBuild(OperationContext* opCtx,
 
     const Status status = _engine->createGroupedSortedDataInterface(opCtx, ident, spec, prefix);
     if (status.isOK()) {
-        opCtx->recoveryUnit()->registerChange(new AddIndexChange(opCtx, this, ident));
+        opCtx->recoveryUnit()->registerChange(new AddIndexChange(opCtx, this, ident, prefix));
     }
 
     return status;
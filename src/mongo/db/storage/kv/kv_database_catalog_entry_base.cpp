@@ -51,18 +51,20 @@ public:
                         KVDatabaseCatalogEntryBase* dce,
                         StringData collection,
                         StringData ident,
+                        KVPrefix prefix,
                         bool dropOnRollback)
         : _opCtx(opCtx),
           _dce(dce),
           _collection(collection.toString()),
           _ident(ident.toString()),
+          _prefix(prefix),
           _dropOnRollback(dropOnRollback) {}
 
     virtual void commit() {}
     virtual void rollback() {
         if (_dropOnRollback) {
             // Intentionally ignoring failure
-            _dce->_engine->getEngine()->dropIdent(_opCtx, _ident);
+            KVCatalog::dropIdent(_opCtx, _dce->_engine->getEngine(), _ident, _prefix);
         }
 
         const CollectionMap::iterator it = _dce->_collections.find(_collection);
@@ -76,6 +78,7 @@ public:
     KVDatabaseCatalogEntryBase* const _dce;
     const std::string _collection;
     const std::string _ident;
+    const KVPrefix _prefix;
     const bool _dropOnRollback;
 };
 
@@ -85,12 +88,14 @@ public:
                            KVDatabaseCatalogEntryBase* dce,
                            StringData collection,
                            StringData ident,
+                           KVPrefix prefix,
                            KVCollectionCatalogEntry* entry,
                            bool dropOnCommit)
         : _opCtx(opCtx),
           _dce(dce),
           _collection(collection.toString()),
           _ident(ident.toString()),
+          _prefix(prefix),
           _entry(entry),
           _dropOnCommit(dropOnCommit) {}
 
@@ -100,7 +105,7 @@ public:
         // Intentionally ignoring failure here. Since we've removed the metadata pointing to the
         // collection, we should never see it again anyway.
         if (_dropOnCommit)
-            _dce->_engine->getEngine()->dropIdent(_opCtx, _ident);
+            KVCatalog::dropIdent(_opCtx, _dce->_engine->getEngine(), _ident, _prefix);
     }
 
     virtual void rollback() {
@@ -111,6 +116,7 @@ public:
     KVDatabaseCatalogEntryBase* const _dce;
     const std::string _collection;
     const std::string _ident;
+    const KVPrefix _prefix;
     KVCollectionCatalogEntry* const _entry;
     const bool _dropOnCommit;
 };
@@ -207,7 +213,11 @@ Status KVDatabaseCatalogEntryBase::createCollection(OperationContext* opCtx,
         return Status(ErrorCodes::NamespaceExists, "collection already exists");
     }
 
-    KVPrefix prefix = KVPrefix::getNextPrefix(NamespaceString(ns));
+    // Capped collections delete their oldest records by truncating from the start of their table,
+    // and collections with storage engine options need a table configured for them alone.
+    KVPrefix prefix = options.capped || !options.storageEngine.isEmpty()
+        ? KVPrefix::kNotPrefixed
+        : KVPrefix::getNextPrefix(NamespaceString(ns));
 
     // need to create it
     Status status = _engine->getCatalog()->newCollection(opCtx, ns, options, prefix);
@@ -230,7 +240,8 @@ Status KVDatabaseCatalogEntryBase::createCollection(OperationContext* opCtx,
         }
     }
 
-    opCtx->recoveryUnit()->registerChange(new AddCollectionChange(opCtx, this, ns, ident, true));
+    opCtx->recoveryUnit()->registerChange(
+        new AddCollectionChange(opCtx, this, ns, ident, prefix, true));
 
     auto rs = _engine->getEngine()->getGroupedRecordStore(opCtx, ns, ident, options, prefix);
     invariant(rs);
@@ -259,6 +270,15 @@ void KVDatabaseCatalogEntryBase::initCollection(OperationContext* opCtx,
         invariant(rs);
     }
 
+    initCollectionWithRecordStore(ns, std::move(rs));
+}
+
+void KVDatabaseCatalogEntryBase::initCollectionWithRecordStore(const std::string& ns,
+                                                               std::unique_ptr<RecordStore> rs) {
+    invariant(!_collections.count(ns));
+
+    const std::string ident = _engine->getCatalog()->getCollectionIdent(ns);
+
     // No change registration since this is only for committed collections
     _collections[ns] = new KVCollectionCatalogEntry(
         _engine->getEngine(), _engine->getCatalog(), ns, ident, std::move(rs));
@@ -315,11 +335,12 @@ Status KVDatabaseCatalogEntryBase::renameCollection(OperationContext* opCtx,
     const CollectionMap::iterator itFrom = _collections.find(fromNS.toString());
     invariant(itFrom != _collections.end());
     opCtx->recoveryUnit()->registerChange(
-        new RemoveCollectionChange(opCtx, this, fromNS, identFrom, itFrom->second, false));
+        new RemoveCollectionChange(
+            opCtx, this, fromNS, identFrom, md.prefix, itFrom->second, false));
     _collections.erase(itFrom);
 
     opCtx->recoveryUnit()->registerChange(
-        new AddCollectionChange(opCtx, this, toNS, identTo, false));
+        new AddCollectionChange(opCtx, this, toNS, identTo, md.prefix, false));
 
     auto rs =
         _engine->getEngine()->getGroupedRecordStore(opCtx, toNS, identTo, md.options, md.prefix);
@@ -353,6 +374,7 @@ Status KVDatabaseCatalogEntryBase::dropCollection(OperationContext* opCtx, Strin
     invariant(entry->getTotalIndexCount(opCtx) == 0);
 
     const std::string ident = _engine->getCatalog()->getCollectionIdent(ns);
+    const KVPrefix prefix = _engine->getCatalog()->getMetaData(opCtx, ns).prefix;
 
     Status status = _engine->getCatalog()->dropCollection(opCtx, ns);
     if (!status.isOK()) {
@@ -362,7 +384,7 @@ Status KVDatabaseCatalogEntryBase::dropCollection(OperationContext* opCtx, Strin
     // This will lazily delete the KVCollectionCatalogEntry and notify the storageEngine to
     // drop the collection only on WUOW::commit().
     opCtx->recoveryUnit()->registerChange(
-        new RemoveCollectionChange(opCtx, this, ns, ident, it->second, true));
+        new RemoveCollectionChange(opCtx, this, ns, ident, prefix, it->second, true));
 
     _collections.erase(ns.toString());
 
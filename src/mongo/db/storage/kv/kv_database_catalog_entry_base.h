@@ -87,6 +87,12 @@ public:
 
     void initCollection(OperationContext* opCtx, const std::string& ns, bool forRepair);
 
+    /**
+     * Like initCollection(), but for a collection whose record store was already opened by the
+     * caller. 'rs' is null if the collection is about to be repaired.
+     */
+    void initCollectionWithRecordStore(const std::string& ns, std::unique_ptr<RecordStore> rs);
+
     void initCollectionBeforeRepair(OperationContext* opCtx, const std::string& ns);
     void reinitCollectionAfterRepair(OperationContext* opCtx, const std::string& ns);
 
@@ -162,6 +162,15 @@ public:
 
     virtual Status dropIdent(OperationContext* opCtx, StringData ident) = 0;
 
+    /**
+     * Removes the data stored under 'prefix' in the shared table 'ident', leaving the data of
+     * the other prefixes in place. Engines that do not support grouped collections never create
+     * shared tables, so the default drops the whole ident.
+     */
+    virtual Status dropGroupedIdent(OperationContext* opCtx, StringData ident, KVPrefix prefix) {
+        return dropIdent(opCtx, ident);
+    }
+
     // optional
     virtual int flushAllFiles(OperationContext* opCtx, bool sync) {
         return 0;
@@ -202,6 +211,14 @@ public:
      */
     virtual bool supportsDirectoryPerDB() const = 0;
 
+    /**
+     * Returns true if the record stores of this engine derive the RecordId of each record from its
+     * _id when created for a collection with the 'clustered' option.
+     */
+    virtual bool supportsClusteredCollections() const {
+        return false;
+    }
+
     virtual Status okToRename(OperationContext* opCtx,
                               StringData fromNS,
                               StringData toNS,
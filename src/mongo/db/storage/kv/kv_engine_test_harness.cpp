@@ -485,6 +485,84 @@ TEST(KVCatalogTest, RestartForPrefixes) {
     }
 }
 
+TEST(KVCatalogTest, GroupedIdents) {
+    unique_ptr<KVHarnessHelper> helper(KVHarnessHelper::create());
+    KVEngine* engine = helper->getEngine();
+
+    unique_ptr<RecordStore> rs;
+    unique_ptr<KVCatalog> catalog;
+    {
+        MyOperationContext opCtx(engine);
+        WriteUnitOfWork uow(&opCtx);
+        ASSERT_OK(engine->createRecordStore(&opCtx, "catalog", "catalog", CollectionOptions()));
+        rs = engine->getRecordStore(&opCtx, "catalog", "catalog", CollectionOptions());
+        catalog.reset(new KVCatalog(rs.get(), false, false));
+        uow.commit();
+    }
+
+    // Prefixes that differ by the number of tables per database land in the same table.
+    KVPrefix abPrefix = KVPrefix::generateNextPrefix();
+    for (int i = 1; i < 16; ++i) {
+        KVPrefix::generateNextPrefix();
+    }
+    KVPrefix acPrefix = KVPrefix::generateNextPrefix();
+    KVPrefix adPrefix = KVPrefix::generateNextPrefix();
+    {
+        MyOperationContext opCtx(engine);
+        WriteUnitOfWork uow(&opCtx);
+        ASSERT_OK(catalog->newCollection(&opCtx, "a.b", CollectionOptions(), abPrefix));
+        ASSERT_OK(catalog->newCollection(&opCtx, "a.c", CollectionOptions(), acPrefix));
+        ASSERT_OK(catalog->newCollection(&opCtx, "a.d", CollectionOptions(), adPrefix));
+        ASSERT_OK(
+            catalog->newCollection(&opCtx, "a.e", CollectionOptions(), KVPrefix::kNotPrefixed));
+        uow.commit();
+    }
+
+    ASSERT_EQUALS(catalog->getCollectionIdent("a.b"), catalog->getCollectionIdent("a.c"));
+    ASSERT_NOT_EQUALS(catalog->getCollectionIdent("a.b"), catalog->getCollectionIdent("a.d"));
+    ASSERT_TRUE(KVCatalog::isGroupedIdent(catalog->getCollectionIdent("a.b")));
+    ASSERT_TRUE(KVCatalog::isGroupedIdent(catalog->getCollectionIdent("a.d")));
+    ASSERT_FALSE(KVCatalog::isGroupedIdent(catalog->getCollectionIdent("a.e")));
+    ASSERT_TRUE(catalog->isUserDataIdent(catalog->getCollectionIdent("a.b")));
+
+    // Indexes of different versions never share a table.
+    {
+        MyOperationContext opCtx(engine);
+        WriteUnitOfWork uow(&opCtx);
+        BSONCollectionCatalogEntry::MetaData md;
+        md.ns = "a.b";
+        md.prefix = abPrefix;
+        md.indexes.push_back(BSONCollectionCatalogEntry::IndexMetaData(
+            BSON("name"
+                 << "v1"
+                 << "v"
+                 << 1),
+            false,
+            RecordId(),
+            false,
+            abPrefix));
+        md.indexes.push_back(BSONCollectionCatalogEntry::IndexMetaData(
+            BSON("name"
+                 << "v2"
+                 << "v"
+                 << 2),
+            false,
+            RecordId(),
+            false,
+            abPrefix));
+        catalog->putMetaData(&opCtx, "a.b", md);
+        uow.commit();
+    }
+
+    MyOperationContext opCtx(engine);
+    const string v1Ident = catalog->getIndexIdent(&opCtx, "a.b", "v1");
+    const string v2Ident = catalog->getIndexIdent(&opCtx, "a.b", "v2");
+    ASSERT_NOT_EQUALS(v1Ident, v2Ident);
+    ASSERT_TRUE(KVCatalog::isGroupedIdent(v1Ident));
+    ASSERT_TRUE(KVCatalog::isGroupedIdent(v2Ident));
+    ASSERT_TRUE(catalog->isUserDataIdent(v1Ident));
+}
+
 }  // namespace
 
 std::unique_ptr<KVHarnessHelper> KVHarnessHelper::create() {
@@ -202,6 +202,7 @@ TEST_F(SnapshotManagerTests, ConsistentIfNotSupported) {
     auto ru = op->recoveryUnit();
     ASSERT(!ru->isReadingFromMajorityCommittedSnapshot());
     ASSERT(!ru->getMajorityCommittedSnapshot());
+    ASSERT(!ru->getLastAppliedSnapshot());
 }
 
 TEST_F(SnapshotManagerTests, FailsWithNoCommittedSnapshot) {
@@ -323,6 +324,48 @@ TEST_F(SnapshotManagerTests, BasicFunctionality) {
     ASSERT_EQ(itCountOn(longOp), 4);
 }
 
+TEST_F(SnapshotManagerTests, ReadFromLastAppliedSnapshot) {
+    if (!snapshotManager)
+        return;  // This test is only for engines that DO support SnapshotMangers.
+
+    // Before first snapshot is created.
+    {
+        auto op = makeOperation();
+        ASSERT_EQ(op->recoveryUnit()->setReadFromLastAppliedSnapshot(),
+                  ErrorCodes::SnapshotUnavailable);
+    }
+
+    insertRecordAndCommit();
+    auto snap1 = prepareAndCreateSnapshot();
+    insertRecordAndCommit();
+
+    // The snapshot doesn't need to be committed, and writes after it are invisible.
+    auto longOp = makeOperation();
+    ASSERT_OK(longOp->recoveryUnit()->setReadFromLastAppliedSnapshot());
+    ASSERT(longOp->recoveryUnit()->getLastAppliedSnapshot() == snap1);
+    ASSERT(!longOp->recoveryUnit()->getMajorityCommittedSnapshot());
+    ASSERT_EQ(itCountOn(longOp), 1);
+
+    // If this fails, longOp changed snapshots at an illegal time.
+    auto snap2 = prepareAndCreateSnapshot();
+    ASSERT_EQ(itCountOn(longOp), 1);
+
+    // If this fails, longOp didn't move to the newest snapshot when it should have.
+    longOp->recoveryUnit()->abandonSnapshot();
+    ASSERT_EQ(itCountOn(longOp), 2);
+    ASSERT(longOp->recoveryUnit()->getLastAppliedSnapshot() == snap2);
+
+    // Cleaning up behind the committed snapshot never removes the last applied one.
+    snapshotManager->setCommittedSnapshot(snap2);
+    snapshotManager->cleanupUnneededSnapshots();
+    longOp->recoveryUnit()->abandonSnapshot();
+    ASSERT_EQ(itCountOn(longOp), 2);
+
+    snapshotManager->dropAllSnapshots();
+    longOp->recoveryUnit()->abandonSnapshot();
+    ASSERT_THROWS_CODE(itCountOn(longOp), UserException, ErrorCodes::SnapshotUnavailable);
+}
+
 TEST_F(SnapshotManagerTests, UpdateAndDelete) {
     if (!snapshotManager)
         return;  // This test is only for engines that DO support SnapshotMangers.
@@ -33,11 +33,15 @@
 #include <algorithm>
 
 #include "mongo/db/operation_context_noop.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/kv/kv_database_catalog_entry.h"
 #include "mongo/db/storage/kv/kv_engine.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -46,6 +50,9 @@ using std::vector;
 
 namespace {
 const std::string catalogInfo = "_mdb_catalog";
+
+// How many threads open collection record stores at startup.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(kvStorageEngineStartupThreads, int, 8);
 }
 
 class KVStorageEngine::RemoveDBChange : public RecoveryUnit::Change {
@@ -80,6 +87,8 @@ KVStorageEngine::KVStorageEngine(
             !(options.directoryPerDB && !engine->supportsDirectoryPerDB()));
 
     OperationContextNoop opCtx(_engine->newRecoveryUnit());
+    BSONObjBuilder startupStats;
+    Timer phaseTimer;
 
     bool catalogExists = engine->hasIdent(&opCtx, catalogInfo);
 
@@ -124,13 +133,24 @@ KVStorageEngine::KVStorageEngine(
             db = _databaseCatalogEntryFactory(dbName, this).release();
         }
 
-        db->initCollection(&opCtx, coll, options.forRepair);
         auto maxPrefixForCollection = _catalog->getMetaData(&opCtx, coll).getMaxPrefix();
         maxSeenPrefix = std::max(maxSeenPrefix, maxPrefixForCollection);
     }
 
     KVPrefix::setLargestPrefix(maxSeenPrefix);
     opCtx.recoveryUnit()->abandonSnapshot();
+    startupStats.append("loadCatalogMillis", phaseTimer.millis());
+    phaseTimer.reset();
+
+    _openCollections(collections);
+    startupStats.append("numCollections", static_cast<long long>(collections.size()));
+    startupStats.append("openCollectionsMillis", phaseTimer.millis());
+    phaseTimer.reset();
+
+    ON_BLOCK_EXIT([&] {
+        _startupStats = startupStats.obj();
+        log() << "Opened storage engine catalog: " << _startupStats;
+    });
 
     // now clean up orphaned idents
     // we don't do this in readOnly mode.
@@ -165,6 +185,64 @@ KVStorageEngine::KVStorageEngine(
             wuow.commit();
         }
     }
+    startupStats.append("dropUnusedIdentsMillis", phaseTimer.millis());
+}
+
+void KVStorageEngine::_openCollections(const std::vector<std::string>& collections) {
+    // Each collection's record store is opened into its own slot so that worker threads never
+    // touch the database catalog entries, which are not thread-safe.
+    std::vector<std::unique_ptr<RecordStore>> recordStores(collections.size());
+    std::vector<Status> statuses(collections.size(), Status::OK());
+
+    auto openRange = [&](size_t begin, size_t end) {
+        OperationContextNoop opCtx(_engine->newRecoveryUnit());
+        for (size_t i = begin; i < end; ++i) {
+            try {
+                const std::string& ns = collections[i];
+                BSONCollectionCatalogEntry::MetaData md = _catalog->getMetaData(&opCtx, ns);
+                recordStores[i] = _engine->getGroupedRecordStore(
+                    &opCtx, ns, _catalog->getCollectionIdent(ns), md.options, md.prefix);
+                invariant(recordStores[i]);
+            } catch (const DBException& ex) {
+                statuses[i] = ex.toStatus();
+            }
+        }
+        opCtx.recoveryUnit()->abandonSnapshot();
+    };
+
+    // Record stores aren't opened before a repair; see KVDatabaseCatalogEntryBase.
+    if (!_options.forRepair) {
+        const size_t numThreads = std::min(
+            collections.size(), static_cast<size_t>(std::max(1, kvStorageEngineStartupThreads)));
+        if (numThreads <= 1) {
+            openRange(0, collections.size());
+        } else {
+            ThreadPool::Options poolOptions;
+            poolOptions.poolName = "KVStorageEngineStartup";
+            poolOptions.maxThreads = numThreads;
+            ThreadPool pool(poolOptions);
+            pool.startup();
+
+            const size_t perThread = (collections.size() + numThreads - 1) / numThreads;
+            for (size_t begin = 0; begin < collections.size(); begin += perThread) {
+                const size_t end = std::min(begin + perThread, collections.size());
+                fassert(40630, pool.schedule([&openRange, begin, end] { openRange(begin, end); }));
+            }
+            pool.shutdown();
+            pool.join();
+        }
+    }
+
+    for (size_t i = 0; i < collections.size(); ++i) {
+        uassertStatusOK(statuses[i]);
+        const std::string& ns = collections[i];
+        _dbs[NamespaceString(ns).db().toString()]->initCollectionWithRecordStore(
+            ns, std::move(recordStores[i]));
+    }
+}
+
+void KVStorageEngine::appendStartupStats(BSONObjBuilder* builder) const {
+    builder->appendElements(_startupStats);
 }
 
 void KVStorageEngine::cleanShutdown() {
@@ -284,6 +362,10 @@ bool KVStorageEngine::isEphemeral() const {
     return _engine->isEphemeral();
 }
 
+bool KVStorageEngine::supportsClusteredCollections() const {
+    return _engine->supportsClusteredCollections();
+}
+
 SnapshotManager* KVStorageEngine::getSnapshotManager() const {
     return _engine->getSnapshotManager();
 }
@@ -103,6 +103,8 @@ public:
 
     virtual bool isEphemeral() const;
 
+    bool supportsClusteredCollections() const override;
+
     virtual Status repairRecordStore(OperationContext* opCtx, const std::string& ns);
 
     virtual void cleanShutdown();
@@ -111,6 +113,8 @@ public:
 
     void setJournalListener(JournalListener* jl) final;
 
+    void appendStartupStats(BSONObjBuilder* builder) const final;
+
     // ------ kv ------
 
     KVEngine* getEngine() {
@@ -130,6 +134,13 @@ public:
 private:
     class RemoveDBChange;
 
+    /**
+     * Opens the record store of every collection in 'collections' and adds it to its database's
+     * catalog entry. Record stores are opened by up to 'kvStorageEngineStartupThreads' threads at
+     * once, since on nodes with many collections this dominates startup time.
+     */
+    void _openCollections(const std::vector<std::string>& collections);
+
     stdx::function<KVDatabaseCatalogEntryFactory> _databaseCatalogEntryFactory;
 
     KVStorageEngineOptions _options;
@@ -148,5 +159,8 @@ private:
 
     // Flag variable that states if the storage engine is in backup mode.
     bool _inBackupMode = false;
+
+    // Durations of the phases of this object's construction. Immutable once constructed.
+    BSONObj _startupStats;
 };
 }  // namespace mongo
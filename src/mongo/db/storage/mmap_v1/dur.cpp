@@ -138,9 +138,9 @@ enum {
     NumCommitsBeforeRemap = 10,
 
     // How many outstanding journal flushes should be allowed before applying writer back
-    // pressure. Size of 1 allows two journal blocks to be in the process of being written -
-    // one on the journal writer's buffer and one blocked waiting to be picked up.
-    NumAsyncJournalWrites = 1,
+    // pressure. Each one has a journal writer buffer, so 2 lets the durability thread prepare the
+    // next group commit while the journal writer threads compress and write the previous one.
+    NumAsyncJournalWrites = 2,
 };
 
 // Remap loop state
@@ -465,7 +465,8 @@ void Stats::S::reset() {
 }
 
 std::string Stats::S::_CSVHeader() const {
-    return "cmts\t jrnMB\t wrDFMB\t cIWLk\t early\t prpLgB\t wrToJ\t wrToDF\t rmpPrVw";
+    return "cmts\t jrnMB\t wrDFMB\t cIWLk\t early\t prpLgB\t wrToJ\t wrToDF\t rmpPrVw\t "
+           "cmprsJ\t gcLat";
 }
 
 std::string Stats::S::_asCSV() const {
@@ -476,7 +477,9 @@ std::string Stats::S::_asCSV() const {
        << (unsigned)(_writeToJournalMicros / 1000) << '\t'
        << (unsigned)(_writeToDataFilesMicros / 1000) << '\t'
        << (unsigned)(_remapPrivateViewMicros / 1000) << '\t' << (unsigned)(_commitsMicros / 1000)
-       << '\t' << (unsigned)(_commitsInWriteLockMicros / 1000) << '\t';
+       << '\t' << (unsigned)(_commitsInWriteLockMicros / 1000) << '\t'
+       << (unsigned)(_compressJournalMicros / 1000) << '\t'
+       << (unsigned)(_groupCommitLatencyMicros / 1000) << '\t';
 
     return ss.str();
 }
@@ -497,7 +500,15 @@ void Stats::S::_asObj(BSONObjBuilder* builder) const {
                    << "commits"
                    << (unsigned)(_commitsMicros / 1000)
                    << "commitsInWriteLock"
-                   << (unsigned)(_commitsInWriteLockMicros / 1000));
+                   << (unsigned)(_commitsInWriteLockMicros / 1000)
+                   << "compressJournal"
+                   << (unsigned)(_compressJournalMicros / 1000));
+
+    b << "groupCommits"
+      << BSON("count" << _groupCommits << "latencyMicros"
+                      << static_cast<long long>(_groupCommitLatencyMicros)
+                      << "maxLatencyMicros"
+                      << static_cast<long long>(_groupCommitMaxLatencyMicros));
 
     if (storageGlobalParams.journalCommitIntervalMs.load() != 0) {
         b << "journalCommitIntervalMs" << storageGlobalParams.journalCommitIntervalMs.load();
@@ -752,19 +752,29 @@ void Journal::_rotate(unsigned long long lsnOfCurrentJournalEntry) {
     }
 }
 
-/** write (append) the buffer we have built to the journal and fsync it.
+void prepareJournalSection(const JSectHeader& h,
+                           const AlignedBuilder& uncompressed,
+                           AlignedBuilder* section) {
+    Timer t;
+    Journal::prepareSection(h, uncompressed, section);
+    stats.curr()->_compressJournalMicros += t.micros();
+}
+
+/** write (append) a section we have built to the journal and fsync it.
     outside of dbMutex lock as this could be slow.
-    @param uncompressed - a buffer that will be written to the journal after compression
+    @param section - built by prepareJournalSection
     will not return until on disk
 */
-void WRITETOJOURNAL(const JSectHeader& h, const AlignedBuilder& uncompressed) {
+void WRITETOJOURNAL(AlignedBuilder* section, unsigned uncompressedLen) {
     Timer t;
-    j.journal(h, uncompressed);
+    j.journal(section, uncompressedLen);
     stats.curr()->_writeToJournalMicros += t.micros();
 }
 
-void Journal::journal(const JSectHeader& h, const AlignedBuilder& uncompressed) {
-    static AlignedBuilder b(32 * 1024 * 1024);
+void Journal::prepareSection(const JSectHeader& h,
+                             const AlignedBuilder& uncompressed,
+                             AlignedBuilder* section) {
+    AlignedBuilder& b = *section;
     /* buffer to journal will be
        JSectHeader
        compressed operations
@@ -803,6 +813,12 @@ void Journal::journal(const JSectHeader& h, const AlignedBuilder& uncompressed)
         b.skip(L - lenUnpadded);
         dassert(b.len() % Alignment == 0);
     }
+}
+
+void Journal::journal(AlignedBuilder* section, unsigned uncompressedLen) {
+    AlignedBuilder& b = *section;
+    JSectHeader* const h = (JSectHeader*)b.atOfs(0);
+    const unsigned L = h->sectionLenWithPadding();
 
     try {
         stdx::lock_guard<SimpleMutex> lk(_curLogFileMutex);
@@ -810,13 +826,23 @@ void Journal::journal(const JSectHeader& h, const AlignedBuilder& uncompressed)
         // must already be open -- so that _curFileId is correct for previous buffer building
         verify(_curLogFile);
 
-        stats.curr()->_uncompressedBytes += uncompressed.len();
+        // The section may have been built while the previous one was still being written, before
+        // that write rotated to a new journal file. Recovery stops at a section whose fileId does
+        // not match its file's, so restamp it and recompute the checksum, which covers the header.
+        if (h->fileId != _curFileId) {
+            h->fileId = _curFileId;
+
+            const unsigned hashedLen = h->sectionLen() - sizeof(JSectFooter);
+            *((JSectFooter*)b.atOfs(hashedLen)) = JSectFooter(b.buf(), hashedLen);
+        }
+
+        stats.curr()->_uncompressedBytes += uncompressedLen;
         unsigned w = b.len();
         _written += w;
         verify(w <= L);
         stats.curr()->_journaledBytes += L;
         _curLogFile->synchronousAppend((const void*)b.buf(), L);
-        _rotate(h.seqNumber);
+        _rotate(h->seqNumber);
     } catch (std::exception& e) {
         log() << "error exception in dur::journal " << e.what() << endl;
         throw;
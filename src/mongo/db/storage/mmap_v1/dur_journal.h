@@ -83,9 +83,19 @@ unsigned long long journalReadLSN();
 bool haveJournalFiles(bool anyFiles = false);
 
 /**
- * Writes the specified uncompressed buffer to the journal.
+ * Compresses the specified uncompressed buffer into a journal section with the given header, ready
+ * to be appended to the journal by WRITETOJOURNAL. Does not touch the journal file, so it can run
+ * while the previous section is being written.
  */
-void WRITETOJOURNAL(const JSectHeader& h, const AlignedBuilder& uncompressed);
+void prepareJournalSection(const JSectHeader& h,
+                           const AlignedBuilder& uncompressed,
+                           AlignedBuilder* section);
+
+/**
+ * Appends a section built by prepareJournalSection to the journal. Will not return until the
+ * section is on disk.
+ */
+void WRITETOJOURNAL(AlignedBuilder* section, unsigned uncompressedLen);
 
 // in case disk controller buffers writes
 const long long ExtraKeepTimeMs = 10000;
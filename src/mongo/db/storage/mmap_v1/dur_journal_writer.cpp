@@ -32,6 +32,8 @@
 
 #include "mongo/db/storage/mmap_v1/dur_journal_writer.h"
 
+#include <algorithm>
+
 #include "mongo/db/client.h"
 #include "mongo/db/storage/mmap_v1/dur.h"
 #include "mongo/db/storage/mmap_v1/dur_journal.h"
@@ -41,6 +43,7 @@
 #include "mongo/stdx/thread.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/log.h"
+#include "mongo/util/time_support.h"
 #include "mongo/util/timer.h"
 
 namespace mongo {
@@ -74,6 +77,30 @@ void WRITETODATAFILES(OperationContext* opCtx,
     LOG(4) << "journal WRITETODATAFILES " << m / 1000.0 << "ms";
 }
 
+/**
+ * Called from the catch block of a journal thread's main loop. Any exception there is fatal.
+ */
+void terminateOnJournalThreadException(StringData threadName) {
+    try {
+        throw;
+    } catch (const DBException& e) {
+        severe() << "dbexception in " << threadName
+                 << " causing immediate shutdown: " << redact(e);
+    } catch (const std::ios_base::failure& e) {
+        severe() << "ios_base exception in " << threadName
+                 << " causing immediate shutdown: " << e.what();
+    } catch (const std::bad_alloc& e) {
+        severe() << "bad_alloc exception in " << threadName
+                 << " causing immediate shutdown: " << e.what();
+    } catch (const std::exception& e) {
+        severe() << "exception in " << threadName
+                 << " causing immediate shutdown: " << redact(e.what());
+    } catch (...) {
+        severe() << "unhandled exception in " << threadName << " causing immediate shutdown";
+    }
+    invariant(false);
+}
+
 }  // namespace
 
 
@@ -120,13 +147,16 @@ JournalWriter::JournalWriter(CommitNotifier* commitNotify,
       _shutdownRequested(false),
       _journalQueue(numBuffers),
       _lastCommitNumber(0),
+      _writeQueue(numBuffers),
       _readyQueue(numBuffers) {
     invariant(_journalQueue.maxSize() == _readyQueue.maxSize());
+    invariant(_writeQueue.maxSize() == _readyQueue.maxSize());
 }
 
 JournalWriter::~JournalWriter() {
     // Never close the journal writer with outstanding or unaccounted writes
     invariant(_journalQueue.empty());
+    invariant(_writeQueue.empty());
     invariant(_readyQueue.empty());
 }
 
@@ -139,9 +169,12 @@ void JournalWriter::start() {
         _readyQueue.push(new Buffer(InitialBufferSizeBytes));
     }
 
-    // Start the thread
-    stdx::thread t(stdx::bind(&JournalWriter::_journalWriterThread, this));
-    _journalWriterThreadHandle.swap(t);
+    // Start the threads
+    stdx::thread compressor(stdx::bind(&JournalWriter::_journalCompressorThread, this));
+    _journalCompressorThreadHandle.swap(compressor);
+
+    stdx::thread writer(stdx::bind(&JournalWriter::_journalWriterThread, this));
+    _journalWriterThreadHandle.swap(writer);
 }
 
 void JournalWriter::shutdown() {
@@ -155,11 +188,12 @@ void JournalWriter::shutdown() {
     Buffer* const shutdownBuffer = newBuffer();
     shutdownBuffer->_setShutdown();
 
-    // This will terminate the journal thread. No need to specify commit number, since we are
+    // This will terminate the journal threads. No need to specify commit number, since we are
     // shutting down and nothing will be notified anyways.
     writeBuffer(shutdownBuffer, 0);
 
-    // Ensure the journal thread has stopped and everything accounted for.
+    // Ensure the journal threads have stopped and everything accounted for.
+    _journalCompressorThreadHandle.join();
     _journalWriterThreadHandle.join();
     assertIdle();
 
@@ -173,6 +207,7 @@ void JournalWriter::shutdown() {
 void JournalWriter::assertIdle() {
     // All buffers are in the ready queue means there is nothing pending.
     invariant(_journalQueue.empty());
+    invariant(_writeQueue.empty());
     invariant(_readyQueue.count() == _readyQueue.maxSize());
 }
 
@@ -188,6 +223,7 @@ void JournalWriter::writeBuffer(Buffer* buffer, CommitNotifier::When commitNumbe
     invariant((commitNumber > _lastCommitNumber) || (buffer->_isShutdown && (commitNumber == 0)));
 
     buffer->_commitNumber = commitNumber;
+    buffer->_submittedMicros = curTimeMicros64();
 
     _journalQueue.push(buffer);
 }
@@ -207,6 +243,38 @@ void JournalWriter::flush() {
     }
 }
 
+void JournalWriter::_journalCompressorThread() {
+    Client::initThread("journal compressor");
+
+    log() << "Journal compressor thread started";
+
+    try {
+        while (true) {
+            Buffer* const buffer = [&] {
+                MONGO_IDLE_THREAD_BLOCK;
+                return _journalQueue.blockingPop();
+            }();
+
+            if (!buffer->_isShutdown && !buffer->_isNoop) {
+                prepareJournalSection(buffer->_header, buffer->_builder, &buffer->_section);
+            }
+
+            // This should never block, because there are no more buffers than the queue holds.
+            invariant(_writeQueue.count() < _writeQueue.maxSize());
+            _writeQueue.push(buffer);
+
+            if (buffer->_isShutdown) {
+                // The writer thread terminates once it gets to this buffer.
+                break;
+            }
+        }
+    } catch (...) {
+        terminateOnJournalThreadException("journalCompressorThread");
+    }
+
+    log() << "Journal compressor thread stopped";
+}
+
 void JournalWriter::_journalWriterThread() {
     Client::initThread("journal writer");
 
@@ -216,7 +284,7 @@ void JournalWriter::_journalWriterThread() {
         while (true) {
             Buffer* const buffer = [&] {
                 MONGO_IDLE_THREAD_BLOCK;
-                return _journalQueue.blockingPop();
+                return _writeQueue.blockingPop();
             }();
 
             BufferGuard bufferGuard(buffer, &_readyQueue);
@@ -242,7 +310,13 @@ void JournalWriter::_journalWriterThread() {
                    << ", size " << buffer->_builder.len() << " bytes)";
 
             // This performs synchronous I/O to the journal file and will block.
-            WRITETOJOURNAL(buffer->_header, buffer->_builder);
+            WRITETOJOURNAL(&buffer->_section, buffer->_builder.len());
+
+            const uint64_t latencyMicros = curTimeMicros64() - buffer->_submittedMicros;
+            stats.curr()->_groupCommits++;
+            stats.curr()->_groupCommitLatencyMicros += latencyMicros;
+            stats.curr()->_groupCommitMaxLatencyMicros =
+                std::max(stats.curr()->_groupCommitMaxLatencyMicros, latencyMicros);
 
             // Data is now persisted in the journal, which is sufficient for acknowledging
             // durability.
@@ -257,24 +331,8 @@ void JournalWriter::_journalWriterThread() {
             // cleanup waiters.
             _applyToDataFilesNotify->notifyAll(buffer->_commitNumber);
         }
-    } catch (const DBException& e) {
-        severe() << "dbexception in journalWriterThread causing immediate shutdown: " << redact(e);
-        invariant(false);
-    } catch (const std::ios_base::failure& e) {
-        severe() << "ios_base exception in journalWriterThread causing immediate shutdown: "
-                 << e.what();
-        invariant(false);
-    } catch (const std::bad_alloc& e) {
-        severe() << "bad_alloc exception in journalWriterThread causing immediate shutdown: "
-                 << e.what();
-        invariant(false);
-    } catch (const std::exception& e) {
-        severe() << "exception in journalWriterThread causing immediate shutdown: "
-                 << redact(e.what());
-        invariant(false);
     } catch (...) {
-        severe() << "unhandled exception in journalWriterThread causing immediate shutdown";
-        invariant(false);
+        terminateOnJournalThreadException("journalWriterThread");
     }
 
     log() << "Journal writer thread stopped";
@@ -286,7 +344,13 @@ void JournalWriter::_journalWriterThread() {
 //
 
 JournalWriter::Buffer::Buffer(size_t initialSize)
-    : _commitNumber(0), _isNoop(false), _isShutdown(false), _header(), _builder(initialSize) {}
+    : _commitNumber(0),
+      _isNoop(false),
+      _isShutdown(false),
+      _submittedMicros(0),
+      _header(),
+      _builder(initialSize),
+      _section(initialSize) {}
 
 JournalWriter::Buffer::~Buffer() {
     _assertEmpty();
@@ -301,6 +365,7 @@ void JournalWriter::Buffer::_reset() {
     _commitNumber = 0;
     _isNoop = false;
     _builder.reset();
+    _section.reset();
 }
 
 }  // namespace dur
@@ -40,9 +40,13 @@ namespace mongo {
 namespace dur {
 
 /**
- * Manages the thread and queues used for writing the journal to disk and notify parties with
+ * Manages the threads and queues used for writing the journal to disk and notify parties with
  * are waiting on the write concern.
  *
+ * Buffers are compressed into journal sections on a compressor thread and then written and applied
+ * to the data files on the writer thread, so with more than one buffer, a group commit is
+ * compressed while the previous one is being written and fsynced.
+ *
  * NOTE: Not thread-safe and must not be used from more than one thread.
  */
 class JournalWriter {
@@ -95,8 +99,14 @@ public:
         // be the last entry posted to the queue and the commit number should be zero.
         bool _isShutdown;
 
+        // When the buffer was handed to writeBuffer, to measure the group commit latency
+        uint64_t _submittedMicros;
+
         JSectHeader _header;
         AlignedBuilder _builder;
+
+        // Compressed journal section built from _header and _builder by the compressor thread
+        AlignedBuilder _section;
     };
 
 
@@ -172,6 +182,7 @@ private:
     enum { InitialBufferSizeBytes = 4 * 1024 * 1024 };
 
 
+    void _journalCompressorThread();
     void _journalWriterThread();
 
 
@@ -182,16 +193,20 @@ private:
     // This gets notified as journal buffers are done being applied to the shared view
     CommitNotifier* const _applyToDataFilesNotify;
 
-    // Wraps and controls the journal writer thread
+    // Wrap and control the journal compressor and writer threads
+    stdx::thread _journalCompressorThreadHandle;
     stdx::thread _journalWriterThreadHandle;
 
     // Indicates that shutdown has been requested. Used for idempotency of the shutdown call.
     bool _shutdownRequested;
 
-    // Queue of buffers, which need to be written by the journal writer thread
+    // Queue of buffers, which need to be compressed by the journal compressor thread
     BufferQueue _journalQueue;
     CommitNotifier::When _lastCommitNumber;
 
+    // Queue of compressed buffers, which need to be written by the journal writer thread
+    BufferQueue _writeQueue;
+
     // Queue of buffers, whose write has been completed by the journal writer thread.
     BufferQueue _readyQueue;
 };
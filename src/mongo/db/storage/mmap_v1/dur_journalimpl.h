@@ -62,9 +62,15 @@ public:
      */
     void rotate();
 
-    /** append to the journal file
+    /** compress and frame a journal section. does not need any lock.
     */
-    void journal(const JSectHeader& h, const AlignedBuilder& b);
+    static void prepareSection(const JSectHeader& h,
+                               const AlignedBuilder& uncompressed,
+                               AlignedBuilder* section);
+
+    /** append a section built by prepareSection to the journal file
+    */
+    void journal(AlignedBuilder* section, unsigned uncompressedLen);
 
     boost::filesystem::path getFilePathFor(int filenumber) const;
 
@@ -34,9 +34,9 @@ namespace mongo {
 namespace dur {
 
 /**
- * journaling stats.  the model here is that the commit thread is the only writer, and that reads
- * are uncommon (from a serverStatus command and such).  Thus, there should not be multicore chatter
- * overhead.
+ * journaling stats.  the model here is that the commit thread and the journal writer threads are
+ * the only writers, each of its own fields, and that reads are uncommon (from a serverStatus
+ * command and such).  Thus, there should not be multicore chatter overhead.
  */
 struct Stats {
     struct S {
@@ -66,11 +66,18 @@ struct Stats {
         uint64_t _writeToDataFilesBytes;
 
         uint64_t _prepLogBufferMicros;
+        uint64_t _compressJournalMicros;
         uint64_t _writeToJournalMicros;
         uint64_t _writeToDataFilesMicros;
         uint64_t _remapPrivateViewMicros;
         uint64_t _commitsMicros;
         uint64_t _commitsInWriteLockMicros;
+
+        // Time from handing a group commit to the journal writer until it is durable in the
+        // journal, which includes waiting behind the group commits before it.
+        unsigned _groupCommits;
+        uint64_t _groupCommitLatencyMicros;
+        uint64_t _groupCommitMaxLatencyMicros;
     };
 
 
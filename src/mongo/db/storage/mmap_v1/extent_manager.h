@@ -188,6 +188,12 @@ public:
      */
     virtual CacheHint* cacheHint(const DiskLoc& extentLoc, const HintType& hint) = 0;
 
+    /**
+     * Tell the system that this extent is about to be read, so that it can start paging it in
+     * ahead of the reader. Does nothing by default.
+     */
+    virtual void readAhead(const DiskLoc& extentLoc) {}
+
     virtual DataFileVersion getFileFormat(OperationContext* opCtx) const = 0;
     virtual void setFileFormat(OperationContext* opCtx, DataFileVersion newVersion) = 0;
 
@@ -135,6 +135,7 @@ public:
 #if defined(__sun)
 MAdvise::MAdvise(void*, unsigned, Advice) {}
 MAdvise::~MAdvise() {}
+void MAdvise::willNeed(void*, unsigned) {}
 #else
 MAdvise::MAdvise(void* p, unsigned len, Advice a) {
     _p = _pageAlign(p);
@@ -158,6 +159,15 @@ MAdvise::MAdvise(void* p, unsigned len, Advice a) {
 MAdvise::~MAdvise() {
     madvise(_p, _len, MADV_NORMAL);
 }
+void MAdvise::willNeed(void* p, unsigned len) {
+    void* const start = _pageAlign(p);
+    len += static_cast<unsigned>(reinterpret_cast<size_t>(p) - reinterpret_cast<size_t>(start));
+
+    // This is only a hint, so a failure is not worth more than a debug message.
+    if (madvise(start, len, MADV_WILLNEED)) {
+        LOG(1) << "madvise(MADV_WILLNEED) failed: " << errnoWithDescription();
+    }
+}
 #endif
 
 void* MemoryMappedFile::map(OperationContext* opCtx,
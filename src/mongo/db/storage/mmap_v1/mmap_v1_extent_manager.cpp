@@ -639,6 +639,11 @@ ExtentManager::CacheHint* MmapV1ExtentManager::cacheHint(const DiskLoc& extentLo
     return new CacheHintMadvise(reinterpret_cast<void*>(e), e->length, MAdvise::Sequential);
 }
 
+void MmapV1ExtentManager::readAhead(const DiskLoc& extentLoc) {
+    Extent* e = getExtent(extentLoc);
+    MAdvise::willNeed(reinterpret_cast<void*>(e), e->length);
+}
+
 MmapV1ExtentManager::FilesArray::~FilesArray() {
     for (int i = 0; i < size(); i++) {
         delete _files[i];
@@ -163,6 +163,8 @@ public:
 
     virtual CacheHint* cacheHint(const DiskLoc& extentLoc, const HintType& hint);
 
+    virtual void readAhead(const DiskLoc& extentLoc);
+
 private:
     /**
      * will return NULL if nothing suitable in free list
@@ -70,6 +70,7 @@ stdx::mutex mapViewMutex;
 
 MAdvise::MAdvise(void*, unsigned, Advice) {}
 MAdvise::~MAdvise() {}
+void MAdvise::willNeed(void*, unsigned) {}
 
 const unsigned long long memoryMappedFileLocationFloor = 256LL * 1024LL * 1024LL * 1024LL;
 static unsigned long long _nextMemoryMappedFileLocation = memoryMappedFileLocationFloor;
@@ -29,12 +29,21 @@
 #include "mongo/db/storage/mmap_v1/record_store_v1_simple_iterator.h"
 
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/mmap_v1/extent.h"
 #include "mongo/db/storage/mmap_v1/extent_manager.h"
 #include "mongo/db/storage/mmap_v1/record_store_v1_simple.h"
 
 namespace mongo {
 
+namespace {
+
+// How many extents ahead of a collection scan to ask the OS to read in. 0 disables the read ahead
+// and the sequential access hint for the extent being scanned.
+MONGO_EXPORT_SERVER_PARAMETER(mmapv1CollectionScanReadAheadExtents, int, 1);
+
+}  // namespace
+
 //
 // Regular / non-capped collection traversal
 //
@@ -74,6 +83,8 @@ SimpleRecordStoreV1Iterator::SimpleRecordStoreV1Iterator(OperationContext* opCtx
         // valid e->xprev
         _curr = e->lastRecord;
     }
+
+    adviseOnExtentChange();
 }
 
 boost::optional<Record> SimpleRecordStoreV1Iterator::next() {
@@ -99,6 +110,37 @@ void SimpleRecordStoreV1Iterator::advance() {
             _curr = _recordStore->getPrevRecord(_opCtx, _curr);
         }
     }
+
+    adviseOnExtentChange();
+}
+
+void SimpleRecordStoreV1Iterator::adviseOnExtentChange() {
+    const int readAheadExtents = mmapv1CollectionScanReadAheadExtents.load();
+    if (isEOF() || readAheadExtents <= 0) {
+        _currExtent = DiskLoc();
+        _currExtentHint.reset();
+        return;
+    }
+
+    ExtentManager* em = _recordStore->_extentManager;
+    const DiskLoc extentLoc = em->extentLocForV1(_curr);
+    if (extentLoc == _currExtent) {
+        return;
+    }
+
+    _currExtent = extentLoc;
+    _currExtentHint.reset(em->cacheHint(extentLoc, ExtentManager::Sequential));
+
+    const Extent* e = em->getExtent(extentLoc);
+    for (int i = 0; i < readAheadExtents; i++) {
+        const DiskLoc nextLoc = _forward ? e->xnext : e->xprev;
+        if (nextLoc.isNull()) {
+            break;
+        }
+
+        em->readAhead(nextLoc);
+        e = em->getExtent(nextLoc);
+    }
 }
 
 void SimpleRecordStoreV1Iterator::invalidate(OperationContext* opCtx, const RecordId& dl) {
@@ -28,7 +28,10 @@
 
 #pragma once
 
+#include <memory>
+
 #include "mongo/db/storage/mmap_v1/diskloc.h"
+#include "mongo/db/storage/mmap_v1/extent_manager.h"
 #include "mongo/db/storage/record_store.h"
 
 namespace mongo {
@@ -67,6 +70,12 @@ private:
         return _curr.isNull();
     }
 
+    /**
+     * When the iteration has moved into a new extent, hints that the extent is read sequentially
+     * and asks for the next extents in the direction of the iteration to be read ahead.
+     */
+    void adviseOnExtentChange();
+
     // for getNext, not owned
     OperationContext* _opCtx;
 
@@ -74,6 +83,11 @@ private:
     DiskLoc _curr;
     const SimpleRecordStoreV1* const _recordStore;
     const bool _forward;
+
+    // The extent of _curr when adviseOnExtentChange last ran, and the sequential access hint for
+    // it, which is reset when the iteration leaves it.
+    DiskLoc _currExtent;
+    std::unique_ptr<ExtentManager::CacheHint> _currExtentHint;
 };
 
 }  // namespace mongo
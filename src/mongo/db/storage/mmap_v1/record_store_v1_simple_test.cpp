@@ -455,4 +455,50 @@ TEST(SimpleRecordStoreV1, Truncate) {
         assertStateV1RS(&opCtx, recs, drecs, NULL, &em, md);
     }
 }
+
+class ReadAheadRecordingExtentManager : public DummyExtentManager {
+public:
+    void readAhead(const DiskLoc& extentLoc) override {
+        readAheadExtents.push_back(extentLoc);
+    }
+
+    std::vector<DiskLoc> readAheadExtents;
+};
+
+TEST(SimpleRecordStoreV1, CollectionScanReadsAheadNextExtent) {
+    OperationContextNoop opCtx;
+    ReadAheadRecordingExtentManager em;
+    DummyRecordStoreV1MetaData* md = new DummyRecordStoreV1MetaData(false, 0);
+    SimpleRecordStoreV1 rs(&opCtx, "test.foo", md, &em, false);
+
+    {
+        LocAndSize recs[] = {{DiskLoc(0, 1000), 100},
+                             {DiskLoc(0, 1100), 100},
+                             {DiskLoc(1, 1000), 100},
+                             {DiskLoc(2, 1000), 100},
+                             {DiskLoc(2, 1100), 100},
+                             {}};
+        LocAndSize drecs[] = {{}};
+        initializeV1RS(&opCtx, recs, drecs, NULL, &em, md);
+    }
+
+    // Each extent is read ahead once, when the scan enters the extent before it.
+    auto cursor = rs.getCursor(&opCtx, true);
+    int count = 0;
+    while (cursor->next()) {
+        count++;
+    }
+    ASSERT_EQUALS(5, count);
+    ASSERT_EQUALS(2U, em.readAheadExtents.size());
+    ASSERT_EQUALS(DiskLoc(1, 0), em.readAheadExtents[0]);
+    ASSERT_EQUALS(DiskLoc(2, 0), em.readAheadExtents[1]);
+
+    em.readAheadExtents.clear();
+    cursor = rs.getCursor(&opCtx, false);
+    while (cursor->next()) {
+    }
+    ASSERT_EQUALS(2U, em.readAheadExtents.size());
+    ASSERT_EQUALS(DiskLoc(1, 0), em.readAheadExtents[0]);
+    ASSERT_EQUALS(DiskLoc(0, 0), em.readAheadExtents[1]);
+}
 }
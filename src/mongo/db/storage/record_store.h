@@ -314,6 +314,14 @@ public:
 
     virtual bool isCapped() const = 0;
 
+    /**
+     * Returns true if the RecordId of each record is derived from the _id of the document it holds
+     * (see clustered_key.h) rather than assigned by the RecordStore.
+     */
+    virtual bool isClustered() const {
+        return false;
+    }
+
     virtual void setCappedCallback(CappedCallback*) {
         invariant(false);
     }
@@ -569,6 +577,18 @@ public:
                                    BSONObjBuilder* result,
                                    double scale) const = 0;
 
+    /**
+     * Appends how much of this RecordStore is resident in the storage engine's cache and how much
+     * has been read into and evicted from it. Unlike appendCustomStats, this must be cheap enough
+     * to sample periodically.
+     *
+     * Returns false, appending nothing, if the storage engine does not track its cache per
+     * RecordStore.
+     */
+    virtual bool appendCacheStats(OperationContext* opCtx, BSONObjBuilder* result) const {
+        return false;
+    }
+
     /**
      * Load all data into cache.
      * What cache depends on implementation.
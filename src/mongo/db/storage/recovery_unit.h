@@ -123,6 +123,35 @@ public:
         return {};
     }
 
+    /**
+     * Tells the recovery unit that, where it would normally read the latest data, it should
+     * instead read from the most recently created named snapshot. Snapshots are only created
+     * between batches of secondary oplog application, so such reads see a consistent state without
+     * needing to be serialized against the batch currently being applied.
+     *
+     * Must be called before the recovery unit starts reading, and cannot be combined with
+     * setReadFromMajorityCommittedSnapshot(). Returns a status with error code
+     * SnapshotUnavailable if there is no snapshot to read from yet.
+     *
+     * StorageEngines that don't support a SnapshotManager should use the default
+     * implementation.
+     */
+    virtual Status setReadFromLastAppliedSnapshot() {
+        return {ErrorCodes::CommandNotSupported,
+                "Current storage engine does not support reading from applied snapshots"};
+    }
+
+    /**
+     * Returns the SnapshotName being used by this recovery unit or boost::none if not reading from
+     * the last applied snapshot.
+     *
+     * As with majority committed snapshots, reads may occur from later snapshots, but not from
+     * earlier ones.
+     */
+    virtual boost::optional<SnapshotName> getLastAppliedSnapshot() const {
+        return {};
+    }
+
     /**
      * Gets the local SnapshotId.
      *
@@ -29,11 +29,14 @@
 #include <boost/optional/optional.hpp>
 #include <boost/optional/optional_io.hpp>
 #include <memory>
+#include <vector>
 
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/record_id.h"
 #include "mongo/db/storage/index_entry_comparison.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/util/assert_util.h"
 
 #pragma once
 
@@ -101,6 +104,28 @@ public:
                           const RecordId& loc,
                           bool dupsAllowed) = 0;
 
+    /**
+     * Insert each of the entries in 'entries', in order, as if by calling insert() on each of
+     * them. Every entry is attempted regardless of the outcome of the others, and the result of
+     * each is stored at the same position of 'statusesOut', which is resized to match 'entries'.
+     *
+     * Callers with many keys to insert at once should sort them in index order first, so that an
+     * implementation can perform the inserts as a sequence of monotonic writes.
+     *
+     * The default implementation simply calls insert() on each entry. Implementations which pay
+     * a per-call cost for insert(), such as positioning a new cursor, should override it.
+     */
+    virtual void insertKeys(OperationContext* opCtx,
+                            const std::vector<IndexKeyEntry>& entries,
+                            bool dupsAllowed,
+                            std::vector<Status>* statusesOut) {
+        statusesOut->clear();
+        statusesOut->reserve(entries.size());
+        for (const auto& entry : entries) {
+            statusesOut->push_back(insert(opCtx, entry.key, entry.loc, dupsAllowed));
+        }
+    }
+
     /**
      * Remove the entry from the index with the specified key and RecordId.
      *
@@ -148,6 +173,17 @@ public:
                                    BSONObjBuilder* output,
                                    double scale) const = 0;
 
+    /**
+     * Appends how much of this index is resident in the storage engine's cache and how much has
+     * been read into and evicted from it. Returns false, appending nothing, if the storage engine
+     * does not track its cache per index.
+     *
+     * @see RecordStore::appendCacheStats
+     */
+    virtual bool appendCacheStats(OperationContext* opCtx, BSONObjBuilder* output) const {
+        return false;
+    }
+
 
     /**
      * Return the number of bytes consumed by 'this' index.
@@ -300,6 +336,29 @@ public:
             return {};
         }
 
+        //
+        // Deferred key decoding
+        //
+
+        /**
+         * Returns true if this cursor implements deferredKey(), in which case callers that may
+         * not need the key of an entry can request only kWantLoc and decode the key later.
+         */
+        virtual bool supportsDeferredKeys() const {
+            return false;
+        }
+
+        /**
+         * Returns a function producing the key of the entry most recently returned by next() or
+         * seek(), which must have returned an entry. The returned function holds a copy of the
+         * encoded key, so it remains valid after this cursor moves, is saved, or is destroyed.
+         *
+         * Only valid if supportsDeferredKeys() returns true.
+         */
+        virtual stdx::function<BSONObj()> deferredKey() const {
+            MONGO_UNREACHABLE;
+        }
+
         //
         // Saving and restoring state
         //
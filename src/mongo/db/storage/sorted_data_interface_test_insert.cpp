@@ -31,6 +31,7 @@
 #include "mongo/db/storage/sorted_data_interface_test_harness.h"
 
 #include <memory>
+#include <vector>
 
 #include "mongo/db/storage/sorted_data_interface.h"
 #include "mongo/unittest/unittest.h"
@@ -213,6 +214,40 @@ TEST(SortedDataInterface, InsertSameKey) {
     }
 }
 
+// Insert a batch of keys, one of which duplicates another, into a unique index and verify that
+// every entry is attempted and only the duplicate fails.
+TEST(SortedDataInterface, InsertKeysReportsStatusOfEachEntry) {
+    const auto harnessHelper(newSortedDataInterfaceHarnessHelper());
+    const std::unique_ptr<SortedDataInterface> sorted(harnessHelper->newSortedDataInterface(true));
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT(sorted->isEmpty(opCtx.get()));
+    }
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        {
+            WriteUnitOfWork uow(opCtx.get());
+            std::vector<IndexKeyEntry> entries = {
+                {key1, loc1}, {key2, loc2}, {key2, loc3}, {key3, loc3}};
+            std::vector<Status> statuses;
+            sorted->insertKeys(opCtx.get(), entries, false, &statuses);
+            ASSERT_EQUALS(entries.size(), statuses.size());
+            ASSERT_OK(statuses[0]);
+            ASSERT_OK(statuses[1]);
+            ASSERT_NOT_OK(statuses[2]);
+            ASSERT_OK(statuses[3]);
+            uow.commit();
+        }
+    }
+
+    {
+        const ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQUALS(3, sorted->numEntries(opCtx.get()));
+    }
+}
+
 namespace {
 
 // Insert the same key multiple times and verify that all entries exists
@@ -39,6 +39,7 @@
 
 namespace mongo {
 
+class BSONObjBuilder;
 class DatabaseCatalogEntry;
 class JournalListener;
 class OperationContext;
@@ -194,6 +195,14 @@ public:
         return false;
     }
 
+    /**
+     * Returns whether collections can be created with the 'clustered' option, which makes the
+     * RecordId of each document derived from its _id.
+     */
+    virtual bool supportsClusteredCollections() const {
+        return false;
+    }
+
     /**
      * Closes all file handles associated with a database.
      */
@@ -280,6 +289,12 @@ public:
      */
     virtual void setJournalListener(JournalListener* jl) = 0;
 
+    /**
+     * Appends how long the phases of opening this storage engine took, for reporting in
+     * serverStatus. Storage engines which do not track this append nothing.
+     */
+    virtual void appendStartupStats(BSONObjBuilder* builder) const {}
+
 protected:
     /**
      * The destructor will never be called. See cleanShutdown instead.
@@ -55,12 +55,18 @@ public:
     virtual BSONObj generateSection(OperationContext* opCtx,
                                     const BSONElement& configElement) const {
         auto engine = opCtx->getClient()->getServiceContext()->getGlobalStorageEngine();
-        return BSON("name" << storageGlobalParams.engine << "supportsCommittedReads"
-                           << bool(engine->getSnapshotManager())
-                           << "readOnly"
-                           << storageGlobalParams.readOnly
-                           << "persistent"
-                           << !engine->isEphemeral());
+        BSONObjBuilder bob;
+        bob.append("name", storageGlobalParams.engine);
+        bob.append("supportsCommittedReads", bool(engine->getSnapshotManager()));
+        bob.append("readOnly", storageGlobalParams.readOnly);
+        bob.append("persistent", !engine->isEphemeral());
+
+        BSONObjBuilder startup;
+        engine->appendStartupStats(&startup);
+        if (!startup.asTempObj().isEmpty()) {
+            bob.append("startup", startup.obj());
+        }
+        return bob.obj();
     }
 
 } storageSSS;
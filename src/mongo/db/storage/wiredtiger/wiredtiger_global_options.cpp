@@ -31,6 +31,7 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/base/status.h"
+#include "mongo/config.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/util/log.h"
@@ -77,6 +78,18 @@ Status WiredTigerGlobalOptions::add(moe::OptionSection* options) {
         .hidden();
 
     // WiredTiger collection options
+#ifdef MONGO_CONFIG_ZSTD
+    // "zstd-<level>" picks a zstd compression level, see WiredTigerZstdCompressor.
+    wiredTigerOptions
+        .addOptionChaining("storage.wiredTiger.collectionConfig.blockCompressor",
+                           "wiredTigerCollectionBlockCompressor",
+                           moe::String,
+                           "block compression algorithm for collection data "
+                           "[none|snappy|zlib|zstd|zstd-<level>]")
+        .format("(:?none)|(:?snappy)|(:?zlib)|(:?zstd(-[0-9]+)?)",
+                "(none/snappy/zlib/zstd/zstd-<level>)")
+        .setDefault(moe::Value(std::string("snappy")));
+#else
     wiredTigerOptions
         .addOptionChaining("storage.wiredTiger.collectionConfig.blockCompressor",
                            "wiredTigerCollectionBlockCompressor",
@@ -85,6 +98,7 @@ Status WiredTigerGlobalOptions::add(moe::OptionSection* options) {
                            "[none|snappy|zlib]")
         .format("(:?none)|(:?snappy)|(:?zlib)", "(none/snappy/zlib)")
         .setDefault(moe::Value(std::string("snappy")));
+#endif
     wiredTigerOptions
         .addOptionChaining("storage.wiredTiger.collectionConfig.configString",
                            "wiredTigerCollectionConfigString",
@@ -34,6 +34,7 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_index.h"
 
+#include <map>
 #include <set>
 
 #include "mongo/base/checked_cast.h"
@@ -50,6 +51,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/hex.h"
@@ -78,6 +80,10 @@ MONGO_FP_DECLARE(WTEmulateOutOfOrderNextIndexKey);
 using std::string;
 using std::vector;
 
+// The number of open prefixed indexes on each shared table, which split the size of the table.
+stdx::mutex groupedIndexCountsMutex;
+std::map<std::string, int> groupedIndexCounts;
+
 static const int TempKeyMaxSize = 1024;  // this goes away with SERVER-3372
 
 static const WiredTigerItem emptyItem(NULL, 0);
@@ -88,6 +94,11 @@ static const int kKeyStringV1Version = 8;
 static const int kMinimumIndexVersion = kKeyStringV0Version;
 static const int kMaximumIndexVersion = kKeyStringV1Version;
 
+// Sizing of the in-memory chunk used by indexes created with the 'writeBuffer' option, and how
+// many on-disk chunks accumulate before they are merged.
+static const int kWriteBufferChunkSizeMB = 20;
+static const int kWriteBufferMergeMin = 4;
+
 bool hasFieldNames(const BSONObj& obj) {
     BSONForEach(e, obj) {
         if (e.fieldName()[0])
@@ -145,6 +156,20 @@ StatusWith<std::string> WiredTigerIndex::parseIndexOptions(const BSONObj& option
                 return status;
             }
             ss << elem.valueStringData() << ',';
+        } else if (elem.fieldNameStringData() == "writeBuffer") {
+            if (!elem.isBoolean()) {
+                return {ErrorCodes::TypeMismatch,
+                        str::stream() << "'writeBuffer' must be a boolean, not "
+                                      << typeName(elem.type())};
+            }
+            // Buffer writes in an in-memory LSM chunk that WiredTiger merges into on-disk trees in
+            // key order. This keeps scattered inserts into random-key indexes (UUIDs, hashes) from
+            // dirtying a different B-tree page for every key. Updates to the chunk are journaled
+            // like any other table write, and cursors see a merged view of the chunk and trees.
+            if (elem.boolean()) {
+                ss << "type=lsm,lsm=(chunk_size=" << kWriteBufferChunkSizeMB
+                   << "MB,bloom=true,merge_min=" << kWriteBufferMergeMin << "),";
+            }
         } else {
             // Return error on first unrecognized field.
             return StatusWith<std::string>(ErrorCodes::InvalidOptions,
@@ -257,6 +282,22 @@ WiredTigerIndex::WiredTigerIndex(OperationContext* ctx,
     }
     _keyStringVersion =
         version.getValue() == kKeyStringV1Version ? KeyString::Version::V1 : KeyString::Version::V0;
+
+    if (_prefix.isPrefixed()) {
+        stdx::lock_guard<stdx::mutex> lk(groupedIndexCountsMutex);
+        ++groupedIndexCounts[_uri];
+    }
+}
+
+WiredTigerIndex::~WiredTigerIndex() {
+    if (_prefix.isPrefixed()) {
+        stdx::lock_guard<stdx::mutex> lk(groupedIndexCountsMutex);
+        auto it = groupedIndexCounts.find(_uri);
+        invariant(it != groupedIndexCounts.end());
+        if (--it->second == 0) {
+            groupedIndexCounts.erase(it);
+        }
+    }
 }
 
 Status WiredTigerIndex::insert(OperationContext* opCtx,
@@ -277,6 +318,31 @@ Status WiredTigerIndex::insert(OperationContext* opCtx,
     return _insert(c, key, id, dupsAllowed);
 }
 
+void WiredTigerIndex::insertKeys(OperationContext* opCtx,
+                                 const std::vector<IndexKeyEntry>& entries,
+                                 bool dupsAllowed,
+                                 std::vector<Status>* statusesOut) {
+    statusesOut->clear();
+    statusesOut->reserve(entries.size());
+    if (entries.empty()) {
+        return;
+    }
+
+    // All of the inserts share a single cursor, rather than taking one from the session's cursor
+    // cache for each key.
+    WiredTigerCursor curwrap(_uri, _tableId, false, opCtx);
+    curwrap.assertInActiveTxn();
+    WT_CURSOR* c = curwrap.get();
+
+    for (const auto& entry : entries) {
+        invariant(entry.loc.isNormal());
+        dassert(!hasFieldNames(entry.key));
+
+        Status s = checkKeySize(entry.key);
+        statusesOut->push_back(s.isOK() ? _insert(c, entry.key, entry.loc, dupsAllowed) : s);
+    }
+}
+
 void WiredTigerIndex::unindex(OperationContext* opCtx,
                               const BSONObj& key,
                               const RecordId& id,
@@ -370,6 +436,17 @@ bool WiredTigerIndex::appendCustomStats(OperationContext* opCtx,
     return true;
 }
 
+bool WiredTigerIndex::appendCacheStats(OperationContext* opCtx, BSONObjBuilder* output) const {
+    WT_SESSION* s = WiredTigerRecoveryUnit::get(opCtx)->getSession(opCtx)->getSession();
+    Status status = WiredTigerUtil::appendCacheStats(s, uri(), output);
+    if (!status.isOK()) {
+        output->append("error", "unable to retrieve cache statistics");
+        output->append("code", static_cast<int>(status.code()));
+        output->append("reason", status.reason());
+    }
+    return true;
+}
+
 Status WiredTigerIndex::dupKeyCheck(OperationContext* opCtx,
                                     const BSONObj& key,
                                     const RecordId& id) {
@@ -414,6 +491,20 @@ Status WiredTigerIndex::touch(OperationContext* opCtx) const {
 
 
 long long WiredTigerIndex::getSpaceUsedBytes(OperationContext* opCtx) const {
+    const long long tableBytes = _getTableSpaceUsedBytes(opCtx);
+    if (!_prefix.isPrefixed()) {
+        return tableBytes;
+    }
+
+    // The table is shared with the other grouped indexes of the same version. Without a cheap way
+    // to measure the keys of one prefix, split its size evenly between the indexes using it.
+    stdx::lock_guard<stdx::mutex> lk(groupedIndexCountsMutex);
+    auto it = groupedIndexCounts.find(_uri);
+    invariant(it != groupedIndexCounts.end());
+    return tableBytes / it->second;
+}
+
+long long WiredTigerIndex::_getTableSpaceUsedBytes(OperationContext* opCtx) const {
     auto ru = WiredTigerRecoveryUnit::get(opCtx);
     WiredTigerSession* session = ru->getSession(opCtx);
 
@@ -722,6 +813,22 @@ public:
         return curr(parts);
     }
 
+    bool supportsDeferredKeys() const override {
+        return true;
+    }
+
+    stdx::function<BSONObj()> deferredKey() const override {
+        invariant(!_eof);
+
+        // KeyString::toBson() ignores the RecordId appended to keys in standard indexes.
+        std::string key(_key.getBuffer(), _key.getSize());
+        KeyString::TypeBits typeBits = _typeBits;
+        Ordering ordering = _idx.ordering();
+        return [ key = std::move(key), typeBits, ordering ] {
+            return KeyString::toBson(key.data(), key.size(), ordering, typeBits);
+        };
+    }
+
     void setEndPosition(const BSONObj& key, bool inclusive) override {
         TRACE_CURSOR << "setEndPosition inclusive: " << inclusive << ' ' << key;
         if (key.isEmpty()) {
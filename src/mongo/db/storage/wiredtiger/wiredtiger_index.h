@@ -81,11 +81,18 @@ public:
                     const IndexDescriptor* desc,
                     KVPrefix prefix);
 
+    virtual ~WiredTigerIndex();
+
     virtual Status insert(OperationContext* opCtx,
                           const BSONObj& key,
                           const RecordId& id,
                           bool dupsAllowed);
 
+    virtual void insertKeys(OperationContext* opCtx,
+                            const std::vector<IndexKeyEntry>& entries,
+                            bool dupsAllowed,
+                            std::vector<Status>* statusesOut);
+
     virtual void unindex(OperationContext* opCtx,
                          const BSONObj& key,
                          const RecordId& id,
@@ -97,6 +104,7 @@ public:
     virtual bool appendCustomStats(OperationContext* opCtx,
                                    BSONObjBuilder* output,
                                    double scale) const;
+    virtual bool appendCacheStats(OperationContext* opCtx, BSONObjBuilder* output) const;
     virtual Status dupKeyCheck(OperationContext* opCtx, const BSONObj& key, const RecordId& id);
 
     virtual bool isEmpty(OperationContext* opCtx);
@@ -149,6 +157,9 @@ protected:
 
     void setKey(WT_CURSOR* cursor, const WT_ITEM* item);
 
+    // Returns the space used by the whole table, which prefixed indexes share.
+    long long _getTableSpaceUsedBytes(OperationContext* opCtx) const;
+
     class BulkBuilder;
     class StandardBulkBuilder;
     class UniqueBulkBuilder;
@@ -94,5 +94,24 @@ TEST(WiredTigerIndexTest, GenerateCreateStringValidConfigStringOption) {
     ASSERT_EQ(WiredTigerIndex::parseIndexOptions(spec), std::string("prefix_compression=true,"));
 }
 
+TEST(WiredTigerIndexTest, GenerateCreateStringWriteBuffer) {
+    BSONObj spec = fromjson("{writeBuffer: true}");
+    StatusWith<std::string> result = WiredTigerIndex::parseIndexOptions(spec);
+    ASSERT_OK(result.getStatus());
+    ASSERT_NOT_EQUALS(result.getValue().find("type=lsm,"), std::string::npos);
+    ASSERT_OK(WiredTigerUtil::checkTableCreationOptions(
+        BSON("configString" << result.getValue()).firstElement()));
+}
+
+TEST(WiredTigerIndexTest, GenerateCreateStringWriteBufferDisabled) {
+    BSONObj spec = fromjson("{writeBuffer: false}");
+    ASSERT_EQ(WiredTigerIndex::parseIndexOptions(spec), std::string(""));
+}
+
+TEST(WiredTigerIndexTest, GenerateCreateStringNonBooleanWriteBuffer) {
+    BSONObj spec = fromjson("{writeBuffer: 1}");
+    ASSERT_EQ(WiredTigerIndex::parseIndexOptions(spec), ErrorCodes::TypeMismatch);
+}
+
 }  // namespace
 }  // namespace mongo
@@ -45,6 +45,7 @@
 #include <boost/filesystem/operations.hpp>
 #include <valgrind/valgrind.h>
 
+#include "mongo/base/checked_cast.h"
 #include "mongo/base/error_codes.h"
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/bson/dotted_path_support.h"
@@ -56,6 +57,7 @@
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/stats/top.h"
 #include "mongo/db/storage/journal_listener.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
@@ -66,6 +68,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_ticket_tuner.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/background.h"
@@ -102,26 +105,23 @@ public:
 
         LOG(1) << "starting " << name() << " thread";
 
+        // Flushes whenever writers wait for the journal, batching all those waiting at the time,
+        // and at least every journalCommitIntervalMs.
         while (!_shuttingDown.load()) {
-            try {
-                _sessionCache->waitUntilDurable(false);
-            } catch (const UserException& e) {
-                invariant(e.getCode() == ErrorCodes::ShutdownInProgress);
-            }
-
             int ms = storageGlobalParams.journalCommitIntervalMs.load();
             if (!ms) {
                 ms = 100;
             }
 
             MONGO_IDLE_THREAD_BLOCK;
-            sleepmillis(ms);
+            _sessionCache->flushJournalForWaiters(Milliseconds(ms));
         }
         LOG(1) << "stopping " << name() << " thread";
     }
 
     void shutdown() {
         _shuttingDown.store(true);
+        _sessionCache->disableGroupCommit();
         wait();
     }
 
@@ -179,6 +179,63 @@ private:
 
 namespace {
 
+// How often the cached sizes of changed collections are written to the size storer table.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerSizeStorerPeriodMillis, int, 60 * 1000);
+
+}  // namespace
+
+class WiredTigerKVEngine::WiredTigerSizeStorerSyncer : public BackgroundJob {
+public:
+    explicit WiredTigerSizeStorerSyncer(const WiredTigerKVEngine* engine)
+        : BackgroundJob(false /* deleteSelf */), _engine(engine) {}
+
+    virtual string name() const {
+        return "WTSizeStorerSyncer";
+    }
+
+    virtual void run() {
+        Client::initThread(name().c_str());
+
+        LOG(1) << "starting " << name() << " thread";
+
+        while (true) {
+            {
+                stdx::unique_lock<stdx::mutex> lock(_mutex);
+                const int periodMillis = std::max(1, wiredTigerSizeStorerPeriodMillis.load());
+                MONGO_IDLE_THREAD_BLOCK;
+                _condvar.wait_for(lock, stdx::chrono::milliseconds(periodMillis), [this] {
+                    return _shuttingDown;
+                });
+                if (_shuttingDown) {
+                    break;
+                }
+            }
+
+            _engine->syncSizeInfo(false);
+        }
+        LOG(1) << "stopping " << name() << " thread";
+    }
+
+    void shutdown() {
+        {
+            stdx::lock_guard<stdx::mutex> lock(_mutex);
+            _shuttingDown = true;
+        }
+        _condvar.notify_one();
+        wait();
+    }
+
+private:
+    const WiredTigerKVEngine* _engine;
+
+    // _mutex/_condvar used to notify when _shuttingDown is flipped.
+    stdx::mutex _mutex;
+    stdx::condition_variable _condvar;
+    bool _shuttingDown = false;
+};
+
+namespace {
+
 class TicketServerParameter : public ServerParameter {
     MONGO_DISALLOW_COPYING(TicketServerParameter);
 
@@ -224,6 +281,197 @@ TicketHolder openReadTransaction(128);
 TicketServerParameter openReadTransactionParam(&openReadTransaction,
                                                "wiredTigerConcurrentReadTransactions");
 
+// Low priority operations need one of these tickets as well as a regular one, so they can only
+// hold as many of the regular tickets as there are of these.
+TicketHolder openLowPriorityWriteTransaction(32);
+TicketServerParameter openLowPriorityWriteTransactionParam(
+    &openLowPriorityWriteTransaction, "wiredTigerConcurrentLowPriorityWriteTransactions");
+
+TicketHolder openLowPriorityReadTransaction(32);
+TicketServerParameter openLowPriorityReadTransactionParam(
+    &openLowPriorityReadTransaction, "wiredTigerConcurrentLowPriorityReadTransactions");
+
+// When enabled, the numbers of concurrent read and write transactions are adjusted once per
+// period, within the bounds, by a WiredTigerTicketTuner.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerTicketTunerEnabled, bool, false);
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerTicketTunerPeriodMillis, int, 1000);
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerTicketTunerMinTickets, int, 16);
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerTicketTunerMaxTickets, int, 256);
+
+// Number of changes made by the tuner, by kind of ticket and cause. Reported in serverStatus, so
+// that its decisions are recorded by FTDC.
+struct TicketTunerStats {
+    AtomicInt64 increases;
+    AtomicInt64 decreases;
+    AtomicInt64 cachePressureDecreases;
+
+    void append(BSONObjBuilder* builder) const {
+        BSONObjBuilder tunerBuilder(builder->subobjStart("tuner"));
+        tunerBuilder.append("increases", increases.load());
+        tunerBuilder.append("decreases", decreases.load());
+        tunerBuilder.append("cachePressureDecreases", cachePressureDecreases.load());
+        tunerBuilder.done();
+    }
+};
+
+TicketTunerStats writeTicketTunerStats;
+TicketTunerStats readTicketTunerStats;
+
+}  // namespace
+
+class WiredTigerKVEngine::WiredTigerTicketTunerThread : public BackgroundJob {
+public:
+    explicit WiredTigerTicketTunerThread(WT_CONNECTION* conn)
+        : BackgroundJob(false /* deleteSelf */), _conn(conn) {}
+
+    virtual string name() const {
+        return "WTTicketTuner";
+    }
+
+    virtual void run() {
+        Client::initThread(name().c_str());
+
+        LOG(1) << "starting " << name() << " thread";
+
+        WiredTigerSession session(_conn);
+        BSONObj previousLatencies = _getLatencies();
+        while (true) {
+            {
+                stdx::unique_lock<stdx::mutex> lock(_mutex);
+                const int periodMillis = std::max(1, wiredTigerTicketTunerPeriodMillis.load());
+                MONGO_IDLE_THREAD_BLOCK;
+                _condvar.wait_for(lock, stdx::chrono::milliseconds(periodMillis), [this] {
+                    return _shuttingDown;
+                });
+                if (_shuttingDown) {
+                    break;
+                }
+            }
+
+            BSONObj latencies = _getLatencies();
+            if (wiredTigerTicketTunerEnabled.load()) {
+                WiredTigerTicketTuner::Sample sample;
+                _getCacheRatios(session.getSession(), &sample);
+                _tune(&_writeTuner,
+                      &openWriteTransaction,
+                      &writeTicketTunerStats,
+                      "write",
+                      _getSample(latencies["writes"], previousLatencies["writes"], sample));
+                _tune(&_readTuner,
+                      &openReadTransaction,
+                      &readTicketTunerStats,
+                      "read",
+                      _getSample(latencies["reads"], previousLatencies["reads"], sample));
+            } else {
+                // Start from scratch once enabled, as the ticket counts may be changed meanwhile.
+                _writeTuner = WiredTigerTicketTuner();
+                _readTuner = WiredTigerTicketTuner();
+            }
+            previousLatencies = std::move(latencies);
+        }
+        LOG(1) << "stopping " << name() << " thread";
+    }
+
+    void shutdown() {
+        {
+            stdx::lock_guard<stdx::mutex> lock(_mutex);
+            _shuttingDown = true;
+        }
+        _condvar.notify_one();
+        wait();
+    }
+
+private:
+    static BSONObj _getLatencies() {
+        BSONObjBuilder builder;
+        Top::get(getGlobalServiceContext()).appendGlobalLatencyStats(false, &builder);
+        return builder.obj();
+    }
+
+    /**
+     * Returns 'cacheState' with the number of operations completed, and their total latency,
+     * between the 'previous' and 'latest' totals of a kind of operation.
+     */
+    static WiredTigerTicketTuner::Sample _getSample(const BSONElement& latest,
+                                                    const BSONElement& previous,
+                                                    WiredTigerTicketTuner::Sample cacheState) {
+        cacheState.ops = latest["ops"].safeNumberLong() - previous["ops"].safeNumberLong();
+        cacheState.latencyMicros =
+            latest["latency"].safeNumberLong() - previous["latency"].safeNumberLong();
+        return cacheState;
+    }
+
+    static void _getCacheRatios(WT_SESSION* session, WiredTigerTicketTuner::Sample* sample) {
+        auto getStat = [session](int key) {
+            auto result = WiredTigerUtil::getStatisticsValueAs<int64_t>(
+                session, "statistics:", "statistics=(fast)", key);
+            return result.isOK() ? result.getValue() : 0;
+        };
+        const int64_t maxBytes = getStat(WT_STAT_CONN_CACHE_BYTES_MAX);
+        if (maxBytes <= 0) {
+            return;
+        }
+        sample->cacheUsedRatio =
+            static_cast<double>(getStat(WT_STAT_CONN_CACHE_BYTES_INUSE)) / maxBytes;
+        sample->cacheDirtyRatio =
+            static_cast<double>(getStat(WT_STAT_CONN_CACHE_BYTES_DIRTY)) / maxBytes;
+    }
+
+    static void _tune(WiredTigerTicketTuner* tuner,
+                      TicketHolder* holder,
+                      TicketTunerStats* stats,
+                      StringData kind,
+                      const WiredTigerTicketTuner::Sample& sample) {
+        // TicketHolder::resize() refuses fewer than 5 tickets.
+        const int minTickets = std::max(5, wiredTigerTicketTunerMinTickets.load());
+        const int maxTickets = std::max(minTickets, wiredTigerTicketTunerMaxTickets.load());
+        const int currentTickets = holder->outof();
+
+        WiredTigerTicketTuner::Decision decision;
+        const int newTickets =
+            tuner->nextTicketCount(sample, currentTickets, minTickets, maxTickets, &decision);
+        if (newTickets == currentTickets) {
+            return;
+        }
+        Status status = holder->resize(newTickets);
+        if (!status.isOK()) {
+            warning() << "Failed to change the number of concurrent " << kind
+                      << " transactions to " << newTickets << ": " << status;
+            return;
+        }
+
+        switch (decision) {
+            case WiredTigerTicketTuner::Decision::kIncrease:
+                stats->increases.fetchAndAdd(1);
+                break;
+            case WiredTigerTicketTuner::Decision::kDecrease:
+                stats->decreases.fetchAndAdd(1);
+                break;
+            case WiredTigerTicketTuner::Decision::kCachePressureDecrease:
+                stats->cachePressureDecreases.fetchAndAdd(1);
+                break;
+            case WiredTigerTicketTuner::Decision::kUnchanged:
+                break;
+        }
+        LOG(1) << "Changed the number of concurrent " << kind << " transactions from "
+               << currentTickets << " to " << newTickets << " after " << sample.ops
+               << " operations, cache used " << sample.cacheUsedRatio << ", dirty "
+               << sample.cacheDirtyRatio;
+    }
+
+    WT_CONNECTION* _conn;
+
+    WiredTigerTicketTuner _writeTuner;
+    WiredTigerTicketTuner _readTuner;
+
+    // _mutex/_condvar used to notify when _shuttingDown is flipped.
+    stdx::mutex _mutex;
+    stdx::condition_variable _condvar;
+    bool _shuttingDown = false;
+};
+
+namespace {
+
 stdx::function<bool(StringData)> initRsOplogBackgroundThreadCallback = [](StringData) -> bool {
     fassertFailed(40358);
 };
@@ -241,7 +489,6 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
     : _eventHandler(WiredTigerUtil::defaultEventHandlers()),
       _canonicalName(canonicalName),
       _path(path),
-      _sizeStorerSyncTracker(cs, 100000, Seconds(60)),
       _durable(durable),
       _ephemeral(ephemeral),
       _readOnly(readOnly) {
@@ -329,6 +576,7 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
 
     if (_durable && !_ephemeral) {
         _journalFlusher = stdx::make_unique<WiredTigerJournalFlusher>(_sessionCache.get());
+        _sessionCache->enableGroupCommit();
         _journalFlusher->go();
     }
 
@@ -346,7 +594,19 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
     _sizeStorer.reset(new WiredTigerSizeStorer(_conn, _sizeStorerUri));
     _sizeStorer->fillCache();
 
+    if (!_readOnly) {
+        _sizeStorerSyncer = stdx::make_unique<WiredTigerSizeStorerSyncer>(this);
+        _sizeStorerSyncer->go();
+    }
+
     Locker::setGlobalThrottling(&openReadTransaction, &openWriteTransaction);
+    Locker::setLowPriorityThrottling(&openLowPriorityReadTransaction,
+                                     &openLowPriorityWriteTransaction);
+
+    if (!_readOnly && !_ephemeral) {
+        _ticketTunerThread = stdx::make_unique<WiredTigerTicketTunerThread>(_conn);
+        _ticketTunerThread->go();
+    }
 }
 
 
@@ -365,6 +625,7 @@ void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
         bbb.append("out", openWriteTransaction.used());
         bbb.append("available", openWriteTransaction.available());
         bbb.append("totalTickets", openWriteTransaction.outof());
+        writeTicketTunerStats.append(&bbb);
         bbb.done();
     }
     {
@@ -372,13 +633,36 @@ void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
         bbb.append("out", openReadTransaction.used());
         bbb.append("available", openReadTransaction.available());
         bbb.append("totalTickets", openReadTransaction.outof());
+        readTicketTunerStats.append(&bbb);
+        bbb.done();
+    }
+    {
+        BSONObjBuilder bbb(bb.subobjStart("lowPriorityWrite"));
+        bbb.append("out", openLowPriorityWriteTransaction.used());
+        bbb.append("available", openLowPriorityWriteTransaction.available());
+        bbb.append("totalTickets", openLowPriorityWriteTransaction.outof());
+        bbb.done();
+    }
+    {
+        BSONObjBuilder bbb(bb.subobjStart("lowPriorityRead"));
+        bbb.append("out", openLowPriorityReadTransaction.used());
+        bbb.append("available", openLowPriorityReadTransaction.available());
+        bbb.append("totalTickets", openLowPriorityReadTransaction.outof());
         bbb.done();
     }
     bb.done();
+
+    WiredTigerRecoveryUnit::appendGlobalStats(b);
+    WiredTigerSizeStorer::appendGlobalStats(b);
+    WiredTigerSessionCache::appendGlobalStats(b);
 }
 
 void WiredTigerKVEngine::cleanShutdown() {
     log() << "WiredTigerKVEngine shutting down";
+    if (_ticketTunerThread)
+        _ticketTunerThread->shutdown();
+    if (_sizeStorerSyncer)
+        _sizeStorerSyncer->shutdown();
     if (!_readOnly)
         syncSizeInfo(true);
     if (_conn) {
@@ -417,8 +701,8 @@ Status WiredTigerKVEngine::okToRename(OperationContext* opCtx,
                                       StringData toNS,
                                       StringData ident,
                                       const RecordStore* originalRecordStore) const {
-    _sizeStorer->storeToCache(
-        _uri(ident), originalRecordStore->numRecords(opCtx), originalRecordStore->dataSize(opCtx));
+    const auto rs = checked_cast<const WiredTigerRecordStore*>(originalRecordStore);
+    _sizeStorer->storeToCache(rs->getSizeStorerURI(), rs->numRecords(opCtx), rs->dataSize(opCtx));
     syncSizeInfo(true);
     return Status::OK();
 }
@@ -633,6 +917,46 @@ Status WiredTigerKVEngine::dropIdent(OperationContext* opCtx, StringData ident)
     return Status::OK();
 }
 
+Status WiredTigerKVEngine::dropGroupedIdent(OperationContext* opCtx,
+                                            StringData ident,
+                                            KVPrefix prefix) {
+    invariant(prefix.isPrefixed());
+    const string uri = _uri(ident);
+
+    WiredTigerSession session(_conn);
+    WT_SESSION* s = session.getSession();
+
+    WT_CURSOR* start;
+    int ret = s->open_cursor(s, uri.c_str(), NULL, NULL, &start);
+    if (ret == ENOENT) {
+        return Status::OK();
+    }
+    invariantWTOK(ret);
+    WT_CURSOR* stop;
+    invariantWTOK(s->open_cursor(s, uri.c_str(), NULL, NULL, &stop));
+
+    // Record stores are keyed by (prefix, RecordId) and indexes by (prefix, KeyString). Index
+    // keys are never empty, so (prefix + 1, "") sorts after every key of 'prefix' and before
+    // those of the next prefix. Truncate positions both ends on existing keys itself.
+    if (StringData(start->key_format) == "qq") {
+        start->set_key(start, prefix.repr(), RecordId::min().repr());
+        stop->set_key(stop, prefix.repr(), RecordId::max().repr());
+    } else {
+        invariant(StringData(start->key_format) == "qu");
+        WiredTigerItem empty("", 0);
+        start->set_key(start, prefix.repr(), empty.Get());
+        stop->set_key(stop, prefix.repr() + 1, empty.Get());
+    }
+
+    ret = s->truncate(s, NULL, start, stop, NULL);
+    LOG(1) << "WT truncate of " << uri << " prefix " << prefix.repr() << " res " << ret;
+
+    if (_sizeStorer) {
+        _sizeStorer->clearFromCache(WiredTigerSizeStorer::prefixedUri(uri, prefix.repr()));
+    }
+    return wtRCToStatus(ret);
+}
+
 bool WiredTigerKVEngine::_drop(StringData ident) {
     string uri = _uri(ident);
 
@@ -665,11 +989,6 @@ bool WiredTigerKVEngine::haveDropsQueued() const {
     Date_t now = Date_t::now();
     Milliseconds delta = now - _previousCheckedDropsQueued;
 
-    if (!_readOnly && _sizeStorerSyncTracker.intervalHasElapsed()) {
-        _sizeStorerSyncTracker.resetLastTime();
-        syncSizeInfo(false);
-    }
-
     // We only want to check the queue max once per second or we'll thrash
     // This is done in haveDropsQueued, not dropSomeQueuedIdents so we skip the mutex
     if (delta < Milliseconds(1000))
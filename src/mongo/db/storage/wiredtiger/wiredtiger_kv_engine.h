@@ -42,7 +42,6 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/stdx/mutex.h"
-#include "mongo/util/elapsed_tracker.h"
 
 namespace mongo {
 
@@ -72,6 +71,10 @@ public:
 
     virtual bool supportsDirectoryPerDB() const;
 
+    bool supportsClusteredCollections() const override {
+        return true;
+    }
+
     virtual bool isDurable() const {
         return _durable;
     }
@@ -132,6 +135,8 @@ public:
 
     virtual Status dropIdent(OperationContext* opCtx, StringData ident);
 
+    virtual Status dropGroupedIdent(OperationContext* opCtx, StringData ident, KVPrefix prefix);
+
     virtual Status okToRename(OperationContext* opCtx,
                               StringData fromNS,
                               StringData toNS,
@@ -193,6 +198,8 @@ public:
 private:
     class WiredTigerJournalFlusher;
     class WiredTigerCheckpointThread;
+    class WiredTigerSizeStorerSyncer;
+    class WiredTigerTicketTunerThread;
 
     Status _salvageIfNeeded(const char* uri);
     void _checkIdentPath(StringData ident);
@@ -210,13 +217,14 @@ private:
 
     std::unique_ptr<WiredTigerSizeStorer> _sizeStorer;
     std::string _sizeStorerUri;
-    mutable ElapsedTracker _sizeStorerSyncTracker;
 
     bool _durable;
     bool _ephemeral;
     bool _readOnly;
     std::unique_ptr<WiredTigerJournalFlusher> _journalFlusher;  // Depends on _sizeStorer
     std::unique_ptr<WiredTigerCheckpointThread> _checkpointThread;
+    std::unique_ptr<WiredTigerSizeStorerSyncer> _sizeStorerSyncer;  // Depends on _sizeStorer
+    std::unique_ptr<WiredTigerTicketTunerThread> _ticketTunerThread;
 
     std::string _rsOptions;
     std::string _indexOptions;
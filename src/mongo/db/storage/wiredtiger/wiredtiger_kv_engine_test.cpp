@@ -33,12 +33,23 @@
 
 #include "mongo/db/storage/kv/kv_engine_test_harness.h"
 
+#include <vector>
+
 #include "mongo/base/init.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/catalog/collection_options.h"
+#include "mongo/db/operation_context_noop.h"
+#include "mongo/db/storage/kv/kv_prefix.h"
+#include "mongo/db/storage/recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
 #include "mongo/util/clock_source_mock.h"
+#include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
 namespace {
@@ -80,5 +91,88 @@ MONGO_INITIALIZER(RegisterKVHarnessFactory)(InitializerContext*) {
     return Status::OK();
 }
 
+BSONObj getGroupCommitStats() {
+    BSONObjBuilder builder;
+    WiredTigerSessionCache::appendGlobalStats(builder);
+    return builder.obj()["journalGroupCommit"].Obj().getOwned();
+}
+
+TEST(WiredTigerKVEngineTest, ConcurrentJournalWaitersAreServedByTheJournalFlusher) {
+    ClockSourceMock cs;
+    unittest::TempDir dbpath("wt-kv-group-commit");
+    WiredTigerKVEngine engine(
+        kWiredTigerEngineName, dbpath.path(), &cs, "", 1, true, false, false, false);
+
+    const BSONObj before = getGroupCommitStats();
+
+    const int kNumWaiters = 8;
+    std::vector<stdx::thread> waiters;
+    for (int i = 0; i < kNumWaiters; ++i) {
+        waiters.emplace_back([&engine] {
+            std::unique_ptr<RecoveryUnit> ru(engine.newRecoveryUnit());
+            ru->waitUntilDurable();
+        });
+    }
+    for (auto& waiter : waiters) {
+        waiter.join();
+    }
+
+    const BSONObj after = getGroupCommitStats();
+    ASSERT_EQ(kNumWaiters, after["waiters"].numberLong() - before["waiters"].numberLong());
+    ASSERT_GTE(after["flushes"].numberLong() - before["flushes"].numberLong(), 1);
+    ASSERT_GTE(after["maxBatchSize"].numberLong(), 1);
+}
+
+TEST(WiredTigerKVEngineTest, GroupedRecordStoresOnlyRemoveTheirOwnRecords) {
+    WiredTigerKVHarnessHelper helper;
+    KVEngine* engine = helper.getEngine();
+
+    const std::string ident = "collection-group-0";
+    const KVPrefix prefixes[] = {KVPrefix::generateNextPrefix(),
+                                 KVPrefix::generateNextPrefix(),
+                                 KVPrefix::generateNextPrefix()};
+    std::vector<std::unique_ptr<RecordStore>> rss;
+    for (size_t i = 0; i < 3; ++i) {
+        const std::string ns = str::stream() << "a.b" << i;
+        OperationContextNoop opCtx(engine->newRecoveryUnit());
+        WriteUnitOfWork uow(&opCtx);
+        ASSERT_OK(
+            engine->createGroupedRecordStore(&opCtx, ns, ident, CollectionOptions(), prefixes[i]));
+        rss.push_back(
+            engine->getGroupedRecordStore(&opCtx, ns, ident, CollectionOptions(), prefixes[i]));
+        for (int j = 0; j < 10; ++j) {
+            ASSERT_OK(rss.back()->insertRecord(&opCtx, "abc", 4, false).getStatus());
+        }
+        uow.commit();
+    }
+
+    auto countRecords = [&](RecordStore* rs) {
+        OperationContextNoop opCtx(engine->newRecoveryUnit());
+        int count = 0;
+        auto cursor = rs->getCursor(&opCtx, true);
+        while (cursor->next()) {
+            ++count;
+        }
+        return count;
+    };
+
+    {
+        OperationContextNoop opCtx(engine->newRecoveryUnit());
+        WriteUnitOfWork uow(&opCtx);
+        ASSERT_OK(rss[0]->truncate(&opCtx));
+        uow.commit();
+    }
+    ASSERT_EQ(0, countRecords(rss[0].get()));
+    ASSERT_EQ(10, countRecords(rss[1].get()));
+    ASSERT_EQ(10, countRecords(rss[2].get()));
+
+    {
+        OperationContextNoop opCtx(engine->newRecoveryUnit());
+        ASSERT_OK(engine->dropGroupedIdent(&opCtx, ident, prefixes[1]));
+    }
+    ASSERT_EQ(0, countRecords(rss[1].get()));
+    ASSERT_EQ(10, countRecords(rss[2].get()));
+}
+
 }  // namespace
 }  // namespace mongo
@@ -43,6 +43,7 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/storage/clustered_key.h"
 #include "mongo/db/storage/oplog_hack.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
@@ -60,6 +61,7 @@
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 
 //#define RS_ITERATOR_TRACE(x) log() << "WTRS::Iterator " << x
 #define RS_ITERATOR_TRACE(x)
@@ -86,6 +88,15 @@ bool shouldUseOplogHack(OperationContext* opCtx, const std::string& uri) {
     return (appMetadata.getValue().getIntField("oplogKeyExtractionVersion") == 1);
 }
 
+bool shouldUseClusteredKeys(OperationContext* opCtx, const std::string& uri) {
+    StatusWith<BSONObj> appMetadata = WiredTigerUtil::getApplicationMetadata(opCtx, uri);
+    if (!appMetadata.isOK()) {
+        return false;
+    }
+
+    return (appMetadata.getValue().getIntField("clusteredKeyExtractionVersion") == 1);
+}
+
 }  // namespace
 
 MONGO_FP_DECLARE(WTWriteConflictException);
@@ -269,6 +280,30 @@ void WiredTigerRecordStore::OplogStones::updateStonesAfterCappedTruncateAfter(
     _currentBytes.addAndFetch(bytesInStonesToRemove - bytesRemoved);
 }
 
+void WiredTigerRecordStore::OplogStones::recordTruncation(const Stone& stone,
+                                                           Microseconds duration) {
+    _truncateCount.fetchAndAdd(1);
+    _totalTruncateMicros.fetchAndAdd(durationCount<Microseconds>(duration));
+    _recordsReclaimed.fetchAndAdd(stone.records);
+    _bytesReclaimed.fetchAndAdd(stone.bytes);
+}
+
+void WiredTigerRecordStore::OplogStones::appendStats(BSONObjBuilder* builder) const {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        builder->appendNumber("numStones", static_cast<long long>(_stones.size()));
+        builder->appendNumber("numStonesToKeep", static_cast<long long>(_numStonesToKeep));
+        builder->appendNumber("minBytesPerStone", static_cast<long long>(_minBytesPerStone));
+    }
+    builder->appendNumber("currentStoneRecords", static_cast<long long>(_currentRecords.load()));
+    builder->appendNumber("currentStoneBytes", static_cast<long long>(_currentBytes.load()));
+    builder->appendNumber("truncateCount", static_cast<long long>(_truncateCount.load()));
+    builder->appendNumber("totalTimeTruncatingMicros",
+                          static_cast<long long>(_totalTruncateMicros.load()));
+    builder->appendNumber("recordsReclaimed", static_cast<long long>(_recordsReclaimed.load()));
+    builder->appendNumber("bytesReclaimed", static_cast<long long>(_bytesReclaimed.load()));
+}
+
 void WiredTigerRecordStore::OplogStones::setMinBytesPerStone(int64_t size) {
     invariant(size > 0);
 
@@ -582,6 +617,9 @@ StatusWith<std::string> WiredTigerRecordStore::generateCreateString(
     if (NamespaceString::oplog(ns)) {
         ss << ",oplogKeyExtractionVersion=1";
     }
+    if (options.clustered) {
+        ss << ",clusteredKeyExtractionVersion=1";
+    }
     ss << ")";
 
     return StatusWith<std::string>(ss);
@@ -590,6 +628,7 @@ StatusWith<std::string> WiredTigerRecordStore::generateCreateString(
 WiredTigerRecordStore::WiredTigerRecordStore(OperationContext* ctx, Params params)
     : RecordStore(params.ns),
       _uri(params.uri),
+      _sizeStorerUri(params.sizeStorerUri.empty() ? params.uri : params.sizeStorerUri),
       _tableId(WiredTigerSession::genTableId()),
       _engineName(params.engineName),
       _isCapped(params.isCapped),
@@ -603,8 +642,8 @@ WiredTigerRecordStore::WiredTigerRecordStore(OperationContext* ctx, Params param
       _cappedCallback(params.cappedCallback),
       _cappedDeleteCheckCount(0),
       _useOplogHack(shouldUseOplogHack(ctx, _uri)),
+      _isClustered(shouldUseClusteredKeys(ctx, _uri)),
       _sizeStorer(params.sizeStorer),
-      _sizeStorerCounter(0),
       _shuttingDown(false) {
     Status versionStatus = WiredTigerUtil::checkApplicationMetadataFormatVersion(
                                ctx, _uri, kMinimumRecordStoreVersion, kMaximumRecordStoreVersion)
@@ -625,6 +664,8 @@ WiredTigerRecordStore::WiredTigerRecordStore(OperationContext* ctx, Params param
         invariant(_cappedMaxSize == -1);
         invariant(_cappedMaxDocs == -1);
     }
+
+    invariant(!_isClustered || !_isCapped);
 }
 
 WiredTigerRecordStore::~WiredTigerRecordStore() {
@@ -654,16 +695,16 @@ void WiredTigerRecordStore::postConstructorInit(OperationContext* opCtx) {
     std::unique_ptr<SeekableRecordCursor> cursor = getCursor(opCtx, /*forward=*/false);
     if (auto record = cursor->next()) {
         int64_t max = record->id.repr();
-        _oplog_highestSeen = record->id;
+        _oplog_highestSeen.store(record->id.repr());
         _nextIdNum.store(1 + max);
 
         if (_sizeStorer) {
             long long numRecords;
             long long dataSize;
-            _sizeStorer->loadFromCache(_uri, &numRecords, &dataSize);
+            _sizeStorer->loadFromCache(_sizeStorerUri, &numRecords, &dataSize);
             _numRecords.store(numRecords);
             _dataSize.store(dataSize);
-            _sizeStorer->onCreate(this, numRecords, dataSize);
+            _sizeInfo = _sizeStorer->onCreate(this, numRecords, dataSize);
         } else {
             LOG(1) << "Doing scan of collection " << ns() << " to get size and count info";
 
@@ -681,7 +722,7 @@ void WiredTigerRecordStore::postConstructorInit(OperationContext* opCtx) {
         // Need to start at 1 so we are always higher than RecordId::min()
         _nextIdNum.store(1);
         if (_sizeStorer)
-            _sizeStorer->onCreate(this, 0, 0);
+            _sizeInfo = _sizeStorer->onCreate(this, 0, 0);
     }
 
     if (WiredTigerKVEngine::initRsOplogBackgroundThread(ns())) {
@@ -716,6 +757,10 @@ bool WiredTigerRecordStore::isCapped() const {
     return _isCapped;
 }
 
+bool WiredTigerRecordStore::isClustered() const {
+    return _isClustered;
+}
+
 int64_t WiredTigerRecordStore::cappedMaxDocs() const {
     invariant(_isCapped);
     return _cappedMaxDocs;
@@ -1023,8 +1068,13 @@ bool WiredTigerRecordStore::yieldAndAwaitOplogDeletionRequest(OperationContext*
     return !oplogStones->isDead();
 }
 
-void WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx) {
-    while (auto stone = _oplogStones->peekOldestStoneIfNeeded()) {
+void WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx, size_t maxStonesToTruncate) {
+    size_t numStonesTruncated = 0;
+    while (numStonesTruncated < maxStonesToTruncate) {
+        auto stone = _oplogStones->peekOldestStoneIfNeeded();
+        if (!stone) {
+            break;
+        }
         invariant(stone->lastRecord.isNormal());
 
         LOG(1) << "Truncating the oplog between " << _oplogStones->firstRecord << " and "
@@ -1035,6 +1085,7 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx) {
         WT_SESSION* session = ru->getSession(opCtx)->getSession();
 
         try {
+            Timer timer;
             WriteUnitOfWork wuow(opCtx);
 
             WiredTigerCursor startwrap(_uri, _tableId, true, opCtx);
@@ -1056,6 +1107,9 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx) {
 
             // Stash the truncate point for next time to cleanly skip over tombstones, etc.
             _oplogStones->firstRecord = stone->lastRecord;
+
+            _oplogStones->recordTruncation(*stone, Microseconds(timer.micros()));
+            ++numStonesTruncated;
         } catch (const WriteConflictException& wce) {
             LOG(1) << "Caught WriteConflictException while truncating oplog entries, retrying";
         }
@@ -1099,6 +1153,18 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
             if (!status.isOK())
                 return status.getStatus();
             record.id = status.getValue();
+        } else if (_isClustered) {
+            // The records of a batch are not necessarily in _id order. A record with the _id of
+            // an existing one overwrites it here, but the insert into the _id index then fails,
+            // which rolls the overwrite back with the rest of the WriteUnitOfWork.
+            StatusWith<RecordId> status =
+                clusteredkey::extractKey(record.data.data(), record.data.size());
+            if (!status.isOK())
+                return status.getStatus();
+            record.id = status.getValue();
+            if (record.id > highestId)
+                highestId = record.id;
+            continue;
         } else if (_isCapped) {
             stdx::lock_guard<stdx::mutex> lk(_uncommittedRecordIdsMutex);
             record.id = _nextId();
@@ -1110,10 +1176,15 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
         highestId = record.id;
     }
 
-    if (_useOplogHack && (highestId > _oplog_highestSeen)) {
-        stdx::lock_guard<stdx::mutex> lk(_uncommittedRecordIdsMutex);
-        if (highestId > _oplog_highestSeen)
-            _oplog_highestSeen = highestId;
+    if (_useOplogHack) {
+        int64_t highestSeen = _oplog_highestSeen.load();
+        while (highestId.repr() > highestSeen) {
+            const int64_t previous =
+                _oplog_highestSeen.compareAndSwap(highestSeen, highestId.repr());
+            if (previous == highestSeen)
+                break;
+            highestSeen = previous;
+        }
     }
 
     for (size_t i = 0; i < nRecords; i++) {
@@ -1153,7 +1224,7 @@ StatusWith<RecordId> WiredTigerRecordStore::insertRecord(OperationContext* opCtx
 void WiredTigerRecordStore::_dealtWithCappedId(SortedRecordIds::iterator it, bool didCommit) {
     invariant(it->isNormal());
     stdx::lock_guard<stdx::mutex> lk(_uncommittedRecordIdsMutex);
-    if (didCommit && _isOplog && *it != _oplog_highestSeen) {
+    if (didCommit && _isOplog && it->repr() != _oplog_highestSeen.load()) {
         // Defer removal from _uncommittedRecordIds until it is durable. We don't need to wait for
         // durability of ops that didn't commit because they won't become durable.
         // As an optimization, we only defer visibility until durable if new ops were created while
@@ -1167,21 +1238,18 @@ void WiredTigerRecordStore::_dealtWithCappedId(SortedRecordIds::iterator it, boo
         }
     } else {
         _uncommittedRecordIds.erase(it);
+        _publishLowestUncommittedRecordId_inlock();
         _opsBecameVisibleCV.notify_all();
     }
 }
 
 bool WiredTigerRecordStore::isCappedHidden(const RecordId& id) const {
-    stdx::lock_guard<stdx::mutex> lk(_uncommittedRecordIdsMutex);
-    if (_uncommittedRecordIds.empty()) {
-        return false;
-    }
-    return _uncommittedRecordIds.front() <= id;
+    const RecordId lowest = lowestCappedHiddenRecord();
+    return !lowest.isNull() && lowest <= id;
 }
 
 RecordId WiredTigerRecordStore::lowestCappedHiddenRecord() const {
-    stdx::lock_guard<stdx::mutex> lk(_uncommittedRecordIdsMutex);
-    return _uncommittedRecordIds.empty() ? RecordId() : _uncommittedRecordIds.front();
+    return RecordId(_lowestUncommittedRecordId.load());
 }
 
 Status WiredTigerRecordStore::insertRecordsWithDocWriter(OperationContext* opCtx,
@@ -1262,7 +1330,7 @@ Status WiredTigerRecordStore::updateRecord(OperationContext* opCtx,
 }
 
 bool WiredTigerRecordStore::updateWithDamagesSupported() const {
-    return false;
+    return true;
 }
 
 StatusWith<RecordData> WiredTigerRecordStore::updateWithDamages(
@@ -1271,16 +1339,37 @@ StatusWith<RecordData> WiredTigerRecordStore::updateWithDamages(
     const RecordData& oldRec,
     const char* damageSource,
     const mutablebson::DamageVector& damages) {
-    MONGO_UNREACHABLE;
+    // This version of WiredTiger cannot modify part of a value, so the damages are applied to a
+    // copy of the old record which then replaces it. Since the size of the record cannot change,
+    // there is no need to look the old value up as updateRecord() does.
+    const int len = oldRec.size();
+    SharedBuffer data = SharedBuffer::allocate(len);
+    char* root = data.get();
+    memcpy(root, oldRec.data(), len);
+    for (const mutablebson::DamageEvent& damage : damages) {
+        invariant(damage.targetOffset + damage.size <= static_cast<size_t>(len));
+        memcpy(root + damage.targetOffset, damageSource + damage.sourceOffset, damage.size);
+    }
+
+    WiredTigerCursor curwrap(_uri, _tableId, true, opCtx);
+    curwrap.assertInActiveTxn();
+    WT_CURSOR* c = curwrap.get();
+    invariant(c);
+    setKey(c, id);
+    WiredTigerItem value(root, len);
+    c->set_value(c, value.Get());
+    int ret = WT_OP_CHECK(c->insert(c));
+    invariantWTOK(ret);
+
+    return RecordData(std::move(data), len);
 }
 
 void WiredTigerRecordStore::_oplogSetStartHack(WiredTigerRecoveryUnit* wru) const {
-    stdx::lock_guard<stdx::mutex> lk(_uncommittedRecordIdsMutex);
-    if (_uncommittedRecordIds.empty()) {
-        wru->setOplogReadTill(_oplog_highestSeen);
-    } else {
-        wru->setOplogReadTill(_uncommittedRecordIds.front());
-    }
+    // Load the highest RecordId seen first. It is published after the front of the uncommitted
+    // RecordIds when inserting, so no uncommitted RecordId can be below it if there are none.
+    const RecordId highestSeen(_oplog_highestSeen.load());
+    const RecordId lowestHidden = lowestCappedHiddenRecord();
+    wru->setOplogReadTill(lowestHidden.isNull() ? highestSeen : lowestHidden);
 }
 
 std::unique_ptr<RecordCursor> WiredTigerRecordStore::getRandomCursor(
@@ -1297,17 +1386,17 @@ std::vector<std::unique_ptr<RecordCursor>> WiredTigerRecordStore::getManyCursors
 }
 
 Status WiredTigerRecordStore::truncate(OperationContext* opCtx) {
+    // Bound the range by the keys of this record store, as a grouped record store shares its
+    // table. The keys need not exist, and WiredTiger does nothing if the range is empty.
     WiredTigerCursor startWrap(_uri, _tableId, true, opCtx);
     WT_CURSOR* start = startWrap.get();
-    int ret = WT_READ_CHECK(start->next(start));
-    // Empty collections don't have anything to truncate.
-    if (ret == WT_NOTFOUND) {
-        return Status::OK();
-    }
-    invariantWTOK(ret);
+    setKey(start, RecordId::min());
+    WiredTigerCursor stopWrap(_uri, _tableId, true, opCtx);
+    WT_CURSOR* stop = stopWrap.get();
+    setKey(stop, RecordId::max());
 
     WT_SESSION* session = WiredTigerRecoveryUnit::get(opCtx)->getSession(opCtx)->getSession();
-    invariantWTOK(WT_OP_CHECK(session->truncate(session, NULL, start, NULL, NULL)));
+    invariantWTOK(WT_OP_CHECK(session->truncate(session, NULL, start, stop, NULL)));
     _changeNumRecords(opCtx, -numRecords(opCtx));
     _increaseDataSize(opCtx, -dataSize(opCtx));
 
@@ -1337,7 +1426,12 @@ Status WiredTigerRecordStore::validate(OperationContext* opCtx,
                                        ValidateAdaptor* adaptor,
                                        ValidateResults* results,
                                        BSONObjBuilder* output) {
-    if (!_isEphemeral) {
+    // A validation which doesn't hold the collection exclusively reads a snapshot of it while other
+    // operations keep writing to it. It can neither verify the table, which requires exclusive
+    // access, nor correct the size counters, which also count the concurrent writes.
+    const bool background = !opCtx->lockState()->isCollectionLockedForMode(ns(), MODE_X);
+
+    if (!_isEphemeral && !background) {
         int err = WiredTigerUtil::verifyTable(opCtx, _uri, &results->errors);
         if (err == EBUSY) {
             std::string msg = str::stream()
@@ -1391,7 +1485,7 @@ Status WiredTigerRecordStore::validate(OperationContext* opCtx,
         }
     }
 
-    if (_sizeStorer && results->valid) {
+    if (_sizeStorer && results->valid && !background) {
         if (nrecords != _numRecords.load() || dataSizeTotal != _dataSize.load()) {
             warning() << _uri << ": Existing record and data size counters (" << _numRecords.load()
                       << " records " << _dataSize.load() << " bytes) "
@@ -1401,7 +1495,7 @@ Status WiredTigerRecordStore::validate(OperationContext* opCtx,
         }
         _numRecords.store(nrecords);
         _dataSize.store(dataSizeTotal);
-        _sizeStorer->storeToCache(_uri, _numRecords.load(), _dataSize.load());
+        _sizeStorer->storeToCache(_sizeStorerUri, _numRecords.load(), _dataSize.load());
     }
 
     if (level == kValidateFull) {
@@ -1459,6 +1553,18 @@ void WiredTigerRecordStore::appendCustomStats(OperationContext* opCtx,
     }
 }
 
+bool WiredTigerRecordStore::appendCacheStats(OperationContext* opCtx,
+                                             BSONObjBuilder* result) const {
+    WT_SESSION* s = WiredTigerRecoveryUnit::get(opCtx)->getSession(opCtx)->getSession();
+    Status status = WiredTigerUtil::appendCacheStats(s, getURI(), result);
+    if (!status.isOK()) {
+        result->append("error", "unable to retrieve cache statistics");
+        result->append("code", static_cast<int>(status.code()));
+        result->append("reason", status.reason());
+    }
+    return true;
+}
+
 Status WiredTigerRecordStore::touch(OperationContext* opCtx, BSONObjBuilder* output) const {
     if (_isEphemeral) {
         // Everything is already in memory.
@@ -1530,6 +1636,7 @@ void WiredTigerRecordStore::_oplogJournalThreadLoop(WiredTigerSessionCache* sess
         for (auto&& op : opsAboutToBeJournaled) {
             _uncommittedRecordIds.erase(op);
         }
+        _publishLowestUncommittedRecordId_inlock();
 
         _opsBecameVisibleCV.notify_all();
         lk.unlock();
@@ -1550,7 +1657,7 @@ void WiredTigerRecordStore::waitForAllEarlierOplogWritesToBeVisible(OperationCon
     // loop of WCE handling when the getCursor() is called.
 
     stdx::unique_lock<stdx::mutex> lk(_uncommittedRecordIdsMutex);
-    const auto waitingFor = _oplog_highestSeen;
+    const RecordId waitingFor(_oplog_highestSeen.load());
     opCtx->waitForConditionOrInterrupt(_opsBecameVisibleCV, lk, [&] {
         return _uncommittedRecordIds.empty() || _uncommittedRecordIds.front() > waitingFor;
     });
@@ -1561,7 +1668,13 @@ void WiredTigerRecordStore::_addUncommittedRecordId_inlock(OperationContext* opC
     SortedRecordIds::iterator it = _uncommittedRecordIds.insert(_uncommittedRecordIds.end(), id);
     invariant(it->isNormal());
     opCtx->recoveryUnit()->registerChange(new CappedInsertChange(this, it));
-    _oplog_highestSeen = id;
+    _publishLowestUncommittedRecordId_inlock();
+    _oplog_highestSeen.store(id.repr());
+}
+
+void WiredTigerRecordStore::_publishLowestUncommittedRecordId_inlock() {
+    _lowestUncommittedRecordId.store(
+        _uncommittedRecordIds.empty() ? RecordId().repr() : _uncommittedRecordIds.front().repr());
 }
 
 boost::optional<RecordId> WiredTigerRecordStore::oplogStartHack(
@@ -1596,7 +1709,7 @@ void WiredTigerRecordStore::updateStatsAfterRepair(OperationContext* opCtx,
     _dataSize.store(dataSize);
 
     if (_sizeStorer) {
-        _sizeStorer->storeToCache(_uri, numRecords, dataSize);
+        _sizeStorer->storeToCache(_sizeStorerUri, numRecords, dataSize);
     }
 }
 
@@ -1628,6 +1741,10 @@ void WiredTigerRecordStore::_changeNumRecords(OperationContext* opCtx, int64_t d
     opCtx->recoveryUnit()->registerChange(new NumRecordsChange(this, diff));
     if (_numRecords.fetchAndAdd(diff) < 0)
         _numRecords.store(std::max(diff, int64_t(0)));
+
+    if (_sizeInfo) {
+        _sizeStorer->markDirty(_sizeInfo);
+    }
 }
 
 class WiredTigerRecordStore::DataSizeChange : public RecoveryUnit::Change {
@@ -1650,8 +1767,8 @@ void WiredTigerRecordStore::_increaseDataSize(OperationContext* opCtx, int64_t a
     if (_dataSize.fetchAndAdd(amount) < 0)
         _dataSize.store(std::max(amount, int64_t(0)));
 
-    if (_sizeStorer && _sizeStorerCounter++ % 1000 == 0) {
-        _sizeStorer->storeToCache(_uri, _numRecords.load(), _dataSize.load());
+    if (_sizeInfo) {
+        _sizeStorer->markDirty(_sizeInfo);
     }
 }
 
@@ -1716,7 +1833,7 @@ void WiredTigerRecordStore::cappedTruncateAfter(OperationContext* opCtx,
 
     if (_useOplogHack) {
         // Forget that we've ever seen a higher timestamp than we now have.
-        _oplog_highestSeen = lastKeptId;
+        _oplog_highestSeen.store(lastKeptId.repr());
     }
 
     if (_oplogStones) {
@@ -1967,10 +2084,34 @@ bool WiredTigerRecordStoreStandardCursor::hasWrongPrefix(WT_CURSOR* cursor,
 
 // Prefixed Implementations:
 
+namespace {
+WiredTigerRecordStore::Params withPrefixedSizeStorerUri(WiredTigerRecordStore::Params params,
+                                                        KVPrefix prefix) {
+    params.sizeStorerUri = WiredTigerSizeStorer::prefixedUri(params.uri, prefix.repr());
+    return params;
+}
+}  // namespace
+
 PrefixedWiredTigerRecordStore::PrefixedWiredTigerRecordStore(OperationContext* opCtx,
                                                              Params params,
                                                              KVPrefix prefix)
-    : WiredTigerRecordStore(opCtx, params), _prefix(prefix) {}
+    : WiredTigerRecordStore(opCtx, withPrefixedSizeStorerUri(params, prefix)), _prefix(prefix) {}
+
+int64_t PrefixedWiredTigerRecordStore::storageSize(OperationContext* opCtx,
+                                                   BSONObjBuilder* extraInfo,
+                                                   int infoLevel) const {
+    const int64_t tableSize = WiredTigerRecordStore::storageSize(opCtx, extraInfo, infoLevel);
+    if (_isEphemeral || !_sizeStorer) {
+        return tableSize;
+    }
+
+    const long long tableDataSize = _sizeStorer->dataSizeOfGroupedTable(_uri);
+    if (tableDataSize <= 0) {
+        return tableSize;
+    }
+    const double share = std::min(1.0, static_cast<double>(dataSize(opCtx)) / tableDataSize);
+    return static_cast<int64_t>(tableSize * share);
+}
 
 std::unique_ptr<SeekableRecordCursor> PrefixedWiredTigerRecordStore::getCursor(
     OperationContext* opCtx, bool forward) const {
@@ -32,6 +32,7 @@
 #pragma once
 
 #include <boost/thread/mutex.hpp>
+#include <limits>
 #include <set>
 #include <string>
 #include <wiredtiger.h>
@@ -41,6 +42,7 @@
 #include "mongo/db/storage/kv/kv_prefix.h"
 #include "mongo/db/storage/record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
@@ -64,7 +66,6 @@ namespace mongo {
 
 class RecoveryUnit;
 class WiredTigerSessionCache;
-class WiredTigerSizeStorer;
 
 extern const std::string kWiredTigerEngineName;
 typedef std::list<RecordId> SortedRecordIds;
@@ -111,6 +112,8 @@ public:
         int64_t cappedMaxDocs;
         CappedCallback* cappedCallback;
         WiredTigerSizeStorer* sizeStorer;
+        // The key of the sizes of this record store in 'sizeStorer'. Defaults to 'uri'.
+        std::string sizeStorerUri;
     };
 
     WiredTigerRecordStore(OperationContext* opCtx, Params params);
@@ -128,6 +131,8 @@ public:
 
     virtual bool isCapped() const;
 
+    bool isClustered() const override;
+
     virtual int64_t storageSize(OperationContext* opCtx,
                                 BSONObjBuilder* extraInfo = NULL,
                                 int infoLevel = 0) const;
@@ -203,6 +208,8 @@ public:
                                    BSONObjBuilder* result,
                                    double scale) const;
 
+    virtual bool appendCacheStats(OperationContext* opCtx, BSONObjBuilder* result) const;
+
     virtual Status touch(OperationContext* opCtx, BSONObjBuilder* output) const;
 
     virtual void cappedTruncateAfter(OperationContext* opCtx, RecordId end, bool inclusive);
@@ -237,6 +244,9 @@ public:
     const std::string& getURI() const {
         return _uri;
     }
+    const std::string& getSizeStorerURI() const {
+        return _sizeStorerUri;
+    }
     uint64_t tableId() const {
         return _tableId;
     }
@@ -250,7 +260,10 @@ public:
 
     bool inShutdown() const;
 
-    void reclaimOplog(OperationContext* opCtx);
+    // Truncates the oldest oplog stones while there are more than the number of stones to keep,
+    // stopping early once 'maxStonesToTruncate' of them have been truncated.
+    void reclaimOplog(OperationContext* opCtx,
+                      size_t maxStonesToTruncate = std::numeric_limits<size_t>::max());
 
     int64_t cappedDeleteAsNeeded(OperationContext* opCtx, const RecordId& justInserted);
 
@@ -295,6 +308,7 @@ private:
 
     void _dealtWithCappedId(SortedRecordIds::iterator it, bool didCommit);
     void _addUncommittedRecordId_inlock(OperationContext* opCtx, RecordId id);
+    void _publishLowestUncommittedRecordId_inlock();
 
     Status _insertRecords(OperationContext* opCtx, Record* records, size_t nRecords);
 
@@ -308,6 +322,7 @@ private:
     void _oplogJournalThreadLoop(WiredTigerSessionCache* sessionCache);
 
     const std::string _uri;
+    const std::string _sizeStorerUri;
     const uint64_t _tableId;  // not persisted
 
     // Canonical engine name to use for retrieving options
@@ -333,16 +348,26 @@ private:
 
     const bool _useOplogHack;
 
+    // True if the RecordIds are derived from the _id of the documents, see clustered_key.h.
+    const bool _isClustered;
+
     SortedRecordIds _uncommittedRecordIds;
-    RecordId _oplog_highestSeen;
     mutable stdx::mutex _uncommittedRecordIdsMutex;
 
+    // The representations of the front of _uncommittedRecordIds, or of the null RecordId when it
+    // is empty, and of the highest RecordId inserted. The former is only written under
+    // _uncommittedRecordIdsMutex, but both are read without it, so that the visibility checks of
+    // cursors do not serialize with the writers of the oplog.
+    AtomicInt64 _lowestUncommittedRecordId;
+    AtomicInt64 _oplog_highestSeen;
+
     AtomicInt64 _nextIdNum;
     AtomicInt64 _dataSize;
     AtomicInt64 _numRecords;
 
     WiredTigerSizeStorer* _sizeStorer;  // not owned, can be NULL
-    int _sizeStorerCounter;
+    // The size storer's entry for this table, set once the sizes have been handed to it.
+    std::shared_ptr<WiredTigerSizeStorer::SizeInfo> _sizeInfo;
 
     bool _shuttingDown;
 
@@ -396,6 +421,14 @@ public:
         return _prefix;
     }
 
+    /**
+     * The table is shared with other grouped collections, so this reports the part of its size
+     * in proportion to this collection's part of the data in it.
+     */
+    virtual int64_t storageSize(OperationContext* opCtx,
+                                BSONObjBuilder* extraInfo = NULL,
+                                int infoLevel = 0) const override;
+
 protected:
     virtual RecordId getKey(WT_CURSOR* cursor) const;
 
@@ -0,0 +1,185 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/db/catalog/collection_options.h"
+#include "mongo/db/operation_context_noop.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/platform/random.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/benchmark.h"
+#include "mongo/unittest/temp_dir.h"
+
+namespace mongo {
+namespace {
+
+using unittest::benchmarkDoNotOptimize;
+
+const std::string kNs = "bm.records";
+const int kRecordSize = 128;
+const int kPopulatedRecords = 10 * 1000;
+
+/**
+ * Opens a fresh WiredTiger connection in a temporary directory and creates an empty standard
+ * record store in it.
+ */
+class WiredTigerRecordStoreBenchmark : public unittest::Benchmark {
+protected:
+    void setUp() override {
+        _dbpath = stdx::make_unique<unittest::TempDir>("wt_record_store_bm");
+        invariantWTOK(
+            wiredtiger_open(_dbpath->path().c_str(), nullptr, "create,cache_size=256M", &_conn));
+        _sessionCache = stdx::make_unique<WiredTigerSessionCache>(_conn);
+        opCtx = makeOperationContext();
+
+        const std::string uri = "table:" + kNs;
+        const bool prefixed = false;
+        const std::string config = uassertStatusOK(WiredTigerRecordStore::generateCreateString(
+            kWiredTigerEngineName, kNs, CollectionOptions(), "", prefixed));
+        {
+            WriteUnitOfWork uow(opCtx.get());
+            WT_SESSION* s =
+                WiredTigerRecoveryUnit::get(opCtx.get())->getSession(opCtx.get())->getSession();
+            invariantWTOK(s->create(s, uri.c_str(), config.c_str()));
+            uow.commit();
+        }
+
+        WiredTigerRecordStore::Params params;
+        params.ns = kNs;
+        params.uri = uri;
+        params.engineName = kWiredTigerEngineName;
+        params.isCapped = false;
+        params.isEphemeral = false;
+        params.cappedMaxSize = -1;
+        params.cappedMaxDocs = -1;
+        params.cappedCallback = nullptr;
+        params.sizeStorer = nullptr;
+        auto rs = stdx::make_unique<StandardWiredTigerRecordStore>(opCtx.get(), params);
+        rs->postConstructorInit(opCtx.get());
+        recordStore = std::move(rs);
+    }
+
+    void tearDown() override {
+        recordStore.reset();
+        opCtx.reset();
+        _sessionCache.reset();
+        _conn->close(_conn, nullptr);
+        _dbpath.reset();
+    }
+
+    std::unique_ptr<OperationContext> makeOperationContext() {
+        return stdx::make_unique<OperationContextNoop>(
+            new WiredTigerRecoveryUnit(_sessionCache.get()));
+    }
+
+    void populate(int numRecords) {
+        WriteUnitOfWork uow(opCtx.get());
+        for (int i = 0; i < numRecords; ++i) {
+            auto id = recordStore->insertRecord(opCtx.get(), record, kRecordSize, false);
+            ids.push_back(uassertStatusOK(id));
+        }
+        uow.commit();
+    }
+
+    const char record[kRecordSize] = {};
+    std::unique_ptr<OperationContext> opCtx;
+    std::unique_ptr<RecordStore> recordStore;
+    std::vector<RecordId> ids;
+
+private:
+    std::unique_ptr<unittest::TempDir> _dbpath;
+    WT_CONNECTION* _conn = nullptr;
+    std::unique_ptr<WiredTigerSessionCache> _sessionCache;
+};
+
+BENCHMARK_F(WiredTigerRecordStoreBenchmark, InsertOnePerUnitOfWork) {
+    while (state.keepRunning()) {
+        WriteUnitOfWork uow(opCtx.get());
+        benchmarkDoNotOptimize(recordStore->insertRecord(opCtx.get(), record, kRecordSize, false));
+        uow.commit();
+    }
+    state.setBytesProcessed(state.iterations() * kRecordSize);
+}
+
+BENCHMARK_F(WiredTigerRecordStoreBenchmark, InsertHundredPerUnitOfWork) {
+    const int kBatchSize = 100;
+    while (state.keepRunning()) {
+        WriteUnitOfWork uow(opCtx.get());
+        for (int i = 0; i < kBatchSize; ++i) {
+            benchmarkDoNotOptimize(
+                recordStore->insertRecord(opCtx.get(), record, kRecordSize, false));
+        }
+        uow.commit();
+    }
+    state.setItemsProcessed(state.iterations() * kBatchSize);
+    state.setBytesProcessed(state.iterations() * kBatchSize * kRecordSize);
+}
+
+BENCHMARK_F(WiredTigerRecordStoreBenchmark, FindRecord) {
+    populate(kPopulatedRecords);
+    PseudoRandom random(12345);
+    RecordData data;
+    while (state.keepRunning()) {
+        const RecordId& id = ids[random.nextInt32(ids.size())];
+        benchmarkDoNotOptimize(recordStore->findRecord(opCtx.get(), id, &data));
+    }
+}
+
+BENCHMARK_F(WiredTigerRecordStoreBenchmark, SeekExactWithCursor) {
+    populate(kPopulatedRecords);
+    PseudoRandom random(12345);
+    auto cursor = recordStore->getCursor(opCtx.get());
+    while (state.keepRunning()) {
+        const RecordId& id = ids[random.nextInt32(ids.size())];
+        benchmarkDoNotOptimize(cursor->seekExact(id));
+    }
+}
+
+BENCHMARK_F(WiredTigerRecordStoreBenchmark, ForwardScan) {
+    populate(kPopulatedRecords);
+    while (state.keepRunning()) {
+        auto cursor = recordStore->getCursor(opCtx.get());
+        long long bytes = 0;
+        while (auto rec = cursor->next()) {
+            bytes += rec->data.size();
+        }
+        benchmarkDoNotOptimize(bytes);
+    }
+    state.setItemsProcessed(state.iterations() * kPopulatedRecords);
+    state.setBytesProcessed(state.iterations() * kPopulatedRecords * kRecordSize);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -31,6 +31,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include <limits>
 #include <set>
 
 #include "mongo/base/checked_cast.h"
@@ -38,12 +39,15 @@
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/client.h"
+#include "mongo/db/commands/server_status.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_record_store_oplog_stones.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/background.h"
@@ -54,6 +58,14 @@ namespace mongo {
 
 namespace {
 
+// The background thread truncates at most this many oplog stones before releasing its locks, so
+// that a large backlog of excess stones does not hold them for the duration of the whole backlog.
+MONGO_EXPORT_SERVER_PARAMETER(oplogTruncationMaxStonesPerPass, int, 1);
+
+// How long the background thread sleeps, without holding any locks, between passes that
+// truncated oplog stones. Trades a bigger oplog for less interference with concurrent writes.
+MONGO_EXPORT_SERVER_PARAMETER(oplogTruncationPassDelayMillis, int, 0);
+
 std::set<NamespaceString> _backgroundThreadNamespaces;
 stdx::mutex _backgroundThreadMutex;
 
@@ -102,7 +114,10 @@ public:
             if (!rs->yieldAndAwaitOplogDeletionRequest(&opCtx)) {
                 return false;  // Oplog went away.
             }
-            rs->reclaimOplog(&opCtx);
+            const int maxStonesPerPass = oplogTruncationMaxStonesPerPass.load();
+            rs->reclaimOplog(&opCtx,
+                             maxStonesPerPass > 0 ? static_cast<size_t>(maxStonesPerPass)
+                                                  : std::numeric_limits<size_t>::max());
         } catch (const std::exception& e) {
             severe() << "error in WiredTigerRecordStoreThread: " << e.what();
             fassertFailedNoTrace(!"error in WiredTigerRecordStoreThread");
@@ -118,6 +133,8 @@ public:
         while (!globalInShutdownDeprecated()) {
             if (!_deleteExcessDocuments()) {
                 sleepmillis(1000);  // Back off in case there were problems deleting.
+            } else if (const int delayMillis = oplogTruncationPassDelayMillis.load()) {
+                sleepmillis(delayMillis);
             }
         }
     }
@@ -151,6 +168,38 @@ bool initRsOplogBackgroundThread(StringData ns) {
     return true;
 }
 
+/**
+ * Adds "oplogTruncation" to the results of db.serverStatus().
+ */
+class OplogTruncationServerStatusSection final : public ServerStatusSection {
+public:
+    OplogTruncationServerStatusSection() : ServerStatusSection("oplogTruncation") {}
+
+    bool includeByDefault() const override {
+        return true;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override {
+        const NamespaceString oplogNss("local.oplog.rs");
+        AutoGetCollection autoColl(opCtx, oplogNss, MODE_IS);
+        Collection* collection = autoColl.getCollection();
+        if (!collection) {
+            return BSONObj();
+        }
+
+        // The oplog may belong to a different storage engine than the one this file is built for.
+        auto rs = dynamic_cast<WiredTigerRecordStore*>(collection->getRecordStore());
+        if (!rs || !rs->oplogStones()) {
+            return BSONObj();
+        }
+
+        BSONObjBuilder builder;
+        rs->oplogStones()->appendStats(&builder);
+        return builder.obj();
+    }
+} oplogTruncationServerStatusSection;
+
 MONGO_INITIALIZER(SetInitRsOplogBackgroundThreadCallback)(InitializerContext* context) {
     WiredTigerKVEngine::setInitRsOplogBackgroundThreadCallback(initRsOplogBackgroundThread);
     return Status::OK();
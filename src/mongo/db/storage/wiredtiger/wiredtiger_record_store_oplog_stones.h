@@ -35,9 +35,11 @@
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/duration.h"
 
 namespace mongo {
 
+class BSONObjBuilder;
 class OperationContext;
 class RecordId;
 
@@ -81,6 +83,13 @@ public:
                                               int64_t bytesRemoved,
                                               RecordId firstRemovedId);
 
+    // Accounts for the truncation of 'stone', which took 'duration' to complete.
+    void recordTruncation(const Stone& stone, Microseconds duration);
+
+    // Appends the current state of the oplog stones and totals about the truncations performed so
+    // far, as reported by the "oplogTruncation" section of serverStatus.
+    void appendStats(BSONObjBuilder* builder) const;
+
     // The start point of where to truncate next. Used by the background reclaim thread to
     // efficiently truncate records with WiredTiger by skipping over tombstones, etc.
     RecordId firstRecord;
@@ -140,6 +149,12 @@ private:
     AtomicInt64 _currentRecords;  // Number of records in the stone being filled.
     AtomicInt64 _currentBytes;    // Number of bytes in the stone being filled.
 
+    // Totals over the lifetime of this object, reported by appendStats().
+    AtomicInt64 _truncateCount;
+    AtomicInt64 _totalTruncateMicros;
+    AtomicInt64 _recordsReclaimed;
+    AtomicInt64 _bytesReclaimed;
+
     mutable stdx::mutex _mutex;  // Protects against concurrent access to the deque of oplog stones.
     std::deque<OplogStones::Stone> _stones;  // front = oldest, back = newest.
 };
@@ -668,6 +668,44 @@ TEST(WiredTigerRecordStoreTest, OplogDurableVisibilityOutOfOrder) {
     ASSERT(!wtrs->isCappedHidden(id2));
 }
 
+// Test that the lowest hidden oplog entry, which cursors read without a lock, follows the earliest
+// uncommitted insert as later inserts commit and earlier ones roll back.
+TEST(WiredTigerRecordStoreTest, OplogLowestHiddenRecordAfterRollback) {
+    unique_ptr<RecordStoreHarnessHelper> harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newCappedRecordStore("local.oplog.foo", 100000, -1));
+
+    auto wtrs = checked_cast<WiredTigerRecordStore*>(rs.get());
+    ASSERT(wtrs->lowestCappedHiddenRecord().isNull());
+
+    RecordId id1;
+    RecordId id2;
+    {
+        ServiceContext::UniqueOperationContext longLivedOp(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(longLivedOp.get());
+        id1 = _oplogOrderInsertOplog(longLivedOp.get(), rs, 1);
+        ASSERT_EQ(id1, wtrs->lowestCappedHiddenRecord());
+
+        {
+            auto innerClient = harnessHelper->serviceContext()->makeClient("inner");
+            ServiceContext::UniqueOperationContext opCtx(
+                harnessHelper->newOperationContext(innerClient.get()));
+            WriteUnitOfWork uow(opCtx.get());
+            id2 = _oplogOrderInsertOplog(opCtx.get(), rs, 2);
+            ASSERT_EQ(id1, wtrs->lowestCappedHiddenRecord());
+            uow.commit();
+        }
+
+        // The earlier insert still hides the later one.
+        ASSERT_EQ(id1, wtrs->lowestCappedHiddenRecord());
+        ASSERT(wtrs->isCappedHidden(id2));
+    }
+
+    // Rolling back the earlier insert makes the later one visible.
+    ASSERT(wtrs->lowestCappedHiddenRecord().isNull());
+    ASSERT(!wtrs->isCappedHidden(id1));
+    ASSERT(!wtrs->isCappedHidden(id2));
+}
+
 TEST(WiredTigerRecordStoreTest, AppendCustomStatsMetadata) {
     std::unique_ptr<RecordStoreHarnessHelper> harnessHelper = newRecordStoreHarnessHelper();
     unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore("a.b"));
@@ -1116,6 +1154,69 @@ TEST(WiredTigerRecordStoreTest, OplogStones_ReclaimStones) {
     }
 }
 
+// Verify that reclaiming the oplog can be limited to a number of stones per call, and that each
+// truncation is accounted for in the oplog stones' statistics.
+TEST(WiredTigerRecordStoreTest, OplogStones_ReclaimStonesWithLimit) {
+    std::unique_ptr<RecordStoreHarnessHelper> harnessHelper = newRecordStoreHarnessHelper();
+
+    const int64_t cappedMaxSize = 10 * 1024;  // 10KB
+    unique_ptr<RecordStore> rs(
+        harnessHelper->newCappedRecordStore("local.oplog.stones", cappedMaxSize, -1));
+
+    WiredTigerRecordStore* wtrs = static_cast<WiredTigerRecordStore*>(rs.get());
+    WiredTigerRecordStore::OplogStones* oplogStones = wtrs->oplogStones();
+
+    oplogStones->setMinBytesPerStone(100);
+    oplogStones->setNumStonesToKeep(1U);
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 1), 100), RecordId(1, 1));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 2), 110), RecordId(1, 2));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 3), 120), RecordId(1, 3));
+
+        ASSERT_EQ(3U, oplogStones->numStones());
+    }
+
+    // Only truncate a single stone even though two are in excess.
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        wtrs->reclaimOplog(opCtx.get(), 1U);
+
+        ASSERT_EQ(2, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(230, rs->dataSize(opCtx.get()));
+        ASSERT_EQ(2U, oplogStones->numStones());
+
+        BSONObjBuilder builder;
+        oplogStones->appendStats(&builder);
+        BSONObj stats = builder.obj();
+        ASSERT_EQ(2, stats["numStones"].numberLong());
+        ASSERT_EQ(1, stats["truncateCount"].numberLong());
+        ASSERT_EQ(1, stats["recordsReclaimed"].numberLong());
+        ASSERT_EQ(100, stats["bytesReclaimed"].numberLong());
+    }
+
+    // The next call picks up where the previous one stopped.
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        wtrs->reclaimOplog(opCtx.get(), 1U);
+
+        ASSERT_EQ(1, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(120, rs->dataSize(opCtx.get()));
+        ASSERT_EQ(1U, oplogStones->numStones());
+
+        BSONObjBuilder builder;
+        oplogStones->appendStats(&builder);
+        BSONObj stats = builder.obj();
+        ASSERT_EQ(2, stats["truncateCount"].numberLong());
+        ASSERT_EQ(2, stats["recordsReclaimed"].numberLong());
+        ASSERT_EQ(210, stats["bytesReclaimed"].numberLong());
+    }
+}
+
 // Verify that oplog stones are not reclaimed even if the size of the record store exceeds
 // 'cappedMaxSize'.
 TEST(WiredTigerRecordStoreTest, OplogStones_ExceedCappedMaxSize) {
@@ -54,6 +54,11 @@ namespace {
 AtomicUInt64 nextSnapshotId{1};
 
 logger::LogSeverity kSlowTransactionSeverity = logger::LogSeverity::Debug(1);
+
+// Transactions started on the last applied snapshot, and the sum of the ages of the snapshots they
+// were started on. The age of a snapshot bounds how stale the data read from it can be.
+AtomicUInt64 lastAppliedSnapshotTransactions;
+AtomicUInt64 lastAppliedSnapshotTotalAgeMillis;
 }  // namespace
 
 WiredTigerRecoveryUnit::WiredTigerRecoveryUnit(WiredTigerSessionCache* sc)
@@ -71,6 +76,7 @@ void WiredTigerRecoveryUnit::prepareForCreateSnapshot(OperationContext* opCtx) {
     invariant(!_active);  // Can't already be in a WT transaction.
     invariant(!_inUnitOfWork);
     invariant(!_readFromMajorityCommittedSnapshot);
+    invariant(!_readFromLastAppliedSnapshot);
 
     // Starts the WT transaction that will be the basis for creating a named snapshot.
     getSession(opCtx);
@@ -231,6 +237,36 @@ boost::optional<SnapshotName> WiredTigerRecoveryUnit::getMajorityCommittedSnapsh
     return _majorityCommittedSnapshot;
 }
 
+void WiredTigerRecoveryUnit::appendGlobalStats(BSONObjBuilder& b) {
+    BSONObjBuilder bb(b.subobjStart("lastAppliedSnapshotReads"));
+    bb.append("transactions", static_cast<long long>(lastAppliedSnapshotTransactions.load()));
+    bb.append("totalSnapshotAgeMillis",
+              static_cast<long long>(lastAppliedSnapshotTotalAgeMillis.load()));
+    bb.done();
+}
+
+Status WiredTigerRecoveryUnit::setReadFromLastAppliedSnapshot() {
+    if (_active || _readFromMajorityCommittedSnapshot) {
+        return {ErrorCodes::IllegalOperation,
+                "Cannot switch to reading from the last applied snapshot"};
+    }
+
+    auto snapshotName = _sessionCache->snapshotManager().getLastAppliedSnapshot();
+    if (!snapshotName) {
+        return {ErrorCodes::SnapshotUnavailable, "No applied snapshot is available to read from"};
+    }
+
+    _lastAppliedSnapshot = *snapshotName;
+    _readFromLastAppliedSnapshot = true;
+    return Status::OK();
+}
+
+boost::optional<SnapshotName> WiredTigerRecoveryUnit::getLastAppliedSnapshot() const {
+    if (!_readFromLastAppliedSnapshot)
+        return {};
+    return _lastAppliedSnapshot;
+}
+
 void WiredTigerRecoveryUnit::_txnOpen(OperationContext* opCtx) {
     invariant(!_active);
     _ensureSession();
@@ -244,6 +280,13 @@ void WiredTigerRecoveryUnit::_txnOpen(OperationContext* opCtx) {
     if (_readFromMajorityCommittedSnapshot) {
         _majorityCommittedSnapshot =
             _sessionCache->snapshotManager().beginTransactionOnCommittedSnapshot(s);
+    } else if (_readFromLastAppliedSnapshot) {
+        Date_t createdAt;
+        _lastAppliedSnapshot =
+            _sessionCache->snapshotManager().beginTransactionOnLastAppliedSnapshot(s, &createdAt);
+        lastAppliedSnapshotTransactions.fetchAndAdd(1);
+        lastAppliedSnapshotTotalAgeMillis.fetchAndAdd(
+            durationCount<Milliseconds>(Date_t::now() - createdAt));
     } else {
         invariantWTOK(s->begin_transaction(s, NULL));
     }
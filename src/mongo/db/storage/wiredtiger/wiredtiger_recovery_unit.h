@@ -80,6 +80,9 @@ public:
 
     boost::optional<SnapshotName> getMajorityCommittedSnapshot() const final;
 
+    Status setReadFromLastAppliedSnapshot() final;
+    boost::optional<SnapshotName> getLastAppliedSnapshot() const final;
+
     // ---- WT STUFF
 
     WiredTigerSession* getSession(OperationContext* opCtx);
@@ -135,6 +138,8 @@ private:
     RecordId _oplogReadTill;
     bool _readFromMajorityCommittedSnapshot = false;
     SnapshotName _majorityCommittedSnapshot = SnapshotName::min();
+    bool _readFromLastAppliedSnapshot = false;
+    SnapshotName _lastAppliedSnapshot = SnapshotName::min();
     std::unique_ptr<Timer> _timer;
 
     typedef std::vector<std::unique_ptr<Change>> Changes;
@@ -35,14 +35,20 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 
+#include <algorithm>
+
 #include "mongo/base/error_codes.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/journal_listener.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/threadlocal.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -144,11 +150,50 @@ uint64_t WiredTigerSession::genTableId() {
 
 // -----------------------
 
+namespace {
+
+// Number of session slots per hardware thread. More than one, so that the threads of a busy server
+// mostly land in slots of their own even with more threads than cores.
+const size_t kSessionSlotsPerCore = 4;
+
+size_t numSessionSlots() {
+    return std::max(1U, stdx::thread::hardware_concurrency()) * kSessionSlotsPerCore;
+}
+
+// Hands out session slot affinities to threads in round-robin order.
+AtomicUInt32 nextSessionSlotAffinity;
+
+// One more than the session slot affinity of this thread, or zero if it has not been assigned.
+MONGO_TRIVIALLY_CONSTRUCTIBLE_THREAD_LOCAL uint32_t sessionSlotAffinity;
+
+// Upper bound of the time a group commit flush waits for more writers to join its batch. The delay
+// is at most half the duration of a flush, and only applies when flushes serve several writers.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerJournalGroupCommitMaxDelayMicros, int, 1000);
+
+AtomicUInt64 groupCommitFlushes;
+AtomicUInt64 groupCommitWaiters;
+AtomicUInt64 groupCommitTotalWaitMicros;
+AtomicUInt64 groupCommitTotalDelayMicros;
+AtomicUInt64 groupCommitTotalFlushMicros;
+AtomicUInt64 groupCommitMaxBatchSize;
+
+}  // namespace
+
 WiredTigerSessionCache::WiredTigerSessionCache(WiredTigerKVEngine* engine)
-    : _engine(engine), _conn(engine->getConnection()), _snapshotManager(_conn), _shuttingDown(0) {}
+    : _engine(engine),
+      _conn(engine->getConnection()),
+      _snapshotManager(_conn),
+      _shuttingDown(0),
+      _numSessionSlots(numSessionSlots()),
+      _sessionSlots(new SessionSlot[_numSessionSlots]) {}
 
 WiredTigerSessionCache::WiredTigerSessionCache(WT_CONNECTION* conn)
-    : _engine(NULL), _conn(conn), _snapshotManager(_conn), _shuttingDown(0) {}
+    : _engine(NULL),
+      _conn(conn),
+      _snapshotManager(_conn),
+      _shuttingDown(0),
+      _numSessionSlots(numSessionSlots()),
+      _sessionSlots(new SessionSlot[_numSessionSlots]) {}
 
 WiredTigerSessionCache::~WiredTigerSessionCache() {
     shuttingDown();
@@ -204,6 +249,23 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint) {
         return;
     }
 
+    {
+        stdx::unique_lock<stdx::mutex> lk(_groupCommitMutex);
+        if (_groupCommitEnabled) {
+            Timer waitTimer;
+            const uint64_t flush = _flushesStarted + 1;
+            ++_groupCommitWaiters;
+            _flushRequested.notify_one();
+            _flushCompleted.wait(
+                lk, [&] { return _flushesCompleted >= flush || !_groupCommitEnabled; });
+            if (_flushesCompleted >= flush) {
+                groupCommitTotalWaitMicros.fetchAndAdd(waitTimer.micros());
+                return;
+            }
+            // Group commit was disabled before our flush started, so flush on our own.
+        }
+    }
+
     uint32_t start = _lastSyncTime.load();
     // Do the remainder in a critical section that ensures only a single thread at a time
     // will attempt to synchronize.
@@ -216,6 +278,88 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint) {
     _lastSyncTime.store(current + 1);
 
     // Nobody has synched yet, so we have to sync ourselves.
+    _flushJournal();
+}
+
+void WiredTigerSessionCache::enableGroupCommit() {
+    stdx::lock_guard<stdx::mutex> lk(_groupCommitMutex);
+    _groupCommitEnabled = true;
+}
+
+void WiredTigerSessionCache::disableGroupCommit() {
+    stdx::lock_guard<stdx::mutex> lk(_groupCommitMutex);
+    _groupCommitEnabled = false;
+    _groupCommitWaiters = 0;
+    _flushRequested.notify_all();
+    _flushCompleted.notify_all();
+}
+
+void WiredTigerSessionCache::flushJournalForWaiters(Milliseconds interval) {
+    stdx::unique_lock<stdx::mutex> lk(_groupCommitMutex);
+    _flushRequested.wait_for(lk, interval.toSystemDuration(), [&] {
+        return _groupCommitWaiters > 0 || !_groupCommitEnabled;
+    });
+    if (!_groupCommitEnabled) {
+        return;
+    }
+
+    // A flush which served several writers suggests more are about to wait, so let them join this
+    // batch for a fraction of a flush, or until as many are waiting as last time.
+    if (_groupCommitWaiters > 0 && _lastBatchSize > 1) {
+        const Microseconds delay =
+            std::min(Microseconds(wiredTigerJournalGroupCommitMaxDelayMicros.load()),
+                     _averageFlushTime / 2);
+        if (delay > Microseconds(0)) {
+            Timer delayTimer;
+            _flushRequested.wait_for(lk, delay.toSystemDuration(), [&] {
+                return _groupCommitWaiters >= _lastBatchSize || !_groupCommitEnabled;
+            });
+            groupCommitTotalDelayMicros.fetchAndAdd(delayTimer.micros());
+        }
+    }
+
+    const size_t batchSize = _groupCommitWaiters;
+    _groupCommitWaiters = 0;
+    const uint64_t flush = ++_flushesStarted;
+    lk.unlock();
+
+    Timer flushTimer;
+    _flushJournal();
+    const Microseconds flushTime(flushTimer.micros());
+
+    lk.lock();
+    _flushesCompleted = flush;
+    _lastBatchSize = batchSize;
+    _averageFlushTime = (_averageFlushTime * 7 + flushTime) / 8;
+    _flushCompleted.notify_all();
+    lk.unlock();
+
+    groupCommitFlushes.fetchAndAdd(1);
+    groupCommitWaiters.fetchAndAdd(batchSize);
+    groupCommitTotalFlushMicros.fetchAndAdd(durationCount<Microseconds>(flushTime));
+    uint64_t maxBatchSize = groupCommitMaxBatchSize.load();
+    while (batchSize > maxBatchSize) {
+        const uint64_t actual = groupCommitMaxBatchSize.compareAndSwap(maxBatchSize, batchSize);
+        if (actual == maxBatchSize) {
+            break;
+        }
+        maxBatchSize = actual;
+    }
+}
+
+// static
+void WiredTigerSessionCache::appendGlobalStats(BSONObjBuilder& b) {
+    BSONObjBuilder bb(b.subobjStart("journalGroupCommit"));
+    bb.append("flushes", static_cast<long long>(groupCommitFlushes.load()));
+    bb.append("waiters", static_cast<long long>(groupCommitWaiters.load()));
+    bb.append("maxBatchSize", static_cast<long long>(groupCommitMaxBatchSize.load()));
+    bb.append("totalWaitMicros", static_cast<long long>(groupCommitTotalWaitMicros.load()));
+    bb.append("totalDelayMicros", static_cast<long long>(groupCommitTotalDelayMicros.load()));
+    bb.append("totalFlushMicros", static_cast<long long>(groupCommitTotalFlushMicros.load()));
+    bb.done();
+}
+
+void WiredTigerSessionCache::_flushJournal() {
     auto session = getSession();
     WT_SESSION* s = session->getSession();
 
@@ -243,6 +387,15 @@ void WiredTigerSessionCache::closeAllCursors() {
     for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
         (*i)->closeAllCursors();
     }
+
+    // Sessions parked in the slots are idle too, but can only be touched once taken out of their
+    // slot, so move them to the shared list.
+    for (size_t i = 0; i < _numSessionSlots; i++) {
+        if (WiredTigerSession* session = _sessionSlots[i].session.swap(nullptr)) {
+            session->closeAllCursors();
+            _sessions.push_back(session);
+        }
+    }
 }
 
 void WiredTigerSessionCache::closeAll() {
@@ -255,6 +408,12 @@ void WiredTigerSessionCache::closeAll() {
         _sessions.swap(swap);
     }
 
+    for (size_t i = 0; i < _numSessionSlots; i++) {
+        if (WiredTigerSession* session = _sessionSlots[i].session.swap(nullptr)) {
+            swap.push_back(session);
+        }
+    }
+
     for (SessionCache::iterator i = swap.begin(); i != swap.end(); i++) {
         delete (*i);
     }
@@ -269,6 +428,17 @@ UniqueWiredTigerSession WiredTigerSessionCache::getSession() {
     // operations should be allowed to start.
     invariant(!(_shuttingDown.loadRelaxed() & kShuttingDownMask));
 
+    // Prefer the session this thread released last, which still has its cursors cached.
+    if (WiredTigerSession* slotSession = _getSessionSlot().session.swap(nullptr)) {
+        if (slotSession->_getEpoch() == _epoch.load()) {
+            return UniqueWiredTigerSession(slotSession);
+        }
+
+        // closeAll() ran between the check of the epoch in releaseSession() and the session being
+        // parked in the slot.
+        delete slotSession;
+    }
+
     {
         stdx::lock_guard<stdx::mutex> lock(_cacheLock);
         if (!_sessions.empty()) {
@@ -324,10 +494,16 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
     uint64_t currentEpoch = _epoch.load();
 
     if (session->_getEpoch() == currentEpoch) {  // check outside of lock to reduce contention
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        if (session->_getEpoch() == _epoch.load()) {  // recheck inside the lock for correctness
+        // Park the session in this thread's slot if it is free. A concurrent closeAll() may leave
+        // it there with an old epoch, which getSession() checks for.
+        if (_getSessionSlot().session.compareAndSwap(nullptr, session) == nullptr) {
             returnedToCache = true;
-            _sessions.push_back(session);
+        } else {
+            stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+            if (session->_getEpoch() == _epoch.load()) {  // recheck inside the lock for correctness
+                returnedToCache = true;
+                _sessions.push_back(session);
+            }
         }
     } else
         invariant(session->_getEpoch() < currentEpoch);
@@ -339,6 +515,12 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
         _engine->dropSomeQueuedIdents();
 }
 
+WiredTigerSessionCache::SessionSlot& WiredTigerSessionCache::_getSessionSlot() {
+    if (!sessionSlotAffinity) {
+        sessionSlotAffinity = nextSessionSlotAffinity.fetchAndAdd(1) + 1;
+    }
+    return _sessionSlots[(sessionSlotAffinity - 1) % _numSessionSlots];
+}
 
 void WiredTigerSessionCache::setJournalListener(JournalListener* jl) {
     stdx::unique_lock<stdx::mutex> lk(_journalListenerMutex);
@@ -32,6 +32,7 @@
 #pragma once
 
 #include <list>
+#include <memory>
 #include <string>
 
 #include <boost/thread/shared_mutex.hpp>
@@ -40,11 +41,14 @@
 #include "mongo/db/storage/journal_listener.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_snapshot_manager.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/spin_lock.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
+class BSONObjBuilder;
 class WiredTigerKVEngine;
 class WiredTigerSessionCache;
 
@@ -184,9 +188,31 @@ public:
      * Waits until all commits that happened before this call are durable, either by flushing
      * the log or forcing a checkpoint if forceCheckpoint is true or the journal is disabled.
      * Uses a temporary session. Safe to call without any locks, even during shutdown.
+     *
+     * While group commit is enabled, waiting for the journal is handed over to the journal
+     * flusher thread, which makes the commits of every concurrent waiter durable with one flush.
      */
     void waitUntilDurable(bool forceCheckpoint);
 
+    /**
+     * Enables and disables group commit. Must only be enabled while a journal flusher thread
+     * calls flushJournalForWaiters() in a loop. Disabling it wakes up the flusher and makes any
+     * pending waiters flush on their own.
+     */
+    void enableGroupCommit();
+    void disableGroupCommit();
+
+    /**
+     * Runs one round of group commit on the journal flusher thread. Waits up to 'interval' for a
+     * writer to wait for durability and, if the previous flush served several writers, delays the
+     * flush a little to let more of them join the batch. Then makes the commits of the whole batch
+     * durable with a single flush, which is also done when 'interval' expires without waiters.
+     * Returns without flushing if group commit is disabled.
+     */
+    void flushJournalForWaiters(Milliseconds interval);
+
+    static void appendGlobalStats(BSONObjBuilder& b);
+
     WT_CONNECTION* conn() const {
         return _conn;
     }
@@ -219,6 +245,19 @@ private:
     typedef std::vector<WiredTigerSession*> SessionCache;
     SessionCache _sessions;
 
+    // Each thread has an affinity for one of these slots, which holds at most one released session.
+    // A thread returns its session to its own slot and takes it back on its next getSession(), so
+    // in the common case the session, along with its cached cursors, stays with the thread and
+    // neither call touches _cacheLock. When the slot is empty or already taken, the shared
+    // _sessions list above is used instead. Each slot is padded to a cache line so that threads
+    // with different slots do not contend.
+    struct SessionSlot {
+        AtomicWord<WiredTigerSession*> session{nullptr};
+        char padding[64 - sizeof(AtomicWord<WiredTigerSession*>)];
+    };
+    const size_t _numSessionSlots;
+    std::unique_ptr<SessionSlot[]> _sessionSlots;
+
     // Bumped when all open sessions need to be closed
     AtomicUInt64 _epoch;  // atomic so we can check it outside of the lock
 
@@ -229,6 +268,20 @@ private:
     AtomicUInt32 _lastSyncTime;
     stdx::mutex _lastSyncMutex;
 
+    // Group commit state, all guarded by _groupCommitMutex. A writer waiting for durability needs
+    // the first flush to start after it registered, as one in progress may miss its commits.
+    stdx::mutex _groupCommitMutex;
+    stdx::condition_variable _flushRequested;  // Signals the flusher that writers are waiting.
+    stdx::condition_variable _flushCompleted;  // Signals waiters that a flush has completed.
+    bool _groupCommitEnabled = false;
+    size_t _groupCommitWaiters = 0;
+    uint64_t _flushesStarted = 0;
+    uint64_t _flushesCompleted = 0;
+    // Feedback for the delay before a flush: the number of waiters of the last flush, and a
+    // moving average of the duration of flushes.
+    size_t _lastBatchSize = 0;
+    Microseconds _averageFlushTime{0};
+
     // Notified when we commit to the journal.
     JournalListener* _journalListener = &NoOpJournalListener::instance;
     // Protects _journalListener.
@@ -239,6 +292,17 @@ private:
      * session and releasing it, the session is directly released. This method is thread safe.
      */
     void releaseSession(WiredTigerSession* session);
+
+    /**
+     * Makes all commits that happened before this call durable, flushing the journal when
+     * available and taking a checkpoint otherwise.
+     */
+    void _flushJournal();
+
+    /**
+     * Returns the session slot the calling thread has an affinity for.
+     */
+    SessionSlot& _getSessionSlot();
 };
 
 /**
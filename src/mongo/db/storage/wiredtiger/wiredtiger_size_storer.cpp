@@ -45,7 +45,9 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -53,6 +55,11 @@ using std::string;
 
 namespace {
 int MAGIC = 123123;
+
+// Totals over all syncCache() calls that had something to write.
+AtomicUInt64 syncCount;
+AtomicUInt64 syncEntriesWritten;
+AtomicUInt64 syncTotalMicros;
 }
 
 WiredTigerSizeStorer::WiredTigerSizeStorer(WT_CONNECTION* conn, const std::string& storageUri)
@@ -86,36 +93,58 @@ void WiredTigerSizeStorer::_checkMagic() const {
     invariant(_magic == MAGIC);
 }
 
-void WiredTigerSizeStorer::onCreate(WiredTigerRecordStore* rs,
-                                    long long numRecords,
-                                    long long dataSize) {
+std::shared_ptr<WiredTigerSizeStorer::SizeInfo> WiredTigerSizeStorer::onCreate(
+    WiredTigerRecordStore* rs, long long numRecords, long long dataSize) {
     _checkMagic();
     stdx::lock_guard<stdx::mutex> lk(_entriesMutex);
-    Entry& entry = _entries[rs->getURI()];
-    entry.rs = rs;
-    entry.numRecords = numRecords;
-    entry.dataSize = dataSize;
-    entry.dirty = true;
+    auto& entry = _entries[rs->getSizeStorerURI()];
+    if (!entry) {
+        entry = std::make_shared<SizeInfo>(rs->getSizeStorerURI());
+    }
+    entry->rs = rs;
+    entry->numRecords.store(numRecords);
+    entry->dataSize.store(dataSize);
+    _markDirty_inlock(entry);
+    return entry;
 }
 
 void WiredTigerSizeStorer::onDestroy(WiredTigerRecordStore* rs) {
     _checkMagic();
     stdx::lock_guard<stdx::mutex> lk(_entriesMutex);
-    Entry& entry = _entries[rs->getURI()];
-    entry.numRecords = rs->numRecords(NULL);
-    entry.dataSize = rs->dataSize(NULL);
-    entry.dirty = true;
-    entry.rs = NULL;
+    auto& entry = _entries[rs->getSizeStorerURI()];
+    if (!entry) {
+        entry = std::make_shared<SizeInfo>(rs->getSizeStorerURI());
+    }
+    entry->numRecords.store(rs->numRecords(NULL));
+    entry->dataSize.store(rs->dataSize(NULL));
+    entry->rs = NULL;
+    _markDirty_inlock(entry);
+}
+
+void WiredTigerSizeStorer::markDirty(const std::shared_ptr<SizeInfo>& sizeInfo) {
+    if (sizeInfo->dirty.load()) {
+        return;
+    }
+    stdx::lock_guard<stdx::mutex> lk(_entriesMutex);
+    _markDirty_inlock(sizeInfo);
 }
 
+void WiredTigerSizeStorer::_markDirty_inlock(const std::shared_ptr<SizeInfo>& sizeInfo) {
+    if (!sizeInfo->dirty.swap(true)) {
+        _dirtyEntries.push_back(sizeInfo);
+    }
+}
 
 void WiredTigerSizeStorer::storeToCache(StringData uri, long long numRecords, long long dataSize) {
     _checkMagic();
     stdx::lock_guard<stdx::mutex> lk(_entriesMutex);
-    Entry& entry = _entries[uri.toString()];
-    entry.numRecords = numRecords;
-    entry.dataSize = dataSize;
-    entry.dirty = true;
+    auto& entry = _entries[uri.toString()];
+    if (!entry) {
+        entry = std::make_shared<SizeInfo>(uri.toString());
+    }
+    entry->numRecords.store(numRecords);
+    entry->dataSize.store(dataSize);
+    _markDirty_inlock(entry);
 }
 
 void WiredTigerSizeStorer::loadFromCache(StringData uri,
@@ -129,8 +158,39 @@ void WiredTigerSizeStorer::loadFromCache(StringData uri,
         *dataSize = 0;
         return;
     }
-    *numRecords = it->second.numRecords;
-    *dataSize = it->second.dataSize;
+    *numRecords = it->second->numRecords.load();
+    *dataSize = it->second->dataSize.load();
+}
+
+void WiredTigerSizeStorer::clearFromCache(StringData uri) {
+    _checkMagic();
+    stdx::lock_guard<stdx::mutex> lk(_entriesMutex);
+    Map::const_iterator it = _entries.find(uri.toString());
+    if (it == _entries.end()) {
+        return;
+    }
+    it->second->numRecords.store(0);
+    it->second->dataSize.store(0);
+    _markDirty_inlock(it->second);
+}
+
+long long WiredTigerSizeStorer::dataSizeOfGroupedTable(StringData uri) const {
+    _checkMagic();
+    // All the keys of the table sort between "<uri>#" and "<uri>$".
+    const std::string begin = uri.toString() + '#';
+    const std::string end = uri.toString() + '$';
+
+    long long total = 0;
+    stdx::lock_guard<stdx::mutex> lk(_entriesMutex);
+    for (auto it = _entries.lower_bound(begin); it != _entries.end() && it->first < end; ++it) {
+        const auto& entry = it->second;
+        total += entry->rs ? entry->rs->dataSize(NULL) : entry->dataSize.load();
+    }
+    return total;
+}
+
+std::string WiredTigerSizeStorer::prefixedUri(StringData uri, int64_t prefix) {
+    return str::stream() << uri << '#' << prefix;
 }
 
 void WiredTigerSizeStorer::fillCache() {
@@ -158,67 +218,65 @@ void WiredTigerSizeStorer::fillCache() {
 
             LOG(2) << "WiredTigerSizeStorer::loadFrom " << uriKey << " -> " << redact(data);
 
-            Entry& e = m[uriKey];
-            e.numRecords = data["numRecords"].safeNumberLong();
-            e.dataSize = data["dataSize"].safeNumberLong();
-            e.dirty = false;
-            e.rs = NULL;
+            auto entry = std::make_shared<SizeInfo>(uriKey);
+            entry->numRecords.store(data["numRecords"].safeNumberLong());
+            entry->dataSize.store(data["dataSize"].safeNumberLong());
+            m[uriKey] = std::move(entry);
         }
     }
 
     stdx::lock_guard<stdx::mutex> lk(_entriesMutex);
     _entries.swap(m);
+    _dirtyEntries.clear();
 }
 
 void WiredTigerSizeStorer::syncCache(bool syncToDisk) {
     stdx::lock_guard<stdx::mutex> cursorLock(_cursorMutex);
     _checkMagic();
 
-    Map myMap;
+    Timer timer;
+    std::vector<std::shared_ptr<SizeInfo>> dirtyEntries;
     {
         stdx::lock_guard<stdx::mutex> lk(_entriesMutex);
-        for (Map::iterator it = _entries.begin(); it != _entries.end(); ++it) {
-            std::string uriKey = it->first;
-            Entry& entry = it->second;
-            if (entry.rs) {
-                if (entry.dataSize != entry.rs->dataSize(NULL)) {
-                    entry.dataSize = entry.rs->dataSize(NULL);
-                    entry.dirty = true;
-                }
-                if (entry.numRecords != entry.rs->numRecords(NULL)) {
-                    entry.numRecords = entry.rs->numRecords(NULL);
-                    entry.dirty = true;
-                }
+        dirtyEntries.swap(_dirtyEntries);
+        for (auto&& entry : dirtyEntries) {
+            // Clear the flag before reading the sizes so that any later change marks the entry
+            // dirty again.
+            entry->dirty.store(false);
+            if (entry->rs) {
+                entry->numRecords.store(entry->rs->numRecords(NULL));
+                entry->dataSize.store(entry->rs->dataSize(NULL));
             }
-
-            if (!entry.dirty)
-                continue;
-            myMap[uriKey] = entry;
         }
     }
 
-    if (myMap.empty())
+    if (dirtyEntries.empty())
         return;  // Nothing to do.
 
+    // If the entries don't make it to the table, write them on the next call instead.
+    ScopeGuard requeuer = MakeGuard([&] {
+        stdx::lock_guard<stdx::mutex> lk(_entriesMutex);
+        for (auto&& entry : dirtyEntries) {
+            _markDirty_inlock(entry);
+        }
+    });
+
     WT_SESSION* session = _session.getSession();
     invariantWTOK(session->begin_transaction(session, syncToDisk ? "sync=true" : ""));
     ScopeGuard rollbacker = MakeGuard(session->rollback_transaction, session, "");
 
-    for (Map::iterator it = myMap.begin(); it != myMap.end(); ++it) {
-        string uriKey = it->first;
-        Entry& entry = it->second;
-
+    for (auto&& entry : dirtyEntries) {
         BSONObj data;
         {
             BSONObjBuilder b;
-            b.append("numRecords", entry.numRecords);
-            b.append("dataSize", entry.dataSize);
+            b.append("numRecords", static_cast<long long>(entry->numRecords.load()));
+            b.append("dataSize", static_cast<long long>(entry->dataSize.load()));
             data = b.obj();
         }
 
-        LOG(2) << "WiredTigerSizeStorer::storeInto " << uriKey << " -> " << redact(data);
+        LOG(2) << "WiredTigerSizeStorer::storeInto " << entry->uri << " -> " << redact(data);
 
-        WiredTigerItem key(uriKey.c_str(), uriKey.size());
+        WiredTigerItem key(entry->uri.c_str(), entry->uri.size());
         WiredTigerItem value(data.objdata(), data.objsize());
         _cursor->set_key(_cursor, key.Get());
         _cursor->set_value(_cursor, value.Get());
@@ -229,12 +287,18 @@ void WiredTigerSizeStorer::syncCache(bool syncToDisk) {
 
     rollbacker.Dismiss();
     invariantWTOK(session->commit_transaction(session, NULL));
+    requeuer.Dismiss();
 
-    {
-        stdx::lock_guard<stdx::mutex> lk(_entriesMutex);
-        for (Map::iterator it = _entries.begin(); it != _entries.end(); ++it) {
-            it->second.dirty = false;
-        }
-    }
+    syncCount.fetchAndAdd(1);
+    syncEntriesWritten.fetchAndAdd(dirtyEntries.size());
+    syncTotalMicros.fetchAndAdd(timer.micros());
+}
+
+void WiredTigerSizeStorer::appendGlobalStats(BSONObjBuilder& b) {
+    BSONObjBuilder bb(b.subobjStart("sizeStorer"));
+    bb.append("syncs", static_cast<long long>(syncCount.load()));
+    bb.append("entriesWritten", static_cast<long long>(syncEntriesWritten.load()));
+    bb.append("totalSyncMicros", static_cast<long long>(syncTotalMicros.load()));
+    bb.done();
 }
 }
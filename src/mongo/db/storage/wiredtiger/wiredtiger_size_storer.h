@@ -32,50 +32,101 @@
 #pragma once
 
 #include <map>
+#include <memory>
 #include <string>
+#include <vector>
 #include <wiredtiger.h>
 
 #include "mongo/base/string_data.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
 
 namespace mongo {
 
+class BSONObjBuilder;
 class WiredTigerRecordStore;
 class WiredTigerSession;
 
 class WiredTigerSizeStorer {
 public:
+    /**
+     * The cached sizes of a single table. Record stores keep a reference to the entry of their
+     * table so that marking it dirty does not need a lookup.
+     */
+    class SizeInfo {
+    public:
+        explicit SizeInfo(std::string uri) : uri(std::move(uri)) {}
+
+        const std::string uri;
+        AtomicInt64 numRecords;
+        AtomicInt64 dataSize;
+
+        // True while this entry is on the list of entries to write on the next syncCache().
+        AtomicWord<bool> dirty{false};
+
+        // The record store currently attached to this table, if any. Guarded by _entriesMutex.
+        WiredTigerRecordStore* rs = nullptr;  // not owned
+    };
+
     WiredTigerSizeStorer(WT_CONNECTION* conn, const std::string& storageUri);
     ~WiredTigerSizeStorer();
 
-    void onCreate(WiredTigerRecordStore* rs, long long nr, long long ds);
+    /**
+     * Attaches 'rs' to the entry of its table and returns that entry to be passed to markDirty().
+     */
+    std::shared_ptr<SizeInfo> onCreate(WiredTigerRecordStore* rs, long long nr, long long ds);
     void onDestroy(WiredTigerRecordStore* rs);
 
+    /**
+     * Records that the sizes of the record store attached to 'sizeInfo' changed, so that the next
+     * syncCache() writes them. Cheap once the entry is already dirty.
+     */
+    void markDirty(const std::shared_ptr<SizeInfo>& sizeInfo);
+
     void storeToCache(StringData uri, long long numRecords, long long dataSize);
 
     void loadFromCache(StringData uri, long long* numRecords, long long* dataSize) const;
 
+    /**
+     * Resets the cached sizes of 'uri' to zero if it has an entry. Used when the data of a
+     * grouped record store is dropped, since its shared table and thus its entry may live on.
+     */
+    void clearFromCache(StringData uri);
+
+    /**
+     * Returns the total data size of the grouped record stores sharing the table 'uri', as the
+     * sum of their entries keyed by prefixedUri().
+     */
+    long long dataSizeOfGroupedTable(StringData uri) const;
+
+    /**
+     * Returns the key of the sizes of the record store stored under 'prefix' in the shared table
+     * 'uri'. Grouped record stores can't share the key of their table.
+     */
+    static std::string prefixedUri(StringData uri, int64_t prefix);
+
     /**
      * Loads from the underlying table.
      */
     void fillCache();
 
     /**
-     * Writes all changes to the underlying table.
+     * Writes all changes to the underlying table. Only the entries that changed since the last
+     * call are visited.
      */
     void syncCache(bool syncToDisk);
 
+    /**
+     * Appends the cost of the syncCache() calls so far, across all size storers.
+     */
+    static void appendGlobalStats(BSONObjBuilder& b);
+
 private:
     void _checkMagic() const;
 
-    struct Entry {
-        Entry() : numRecords(0), dataSize(0), dirty(false), rs(NULL) {}
-        long long numRecords;
-        long long dataSize;
-        bool dirty;
-        WiredTigerRecordStore* rs;  // not owned
-    };
+    // Adds 'sizeInfo' to _dirtyEntries unless it is already there. Requires _entriesMutex.
+    void _markDirty_inlock(const std::shared_ptr<SizeInfo>& sizeInfo);
 
     int _magic;
 
@@ -84,8 +135,9 @@ private:
     const WiredTigerSession _session;
     WT_CURSOR* _cursor;  // pointer is const after constructor
 
-    typedef std::map<std::string, Entry> Map;
+    typedef std::map<std::string, std::shared_ptr<SizeInfo>> Map;
     Map _entries;
+    std::vector<std::shared_ptr<SizeInfo>> _dirtyEntries;
     mutable stdx::mutex _entriesMutex;
 };
 }
@@ -50,7 +50,17 @@ Status WiredTigerSnapshotManager::createSnapshot(OperationContext* opCtx,
                                                  const SnapshotName& name) {
     auto session = WiredTigerRecoveryUnit::get(opCtx)->getSession(opCtx)->getSession();
     const std::string config = str::stream() << "name=" << name.asU64();
-    return wtRCToStatus(session->snapshot(session, config.c_str()));
+    Status status = wtRCToStatus(session->snapshot(session, config.c_str()));
+    if (!status.isOK()) {
+        return status;
+    }
+
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    if (!_lastAppliedSnapshot || *_lastAppliedSnapshot < name) {
+        _lastAppliedSnapshot = name;
+        _lastAppliedSnapshotCreatedAt = Date_t::now();
+    }
+    return Status::OK();
 }
 
 void WiredTigerSnapshotManager::setCommittedSnapshot(const SnapshotName& name) {
@@ -74,6 +84,7 @@ void WiredTigerSnapshotManager::cleanupUnneededSnapshots() {
 void WiredTigerSnapshotManager::dropAllSnapshots() {
     stdx::lock_guard<stdx::mutex> lock(_mutex);
     _committedSnapshot = boost::none;
+    _lastAppliedSnapshot = boost::none;
     invariantWTOK(_session->snapshot(_session, "drop=(all)"));
 }
 
@@ -106,4 +117,27 @@ SnapshotName WiredTigerSnapshotManager::beginTransactionOnCommittedSnapshot(
     return *_committedSnapshot;
 }
 
+boost::optional<SnapshotName> WiredTigerSnapshotManager::getLastAppliedSnapshot() const {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    return _lastAppliedSnapshot;
+}
+
+SnapshotName WiredTigerSnapshotManager::beginTransactionOnLastAppliedSnapshot(
+    WT_SESSION* session, Date_t* createdAt) const {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+
+    uassert(ErrorCodes::SnapshotUnavailable,
+            "Last applied snapshot disappeared while running operation",
+            _lastAppliedSnapshot);
+
+    StringBuilder config;
+    config << "snapshot=" << _lastAppliedSnapshot->asU64();
+    invariantWTOK(session->begin_transaction(session, config.str().c_str()));
+
+    if (createdAt) {
+        *createdAt = _lastAppliedSnapshotCreatedAt;
+    }
+    return *_lastAppliedSnapshot;
+}
+
 }  // namespace mongo
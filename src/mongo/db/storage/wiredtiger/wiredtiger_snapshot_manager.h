@@ -36,6 +36,7 @@
 #include "mongo/db/storage/snapshot_manager.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -83,9 +84,27 @@ public:
      */
     boost::optional<SnapshotName> getMinSnapshotForNextCommittedRead() const;
 
+    /**
+     * Starts a transaction on the most recently created snapshot and returns the SnapshotName
+     * used. If 'createdAt' is non-null, it is set to the time that snapshot was created.
+     *
+     * Throws if there is currently no snapshot.
+     */
+    SnapshotName beginTransactionOnLastAppliedSnapshot(WT_SESSION* session,
+                                                       Date_t* createdAt = nullptr) const;
+
+    /**
+     * Returns the name of the most recently created snapshot, or boost::none if there is
+     * currently no snapshot. Snapshots are only created at the boundaries of replication batches,
+     * so this is the last consistent state that was applied.
+     */
+    boost::optional<SnapshotName> getLastAppliedSnapshot() const;
+
 private:
     mutable stdx::mutex _mutex;  // Guards all members.
     boost::optional<SnapshotName> _committedSnapshot;
+    boost::optional<SnapshotName> _lastAppliedSnapshot;
+    Date_t _lastAppliedSnapshotCreatedAt;
     WT_SESSION* _session;  // only used for dropping snapshots.
 };
 }
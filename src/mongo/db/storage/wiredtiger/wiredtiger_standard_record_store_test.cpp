@@ -98,13 +98,18 @@ public:
     }
 
     virtual std::unique_ptr<RecordStore> newNonCappedRecordStore(const std::string& ns) {
+        return newNonCappedRecordStore(ns, CollectionOptions());
+    }
+
+    std::unique_ptr<RecordStore> newNonCappedRecordStore(const std::string& ns,
+                                                         const CollectionOptions& options) {
         WiredTigerRecoveryUnit* ru = new WiredTigerRecoveryUnit(_sessionCache);
         OperationContextNoop opCtx(ru);
         string uri = "table:" + ns;
 
         const bool prefixed = false;
         StatusWith<std::string> result = WiredTigerRecordStore::generateCreateString(
-            kWiredTigerEngineName, ns, CollectionOptions(), "", prefixed);
+            kWiredTigerEngineName, ns, options, "", prefixed);
         ASSERT_TRUE(result.isOK());
         std::string config = result.getValue();
 
@@ -210,6 +215,42 @@ TEST(WiredTigerRecordStoreTest, StorageSizeStatisticsDisabled) {
     ASSERT_THROWS(rs->storageSize(opCtx.get()), UserException);
 }
 
+TEST(WiredTigerRecordStoreTest, ClusteredRecordIdsAreDerivedFromId) {
+    WiredTigerHarnessHelper harnessHelper;
+    CollectionOptions options;
+    options.clustered = true;
+    unique_ptr<RecordStore> rs(harnessHelper.newNonCappedRecordStore("a.b", options));
+    ASSERT_TRUE(rs->isClustered());
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper.newOperationContext());
+    WriteUnitOfWork uow(opCtx.get());
+    for (const BSONObj& obj : {BSON("_id" << 7), BSON("_id" << 3LL), BSON("_id" << 5.0)}) {
+        StatusWith<RecordId> res =
+            rs->insertRecord(opCtx.get(), obj.objdata(), obj.objsize(), false);
+        ASSERT_OK(res.getStatus());
+        ASSERT_EQ(RecordId(obj["_id"].numberLong()), res.getValue());
+    }
+
+    for (const BSONObj& obj : {BSON("_id"
+                                    << "a"),
+                               BSON("_id" << 0),
+                               BSON("_id" << -1),
+                               BSON("_id" << 1.5),
+                               BSON("x" << 1)}) {
+        ASSERT_NOT_OK(
+            rs->insertRecord(opCtx.get(), obj.objdata(), obj.objsize(), false).getStatus());
+    }
+
+    // The records are in _id order rather than insertion order.
+    auto cursor = rs->getCursor(opCtx.get());
+    for (long long id : {3, 5, 7}) {
+        auto record = cursor->next();
+        ASSERT(record);
+        ASSERT_EQ(RecordId(id), record->id);
+    }
+    ASSERT_FALSE(cursor->next());
+}
+
 TEST(WiredTigerRecordStoreTest, SizeStorer1) {
     unique_ptr<WiredTigerHarnessHelper> harnessHelper(new WiredTigerHarnessHelper());
     unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
@@ -298,6 +339,84 @@ TEST(WiredTigerRecordStoreTest, SizeStorer1) {
     rs.reset(NULL);  // this has to be deleted before ss
 }
 
+// Returns the number of size storer entries written to disk by all syncCache() calls so far.
+long long sizeStorerEntriesWritten() {
+    BSONObjBuilder builder;
+    WiredTigerSizeStorer::appendGlobalStats(builder);
+    return builder.obj()["sizeStorer"]["entriesWritten"].numberLong();
+}
+
+TEST(WiredTigerRecordStoreTest, SizeStorerOnlySyncsChangedEntries) {
+    unique_ptr<WiredTigerHarnessHelper> harnessHelper(new WiredTigerHarnessHelper());
+    string indexUri = "table:myindex";
+    WiredTigerSizeStorer ss(harnessHelper->conn(), indexUri);
+
+    // Reopens the table of a new record store with the size storer attached.
+    auto openWithSizeStorer = [&](const std::string& ns) {
+        string uri = checked_cast<WiredTigerRecordStore*>(
+                         harnessHelper->newNonCappedRecordStore(ns).get())
+                         ->getURI();
+
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WiredTigerRecordStore::Params params;
+        params.ns = ns;
+        params.uri = uri;
+        params.engineName = kWiredTigerEngineName;
+        params.isCapped = false;
+        params.isEphemeral = false;
+        params.cappedMaxSize = -1;
+        params.cappedMaxDocs = -1;
+        params.cappedCallback = nullptr;
+        params.sizeStorer = &ss;
+
+        auto ret = stdx::make_unique<StandardWiredTigerRecordStore>(opCtx.get(), params);
+        ret->postConstructorInit(opCtx.get());
+        return ret;
+    };
+
+    auto rs1 = openWithSizeStorer("a.b");
+    auto rs2 = openWithSizeStorer("a.c");
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        WT_SESSION* s =
+            WiredTigerRecoveryUnit::get(opCtx.get())->getSession(opCtx.get())->getSession();
+        invariantWTOK(s->create(s, indexUri.c_str(), ""));
+        uow.commit();
+    }
+
+    // Both record stores are new.
+    long long written = sizeStorerEntriesWritten();
+    ss.syncCache(true);
+    ASSERT_EQUALS(written + 2, sizeStorerEntriesWritten());
+
+    // Nothing changed.
+    ss.syncCache(true);
+    ASSERT_EQUALS(written + 2, sizeStorerEntriesWritten());
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        ASSERT_OK(rs2->insertRecord(opCtx.get(), "a", 2, false).getStatus());
+        uow.commit();
+    }
+
+    // Only the record store that was written to is synced.
+    ss.syncCache(true);
+    ASSERT_EQUALS(written + 3, sizeStorerEntriesWritten());
+
+    long long numRecords;
+    long long dataSize;
+    ss.loadFromCache(rs2->getURI(), &numRecords, &dataSize);
+    ASSERT_EQUALS(1, numRecords);
+    ASSERT_EQUALS(2, dataSize);
+
+    // These have to be deleted before ss.
+    rs1.reset();
+    rs2.reset();
+}
+
 class GoodValidateAdaptor : public ValidateAdaptor {
 public:
     virtual Status validate(const RecordId& recordId, const RecordData& record, size_t* dataSize) {
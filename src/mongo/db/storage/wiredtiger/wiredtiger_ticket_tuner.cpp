@@ -0,0 +1,103 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_ticket_tuner.h"
+
+#include <algorithm>
+
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+constexpr double WiredTigerTicketTuner::kThroughputTolerance;
+constexpr double WiredTigerTicketTuner::kLatencyTolerance;
+constexpr double WiredTigerTicketTuner::kCacheUsedTrigger;
+constexpr double WiredTigerTicketTuner::kCacheDirtyTrigger;
+
+int WiredTigerTicketTuner::nextTicketCount(const Sample& sample,
+                                           int currentTickets,
+                                           int minTickets,
+                                           int maxTickets,
+                                           Decision* decision) {
+    ON_BLOCK_EXIT([&] {
+        _previous = sample;
+        _havePrevious = true;
+    });
+
+    if (sample.cacheUsedRatio >= kCacheUsedTrigger ||
+        sample.cacheDirtyRatio >= kCacheDirtyTrigger) {
+        _increasing = false;
+        const int next =
+            _clamp(currentTickets - std::max(1, currentTickets / 4), minTickets, maxTickets);
+        *decision = next < currentTickets ? Decision::kCachePressureDecrease : Decision::kUnchanged;
+        return next;
+    }
+
+    // Without a previous period to compare with, or operations to measure, there is nothing to
+    // base a change on.
+    if (!_havePrevious || sample.ops == 0 || _previous.ops == 0) {
+        *decision = Decision::kUnchanged;
+        return _clamp(currentTickets, minTickets, maxTickets);
+    }
+
+    const double throughputChange =
+        (static_cast<double>(sample.ops) - _previous.ops) / _previous.ops;
+    if (throughputChange < -kThroughputTolerance) {
+        // The last change made things worse, so undo it and keep going the other way.
+        _increasing = !_increasing;
+    } else if (throughputChange <= kThroughputTolerance) {
+        const double latency = static_cast<double>(sample.latencyMicros) / sample.ops;
+        const double previousLatency =
+            static_cast<double>(_previous.latencyMicros) / _previous.ops;
+        if (latency <= previousLatency * (1 + kLatencyTolerance)) {
+            *decision = Decision::kUnchanged;
+            return _clamp(currentTickets, minTickets, maxTickets);
+        }
+        _increasing = false;
+    }
+
+    const int step = std::max(1, currentTickets / 8);
+    const int next =
+        _clamp(_increasing ? currentTickets + step : currentTickets - step, minTickets, maxTickets);
+    if (next > currentTickets) {
+        *decision = Decision::kIncrease;
+    } else if (next < currentTickets) {
+        *decision = Decision::kDecrease;
+    } else {
+        *decision = Decision::kUnchanged;
+    }
+    return next;
+}
+
+int WiredTigerTicketTuner::_clamp(int tickets, int minTickets, int maxTickets) {
+    return std::max(minTickets, std::min(tickets, maxTickets));
+}
+
+}  // namespace mongo
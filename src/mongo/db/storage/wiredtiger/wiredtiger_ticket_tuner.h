@@ -0,0 +1,91 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace mongo {
+
+/**
+ * Feedback controller for the number of concurrent transaction tickets of one kind, read or write.
+ * It is given a sample of the operations completed and the state of the WiredTiger cache once per
+ * period, and returns the number of tickets to use for the next period.
+ *
+ * The controller climbs towards the ticket count with the best throughput: it keeps moving in the
+ * same direction while throughput improves, and turns around when throughput drops. If throughput
+ * holds but latency grows, more tickets only add queueing inside the storage engine, so it backs
+ * off. Whenever the cache is under eviction pressure, more concurrency only makes application
+ * threads do eviction, so it backs off further regardless of throughput.
+ *
+ * Not thread-safe.
+ */
+class WiredTigerTicketTuner {
+public:
+    struct Sample {
+        // Number of operations completed in the period, and their total latency.
+        uint64_t ops = 0;
+        uint64_t latencyMicros = 0;
+
+        // Fractions of the cache in use and dirty at the end of the period.
+        double cacheUsedRatio = 0;
+        double cacheDirtyRatio = 0;
+    };
+
+    enum class Decision { kUnchanged, kIncrease, kDecrease, kCachePressureDecrease };
+
+    // Relative throughput, or latency, change within which a period counts as unchanged.
+    static constexpr double kThroughputTolerance = 0.05;
+    static constexpr double kLatencyTolerance = 0.1;
+
+    // WiredTiger makes application threads evict pages past these fractions of the cache, which
+    // by default are its eviction_trigger and eviction_dirty_trigger.
+    static constexpr double kCacheUsedTrigger = 0.95;
+    static constexpr double kCacheDirtyTrigger = 0.2;
+
+    /**
+     * Returns the number of tickets for the next period, within ['minTickets', 'maxTickets'],
+     * given the number in use during the period of 'sample'. Sets 'decision' to what changed it.
+     */
+    int nextTicketCount(const Sample& sample,
+                        int currentTickets,
+                        int minTickets,
+                        int maxTickets,
+                        Decision* decision);
+
+private:
+    static int _clamp(int tickets, int minTickets, int maxTickets);
+
+    bool _havePrevious = false;
+    Sample _previous;
+
+    // Whether the last change went up, which the next one repeats while throughput improves.
+    bool _increasing = true;
+};
+
+}  // namespace mongo
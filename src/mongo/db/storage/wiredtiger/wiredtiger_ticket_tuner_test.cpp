@@ -0,0 +1,133 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_ticket_tuner.h"
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using Decision = WiredTigerTicketTuner::Decision;
+
+WiredTigerTicketTuner::Sample makeSample(uint64_t ops, uint64_t latencyMicros) {
+    WiredTigerTicketTuner::Sample sample;
+    sample.ops = ops;
+    sample.latencyMicros = latencyMicros;
+    return sample;
+}
+
+TEST(WiredTigerTicketTunerTest, FirstSampleLeavesTicketsUnchanged) {
+    WiredTigerTicketTuner tuner;
+    Decision decision;
+    ASSERT_EQ(128, tuner.nextTicketCount(makeSample(1000, 1000), 128, 16, 256, &decision));
+    ASSERT(decision == Decision::kUnchanged);
+}
+
+TEST(WiredTigerTicketTunerTest, KeepsIncreasingWhileThroughputImproves) {
+    WiredTigerTicketTuner tuner;
+    Decision decision;
+    int tickets = tuner.nextTicketCount(makeSample(1000, 1000), 128, 16, 256, &decision);
+    tickets = tuner.nextTicketCount(makeSample(1200, 1200), tickets, 16, 256, &decision);
+    ASSERT_EQ(144, tickets);
+    ASSERT(decision == Decision::kIncrease);
+    tickets = tuner.nextTicketCount(makeSample(1400, 1400), tickets, 16, 256, &decision);
+    ASSERT_EQ(162, tickets);
+    ASSERT(decision == Decision::kIncrease);
+}
+
+TEST(WiredTigerTicketTunerTest, TurnsAroundWhenThroughputDrops) {
+    WiredTigerTicketTuner tuner;
+    Decision decision;
+    int tickets = tuner.nextTicketCount(makeSample(1000, 1000), 128, 16, 256, &decision);
+    tickets = tuner.nextTicketCount(makeSample(1200, 1200), tickets, 16, 256, &decision);
+    ASSERT_EQ(144, tickets);
+    tickets = tuner.nextTicketCount(makeSample(1000, 1000), tickets, 16, 256, &decision);
+    ASSERT_EQ(126, tickets);
+    ASSERT(decision == Decision::kDecrease);
+}
+
+TEST(WiredTigerTicketTunerTest, DecreasesWhenLatencyGrowsAtTheSameThroughput) {
+    WiredTigerTicketTuner tuner;
+    Decision decision;
+    int tickets = tuner.nextTicketCount(makeSample(1000, 1000), 128, 16, 256, &decision);
+    tickets = tuner.nextTicketCount(makeSample(1000, 1050), tickets, 16, 256, &decision);
+    ASSERT_EQ(128, tickets);
+    ASSERT(decision == Decision::kUnchanged);
+    tickets = tuner.nextTicketCount(makeSample(1000, 2000), tickets, 16, 256, &decision);
+    ASSERT_EQ(112, tickets);
+    ASSERT(decision == Decision::kDecrease);
+}
+
+TEST(WiredTigerTicketTunerTest, DecreasesUnderCachePressure) {
+    WiredTigerTicketTuner tuner;
+    Decision decision;
+    auto sample = makeSample(1000, 1000);
+    sample.cacheDirtyRatio = 0.25;
+    ASSERT_EQ(96, tuner.nextTicketCount(sample, 128, 16, 256, &decision));
+    ASSERT(decision == Decision::kCachePressureDecrease);
+
+    sample.cacheDirtyRatio = 0;
+    sample.cacheUsedRatio = 0.97;
+    ASSERT_EQ(72, tuner.nextTicketCount(sample, 96, 16, 256, &decision));
+    ASSERT(decision == Decision::kCachePressureDecrease);
+}
+
+TEST(WiredTigerTicketTunerTest, StaysWithinBounds) {
+    WiredTigerTicketTuner tuner;
+    Decision decision;
+    auto sample = makeSample(1000, 1000);
+    sample.cacheUsedRatio = 1;
+    ASSERT_EQ(16, tuner.nextTicketCount(sample, 18, 16, 256, &decision));
+    ASSERT(decision == Decision::kCachePressureDecrease);
+    ASSERT_EQ(16, tuner.nextTicketCount(sample, 16, 16, 256, &decision));
+    ASSERT(decision == Decision::kUnchanged);
+
+    WiredTigerTicketTuner increasingTuner;
+    int tickets = increasingTuner.nextTicketCount(makeSample(1000, 1000), 250, 16, 256, &decision);
+    tickets = increasingTuner.nextTicketCount(makeSample(2000, 2000), tickets, 16, 256, &decision);
+    ASSERT_EQ(256, tickets);
+    ASSERT(decision == Decision::kIncrease);
+}
+
+TEST(WiredTigerTicketTunerTest, IdlePeriodsLeaveTicketsUnchanged) {
+    WiredTigerTicketTuner tuner;
+    Decision decision;
+    int tickets = tuner.nextTicketCount(makeSample(1000, 1000), 128, 16, 256, &decision);
+    tickets = tuner.nextTicketCount(makeSample(0, 0), tickets, 16, 256, &decision);
+    ASSERT_EQ(128, tickets);
+    ASSERT(decision == Decision::kUnchanged);
+    tickets = tuner.nextTicketCount(makeSample(1000, 1000), tickets, 16, 256, &decision);
+    ASSERT_EQ(128, tickets);
+    ASSERT(decision == Decision::kUnchanged);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -317,6 +317,57 @@ StatusWith<uint64_t> WiredTigerUtil::getStatisticsValue(WT_SESSION* session,
     return StatusWith<uint64_t>(value);
 }
 
+Status WiredTigerUtil::appendCacheStats(WT_SESSION* session,
+                                        const std::string& uri,
+                                        BSONObjBuilder* bob) {
+    // Each of these is maintained on the data handle as pages move in and out of the cache, so
+    // unlike the tree walking statistics they cost nothing to read.
+    static const struct {
+        const char* field;
+        int key;
+    } kCacheStats[] = {
+        {"bytesInCache", WT_STAT_DSRC_CACHE_BYTES_INUSE},
+        {"bytesDirtyInCache", WT_STAT_DSRC_CACHE_BYTES_DIRTY},
+        {"bytesReadIntoCache", WT_STAT_DSRC_CACHE_BYTES_READ},
+        {"bytesWrittenFromCache", WT_STAT_DSRC_CACHE_BYTES_WRITE},
+        {"pagesRequestedFromCache", WT_STAT_DSRC_CACHE_PAGES_REQUESTED},
+        {"pagesReadIntoCache", WT_STAT_DSRC_CACHE_READ},
+        {"pagesWrittenFromCache", WT_STAT_DSRC_CACHE_WRITE},
+        {"unmodifiedPagesEvicted", WT_STAT_DSRC_CACHE_EVICTION_CLEAN},
+        {"modifiedPagesEvicted", WT_STAT_DSRC_CACHE_EVICTION_DIRTY},
+    };
+
+    invariant(session);
+    const std::string statsUri = "statistics:" + uri;
+    WT_CURSOR* cursor = NULL;
+    int ret = session->open_cursor(session, statsUri.c_str(), NULL, "statistics=(fast)", &cursor);
+    if (ret != 0) {
+        return Status(ErrorCodes::CursorNotFound,
+                      str::stream() << "unable to open cursor at URI " << statsUri << ". reason: "
+                                    << wiredtiger_strerror(ret));
+    }
+    invariant(cursor);
+    ON_BLOCK_EXIT(cursor->close, cursor);
+
+    for (const auto& stat : kCacheStats) {
+        cursor->set_key(cursor, stat.key);
+        ret = cursor->search(cursor);
+        uint64_t value;
+        if (ret == 0) {
+            ret = cursor->get_value(cursor, NULL, NULL, &value);
+        }
+        if (ret != 0) {
+            return Status(ErrorCodes::NoSuchKey,
+                          str::stream() << "unable to find key " << stat.key << " at URI "
+                                        << statsUri
+                                        << ". reason: "
+                                        << wiredtiger_strerror(ret));
+        }
+        bob->appendNumber(stat.field, _castStatisticsValue<long long>(value));
+    }
+    return Status::OK();
+}
+
 int64_t WiredTigerUtil::getIdentSize(WT_SESSION* s, const std::string& uri) {
     StatusWith<int64_t> result = WiredTigerUtil::getStatisticsValueAs<int64_t>(
         s, "statistics:" + uri, "statistics=(size)", WT_STAT_DSRC_BLOCK_SIZE);
@@ -152,6 +152,15 @@ public:
                                                    const std::string& config,
                                                    int statisticsKey);
 
+    /**
+     * Appends the cache residency and I/O statistics of the table at 'uri' to 'bob'. Only the
+     * fast, per-handle counters are read, through a single statistics cursor, so this is cheap
+     * enough to sample periodically.
+     */
+    static Status appendCacheStats(WT_SESSION* session,
+                                   const std::string& uri,
+                                   BSONObjBuilder* bob);
+
     /**
      * Reads individual statistics using URI and casts to type ResultType.
      * Caps statistics value at max(ResultType) in case of overflow.
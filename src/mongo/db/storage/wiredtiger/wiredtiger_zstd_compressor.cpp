@@ -0,0 +1,259 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_zstd_compressor.h"
+
+#include <wiredtiger.h>
+#include <wiredtiger_ext.h>
+#include <zstd.h>
+
+#include "mongo/base/data_type_endian.h"
+#include "mongo/base/data_view.h"
+#include "mongo/base/init.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_extensions.h"
+#include "mongo/platform/compiler.h"
+#include "mongo/util/concurrency/threadlocal.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+// zstd needs the exact compressed length to decompress, and WiredTiger hands back the whole
+// allocated block, so the length is stored ahead of the frame.
+const size_t kPrefixSize = sizeof(uint64_t);
+
+// Each thread keeps its own compression context, as eviction and checkpoints compress pages
+// from many threads at once and allocating a context costs more than compressing a small page.
+class ZstdContexts {
+    MONGO_DISALLOW_COPYING(ZstdContexts);
+
+public:
+    ZstdContexts() : compression(ZSTD_createCCtx()), decompression(ZSTD_createDCtx()) {}
+
+    ~ZstdContexts() {
+        ZSTD_freeCCtx(compression);
+        ZSTD_freeDCtx(decompression);
+    }
+
+    ZSTD_CCtx* const compression;
+    ZSTD_DCtx* const decompression;
+};
+
+}  // namespace
+
+TSP_DECLARE(ZstdContexts, wiredTigerZstdContexts);
+TSP_DEFINE(ZstdContexts, wiredTigerZstdContexts);
+
+const StringData WiredTigerZstdCompressor::kName = "zstd"_sd;
+const StringData WiredTigerZstdCompressor::kExtensionConfig =
+    "local=(entry=mongo_addWiredTigerZstdCompressors)"_sd;
+
+WiredTigerZstdCompressor::WiredTigerZstdCompressor(int compressionLevel)
+    : _compressionLevel(compressionLevel) {}
+
+std::string WiredTigerZstdCompressor::getNameForLevel(int compressionLevel) {
+    return str::stream() << kName << "-" << compressionLevel;
+}
+
+std::size_t WiredTigerZstdCompressor::getMaxCompressedSize(size_t inputSize) const {
+    return ZSTD_compressBound(inputSize) + kPrefixSize;
+}
+
+StatusWith<std::size_t> WiredTigerZstdCompressor::compressData(ConstDataRange input,
+                                                               DataRange output) const {
+    if (output.length() < kPrefixSize) {
+        return Status{ErrorCodes::BadValue, "Output buffer is too small for a zstd block"};
+    }
+
+    ZstdContexts* contexts = wiredTigerZstdContexts.getMake();
+    size_t outLength = ZSTD_compressCCtx(contexts->compression,
+                                         const_cast<char*>(output.data()) + kPrefixSize,
+                                         output.length() - kPrefixSize,
+                                         input.data(),
+                                         input.length(),
+                                         _compressionLevel);
+    if (ZSTD_isError(outLength)) {
+        return Status{ErrorCodes::BadValue,
+                      str::stream() << "Could not compress block: "
+                                    << ZSTD_getErrorName(outLength)};
+    }
+
+    DataView(const_cast<char*>(output.data()))
+        .write<LittleEndian<uint64_t>>(static_cast<uint64_t>(outLength));
+    return {outLength + kPrefixSize};
+}
+
+StatusWith<std::size_t> WiredTigerZstdCompressor::decompressData(ConstDataRange input,
+                                                                 DataRange output) const {
+    if (input.length() < kPrefixSize) {
+        return Status{ErrorCodes::BadValue, "zstd block is missing its length prefix"};
+    }
+
+    uint64_t frameLength = ConstDataView(input.data()).read<LittleEndian<uint64_t>>();
+    if (frameLength > input.length() - kPrefixSize) {
+        return Status{ErrorCodes::BadValue, "zstd block length exceeds the stored block"};
+    }
+
+    ZstdContexts* contexts = wiredTigerZstdContexts.getMake();
+    size_t length = ZSTD_decompressDCtx(contexts->decompression,
+                                        const_cast<char*>(output.data()),
+                                        output.length(),
+                                        input.data() + kPrefixSize,
+                                        static_cast<size_t>(frameLength));
+    if (ZSTD_isError(length)) {
+        return Status{ErrorCodes::BadValue,
+                      str::stream() << "Could not decompress block: "
+                                    << ZSTD_getErrorName(length)};
+    }
+    return {length};
+}
+
+namespace {
+
+// The WT_COMPRESSOR must come first, WiredTiger hands the callbacks a pointer to it.
+struct ZstdBlockCompressor {
+    ZstdBlockCompressor(WT_EXTENSION_API* api, int compressionLevel)
+        : wtApi(api), compressor(compressionLevel) {}
+
+    WT_COMPRESSOR wtCompressor = {};
+    WT_EXTENSION_API* const wtApi;
+    const WiredTigerZstdCompressor compressor;
+};
+
+ZstdBlockCompressor* getZstdBlockCompressor(WT_COMPRESSOR* wtCompressor) {
+    return reinterpret_cast<ZstdBlockCompressor*>(wtCompressor);
+}
+
+int reportZstdError(WT_COMPRESSOR* wtCompressor, WT_SESSION* session, const Status& status) {
+    WT_EXTENSION_API* wtApi = getZstdBlockCompressor(wtCompressor)->wtApi;
+    (void)wtApi->err_printf(wtApi, session, "%s", status.reason().c_str());
+    return WT_ERROR;
+}
+
+int zstdCompress(WT_COMPRESSOR* wtCompressor,
+                 WT_SESSION* session,
+                 uint8_t* src,
+                 size_t srcLen,
+                 uint8_t* dst,
+                 size_t dstLen,
+                 size_t* resultLen,
+                 int* compressionFailed) {
+    auto result = getZstdBlockCompressor(wtCompressor)
+                      ->compressor.compressData(
+                          ConstDataRange(reinterpret_cast<const char*>(src), srcLen),
+                          DataRange(reinterpret_cast<char*>(dst), dstLen));
+    if (!result.isOK()) {
+        *compressionFailed = 1;
+        return reportZstdError(wtCompressor, session, result.getStatus());
+    }
+
+    // WiredTiger writes the page uncompressed when compressing it does not save any space.
+    *compressionFailed = result.getValue() >= srcLen;
+    if (!*compressionFailed) {
+        *resultLen = result.getValue();
+    }
+    return 0;
+}
+
+int zstdDecompress(WT_COMPRESSOR* wtCompressor,
+                   WT_SESSION* session,
+                   uint8_t* src,
+                   size_t srcLen,
+                   uint8_t* dst,
+                   size_t dstLen,
+                   size_t* resultLen) {
+    auto result = getZstdBlockCompressor(wtCompressor)
+                      ->compressor.decompressData(
+                          ConstDataRange(reinterpret_cast<const char*>(src), srcLen),
+                          DataRange(reinterpret_cast<char*>(dst), dstLen));
+    if (!result.isOK()) {
+        return reportZstdError(wtCompressor, session, result.getStatus());
+    }
+    *resultLen = result.getValue();
+    return 0;
+}
+
+int zstdPreSize(WT_COMPRESSOR* wtCompressor,
+                WT_SESSION* session,
+                uint8_t* src,
+                size_t srcLen,
+                size_t* resultLen) {
+    // zstd compresses fastest when the destination can hold its worst case output.
+    *resultLen = getZstdBlockCompressor(wtCompressor)->compressor.getMaxCompressedSize(srcLen);
+    return 0;
+}
+
+int zstdTerminate(WT_COMPRESSOR* wtCompressor, WT_SESSION* session) {
+    delete getZstdBlockCompressor(wtCompressor);
+    return 0;
+}
+
+int addZstdCompressor(WT_CONNECTION* conn, const std::string& name, int compressionLevel) {
+    auto blockCompressor = new ZstdBlockCompressor(conn->get_extension_api(conn), compressionLevel);
+    blockCompressor->wtCompressor.compress = zstdCompress;
+    blockCompressor->wtCompressor.decompress = zstdDecompress;
+    blockCompressor->wtCompressor.pre_size = zstdPreSize;
+    blockCompressor->wtCompressor.terminate = zstdTerminate;
+
+    int ret = conn->add_compressor(conn, name.c_str(), &blockCompressor->wtCompressor, nullptr);
+    if (ret != 0) {
+        delete blockCompressor;
+    }
+    return ret;
+}
+
+}  // namespace
+
+/**
+ * The entry point WiredTiger looks up in the mongod binary when it loads kExtensionConfig.
+ */
+extern "C" MONGO_COMPILER_API_EXPORT int mongo_addWiredTigerZstdCompressors(WT_CONNECTION* conn,
+                                                                            WT_CONFIG_ARG* config) {
+    int ret = addZstdCompressor(conn,
+                                WiredTigerZstdCompressor::kName.toString(),
+                                WiredTigerZstdCompressor::kDefaultCompressionLevel);
+    for (int level = 1; ret == 0 && level <= ZSTD_maxCLevel(); ++level) {
+        ret = addZstdCompressor(conn, WiredTigerZstdCompressor::getNameForLevel(level), level);
+    }
+    return ret;
+}
+
+MONGO_INITIALIZER_WITH_PREREQUISITES(WiredTigerZstdCompressorExtension,
+                                     ("SetWiredTigerExtensions"))
+(InitializerContext* context) {
+    WiredTigerExtensions::get(getGlobalServiceContext())
+        ->addExtension(WiredTigerZstdCompressor::kExtensionConfig);
+    return Status::OK();
+}
+
+}  // namespace mongo
@@ -0,0 +1,88 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "mongo/base/data_range.h"
+#include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
+
+namespace mongo {
+
+/**
+ * A WiredTiger block compressor backed by zstd.
+ *
+ * Every level zstd supports is registered with WiredTiger under its own name, because WiredTiger
+ * fixes a compressor's settings when it is added to the connection. "zstd" compresses at
+ * kDefaultCompressionLevel and "zstd-<level>" at the given level, so a collection or index picks
+ * its level with "block_compressor=zstd-<level>" in its storageEngine.wiredTiger.configString.
+ * Decompression does not depend on the level.
+ *
+ * Compressed blocks use the same layout as the zstd extension shipped with WiredTiger: a
+ * little-endian 64-bit compressed length followed by the zstd frame.
+ */
+class WiredTigerZstdCompressor {
+public:
+    // Matches the default of the zstd network message compressor.
+    static const int kDefaultCompressionLevel = 3;
+
+    // The name of the compressor that uses kDefaultCompressionLevel.
+    static const StringData kName;
+
+    // The `extensions=[...]` entry that registers the compressors during wiredtiger_open, before
+    // recovery needs to read any table that uses them.
+    static const StringData kExtensionConfig;
+
+    explicit WiredTigerZstdCompressor(int compressionLevel = kDefaultCompressionLevel);
+
+    /**
+     * Returns the block_compressor name a table uses to compress at "compressionLevel".
+     */
+    static std::string getNameForLevel(int compressionLevel);
+
+    std::string getName() const {
+        return getNameForLevel(_compressionLevel);
+    }
+
+    int getCompressionLevel() const {
+        return _compressionLevel;
+    }
+
+    std::size_t getMaxCompressedSize(size_t inputSize) const;
+
+    StatusWith<std::size_t> compressData(ConstDataRange input, DataRange output) const;
+
+    StatusWith<std::size_t> decompressData(ConstDataRange input, DataRange output) const;
+
+private:
+    const int _compressionLevel;
+};
+
+}  // namespace mongo
@@ -0,0 +1,181 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+#include <vector>
+#include <wiredtiger.h>
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_zstd_compressor.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+std::string makeCompressibleData(size_t size) {
+    std::string data;
+    for (int i = 0; data.size() < size; ++i) {
+        data += str::stream() << "{\"_id\": " << i << ", \"status\": \"" << (i % 3 ? "A" : "B")
+                              << "\", \"note\": \"a moderately repetitive document\"}";
+    }
+    data.resize(size);
+    return data;
+}
+
+TEST(WiredTigerZstdCompressorTest, Names) {
+    ASSERT_EQ("zstd", WiredTigerZstdCompressor::kName);
+    ASSERT_EQ("zstd-9", WiredTigerZstdCompressor::getNameForLevel(9));
+    ASSERT_EQ("zstd-1", WiredTigerZstdCompressor(1).getName());
+    ASSERT_EQ(WiredTigerZstdCompressor::kDefaultCompressionLevel,
+              WiredTigerZstdCompressor().getCompressionLevel());
+}
+
+TEST(WiredTigerZstdCompressorTest, RoundTripsAtEachLevel) {
+    const std::string input = makeCompressibleData(32 * 1024);
+    for (int level : {1, 3, 9, 19}) {
+        WiredTigerZstdCompressor compressor(level);
+        std::vector<char> compressed(compressor.getMaxCompressedSize(input.size()));
+        auto compressedSize =
+            compressor.compressData(ConstDataRange(input.data(), input.size()),
+                                    DataRange(compressed.data(), compressed.size()));
+        ASSERT_OK(compressedSize.getStatus());
+        ASSERT_LT(compressedSize.getValue(), input.size());
+
+        // WiredTiger passes the whole allocated block, which may extend past the frame.
+        std::vector<char> decompressed(input.size());
+        auto decompressedSize =
+            compressor.decompressData(ConstDataRange(compressed.data(), compressed.size()),
+                                      DataRange(decompressed.data(), decompressed.size()));
+        ASSERT_OK(decompressedSize.getStatus());
+        ASSERT_EQ(input.size(), decompressedSize.getValue());
+        ASSERT(std::equal(input.begin(), input.end(), decompressed.begin()));
+    }
+}
+
+TEST(WiredTigerZstdCompressorTest, RejectsTruncatedBlock) {
+    const std::string input = makeCompressibleData(4096);
+    WiredTigerZstdCompressor compressor;
+    std::vector<char> compressed(compressor.getMaxCompressedSize(input.size()));
+    auto compressedSize = compressor.compressData(ConstDataRange(input.data(), input.size()),
+                                                  DataRange(compressed.data(), compressed.size()));
+    ASSERT_OK(compressedSize.getStatus());
+
+    std::vector<char> decompressed(input.size());
+    ASSERT_NOT_OK(
+        compressor
+            .decompressData(ConstDataRange(compressed.data(), compressedSize.getValue() - 1),
+                            DataRange(decompressed.data(), decompressed.size()))
+            .getStatus());
+    ASSERT_NOT_OK(compressor
+                      .decompressData(ConstDataRange(compressed.data(), 4),
+                                      DataRange(decompressed.data(), decompressed.size()))
+                      .getStatus());
+}
+
+class ZstdTableTest : public unittest::Test {
+protected:
+    void openConnection() {
+        std::string config = str::stream() << "create,extensions=["
+                                           << WiredTigerZstdCompressor::kExtensionConfig << "]";
+        ASSERT_OK(
+            wtRCToStatus(wiredtiger_open(_dbpath.path().c_str(), NULL, config.c_str(), &_conn)));
+        ASSERT_OK(wtRCToStatus(_conn->open_session(_conn, NULL, NULL, &_session)));
+    }
+
+    void closeConnection() {
+        ASSERT_OK(wtRCToStatus(_conn->close(_conn, NULL)));
+        _conn = NULL;
+        _session = NULL;
+    }
+
+    void tearDown() override {
+        if (_conn) {
+            closeConnection();
+        }
+    }
+
+    unittest::TempDir _dbpath{"wt_zstd_test"};
+    WT_CONNECTION* _conn = NULL;
+    WT_SESSION* _session = NULL;
+};
+
+TEST_F(ZstdTableTest, TablesReadBackAfterRestart) {
+    const std::string value = makeCompressibleData(8192);
+    const std::vector<std::string> compressors = {"zstd", "zstd-1", "zstd-19"};
+
+    openConnection();
+    for (const auto& name : compressors) {
+        std::string uri = "table:" + name;
+        std::string config = "key_format=q,value_format=u,block_compressor=" + name;
+        ASSERT_OK(wtRCToStatus(_session->create(_session, uri.c_str(), config.c_str())));
+
+        WT_CURSOR* cursor;
+        ASSERT_OK(wtRCToStatus(_session->open_cursor(_session, uri.c_str(), NULL, NULL, &cursor)));
+        for (int64_t key = 0; key < 100; ++key) {
+            WT_ITEM item = {value.data(), value.size()};
+            cursor->set_key(cursor, key);
+            cursor->set_value(cursor, &item);
+            ASSERT_OK(wtRCToStatus(cursor->insert(cursor)));
+        }
+        ASSERT_OK(wtRCToStatus(cursor->close(cursor)));
+    }
+    ASSERT_OK(wtRCToStatus(_session->checkpoint(_session, NULL)));
+    closeConnection();
+
+    // The restarted connection has to decompress the pages written above.
+    openConnection();
+    for (const auto& name : compressors) {
+        std::string uri = "table:" + name;
+        WT_CURSOR* cursor;
+        ASSERT_OK(wtRCToStatus(_session->open_cursor(_session, uri.c_str(), NULL, NULL, &cursor)));
+        int64_t count = 0;
+        int ret;
+        while ((ret = cursor->next(cursor)) == 0) {
+            WT_ITEM item;
+            ASSERT_OK(wtRCToStatus(cursor->get_value(cursor, &item)));
+            ASSERT_EQ(value, std::string(static_cast<const char*>(item.data), item.size));
+            ++count;
+        }
+        ASSERT_EQ(WT_NOTFOUND, ret);
+        ASSERT_EQ(100, count);
+        ASSERT_OK(wtRCToStatus(cursor->close(cursor)));
+    }
+}
+
+TEST_F(ZstdTableTest, UnsupportedLevelIsRejected) {
+    openConnection();
+    ASSERT_NOT_OK(wtRCToStatus(
+        _session->create(_session, "table:bad", "block_compressor=zstd-1000")));
+}
+
+}  // namespace
+}  // namespace mongo
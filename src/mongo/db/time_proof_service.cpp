@@ -48,16 +48,25 @@ TimeProofService::Key TimeProofService::generateRandomKey() {
                                                  SHA1Block::kHashLength));
 }
 
-TimeProofService::TimeProof TimeProofService::getProof(const LogicalTime& time,
-                                                       const Key& key) const {
-    auto unsignedTimeArray = time.toUnsignedArray();
-    return SHA1Block::computeHmac(
+TimeProofService::TimeProof TimeProofService::getProof(const LogicalTime& time, const Key& key) {
+    const LogicalTime timeCeil(Timestamp(time.asTimestamp().asULL() | kRangeMask));
+
+    stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
+    if (_cache && _cache->hasProof(timeCeil, key)) {
+        return _cache->proof;
+    }
+
+    auto unsignedTimeArray = timeCeil.toUnsignedArray();
+    auto proof = SHA1Block::computeHmac(
         key.data(), key.size(), unsignedTimeArray.data(), unsignedTimeArray.size());
+
+    _cache = CacheEntry(proof, timeCeil, key);
+    return proof;
 }
 
 Status TimeProofService::checkProof(const LogicalTime& time,
                                     const TimeProof& proof,
-                                    const Key& key) const {
+                                    const Key& key) {
     auto myProof = getProof(time, key);
     if (myProof != proof) {
         return Status(ErrorCodes::TimeProofMismatch, "Proof does not match the logical time");
@@ -65,4 +74,9 @@ Status TimeProofService::checkProof(const LogicalTime& time,
     return Status::OK();
 }
 
+void TimeProofService::resetCache() {
+    stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
+    _cache = boost::none;
+}
+
 }  // namespace mongo
@@ -28,9 +28,12 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+
 #include "mongo/base/status.h"
 #include "mongo/crypto/sha1_block.h"
 #include "mongo/db/logical_time.h"
+#include "mongo/stdx/mutex.h"
 
 namespace mongo {
 
@@ -39,6 +42,11 @@ namespace mongo {
  *
  * The TimeProofService holds the key used by mongod and mongos processes to verify logical times
  * and contains the logic to generate this key, but not to store or retrieve it.
+ *
+ * A proof covers a range of logical times rather than a single one: it is computed for the greatest
+ * time of the range, which is the time with all the bits of kRangeMask set. As every time in the
+ * range therefore has the same proof, the last one computed is cached, so that signing or checking
+ * the many times within a range only pays for the HMAC once.
  */
 class TimeProofService {
 public:
@@ -46,6 +54,9 @@ public:
     using TimeProof = SHA1Block;
     using Key = SHA1Block;
 
+    // The low bits of the logical times which a single proof covers all values of.
+    static const uint64_t kRangeMask = 0xFFFF;
+
     TimeProofService() = default;
 
     /**
@@ -56,12 +67,38 @@ public:
     /**
      * Returns the proof matching the time argument.
      */
-    TimeProof getProof(const LogicalTime& time, const Key& key) const;
+    TimeProof getProof(const LogicalTime& time, const Key& key);
 
     /**
      * Verifies that the proof matches the time argument.
      */
-    Status checkProof(const LogicalTime& time, const TimeProof& proof, const Key& key) const;
+    Status checkProof(const LogicalTime& time, const TimeProof& proof, const Key& key);
+
+    /**
+     * Clears the cached proof, after which the next proof is computed again.
+     */
+    void resetCache();
+
+private:
+    /**
+     * The proof of the range of logical times ending at 'time', computed with 'key'.
+     */
+    struct CacheEntry {
+        CacheEntry(TimeProof proof, LogicalTime time, const Key& key)
+            : proof(std::move(proof)), time(std::move(time)), key(key) {}
+
+        bool hasProof(const LogicalTime& otherTime, const Key& otherKey) const {
+            return time == otherTime && key == otherKey;
+        }
+
+        TimeProof proof;
+        LogicalTime time;
+        Key key;
+    };
+
+    // Protects _cache
+    stdx::mutex _cacheMutex;
+    boost::optional<CacheEntry> _cache;
 };
 
 }  // namespace mongo
@@ -61,5 +61,41 @@ TEST(TimeProofService, LogicalTimeWithMismatchingProofShouldFail) {
                   timeProofService.checkProof(time, invalidProof, key));
 }
 
+// Verifies that all the logical times in a range have the same proof, and that the proof of one
+// range doesn't prove the times of the next one.
+TEST(TimeProofService, LogicalTimesInTheSameRangeShareTheirProof) {
+    TimeProofService timeProofService;
+
+    LogicalTime first(Timestamp(1, 0));
+    LogicalTime last(Timestamp(1, TimeProofService::kRangeMask));
+    LogicalTime next(Timestamp(1, TimeProofService::kRangeMask + 1));
+
+    TimeProof proof = timeProofService.getProof(first, key);
+    ASSERT_TRUE(proof == timeProofService.getProof(last, key));
+    ASSERT_OK(timeProofService.checkProof(last, proof, key));
+
+    ASSERT_FALSE(proof == timeProofService.getProof(next, key));
+    ASSERT_EQUALS(ErrorCodes::TimeProofMismatch, timeProofService.checkProof(next, proof, key));
+}
+
+// Verifies that the cached proof is only used for the key it was computed with.
+TEST(TimeProofService, CachedProofIsNotUsedForOtherKeys) {
+    TimeProofService timeProofService;
+    const TimeProofService::Key otherKey = {{1, 2, 3}};
+
+    LogicalTime time(Timestamp(1, 1));
+    TimeProof proof = timeProofService.getProof(time, key);
+    TimeProof otherProof = timeProofService.getProof(time, otherKey);
+    ASSERT_FALSE(proof == otherProof);
+
+    ASSERT_EQUALS(ErrorCodes::TimeProofMismatch,
+                  timeProofService.checkProof(time, proof, otherKey));
+    ASSERT_OK(timeProofService.checkProof(time, proof, key));
+
+    // Proofs computed again after clearing the cache are the same.
+    timeProofService.resetCache();
+    ASSERT_TRUE(otherProof == timeProofService.getProof(time, otherKey));
+}
+
 }  // unnamed namespace
 }  // namespace mongo
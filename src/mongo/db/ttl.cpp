@@ -34,6 +34,10 @@
 
 #include "mongo/db/ttl.h"
 
+#include <algorithm>
+#include <map>
+#include <vector>
+
 #include "mongo/base/counter.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/auth/user_name.h"
@@ -46,7 +50,7 @@
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
-#include "mongo/db/exec/delete.h"
+#include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/matcher/extensions_callback_disallow_extensions.h"
 #include "mongo/db/namespace_string.h"
@@ -55,10 +59,11 @@
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/ttl_collection_cache.h"
-#include "mongo/util/background.h"
-#include "mongo/util/concurrency/idle_thread_block.h"
-#include "mongo/util/exit.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/log.h"
+#include "mongo/util/periodic_runner.h"
 
 namespace mongo {
 
@@ -72,51 +77,117 @@ ServerStatusMetricField<Counter64> ttlDeletedDocumentsDisplay("ttl.deletedDocume
 MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorEnabled, bool, true);
 MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorSleepSecs, int, 60);  // used for testing
 
-class TTLMonitor : public BackgroundJob {
+// Number of collections whose expired documents are deleted concurrently
+MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorMaxThreads, int, 4);
+
+// Number of expired documents deleted under a single WriteUnitOfWork
+MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorBatchSize, int, 64);
+
+// Upper bound on the number of documents deleted through one TTL index in a pass, so that a
+// collection with a large backlog does not hold up the other collections
+MONGO_EXPORT_SERVER_PARAMETER(ttlIndexMaxDeletesPerPass, int, 100000);
+
+// Time between passes when some TTL index still had expired documents left after the last one
+MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorBacklogSleepSecs, int, 1);
+
+namespace {
+
+/**
+ * The outcome of deleting the expired documents of one TTL index during a pass.
+ */
+struct TTLIndexPassStats {
+    long long numDeleted = 0;
+
+    // Whether the pass stopped before deleting all the expired documents
+    bool backlog = false;
+
+    // How long ago the oldest document left behind by the pass expired, approximately
+    Milliseconds lag{0};
+};
+
+/**
+ * Reports the outcome of the last pass for each TTL index under metrics.ttl.indexes in
+ * serverStatus, so that TTL deletion falling behind can be noticed.
+ */
+class TTLIndexStatsMetric : public ServerStatusMetric {
 public:
-    TTLMonitor() {}
-    virtual ~TTLMonitor() {}
+    TTLIndexStatsMetric() : ServerStatusMetric("ttl.indexes") {}
+
+    void setLastPassStats(std::map<std::string, TTLIndexPassStats> stats) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _lastPassStats = std::move(stats);
+    }
 
-    virtual std::string name() const {
-        return "TTLMonitor";
+    void appendAtLeaf(BSONObjBuilder& b) const override {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        BSONObjBuilder indexes(b.subobjStart(_leafName));
+        for (const auto& entry : _lastPassStats) {
+            BSONObjBuilder index(indexes.subobjStart(entry.first));
+            index.append("deletedLastPass", entry.second.numDeleted);
+            index.append("backlog", entry.second.backlog);
+            index.append("lagSecs", durationCount<Seconds>(entry.second.lag));
+        }
     }
 
+private:
+    mutable stdx::mutex _mutex;
+    std::map<std::string, TTLIndexPassStats> _lastPassStats;
+};
+
+TTLIndexStatsMetric ttlIndexStatsMetric;
+
+}  // namespace
+
+/**
+ * Periodic job that deletes expired documents from the collections with TTL indexes.
+ */
+class TTLMonitor {
+public:
     static std::string secondsExpireField;
 
-    virtual void run() {
-        Client::initThread(name().c_str());
+    void run() {
         AuthorizationSession::get(cc())->grantInternalAuthorization();
+        _backlog.store(false);
 
-        while (!globalInShutdownDeprecated()) {
-            {
-                MONGO_IDLE_THREAD_BLOCK;
-                sleepsecs(ttlMonitorSleepSecs.load());
-            }
-
-            LOG(3) << "thread awake";
+        LOG(3) << "thread awake";
 
-            if (!ttlMonitorEnabled.load()) {
-                LOG(1) << "disabled";
-                continue;
-            }
+        if (!ttlMonitorEnabled.load()) {
+            LOG(1) << "disabled";
+            return;
+        }
 
-            if (lockedForWriting()) {
-                // Note: this is not perfect as you can go into fsync+lock between this and actually
-                // doing the delete later.
-                LOG(3) << "locked for writing";
-                continue;
-            }
+        if (lockedForWriting()) {
+            // Note: this is not perfect as you can go into fsync+lock between this and actually
+            // doing the delete later.
+            LOG(3) << "locked for writing";
+            return;
+        }
 
-            try {
-                doTTLPass();
-            } catch (const WriteConflictException& e) {
-                LOG(1) << "got WriteConflictException";
-            }
+        try {
+            _backlog.store(doTTLPass());
+        } catch (const WriteConflictException& e) {
+            LOG(1) << "got WriteConflictException";
+        } catch (const DBException& e) {
+            warning() << "TTL pass failed: " << e.toStatus();
         }
     }
 
+    /**
+     * Returns how long to wait before the next pass, which is shorter while some indexes still
+     * have expired documents left.
+     */
+    Milliseconds interval() const {
+        return Seconds(_backlog.load()
+                           ? std::min(ttlMonitorBacklogSleepSecs.load(), ttlMonitorSleepSecs.load())
+                           : ttlMonitorSleepSecs.load());
+    }
+
 private:
-    void doTTLPass() {
+    /**
+     * Deletes the expired documents of every TTL index, processing several collections at a time.
+     * Returns true if some of the indexes still have expired documents left.
+     */
+    bool doTTLPass() {
         const ServiceContext::UniqueOperationContext opCtxPtr = cc().makeOperationContext();
         OperationContext& opCtx = *opCtxPtr;
 
@@ -124,11 +195,11 @@ private:
         if (repl::getGlobalReplicationCoordinator()->getReplicationMode() ==
                 repl::ReplicationCoordinator::modeReplSet &&
             !repl::getGlobalReplicationCoordinator()->getMemberState().readable())
-            return;
+            return false;
 
         TTLCollectionCache& ttlCollectionCache = TTLCollectionCache::get(getGlobalServiceContext());
         std::vector<std::string> ttlCollections = ttlCollectionCache.getCollections();
-        std::vector<BSONObj> ttlIndexes;
+        std::vector<std::vector<BSONObj>> ttlIndexesByCollection;
 
         ttlPasses.increment();
 
@@ -145,130 +216,246 @@ private:
             CollectionCatalogEntry* collEntry = coll->getCatalogEntry();
             std::vector<std::string> indexNames;
             collEntry->getAllIndexes(&opCtx, &indexNames);
+            std::vector<BSONObj> ttlIndexes;
             for (const std::string& name : indexNames) {
                 BSONObj spec = collEntry->getIndexSpec(&opCtx, name);
                 if (spec.hasField(secondsExpireField)) {
                     ttlIndexes.push_back(spec.getOwned());
                 }
             }
+            if (!ttlIndexes.empty()) {
+                ttlIndexesByCollection.push_back(std::move(ttlIndexes));
+            }
         }
 
-        for (const BSONObj& idx : ttlIndexes) {
-            try {
-                doTTLForIndex(&opCtx, idx);
-            } catch (const DBException& dbex) {
-                error() << "Error processing ttl index: " << idx << " -- " << dbex.toString();
-                // Continue on to the next index.
-                continue;
-            }
+        ThreadPool::Options options;
+        options.poolName = "TTLMonitor";
+        options.minThreads = 0;
+        options.maxThreads = std::max(ttlMonitorMaxThreads.load(), 1);
+        options.onCreateThread = [](const std::string& threadName) {
+            Client::initThread(threadName.c_str());
+            AuthorizationSession::get(cc())->grantInternalAuthorization();
+        };
+        ThreadPool threadPool(options);
+        threadPool.startup();
+
+        stdx::mutex mutex;
+        std::map<std::string, TTLIndexPassStats> passStats;
+
+        // The indexes of a collection are processed one after the other, so that the collections
+        // with expired documents are spread over the threads.
+        for (auto& ttlIndexes : ttlIndexesByCollection) {
+            invariantOK(threadPool.schedule([this, &mutex, &passStats, ttlIndexes] {
+                const ServiceContext::UniqueOperationContext opCtxPtr =
+                    cc().makeOperationContext();
+
+                for (const BSONObj& idx : ttlIndexes) {
+                    try {
+                        auto indexStats = doTTLForIndex(opCtxPtr.get(), idx);
+                        if (indexStats) {
+                            stdx::lock_guard<stdx::mutex> lk(mutex);
+                            passStats[NamespaceString(idx["ns"].String()).ns() + ".$" +
+                                      idx["name"].String()] = *indexStats;
+                        }
+                    } catch (const DBException& dbex) {
+                        error() << "Error processing ttl index: " << idx << " -- "
+                                << dbex.toString();
+                        // Continue on to the next index.
+                        continue;
+                    }
+                }
+            }));
         }
+
+        threadPool.shutdown();
+        threadPool.join();
+
+        const bool backlog = std::any_of(
+            passStats.begin(), passStats.end(), [](const auto& entry) {
+                return entry.second.backlog;
+            });
+        ttlIndexStatsMetric.setLastPassStats(std::move(passStats));
+        return backlog;
     }
 
     /**
      * Remove documents from the collection using the specified TTL index after a sufficient amount
      * of time has passed according to its expiry specification.
+     *
+     * The expired documents are deleted in index order, in batches which each take the collection
+     * lock again and are deleted under a single WriteUnitOfWork, until there are none left or
+     * ttlIndexMaxDeletesPerPass of them were deleted. Returns boost::none if the index was skipped.
      */
-    void doTTLForIndex(OperationContext* opCtx, BSONObj idx) {
+    boost::optional<TTLIndexPassStats> doTTLForIndex(OperationContext* opCtx, BSONObj idx) {
         const NamespaceString collectionNSS(idx["ns"].String());
         if (!userAllowedWriteNS(collectionNSS).isOK()) {
             error() << "namespace '" << collectionNSS
                     << "' doesn't allow deletes, skipping ttl job for: " << idx;
-            return;
+            return boost::none;
         }
 
         const BSONObj key = idx["key"].Obj();
-        const StringData name = idx["name"].valueStringData();
+        const std::string name = idx["name"].String();
         if (key.nFields() != 1) {
             error() << "key for ttl index can only have 1 field, skipping ttl job for: " << idx;
-            return;
+            return boost::none;
         }
 
         LOG(1) << "ns: " << collectionNSS << " key: " << key << " name: " << name;
 
-        AutoGetCollection autoGetCollection(opCtx, collectionNSS, MODE_IX);
-        Collection* collection = autoGetCollection.getCollection();
-        if (!collection) {
-            // Collection was dropped.
-            return;
-        }
+        const long long maxToDelete = std::max(ttlIndexMaxDeletesPerPass.load(), 1);
+        const int batchSize = std::max(ttlMonitorBatchSize.load(), 1);
 
-        if (!repl::getGlobalReplicationCoordinator()->canAcceptWritesFor(opCtx, collectionNSS)) {
-            return;
-        }
+        TTLIndexPassStats stats;
 
-        IndexDescriptor* desc = collection->getIndexCatalog()->findIndexByName(opCtx, name);
-        if (!desc) {
-            LOG(1) << "index not found (index build in progress? index dropped?), skipping "
-                   << "ttl job for: " << idx;
-            return;
-        }
+        // Set by the first batch, so that all the batches delete the documents which had expired
+        // when the pass started.
+        boost::optional<Date_t> expirationTime;
+        std::unique_ptr<CanonicalQuery> canonicalQuery;
 
-        // Re-read 'idx' from the descriptor, in case the collection or index definition changed
-        // before we re-acquired the collection lock.
-        idx = desc->infoObj();
+        while (true) {
+            opCtx->checkForInterrupt();
 
-        if (IndexType::INDEX_BTREE != IndexNames::nameToType(desc->getAccessMethodName())) {
-            error() << "special index can't be used as a ttl index, skipping ttl job for: " << idx;
-            return;
-        }
+            AutoGetCollection autoGetCollection(opCtx, collectionNSS, MODE_IX);
+            Collection* collection = autoGetCollection.getCollection();
+            if (!collection) {
+                // Collection was dropped.
+                return boost::none;
+            }
 
-        BSONElement secondsExpireElt = idx[secondsExpireField];
-        if (!secondsExpireElt.isNumber()) {
-            error() << "ttl indexes require the " << secondsExpireField << " field to be "
-                    << "numeric but received a type of " << typeName(secondsExpireElt.type())
-                    << ", skipping ttl job for: " << idx;
-            return;
-        }
+            if (!repl::getGlobalReplicationCoordinator()->canAcceptWritesFor(opCtx,
+                                                                             collectionNSS)) {
+                return boost::none;
+            }
 
-        const Date_t kDawnOfTime =
-            Date_t::fromMillisSinceEpoch(std::numeric_limits<long long>::min());
-        const Date_t expirationTime = Date_t::now() - Seconds(secondsExpireElt.numberLong());
-        const BSONObj startKey = BSON("" << kDawnOfTime);
-        const BSONObj endKey = BSON("" << expirationTime);
-        // The canonical check as to whether a key pattern element is "ascending" or
-        // "descending" is (elt.number() >= 0).  This is defined by the Ordering class.
-        const InternalPlanner::Direction direction = (key.firstElement().number() >= 0)
-            ? InternalPlanner::Direction::FORWARD
-            : InternalPlanner::Direction::BACKWARD;
-
-        // We need to pass into the DeleteStageParams (below) a CanonicalQuery with a BSONObj that
-        // queries for the expired documents correctly so that we do not delete documents that are
-        // not actually expired when our snapshot changes during deletion.
-        const char* keyFieldName = key.firstElement().fieldName();
-        BSONObj query =
-            BSON(keyFieldName << BSON("$gte" << kDawnOfTime << "$lte" << expirationTime));
-        auto qr = stdx::make_unique<QueryRequest>(collectionNSS);
-        qr->setFilter(query);
-        auto canonicalQuery = CanonicalQuery::canonicalize(
-            opCtx, std::move(qr), ExtensionsCallbackDisallowExtensions());
-        invariantOK(canonicalQuery.getStatus());
-
-        DeleteStageParams params;
-        params.isMulti = true;
-        params.canonicalQuery = canonicalQuery.getValue().get();
-
-        auto exec =
-            InternalPlanner::deleteWithIndexScan(opCtx,
-                                                 collection,
-                                                 params,
-                                                 desc,
-                                                 startKey,
-                                                 endKey,
-                                                 BoundInclusion::kIncludeBothStartAndEndKeys,
-                                                 PlanExecutor::YIELD_AUTO,
-                                                 direction);
-
-        Status result = exec->executePlan();
-        if (!result.isOK()) {
-            error() << "ttl query execution for index " << idx
-                    << " failed with status: " << redact(result);
-            return;
+            IndexDescriptor* desc = collection->getIndexCatalog()->findIndexByName(opCtx, name);
+            if (!desc) {
+                LOG(1) << "index not found (index build in progress? index dropped?), skipping "
+                       << "ttl job for: " << idx;
+                return boost::none;
+            }
+
+            // Re-read 'idx' from the descriptor, in case the collection or index definition
+            // changed before we re-acquired the collection lock.
+            idx = desc->infoObj();
+
+            if (IndexType::INDEX_BTREE != IndexNames::nameToType(desc->getAccessMethodName())) {
+                error() << "special index can't be used as a ttl index, skipping ttl job for: "
+                        << idx;
+                return boost::none;
+            }
+
+            BSONElement secondsExpireElt = idx[secondsExpireField];
+            if (!secondsExpireElt.isNumber()) {
+                error() << "ttl indexes require the " << secondsExpireField << " field to be "
+                        << "numeric but received a type of " << typeName(secondsExpireElt.type())
+                        << ", skipping ttl job for: " << idx;
+                return boost::none;
+            }
+
+            const Date_t kDawnOfTime =
+                Date_t::fromMillisSinceEpoch(std::numeric_limits<long long>::min());
+            if (!expirationTime) {
+                expirationTime = Date_t::now() - Seconds(secondsExpireElt.numberLong());
+            }
+            const BSONObj startKey = BSON("" << kDawnOfTime);
+            const BSONObj endKey = BSON("" << *expirationTime);
+            // The canonical check as to whether a key pattern element is "ascending" or
+            // "descending" is (elt.number() >= 0).  This is defined by the Ordering class.
+            const InternalPlanner::Direction direction = (key.firstElement().number() >= 0)
+                ? InternalPlanner::Direction::FORWARD
+                : InternalPlanner::Direction::BACKWARD;
+
+            // The documents are checked against a query for the expired documents before being
+            // deleted, so that we do not delete documents that are not actually expired, should
+            // they have changed since their index keys were read.
+            if (!canonicalQuery) {
+                const char* keyFieldName = key.firstElement().fieldName();
+                BSONObj query = BSON(keyFieldName << BSON("$gte" << kDawnOfTime << "$lte"
+                                                                 << *expirationTime));
+                auto qr = stdx::make_unique<QueryRequest>(collectionNSS);
+                qr->setFilter(query);
+                auto statusWithCQ = CanonicalQuery::canonicalize(
+                    opCtx, std::move(qr), ExtensionsCallbackDisallowExtensions());
+                invariantOK(statusWithCQ.getStatus());
+                canonicalQuery = std::move(statusWithCQ.getValue());
+            }
+
+            // Only the record ids of the batch are looked up through the index, so that the
+            // documents can be deleted together.
+            const long long numToFetch =
+                std::min<long long>(batchSize, maxToDelete - stats.numDeleted);
+            std::vector<RecordId> recordIds;
+            BSONObj lastKey;
+            {
+                auto exec = InternalPlanner::indexScan(opCtx,
+                                                       collection,
+                                                       desc,
+                                                       startKey,
+                                                       endKey,
+                                                       BoundInclusion::kIncludeBothStartAndEndKeys,
+                                                       PlanExecutor::YIELD_MANUAL,
+                                                       direction);
+
+                RecordId recordId;
+                BSONObj obj;
+                PlanExecutor::ExecState state = PlanExecutor::IS_EOF;
+                while (static_cast<long long>(recordIds.size()) < numToFetch &&
+                       PlanExecutor::ADVANCED == (state = exec->getNext(&obj, &recordId))) {
+                    recordIds.push_back(recordId);
+                    lastKey = obj.getOwned();
+                }
+
+                if (state == PlanExecutor::FAILURE || state == PlanExecutor::DEAD) {
+                    error() << "ttl query execution for index " << idx
+                            << " failed with status: " << WorkingSetCommon::toStatusString(obj);
+                    return stats;
+                }
+            }
+
+            long long batchDeleted = 0;
+            MONGO_WRITE_CONFLICT_RETRY_LOOP_BEGIN {
+                batchDeleted = 0;
+                WriteUnitOfWork wuow(opCtx);
+                for (const auto& recordId : recordIds) {
+                    // A document with several expired dates is found once for each of them.
+                    Snapshotted<BSONObj> doc;
+                    if (!collection->findDoc(opCtx, recordId, &doc) ||
+                        !canonicalQuery->root()->matchesBSON(doc.value())) {
+                        continue;
+                    }
+                    collection->deleteDocument(opCtx, recordId, nullptr);
+                    batchDeleted++;
+                }
+                wuow.commit();
+            }
+            MONGO_WRITE_CONFLICT_RETRY_LOOP_END(opCtx, "ttl delete", collectionNSS.ns());
+
+            stats.numDeleted += batchDeleted;
+            ttlDeletedDocuments.increment(batchDeleted);
+
+            // A short batch means that the scan reached the last expired document. A batch which
+            // deleted nothing would find the same documents again.
+            if (static_cast<long long>(recordIds.size()) < numToFetch || batchDeleted == 0) {
+                break;
+            }
+
+            if (stats.numDeleted >= maxToDelete) {
+                // The documents are deleted oldest first, so the last one deleted expired about as
+                // long ago as the oldest one left.
+                stats.backlog = true;
+                if (lastKey.firstElement().type() == Date) {
+                    stats.lag = *expirationTime - lastKey.firstElement().date();
+                }
+                break;
+            }
         }
 
-        const long long numDeleted = DeleteStage::getNumDeleted(*exec);
-        ttlDeletedDocuments.increment(numDeleted);
-        LOG(1) << "deleted: " << numDeleted;
+        LOG(1) << "deleted: " << stats.numDeleted;
+        return stats;
     }
+
+    AtomicWord<bool> _backlog{false};
 };
 
 namespace {
@@ -280,7 +467,8 @@ TTLMonitor* ttlMonitor = nullptr;
 
 void startTTLBackgroundJob() {
     ttlMonitor = new TTLMonitor();
-    ttlMonitor->go();
+    getGlobalServiceContext()->getPeriodicRunner()->scheduleJob(
+        {[] { ttlMonitor->run(); }, [] { return ttlMonitor->interval(); }});
 }
 
 std::string TTLMonitor::secondsExpireField = "expireAfterSeconds";
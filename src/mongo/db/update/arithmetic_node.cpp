@@ -124,4 +124,66 @@ Status ArithmeticNode::setValueForNewElement(mutablebson::Element* element) cons
     return element->setValueSafeNum(valueToSet);
 }
 
+Status ArithmeticNode::applyToField(const BSONObj& document,
+                                    StringData fieldName,
+                                    BSONElement existing,
+                                    BSONObjBuilder* builder,
+                                    LogBuilder* logBuilder,
+                                    bool* noop) const {
+    *noop = false;
+
+    SafeNum valueToSet = _val;
+    if (!existing.ok()) {
+        // A missing field is treated as zero, as in setValueForNewElement().
+        if (_op == ArithmeticOp::kMultiply) {
+            valueToSet *= SafeNum(static_cast<int32_t>(0));
+        }
+    } else {
+        if (!existing.isNumber()) {
+            return Status(ErrorCodes::TypeMismatch,
+                          str::stream() << "Cannot apply " << getModifierNameForOp(_op)
+                                        << " to a value of non-numeric type. {"
+                                        << document["_id"].toString()
+                                        << "} has the field '"
+                                        << fieldName
+                                        << "' of non-numeric type "
+                                        << typeName(existing.type()));
+        }
+
+        SafeNum originalValue(existing);
+        switch (_op) {
+            case ArithmeticOp::kAdd:
+                valueToSet += originalValue;
+                break;
+            case ArithmeticOp::kMultiply:
+                valueToSet *= originalValue;
+                break;
+        }
+
+        if (!valueToSet.isValid()) {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << "Failed to apply " << getModifierNameForOp(_op)
+                                        << " operations to current value ("
+                                        << originalValue.debugString()
+                                        << ") for document {"
+                                        << document["_id"].toString()
+                                        << "}");
+        }
+
+        if (valueToSet.isIdentical(originalValue)) {
+            *noop = true;
+            builder->append(existing);
+            return Status::OK();
+        }
+    }
+
+    valueToSet.toBSON(fieldName, builder);
+
+    if (logBuilder) {
+        return logBuilder->addToSets(fieldName, valueToSet);
+    }
+
+    return Status::OK();
+}
+
 }  // namespace mongo
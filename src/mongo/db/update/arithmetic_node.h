@@ -50,6 +50,17 @@ public:
 
     void setCollator(const CollatorInterface* collator) final {}
 
+    bool supportsApplyToField() const final {
+        return true;
+    }
+
+    Status applyToField(const BSONObj& document,
+                        StringData fieldName,
+                        BSONElement existing,
+                        BSONObjBuilder* builder,
+                        LogBuilder* logBuilder,
+                        bool* noop) const final;
+
 protected:
     Status updateExistingElement(mutablebson::Element* element, bool* noop) const final;
     Status setValueForNewElement(mutablebson::Element* element) const final;
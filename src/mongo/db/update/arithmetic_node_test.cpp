@@ -30,6 +30,8 @@
 
 #include "mongo/db/update/arithmetic_node.h"
 
+#include <limits>
+
 #include "mongo/bson/mutable/algorithm.h"
 #include "mongo/bson/mutable/mutable_bson_test_utils.h"
 #include "mongo/db/json.h"
@@ -1737,5 +1739,80 @@ TEST(ArithmeticNodeTest, LogEmptyObject) {
     ASSERT_EQUALS(fromjson("{$set: {'a.2.b': 2}}"), logDoc);
 }
 
+TEST(ArithmeticNodeTest, ApplyToFieldIncrementsExistingValue) {
+    auto update = fromjson("{$inc: {a: NumberLong(2)}}");
+    const CollatorInterface* collator = nullptr;
+    ArithmeticNode node(ArithmeticNode::ArithmeticOp::kAdd);
+    ASSERT_OK(node.init(update["$inc"]["a"], collator));
+
+    auto doc = fromjson("{a: 5}");
+    Document logDoc;
+    LogBuilder logBuilder(logDoc.root());
+    BSONObjBuilder builder;
+    auto noop = true;
+    ASSERT_OK(node.applyToField(doc, "a", doc["a"], &builder, &logBuilder, &noop));
+    ASSERT_FALSE(noop);
+    auto result = builder.obj();
+    ASSERT_BSONOBJ_EQ(fromjson("{a: NumberLong(7)}"), result);
+    ASSERT_EQUALS(mongo::NumberLong, result["a"].type());
+    ASSERT_EQUALS(fromjson("{$set: {a: NumberLong(7)}}"), logDoc);
+}
+
+TEST(ArithmeticNodeTest, ApplyToFieldMultipliesMissingFieldToZero) {
+    auto update = fromjson("{$mul: {a: 2.5}}");
+    const CollatorInterface* collator = nullptr;
+    ArithmeticNode node(ArithmeticNode::ArithmeticOp::kMultiply);
+    ASSERT_OK(node.init(update["$mul"]["a"], collator));
+
+    auto doc = fromjson("{_id: 1}");
+    BSONObjBuilder builder;
+    auto noop = true;
+    ASSERT_OK(node.applyToField(doc, "a", BSONElement(), &builder, nullptr, &noop));
+    ASSERT_FALSE(noop);
+    auto result = builder.obj();
+    ASSERT_BSONOBJ_EQ(fromjson("{a: 0.0}"), result);
+    ASSERT_EQUALS(mongo::NumberDouble, result["a"].type());
+}
+
+TEST(ArithmeticNodeTest, ApplyToFieldNoOp) {
+    auto update = fromjson("{$inc: {a: 0}}");
+    const CollatorInterface* collator = nullptr;
+    ArithmeticNode node(ArithmeticNode::ArithmeticOp::kAdd);
+    ASSERT_OK(node.init(update["$inc"]["a"], collator));
+
+    auto doc = fromjson("{a: 5}");
+    BSONObjBuilder builder;
+    auto noop = false;
+    ASSERT_OK(node.applyToField(doc, "a", doc["a"], &builder, nullptr, &noop));
+    ASSERT_TRUE(noop);
+    ASSERT_BSONOBJ_EQ(fromjson("{a: 5}"), builder.obj());
+}
+
+TEST(ArithmeticNodeTest, ApplyToFieldFailsForNonNumericValue) {
+    auto update = fromjson("{$inc: {a: 1}}");
+    const CollatorInterface* collator = nullptr;
+    ArithmeticNode node(ArithmeticNode::ArithmeticOp::kAdd);
+    ASSERT_OK(node.init(update["$inc"]["a"], collator));
+
+    auto doc = fromjson("{_id: 1, a: 'x'}");
+    BSONObjBuilder builder;
+    auto noop = false;
+    ASSERT_EQUALS(ErrorCodes::TypeMismatch,
+                  node.applyToField(doc, "a", doc["a"], &builder, nullptr, &noop));
+}
+
+TEST(ArithmeticNodeTest, ApplyToFieldFailsOnOverflow) {
+    auto update = fromjson("{$inc: {a: NumberLong(1)}}");
+    const CollatorInterface* collator = nullptr;
+    ArithmeticNode node(ArithmeticNode::ArithmeticOp::kAdd);
+    ASSERT_OK(node.init(update["$inc"]["a"], collator));
+
+    auto doc = BSON("_id" << 1 << "a" << std::numeric_limits<long long>::max());
+    BSONObjBuilder builder;
+    auto noop = false;
+    ASSERT_EQUALS(ErrorCodes::BadValue,
+                  node.applyToField(doc, "a", doc["a"], &builder, nullptr, &noop));
+}
+
 }  // namespace
 }  // namespace mongo
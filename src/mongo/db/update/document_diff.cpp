@@ -0,0 +1,400 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/update/document_diff.h"
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include "mongo/base/parse_number.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace documentdiff {
+
+namespace {
+
+const char kDeleteSection[] = "d";
+const char kUpdateSection[] = "u";
+const char kInsertSection[] = "i";
+const char kArrayMarker[] = "a";
+const char kArrayLength[] = "l";
+const char kUpdatePrefix = 'u';
+const char kSubDiffPrefix = 's';
+
+bool diffObject(const BSONObj& pre, const BSONObj& post, BSONObjBuilder* builder);
+
+/**
+ * Appends to 'builder' the diff of the array 'pre' into the array 'post'. Returns false if the
+ * arrays contain documents that cannot be diffed.
+ */
+bool diffArray(const BSONObj& pre, const BSONObj& post, BSONObjBuilder* builder) {
+    std::vector<BSONElement> preElems;
+    std::vector<BSONElement> postElems;
+    pre.elems(preElems);
+    post.elems(postElems);
+
+    builder->append(kArrayMarker, true);
+    if (preElems.size() != postElems.size()) {
+        builder->append(kArrayLength, static_cast<long long>(postElems.size()));
+    }
+
+    for (size_t i = 0; i < postElems.size(); ++i) {
+        if (i < preElems.size() && preElems[i].binaryEqualValues(postElems[i]) &&
+            preElems[i].type() == postElems[i].type()) {
+            continue;
+        }
+
+        BSONObjBuilder subDiff;
+        const bool canUseSubDiff = i < preElems.size() &&
+            preElems[i].type() == postElems[i].type() &&
+            (postElems[i].type() == Object || postElems[i].type() == Array);
+        if (canUseSubDiff) {
+            const bool diffed = postElems[i].type() == Object
+                ? diffObject(preElems[i].Obj(), postElems[i].Obj(), &subDiff)
+                : diffArray(preElems[i].Obj(), postElems[i].Obj(), &subDiff);
+            if (!diffed) {
+                return false;
+            }
+        }
+
+        if (canUseSubDiff && subDiff.len() < postElems[i].valuesize()) {
+            builder->append(str::stream() << kSubDiffPrefix << i, subDiff.obj());
+        } else {
+            builder->appendAs(postElems[i], str::stream() << kUpdatePrefix << i);
+        }
+    }
+    return true;
+}
+
+/**
+ * Appends to 'builder' the diff of the object 'pre' into the object 'post'. Returns false if
+ * either object has duplicate field names.
+ */
+bool diffObject(const BSONObj& pre, const BSONObj& post, BSONObjBuilder* builder) {
+    std::set<StringData> preNames;
+    for (auto&& elem : pre) {
+        if (!preNames.insert(elem.fieldNameStringData()).second) {
+            return false;
+        }
+    }
+    std::set<StringData> postNames;
+    for (auto&& elem : post) {
+        if (!postNames.insert(elem.fieldNameStringData()).second) {
+            return false;
+        }
+    }
+
+    BSONObjBuilder deletes;
+    for (auto&& elem : pre) {
+        if (!postNames.count(elem.fieldNameStringData())) {
+            deletes.append(elem.fieldNameStringData(), false);
+        }
+    }
+
+    // The fields of 'post' keep their position as long as they come in the same order as in
+    // 'pre'. From the first one that does not, every remaining field is re-inserted at the end.
+    BSONObjBuilder updates;
+    BSONObjBuilder inserts;
+    BSONObjBuilder subDiffs;
+    BSONObjIterator preIt(pre);
+    bool inOrder = true;
+    for (auto&& postElem : post) {
+        const auto fieldName = postElem.fieldNameStringData();
+
+        BSONElement preElem;
+        if (inOrder) {
+            while (preIt.more()) {
+                preElem = preIt.next();
+                if (postNames.count(preElem.fieldNameStringData())) {
+                    break;
+                }
+                preElem = BSONElement();
+            }
+            inOrder = preElem.ok() && preElem.fieldNameStringData() == fieldName;
+        }
+
+        if (!inOrder) {
+            inserts.append(postElem);
+            continue;
+        }
+
+        if (preElem.type() == postElem.type() && preElem.binaryEqualValues(postElem)) {
+            continue;
+        }
+
+        BSONObjBuilder subDiff;
+        const bool canUseSubDiff = preElem.type() == postElem.type() &&
+            (postElem.type() == Object || postElem.type() == Array);
+        if (canUseSubDiff) {
+            const bool diffed = postElem.type() == Object
+                ? diffObject(preElem.Obj(), postElem.Obj(), &subDiff)
+                : diffArray(preElem.Obj(), postElem.Obj(), &subDiff);
+            if (!diffed) {
+                return false;
+            }
+        }
+
+        if (canUseSubDiff && subDiff.len() < postElem.valuesize()) {
+            subDiffs.append(str::stream() << kSubDiffPrefix << fieldName, subDiff.obj());
+        } else {
+            updates.append(postElem);
+        }
+    }
+
+    if (deletes.len() > BSONObj().objsize()) {
+        builder->append(kDeleteSection, deletes.obj());
+    }
+    if (updates.len() > BSONObj().objsize()) {
+        builder->append(kUpdateSection, updates.obj());
+    }
+    if (inserts.len() > BSONObj().objsize()) {
+        builder->append(kInsertSection, inserts.obj());
+    }
+    builder->appendElements(subDiffs.obj());
+    return true;
+}
+
+Status badDiff(const BSONObj& diff) {
+    return Status(ErrorCodes::BadValue, str::stream() << "Invalid document diff: " << diff);
+}
+
+Status applyObjectDiff(const BSONObj& pre, const BSONObj& diff, BSONObjBuilder* builder);
+
+/**
+ * Applies the array diff 'diff' to the array 'pre', appending the resulting entries to 'builder'.
+ */
+Status applyArrayDiff(const BSONObj& pre, const BSONObj& diff, BSONArrayBuilder* builder) {
+    std::vector<BSONElement> preElems;
+    pre.elems(preElems);
+
+    size_t length = preElems.size();
+    std::map<size_t, BSONElement> updates;
+    std::map<size_t, BSONElement> subDiffs;
+    for (auto&& elem : diff) {
+        const auto fieldName = elem.fieldNameStringData();
+        if (fieldName == kArrayMarker) {
+            continue;
+        }
+        if (fieldName == kArrayLength) {
+            if (!elem.isNumber() || elem.numberLong() < 0) {
+                return badDiff(diff);
+            }
+            length = elem.numberLong();
+            continue;
+        }
+
+        size_t index;
+        if (fieldName.size() < 2 ||
+            !parseNumberFromStringWithBase(fieldName.substr(1), 10, &index).isOK()) {
+            return badDiff(diff);
+        }
+        if (fieldName[0] == kUpdatePrefix) {
+            updates[index] = elem;
+        } else if (fieldName[0] == kSubDiffPrefix && elem.type() == Object) {
+            subDiffs[index] = elem;
+        } else {
+            return badDiff(diff);
+        }
+    }
+
+    // Entries past the end of 'pre' are always listed in the diff, so a valid diff never asks for
+    // padding, and never names an index past the new length.
+    if (length > preElems.size() + updates.size() ||
+        (!updates.empty() && updates.rbegin()->first >= length) ||
+        (!subDiffs.empty() && subDiffs.rbegin()->first >= length)) {
+        return badDiff(diff);
+    }
+
+    for (size_t i = 0; i < length; ++i) {
+        auto update = updates.find(i);
+        if (update != updates.end()) {
+            builder->append(update->second);
+            continue;
+        }
+
+        auto subDiff = subDiffs.find(i);
+        if (subDiff != subDiffs.end()) {
+            if (i >= preElems.size()) {
+                return badDiff(diff);
+            }
+            auto status = [&] {
+                const BSONObj& elemDiff = subDiff->second.Obj();
+                if (preElems[i].type() == Array && elemDiff[kArrayMarker].trueValue()) {
+                    BSONArrayBuilder subBuilder(builder->subarrayStart());
+                    return applyArrayDiff(preElems[i].Obj(), elemDiff, &subBuilder);
+                }
+                if (preElems[i].type() == Object && !elemDiff.hasField(kArrayMarker)) {
+                    BSONObjBuilder subBuilder(builder->subobjStart());
+                    return applyObjectDiff(preElems[i].Obj(), elemDiff, &subBuilder);
+                }
+                return badDiff(diff);
+            }();
+            if (!status.isOK()) {
+                return status;
+            }
+            continue;
+        }
+
+        if (i >= preElems.size()) {
+            return badDiff(diff);
+        }
+        builder->append(preElems[i]);
+    }
+
+    return Status::OK();
+}
+
+/**
+ * Applies the object diff 'diff' to the object 'pre', appending the resulting fields to
+ * 'builder'.
+ */
+Status applyObjectDiff(const BSONObj& pre, const BSONObj& diff, BSONObjBuilder* builder) {
+    std::set<StringData> removed;
+    std::map<StringData, BSONElement> updates;
+    std::map<StringData, BSONElement> subDiffs;
+    BSONObj inserts;
+    for (auto&& elem : diff) {
+        const auto fieldName = elem.fieldNameStringData();
+        if (elem.type() != Object || fieldName.empty()) {
+            return badDiff(diff);
+        }
+
+        if (fieldName == kDeleteSection) {
+            for (auto&& deleted : elem.Obj()) {
+                removed.insert(deleted.fieldNameStringData());
+            }
+        } else if (fieldName == kUpdateSection) {
+            for (auto&& updated : elem.Obj()) {
+                updates[updated.fieldNameStringData()] = updated;
+            }
+        } else if (fieldName == kInsertSection) {
+            inserts = elem.Obj();
+            for (auto&& inserted : inserts) {
+                removed.insert(inserted.fieldNameStringData());
+            }
+        } else if (fieldName[0] == kSubDiffPrefix) {
+            subDiffs[fieldName.substr(1)] = elem;
+        } else {
+            return badDiff(diff);
+        }
+    }
+
+    for (auto&& preElem : pre) {
+        const auto fieldName = preElem.fieldNameStringData();
+        if (removed.count(fieldName)) {
+            continue;
+        }
+
+        auto update = updates.find(fieldName);
+        if (update != updates.end()) {
+            builder->append(update->second);
+            updates.erase(update);
+            continue;
+        }
+
+        auto subDiff = subDiffs.find(fieldName);
+        if (subDiff == subDiffs.end()) {
+            builder->append(preElem);
+            continue;
+        }
+
+        const BSONObj& fieldDiff = subDiff->second.Obj();
+        Status status = Status::OK();
+        if (preElem.type() == Array && fieldDiff[kArrayMarker].trueValue()) {
+            BSONArrayBuilder subBuilder(builder->subarrayStart(fieldName));
+            status = applyArrayDiff(preElem.Obj(), fieldDiff, &subBuilder);
+        } else if (preElem.type() == Object && !fieldDiff.hasField(kArrayMarker)) {
+            BSONObjBuilder subBuilder(builder->subobjStart(fieldName));
+            status = applyObjectDiff(preElem.Obj(), fieldDiff, &subBuilder);
+        } else {
+            status = badDiff(diff);
+        }
+        if (!status.isOK()) {
+            return status;
+        }
+        subDiffs.erase(subDiff);
+    }
+
+    // A diff is applied to the document it was computed from, so every field it replaces or
+    // patches must exist.
+    if (!updates.empty() || !subDiffs.empty()) {
+        return badDiff(diff);
+    }
+
+    builder->appendElements(inserts);
+    return Status::OK();
+}
+
+}  // namespace
+
+BSONObj computeDiff(const BSONObj& pre, const BSONObj& post, int maxDiffSize) {
+    BSONObjBuilder builder;
+    if (!diffObject(pre, post, &builder)) {
+        return BSONObj();
+    }
+    BSONObj diff = builder.obj();
+    return diff.objsize() < maxDiffSize ? diff : BSONObj();
+}
+
+StatusWith<BSONObj> applyDiff(const BSONObj& pre, const BSONObj& diff) {
+    BSONObjBuilder builder(pre.objsize());
+    Status status = applyObjectDiff(pre, diff, &builder);
+    if (!status.isOK()) {
+        return status;
+    }
+    return builder.obj();
+}
+
+BSONObj makeDeltaOplogEntryUpdate(const BSONObj& diff) {
+    return BSON("$v" << kDeltaOplogEntryVersion << "diff" << diff);
+}
+
+bool isDeltaOplogEntryUpdate(const BSONObj& update, BSONObj* diff) {
+    BSONElement version = update.firstElement();
+    if (version.fieldNameStringData() != "$v" || !version.isNumber() ||
+        version.numberInt() != kDeltaOplogEntryVersion) {
+        return false;
+    }
+
+    BSONElement diffElem = update["diff"];
+    if (diffElem.type() != Object) {
+        return false;
+    }
+    if (diff) {
+        *diff = diffElem.Obj();
+    }
+    return true;
+}
+
+}  // namespace documentdiff
+}  // namespace mongo
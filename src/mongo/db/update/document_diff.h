@@ -0,0 +1,92 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/base/status_with.h"
+#include "mongo/bson/bsonobj.h"
+
+namespace mongo {
+
+/**
+ * A document diff describes how to turn one document into another as a set of field-level
+ * changes, and is what delta update oplog entries carry instead of the update's modifiers. When an
+ * update rewrites a large array or subdocument, the modifiers log the whole new value, while the
+ * diff only carries the fields and array entries that actually changed.
+ *
+ * A diff of an object is a document with the following optional fields:
+ *
+ *   d: {<field>: false, ...}  Fields to remove.
+ *   u: {<field>: <value>, ...}  Fields whose value is replaced, keeping their position.
+ *   i: {<field>: <value>, ...}  Fields to remove, if they exist, and append in this order.
+ *   s<field>: <diff>  A diff to apply to the object or array in <field>.
+ *
+ * A diff of an array is a document with the following fields:
+ *
+ *   a: true  Marks the diff as an array diff.
+ *   l: <length>  The new length of the array, if it changed. Entries past it are removed, and
+ *                entries added past the end of the old array are all listed as u<index>.
+ *   u<index>: <value>  Entries whose value is replaced.
+ *   s<index>: <diff>  A diff to apply to the object or array at <index>.
+ *
+ * For example, {d: {x: false}, i: {y: 1}, sa: {u: {b: 5}}, sarr: {a: true, l: 3, u2: 3}} is a
+ * diff taking {_id: 1, a: {b: 1, c: 2}, arr: [1, 2], x: 1} to
+ * {_id: 1, a: {b: 5, c: 2}, arr: [1, 2, 3], y: 1}. computeDiff() only uses a nested diff when it
+ * is smaller than the new value it describes.
+ */
+namespace documentdiff {
+
+// The value of the "$v" field that marks delta update oplog entries.
+const int kDeltaOplogEntryVersion = 2;
+
+/**
+ * Returns a diff that turns 'pre' into 'post', or an empty object if the documents cannot be
+ * diffed (because of duplicate field names) or if the diff would not be smaller than
+ * 'maxDiffSize' bytes.
+ */
+BSONObj computeDiff(const BSONObj& pre, const BSONObj& post, int maxDiffSize);
+
+/**
+ * Applies 'diff', as returned by computeDiff(), to 'pre' and returns the resulting document.
+ * Returns a non-OK status if 'diff' is malformed or does not fit the structure of 'pre'.
+ */
+StatusWith<BSONObj> applyDiff(const BSONObj& pre, const BSONObj& diff);
+
+/**
+ * Returns the "o" field of a delta update oplog entry carrying 'diff'.
+ */
+BSONObj makeDeltaOplogEntryUpdate(const BSONObj& diff);
+
+/**
+ * Returns true if 'update', the "o" field of an update oplog entry, is a delta update created by
+ * makeDeltaOplogEntryUpdate(). If so, and 'diff' is not null, sets '*diff' to the diff it carries.
+ */
+bool isDeltaOplogEntryUpdate(const BSONObj& update, BSONObj* diff = nullptr);
+
+}  // namespace documentdiff
+}  // namespace mongo
@@ -0,0 +1,177 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/update/document_diff.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/json.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const int kNoSizeLimit = BSONObjMaxInternalSize;
+
+/**
+ * Checks that diffing 'pre' into 'post' gives 'expectedDiff', and that applying that diff to
+ * 'pre' gives back 'post' with its fields in the same order.
+ */
+void assertRoundTrip(const char* pre, const char* post, const char* expectedDiff) {
+    BSONObj preObj = fromjson(pre);
+    BSONObj postObj = fromjson(post);
+    BSONObj diff = documentdiff::computeDiff(preObj, postObj, kNoSizeLimit);
+    ASSERT_BSONOBJ_EQ(fromjson(expectedDiff), diff);
+
+    auto result = documentdiff::applyDiff(preObj, diff);
+    ASSERT_OK(result.getStatus());
+    ASSERT(postObj.binaryEqual(result.getValue())) << result.getValue();
+}
+
+TEST(DocumentDiffTest, UpdateKeepsFieldPosition) {
+    assertRoundTrip("{_id: 1, a: 1, b: 'x'}", "{_id: 1, a: 2, b: 'x'}", "{u: {a: 2}}");
+}
+
+TEST(DocumentDiffTest, TypeChangeIsAnUpdate) {
+    assertRoundTrip("{_id: 1, a: 1}", "{_id: 1, a: 1.0}", "{u: {a: 1.0}}");
+}
+
+TEST(DocumentDiffTest, DeleteField) {
+    assertRoundTrip("{_id: 1, a: 1, b: 2}", "{_id: 1, b: 2}", "{d: {a: false}}");
+}
+
+TEST(DocumentDiffTest, AppendField) {
+    assertRoundTrip("{_id: 1, a: 1}", "{_id: 1, a: 1, b: 2}", "{i: {b: 2}}");
+}
+
+TEST(DocumentDiffTest, ReorderedFieldsAreReinserted) {
+    assertRoundTrip(
+        "{_id: 1, a: 1, b: 2, c: 3}", "{_id: 1, b: 2, a: 1, c: 3}", "{i: {b: 2, a: 1, c: 3}}");
+}
+
+TEST(DocumentDiffTest, SubDocumentChangeUsesSubDiff) {
+    assertRoundTrip("{_id: 1, a: {b: 1, c: 'a long string value', d: {e: 1}}}",
+                    "{_id: 1, a: {b: 1, c: 'a long string value', d: {e: 2}}}",
+                    "{sa: {u: {d: {e: 2}}}}");
+}
+
+TEST(DocumentDiffTest, SmallSubDocumentIsReplaced) {
+    assertRoundTrip("{_id: 1, a: {b: 1}}", "{_id: 1, a: {b: 2}}", "{u: {a: {b: 2}}}");
+}
+
+TEST(DocumentDiffTest, ArrayEntryChange) {
+    assertRoundTrip("{_id: 1, a: [1, 2, 3, 4, 5, 6, 7, 8]}",
+                    "{_id: 1, a: [1, 2, 3, 4, 5, 0, 7, 8]}",
+                    "{sa: {a: true, u5: 0}}");
+}
+
+TEST(DocumentDiffTest, ArrayGrows) {
+    assertRoundTrip("{_id: 1, a: [1, 2, 3, 4, 5, 6, 7, 8]}",
+                    "{_id: 1, a: [1, 2, 3, 4, 5, 6, 7, 8, 9]}",
+                    "{sa: {a: true, l: 9, u8: 9}}");
+}
+
+TEST(DocumentDiffTest, ArrayShrinks) {
+    assertRoundTrip("{_id: 1, a: [1, 2, 3, 4, 5, 6, 7, 8]}",
+                    "{_id: 1, a: [1, 2, 3, 4, 5, 6]}",
+                    "{sa: {a: true, l: 6}}");
+}
+
+TEST(DocumentDiffTest, DocumentInArray) {
+    assertRoundTrip("{_id: 1, a: [{b: 1, c: 'a long string value'}, {b: 2, c: 'another one'}]}",
+                    "{_id: 1, a: [{b: 1, c: 'a long string value'}, {b: 3, c: 'another one'}]}",
+                    "{sa: {a: true, s1: {u: {b: 3}}}}");
+}
+
+TEST(DocumentDiffTest, CombinedChanges) {
+    assertRoundTrip("{_id: 1, a: {b: 1, c: 'long string'}, arr: [1, 2, 3, 4, 5, 6], x: 1}",
+                    "{_id: 1, a: {b: 5, c: 'long string'}, arr: [1, 2, 3, 4, 5, 6, 7], y: 1}",
+                    "{d: {x: false}, i: {y: 1}, sa: {u: {b: 5}}, sarr: {a: true, l: 7, u6: 7}}");
+}
+
+TEST(DocumentDiffTest, DuplicateFieldNamesCannotBeDiffed) {
+    BSONObj pre = BSON("_id" << 1 << "a" << 1 << "a" << 2);
+    BSONObj post = BSON("_id" << 1 << "a" << 3);
+    ASSERT_BSONOBJ_EQ(BSONObj(), documentdiff::computeDiff(pre, post, kNoSizeLimit));
+    ASSERT_BSONOBJ_EQ(BSONObj(), documentdiff::computeDiff(post, pre, kNoSizeLimit));
+
+    BSONObj nestedPre = BSON("_id" << 1 << "a" << BSON("b" << 1 << "b" << 2 << "c" << 3));
+    BSONObj nestedPost = BSON("_id" << 1 << "a" << BSON("b" << 1 << "b" << 2 << "c" << 4));
+    ASSERT_BSONOBJ_EQ(BSONObj(), documentdiff::computeDiff(nestedPre, nestedPost, kNoSizeLimit));
+}
+
+TEST(DocumentDiffTest, DiffNotSmallerThanLimitIsEmpty) {
+    BSONObj pre = fromjson("{_id: 1, a: 1}");
+    BSONObj post = fromjson("{_id: 1, a: 2}");
+    BSONObj diff = documentdiff::computeDiff(pre, post, kNoSizeLimit);
+    ASSERT_FALSE(diff.isEmpty());
+    ASSERT_BSONOBJ_EQ(BSONObj(), documentdiff::computeDiff(pre, post, diff.objsize()));
+    ASSERT_BSONOBJ_EQ(diff, documentdiff::computeDiff(pre, post, diff.objsize() + 1));
+}
+
+TEST(DocumentDiffTest, ApplyRejectsMalformedDiffs) {
+    BSONObj pre = fromjson("{_id: 1, a: 1, b: {c: 1}, arr: [1, 2]}");
+    const char* badDiffs[] = {
+        "{x: 1}",
+        "{u: 1}",
+        "{u: {missing: 1}}",
+        "{smissing: {u: {c: 2}}}",
+        "{sa: {u: {c: 2}}}",
+        "{sb: {a: true, u0: 1}}",
+        "{sarr: {u: {c: 2}}}",
+        "{sarr: {a: true, l: 5, u2: 1}}",
+        "{sarr: {a: true, u2: 1}}",
+        "{sarr: {a: true, l: 1, u1: 1}}",
+        "{sarr: {a: true, l: 3, u0: 1}}",
+        "{sarr: {a: true, ux: 1}}",
+    };
+    for (auto&& badDiff : badDiffs) {
+        ASSERT_EQ(ErrorCodes::BadValue,
+                  documentdiff::applyDiff(pre, fromjson(badDiff)).getStatus().code())
+            << badDiff;
+    }
+}
+
+TEST(DocumentDiffTest, DeltaOplogEntryUpdate) {
+    BSONObj diff = fromjson("{u: {a: 2}}");
+    BSONObj update = documentdiff::makeDeltaOplogEntryUpdate(diff);
+
+    BSONObj parsed;
+    ASSERT_TRUE(documentdiff::isDeltaOplogEntryUpdate(update, &parsed));
+    ASSERT_BSONOBJ_EQ(diff, parsed);
+    ASSERT_TRUE(documentdiff::isDeltaOplogEntryUpdate(update));
+
+    ASSERT_FALSE(documentdiff::isDeltaOplogEntryUpdate(fromjson("{$set: {a: 2}}")));
+    ASSERT_FALSE(documentdiff::isDeltaOplogEntryUpdate(fromjson("{_id: 1, a: 2}")));
+    ASSERT_FALSE(documentdiff::isDeltaOplogEntryUpdate(fromjson("{$v: 1, $set: {a: 2}}")));
+    ASSERT_FALSE(documentdiff::isDeltaOplogEntryUpdate(fromjson("{$v: 2, diff: 1}")));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -58,4 +58,26 @@ Status SetNode::setValueForNewElement(mutablebson::Element* element) const {
     return element->setValueBSONElement(_val);
 }
 
+Status SetNode::applyToField(const BSONObj& document,
+                             StringData fieldName,
+                             BSONElement existing,
+                             BSONObjBuilder* builder,
+                             LogBuilder* logBuilder,
+                             bool* noop) const {
+    if (existing.ok() && existing.binaryEqualValues(_val)) {
+        *noop = true;
+        builder->append(existing);
+        return Status::OK();
+    }
+
+    *noop = false;
+    builder->appendAs(_val, fieldName);
+
+    if (logBuilder) {
+        return logBuilder->addToSetsWithNewFieldName(fieldName, _val);
+    }
+
+    return Status::OK();
+}
+
 }  // namespace mongo
@@ -1740,4 +1740,52 @@ TEST(SetNodeTest, ApplySetModToEphemeralDocument) {
     ASSERT_FALSE(doc.isInPlaceModeEnabled());
 }
 
+TEST(SetNodeTest, ApplyToFieldReplacesExistingValue) {
+    auto update = fromjson("{$set: {a: 5}}");
+    const CollatorInterface* collator = nullptr;
+    SetNode node;
+    ASSERT_OK(node.init(update["$set"]["a"], collator));
+
+    auto doc = fromjson("{a: 'x'}");
+    Document logDoc;
+    LogBuilder logBuilder(logDoc.root());
+    BSONObjBuilder builder;
+    auto noop = true;
+    ASSERT_OK(node.applyToField(doc, "a", doc["a"], &builder, &logBuilder, &noop));
+    ASSERT_FALSE(noop);
+    ASSERT_BSONOBJ_EQ(fromjson("{a: 5}"), builder.obj());
+    ASSERT_EQUALS(fromjson("{$set: {a: 5}}"), logDoc);
+}
+
+TEST(SetNodeTest, ApplyToFieldCreatesMissingField) {
+    auto update = fromjson("{$set: {a: 5}}");
+    const CollatorInterface* collator = nullptr;
+    SetNode node;
+    ASSERT_OK(node.init(update["$set"]["a"], collator));
+
+    auto doc = fromjson("{b: 1}");
+    BSONObjBuilder builder;
+    auto noop = true;
+    ASSERT_OK(node.applyToField(doc, "a", BSONElement(), &builder, nullptr, &noop));
+    ASSERT_FALSE(noop);
+    ASSERT_BSONOBJ_EQ(fromjson("{a: 5}"), builder.obj());
+}
+
+TEST(SetNodeTest, ApplyToFieldNoOp) {
+    auto update = fromjson("{$set: {a: 5}}");
+    const CollatorInterface* collator = nullptr;
+    SetNode node;
+    ASSERT_OK(node.init(update["$set"]["a"], collator));
+
+    auto doc = fromjson("{a: 5}");
+    Document logDoc;
+    LogBuilder logBuilder(logDoc.root());
+    BSONObjBuilder builder;
+    auto noop = false;
+    ASSERT_OK(node.applyToField(doc, "a", doc["a"], &builder, &logBuilder, &noop));
+    ASSERT_TRUE(noop);
+    ASSERT_BSONOBJ_EQ(fromjson("{a: 5}"), builder.obj());
+    ASSERT_EQUALS(fromjson("{}"), logDoc);
+}
+
 }  // namespace
@@ -81,4 +81,24 @@ Status UnsetNode::apply(mutablebson::Element element,
     return Status::OK();
 }
 
+Status UnsetNode::applyToField(const BSONObj& document,
+                               StringData fieldName,
+                               BSONElement existing,
+                               BSONObjBuilder* builder,
+                               LogBuilder* logBuilder,
+                               bool* noop) const {
+    // Removing the field amounts to not appending it.
+    if (!existing.ok()) {
+        *noop = true;
+        return Status::OK();
+    }
+
+    *noop = false;
+    if (logBuilder) {
+        return logBuilder->addToUnsets(fieldName);
+    }
+
+    return Status::OK();
+}
+
 }  // namespace mongo
@@ -55,6 +55,17 @@ public:
                  LogBuilder* logBuilder,
                  bool* indexesAffected,
                  bool* noop) const final;
+
+    bool supportsApplyToField() const final {
+        return true;
+    }
+
+    Status applyToField(const BSONObj& document,
+                        StringData fieldName,
+                        BSONElement existing,
+                        BSONObjBuilder* builder,
+                        LogBuilder* logBuilder,
+                        bool* noop) const final;
 };
 
 }  // namespace mongo
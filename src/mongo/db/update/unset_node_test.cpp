@@ -576,4 +576,35 @@ TEST(UnsetNodeTest, ApplyFieldWithDot) {
     ASSERT_EQUALS(fromjson("{$unset: {'a.b': true}}"), logDoc);
 }
 
+TEST(UnsetNodeTest, ApplyToFieldRemovesExistingField) {
+    auto update = fromjson("{$unset: {a: 1}}");
+    const CollatorInterface* collator = nullptr;
+    UnsetNode node;
+    ASSERT_OK(node.init(update["$unset"]["a"], collator));
+
+    auto doc = fromjson("{a: 5}");
+    Document logDoc;
+    LogBuilder logBuilder(logDoc.root());
+    BSONObjBuilder builder;
+    auto noop = true;
+    ASSERT_OK(node.applyToField(doc, "a", doc["a"], &builder, &logBuilder, &noop));
+    ASSERT_FALSE(noop);
+    ASSERT_BSONOBJ_EQ(fromjson("{}"), builder.obj());
+    ASSERT_EQUALS(fromjson("{$unset: {a: true}}"), logDoc);
+}
+
+TEST(UnsetNodeTest, ApplyToFieldNoOpForMissingField) {
+    auto update = fromjson("{$unset: {a: 1}}");
+    const CollatorInterface* collator = nullptr;
+    UnsetNode node;
+    ASSERT_OK(node.init(update["$unset"]["a"], collator));
+
+    auto doc = fromjson("{b: 5}");
+    BSONObjBuilder builder;
+    auto noop = false;
+    ASSERT_OK(node.applyToField(doc, "a", BSONElement(), &builder, nullptr, &noop));
+    ASSERT_TRUE(noop);
+    ASSERT_BSONOBJ_EQ(fromjson("{}"), builder.obj());
+}
+
 }  // namespace
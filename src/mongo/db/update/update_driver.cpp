@@ -40,6 +40,8 @@
 #include "mongo/db/update/log_builder.h"
 #include "mongo/db/update/modifier_table.h"
 #include "mongo/db/update/path_support.h"
+#include "mongo/db/update/update_leaf_node.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/util/embedded_builder.h"
 #include "mongo/util/mongoutils/str.h"
 
@@ -138,6 +140,8 @@ Status UpdateDriver::parse(const BSONObj& updateExpr, const bool multi) {
         }
     }
 
+    parseDirectUpdate(updateExpr);
+
     // Register the fact that there will be only $mod's in this driver -- no object
     // replacement.
     _replacementMode = false;
@@ -173,6 +177,50 @@ inline Status UpdateDriver::addAndParse(const modifiertable::ModifierType type,
     return Status::OK();
 }
 
+void UpdateDriver::parseDirectUpdate(const BSONObj& updateExpr) {
+    std::vector<DirectUpdateField> fields;
+
+    for (auto&& outerModElem : updateExpr) {
+        const auto modType = modifiertable::getType(outerModElem.fieldName());
+        if (modType != modifiertable::MOD_SET && modType != modifiertable::MOD_INC &&
+            modType != modifiertable::MOD_MUL && modType != modifiertable::MOD_UNSET) {
+            return;
+        }
+
+        for (auto&& innerModElem : outerModElem.embeddedObject()) {
+            const auto fieldName = innerModElem.fieldNameStringData();
+            if (fieldName.empty() || fieldName[0] == '$' ||
+                fieldName.find('.') != std::string::npos || fieldName == "_id") {
+                return;
+            }
+
+            // Objects and arrays are left to update(), whose caller validates them for storage.
+            if (modType == modifiertable::MOD_SET &&
+                (innerModElem.type() == Object || innerModElem.type() == Array)) {
+                return;
+            }
+
+            // Conflicting mods are also left to update(), which reports the conflict.
+            for (auto&& field : fields) {
+                if (field.path->dottedField() == fieldName) {
+                    return;
+                }
+            }
+
+            auto node = modifiertable::makeUpdateLeafNode(modType);
+            if (!node || !node->supportsApplyToField()) {
+                return;
+            }
+            if (!node->init(innerModElem, nullptr).isOK()) {
+                return;
+            }
+            fields.push_back({stdx::make_unique<FieldRef>(fieldName), std::move(node)});
+        }
+    }
+
+    _directUpdateFields = std::move(fields);
+}
+
 Status UpdateDriver::populateDocumentWithQueryFields(OperationContext* opCtx,
                                                      const BSONObj& query,
                                                      const vector<FieldRef*>* immutablePaths,
@@ -326,6 +374,107 @@ Status UpdateDriver::update(StringData matchedField,
     return Status::OK();
 }
 
+bool UpdateDriver::canUpdateDirect() const {
+    return !_directUpdateFields.empty();
+}
+
+Status UpdateDriver::updateDirect(const BSONObj& original,
+                                  BSONObj* newObj,
+                                  BSONObj* logOpRec,
+                                  FieldRefSet* updatedFields,
+                                  bool* docWasModified) {
+    invariant(canUpdateDirect());
+
+    if (updatedFields) {
+        for (auto&& field : _directUpdateFields) {
+            updatedFields->insert(field.path.get());
+        }
+    }
+
+    _affectIndices = false;
+    _logDoc.reset();
+    LogBuilder logBuilder(_logDoc.root());
+    LogBuilder* logBuilderPtr = (_logOp && logOpRec) ? &logBuilder : nullptr;
+
+    BSONObjBuilder builder(original.objsize() + 128);
+    bool noop = true;
+    std::vector<bool> applied(_directUpdateFields.size(), false);
+
+    auto applyField = [&](size_t i, BSONElement existing) {
+        const DirectUpdateField& field = _directUpdateFields[i];
+        const StringData fieldName = field.path->dottedField();
+        bool fieldNoop = false;
+        Status status = field.node->applyToField(
+            original, fieldName, existing, &builder, logBuilderPtr, &fieldNoop);
+        if (!status.isOK()) {
+            return status;
+        }
+
+        applied[i] = true;
+        if (!fieldNoop) {
+            noop = false;
+            if (_indexedFields && _indexedFields->mightBeIndexed(fieldName)) {
+                _affectIndices = true;
+            }
+        }
+        return Status::OK();
+    };
+
+    // Updates of this shape name only a handful of fields, so they are scanned linearly for each
+    // field of the document. Only the first occurrence of a field name is updated, as update()
+    // does for documents with duplicate field names.
+    size_t remaining = _directUpdateFields.size();
+    BSONObjIterator it(original);
+    while (it.more()) {
+        BSONElement element = it.next();
+
+        size_t match = _directUpdateFields.size();
+        if (remaining > 0) {
+            const auto fieldName = element.fieldNameStringData();
+            for (size_t i = 0; i < _directUpdateFields.size(); ++i) {
+                if (!applied[i] && _directUpdateFields[i].path->dottedField() == fieldName) {
+                    match = i;
+                    break;
+                }
+            }
+        }
+
+        if (match == _directUpdateFields.size()) {
+            builder.append(element);
+            continue;
+        }
+
+        Status status = applyField(match, element);
+        if (!status.isOK()) {
+            return status;
+        }
+        --remaining;
+    }
+
+    // The fields that do not exist yet are created at the end, in the order of the mods.
+    for (size_t i = 0; i < _directUpdateFields.size(); ++i) {
+        if (!applied[i]) {
+            Status status = applyField(i, BSONElement());
+            if (!status.isOK()) {
+                return status;
+            }
+        }
+    }
+
+    if (noop) {
+        *newObj = original;
+    } else {
+        *newObj = builder.obj();
+        if (docWasModified)
+            *docWasModified = true;
+    }
+
+    if (logBuilderPtr)
+        *logOpRec = _logDoc.getObject();
+
+    return Status::OK();
+}
+
 size_t UpdateDriver::numMods() const {
     return _mods.size();
 }
@@ -398,6 +547,7 @@ void UpdateDriver::clear() {
         delete *it;
     }
     _mods.clear();
+    _directUpdateFields.clear();
     _indexedFields = NULL;
     _replacementMode = false;
     _positional = false;
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -45,6 +46,7 @@ namespace mongo {
 
 class CollatorInterface;
 class OperationContext;
+class UpdateLeafNode;
 
 class UpdateDriver {
 public:
@@ -104,6 +106,26 @@ public:
                   FieldRefSet* updatedFields = NULL,
                   bool* docWasModified = NULL);
 
+    /**
+     * Returns true if the update can be applied with updateDirect(). That is the case when it is
+     * made only of $set, $inc, $mul and $unset on top-level fields other than _id, and every $set
+     * value is neither an object nor an array.
+     */
+    bool canUpdateDirect() const;
+
+    /**
+     * Like update(), but applies the mods to 'original' in a single pass that builds '*newObj'
+     * directly, without constructing a mutablebson::Document. Fields the mods do not touch are
+     * copied as they are, updated fields keep their position, and created fields are appended in
+     * the order of the mods, exactly as update() would do. If the update is a no-op, '*newObj'
+     * is set to 'original'. Requires canUpdateDirect().
+     */
+    Status updateDirect(const BSONObj& original,
+                        BSONObj* newObj,
+                        BSONObj* logOpRec = NULL,
+                        FieldRefSet* updatedFields = NULL,
+                        bool* docWasModified = NULL);
+
     //
     // Accessors
     //
@@ -150,6 +172,12 @@ private:
     /** Create the modifier and add it to the back of the modifiers vector */
     inline Status addAndParse(const modifiertable::ModifierType type, const BSONElement& elem);
 
+    /**
+     * Fills in '_directUpdateFields' if 'updateExpr', which has already been parsed into '_mods',
+     * has a shape that updateDirect() supports.
+     */
+    void parseDirectUpdate(const BSONObj& updateExpr);
+
     //
     // immutable properties after parsing
     //
@@ -160,6 +188,16 @@ private:
     // Collection of update mod instances. Owned here.
     std::vector<ModifierInterface*> _mods;
 
+    // A top-level field and the update node that updateDirect() applies to it.
+    struct DirectUpdateField {
+        std::unique_ptr<FieldRef> path;
+        std::unique_ptr<UpdateLeafNode> node;
+    };
+
+    // The same update as '_mods', in the same order, for updateDirect() to apply. Empty if the
+    // update has a shape that updateDirect() does not support.
+    std::vector<DirectUpdateField> _directUpdateFields;
+
     // What are the list of fields in the collection over which the update is going to be
     // applied that participate in indices?
     //
@@ -428,4 +428,96 @@ TEST_F(CreateFromQuery, NotFullShardKeyRepl) {
         opCtx(), query, &immutablePaths.vector(), doc()));
 }
 
+TEST(UpdateDirect, SupportedShapes) {
+    for (auto&& update : {"{$set: {a: 1}}",
+                          "{$set: {a: 'x', b: null}, $inc: {c: 1}}",
+                          "{$mul: {a: 2}, $unset: {b: 1}}"}) {
+        UpdateDriver driver((UpdateDriver::Options()));
+        ASSERT_OK(driver.parse(fromjson(update)));
+        ASSERT_TRUE(driver.canUpdateDirect()) << update;
+    }
+
+    for (auto&& update : {"{$set: {'a.b': 1}}",
+                          "{$set: {a: {b: 1}}}",
+                          "{$set: {a: [1]}}",
+                          "{$set: {_id: 1}}",
+                          "{$set: {a: 1}, $inc: {a: 1}}",
+                          "{$push: {a: 1}}",
+                          "{$setOnInsert: {a: 1}}",
+                          "{a: 1}"}) {
+        UpdateDriver driver((UpdateDriver::Options()));
+        ASSERT_OK(driver.parse(fromjson(update)));
+        ASSERT_FALSE(driver.canUpdateDirect()) << update;
+    }
+}
+
+TEST(UpdateDirect, MatchesUpdate) {
+    // The created fields must come out in the order of the mods, as they do with update().
+    BSONObj update = fromjson("{$set: {z: 1, b: 'new'}, $inc: {c: 5}, $unset: {d: 1}}");
+    for (auto&& original : {fromjson("{_id: 1}"),
+                            fromjson("{_id: 1, a: {x: [1, 2]}, b: 'old', c: 1, d: 1, e: 2}"),
+                            fromjson("{_id: 1, c: NumberLong(7), z: 1}"),
+                            fromjson("{_id: 1, b: 1, b: 2, d: 3, d: 4}")}) {
+        UpdateDriver::Options opts;
+        opts.logOp = true;
+        UpdateDriver driver(opts);
+        ASSERT_OK(driver.parse(update));
+        ASSERT_TRUE(driver.canUpdateDirect());
+
+        Document doc(original);
+        BSONObj logObj;
+        mongo::FieldRefSet updatedFields;
+        bool modified = false;
+        ASSERT_OK(driver.update(StringData(), &doc, &logObj, &updatedFields, &modified));
+
+        BSONObj directObj;
+        BSONObj directLogObj;
+        mongo::FieldRefSet directUpdatedFields;
+        bool directModified = false;
+        ASSERT_OK(driver.updateDirect(
+            original, &directObj, &directLogObj, &directUpdatedFields, &directModified));
+
+        ASSERT_BSONOBJ_EQ(doc.getObject(), directObj);
+        assertSameFields(logObj, directLogObj);
+        ASSERT_EQ(modified, directModified);
+        ASSERT_EQ(updatedFields.toString(), directUpdatedFields.toString());
+    }
+}
+
+TEST(UpdateDirect, NoopReturnsOriginal) {
+    UpdateDriver driver((UpdateDriver::Options()));
+    ASSERT_OK(driver.parse(fromjson("{$set: {a: 1}, $unset: {b: 1}}")));
+
+    BSONObj original = fromjson("{_id: 1, a: 1}");
+    BSONObj newObj;
+    bool modified = false;
+    ASSERT_OK(driver.updateDirect(original, &newObj, nullptr, nullptr, &modified));
+    ASSERT_FALSE(modified);
+    ASSERT_EQ(original.objdata(), newObj.objdata());
+}
+
+TEST(UpdateDirect, AffectsIndices) {
+    UpdateIndexData indexData;
+    indexData.addPath("b");
+    UpdateDriver driver((UpdateDriver::Options()));
+    ASSERT_OK(driver.parse(fromjson("{$set: {a: 1, b: 1}}")));
+    driver.refreshIndexKeys(&indexData);
+
+    BSONObj newObj;
+    ASSERT_OK(driver.updateDirect(fromjson("{_id: 1, a: 0, b: 1}"), &newObj));
+    ASSERT_FALSE(driver.modsAffectIndices());
+
+    ASSERT_OK(driver.updateDirect(fromjson("{_id: 1, a: 0, b: 0}"), &newObj));
+    ASSERT_TRUE(driver.modsAffectIndices());
+}
+
+TEST(UpdateDirect, IncOnNonNumericFails) {
+    UpdateDriver driver((UpdateDriver::Options()));
+    ASSERT_OK(driver.parse(fromjson("{$inc: {a: 1}}")));
+
+    BSONObj newObj;
+    ASSERT_EQUALS(mongo::ErrorCodes::TypeMismatch,
+                  driver.updateDirect(fromjson("{_id: 1, a: 'x'}"), &newObj));
+}
+
 }  // unnamed namespace
@@ -52,6 +52,32 @@ public:
      * multiple documents.
      */
     virtual Status init(BSONElement modExpr, const CollatorInterface* collator) = 0;
+
+    /**
+     * Returns true if the node implements applyToField(), which lets an update made only of such
+     * leaves on top-level fields be applied directly to the original BSONObj, without building a
+     * mutablebson::Document. See UpdateDriver::updateDirect().
+     */
+    virtual bool supportsApplyToField() const {
+        return false;
+    }
+
+    /**
+     * Applies the update to the top-level field 'fieldName' of 'document'. 'existing' is the
+     * current value of the field, or EOO if 'document' does not have it. Appends the field as it
+     * should appear in the updated document to 'builder', or nothing if the field is not present
+     * afterwards. If a LogBuilder is provided, logs the update. Outputs whether the operation was a
+     * no-op. Returns a non-OK status if the update cannot be applied to the field. Only called when
+     * supportsApplyToField() is true.
+     */
+    virtual Status applyToField(const BSONObj& document,
+                                StringData fieldName,
+                                BSONElement existing,
+                                BSONObjBuilder* builder,
+                                LogBuilder* logBuilder,
+                                bool* noop) const {
+        MONGO_UNREACHABLE;
+    }
 };
 
 }  // namespace mongo
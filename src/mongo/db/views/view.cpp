@@ -33,9 +33,56 @@
 #include <memory>
 
 #include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
 
+StatusWith<MaterializedViewOptions> MaterializedViewOptions::parse(StringData dbName,
+                                                                   const BSONObj& options) {
+    MaterializedViewOptions parsed;
+    for (auto&& elem : options) {
+        const auto fieldName = elem.fieldNameStringData();
+        if (fieldName == "into"_sd) {
+            if (elem.type() != BSONType::String) {
+                return {ErrorCodes::TypeMismatch, "'materialized.into' has to be a string"};
+            }
+            if (!NamespaceString::validCollectionName(elem.valueStringData())) {
+                return {ErrorCodes::InvalidNamespace,
+                        str::stream() << "invalid name for 'materialized.into': "
+                                      << elem.valueStringData()};
+            }
+            parsed.into = NamespaceString(dbName, elem.valueStringData());
+            if (parsed.into.isSystem()) {
+                return {ErrorCodes::InvalidNamespace,
+                        "'materialized.into' cannot be a system collection"};
+            }
+        } else if (fieldName == "maxStalenessMS"_sd) {
+            if (!elem.isNumber()) {
+                return {ErrorCodes::TypeMismatch,
+                        "'materialized.maxStalenessMS' has to be a number"};
+            }
+            if (elem.numberLong() < 0) {
+                return {ErrorCodes::BadValue, "'materialized.maxStalenessMS' cannot be negative"};
+            }
+            parsed.maxStaleness = Milliseconds(elem.numberLong());
+        } else {
+            return {ErrorCodes::BadValue,
+                    str::stream() << "unrecognized field 'materialized." << fieldName << "'"};
+        }
+    }
+
+    if (parsed.into.coll().empty()) {
+        return {ErrorCodes::BadValue, "a materialized view requires 'materialized.into'"};
+    }
+    return parsed;
+}
+
+BSONObj MaterializedViewOptions::toBSON() const {
+    return BSON("into" << into.coll() << "maxStalenessMS"
+                       << durationCount<Milliseconds>(maxStaleness));
+}
+
 ViewDefinition::ViewDefinition(StringData dbName,
                                StringData viewName,
                                StringData viewOnName,
@@ -51,13 +98,15 @@ ViewDefinition::ViewDefinition(const ViewDefinition& other)
     : _viewNss(other._viewNss),
       _viewOnNss(other._viewOnNss),
       _collator(CollatorInterface::cloneCollator(other._collator.get())),
-      _pipeline(other._pipeline) {}
+      _pipeline(other._pipeline),
+      _materialization(other._materialization) {}
 
 ViewDefinition& ViewDefinition::operator=(const ViewDefinition& other) {
     _viewNss = other._viewNss;
     _viewOnNss = other._viewOnNss;
     _collator = CollatorInterface::cloneCollator(other._collator.get());
     _pipeline = other._pipeline;
+    _materialization = other._materialization;
 
     return *this;
 }
@@ -75,4 +124,9 @@ void ViewDefinition::setPipeline(const BSONElement& pipeline) {
         _pipeline.push_back(value.copy());
     }
 }
+
+void ViewDefinition::setMaterialization(boost::optional<MaterializedViewOptions> materialization) {
+    invariant(!materialization || materialization->into.db() == _viewNss.db());
+    _materialization = std::move(materialization);
+}
 }  // namespace mongo
@@ -28,16 +28,38 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
 #include <memory>
 #include <vector>
 
+#include "mongo/base/status_with.h"
 #include "mongo/base/string_data.h"
 #include "mongo/bson/bsonobj.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
+/**
+ * The options of a materialized view. Such a view keeps a copy of its contents in the collection
+ * 'into', which the refreshView command recomputes. Reads of the view use that copy as long as it
+ * has been refreshed and has been stale for less than 'maxStaleness'; otherwise they run the view's
+ * pipeline as for any other view.
+ */
+struct MaterializedViewOptions {
+    /**
+     * Parses the 'materialized' option of a view in the database 'dbName', which looks like
+     * {into: <collection name>, maxStalenessMS: <number>}.
+     */
+    static StatusWith<MaterializedViewOptions> parse(StringData dbName, const BSONObj& options);
+
+    BSONObj toBSON() const;
+
+    NamespaceString into;
+    Milliseconds maxStaleness{0};
+};
+
 /**
  * Represents a "view": a virtual collection defined by a query on a collection or another view.
  */
@@ -89,6 +111,13 @@ public:
         return _collator.get();
     }
 
+    /**
+     * Returns the options of this view if it is materialized, or boost::none if it is not.
+     */
+    const boost::optional<MaterializedViewOptions>& materialization() const {
+        return _materialization;
+    }
+
     void setViewOn(const NamespaceString& viewOnNss);
 
     /**
@@ -96,10 +125,13 @@ public:
      */
     void setPipeline(const BSONElement& pipeline);
 
+    void setMaterialization(boost::optional<MaterializedViewOptions> materialization);
+
 private:
     NamespaceString _viewNss;
     NamespaceString _viewOnNss;
     std::unique_ptr<CollatorInterface> _collator;
     std::vector<BSONObj> _pipeline;
+    boost::optional<MaterializedViewOptions> _materialization;
 };
 }  // namespace mongo
@@ -45,6 +45,7 @@
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/lite_parsed_pipeline.h"
 #include "mongo/db/pipeline/pipeline.h"
+#include "mongo/db/query/collation/collation_spec.h"
 #include "mongo/db/query/collation/collator_factory_interface.h"
 #include "mongo/db/server_options.h"
 #include "mongo/db/server_parameters.h"
@@ -65,8 +66,14 @@ StatusWith<std::unique_ptr<CollatorInterface>> parseCollator(OperationContext* o
     }
     return CollatorFactoryInterface::get(opCtx->getServiceContext())->makeFromBSON(collationSpec);
 }
+
+// The key of '_materializedViewsBySource' under which are recorded the materialized views whose
+// sources could not be determined. Changes to any namespace make them stale.
+const char kAnySource[] = "";
 }  // namespace
 
+AtomicBool ViewCatalog::_anyMaterializedViews;
+
 Status ViewCatalog::reloadIfNeeded(OperationContext* opCtx) {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     return _reloadIfNeeded_inlock(opCtx);
@@ -78,8 +85,11 @@ Status ViewCatalog::_reloadIfNeeded_inlock(OperationContext* opCtx) {
 
     LOG(1) << "reloading view catalog for database " << _durable->getName();
 
-    // Need to reload, first clear our cache.
+    // Need to reload, first clear our cache. The view definitions may have changed in any way, so
+    // forget what was refreshed too.
     _viewMap.clear();
+    _materializationStates.clear();
+    _materializationSourcesNeedRefresh = true;
 
     Status status = _durable->iterate(opCtx, [&](const BSONObj& view) -> Status {
         BSONObj collationSpec = view.hasField("collation") ? view["collation"].Obj() : BSONObj();
@@ -101,11 +111,26 @@ Status ViewCatalog::_reloadIfNeeded_inlock(OperationContext* opCtx) {
             }
         }
 
-        _viewMap[viewName.ns()] = std::make_shared<ViewDefinition>(viewName.db(),
-                                                                   viewName.coll(),
-                                                                   view["viewOn"].str(),
-                                                                   pipeline,
-                                                                   std::move(collator.getValue()));
+        auto viewDef = std::make_shared<ViewDefinition>(viewName.db(),
+                                                        viewName.coll(),
+                                                        view["viewOn"].str(),
+                                                        pipeline,
+                                                        std::move(collator.getValue()));
+
+        if (view.hasField("materialized")) {
+            auto materialization =
+                MaterializedViewOptions::parse(viewName.db(), view["materialized"].Obj());
+            if (!materialization.isOK()) {
+                return {ErrorCodes::InvalidViewDefinition,
+                        str::stream() << "View " << viewName.toString()
+                                      << " has invalid 'materialized' options: "
+                                      << materialization.getStatus().reason()};
+            }
+            viewDef->setMaterialization(std::move(materialization.getValue()));
+            _anyMaterializedViews.store(true);
+        }
+
+        _viewMap[viewName.ns()] = std::move(viewDef);
         return Status::OK();
     });
     _valid.store(status.isOK());
@@ -126,11 +151,13 @@ void ViewCatalog::iterate(OperationContext* opCtx, ViewIteratorCallback callback
     }
 }
 
-Status ViewCatalog::_createOrUpdateView_inlock(OperationContext* opCtx,
-                                               const NamespaceString& viewName,
-                                               const NamespaceString& viewOn,
-                                               const BSONArray& pipeline,
-                                               std::unique_ptr<CollatorInterface> collator) {
+Status ViewCatalog::_createOrUpdateView_inlock(
+    OperationContext* opCtx,
+    const NamespaceString& viewName,
+    const NamespaceString& viewOn,
+    const BSONArray& pipeline,
+    std::unique_ptr<CollatorInterface> collator,
+    boost::optional<MaterializedViewOptions> materialization) {
     _requireValidCatalog_inlock(opCtx);
 
     // Build the BSON definition for this view to be saved in the durable view catalog. If the
@@ -142,10 +169,14 @@ Status ViewCatalog::_createOrUpdateView_inlock(OperationContext* opCtx,
     if (collator) {
         viewDefBuilder.append("collation", collator->getSpec().toBSON());
     }
+    if (materialization) {
+        viewDefBuilder.append("materialized", materialization->toBSON());
+    }
 
     BSONObj ownedPipeline = pipeline.getOwned();
     auto view = std::make_shared<ViewDefinition>(
         viewName.db(), viewName.coll(), viewOn.coll(), ownedPipeline, std::move(collator));
+    view->setMaterialization(std::move(materialization));
 
     // Check that the resulting dependency graph is acyclic and within the maximum depth.
     Status graphStatus = _upsertIntoGraph(opCtx, *(view.get()));
@@ -155,9 +186,17 @@ Status ViewCatalog::_createOrUpdateView_inlock(OperationContext* opCtx,
 
     _durable->upsert(opCtx, viewName, viewDefBuilder.obj());
     _viewMap[viewName.ns()] = view;
+    if (view->materialization()) {
+        _anyMaterializedViews.store(true);
+    }
+
+    // Whatever the view materialized so far no longer matches its definition.
+    _materializationStates.erase(viewName.ns());
+    _materializationSourcesNeedRefresh = true;
     opCtx->recoveryUnit()->onRollback([this, viewName]() {
         this->_viewMap.erase(viewName.ns());
         this->_viewGraphNeedsRefresh = true;
+        this->_materializationSourcesNeedRefresh = true;
     });
 
     // We may get invalidated, but we're exclusively locked, so the change must be ours.
@@ -259,7 +298,8 @@ Status ViewCatalog::createView(OperationContext* opCtx,
                                const NamespaceString& viewName,
                                const NamespaceString& viewOn,
                                const BSONArray& pipeline,
-                               const BSONObj& collation) {
+                               const BSONObj& collation,
+                               const BSONObj& materialized) {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
 
     if (serverGlobalParams.featureCompatibility.version.load() ==
@@ -290,8 +330,28 @@ Status ViewCatalog::createView(OperationContext* opCtx,
     if (!collator.isOK())
         return collator.getStatus();
 
-    return _createOrUpdateView_inlock(
-        opCtx, viewName, viewOn, pipeline, std::move(collator.getValue()));
+    boost::optional<MaterializedViewOptions> materialization;
+    if (!materialized.isEmpty()) {
+        auto parsed = MaterializedViewOptions::parse(viewName.db(), materialized);
+        if (!parsed.isOK())
+            return parsed.getStatus();
+
+        const auto& into = parsed.getValue().into;
+        if (into == viewName || into == viewOn)
+            return Status(ErrorCodes::InvalidOptions,
+                          "A view cannot be materialized into itself or into its 'viewOn'");
+        if (_lookup_inlock(opCtx, into.ns()))
+            return Status(ErrorCodes::InvalidOptions,
+                          str::stream() << "Cannot materialize a view into the view " << into.ns());
+        materialization = std::move(parsed.getValue());
+    }
+
+    return _createOrUpdateView_inlock(opCtx,
+                                      viewName,
+                                      viewOn,
+                                      pipeline,
+                                      std::move(collator.getValue()),
+                                      std::move(materialization));
 }
 
 Status ViewCatalog::modifyView(OperationContext* opCtx,
@@ -321,6 +381,11 @@ Status ViewCatalog::modifyView(OperationContext* opCtx,
         return Status(ErrorCodes::InvalidNamespace,
                       str::stream() << "invalid name for 'viewOn': " << viewOn.coll());
 
+    if (viewPtr->materialization() && viewPtr->materialization()->into == viewOn)
+        return Status(ErrorCodes::InvalidOptions,
+                      "A materialized view cannot be defined on the collection it is materialized "
+                      "into");
+
     ViewDefinition savedDefinition = *viewPtr;
     opCtx->recoveryUnit()->onRollback([this, opCtx, viewName, savedDefinition]() {
         this->_viewMap[viewName.ns()] = std::make_shared<ViewDefinition>(savedDefinition);
@@ -331,7 +396,8 @@ Status ViewCatalog::modifyView(OperationContext* opCtx,
         viewName,
         viewOn,
         pipeline,
-        CollatorInterface::cloneCollator(savedDefinition.defaultCollator()));
+        CollatorInterface::cloneCollator(savedDefinition.defaultCollator()),
+        savedDefinition.materialization());
 }
 
 Status ViewCatalog::dropView(OperationContext* opCtx, const NamespaceString& viewName) {
@@ -351,8 +417,11 @@ Status ViewCatalog::dropView(OperationContext* opCtx, const NamespaceString& vie
     _durable->remove(opCtx, viewName);
     _viewGraph.remove(savedDefinition.name());
     _viewMap.erase(viewName.ns());
+    _materializationStates.erase(viewName.ns());
+    _materializationSourcesNeedRefresh = true;
     opCtx->recoveryUnit()->onRollback([this, opCtx, viewName, savedDefinition]() {
         this->_viewGraphNeedsRefresh = true;
+        this->_materializationSourcesNeedRefresh = true;
         this->_viewMap[viewName.ns()] = std::make_shared<ViewDefinition>(savedDefinition);
     });
 
@@ -391,8 +460,15 @@ std::shared_ptr<ViewDefinition> ViewCatalog::lookup(OperationContext* opCtx, Str
 }
 
 StatusWith<ResolvedView> ViewCatalog::resolveView(OperationContext* opCtx,
-                                                  const NamespaceString& nss) {
+                                                  const NamespaceString& nss,
+                                                  bool useMaterializations) {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _resolveView_inlock(opCtx, nss, useMaterializations);
+}
+
+StatusWith<ResolvedView> ViewCatalog::_resolveView_inlock(OperationContext* opCtx,
+                                                          const NamespaceString& nss,
+                                                          bool useMaterializations) {
     const NamespaceString* resolvedNss = &nss;
     std::vector<BSONObj> resolvedPipeline;
 
@@ -412,6 +488,13 @@ StatusWith<ResolvedView> ViewCatalog::resolveView(OperationContext* opCtx,
             return StatusWith<ResolvedView>({*resolvedNss, resolvedPipeline});
         }
 
+        // Read a materialized view from the collection that holds its contents, if they are fresh
+        // enough.
+        if (useMaterializations && view->materialization() &&
+            _canReadMaterialization_inlock(opCtx, *view)) {
+            return StatusWith<ResolvedView>({view->materialization()->into, resolvedPipeline});
+        }
+
         resolvedNss = &(view->viewOn());
 
         // Prepend the underlying view's pipeline to the current working pipeline.
@@ -428,4 +511,223 @@ StatusWith<ResolvedView> ViewCatalog::resolveView(OperationContext* opCtx,
             str::stream() << "View depth too deep or view cycle detected; maximum depth is "
                           << ViewGraph::kMaxViewDepth};
 }
+
+bool ViewCatalog::_canReadMaterialization_inlock(OperationContext* opCtx,
+                                                 const ViewDefinition& view) {
+    auto it = _materializationStates.find(view.name().ns());
+    if (it == _materializationStates.end() || it->second.refreshedAt < 0) {
+        return false;
+    }
+
+    // A view created since the refresh would hide the materialized contents.
+    const auto& options = *view.materialization();
+    if (_lookup_inlock(opCtx, options.into.ns())) {
+        return false;
+    }
+
+    const auto& state = it->second;
+    return state.sourceChanges == state.refreshedAt ||
+        Date_t::now() - state.staleSince < options.maxStaleness;
+}
+
+ViewCatalog::MaterializationState& ViewCatalog::_getMaterializationState_inlock(
+    const NamespaceString& viewName) {
+    auto& state = _materializationStates[viewName.ns()];
+    if (state.id == 0) {
+        state.id = ++_nextMaterializationStateId;
+    }
+    return state;
+}
+
+void ViewCatalog::_refreshMaterializationSources_inlock() {
+    if (!_materializationSourcesNeedRefresh) {
+        return;
+    }
+
+    _materializedViewsBySource.clear();
+    for (auto&& entry : _viewMap) {
+        const auto& materializedView = *entry.second;
+        if (!materializedView.materialization()) {
+            continue;
+        }
+
+        // Walk down the views this view is defined on, recording every namespace they read.
+        StringMap<bool> sources;
+        std::vector<const ViewDefinition*> toVisit{&materializedView};
+        try {
+            while (!toVisit.empty()) {
+                const ViewDefinition* view = toVisit.back();
+                toVisit.pop_back();
+
+                AggregationRequest request(view->viewOn(), view->pipeline());
+                const LiteParsedPipeline liteParsedPipeline(request);
+                auto refs = liteParsedPipeline.getInvolvedNamespaces();
+                refs.insert(view->viewOn());
+                for (auto&& ref : refs) {
+                    if (!sources.try_emplace(ref.ns(), true).second) {
+                        continue;
+                    }
+                    auto it = _viewMap.find(ref.ns());
+                    if (it != _viewMap.end()) {
+                        toVisit.push_back(it->second.get());
+                    }
+                }
+            }
+        } catch (const DBException& ex) {
+            // Stay safe if some pipeline does not parse: the view then depends on everything.
+            LOG(1) << "could not determine the sources of materialized view "
+                   << materializedView.name() << ": " << ex.toStatus();
+            sources.clear();
+            sources[kAnySource] = true;
+        }
+
+        for (auto&& source : sources) {
+            _materializedViewsBySource[source.first].push_back(materializedView.name());
+        }
+    }
+    _materializationSourcesNeedRefresh = false;
+}
+
+void ViewCatalog::onSourceChange(OperationContext* opCtx, const NamespaceString& nss) {
+    opCtx->recoveryUnit()->onCommit([this, nss]() { this->_onSourceChangeCommitted(nss, false); });
+}
+
+void ViewCatalog::onCollectionDrop(OperationContext* opCtx, const NamespaceString& nss) {
+    opCtx->recoveryUnit()->onCommit([this, nss]() { this->_onSourceChangeCommitted(nss, true); });
+}
+
+void ViewCatalog::_onSourceChangeCommitted(const NamespaceString& nss, bool dropped) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    // Reloading the catalog forgets every refresh anyway.
+    if (!_valid.load()) {
+        return;
+    }
+
+    const Date_t now = Date_t::now();
+    auto markStale = [&](const std::vector<NamespaceString>& views) {
+        for (auto&& viewName : views) {
+            auto it = _materializationStates.find(viewName.ns());
+            if (it == _materializationStates.end()) {
+                continue;
+            }
+            auto& state = it->second;
+            if (state.sourceChanges == state.refreshedAt) {
+                state.staleSince = now;
+            }
+            ++state.sourceChanges;
+        }
+    };
+
+    _refreshMaterializationSources_inlock();
+    for (auto&& key : {StringData(nss.ns()), StringData(kAnySource)}) {
+        auto it = _materializedViewsBySource.find(key);
+        if (it != _materializedViewsBySource.end()) {
+            markStale(it->second);
+        }
+    }
+
+    if (!dropped) {
+        return;
+    }
+
+    // Views materialized into a dropped collection must be refreshed before they can be read
+    // from it again. Keep their states, so that a refresh which is replacing the collection can
+    // still complete.
+    for (auto&& entry : _viewMap) {
+        const auto& view = *entry.second;
+        if (!view.materialization() || view.materialization()->into != nss) {
+            continue;
+        }
+        auto it = _materializationStates.find(view.name().ns());
+        if (it != _materializationStates.end()) {
+            it->second.refreshedAt = -1;
+        }
+    }
+}
+
+StatusWith<ViewCatalog::MaterializedViewRefresh> ViewCatalog::beginMaterializedViewRefresh(
+    OperationContext* opCtx, const NamespaceString& viewName) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto view = _lookup_inlock(opCtx, viewName.ns());
+    if (!view) {
+        return {ErrorCodes::NamespaceNotFound,
+                str::stream() << "cannot refresh missing view " << viewName.ns()};
+    }
+    if (!view->materialization()) {
+        return {ErrorCodes::InvalidOptions,
+                str::stream() << "view " << viewName.ns() << " is not materialized"};
+    }
+
+    const auto& into = view->materialization()->into;
+    if (_lookup_inlock(opCtx, into.ns())) {
+        return {ErrorCodes::InvalidOptions,
+                str::stream() << "cannot materialize view " << viewName.ns() << " into the view "
+                              << into.ns()};
+    }
+
+    // The refresh must recompute the view, not copy other materializations which may be stale.
+    auto resolvedView = _resolveView_inlock(opCtx, viewName, false);
+    if (!resolvedView.isOK()) {
+        return resolvedView.getStatus();
+    }
+
+    auto collation = view->defaultCollator()
+        ? view->defaultCollator()->getSpec().toBSON().getOwned()
+        : CollationSpec::kSimpleSpec;
+
+    const auto& state = _getMaterializationState_inlock(viewName);
+    return MaterializedViewRefresh{std::move(resolvedView.getValue()),
+                                   std::move(collation),
+                                   into,
+                                   Date_t::now(),
+                                   state.id,
+                                   state.sourceChanges};
+}
+
+void ViewCatalog::finishMaterializedViewRefresh(const NamespaceString& viewName,
+                                                const MaterializedViewRefresh& refresh) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto it = _materializationStates.find(viewName.ns());
+    if (it == _materializationStates.end() || it->second.id != refresh.stateId) {
+        return;
+    }
+
+    // Changes committed while the refresh ran may be missing from its results.
+    auto& state = it->second;
+    state.refreshedAt = refresh.sourceChanges;
+    state.lastRefresh = refresh.startedAt;
+    if (state.sourceChanges != state.refreshedAt) {
+        state.staleSince = refresh.startedAt;
+    }
+}
+
+BSONObj ViewCatalog::describeMaterialization(OperationContext* opCtx,
+                                             const NamespaceString& viewName) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto view = _lookup_inlock(opCtx, viewName.ns());
+    if (!view || !view->materialization()) {
+        return BSONObj();
+    }
+
+    BSONObjBuilder builder;
+    auto it = _materializationStates.find(viewName.ns());
+    const bool refreshed = it != _materializationStates.end() && it->second.refreshedAt >= 0;
+    if (refreshed) {
+        const auto& state = it->second;
+        const bool upToDate = state.sourceChanges == state.refreshedAt;
+        builder.append("lastRefresh", state.lastRefresh);
+        builder.append("upToDate", upToDate);
+        if (!upToDate) {
+            builder.append("staleSince", state.staleSince);
+        }
+    } else {
+        builder.append("upToDate", false);
+    }
+    builder.append("readsMaterialization", _canReadMaterialization_inlock(opCtx, *view));
+    return builder.obj();
+}
 }  // namespace mongo
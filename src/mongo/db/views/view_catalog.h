@@ -43,8 +43,10 @@
 #include "mongo/db/views/view.h"
 #include "mongo/db/views/view_graph.h"
 #include "mongo/stdx/functional.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/string_map.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 class OperationContext;
@@ -79,13 +81,17 @@ public:
      * database's catalog, so the check for an existing collection with the same name must be done
      * before calling createView.
      *
+     * If 'materialized' is not empty, the view is materialized with the options it describes; see
+     * MaterializedViewOptions.
+     *
      * Must be in WriteUnitOfWork. View creation rolls back if the unit of work aborts.
      */
     Status createView(OperationContext* opCtx,
                       const NamespaceString& viewName,
                       const NamespaceString& viewOn,
                       const BSONArray& pipeline,
-                      const BSONObj& collation);
+                      const BSONObj& collation,
+                      const BSONObj& materialized = BSONObj());
 
     /**
      * Drop the view named 'viewName'.
@@ -114,8 +120,71 @@ public:
      * Resolve the views on 'nss', transforming the pipeline appropriately. This function returns a
      * fully-resolved view definition containing the backing namespace, the resolved pipeline and
      * the collation to use for the operation.
+     *
+     * If 'useMaterializations' is true, resolution stops at the first materialized view whose
+     * contents are fresh enough, and reads that view's 'into' collection instead of expanding it.
+     */
+    StatusWith<ResolvedView> resolveView(OperationContext* opCtx,
+                                         const NamespaceString& nss,
+                                         bool useMaterializations = true);
+
+    /**
+     * What a refresh of a materialized view needs to know: the logical definition of the view, the
+     * collation to run it with, and where to write its results. Also remembers which changes to
+     * the view's sources the refresh may miss.
+     */
+    struct MaterializedViewRefresh {
+        ResolvedView view;
+        BSONObj collation;
+        NamespaceString into;
+
+        Date_t startedAt;
+        long long stateId;
+        long long sourceChanges;
+    };
+
+    /**
+     * Starts refreshing the materialized view 'viewName'. The caller writes the results of running
+     * the returned view into the returned 'into' collection, then calls
+     * finishMaterializedViewRefresh().
+     */
+    StatusWith<MaterializedViewRefresh> beginMaterializedViewRefresh(
+        OperationContext* opCtx, const NamespaceString& viewName);
+
+    /**
+     * Records that 'refresh' has rewritten the contents of its materialized view. The view is then
+     * up to date with respect to all the changes to its sources committed before the refresh
+     * started. Does nothing if the view has been redefined or dropped since.
+     */
+    void finishMaterializedViewRefresh(const NamespaceString& viewName,
+                                       const MaterializedViewRefresh& refresh);
+
+    /**
+     * Returns a description of how fresh the contents of the materialized view 'viewName' are, or
+     * an empty object if 'viewName' is not a materialized view.
+     */
+    BSONObj describeMaterialization(OperationContext* opCtx, const NamespaceString& viewName);
+
+    /**
+     * To be called when a write to 'nss' is about to be committed. Once it is, the contents of the
+     * materialized views which depend on 'nss' become stale.
+     */
+    void onSourceChange(OperationContext* opCtx, const NamespaceString& nss);
+
+    /**
+     * To be called when the collection 'nss' is about to be dropped or renamed. Besides making
+     * the views which depend on it stale, this forgets the refreshes of any view materialized into
+     * it.
      */
-    StatusWith<ResolvedView> resolveView(OperationContext* opCtx, const NamespaceString& nss);
+    void onCollectionDrop(OperationContext* opCtx, const NamespaceString& nss);
+
+    /**
+     * Returns false as long as no materialized view has been defined, so that writes need not look
+     * for views to make stale.
+     */
+    static bool anyMaterializedViews() {
+        return _anyMaterializedViews.load();
+    }
 
     /**
      * Reload the views catalog if marked invalid. No-op if already valid. Does only minimal
@@ -136,11 +205,45 @@ public:
     }
 
 private:
-    Status _createOrUpdateView_inlock(OperationContext* opCtx,
-                                      const NamespaceString& viewName,
-                                      const NamespaceString& viewOn,
-                                      const BSONArray& pipeline,
-                                      std::unique_ptr<CollatorInterface> collator);
+    /**
+     * How up to date the contents of a materialized view are. Every committed change to one of the
+     * view's sources increments 'sourceChanges'.
+     */
+    struct MaterializationState {
+        // Identifies this state, which is recreated whenever the view is (re)defined.
+        long long id = 0;
+        long long sourceChanges = 0;
+
+        // The value of 'sourceChanges' when the last successful refresh started, or -1 if the view
+        // has not been refreshed since it was defined or loaded.
+        long long refreshedAt = -1;
+        Date_t lastRefresh;
+
+        // When the contents became stale, if 'sourceChanges' is past 'refreshedAt'.
+        Date_t staleSince;
+    };
+
+    /**
+     * Returns whether reads of 'view', a materialized view, may use its 'into' collection.
+     */
+    bool _canReadMaterialization_inlock(OperationContext* opCtx, const ViewDefinition& view);
+
+    MaterializationState& _getMaterializationState_inlock(const NamespaceString& viewName);
+
+    /**
+     * Recomputes '_materializedViewsBySource' if the views changed since it was last computed.
+     */
+    void _refreshMaterializationSources_inlock();
+
+    void _onSourceChangeCommitted(const NamespaceString& nss, bool dropped);
+
+    Status _createOrUpdateView_inlock(
+        OperationContext* opCtx,
+        const NamespaceString& viewName,
+        const NamespaceString& viewOn,
+        const BSONArray& pipeline,
+        std::unique_ptr<CollatorInterface> collator,
+        boost::optional<MaterializedViewOptions> materialization);
     /**
      * Parses the view definition pipeline, attempts to upsert into the view graph, and refreshes
      * the graph if necessary. Returns an error status if the resulting graph would be invalid.
@@ -156,6 +259,9 @@ private:
                                      const std::vector<NamespaceString>& refs);
 
     std::shared_ptr<ViewDefinition> _lookup_inlock(OperationContext* opCtx, StringData ns);
+    StatusWith<ResolvedView> _resolveView_inlock(OperationContext* opCtx,
+                                                 const NamespaceString& nss,
+                                                 bool useMaterializations);
     Status _reloadIfNeeded_inlock(OperationContext* opCtx);
 
     void _requireValidCatalog_inlock(OperationContext* opCtx) {
@@ -169,5 +275,16 @@ private:
     AtomicBool _valid;
     ViewGraph _viewGraph;
     bool _viewGraphNeedsRefresh = true;  // Defers initializing the graph until the first insert.
+
+    // Keyed by the name of a materialized view. A view without an entry has not been refreshed.
+    StringMap<MaterializationState> _materializationStates;
+    long long _nextMaterializationStateId = 0;
+
+    // Maps a namespace to the materialized views whose contents depend on it, directly or through
+    // other views.
+    StringMap<std::vector<NamespaceString>> _materializedViewsBySource;
+    bool _materializationSourcesNeedRefresh = true;
+
+    static AtomicBool _anyMaterializedViews;
 };
 }  // namespace mongo
@@ -425,5 +425,149 @@ TEST_F(ViewCatalogFixture, InvalidateThenReload) {
     ASSERT_OK(viewCatalog.reloadIfNeeded(opCtx.get()));
     ASSERT_EQ(2, durableViewCatalog.getIterateCount());
 }
+TEST_F(ViewCatalogFixture, MaterializedViewIsExpandedUntilRefreshed) {
+    const NamespaceString viewName("db.view");
+    const NamespaceString viewOn("db.coll");
+    BSONArrayBuilder pipeline;
+    pipeline << BSON("$match" << BSON("foo" << 1));
+
+    ASSERT_OK(viewCatalog.createView(
+        opCtx.get(), viewName, viewOn, pipeline.arr(), emptyCollation, BSON("into"
+                                                                           << "mv")));
+
+    auto resolvedView = viewCatalog.resolveView(opCtx.get(), viewName);
+    ASSERT_OK(resolvedView.getStatus());
+    ASSERT_EQ(viewOn, resolvedView.getValue().getNamespace());
+    ASSERT_EQ(1U, resolvedView.getValue().getPipeline().size());
+
+    auto refresh = viewCatalog.beginMaterializedViewRefresh(opCtx.get(), viewName);
+    ASSERT_OK(refresh.getStatus());
+    ASSERT_EQ(viewOn, refresh.getValue().view.getNamespace());
+    ASSERT_EQ(NamespaceString("db.mv"), refresh.getValue().into);
+    viewCatalog.finishMaterializedViewRefresh(viewName, refresh.getValue());
+
+    resolvedView = viewCatalog.resolveView(opCtx.get(), viewName);
+    ASSERT_OK(resolvedView.getStatus());
+    ASSERT_EQ(NamespaceString("db.mv"), resolvedView.getValue().getNamespace());
+    ASSERT_EQ(0U, resolvedView.getValue().getPipeline().size());
+
+    // A refresh still recomputes the view.
+    resolvedView = viewCatalog.resolveView(opCtx.get(), viewName, false);
+    ASSERT_OK(resolvedView.getStatus());
+    ASSERT_EQ(viewOn, resolvedView.getValue().getNamespace());
+}
+
+TEST_F(ViewCatalogFixture, CommittedSourceChangesMakeMaterializedViewsStale) {
+    const NamespaceString viewName("db.view");
+    const NamespaceString middleView("db.middle");
+    const NamespaceString viewOn("db.coll");
+    const NamespaceString into("db.mv");
+
+    ASSERT_OK(
+        viewCatalog.createView(opCtx.get(), middleView, viewOn, emptyPipeline, emptyCollation));
+    ASSERT_OK(viewCatalog.createView(
+        opCtx.get(), viewName, middleView, emptyPipeline, emptyCollation, BSON("into"
+                                                                              << "mv")));
+    auto refresh = viewCatalog.beginMaterializedViewRefresh(opCtx.get(), viewName);
+    ASSERT_OK(refresh.getStatus());
+    viewCatalog.finishMaterializedViewRefresh(viewName, refresh.getValue());
+    ASSERT_TRUE(viewCatalog.describeMaterialization(opCtx.get(), viewName)["upToDate"].trueValue());
+
+    // Changes to other collections do not matter.
+    viewCatalog.onSourceChange(opCtx.get(), NamespaceString("db.other"));
+    opCtx->recoveryUnit()->commitUnitOfWork();
+    ASSERT_EQ(into, viewCatalog.resolveView(opCtx.get(), viewName).getValue().getNamespace());
+
+    // Changes only count once committed.
+    viewCatalog.onSourceChange(opCtx.get(), viewOn);
+    ASSERT_EQ(into, viewCatalog.resolveView(opCtx.get(), viewName).getValue().getNamespace());
+    opCtx->recoveryUnit()->commitUnitOfWork();
+    ASSERT_EQ(viewOn, viewCatalog.resolveView(opCtx.get(), viewName).getValue().getNamespace());
+
+    auto description = viewCatalog.describeMaterialization(opCtx.get(), viewName);
+    ASSERT_FALSE(description["upToDate"].trueValue());
+    ASSERT_FALSE(description["readsMaterialization"].trueValue());
+    ASSERT_TRUE(description.hasField("staleSince"));
+}
+
+TEST_F(ViewCatalogFixture, MaterializedViewCanBeReadWithinMaxStaleness) {
+    const NamespaceString viewName("db.view");
+    const NamespaceString viewOn("db.coll");
+    const NamespaceString into("db.mv");
+
+    ASSERT_OK(viewCatalog.createView(opCtx.get(),
+                                     viewName,
+                                     viewOn,
+                                     emptyPipeline,
+                                     emptyCollation,
+                                     BSON("into"
+                                          << "mv"
+                                          << "maxStalenessMS"
+                                          << 60 * 60 * 1000)));
+    auto refresh = viewCatalog.beginMaterializedViewRefresh(opCtx.get(), viewName);
+    ASSERT_OK(refresh.getStatus());
+    viewCatalog.finishMaterializedViewRefresh(viewName, refresh.getValue());
+
+    viewCatalog.onSourceChange(opCtx.get(), viewOn);
+    opCtx->recoveryUnit()->commitUnitOfWork();
+    ASSERT_EQ(into, viewCatalog.resolveView(opCtx.get(), viewName).getValue().getNamespace());
+    auto description = viewCatalog.describeMaterialization(opCtx.get(), viewName);
+    ASSERT_FALSE(description["upToDate"].trueValue());
+    ASSERT_TRUE(description["readsMaterialization"].trueValue());
+
+    // Dropping the collection the view is materialized into forgets the refresh.
+    viewCatalog.onCollectionDrop(opCtx.get(), into);
+    opCtx->recoveryUnit()->commitUnitOfWork();
+    ASSERT_EQ(viewOn, viewCatalog.resolveView(opCtx.get(), viewName).getValue().getNamespace());
+}
+
+TEST_F(ViewCatalogFixture, ChangesDuringARefreshLeaveTheViewStale) {
+    const NamespaceString viewName("db.view");
+    const NamespaceString viewOn("db.coll");
+
+    ASSERT_OK(viewCatalog.createView(
+        opCtx.get(), viewName, viewOn, emptyPipeline, emptyCollation, BSON("into"
+                                                                          << "mv")));
+    auto refresh = viewCatalog.beginMaterializedViewRefresh(opCtx.get(), viewName);
+    ASSERT_OK(refresh.getStatus());
+    viewCatalog.onSourceChange(opCtx.get(), viewOn);
+    opCtx->recoveryUnit()->commitUnitOfWork();
+    viewCatalog.finishMaterializedViewRefresh(viewName, refresh.getValue());
+
+    ASSERT_EQ(viewOn, viewCatalog.resolveView(opCtx.get(), viewName).getValue().getNamespace());
+}
+
+TEST_F(ViewCatalogFixture, InvalidMaterializedViewOptions) {
+    const NamespaceString viewName("db.view");
+    const NamespaceString viewOn("db.coll");
+
+    ASSERT_NOT_OK(viewCatalog.createView(
+        opCtx.get(), viewName, viewOn, emptyPipeline, emptyCollation, BSON("maxStalenessMS" << 1)));
+    ASSERT_NOT_OK(viewCatalog.createView(
+        opCtx.get(), viewName, viewOn, emptyPipeline, emptyCollation, BSON("into"
+                                                                          << "coll")));
+    ASSERT_NOT_OK(viewCatalog.createView(opCtx.get(),
+                                         viewName,
+                                         viewOn,
+                                         emptyPipeline,
+                                         emptyCollation,
+                                         BSON("into"
+                                              << "mv"
+                                              << "maxStalenessMS"
+                                              << -1)));
+    ASSERT_NOT_OK(viewCatalog.createView(opCtx.get(),
+                                         viewName,
+                                         viewOn,
+                                         emptyPipeline,
+                                         emptyCollation,
+                                         BSON("into"
+                                              << "mv"
+                                              << "unknown"
+                                              << 1)));
+
+    ASSERT_OK(viewCatalog.createView(opCtx.get(), viewName, viewOn, emptyPipeline, emptyCollation));
+    ASSERT_EQ(ErrorCodes::InvalidOptions,
+              viewCatalog.beginMaterializedViewRefresh(opCtx.get(), viewName).getStatus());
+}
 }  // namespace
 }  // namespace mongo
@@ -37,6 +37,7 @@
 #include "mongo/db/client.h"
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/operation_phases.h"
 #include "mongo/db/repl/optime.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/server_options.h"
@@ -166,6 +167,7 @@ Status waitForWriteConcern(OperationContext* opCtx,
                            WriteConcernResult* result) {
     LOG(2) << "Waiting for write concern. OpTime: " << replOpTime
            << ", write concern: " << writeConcern.toBSON();
+    OperationPhases::Scope writeConcernPhase(opCtx, OperationPhases::Phase::kWriteConcern);
     auto replCoord = repl::ReplicationCoordinator::get(opCtx);
 
     MONGO_FAIL_POINT_PAUSE_WHILE_SET(hangBeforeWaitingForWriteConcern);
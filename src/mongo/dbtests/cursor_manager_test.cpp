@@ -35,6 +35,7 @@
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/query/find_common.h"
 #include "mongo/db/query/plan_executor.h"
 #include "mongo/db/query/query_test_service_context.h"
 #include "mongo/dbtests/dbtests.h"
@@ -397,5 +398,35 @@ TEST_F(CursorManagerTest, CursorShouldNotTimeOutUntilIdleForLongEnoughAfterBeing
     ASSERT_EQ(1UL, cursorManager->timeoutCursors(_opCtx.get(), clock->now()));
     ASSERT_EQ(0UL, cursorManager->numCursors());
 }
+
+/**
+ * Test that getMore batches are only shrunk for clients which consume them slower than targeted.
+ */
+TEST_F(CursorManagerTest, BatchByteBudgetFollowsClientConsumptionRate) {
+    CursorManager* cursorManager = useCursorManager();
+    auto clock = useClock();
+
+    auto cursorPin = cursorManager->registerCursor(
+        _opCtx.get(), {makeFakePlanExecutor(), kTestNss, {}, false, BSONObj()});
+    auto cursor = cursorPin.getCursor();
+    const int maxBytes = FindCommon::kMaxBytesToReturnToClientAtOnce;
+
+    // Nothing has been returned yet.
+    ASSERT_EQ(maxBytes, cursor->getBatchByteBudget(clock->now()));
+
+    // A client which comes back within the target gets full batches.
+    cursor->recordBatchReturned(8 * 1024 * 1024, clock->now());
+    clock->advance(Milliseconds(500));
+    ASSERT_EQ(maxBytes, cursor->getBatchByteBudget(clock->now()));
+
+    // A client which took four times the target gets a quarter of the last batch.
+    clock->advance(Milliseconds(3500));
+    ASSERT_EQ(2 * 1024 * 1024, cursor->getBatchByteBudget(clock->now()));
+
+    // The budget does not go below the minimum.
+    clock->advance(Seconds(60));
+    ASSERT_EQ(1024 * 1024, cursor->getBatchByteBudget(clock->now()));
+}
+
 }  // namespace
 }  // namespace mongo
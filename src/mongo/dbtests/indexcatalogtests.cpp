@@ -173,12 +173,66 @@ private:
     Database* _db;
 };
 
+/**
+ * Test that the index-dependent state of the CollectionInfoCache is built on use and can be
+ * evicted once idle.
+ */
+class InfoCacheIndexDataEviction {
+public:
+    InfoCacheIndexDataEviction() {
+        const ServiceContext::UniqueOperationContext opCtxPtr = cc().makeOperationContext();
+        OperationContext& opCtx = *opCtxPtr;
+        Lock::DBLock lk(&opCtx, nsToDatabaseSubstring(_ns), MODE_X);
+        OldClientContext ctx(&opCtx, _ns);
+        WriteUnitOfWork wuow(&opCtx);
+
+        _db = ctx.db();
+        _coll = _db->createCollection(&opCtx, _ns);
+        wuow.commit();
+    }
+
+    ~InfoCacheIndexDataEviction() {
+        const ServiceContext::UniqueOperationContext opCtxPtr = cc().makeOperationContext();
+        OperationContext& opCtx = *opCtxPtr;
+        Lock::DBLock lk(&opCtx, nsToDatabaseSubstring(_ns), MODE_X);
+        OldClientContext ctx(&opCtx, _ns);
+        WriteUnitOfWork wuow(&opCtx);
+
+        _db->dropCollection(&opCtx, _ns);
+        wuow.commit();
+    }
+
+    void run() {
+        const ServiceContext::UniqueOperationContext opCtxPtr = cc().makeOperationContext();
+        OperationContext& opCtx = *opCtxPtr;
+        OldClientWriteContext ctx(&opCtx, _ns);
+        CollectionInfoCache* infoCache = _coll->infoCache();
+
+        dbtests::createIndex(&opCtx, _ns, BSON("x" << 1));
+
+        const Date_t future = Date_t::now() + Hours(1);
+        ASSERT_TRUE(infoCache->getIndexKeys(&opCtx).mightBeIndexed("x"));
+        ASSERT_FALSE(infoCache->evictIndexDataIfIdle(&opCtx, Date_t::now() - Hours(1)));
+        ASSERT_TRUE(infoCache->evictIndexDataIfIdle(&opCtx, future));
+        ASSERT_FALSE(infoCache->evictIndexDataIfIdle(&opCtx, future));
+
+        // The evicted state is rebuilt on next use.
+        ASSERT_TRUE(infoCache->getIndexKeys(&opCtx).mightBeIndexed("x"));
+        ASSERT_FALSE(infoCache->getIndexKeys(&opCtx).mightBeIndexed("y"));
+    }
+
+private:
+    Collection* _coll;
+    Database* _db;
+};
+
 class IndexCatalogTests : public Suite {
 public:
     IndexCatalogTests() : Suite("indexcatalogtests") {}
     void setupTests() {
         add<IndexIteratorTests>();
         add<RefreshEntry>();
+        add<InfoCacheIndexDataEviction>();
     }
 };
 
@@ -145,6 +145,7 @@ public:
 
         ASSERT_OK(indexer.init(spec).getStatus());
         ASSERT_OK(indexer.insertAllDocumentsInCollection());
+        ASSERT_OK(indexer.drainBackgroundWrites());
 
         WriteUnitOfWork wunit(&_opCtx);
         indexer.commit();
@@ -198,7 +199,13 @@ public:
                                   << background);
 
         ASSERT_OK(indexer.init(spec).getStatus());
-        const Status status = indexer.insertAllDocumentsInCollection();
+
+        // Background builds which bulk load the index only check the unique constraint once the
+        // concurrent writes are applied.
+        Status status = indexer.insertAllDocumentsInCollection();
+        if (status.isOK()) {
+            status = indexer.drainBackgroundWrites();
+        }
         ASSERT_EQUALS(status.code(), ErrorCodes::DuplicateKey);
     }
 };
@@ -254,6 +261,7 @@ public:
 
         std::set<RecordId> dups;
         ASSERT_OK(indexer.insertAllDocumentsInCollection(&dups));
+        ASSERT_OK(indexer.drainBackgroundWrites(&dups));
 
         // either loc1 or loc2 should be in dups but not both.
         ASSERT_EQUALS(dups.size(), 1U);
@@ -266,6 +274,139 @@ public:
     }
 };
 
+/**
+ * Duplicates are found when the keys of a foreground build of a large enough collection are
+ * generated by several threads, even when duplicate keys end up in different threads' sorters.
+ */
+class InsertBuildFillDupsParallelKeyGeneration : public IndexBuildBase {
+public:
+    void run() {
+        const int kNumDocs = 20000;
+
+        // Create a new collection, in which every value of 'a' is present twice.
+        Database* db = _ctx.db();
+        Collection* coll;
+        {
+            WriteUnitOfWork wunit(&_opCtx);
+            db->dropCollection(&_opCtx, _ns);
+            coll = db->createCollection(&_opCtx, _ns);
+
+            OpDebug* const nullOpDebug = nullptr;
+            for (int i = 0; i < kNumDocs; i++) {
+                ASSERT_OK(coll->insertDocument(
+                    &_opCtx, BSON("_id" << i << "a" << i / 2), nullOpDebug, true));
+            }
+            wunit.commit();
+        }
+
+        MultiIndexBlock indexer(&_opCtx, coll);
+        indexer.allowInterruption();
+
+        const BSONObj spec = BSON("name"
+                                  << "a"
+                                  << "ns"
+                                  << coll->ns().ns()
+                                  << "key"
+                                  << BSON("a" << 1)
+                                  << "v"
+                                  << static_cast<int>(kIndexVersion)
+                                  << "unique"
+                                  << true);
+
+        ASSERT_OK(indexer.init(spec).getStatus());
+
+        std::set<RecordId> dups;
+        ASSERT_OK(indexer.insertAllDocumentsInCollection(&dups));
+
+        // Exactly one document of each pair should be in dups.
+        ASSERT_EQUALS(dups.size(), static_cast<size_t>(kNumDocs / 2));
+
+        std::set<int> dupValues;
+        for (auto recordId : dups) {
+            BSONObj obj = coll->docFor(&_opCtx, recordId).value();
+            ASSERT(dupValues.insert(obj["a"].Int()).second);
+        }
+    }
+};
+
+/**
+ * The writes made to the collection while a background build bulk loads the index are applied to
+ * it once the collection scan is done, unless they are rolled back.
+ */
+class InsertBuildBackgroundSideWrites : public IndexBuildBase {
+public:
+    void run() {
+        // Create a new collection.
+        Database* db = _ctx.db();
+        Collection* coll;
+        {
+            WriteUnitOfWork wunit(&_opCtx);
+            db->dropCollection(&_opCtx, _ns);
+            coll = db->createCollection(&_opCtx, _ns);
+
+            OpDebug* const nullOpDebug = nullptr;
+            for (int i = 0; i < 10; i++) {
+                ASSERT_OK(
+                    coll->insertDocument(&_opCtx, BSON("_id" << i << "a" << i), nullOpDebug, true));
+            }
+            wunit.commit();
+        }
+
+        MultiIndexBlock indexer(&_opCtx, coll);
+        indexer.allowBackgroundBuilding();
+        indexer.allowInterruption();
+
+        const BSONObj spec = BSON("name"
+                                  << "a"
+                                  << "ns"
+                                  << coll->ns().ns()
+                                  << "key"
+                                  << BSON("a" << 1)
+                                  << "v"
+                                  << static_cast<int>(kIndexVersion)
+                                  << "unique"
+                                  << true
+                                  << "background"
+                                  << true);
+
+        ASSERT_OK(indexer.init(spec).getStatus());
+
+        // Write to the collection while the index is being built. The document inserted last
+        // reuses the value of the deleted one.
+        _client.insert(_ns, BSON("_id" << 10 << "a" << 10));
+        _client.update(_ns, BSON("_id" << 1), BSON("$set" << BSON("a" << 11)));
+        _client.remove(_ns, BSON("_id" << 2));
+        _client.insert(_ns, BSON("_id" << 12 << "a" << 2));
+        {
+            WriteUnitOfWork wunit(&_opCtx);
+            OpDebug* const nullOpDebug = nullptr;
+            ASSERT_OK(coll->insertDocument(
+                &_opCtx, BSON("_id" << 13 << "a" << 13), nullOpDebug, true));
+            // Not committed.
+        }
+
+        ASSERT_OK(indexer.insertAllDocumentsInCollection());
+        ASSERT_OK(indexer.drainBackgroundWrites());
+        {
+            WriteUnitOfWork wunit(&_opCtx);
+            indexer.commit();
+            wunit.commit();
+        }
+
+        IndexDescriptor* desc = coll->getIndexCatalog()->findIndexByName(&_opCtx, "a");
+        ASSERT(desc);
+        auto cursor = coll->getIndexCatalog()->getIndex(desc)->newCursor(&_opCtx, true);
+
+        std::vector<int> values;
+        for (auto entry = cursor->seek(BSON("" << MINKEY), true); entry; entry = cursor->next()) {
+            values.push_back(entry->key.firstElement().numberInt());
+        }
+        ASSERT_EQUALS(values.size(), 11U);
+        const std::vector<int> expected{0, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+        ASSERT(values == expected);
+    }
+};
+
 /** Index creation is killed if mayInterrupt is true. */
 class InsertBuildIndexInterrupt : public IndexBuildBase {
 public:
@@ -805,6 +946,8 @@ public:
         add<InsertBuildEnforceUnique<false>>();
         add<InsertBuildFillDups<true>>();
         add<InsertBuildFillDups<false>>();
+        add<InsertBuildFillDupsParallelKeyGeneration>();
+        add<InsertBuildBackgroundSideWrites>();
         add<InsertBuildIndexInterrupt>();
         add<InsertBuildIndexInterruptDisallowed>();
         add<InsertBuildIdIndexInterrupt>();
@@ -980,6 +980,20 @@ class AllowedControlCharacter : public Base {
     }
 };
 
+class EscapesWithinLongStrings : public Base {
+    virtual BSONObj bson() const {
+        BSONObjBuilder b;
+        b.append("a", string(100, 'x') + "\n" + string(100, 'y') + "\xc3\xa9z");
+        b.append("b", "");
+        b.append("c", "plain");
+        return b.obj();
+    }
+    virtual string json() const {
+        return "{ \"a\" : \"" + string(100, 'x') + "\\n" + string(100, 'y') +
+            "\\u00e9z\", \"b\" : \"\", \"c\" : \"plain\" }";
+    }
+};
+
 class InvalidControlCharacter : public Bad {
     virtual string json() const {
         return "{ \"a\" : \"\x1f\" }";
@@ -2769,6 +2783,7 @@ public:
         add<FromJsonTests::EscapedCharacters>();
         add<FromJsonTests::NonEscapedCharacters>();
         add<FromJsonTests::AllowedControlCharacter>();
+        add<FromJsonTests::EscapesWithinLongStrings>();
         add<FromJsonTests::InvalidControlCharacter>();
         add<FromJsonTests::NumbersInFieldName>();
         add<FromJsonTests::EscapeFieldName>();
@@ -152,6 +152,55 @@ public:
                     .isOK());
     }
 };
+
+class FixBatch : public Base {
+public:
+    void run() {
+        BSONObjBuilder timestampBuilder;
+        timestampBuilder.append("_id", 1);
+        timestampBuilder.appendTimestamp("a");
+
+        const std::vector<BSONObj> docs = {BSON("x" << 1),
+                                           BSON("_id" << 2 << "x" << 2),
+                                           BSON("x" << 3 << "_id" << 3),
+                                           BSON("$x" << 4),
+                                           timestampBuilder.obj(),
+                                           BSON("x" << 5)};
+        auto fixed = fixDocumentsForInsert(_opCtx.getServiceContext(), docs);
+        ASSERT_EQUALS(docs.size(), fixed.size());
+
+        // Each result matches what fixDocumentForInsert() makes of the same document, apart from
+        // the generated _ids.
+        ASSERT(fixed[0].isOK());
+        ASSERT_EQUALS(jstOID, fixed[0].getValue().firstElement().type());
+        ASSERT_BSONOBJ_EQ(BSON("x" << 1), fixed[0].getValue().removeField("_id"));
+
+        ASSERT(fixed[1].isOK());
+        ASSERT(fixed[1].getValue().isEmpty());
+
+        ASSERT(fixed[2].isOK());
+        ASSERT_BSONOBJ_EQ(BSON("_id" << 3 << "x" << 3), fixed[2].getValue());
+
+        ASSERT(!fixed[3].isOK());
+
+        ASSERT(fixed[4].isOK());
+        ASSERT_EQUALS(1, fixed[4].getValue().firstElement().number());
+        ASSERT(fixed[4].getValue()["a"].timestampValue() > 0);
+
+        ASSERT(fixed[5].isOK());
+        ASSERT_EQUALS(jstOID, fixed[5].getValue().firstElement().type());
+        ASSERT_NOT_EQUALS(fixed[0].getValue().firstElement().OID(),
+                          fixed[5].getValue().firstElement().OID());
+
+        // The rebuilt documents own their data.
+        for (auto&& result : fixed) {
+            if (result.isOK() && !result.getValue().isEmpty()) {
+                ASSERT(result.getValue().isOwned());
+                ASSERT(result.getValue().valid(BSONVersion::kLatest));
+            }
+        }
+    }
+};
 }  // namespace Insert
 
 class All : public Suite {
@@ -163,6 +212,7 @@ public:
         add<Insert::UpdateDate>();
         add<Insert::UpdateDate2>();
         add<Insert::ValidId>();
+        add<Insert::FixBatch>();
     }
 };
 
@@ -46,6 +46,7 @@
 #include <iostream>
 #include <mutex>
 
+#include "mongo/bson/bson_validate.h"
 #include "mongo/config.h"
 #include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/client.h"
@@ -55,10 +56,20 @@
 #include "mongo/db/storage/mmap_v1/dur_stats.h"
 #include "mongo/db/storage/mmap_v1/mmap.h"
 #include "mongo/db/storage/storage_options.h"
+#if defined(MONGO_CONFIG_WIREDTIGER_ENABLED) && defined(MONGO_CONFIG_ZSTD)
+#include "mongo/db/storage/wiredtiger/wiredtiger_zstd_compressor.h"
+#endif
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/dbtests/framework_options.h"
+#include "mongo/s/catalog/type_chunk.h"
+#include "mongo/s/chunk_manager.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/thread.h"
+#include "mongo/transport/message_compressor_snappy.h"
+#include "mongo/transport/message_compressor_zlib.h"
+#ifdef MONGO_CONFIG_ZSTD
+#include "mongo/transport/message_compressor_zstd.h"
+#endif
 #include "mongo/util/log.h"
 #include "mongo/util/timer.h"
 #include "mongo/util/version.h"
@@ -450,6 +461,305 @@ public:
     }
 };
 
+/**
+ * Routing table for a collection sharded on {x: 1} with 'numChunks' chunks of ten keys each,
+ * spread over ten shards.
+ */
+std::shared_ptr<ChunkManager> makeRoutingTable(int numChunks) {
+    const NamespaceString nss("perftest.routing");
+    const KeyPattern keyPattern(BSON("x" << 1));
+
+    ChunkVersion version(1, 0, OID::gen());
+    std::vector<ChunkType> chunks;
+    for (int i = 0; i < numChunks; ++i) {
+        const BSONObj min = (i == 0) ? keyPattern.globalMin() : BSON("x" << i * 10);
+        const BSONObj max =
+            (i == numChunks - 1) ? keyPattern.globalMax() : BSON("x" << (i + 1) * 10);
+        chunks.emplace_back(nss, ChunkRange(min, max), version, ShardId(str::stream() << (i % 10)));
+        version.incMinor();
+    }
+
+    return ChunkManager::makeNew(nss, keyPattern, nullptr, false, version.epoch(), chunks);
+}
+
+template <int NumChunks>
+class ChunkTargeting : public B {
+public:
+    virtual string name() {
+        return str::stream() << "chunkTargeting" << NumChunks;
+    }
+    virtual int howLongMillis() {
+        return 1000;
+    }
+    virtual bool showDurStats() {
+        return false;
+    }
+    void prep() {
+        _cm = makeRoutingTable(NumChunks);
+    }
+    void timed() {
+        // Stride through the key space so that consecutive lookups hit different chunks.
+        _key = (_key + 7919) % (NumChunks * 10);
+        _cm->findIntersectingChunkWithSimpleCollation(BSON("x" << _key));
+    }
+
+private:
+    std::shared_ptr<ChunkManager> _cm;
+    int _key = 0;
+};
+
+template <int NumChunks>
+class ChunkIncrementalRefresh : public B {
+public:
+    virtual string name() {
+        return str::stream() << "chunkIncrementalRefresh" << NumChunks;
+    }
+    virtual int howLongMillis() {
+        return 1000;
+    }
+    virtual bool showDurStats() {
+        return false;
+    }
+    virtual unsigned batchSize() {
+        return 1;
+    }
+    void prep() {
+        _cm = makeRoutingTable(NumChunks);
+    }
+    void timed() {
+        // Move the middle chunk to the next shard, as a migration would.
+        auto chunk = _cm->findIntersectingChunkWithSimpleCollation(BSON("x" << NumChunks * 5));
+        ChunkVersion version = _cm->getVersion();
+        version.incMajor();
+        ChunkType moved(NamespaceString(_cm->getns()),
+                        ChunkRange(chunk->getMin(), chunk->getMax()),
+                        version,
+                        ShardId(str::stream() << (++_moves % 10)));
+        _cm = _cm->makeUpdated({moved});
+    }
+
+private:
+    std::shared_ptr<ChunkManager> _cm;
+    int _moves = 0;
+};
+
+enum class DocShape { kSmallFlat, kWide, kNested, kLongStrings, kNumberArray };
+
+/**
+ * Validates a document of a representative shape, as is done for every incoming insert.
+ */
+template <DocShape Shape>
+class ValidateBSON : public B {
+public:
+    virtual string name() {
+        switch (Shape) {
+            case DocShape::kSmallFlat:
+                return "validateBSONSmallFlat";
+            case DocShape::kWide:
+                return "validateBSONWide";
+            case DocShape::kNested:
+                return "validateBSONNested";
+            case DocShape::kLongStrings:
+                return "validateBSONLongStrings";
+            case DocShape::kNumberArray:
+                return "validateBSONNumberArray";
+        }
+        MONGO_UNREACHABLE;
+    }
+    virtual int howLongMillis() {
+        return 1000;
+    }
+    virtual bool showDurStats() {
+        return false;
+    }
+    void prep() {
+        BSONObjBuilder b;
+        b.append("_id", OID::gen());
+        switch (Shape) {
+            case DocShape::kSmallFlat:
+                b.append("name", "widget");
+                b.append("qty", 10);
+                b.append("price", 9.99);
+                b.appendDate("created", Date_t::now());
+                break;
+            case DocShape::kWide:
+                for (int i = 0; i < 200; ++i) {
+                    b.append(str::stream() << "field" << i, i);
+                }
+                break;
+            case DocShape::kNested: {
+                BSONObj sub = BSON("x" << 1 << "y" << "a");
+                for (int depth = 0; depth < 20; ++depth) {
+                    sub = BSON("level" << depth << "sub" << sub << "tags"
+                                       << BSON_ARRAY("a"
+                                                     << "b"));
+                }
+                b.append("doc", sub);
+                break;
+            }
+            case DocShape::kLongStrings:
+                for (int i = 0; i < 10; ++i) {
+                    b.append(str::stream() << "text" << i, string(1000, 'a' + i));
+                }
+                break;
+            case DocShape::kNumberArray: {
+                BSONArrayBuilder arr(b.subarrayStart("values"));
+                for (int i = 0; i < 1000; ++i) {
+                    arr.append(i * 1.5);
+                }
+                arr.done();
+                break;
+            }
+        }
+        _doc = b.obj();
+    }
+    void timed() {
+        invariantOK(validateBSON(_doc.objdata(), _doc.objsize(), BSONVersion::kLatest));
+    }
+
+private:
+    BSONObj _doc;
+};
+
+
+/**
+ * Compresses and decompresses a batch of documents shaped like a typical insert or getMore reply,
+ * so the network message compressors can be compared on both speed and ratio.
+ */
+template <typename Compressor>
+class CompressMessage : public B {
+public:
+    virtual string name() {
+        return str::stream() << "compressMessage-" << _compressor.getName();
+    }
+    virtual int howLongMillis() {
+        return 1000;
+    }
+    virtual bool showDurStats() {
+        return false;
+    }
+    void prep() {
+        BSONArrayBuilder batch;
+        for (int i = 0; i < 100; ++i) {
+            std::string customer = str::stream() << "cust" << i % 7;
+            batch.append(BSON("_id" << OID::gen() << "customer" << customer << "status"
+                                    << (i % 3 ? "shipped" : "pending")
+                                    << "qty"
+                                    << i
+                                    << "price"
+                                    << i * 1.25
+                                    << "created"
+                                    << Date_t::now()
+                                    << "note"
+                                    << "a moderately long description of the order contents"));
+        }
+        _input = BSON("cursor" << BSON("id" << 0LL << "ns"
+                                            << "test.orders"
+                                            << "firstBatch"
+                                            << batch.arr())
+                               << "ok"
+                               << 1);
+        _compressed.resize(_compressor.getMaxCompressedSize(_input.objsize()));
+        _decompressed.resize(_input.objsize());
+    }
+    void timed() {
+        auto compressed = _compressor.compressData(
+            ConstDataRange(_input.objdata(), _input.objsize()),
+            DataRange(_compressed.data(), _compressed.size()));
+        invariantOK(compressed.getStatus());
+        _compressedSize = compressed.getValue();
+        invariantOK(_compressor
+                        .decompressData(ConstDataRange(_compressed.data(), _compressedSize),
+                                        DataRange(_decompressed.data(), _decompressed.size()))
+                        .getStatus());
+    }
+    void post() {
+        cout << name() << " compressed " << _input.objsize() << " bytes to " << _compressedSize
+             << endl;
+    }
+
+private:
+    Compressor _compressor;
+    BSONObj _input;
+    std::vector<char> _compressed;
+    std::vector<char> _decompressed;
+    size_t _compressedSize = 0;
+};
+
+#if defined(MONGO_CONFIG_WIREDTIGER_ENABLED) && defined(MONGO_CONFIG_ZSTD)
+template <int compressionLevel>
+class WiredTigerZstdAtLevel : public WiredTigerZstdCompressor {
+public:
+    WiredTigerZstdAtLevel() : WiredTigerZstdCompressor(compressionLevel) {}
+};
+#endif
+
+/**
+ * Compresses and decompresses a page worth of JSON-like collection documents, so the network
+ * message compressors and the WiredTiger zstd block compressor levels can be compared at the
+ * size WiredTiger compresses.
+ */
+template <typename Compressor>
+class CompressBlock : public B {
+public:
+    virtual string name() {
+        return str::stream() << "compressBlock-" << _compressor.getName();
+    }
+    virtual int howLongMillis() {
+        return 1000;
+    }
+    virtual bool showDurStats() {
+        return false;
+    }
+    void prep() {
+        // The default WiredTiger leaf page size.
+        const size_t kPageSize = 32 * 1024;
+        for (int i = 0; _input.size() < kPageSize; ++i) {
+            std::string customer = str::stream() << "cust" << i % 7;
+            BSONObj doc = BSON("_id" << OID::gen() << "customer" << customer << "status"
+                                     << (i % 3 ? "shipped" : "pending")
+                                     << "items"
+                                     << BSON_ARRAY(BSON("sku" << i % 50 << "qty" << i % 4)
+                                                   << BSON("sku" << i % 30 << "qty" << 1))
+                                     << "total"
+                                     << i * 1.25
+                                     << "created"
+                                     << Date_t::now()
+                                     << "address"
+                                     << BSON("street" << "100 Main Street"
+                                                      << "city"
+                                                      << "Springfield"
+                                                      << "zip"
+                                                      << 10000 + i % 97));
+            _input.append(doc.objdata(), doc.objsize());
+        }
+        _compressed.resize(_compressor.getMaxCompressedSize(_input.size()));
+        _decompressed.resize(_input.size());
+    }
+    void timed() {
+        auto compressed =
+            _compressor.compressData(ConstDataRange(_input.data(), _input.size()),
+                                     DataRange(_compressed.data(), _compressed.size()));
+        invariantOK(compressed.getStatus());
+        _compressedSize = compressed.getValue();
+        invariantOK(_compressor
+                        .decompressData(ConstDataRange(_compressed.data(), _compressedSize),
+                                        DataRange(_decompressed.data(), _decompressed.size()))
+                        .getStatus());
+    }
+    void post() {
+        cout << name() << " compressed " << _input.size() << " bytes to " << _compressedSize
+             << endl;
+    }
+
+private:
+    Compressor _compressor;
+    std::string _input;
+    std::vector<char> _compressed;
+    std::vector<char> _decompressed;
+    size_t _compressedSize = 0;
+};
+
 
 class All : public Suite {
 public:
@@ -463,6 +773,30 @@ public:
         add<boosttimed_mutexspeed>();
         add<stdmutexspeed>();
         add<stdtimed_mutexspeed>();
+        add<ChunkTargeting<1000>>();
+        add<ChunkTargeting<100000>>();
+        add<ChunkTargeting<500000>>();
+        add<ChunkIncrementalRefresh<1000>>();
+        add<ChunkIncrementalRefresh<100000>>();
+        add<ChunkIncrementalRefresh<500000>>();
+        add<ValidateBSON<DocShape::kSmallFlat>>();
+        add<ValidateBSON<DocShape::kWide>>();
+        add<ValidateBSON<DocShape::kNested>>();
+        add<ValidateBSON<DocShape::kLongStrings>>();
+        add<ValidateBSON<DocShape::kNumberArray>>();
+        add<CompressMessage<SnappyMessageCompressor>>();
+        add<CompressMessage<ZlibMessageCompressor>>();
+#ifdef MONGO_CONFIG_ZSTD
+        add<CompressMessage<ZstdMessageCompressor>>();
+#endif
+        add<CompressBlock<SnappyMessageCompressor>>();
+        add<CompressBlock<ZlibMessageCompressor>>();
+#if defined(MONGO_CONFIG_WIREDTIGER_ENABLED) && defined(MONGO_CONFIG_ZSTD)
+        add<CompressBlock<WiredTigerZstdAtLevel<1>>>();
+        add<CompressBlock<WiredTigerZstdAtLevel<3>>>();
+        add<CompressBlock<WiredTigerZstdAtLevel<9>>>();
+        add<CompressBlock<WiredTigerZstdAtLevel<19>>>();
+#endif
     }
 } myall;
 }  // namespace PerfTests
@@ -0,0 +1,228 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/client.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/json.h"
+#include "mongo/db/query/parameterized_equality_plan.h"
+#include "mongo/dbtests/dbtests.h"
+
+namespace QueryParameterizedEqualityPlan {
+
+using std::unique_ptr;
+
+static const NamespaceString nss("unittests.QueryParameterizedEqualityPlan");
+
+class Base {
+public:
+    Base() : _client(&_opCtx) {
+        _client.dropCollection(nss.ns());
+    }
+
+    virtual ~Base() {
+        _client.dropCollection(nss.ns());
+    }
+
+protected:
+    void addIndex(const BSONObj& keyPattern) {
+        ASSERT_OK(dbtests::createIndex(&_opCtx, nss.ns(), keyPattern));
+    }
+
+    void insert(const BSONObj& obj) {
+        _client.insert(nss.ns(), obj);
+    }
+
+    unique_ptr<ParameterizedEqualityPlan> makePlan(Collection* collection,
+                                                   const BSONObj& filter = BSONObj()) {
+        const BSONObj sample = BSON("" << 0);
+        return ParameterizedEqualityPlan::make(
+            &_opCtx, collection, "a", sample.firstElement(), filter, BSONObj());
+    }
+
+    /**
+     * Returns the _ids of the documents returned by 'plan' bound to 'values', in order.
+     */
+    std::vector<int> run(ParameterizedEqualityPlan* plan,
+                         Collection* collection,
+                         const BSONObj& values) {
+        auto exec = plan->bind(&_opCtx, collection, values, PlanExecutor::YIELD_MANUAL);
+        ASSERT(exec);
+
+        std::vector<int> ids;
+        BSONObj obj;
+        PlanExecutor::ExecState state;
+        while (PlanExecutor::ADVANCED == (state = exec->getNext(&obj, nullptr))) {
+            ids.push_back(obj["_id"].numberInt());
+        }
+        ASSERT_EQUALS(PlanExecutor::IS_EOF, state);
+        return ids;
+    }
+
+    const ServiceContext::UniqueOperationContext _opCtxPtr = cc().makeOperationContext();
+    OperationContext& _opCtx = *_opCtxPtr;
+
+private:
+    DBDirectClient _client;
+};
+
+/**
+ * A plan bound to different values returns the documents holding those values and matching the
+ * rest of the query.
+ */
+class RebindsValues : public Base {
+public:
+    void run() {
+        OldClientWriteContext ctx(&_opCtx, nss.ns());
+        for (int i = 0; i < 10; ++i) {
+            insert(BSON("_id" << i << "a" << i % 5 << "b" << i));
+        }
+        addIndex(BSON("a" << 1));
+        Collection* collection = ctx.getCollection();
+
+        auto plan = makePlan(collection, fromjson("{b: {$lt: 8}}"));
+        ASSERT(plan);
+        ASSERT(plan->isValid(&_opCtx, collection));
+
+        ASSERT(std::vector<int>({1, 6}) == Base::run(plan.get(), collection, BSON_ARRAY(1)));
+        ASSERT(std::vector<int>({1, 6, 3}) ==
+               Base::run(plan.get(), collection, BSON_ARRAY(3 << 1 << 1)));
+        ASSERT(std::vector<int>({4}) == Base::run(plan.get(), collection, BSON_ARRAY(4 << 7)));
+        ASSERT(std::vector<int>({2, 7}) ==
+               Base::run(plan.get(), collection, BSON_ARRAY(2LL << 2.0)));
+    }
+};
+
+/**
+ * Points are scanned in the direction of the index.
+ */
+class RebindsValuesIntoDescendingIndex : public Base {
+public:
+    void run() {
+        OldClientWriteContext ctx(&_opCtx, nss.ns());
+        for (int i = 0; i < 10; ++i) {
+            insert(BSON("_id" << i << "a" << i % 5));
+        }
+        addIndex(BSON("a" << -1));
+        Collection* collection = ctx.getCollection();
+
+        auto plan = makePlan(collection);
+        ASSERT(plan);
+        ASSERT(std::vector<int>({3, 8, 1, 6}) ==
+               Base::run(plan.get(), collection, BSON_ARRAY(1 << 3)));
+    }
+};
+
+/**
+ * Values which index bounds can't answer by equality alone aren't bound.
+ */
+class RefusesValuesNotMatchedByEquality : public Base {
+public:
+    void run() {
+        OldClientWriteContext ctx(&_opCtx, nss.ns());
+        insert(BSON("_id" << 0 << "a" << 0));
+        addIndex(BSON("a" << 1));
+        Collection* collection = ctx.getCollection();
+
+        auto plan = makePlan(collection);
+        ASSERT(plan);
+        auto bind = [&](const BSONObj& values) {
+            return plan->bind(&_opCtx, collection, values, PlanExecutor::YIELD_MANUAL);
+        };
+        ASSERT_FALSE(bind(BSON_ARRAY(1 << BSONNULL)));
+        ASSERT_FALSE(bind(BSON_ARRAY(BSON_ARRAY(1))));
+        ASSERT_FALSE(bind(BSON_ARRAY(BSONRegEx("a"))));
+        ASSERT(bind(BSON_ARRAY(1)));
+    }
+};
+
+/**
+ * Queries without a single index scan answering the equality, or which constrain the equality's
+ * path further, aren't parameterized.
+ */
+class RefusesQueriesWithoutSingleIndexedPlan : public Base {
+public:
+    void run() {
+        OldClientWriteContext ctx(&_opCtx, nss.ns());
+        insert(BSON("_id" << 0 << "a" << 0 << "b" << 0));
+        Collection* collection = ctx.getCollection();
+        ASSERT_FALSE(makePlan(collection));
+
+        addIndex(BSON("a" << 1));
+        ASSERT(makePlan(collection));
+        ASSERT_FALSE(makePlan(collection, fromjson("{a: {$gt: -1}}")));
+        ASSERT_FALSE(makePlan(collection, fromjson("{$or: [{a: 1}, {b: 1}]}")));
+
+        addIndex(BSON("b" << 1));
+        ASSERT_FALSE(makePlan(collection, fromjson("{b: 0}")));
+    }
+};
+
+/**
+ * A plan is invalidated by changes to the indexes it was made with.
+ */
+class InvalidatedByIndexChanges : public Base {
+public:
+    void run() {
+        OldClientWriteContext ctx(&_opCtx, nss.ns());
+        insert(BSON("_id" << 0 << "a" << 0));
+        addIndex(BSON("a" << 1));
+        Collection* collection = ctx.getCollection();
+
+        auto plan = makePlan(collection);
+        ASSERT(plan);
+        insert(BSON("_id" << 1 << "a" << BSON_ARRAY(1 << 2)));
+        ASSERT_FALSE(plan->isValid(&_opCtx, collection));
+
+        plan = makePlan(collection);
+        ASSERT(plan);
+        ASSERT(std::vector<int>({1}) == Base::run(plan.get(), collection, BSON_ARRAY(1 << 2)));
+        addIndex(BSON("b" << 1));
+        ASSERT_FALSE(plan->isValid(&_opCtx, collection));
+    }
+};
+
+class All : public Suite {
+public:
+    All() : Suite("query_parameterized_equality_plan") {}
+
+    void setupTests() {
+        add<RebindsValues>();
+        add<RebindsValuesIntoDescendingIndex>();
+        add<RefusesValuesNotMatchedByEquality>();
+        add<RefusesQueriesWithoutSingleIndexedPlan>();
+        add<InvalidatedByIndexChanges>();
+    }
+};
+
+SuiteInstance<All> queryParameterizedEqualityPlanAll;
+
+}  // namespace QueryParameterizedEqualityPlan
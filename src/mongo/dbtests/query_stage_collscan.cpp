@@ -83,7 +83,9 @@ public:
         _client.remove(nss.ns(), obj);
     }
 
-    int countResults(CollectionScanParams::Direction direction, const BSONObj& filterObj) {
+    int countResults(CollectionScanParams::Direction direction,
+                     const BSONObj& filterObj,
+                     size_t maxParallelism = 1) {
         AutoGetCollectionForReadCommand ctx(&_opCtx, nss);
 
         // Configure the scan.
@@ -91,6 +93,7 @@ public:
         params.collection = ctx.getCollection();
         params.direction = direction;
         params.tailable = false;
+        params.maxParallelism = maxParallelism;
 
         // Make the filter.
         const CollatorInterface* collator = nullptr;
@@ -268,6 +271,95 @@ public:
     }
 };
 
+//
+// Filter in batches on several threads, and get the same matches.
+//
+class QueryStageCollscanParallelForwardWithMatch : public QueryStageCollectionScanBase {
+public:
+    void run() {
+        BSONObj obj = BSON("foo" << BSON("$lt" << 25));
+        ASSERT_EQUALS(25, countResults(CollectionScanParams::FORWARD, obj, 4));
+    }
+};
+
+class QueryStageCollscanParallelBackwardWithMatch : public QueryStageCollectionScanBase {
+public:
+    void run() {
+        BSONObj obj = BSON("foo" << BSON("$lt" << 25));
+        ASSERT_EQUALS(25, countResults(CollectionScanParams::BACKWARD, obj, 4));
+    }
+};
+
+//
+// Delete a record that has been read and filtered in batched mode but not yet returned, and
+// expect the scan to skip it.
+//
+class QueryStageCollscanParallelInvalidateBufferedObject : public QueryStageCollectionScanBase {
+public:
+    void run() {
+        OldClientWriteContext ctx(&_opCtx, nss.ns());
+
+        Collection* coll = ctx.getCollection();
+
+        vector<RecordId> recordIds;
+        getRecordIds(coll, CollectionScanParams::FORWARD, &recordIds);
+
+        CollectionScanParams params;
+        params.collection = coll;
+        params.direction = CollectionScanParams::FORWARD;
+        params.tailable = false;
+        params.maxParallelism = 4;
+
+        StatusWithMatchExpression statusWithMatcher =
+            MatchExpressionParser::parse(BSON("foo" << BSON("$gte" << 0)),
+                                         ExtensionsCallbackDisallowExtensions(),
+                                         nullptr);
+        ASSERT_OK(statusWithMatcher.getStatus());
+        unique_ptr<MatchExpression> filterExpr = std::move(statusWithMatcher.getValue());
+
+        WorkingSet ws;
+        unique_ptr<CollectionScan> scan(new CollectionScan(&_opCtx, params, &ws, filterExpr.get()));
+
+        int count = 0;
+        while (count < 10) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            PlanStage::StageState state = scan->work(&id);
+            if (PlanStage::ADVANCED == state) {
+                WorkingSetMember* member = ws.get(id);
+                ASSERT_EQUALS(recordIds[count], member->recordId);
+                ++count;
+            }
+        }
+
+        // All of the records have been read into the scan's buffer by now. Remove
+        // recordIds[count].
+        scan->saveState();
+        {
+            WriteUnitOfWork wunit(&_opCtx);
+            scan->invalidate(&_opCtx, recordIds[count], INVALIDATION_DELETION);
+            wunit.commit();  // to avoid rollback of the invalidate
+        }
+        remove(coll->docFor(&_opCtx, recordIds[count]).value());
+        scan->restoreState();
+
+        // Skip over recordIds[count].
+        ++count;
+
+        // Expect the rest.
+        while (!scan->isEOF()) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            PlanStage::StageState state = scan->work(&id);
+            if (PlanStage::ADVANCED == state) {
+                WorkingSetMember* member = ws.get(id);
+                ASSERT_EQUALS(recordIds[count], member->recordId);
+                ++count;
+            }
+        }
+
+        ASSERT_EQUALS(numObj(), count);
+    }
+};
+
 //
 // Scan through half the objects, delete the one we're about to fetch, then expect to get the
 // "next" object we would have gotten after that.
@@ -413,6 +505,9 @@ public:
         add<QueryStageCollscanObjectsInOrderBackward>();
         add<QueryStageCollscanInvalidateUpcomingObject>();
         add<QueryStageCollscanInvalidateUpcomingObjectBackward>();
+        add<QueryStageCollscanParallelForwardWithMatch>();
+        add<QueryStageCollscanParallelBackwardWithMatch>();
+        add<QueryStageCollscanParallelInvalidateBufferedObject>();
     }
 };
 
@@ -41,6 +41,7 @@
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/json.h"
 #include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/matcher/extensions_callback_disallow_extensions.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/fail_point_registry.h"
@@ -640,6 +641,76 @@ public:
     }
 };
 
+//
+// Counts the keys in each of several intervals, seeking between them, and counts a document with
+// keys in more than one of them once.
+//
+class QueryStageCountScanMultipleIntervals : public CountBase {
+public:
+    void run() {
+        OldClientWriteContext ctx(&_opCtx, ns());
+
+        for (int i = 0; i < 10; ++i) {
+            insert(BSON("a" << i));
+        }
+        insert(BSON("a" << BSON_ARRAY(2 << 6)));
+        addIndex(BSON("a" << 1));
+
+        OrderedIntervalList oil("a");
+        oil.intervals.push_back(Interval(BSON("" << 2 << "" << 3), true, true));
+        oil.intervals.push_back(Interval(BSON("" << 6 << "" << 7), true, false));
+
+        CountScanParams params;
+        params.descriptor = getIndex(ctx.db(), BSON("a" << 1));
+        params.bounds.fields.push_back(oil);
+
+        WorkingSet ws;
+        CountScan count(&_opCtx, params, &ws);
+
+        int numCounted = runCount(&count);
+        ASSERT_EQUALS(4, numCounted);
+    }
+};
+
+//
+// Only counts the keys which pass a filter over the fields of the index.
+//
+class QueryStageCountScanCoveredFilter : public CountBase {
+public:
+    void run() {
+        OldClientWriteContext ctx(&_opCtx, ns());
+
+        for (int i = 0; i < 10; ++i) {
+            insert(BSON("a" << i % 3 << "b" << i));
+        }
+        addIndex(BSON("a" << 1 << "b" << 1));
+
+        OrderedIntervalList aOil("a");
+        aOil.intervals.push_back(Interval(BSON("" << 0 << "" << 0), true, true));
+        aOil.intervals.push_back(Interval(BSON("" << 2 << "" << 2), true, true));
+        OrderedIntervalList bOil("b");
+        bOil.intervals.push_back(Interval(BSON("" << MINKEY << "" << MAXKEY), true, true));
+
+        CountScanParams params;
+        params.descriptor = getIndex(ctx.db(), BSON("a" << 1 << "b" << 1));
+        params.bounds.fields.push_back(aOil);
+        params.bounds.fields.push_back(bOil);
+
+        const CollatorInterface* collator = nullptr;
+        StatusWithMatchExpression statusWithMatcher = MatchExpressionParser::parse(
+            BSON("b" << BSON("$gte" << 5)), ExtensionsCallbackDisallowExtensions(), collator);
+        ASSERT_OK(statusWithMatcher.getStatus());
+        std::unique_ptr<MatchExpression> filter = std::move(statusWithMatcher.getValue());
+
+        WorkingSet ws;
+        CountScan count(&_opCtx, params, &ws, filter.get());
+
+        // a is 0 for b in {0, 3, 6, 9} and 2 for b in {2, 5, 8}.
+        int numCounted = runCount(&count);
+        ASSERT_EQUALS(4, numCounted);
+    }
+};
+
 class All : public Suite {
 public:
     All() : Suite("query_stage_count_scan") {}
@@ -656,6 +727,8 @@ public:
         add<QueryStageCountScanInsertNewDocsDuringYield>();
         add<QueryStageCountScanBecomesMultiKeyDuringYield>();
         add<QueryStageCountScanUnusedKeys>();
+        add<QueryStageCountScanMultipleIntervals>();
+        add<QueryStageCountScanCoveredFilter>();
     }
 };
 
@@ -43,9 +43,11 @@
 #include "mongo/db/exec/queued_data_stage.h"
 #include "mongo/db/matcher/extensions_callback_disallow_extensions.h"
 #include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/service_context.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/scopeguard.h"
 
 namespace QueryStageDelete {
 
@@ -132,6 +134,11 @@ private:
 class QueryStageDeleteInvalidateUpcomingObject : public QueryStageDeleteBase {
 public:
     void run() {
+        // Delete one document at a time, so that the upcoming object is still in the collection.
+        const int oldBatchSize = internalQueryExecDeleteBatchSize.load();
+        ON_BLOCK_EXIT([&] { internalQueryExecDeleteBatchSize.store(oldBatchSize); });
+        internalQueryExecDeleteBatchSize.store(1);
+
         OldClientWriteContext ctx(&_opCtx, nss.ns());
 
         Collection* coll = ctx.getCollection();
@@ -190,6 +197,74 @@ public:
     }
 };
 
+/**
+ * Test that a multi-delete deleting in batches skips a document which is invalidated while it is
+ * waiting in the batch, and deletes the rest of the batch together.
+ */
+class QueryStageDeleteInvalidateBatchedObject : public QueryStageDeleteBase {
+public:
+    void run() {
+        const int oldBatchSize = internalQueryExecDeleteBatchSize.load();
+        ON_BLOCK_EXIT([&] { internalQueryExecDeleteBatchSize.store(oldBatchSize); });
+        internalQueryExecDeleteBatchSize.store(numObj());
+
+        OldClientWriteContext ctx(&_opCtx, nss.ns());
+        Collection* coll = ctx.getCollection();
+
+        vector<RecordId> recordIds;
+        getRecordIds(coll, CollectionScanParams::FORWARD, &recordIds);
+
+        // Pass every document to the delete stage in a RID_AND_OBJ state, one per work() call.
+        WorkingSet ws;
+        auto qds = make_unique<QueuedDataStage>(&_opCtx, &ws);
+        for (const auto& recordId : recordIds) {
+            WorkingSetID id = ws.allocate();
+            WorkingSetMember* member = ws.get(id);
+            member->recordId = recordId;
+            member->obj = coll->docFor(&_opCtx, recordId);
+            ws.transitionToRecordIdAndObj(id);
+            qds->pushBack(id);
+        }
+
+        DeleteStageParams deleteStageParams;
+        deleteStageParams.isMulti = true;
+
+        DeleteStage deleteStage(&_opCtx, deleteStageParams, &ws, coll, qds.release());
+
+        const DeleteStats* stats = static_cast<const DeleteStats*>(deleteStage.getSpecificStats());
+
+        // Buffer the first documents without deleting any of them.
+        const size_t targetDocIndex = 10;
+        for (size_t i = 0; i <= targetDocIndex; ++i) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            ASSERT_EQUALS(PlanStage::NEED_TIME, deleteStage.work(&id));
+        }
+        ASSERT_EQUALS(0U, stats->docsDeleted);
+
+        // Remove recordIds[targetDocIndex] while it is in the batch.
+        deleteStage.saveState();
+        {
+            WriteUnitOfWork wunit(&_opCtx);
+            deleteStage.invalidate(&_opCtx, recordIds[targetDocIndex], INVALIDATION_DELETION);
+            wunit.commit();
+        }
+        BSONObj targetDoc = coll->docFor(&_opCtx, recordIds[targetDocIndex]).value();
+        ASSERT(!targetDoc.isEmpty());
+        remove(targetDoc);
+        deleteStage.restoreState();
+
+        while (!deleteStage.isEOF()) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            PlanStage::StageState state = deleteStage.work(&id);
+            invariant(PlanStage::NEED_TIME == state || PlanStage::IS_EOF == state);
+        }
+
+        ASSERT_EQUALS(numObj() - 1, stats->docsDeleted);
+        ASSERT_EQUALS(1U, stats->nInvalidateSkips);
+        ASSERT_EQUALS(0U, coll->numRecords(&_opCtx));
+    }
+};
+
 /**
  * Test that the delete stage returns an owned copy of the original document if returnDeleted is
  * specified.
@@ -314,6 +389,7 @@ public:
     void setupTests() {
         // Stage-specific tests below.
         add<QueryStageDeleteInvalidateUpcomingObject>();
+        add<QueryStageDeleteInvalidateBatchedObject>();
         add<QueryStageDeleteReturnOldDoc>();
         add<QueryStageDeleteSkipOwnedObjects>();
     }
@@ -191,10 +191,10 @@ public:
         // Expect to get key {'': 5} and then key {'': 6}.
         WorkingSetMember* member = getNext(ixscan.get());
         ASSERT_EQ(WorkingSetMember::RID_AND_IDX, member->getState());
-        ASSERT_BSONOBJ_EQ(member->keyData[0].keyData, BSON("" << 5));
+        ASSERT_BSONOBJ_EQ(member->keyData[0].keyData(), BSON("" << 5));
         member = getNext(ixscan.get());
         ASSERT_EQ(WorkingSetMember::RID_AND_IDX, member->getState());
-        ASSERT_BSONOBJ_EQ(member->keyData[0].keyData, BSON("" << 6));
+        ASSERT_BSONOBJ_EQ(member->keyData[0].keyData(), BSON("" << 6));
 
         // Save state and insert a few indexed docs.
         ixscan->saveState();
@@ -204,7 +204,7 @@ public:
 
         member = getNext(ixscan.get());
         ASSERT_EQ(WorkingSetMember::RID_AND_IDX, member->getState());
-        ASSERT_BSONOBJ_EQ(member->keyData[0].keyData, BSON("" << 10));
+        ASSERT_BSONOBJ_EQ(member->keyData[0].keyData(), BSON("" << 10));
 
         WorkingSetID id;
         ASSERT_EQ(PlanStage::IS_EOF, ixscan->work(&id));
@@ -228,7 +228,7 @@ public:
         // Expect to get key {'': 6}.
         WorkingSetMember* member = getNext(ixscan.get());
         ASSERT_EQ(WorkingSetMember::RID_AND_IDX, member->getState());
-        ASSERT_BSONOBJ_EQ(member->keyData[0].keyData, BSON("" << 6));
+        ASSERT_BSONOBJ_EQ(member->keyData[0].keyData(), BSON("" << 6));
 
         // Save state and insert an indexed doc.
         ixscan->saveState();
@@ -237,7 +237,7 @@ public:
 
         member = getNext(ixscan.get());
         ASSERT_EQ(WorkingSetMember::RID_AND_IDX, member->getState());
-        ASSERT_BSONOBJ_EQ(member->keyData[0].keyData, BSON("" << 7));
+        ASSERT_BSONOBJ_EQ(member->keyData[0].keyData(), BSON("" << 7));
 
         WorkingSetID id;
         ASSERT_EQ(PlanStage::IS_EOF, ixscan->work(&id));
@@ -261,7 +261,7 @@ public:
         // Expect to get key {'': 6}.
         WorkingSetMember* member = getNext(ixscan.get());
         ASSERT_EQ(WorkingSetMember::RID_AND_IDX, member->getState());
-        ASSERT_BSONOBJ_EQ(member->keyData[0].keyData, BSON("" << 6));
+        ASSERT_BSONOBJ_EQ(member->keyData[0].keyData(), BSON("" << 6));
 
         // Save state and insert an indexed doc.
         ixscan->saveState();
@@ -291,10 +291,10 @@ public:
         // Expect to get key {'': 10} and then {'': 8}.
         WorkingSetMember* member = getNext(ixscan.get());
         ASSERT_EQ(WorkingSetMember::RID_AND_IDX, member->getState());
-        ASSERT_BSONOBJ_EQ(member->keyData[0].keyData, BSON("" << 10));
+        ASSERT_BSONOBJ_EQ(member->keyData[0].keyData(), BSON("" << 10));
         member = getNext(ixscan.get());
         ASSERT_EQ(WorkingSetMember::RID_AND_IDX, member->getState());
-        ASSERT_BSONOBJ_EQ(member->keyData[0].keyData, BSON("" << 8));
+        ASSERT_BSONOBJ_EQ(member->keyData[0].keyData(), BSON("" << 8));
 
         // Save state and insert an indexed doc.
         ixscan->saveState();
@@ -305,7 +305,7 @@ public:
         // Ensure that we don't erroneously return {'': 9} or {'':3}.
         member = getNext(ixscan.get());
         ASSERT_EQ(WorkingSetMember::RID_AND_IDX, member->getState());
-        ASSERT_BSONOBJ_EQ(member->keyData[0].keyData, BSON("" << 6));
+        ASSERT_BSONOBJ_EQ(member->keyData[0].keyData(), BSON("" << 6));
 
         WorkingSetID id;
         ASSERT_EQ(PlanStage::IS_EOF, ixscan->work(&id));
@@ -41,6 +41,7 @@
 #include "mongo/db/exec/sort.h"
 #include "mongo/db/json.h"
 #include "mongo/db/query/plan_executor.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
 
@@ -157,6 +158,7 @@ public:
         params.collection = coll;
         params.pattern = BSON("foo" << direction);
         params.limit = limit();
+        params.allowDiskUse = allowDiskUse();
 
         auto keyGenStage = make_unique<SortKeyGeneratorStage>(
             &_opCtx, queuedDataStage.release(), ws.get(), params.pattern, BSONObj(), nullptr);
@@ -216,6 +218,11 @@ public:
         return 0;
     };
 
+    // Returns whether the sort may spill to disk.
+    virtual bool allowDiskUse() const {
+        return false;
+    }
+
 
     static const char* ns() {
         return "unittests.QueryStageSort";
@@ -303,6 +310,31 @@ public:
     }
 };
 
+// Sort a big bunch of objects with a small memory limit, forcing the sort to spill to disk.
+template <int LIMIT>
+class QueryStageSortSpillToDisk : public QueryStageSortExt {
+public:
+    QueryStageSortSpillToDisk()
+        : _oldMaxBlockingSortBytes(internalQueryExecMaxBlockingSortBytes.load()) {
+        internalQueryExecMaxBlockingSortBytes.store(16 * 1024);
+    }
+
+    ~QueryStageSortSpillToDisk() {
+        internalQueryExecMaxBlockingSortBytes.store(_oldMaxBlockingSortBytes);
+    }
+
+    int limit() const final {
+        return LIMIT;
+    }
+
+    bool allowDiskUse() const final {
+        return true;
+    }
+
+private:
+    const int _oldMaxBlockingSortBytes;
+};
+
 // Mutation invalidation of docs fed to sort.
 class QueryStageSortMutationInvalidation : public QueryStageSortTestBase {
 public:
@@ -587,6 +619,8 @@ public:
         // and a special case for limit == 1
         add<QueryStageSortDecWithLimit<1>>();
         add<QueryStageSortExt>();
+        add<QueryStageSortSpillToDisk<0>>();
+        add<QueryStageSortSpillToDisk<5000>>();
         add<QueryStageSortMutationInvalidation>();
         add<QueryStageSortDeletionInvalidation>();
         add<QueryStageSortDeletionInvalidationWithLimit<10>>();
@@ -42,6 +42,7 @@
 #include "mongo/db/matcher/extensions_callback_noop.h"
 #include "mongo/db/query/canonical_query.h"
 #include "mongo/db/query/get_executor.h"
+#include "mongo/db/query/query_planner.h"
 #include "mongo/dbtests/dbtests.h"
 
 namespace QueryStageSubplan {
@@ -210,9 +211,9 @@ public:
             insert(BSON("a" << 1 << "b" << i << "c" << i));
         }
 
-        // Running this query should not create any cache entries. For the first branch, it's
-        // because there are no matching results. For the second branch it's because there is only
-        // one relevant index.
+        // Running this query should not create any cache entries for its branches. For the first
+        // branch, it's because there are no matching results. For the second branch it's because
+        // there is only one relevant index.
         BSONObj query = fromjson("{$or: [{a: 1, b: 15}, {c: 1}]}");
 
         Collection* collection = ctx.getCollection();
@@ -254,7 +255,7 @@ public:
 };
 
 /**
- * Ensure that the subplan stage doesn't create a plan cache entry if there are no query results.
+ * Ensure that the subplan stage doesn't create a plan cache entry if there is a tie between plans.
  */
 class QueryStageSubplanDontCacheTies : public QueryStageSubplanBase {
 public:
@@ -269,9 +270,9 @@ public:
             insert(BSON("a" << 1 << "e" << 1 << "d" << 1));
         }
 
-        // Running this query should not create any cache entries. For the first branch, it's
-        // because plans using the {a: 1, b: 1} and {a: 1, c: 1} indices should tie during plan
-        // ranking. For the second branch it's because there is only one relevant index.
+        // Running this query should not create any cache entries for its branches. For the first
+        // branch, it's because plans using the {a: 1, b: 1} and {a: 1, c: 1} indices should tie
+        // during plan ranking. For the second branch it's because there is only one relevant index.
         BSONObj query = fromjson("{$or: [{a: 1, e: 1}, {d: 1}]}");
 
         Collection* collection = ctx.getCollection();
@@ -312,6 +313,80 @@ public:
     }
 };
 
+/**
+ * Test that the subplan stage caches the composite solution for the whole rooted $or, which later
+ * executions of the query then use through a CachedPlanStage.
+ */
+class QueryStageSubplanCacheCompositeSolution : public QueryStageSubplanBase {
+public:
+    void run() {
+        OldClientWriteContext ctx(&_opCtx, nss.ns());
+
+        addIndex(BSON("a" << 1));
+        addIndex(BSON("a" << 1 << "b" << 1));
+        addIndex(BSON("c" << 1));
+
+        for (int i = 0; i < 10; i++) {
+            insert(BSON("a" << 1 << "b" << i << "c" << i));
+        }
+
+        // The first branch has two competing indices, so choosing the composite solution takes
+        // plan ranking.
+        std::string findCmd = "{find: 'testns', filter: {$or: [{a: 1, b: 3}, {c: 1}]}}";
+        std::unique_ptr<CanonicalQuery> cq = cqFromFindCommand(findCmd);
+
+        Collection* collection = ctx.getCollection();
+        PlanCache* cache = collection->infoCache()->getPlanCache();
+
+        QueryPlannerParams plannerParams;
+        fillOutPlannerParams(&_opCtx, collection, cq.get(), &plannerParams);
+
+        // A SubplanStage which never caches leaves the plan cache empty.
+        WorkingSet ws;
+        std::unique_ptr<SubplanStage> subplan(
+            new SubplanStage(&_opCtx,
+                             collection,
+                             &ws,
+                             plannerParams,
+                             cq.get(),
+                             SubplanStage::CachingMode::NeverCache));
+
+        PlanYieldPolicy yieldPolicy(PlanExecutor::NO_YIELD, _clock);
+        ASSERT_OK(subplan->pickBestPlan(&yieldPolicy));
+        ASSERT_EQUALS(0U, cache->size());
+
+        // Otherwise both the first branch and the whole query get a cache entry.
+        ws.clear();
+        subplan.reset(new SubplanStage(&_opCtx, collection, &ws, plannerParams, cq.get()));
+        ASSERT_OK(subplan->pickBestPlan(&yieldPolicy));
+        ASSERT_TRUE(cache->contains(*cq));
+        ASSERT_EQUALS(2U, cache->size());
+
+        CachedSolution* rawCS;
+        ASSERT_OK(cache->get(*cq, &rawCS));
+        std::unique_ptr<CachedSolution> cachedSolution(rawCS);
+        ASSERT_GREATER_THAN(cachedSolution->decisionWorks, 0U);
+
+        // The cached index assignments build a solution for the whole query.
+        QuerySolution* rawSoln;
+        ASSERT_OK(QueryPlanner::planFromCache(*cq, plannerParams, *cachedSolution, &rawSoln));
+        std::unique_ptr<QuerySolution> soln(rawSoln);
+        ASSERT_EQUALS(STAGE_OR, soln->root->getType());
+
+        // The next execution of the query runs the cached plan rather than subplanning again.
+        auto exec = unittest::assertGet(
+            getExecutor(&_opCtx, collection, cqFromFindCommand(findCmd), PlanExecutor::NO_YIELD));
+        ASSERT_EQUALS(STAGE_CACHED_PLAN, exec->getRootStage()->stageType());
+
+        size_t numResults = 0;
+        BSONObj obj;
+        while (PlanExecutor::ADVANCED == exec->getNext(&obj, nullptr)) {
+            ++numResults;
+        }
+        ASSERT_EQUALS(2U, numResults);
+    }
+};
+
 /**
  * Unit test the subplan stage's canUseSubplanning() method.
  */
@@ -636,6 +711,7 @@ public:
         add<QueryStageSubplanPlanFromCache>();
         add<QueryStageSubplanDontCacheZeroResults>();
         add<QueryStageSubplanDontCacheTies>();
+        add<QueryStageSubplanCacheCompositeSolution>();
         add<QueryStageSubplanCanUseSubplanning>();
         add<QueryStageSubplanRewriteToRootedOr>();
         add<QueryStageSubplanPlanContainedOr>();
@@ -36,6 +36,7 @@
 #include "mongo/config.h"
 #include "mongo/executor/async_stream_common.h"
 #include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
 #include "mongo/util/net/ssl_manager.h"
 
 #ifdef MONGO_CONFIG_SSL
@@ -88,6 +89,19 @@ void AsyncSecureStream::read(asio::mutable_buffer buffer, StreamHandler&& stream
 }
 
 void AsyncSecureStream::_handleConnect(asio::ip::tcp::resolver::iterator iter) {
+    // Key resumable sessions the way SockAddr::toString formats the peer, which the legacy
+    // egress path uses, so both paths share entries.
+    const auto endpoint = iter->endpoint();
+    str::stream remote;
+    if (endpoint.address().is_v6()) {
+        remote << '[' << endpoint.address().to_string() << "]:" << endpoint.port();
+    } else {
+        remote << endpoint.address().to_string() << ':' << endpoint.port();
+    }
+    _remote = remote;
+
+    getSSLManager()->setResumableSession(_stream.native_handle(), _remote);
+
     _stream.async_handshake(decltype(_stream)::client,
                             _strand->wrap([this, iter](std::error_code ec) {
                                 if (ec) {
@@ -98,6 +112,9 @@ void AsyncSecureStream::_handleConnect(asio::ip::tcp::resolver::iterator iter) {
 }
 
 void AsyncSecureStream::_handleHandshake(std::error_code ec, const std::string& hostName) {
+    getSSLManager()->recordHandshake(
+        _stream.native_handle(), SSLManagerInterface::ConnectionDirection::kOutgoing, _remote);
+
     auto certStatus =
         getSSLManager()->parseAndValidatePeerCertificate(_stream.native_handle(), hostName);
     if (!certStatus.isOK()) {
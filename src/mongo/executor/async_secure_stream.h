@@ -66,6 +66,9 @@ private:
     asio::ssl::stream<asio::ip::tcp::socket> _stream;
     ConnectHandler _userHandler;
     bool _connected = false;
+
+    // The address the stream connected to, under which its TLS session is cached for resumption.
+    std::string _remote;
 };
 
 }  // namespace executor
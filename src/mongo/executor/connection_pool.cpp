@@ -35,6 +35,7 @@
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/executor/connection_pool_stats.h"
 #include "mongo/executor/remote_command_request.h"
+#include "mongo/platform/random.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/destructor_guard.h"
@@ -52,6 +53,23 @@
 namespace mongo {
 namespace executor {
 
+namespace {
+
+/**
+ * Locks mutex, counting the acquisition in contentions if another thread already held it.
+ */
+stdx::unique_lock<stdx::mutex> lockAndCountContention(stdx::mutex& mutex,
+                                                      AtomicUInt64* contentions) {
+    stdx::unique_lock<stdx::mutex> lk(mutex, stdx::try_to_lock);
+    if (!lk.owns_lock()) {
+        contentions->fetchAndAdd(1);
+        lk.lock();
+    }
+    return lk;
+}
+
+}  // namespace
+
 /**
  * A pool for a specific HostAndPort
  *
@@ -65,14 +83,35 @@ public:
     ~SpecificPool();
 
     /**
-     * Gets a connection from the specific pool. Sinks a unique_lock from the
-     * parent to preserve the lock on _mutex
+     * Locks this pool's _mutex, which guards all of its state. Requests to different hosts only
+     * share the parent's _mutex, and only for long enough to look up their SpecificPool.
+     */
+    stdx::unique_lock<stdx::mutex> lock() {
+        return lockAndCountContention(_mutex, &_lockContentions);
+    }
+
+    /**
+     * Returns how many times a thread had to wait for this pool's _mutex.
+     */
+    size_t lockContentions() const {
+        return _lockContentions.load();
+    }
+
+    /**
+     * Gets a connection from the specific pool. Sinks a unique_lock on this
+     * pool's _mutex
      */
     void getConnection(const HostAndPort& hostAndPort,
                        Milliseconds timeout,
                        stdx::unique_lock<stdx::mutex> lk,
                        GetConnectionCallback cb);
 
+    /**
+     * Spawns connections up to minConnections without queueing a request. Sinks a unique_lock on
+     * this pool's _mutex
+     */
+    void warmUp(stdx::unique_lock<stdx::mutex> lk);
+
     /**
      * Cascades a failure across existing connections and requests. Invoking
      * this function drops all current connections and fails all current
@@ -81,8 +120,8 @@ public:
     void processFailure(const Status& status, stdx::unique_lock<stdx::mutex> lk);
 
     /**
-     * Returns a connection to a specific pool. Sinks a unique_lock from the
-     * parent to preserve the lock on _mutex
+     * Returns a connection to a specific pool. Sinks a unique_lock on this
+     * pool's _mutex
      */
     void returnConnection(ConnectionInterface* connection, stdx::unique_lock<stdx::mutex> lk);
 
@@ -106,6 +145,11 @@ public:
      */
     size_t createdConnections(const stdx::unique_lock<stdx::mutex>& lk);
 
+    /**
+     * Returns how long the connections created by this pool took to set up.
+     */
+    const ConnectionSetupHistogram& setupLatency(const stdx::unique_lock<stdx::mutex>& lk);
+
     /**
      * Returns the total number of connections currently open that belong to
      * this pool. This is the sum of refreshingConnections, availableConnections,
@@ -145,6 +189,9 @@ private:
 
     const HostAndPort _hostAndPort;
 
+    stdx::mutex _mutex;
+    AtomicUInt64 _lockContentions;
+
     LRUOwnershipPool _readyPool;
     OwnershipPool _processingPool;
     OwnershipPool _droppedProcessingPool;
@@ -159,6 +206,13 @@ private:
     bool _inSpawnConnections;
 
     size_t _created;
+    ConnectionSetupHistogram _setupLatency;
+
+    // This host's entry in InUseConnectionsByHost, kept equal to our share of it by adjusting it
+    // whenever a connection enters or leaves _checkedOutPool.
+    AtomicInt64* const _inUseByHost;
+
+    PseudoRandom _random;
 
     /**
      * The current state of the pool
@@ -203,73 +257,101 @@ ConnectionPool::ConnectionPool(std::unique_ptr<DependentTypeFactoryInterface> im
 
 ConnectionPool::~ConnectionPool() = default;
 
+// Every method that reaches into a SpecificPool locks that pool before releasing _mutex, so that
+// SpecificPool::shutdown(), which needs both, can't remove the pool in between.
+
 void ConnectionPool::dropConnections(const HostAndPort& hostAndPort) {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    auto lk = lockAndCountContention(_mutex, &_lockContentions);
 
     auto iter = _pools.find(hostAndPort);
 
     if (iter == _pools.end())
         return;
 
-    iter->second.get()->processFailure(
-        Status(ErrorCodes::PooledConnectionsDropped, "Pooled connections dropped"), std::move(lk));
+    auto pool = iter->second.get();
+    auto poolLk = pool->lock();
+    lk.unlock();
+
+    pool->processFailure(
+        Status(ErrorCodes::PooledConnectionsDropped, "Pooled connections dropped"),
+        std::move(poolLk));
 }
 
 void ConnectionPool::get(const HostAndPort& hostAndPort,
                          Milliseconds timeout,
                          GetConnectionCallback cb) {
-    SpecificPool* pool;
+    auto lk = lockAndCountContention(_mutex, &_lockContentions);
 
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    auto& handle = _pools[hostAndPort];
+    if (!handle) {
+        handle = stdx::make_unique<SpecificPool>(this, hostAndPort);
+    }
 
-    auto iter = _pools.find(hostAndPort);
+    auto pool = handle.get();
+    auto poolLk = pool->lock();
+    lk.unlock();
 
-    if (iter == _pools.end()) {
-        auto handle = stdx::make_unique<SpecificPool>(this, hostAndPort);
-        pool = handle.get();
-        _pools[hostAndPort] = std::move(handle);
-    } else {
-        pool = iter->second.get();
+    pool->getConnection(hostAndPort, timeout, std::move(poolLk), std::move(cb));
+}
+
+void ConnectionPool::warmUp(const HostAndPort& hostAndPort) {
+    auto lk = lockAndCountContention(_mutex, &_lockContentions);
+
+    auto& handle = _pools[hostAndPort];
+    if (!handle) {
+        handle = stdx::make_unique<SpecificPool>(this, hostAndPort);
     }
 
-    invariant(pool);
+    auto pool = handle.get();
+    auto poolLk = pool->lock();
+    lk.unlock();
 
-    pool->getConnection(hostAndPort, timeout, std::move(lk), std::move(cb));
+    pool->warmUp(std::move(poolLk));
 }
 
 void ConnectionPool::appendConnectionStats(ConnectionPoolStats* stats) const {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    auto lk = lockAndCountContention(_mutex, &_lockContentions);
 
     for (const auto& kv : _pools) {
         HostAndPort host = kv.first;
 
         auto& pool = kv.second;
-        ConnectionStatsPer hostStats{pool->inUseConnections(lk),
-                                     pool->availableConnections(lk),
-                                     pool->createdConnections(lk),
-                                     pool->refreshingConnections(lk)};
+        auto poolLk = pool->lock();
+        ConnectionStatsPer hostStats{pool->inUseConnections(poolLk),
+                                     pool->availableConnections(poolLk),
+                                     pool->createdConnections(poolLk),
+                                     pool->refreshingConnections(poolLk)};
+        hostStats.setupLatency = pool->setupLatency(poolLk);
+        hostStats.lockContentions = pool->lockContentions();
         stats->updateStatsForHost(_name, host, hostStats);
     }
+
+    stats->updateHostMapLockContentions(_name, _lockContentions.load());
 }
 
 size_t ConnectionPool::getNumConnectionsPerHost(const HostAndPort& hostAndPort) const {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    auto lk = lockAndCountContention(_mutex, &_lockContentions);
     auto iter = _pools.find(hostAndPort);
     if (iter != _pools.end()) {
-        return iter->second->openConnections(lk);
+        auto poolLk = iter->second->lock();
+        return iter->second->openConnections(poolLk);
     }
 
     return 0;
 }
 
 void ConnectionPool::returnConnection(ConnectionInterface* conn) {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    auto lk = lockAndCountContention(_mutex, &_lockContentions);
 
     auto iter = _pools.find(conn->getHostAndPort());
 
     invariant(iter != _pools.end());
 
-    iter->second.get()->returnConnection(conn, std::move(lk));
+    auto pool = iter->second.get();
+    auto poolLk = pool->lock();
+    lk.unlock();
+
+    pool->returnConnection(conn, std::move(poolLk));
 }
 
 ConnectionPool::SpecificPool::SpecificPool(ConnectionPool* parent, const HostAndPort& hostAndPort)
@@ -281,6 +363,8 @@ ConnectionPool::SpecificPool::SpecificPool(ConnectionPool* parent, const HostAnd
       _inFulfillRequests(false),
       _inSpawnConnections(false),
       _created(0),
+      _inUseByHost(InUseConnectionsByHost::counterFor(hostAndPort)),
+      _random(SecureRandom::create()->nextInt64()),
       _state(State::kRunning) {}
 
 ConnectionPool::SpecificPool::~SpecificPool() {
@@ -305,6 +389,11 @@ size_t ConnectionPool::SpecificPool::createdConnections(const stdx::unique_lock<
     return _created;
 }
 
+const ConnectionSetupHistogram& ConnectionPool::SpecificPool::setupLatency(
+    const stdx::unique_lock<stdx::mutex>& lk) {
+    return _setupLatency;
+}
+
 size_t ConnectionPool::SpecificPool::openConnections(const stdx::unique_lock<stdx::mutex>& lk) {
     return _checkedOutPool.size() + _readyPool.size() + _processingPool.size();
 }
@@ -327,11 +416,20 @@ void ConnectionPool::SpecificPool::getConnection(const HostAndPort& hostAndPort,
     fulfillRequests(lk);
 }
 
+void ConnectionPool::SpecificPool::warmUp(stdx::unique_lock<stdx::mutex> lk) {
+    // Without any requests this starts the hostTimeout clock, so a warmed pool that is never used
+    // still goes away.
+    updateStateInLock();
+
+    spawnConnections(lk);
+}
+
 void ConnectionPool::SpecificPool::returnConnection(ConnectionInterface* connPtr,
                                                     stdx::unique_lock<stdx::mutex> lk) {
     auto needsRefreshTP = connPtr->getLastUsed() + _parent->_options.refreshRequirement;
 
     auto conn = takeFromPool(_checkedOutPool, connPtr);
+    _inUseByHost->subtractAndFetch(1);
 
     updateStateInLock();
 
@@ -372,7 +470,7 @@ void ConnectionPool::SpecificPool::returnConnection(ConnectionInterface* connPtr
                          [this](ConnectionInterface* connPtr, Status status) {
                              connPtr->indicateUsed();
 
-                             stdx::unique_lock<stdx::mutex> lk(_parent->_mutex);
+                             auto lk = lock();
 
                              auto conn = takeFromProcessingPool(connPtr);
 
@@ -426,13 +524,21 @@ void ConnectionPool::SpecificPool::addToReady(stdx::unique_lock<stdx::mutex>& lk
     // This makes the connection the new most-recently-used connection.
     _readyPool.add(connPtr, std::move(conn));
 
+    // Connections that were set up or refreshed together would otherwise all come due at the
+    // same moment, so spread them out over refreshJitter
+    auto refreshAfter = _parent->_options.refreshRequirement;
+    if (_parent->_options.refreshJitter > Milliseconds(0)) {
+        refreshAfter +=
+            Milliseconds(_random.nextInt64(_parent->_options.refreshJitter.count() + 1));
+    }
+
     // Our strategy for refreshing connections is to check them out and
     // immediately check them back in (which kicks off the refresh logic in
     // returnConnection
-    connPtr->setTimeout(_parent->_options.refreshRequirement, [this, connPtr]() {
+    connPtr->setTimeout(refreshAfter, [this, connPtr]() {
         OwnedConnection conn;
 
-        stdx::unique_lock<stdx::mutex> lk(_parent->_mutex);
+        auto lk = lock();
 
         if (!_readyPool.count(connPtr)) {
             // We've already been checked out. We don't need to refresh
@@ -447,6 +553,7 @@ void ConnectionPool::SpecificPool::addToReady(stdx::unique_lock<stdx::mutex>& lk
             return;
 
         _checkedOutPool[connPtr] = std::move(conn);
+        _inUseByHost->addAndFetch(1);
 
         connPtr->indicateSuccess();
 
@@ -542,6 +649,7 @@ void ConnectionPool::SpecificPool::fulfillRequests(stdx::unique_lock<stdx::mutex
 
         // check out the connection
         _checkedOutPool[connPtr] = std::move(conn);
+        _inUseByHost->addAndFetch(1);
 
         updateStateInLock();
 
@@ -588,13 +696,16 @@ void ConnectionPool::SpecificPool::spawnConnections(stdx::unique_lock<stdx::mute
 
         ++_created;
 
+        const auto setupStart = _parent->_factory->now();
+
         // Run the setup callback
         lk.unlock();
         connPtr->setup(
-            _parent->_options.refreshTimeout, [this](ConnectionInterface* connPtr, Status status) {
+            _parent->_options.refreshTimeout,
+            [this, setupStart](ConnectionInterface* connPtr, Status status) {
                 connPtr->indicateUsed();
 
-                stdx::unique_lock<stdx::mutex> lk(_parent->_mutex);
+                auto lk = lock();
 
                 auto conn = takeFromProcessingPool(connPtr);
 
@@ -603,6 +714,8 @@ void ConnectionPool::SpecificPool::spawnConnections(stdx::unique_lock<stdx::mute
                     // connection lapse
                     spawnConnections(lk);
                 } else if (status.isOK()) {
+                    _setupLatency.record(duration_cast<Milliseconds>(_parent->_factory->now() -
+                                                                     setupStart));
                     addToReady(lk, std::move(conn));
                     spawnConnections(lk);
                 } else if (status.code() == ErrorCodes::NetworkInterfaceExceededTimeLimit) {
@@ -624,7 +737,10 @@ void ConnectionPool::SpecificPool::spawnConnections(stdx::unique_lock<stdx::mute
 
 // Called every second after hostTimeout until all processing connections reap
 void ConnectionPool::SpecificPool::shutdown() {
-    stdx::unique_lock<stdx::mutex> lk(_parent->_mutex);
+    // Removing this pool from the parent requires the parent's _mutex, which must be acquired
+    // before our own.
+    auto parentLk = lockAndCountContention(_parent->_mutex, &_parent->_lockContentions);
+    auto lk = lock();
 
     // We're racing:
     //
@@ -658,7 +774,14 @@ void ConnectionPool::SpecificPool::shutdown() {
     invariant(_requests.empty());
     invariant(_checkedOutPool.empty());
 
-    _parent->_pools.erase(_hostAndPort);
+    // Take ownership of ourselves so that we're destroyed only after both locks are released.
+    auto iter = _parent->_pools.find(_hostAndPort);
+    invariant(iter != _parent->_pools.end());
+    auto self = std::move(iter->second);
+    _parent->_pools.erase(iter);
+
+    lk.unlock();
+    parentLk.unlock();
 }
 
 template <typename OwnershipPoolType>
@@ -702,7 +825,7 @@ void ConnectionPool::SpecificPool::updateStateInLock() {
         // We set a timer for the most recent request, then invoke each timed
         // out request we couldn't service
         _requestTimer->setTimeout(timeout, [this]() {
-            stdx::unique_lock<stdx::mutex> lk(_parent->_mutex);
+            auto lk = lock();
 
             auto now = _parent->_factory->now();
 
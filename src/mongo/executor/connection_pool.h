@@ -31,6 +31,7 @@
 #include <queue>
 
 #include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/chrono.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/stdx/mutex.h"
@@ -112,6 +113,13 @@ public:
          */
         Milliseconds refreshRequirement = kDefaultRefreshRequirement;
 
+        /**
+         * Upper bound of a random delay added to refreshRequirement for each
+         * ready connection, so that connections established together aren't
+         * all refreshed together
+         */
+        Milliseconds refreshJitter = Milliseconds(0);
+
         /**
          * Amount of time to keep a specific pool around without any checked
          * out connections or new requests
@@ -129,6 +137,12 @@ public:
 
     void get(const HostAndPort& hostAndPort, Milliseconds timeout, GetConnectionCallback cb);
 
+    /**
+     * Starts establishing minConnections connections to hostAndPort, creating its pool if needed,
+     * so that the first requests to a new host don't all wait on connection setup.
+     */
+    void warmUp(const HostAndPort& hostAndPort);
+
     void appendConnectionStats(ConnectionPoolStats* stats) const;
 
     size_t getNumConnectionsPerHost(const HostAndPort& hostAndPort) const;
@@ -144,8 +158,11 @@ private:
 
     const std::unique_ptr<DependentTypeFactoryInterface> _factory;
 
-    // The global mutex for specific pool access and the generation counter
+    // Guards _pools. Each SpecificPool has its own mutex for its connections and requests, so
+    // requests to different hosts only share this one for a map lookup. When both are needed,
+    // this one is acquired first.
     mutable stdx::mutex _mutex;
+    mutable AtomicUInt64 _lockContentions;
     stdx::unordered_map<HostAndPort, std::unique_ptr<SpecificPool>> _pools;
 };
 
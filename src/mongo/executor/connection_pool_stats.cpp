@@ -30,11 +30,66 @@
 
 #include "mongo/executor/connection_pool_stats.h"
 
+#include <algorithm>
+
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/map_util.h"
+#include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
 namespace executor {
+namespace {
+
+stdx::mutex inUseConnectionsMutex;
+stdx::unordered_map<HostAndPort, std::unique_ptr<AtomicInt64>> inUseConnections;
+
+}  // namespace
+
+AtomicInt64* InUseConnectionsByHost::counterFor(const HostAndPort& host) {
+    stdx::lock_guard<stdx::mutex> lk(inUseConnectionsMutex);
+    auto& counter = inUseConnections[host];
+    if (!counter) {
+        counter = stdx::make_unique<AtomicInt64>(0);
+    }
+    return counter.get();
+}
+
+int64_t InUseConnectionsByHost::get(const HostAndPort& host) {
+    stdx::lock_guard<stdx::mutex> lk(inUseConnectionsMutex);
+    auto it = inUseConnections.find(host);
+    return it == inUseConnections.end() ? 0 : it->second->load();
+}
+
+const std::array<Milliseconds, 12> ConnectionSetupHistogram::kBucketBounds = {
+    {Milliseconds(1), Milliseconds(2), Milliseconds(5), Milliseconds(10), Milliseconds(20),
+     Milliseconds(50), Milliseconds(100), Milliseconds(200), Milliseconds(500),
+     Milliseconds(1000), Milliseconds(2000), Milliseconds(5000)}};
+
+void ConnectionSetupHistogram::record(Milliseconds latency) {
+    const auto bucket = std::upper_bound(kBucketBounds.begin(), kBucketBounds.end(), latency);
+    ++counts[bucket - kBucketBounds.begin()];
+}
+
+ConnectionSetupHistogram& ConnectionSetupHistogram::operator+=(
+    const ConnectionSetupHistogram& other) {
+    for (size_t i = 0; i < counts.size(); ++i) {
+        counts[i] += other.counts[i];
+    }
+
+    return *this;
+}
+
+void ConnectionSetupHistogram::appendToBSON(mongo::BSONObjBuilder* builder) const {
+    BSONObjBuilder histogramBuilder(builder->subobjStart("setupLatencyMillis"));
+    for (size_t i = 0; i < kBucketBounds.size(); ++i) {
+        const std::string bucketName = str::stream() << "<" << kBucketBounds[i].count();
+        histogramBuilder.appendNumber(bucketName, counts[i]);
+    }
+    const std::string overflowName = str::stream() << ">=" << kBucketBounds.back().count();
+    histogramBuilder.appendNumber(overflowName, counts.back());
+}
 
 ConnectionStatsPer::ConnectionStatsPer(size_t nInUse,
                                        size_t nAvailable,
@@ -49,6 +104,8 @@ ConnectionStatsPer& ConnectionStatsPer::operator+=(const ConnectionStatsPer& oth
     available += other.available;
     created += other.created;
     refreshing += other.refreshing;
+    lockContentions += other.lockContentions;
+    setupLatency += other.setupLatency;
 
     return *this;
 }
@@ -66,6 +123,12 @@ void ConnectionPoolStats::updateStatsForHost(std::string pool,
     totalAvailable += newStats.available;
     totalCreated += newStats.created;
     totalRefreshing += newStats.refreshing;
+    totalLockContentions += newStats.lockContentions;
+}
+
+void ConnectionPoolStats::updateHostMapLockContentions(std::string pool, size_t contentions) {
+    hostMapLockContentionsByPool[pool] += contentions;
+    totalLockContentions += contentions;
 }
 
 void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
@@ -73,6 +136,7 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
     result.appendNumber("totalAvailable", totalAvailable);
     result.appendNumber("totalCreated", totalCreated);
     result.appendNumber("totalRefreshing", totalRefreshing);
+    result.appendNumber("totalLockContentions", totalLockContentions);
 
     {
         BSONObjBuilder poolBuilder(result.subobjStart("pools"));
@@ -83,6 +147,10 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
             poolInfo.appendNumber("poolAvailable", poolStats.available);
             poolInfo.appendNumber("poolCreated", poolStats.created);
             poolInfo.appendNumber("poolRefreshing", poolStats.refreshing);
+            poolInfo.appendNumber("poolLockContentions", poolStats.lockContentions);
+            poolInfo.appendNumber("poolHostMapLockContentions",
+                                  hostMapLockContentionsByPool[pool.first]);
+            poolStats.setupLatency.appendToBSON(&poolInfo);
             for (auto&& host : statsByPoolHost[pool.first]) {
                 BSONObjBuilder hostInfo(poolInfo.subobjStart(host.first.toString()));
                 auto hostStats = host.second;
@@ -90,6 +158,8 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
                 hostInfo.appendNumber("available", hostStats.available);
                 hostInfo.appendNumber("created", hostStats.created);
                 hostInfo.appendNumber("refreshing", hostStats.refreshing);
+                hostInfo.appendNumber("lockContentions", hostStats.lockContentions);
+                hostStats.setupLatency.appendToBSON(&hostInfo);
             }
         }
     }
@@ -102,6 +172,8 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
             hostInfo.appendNumber("available", hostStats.available);
             hostInfo.appendNumber("created", hostStats.created);
             hostInfo.appendNumber("refreshing", hostStats.refreshing);
+            hostInfo.appendNumber("lockContentions", hostStats.lockContentions);
+            hostStats.setupLatency.appendToBSON(&hostInfo);
         }
     }
 }
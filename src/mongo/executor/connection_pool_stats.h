@@ -28,12 +28,54 @@
 
 #pragma once
 
+#include <array>
+#include <memory>
+
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/unordered_map.h"
 #include "mongo/util/net/hostandport.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 namespace executor {
 
+/**
+ * Counts how long new connections took to establish, including any authentication, in fixed
+ * millisecond buckets.
+ */
+struct ConnectionSetupHistogram {
+    // The exclusive upper bound of each bucket. Setups taking at least the last bound are counted
+    // in one extra overflow bucket.
+    static const std::array<Milliseconds, 12> kBucketBounds;
+
+    void record(Milliseconds latency);
+
+    ConnectionSetupHistogram& operator+=(const ConnectionSetupHistogram& other);
+
+    void appendToBSON(mongo::BSONObjBuilder* builder) const;
+
+    std::array<size_t, kBucketBounds.size() + 1> counts{};
+};
+
+/**
+ * Process-wide number of connections checked out of any ConnectionPool, by remote host. A checked
+ * out connection carries one outstanding request, so this is the load this process currently
+ * puts on each host. Counters are created on first use and never removed.
+ */
+class InUseConnectionsByHost {
+public:
+    /**
+     * Returns the counter for 'host', which stays valid for the lifetime of the process.
+     */
+    static AtomicInt64* counterFor(const HostAndPort& host);
+
+    /**
+     * Returns the number of connections to 'host' currently checked out, or 0 if no pool has ever
+     * connected to it.
+     */
+    static int64_t get(const HostAndPort& host);
+};
+
 /**
  * Holds connection information for a specific pool or remote host. These objects are maintained by
  * a parent ConnectionPoolStats object and should not need to be created directly.
@@ -49,6 +91,8 @@ struct ConnectionStatsPer {
     size_t available = 0u;
     size_t created = 0u;
     size_t refreshing = 0u;
+    size_t lockContentions = 0u;
+    ConnectionSetupHistogram setupLatency;
 };
 
 /**
@@ -59,14 +103,22 @@ struct ConnectionStatsPer {
 struct ConnectionPoolStats {
     void updateStatsForHost(std::string pool, HostAndPort host, ConnectionStatsPer newStats);
 
+    /**
+     * Adds the number of times threads waited for a pool's host map, as opposed to for a specific
+     * host's connections, which is reported per host.
+     */
+    void updateHostMapLockContentions(std::string pool, size_t contentions);
+
     void appendToBSON(mongo::BSONObjBuilder& result);
 
     size_t totalInUse = 0u;
     size_t totalAvailable = 0u;
     size_t totalCreated = 0u;
     size_t totalRefreshing = 0u;
+    size_t totalLockContentions = 0u;
 
     stdx::unordered_map<std::string, ConnectionStatsPer> statsByPool;
+    stdx::unordered_map<std::string, size_t> hostMapLockContentionsByPool;
     stdx::unordered_map<HostAndPort, ConnectionStatsPer> statsByHost;
     stdx::unordered_map<std::string, stdx::unordered_map<HostAndPort, ConnectionStatsPer>>
         statsByPoolHost;
@@ -34,6 +34,7 @@
 #include "mongo/executor/connection_pool_test_fixture.h"
 
 #include "mongo/executor/connection_pool.h"
+#include "mongo/executor/connection_pool_stats.h"
 #include "mongo/stdx/future.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
@@ -1308,6 +1309,130 @@ TEST_F(ConnectionPoolTest, RefreshTimeoutsDontTimeoutRequests) {
     ASSERT(!conn2);
 }
 
+/**
+ * Verify that warming up a host spawns minConnections without any requests, and that those
+ * connections then serve requests without a new setup.
+ */
+TEST_F(ConnectionPoolTest, WarmUpSpawnsMinConnections) {
+    ConnectionPool::Options options;
+    options.minConnections = 2;
+    ConnectionPool pool(stdx::make_unique<PoolImpl>(), "test pool", options);
+
+    pool.warmUp(HostAndPort());
+    ASSERT_EQ(ConnectionImpl::setupQueueDepth(), 2u);
+
+    ConnectionImpl::pushSetup(Status::OK());
+    ConnectionImpl::pushSetup(Status::OK());
+    ASSERT_EQ(pool.getNumConnectionsPerHost(HostAndPort()), 2u);
+
+    bool reached = false;
+    pool.get(HostAndPort(),
+             Milliseconds(5000),
+             [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                 ASSERT(swConn.isOK());
+                 reached = true;
+                 doneWith(swConn.getValue());
+             });
+
+    ASSERT(reached);
+    ASSERT_EQ(ConnectionImpl::setupQueueDepth(), 0u);
+
+    // Warming up a host that already has its minimum does nothing
+    pool.warmUp(HostAndPort());
+    ASSERT_EQ(ConnectionImpl::setupQueueDepth(), 0u);
+}
+
+/**
+ * Verify that the time taken to set up connections is reported in the pool stats.
+ */
+TEST_F(ConnectionPoolTest, SetupLatencyIsReported) {
+    ConnectionPool pool(stdx::make_unique<PoolImpl>(), "test pool");
+
+    auto now = Date_t::now();
+    PoolImpl::setNow(now);
+
+    pool.get(HostAndPort(),
+             Milliseconds(5000),
+             [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                 ASSERT(swConn.isOK());
+                 doneWith(swConn.getValue());
+             });
+
+    PoolImpl::setNow(now + Milliseconds(30));
+    ConnectionImpl::pushSetup(Status::OK());
+
+    ConnectionPoolStats stats;
+    pool.appendConnectionStats(&stats);
+
+    // 30ms falls in the [20ms, 50ms) bucket.
+    const auto& counts = stats.statsByHost[HostAndPort()].setupLatency.counts;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        ASSERT_EQ(counts[i], i == 5 ? 1u : 0u);
+    }
+}
+
+/**
+ * Verify that refreshJitter only ever delays a refresh, and by no more than the jitter.
+ */
+TEST_F(ConnectionPoolTest, RefreshJitterDelaysRefresh) {
+    bool refreshed = false;
+    ConnectionImpl::pushRefresh([&]() {
+        refreshed = true;
+        return Status::OK();
+    });
+
+    ConnectionPool::Options options;
+    options.refreshRequirement = Milliseconds(1000);
+    options.refreshJitter = Milliseconds(500);
+    ConnectionPool pool(stdx::make_unique<PoolImpl>(), "test pool", options);
+
+    auto now = Date_t::now();
+    PoolImpl::setNow(now);
+
+    ConnectionImpl::pushSetup(Status::OK());
+    pool.get(HostAndPort(),
+             Milliseconds(5000),
+             [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                 ASSERT(swConn.isOK());
+                 doneWith(swConn.getValue());
+             });
+
+    PoolImpl::setNow(now + Milliseconds(999));
+    ASSERT(!refreshed);
+
+    PoolImpl::setNow(now + Milliseconds(1500));
+    ASSERT(refreshed);
+}
+
+/**
+ * Verify that checked out connections are counted in InUseConnectionsByHost until returned.
+ */
+TEST_F(ConnectionPoolTest, InUseConnectionsByHostCountsCheckedOutConnections) {
+    ConnectionPool pool(stdx::make_unique<PoolImpl>(), "test pool");
+    const HostAndPort host("inUseConnectionsHost", 27017);
+
+    std::vector<ConnectionPool::ConnectionHandle> connections;
+    for (size_t i = 0; i != 2; ++i) {
+        ConnectionImpl::pushSetup(Status::OK());
+        pool.get(host,
+                 Milliseconds(5000),
+                 [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                     ASSERT(swConn.isOK());
+                     connections.push_back(std::move(swConn.getValue()));
+                 });
+    }
+
+    ASSERT_EQ(InUseConnectionsByHost::get(host), 2);
+
+    while (!connections.empty()) {
+        ConnectionPool::ConnectionHandle conn = std::move(connections.back());
+        connections.pop_back();
+        conn->indicateSuccess();
+        conn.reset();
+        ASSERT_EQ(InUseConnectionsByHost::get(host), static_cast<int64_t>(connections.size()));
+    }
+}
+
 }  // namespace connection_pool_test_details
 }  // namespace executor
 }  // namespace mongo
@@ -34,8 +34,10 @@
 
 #include <asio/system_timer.hpp>
 
+#include <set>
 #include <utility>
 
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/executor/async_stream_factory.h"
 #include "mongo/executor/async_stream_interface.h"
 #include "mongo/executor/async_timer_asio.h"
@@ -53,19 +55,40 @@
 #include "mongo/util/net/ssl_manager.h"
 #include "mongo/util/table_formatter.h"
 #include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace executor {
 
 namespace {
-const std::size_t kIOServiceWorkers = 1;
+
+// The running network interfaces, whose reactors are reported in serverStatus.
+stdx::mutex runningInterfacesMutex;
+std::set<NetworkInterfaceASIO*> runningInterfaces;
+
+class NetworkInterfaceASIOReactorsMetric final : public ServerStatusMetric {
+public:
+    NetworkInterfaceASIOReactorsMetric() : ServerStatusMetric(".networkInterfaceASIO") {}
+
+    void appendAtLeaf(BSONObjBuilder& b) const final {
+        BSONArrayBuilder interfaces(b.subarrayStart(_leafName));
+        stdx::lock_guard<stdx::mutex> lk(runningInterfacesMutex);
+        for (auto&& net : runningInterfaces) {
+            BSONObjBuilder interface(interfaces.subobjStart());
+            interface.append("instanceName", net->getInstanceName());
+            BSONArrayBuilder reactors(interface.subarrayStart("reactors"));
+            net->appendReactorStats(&reactors);
+        }
+    }
+} networkInterfaceASIOReactorsMetric;
+
 }  // namespace
 
 NetworkInterfaceASIO::Options::Options() = default;
 
 NetworkInterfaceASIO::NetworkInterfaceASIO(Options options)
     : _options(std::move(options)),
-      _io_service(),
+      _reactors(_makeReactors(_options.numReactors)),
       _metadataHook(std::move(_options.metadataHook)),
       _hook(std::move(_options.networkConnectionHook)),
       _state(State::kReady),
@@ -75,10 +98,15 @@ NetworkInterfaceASIO::NetworkInterfaceASIO(Options options)
                       _options.instanceName,
                       _options.connectionPoolOptions),
       _isExecutorRunnable(false),
-      _strand(_io_service) {
+      _strand(_reactors.front()->ioService) {
     invariant(_timerFactory);
 }
 
+NetworkInterfaceASIO::~NetworkInterfaceASIO() {
+    stdx::lock_guard<stdx::mutex> lk(runningInterfacesMutex);
+    runningInterfaces.erase(this);
+}
+
 std::string NetworkInterfaceASIO::getDiagnosticString() {
     stdx::lock_guard<stdx::mutex> lk(_inProgressMutex);
     return _getDiagnosticString_inlock(nullptr);
@@ -148,20 +176,66 @@ std::string NetworkInterfaceASIO::getHostName() {
     return getHostNameCached();
 }
 
+const std::string& NetworkInterfaceASIO::getInstanceName() const {
+    return _options.instanceName;
+}
+
+void NetworkInterfaceASIO::appendReactorStats(BSONArrayBuilder* builder) const {
+    const long long uptimeMicros = durationCount<Microseconds>(Date_t::now() - _startupTime);
+    for (auto&& reactor : _reactors) {
+        BSONObjBuilder reactorStats(builder->subobjStart());
+        reactorStats.append("handlersRun", static_cast<long long>(reactor->handlersRun.load()));
+        reactorStats.append("busyMicros", static_cast<long long>(reactor->busyMicros.load()));
+        reactorStats.append("uptimeMicros", uptimeMicros);
+    }
+}
+
+std::vector<std::unique_ptr<NetworkInterfaceASIO::Reactor>> NetworkInterfaceASIO::_makeReactors(
+    std::size_t count) {
+    std::vector<std::unique_ptr<Reactor>> reactors;
+    for (std::size_t i = 0; i < std::max(count, std::size_t(1)); ++i) {
+        reactors.push_back(stdx::make_unique<Reactor>());
+    }
+    return reactors;
+}
+
+NetworkInterfaceASIO::Reactor& NetworkInterfaceASIO::_nextReactor() {
+    return *_reactors[_nextReactorIndex.fetchAndAdd(1) % _reactors.size()];
+}
+
+void NetworkInterfaceASIO::_runReactor(Reactor* reactor) {
+    auto& ioService = reactor->ioService;
+    asio::io_service::work work(ioService);
+    std::error_code ec;
+    while (!ioService.stopped()) {
+        // Only the handlers found ready by poll() count as busy time. The one that run_one() waits
+        // for is not timed, so that idle time is never counted, at the cost of slightly
+        // undercounting the busy time of a lightly loaded reactor.
+        Timer timer;
+        const std::size_t ranReady = ioService.poll(ec);
+        if (ranReady) {
+            reactor->busyMicros.fetchAndAdd(timer.micros());
+            reactor->handlersRun.fetchAndAdd(ranReady);
+        }
+        if (!ec) {
+            reactor->handlersRun.fetchAndAdd(ioService.run_one(ec));
+        }
+        if (ec) {
+            severe() << "Failure in the io_service of NetworkInterfaceASIO: " << ec.message();
+            fassertFailed(40335);
+        }
+    }
+}
+
 void NetworkInterfaceASIO::startup() {
-    _serviceRunners.resize(kIOServiceWorkers);
-    for (std::size_t i = 0; i < kIOServiceWorkers; ++i) {
-        _serviceRunners[i] = stdx::thread([this, i]() {
+    _startupTime = Date_t::now();
+    for (std::size_t i = 0; i < _reactors.size(); ++i) {
+        auto reactor = _reactors[i].get();
+        reactor->thread = stdx::thread([this, i, reactor]() {
             setThreadName(_options.instanceName + "-" + std::to_string(i));
             try {
                 LOG(2) << "The NetworkInterfaceASIO worker thread is spinning up";
-                asio::io_service::work work(_io_service);
-                std::error_code ec;
-                _io_service.run(ec);
-                if (ec) {
-                    severe() << "Failure in _io_service.run(): " << ec.message();
-                    fassertFailed(40335);
-                }
+                _runReactor(reactor);
             } catch (...) {
                 severe() << "Uncaught exception in NetworkInterfaceASIO IO "
                             "worker thread of type: "
@@ -171,13 +245,25 @@ void NetworkInterfaceASIO::startup() {
         });
     };
     _state.store(State::kRunning);
+
+    stdx::lock_guard<stdx::mutex> lk(runningInterfacesMutex);
+    runningInterfaces.insert(this);
 }
 
 void NetworkInterfaceASIO::shutdown() {
+    {
+        stdx::lock_guard<stdx::mutex> lk(runningInterfacesMutex);
+        runningInterfaces.erase(this);
+    }
+
     _state.store(State::kShutdown);
-    _io_service.stop();
-    for (auto&& worker : _serviceRunners) {
-        worker.join();
+    for (auto&& reactor : _reactors) {
+        reactor->ioService.stop();
+    }
+    for (auto&& reactor : _reactors) {
+        if (reactor->thread.joinable()) {
+            reactor->thread.join();
+        }
     }
     LOG(2) << "NetworkInterfaceASIO shutdown successfully";
 }
@@ -462,7 +548,8 @@ Status NetworkInterfaceASIO::setAlarm(Date_t when, const stdx::function<void()>&
     try {
         auto timeLeft = when - now();
         // "alarm" must stay alive until it expires, hence the shared_ptr.
-        alarm = std::make_shared<asio::system_timer>(_io_service, timeLeft.toSystemDuration());
+        alarm = std::make_shared<asio::system_timer>(_nextReactor().ioService,
+                                                     timeLeft.toSystemDuration());
     } catch (...) {
         return exceptionToStatus();
     }
@@ -496,9 +583,10 @@ bool NetworkInterfaceASIO::inShutdown() const {
 
 bool NetworkInterfaceASIO::onNetworkThread() {
     auto id = stdx::this_thread::get_id();
-    return std::any_of(_serviceRunners.begin(),
-                       _serviceRunners.end(),
-                       [id](const stdx::thread& thread) { return id == thread.get_id(); });
+    return std::any_of(
+        _reactors.begin(), _reactors.end(), [id](const std::unique_ptr<Reactor>& reactor) {
+            return id == reactor->thread.get_id();
+        });
 }
 
 void NetworkInterfaceASIO::_failWithInfo(const char* file,
@@ -524,5 +612,9 @@ void NetworkInterfaceASIO::dropConnections(const HostAndPort& hostAndPort) {
     _connectionPool.dropConnections(hostAndPort);
 }
 
+void NetworkInterfaceASIO::warmUpConnections(const HostAndPort& hostAndPort) {
+    _connectionPool.warmUp(hostAndPort);
+}
+
 }  // namespace executor
 }  // namespace mongo
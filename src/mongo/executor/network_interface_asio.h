@@ -61,6 +61,8 @@
 
 namespace mongo {
 
+class BSONArrayBuilder;
+
 namespace executor {
 
 namespace connection_pool_asio {
@@ -108,9 +110,14 @@ public:
         std::unique_ptr<NetworkConnectionHook> networkConnectionHook;
         std::unique_ptr<AsyncStreamFactoryInterface> streamFactory;
         std::unique_ptr<rpc::EgressMetadataHook> metadataHook;
+
+        // The number of io_services, each run by its own thread, that the operations and pooled
+        // connections of the interface are spread over.
+        std::size_t numReactors = 1;
     };
 
     NetworkInterfaceASIO(Options = Options());
+    ~NetworkInterfaceASIO();
 
     std::string getDiagnosticString() override;
 
@@ -120,6 +127,15 @@ public:
     uint64_t getNumTimedOutOps();
 
     void appendConnectionStats(ConnectionPoolStats* stats) const override;
+
+    /**
+     * Appends a document per reactor to 'builder', reporting how many handlers the reactor ran
+     * and how long it was busy running them.
+     */
+    void appendReactorStats(BSONArrayBuilder* builder) const;
+
+    const std::string& getInstanceName() const;
+
     std::string getHostName() override;
     void startup() override;
     void shutdown() override;
@@ -138,6 +154,8 @@ public:
 
     void dropConnections(const HostAndPort& hostAndPort) override;
 
+    void warmUpConnections(const HostAndPort& hostAndPort) override;
+
 private:
     using ResponseStatus = TaskExecutor::ResponseStatus;
     using NetworkInterface::RemoteCommandCompletionFn;
@@ -148,6 +166,20 @@ private:
 
     friend class AsyncOp;
 
+    /**
+     * An io_service and the thread that runs it. Every AsyncOp, and so every pooled connection,
+     * stays on the reactor it was created on, which keeps the handlers of a connection on one
+     * thread while the connections are spread over all reactors.
+     */
+    struct Reactor {
+        asio::io_service ioService;
+        stdx::thread thread;
+
+        // Handlers run, and time spent running the ones that were ready without waiting.
+        AtomicUInt64 handlersRun;
+        AtomicUInt64 busyMicros;
+    };
+
     /**
      * AsyncConnection encapsulates the per-connection state we maintain.
      */
@@ -410,6 +442,15 @@ private:
 
     void _startCommand(AsyncOp* op);
 
+    /**
+     * Returns the reactor to place the next AsyncOp or alarm on, going round all reactors.
+     */
+    Reactor& _nextReactor();
+
+    static std::vector<std::unique_ptr<Reactor>> _makeReactors(std::size_t count);
+
+    void _runReactor(Reactor* reactor);
+
     /**
      * Wraps a completion handler in pre-condition checks.
      * When we resume after an asynchronous call, we may find the following:
@@ -465,8 +506,9 @@ private:
 
     Options _options;
 
-    asio::io_service _io_service;
-    std::vector<stdx::thread> _serviceRunners;
+    std::vector<std::unique_ptr<Reactor>> _reactors;
+    AtomicUInt64 _nextReactorIndex;
+    Date_t _startupTime;
 
     const std::unique_ptr<rpc::EgressMetadataHook> _metadataHook;
 
@@ -91,12 +91,12 @@ NetworkInterfaceASIO::AsyncOp::AsyncOp(NetworkInterfaceASIO* const owner,
       _request(request),
       _onFinish(onFinish),
       _start(now),
-      _resolver(owner->_io_service),
+      _resolver(owner->_nextReactor().ioService),
       _id(kAsyncOpIdCounter.addAndFetch(1)),
       _access(std::make_shared<AsyncOp::AccessControl>()),
       _inSetup(true),
       _inRefresh(false),
-      _strand(owner->_io_service) {
+      _strand(_resolver.get_io_service()) {
     // No need to take lock when we aren't yet constructed.
     _transitionToState_inlock(State::kUninitialized);
 }
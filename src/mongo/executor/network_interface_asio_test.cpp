@@ -84,6 +84,7 @@ public:
     void setUp() override {
         initWireSpecMongoD();
         NetworkInterfaceASIO::Options options;
+        options.numReactors = numReactors();
 
         // Use mock timer factory
         auto timerFactory = stdx::make_unique<AsyncTimerFactoryMock>();
@@ -135,6 +136,10 @@ public:
         return *_timerFactory;
     }
 
+    virtual std::size_t numReactors() const {
+        return 1;
+    }
+
     void assertNumOps(uint64_t canceled, uint64_t timedOut, uint64_t failed, uint64_t succeeded) {
         ASSERT_EQ(canceled, net().getNumCanceledOps());
         ASSERT_EQ(timedOut, net().getNumTimedOutOps());
@@ -442,6 +447,52 @@ TEST_F(NetworkInterfaceASIOTest, StartCommand) {
     assertNumOps(0u, 0u, 0u, 1u);
 }
 
+class NetworkInterfaceASIOMultiReactorTest : public NetworkInterfaceASIOTest {
+public:
+    std::size_t numReactors() const override {
+        return 4;
+    }
+};
+
+TEST_F(NetworkInterfaceASIOMultiReactorTest, CommandsToSeveralHosts) {
+    const std::vector<HostAndPort> hosts{{"localhost", 20001}, {"localhost", 20002}};
+    std::vector<Deferred<RemoteCommandResponse>> responses;
+    for (auto&& host : hosts) {
+        RemoteCommandRequest request{host, "testDB", BSON("foo" << 1), BSONObj(), nullptr};
+        responses.push_back(startCommand(makeCallbackHandle(), request));
+    }
+
+    for (auto&& host : hosts) {
+        auto stream = streamFactory().blockUntilStreamExists(host);
+        ConnectEvent{stream}.skip();
+        stream->simulateServer(rpc::Protocol::kOpQuery,
+                               [](RemoteCommandRequest request) -> RemoteCommandResponse {
+                                   return simulateIsMaster(request);
+                               });
+        stream->simulateServer(rpc::Protocol::kOpCommandV1,
+                               [](RemoteCommandRequest request) -> RemoteCommandResponse {
+                                   RemoteCommandResponse response;
+                                   response.data = BSON("ok" << 1.0);
+                                   return response;
+                               });
+    }
+
+    for (auto&& response : responses) {
+        uassertStatusOK(response.get().status);
+    }
+    assertNumOps(0u, 0u, 0u, 2u);
+
+    BSONArrayBuilder reactorStats;
+    net().appendReactorStats(&reactorStats);
+    const BSONObj stats = reactorStats.arr();
+    ASSERT_EQ(4, stats.nFields());
+    long long handlersRun = 0;
+    for (auto&& reactor : stats) {
+        handlersRun += reactor["handlersRun"].numberLong();
+    }
+    ASSERT_GT(handlersRun, 0);
+}
+
 TEST_F(NetworkInterfaceASIOTest, InShutdown) {
     ASSERT_FALSE(net().inShutdown());
     net().shutdown();
@@ -28,6 +28,8 @@
 
 #include "mongo/executor/network_interface_factory.h"
 
+#include <algorithm>
+
 #include "mongo/base/init.h"
 #include "mongo/base/status.h"
 #include "mongo/config.h"
@@ -41,11 +43,28 @@
 #include "mongo/executor/network_interface_asio.h"
 #include "mongo/rpc/metadata/metadata_hook.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/net/ssl_manager.h"
 
 namespace mongo {
 namespace executor {
 
+namespace {
+
+// The number of io_services, each run by its own thread, of every network interface. Zero gives
+// each interface one per core.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(networkInterfaceReactors, int, 1);
+
+std::size_t getNumReactors() {
+    const int reactors = networkInterfaceReactors;
+    if (reactors > 0) {
+        return reactors;
+    }
+    return std::max(1u, stdx::thread::hardware_concurrency());
+}
+
+}  // namespace
+
 std::unique_ptr<NetworkInterface> makeNetworkInterface(std::string instanceName) {
     return makeNetworkInterface(std::move(instanceName), nullptr, nullptr);
 }
@@ -61,6 +80,7 @@ std::unique_ptr<NetworkInterface> makeNetworkInterface(
     options.metadataHook = std::move(metadataHook);
     options.timerFactory = stdx::make_unique<AsyncTimerFactoryASIO>();
     options.connectionPoolOptions = connPoolOptions;
+    options.numReactors = getNumReactors();
 
 #ifdef MONGO_CONFIG_SSL
     if (SSLManagerInterface* manager = getSSLManager()) {
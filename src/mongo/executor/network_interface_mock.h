@@ -127,6 +127,8 @@ public:
 
     void dropConnections(const HostAndPort&) override {}
 
+    void warmUpConnections(const HostAndPort&) override {}
+
 
     ////////////////////////////////////////////////////////////////////////////////
     //
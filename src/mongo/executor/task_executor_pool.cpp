@@ -106,5 +106,12 @@ void TaskExecutorPool::appendConnectionStats(ConnectionPoolStats* stats) const {
     }
 }
 
+void TaskExecutorPool::warmUpConnections(const HostAndPort& hostAndPort) {
+    _fixedExecutor->warmUpConnections(hostAndPort);
+    for (auto&& executor : _executors) {
+        executor->warmUpConnections(hostAndPort);
+    }
+}
+
 }  // namespace executor
 }  // namespace mongo
@@ -34,6 +34,9 @@
 #include "mongo/platform/atomic_word.h"
 
 namespace mongo {
+
+struct HostAndPort;
+
 namespace executor {
 
 struct ConnectionPoolStats;
@@ -111,6 +114,11 @@ public:
      */
     void appendConnectionStats(ConnectionPoolStats* stats) const;
 
+    /**
+     * Warms up connections to the given host on the fixed executor and every pooled executor.
+     */
+    void warmUpConnections(const HostAndPort& hostAndPort);
+
 private:
     AtomicUInt32 _counter;
 
@@ -413,6 +413,10 @@ void ThreadPoolTaskExecutor::appendConnectionStats(ConnectionPoolStats* stats) c
     _net->appendConnectionStats(stats);
 }
 
+void ThreadPoolTaskExecutor::warmUpConnections(const HostAndPort& hostAndPort) {
+    _net->warmUpConnections(hostAndPort);
+}
+
 StatusWith<TaskExecutor::CallbackHandle> ThreadPoolTaskExecutor::enqueueCallbackState_inlock(
     WorkQueue* queue, WorkQueue* wq) {
     if (_inShutdown) {
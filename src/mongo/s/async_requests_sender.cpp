@@ -32,7 +32,15 @@
 
 #include "mongo/s/async_requests_sender.h"
 
+#include <algorithm>
+#include <iterator>
+
+#include "mongo/base/counter.h"
 #include "mongo/client/remote_command_targeter.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/query/killcursors_request.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/s/client/shard_registry.h"
@@ -48,6 +56,135 @@ namespace {
 // Maximum number of retries for network and replication notMaster errors (per host).
 const int kMaxNumFailedHostRetryAttempts = 3;
 
+// Whether reads with a 'nearest' or 'secondaryPreferred' read preference are hedged.
+MONGO_EXPORT_SERVER_PARAMETER(enableHedgedReads, bool, false);
+
+// The percentile of observed response latency after which a hedged request is sent.
+MONGO_EXPORT_SERVER_PARAMETER(hedgedReadsDelayPercentile, int, 95);
+
+// Lower bound on the delay before a hedged request is sent, also used until enough responses have
+// been observed to estimate the latency percentile.
+MONGO_EXPORT_SERVER_PARAMETER(hedgedReadsMinDelayMS, int, 10);
+
+// The commands which are safe to send to two hosts at once.
+const char* const kHedgeableCommands[] = {"find", "count", "distinct"};
+
+Counter64 hedgedReadsSent;
+Counter64 hedgedReadsWon;
+Counter64 hedgedReadsCursorsKilled;
+
+ServerStatusMetricField<Counter64> displayHedgedReadsSent("hedgedReads.sent", &hedgedReadsSent);
+ServerStatusMetricField<Counter64> displayHedgedReadsWon("hedgedReads.won", &hedgedReadsWon);
+ServerStatusMetricField<Counter64> displayHedgedReadsCursorsKilled("hedgedReads.cursorsKilled",
+                                                                   &hedgedReadsCursorsKilled);
+
+/**
+ * Approximates the distribution of successful response latencies with a coarse histogram, from
+ * which the hedging delay is read off as a percentile. Counts are halved every kMaxSamples
+ * samples so the estimate follows changes in latency.
+ */
+class HedgeDelayEstimator {
+public:
+    void record(Milliseconds latency) {
+        const auto bucket =
+            std::upper_bound(std::begin(kBounds), std::end(kBounds), latency.count()) -
+            std::begin(kBounds);
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        ++_counts[bucket];
+        if (++_total < kMaxSamples) {
+            return;
+        }
+
+        _total = 0;
+        for (auto& count : _counts) {
+            count /= 2;
+            _total += count;
+        }
+    }
+
+    Milliseconds delay() const {
+        const int percentile = std::min(std::max(hedgedReadsDelayPercentile.load(), 1), 100);
+        const Milliseconds minDelay(std::max(hedgedReadsMinDelayMS.load(), 0));
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_total < kMinSamples) {
+            return minDelay;
+        }
+
+        const uint64_t target = (_total * percentile + 99) / 100;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kNumBounds; ++i) {
+            seen += _counts[i];
+            if (seen >= target) {
+                return std::max(minDelay, Milliseconds(kBounds[i]));
+            }
+        }
+        return std::max(minDelay, Milliseconds(kBounds[kNumBounds - 1]));
+    }
+
+private:
+    static constexpr size_t kNumBounds = 12;
+    static constexpr long long kBounds[kNumBounds] = {
+        1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000};
+    static constexpr uint64_t kMinSamples = 100;
+    static constexpr uint64_t kMaxSamples = 10000;
+
+    mutable stdx::mutex _mutex;
+
+    // _counts[i] is the number of latencies below kBounds[i] and at or above kBounds[i - 1]. The
+    // last entry counts latencies of kBounds[kNumBounds - 1] and more.
+    uint64_t _counts[kNumBounds + 1] = {};
+    uint64_t _total = 0;
+};
+
+constexpr long long HedgeDelayEstimator::kBounds[];
+
+HedgeDelayEstimator hedgeDelayEstimator;
+
+bool isHedgeable(const ReadPreferenceSetting& readPref, const BSONObj& cmdObj) {
+    if (readPref.pref != ReadPreference::Nearest &&
+        readPref.pref != ReadPreference::SecondaryPreferred) {
+        return false;
+    }
+
+    if (cmdObj["tailable"].trueValue()) {
+        return false;
+    }
+
+    const auto cmdName = cmdObj.firstElementFieldName();
+    return std::any_of(std::begin(kHedgeableCommands),
+                       std::end(kHedgeableCommands),
+                       [&](const char* name) { return str::equals(cmdName, name); });
+}
+
+/**
+ * Makes a good-faith attempt at closing the cursor opened by a request whose response is being
+ * discarded because the same request sent to another host won.
+ */
+void killLosingCursor(executor::TaskExecutor* executor,
+                      const HostAndPort& host,
+                      const executor::RemoteCommandResponse& response) {
+    const auto cursorElem = response.data["cursor"];
+    if (cursorElem.type() != Object) {
+        return;
+    }
+
+    const auto cursorId = cursorElem.Obj()["id"].safeNumberLong();
+    const NamespaceString nss(cursorElem.Obj()["ns"].str());
+    if (!cursorId || !nss.isValid()) {
+        return;
+    }
+
+    executor::RemoteCommandRequest request(
+        host, nss.db().toString(), KillCursorsRequest(nss, {cursorId}).toBSON(), nullptr);
+    auto status = executor->scheduleRemoteCommand(
+        request, [](const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData) {});
+    if (status.isOK()) {
+        hedgedReadsCursorsKilled.increment();
+    }
+}
+
 }  // namespace
 
 AsyncRequestsSender::AsyncRequestsSender(OperationContext* opCtx,
@@ -56,8 +193,10 @@ AsyncRequestsSender::AsyncRequestsSender(OperationContext* opCtx,
                                          const std::vector<AsyncRequestsSender::Request>& requests,
                                          const ReadPreferenceSetting& readPreference)
     : _opCtx(opCtx), _executor(executor), _db(std::move(db)), _readPreference(readPreference) {
+    const bool hedgingEnabled = enableHedgedReads.load();
     for (const auto& request : requests) {
         _remotes.emplace_back(request.shardId, request.cmdObj);
+        _remotes.back().hedgeable = hedgingEnabled && isHedgeable(readPreference, request.cmdObj);
     }
 
     // Initialize command metadata to handle the read preference.
@@ -81,6 +220,11 @@ AsyncRequestsSender::~AsyncRequestsSender() {
     while (!done()) {
         next();
     }
+
+    // Wait for the callbacks of canceled hedge timers and of requests that lost to their hedged
+    // counterpart, which no remote is waiting on anymore.
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _noOutstandingCallbacksCV.wait(lk, [this] { return _outstandingCallbacks == 0; });
 }
 
 AsyncRequestsSender::Response AsyncRequestsSender::next() {
@@ -108,6 +252,27 @@ AsyncRequestsSender::Response AsyncRequestsSender::next() {
     return *readyResponse;
 }
 
+void AsyncRequestsSender::addRequest(const AsyncRequestsSender::Request& request) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    _remotes.emplace_back(request.shardId, request.cmdObj);
+    auto& remote = _remotes.back();
+    remote.hedgeable = enableHedgedReads.load() && isHedgeable(_readPreference, request.cmdObj);
+
+    // Once the operation has been interrupted or the retries were stopped, the request is not sent
+    // at all
+    auto scheduleStatus = !_interruptStatus.isOK()
+        ? _interruptStatus
+        : (_stopRetrying ? Status(ErrorCodes::CallbackCanceled, "request was not scheduled")
+                         : _scheduleRequest_inlock(_remotes.size() - 1));
+    if (!scheduleStatus.isOK()) {
+        _remotes.back().swResponse = std::move(scheduleStatus);
+        if (!*_notification) {
+            _notification->set();
+        }
+    }
+}
+
 void AsyncRequestsSender::stopRetrying() {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     _stopRetrying = true;
@@ -124,10 +289,12 @@ void AsyncRequestsSender::_cancelPendingRequests() {
     _stopRetrying = true;
 
     // Cancel all outstanding requests so they return immediately.
-    for (auto& remote : _remotes) {
+    for (size_t i = 0; i < _remotes.size(); ++i) {
+        auto& remote = _remotes[i];
         if (remote.cbHandle.isValid()) {
             _executor->cancel(remote.cbHandle);
         }
+        _cancelHedge_inlock(i);
     }
 }
 
@@ -237,29 +404,155 @@ Status AsyncRequestsSender::_scheduleRequest_inlock(size_t remoteIndex) {
 
     auto callbackStatus = _executor->scheduleRemoteCommand(
         request,
-        stdx::bind(
-            &AsyncRequestsSender::_handleResponse, this, stdx::placeholders::_1, remoteIndex));
+        [this, remoteIndex](const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData) {
+            _handleResponse(cbData, remoteIndex, false);
+        });
     if (!callbackStatus.isOK()) {
         return callbackStatus.getStatus();
     }
 
     remote.cbHandle = callbackStatus.getValue();
+    remote.sentAt = Date_t::now();
+    ++_outstandingCallbacks;
+
+    if (!remote.hedgeable) {
+        return Status::OK();
+    }
+
+    invariant(!remote.hedgeTimerHandle.isValid());
+    auto timerStatus = _executor->scheduleWorkAt(
+        remote.sentAt + hedgeDelayEstimator.delay(),
+        stdx::bind(
+            &AsyncRequestsSender::_sendHedgedRequest, this, stdx::placeholders::_1, remoteIndex));
+    if (timerStatus.isOK()) {
+        remote.hedgeTimerHandle = timerStatus.getValue();
+        ++_outstandingCallbacks;
+    }
+
+    // Failing to schedule the hedge does not affect the original request.
     return Status::OK();
 }
 
+void AsyncRequestsSender::_cancelHedge_inlock(size_t remoteIndex) {
+    auto& remote = _remotes[remoteIndex];
+
+    if (remote.hedgeTimerHandle.isValid()) {
+        _executor->cancel(remote.hedgeTimerHandle);
+        remote.hedgeTimerHandle = executor::TaskExecutor::CallbackHandle();
+    }
+
+    if (remote.hedgeCbHandle.isValid()) {
+        _executor->cancel(remote.hedgeCbHandle);
+        remote.hedgeCbHandle = executor::TaskExecutor::CallbackHandle();
+    }
+
+    remote.hedgeHostAndPort.reset();
+}
+
+void AsyncRequestsSender::_sendHedgedRequest(const executor::TaskExecutor::CallbackArgs& cbData,
+                                             size_t remoteIndex) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    ON_BLOCK_EXIT([&] { _callbackDone_inlock(); });
+
+    auto& remote = _remotes[remoteIndex];
+
+    // A timer which was canceled, or superseded by a retry, is no longer current.
+    if (cbData.myHandle != remote.hedgeTimerHandle) {
+        return;
+    }
+    remote.hedgeTimerHandle = executor::TaskExecutor::CallbackHandle();
+
+    if (!cbData.status.isOK() || _stopRetrying || remote.swResponse ||
+        !remote.cbHandle.isValid()) {
+        return;
+    }
+
+    auto shard = remote.getShard();
+    if (!shard) {
+        return;
+    }
+
+    auto swHedgeHost =
+        shard->getTargeter()->findHedgeHost(_readPreference, *remote.shardHostAndPort);
+    if (!swHedgeHost.isOK()) {
+        LOG(2) << "Not hedging command to remote " << remote.shardId
+               << causedBy(swHedgeHost.getStatus());
+        return;
+    }
+
+    executor::RemoteCommandRequest request(
+        swHedgeHost.getValue(), _db, remote.cmdObj, _metadataObj, _opCtx);
+
+    auto callbackStatus = _executor->scheduleRemoteCommand(
+        request,
+        [this, remoteIndex](const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData) {
+            _handleResponse(cbData, remoteIndex, true);
+        });
+    if (!callbackStatus.isOK()) {
+        return;
+    }
+
+    LOG(1) << "Hedging command to remote " << remote.shardId << " at host "
+           << *remote.shardHostAndPort << " with host " << swHedgeHost.getValue();
+
+    remote.hedgeHostAndPort = std::move(swHedgeHost.getValue());
+    remote.hedgeCbHandle = callbackStatus.getValue();
+    ++_outstandingCallbacks;
+    hedgedReadsSent.increment();
+}
+
 void AsyncRequestsSender::_handleResponse(
-    const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData, size_t remoteIndex) {
+    const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData,
+    size_t remoteIndex,
+    bool hedged) {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
+    ON_BLOCK_EXIT([&] { _callbackDone_inlock(); });
 
     auto& remote = _remotes[remoteIndex];
+    auto& cbHandle = hedged ? remote.hedgeCbHandle : remote.cbHandle;
+
+    // The handle is cleared as soon as the other of the two requests has won, so a request whose
+    // handle is no longer current has lost.
+    if (cbData.myHandle != cbHandle) {
+        if (cbData.response.isOK()) {
+            killLosingCursor(_executor, cbData.request.target, cbData.response);
+        }
+        return;
+    }
+
     invariant(!remote.swResponse);
 
     // Clear the callback handle. This indicates that we are no longer waiting on a response from
     // 'remote'.
-    remote.cbHandle = executor::TaskExecutor::CallbackHandle();
+    cbHandle = executor::TaskExecutor::CallbackHandle();
+
+    if (hedged) {
+        // A failed hedged request leaves the original one to report the outcome.
+        auto status = cbData.response.status;
+        if (status.isOK()) {
+            status = getStatusFromCommandResult(cbData.response.data);
+        }
+        if (!status.isOK()) {
+            remote.hedgeHostAndPort.reset();
+            return;
+        }
+
+        hedgedReadsWon.increment();
+        remote.shardHostAndPort = std::move(remote.hedgeHostAndPort);
+        remote.hedgeHostAndPort.reset();
+
+        _executor->cancel(remote.cbHandle);
+        remote.cbHandle = executor::TaskExecutor::CallbackHandle();
+    }
+
+    _cancelHedge_inlock(remoteIndex);
 
     // Store the response or error.
     if (cbData.response.status.isOK()) {
+        if (remote.hedgeable) {
+            hedgeDelayEstimator.record(
+                duration_cast<Milliseconds>(Date_t::now() - remote.sentAt));
+        }
         remote.swResponse = std::move(cbData.response);
     } else {
         remote.swResponse = std::move(cbData.response.status);
@@ -271,6 +564,13 @@ void AsyncRequestsSender::_handleResponse(
     }
 }
 
+void AsyncRequestsSender::_callbackDone_inlock() {
+    invariant(_outstandingCallbacks > 0);
+    if (--_outstandingCallbacks == 0) {
+        _noOutstandingCallbacksCV.notify_all();
+    }
+}
+
 AsyncRequestsSender::Request::Request(ShardId shardId, BSONObj cmdObj)
     : shardId(shardId), cmdObj(cmdObj) {}
 
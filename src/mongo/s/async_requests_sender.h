@@ -39,6 +39,7 @@
 #include "mongo/executor/task_executor.h"
 #include "mongo/s/client/shard.h"
 #include "mongo/s/shard_id.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/notification.h"
 #include "mongo/util/net/hostandport.h"
@@ -77,6 +78,12 @@ namespace mongo {
  *     }
  * }
  *
+ * Reads with a 'nearest' or 'secondaryPreferred' read preference may be hedged when the
+ * enableHedgedReads server parameter is set: if a remote has not answered within a delay derived
+ * from the observed response latency percentile, the same command is also sent to another
+ * eligible host of that shard. The first successful reply is returned and the other request is
+ * canceled, with killCursors sent for any cursor it still managed to open.
+ *
  * Does not throw exceptions.
  */
 class AsyncRequestsSender {
@@ -150,6 +157,16 @@ public:
      */
     Response next();
 
+    /**
+     * Schedules an additional request, whose response will be returned by next() like the ones of
+     * the requests the ARS was constructed with. Allows the caller to send the next request to a
+     * remote as soon as the response to its previous one has been processed, without waiting for
+     * the other remotes.
+     *
+     * Note: Must only be called from the same thread as next().
+     */
+    void addRequest(const AsyncRequestsSender::Request& request);
+
     /**
      * Stops the ARS from retrying requests.
      *
@@ -198,6 +215,22 @@ private:
         // The callback handle to an outstanding request for this remote.
         executor::TaskExecutor::CallbackHandle cbHandle;
 
+        // Whether a hedged duplicate of the command may be sent to a second host.
+        bool hedgeable = false;
+
+        // The host to which a hedged duplicate of the command was sent. Is unset unless a hedged
+        // request is outstanding or has won.
+        boost::optional<HostAndPort> hedgeHostAndPort;
+
+        // The callback handle to an outstanding hedged request for this remote.
+        executor::TaskExecutor::CallbackHandle hedgeCbHandle;
+
+        // The callback handle to the timer which sends the hedged request.
+        executor::TaskExecutor::CallbackHandle hedgeTimerHandle;
+
+        // When the outstanding request was sent.
+        Date_t sentAt;
+
         // Whether this remote's result has been returned.
         bool done = false;
     };
@@ -238,16 +271,39 @@ private:
      */
     Status _scheduleRequest_inlock(size_t remoteIndex);
 
+    /**
+     * Cancels the outstanding hedged request and hedge timer, if any, of the remote at
+     * 'remoteIndex'. Their callbacks will still run, but are no longer recognized as current.
+     */
+    void _cancelHedge_inlock(size_t remoteIndex);
+
+    /**
+     * The callback for the hedge timer of a remote. If the remote is still waiting on its
+     * original request, sends a duplicate of the command to a second eligible host.
+     */
+    void _sendHedgedRequest(const executor::TaskExecutor::CallbackArgs& cbData,
+                            size_t remoteIndex);
+
     /**
      * The callback for a remote command.
      *
      * 'remoteIndex' is the position of the relevant remote node in '_remotes', and therefore
      * indicates which node the response came from and where the response should be buffered.
+     * 'hedged' is true if the response is to the hedged duplicate of the command.
      *
-     * Stores the response or error in the remote and signals the notification.
+     * Stores the response or error in the remote and signals the notification. The response of a
+     * request which lost to its hedged counterpart is discarded instead, after scheduling
+     * killCursors for any cursor it opened.
      */
     void _handleResponse(const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData,
-                         size_t remoteIndex);
+                         size_t remoteIndex,
+                         bool hedged);
+
+    /**
+     * Must be called at the end of every callback scheduled by the ARS. Wakes up the destructor
+     * once no callbacks are outstanding.
+     */
+    void _callbackDone_inlock();
 
     OperationContext* _opCtx;
 
@@ -278,6 +334,12 @@ private:
     // Data tracking the state of our communication with each of the remote nodes.
     std::vector<RemoteData> _remotes;
 
+    // The number of scheduled callbacks which have not run yet, including those of canceled hedge
+    // timers and of requests which lost to their hedged counterpart. The destructor waits on
+    // _noOutstandingCallbacksCV for this to drop to zero.
+    size_t _outstandingCallbacks = 0;
+    stdx::condition_variable _noOutstandingCallbacksCV;
+
     // A notification that gets signaled when a remote is ready for processing (i.e., we failed to
     // schedule a request to it or received a response from it).
     boost::optional<Notification<void>> _notification;
@@ -51,6 +51,7 @@
 #include "mongo/db/repl/optime.h"
 #include "mongo/db/repl/read_concern_args.h"
 #include "mongo/db/s/type_shard_identity.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/executor/network_interface.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/rpc/get_status_from_command_result.h"
@@ -99,6 +100,9 @@ namespace {
 const ReadPreferenceSetting kConfigReadSelector(ReadPreference::Nearest, TagSet{});
 const ReadPreferenceSetting kConfigPrimaryPreferredSelector(ReadPreference::PrimaryPreferred,
                                                             TagSet{});
+const ReadPreferenceSetting kConfigSecondaryPreferredSelector(ReadPreference::SecondaryPreferred,
+                                                              TagSet{});
+
 const int kMaxReadRetry = 3;
 const int kMaxWriteRetry = 3;
 
@@ -110,6 +114,17 @@ const int kChangeLogCollectionSizeMB = 10 * 1024 * 1024;
 
 const NamespaceString kSettingsNamespace("config", "settings");
 
+// Whether the reads of the routing table (config.collections and config.chunks) should prefer the
+// config server secondaries, so that mass refreshes of the routing information (for example after
+// a restart of all routers) are not all served by the config primary. These reads are causally
+// consistent regardless, because they always wait for the last known config opTime.
+MONGO_EXPORT_SERVER_PARAMETER(routingTableReadsPreferSecondaries, bool, true);
+
+const ReadPreferenceSetting& getRoutingTableReadSelector() {
+    return routingTableReadsPreferSecondaries.load() ? kConfigSecondaryPreferredSelector
+                                                     : kConfigReadSelector;
+}
+
 void toBatchError(const Status& status, BatchedCommandResponse* response) {
     response->clear();
     response->setErrCode(status.code());
@@ -190,6 +205,41 @@ StatusWith<ChunkVersion> createFirstChunks(OperationContext* opCtx,
     log() << "going to create " << splitPoints.size() + 1 << " chunk(s) for: " << nss
           << " using new epoch " << version.epoch();
 
+    // The chunk documents are written in batches, since there may be thousands of them when
+    // pre-splitting a hashed shard key. No chunks exist for the namespace at this point, so a
+    // failed batch leaves behind chunks which will be detected by the next shardCollection.
+    std::vector<BSONObj> chunkDocs;
+    int chunkDocsSize = 0;
+
+    const auto insertChunkDocs = [&]() -> Status {
+        auto insert(stdx::make_unique<BatchedInsertRequest>());
+        insert->setOrdered(true);
+        for (const auto& chunkDoc : chunkDocs) {
+            insert->addToDocuments(chunkDoc);
+        }
+
+        BatchedCommandRequest request(insert.release());
+        request.setNS(NamespaceString(ChunkType::ConfigNS));
+        request.setWriteConcern(ShardingCatalogClient::kMajorityWriteConcern.toBSON());
+
+        auto configShard = Grid::get(opCtx)->shardRegistry()->getConfigShard();
+        auto response = configShard->runBatchWriteCommand(opCtx,
+                                                          Shard::kDefaultConfigCommandTimeout,
+                                                          request,
+                                                          Shard::RetryPolicy::kNotIdempotent);
+
+        Status status = response.toStatus();
+        if (!status.isOK()) {
+            return {status.code(),
+                    str::stream() << "Creating first chunks failed due to "
+                                  << redact(status.reason())};
+        }
+
+        chunkDocs.clear();
+        chunkDocsSize = 0;
+        return Status::OK();
+    };
+
     for (unsigned i = 0; i <= splitPoints.size(); i++) {
         const BSONObj min = (i == 0) ? keyPattern.globalMin() : splitPoints[i - 1];
         const BSONObj max = (i < splitPoints.size()) ? splitPoints[i] : keyPattern.globalMax();
@@ -207,16 +257,23 @@ StatusWith<ChunkVersion> createFirstChunks(OperationContext* opCtx,
         chunk.setShard(shardIds[i % shardIds.size()]);
         chunk.setVersion(version);
 
-        Status status = Grid::get(opCtx)->catalogClient(opCtx)->insertConfigDocument(
-            opCtx,
-            ChunkType::ConfigNS,
-            chunk.toConfigBSON(),
-            ShardingCatalogClient::kMajorityWriteConcern);
-        if (!status.isOK()) {
-            return {status.code(),
-                    str::stream() << "Creating first chunks failed due to "
-                                  << redact(status.reason())};
+        BSONObj chunkObj = chunk.toConfigBSON();
+        if (!chunkDocs.empty() &&
+            (chunkDocs.size() >= BatchedCommandRequest::kMaxWriteBatchSize ||
+             chunkDocsSize + chunkObj.objsize() > BSONObjMaxUserSize)) {
+            Status status = insertChunkDocs();
+            if (!status.isOK()) {
+                return status;
+            }
         }
+
+        chunkDocsSize += chunkObj.objsize();
+        chunkDocs.push_back(std::move(chunkObj));
+    }
+
+    Status status = insertChunkDocs();
+    if (!status.isOK()) {
+        return status;
     }
 
     return version;
@@ -836,7 +893,7 @@ StatusWith<repl::OpTimeWith<DatabaseType>> ShardingCatalogClientImpl::_fetchData
 StatusWith<repl::OpTimeWith<CollectionType>> ShardingCatalogClientImpl::getCollection(
     OperationContext* opCtx, const std::string& collNs) {
     auto statusFind = _exhaustiveFindOnConfig(opCtx,
-                                              kConfigReadSelector,
+                                              getRoutingTableReadSelector(),
                                               repl::ReadConcernLevel::kMajorityReadConcern,
                                               NamespaceString(CollectionType::ConfigNS),
                                               BSON(CollectionType::fullNs(collNs)),
@@ -881,7 +938,7 @@ Status ShardingCatalogClientImpl::getCollections(OperationContext* opCtx,
     }
 
     auto findStatus = _exhaustiveFindOnConfig(opCtx,
-                                              kConfigReadSelector,
+                                              getRoutingTableReadSelector(),
                                               repl::ReadConcernLevel::kMajorityReadConcern,
                                               NamespaceString(CollectionType::ConfigNS),
                                               b.obj(),
@@ -1218,7 +1275,7 @@ Status ShardingCatalogClientImpl::getChunks(OperationContext* opCtx,
     // Convert boost::optional<int> to boost::optional<long long>.
     auto longLimit = limit ? boost::optional<long long>(*limit) : boost::none;
     auto findStatus = _exhaustiveFindOnConfig(opCtx,
-                                              kConfigReadSelector,
+                                              getRoutingTableReadSelector(),
                                               readConcern,
                                               NamespaceString(ChunkType::ConfigNS),
                                               query,
@@ -110,11 +110,12 @@ public:
         });
     }
 
-    // Intercepts network request to upsert a new chunk definition to the config.chunks collection.
-    // Since the catalog manager cannot predict the epoch that will be assigned the new chunk,
-    // returns the chunk version that is sent in the upsert.
-    ChunkVersion expectCreateChunk(const ChunkType& expectedChunk) {
-        ChunkVersion actualVersion;
+    // Intercepts network request to insert the new chunk definitions to the config.chunks
+    // collection, which are expected to be sent as a single batch. Since the catalog manager
+    // cannot predict the epoch that will be assigned the new chunks, returns the chunk versions
+    // that are sent in the insert.
+    std::vector<ChunkVersion> expectCreateChunks(const std::vector<ChunkType>& expectedChunks) {
+        std::vector<ChunkVersion> actualVersions;
 
         onCommand([&](const RemoteCommandRequest& request) {
             ASSERT_EQUALS(configHost, request.target);
@@ -128,30 +129,39 @@ public:
             ASSERT_TRUE(actualBatchedInsert.parseBSON(request.dbname, request.cmdObj, &errmsg));
             ASSERT_EQUALS(ChunkType::ConfigNS, actualBatchedInsert.getNS().ns());
             auto inserts = actualBatchedInsert.getDocuments();
-            ASSERT_EQUALS(1U, inserts.size());
-
-            BSONObj chunkObj = inserts.front();
-            ASSERT_EQUALS(expectedChunk.getName(), chunkObj["_id"].String());
-            ASSERT_EQUALS(Timestamp(expectedChunk.getVersion().toLong()),
-                          chunkObj[ChunkType::DEPRECATED_lastmod()].timestamp());
-            // Can't check the chunk version's epoch b/c they won't match since it's a randomly
-            // generated OID so just check that the field exists and is *a* OID.
-            ASSERT_EQUALS(jstOID, chunkObj[ChunkType::DEPRECATED_epoch()].type());
-            ASSERT_EQUALS(expectedChunk.getNS(), chunkObj[ChunkType::ns()].String());
-            ASSERT_BSONOBJ_EQ(expectedChunk.getMin(), chunkObj[ChunkType::min()].Obj());
-            ASSERT_BSONOBJ_EQ(expectedChunk.getMax(), chunkObj[ChunkType::max()].Obj());
-            ASSERT_EQUALS(expectedChunk.getShard(), chunkObj[ChunkType::shard()].String());
-
-            actualVersion = ChunkVersion::fromBSON(chunkObj);
+            ASSERT_EQUALS(expectedChunks.size(), inserts.size());
+
+            for (size_t i = 0; i < expectedChunks.size(); i++) {
+                const auto& expectedChunk = expectedChunks[i];
+                const BSONObj& chunkObj = inserts[i];
+
+                ASSERT_EQUALS(expectedChunk.getName(), chunkObj["_id"].String());
+                ASSERT_EQUALS(Timestamp(expectedChunk.getVersion().toLong()),
+                              chunkObj[ChunkType::DEPRECATED_lastmod()].timestamp());
+                // Can't check the chunk version's epoch b/c they won't match since it's a
+                // randomly generated OID so just check that the field exists and is *a* OID.
+                ASSERT_EQUALS(jstOID, chunkObj[ChunkType::DEPRECATED_epoch()].type());
+                ASSERT_EQUALS(expectedChunk.getNS(), chunkObj[ChunkType::ns()].String());
+                ASSERT_BSONOBJ_EQ(expectedChunk.getMin(), chunkObj[ChunkType::min()].Obj());
+                ASSERT_BSONOBJ_EQ(expectedChunk.getMax(), chunkObj[ChunkType::max()].Obj());
+                ASSERT_EQUALS(expectedChunk.getShard(), chunkObj[ChunkType::shard()].String());
+
+                actualVersions.push_back(ChunkVersion::fromBSON(chunkObj));
+            }
 
             BatchedCommandResponse response;
             response.setOk(true);
-            response.setNModified(1);
+            response.setN(inserts.size());
 
             return response.toBSON();
         });
 
-        return actualVersion;
+        return actualVersions;
+    }
+
+    // Same as above, for the case where a single chunk is expected to be created.
+    ChunkVersion expectCreateChunk(const ChunkType& expectedChunk) {
+        return expectCreateChunks({expectedChunk}).front();
     }
 
     void expectUpdateCollection(const CollectionType& expectedCollection) {
@@ -548,14 +558,14 @@ TEST_F(ShardCollectionTest, withInitialChunks) {
             configHost, network()->now(), "shardCollection.start", ns, logChangeDetail);
     }
 
-    for (auto& expectedChunk : expectedChunks) {
-        // Handle the write to create the initial chunk.
-        ChunkVersion actualVersion = expectCreateChunk(expectedChunk);
+    // Handle the write to create the initial chunks, which all fit in a single batch
+    const auto actualVersions = expectCreateChunks(expectedChunks);
 
-        // Since the generated epoch OID will not match the one we initialized expectedChunk with
-        // update the stored version in expectedChunk so that it matches what was actually
-        // written, to avoid problems relating to non-matching epochs down the road.
-        expectedChunk.setVersion(actualVersion);
+    // Since the generated epoch OID will not match the one we initialized the expected chunks with
+    // update the stored versions so that they match what was actually written, to avoid problems
+    // relating to non-matching epochs down the road.
+    for (size_t i = 0; i < expectedChunks.size(); i++) {
+        expectedChunks[i].setVersion(actualVersions[i]);
     }
 
     CollectionType expectedCollection;
@@ -76,63 +76,20 @@ std::shared_ptr<ChunkManager> refreshCollectionRoutingInfo(
 
     const auto collectionAndChunks = uassertStatusOK(std::move(swCollectionAndChangedChunks));
 
-    // Check whether the collection epoch might have changed
-    ChunkVersion startingCollectionVersion;
-    ChunkMap chunkMap =
-        SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<std::shared_ptr<Chunk>>();
-
-    if (!existingRoutingInfo) {
-        // If we don't have a basis chunk manager, do a full refresh
-        startingCollectionVersion = ChunkVersion(0, 0, collectionAndChunks.epoch);
-    } else if (existingRoutingInfo->getVersion().epoch() != collectionAndChunks.epoch) {
-        // If the collection's epoch has changed, do a full refresh
-        startingCollectionVersion = ChunkVersion(0, 0, collectionAndChunks.epoch);
-    } else {
-        startingCollectionVersion = existingRoutingInfo->getVersion();
-        chunkMap = existingRoutingInfo->chunkMap();
-    }
-
-    ChunkVersion collectionVersion = startingCollectionVersion;
-
+    // Ensure all chunks reference valid shards and that the shards are available and loaded
     for (const auto& chunk : collectionAndChunks.changedChunks) {
-        const auto& chunkVersion = chunk.getVersion();
-
-        uassert(ErrorCodes::ConflictingOperationInProgress,
-                str::stream() << "Chunk " << chunk.genID(nss.ns(), chunk.getMin())
-                              << " has epoch different from that of the collection "
-                              << chunkVersion.epoch(),
-                collectionVersion.epoch() == chunkVersion.epoch());
-
-        // Chunks must always come in incrementally sorted order
-        invariant(chunkVersion >= collectionVersion);
-        collectionVersion = chunkVersion;
-
-        // Ensure chunk references a valid shard and that the shard is available and loaded
         uassertStatusOK(Grid::get(opCtx)->shardRegistry()->getShard(opCtx, chunk.getShard()));
+    }
 
-        // Returns the first chunk with a max key that is > min - implies that the chunk overlaps
-        // min
-        const auto low = chunkMap.upper_bound(chunk.getMin());
-
-        // Returns the first chunk with a max key that is > max - implies that the next chunk cannot
-        // not overlap max
-        const auto high = chunkMap.upper_bound(chunk.getMax());
-
-        // Erase all chunks from the map, which overlap the chunk we got from the persistent store
-        chunkMap.erase(low, high);
-
-        // Insert only the chunk itself
-        chunkMap.insert(std::make_pair(chunk.getMax(), std::make_shared<Chunk>(chunk)));
+    // If the collection's epoch has not changed, patch the changed chunks into the existing
+    // routing table
+    if (existingRoutingInfo &&
+        existingRoutingInfo->getVersion().epoch() == collectionAndChunks.epoch) {
+        return existingRoutingInfo->makeUpdated(collectionAndChunks.changedChunks);
     }
 
-    // If at least one diff was applied, the metadata is correct, but it might not have changed so
-    // in this case there is no need to recreate the chunk manager.
-    //
-    // NOTE: In addition to the above statement, it is also important that we return the same chunk
-    // manager object, because the write commands' code relies on changes of the chunk manager's
-    // sequence number to detect batch writes not making progress because of chunks moving across
-    // shards too frequently.
-    if (collectionVersion == startingCollectionVersion) {
+    // Otherwise do a full refresh, unless there is nothing to build the routing table from
+    if (collectionAndChunks.changedChunks.empty()) {
         return existingRoutingInfo;
     }
 
@@ -143,12 +100,12 @@ std::shared_ptr<ChunkManager> refreshCollectionRoutingInfo(
                                               ->makeFromBSON(collectionAndChunks.defaultCollation));
     }
 
-    return stdx::make_unique<ChunkManager>(nss,
-                                           KeyPattern(collectionAndChunks.shardKeyPattern),
-                                           std::move(defaultCollator),
-                                           collectionAndChunks.shardKeyIsUnique,
-                                           std::move(chunkMap),
-                                           collectionVersion);
+    return ChunkManager::makeNew(nss,
+                                 KeyPattern(collectionAndChunks.shardKeyPattern),
+                                 std::move(defaultCollator),
+                                 collectionAndChunks.shardKeyIsUnique,
+                                 collectionAndChunks.epoch,
+                                 collectionAndChunks.changedChunks);
 }
 
 }  // namespace
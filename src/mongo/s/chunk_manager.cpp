@@ -77,6 +77,90 @@ ChunkManager::ChunkManager(NamespaceString nss,
 
 ChunkManager::~ChunkManager() = default;
 
+std::shared_ptr<ChunkManager> ChunkManager::makeNew(
+    NamespaceString nss,
+    KeyPattern shardKeyPattern,
+    std::unique_ptr<CollatorInterface> defaultCollator,
+    bool unique,
+    OID epoch,
+    const std::vector<ChunkType>& chunks) {
+    ChunkMap chunkMap;
+    const auto collectionVersion =
+        _applyChangedChunks(nss, ChunkVersion(0, 0, epoch), chunks, &chunkMap);
+
+    return std::make_shared<ChunkManager>(std::move(nss),
+                                          std::move(shardKeyPattern),
+                                          std::move(defaultCollator),
+                                          unique,
+                                          std::move(chunkMap),
+                                          collectionVersion);
+}
+
+std::shared_ptr<ChunkManager> ChunkManager::makeUpdated(
+    const std::vector<ChunkType>& changedChunks) {
+    // Copying the map only copies pointers to the chunks. Only the changed chunks are allocated.
+    ChunkMap chunkMap = _chunkMap;
+    const auto collectionVersion =
+        _applyChangedChunks(_nss, _collectionVersion, changedChunks, &chunkMap);
+
+    // If at least one diff was applied, the metadata is correct, but it might not have changed so
+    // in this case there is no need to recreate the chunk manager.
+    //
+    // NOTE: In addition to the above statement, it is also important that we return the same chunk
+    // manager object, because the write commands' code relies on changes of the chunk manager's
+    // sequence number to detect batch writes not making progress because of chunks moving across
+    // shards too frequently.
+    if (collectionVersion == _collectionVersion) {
+        return shared_from_this();
+    }
+
+    return std::make_shared<ChunkManager>(_nss,
+                                          KeyPattern(_shardKeyPattern.getKeyPattern()),
+                                          _defaultCollator ? _defaultCollator->clone() : nullptr,
+                                          _unique,
+                                          std::move(chunkMap),
+                                          collectionVersion);
+}
+
+ChunkVersion ChunkManager::_applyChangedChunks(const NamespaceString& nss,
+                                               ChunkVersion startingVersion,
+                                               const std::vector<ChunkType>& changedChunks,
+                                               ChunkMap* chunkMap) {
+    ChunkVersion collectionVersion = startingVersion;
+
+    for (const auto& chunk : changedChunks) {
+        const auto& chunkVersion = chunk.getVersion();
+
+        uassert(ErrorCodes::ConflictingOperationInProgress,
+                str::stream() << "Chunk " << chunk.genID(nss.ns(), chunk.getMin())
+                              << " has epoch different from that of the collection "
+                              << chunkVersion.epoch(),
+                collectionVersion.epoch() == chunkVersion.epoch());
+
+        // Chunks must always come in incrementally sorted order
+        invariant(chunkVersion >= collectionVersion);
+        collectionVersion = chunkVersion;
+
+        const auto chunkMaxKeyString = ShardKeyPattern::toKeyString(chunk.getMax());
+
+        // Returns the first chunk with a max key that is > min - implies that the chunk overlaps
+        // min
+        const auto low = chunkMap->upper_bound(ShardKeyPattern::toKeyString(chunk.getMin()));
+
+        // Returns the first chunk with a max key that is > max - implies that the next chunk cannot
+        // not overlap max
+        const auto high = chunkMap->upper_bound(chunkMaxKeyString);
+
+        // Erase all chunks from the map, which overlap the chunk we got from the persistent store
+        chunkMap->erase(low, high);
+
+        // Insert only the chunk itself
+        chunkMap->insert(std::make_pair(chunkMaxKeyString, std::make_shared<Chunk>(chunk)));
+    }
+
+    return collectionVersion;
+}
+
 std::shared_ptr<Chunk> ChunkManager::findIntersectingChunk(const BSONObj& shardKey,
                                                            const BSONObj& collation) const {
     const bool hasSimpleCollation = (collation.isEmpty() && !_defaultCollator) ||
@@ -90,7 +174,7 @@ std::shared_ptr<Chunk> ChunkManager::findIntersectingChunk(const BSONObj& shardK
         }
     }
 
-    const auto it = _chunkMap.upper_bound(shardKey);
+    const auto it = _chunkMap.upper_bound(ShardKeyPattern::toKeyString(shardKey));
     uassert(ErrorCodes::ShardKeyNotFound,
             str::stream() << "Cannot target single shard using key " << shardKey,
             it != _chunkMap.end() && it->second->containsKey(shardKey));
@@ -107,6 +191,19 @@ void ChunkManager::getShardIdsForQuery(OperationContext* opCtx,
                                        const BSONObj& query,
                                        const BSONObj& collation,
                                        std::set<ShardId>* shardIds) const {
+    // Fast path for targeting simple equality queries on the shard key, which does not need the
+    // query to be canonicalized.
+    auto simpleShardKeyToFind = _shardKeyPattern.extractShardKeyFromSimpleEqualityQuery(query);
+    if (!simpleShardKeyToFind.isEmpty()) {
+        try {
+            auto chunk = findIntersectingChunk(simpleShardKeyToFind, collation);
+            shardIds->insert(chunk->getShardId());
+            return;
+        } catch (const DBException&) {
+            // The collation does not allow targeting a single shard
+        }
+    }
+
     auto qr = stdx::make_unique<QueryRequest>(_nss);
     qr->setFilter(query);
 
@@ -171,8 +268,8 @@ void ChunkManager::getShardIdsForQuery(OperationContext* opCtx,
 void ChunkManager::getShardIdsForRange(const BSONObj& min,
                                        const BSONObj& max,
                                        std::set<ShardId>* shardIds) const {
-    auto it = _chunkMapViews.chunkRangeMap.upper_bound(min);
-    auto end = _chunkMapViews.chunkRangeMap.upper_bound(max);
+    auto it = _chunkMapViews.chunkRangeMap.upper_bound(ShardKeyPattern::toKeyString(min));
+    auto end = _chunkMapViews.chunkRangeMap.upper_bound(ShardKeyPattern::toKeyString(max));
 
     // The chunk range map must always cover the entire key space
     invariant(it != _chunkMapViews.chunkRangeMap.end());
@@ -344,8 +441,7 @@ ChunkManager::ChunkMapViews ChunkManager::_constructChunkMapViews(const OID& epo
                                                                   const ChunkMap& chunkMap) {
     invariant(!chunkMap.empty());
 
-    ChunkRangeMap chunkRangeMap =
-        SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<ShardAndChunkRange>();
+    ChunkRangeMap chunkRangeMap;
 
     ShardVersionMap shardVersions;
 
@@ -384,8 +480,10 @@ ChunkManager::ChunkMapViews ChunkManager::_constructChunkMapViews(const OID& epo
         const BSONObj rangeMin = firstChunkInRange->getMin();
         const BSONObj rangeMax = rangeLast->second->getMax();
 
+        // The range ends where its last chunk ends, so the key of that chunk can be reused.
         const auto insertResult = chunkRangeMap.insert(std::make_pair(
-            rangeMax, ShardAndChunkRange{{rangeMin, rangeMax}, firstChunkInRange->getShardId()}));
+            rangeLast->first,
+            ShardAndChunkRange{{rangeMin, rangeMax}, firstChunkInRange->getShardId()}));
         uassert(ErrorCodes::ConflictingOperationInProgress,
                 str::stream() << "Metadata contains two chunks with the same max value "
                               << rangeMax,
@@ -400,8 +498,8 @@ ChunkManager::ChunkMapViews ChunkManager::_constructChunkMapViews(const OID& epo
                                   << insertIterator->second.range.toString()
                                   << " and "
                                   << std::prev(insertIterator)->second.range.toString(),
-                    SimpleBSONObjComparator::kInstance.evaluate(std::prev(insertIterator)->first ==
-                                                                rangeMin));
+                    SimpleBSONObjComparator::kInstance.evaluate(
+                        std::prev(insertIterator)->second.max() == rangeMin));
         }
 
         // If a shard has chunks it must have a shard version, otherwise we have an invalid chunk
@@ -413,7 +511,7 @@ ChunkManager::ChunkMapViews ChunkManager::_constructChunkMapViews(const OID& epo
     invariant(!shardVersions.empty());
 
     checkAllElementsAreOfType(MinKey, chunkRangeMap.begin()->second.min());
-    checkAllElementsAreOfType(MaxKey, chunkRangeMap.rbegin()->first);
+    checkAllElementsAreOfType(MaxKey, chunkRangeMap.rbegin()->second.max());
 
     return {std::move(chunkRangeMap), std::move(shardVersions)};
 }
@@ -29,8 +29,10 @@
 #pragma once
 
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/namespace_string.h"
@@ -47,13 +49,14 @@ class CanonicalQuery;
 struct QuerySolutionNode;
 class OperationContext;
 
-// Ordered map from the max for each chunk to an entry describing the chunk
-using ChunkMap = BSONObjIndexedMap<std::shared_ptr<Chunk>>;
+// Ordered map from the max for each chunk to an entry describing the chunk. The max is encoded with
+// ShardKeyPattern::toKeyString, so that lookups compare keys with memcmp.
+using ChunkMap = std::map<std::string, std::shared_ptr<Chunk>>;
 
 // Map from a shard is to the max chunk version on that shard
 using ShardVersionMap = std::map<ShardId, ChunkVersion>;
 
-class ChunkManager {
+class ChunkManager : public std::enable_shared_from_this<ChunkManager> {
     MONGO_DISALLOW_COPYING(ChunkManager);
 
 public:
@@ -66,6 +69,31 @@ public:
 
     ~ChunkManager();
 
+    /**
+     * Builds the routing table of a collection with the given epoch from all of its chunks, which
+     * must be sorted by ascending version and cover the complete shard key space.
+     *
+     * Throws ConflictingOperationInProgress if the chunks are not consistent.
+     */
+    static std::shared_ptr<ChunkManager> makeNew(NamespaceString nss,
+                                                 KeyPattern shardKeyPattern,
+                                                 std::unique_ptr<CollatorInterface> defaultCollator,
+                                                 bool unique,
+                                                 OID epoch,
+                                                 const std::vector<ChunkType>& chunks);
+
+    /**
+     * Returns a new routing table with 'changedChunks' applied on top of this one, which is left
+     * untouched so that concurrent readers are not disturbed. The chunks which did not change are
+     * shared between the two routing tables. The changed chunks must be sorted by ascending
+     * version, all of which must be greater than or equal to the current collection version.
+     *
+     * Returns this object if none of the changes advance the collection version.
+     *
+     * Throws ConflictingOperationInProgress if the changed chunks are not consistent.
+     */
+    std::shared_ptr<ChunkManager> makeUpdated(const std::vector<ChunkType>& changedChunks);
+
     /**
      * Returns an increasing number of the reload sequence number of this chunk manager.
      */
@@ -195,7 +223,8 @@ private:
         ShardId shardId;
     };
 
-    using ChunkRangeMap = BSONObjIndexedMap<ShardAndChunkRange>;
+    // Ordered map from the KeyString-encoded max of each range to the range.
+    using ChunkRangeMap = std::map<std::string, ShardAndChunkRange>;
 
     /**
      * Contains different transformations of the chunk map for efficient querying
@@ -216,6 +245,15 @@ private:
      */
     static ChunkMapViews _constructChunkMapViews(const OID& epoch, const ChunkMap& chunkMap);
 
+    /**
+     * Replaces the entries of 'chunkMap' overlapped by each of 'changedChunks' with the changed
+     * chunk and returns the new collection version.
+     */
+    static ChunkVersion _applyChangedChunks(const NamespaceString& nss,
+                                            ChunkVersion startingVersion,
+                                            const std::vector<ChunkType>& changedChunks,
+                                            ChunkMap* chunkMap);
+
     // The shard versioning mechanism hinges on keeping track of the number of times we reload
     // ChunkManagers.
     const unsigned long long _sequenceNumber;
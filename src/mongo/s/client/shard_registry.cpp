@@ -81,6 +81,22 @@ using CallbackHandle = TaskExecutor::CallbackHandle;
 
 namespace {
 const Seconds kRefreshPeriod(30);
+
+/**
+ * Starts pre-establishing pooled connections from the sharding executors to every host in
+ * connString, so that the first burst of requests to a new or restarted shard member doesn't pay
+ * for connection setup all at once.
+ */
+void warmUpConnections(OperationContext* opCtx, const ConnectionString& connString) {
+    auto executorPool = Grid::get(opCtx)->getExecutorPool();
+    if (!executorPool) {
+        return;
+    }
+
+    for (const auto& host : connString.getServers()) {
+        executorPool->warmUpConnections(host);
+    }
+}
 }  // namespace
 
 ShardRegistry::ShardRegistry(std::unique_ptr<ShardFactory> shardFactory,
@@ -311,6 +327,16 @@ bool ShardRegistry::reload(OperationContext* opCtx) {
         ReplicaSetMonitor::remove(name);
     }
 
+    // Reloads run periodically, so this also revives the pools of shards that have been idle for
+    // longer than the executors' hostTimeout.
+    std::set<ShardId> shardIds;
+    _data.getAllShardIds(shardIds);
+    for (const auto& shardId : shardIds) {
+        if (auto shard = _data.findByShardId(shardId)) {
+            warmUpConnections(opCtx, shard->getConnString());
+        }
+    }
+
     nextReloadState = ReloadState::Idle;
     // first successful reload means that registry is up
     _isUp = true;
@@ -332,6 +358,9 @@ void ShardRegistry::replicaSetChangeConfigServerUpdateHook(const std::string& se
     auto opCtx = cc().makeOperationContext();
 
     try {
+        warmUpConnections(opCtx.get(),
+                          uassertStatusOK(ConnectionString::parse(newConnectionString)));
+
         std::shared_ptr<Shard> s = Grid::get(opCtx.get())->shardRegistry()->lookupRSName(setName);
         if (!s) {
             LOG(1) << "shard not found for set: " << newConnectionString
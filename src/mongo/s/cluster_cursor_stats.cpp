@@ -47,9 +47,9 @@ public:
         BSONObjBuilder cursorBob(b.subobjStart(_leafName));
         cursorBob.append("timedOut",
                          static_cast<long long>(grid.getCursorManager()->cursorsTimedOut()));
+        auto stats = grid.getCursorManager()->stats();
         {
             BSONObjBuilder openBob(cursorBob.subobjStart("open"));
-            auto stats = grid.getCursorManager()->stats();
             openBob.append("multiTarget", static_cast<long long>(stats.cursorsSharded));
             openBob.append("singleTarget", static_cast<long long>(stats.cursorsNotSharded));
             openBob.append("pinned", static_cast<long long>(stats.cursorsPinned));
@@ -57,6 +57,16 @@ public:
                            static_cast<long long>(stats.cursorsSharded + stats.cursorsNotSharded));
             openBob.doneFast();
         }
+        {
+            BSONObjBuilder locksBob(cursorBob.subobjStart("partitionLocks"));
+            locksBob.append("partitions",
+                            static_cast<long long>(ClusterCursorManager::numPartitions()));
+            locksBob.append("acquisitions",
+                            static_cast<long long>(stats.partitionLockAcquisitions));
+            locksBob.append("contended", static_cast<long long>(stats.partitionLockContentions));
+            locksBob.append("waitMicros", static_cast<long long>(stats.partitionLockWaitMicros));
+            locksBob.doneFast();
+        }
         cursorBob.done();
     }
 
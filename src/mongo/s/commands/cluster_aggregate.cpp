@@ -38,10 +38,12 @@
 #include "mongo/db/commands.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/pipeline/document_source_out.h"
+#include "mongo/db/pipeline/document_source_sample.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/lite_parsed_pipeline.h"
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/query/collation/collator_factory_interface.h"
+#include "mongo/db/query/cursor_response.h"
 #include "mongo/db/views/resolved_view.h"
 #include "mongo/db/views/view.h"
 #include "mongo/executor/task_executor_pool.h"
@@ -83,13 +85,82 @@ Document wrapAggAsExplain(Document aggregateCommand, ExplainOptions::Verbosity v
     return explainCommandBuilder.freeze();
 }
 
+/**
+ * For a sharded pipeline that starts with $sample, returns the command to send each shard with the
+ * sample size cut down to that shard's share of the collection, so that the shards between them
+ * read about 'sampleSize' random documents rather than 'sampleSize' each. The shares come from the
+ * record counts reported by $collStats.
+ *
+ * Returns an empty map, leaving every shard with the full sample size, if the pipeline does not
+ * start with $sample or the counts cannot be gathered.
+ */
+std::map<ShardId, BSONObj> buildProportionalSampleCommands(OperationContext* opCtx,
+                                                           const NamespaceString& nss,
+                                                           const BSONObj& targetedCommand,
+                                                           Pipeline* pipelineForTargetedShards,
+                                                           const ReadPreferenceSetting& readPref,
+                                                           const BSONObj& query,
+                                                           const BSONObj& collation) {
+    const auto& sources = pipelineForTargetedShards->getSources();
+    auto sampleStage =
+        sources.empty() ? nullptr : dynamic_cast<DocumentSourceSample*>(sources.front().get());
+    if (!sampleStage || sampleStage->getSampleSize() == 0) {
+        return {};
+    }
+
+    BSONObj countCmd =
+        BSON("aggregate" << nss.coll() << "pipeline"
+                         << BSON_ARRAY(BSON("$collStats" << BSON("count" << BSONObj())))
+                         << "cursor"
+                         << BSONObj());
+    auto swResponses =
+        scatterGatherForNamespace(opCtx, nss, countCmd, readPref, query, collation);
+    if (!swResponses.isOK() || swResponses.getValue().size() < 2) {
+        return {};
+    }
+
+    std::map<ShardId, long long> shardCounts;
+    long long totalCount = 0;
+    for (const auto& response : swResponses.getValue()) {
+        if (!response.swResponse.isOK()) {
+            return {};
+        }
+        auto swCursorResponse = CursorResponse::parseFromBSON(response.swResponse.getValue().data);
+        if (!swCursorResponse.isOK() || swCursorResponse.getValue().getBatch().size() != 1) {
+            return {};
+        }
+        long long count =
+            swCursorResponse.getValue().getBatch().front()["count"].safeNumberLong();
+        shardCounts[response.shardId] = count;
+        totalCount += count;
+    }
+
+    std::vector<Value> stages = pipelineForTargetedShards->serialize();
+    std::map<ShardId, BSONObj> shardCommands;
+    for (const auto& shardCount : shardCounts) {
+        long long shardSampleSize = DocumentSourceSample::getShardSampleSize(
+            sampleStage->getSampleSize(), shardCount.second, totalCount);
+        stages.front() = Value(DOC("$sample" << DOC("size" << shardSampleSize)));
+
+        MutableDocument shardCommand{Document(targetedCommand)};
+        shardCommand[AggregationRequest::kPipelineName] = Value(stages);
+        shardCommands[shardCount.first] = shardCommand.freeze().toBson();
+    }
+    return shardCommands;
+}
+
+/**
+ * Establishes cursors on the shards targeted by 'query', sending each shard its entry in
+ * 'shardCommands' if it has one, and 'cmdObj' otherwise.
+ */
 StatusWith<std::vector<ClusterClientCursorParams::RemoteCursor>>
 establishCursorsRetryOnStaleVersion(OperationContext* opCtx,
                                     const NamespaceString& nss,
                                     const BSONObj& cmdObj,
                                     const ReadPreferenceSetting& readPref,
                                     const BSONObj& query,
-                                    const BSONObj& collation) {
+                                    const BSONObj& collation,
+                                    const std::map<ShardId, BSONObj>& shardCommands = {}) {
     StatusWith<std::vector<ClusterClientCursorParams::RemoteCursor>> swCursors(
         (std::vector<ClusterClientCursorParams::RemoteCursor>()));
 
@@ -108,8 +179,12 @@ establishCursorsRetryOnStaleVersion(OperationContext* opCtx,
             std::set<ShardId> shardIds;
             routingInfo.cm()->getShardIdsForQuery(opCtx, query, collation, &shardIds);
             for (auto& shardId : shardIds) {
-                auto versionedCmdObj =
-                    appendShardVersion(cmdObj, routingInfo.cm()->getVersion(shardId));
+                // A shard that joined the targeted set after a stale version retry has no entry,
+                // and samples the full size.
+                auto shardCommand = shardCommands.find(shardId);
+                auto versionedCmdObj = appendShardVersion(
+                    shardCommand != shardCommands.end() ? shardCommand->second : cmdObj,
+                    routingInfo.cm()->getVersion(shardId));
                 requests.emplace_back(std::move(shardId), std::move(versionedCmdObj));
             }
         } else {
@@ -302,12 +377,24 @@ Status ClusterAggregate::runAggregate(OperationContext* opCtx,
         return Status::OK();
     }
 
+    std::map<ShardId, BSONObj> shardCommands;
+    if (needSplit) {
+        shardCommands = buildProportionalSampleCommands(opCtx,
+                                                        namespaces.executionNss,
+                                                        targetedCommand,
+                                                        pipelineForTargetedShards.get(),
+                                                        getReadPref(targetedCommand),
+                                                        shardQuery,
+                                                        request.getCollation());
+    }
+
     auto cursors = uassertStatusOK(establishCursorsRetryOnStaleVersion(opCtx,
                                                                        namespaces.executionNss,
                                                                        targetedCommand,
                                                                        getReadPref(targetedCommand),
                                                                        shardQuery,
-                                                                       request.getCollation()));
+                                                                       request.getCollation(),
+                                                                       shardCommands));
 
     if (!needSplit) {
         invariant(cursors.size() == 1);
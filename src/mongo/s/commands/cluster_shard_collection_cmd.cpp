@@ -119,6 +119,120 @@ BSONObj makeCreateIndexesCmd(const NamespaceString& nss,
     return createIndexes.obj();
 }
 
+/**
+ * Prepares all the shards other than the primary shard to own chunks of the empty collection
+ * 'nss' without having received them through migration. Creates the collection on each of them
+ * with the same options as on the primary shard along with all of its indexes ('indexSpecs'),
+ * which is what the recipient of the first migration would have done otherwise.
+ *
+ * Fails if any of the shards already contains documents in the namespace, because these would
+ * suddenly become owned by that shard.
+ */
+Status prepareShardsForInitialChunks(OperationContext* opCtx,
+                                     const NamespaceString& nss,
+                                     const std::vector<ShardId>& shardIds,
+                                     const ShardId& primaryShardId,
+                                     const BSONObj& collectionOptions,
+                                     const std::list<BSONObj>& indexSpecs) {
+    const auto runCommandOnShard = [&](const std::shared_ptr<Shard>& shard,
+                                       const BSONObj& cmdObj) -> StatusWith<BSONObj> {
+        auto swResponse = shard->runCommandWithFixedRetryAttempts(
+            opCtx,
+            ReadPreferenceSetting{ReadPreference::PrimaryOnly},
+            nss.db().toString(),
+            cmdObj,
+            Shard::RetryPolicy::kIdempotent);
+        if (!swResponse.isOK()) {
+            return swResponse.getStatus();
+        }
+
+        auto& response = swResponse.getValue();
+        if (!response.commandStatus.isOK()) {
+            return response.commandStatus;
+        }
+        if (!response.writeConcernStatus.isOK()) {
+            return response.writeConcernStatus;
+        }
+
+        return std::move(response.response);
+    };
+
+    BSONObj createCmd;
+    {
+        BSONObjBuilder createCmdBuilder;
+        createCmdBuilder.append("create", nss.coll());
+        createCmdBuilder.appendElements(collectionOptions);
+        createCmdBuilder.append("writeConcern", WriteConcernOptions::Majority);
+        createCmd = createCmdBuilder.obj();
+    }
+
+    BSONObj createIndexesCmd;
+    bool hasIndexesToCreate = false;
+    {
+        BSONObjBuilder createIndexesCmdBuilder;
+        createIndexesCmdBuilder.append("createIndexes", nss.coll());
+
+        BSONArrayBuilder indexesBuilder(createIndexesCmdBuilder.subarrayStart("indexes"));
+        for (const auto& indexSpec : indexSpecs) {
+            if (IndexDescriptor::isIdIndexPattern(indexSpec["key"].Obj())) {
+                continue;
+            }
+            indexesBuilder.append(indexSpec);
+            hasIndexesToCreate = true;
+        }
+        indexesBuilder.done();
+
+        createIndexesCmdBuilder.append("writeConcern", WriteConcernOptions::Majority);
+        createIndexesCmd = createIndexesCmdBuilder.obj();
+    }
+
+    const auto shardRegistry = Grid::get(opCtx)->shardRegistry();
+
+    for (const auto& shardId : shardIds) {
+        if (shardId == primaryShardId) {
+            continue;
+        }
+
+        auto swShard = shardRegistry->getShard(opCtx, shardId);
+        if (!swShard.isOK()) {
+            return swShard.getStatus();
+        }
+        const auto shard = std::move(swShard.getValue());
+
+        auto swCount = runCommandOnShard(shard, BSON("count" << nss.coll()));
+        if (!swCount.isOK()) {
+            return swCount.getStatus();
+        }
+
+        long long numDocs = 0;
+        Status status = bsonExtractIntegerField(swCount.getValue(), "n", &numDocs);
+        if (!status.isOK()) {
+            return status;
+        }
+
+        if (numDocs > 0) {
+            return {ErrorCodes::IllegalOperation,
+                    str::stream() << "shard " << shardId << " already contains " << numDocs
+                                  << " documents for collection "
+                                  << nss.ns()};
+        }
+
+        auto swCreate = runCommandOnShard(shard, createCmd);
+        if (!swCreate.isOK() && swCreate.getStatus() != ErrorCodes::NamespaceExists) {
+            return swCreate.getStatus();
+        }
+
+        if (hasIndexesToCreate) {
+            auto swCreateIndexes = runCommandOnShard(shard, createIndexesCmd);
+            if (!swCreateIndexes.isOK()) {
+                return swCreateIndexes.getStatus();
+            }
+        }
+    }
+
+    return Status::OK();
+}
+
 class ShardCollectionCmd : public Command {
 public:
     ShardCollectionCmd() : Command("shardCollection", "shardcollection") {}
@@ -264,6 +378,7 @@ public:
         }
 
         BSONObj defaultCollation;
+        BSONObj collectionOptions;
 
         if (!res.isEmpty()) {
             // Check that namespace is not a view.
@@ -283,9 +398,8 @@ public:
                 }
             }
 
-            BSONObj collectionOptions;
             if (res["options"].type() == BSONType::Object) {
-                collectionOptions = res["options"].Obj();
+                collectionOptions = res["options"].Obj().getOwned();
             }
 
             // Check that collection is not capped.
@@ -347,7 +461,8 @@ public:
         //         ii. is not a sparse index, partial index, or index with a non-simple collation
         //         iii. contains no null values
         //         iv. is not multikey (maybe lift this restriction later)
-        //         v. if a hashed index, has default seed (lift this restriction later)
+        //         v. if a hashed index, has default seed and hashVersion (lift this restriction
+        //            later)
         //
         // 3. If the proposed shard key is specified as unique, there must exist a useful,
         //    unique index exactly equal to the proposedKey (not just a prefix).
@@ -402,6 +517,18 @@ public:
                     return false;
                 }
 
+                // The routing metadata doesn't record a hash function, so chunks are always
+                // computed with the default one.
+                if (isHashedShardKey &&
+                    idx["hashVersion"].numberInt() != BSONElementHasher::MD5_HASH_VERSION) {
+                    errmsg = str::stream() << "can't shard collection " << nss.ns()
+                                           << " with hashed shard key " << proposedKey
+                                           << " because the hashed index uses hashVersion "
+                                           << idx["hashVersion"].numberInt();
+                    conn.done();
+                    return false;
+                }
+
                 hasUsefulIndexForKey = true;
             }
         }
@@ -493,13 +620,23 @@ public:
 
         bool isEmpty = (conn->count(nss.ns()) == 0);
 
+        // The indexes, which need to be present on the other shards if the initial chunks of an
+        // empty hashed collection are assigned to them directly
+        std::list<BSONObj> initialIndexes;
+        if (isHashedShardKey && isEmpty) {
+            initialIndexes = conn->getIndexSpecs(nss.ns());
+        }
+
         conn.done();
 
         // Pre-splitting:
-        // For new collections which use hashed shard keys, we can can pre-split the
-        // range of possible hashes into a large number of chunks, and distribute them
-        // evenly at creation time. Until we design a better initialization scheme, the
-        // safest way to pre-split is to
+        // For new collections which use hashed shard keys, we can can pre-split the range of
+        // possible hashes into a large number of chunks, and distribute them evenly at creation
+        // time. Since the collection is empty, the preferred way to do this is to create all the
+        // initial chunks directly on the config server, assigned round-robin to the shards, which
+        // requires no data movement. If the other shards cannot be prepared to own chunks of the
+        // collection (for example, because some of them still contain documents for it), the
+        // fallback is to
         // 1. make one big chunk for each shard
         // 2. move them one at a time
         // 3. split the big chunks to achieve the desired total number of initial chunks
@@ -557,25 +694,41 @@ public:
                                                        "when the collection is not empty.")});
         }
 
+        bool distributeInitialChunks = false;
+        if (isHashedShardKey && isEmpty && numShards > 1) {
+            auto prepareStatus = prepareShardsForInitialChunks(
+                opCtx, nss, shardIds, primaryShard->getId(), collectionOptions, initialIndexes);
+            if (prepareStatus.isOK()) {
+                distributeInitialChunks = true;
+            } else {
+                warning() << "Unable to assign the initial chunks of " << nss.ns()
+                          << " directly to all shards, they will be migrated instead"
+                          << causedBy(redact(prepareStatus));
+            }
+        }
+
         LOG(0) << "CMD: shardcollection: " << cmdObj;
 
         audit::logShardCollection(Client::getCurrent(), nss.ns(), proposedKey, careAboutUnique);
 
-        uassertStatusOK(catalogClient->shardCollection(opCtx,
-                                                       nss.ns(),
-                                                       proposedShardKey,
-                                                       defaultCollation,
-                                                       careAboutUnique,
-                                                       initSplits,
-                                                       std::set<ShardId>{}));
+        uassertStatusOK(catalogClient->shardCollection(
+            opCtx,
+            nss.ns(),
+            proposedShardKey,
+            defaultCollation,
+            careAboutUnique,
+            distributeInitialChunks ? allSplits : initSplits,
+            distributeInitialChunks ? std::set<ShardId>(shardIds.begin(), shardIds.end())
+                                    : std::set<ShardId>{}));
 
         result << "collectionsharded" << nss.ns();
 
         // Make sure the cached metadata for the collection knows that we are now sharded
         catalogCache->invalidateShardedCollection(nss);
 
-        // Only initially move chunks when using a hashed shard key
-        if (isHashedShardKey && isEmpty) {
+        // Only initially move chunks when using a hashed shard key and the chunks could not be
+        // created distributed already
+        if (isHashedShardKey && isEmpty && !distributeInitialChunks) {
             routingInfo = uassertStatusOK(catalogCache->getCollectionRoutingInfo(opCtx, nss));
             uassert(ErrorCodes::ConflictingOperationInProgress,
                     "Collection was successfully written as sharded but got dropped before it "
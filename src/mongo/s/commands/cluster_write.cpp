@@ -35,6 +35,7 @@
 #include "mongo/base/status.h"
 #include "mongo/client/connpool.h"
 #include "mongo/db/lasterror.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/write_concern_options.h"
 #include "mongo/s/balancer_configuration.h"
 #include "mongo/s/catalog/sharding_catalog_client.h"
@@ -51,6 +52,11 @@
 namespace mongo {
 namespace {
 
+// Whether mongos estimates the data written to each chunk and splits the chunks which grow too big.
+// The shard primaries track the chunk sizes themselves, so this only needs to be turned on when
+// some of the shards are running an older version, which does not auto-split.
+MONGO_EXPORT_SERVER_PARAMETER(routerAutoSplit, bool, false);
+
 // Test whether we should split once data * splitTestFactor > chunkSize (approximately)
 const uint64_t splitTestFactor = 5;
 
@@ -284,6 +290,10 @@ void updateChunkWriteStatsAndSplitIfNeeded(OperationContext* opCtx,
                                            ChunkManager* manager,
                                            Chunk* chunk,
                                            long dataWritten) {
+    if (!routerAutoSplit.load()) {
+        return;
+    }
+
     // Disable lastError tracking so that any errors, which occur during auto-split do not get
     // bubbled up on the client connection doing a write.
     LastError::Disabled d(&LastError::get(cc()));
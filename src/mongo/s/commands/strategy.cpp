@@ -519,6 +519,25 @@ static void runCommand(OperationContext* opCtx,
     }
 }
 
+/**
+ * The cluster commands split each write batch by target shard and re-serialize it, so mongos folds
+ * any document sequences back into arrays in the command body instead of passing them through.
+ */
+static BSONObj foldDocumentSequencesIntoBody(const OpMsg& request) {
+    if (request.sequences.empty())
+        return request.body;
+
+    BSONObjBuilder bodyBuilder;
+    bodyBuilder.appendElements(request.body);
+    for (auto&& sequence : request.sequences) {
+        BSONArrayBuilder arrayBuilder(bodyBuilder.subarrayStart(sequence.name));
+        for (auto&& obj : sequence.objs) {
+            arrayBuilder.append(obj);
+        }
+    }
+    return bodyBuilder.obj();
+}
+
 DbResponse Strategy::clientOpMsgCommand(OperationContext* opCtx, const Message& m) {
     auto request = OpMsg::parse(m);
     OpMsgBuilder reply;
@@ -527,7 +546,7 @@ DbResponse Strategy::clientOpMsgCommand(OperationContext* opCtx, const Message&
         if (auto elem = request.body["$db"])
             db = elem.String();
 
-        runCommand(opCtx, db, request.body, reply.beginBody());
+        runCommand(opCtx, db, foldDocumentSequencesIntoBody(request), reply.beginBody());
     } catch (const DBException& ex) {
         reply.reset();
         auto bob = reply.beginBody();
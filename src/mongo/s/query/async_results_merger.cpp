@@ -36,6 +36,7 @@
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/killcursors_request.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/executor/remote_command_response.h"
 #include "mongo/s/client/shard_registry.h"
@@ -50,21 +51,40 @@ namespace {
 // Maximum number of retries for network and replication notMaster errors (per host).
 const int kMaxNumFailedHostRetryAttempts = 3;
 
+// The largest number of fields whose sort directions an Ordering can describe.
+const int kMaxOrderingFields = 32;
+
 }  // namespace
 
 AsyncResultsMerger::AsyncResultsMerger(executor::TaskExecutor* executor,
                                        ClusterClientCursorParams* params)
-    : _executor(executor),
-      _params(params),
-      _mergeQueue(MergingComparator(_remotes, _params->sort)) {
-    size_t remoteIndex = 0;
+    : _executor(executor), _params(params) {
     for (const auto& remote : _params->remotes) {
         _remotes.emplace_back(remote.hostAndPort, remote.cursorResponse.getCursorId());
+    }
+
+    if (!_params->sort.isEmpty()) {
+        if (_params->sort.nFields() <= kMaxOrderingFields) {
+            _sortKeyOrdering = Ordering::make(_params->sort);
+        }
+
+        // Every remote starts out with an empty buffer. The first batches are added below, each
+        // of which replays the matches of its remote.
+        _mergeTree.resize(2 * _remotes.size());
+        for (size_t i = 0; i < _remotes.size(); ++i) {
+            _mergeTree[_remotes.size() + i] = i;
+        }
+        for (size_t node = _remotes.size(); node-- > 1;) {
+            const size_t left = _mergeTree[2 * node];
+            const size_t right = _mergeTree[2 * node + 1];
+            _mergeTree[node] = mergeTreeLess(right, left) ? right : left;
+        }
+    }
 
+    for (size_t remoteIndex = 0; remoteIndex < _remotes.size(); ++remoteIndex) {
         // We don't check the return value of addBatchToBuffer here; if there was an error,
         // it will be stored in the remote and the first call to ready() will return true.
-        addBatchToBuffer(remoteIndex, remote.cursorResponse.getBatch());
-        ++remoteIndex;
+        addBatchToBuffer(remoteIndex, _params->remotes[remoteIndex].cursorResponse.getBatch());
     }
 
     // Initialize command metadata to handle the read preference. We do this in case the readPref
@@ -187,25 +207,28 @@ ClusterQueryResult AsyncResultsMerger::nextReadySorted() {
     // Tailable cursors cannot have a sort.
     invariant(!_params->isTailable);
 
-    if (_mergeQueue.empty()) {
+    if (_remotes.empty()) {
         return {};
     }
 
-    size_t smallestRemote = _mergeQueue.top();
-    _mergeQueue.pop();
-
-    invariant(!_remotes[smallestRemote].docBuffer.empty());
-    invariant(_remotes[smallestRemote].status.isOK());
+    // The winner of the tournament only has an empty buffer if every remote does.
+    const size_t smallestRemote = _mergeTree[1];
+    auto& remote = _remotes[smallestRemote];
+    if (remote.docBuffer.empty()) {
+        return {};
+    }
 
-    ClusterQueryResult front = _remotes[smallestRemote].docBuffer.front();
-    _remotes[smallestRemote].docBuffer.pop();
+    invariant(remote.status.isOK());
 
-    // Re-populate the merging queue with the next result from 'smallestRemote', if it has a
-    // next result.
-    if (!_remotes[smallestRemote].docBuffer.empty()) {
-        _mergeQueue.push(smallestRemote);
+    ClusterQueryResult front = remote.docBuffer.front();
+    remote.docBuffer.pop();
+    if (_sortKeyOrdering) {
+        remote.sortKeyBuffer.pop();
     }
 
+    // Replay the matches of 'smallestRemote' against its next result, if it has one.
+    updateMergeTree(smallestRemote);
+
     return front;
 }
 
@@ -422,7 +445,13 @@ void AsyncResultsMerger::handleBatchResponse(
             // Clear the results buffer and cursor id.
             std::queue<ClusterQueryResult> emptyBuffer;
             std::swap(remote.docBuffer, emptyBuffer);
+            std::queue<std::string> emptySortKeyBuffer;
+            std::swap(remote.sortKeyBuffer, emptySortKeyBuffer);
             remote.cursorId = 0;
+
+            if (!_params->sort.isEmpty()) {
+                updateMergeTree(remoteIndex);
+            }
         }
 
         return;
@@ -480,15 +509,24 @@ bool AsyncResultsMerger::addBatchToBuffer(size_t remoteIndex, const std::vector<
             return false;
         }
 
+        // Encode the sort key here, on the thread receiving the batch, so that the merge itself
+        // only has to compare strings.
+        if (_sortKeyOrdering) {
+            KeyString sortKey(KeyString::Version::V1,
+                              obj[ClusterClientCursorParams::kSortKeyField].Obj(),
+                              *_sortKeyOrdering);
+            remote.sortKeyBuffer.emplace(sortKey.getBuffer(), sortKey.getSize());
+        }
+
         ClusterQueryResult result(obj);
         remote.docBuffer.push(result);
         ++remote.fetchedCount;
     }
 
-    // If we're doing a sorted merge, then we have to make sure to put this remote onto the
-    // merge queue.
+    // If we're doing a sorted merge, then we have to make sure to replay this remote's matches in
+    // the merge tree.
     if (!_params->sort.isEmpty() && !batch.empty()) {
-        _mergeQueue.push(remoteIndex);
+        updateMergeTree(remoteIndex);
     }
     return true;
 }
@@ -602,19 +640,41 @@ std::shared_ptr<Shard> AsyncResultsMerger::RemoteCursorData::getShard() {
 }
 
 //
-// AsyncResultsMerger::MergingComparator
+// Sorted merge helpers.
 //
 
-bool AsyncResultsMerger::MergingComparator::operator()(const size_t& lhs, const size_t& rhs) {
-    const ClusterQueryResult& leftDoc = _remotes[lhs].docBuffer.front();
-    const ClusterQueryResult& rightDoc = _remotes[rhs].docBuffer.front();
+bool AsyncResultsMerger::mergeTreeLess(size_t lhs, size_t rhs) const {
+    const auto& leftRemote = _remotes[lhs];
+    const auto& rightRemote = _remotes[rhs];
+    if (leftRemote.docBuffer.empty() || rightRemote.docBuffer.empty()) {
+        return rightRemote.docBuffer.empty() && (!leftRemote.docBuffer.empty() || lhs < rhs);
+    }
 
-    BSONObj leftDocKey = (*leftDoc.getResult())[ClusterClientCursorParams::kSortKeyField].Obj();
-    BSONObj rightDocKey = (*rightDoc.getResult())[ClusterClientCursorParams::kSortKeyField].Obj();
+    int cmp;
+    if (_sortKeyOrdering) {
+        cmp = leftRemote.sortKeyBuffer.front().compare(rightRemote.sortKeyBuffer.front());
+    } else {
+        const ClusterQueryResult& leftDoc = leftRemote.docBuffer.front();
+        const ClusterQueryResult& rightDoc = rightRemote.docBuffer.front();
 
-    // This does not need to sort with a collator, since mongod has already mapped strings to their
-    // ICU comparison keys as part of the $sortKey meta projection.
-    return leftDocKey.woCompare(rightDocKey, _sort, false /*considerFieldName*/) > 0;
+        BSONObj leftDocKey =
+            (*leftDoc.getResult())[ClusterClientCursorParams::kSortKeyField].Obj();
+        BSONObj rightDocKey =
+            (*rightDoc.getResult())[ClusterClientCursorParams::kSortKeyField].Obj();
+
+        // This does not need to sort with a collator, since mongod has already mapped strings to
+        // their ICU comparison keys as part of the $sortKey meta projection.
+        cmp = leftDocKey.woCompare(rightDocKey, _params->sort, false /*considerFieldName*/);
+    }
+    return cmp < 0 || (cmp == 0 && lhs < rhs);
+}
+
+void AsyncResultsMerger::updateMergeTree(size_t remoteIndex) {
+    for (size_t node = (_remotes.size() + remoteIndex) / 2; node >= 1; node /= 2) {
+        const size_t left = _mergeTree[2 * node];
+        const size_t right = _mergeTree[2 * node + 1];
+        _mergeTree[node] = mergeTreeLess(right, left) ? right : left;
+    }
 }
 
 }  // namespace mongo
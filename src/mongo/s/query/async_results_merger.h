@@ -35,6 +35,7 @@
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj.h"
+#include "mongo/bson/ordering.h"
 #include "mongo/db/cursor_id.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/s/query/cluster_client_cursor_params.h"
@@ -79,8 +80,8 @@ public:
      * the hosts on which they exist in _remotes.
      *
      * Additionally copies each remote's first batch of results, if one exists, into that remote's
-     * docBuffer. If a sort is specified in the ClusterClientCursorParams, places the remotes with
-     * buffered results onto _mergeQueue.
+     * docBuffer. If a sort is specified in the ClusterClientCursorParams, builds the merge tree
+     * over the remotes' buffered results.
      *
      * The TaskExecutor* must remain valid for the lifetime of the ARM.
      */
@@ -214,6 +215,10 @@ private:
         // The buffer of results that have been retrieved but not yet returned to the caller.
         std::queue<ClusterQueryResult> docBuffer;
 
+        // The KeyString encoding of the $sortKey of each result in 'docBuffer', in the same order.
+        // Populated only for sorted merges whose sort pattern can be represented as an Ordering.
+        std::queue<std::string> sortKeyBuffer;
+
         // Is valid if there is currently a pending request to this remote.
         executor::TaskExecutor::CallbackHandle cbHandle;
 
@@ -226,19 +231,6 @@ private:
         long long fetchedCount = 0;
     };
 
-    class MergingComparator {
-    public:
-        MergingComparator(const std::vector<RemoteCursorData>& remotes, const BSONObj& sort)
-            : _remotes(remotes), _sort(sort) {}
-
-        bool operator()(const size_t& lhs, const size_t& rhs);
-
-    private:
-        const std::vector<RemoteCursorData>& _remotes;
-
-        const BSONObj& _sort;
-    };
-
     enum LifecycleState { kAlive, kKillStarted, kKillComplete };
 
     /**
@@ -285,6 +277,23 @@ private:
     ClusterQueryResult nextReadySorted();
     ClusterQueryResult nextReadyUnsorted();
 
+    //
+    // Helpers for the sorted merge.
+    //
+
+    /**
+     * Returns true if the next buffered result of the remote at 'lhs' should be returned before
+     * that of the remote at 'rhs'. A remote with no buffered results never wins; ties go to the
+     * lower remote index.
+     */
+    bool mergeTreeLess(size_t lhs, size_t rhs) const;
+
+    /**
+     * Replays the matches along the path from the leaf of the remote at 'remoteIndex' to the root
+     * of '_mergeTree'. Must be called whenever the front of that remote's buffer changes.
+     */
+    void updateMergeTree(size_t remoteIndex);
+
     /**
      * When nextEvent() schedules remote work, it passes this method as a callback. The TaskExecutor
      * will call this function, passing the response from the remote.
@@ -338,9 +347,17 @@ private:
     // Data tracking the state of our communication with each of the remote nodes.
     std::vector<RemoteCursorData> _remotes;
 
-    // The top of this priority queue is the index into '_remotes' for the remote host that has the
-    // next document to return, according to the sort order. Used only if there is a sort.
-    std::priority_queue<size_t, std::vector<size_t>, MergingComparator> _mergeQueue;
+    // Tournament tree over '_remotes', used only if there is a sort. The leaf for remote i lives at
+    // position '_remotes.size() + i' and every internal node n holds the index of the remote that
+    // won the match between nodes 2n and 2n + 1, so '_mergeTree[1]' is the remote with the next
+    // document to return. Replacing a remote's front result replays only the log(n) matches on its
+    // path to the root, rather than the heap sift of a priority queue.
+    std::vector<size_t> _mergeTree;
+
+    // Describes the sort direction of each $sortKey field when encoding sort keys as KeyStrings.
+    // Not set if there is no sort, or if the sort pattern has more fields than an Ordering can
+    // describe, in which case the merge falls back to comparing the $sortKey objects directly.
+    boost::optional<Ordering> _sortKeyOrdering;
 
     // The index into '_remotes' for the remote from which we are currently retrieving results.
     // Used only if there is *not* a sort.
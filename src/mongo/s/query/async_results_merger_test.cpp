@@ -597,6 +597,39 @@ TEST_F(AsyncResultsMergerTest, CompoundSortKey) {
     ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
 }
 
+TEST_F(AsyncResultsMergerTest, HighFanoutSortedMerge) {
+    const int kNumRemotes = 200;
+    const int kDocsPerRemote = 50;
+
+    // Remote 'r' holds the values congruent to 'r' modulo the number of remotes, so that every
+    // result comes from a different remote than the one before it.
+    BSONObj findCmd = fromjson("{find: 'testcoll', sort: {a: -1}}");
+    std::vector<ClusterClientCursorParams::RemoteCursor> cursors;
+    for (int r = 0; r < kNumRemotes; ++r) {
+        std::vector<BSONObj> batch;
+        for (int i = kDocsPerRemote - 1; i >= 0; --i) {
+            batch.push_back(BSON("$sortKey" << BSON("" << i * kNumRemotes + r)));
+        }
+        cursors.emplace_back(kTestShardIds[r % kTestShardIds.size()],
+                             kTestShardHosts[r % kTestShardHosts.size()],
+                             CursorResponse(_nss, CursorId(0), batch));
+    }
+    makeCursorFromExistingCursors(std::move(cursors), findCmd);
+
+    // All of the results were delivered with the initial batches, so the ARM returns them in
+    // sorted order without scheduling any remote work.
+    ASSERT_TRUE(arm->ready());
+    ASSERT_TRUE(arm->remotesExhausted());
+    for (int expected = kNumRemotes * kDocsPerRemote - 1; expected >= 0; --expected) {
+        ASSERT_TRUE(arm->ready());
+        ASSERT_BSONOBJ_EQ(BSON("$sortKey" << BSON("" << expected)),
+                          *unittest::assertGet(arm->nextReady()).getResult());
+    }
+
+    ASSERT_TRUE(arm->ready());
+    ASSERT_TRUE(unittest::assertGet(arm->nextReady()).isEOF());
+}
+
 TEST_F(AsyncResultsMergerTest, SortedButNoSortKey) {
     BSONObj findCmd = fromjson("{find: 'testcoll', sort: {a: -1, b: 1}}");
     std::vector<ClusterClientCursorParams::RemoteCursor> cursors;
@@ -34,9 +34,11 @@
 
 #include <set>
 
+#include "mongo/stdx/memory.h"
 #include "mongo/util/clock_source.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -172,20 +174,26 @@ void ClusterCursorManager::PinnedCursor::returnAndKillCursor() {
 }
 
 ClusterCursorManager::ClusterCursorManager(ClockSource* clockSource)
-    : _clockSource(clockSource),
-      _pseudoRandom(std::unique_ptr<SecureRandom>(SecureRandom::create())->nextInt64()) {
+    : _clockSource(clockSource) {
     invariant(_clockSource);
+
+    std::unique_ptr<SecureRandom> secureRandom(SecureRandom::create());
+    for (uint32_t i = 0; i < kNumPartitions; ++i) {
+        _partitions.push_back(stdx::make_unique<Partition>(i, secureRandom->nextInt64()));
+    }
 }
 
 ClusterCursorManager::~ClusterCursorManager() {
-    invariant(_cursorIdPrefixToNamespaceMap.empty());
-    invariant(_namespaceToContainerMap.empty());
+    for (const auto& partition : _partitions) {
+        invariant(partition->cursorIdPrefixToNamespaceMap.empty());
+        invariant(partition->namespaceToContainerMap.empty());
+    }
 }
 
 void ClusterCursorManager::shutdown() {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
-    _inShutdown = true;
-    lk.unlock();
+    // Registration checks this flag under the partition mutex, so once killAllCursors() has
+    // visited a partition no new cursor can be registered in it.
+    _inShutdown.store(true);
 
     killAllCursors();
     reapZombieCursors();
@@ -200,9 +208,10 @@ StatusWith<CursorId> ClusterCursorManager::registerCursor(
     // Read the clock out of the lock.
     const auto now = _clockSource->now();
 
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    Partition& partition = getPartition(nss);
+    stdx::unique_lock<stdx::mutex> lk = partition.lock();
 
-    if (_inShutdown) {
+    if (_inShutdown.load()) {
         lk.unlock();
         cursor->kill(opCtx);
         return Status(ErrorCodes::ShutdownInProgress,
@@ -212,21 +221,25 @@ StatusWith<CursorId> ClusterCursorManager::registerCursor(
     invariant(cursor);
 
     // Find the CursorEntryContainer for this namespace.  If none exists, create one.
-    auto nsToContainerIt = _namespaceToContainerMap.find(nss);
-    if (nsToContainerIt == _namespaceToContainerMap.end()) {
+    auto nsToContainerIt = partition.namespaceToContainerMap.find(nss);
+    if (nsToContainerIt == partition.namespaceToContainerMap.end()) {
         uint32_t containerPrefix = 0;
         do {
             // The server has always generated positive values for CursorId (which is a signed
             // type), so we use std::abs() here on the prefix for consistency with this historical
-            // behavior.
-            containerPrefix = static_cast<uint32_t>(std::abs(_pseudoRandom.nextInt32()));
-        } while (_cursorIdPrefixToNamespaceMap.count(containerPrefix) > 0);
-        _cursorIdPrefixToNamespaceMap[containerPrefix] = nss;
+            // behavior.  The low bits are replaced by the partition index, so that
+            // getNamespaceForCursorId() knows which partition to search.
+            containerPrefix = static_cast<uint32_t>(std::abs(partition.pseudoRandom.nextInt32()));
+            containerPrefix = (containerPrefix & ~static_cast<uint32_t>(kNumPartitions - 1)) |
+                partition.index;
+        } while (partition.cursorIdPrefixToNamespaceMap.count(containerPrefix) > 0);
+        partition.cursorIdPrefixToNamespaceMap[containerPrefix] = nss;
 
         auto emplaceResult =
-            _namespaceToContainerMap.emplace(nss, CursorEntryContainer(containerPrefix));
+            partition.namespaceToContainerMap.emplace(nss, CursorEntryContainer(containerPrefix));
         invariant(emplaceResult.second);
-        invariant(_namespaceToContainerMap.size() == _cursorIdPrefixToNamespaceMap.size());
+        invariant(partition.namespaceToContainerMap.size() ==
+                  partition.cursorIdPrefixToNamespaceMap.size());
 
         nsToContainerIt = emplaceResult.first;
     } else {
@@ -238,7 +251,7 @@ StatusWith<CursorId> ClusterCursorManager::registerCursor(
     CursorEntryMap& entryMap = container.entryMap;
     CursorId cursorId = 0;
     do {
-        const uint32_t cursorSuffix = static_cast<uint32_t>(_pseudoRandom.nextInt32());
+        const uint32_t cursorSuffix = static_cast<uint32_t>(partition.pseudoRandom.nextInt32());
         cursorId = createCursorId(container.containerPrefix, cursorSuffix);
     } while (cursorId == 0 || entryMap.count(cursorId) > 0);
 
@@ -252,14 +265,15 @@ StatusWith<CursorId> ClusterCursorManager::registerCursor(
 
 StatusWith<ClusterCursorManager::PinnedCursor> ClusterCursorManager::checkOutCursor(
     const NamespaceString& nss, CursorId cursorId, OperationContext* opCtx) {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    Partition& partition = getPartition(nss);
+    stdx::unique_lock<stdx::mutex> lk = partition.lock();
 
-    if (_inShutdown) {
+    if (_inShutdown.load()) {
         return Status(ErrorCodes::ShutdownInProgress,
                       "Cannot check out cursor as we are in the process of shutting down");
     }
 
-    CursorEntry* entry = getEntry_inlock(nss, cursorId);
+    CursorEntry* entry = getEntry_inlock(&partition, nss, cursorId);
     if (!entry) {
         return cursorNotFoundStatus(nss, cursorId);
     }
@@ -283,13 +297,14 @@ void ClusterCursorManager::checkInCursor(std::unique_ptr<ClusterClientCursor> cu
     // Read the clock out of the lock.
     const auto now = _clockSource->now();
 
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    Partition& partition = getPartition(nss);
+    stdx::unique_lock<stdx::mutex> lk = partition.lock();
 
     invariant(cursor);
 
     const bool remotesExhausted = cursor->remotesExhausted();
 
-    CursorEntry* entry = getEntry_inlock(nss, cursorId);
+    CursorEntry* entry = getEntry_inlock(&partition, nss, cursorId);
     invariant(entry);
 
     entry->setLastActive(now);
@@ -308,7 +323,7 @@ void ClusterCursorManager::checkInCursor(std::unique_ptr<ClusterClientCursor> cu
 
     // The cursor is exhausted, is not already scheduled for deletion, and does not have any
     // remote cursor state left to clean up. We can delete the cursor right away.
-    auto detachedCursor = detachCursor_inlock(nss, cursorId);
+    auto detachedCursor = detachCursor_inlock(&partition, nss, cursorId);
     invariantOK(detachedCursor.getStatus());
 
     // Deletion of the cursor can happen out of the lock.
@@ -317,9 +332,10 @@ void ClusterCursorManager::checkInCursor(std::unique_ptr<ClusterClientCursor> cu
 }
 
 Status ClusterCursorManager::killCursor(const NamespaceString& nss, CursorId cursorId) {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    Partition& partition = getPartition(nss);
+    stdx::unique_lock<stdx::mutex> lk = partition.lock();
 
-    CursorEntry* entry = getEntry_inlock(nss, cursorId);
+    CursorEntry* entry = getEntry_inlock(&partition, nss, cursorId);
     if (!entry) {
         return cursorNotFoundStatus(nss, cursorId);
     }
@@ -330,28 +346,32 @@ Status ClusterCursorManager::killCursor(const NamespaceString& nss, CursorId cur
 }
 
 void ClusterCursorManager::killMortalCursorsInactiveSince(Date_t cutoff) {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
-
-    for (auto& nsContainerPair : _namespaceToContainerMap) {
-        for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
-            CursorEntry& entry = cursorIdEntryPair.second;
-            if (entry.getLifetimeType() == CursorLifetime::Mortal && entry.isCursorOwned() &&
-                entry.getLastActive() <= cutoff) {
-                entry.setInactive();
-                log() << "Marking cursor id " << cursorIdEntryPair.first
-                      << " for deletion, idle since " << entry.getLastActive().toString();
-                entry.setKillPending();
+    for (const auto& partition : _partitions) {
+        stdx::unique_lock<stdx::mutex> lk = partition->lock();
+
+        for (auto& nsContainerPair : partition->namespaceToContainerMap) {
+            for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
+                CursorEntry& entry = cursorIdEntryPair.second;
+                if (entry.getLifetimeType() == CursorLifetime::Mortal && entry.isCursorOwned() &&
+                    entry.getLastActive() <= cutoff) {
+                    entry.setInactive();
+                    log() << "Marking cursor id " << cursorIdEntryPair.first
+                          << " for deletion, idle since " << entry.getLastActive().toString();
+                    entry.setKillPending();
+                }
             }
         }
     }
 }
 
 void ClusterCursorManager::killAllCursors() {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    for (const auto& partition : _partitions) {
+        stdx::unique_lock<stdx::mutex> lk = partition->lock();
 
-    for (auto& nsContainerPair : _namespaceToContainerMap) {
-        for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
-            cursorIdEntryPair.second.setKillPending();
+        for (auto& nsContainerPair : partition->namespaceToContainerMap) {
+            for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
+                cursorIdEntryPair.second.setKillPending();
+            }
         }
     }
 }
@@ -366,76 +386,86 @@ std::size_t ClusterCursorManager::reapZombieCursors() {
         bool isInactive;
     };
 
-    // List all zombie cursors under the manager lock, and kill them one-by-one while not holding
-    // the lock (ClusterClientCursor::kill() is blocking, so we don't want to hold a lock while
-    // issuing the kill).
-
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
-    std::vector<CursorDescriptor> zombieCursorDescriptors;
-    for (auto& nsContainerPair : _namespaceToContainerMap) {
-        const NamespaceString& nss = nsContainerPair.first;
-        for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
-            CursorId cursorId = cursorIdEntryPair.first;
-            const CursorEntry& entry = cursorIdEntryPair.second;
-            if (!entry.getKillPending()) {
-                continue;
-            }
-            zombieCursorDescriptors.emplace_back(nss, cursorId, entry.isInactive());
-        }
-    }
-
     std::size_t cursorsTimedOut = 0;
 
-    for (auto& cursorDescriptor : zombieCursorDescriptors) {
-        StatusWith<std::unique_ptr<ClusterClientCursor>> zombieCursor =
-            detachCursor_inlock(cursorDescriptor.ns, cursorDescriptor.cursorId);
-        if (!zombieCursor.isOK()) {
-            // Cursor in use, or has already been deleted.
-            continue;
+    for (const auto& partition : _partitions) {
+        // List all zombie cursors in the partition under its lock, and kill them one-by-one while
+        // not holding the lock (ClusterClientCursor::kill() is blocking, so we don't want to hold a
+        // lock while issuing the kill).
+
+        stdx::unique_lock<stdx::mutex> lk = partition->lock();
+        std::vector<CursorDescriptor> zombieCursorDescriptors;
+        for (auto& nsContainerPair : partition->namespaceToContainerMap) {
+            const NamespaceString& nss = nsContainerPair.first;
+            for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
+                CursorId cursorId = cursorIdEntryPair.first;
+                const CursorEntry& entry = cursorIdEntryPair.second;
+                if (!entry.getKillPending()) {
+                    continue;
+                }
+                zombieCursorDescriptors.emplace_back(nss, cursorId, entry.isInactive());
+            }
         }
 
-        lk.unlock();
-        // Pass a null OperationContext, because this call should not actually schedule any remote
-        // work: the cursor is already pending kill, meaning the killCursors commands are already
-        // being scheduled to be sent to the remote shard hosts. This method will just wait for them
-        // all to be scheduled.
-        zombieCursor.getValue()->kill(nullptr);
-        zombieCursor.getValue().reset();
-        lk.lock();
+        for (auto& cursorDescriptor : zombieCursorDescriptors) {
+            StatusWith<std::unique_ptr<ClusterClientCursor>> zombieCursor = detachCursor_inlock(
+                partition.get(), cursorDescriptor.ns, cursorDescriptor.cursorId);
+            if (!zombieCursor.isOK()) {
+                // Cursor in use, or has already been deleted.
+                continue;
+            }
 
-        if (cursorDescriptor.isInactive) {
-            ++cursorsTimedOut;
+            lk.unlock();
+            // Pass a null OperationContext, because this call should not actually schedule any
+            // remote work: the cursor is already pending kill, meaning the killCursors commands are
+            // already being scheduled to be sent to the remote shard hosts. This method will just
+            // wait for them all to be scheduled.
+            zombieCursor.getValue()->kill(nullptr);
+            zombieCursor.getValue().reset();
+            lk.lock();
+
+            if (cursorDescriptor.isInactive) {
+                ++cursorsTimedOut;
+            }
         }
     }
     return cursorsTimedOut;
 }
 
 ClusterCursorManager::Stats ClusterCursorManager::stats() const {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
-
     Stats stats;
 
-    for (auto& nsContainerPair : _namespaceToContainerMap) {
-        for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
-            const CursorEntry& entry = cursorIdEntryPair.second;
-
-            if (entry.getKillPending()) {
-                // Killed cursors do not count towards the number of pinned cursors or the number of
-                // open cursors.
-                continue;
-            }
-
-            if (!entry.isCursorOwned()) {
-                ++stats.cursorsPinned;
-            }
-
-            switch (entry.getCursorType()) {
-                case CursorType::NamespaceNotSharded:
-                    ++stats.cursorsNotSharded;
-                    break;
-                case CursorType::NamespaceSharded:
-                    ++stats.cursorsSharded;
-                    break;
+    for (const auto& partition : _partitions) {
+        // Read the lock counters before acquiring the lock, so that the acquisition below is not
+        // included in them.
+        stats.partitionLockAcquisitions += partition->lockAcquisitions.load();
+        stats.partitionLockContentions += partition->lockContentions.load();
+        stats.partitionLockWaitMicros += partition->lockWaitMicros.load();
+
+        stdx::unique_lock<stdx::mutex> lk = partition->lock();
+
+        for (auto& nsContainerPair : partition->namespaceToContainerMap) {
+            for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
+                const CursorEntry& entry = cursorIdEntryPair.second;
+
+                if (entry.getKillPending()) {
+                    // Killed cursors do not count towards the number of pinned cursors or the
+                    // number of open cursors.
+                    continue;
+                }
+
+                if (!entry.isCursorOwned()) {
+                    ++stats.cursorsPinned;
+                }
+
+                switch (entry.getCursorType()) {
+                    case CursorType::NamespaceNotSharded:
+                        ++stats.cursorsNotSharded;
+                        break;
+                    case CursorType::NamespaceSharded:
+                        ++stats.cursorsSharded;
+                        break;
+                }
             }
         }
     }
@@ -445,19 +475,26 @@ ClusterCursorManager::Stats ClusterCursorManager::stats() const {
 
 boost::optional<NamespaceString> ClusterCursorManager::getNamespaceForCursorId(
     CursorId cursorId) const {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    const uint32_t prefix = extractPrefixFromCursorId(cursorId);
+    Partition& partition = *_partitions[prefix % kNumPartitions];
+    stdx::unique_lock<stdx::mutex> lk = partition.lock();
 
-    const auto it = _cursorIdPrefixToNamespaceMap.find(extractPrefixFromCursorId(cursorId));
-    if (it == _cursorIdPrefixToNamespaceMap.end()) {
+    const auto it = partition.cursorIdPrefixToNamespaceMap.find(prefix);
+    if (it == partition.cursorIdPrefixToNamespaceMap.end()) {
         return boost::none;
     }
     return it->second;
 }
 
-ClusterCursorManager::CursorEntry* ClusterCursorManager::getEntry_inlock(const NamespaceString& nss,
-                                                                         CursorId cursorId) {
-    auto nsToContainerIt = _namespaceToContainerMap.find(nss);
-    if (nsToContainerIt == _namespaceToContainerMap.end()) {
+ClusterCursorManager::Partition& ClusterCursorManager::getPartition(
+    const NamespaceString& nss) const {
+    return *_partitions[NamespaceString::Hasher()(nss) % kNumPartitions];
+}
+
+ClusterCursorManager::CursorEntry* ClusterCursorManager::getEntry_inlock(
+    Partition* partition, const NamespaceString& nss, CursorId cursorId) {
+    auto nsToContainerIt = partition->namespaceToContainerMap.find(nss);
+    if (nsToContainerIt == partition->namespaceToContainerMap.end()) {
         return nullptr;
     }
     CursorEntryMap& entryMap = nsToContainerIt->second.entryMap;
@@ -470,8 +507,8 @@ ClusterCursorManager::CursorEntry* ClusterCursorManager::getEntry_inlock(const N
 }
 
 StatusWith<std::unique_ptr<ClusterClientCursor>> ClusterCursorManager::detachCursor_inlock(
-    const NamespaceString& nss, CursorId cursorId) {
-    CursorEntry* entry = getEntry_inlock(nss, cursorId);
+    Partition* partition, const NamespaceString& nss, CursorId cursorId) {
+    CursorEntry* entry = getEntry_inlock(partition, nss, cursorId);
     if (!entry) {
         return cursorNotFoundStatus(nss, cursorId);
     }
@@ -481,8 +518,8 @@ StatusWith<std::unique_ptr<ClusterClientCursor>> ClusterCursorManager::detachCur
         return cursorInUseStatus(nss, cursorId);
     }
 
-    auto nsToContainerIt = _namespaceToContainerMap.find(nss);
-    invariant(nsToContainerIt != _namespaceToContainerMap.end());
+    auto nsToContainerIt = partition->namespaceToContainerMap.find(nss);
+    invariant(nsToContainerIt != partition->namespaceToContainerMap.end());
     CursorEntryMap& entryMap = nsToContainerIt->second.entryMap;
     size_t eraseResult = entryMap.erase(cursorId);
     invariant(1 == eraseResult);
@@ -490,13 +527,31 @@ StatusWith<std::unique_ptr<ClusterClientCursor>> ClusterCursorManager::detachCur
         // This was the last cursor remaining in the given namespace.  Erase all state associated
         // with this namespace.
         size_t numDeleted =
-            _cursorIdPrefixToNamespaceMap.erase(nsToContainerIt->second.containerPrefix);
+            partition->cursorIdPrefixToNamespaceMap.erase(nsToContainerIt->second.containerPrefix);
         invariant(numDeleted == 1);
-        _namespaceToContainerMap.erase(nsToContainerIt);
-        invariant(_namespaceToContainerMap.size() == _cursorIdPrefixToNamespaceMap.size());
+        partition->namespaceToContainerMap.erase(nsToContainerIt);
+        invariant(partition->namespaceToContainerMap.size() ==
+                  partition->cursorIdPrefixToNamespaceMap.size());
     }
 
     return std::move(cursor);
 }
 
+//
+// ClusterCursorManager::Partition
+//
+
+stdx::unique_lock<stdx::mutex> ClusterCursorManager::Partition::lock() {
+    lockAcquisitions.fetchAndAdd(1);
+
+    stdx::unique_lock<stdx::mutex> lk(mutex, stdx::try_to_lock);
+    if (!lk.owns_lock()) {
+        Timer waitTimer;
+        lk.lock();
+        lockContentions.fetchAndAdd(1);
+        lockWaitMicros.fetchAndAdd(waitTimer.micros());
+    }
+    return lk;
+}
+
 }  // namespace mongo
@@ -33,6 +33,7 @@
 
 #include "mongo/db/cursor_id.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/platform/random.h"
 #include "mongo/s/query/cluster_client_cursor.h"
 #include "mongo/stdx/mutex.h"
@@ -108,6 +109,15 @@ public:
 
         // Count of pinned cursors.
         size_t cursorsPinned = 0;
+
+        // Number of times a partition mutex was acquired, summed across partitions.
+        unsigned long long partitionLockAcquisitions = 0;
+
+        // Number of those acquisitions which found the mutex already held by another thread.
+        unsigned long long partitionLockContentions = 0;
+
+        // Total time spent waiting for contended partition mutexes, in microseconds.
+        unsigned long long partitionLockWaitMicros = 0;
     };
 
     /**
@@ -358,8 +368,20 @@ public:
         return _cursorsTimedOut;
     }
 
+    /**
+     * Returns the number of partitions the registered cursors are spread across.
+     */
+    static constexpr size_t numPartitions() {
+        return kNumPartitions;
+    }
+
 private:
+    // Must be a power of two, so that a partition index fits in the low bits of every cursor id
+    // prefix without changing the range of prefixes that can be generated.
+    static constexpr size_t kNumPartitions = 16;
+
     class CursorEntry;
+    struct Partition;
     using CursorEntryMap = stdx::unordered_map<CursorId, CursorEntry>;
 
     /**
@@ -381,13 +403,20 @@ private:
                        CursorId cursorId,
                        CursorState cursorState);
 
+    /**
+     * Returns the partition holding the cursors registered on 'nss'.
+     */
+    Partition& getPartition(const NamespaceString& nss) const;
+
     /**
      * Returns a pointer to the CursorEntry for the given cursor.  If the given cursor is not
      * registered, returns null.
      *
-     * Not thread-safe.
+     * Not thread-safe: the mutex of 'partition' must be held.
      */
-    CursorEntry* getEntry_inlock(const NamespaceString& nss, CursorId cursorId);
+    CursorEntry* getEntry_inlock(Partition* partition,
+                                 const NamespaceString& nss,
+                                 CursorId cursorId);
 
     /**
      * De-registers the given cursor, and returns an owned pointer to the underlying
@@ -396,10 +425,10 @@ private:
      * If the given cursor is pinned, returns an error Status with code CursorInUse.  If the given
      * cursor is not registered, returns an error Status with code CursorNotFound.
      *
-     * Not thread-safe.
+     * Not thread-safe: the mutex of 'partition' must be held.
      */
-    StatusWith<std::unique_ptr<ClusterClientCursor>> detachCursor_inlock(const NamespaceString& nss,
-                                                                         CursorId cursorId);
+    StatusWith<std::unique_ptr<ClusterClientCursor>> detachCursor_inlock(
+        Partition* partition, const NamespaceString& nss, CursorId cursorId);
 
     /**
      * CursorEntry is a moveable, non-copyable container for a single cursor.
@@ -505,36 +534,67 @@ private:
         CursorEntryMap entryMap;
     };
 
-    // Clock source.  Used when the 'last active' time for a cursor needs to be set/updated.  May be
-    // concurrently accessed by multiple threads.
-    ClockSource* _clockSource;
+    /**
+     * Partition is the unit of locking for the manager.  Each namespace is assigned to a single
+     * partition by hashing, so all of the cursors registered on a namespace live in the same
+     * partition, and each partition owns the cursor id prefixes of its namespaces.
+     */
+    struct Partition {
+        MONGO_DISALLOW_COPYING(Partition);
 
-    // Synchronizes access to all private state variables below.
-    mutable stdx::mutex _mutex;
+        Partition(uint32_t index, int64_t seed) : index(index), pseudoRandom(seed) {}
 
-    bool _inShutdown{false};
+        /**
+         * Acquires 'mutex', recording whether the acquisition was contended and if so, for how
+         * long the caller had to wait.
+         */
+        stdx::unique_lock<stdx::mutex> lock();
+
+        // The position of this partition in '_partitions'.
+        const uint32_t index;
+
+        // Synchronizes access to all state variables below, other than the lock counters.
+        stdx::mutex mutex;
+
+        // Randomness source.  Used for cursor id generation.
+        PseudoRandom pseudoRandom;
+
+        // Map from cursor id prefix to associated namespace.  Exists only to provide namespace
+        // lookup for (deprecated) getNamespaceForCursorId() method.
+        //
+        // A CursorId is a 64-bit type, made up of a 32-bit prefix and a 32-bit suffix.  When the
+        // first cursor on a given namespace is registered, it is given a CursorId with a prefix
+        // that is unique to that namespace, and an arbitrary suffix.  Cursors subsequently
+        // registered on that namespace will all share the same prefix.  The low bits of every
+        // prefix hold the index of the partition which generated it.
+        //
+        // Entries are added when the first cursor on the given namespace is registered, and
+        // removed when the last cursor on the given namespace is destroyed.
+        stdx::unordered_map<uint32_t, NamespaceString> cursorIdPrefixToNamespaceMap;
+
+        // Map from namespace to the CursorEntryContainer for that namespace.
+        //
+        // Entries are added when the first cursor on the given namespace is registered, and
+        // removed when the last cursor on the given namespace is destroyed.
+        stdx::unordered_map<NamespaceString, CursorEntryContainer, NamespaceString::Hasher>
+            namespaceToContainerMap;
+
+        // Lock statistics, reported through stats().
+        AtomicUInt64 lockAcquisitions;
+        AtomicUInt64 lockContentions;
+        AtomicUInt64 lockWaitMicros;
+    };
 
-    // Randomness source.  Used for cursor id generation.
-    PseudoRandom _pseudoRandom;
+    // Clock source.  Used when the 'last active' time for a cursor needs to be set/updated.  May be
+    // concurrently accessed by multiple threads.
+    ClockSource* _clockSource;
 
-    // Map from cursor id prefix to associated namespace.  Exists only to provide namespace lookup
-    // for (deprecated) getNamespaceForCursorId() method.
-    //
-    // A CursorId is a 64-bit type, made up of a 32-bit prefix and a 32-bit suffix.  When the first
-    // cursor on a given namespace is registered, it is given a CursorId with a prefix that is
-    // unique to that namespace, and an arbitrary suffix.  Cursors subsequently registered on that
-    // namespace will all share the same prefix.
-    //
-    // Entries are added when the first cursor on the given namespace is registered, and removed
-    // when the last cursor on the given namespace is destroyed.
-    stdx::unordered_map<uint32_t, NamespaceString> _cursorIdPrefixToNamespaceMap;
+    AtomicWord<bool> _inShutdown{false};
 
-    // Map from namespace to the CursorEntryContainer for that namespace.
-    //
-    // Entries are added when the first cursor on the given namespace is registered, and removed
-    // when the last cursor on the given namespace is destroyed.
-    stdx::unordered_map<NamespaceString, CursorEntryContainer, NamespaceString::Hasher>
-        _namespaceToContainerMap;
+    // The partitions of the registered cursors, indexed by partition number.  The vector itself is
+    // never modified after construction.  If a thread needs to hold more than one partition mutex
+    // at a time, it must acquire them in ascending order of partition number.
+    std::vector<std::unique_ptr<Partition>> _partitions;
 
     size_t _cursorsTimedOut = 0;
 };
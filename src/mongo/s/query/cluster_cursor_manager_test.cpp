@@ -34,6 +34,7 @@
 
 #include "mongo/s/query/cluster_client_cursor_mock.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/clock_source_mock.h"
 
@@ -686,6 +687,26 @@ TEST_F(ClusterCursorManagerTest, StatsCheckInWithoutExhaustingPinnedCursor) {
     ASSERT_EQ(0U, getManager()->stats().cursorsPinned);
 }
 
+// Test that every partition lock acquisition is counted in stats(), and that uncontended
+// acquisitions are not counted as contended.
+TEST_F(ClusterCursorManagerTest, StatsCountPartitionLockAcquisitions) {
+    const auto before = getManager()->stats();
+    auto cursorId = assertGet(
+        getManager()->registerCursor(nullptr,
+                                     allocateMockCursor(),
+                                     nss,
+                                     ClusterCursorManager::CursorType::NamespaceNotSharded,
+                                     ClusterCursorManager::CursorLifetime::Mortal));
+    ASSERT_OK(getManager()->killCursor(nss, cursorId));
+
+    // stats() itself locks every partition once.
+    const auto after = getManager()->stats();
+    ASSERT_EQ(before.partitionLockAcquisitions + ClusterCursorManager::numPartitions() + 2,
+              after.partitionLockAcquisitions);
+    ASSERT_EQ(0U, after.partitionLockContentions);
+    ASSERT_EQ(0U, after.partitionLockWaitMicros);
+}
+
 // Test that getting the namespace for a cursor returns the correct namespace.
 TEST_F(ClusterCursorManagerTest, GetNamespaceForCursorIdBasic) {
     auto cursorId = assertGet(
@@ -942,6 +963,57 @@ TEST_F(ClusterCursorManagerTest, CannotCheckoutCursorDuringShutdown) {
                   getManager()->checkOutCursor(nss, cursorId, nullptr).getStatus());
 }
 
+// Test that cursors on many namespaces, and hence many partitions, can be registered, checked out
+// and killed concurrently.
+TEST_F(ClusterCursorManagerTest, ConcurrentOperationsAcrossNamespaces) {
+    const size_t numThreads = 8;
+    const size_t numCursorsPerThread = 50;
+
+    // The mock cursors are allocated up front, as the fixture's kill flags are not thread-safe.
+    std::vector<std::vector<std::unique_ptr<ClusterClientCursorMock>>> threadCursors(numThreads);
+    for (auto& cursors : threadCursors) {
+        for (size_t i = 0; i < numCursorsPerThread; ++i) {
+            cursors.push_back(allocateMockCursor());
+        }
+    }
+
+    std::vector<std::vector<std::pair<NamespaceString, CursorId>>> registered(numThreads);
+    std::vector<stdx::thread> threads;
+    for (size_t t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&, t] {
+            for (size_t i = 0; i < numCursorsPerThread; ++i) {
+                NamespaceString cursorNamespace(std::string(str::stream() << "test.collection"
+                                                                          << i));
+                auto cursorId = assertGet(getManager()->registerCursor(
+                    nullptr,
+                    std::move(threadCursors[t][i]),
+                    cursorNamespace,
+                    ClusterCursorManager::CursorType::NamespaceNotSharded,
+                    ClusterCursorManager::CursorLifetime::Mortal));
+                auto pinnedCursor =
+                    assertGet(getManager()->checkOutCursor(cursorNamespace, cursorId, nullptr));
+                pinnedCursor.returnCursor(ClusterCursorManager::CursorState::NotExhausted);
+                registered[t].emplace_back(cursorNamespace, cursorId);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(numThreads * numCursorsPerThread, getManager()->stats().cursorsNotSharded);
+    for (const auto& cursors : registered) {
+        for (const auto& cursor : cursors) {
+            boost::optional<NamespaceString> cursorNamespace =
+                getManager()->getNamespaceForCursorId(cursor.second);
+            ASSERT(cursorNamespace);
+            ASSERT_EQ(cursor.first.ns(), cursorNamespace->ns());
+            ASSERT_OK(getManager()->killCursor(cursor.first, cursor.second));
+        }
+    }
+    ASSERT_EQ(0U, getManager()->stats().cursorsNotSharded);
+}
+
 }  // namespace
 
 }  // namespace mongo
@@ -87,6 +87,8 @@
 #include "mongo/s/version_mongos.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/thread.h"
+#include "mongo/transport/service_executor_adaptive.h"
+#include "mongo/transport/transport_layer_asio.h"
 #include "mongo/transport/transport_layer_legacy.h"
 #include "mongo/util/admin_access.h"
 #include "mongo/util/cmdline_utils/censor_cmdline.h"
@@ -250,22 +252,45 @@ static ExitCode runMongosServer() {
 
     _initWireSpec();
 
-    transport::TransportLayerLegacy::Options opts;
-    opts.port = serverGlobalParams.port;
-    opts.ipList = serverGlobalParams.bind_ip;
-
     auto sep =
         stdx::make_unique<ServiceEntryPointMongos>(getGlobalServiceContext()->getTransportLayer());
     auto sepPtr = sep.get();
 
     getGlobalServiceContext()->setServiceEntryPoint(std::move(sep));
 
-    auto transportLayer = stdx::make_unique<transport::TransportLayerLegacy>(opts, sepPtr);
-    auto res = transportLayer->setup();
+    std::unique_ptr<transport::TransportLayer> transportLayer;
+    Status res = Status::OK();
+    if (serverGlobalParams.transportLayer == "asio") {
+        transport::TransportLayerASIO::Options opts;
+        opts.port = serverGlobalParams.port;
+        opts.ipList = serverGlobalParams.bind_ip;
+
+        auto asioTL = stdx::make_unique<transport::TransportLayerASIO>(opts, sepPtr);
+        res = asioTL->setup();
+        transportLayer = std::move(asioTL);
+    } else {
+        transport::TransportLayerLegacy::Options opts;
+        opts.port = serverGlobalParams.port;
+        opts.ipList = serverGlobalParams.bind_ip;
+
+        auto legacyTL = stdx::make_unique<transport::TransportLayerLegacy>(opts, sepPtr);
+        res = legacyTL->setup();
+        transportLayer = std::move(legacyTL);
+    }
     if (!res.isOK()) {
         return EXIT_NET_ERROR;
     }
 
+    if (serverGlobalParams.serviceExecutor == "adaptive") {
+        auto exec = stdx::make_unique<transport::ServiceExecutorAdaptive>(
+            getGlobalServiceContext()->getTickSource());
+        auto status = exec->start();
+        if (!status.isOK()) {
+            return EXIT_NET_ERROR;
+        }
+        getGlobalServiceContext()->setServiceExecutor(std::move(exec));
+    }
+
     auto unshardedHookList = stdx::make_unique<rpc::EgressMetadataHookList>();
     unshardedHookList->addHook(
         stdx::make_unique<rpc::LogicalTimeMetadataHook>(getGlobalServiceContext()));
@@ -38,6 +38,7 @@
 #include "mongo/db/index_names.h"
 #include "mongo/db/matcher/extensions_callback_noop.h"
 #include "mongo/db/query/canonical_query.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/db/update/path_support.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/transitional_tools_do_not_use/vector_spooling.h"
@@ -128,6 +129,11 @@ Status ShardKeyPattern::checkShardKeySize(const BSONObj& shardKey) {
                           << " bytes"};
 }
 
+std::string ShardKeyPattern::toKeyString(const BSONObj& shardKey) {
+    KeyString ks(KeyString::Version::V1, shardKey, Ordering::make(BSONObj()));
+    return {ks.getBuffer(), ks.getSize()};
+}
+
 ShardKeyPattern::ShardKeyPattern(const BSONObj& keyPattern)
     : _keyPatternPaths(parseShardKeyPattern(keyPattern)),
       _keyPattern(_keyPatternPaths.empty() ? BSONObj() : keyPattern) {}
@@ -279,6 +285,10 @@ StatusWith<BSONObj> ShardKeyPattern::extractShardKeyFromQuery(OperationContext*
     if (!isValid())
         return StatusWith<BSONObj>(BSONObj());
 
+    BSONObj simpleShardKey = extractShardKeyFromSimpleEqualityQuery(basicQuery);
+    if (!simpleShardKey.isEmpty())
+        return simpleShardKey;
+
     auto qr = stdx::make_unique<QueryRequest>(NamespaceString(""));
     qr->setFilter(basicQuery);
 
@@ -292,6 +302,49 @@ StatusWith<BSONObj> ShardKeyPattern::extractShardKeyFromQuery(OperationContext*
     return extractShardKeyFromQuery(*query);
 }
 
+BSONObj ShardKeyPattern::extractShardKeyFromSimpleEqualityQuery(const BSONObj& basicQuery) const {
+    if (!isValid())
+        return BSONObj();
+
+    // Only top-level equalities to scalars have the same meaning in the query language as in a
+    // document, everything else needs to be parsed. Equalities to null also match missing fields.
+    for (const auto& queryEl : basicQuery) {
+        if (queryEl.fieldNameStringData().startsWith("$"))
+            return BSONObj();
+
+        switch (queryEl.type()) {
+            case Object:
+            case Array:
+            case RegEx:
+            case jstNULL:
+            case Undefined:
+                return BSONObj();
+            default:
+                break;
+        }
+    }
+
+    BSONObjBuilder keyBuilder;
+    for (auto it = _keyPatternPaths.begin(); it != _keyPatternPaths.end(); ++it) {
+        const StringData patternPath = (*it)->dottedField();
+        BSONElement equalEl = basicQuery[patternPath];
+
+        if (!isShardKeyElement(equalEl, false))
+            return BSONObj();
+
+        if (isHashedPattern()) {
+            keyBuilder.append(
+                patternPath,
+                BSONElementHasher::hash64(equalEl, BSONElementHasher::DEFAULT_HASH_SEED));
+        } else {
+            keyBuilder.appendAs(equalEl, patternPath);
+        }
+    }
+
+    dassert(isShardKey(keyBuilder.asTempObj()));
+    return keyBuilder.obj();
+}
+
 BSONObj ShardKeyPattern::extractShardKeyFromQuery(const CanonicalQuery& query) const {
     if (!isValid())
         return BSONObj();
@@ -76,6 +76,13 @@ public:
      */
     static Status checkShardKeySize(const BSONObj& shardKey);
 
+    /**
+     * Encodes a shard key (or a prefix of one) as a KeyString. Comparing two encodings with
+     * memcmp orders them the same way the simple BSON comparator orders the keys, ignoring field
+     * names. The chunk maps in ChunkManager are indexed by these encodings.
+     */
+    static std::string toKeyString(const BSONObj& shardKey);
+
     /**
      * Constructs a shard key pattern from a BSON pattern document.  If the document is not a
      * valid shard key pattern, !isValid() will be true and key extraction will fail.
@@ -172,6 +179,25 @@ public:
                                                  const BSONObj& basicQuery) const;
     BSONObj extractShardKeyFromQuery(const CanonicalQuery& query) const;
 
+    /**
+     * Fast path of extractShardKeyFromQuery for the queries, which consist only of top-level
+     * equalities to scalar values, e.g. { a : 10, b : "hi" }. Extracts the shard key without
+     * parsing the query, so is cheap enough to try before canonicalizing it.
+     *
+     * Returns an empty BSONObj() if the query is not such a simple equality query or if it does
+     * not contain the full shard key. This does not mean that the query contains no shard key, so
+     * the query needs to be canonicalized in that case.
+     *
+     * Examples:
+     *  If the key pattern is { a : 1 }
+     *   { a : "hi", b : 4 } --> returns { a : "hi" }
+     *   { a : { $eq : "hi" }, b : 4 } --> returns {}
+     *  If the key pattern is { 'a.b' : 1 }
+     *   { 'a.b' : "hi" } --> returns { 'a.b' : "hi" }
+     *   { a : { b : "hi" } } --> returns {}
+     */
+    BSONObj extractShardKeyFromSimpleEqualityQuery(const BSONObj& basicQuery) const;
+
     /**
      * Returns true if the shard key pattern can ensure that the unique index pattern is
      * respected across all shards.
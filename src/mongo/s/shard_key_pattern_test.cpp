@@ -396,6 +396,48 @@ TEST(ShardKeyPattern, ExtractQueryShardKeyDeepNested) {
                       BSONObj());
 }
 
+TEST(ShardKeyPattern, ExtractSimpleEqualityQueryShardKey) {
+    //
+    // Fast path for the top-level equalities to scalars
+    //
+
+    ShardKeyPattern pattern(BSON("a" << 1 << "b.c" << 1));
+    ASSERT_BSONOBJ_EQ(pattern.extractShardKeyFromSimpleEqualityQuery(
+                          fromjson("{a:10, 'b.c':'20', d:30}")),
+                      fromjson("{a:10, 'b.c':'20'}"));
+    ASSERT_BSONOBJ_EQ(pattern.extractShardKeyFromSimpleEqualityQuery(
+                          fromjson("{'b.c':'20', a:10}")),
+                      fromjson("{a:10, 'b.c':'20'}"));
+
+    // Anything but top-level equalities to scalars is left to the full query parsing
+    ASSERT_BSONOBJ_EQ(pattern.extractShardKeyFromSimpleEqualityQuery(fromjson("{a:10}")),
+                      BSONObj());
+    ASSERT_BSONOBJ_EQ(pattern.extractShardKeyFromSimpleEqualityQuery(
+                          fromjson("{a:10, b:{c:'20'}}")),
+                      BSONObj());
+    ASSERT_BSONOBJ_EQ(pattern.extractShardKeyFromSimpleEqualityQuery(
+                          fromjson("{a:{$eq:10}, 'b.c':'20'}")),
+                      BSONObj());
+    ASSERT_BSONOBJ_EQ(pattern.extractShardKeyFromSimpleEqualityQuery(
+                          fromjson("{a:10, 'b.c':'20', d:{$gt:30}}")),
+                      BSONObj());
+    ASSERT_BSONOBJ_EQ(pattern.extractShardKeyFromSimpleEqualityQuery(
+                          fromjson("{a:10, 'b.c':'20', $comment:'x'}")),
+                      BSONObj());
+    ASSERT_BSONOBJ_EQ(pattern.extractShardKeyFromSimpleEqualityQuery(
+                          fromjson("{a:null, 'b.c':'20'}")),
+                      BSONObj());
+    ASSERT_BSONOBJ_EQ(pattern.extractShardKeyFromSimpleEqualityQuery(
+                          fromjson("{a:[10], 'b.c':'20'}")),
+                      BSONObj());
+
+    // The queries left out of the fast path still have their shard key extracted
+    ASSERT_BSONOBJ_EQ(queryKey(pattern, fromjson("{a:10, 'b.c':'20', d:30}")),
+                      fromjson("{a:10, 'b.c':'20'}"));
+    ASSERT_BSONOBJ_EQ(queryKey(pattern, fromjson("{a:10, b:{c:'20'}}")),
+                      fromjson("{a:10, 'b.c':'20'}"));
+}
+
 TEST(ShardKeyPattern, ExtractQueryShardKeyHashed) {
     //
     // Hashed ShardKeyPattern
@@ -501,4 +543,27 @@ TEST(ShardKeyPattern, UniqueIndexCompatibleHashed) {
     ASSERT(!indexComp(pattern, BSON("c" << 1)));
     ASSERT(!indexComp(pattern, BSON("c" << -1 << "a.b" << 1)));
 }
+
+TEST(ShardKeyPattern, KeyStringOrderMatchesSimpleBSONOrder) {
+    std::vector<BSONObj> keys{BSON("a" << MINKEY),
+                              BSON("a" << -1.5),
+                              BSON("a" << 1),
+                              BSON("a" << 1 << "b" << MINKEY),
+                              BSON("a" << 1 << "b"
+                                       << "x"),
+                              BSON("a" << 2LL),
+                              BSON("a"
+                                   << "abc"),
+                              BSON("a" << OID()),
+                              BSON("a" << MAXKEY)};
+
+    for (size_t i = 1; i < keys.size(); ++i) {
+        ASSERT_LT(ShardKeyPattern::toKeyString(keys[i - 1]), ShardKeyPattern::toKeyString(keys[i]))
+            << keys[i - 1] << " must sort before " << keys[i];
+    }
+
+    // Numerically equal keys have the same encoding regardless of their type
+    ASSERT_EQ(ShardKeyPattern::toKeyString(BSON("a" << 1)),
+              ShardKeyPattern::toKeyString(BSON("a" << 1.0)));
+}
 }
@@ -89,6 +89,9 @@ MONGO_EXPORT_STARTUP_SERVER_PARAMETER(ShardingTaskExecutorPoolRefreshRequirement
 MONGO_EXPORT_STARTUP_SERVER_PARAMETER(ShardingTaskExecutorPoolRefreshTimeoutMS,
                                       int,
                                       ConnectionPool::kDefaultRefreshTimeout.count());
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(ShardingTaskExecutorPoolRefreshJitterMS,
+                                      int,
+                                      ConnectionPool::kDefaultRefreshRequirement.count() / 10);
 
 namespace {
 
@@ -186,6 +189,7 @@ Status initializeGlobalShardingState(OperationContext* opCtx,
     connPoolOptions.minConnections = ShardingTaskExecutorPoolMinSize;
     connPoolOptions.refreshRequirement = Milliseconds(ShardingTaskExecutorPoolRefreshRequirementMS);
     connPoolOptions.refreshTimeout = Milliseconds(ShardingTaskExecutorPoolRefreshTimeoutMS);
+    connPoolOptions.refreshJitter = Milliseconds(ShardingTaskExecutorPoolRefreshJitterMS);
 
     auto network =
         executor::makeNetworkInterface("NetworkInterfaceASIO-ShardRegistry",
@@ -38,6 +38,7 @@
 #include "mongo/bson/util/builder.h"
 #include "mongo/client/connection_string.h"
 #include "mongo/client/remote_command_targeter.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/executor/task_executor_pool.h"
 #include "mongo/s/async_requests_sender.h"
 #include "mongo/s/client/shard_registry.h"
@@ -78,6 +79,10 @@ static void noteStaleResponses(const vector<ShardError*>& staleErrors, NSTargete
     }
 }
 
+// Whether the next batches of unordered writes are sent to each shard as soon as it responds,
+// rather than once all the shards have responded
+MONGO_EXPORT_SERVER_PARAMETER(enablePipelinedWrites, bool, true);
+
 // The number of times we'll try to continue a batch op if no progress is being made
 // This only applies when no writes are occurring and metadata is not changing on reload
 static const int kMaxRoundsWithoutProgress(5);
@@ -145,163 +150,187 @@ void BatchWriteExec::executeBatch(OperationContext* opCtx,
         // Send all child batches
         //
 
-        size_t numSent = 0;
-        size_t numToSend = childBatches.size();
-        while (numSent != numToSend) {
-            // Collect batches out on the network, mapped by endpoint
-            OwnedShardBatchMap ownedPendingBatches;
-            OwnedShardBatchMap::MapType& pendingBatches = ownedPendingBatches.mutableMap();
+        // Batches out on the network, mapped by shard. Every shard has at most one.
+        OwnedShardBatchMap ownedPendingBatches;
+        OwnedShardBatchMap::MapType& pendingBatches = ownedPendingBatches.mutableMap();
 
-            //
-            // Construct the requests.
-            //
+        // Builds the request for a batch, which then becomes pending on its shard
+        auto prepareRequest = [&](TargetedWriteBatch* nextBatch) {
+            const ShardId& targetShardId = nextBatch->getEndpoint().shardName;
+            invariant(pendingBatches.find(targetShardId) == pendingBatches.end());
 
-            vector<AsyncRequestsSender::Request> requests;
+            BatchedCommandRequest request(clientRequest.getBatchType());
+            batchOp.buildBatchRequest(*nextBatch, &request);
 
-            // Get as many batches as we can at once
-            for (auto it = childBatches.begin(); it != childBatches.end(); ++it) {
+            // Internally we use full namespaces for request/response, but we send the
+            // command to a database with the collection name in the request.
+            NamespaceString nss(request.getNS());
+            request.setNS(nss);
 
-                TargetedWriteBatch* nextBatch = it->second;
+            LOG(4) << "sending write batch to " << targetShardId << ": "
+                   << redact(request.toString());
 
-                // If the batch is NULL, we sent it previously, so skip
-                if (nextBatch == NULL)
-                    continue;
+            // Recv-side is responsible for cleaning up the nextBatch when used
+            pendingBatches.insert(make_pair(targetShardId, nextBatch));
 
-                // If we already have a batch for this shard, wait until the next time
-                ShardId targetShardId = nextBatch->getEndpoint().shardName;
-                OwnedShardBatchMap::MapType::iterator pendingIt =
-                    pendingBatches.find(targetShardId);
-                if (pendingIt != pendingBatches.end())
-                    continue;
+            return AsyncRequestsSender::Request(targetShardId, request.toBSON());
+        };
 
-                BatchedCommandRequest request(clientRequest.getBatchType());
-                batchOp.buildBatchRequest(*nextBatch, &request);
+        //
+        // Construct the requests.
+        //
 
-                // Internally we use full namespaces for request/response, but we send the
-                // command to a database with the collection name in the request.
-                NamespaceString nss(request.getNS());
-                request.setNS(nss);
+        vector<AsyncRequestsSender::Request> requests;
 
-                LOG(4) << "sending write batch to " << targetShardId << ": "
-                       << redact(request.toString());
+        for (auto it = childBatches.begin(); it != childBatches.end(); ++it) {
+            requests.push_back(prepareRequest(it->second));
 
-                requests.emplace_back(targetShardId, request.toBSON());
+            // The batch is now owned by pendingBatches
+            it->second = NULL;
+        }
 
-                // Indicate we're done by setting the batch to NULL
-                // We'll only get duplicate hostEndpoints if we have broadcast and non-broadcast
-                // endpoints for the same host, so this should be pretty efficient without
-                // moving stuff around.
-                it->second = NULL;
+        //
+        // Send the requests.
+        //
 
-                // Recv-side is responsible for cleaning up the nextBatch when used
-                pendingBatches.insert(make_pair(targetShardId, nextBatch));
-            }
+        const ReadPreferenceSetting readPref(ReadPreference::PrimaryOnly, TagSet());
+        AsyncRequestsSender ars(opCtx,
+                                Grid::get(opCtx)->getExecutorPool()->getArbitraryExecutor(),
+                                clientRequest.getTargetingNSS().db().toString(),
+                                requests,
+                                readPref);
 
-            //
-            // Send the requests.
-            //
+        // The write ops of unordered batches can be sent in any order, so as soon as a shard
+        // responds, the ops for it, which were left out of its previous batch can be sent to it
+        // without waiting for the slower shards. This stops for the rest of the round when the
+        // targeter needs to be refreshed.
+        bool pipelined = !clientRequest.getOrdered() && enablePipelinedWrites.load();
 
-            const ReadPreferenceSetting readPref(ReadPreference::PrimaryOnly, TagSet());
-            AsyncRequestsSender ars(opCtx,
-                                    Grid::get(opCtx)->getExecutorPool()->getArbitraryExecutor(),
-                                    clientRequest.getTargetingNSS().db().toString(),
-                                    requests,
-                                    readPref);
-            numSent += pendingBatches.size();
+        //
+        // Receive the responses.
+        //
 
-            //
-            // Receive the responses.
-            //
+        while (!ars.done()) {
+            // Block until a response is available.
+            auto response = ars.next();
+
+            // Get the TargetedWriteBatch to find where to put the response
+            auto pendingIt = pendingBatches.find(response.shardId);
+            invariant(pendingIt != pendingBatches.end());
+            std::unique_ptr<TargetedWriteBatch> batch(pendingIt->second);
+            pendingBatches.erase(pendingIt);
+
+            // First check if we were able to target a shard host.
+            if (!response.shardHostAndPort) {
+                invariant(!response.swResponse.isOK());
+
+                // Record a resolve failure
+                // TODO: It may be necessary to refresh the cache if stale, or maybe just
+                // cancel and retarget the batch
+                LOG(4) << "unable to send write batch to " << batch->getEndpoint().shardName
+                       << causedBy(response.swResponse.getStatus());
+                WriteErrorDetail error;
+                buildErrorFrom(std::move(response.swResponse.getStatus()), &error);
+                batchOp.noteBatchError(*batch, error);
+
+                // We're done with this batch
+                continue;
+            }
 
-            while (!ars.done()) {
-                // Block until a response is available.
-                auto response = ars.next();
-
-                // Get the TargetedWriteBatch to find where to put the response
-                dassert(pendingBatches.find(response.shardId) != pendingBatches.end());
-                TargetedWriteBatch* batch = pendingBatches.find(response.shardId)->second;
-
-                // First check if we were able to target a shard host.
-                if (!response.shardHostAndPort) {
-                    invariant(!response.swResponse.isOK());
-
-                    // Record a resolve failure
-                    // TODO: It may be necessary to refresh the cache if stale, or maybe just
-                    // cancel and retarget the batch
-                    LOG(4) << "unable to send write batch to " << batch->getEndpoint().shardName
-                           << causedBy(response.swResponse.getStatus());
-                    WriteErrorDetail error;
-                    buildErrorFrom(std::move(response.swResponse.getStatus()), &error);
-                    batchOp.noteBatchError(*batch, error);
-
-                    // We're done with this batch
-                    // Clean up when we can't resolve a host
-                    auto it = childBatches.find(batch->getEndpoint().shardName);
-                    invariant(it != childBatches.end());
-                    delete it->second;
-                    it->second = NULL;
-                    continue;
+            auto shardHost(std::move(*response.shardHostAndPort));
+
+            // Then check if we successfully got a response.
+            Status status = response.swResponse.getStatus();
+            BatchedCommandResponse batchedCommandResponse;
+            if (status.isOK()) {
+                std::string errMsg;
+                if (!batchedCommandResponse.parseBSON(response.swResponse.getValue().data,
+                                                      &errMsg) ||
+                    !batchedCommandResponse.isValid(&errMsg)) {
+                    status = {ErrorCodes::FailedToParse, errMsg};
                 }
+            }
 
-                auto shardHost(std::move(*response.shardHostAndPort));
+            if (status.isOK()) {
+                TrackedErrors trackedErrors;
+                trackedErrors.startTracking(ErrorCodes::StaleShardVersion);
 
+                LOG(4) << "write results received from " << shardHost.toString() << ": "
+                       << redact(batchedCommandResponse.toString());
 
-                // Then check if we successfully got a response.
-                Status status = response.swResponse.getStatus();
-                BatchedCommandResponse batchedCommandResponse;
-                if (status.isOK()) {
-                    std::string errMsg;
-                    if (!batchedCommandResponse.parseBSON(response.swResponse.getValue().data,
-                                                          &errMsg) ||
-                        !batchedCommandResponse.isValid(&errMsg)) {
-                        status = {ErrorCodes::FailedToParse, errMsg};
-                    }
-                }
+                // Dispatch was ok, note response
+                batchOp.noteBatchResponse(*batch, batchedCommandResponse, &trackedErrors);
+
+                // Note if anything was stale
+                const vector<ShardError*>& staleErrors =
+                    trackedErrors.getErrors(ErrorCodes::StaleShardVersion);
 
-                if (status.isOK()) {
-                    TrackedErrors trackedErrors;
-                    trackedErrors.startTracking(ErrorCodes::StaleShardVersion);
-
-                    LOG(4) << "write results received from " << shardHost.toString() << ": "
-                           << redact(batchedCommandResponse.toString());
-
-                    // Dispatch was ok, note response
-                    batchOp.noteBatchResponse(*batch, batchedCommandResponse, &trackedErrors);
-
-                    // Note if anything was stale
-                    const vector<ShardError*>& staleErrors =
-                        trackedErrors.getErrors(ErrorCodes::StaleShardVersion);
-
-                    if (staleErrors.size() > 0) {
-                        noteStaleResponses(staleErrors, &targeter);
-                        ++stats->numStaleBatches;
-                    }
-
-                    // Remember that we successfully wrote to this shard
-                    // NOTE: This will record lastOps for shards where we actually didn't update
-                    // or delete any documents, which preserves old behavior but is conservative
-                    stats->noteWriteAt(shardHost,
-                                       batchedCommandResponse.isLastOpSet()
-                                           ? batchedCommandResponse.getLastOp()
-                                           : repl::OpTime(),
-                                       batchedCommandResponse.isElectionIdSet()
-                                           ? batchedCommandResponse.getElectionId()
-                                           : OID());
-                } else {
-                    // Error occurred dispatching, note it
-
-                    stringstream msg;
-                    msg << "write results unavailable from " << shardHost.toString()
-                        << causedBy(status.toString());
-
-                    WriteErrorDetail error;
-                    buildErrorFrom(Status(ErrorCodes::RemoteResultsUnavailable, msg.str()), &error);
-
-                    LOG(4) << "unable to receive write results from " << shardHost.toString()
-                           << causedBy(redact(status.toString()));
-
-                    batchOp.noteBatchError(*batch, error);
+                if (staleErrors.size() > 0) {
+                    noteStaleResponses(staleErrors, &targeter);
+                    ++stats->numStaleBatches;
+
+                    // Retargeting with the stale metadata would send the ops back to where they
+                    // failed
+                    pipelined = false;
                 }
+
+                // Remember that we successfully wrote to this shard
+                // NOTE: This will record lastOps for shards where we actually didn't update
+                // or delete any documents, which preserves old behavior but is conservative
+                stats->noteWriteAt(shardHost,
+                                   batchedCommandResponse.isLastOpSet()
+                                       ? batchedCommandResponse.getLastOp()
+                                       : repl::OpTime(),
+                                   batchedCommandResponse.isElectionIdSet()
+                                       ? batchedCommandResponse.getElectionId()
+                                       : OID());
+            } else {
+                // Error occurred dispatching, note it
+
+                stringstream msg;
+                msg << "write results unavailable from " << shardHost.toString()
+                    << causedBy(status.toString());
+
+                WriteErrorDetail error;
+                buildErrorFrom(Status(ErrorCodes::RemoteResultsUnavailable, msg.str()), &error);
+
+                LOG(4) << "unable to receive write results from " << shardHost.toString()
+                       << causedBy(redact(status.toString()));
+
+                batchOp.noteBatchError(*batch, error);
+            }
+
+            //
+            // Send the next batches to the shards, which are not busy anymore
+            //
+
+            if (!pipelined || batchOp.isFinished()) {
+                continue;
+            }
+
+            std::set<ShardId> busyShards;
+            for (const auto& pending : pendingBatches) {
+                busyShards.insert(pending.first);
+            }
+
+            OwnedPointerMap<ShardId, TargetedWriteBatch> nextBatchesOwned;
+            map<ShardId, TargetedWriteBatch*>& nextBatches = nextBatchesOwned.mutableMap();
+
+            Status nextTargetStatus = batchOp.targetBatch(
+                opCtx, targeter, recordTargetErrors, &nextBatches, &busyShards);
+            if (!nextTargetStatus.isOK()) {
+                // Don't send anything more until a targeter refresh
+                targeter.noteCouldNotTarget();
+                refreshedTargeter = true;
+                ++stats->numTargetErrors;
+                pipelined = false;
+                continue;
+            }
+
+            for (auto it = nextBatches.begin(); it != nextBatches.end(); ++it) {
+                ars.addRequest(prepareRequest(it->second));
+                it->second = NULL;
+                ++stats->numPipelinedBatches;
             }
         }
 
@@ -84,7 +84,11 @@ typedef std::map<ConnectionString, HostOpTime> HostOpTimeMap;
 class BatchWriteExecStats {
 public:
     BatchWriteExecStats()
-        : numRounds(0), numTargetErrors(0), numResolveErrors(0), numStaleBatches(0) {}
+        : numRounds(0),
+          numTargetErrors(0),
+          numResolveErrors(0),
+          numStaleBatches(0),
+          numPipelinedBatches(0) {}
 
     void noteWriteAt(const HostAndPort& host, repl::OpTime opTime, const OID& electionId);
 
@@ -100,6 +104,8 @@ public:
     int numResolveErrors;
     // Number of stale batches
     int numStaleBatches;
+    // Number of batches sent to a shard as soon as it responded, without waiting for the others
+    int numPipelinedBatches;
 
 private:
     HostOpTimeMap _writeOpTimes;
@@ -30,6 +30,7 @@
 
 #include "mongo/s/write_ops/batch_write_op.h"
 
+#include <algorithm>
 #include <numeric>
 
 #include "mongo/base/error_codes.h"
@@ -95,6 +96,16 @@ void buildTargetError(const Status& errStatus, WriteErrorDetail* details) {
     details->setErrMessage(errStatus.reason());
 }
 
+/**
+ * Returns whether any of the targeted writes goes to one of the specified shards.
+ */
+bool isAnyShardBusy(const std::vector<TargetedWrite*>& writes,
+                    const std::set<ShardId>& busyShards) {
+    return std::any_of(writes.begin(), writes.end(), [&](const TargetedWrite* write) {
+        return busyShards.count(write->endpoint.shardName) > 0;
+    });
+}
+
 /**
  * Helper to determine whether a number of targeted writes require a new targeted batch.
  */
@@ -230,7 +241,8 @@ BatchWriteOp::~BatchWriteOp() {
 Status BatchWriteOp::targetBatch(OperationContext* opCtx,
                                  const NSTargeter& targeter,
                                  bool recordTargetErrors,
-                                 std::map<ShardId, TargetedWriteBatch*>* targetedBatches) {
+                                 std::map<ShardId, TargetedWriteBatch*>* targetedBatches,
+                                 const std::set<ShardId>* busyShards) {
     //
     // Targeting of unordered batches is fairly simple - each remaining write op is targeted,
     // and each of those targeted writes are grouped into a batch for a particular shard
@@ -265,6 +277,7 @@ Status BatchWriteOp::targetBatch(OperationContext* opCtx,
     //
 
     const bool ordered = _clientRequest.getOrdered();
+    invariant(!ordered || !busyShards);
 
     TargetedBatchMap batchMap;
     TargetedBatchSizeMap batchSizes;
@@ -318,6 +331,15 @@ Status BatchWriteOp::targetBatch(OperationContext* opCtx,
             }
         }
 
+        //
+        // Leave the write ops, which target a shard still busy with a previous batch, for later
+        //
+
+        if (busyShards && isAnyShardBusy(writes, *busyShards)) {
+            writeOp.cancelWrites(NULL);
+            continue;
+        }
+
         //
         // If ordered and we have a previous endpoint, make sure we don't need to send these
         // targeted writes to any other endpoints.
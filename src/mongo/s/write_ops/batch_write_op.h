@@ -106,12 +106,16 @@ public:
      * (The idea here is that if we are sure our NSTargeter is up-to-date we should record
      * targeting errors, but if not we should refresh once first.)
      *
+     * If 'busyShards' is specified, the write ops which target any of these shards are left to be
+     * targeted again later. Only unordered batches may skip write ops this way.
+     *
      * Returned TargetedWriteBatches are owned by the caller.
      */
     Status targetBatch(OperationContext* opCtx,
                        const NSTargeter& targeter,
                        bool recordTargetErrors,
-                       std::map<ShardId, TargetedWriteBatch*>* targetedBatches);
+                       std::map<ShardId, TargetedWriteBatch*>* targetedBatches,
+                       const std::set<ShardId>* busyShards = nullptr);
 
     /**
      * Fills a BatchCommandRequest from a TargetedWriteBatch for this BatchWriteOp.
@@ -562,6 +562,65 @@ TEST(WriteOpTests, MultiOpTwoShardsUnordered) {
     ASSERT_EQUALS(clientResponse.getN(), 2);
 }
 
+TEST(WriteOpTests, MultiOpTwoShardsOneBusyUnordered) {
+    //
+    // Multi-op, multi-endpoint targeting test (unordered) with one of the shards still busy
+    // The ops for the busy shard should be left to be targeted once it is not busy anymore
+    //
+
+    OperationContextNoop opCtx;
+    NamespaceString nss("foo.bar");
+    ShardEndpoint endpointA(ShardId("shardA"), ChunkVersion::IGNORED());
+    ShardEndpoint endpointB(ShardId("shardB"), ChunkVersion::IGNORED());
+    MockNSTargeter targeter;
+    initTargeterSplitRange(nss, endpointA, endpointB, &targeter);
+
+    // Do multi-target, multi-doc batch write op
+    BatchedCommandRequest request(BatchedCommandRequest::BatchType_Insert);
+    request.setNS(nss);
+    request.setOrdered(false);
+    request.getInsertRequest()->addToDocuments(BSON("x" << -1));
+    request.getInsertRequest()->addToDocuments(BSON("x" << 1));
+    request.getInsertRequest()->addToDocuments(BSON("x" << -2));
+
+    BatchWriteOp batchOp(request);
+
+    const std::set<ShardId> busyShards{endpointA.shardName};
+
+    OwnedPointerMap<ShardId, TargetedWriteBatch> targetedOwned;
+    map<ShardId, TargetedWriteBatch*>& targeted = targetedOwned.mutableMap();
+    Status status = batchOp.targetBatch(&opCtx, targeter, false, &targeted, &busyShards);
+
+    ASSERT(status.isOK());
+    ASSERT(!batchOp.isFinished());
+    ASSERT_EQUALS(targeted.size(), 1u);
+    verifyTargetedBatches({{endpointB.shardName, 1u}}, targeted);
+    ASSERT_EQUALS(2, batchOp.numWriteOpsIn(WriteOpState_Ready));
+
+    BatchedCommandResponse response;
+    buildResponse(1, &response);
+    batchOp.noteBatchResponse(*targeted.begin()->second, response, NULL);
+    ASSERT(!batchOp.isFinished());
+
+    // Once the shard is not busy anymore, its ops are targeted
+    OwnedPointerMap<ShardId, TargetedWriteBatch> nextTargetedOwned;
+    map<ShardId, TargetedWriteBatch*>& nextTargeted = nextTargetedOwned.mutableMap();
+    status = batchOp.targetBatch(&opCtx, targeter, false, &nextTargeted);
+
+    ASSERT(status.isOK());
+    ASSERT_EQUALS(nextTargeted.size(), 1u);
+    verifyTargetedBatches({{endpointA.shardName, 2u}}, nextTargeted);
+
+    buildResponse(2, &response);
+    batchOp.noteBatchResponse(*nextTargeted.begin()->second, response, NULL);
+    ASSERT(batchOp.isFinished());
+
+    BatchedCommandResponse clientResponse;
+    batchOp.buildClientResponse(&clientResponse);
+    ASSERT(clientResponse.getOk());
+    ASSERT_EQUALS(clientResponse.getN(), 3);
+}
+
 TEST(WriteOpTests, MultiOpTwoShardsEachOrdered) {
     //
     // Multi-op (ordered) targeting test where each op goes to both shards
@@ -33,17 +33,20 @@
 
 #include "mongo/scripting/engine.h"
 
+#include <algorithm>
 #include <boost/filesystem/operations.hpp>
 #include <cctype>
 
 #include "mongo/client/dbclientcursor.h"
 #include "mongo/client/dbclientinterface.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/platform/unordered_set.h"
 #include "mongo/scripting/dbdirectclient_factory.h"
 #include "mongo/util/file.h"
 #include "mongo/util/log.h"
+#include "mongo/util/processinfo.h"
 #include "mongo/util/text.h"
 
 namespace mongo {
@@ -312,6 +315,16 @@ void Scope::execCoreFiles() {
 }
 
 namespace {
+
+// Idle scopes are kept for reuse, along with the functions compiled in them, so that a $where,
+// group or mapReduce doesn't pay for setting up a scope and compiling its functions every time.
+// The cache holds up to this many idle scopes per core, and at least kMinPoolSize.
+MONGO_EXPORT_SERVER_PARAMETER(jsScopeCacheSizePerCore, int, 2);
+
+// The number of times a scope is reused before it is discarded, to bound the garbage that
+// functions may leave behind in its global object.
+MONGO_EXPORT_SERVER_PARAMETER(jsScopeMaxReuse, int, 100);
+
 class ScopeCache {
 public:
     void release(const string& poolName, const std::shared_ptr<Scope>& scope) {
@@ -324,13 +337,16 @@ public:
             return;
         }
 
-        if (scope->getTimesUsed() > kMaxScopeReuse)
+        if (scope->getTimesUsed() > jsScopeMaxReuse.load())
             return;  // used too many times to save
 
+        if (scope->getNumCachedFunctions() > kMaxCachedFunctions)
+            return;  // compiled too many distinct functions to save
+
         if (!scope->getError().empty())
             return;  // not saving errored scopes
 
-        if (_pools.size() >= kMaxPoolSize) {
+        if (_pools.size() >= _maxPoolSize()) {
             // prefer to keep recently-used scopes
             _pools.pop_back();
         }
@@ -369,9 +385,17 @@ private:
         string poolName;
     };
 
-    // Note: if these numbers change, reconsider choice of datastructure for _pools
-    static const unsigned kMaxPoolSize = 10;
-    static const int kMaxScopeReuse = 10;
+    static size_t _maxPoolSize() {
+        static const unsigned numCores = ProcessInfo().getNumCores();
+        return std::max(kMinPoolSize,
+                        static_cast<size_t>(std::max(jsScopeCacheSizePerCore.load(), 0)) *
+                            numCores);
+    }
+
+    // Note: if these numbers grow much larger, reconsider choice of datastructure for _pools,
+    // which is searched linearly.
+    static const size_t kMinPoolSize = 10;
+    static const size_t kMaxCachedFunctions = 1000;
 
     typedef std::deque<ScopeAndPool> Pools;  // More-recently used Scopes are kept at the front.
     Pools _pools;                            // protected by _mutex
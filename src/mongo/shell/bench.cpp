@@ -34,6 +34,8 @@
 
 #include "mongo/shell/bench.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <pcrecpp.h>
 
@@ -42,6 +44,7 @@
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/query_request.h"
+#include "mongo/platform/bits.h"
 #include "mongo/scripting/bson_template_evaluator.h"
 #include "mongo/scripting/engine.h"
 #include "mongo/stdx/thread.h"
@@ -92,6 +95,91 @@ const std::map<OpType, std::string> opTypeName{{OpType::NONE, "none"},
                                                {OpType::LET, "let"},
                                                {OpType::CPULOAD, "cpuload"}};
 
+namespace {
+// Values below 2^kSubBucketBits are recorded exactly; above that, each power of two is split into
+// 2^(kSubBucketBits - 1) buckets.
+const int kSubBucketBits = 7;
+const long long kSubBucketCount = 1LL << kSubBucketBits;
+const long long kSubBucketHalfCount = kSubBucketCount / 2;
+
+// Latencies are clamped to 2^40 microseconds, about 12 days.
+const int kMaxValueBits = 40;
+const size_t kNumLatencyBuckets =
+    kSubBucketCount + (kMaxValueBits - kSubBucketBits + 1) * kSubBucketHalfCount;
+
+const long long kMaxScheduleSleepMicros = 100 * 1000;
+}  // namespace
+
+BenchRunLatencyHistogram::BenchRunLatencyHistogram() : _buckets(kNumLatencyBuckets) {
+    reset();
+}
+
+void BenchRunLatencyHistogram::reset() {
+    std::fill(_buckets.begin(), _buckets.end(), 0);
+    _count = 0;
+    _max = 0;
+}
+
+size_t BenchRunLatencyHistogram::bucketIndex(long long micros) {
+    if (micros < kSubBucketCount) {
+        return std::max(micros, 0LL);
+    }
+    const int highestBit = 63 - countLeadingZeros64(micros);
+    const int shift = highestBit - (kSubBucketBits - 1);
+    const long long subBucket = micros >> shift;
+    const size_t index =
+        kSubBucketCount + (shift - 1) * kSubBucketHalfCount + subBucket - kSubBucketHalfCount;
+    return std::min(index, kNumLatencyBuckets - 1);
+}
+
+long long BenchRunLatencyHistogram::bucketHighestValue(size_t index) {
+    if (index < static_cast<size_t>(kSubBucketCount)) {
+        return index;
+    }
+    const long long offset = index - kSubBucketCount;
+    const long long shift = offset / kSubBucketHalfCount + 1;
+    const long long subBucket = offset % kSubBucketHalfCount + kSubBucketHalfCount;
+    return ((subBucket + 1) << shift) - 1;
+}
+
+void BenchRunLatencyHistogram::record(long long micros) {
+    ++_buckets[bucketIndex(micros)];
+    ++_count;
+    _max = std::max(_max, micros);
+}
+
+void BenchRunLatencyHistogram::merge(const BenchRunLatencyHistogram& other) {
+    for (size_t i = 0; i < _buckets.size(); ++i) {
+        _buckets[i] += other._buckets[i];
+    }
+    _count += other._count;
+    _max = std::max(_max, other._max);
+}
+
+long long BenchRunLatencyHistogram::getValueAtPercentile(double percentile) const {
+    if (_count == 0) {
+        return 0;
+    }
+    const unsigned long long rank = std::max(
+        1ULL, static_cast<unsigned long long>(std::ceil(percentile / 100.0 * _count)));
+    unsigned long long seen = 0;
+    for (size_t i = 0; i < _buckets.size(); ++i) {
+        seen += _buckets[i];
+        if (seen >= rank) {
+            return std::min(bucketHighestValue(i), _max);
+        }
+    }
+    return _max;
+}
+
+void BenchRunLatencyHistogram::appendPercentiles(BSONObjBuilder* builder) const {
+    builder->append("p50", getValueAtPercentile(50));
+    builder->append("p95", getValueAtPercentile(95));
+    builder->append("p99", getValueAtPercentile(99));
+    builder->append("p99_9", getValueAtPercentile(99.9));
+    builder->append("max", getMax());
+}
+
 BenchRunEventCounter::BenchRunEventCounter() {
     reset();
 }
@@ -101,11 +189,13 @@ BenchRunEventCounter::~BenchRunEventCounter() {}
 void BenchRunEventCounter::reset() {
     _numEvents = 0;
     _totalTimeMicros = 0;
+    _latencies.reset();
 }
 
 void BenchRunEventCounter::updateFrom(const BenchRunEventCounter& other) {
     _numEvents += other._numEvents;
     _totalTimeMicros += other._totalTimeMicros;
+    _latencies.merge(other._latencies);
 }
 
 BenchRunStats::BenchRunStats() {
@@ -169,6 +259,11 @@ void BenchRunConfig::initializeToDefaults() {
     throwGLE = false;
     breakOnTrap = true;
     randomSeed = 1314159265358979323;
+
+    opsPerSecond = 0;
+    numProcesses = 1;
+    processId = 0;
+    startAt = Date_t();
 }
 
 BenchRunConfig* BenchRunConfig::createFromBson(const BSONObj& args) {
@@ -445,6 +540,27 @@ void BenchRunConfig::initializeFromBson(const BSONObj& args) {
                                   << typeName(arg.type()),
                     arg.isNumber());
             seconds = arg.number();
+        } else if (name == "opsPerSecond") {
+            uassert(40654,
+                    str::stream() << "Field '" << name << "' should be a non-negative number",
+                    arg.isNumber() && arg.number() >= 0);
+            opsPerSecond = arg.number();
+        } else if (name == "numProcesses") {
+            uassert(40655,
+                    str::stream() << "Field '" << name << "' should be a positive number",
+                    arg.isNumber() && arg.numberInt() > 0);
+            numProcesses = arg.numberInt();
+        } else if (name == "processId") {
+            uassert(40656,
+                    str::stream() << "Field '" << name << "' should be a non-negative number",
+                    arg.isNumber() && arg.numberInt() >= 0);
+            processId = arg.numberInt();
+        } else if (name == "startAt") {
+            uassert(40657,
+                    str::stream() << "Field '" << name << "' should be a date. Type is "
+                                  << typeName(arg.type()),
+                    arg.type() == Date);
+            startAt = arg.date();
         } else if (name == "hideResults") {
             hideResults = arg.trueValue();
         } else if (name == "handleErrors") {
@@ -488,6 +604,11 @@ void BenchRunConfig::initializeFromBson(const BSONObj& args) {
             uassert(34376, "benchRun passed an unsupported configuration field", false);
         }
     }
+
+    uassert(40658,
+            str::stream() << "processId " << processId << " must be less than numProcesses "
+                          << numProcesses,
+            processId < numProcesses);
 }
 
 DBClientBase* BenchRunConfig::createConnection() const {
@@ -604,7 +725,18 @@ BenchRunWorker::BenchRunWorker(size_t id,
                                const BenchRunConfig* config,
                                BenchRunState* brState,
                                int64_t randomSeed)
-    : _id(id), _config(config), _brState(brState), _randomSeed(randomSeed) {}
+    : _id(id), _config(config), _brState(brState), _randomSeed(randomSeed) {
+    if (_config->opsPerSecond > 0) {
+        // Interleave the threads of all processes evenly: with N threads in total, each one
+        // issues every Nth operation of the aggregate schedule.
+        const double aggregateIntervalMicros = 1000 * 1000 / _config->opsPerSecond;
+        const unsigned slot = _config->processId * _config->parallel + _id;
+        const unsigned numSlots = _config->numProcesses * _config->parallel;
+        _scheduleStartMicros =
+            _config->startAt.toMillisSinceEpoch() * 1000.0 + slot * aggregateIntervalMicros;
+        _scheduleIntervalMicros = numSlots * aggregateIntervalMicros;
+    }
+}
 
 BenchRunWorker::~BenchRunWorker() {}
 
@@ -620,6 +752,20 @@ bool BenchRunWorker::shouldCollectStats() const {
     return _brState->shouldWorkerCollectStats();
 }
 
+bool BenchRunWorker::waitForNextScheduledOp(long long* scheduleDelayMicros) {
+    const long long scheduledMicros =
+        static_cast<long long>(_scheduleStartMicros + _numScheduledOps++ * _scheduleIntervalMicros);
+
+    long long nowMicros;
+    while ((nowMicros = static_cast<long long>(curTimeMicros64())) < scheduledMicros) {
+        if (shouldStop())
+            return false;
+        sleepmicros(std::min(scheduledMicros - nowMicros, kMaxScheduleSleepMicros));
+    }
+    *scheduleDelayMicros = nowMicros - scheduledMicros;
+    return true;
+}
+
 void doNothing(const BSONObj&) {}
 
 /**
@@ -696,6 +842,11 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
         for (const auto& op : _config->ops) {
             if (shouldStop())
                 break;
+
+            long long scheduleDelayMicros = 0;
+            if (_config->opsPerSecond > 0 && !waitForNextScheduledOp(&scheduleDelayMicros))
+                break;
+
             auto& stats = shouldCollectStats() ? _stats : _statsBlackHole;
 
             ScriptingFunction scopeFunc = 0;
@@ -742,10 +893,10 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                             qr->setWantMore(false);
                             invariantOK(qr->validate());
 
-                            BenchRunEventTrace _bret(&stats.findOneCounter);
+                            BenchRunEventTrace _bret(&stats.findOneCounter, scheduleDelayMicros);
                             runQueryWithReadCommands(conn, std::move(qr), &result);
                         } else {
-                            BenchRunEventTrace _bret(&stats.findOneCounter);
+                            BenchRunEventTrace _bret(&stats.findOneCounter, scheduleDelayMicros);
                             result = conn->findOne(op.ns, fixedQuery);
                         }
 
@@ -768,7 +919,7 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                         bool ok;
                         BSONObj result;
                         {
-                            BenchRunEventTrace _bret(&stats.commandCounter);
+                            BenchRunEventTrace _bret(&stats.commandCounter, scheduleDelayMicros);
                             ok = conn->runCommand(op.ns,
                                                   fixQuery(op.command, bsonTemplateEvaluator),
                                                   result,
@@ -850,17 +1001,17 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                             }
                             invariantOK(qr->validate());
 
-                            BenchRunEventTrace _bret(&stats.queryCounter);
+                            BenchRunEventTrace _bret(&stats.queryCounter, scheduleDelayMicros);
                             count = runQueryWithReadCommands(conn, std::move(qr));
                         } else {
                             // Use special query function for exhaust query option.
                             if (op.options & QueryOption_Exhaust) {
-                                BenchRunEventTrace _bret(&stats.queryCounter);
+                                BenchRunEventTrace _bret(&stats.queryCounter, scheduleDelayMicros);
                                 stdx::function<void(const BSONObj&)> castedDoNothing(doNothing);
                                 count = conn->query(
                                     castedDoNothing, op.ns, fixedQuery, &op.projection, op.options);
                             } else {
-                                BenchRunEventTrace _bret(&stats.queryCounter);
+                                BenchRunEventTrace _bret(&stats.queryCounter, scheduleDelayMicros);
                                 unique_ptr<DBClientCursor> cursor;
                                 cursor = conn->query(op.ns,
                                                      fixedQuery,
@@ -898,7 +1049,7 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                     case OpType::UPDATE: {
                         BSONObj result;
                         {
-                            BenchRunEventTrace _bret(&stats.updateCounter);
+                            BenchRunEventTrace _bret(&stats.updateCounter, scheduleDelayMicros);
                             BSONObj query = fixQuery(op.query, bsonTemplateEvaluator);
                             BSONObj update = fixQuery(op.update, bsonTemplateEvaluator);
 
@@ -949,7 +1100,7 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                         BSONObj result;
 
                         {
-                            BenchRunEventTrace _bret(&stats.insertCounter);
+                            BenchRunEventTrace _bret(&stats.insertCounter, scheduleDelayMicros);
 
                             BSONObj insertDoc;
                             if (op.useWriteCmd) {
@@ -1014,7 +1165,7 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                     case OpType::REMOVE: {
                         BSONObj result;
                         {
-                            BenchRunEventTrace _bret(&stats.deleteCounter);
+                            BenchRunEventTrace _bret(&stats.deleteCounter, scheduleDelayMicros);
                             BSONObj predicate = fixQuery(op.query, bsonTemplateEvaluator);
                             if (op.useWriteCmd) {
                                 // TODO: Replace after SERVER-11774.
@@ -1197,6 +1348,10 @@ void BenchRunner::start() {
             }
         }
 
+        if (_config->opsPerSecond > 0 && _config->startAt == Date_t()) {
+            _config->startAt = Date_t::now();
+        }
+
         // Start threads
         for (int64_t i = 0; i < _config->parallel; i++) {
             // Make a unique random seed for the worker.
@@ -1265,6 +1420,15 @@ static void appendAverageMicrosIfAvailable(BSONObjBuilder& buf,
                    static_cast<double>(counter.getTotalTimeMicros()) / counter.getNumEvents());
 }
 
+static void appendLatencyPercentilesIfAvailable(BSONObjBuilder& buf,
+                                                StringData name,
+                                                const BenchRunEventCounter& counter) {
+    if (counter.getNumEvents() > 0) {
+        BSONObjBuilder percentiles(buf.subobjStart(name));
+        counter.getLatencies().appendPercentiles(&percentiles);
+    }
+}
+
 BSONObj BenchRunner::finish(BenchRunner* runner) {
     runner->stop();
 
@@ -1288,6 +1452,17 @@ BSONObj BenchRunner::finish(BenchRunner* runner) {
     appendAverageMicrosIfAvailable(buf, "queryLatencyAverageMicros", stats.queryCounter);
     appendAverageMicrosIfAvailable(buf, "commandsLatencyAverageMicros", stats.commandCounter);
 
+    appendLatencyPercentilesIfAvailable(buf, "findOneLatencyMicros", stats.findOneCounter);
+    appendLatencyPercentilesIfAvailable(buf, "insertLatencyMicros", stats.insertCounter);
+    appendLatencyPercentilesIfAvailable(buf, "deleteLatencyMicros", stats.deleteCounter);
+    appendLatencyPercentilesIfAvailable(buf, "updateLatencyMicros", stats.updateCounter);
+    appendLatencyPercentilesIfAvailable(buf, "queryLatencyMicros", stats.queryCounter);
+    appendLatencyPercentilesIfAvailable(buf, "commandsLatencyMicros", stats.commandCounter);
+
+    if (runner->_config->opsPerSecond > 0) {
+        buf.append("targetOps/s", runner->_config->opsPerSecond / runner->_config->numProcesses);
+    }
+
     buf.append("totalOps", static_cast<long long>(stats.opCount));
 
     auto appendPerSec = [&buf, runner](StringData name, double total) {
@@ -29,12 +29,14 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "mongo/client/dbclientinterface.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
 #include "mongo/util/timer.h"
 
 namespace pcrecpp {
@@ -181,11 +183,88 @@ public:
     bool throwGLE;
     bool breakOnTrap;
 
+    /**
+     * Target rate, in operations per second summed over all threads and processes, for an
+     * open-loop run. Zero, the default, runs closed-loop: every thread issues its next operation
+     * as soon as the previous one completes.
+     *
+     * In an open-loop run each entry of "ops" is issued at a fixed, precomputed time regardless
+     * of how long earlier operations took, and its latency is measured from that intended start
+     * time. A stalled server then shows up as higher latencies instead of as a silently lower
+     * request rate (coordinated omission).
+     */
+    double opsPerSecond;
+
+    /**
+     * For open-loop runs driven from several shell processes: "numProcesses" processes
+     * participate and "processId", between 0 and numProcesses - 1, identifies this one. Every
+     * process must use the same "parallel", "opsPerSecond" and "startAt" so that their schedules
+     * interleave evenly.
+     */
+    unsigned numProcesses;
+    unsigned processId;
+
+    /**
+     * Wall clock time at which the open-loop schedule begins. Defaults to the time the run is
+     * started; giving every process the same future time lines up their schedules.
+     */
+    Date_t startAt;
+
 private:
     /// Initialize a config object to its default values.
     void initializeToDefaults();
 };
 
+/**
+ * A log-linear histogram of latencies in microseconds, in the style of HdrHistogram.
+ *
+ * Values below 128 are recorded exactly. Larger values fall into buckets that subdivide each
+ * power of two into 64 parts, so every recorded value is within 1/64 of its true value.
+ *
+ * Not thread safe.
+ */
+class BenchRunLatencyHistogram {
+public:
+    BenchRunLatencyHistogram();
+
+    void reset();
+
+    void record(long long micros);
+
+    /**
+     * Adds all of the values recorded in "other" into this.
+     */
+    void merge(const BenchRunLatencyHistogram& other);
+
+    unsigned long long getCount() const {
+        return _count;
+    }
+
+    long long getMax() const {
+        return _max;
+    }
+
+    /**
+     * Returns the smallest recorded latency such that "percentile" percent of all recorded
+     * latencies are at or below it, up to the precision of the histogram. Returns 0 if nothing
+     * has been recorded.
+     */
+    long long getValueAtPercentile(double percentile) const;
+
+    /**
+     * Appends {p50, p95, p99, p99_9, max} to "builder".
+     */
+    void appendPercentiles(BSONObjBuilder* builder) const;
+
+private:
+    static size_t bucketIndex(long long micros);
+    static long long bucketHighestValue(size_t index);
+
+    std::vector<unsigned long long> _buckets;
+    unsigned long long _count;
+    long long _max;
+};
+
 /**
  * An event counter for events that have an associated duration.
  *
@@ -215,6 +294,7 @@ public:
     void countOne(long long timeMicros) {
         ++_numEvents;
         _totalTimeMicros += timeMicros;
+        _latencies.record(timeMicros);
     }
 
     /**
@@ -231,9 +311,17 @@ public:
         return _numEvents;
     }
 
+    /**
+     * Get the distribution of the durations of all observed events.
+     */
+    const BenchRunLatencyHistogram& getLatencies() const {
+        return _latencies;
+    }
+
 private:
     unsigned long long _numEvents;
     long long _totalTimeMicros;
+    BenchRunLatencyHistogram _latencies;
 };
 
 /**
@@ -248,12 +336,18 @@ private:
  * event, and otherwise, the succes counter will.
  *
  * In all cases, the counter objects must outlive the trace object.
+ *
+ * In open-loop runs, "scheduleDelayMicros" is how late the event started relative to its
+ * scheduled time. It is added to the measured duration, so that the counter sees the latency a
+ * client issuing requests on schedule would have seen.
  */
 class BenchRunEventTrace {
     MONGO_DISALLOW_COPYING(BenchRunEventTrace);
 
 public:
-    explicit BenchRunEventTrace(BenchRunEventCounter* eventCounter) {
+    explicit BenchRunEventTrace(BenchRunEventCounter* eventCounter,
+                                long long scheduleDelayMicros = 0)
+        : _scheduleDelayMicros(scheduleDelayMicros) {
         initialize(eventCounter, eventCounter, false);
     }
 
@@ -264,7 +358,8 @@ public:
     }
 
     ~BenchRunEventTrace() {
-        (_succeeded ? _successCounter : _failCounter)->countOne(_timer.micros());
+        (_succeeded ? _successCounter : _failCounter)
+            ->countOne(_timer.micros() + _scheduleDelayMicros);
     }
 
     void succeed() {
@@ -284,6 +379,7 @@ private:
     }
 
     Timer _timer;
+    long long _scheduleDelayMicros = 0;
     BenchRunEventCounter* _successCounter;
     BenchRunEventCounter* _failCounter;
     bool _succeeded;
@@ -443,6 +539,13 @@ private:
     /// Predicate, used to decide whether or not it's time to collect statistics
     bool shouldCollectStats() const;
 
+    /**
+     * In an open-loop run, sleeps until the scheduled start time of the next operation. Stores
+     * how late the operation is starting in "scheduleDelayMicros". Returns false if the worker
+     * was told to stop while waiting.
+     */
+    bool waitForNextScheduledOp(long long* scheduleDelayMicros);
+
     size_t _id;
     const BenchRunConfig* _config;
     BenchRunState* _brState;
@@ -450,6 +553,12 @@ private:
     /// Dummy stats to use before observation period.
     BenchRunStats _statsBlackHole;
     int64_t _randomSeed;
+
+    // Open-loop schedule: operation n is due at _scheduleStartMicros + n * _scheduleIntervalMicros,
+    // in microseconds since the epoch.
+    double _scheduleStartMicros = 0;
+    double _scheduleIntervalMicros = 0;
+    long long _numScheduledOps = 0;
 };
 
 /**
@@ -1815,6 +1815,8 @@ PlanCache.prototype.help = function() {
     print("\tdb." + shortName +
           ".getPlanCache().getPlansByQuery(query[, projection, sort, collation]) - " +
           "displays the cached plans for a query shape");
+    print("\tdb." + shortName + ".getPlanCache().warm(shapes) - " +
+          "plans and caches query shapes, as returned by listQueryShapes()");
     return __magicNoPrint;
 };
 
@@ -1897,6 +1899,14 @@ PlanCache.prototype.listQueryShapes = function() {
     return this._runCommandThrowOnError("planCacheListQueryShapes", {}).shapes;
 };
 
+/**
+ * Plans and caches a list of query shapes in a collection, such as those returned by
+ * listQueryShapes() on another member of the replica set.
+ */
+PlanCache.prototype.warm = function(shapes) {
+    return this._runCommandThrowOnError("planCacheWarm", {shapes: shapes});
+};
+
 /**
  * Clears plan cache in a collection.
  */
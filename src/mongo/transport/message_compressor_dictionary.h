@@ -0,0 +1,106 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/transport/message_compressor_base.h"
+
+#include <string>
+#include <vector>
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/*
+ * A compressor that can compress against a dictionary shared with the remote end of a connection.
+ * Small messages with repetitive field names compress poorly on their own, but very well against
+ * a dictionary trained from similar traffic.
+ *
+ * Dictionaries are identified by a non-zero DictionaryId. The server side of a connection tells
+ * the client which dictionary to use (sending its contents if the client doesn't already have it)
+ * during isMaster compression negotiation, and then both ends compress with that dictionary for
+ * the lifetime of the connection. Compressed data must identify the dictionary it was compressed
+ * with, so that decompressData() can find it without any per-connection state.
+ */
+class DictionaryMessageCompressorBase : public MessageCompressorBase {
+public:
+    using DictionaryId = uint32_t;
+    static const DictionaryId kNoDictionary = 0;
+
+    /*
+     * Returns the dictionary that connections negotiated now should use, or kNoDictionary if none
+     * is available yet. This is only called on the server side of a negotiation.
+     */
+    virtual DictionaryId getCurrentDictionaryId() = 0;
+
+    /*
+     * Returns the ids of every dictionary this compressor can compress and decompress with.
+     */
+    virtual std::vector<DictionaryId> getDictionaryIds() const = 0;
+
+    /*
+     * Returns true if this compressor has the dictionary with the given id.
+     */
+    virtual bool hasDictionary(DictionaryId id) const = 0;
+
+    /*
+     * Returns the contents of the dictionary with the given id, or an empty string if this
+     * compressor doesn't have it.
+     */
+    virtual std::string getDictionaryData(DictionaryId id) const = 0;
+
+    /*
+     * Adds a dictionary received from the remote end of a connection. Loading a dictionary that
+     * is already present succeeds without replacing it.
+     */
+    virtual Status loadDictionary(DictionaryId id, ConstDataRange data) = 0;
+
+    /*
+     * Like compressData, but compresses against the dictionary with the given id. Passing
+     * kNoDictionary compresses without a dictionary.
+     */
+    virtual StatusWith<std::size_t> compressDataWithDictionary(DictionaryId id,
+                                                               ConstDataRange input,
+                                                               DataRange output) = 0;
+
+    StatusWith<std::size_t> compressData(ConstDataRange input, DataRange output) final {
+        return compressDataWithDictionary(kNoDictionary, input, output);
+    }
+
+    /*
+     * Appends the bytesIn/bytesOut counters of each dictionary as a sub-object keyed by
+     * dictionary id.
+     */
+    virtual void appendDictionaryStats(BSONObjBuilder* b) const = 0;
+
+protected:
+    DictionaryMessageCompressorBase(MessageCompressor id) : MessageCompressorBase(id) {}
+};
+
+}  // namespace mongo
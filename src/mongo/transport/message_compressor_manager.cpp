@@ -71,6 +71,9 @@ struct CompressionHeader {
     }
 };
 
+const auto kDictionaryFieldName = "compressionDictionary"_sd;
+const auto kDictionaryIdsFieldName = "compressionDictionaries"_sd;
+
 const transport::Session::Decoration<MessageCompressorManager> getForSession =
     transport::Session::declareDecoration<MessageCompressorManager>();
 }  // namespace
@@ -87,6 +90,13 @@ StatusWith<Message> MessageCompressorManager::compressMessage(const Message& msg
     }
     auto compressor = _negotiated[0];
 
+    if (msg.hasSegments()) {
+        // The compressors want the whole message in one buffer.
+        Message flattened(msg);
+        flattened.flatten();
+        return compressMessage(flattened);
+    }
+
     LOG(3) << "Compressing message with " << compressor->getName();
 
     auto inputHeader = msg.header();
@@ -114,7 +124,9 @@ StatusWith<Message> MessageCompressorManager::compressMessage(const Message& msg
     compressionHeader.serialize(&output);
     ConstDataRange input(inputHeader.data(), inputHeader.data() + inputHeader.dataLen());
 
-    auto sws = compressor->compressData(input, output);
+    auto sws = _dictionaryCompressor
+        ? _dictionaryCompressor->compressDataWithDictionary(_dictionaryId, input, output)
+        : compressor->compressData(input, output);
 
     if (!sws.isOK())
         return sws.getStatus();
@@ -166,18 +178,34 @@ void MessageCompressorManager::clientBegin(BSONObjBuilder* output) {
     LOG(3) << "Starting client-side compression negotiation";
 
     // We're about to update the compressor list with the negotiation result from the server.
-    _negotiated.clear();
+    _resetNegotiation();
 
     auto& compressorList = _registry->getCompressorNames();
     if (compressorList.size() == 0)
         return;
 
+    std::vector<DictionaryId> dictionaryIds;
     BSONArrayBuilder sub(output->subarrayStart("compression"));
     for (const auto e : _registry->getCompressorNames()) {
         LOG(3) << "Offering " << e << " compressor to server";
         sub.append(e);
+
+        auto dictionaryCompressor =
+            dynamic_cast<DictionaryMessageCompressorBase*>(_registry->getCompressor(e));
+        if (dictionaryCompressor) {
+            auto ids = dictionaryCompressor->getDictionaryIds();
+            dictionaryIds.insert(dictionaryIds.end(), ids.begin(), ids.end());
+        }
     }
     sub.doneFast();
+
+    if (!dictionaryIds.empty()) {
+        BSONArrayBuilder ids(output->subarrayStart(kDictionaryIdsFieldName));
+        for (auto id : dictionaryIds) {
+            ids.append(static_cast<long long>(id));
+        }
+        ids.doneFast();
+    }
 }
 
 void MessageCompressorManager::clientFinish(const BSONObj& input) {
@@ -203,6 +231,34 @@ void MessageCompressorManager::clientFinish(const BSONObj& input) {
         LOG(3) << "Adding compressor " << ret->getName();
         _negotiated.push_back(ret);
     }
+
+    if (_negotiated.empty()) {
+        return;
+    }
+    _dictionaryCompressor = dynamic_cast<DictionaryMessageCompressorBase*>(_negotiated[0]);
+    auto dictionaryElem = input.getField(kDictionaryFieldName);
+    if (!_dictionaryCompressor || dictionaryElem.type() != Object) {
+        return;
+    }
+
+    auto dictionaryObj = dictionaryElem.Obj();
+    auto id = static_cast<DictionaryId>(dictionaryObj["id"].safeNumberLong());
+    auto dataElem = dictionaryObj["data"];
+    if (dataElem.type() == BinData) {
+        int length;
+        const char* data = dataElem.binData(length);
+        auto status = _dictionaryCompressor->loadDictionary(id, ConstDataRange(data, length));
+        if (!status.isOK()) {
+            warning() << "Could not load compression dictionary sent by server: " << status;
+        }
+    }
+
+    if (_dictionaryCompressor->hasDictionary(id)) {
+        LOG(3) << "Compressing with dictionary " << id;
+        _dictionaryId = id;
+    } else {
+        warning() << "Server asked to compress with unknown dictionary " << id;
+    }
 }
 
 void MessageCompressorManager::serverNegotiate(const BSONObj& input, BSONObjBuilder* output) {
@@ -229,7 +285,7 @@ void MessageCompressorManager::serverNegotiate(const BSONObj& input, BSONObjBuil
 
     // If compression has already been negotiated, then this is a renegotiation, so we should
     // reset the state of the manager.
-    _negotiated.clear();
+    _resetNegotiation();
 
     // First we go through all the compressor names that the client has requested support for
     BSONObj theirObj = elem.Obj();
@@ -262,7 +318,42 @@ void MessageCompressorManager::serverNegotiate(const BSONObj& input, BSONObjBuil
         sub.doneFast();
     } else {
         LOG(3) << "Could not agree on compressor to use";
+        return;
+    }
+
+    _dictionaryCompressor = dynamic_cast<DictionaryMessageCompressorBase*>(_negotiated[0]);
+    if (!_dictionaryCompressor) {
+        return;
+    }
+    _dictionaryId = _dictionaryCompressor->getCurrentDictionaryId();
+    if (_dictionaryId == DictionaryMessageCompressorBase::kNoDictionary) {
+        LOG(3) << "No compression dictionary is available yet";
+        return;
     }
+
+    bool clientHasDictionary = false;
+    auto idsElem = input.getField(kDictionaryIdsFieldName);
+    if (idsElem.type() == Array) {
+        for (const auto& id : idsElem.Obj()) {
+            if (id.isNumber() && static_cast<DictionaryId>(id.safeNumberLong()) == _dictionaryId) {
+                clientHasDictionary = true;
+            }
+        }
+    }
+
+    BSONObjBuilder dictionary(output->subobjStart(kDictionaryFieldName));
+    dictionary.append("id", static_cast<long long>(_dictionaryId));
+    if (!clientHasDictionary) {
+        auto data = _dictionaryCompressor->getDictionaryData(_dictionaryId);
+        dictionary.appendBinData("data", data.size(), BinDataGeneral, data.data());
+    }
+    dictionary.doneFast();
+}
+
+void MessageCompressorManager::_resetNegotiation() {
+    _negotiated.clear();
+    _dictionaryCompressor = nullptr;
+    _dictionaryId = DictionaryMessageCompressorBase::kNoDictionary;
 }
 
 MessageCompressorManager& MessageCompressorManager::forSession(
@@ -31,6 +31,7 @@
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/status_with.h"
 #include "mongo/transport/message_compressor_base.h"
+#include "mongo/transport/message_compressor_dictionary.h"
 #include "mongo/transport/session.h"
 
 #include <vector>
@@ -64,6 +65,9 @@ public:
      * Called by a client constructing an isMaster request. This function will append the result
      * of _registry->getCompressorNames() to the BSONObjBuilder as a BSON array. If no compressors
      * are configured, it won't append anything.
+     *
+     * If any configured compressor uses dictionaries, it also appends the ids of the dictionaries
+     * it already has as "compressionDictionaries", so the server only sends one we're missing.
      */
     void clientBegin(BSONObjBuilder* output);
 
@@ -74,6 +78,9 @@ public:
      * This looks for a BSON array called "compression" with the server's list of
      * requested algorithms. The first algorithm in that array will be used in subsequent calls
      * to compressMessage.
+     *
+     * If that algorithm uses dictionaries, the server's "compressionDictionary" sub-object names
+     * the dictionary this connection compresses with, and carries its contents if it's new to us.
      */
     void clientFinish(const BSONObj& input);
 
@@ -86,6 +93,10 @@ public:
      *
      * If no compressors are configured that match those requested by the client, then it will
      * not append anything to the BSONObjBuilder output.
+     *
+     * If the first negotiated compressor uses dictionaries, this picks its current dictionary for
+     * the connection and appends it as "compressionDictionary", including its contents unless the
+     * client listed it in "compressionDictionaries".
      */
     void serverNegotiate(const BSONObj& input, BSONObjBuilder* output);
 
@@ -117,8 +128,17 @@ public:
     static MessageCompressorManager& forSession(const transport::SessionHandle& session);
 
 private:
+    using DictionaryId = DictionaryMessageCompressorBase::DictionaryId;
+
+    void _resetNegotiation();
+
     std::vector<MessageCompressorBase*> _negotiated;
     MessageCompressorRegistry* _registry;
+
+    // Set when _negotiated[0] compresses with dictionaries, along with the dictionary both ends
+    // of this connection agreed to compress with.
+    DictionaryMessageCompressorBase* _dictionaryCompressor = nullptr;
+    DictionaryId _dictionaryId = DictionaryMessageCompressorBase::kNoDictionary;
 };
 
 }  // namespace mongo
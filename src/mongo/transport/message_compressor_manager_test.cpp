@@ -28,16 +28,26 @@
 
 #include "mongo/platform/basic.h"
 
+#include "mongo/base/data_range_cursor.h"
+#include "mongo/base/data_type_endian.h"
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/config.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/transport/message_compressor_dictionary.h"
 #include "mongo/transport/message_compressor_manager.h"
 #include "mongo/transport/message_compressor_noop.h"
 #include "mongo/transport/message_compressor_registry.h"
 #include "mongo/transport/message_compressor_snappy.h"
 #include "mongo/transport/message_compressor_zlib.h"
+#ifdef MONGO_CONFIG_ZSTD
+#include "mongo/transport/message_compressor_zstd.h"
+#include "mongo/transport/message_compressor_zstd_dictionary.h"
+#endif
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/net/message.h"
 
+#include <cstring>
+#include <map>
 #include <string>
 #include <vector>
 
@@ -55,6 +65,84 @@ MessageCompressorRegistry buildRegistry() {
     return ret;
 }
 
+/*
+ * A dictionary compressor that "compresses" by prefixing the input with the dictionary id, so the
+ * tests can see which dictionary each end of a connection compressed with.
+ */
+class MockDictionaryCompressor final : public DictionaryMessageCompressorBase {
+public:
+    MockDictionaryCompressor()
+        : DictionaryMessageCompressorBase(MessageCompressor::kZstdDictionary) {}
+
+    std::size_t getMaxCompressedSize(size_t inputSize) override {
+        return inputSize + sizeof(DictionaryId);
+    }
+
+    StatusWith<std::size_t> compressDataWithDictionary(DictionaryId id,
+                                                       ConstDataRange input,
+                                                       DataRange output) override {
+        lastCompressedWith = id;
+        DataRangeCursor cursor(const_cast<char*>(output.data()),
+                               const_cast<char*>(output.data()) + output.length());
+        cursor.writeAndAdvance<LittleEndian<DictionaryId>>(id);
+        std::memcpy(const_cast<char*>(cursor.data()), input.data(), input.length());
+        return {sizeof(DictionaryId) + input.length()};
+    }
+
+    StatusWith<std::size_t> decompressData(ConstDataRange input, DataRange output) override {
+        ConstDataRangeCursor cursor(input.data(), input.data() + input.length());
+        auto id = cursor.readAndAdvance<LittleEndian<DictionaryId>>().getValue();
+        if (id != kNoDictionary && !hasDictionary(id)) {
+            return Status{ErrorCodes::BadValue, "unknown dictionary"};
+        }
+        std::memcpy(const_cast<char*>(output.data()), cursor.data(), cursor.length());
+        return {cursor.length()};
+    }
+
+    DictionaryId getCurrentDictionaryId() override {
+        return current;
+    }
+
+    std::vector<DictionaryId> getDictionaryIds() const override {
+        std::vector<DictionaryId> ids;
+        for (auto&& entry : dictionaries) {
+            ids.push_back(entry.first);
+        }
+        return ids;
+    }
+
+    bool hasDictionary(DictionaryId id) const override {
+        return dictionaries.count(id);
+    }
+
+    std::string getDictionaryData(DictionaryId id) const override {
+        auto it = dictionaries.find(id);
+        return it == dictionaries.end() ? std::string() : it->second;
+    }
+
+    Status loadDictionary(DictionaryId id, ConstDataRange data) override {
+        dictionaries.emplace(id, std::string(data.data(), data.length()));
+        return Status::OK();
+    }
+
+    void appendDictionaryStats(BSONObjBuilder* b) const override {}
+
+    std::map<DictionaryId, std::string> dictionaries;
+    DictionaryId current = kNoDictionary;
+    DictionaryId lastCompressedWith = kNoDictionary;
+};
+
+MessageCompressorRegistry buildDictionaryRegistry(
+    std::unique_ptr<MockDictionaryCompressor> compressor) {
+    MessageCompressorRegistry ret;
+    std::vector<std::string> compressorList = {compressor->getName()};
+    ret.setSupportedCompressors(std::move(compressorList));
+    ret.registerImplementation(std::move(compressor));
+    ret.finalizeSupportedCompressors();
+
+    return ret;
+}
+
 void checkNegotiationResult(const BSONObj& result, const std::vector<std::string>& algos) {
     auto compressorsList = result.getField("compression");
     if (algos.empty()) {
@@ -174,6 +262,83 @@ TEST(MessageCompressorManager, FullNormalCompression) {
     clientManager.clientFinish(serverObj);
 }
 
+TEST(MessageCompressorManager, ServerSendsDictionaryTheClientIsMissing) {
+    auto serverCompressor = stdx::make_unique<MockDictionaryCompressor>();
+    serverCompressor->dictionaries.emplace(7, "dictionary seven");
+    serverCompressor->current = 7;
+    auto serverRegistry = buildDictionaryRegistry(std::move(serverCompressor));
+    MessageCompressorManager serverManager(&serverRegistry);
+
+    auto clientCompressor = stdx::make_unique<MockDictionaryCompressor>();
+    auto client = clientCompressor.get();
+    auto clientRegistry = buildDictionaryRegistry(std::move(clientCompressor));
+    MessageCompressorManager clientManager(&clientRegistry);
+
+    BSONObjBuilder clientOutput;
+    clientManager.clientBegin(&clientOutput);
+    auto clientObj = clientOutput.obj();
+    ASSERT_TRUE(clientObj["compressionDictionaries"].eoo());
+
+    BSONObjBuilder serverOutput;
+    serverManager.serverNegotiate(clientObj, &serverOutput);
+    auto serverObj = serverOutput.obj();
+    checkNegotiationResult(serverObj, {"zstd-dict"});
+    ASSERT_EQ(serverObj["compressionDictionary"]["id"].numberLong(), 7);
+    ASSERT_EQ(serverObj["compressionDictionary"]["data"].type(), BinData);
+
+    clientManager.clientFinish(serverObj);
+    ASSERT_EQ(client->getDictionaryData(7), "dictionary seven");
+
+    auto swm = clientManager.compressMessage(buildMessage());
+    ASSERT_OK(swm.getStatus());
+    ASSERT_EQ(client->lastCompressedWith, 7U);
+    ASSERT_OK(serverManager.decompressMessage(swm.getValue()).getStatus());
+}
+
+TEST(MessageCompressorManager, ServerOmitsDictionaryTheClientHas) {
+    auto serverCompressor = stdx::make_unique<MockDictionaryCompressor>();
+    serverCompressor->dictionaries.emplace(7, "dictionary seven");
+    serverCompressor->current = 7;
+    auto server = serverCompressor.get();
+    auto serverRegistry = buildDictionaryRegistry(std::move(serverCompressor));
+    MessageCompressorManager serverManager(&serverRegistry);
+
+    auto clientCompressor = stdx::make_unique<MockDictionaryCompressor>();
+    clientCompressor->dictionaries.emplace(7, "dictionary seven");
+    auto clientRegistry = buildDictionaryRegistry(std::move(clientCompressor));
+    MessageCompressorManager clientManager(&clientRegistry);
+
+    BSONObjBuilder clientOutput;
+    clientManager.clientBegin(&clientOutput);
+    auto clientObj = clientOutput.obj();
+    ASSERT_EQ(clientObj["compressionDictionaries"].Array().size(), 1U);
+
+    BSONObjBuilder serverOutput;
+    serverManager.serverNegotiate(clientObj, &serverOutput);
+    auto serverObj = serverOutput.obj();
+    ASSERT_EQ(serverObj["compressionDictionary"]["id"].numberLong(), 7);
+    ASSERT_TRUE(serverObj["compressionDictionary"]["data"].eoo());
+
+    clientManager.clientFinish(serverObj);
+    auto swm = serverManager.compressMessage(buildMessage());
+    ASSERT_OK(swm.getStatus());
+    ASSERT_EQ(server->lastCompressedWith, 7U);
+    ASSERT_OK(clientManager.decompressMessage(swm.getValue()).getStatus());
+}
+
+TEST(MessageCompressorManager, DictionaryCompressorWithoutDictionaryCompressesWithoutOne) {
+    auto serverRegistry = buildDictionaryRegistry(stdx::make_unique<MockDictionaryCompressor>());
+    MessageCompressorManager serverManager(&serverRegistry);
+
+    BSONObjBuilder serverOutput;
+    serverManager.serverNegotiate(BSON("isMaster" << 1 << "compression" << BSON_ARRAY("zstd-dict")),
+                                  &serverOutput);
+    auto serverObj = serverOutput.obj();
+    checkNegotiationResult(serverObj, {"zstd-dict"});
+    ASSERT_TRUE(serverObj["compressionDictionary"].eoo());
+    ASSERT_OK(serverManager.compressMessage(buildMessage()).getStatus());
+}
+
 TEST(NoopMessageCompressor, Fidelity) {
     auto testMessage = buildMessage();
     checkFidelity(testMessage, stdx::make_unique<NoopMessageCompressor>());
@@ -189,5 +354,75 @@ TEST(ZlibMessageCompressor, Fidelity) {
     checkFidelity(testMessage, stdx::make_unique<ZlibMessageCompressor>());
 }
 
+#ifdef MONGO_CONFIG_ZSTD
+TEST(ZstdMessageCompressor, Fidelity) {
+    auto testMessage = buildMessage();
+    checkFidelity(testMessage, stdx::make_unique<ZstdMessageCompressor>());
+    checkFidelity(testMessage, stdx::make_unique<ZstdMessageCompressor>(19));
+}
+
+TEST(ZstdMessageCompressor, ValidateCompressionLevel) {
+    ASSERT_OK(ZstdMessageCompressor::validateCompressionLevel(1));
+    ASSERT_OK(ZstdMessageCompressor::validateCompressionLevel(
+        ZstdMessageCompressor::kDefaultCompressionLevel));
+    ASSERT_NOT_OK(ZstdMessageCompressor::validateCompressionLevel(0));
+    ASSERT_NOT_OK(ZstdMessageCompressor::validateCompressionLevel(100));
+}
+
+TEST(ZstdDictionaryMessageCompressor, Fidelity) {
+    auto testMessage = buildMessage();
+    checkFidelity(testMessage, stdx::make_unique<ZstdDictionaryMessageCompressor>(3));
+}
+
+TEST(ZstdDictionaryMessageCompressor, CompressesWithTrainedDictionary) {
+    std::string samples;
+    std::vector<std::size_t> sizes;
+    for (int i = 0; i < 5000; ++i) {
+        auto doc = BSON("insert"
+                        << "orders"
+                        << "documents"
+                        << BSON_ARRAY(BSON("_id" << i << "customer" << i % 13 << "status"
+                                                 << "pending")));
+        samples.append(doc.objdata(), doc.objsize());
+        sizes.push_back(doc.objsize());
+    }
+
+    ZstdDictionaryMessageCompressor server(3);
+    ASSERT_OK(server.trainDictionary(samples, sizes));
+    auto id = server.getCurrentDictionaryId();
+    ASSERT_NE(id, DictionaryMessageCompressorBase::kNoDictionary);
+
+    ZstdDictionaryMessageCompressor client(3);
+    auto data = server.getDictionaryData(id);
+    ASSERT_OK(client.loadDictionary(id, ConstDataRange(data.data(), data.size())));
+    ASSERT_NOT_OK(client.loadDictionary(id + 1, ConstDataRange(data.data(), data.size())));
+
+    auto input = BSON("insert"
+                      << "orders"
+                      << "documents"
+                      << BSON_ARRAY(BSON("_id" << 12345 << "customer" << 4 << "status"
+                                               << "pending")));
+    std::vector<char> compressed(client.getMaxCompressedSize(input.objsize()));
+    auto sws = client.compressDataWithDictionary(id,
+                                                 ConstDataRange(input.objdata(), input.objsize()),
+                                                 DataRange(compressed.data(), compressed.size()));
+    ASSERT_OK(sws.getStatus());
+
+    std::vector<char> decompressed(input.objsize());
+    ASSERT_OK(server
+                  .decompressData(ConstDataRange(compressed.data(), sws.getValue()),
+                                  DataRange(decompressed.data(), decompressed.size()))
+                  .getStatus());
+    ASSERT_EQ(std::memcmp(decompressed.data(), input.objdata(), input.objsize()), 0);
+
+    // A compressor without the dictionary can't decompress the message.
+    ZstdDictionaryMessageCompressor other(3);
+    ASSERT_NOT_OK(other
+                      .decompressData(ConstDataRange(compressed.data(), sws.getValue()),
+                                      DataRange(decompressed.data(), decompressed.size()))
+                      .getStatus());
+}
+#endif
+
 }  // namespace mongo
 }  // namespace
@@ -29,6 +29,7 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/transport/message_compressor_dictionary.h"
 #include "mongo/transport/message_compressor_registry.h"
 
 namespace mongo {
@@ -58,6 +59,15 @@ void appendMessageCompressionStats(BSONObjBuilder* b) {
         decompressed << kBytesIn << compressor->getDecompressedBytesIn() << kBytesOut
                      << compressor->getDecompressedBytesOut();
         decompressed.doneFast();
+
+        // Dictionary compressors also break their counters down by dictionary, so the ratio each
+        // dictionary achieves can be compared across retrainings.
+        auto dictionaryCompressor = dynamic_cast<DictionaryMessageCompressorBase*>(compressor);
+        if (dictionaryCompressor) {
+            BSONObjBuilder dictionaries(base.subobjStart("dictionaries"));
+            dictionaryCompressor->appendDictionaryStats(&dictionaries);
+            dictionaries.doneFast();
+        }
         base.doneFast();
     }
     compressionSection.doneFast();
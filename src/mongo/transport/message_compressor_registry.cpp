@@ -28,6 +28,8 @@
 
 #include "mongo/platform/basic.h"
 
+#include "mongo/config.h"
+
 #include "mongo/transport/message_compressor_registry.h"
 
 #include "mongo/base/init.h"
@@ -54,6 +56,10 @@ StringData getMessageCompressorName(MessageCompressor id) {
             return "snappy"_sd;
         case MessageCompressor::kZlib:
             return "zlib"_sd;
+        case MessageCompressor::kZstd:
+            return "zstd"_sd;
+        case MessageCompressor::kZstdDictionary:
+            return "zstd-dict"_sd;
         default:
             fassert(40269, "Invalid message compressor ID");
     }
@@ -123,6 +129,16 @@ Status addMessageCompressionOptions(moe::OptionSection* options, bool forShell)
     if (forShell)
         ret.hidden();
 
+#ifdef MONGO_CONFIG_ZSTD
+    auto zstdLevel = options->addOptionChaining("net.compression.zstdCompressionLevel",
+                                                "zstdCompressionLevel",
+                                                moe::Int,
+                                                "Compression level used by the zstd and zstd-dict "
+                                                "network message compressors (1 to 22, default 3)");
+    if (forShell)
+        zstdLevel.hidden();
+#endif
+
     return Status::OK();
 }
 
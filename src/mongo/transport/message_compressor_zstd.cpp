@@ -0,0 +1,140 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kNetwork
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/base/init.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/transport/message_compressor_registry.h"
+#include "mongo/transport/message_compressor_zstd.h"
+#include "mongo/util/concurrency/threadlocal.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/options_parser/startup_options.h"
+
+#include <zstd.h>
+
+namespace mongo {
+namespace {
+
+// Each thread keeps its own zstd contexts, as allocating them costs more than compressing a small
+// message.
+class ZstdContexts {
+    MONGO_DISALLOW_COPYING(ZstdContexts);
+
+public:
+    ZstdContexts() : compression(ZSTD_createCCtx()), decompression(ZSTD_createDCtx()) {}
+
+    ~ZstdContexts() {
+        ZSTD_freeCCtx(compression);
+        ZSTD_freeDCtx(decompression);
+    }
+
+    ZSTD_CCtx* const compression;
+    ZSTD_DCtx* const decompression;
+};
+
+}  // namespace
+
+TSP_DECLARE(ZstdContexts, zstdContexts);
+TSP_DEFINE(ZstdContexts, zstdContexts);
+
+ZstdMessageCompressor::ZstdMessageCompressor(int compressionLevel)
+    : MessageCompressorBase(MessageCompressor::kZstd), _compressionLevel(compressionLevel) {}
+
+Status ZstdMessageCompressor::validateCompressionLevel(int compressionLevel) {
+    if (compressionLevel < 1 || compressionLevel > ZSTD_maxCLevel()) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "zstd compression level must be between 1 and "
+                              << ZSTD_maxCLevel()
+                              << ", but was "
+                              << compressionLevel};
+    }
+    return Status::OK();
+}
+
+std::size_t ZstdMessageCompressor::getMaxCompressedSize(size_t inputSize) {
+    return ZSTD_compressBound(inputSize);
+}
+
+StatusWith<std::size_t> ZstdMessageCompressor::compressData(ConstDataRange input,
+                                                            DataRange output) {
+    ZstdContexts* contexts = zstdContexts.getMake();
+    size_t outLength = ZSTD_compressCCtx(contexts->compression,
+                                         const_cast<char*>(output.data()),
+                                         output.length(),
+                                         input.data(),
+                                         input.length(),
+                                         _compressionLevel);
+
+    if (ZSTD_isError(outLength)) {
+        return Status{ErrorCodes::BadValue, "Could not compress input"};
+    }
+    counterHitCompress(input.length(), outLength);
+    return {outLength};
+}
+
+StatusWith<std::size_t> ZstdMessageCompressor::decompressData(ConstDataRange input,
+                                                              DataRange output) {
+    ZstdContexts* contexts = zstdContexts.getMake();
+    size_t length = ZSTD_decompressDCtx(contexts->decompression,
+                                        const_cast<char*>(output.data()),
+                                        output.length(),
+                                        input.data(),
+                                        input.length());
+
+    if (ZSTD_isError(length) || length != output.length()) {
+        return Status{ErrorCodes::BadValue, "Compressed message was invalid or corrupted"};
+    }
+
+    counterHitDecompress(input.length(), output.length());
+    return {output.length()};
+}
+
+
+MONGO_INITIALIZER_GENERAL(ZstdMessageCompressorInit,
+                          ("EndStartupOptionHandling"),
+                          ("AllCompressorsRegistered"))
+(InitializerContext* context) {
+    int compressionLevel = ZstdMessageCompressor::kDefaultCompressionLevel;
+    if (moe::startupOptionsParsed.count("net.compression.zstdCompressionLevel")) {
+        compressionLevel =
+            moe::startupOptionsParsed["net.compression.zstdCompressionLevel"].as<int>();
+    }
+    Status status = ZstdMessageCompressor::validateCompressionLevel(compressionLevel);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    auto& compressorRegistry = MessageCompressorRegistry::get();
+    compressorRegistry.registerImplementation(
+        stdx::make_unique<ZstdMessageCompressor>(compressionLevel));
+    return Status::OK();
+}
+}  // namespace mongo
@@ -0,0 +1,354 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kNetwork
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/message_compressor_zstd_dictionary.h"
+
+#include "mongo/base/init.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/transport/message_compressor_registry.h"
+#include "mongo/transport/message_compressor_zstd.h"
+#include "mongo/util/concurrency/threadlocal.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/options_parser/startup_options.h"
+
+#include <zdict.h>
+#include <zstd.h>
+
+namespace mongo {
+namespace {
+
+class ZstdDictionaryContexts {
+    MONGO_DISALLOW_COPYING(ZstdDictionaryContexts);
+
+public:
+    ZstdDictionaryContexts() : compression(ZSTD_createCCtx()), decompression(ZSTD_createDCtx()) {}
+
+    ~ZstdDictionaryContexts() {
+        ZSTD_freeCCtx(compression);
+        ZSTD_freeDCtx(decompression);
+    }
+
+    ZSTD_CCtx* const compression;
+    ZSTD_DCtx* const decompression;
+};
+
+}  // namespace
+
+TSP_DECLARE(ZstdDictionaryContexts, zstdDictionaryContexts);
+TSP_DEFINE(ZstdDictionaryContexts, zstdDictionaryContexts);
+
+const Minutes ZstdDictionaryMessageCompressor::kRetrainInterval{60};
+
+struct ZstdDictionaryMessageCompressor::Dictionary {
+    MONGO_DISALLOW_COPYING(Dictionary);
+
+    Dictionary(DictionaryId id, int version, std::string contents, int compressionLevel)
+        : id(id),
+          version(version),
+          data(std::move(contents)),
+          compression(ZSTD_createCDict(data.data(), data.size(), compressionLevel)),
+          decompression(ZSTD_createDDict(data.data(), data.size())) {}
+
+    ~Dictionary() {
+        ZSTD_freeCDict(compression);
+        ZSTD_freeDDict(decompression);
+    }
+
+    const DictionaryId id;
+    // The training generation of dictionaries this process trained, or 0 for ones received from
+    // a server.
+    const int version;
+    const std::string data;
+    ZSTD_CDict* const compression;
+    ZSTD_DDict* const decompression;
+
+    AtomicInt64 compressBytesIn;
+    AtomicInt64 compressBytesOut;
+    AtomicInt64 decompressBytesIn;
+    AtomicInt64 decompressBytesOut;
+};
+
+ZstdDictionaryMessageCompressor::ZstdDictionaryMessageCompressor(int compressionLevel)
+    : DictionaryMessageCompressorBase(MessageCompressor::kZstdDictionary),
+      _compressionLevel(compressionLevel) {}
+
+ZstdDictionaryMessageCompressor::~ZstdDictionaryMessageCompressor() = default;
+
+std::size_t ZstdDictionaryMessageCompressor::getMaxCompressedSize(size_t inputSize) {
+    return ZSTD_compressBound(inputSize);
+}
+
+StatusWith<std::size_t> ZstdDictionaryMessageCompressor::compressDataWithDictionary(
+    DictionaryId id, ConstDataRange input, DataRange output) {
+    _maybeSample(input);
+
+    ZstdDictionaryContexts* contexts = zstdDictionaryContexts.getMake();
+    auto dictionary = _getDictionary(id);
+    size_t outLength;
+    if (dictionary) {
+        outLength = ZSTD_compress_usingCDict(contexts->compression,
+                                             const_cast<char*>(output.data()),
+                                             output.length(),
+                                             input.data(),
+                                             input.length(),
+                                             dictionary->compression);
+    } else {
+        outLength = ZSTD_compressCCtx(contexts->compression,
+                                      const_cast<char*>(output.data()),
+                                      output.length(),
+                                      input.data(),
+                                      input.length(),
+                                      _compressionLevel);
+    }
+
+    if (ZSTD_isError(outLength)) {
+        return Status{ErrorCodes::BadValue, "Could not compress input"};
+    }
+    if (dictionary) {
+        dictionary->compressBytesIn.addAndFetch(input.length());
+        dictionary->compressBytesOut.addAndFetch(outLength);
+    }
+    counterHitCompress(input.length(), outLength);
+    return {outLength};
+}
+
+StatusWith<std::size_t> ZstdDictionaryMessageCompressor::decompressData(ConstDataRange input,
+                                                                        DataRange output) {
+    ZstdDictionaryContexts* contexts = zstdDictionaryContexts.getMake();
+    DictionaryId id = ZSTD_getDictID_fromFrame(input.data(), input.length());
+    std::shared_ptr<Dictionary> dictionary;
+    size_t length;
+    if (id == kNoDictionary) {
+        length = ZSTD_decompressDCtx(contexts->decompression,
+                                     const_cast<char*>(output.data()),
+                                     output.length(),
+                                     input.data(),
+                                     input.length());
+    } else {
+        dictionary = _getDictionary(id);
+        if (!dictionary) {
+            return Status{ErrorCodes::BadValue,
+                          str::stream() << "Compressed message uses unknown dictionary " << id};
+        }
+        length = ZSTD_decompress_usingDDict(contexts->decompression,
+                                            const_cast<char*>(output.data()),
+                                            output.length(),
+                                            input.data(),
+                                            input.length(),
+                                            dictionary->decompression);
+    }
+
+    if (ZSTD_isError(length) || length != output.length()) {
+        return Status{ErrorCodes::BadValue, "Compressed message was invalid or corrupted"};
+    }
+
+    if (dictionary) {
+        dictionary->decompressBytesIn.addAndFetch(input.length());
+        dictionary->decompressBytesOut.addAndFetch(output.length());
+    }
+    counterHitDecompress(input.length(), output.length());
+    _maybeSample(ConstDataRange(output.data(), output.length()));
+    return {output.length()};
+}
+
+DictionaryMessageCompressorBase::DictionaryId
+ZstdDictionaryMessageCompressor::getCurrentDictionaryId() {
+    _samplingEnabled.store(true);
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _current;
+}
+
+std::vector<DictionaryMessageCompressorBase::DictionaryId>
+ZstdDictionaryMessageCompressor::getDictionaryIds() const {
+    std::vector<DictionaryId> ids;
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    for (auto&& entry : _dictionaries) {
+        ids.push_back(entry.first);
+    }
+    return ids;
+}
+
+bool ZstdDictionaryMessageCompressor::hasDictionary(DictionaryId id) const {
+    return static_cast<bool>(_getDictionary(id));
+}
+
+std::string ZstdDictionaryMessageCompressor::getDictionaryData(DictionaryId id) const {
+    auto dictionary = _getDictionary(id);
+    return dictionary ? dictionary->data : std::string();
+}
+
+Status ZstdDictionaryMessageCompressor::loadDictionary(DictionaryId id, ConstDataRange data) {
+    // The id is part of the dictionary contents, so check that the peer sent a consistent pair.
+    if (id == kNoDictionary || ZDICT_getDictID(data.data(), data.length()) != id) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "Received compression dictionary does not have id " << id};
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_dictionaries.count(id)) {
+        return Status::OK();
+    }
+    return _addDictionary_inlock(id, 0, std::string(data.data(), data.length()));
+}
+
+void ZstdDictionaryMessageCompressor::appendDictionaryStats(BSONObjBuilder* b) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    for (auto&& entry : _dictionaries) {
+        const auto& dictionary = *entry.second;
+        BSONObjBuilder sub(b->subobjStart(std::to_string(dictionary.id)));
+        if (dictionary.version) {
+            sub.append("version", dictionary.version);
+        }
+        sub.append("current", dictionary.id == _current);
+        sub.append("size", static_cast<long long>(dictionary.data.size()));
+        sub.append("compressed",
+                   BSON("bytesIn" << dictionary.compressBytesIn.loadRelaxed() << "bytesOut"
+                                  << dictionary.compressBytesOut.loadRelaxed()));
+        sub.append("decompressed",
+                   BSON("bytesIn" << dictionary.decompressBytesIn.loadRelaxed() << "bytesOut"
+                                  << dictionary.decompressBytesOut.loadRelaxed()));
+        sub.doneFast();
+    }
+}
+
+Status ZstdDictionaryMessageCompressor::trainDictionary(const std::string& samples,
+                                                        const std::vector<std::size_t>& sizes) {
+    std::string data(kDictionaryCapacity, '\0');
+    size_t size = ZDICT_trainFromBuffer(
+        &data[0], data.size(), samples.data(), sizes.data(), static_cast<unsigned>(sizes.size()));
+    if (ZDICT_isError(size)) {
+        return {ErrorCodes::OperationFailed,
+                str::stream() << "Could not train compression dictionary: "
+                              << ZDICT_getErrorName(size)};
+    }
+    data.resize(size);
+
+    DictionaryId id = ZDICT_getDictID(data.data(), data.size());
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (id == kNoDictionary || _dictionaries.count(id)) {
+        return {ErrorCodes::OperationFailed,
+                str::stream() << "Trained compression dictionary has unusable id " << id};
+    }
+    auto status = _addDictionary_inlock(id, _trainedDictionaries + 1, std::move(data));
+    if (!status.isOK()) {
+        return status;
+    }
+    ++_trainedDictionaries;
+    _current = id;
+    log() << "Trained network compression dictionary " << id << " (version "
+          << _trainedDictionaries << ") from " << sizes.size() << " sampled messages";
+    return Status::OK();
+}
+
+std::shared_ptr<ZstdDictionaryMessageCompressor::Dictionary>
+ZstdDictionaryMessageCompressor::_getDictionary(DictionaryId id) const {
+    if (id == kNoDictionary) {
+        return nullptr;
+    }
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _dictionaries.find(id);
+    return it == _dictionaries.end() ? nullptr : it->second;
+}
+
+Status ZstdDictionaryMessageCompressor::_addDictionary_inlock(DictionaryId id,
+                                                              int version,
+                                                              std::string data) {
+    auto dictionary = std::make_shared<Dictionary>(id, version, std::move(data), _compressionLevel);
+    if (!dictionary->compression || !dictionary->decompression) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "Could not load compression dictionary " << id};
+    }
+    _dictionaries.emplace(id, std::move(dictionary));
+    return Status::OK();
+}
+
+void ZstdDictionaryMessageCompressor::_maybeSample(ConstDataRange message) {
+    if (!_samplingEnabled.load() || message.length() > kMaxSampleSize ||
+        _messagesSeen.fetchAndAdd(1) % kSampleInterval != 0) {
+        return;
+    }
+
+    std::string samples;
+    std::vector<std::size_t> sizes;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_training || _trainedDictionaries >= kMaxTrainedDictionaries ||
+            Date_t::now() < _nextTraining) {
+            return;
+        }
+        _samples.append(message.data(), message.length());
+        _sampleSizes.push_back(message.length());
+        if (_samples.size() < kSampleBytesPerTraining) {
+            return;
+        }
+        _training = true;
+        samples.swap(_samples);
+        sizes.swap(_sampleSizes);
+    }
+
+    // Training takes far longer than compressing a message, so keep it off the network thread.
+    // The compressor lives in the global registry, which outlives every thread.
+    stdx::thread([ this, samples = std::move(samples), sizes = std::move(sizes) ] {
+        auto status = trainDictionary(samples, sizes);
+        if (!status.isOK()) {
+            warning() << status;
+        }
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _training = false;
+        _nextTraining = Date_t::now() + kRetrainInterval;
+    }).detach();
+}
+
+
+MONGO_INITIALIZER_GENERAL(ZstdDictionaryMessageCompressorInit,
+                          ("EndStartupOptionHandling"),
+                          ("AllCompressorsRegistered"))
+(InitializerContext* context) {
+    int compressionLevel = ZstdMessageCompressor::kDefaultCompressionLevel;
+    if (moe::startupOptionsParsed.count("net.compression.zstdCompressionLevel")) {
+        compressionLevel =
+            moe::startupOptionsParsed["net.compression.zstdCompressionLevel"].as<int>();
+    }
+    Status status = ZstdMessageCompressor::validateCompressionLevel(compressionLevel);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    auto& compressorRegistry = MessageCompressorRegistry::get();
+    compressorRegistry.registerImplementation(
+        stdx::make_unique<ZstdDictionaryMessageCompressor>(compressionLevel));
+    return Status::OK();
+}
+}  // namespace mongo
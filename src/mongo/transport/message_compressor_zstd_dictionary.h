@@ -0,0 +1,121 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/transport/message_compressor_dictionary.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+/*
+ * Compresses messages with zstd against dictionaries trained from a sample of this process's own
+ * traffic.
+ *
+ * Once this process has negotiated "zstd-dict" as a server, it samples one in every
+ * kSampleInterval small messages. When enough samples are collected it trains a new dictionary
+ * on a background thread and offers it to connections negotiated from then on. Dictionaries are
+ * never discarded, because connections negotiated earlier keep compressing with them, so at most
+ * kMaxTrainedDictionaries are trained and training runs at most once per kRetrainInterval.
+ *
+ * zstd records the dictionary id in each frame it writes, which is how decompressData finds the
+ * dictionary a message was compressed with.
+ */
+class ZstdDictionaryMessageCompressor final : public DictionaryMessageCompressorBase {
+public:
+    // Only messages up to this size are sampled, as larger messages are already compressed well.
+    static const std::size_t kMaxSampleSize = 16 * 1024;
+    static const std::size_t kSampleBytesPerTraining = 1024 * 1024;
+    static const std::size_t kDictionaryCapacity = 64 * 1024;
+    static const uint64_t kSampleInterval = 100;
+    static const int kMaxTrainedDictionaries = 16;
+    static const Minutes kRetrainInterval;
+
+    explicit ZstdDictionaryMessageCompressor(int compressionLevel);
+    ~ZstdDictionaryMessageCompressor();
+
+    std::size_t getMaxCompressedSize(size_t inputSize) override;
+
+    StatusWith<std::size_t> compressDataWithDictionary(DictionaryId id,
+                                                       ConstDataRange input,
+                                                       DataRange output) override;
+
+    StatusWith<std::size_t> decompressData(ConstDataRange input, DataRange output) override;
+
+    DictionaryId getCurrentDictionaryId() override;
+
+    std::vector<DictionaryId> getDictionaryIds() const override;
+
+    bool hasDictionary(DictionaryId id) const override;
+
+    std::string getDictionaryData(DictionaryId id) const override;
+
+    Status loadDictionary(DictionaryId id, ConstDataRange data) override;
+
+    void appendDictionaryStats(BSONObjBuilder* b) const override;
+
+    /*
+     * Trains a dictionary from the given samples and makes it the current dictionary. This is
+     * what the background training thread runs, and is exposed for testing.
+     */
+    Status trainDictionary(const std::string& samples, const std::vector<std::size_t>& sizes);
+
+private:
+    struct Dictionary;
+
+    std::shared_ptr<Dictionary> _getDictionary(DictionaryId id) const;
+
+    Status _addDictionary_inlock(DictionaryId id, int version, std::string data);
+
+    void _maybeSample(ConstDataRange message);
+
+    const int _compressionLevel;
+
+    // Set once this process negotiates dictionary compression as a server. Pure clients never
+    // train dictionaries; they only use the ones servers send them.
+    AtomicWord<bool> _samplingEnabled{false};
+    AtomicUInt64 _messagesSeen;
+
+    mutable stdx::mutex _mutex;
+
+    std::map<DictionaryId, std::shared_ptr<Dictionary>> _dictionaries;
+    DictionaryId _current = kNoDictionary;
+    int _trainedDictionaries = 0;
+
+    std::string _samples;
+    std::vector<std::size_t> _sampleSizes;
+    bool _training = false;
+    Date_t _nextTraining;
+};
+
+}  // namespace mongo
@@ -37,10 +37,13 @@
 #include "mongo/db/assemble_response.h"
 #include "mongo/db/client.h"
 #include "mongo/db/dbmessage.h"
+#include "mongo/db/server_options.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/transport/service_entry_point_utils.h"
+#include "mongo/transport/service_state_machine.h"
 #include "mongo/transport/session.h"
 #include "mongo/transport/ticket.h"
+#include "mongo/transport/traffic_recorder.h"
 #include "mongo/transport/transport_layer.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/exit.h"
@@ -52,46 +55,25 @@
 #include "mongo/util/scopeguard.h"
 
 namespace mongo {
-namespace {
-
-// Set up proper headers for formatting an exhaust request, if we need to
-bool setExhaustMessage(Message* m, const DbResponse& dbresponse) {
-    MsgData::View header = dbresponse.response.header();
-    QueryResult::View qr = header.view2ptr();
-    long long cursorid = qr.getCursorId();
-
-    if (!cursorid) {
-        return false;
-    }
-
-    verify(dbresponse.exhaustNS.size() && dbresponse.exhaustNS[0]);
-
-    auto ns = dbresponse.exhaustNS;  // reset() will free this
-
-    m->reset();
-
-    BufBuilder b(512);
-    b.appendNum(static_cast<int>(0) /* size set later in appendData() */);
-    b.appendNum(header.getId());
-    b.appendNum(header.getResponseToMsgId());
-    b.appendNum(static_cast<int>(dbGetMore));
-    b.appendNum(static_cast<int>(0));
-    b.appendStr(ns);
-    b.appendNum(static_cast<int>(0));  // ntoreturn
-    b.appendNum(cursorid);
-
-    MsgData::View(b.buf()).setLen(b.len());
-    m->setData(b.release());
-
-    return true;
-}
-
-}  // namespace
 
 using transport::Session;
 using transport::TransportLayer;
 
+ServiceEntryPointImpl::ServiceEntryPointImpl(transport::TransportLayer* tl) : _tl(tl) {
+    startTrafficRecordingIfConfigured();
+}
+
 void ServiceEntryPointImpl::startSession(transport::SessionHandle session) {
+    if (serverGlobalParams.transportLayer == "asio") {
+        // The asio transport layer drives the session from its own worker threads, so no thread
+        // is launched here.
+        _nWorkers.fetchAndAdd(1);
+        auto ssm = ServiceStateMachine::create(getGlobalServiceContext(), std::move(session), this);
+        ssm->setCleanupHook([this] { _nWorkers.fetchAndSubtract(1); });
+        ssm->start();
+        return;
+    }
+
     // Pass ownership of the transport::SessionHandle into our worker thread. When this
     // thread exits, the session will end.
     launchWrappedServiceEntryWorkerThread(
@@ -108,6 +90,9 @@ void ServiceEntryPointImpl::_sessionLoop(const transport::SessionHandle& session
     bool inExhaust = false;
     int64_t counter = 0;
 
+    auto& trafficRecorder = TrafficRecorder::get();
+    ON_BLOCK_EXIT([&] { trafficRecorder.recordSessionEnd(session->id()); });
+
     while (true) {
         // 1. Source a Message from the client (unless we are exhausting)
         if (!inExhaust) {
@@ -128,6 +113,7 @@ void ServiceEntryPointImpl::_sessionLoop(const transport::SessionHandle& session
             }
 
             uassertStatusOK(status);
+            trafficRecorder.record(session->id(), TrafficRecorder::EventType::kRequest, inMessage);
         }
 
         // 2. Pass sourced Message to handler to generate response.
@@ -148,12 +134,14 @@ void ServiceEntryPointImpl::_sessionLoop(const transport::SessionHandle& session
             toSink.header().setResponseToMsgId(inMessage.header().getId());
 
             // If this is an exhaust cursor, don't source more Messages
-            if (dbresponse.exhaustNS.size() > 0 && setExhaustMessage(&inMessage, dbresponse)) {
+            if (setExhaustMessage(&inMessage, dbresponse)) {
                 inExhaust = true;
             } else {
                 inExhaust = false;
             }
 
+            trafficRecorder.record(session->id(), TrafficRecorder::EventType::kResponse, toSink);
+
             // 4. Sink our response to the client
             uassertStatusOK(session->sinkMessage(toSink).wait());
         } else {
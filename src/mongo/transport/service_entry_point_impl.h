@@ -49,13 +49,14 @@ class TransportLayer;
  *
  * The server logic is implemented inside of handleRequest() by a subclass.
  * startSession() spawns and detaches a new thread for each incoming connection
- * (transport::Session).
+ * (transport::Session). When the asio transport layer is in use, the session is instead handed
+ * to a ServiceStateMachine, which is driven by the transport layer's worker threads.
  */
 class ServiceEntryPointImpl : public ServiceEntryPoint {
     MONGO_DISALLOW_COPYING(ServiceEntryPointImpl);
 
 public:
-    explicit ServiceEntryPointImpl(transport::TransportLayer* tl) : _tl(tl) {}
+    explicit ServiceEntryPointImpl(transport::TransportLayer* tl);
 
     void startSession(transport::SessionHandle session) final;
 
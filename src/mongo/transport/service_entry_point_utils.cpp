@@ -33,6 +33,7 @@
 #include "mongo/transport/service_entry_point_utils.h"
 
 #include "mongo/db/client.h"
+#include "mongo/db/dbmessage.h"
 #include "mongo/db/server_options.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/transport/session.h"
@@ -40,7 +41,9 @@
 #include "mongo/util/assert_util.h"
 #include "mongo/util/debug_util.h"
 #include "mongo/util/log.h"
+#include "mongo/util/net/op_msg.h"
 #include "mongo/util/net/socket_exception.h"
+#include "mongo/util/numa.h"
 #include "mongo/util/quick_exit.h"
 
 #ifdef __linux__  // TODO: consider making this ifndef _WIN32
@@ -73,6 +76,13 @@ void* runFunc(void* ptr) {
     auto client = getGlobalServiceContext()->makeClient("conn", ctx->session);
     setThreadName(str::stream() << "conn" << ctx->session->id());
 
+    if (NumaTopology::shouldBindServiceThreads()) {
+        Status status = NumaTopology::get().bindThreadToNode(ctx->session->id());
+        if (!status.isOK()) {
+            LOG(1) << status.reason();
+        }
+    }
+
     Client::setCurrent(std::move(client));
 
     auto tl = ctx->session->getTransportLayer();
@@ -156,4 +166,51 @@ void launchWrappedServiceEntryWorkerThread(
     }
 }
 
+bool setExhaustMessage(Message* m, const DbResponse& dbresponse) {
+    MsgData::View header = dbresponse.response.header();
+
+    if (!dbresponse.nextInvocation.isEmpty()) {
+        OpMsgBuilder builder;
+        builder.setBody(dbresponse.nextInvocation);
+        builder.flags() = OpMsg::kExhaustAllowed;
+        *m = builder.finish();
+        m->header().setId(header.getId());
+        m->header().setResponseToMsgId(header.getResponseToMsgId());
+        return true;
+    }
+
+    if (dbresponse.exhaustNS.empty()) {
+        return false;
+    }
+
+    QueryResult::View qr = header.view2ptr();
+    long long cursorid = qr.getCursorId();
+
+    if (!cursorid) {
+        return false;
+    }
+
+    verify(dbresponse.exhaustNS.size() && dbresponse.exhaustNS[0]);
+
+    auto ns = dbresponse.exhaustNS;  // reset() will free this
+
+    m->reset();
+
+    BufBuilder b(512);
+    b.appendNum(static_cast<int>(0) /* size set later in appendData() */);
+    b.appendNum(header.getId());
+    b.appendNum(header.getResponseToMsgId());
+    b.appendNum(static_cast<int>(dbGetMore));
+    b.appendNum(static_cast<int>(0));
+    b.appendStr(ns);
+    b.appendNum(static_cast<int>(0));  // ntoreturn
+    b.appendNum(cursorid);
+
+    MsgData::View(b.buf()).setLen(b.len());
+    m->setData(b.release());
+
+    return true;
+}
+
+
 }  // namespace mongo
@@ -33,7 +33,17 @@
 
 namespace mongo {
 
+struct DbResponse;
+class Message;
+
 void launchWrappedServiceEntryWorkerThread(
     transport::SessionHandle session, stdx::function<void(const transport::SessionHandle&)> task);
 
+/**
+ * Rewrites the request in 'm' into the OP_GET_MORE, or the OP_MSG getMore command, needed to
+ * continue an exhaust cursor. Returns false if 'dbresponse' is not for an exhaust cursor or has
+ * exhausted its cursor and no getMore is needed.
+ */
+bool setExhaustMessage(Message* m, const DbResponse& dbresponse);
+
 }  // namespace mongo
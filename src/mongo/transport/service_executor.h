@@ -0,0 +1,84 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/stdx/functional.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+namespace transport {
+
+/**
+ * A ServiceExecutor is responsible for running the database side of each request (the "process"
+ * step of a ServiceStateMachine) on its own worker threads, decoupled from the threads that
+ * perform network I/O.
+ */
+class ServiceExecutor {
+    MONGO_DISALLOW_COPYING(ServiceExecutor);
+
+public:
+    virtual ~ServiceExecutor() = default;
+    using Task = stdx::function<void()>;
+
+    /*
+     * Starts the ServiceExecutor. This may create threads even if no tasks are scheduled.
+     */
+    virtual Status start() = 0;
+
+    /*
+     * Schedules a task with the ServiceExecutor and returns immediately.
+     *
+     * This is guaranteed to unwind the stack before running the task, although the task may be
+     * run later in the same thread.
+     */
+    virtual Status schedule(Task task) = 0;
+
+    /*
+     * Stops and joins the ServiceExecutor. Any outstanding tasks will not be executed, and any
+     * associated callbacks waiting on I/O may get called with an error code.
+     *
+     * This should only be called during server shutdown to gracefully destroy the ServiceExecutor
+     */
+    virtual Status shutdown() = 0;
+
+    /*
+     * Appends statistics about task scheduling to a BSONObjBuilder for serverStatus output.
+     */
+    virtual void appendStats(BSONObjBuilder* bob) const = 0;
+
+protected:
+    ServiceExecutor() = default;
+};
+
+}  // namespace transport
+}  // namespace mongo
@@ -0,0 +1,390 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kExecutor
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/service_executor_adaptive.h"
+
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/numa.h"
+#include "mongo/util/processinfo.h"
+
+namespace mongo {
+namespace transport {
+namespace {
+
+// The number of threads the executor keeps running. -1 means half the number of cores.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(adaptiveServiceExecutorReservedThreads, int, -1);
+
+// The most threads the executor will start. -1 means ten per core.
+MONGO_EXPORT_SERVER_PARAMETER(adaptiveServiceExecutorMaxThreads, int, -1);
+
+// The window, in milliseconds, over which a worker measures its utilization.
+MONGO_EXPORT_SERVER_PARAMETER(adaptiveServiceExecutorRunTimeMillis, int, 5000);
+
+// Workers that are busy for less than this percentage of a window retire.
+MONGO_EXPORT_SERVER_PARAMETER(adaptiveServiceExecutorIdlePctThreshold, int, 60);
+
+// A new worker is started when a task has been queued this long and no worker is free.
+MONGO_EXPORT_SERVER_PARAMETER(adaptiveServiceExecutorMaxQueueLatencyMicros, int, 500);
+
+// A worker running a single task for this long is considered blocked.
+MONGO_EXPORT_SERVER_PARAMETER(adaptiveServiceExecutorStuckThreadTimeoutMillis, int, 250);
+
+// How often the controller thread re-evaluates the size of the pool.
+MONGO_EXPORT_SERVER_PARAMETER(adaptiveServiceExecutorControllerIntervalMillis, int, 50);
+
+int numCores() {
+    ProcessInfo p;
+    return std::max(static_cast<int>(p.getNumCores()), 1);
+}
+
+struct ServerParameterOptions final : public ServiceExecutorAdaptive::Options {
+    int reservedThreads() const final {
+        auto value = adaptiveServiceExecutorReservedThreads;
+        if (value == -1) {
+            value = std::max(numCores() / 2, 1);
+        }
+        return value;
+    }
+
+    int maxThreads() const final {
+        auto value = adaptiveServiceExecutorMaxThreads.load();
+        if (value == -1) {
+            value = numCores() * 10;
+        }
+        return value;
+    }
+
+    Milliseconds workerThreadRunTime() const final {
+        return Milliseconds{adaptiveServiceExecutorRunTimeMillis.load()};
+    }
+
+    int idlePctThreshold() const final {
+        return adaptiveServiceExecutorIdlePctThreshold.load();
+    }
+
+    Microseconds maxQueueLatency() const final {
+        return Microseconds{adaptiveServiceExecutorMaxQueueLatencyMicros.load()};
+    }
+
+    Milliseconds stuckThreadTimeout() const final {
+        return Milliseconds{adaptiveServiceExecutorStuckThreadTimeoutMillis.load()};
+    }
+
+    Milliseconds controllerInterval() const final {
+        return Milliseconds{adaptiveServiceExecutorControllerIntervalMillis.load()};
+    }
+};
+
+}  // namespace
+
+void ServiceExecutorAdaptive::TimeHistogram::increment(int64_t micros) {
+    int bucket = 0;
+    while (bucket < kBuckets - 1 && micros >= (1LL << bucket)) {
+        ++bucket;
+    }
+    _buckets[bucket].fetchAndAdd(1);
+    _count.fetchAndAdd(1);
+    _sumMicros.fetchAndAdd(micros);
+}
+
+void ServiceExecutorAdaptive::TimeHistogram::append(StringData name,
+                                                    BSONObjBuilder* bob) const {
+    BSONObjBuilder section(bob->subobjStart(name));
+    section.append("count", _count.load());
+    section.append("totalMicros", _sumMicros.load());
+
+    // Every bucket is always reported so that the shape of the document is stable for FTDC.
+    BSONArrayBuilder histogram(section.subarrayStart("histogram"));
+    for (int i = 0; i < kBuckets; ++i) {
+        BSONObjBuilder entry(histogram.subobjStart());
+        entry.append("micros", i == 0 ? 0LL : (1LL << (i - 1)));
+        entry.append("count", _buckets[i].load());
+    }
+}
+
+ServiceExecutorAdaptive::ServiceExecutorAdaptive(TickSource* tickSource)
+    : ServiceExecutorAdaptive(tickSource, stdx::make_unique<ServerParameterOptions>()) {}
+
+ServiceExecutorAdaptive::ServiceExecutorAdaptive(TickSource* tickSource,
+                                                 std::unique_ptr<Options> options)
+    : _tickSource(tickSource), _options(std::move(options)) {}
+
+ServiceExecutorAdaptive::~ServiceExecutorAdaptive() {
+    invariant(!_isRunning);
+}
+
+Status ServiceExecutorAdaptive::start() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_isRunning) {
+        return {ErrorCodes::InternalError, "ServiceExecutor is already running"};
+    }
+
+    _isRunning = true;
+    for (int i = 0; i < _options->reservedThreads(); ++i) {
+        _startWorkerThread_inlock(SpawnReason::kReserved);
+    }
+
+    _controllerThread = stdx::thread([this] { _controllerThreadRoutine(); });
+    return Status::OK();
+}
+
+Status ServiceExecutorAdaptive::shutdown() {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    if (!_isRunning) {
+        return Status::OK();
+    }
+
+    _isRunning = false;
+    _tasks.clear();
+    _workAvailable.notify_all();
+    _controllerWakeup.notify_all();
+
+    // Worker threads are detached; wait for each of them to remove itself from the list.
+    _threadExited.wait(lk, [this] { return _threads.empty(); });
+    lk.unlock();
+
+    _controllerThread.join();
+    return Status::OK();
+}
+
+Status ServiceExecutorAdaptive::schedule(Task task) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (!_isRunning) {
+        return {ErrorCodes::ShutdownInProgress, "Executor is not running"};
+    }
+
+    _tasks.push_back({std::move(task), _tickSource->getTicks()});
+    _totalQueued.fetchAndAdd(1);
+    _workAvailable.notify_one();
+    return Status::OK();
+}
+
+size_t ServiceExecutorAdaptive::threadsRunning() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _threads.size();
+}
+
+int64_t ServiceExecutorAdaptive::_ticksToMicros(TickSource::Tick ticks) const {
+    const auto ticksPerSecond = _tickSource->getTicksPerSecond();
+    if (ticksPerSecond == 1000 * 1000) {
+        return ticks;
+    }
+    return static_cast<int64_t>(static_cast<double>(ticks) * 1000 * 1000 / ticksPerSecond);
+}
+
+void ServiceExecutorAdaptive::_startWorkerThread_inlock(SpawnReason reason) {
+    auto it = _threads.emplace(_threads.end(), _nextThreadId++, _tickSource->getTicks());
+
+    _threadsSpawned.fetchAndAdd(1);
+    if (reason == SpawnReason::kQueueLatency) {
+        _threadsSpawnedForLatency.fetchAndAdd(1);
+    } else if (reason == SpawnReason::kStuckThreads) {
+        _threadsSpawnedForStuck.fetchAndAdd(1);
+    }
+
+    // Worker threads remove themselves from _threads on exit, so they are never joined.
+    stdx::thread([this, it] { _workerThreadRoutine(it); }).detach();
+}
+
+void ServiceExecutorAdaptive::_workerThreadRoutine(ThreadList::iterator state) {
+    setThreadName(str::stream() << "worker-" << state->id);
+    LOG(3) << "Started new service executor worker thread " << state->id;
+
+    if (NumaTopology::shouldBindServiceThreads()) {
+        Status status = NumaTopology::get().bindThreadToNode(state->id);
+        if (!status.isOK()) {
+            LOG(1) << status.reason();
+        }
+    }
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    while (_isRunning) {
+        if (_tasks.empty()) {
+            const auto windowEnd = state->windowStart + _options->workerThreadRunTime().count() *
+                    _tickSource->getTicksPerSecond() / 1000;
+            const auto now = _tickSource->getTicks();
+            if (now < windowEnd) {
+                _workAvailable.wait_for(
+                    lk, Microseconds(_ticksToMicros(windowEnd - now)).toSystemDuration());
+                if (_tasks.empty() && _tickSource->getTicks() < windowEnd) {
+                    continue;
+                }
+            }
+        } else {
+            auto task = std::move(_tasks.front());
+            _tasks.pop_front();
+            lk.unlock();
+
+            const auto taskStart = _tickSource->getTicks();
+            _queueLatency.increment(_ticksToMicros(taskStart - task.scheduledTicks));
+
+            state->taskStartTicks.store(taskStart);
+            _threadsExecuting.fetchAndAdd(1);
+
+            task.task();
+
+            _threadsExecuting.fetchAndSubtract(1);
+            state->taskStartTicks.store(0);
+
+            const auto taskTicks = _tickSource->getTicks() - taskStart;
+            _executionTime.increment(_ticksToMicros(taskTicks));
+            state->executingTicks.fetchAndAdd(taskTicks);
+            state->windowExecutingTicks += taskTicks;
+            state->tasksRun.fetchAndAdd(1);
+            _totalExecuted.fetchAndAdd(1);
+
+            lk.lock();
+        }
+
+        // At the end of each window, decide whether this thread is still pulling its weight.
+        const auto now = _tickSource->getTicks();
+        const auto windowTicks = now - state->windowStart;
+        if (_ticksToMicros(windowTicks) < durationCount<Microseconds>(
+                                              _options->workerThreadRunTime())) {
+            continue;
+        }
+
+        const auto utilizationPct = windowTicks > 0
+            ? static_cast<int>(state->windowExecutingTicks * 100 / windowTicks)
+            : 100;
+        state->windowStart = now;
+        state->windowExecutingTicks = 0;
+
+        if (utilizationPct < _options->idlePctThreshold() &&
+            _threads.size() > static_cast<size_t>(_options->reservedThreads())) {
+            LOG(3) << "Retiring service executor worker thread " << state->id << " at "
+                   << utilizationPct << "% utilization";
+            _threadsRetired.fetchAndAdd(1);
+            break;
+        }
+    }
+
+    _retiredRunningTicks.fetchAndAdd(_tickSource->getTicks() - state->startTicks);
+    _retiredExecutingTicks.fetchAndAdd(state->executingTicks.load());
+    _threads.erase(state);
+    _threadExited.notify_all();
+}
+
+void ServiceExecutorAdaptive::_controllerThreadRoutine() {
+    setThreadName("worker-controller");
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    while (_isRunning) {
+        _controllerWakeup.wait_for(lk, _options->controllerInterval().toSystemDuration());
+        if (!_isRunning || _tasks.empty()) {
+            continue;
+        }
+
+        const auto now = _tickSource->getTicks();
+        if (_threads.size() >= static_cast<size_t>(_options->maxThreads())) {
+            continue;
+        }
+
+        // Count the threads that have been in a single task for too long. These are most likely
+        // blocked on something other than CPU, so they should not count against the pool.
+        const auto stuckMicros = durationCount<Microseconds>(_options->stuckThreadTimeout());
+        size_t stuckThreads = 0;
+        for (auto&& thread : _threads) {
+            const auto taskStart = thread.taskStartTicks.load();
+            if (taskStart != 0 && _ticksToMicros(now - taskStart) > stuckMicros) {
+                stuckThreads++;
+            }
+        }
+
+        if (stuckThreads == _threads.size()) {
+            LOG(1) << "All " << stuckThreads
+                   << " service executor threads are blocked, starting a new thread";
+            _startWorkerThread_inlock(SpawnReason::kStuckThreads);
+            continue;
+        }
+
+        const auto queueLatency = _ticksToMicros(now - _tasks.front().scheduledTicks);
+        const auto threadsFree = static_cast<int64_t>(_threads.size()) - _threadsExecuting.load();
+        if (threadsFree <= 0 &&
+            queueLatency > durationCount<Microseconds>(_options->maxQueueLatency())) {
+            LOG(3) << "Service executor queue latency is " << queueLatency
+                   << " micros with no free threads, starting a new thread";
+            _startWorkerThread_inlock(SpawnReason::kQueueLatency);
+        }
+    }
+}
+
+void ServiceExecutorAdaptive::appendStats(BSONObjBuilder* bob) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    const auto now = _tickSource->getTicks();
+
+    BSONObjBuilder section(bob->subobjStart("serviceExecutorTaskStats"));
+    section.append("executor", "adaptive");
+    section.append("threadsRunning", static_cast<long long>(_threads.size()));
+    section.append("threadsInUse", _threadsExecuting.load());
+    section.append("tasksQueued", static_cast<long long>(_tasks.size()));
+    section.append("totalQueued", _totalQueued.load());
+    section.append("totalExecuted", _totalExecuted.load());
+    section.append("threadsSpawned", _threadsSpawned.load());
+    section.append("threadsSpawnedForQueueLatency", _threadsSpawnedForLatency.load());
+    section.append("threadsSpawnedForStuckThreads", _threadsSpawnedForStuck.load());
+    section.append("threadsRetired", _threadsRetired.load());
+
+    int64_t runningTicks = _retiredRunningTicks.load();
+    int64_t executingTicks = _retiredExecutingTicks.load();
+    for (auto&& thread : _threads) {
+        runningTicks += now - thread.startTicks;
+        executingTicks += thread.executingTicks.load();
+    }
+    section.append("totalTimeRunningMicros", _ticksToMicros(runningTicks));
+    section.append("totalTimeExecutingMicros", _ticksToMicros(executingTicks));
+
+    _queueLatency.append("queueLatencyMicros", &section);
+    _executionTime.append("executionTimeMicros", &section);
+
+    BSONObjBuilder threads(section.subobjStart("threads"));
+    for (auto&& thread : _threads) {
+        const auto lifetime = now - thread.startTicks;
+        const auto executing = thread.executingTicks.load();
+
+        BSONObjBuilder threadBob(threads.subobjStart(str::stream() << "worker-" << thread.id));
+        threadBob.append("utilizationPct",
+                         lifetime > 0 ? static_cast<double>(executing) * 100 / lifetime : 0.0);
+        threadBob.append("tasksRun", thread.tasksRun.load());
+        threadBob.append("executing", thread.taskStartTicks.load() != 0);
+    }
+}
+
+}  // namespace transport
+}  // namespace mongo
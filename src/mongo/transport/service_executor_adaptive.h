@@ -0,0 +1,198 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <deque>
+#include <list>
+#include <memory>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/transport/service_executor.h"
+#include "mongo/util/tick_source.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace transport {
+
+/**
+ * A ServiceExecutor which grows and shrinks its pool of worker threads to keep
+ * the queue of ready tasks short.
+ *
+ * Workers account for the time they spend executing tasks versus waiting for work. A controller
+ * thread periodically looks at the queue: if the oldest task has waited longer than
+ * maxQueueLatency() and no worker is free, or if every worker has been stuck in a single task
+ * (typically blocked in the storage engine, on a lock, or on the network) for longer than
+ * stuckThreadTimeout(), it starts another worker. Workers whose utilization over a
+ * workerThreadRunTime() window falls below idlePctThreshold() retire, down to
+ * reservedThreads().
+ */
+class ServiceExecutorAdaptive final : public ServiceExecutor {
+public:
+    /**
+     * Tuning knobs for the executor. These are re-read every time they are needed, so an
+     * implementation backed by server parameters can be changed at runtime.
+     */
+    struct Options {
+        virtual ~Options() = default;
+
+        // The minimum number of threads the executor will keep running.
+        virtual int reservedThreads() const = 0;
+
+        // The executor will never grow beyond this many threads.
+        virtual int maxThreads() const = 0;
+
+        // The length of the window over which each thread measures its utilization.
+        virtual Milliseconds workerThreadRunTime() const = 0;
+
+        // Threads whose utilization in a window is below this percentage are retired.
+        virtual int idlePctThreshold() const = 0;
+
+        // If a task has been queued for longer than this and no thread is free, start a thread.
+        virtual Microseconds maxQueueLatency() const = 0;
+
+        // A thread running one task for longer than this is considered blocked.
+        virtual Milliseconds stuckThreadTimeout() const = 0;
+
+        // How often the controller thread re-evaluates the pool.
+        virtual Milliseconds controllerInterval() const = 0;
+    };
+
+    /**
+     * Constructs an executor whose options are backed by the adaptiveServiceExecutor* server
+     * parameters.
+     */
+    explicit ServiceExecutorAdaptive(TickSource* tickSource);
+
+    ServiceExecutorAdaptive(TickSource* tickSource, std::unique_ptr<Options> options);
+
+    ~ServiceExecutorAdaptive();
+
+    Status start() override;
+    Status schedule(Task task) override;
+    Status shutdown() override;
+
+    /**
+     * Appends a "serviceExecutorTaskStats" sub-document with thread counts, spawn/retire counts,
+     * queue latency and execution time histograms, and per-thread utilization.
+     */
+    void appendStats(BSONObjBuilder* bob) const override;
+
+    /**
+     * Returns the number of worker threads currently in the pool.
+     */
+    size_t threadsRunning() const;
+
+private:
+    /**
+     * A fixed-bucket histogram of durations in microseconds, with power-of-two bucket bounds.
+     * Buckets are updated without holding any lock.
+     */
+    class TimeHistogram {
+    public:
+        static constexpr int kBuckets = 24;
+
+        void increment(int64_t micros);
+        void append(StringData name, BSONObjBuilder* bob) const;
+
+    private:
+        std::array<AtomicInt64, kBuckets> _buckets;
+        AtomicInt64 _count{0};
+        AtomicInt64 _sumMicros{0};
+    };
+
+    struct QueuedTask {
+        Task task;
+        TickSource::Tick scheduledTicks;
+    };
+
+    struct ThreadState {
+        ThreadState(size_t id, TickSource::Tick now) : id(id), startTicks(now), windowStart(now) {}
+
+        const size_t id;
+        const TickSource::Tick startTicks;
+
+        // Total ticks this thread has spent inside tasks.
+        AtomicInt64 executingTicks{0};
+
+        // The tick count at which the current task started, or 0 if the thread is not executing.
+        AtomicInt64 taskStartTicks{0};
+
+        AtomicInt64 tasksRun{0};
+
+        // Only touched by the thread itself.
+        TickSource::Tick windowStart;
+        TickSource::Tick windowExecutingTicks = 0;
+    };
+
+    using ThreadList = std::list<ThreadState>;
+
+    enum class SpawnReason { kReserved, kQueueLatency, kStuckThreads };
+
+    void _startWorkerThread_inlock(SpawnReason reason);
+    void _workerThreadRoutine(ThreadList::iterator state);
+    void _controllerThreadRoutine();
+
+    int64_t _ticksToMicros(TickSource::Tick ticks) const;
+
+    TickSource* const _tickSource;
+    const std::unique_ptr<Options> _options;
+
+    mutable stdx::mutex _mutex;
+    stdx::condition_variable _workAvailable;
+    stdx::condition_variable _controllerWakeup;
+    stdx::condition_variable _threadExited;
+
+    bool _isRunning = false;
+    std::deque<QueuedTask> _tasks;
+    ThreadList _threads;
+    size_t _nextThreadId = 0;
+    stdx::thread _controllerThread;
+
+    AtomicInt64 _threadsExecuting{0};
+    AtomicInt64 _totalQueued{0};
+    AtomicInt64 _totalExecuted{0};
+    AtomicInt64 _threadsSpawned{0};
+    AtomicInt64 _threadsSpawnedForLatency{0};
+    AtomicInt64 _threadsSpawnedForStuck{0};
+    AtomicInt64 _threadsRetired{0};
+
+    // Accumulated over threads that have exited.
+    AtomicInt64 _retiredRunningTicks{0};
+    AtomicInt64 _retiredExecutingTicks{0};
+
+    TimeHistogram _queueLatency;
+    TimeHistogram _executionTime;
+};
+
+}  // namespace transport
+}  // namespace mongo
@@ -0,0 +1,158 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/transport/service_executor_adaptive.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/system_tick_source.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace transport {
+namespace {
+
+struct TestOptions : public ServiceExecutorAdaptive::Options {
+    int reservedThreads() const final {
+        return 1;
+    }
+
+    int maxThreads() const final {
+        return 4;
+    }
+
+    Milliseconds workerThreadRunTime() const final {
+        return Milliseconds{1000};
+    }
+
+    int idlePctThreshold() const final {
+        return 60;
+    }
+
+    Microseconds maxQueueLatency() const final {
+        return Microseconds{500};
+    }
+
+    Milliseconds stuckThreadTimeout() const final {
+        return Milliseconds{20};
+    }
+
+    Milliseconds controllerInterval() const final {
+        return Milliseconds{5};
+    }
+};
+
+class ServiceExecutorAdaptiveTest : public unittest::Test {
+public:
+    void setUp() final {
+        _executor = stdx::make_unique<ServiceExecutorAdaptive>(SystemTickSource::get(),
+                                                               stdx::make_unique<TestOptions>());
+        ASSERT_OK(_executor->start());
+    }
+
+    void tearDown() final {
+        ASSERT_OK(_executor->shutdown());
+    }
+
+    ServiceExecutorAdaptive* executor() {
+        return _executor.get();
+    }
+
+private:
+    std::unique_ptr<ServiceExecutorAdaptive> _executor;
+};
+
+TEST_F(ServiceExecutorAdaptiveTest, RunsScheduledTasks) {
+    stdx::mutex mutex;
+    stdx::condition_variable cond;
+    int tasksRun = 0;
+
+    const int kTasks = 100;
+    for (int i = 0; i < kTasks; ++i) {
+        ASSERT_OK(executor()->schedule([&] {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            tasksRun++;
+            cond.notify_one();
+        }));
+    }
+
+    stdx::unique_lock<stdx::mutex> lk(mutex);
+    cond.wait(lk, [&] { return tasksRun == kTasks; });
+}
+
+TEST_F(ServiceExecutorAdaptiveTest, StartsThreadsWhenWorkersAreBlocked) {
+    stdx::mutex mutex;
+    stdx::condition_variable cond;
+    bool release = false;
+    int tasksRun = 0;
+
+    ASSERT_EQ(executor()->threadsRunning(), 1U);
+
+    // Block the only reserved thread. The controller should notice that it is stuck and start
+    // another thread to run the second task.
+    ASSERT_OK(executor()->schedule([&] {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        cond.wait(lk, [&] { return release; });
+        tasksRun++;
+        cond.notify_all();
+    }));
+    ASSERT_OK(executor()->schedule([&] {
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        release = true;
+        tasksRun++;
+        cond.notify_all();
+    }));
+
+    {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        cond.wait(lk, [&] { return tasksRun == 2; });
+    }
+
+    ASSERT_GT(executor()->threadsRunning(), 1U);
+
+    BSONObjBuilder bob;
+    executor()->appendStats(&bob);
+    auto stats = bob.obj()["serviceExecutorTaskStats"].Obj();
+    ASSERT_EQ(stats["executor"].str(), "adaptive");
+    ASSERT_GTE(stats["threadsSpawnedForStuckThreads"].numberLong(), 1);
+}
+
+TEST_F(ServiceExecutorAdaptiveTest, ScheduleFailsAfterShutdown) {
+    ASSERT_OK(executor()->shutdown());
+    ASSERT_EQ(executor()->schedule([] {}), ErrorCodes::ShutdownInProgress);
+}
+
+}  // namespace
+}  // namespace transport
+}  // namespace mongo
@@ -0,0 +1,292 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kNetwork
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/service_state_machine.h"
+
+#include "mongo/db/client.h"
+#include "mongo/db/dbmessage.h"
+#include "mongo/db/server_options.h"
+#include "mongo/transport/service_entry_point.h"
+#include "mongo/transport/service_entry_point_utils.h"
+#include "mongo/transport/service_executor.h"
+#include "mongo/transport/session.h"
+#include "mongo/transport/ticket.h"
+#include "mongo/transport/traffic_recorder.h"
+#include "mongo/transport/transport_layer.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/exit.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/net/socket_exception.h"
+#include "mongo/util/net/thread_idle_callback.h"
+#include "mongo/util/quick_exit.h"
+
+namespace mongo {
+
+using transport::TransportLayer;
+
+/*
+ * This class wraps up the logic for swapping/unswapping the Client and the thread name during
+ * each step of the state machine.
+ */
+class ServiceStateMachine::ThreadGuard {
+    MONGO_DISALLOW_COPYING(ThreadGuard);
+
+public:
+    explicit ThreadGuard(ServiceStateMachine* ssm)
+        : _ssm(ssm), _oldThreadName(getThreadName().toString()) {
+        setThreadName(_ssm->_threadName);
+        Client::setCurrent(std::move(_ssm->_dbClient));
+    }
+
+    ~ThreadGuard() {
+        if (haveClient()) {
+            _ssm->_dbClient = Client::releaseCurrent();
+        }
+        setThreadName(_oldThreadName);
+    }
+
+private:
+    ServiceStateMachine* _ssm;
+    const std::string _oldThreadName;
+};
+
+std::shared_ptr<ServiceStateMachine> ServiceStateMachine::create(ServiceContext* svcContext,
+                                                                 transport::SessionHandle session,
+                                                                 ServiceEntryPoint* sep) {
+    std::shared_ptr<ServiceStateMachine> handle(
+        new ServiceStateMachine(svcContext, std::move(session), sep));
+    return handle;
+}
+
+ServiceStateMachine::ServiceStateMachine(ServiceContext* svcContext,
+                                         transport::SessionHandle session,
+                                         ServiceEntryPoint* sep)
+    : _serviceContext(svcContext),
+      _sep(sep),
+      _session(std::move(session)),
+      _dbClient(svcContext->makeClient("conn", _session)),
+      _threadName(str::stream() << "conn" << _session->id()) {}
+
+ServiceStateMachine::~ServiceStateMachine() {
+    if (_cleanupHook) {
+        _cleanupHook();
+    }
+}
+
+void ServiceStateMachine::start() {
+    invariant(_state.load() == State::Created);
+    _sourceMessage();
+}
+
+ServiceStateMachine::State ServiceStateMachine::state() const {
+    return _state.load();
+}
+
+void ServiceStateMachine::setCleanupHook(stdx::function<void()> hook) {
+    invariant(_state.load() == State::Created);
+    _cleanupHook = std::move(hook);
+}
+
+void ServiceStateMachine::_sourceMessage() {
+    _state.store(State::Source);
+    _inMessage.reset();
+
+    auto ticket = _session->sourceMessage(&_inMessage);
+    _state.store(State::SourceWait);
+    std::move(ticket).asyncWait(
+        [ssm = shared_from_this()](Status status) { ssm->_sourceCallback(std::move(status)); });
+}
+
+void ServiceStateMachine::_sourceCallback(Status status) {
+    invariant(_state.load() == State::SourceWait);
+
+    if (status.isOK()) {
+        TrafficRecorder::get().record(
+            _session->id(), TrafficRecorder::EventType::kRequest, _inMessage);
+        _state.store(State::Process);
+        _scheduleProcess();
+        return;
+    }
+
+    ThreadGuard guard(this);
+    if (!ErrorCodes::isInterruption(status.code()) && !ErrorCodes::isNetworkError(status.code()) &&
+        status != TransportLayer::TicketSessionClosedStatus) {
+        log() << "Error receiving request from client: " << status << ". Ending connection from "
+              << _session->remote() << " (connection id: " << _session->id() << ")";
+    }
+    _endSession();
+}
+
+void ServiceStateMachine::_sinkCallback(Status status) {
+    invariant(_state.load() == State::SinkWait);
+
+    if (!status.isOK()) {
+        ThreadGuard guard(this);
+        log() << "Error sending response to client: " << status << ". Ending connection from "
+              << _session->remote() << " (connection id: " << _session->id() << ")";
+        _endSession();
+        return;
+    }
+
+    _outMessage.reset();
+    if (_inExhaust) {
+        _state.store(State::Process);
+        _scheduleProcess();
+    } else {
+        _sourceMessage();
+    }
+}
+
+void ServiceStateMachine::_scheduleProcess() {
+    auto executor = _serviceContext->getServiceExecutor();
+    if (!executor) {
+        ThreadGuard guard(this);
+        _processMessage();
+        return;
+    }
+
+    // Hand the database work off to the executor so that the thread which completed the network
+    // I/O is free to service other sessions.
+    auto status = executor->schedule([ssm = shared_from_this()] {
+        ThreadGuard guard(ssm.get());
+        ssm->_processMessage();
+    });
+    if (!status.isOK()) {
+        ThreadGuard guard(this);
+        log() << "Failed to schedule request for processing: " << status
+              << ". Ending connection from " << _session->remote()
+              << " (connection id: " << _session->id() << ")";
+        _endSession();
+    }
+}
+
+void ServiceStateMachine::_processMessage() {
+    try {
+        auto opCtx = cc().makeOperationContext();
+
+        // The handleRequest is implemented in a subclass for mongod/mongos and actually all the
+        // database work for this request.
+        DbResponse dbresponse = _sep->handleRequest(opCtx.get(), _inMessage, _session->remote());
+
+        // opCtx must be destroyed here so that the operation cannot show
+        // up in currentOp results after the response reaches the client
+        opCtx.reset();
+
+        if ((_counter++ & 0xf) == 0) {
+            markThreadIdle();
+        }
+
+        // Format our response, if we have one
+        Message& toSink = dbresponse.response;
+        if (toSink.empty()) {
+            _inExhaust = false;
+            _sourceMessage();
+            return;
+        }
+
+        toSink.header().setId(nextMessageId());
+        toSink.header().setResponseToMsgId(_inMessage.header().getId());
+
+        // If this is an exhaust cursor, don't source more Messages
+        _inExhaust = setExhaustMessage(&_inMessage, dbresponse);
+
+        TrafficRecorder::get().record(
+            _session->id(), TrafficRecorder::EventType::kResponse, toSink);
+
+        _outMessage = std::move(toSink);
+        auto ticket = _session->sinkMessage(_outMessage);
+        _state.store(State::SinkWait);
+        std::move(ticket).asyncWait(
+            [ssm = shared_from_this()](Status status) { ssm->_sinkCallback(std::move(status)); });
+    } catch (const AssertionException& e) {
+        log() << "AssertionException handling request, closing client connection: " << e;
+        _endSession();
+    } catch (const SocketException& e) {
+        log() << "SocketException handling request, closing client connection: " << e;
+        _endSession();
+    } catch (const DBException& e) {
+        // must be right above std::exception to avoid catching subclasses
+        log() << "DBException handling request, closing client connection: " << e;
+        _endSession();
+    } catch (const std::exception& e) {
+        error() << "Uncaught std::exception: " << e.what() << ", terminating";
+        quickExit(EXIT_UNCAUGHT);
+    }
+}
+
+void ServiceStateMachine::_endSession() {
+    _state.store(State::EndSession);
+    TrafficRecorder::get().recordSessionEnd(_session->id());
+
+    auto tl = _session->getTransportLayer();
+    tl->end(_session);
+
+    if (!serverGlobalParams.quiet.load()) {
+        auto conns = tl->sessionStats().numOpenSessions;
+        const char* word = (conns == 1 ? " connection" : " connections");
+        log() << "end connection " << _session->remote() << " (" << conns << word
+              << " now open)";
+    }
+
+    _state.store(State::Ended);
+}
+
+std::ostream& operator<<(std::ostream& stream, const ServiceStateMachine::State& state) {
+    switch (state) {
+        case ServiceStateMachine::State::Created:
+            stream << "created";
+            break;
+        case ServiceStateMachine::State::Source:
+            stream << "source";
+            break;
+        case ServiceStateMachine::State::SourceWait:
+            stream << "sourceWait";
+            break;
+        case ServiceStateMachine::State::Process:
+            stream << "process";
+            break;
+        case ServiceStateMachine::State::SinkWait:
+            stream << "sinkWait";
+            break;
+        case ServiceStateMachine::State::EndSession:
+            stream << "endSession";
+            break;
+        case ServiceStateMachine::State::Ended:
+            stream << "ended";
+            break;
+    }
+    return stream;
+}
+
+}  // namespace mongo
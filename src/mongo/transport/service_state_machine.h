@@ -0,0 +1,158 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/db/service_context.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/transport/session.h"
+#include "mongo/util/net/message.h"
+
+namespace mongo {
+
+class ServiceEntryPoint;
+
+/**
+ * The ServiceStateMachine holds the state of a single client connection and represents the
+ * lifecycle of each user request as a state machine. It is the bridge between the database and
+ * the transport layer for TransportLayers that support asyncWait().
+ *
+ * Instead of dedicating a thread to the connection, every step of the source-process-sink cycle
+ * runs as a callback on whichever thread completes the previous step's I/O. The Client for the
+ * connection is attached to that thread for the duration of the step and detached again
+ * afterwards, so a small pool of threads can drive any number of sessions.
+ */
+class ServiceStateMachine : public std::enable_shared_from_this<ServiceStateMachine> {
+    MONGO_DISALLOW_COPYING(ServiceStateMachine);
+
+public:
+    /*
+     * Any state may transition to EndSession in case of an error, otherwise the valid state
+     * transitions are:
+     * Source -> SourceWait -> Process -> SinkWait -> Source (standard RPC)
+     * Source -> SourceWait -> Process -> SinkWait -> Process -> SinkWait ... (exhaust)
+     * Source -> SourceWait -> Process -> Source (fire-and-forget)
+     */
+    enum class State {
+        Created,     // The session has been created, but no operations have been performed yet
+        Source,      // Request a new Message from the network to handle
+        SourceWait,  // Wait for the new Message to arrive from the network
+        Process,     // Run the Message through the database
+        SinkWait,    // Wait for the database result to be sent by the network
+        EndSession,  // End the session - the ServiceStateMachine will be invalid after this
+        Ended        // The session has ended. It is illegal to call any method besides
+                     // state() if this is the current state.
+    };
+
+    /*
+     * Creates a new ServiceStateMachine for a given session/service context.
+     */
+    static std::shared_ptr<ServiceStateMachine> create(ServiceContext* svcContext,
+                                                       transport::SessionHandle session,
+                                                       ServiceEntryPoint* sep);
+
+    ~ServiceStateMachine();
+
+    /*
+     * Begins running the state machine. The first Message is sourced asynchronously; this method
+     * returns immediately.
+     */
+    void start();
+
+    /*
+     * Gets the current state of connection for testing/diagnostic purposes.
+     */
+    State state() const;
+
+    /*
+     * Sets a function to be called after the session is ended and the ServiceStateMachine is
+     * destroyed.
+     */
+    void setCleanupHook(stdx::function<void()> hook);
+
+private:
+    class ThreadGuard;
+    friend class ThreadGuard;
+
+    ServiceStateMachine(ServiceContext* svcContext,
+                        transport::SessionHandle session,
+                        ServiceEntryPoint* sep);
+
+    /*
+     * Requests the next Message from the network.
+     */
+    void _sourceMessage();
+
+    /*
+     * Callbacks for the source and sink tickets. These run on the transport layer's threads.
+     */
+    void _sourceCallback(Status status);
+    void _sinkCallback(Status status);
+
+    /*
+     * Runs _processMessage() on the ServiceContext's ServiceExecutor if there is one, or inline
+     * on the current thread otherwise.
+     */
+    void _scheduleProcess();
+
+    /*
+     * Runs the current Message through the database and starts sinking the response, if any.
+     */
+    void _processMessage();
+
+    /*
+     * Closes the session and moves to the Ended state.
+     */
+    void _endSession();
+
+    AtomicWord<State> _state{State::Created};
+
+    ServiceContext* const _serviceContext;
+    ServiceEntryPoint* _sep;
+
+    transport::SessionHandle _session;
+    ServiceContext::UniqueClient _dbClient;
+    const std::string _threadName;
+
+    Message _inMessage;
+    Message _outMessage;
+    bool _inExhaust = false;
+    int64_t _counter = 0;
+
+    stdx::function<void()> _cleanupHook;
+};
+
+std::ostream& operator<<(std::ostream& stream, const ServiceStateMachine::State& state);
+
+}  // namespace mongo
@@ -0,0 +1,389 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kNetwork
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/traffic_recorder.h"
+
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+#include "mongo/base/data_range_cursor.h"
+#include "mongo/base/data_type_endian.h"
+#include "mongo/bson/util/builder.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/exit.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/net/message.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+namespace {
+
+MONGO_EXPORT_SERVER_PARAMETER(trafficRecordingMaxFileSizeMB, int, 256);
+MONGO_EXPORT_SERVER_PARAMETER(trafficRecordingMaxFiles, int, 8);
+MONGO_EXPORT_SERVER_PARAMETER(trafficRecordingBufferSizeMB, int, 32);
+
+// length, eventType, sessionId, timestampMicros.
+const size_t kRecordHeaderSize = 4 + 1 + 8 + 8;
+const size_t kMagicSize = 8;
+
+TrafficRecorder::Options makeOptionsFromParameters(const std::string& directory) {
+    TrafficRecorder::Options options;
+    options.directory = directory;
+    options.maxFileSizeBytes = std::max(1, trafficRecordingMaxFileSizeMB.load()) * 1024LL * 1024;
+    options.maxFiles = std::max(1, trafficRecordingMaxFiles.load());
+    options.maxBufferedBytes = std::max(1, trafficRecordingBufferSizeMB.load()) * 1024LL * 1024;
+    return options;
+}
+
+/**
+ * "trafficRecordingDirectory": a value given at startup takes effect once the server starts
+ * accepting connections, and setting it at runtime starts, redirects or (when empty) stops
+ * recording immediately.
+ */
+class TrafficRecordingDirectoryParameter : public ServerParameter {
+public:
+    TrafficRecordingDirectoryParameter()
+        : ServerParameter(ServerParameterSet::getGlobal(), "trafficRecordingDirectory") {}
+
+    void append(OperationContext* opCtx, BSONObjBuilder& b, const std::string& name) final {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        b.append(name, _directory);
+    }
+
+    Status set(const BSONElement& newValueElement) final {
+        if (newValueElement.type() != String) {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << name() << " must be a string");
+        }
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        const std::string directory = newValueElement.String();
+        if (directory.empty()) {
+            TrafficRecorder::get().stop();
+        } else {
+            Status status = TrafficRecorder::get().start(makeOptionsFromParameters(directory));
+            if (!status.isOK()) {
+                return status;
+            }
+        }
+        _directory = directory;
+        return Status::OK();
+    }
+
+    Status setFromString(const std::string& str) final {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _directory = str;
+        return Status::OK();
+    }
+
+    std::string getDirectory() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        return _directory;
+    }
+
+private:
+    stdx::mutex _mutex;
+    std::string _directory;
+} trafficRecordingDirectoryParameter;
+
+}  // namespace
+
+const char TrafficRecorder::kFilePrefix[] = "traffic.";
+const char TrafficRecorder::kFileMagic[] = "MDBTRAF1";
+
+TrafficRecorder& TrafficRecorder::get() {
+    // Leaked, so that sessions still running during shutdown never see a destroyed recorder.
+    static TrafficRecorder* recorder = new TrafficRecorder();
+    return *recorder;
+}
+
+TrafficRecorder::~TrafficRecorder() {
+    stop();
+}
+
+Status TrafficRecorder::start(const Options& options) {
+    stop();
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _options = options;
+    _files.clear();
+    _nextFileNumber = 0;
+
+    try {
+        boost::filesystem::create_directories(_options.directory);
+
+        // Continue the numbering of an earlier recording into the same directory, and count its
+        // files against the rotation limit.
+        for (boost::filesystem::directory_iterator it(_options.directory), end; it != end; ++it) {
+            const std::string name = it->path().filename().string();
+            long long number;
+            if (name.compare(0, strlen(kFilePrefix), kFilePrefix) != 0 ||
+                !(std::istringstream(name.substr(strlen(kFilePrefix))) >> number)) {
+                continue;
+            }
+            _files.push_back(it->path().string());
+            _nextFileNumber = std::max(_nextFileNumber, number + 1);
+        }
+        std::sort(_files.begin(), _files.end());
+    } catch (const boost::filesystem::filesystem_error& ex) {
+        return Status(ErrorCodes::FileOpenFailed,
+                      str::stream() << "Could not use traffic recording directory "
+                                    << _options.directory
+                                    << ": "
+                                    << ex.what());
+    }
+
+    Status status = _openNextFile();
+    if (!status.isOK()) {
+        return status;
+    }
+
+    _queue.clear();
+    _queuedBytes = 0;
+    _stopping = false;
+    _eventsRecorded.store(0);
+    _eventsDropped.store(0);
+    _writer = stdx::thread([this] { _writerThread(); });
+    _recording.store(true);
+
+    static std::once_flag registerShutdownTaskOnce;
+    std::call_once(registerShutdownTaskOnce, [] {
+        // Only the global recorder is started by the server.
+        registerShutdownTask([] { TrafficRecorder::get().stop(); });
+    });
+
+    log() << "Recording traffic to " << _options.directory;
+    return Status::OK();
+}
+
+void TrafficRecorder::stop() {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (!_writer.joinable()) {
+            return;
+        }
+        _recording.store(false);
+        _stopping = true;
+        _queueCondition.notify_one();
+    }
+    _writer.join();
+
+    log() << "Stopped recording traffic to " << _options.directory << "; recorded "
+          << _eventsRecorded.load() << " events and dropped " << _eventsDropped.load();
+}
+
+void TrafficRecorder::record(transport::SessionId session,
+                             EventType type,
+                             const Message& message) {
+    if (!isRecording() || message.empty()) {
+        return;
+    }
+    const size_t len = type == EventType::kRequest ? message.size() : sizeof(MSGHEADER::Value);
+    _enqueue(session, type, message.buf(), len);
+}
+
+void TrafficRecorder::recordSessionEnd(transport::SessionId session) {
+    if (!isRecording()) {
+        return;
+    }
+    _enqueue(session, EventType::kSessionEnd, nullptr, 0);
+}
+
+void TrafficRecorder::_enqueue(transport::SessionId session,
+                               EventType type,
+                               const char* data,
+                               size_t len) {
+    const size_t recordSize = kRecordHeaderSize + len;
+
+    // Encode outside of the mutex, so that concurrent sessions only serialize on the queue push.
+    BufBuilder builder(recordSize);
+    builder.appendNum(static_cast<unsigned>(recordSize));
+    builder.appendChar(static_cast<char>(type));
+    builder.appendNum(static_cast<unsigned long long>(session));
+    builder.appendNum(static_cast<long long>(curTimeMicros64()));
+    builder.appendBuf(data, len);
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_stopping || !_writer.joinable()) {
+        return;
+    }
+    if (_queuedBytes + static_cast<long long>(recordSize) > _options.maxBufferedBytes) {
+        _eventsDropped.fetchAndAdd(1);
+        return;
+    }
+    _queue.emplace_back(builder.release(), recordSize);
+    _queuedBytes += recordSize;
+    _eventsRecorded.fetchAndAdd(1);
+    _queueCondition.notify_one();
+}
+
+void TrafficRecorder::_writerThread() {
+    setThreadName("trafficRecorder");
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    while (true) {
+        _queueCondition.wait(lk, [&] { return _stopping || !_queue.empty(); });
+        if (_queue.empty()) {
+            break;
+        }
+
+        auto batch = std::move(_queue);
+        _queue.clear();
+        _queuedBytes = 0;
+        lk.unlock();
+
+        bool failed = false;
+        for (const auto& record : batch) {
+            // Every file gets at least one record, however small the size limit.
+            if (_fileSize >= _options.maxFileSizeBytes && _fileSize > kMagicSize) {
+                Status status = _openNextFile();
+                if (!status.isOK()) {
+                    error() << "Stopping traffic recording: " << status;
+                    failed = true;
+                    break;
+                }
+            }
+            _file.write(record.first.get(), record.second);
+            _fileSize += record.second;
+        }
+        _file.flush();
+        if (!failed && !_file) {
+            error() << "Stopping traffic recording: failed to write to " << _files.back();
+            failed = true;
+        }
+
+        lk.lock();
+        if (failed) {
+            _recording.store(false);
+            _stopping = true;
+            _queue.clear();
+            _queuedBytes = 0;
+        }
+    }
+
+    _file.close();
+}
+
+Status TrafficRecorder::_openNextFile() {
+    if (_file.is_open()) {
+        _file.close();
+    }
+
+    std::ostringstream name;
+    name << kFilePrefix << std::setw(10) << std::setfill('0') << _nextFileNumber++;
+    const std::string path = (boost::filesystem::path(_options.directory) / name.str()).string();
+
+    _file.clear();
+    _file.open(path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!_file) {
+        return Status(ErrorCodes::FileOpenFailed,
+                      str::stream() << "Could not open traffic recording file " << path);
+    }
+    _file.write(kFileMagic, kMagicSize);
+    _fileSize = kMagicSize;
+
+    _files.push_back(path);
+    _removeOldFiles();
+    return Status::OK();
+}
+
+void TrafficRecorder::_removeOldFiles() {
+    while (_files.size() > static_cast<size_t>(_options.maxFiles)) {
+        boost::system::error_code ec;
+        boost::filesystem::remove(_files.front(), ec);
+        if (ec) {
+            warning() << "Could not remove old traffic recording file " << _files.front() << ": "
+                      << ec.message();
+        }
+        _files.erase(_files.begin());
+    }
+}
+
+void startTrafficRecordingIfConfigured() {
+    const std::string directory = trafficRecordingDirectoryParameter.getDirectory();
+    if (directory.empty()) {
+        return;
+    }
+    Status status = TrafficRecorder::get().start(makeOptionsFromParameters(directory));
+    if (!status.isOK()) {
+        error() << "Could not start traffic recording: " << status;
+    }
+}
+
+StatusWith<std::vector<TrafficRecord>> readTrafficRecordingFile(const std::string& path) {
+    std::ifstream file(path.c_str(), std::ios::in | std::ios::binary);
+    if (!file) {
+        return Status(ErrorCodes::FileOpenFailed,
+                      str::stream() << "Could not open traffic recording file " << path);
+    }
+    const std::string contents((std::istreambuf_iterator<char>(file)),
+                               std::istreambuf_iterator<char>());
+
+    if (contents.compare(0, kMagicSize, TrafficRecorder::kFileMagic) != 0) {
+        return Status(ErrorCodes::FailedToParse,
+                      str::stream() << path << " is not a traffic recording file");
+    }
+
+    std::vector<TrafficRecord> records;
+    ConstDataRangeCursor cursor(contents.data() + kMagicSize, contents.data() + contents.size());
+    while (cursor.length() > 0) {
+        if (cursor.length() < kRecordHeaderSize) {
+            return Status(ErrorCodes::FailedToParse,
+                          str::stream() << "Truncated record header in " << path);
+        }
+        const char* recordStart = cursor.data();
+        const auto length = cursor.readAndAdvance<LittleEndian<std::uint32_t>>().getValue().value;
+        if (length < kRecordHeaderSize || length - 4 > cursor.length()) {
+            return Status(ErrorCodes::FailedToParse,
+                          str::stream() << "Truncated or corrupt record in " << path);
+        }
+
+        TrafficRecord record;
+        record.type = static_cast<TrafficRecorder::EventType>(
+            cursor.readAndAdvance<std::uint8_t>().getValue());
+        record.session = cursor.readAndAdvance<LittleEndian<std::uint64_t>>().getValue().value;
+        record.timestampMicros =
+            cursor.readAndAdvance<LittleEndian<std::int64_t>>().getValue().value;
+        record.message.assign(cursor.data(), recordStart + length);
+        cursor.advance(length - kRecordHeaderSize);
+        records.push_back(std::move(record));
+    }
+    return {std::move(records)};
+}
+
+}  // namespace mongo
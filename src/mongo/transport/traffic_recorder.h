@@ -0,0 +1,181 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/base/status_with.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/transport/session_id.h"
+#include "mongo/util/shared_buffer.h"
+
+namespace mongo {
+
+class Message;
+
+/**
+ * Records the wire protocol traffic a server receives into rotating capture files, so that a
+ * production workload can later be replayed against a test deployment with
+ * buildscripts/traffic_replay.py.
+ *
+ * The request path only copies the message into a bounded in-memory queue; a background thread
+ * writes the queue out. When the queue is full, events are dropped and counted rather than
+ * slowing down the server.
+ *
+ * Each capture file starts with the 8 byte magic "MDBTRAF1" and is followed by records of the
+ * form (all integers little-endian):
+ *
+ *     uint32 length           total length of the record, including this field
+ *     uint8  eventType        EventType below
+ *     uint64 sessionId        transport::SessionId of the connection
+ *     int64  timestampMicros  wall clock time the server observed the event, since the epoch
+ *     bytes  message          kRequest: the whole message; kResponse: its 16 byte header;
+ *                             kSessionEnd: nothing
+ *
+ * Recording is controlled by the "trafficRecordingDirectory" server parameter, which can be set
+ * at startup or at runtime; setting it to the empty string stops recording.
+ */
+class TrafficRecorder {
+    MONGO_DISALLOW_COPYING(TrafficRecorder);
+
+public:
+    enum class EventType : std::uint8_t { kRequest = 0, kResponse = 1, kSessionEnd = 2 };
+
+    struct Options {
+        std::string directory;
+        long long maxFileSizeBytes = 256 * 1024 * 1024;
+        int maxFiles = 8;
+        long long maxBufferedBytes = 32 * 1024 * 1024;
+    };
+
+    /**
+     * Returns the recorder used by the server's service entry points.
+     */
+    static TrafficRecorder& get();
+
+    TrafficRecorder() = default;
+    ~TrafficRecorder();
+
+    /**
+     * Starts writing capture files into options.directory, creating it if needed. Stops any
+     * recording in progress first.
+     */
+    Status start(const Options& options);
+
+    /**
+     * Flushes everything queued so far and stops recording. A no-op if not recording.
+     */
+    void stop();
+
+    /**
+     * Cheap check, suitable for the request path, of whether record() would do anything.
+     */
+    bool isRecording() const {
+        return _recording.loadRelaxed();
+    }
+
+    /**
+     * Queues one event. Requests are recorded in full, responses as just their header.
+     */
+    void record(transport::SessionId session, EventType type, const Message& message);
+    void recordSessionEnd(transport::SessionId session);
+
+    /**
+     * Counters for the current or most recent recording.
+     */
+    long long getEventsRecordedCount() const {
+        return _eventsRecorded.load();
+    }
+    long long getEventsDroppedCount() const {
+        return _eventsDropped.load();
+    }
+
+    /**
+     * Capture files are named with this prefix followed by a sequence number.
+     */
+    static const char kFilePrefix[];
+    static const char kFileMagic[];
+
+private:
+    void _enqueue(transport::SessionId session, EventType type, const char* data, size_t len);
+    void _writerThread();
+    Status _openNextFile();
+    void _removeOldFiles();
+
+    AtomicBool _recording{false};
+    AtomicInt64 _eventsRecorded{0};
+    AtomicInt64 _eventsDropped{0};
+
+    // Guards everything below.
+    stdx::mutex _mutex;
+    stdx::condition_variable _queueCondition;
+    Options _options;
+    std::deque<std::pair<SharedBuffer, size_t>> _queue;
+    long long _queuedBytes = 0;
+    bool _stopping = false;
+    stdx::thread _writer;
+
+    // Only used by the writer thread.
+    std::ofstream _file;
+    long long _fileSize = 0;
+    long long _nextFileNumber = 0;
+    std::vector<std::string> _files;
+};
+
+/**
+ * Starts the global TrafficRecorder if "trafficRecordingDirectory" was given at startup. Called
+ * by the service entry point once the server is ready to accept connections, after any fork.
+ */
+void startTrafficRecordingIfConfigured();
+
+/**
+ * One event read back from a capture file.
+ */
+struct TrafficRecord {
+    TrafficRecorder::EventType type;
+    transport::SessionId session;
+    long long timestampMicros;
+    std::string message;
+};
+
+/**
+ * Reads every record in the capture file at "path".
+ */
+StatusWith<std::vector<TrafficRecord>> readTrafficRecordingFile(const std::string& path);
+
+}  // namespace mongo
@@ -0,0 +1,160 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/traffic_recorder.h"
+
+#include <boost/filesystem.hpp>
+#include <cstring>
+
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/net/message.h"
+
+namespace mongo {
+namespace {
+
+Message buildMessage(int id, const std::string& data) {
+    const auto bufferSize = MsgData::MsgDataHeaderSize + data.size();
+    auto buf = SharedBuffer::allocate(bufferSize);
+    MsgData::View view(buf.get());
+    view.setId(id);
+    view.setResponseToMsgId(0);
+    view.setOperation(dbQuery);
+    view.setLen(bufferSize);
+    memcpy(view.data(), data.data(), data.size());
+    return Message{buf};
+}
+
+std::vector<std::string> listFiles(const std::string& directory) {
+    std::vector<std::string> files;
+    for (boost::filesystem::directory_iterator it(directory), end; it != end; ++it) {
+        files.push_back(it->path().string());
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+TEST(TrafficRecorderTest, RecordsRequestsResponsesAndSessionEnds) {
+    unittest::TempDir tempDir("traffic_recorder_test");
+    TrafficRecorder recorder;
+    TrafficRecorder::Options options;
+    options.directory = tempDir.path();
+    ASSERT_OK(recorder.start(options));
+    ASSERT_TRUE(recorder.isRecording());
+
+    const Message request = buildMessage(1, "request body");
+    const Message response = buildMessage(2, "a response body that is not recorded");
+    recorder.record(7, TrafficRecorder::EventType::kRequest, request);
+    recorder.record(7, TrafficRecorder::EventType::kResponse, response);
+    recorder.recordSessionEnd(7);
+    recorder.stop();
+    ASSERT_FALSE(recorder.isRecording());
+    ASSERT_EQUALS(3, recorder.getEventsRecordedCount());
+    ASSERT_EQUALS(0, recorder.getEventsDroppedCount());
+
+    // Events after stop() are ignored.
+    recorder.record(7, TrafficRecorder::EventType::kRequest, request);
+
+    const auto files = listFiles(tempDir.path());
+    ASSERT_EQUALS(1U, files.size());
+    auto records = unittest::assertGet(readTrafficRecordingFile(files[0]));
+    ASSERT_EQUALS(3U, records.size());
+
+    ASSERT(records[0].type == TrafficRecorder::EventType::kRequest);
+    ASSERT_EQUALS(7U, records[0].session);
+    ASSERT_EQUALS(std::string(request.buf(), request.size()), records[0].message);
+
+    ASSERT(records[1].type == TrafficRecorder::EventType::kResponse);
+    ASSERT_EQUALS(std::string(response.buf(), MsgData::MsgDataHeaderSize), records[1].message);
+
+    ASSERT(records[2].type == TrafficRecorder::EventType::kSessionEnd);
+    ASSERT_EQUALS(0U, records[2].message.size());
+
+    ASSERT_LESS_THAN_OR_EQUALS(records[0].timestampMicros, records[1].timestampMicros);
+    ASSERT_LESS_THAN_OR_EQUALS(records[1].timestampMicros, records[2].timestampMicros);
+}
+
+TEST(TrafficRecorderTest, RotatesAndRemovesOldFiles) {
+    unittest::TempDir tempDir("traffic_recorder_test");
+    TrafficRecorder recorder;
+    TrafficRecorder::Options options;
+    options.directory = tempDir.path();
+    options.maxFileSizeBytes = 1;
+    options.maxFiles = 3;
+    ASSERT_OK(recorder.start(options));
+
+    const Message request = buildMessage(1, "request body");
+    for (int i = 0; i < 10; ++i) {
+        recorder.record(i, TrafficRecorder::EventType::kRequest, request);
+    }
+    recorder.stop();
+
+    // Every file holds exactly one record, and only the newest three remain.
+    const auto files = listFiles(tempDir.path());
+    ASSERT_EQUALS(3U, files.size());
+    for (size_t i = 0; i < files.size(); ++i) {
+        auto records = unittest::assertGet(readTrafficRecordingFile(files[i]));
+        ASSERT_EQUALS(1U, records.size());
+        ASSERT_EQUALS(7U + i, records[0].session);
+    }
+
+    // A new recording into the same directory continues the numbering and the rotation.
+    ASSERT_OK(recorder.start(options));
+    recorder.record(10, TrafficRecorder::EventType::kRequest, request);
+    recorder.stop();
+    const auto newFiles = listFiles(tempDir.path());
+    ASSERT_EQUALS(3U, newFiles.size());
+    ASSERT_EQUALS(files[2], newFiles[1]);
+    ASSERT_EQUALS(10U, unittest::assertGet(readTrafficRecordingFile(newFiles[2]))[0].session);
+}
+
+TEST(TrafficRecorderTest, DropsEventsWhenBufferIsFull) {
+    unittest::TempDir tempDir("traffic_recorder_test");
+    TrafficRecorder recorder;
+    TrafficRecorder::Options options;
+    options.directory = tempDir.path();
+    options.maxBufferedBytes = 1;
+    ASSERT_OK(recorder.start(options));
+
+    recorder.record(1, TrafficRecorder::EventType::kRequest, buildMessage(1, "request body"));
+    recorder.stop();
+    ASSERT_EQUALS(0, recorder.getEventsRecordedCount());
+    ASSERT_EQUALS(1, recorder.getEventsDroppedCount());
+}
+
+TEST(TrafficRecorderTest, RejectsFilesWithoutMagic) {
+    unittest::TempDir tempDir("traffic_recorder_test");
+    const std::string path = tempDir.path() + "/not_a_recording";
+    std::ofstream(path.c_str()) << "some other file";
+    ASSERT_EQUALS(ErrorCodes::FailedToParse, readTrafficRecordingFile(path).getStatus());
+}
+
+}  // namespace
+}  // namespace mongo
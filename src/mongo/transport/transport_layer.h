@@ -36,6 +36,9 @@
 #include "mongo/util/time_support.h"
 
 namespace mongo {
+
+class BSONObjBuilder;
+
 namespace transport {
 
 class TicketImpl;
@@ -190,6 +193,13 @@ public:
      */
     virtual void shutdown() = 0;
 
+    /**
+     * Append implementation-specific statistics about this TransportLayer (for example, the
+     * state of any worker threads it owns) to the given builder. The default implementation
+     * appends nothing.
+     */
+    virtual void appendStats(BSONObjBuilder* bob) const {}
+
 protected:
     TransportLayer() = default;
 
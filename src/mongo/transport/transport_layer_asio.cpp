@@ -0,0 +1,761 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kNetwork
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/transport_layer_asio.h"
+
+#include <algorithm>
+#include <asio.hpp>
+#include <boost/optional.hpp>
+#include <iterator>
+
+#include "mongo/base/checked_cast.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/config.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/stats/counters.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/transport/message_compressor_manager.h"
+#include "mongo/transport/service_entry_point.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/net/message.h"
+#include "mongo/util/net/sock.h"
+#include "mongo/util/net/ssl_options.h"
+#include "mongo/util/processinfo.h"
+
+namespace mongo {
+namespace transport {
+namespace {
+
+// Number of reactor threads used when Options::numWorkerThreads is left at 0. If this is also 0,
+// one worker is started per core.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(transportLayerASIOWorkerThreads, int, 0);
+
+const size_t kHeaderLen = sizeof(MSGHEADER::Value);
+const size_t kInitialMessageSize = 1024;
+
+struct lock_weak {
+    template <typename T>
+    std::shared_ptr<T> operator()(const std::weak_ptr<T>& p) const {
+        return p.lock();
+    }
+};
+
+Status errorCodeToStatus(const asio::error_code& ec) {
+    if (!ec) {
+        return Status::OK();
+    }
+
+    if (ec == asio::error::operation_aborted) {
+        return TransportLayer::TicketSessionClosedStatus;
+    }
+
+    return {ErrorCodes::HostUnreachable, ec.message()};
+}
+
+}  // namespace
+
+/**
+ * A single reactor thread. Every session is pinned to exactly one Worker, which runs all of the
+ * I/O completions and ticket callbacks for that session.
+ */
+class TransportLayerASIO::Worker {
+    MONGO_DISALLOW_COPYING(Worker);
+
+public:
+    explicit Worker(size_t id) : _id(id) {
+        _work.emplace(_ioService);
+    }
+
+    void start() {
+        _thread = stdx::thread([this] {
+            setThreadName(str::stream() << "asioWorker" << _id);
+            _ioService.run();
+        });
+    }
+
+    void stop() {
+        _work = boost::none;
+        _ioService.stop();
+        if (_thread.joinable()) {
+            _thread.join();
+        }
+    }
+
+    asio::io_service& ioService() {
+        return _ioService;
+    }
+
+    /**
+     * Queues a task to run on this worker's thread. The task is counted as queued until the
+     * reactor gets around to running it.
+     */
+    void schedule(stdx::function<void()> task) {
+        _queued.fetchAndAdd(1);
+        _ioService.post([this, task] {
+            _queued.fetchAndSubtract(1);
+            task();
+            _completed.fetchAndAdd(1);
+        });
+    }
+
+    void sessionAdded() {
+        _sessions.fetchAndAdd(1);
+    }
+
+    void sessionRemoved() {
+        _sessions.fetchAndSubtract(1);
+    }
+
+    long long sessions() const {
+        return _sessions.load();
+    }
+
+    void appendStats(BSONObjBuilder* bob) const {
+        bob->append("queued", _queued.load());
+        bob->append("sessions", _sessions.load());
+        bob->append("completed", _completed.load());
+    }
+
+private:
+    const size_t _id;
+
+    AtomicInt64 _queued{0};
+    AtomicInt64 _sessions{0};
+    AtomicInt64 _completed{0};
+
+    stdx::thread _thread;
+
+    // Must be declared last, so that any handlers still owned by the io_service are destroyed
+    // while the counters above are alive.
+    asio::io_service _ioService;
+    boost::optional<asio::io_service::work> _work;
+};
+
+/**
+ * An implementation of the Session interface for this TransportLayer.
+ */
+class TransportLayerASIO::ASIOSession : public Session {
+    MONGO_DISALLOW_COPYING(ASIOSession);
+
+public:
+    ~ASIOSession() {
+        _tl->_destroy(*this);
+    }
+
+    static ASIOSessionHandle create(TransportLayerASIO* tl,
+                                    Worker* worker,
+                                    int fd,
+                                    const SockAddr& remote,
+                                    const SockAddr& local,
+                                    long long connectionId) {
+        std::shared_ptr<ASIOSession> handle(
+            new ASIOSession(tl, worker, fd, remote, local, connectionId));
+        return handle;
+    }
+
+    TransportLayer* getTransportLayer() const override {
+        return _tl;
+    }
+
+    const HostAndPort& remote() const override {
+        return _remote;
+    }
+
+    const HostAndPort& local() const override {
+        return _local;
+    }
+
+    Worker* worker() const {
+        return _worker;
+    }
+
+    asio::generic::stream_protocol::socket& socket() {
+        return _socket;
+    }
+
+    long long connectionId() const {
+        return _connectionId;
+    }
+
+    bool isClosed() const {
+        return _closed.load();
+    }
+
+    /**
+     * Shuts down the underlying socket. Any outstanding I/O on this session will complete with an
+     * error. Returns false if the session had already been closed.
+     */
+    bool close() {
+        stdx::lock_guard<stdx::mutex> lk(_closeMutex);
+        if (_closed.load()) {
+            return false;
+        }
+
+        _closed.store(true);
+        asio::error_code ec;
+        _socket.shutdown(asio::socket_base::shutdown_both, ec);
+        return true;
+    }
+
+    void setIter(SessionEntry it) {
+        _entry = std::move(it);
+    }
+
+    SessionEntry getIter() const {
+        return _entry;
+    }
+
+private:
+    ASIOSession(TransportLayerASIO* tl,
+                Worker* worker,
+                int fd,
+                const SockAddr& remote,
+                const SockAddr& local,
+                long long connectionId)
+        : _remote(remote.getAddr(), remote.getPort()),
+          _local(local.toString(true)),
+          _tl(tl),
+          _worker(worker),
+          _connectionId(connectionId),
+          _socket(worker->ioService(),
+                  asio::generic::stream_protocol(remote.getType(),
+                                                 remote.getType() == AF_UNIX ? 0 : IPPROTO_TCP),
+                  fd) {
+        _worker->sessionAdded();
+    }
+
+    HostAndPort _remote;
+    HostAndPort _local;
+
+    TransportLayerASIO* _tl;
+    Worker* _worker;
+
+    const long long _connectionId;
+
+    stdx::mutex _closeMutex;
+    AtomicWord<bool> _closed{false};
+
+    asio::generic::stream_protocol::socket _socket;
+
+    // A handle to this session's entry in the TL's session list
+    SessionEntry _entry;
+};
+
+/**
+ * A TicketImpl implementation for this TransportLayer. Tickets can be filled either
+ * synchronously on the calling thread or asynchronously by the session's worker.
+ */
+class TransportLayerASIO::ASIOTicket : public TicketImpl {
+    MONGO_DISALLOW_COPYING(ASIOTicket);
+
+public:
+    ASIOTicket(const ASIOSessionHandle& session, Date_t expiration)
+        : _session(session), _sessionId(session->id()), _expiration(expiration) {}
+
+    SessionId sessionId() const override {
+        return _sessionId;
+    }
+
+    Date_t expiration() const override {
+        return _expiration;
+    }
+
+    /**
+     * If this ticket's session is still alive, return a shared_ptr. Otherwise,
+     * return nullptr.
+     */
+    ASIOSessionHandle getSession() {
+        return _session.lock();
+    }
+
+    /**
+     * Performs this ticket's I/O on the calling thread.
+     */
+    virtual Status fillSync(const ASIOSessionHandle& session) = 0;
+
+    /**
+     * Starts this ticket's I/O. The callback is invoked from the session's worker thread once the
+     * I/O has completed. The caller must keep this ticket alive until then.
+     */
+    virtual void fillAsync(const ASIOSessionHandle& session, TicketCallback cb) = 0;
+
+private:
+    std::weak_ptr<ASIOSession> _session;
+
+    SessionId _sessionId;
+    Date_t _expiration;
+};
+
+class TransportLayerASIO::ASIOSourceTicket final : public ASIOTicket {
+public:
+    ASIOSourceTicket(const ASIOSessionHandle& session, Date_t expiration, Message* target)
+        : ASIOTicket(session, expiration), _target(target) {}
+
+    Status fillSync(const ASIOSessionHandle& session) override {
+        _buffer = SharedBuffer::allocate(kInitialMessageSize);
+
+        asio::error_code ec;
+        asio::read(session->socket(), asio::buffer(_buffer.get(), kHeaderLen), ec);
+        auto status = _headerReceived(ec);
+        if (!status.isOK()) {
+            return status;
+        }
+
+        asio::read(session->socket(), asio::buffer(_buffer.get() + kHeaderLen, _bodyLen()), ec);
+        return _bodyReceived(session, ec);
+    }
+
+    void fillAsync(const ASIOSessionHandle& session, TicketCallback cb) override {
+        _buffer = SharedBuffer::allocate(kInitialMessageSize);
+
+        asio::async_read(
+            session->socket(),
+            asio::buffer(_buffer.get(), kHeaderLen),
+            [this, session, cb](const asio::error_code& ec, size_t) {
+                auto status = _headerReceived(ec);
+                if (!status.isOK()) {
+                    return cb(status);
+                }
+
+                asio::async_read(session->socket(),
+                                 asio::buffer(_buffer.get() + kHeaderLen, _bodyLen()),
+                                 [this, session, cb](const asio::error_code& ec, size_t) {
+                                     cb(_bodyReceived(session, ec));
+                                 });
+            });
+    }
+
+private:
+    size_t _bodyLen() const {
+        return MsgData::ConstView(_buffer.get()).getLen() - kHeaderLen;
+    }
+
+    Status _headerReceived(const asio::error_code& ec) {
+        if (ec) {
+            return errorCodeToStatus(ec);
+        }
+
+        const size_t msgLen = MsgData::ConstView(_buffer.get()).getLen();
+        if (msgLen < kHeaderLen || msgLen > MaxMessageSizeBytes) {
+            return {ErrorCodes::ProtocolError,
+                    str::stream() << "recv(): message len " << msgLen << " is invalid. "
+                                  << "Min: " << kHeaderLen << ", Max: " << MaxMessageSizeBytes};
+        }
+
+        if (msgLen > kInitialMessageSize) {
+            _buffer.realloc(msgLen);
+        }
+
+        return Status::OK();
+    }
+
+    Status _bodyReceived(const ASIOSessionHandle& session, const asio::error_code& ec) {
+        if (ec) {
+            return errorCodeToStatus(ec);
+        }
+
+        Message message(std::move(_buffer));
+        networkCounter.hitPhysical(message.size(), 0);
+        if (message.operation() == dbCompressed) {
+            auto swm = MessageCompressorManager::forSession(session).decompressMessage(message);
+            if (!swm.isOK()) {
+                return swm.getStatus();
+            }
+            message = std::move(swm.getValue());
+        }
+        networkCounter.hitLogical(message.size(), 0);
+
+        *_target = std::move(message);
+        return Status::OK();
+    }
+
+    Message* _target;
+    SharedBuffer _buffer;
+};
+
+class TransportLayerASIO::ASIOSinkTicket final : public ASIOTicket {
+public:
+    ASIOSinkTicket(const ASIOSessionHandle& session, Date_t expiration, const Message& message)
+        : ASIOTicket(session, expiration), _message(message) {}
+
+    Status fillSync(const ASIOSessionHandle& session) override {
+        auto status = _prepare(session);
+        if (!status.isOK()) {
+            return status;
+        }
+
+        asio::error_code ec;
+        asio::write(session->socket(), _buffers, ec);
+        return _sent(ec);
+    }
+
+    void fillAsync(const ASIOSessionHandle& session, TicketCallback cb) override {
+        auto status = _prepare(session);
+        if (!status.isOK()) {
+            // Never complete the ticket inline; the caller may not be re-entrant.
+            session->worker()->schedule([cb, status] { cb(status); });
+            return;
+        }
+
+        asio::async_write(session->socket(),
+                          _buffers,
+                          [this, session, cb](const asio::error_code& ec, size_t) {
+                              cb(_sent(ec));
+                          });
+    }
+
+private:
+    Status _prepare(const ASIOSessionHandle& session) {
+        networkCounter.hitLogical(0, _message.size());
+        auto swm = MessageCompressorManager::forSession(session).compressMessage(_message);
+        if (!swm.isOK()) {
+            return swm.getStatus();
+        }
+        _toSend = std::move(swm.getValue());
+
+        // Messages with segments, such as large query replies, go out with a gathering write.
+        _buffers.clear();
+        for (auto&& range : _toSend.gatherRanges()) {
+            _buffers.emplace_back(range.first, range.second);
+        }
+        return Status::OK();
+    }
+
+    Status _sent(const asio::error_code& ec) {
+        if (ec) {
+            return errorCodeToStatus(ec);
+        }
+
+        networkCounter.hitPhysical(0, _toSend.size());
+        return Status::OK();
+    }
+
+    // The caller owns the Message to sink and must keep it alive until the ticket completes.
+    const Message& _message;
+    Message _toSend;
+    std::vector<asio::const_buffer> _buffers;
+};
+
+/**
+ * This Listener accepts connections using the legacy networking code, then hands the raw file
+ * descriptor over to the TransportLayerASIO instead of wrapping it in an AbstractMessagingPort.
+ */
+class TransportLayerASIO::ListenerASIO final : public Listener {
+public:
+    ListenerASIO(const TransportLayerASIO::Options& opts, NewConnectionCb callback)
+        : Listener("", opts.ipList, opts.port, getGlobalServiceContext(), true),
+          _newConnectionCb(std::move(callback)) {}
+
+    void accepted(std::unique_ptr<AbstractMessagingPort> mp) override {
+        MONGO_UNREACHABLE;
+    }
+
+    bool useUnixSockets() const override {
+        return true;
+    }
+
+private:
+    void _accepted(const std::shared_ptr<Socket>& psocket, long long connectionId) override {
+        const auto remote = psocket->remoteAddr();
+        const auto local = psocket->localAddr();
+        _newConnectionCb(psocket->stealSD(), remote, local, connectionId);
+    }
+
+    NewConnectionCb _newConnectionCb;
+};
+
+TransportLayerASIO::TransportLayerASIO(const TransportLayerASIO::Options& opts,
+                                       ServiceEntryPoint* sep)
+    : _sep(sep),
+      _listener(stdx::make_unique<ListenerASIO>(
+          opts,
+          stdx::bind(&TransportLayerASIO::_handleNewConnection,
+                     this,
+                     stdx::placeholders::_1,
+                     stdx::placeholders::_2,
+                     stdx::placeholders::_3,
+                     stdx::placeholders::_4))),
+      _running(false),
+      _options(opts) {}
+
+TransportLayerASIO::~TransportLayerASIO() = default;
+
+Status TransportLayerASIO::setup() {
+#ifdef MONGO_CONFIG_SSL
+    if (sslGlobalParams.sslMode.load() != SSLParams::SSLMode_disabled) {
+        return {ErrorCodes::InvalidOptions,
+                "The asio transport layer does not support SSL connections yet"};
+    }
+#endif
+
+    if (!_listener->setupSockets()) {
+        error() << "Failed to set up sockets during startup.";
+        return {ErrorCodes::InternalError, "Failed to set up sockets"};
+    }
+
+    auto numWorkers = _options.numWorkerThreads;
+    if (numWorkers == 0 && transportLayerASIOWorkerThreads > 0) {
+        numWorkers = static_cast<size_t>(transportLayerASIOWorkerThreads);
+    }
+    if (numWorkers == 0) {
+        ProcessInfo p;
+        numWorkers = std::max(p.getNumCores(), 1u);
+    }
+
+    for (size_t i = 0; i < numWorkers; ++i) {
+        _workers.emplace_back(stdx::make_unique<Worker>(i));
+    }
+
+    return Status::OK();
+}
+
+Status TransportLayerASIO::start() {
+    if (_running.swap(true)) {
+        return {ErrorCodes::InternalError, "TransportLayer is already running"};
+    }
+
+    for (auto&& worker : _workers) {
+        worker->start();
+    }
+
+    _listenerThread = stdx::thread([this]() { _listener->initAndListen(); });
+
+    return Status::OK();
+}
+
+Ticket TransportLayerASIO::sourceMessage(const SessionHandle& session,
+                                         Message* message,
+                                         Date_t expiration) {
+    auto asioSession = checked_pointer_cast<ASIOSession>(session);
+    return Ticket(this,
+                  stdx::make_unique<ASIOSourceTicket>(std::move(asioSession), expiration, message));
+}
+
+Ticket TransportLayerASIO::sinkMessage(const SessionHandle& session,
+                                       const Message& message,
+                                       Date_t expiration) {
+    auto asioSession = checked_pointer_cast<ASIOSession>(session);
+    return Ticket(this,
+                  stdx::make_unique<ASIOSinkTicket>(std::move(asioSession), expiration, message));
+}
+
+Status TransportLayerASIO::wait(Ticket&& ticket) {
+    if (!_running.load()) {
+        return TransportLayer::ShutdownStatus;
+    }
+
+    if (ticket.expiration() < Date_t::now()) {
+        return Ticket::ExpiredStatus;
+    }
+
+    auto asioTicket = checked_cast<ASIOTicket*>(getTicketImpl(ticket));
+    auto session = asioTicket->getSession();
+    if (!session || session->isClosed()) {
+        return TransportLayer::TicketSessionClosedStatus;
+    }
+
+    try {
+        return asioTicket->fillSync(session);
+    } catch (...) {
+        return exceptionToStatus();
+    }
+}
+
+void TransportLayerASIO::asyncWait(Ticket&& ticket, TicketCallback callback) {
+    auto asioTicket = checked_cast<ASIOTicket*>(getTicketImpl(ticket));
+    auto session = asioTicket->getSession();
+    if (!session) {
+        return callback(TransportLayer::TicketSessionClosedStatus);
+    }
+
+    // Keep the ticket alive until the I/O completes, and hop onto the worker's queue before
+    // running the callback so that queue depth reflects all ready work.
+    auto worker = session->worker();
+    auto ownedTicket = std::make_shared<Ticket>(std::move(ticket));
+    auto onComplete = [worker, ownedTicket, callback](Status status) {
+        worker->schedule([callback, status] { callback(status); });
+    };
+
+    if (!_running.load()) {
+        return onComplete(TransportLayer::ShutdownStatus);
+    }
+
+    if (ownedTicket->expiration() < Date_t::now()) {
+        return onComplete(Ticket::ExpiredStatus);
+    }
+
+    if (session->isClosed()) {
+        return onComplete(TransportLayer::TicketSessionClosedStatus);
+    }
+
+    asioTicket->fillAsync(session, std::move(onComplete));
+}
+
+TransportLayer::Stats TransportLayerASIO::sessionStats() {
+    Stats stats;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_sessionsMutex);
+        stats.numOpenSessions = _sessions.size();
+    }
+
+    stats.numAvailableSessions = Listener::globalTicketHolder.available();
+    stats.numCreatedSessions = Listener::globalConnectionNumber.load();
+
+    return stats;
+}
+
+void TransportLayerASIO::end(const SessionHandle& session) {
+    auto asioSession = checked_pointer_cast<ASIOSession>(session);
+    _closeSession(asioSession.get());
+}
+
+void TransportLayerASIO::_closeSession(ASIOSession* session) {
+    if (session->close()) {
+        Listener::globalTicketHolder.release();
+    }
+}
+
+// Capture all of the weak pointers behind the lock, to delay their expiry until we leave the
+// locking context. This function requires proof of locking, by passing the lock guard.
+auto TransportLayerASIO::_lockAllSessions(const stdx::unique_lock<stdx::mutex>&) const
+    -> std::vector<ASIOSessionHandle> {
+    using std::begin;
+    using std::end;
+    std::vector<std::shared_ptr<ASIOSession>> result;
+    std::transform(begin(_sessions), end(_sessions), std::back_inserter(result), lock_weak());
+    // Skip expired weak pointers.
+    result.erase(std::remove(begin(result), end(result), nullptr), end(result));
+    return result;
+}
+
+void TransportLayerASIO::endAllSessions(Session::TagMask tags) {
+    log() << "asio transport layer closing all connections";
+
+    std::vector<ASIOSessionHandle> sessions;
+    {
+        stdx::unique_lock<stdx::mutex> lk(_sessionsMutex);
+        sessions = _lockAllSessions(lk);
+    }
+
+    // The shared_ptrs are released outside of the lock, since dropping the last reference to a
+    // session takes _sessionsMutex.
+    for (auto&& session : sessions) {
+        if (session->getTags() & tags) {
+            log() << "Skip closing connection for connection # " << session->connectionId();
+        } else {
+            _closeSession(session.get());
+        }
+    }
+}
+
+void TransportLayerASIO::shutdown() {
+    _running.store(false);
+    _listener->shutdown();
+    if (_listenerThread.joinable()) {
+        _listenerThread.join();
+    }
+    endAllSessions(Session::kEmptyTagMask);
+
+    for (auto&& worker : _workers) {
+        worker->stop();
+    }
+}
+
+void TransportLayerASIO::appendStats(BSONObjBuilder* bob) const {
+    BSONObjBuilder section(bob->subobjStart("transportLayerASIO"));
+    section.append("numWorkerThreads", static_cast<int>(_workers.size()));
+
+    BSONArrayBuilder workers(section.subarrayStart("workers"));
+    for (auto&& worker : _workers) {
+        BSONObjBuilder workerBob(workers.subobjStart());
+        worker->appendStats(&workerBob);
+    }
+}
+
+TransportLayerASIO::Worker* TransportLayerASIO::_pickWorker() {
+    invariant(!_workers.empty());
+    auto it = std::min_element(_workers.begin(), _workers.end(), [](const auto& a, const auto& b) {
+        return a->sessions() < b->sessions();
+    });
+    return it->get();
+}
+
+void TransportLayerASIO::_destroy(ASIOSession& session) {
+    _closeSession(&session);
+    session.worker()->sessionRemoved();
+
+    stdx::lock_guard<stdx::mutex> lk(_sessionsMutex);
+    _sessions.erase(session.getIter());
+}
+
+void TransportLayerASIO::_handleNewConnection(int fd,
+                                              const SockAddr& remote,
+                                              const SockAddr& local,
+                                              long long connectionId) {
+    if (!Listener::globalTicketHolder.tryAcquire()) {
+        log() << "connection refused because too many open connections: "
+              << Listener::globalTicketHolder.used();
+        closesocket(fd);
+        return;
+    }
+
+    ASIOSessionHandle session;
+    try {
+        session = ASIOSession::create(this, _pickWorker(), fd, remote, local, connectionId);
+    } catch (const asio::system_error& e) {
+        error() << "failed to attach accepted connection to the transport layer: "
+                << redact(e.what());
+        Listener::globalTicketHolder.release();
+        closesocket(fd);
+        return;
+    }
+
+    stdx::list<std::weak_ptr<ASIOSession>> list;
+    auto it = list.emplace(list.begin(), session);
+
+    {
+        // Add the new session to our list
+        stdx::lock_guard<stdx::mutex> lk(_sessionsMutex);
+        session->setIter(it);
+        _sessions.splice(_sessions.begin(), list, it);
+    }
+
+    invariant(_sep);
+    _sep->startSession(std::move(session));
+}
+
+}  // namespace transport
+}  // namespace mongo
@@ -0,0 +1,151 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/list.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/transport/ticket_impl.h"
+#include "mongo/transport/transport_layer.h"
+#include "mongo/util/net/listen.h"
+#include "mongo/util/net/sockaddr.h"
+
+namespace mongo {
+
+class ServiceEntryPoint;
+
+namespace transport {
+
+/**
+ * A TransportLayer implementation that performs all session I/O asynchronously on a fixed pool
+ * of worker threads, each of which runs its own ASIO reactor.
+ *
+ * Connections are still accepted through the legacy Listener, so binding, unix domain sockets
+ * and the maxConns limit behave exactly as they do for TransportLayerLegacy. Each accepted
+ * socket is pinned to the least loaded worker, and every completion for that session (including
+ * callbacks passed to asyncWait()) runs on that worker's thread. This lets a small, fixed number
+ * of threads serve any number of connections.
+ *
+ * SSL is not yet supported by this TransportLayer; setup() fails if SSL is enabled.
+ */
+class TransportLayerASIO final : public TransportLayer {
+    MONGO_DISALLOW_COPYING(TransportLayerASIO);
+
+public:
+    struct Options {
+        int port;                 // port to bind to
+        std::string ipList;       // addresses to bind to
+        size_t numWorkerThreads;  // number of reactor threads, 0 means one per core
+
+        Options() : port(0), ipList(""), numWorkerThreads(0) {}
+    };
+
+    TransportLayerASIO(const Options& opts, ServiceEntryPoint* sep);
+
+    ~TransportLayerASIO();
+
+    Status setup();
+    Status start() override;
+
+    Ticket sourceMessage(const SessionHandle& session,
+                         Message* message,
+                         Date_t expiration = Ticket::kNoExpirationDate) override;
+
+    Ticket sinkMessage(const SessionHandle& session,
+                       const Message& message,
+                       Date_t expiration = Ticket::kNoExpirationDate) override;
+
+    Status wait(Ticket&& ticket) override;
+    void asyncWait(Ticket&& ticket, TicketCallback callback) override;
+
+    Stats sessionStats() override;
+
+    void end(const SessionHandle& session) override;
+    void endAllSessions(transport::Session::TagMask tags) override;
+
+    void shutdown() override;
+
+    /**
+     * Appends a "transportLayerASIO" sub-document with per-worker queue depths and session
+     * counts.
+     */
+    void appendStats(BSONObjBuilder* bob) const override;
+
+private:
+    class ASIOSession;
+    class ASIOTicket;
+    class ASIOSourceTicket;
+    class ASIOSinkTicket;
+    class ListenerASIO;
+    class Worker;
+
+    using ASIOSessionHandle = std::shared_ptr<ASIOSession>;
+    using SessionEntry = std::list<std::weak_ptr<ASIOSession>>::iterator;
+    using NewConnectionCb =
+        stdx::function<void(int, const SockAddr&, const SockAddr&, long long)>;
+
+    void _handleNewConnection(int fd,
+                              const SockAddr& remote,
+                              const SockAddr& local,
+                              long long connectionId);
+
+    void _closeSession(ASIOSession* session);
+    void _destroy(ASIOSession& session);
+
+    Worker* _pickWorker();
+
+    std::vector<ASIOSessionHandle> _lockAllSessions(const stdx::unique_lock<stdx::mutex>&) const;
+
+    ServiceEntryPoint* _sep;
+
+    std::unique_ptr<Listener> _listener;
+    stdx::thread _listenerThread;
+
+    // TransportLayerASIO holds non-owning pointers to all of its sessions.
+    mutable stdx::mutex _sessionsMutex;
+    stdx::list<std::weak_ptr<ASIOSession>> _sessions;
+
+    // The reactor threads, fixed in size once setup() has run. Declared after the session list
+    // because destroying a worker destroys any handlers (and therefore sessions) it still owns.
+    std::vector<std::unique_ptr<Worker>> _workers;
+
+    AtomicWord<bool> _running;
+
+    Options _options;
+};
+
+}  // namespace transport
+}  // namespace mongo
@@ -0,0 +1,126 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/dbmessage.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/transport/service_entry_point.h"
+#include "mongo/transport/transport_layer_asio.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/net/sock.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Echoes the first Message it receives on each session back to the client, using only
+ * asyncWait(), then ends the session.
+ */
+class ServiceEntryPointEcho : public ServiceEntryPoint {
+public:
+    void startSession(transport::SessionHandle session) override {
+        auto message = std::make_shared<Message>();
+        session->sourceMessage(message.get()).asyncWait([this, session, message](Status status) {
+            ASSERT_OK(status);
+            session->sinkMessage(*message).asyncWait([this, session, message](Status status) {
+                ASSERT_OK(status);
+                tla->end(session);
+
+                stdx::lock_guard<stdx::mutex> lk(mutex);
+                echoed++;
+                cv.notify_one();
+            });
+        });
+    }
+
+    DbResponse handleRequest(OperationContext* opCtx,
+                             const Message& request,
+                             const HostAndPort& client) override {
+        MONGO_UNREACHABLE;
+    }
+
+    transport::TransportLayerASIO* tla = nullptr;
+
+    stdx::mutex mutex;
+    stdx::condition_variable cv;
+    int echoed = 0;
+};
+
+TEST(TransportLayerASIO, asyncRoundTrip) {
+    // Disabling this test until we can figure out the best way to allocate port numbers for unit
+    // tests
+    return;
+
+    ServiceEntryPointEcho sep;
+
+    transport::TransportLayerASIO::Options opts{};
+    opts.port = 27017;
+    opts.numWorkerThreads = 2;
+    transport::TransportLayerASIO tla(opts, &sep);
+
+    sep.tla = &tla;
+
+    ASSERT_OK(tla.setup());
+    ASSERT_OK(tla.start());
+
+    Socket s;
+    SockAddr sa{"localhost", 27017};
+    ASSERT(s.connect(sa));
+
+    BufBuilder b;
+    b.skip(sizeof(MSGHEADER::Value));
+    b.appendStr("ping");
+    Message toSend(b.release());
+    toSend.header().setLen(toSend.size());
+    toSend.header().setId(1);
+    toSend.header().setResponseToMsgId(0);
+    toSend.header().setOperation(dbQuery);
+    s.send(toSend.buf(), toSend.size(), "asyncRoundTrip");
+
+    std::vector<char> reply(toSend.size());
+    s.recv(reply.data(), reply.size());
+    ASSERT_EQ(0, memcmp(reply.data(), toSend.buf(), toSend.size()));
+
+    {
+        stdx::unique_lock<stdx::mutex> lk(sep.mutex);
+        sep.cv.wait(lk, [&] { return sep.echoed == 1; });
+    }
+
+    BSONObjBuilder stats;
+    tla.appendStats(&stats);
+    ASSERT_EQ(2, stats.obj()["transportLayerASIO"]["numWorkerThreads"].numberInt());
+
+    tla.shutdown();
+}
+
+}  // namespace
+}  // namespace mongo
@@ -65,7 +65,7 @@ void TransportLayerManager::asyncWait(Ticket&& ticket, TicketCallback callback)
 }
 
 template <typename Callable>
-void TransportLayerManager::_foreach(Callable&& cb) {
+void TransportLayerManager::_foreach(Callable&& cb) const {
     {
         stdx::lock_guard<stdx::mutex> lk(_tlsMutex);
         for (auto&& tl : _tls) {
@@ -109,6 +109,10 @@ void TransportLayerManager::shutdown() {
     _foreach([](TransportLayer* tl) { tl->shutdown(); });
 }
 
+void TransportLayerManager::appendStats(BSONObjBuilder* bob) const {
+    _foreach([bob](TransportLayer* tl) { tl->appendStats(bob); });
+}
+
 Status TransportLayerManager::addAndStartTransportLayer(std::unique_ptr<TransportLayer> tl) {
     auto ptr = tl.get();
     {
@@ -72,13 +72,15 @@ public:
     Status start() override;
     void shutdown() override;
 
+    void appendStats(BSONObjBuilder* bob) const override;
+
     Status addAndStartTransportLayer(std::unique_ptr<TransportLayer> tl);
 
 private:
     template <typename Callable>
-    void _foreach(Callable&& cb);
+    void _foreach(Callable&& cb) const;
 
-    stdx::mutex _tlsMutex;
+    mutable stdx::mutex _tlsMutex;
     std::vector<std::unique_ptr<TransportLayer>> _tls;
 };
 
@@ -0,0 +1,336 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/unittest/benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/debug_util.h"
+#include "mongo/util/log.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace unittest {
+
+namespace {
+
+struct RegisteredBenchmark {
+    std::string suiteName;
+    std::string benchmarkName;
+    Benchmark::Factory factory;
+};
+
+std::vector<RegisteredBenchmark>& getRegistry() {
+    // Leaked, so that it is usable from static initializers in any translation unit.
+    static std::vector<RegisteredBenchmark>* registry = new std::vector<RegisteredBenchmark>();
+    return *registry;
+}
+
+// Bounds calibration, so that a benchmark whose body the compiler managed to remove entirely
+// still terminates.
+const std::int64_t kMaxIterations = 1000LL * 1000 * 1000;
+
+// While calibrating, aim this far past the minimum time so that the timed repetitions do not fall
+// just short of it, but never grow the iteration count by more than kMaxGrowth per step so that a
+// single noisy run cannot overshoot wildly.
+const double kCalibrationHeadroom = 1.4;
+const double kMaxGrowth = 10.0;
+
+double toNanos(BenchmarkState::Clock::duration d) {
+    return stdx::chrono::duration_cast<stdx::chrono::duration<double, std::nano>>(d).count();
+}
+
+std::unique_ptr<BenchmarkState> runRepetition(const std::string& fullName,
+                                              const Benchmark::Factory& factory,
+                                              std::int64_t iterations) {
+    auto state = stdx::make_unique<BenchmarkState>(iterations);
+    factory()->run(*state);
+    uassert(40653,
+            str::stream() << "benchmark " << fullName
+                          << " returned before keepRunning() reported completion",
+            state->finished());
+    return state;
+}
+
+std::string formatRate(double perSecond) {
+    if (perSecond <= 0) {
+        return "-";
+    }
+    const char* const suffixes[] = {"", "k", "M", "G", "T"};
+    size_t i = 0;
+    while (perSecond >= 1000 && i + 1 < sizeof(suffixes) / sizeof(suffixes[0])) {
+        perSecond /= 1000;
+        ++i;
+    }
+    std::ostringstream os;
+    os << std::fixed << std::setprecision(2) << perSecond << suffixes[i] << "/s";
+    return os.str();
+}
+
+void writeTextReport(std::ostream& os, const std::vector<BenchmarkResult>& results) {
+    os << std::left << std::setw(56) << "Benchmark" << std::right << std::setw(14)
+       << "Median ns" << std::setw(9) << "+/-%" << std::setw(14) << "Min ns" << std::setw(13)
+       << "Iterations" << std::setw(14) << "Items" << std::setw(14) << "Bytes" << '\n';
+    for (const auto& result : results) {
+        const auto stats = BenchmarkStatistics::compute(result.nanosPerIteration);
+        const double relStddev = stats.mean > 0 ? 100 * stats.stddev / stats.mean : 0;
+        const double perSecond = stats.median > 0 ? 1e9 / stats.median : 0;
+        os << std::left << std::setw(56) << (result.suiteName + "." + result.benchmarkName)
+           << std::right << std::fixed << std::setprecision(1) << std::setw(14) << stats.median
+           << std::setw(9) << relStddev << std::setw(14) << stats.min << std::setw(13)
+           << result.iterations << std::setw(14)
+           << formatRate(result.itemsPerIteration * perSecond) << std::setw(14)
+           << formatRate(result.bytesPerIteration * perSecond) << '\n';
+    }
+}
+
+void writeJSONReport(std::ostream& os,
+                     const BenchmarkOptions& options,
+                     const std::vector<BenchmarkResult>& results) {
+    BSONObjBuilder report;
+    {
+        BSONObjBuilder context(report.subobjStart("context"));
+        context.append("date", Date_t::now());
+        context.append("debugBuild", kDebugBuild);
+        context.append("numCores", static_cast<int>(stdx::thread::hardware_concurrency()));
+        context.append("repetitions", options.repetitions);
+        context.append("minTimeMillis", static_cast<long long>(options.minTime.count()));
+    }
+    {
+        BSONArrayBuilder benchmarks(report.subarrayStart("benchmarks"));
+        for (const auto& result : results) {
+            benchmarks.append(result.toBSON());
+        }
+    }
+    os << report.obj().jsonString(Strict, 1) << '\n';
+}
+
+}  // namespace
+
+BenchmarkState::BenchmarkState(std::int64_t iterations)
+    : _iterations(iterations), _remaining(iterations) {}
+
+bool BenchmarkState::_keepRunningSlow() {
+    if (!_started) {
+        _started = true;
+        _start = Clock::now();
+        if (_remaining > 0) {
+            --_remaining;
+            return true;
+        }
+    }
+    if (!_paused) {
+        _elapsed += Clock::now() - _start;
+    }
+    _paused = true;
+    _finished = true;
+    return false;
+}
+
+void BenchmarkState::pauseTiming() {
+    invariant(_started && !_paused);
+    _elapsed += Clock::now() - _start;
+    _paused = true;
+}
+
+void BenchmarkState::resumeTiming() {
+    invariant(_started && _paused && !_finished);
+    _paused = false;
+    _start = Clock::now();
+}
+
+void Benchmark::run(BenchmarkState& state) {
+    setUp();
+    try {
+        _doBenchmark(state);
+    } catch (...) {
+        tearDown();
+        throw;
+    }
+    tearDown();
+}
+
+void Benchmark::registerBenchmark(const std::string& suiteName,
+                                  const std::string& benchmarkName,
+                                  Factory factory) {
+    getRegistry().push_back({suiteName, benchmarkName, std::move(factory)});
+}
+
+BenchmarkStatistics BenchmarkStatistics::compute(std::vector<double> samples) {
+    invariant(!samples.empty());
+    std::sort(samples.begin(), samples.end());
+
+    BenchmarkStatistics stats;
+    const size_t n = samples.size();
+    stats.min = samples.front();
+    stats.max = samples.back();
+    stats.median = (n % 2) ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+
+    double sum = 0;
+    for (double sample : samples) {
+        sum += sample;
+    }
+    stats.mean = sum / n;
+
+    if (n > 1) {
+        double squares = 0;
+        for (double sample : samples) {
+            squares += (sample - stats.mean) * (sample - stats.mean);
+        }
+        stats.stddev = std::sqrt(squares / (n - 1));
+    }
+    return stats;
+}
+
+BSONObj BenchmarkResult::toBSON() const {
+    const auto stats = BenchmarkStatistics::compute(nanosPerIteration);
+    const double perSecond = stats.median > 0 ? 1e9 / stats.median : 0;
+
+    BSONObjBuilder builder;
+    builder.append("suite", suiteName);
+    builder.append("name", benchmarkName);
+    builder.append("iterations", static_cast<long long>(iterations));
+    builder.append("repetitions", static_cast<int>(nanosPerIteration.size()));
+    {
+        BSONObjBuilder nanos(builder.subobjStart("nanosPerIteration"));
+        nanos.append("min", stats.min);
+        nanos.append("max", stats.max);
+        nanos.append("mean", stats.mean);
+        nanos.append("median", stats.median);
+        nanos.append("stddev", stats.stddev);
+        nanos.append("samples", nanosPerIteration);
+    }
+    if (itemsPerIteration > 0) {
+        builder.append("itemsPerSecond", itemsPerIteration * perSecond);
+    }
+    if (bytesPerIteration > 0) {
+        builder.append("bytesPerSecond", bytesPerIteration * perSecond);
+    }
+    return builder.obj();
+}
+
+BenchmarkResult runBenchmark(const std::string& suiteName,
+                             const std::string& benchmarkName,
+                             const Benchmark::Factory& factory,
+                             const BenchmarkOptions& options) {
+    const std::string fullName = suiteName + "." + benchmarkName;
+    const double minNanos = toNanos(options.minTime);
+
+    // Calibrate. The calibration runs also serve as warm-up for caches and allocators.
+    std::int64_t iterations = 1;
+    while (iterations < kMaxIterations) {
+        const auto state = runRepetition(fullName, factory, iterations);
+        const double elapsedNanos = toNanos(state->elapsed());
+        if (elapsedNanos >= minNanos) {
+            break;
+        }
+        const double growth = elapsedNanos > 0
+            ? std::min(kMaxGrowth, kCalibrationHeadroom * minNanos / elapsedNanos)
+            : kMaxGrowth;
+        const auto next = static_cast<std::int64_t>(iterations * growth);
+        iterations = std::min(kMaxIterations, std::max(iterations + 1, next));
+    }
+
+    BenchmarkResult result;
+    result.suiteName = suiteName;
+    result.benchmarkName = benchmarkName;
+    result.iterations = iterations;
+    for (int i = 0; i < std::max(1, options.repetitions); ++i) {
+        const auto state = runRepetition(fullName, factory, iterations);
+        result.nanosPerIteration.push_back(toNanos(state->elapsed()) / iterations);
+        result.itemsPerIteration = static_cast<double>(state->itemsProcessed()) / iterations;
+        result.bytesPerIteration = static_cast<double>(state->bytesProcessed()) / iterations;
+    }
+    return result;
+}
+
+int runBenchmarks(const BenchmarkOptions& options) {
+    auto registered = getRegistry();
+    std::stable_sort(registered.begin(),
+                     registered.end(),
+                     [](const RegisteredBenchmark& lhs, const RegisteredBenchmark& rhs) {
+                         return lhs.suiteName < rhs.suiteName;
+                     });
+
+    std::ofstream outputFile;
+    if (!options.outputFile.empty()) {
+        outputFile.open(options.outputFile.c_str(), std::ios::out | std::ios::trunc);
+        if (!outputFile) {
+            severe() << "could not open benchmark output file " << options.outputFile;
+            return EXIT_FAILURE;
+        }
+    }
+    std::ostream& os = options.outputFile.empty() ? std::cout : outputFile;
+
+    std::vector<BenchmarkResult> results;
+    bool failed = false;
+    for (const auto& benchmark : registered) {
+        const std::string fullName = benchmark.suiteName + "." + benchmark.benchmarkName;
+        if (fullName.find(options.filter) == std::string::npos) {
+            continue;
+        }
+        if (options.listOnly) {
+            os << fullName << '\n';
+            continue;
+        }
+
+        LOG(1) << "running benchmark " << fullName;
+        try {
+            results.push_back(runBenchmark(
+                benchmark.suiteName, benchmark.benchmarkName, benchmark.factory, options));
+        } catch (const DBException& ex) {
+            severe() << "benchmark " << fullName << " failed: " << ex.what();
+            failed = true;
+        }
+    }
+
+    if (!options.listOnly) {
+        if (options.format == "json") {
+            writeJSONReport(os, options, results);
+        } else {
+            writeTextReport(os, results);
+        }
+    }
+    os.flush();
+    return (failed || !os) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+}  // namespace unittest
+}  // namespace mongo
@@ -0,0 +1,316 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * A minimal microbenchmark framework, modeled on the unit test framework in unittest.h.
+ *
+ * Benchmarks are declared with the BENCHMARK and BENCHMARK_F macros, which mirror TEST and
+ * TEST_F. The body receives a BenchmarkState named "state" and must run the code under
+ * measurement inside a "while (state.keepRunning())" loop:
+ *
+ *     BENCHMARK(BSONObjBuilder, AppendInt) {
+ *         while (state.keepRunning()) {
+ *             BSONObjBuilder bob;
+ *             bob.append("a", 1);
+ *             benchmarkDoNotOptimize(bob.done());
+ *         }
+ *     }
+ *
+ * The runner first calibrates the number of iterations so that one repetition takes at least
+ * the configured minimum time, then times a fixed number of repetitions of that many iterations.
+ * Fixture setUp() and tearDown() run outside of the timed region, once per repetition.
+ *
+ * Benchmark programs are built with env.Benchmark() in SConscript files and link against
+ * benchmark_main; see benchmark_main.cpp for the supported command line options.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/platform/compiler.h"
+#include "mongo/stdx/chrono.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/memory.h"
+
+#define BENCHMARK(CASE_NAME, BENCHMARK_NAME) \
+    _BENCHMARK_DEFINE(CASE_NAME, BENCHMARK_NAME, ::mongo::unittest::Benchmark)
+
+/**
+ * Like BENCHMARK, except that the benchmark class derives from FIXTURE_NAME, which must be a
+ * subclass of ::mongo::unittest::Benchmark.
+ */
+#define BENCHMARK_F(FIXTURE_NAME, BENCHMARK_NAME) \
+    _BENCHMARK_DEFINE(FIXTURE_NAME, BENCHMARK_NAME, FIXTURE_NAME)
+
+#define _BENCHMARK_DEFINE(CASE_NAME, BENCHMARK_NAME, BASE_NAME)                                \
+    class _BENCHMARK_TYPE_NAME(CASE_NAME, BENCHMARK_NAME) : public BASE_NAME {                 \
+    private:                                                                                   \
+        void _doBenchmark(::mongo::unittest::BenchmarkState& state) override;                  \
+        static const RegistrationAgent<_BENCHMARK_TYPE_NAME(CASE_NAME, BENCHMARK_NAME)> _agent; \
+    };                                                                                         \
+    const ::mongo::unittest::Benchmark::RegistrationAgent<_BENCHMARK_TYPE_NAME(CASE_NAME,     \
+                                                                               BENCHMARK_NAME)> \
+        _BENCHMARK_TYPE_NAME(CASE_NAME, BENCHMARK_NAME)::_agent(#CASE_NAME, #BENCHMARK_NAME);  \
+    void _BENCHMARK_TYPE_NAME(CASE_NAME, BENCHMARK_NAME)::_doBenchmark(                        \
+        ::mongo::unittest::BenchmarkState& state)
+
+#define _BENCHMARK_TYPE_NAME(CASE_NAME, BENCHMARK_NAME) \
+    Benchmark__##CASE_NAME##__##BENCHMARK_NAME
+
+namespace mongo {
+namespace unittest {
+
+/**
+ * Prevents the compiler from discarding the computation of "value" as dead code.
+ */
+template <typename T>
+inline void benchmarkDoNotOptimize(const T& value) {
+#if defined(__GNUC__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+/**
+ * Controls the iteration loop of a single repetition of a benchmark and accumulates the time
+ * spent inside it.
+ */
+class BenchmarkState {
+    MONGO_DISALLOW_COPYING(BenchmarkState);
+
+public:
+    using Clock = stdx::chrono::steady_clock;
+
+    explicit BenchmarkState(std::int64_t iterations);
+
+    /**
+     * Returns true while there are iterations left to run. The first call starts the timer and
+     * the call that returns false stops it.
+     */
+    bool keepRunning() {
+        if (MONGO_likely(_started && _remaining > 0)) {
+            --_remaining;
+            return true;
+        }
+        return _keepRunningSlow();
+    }
+
+    /**
+     * Excludes the time between pauseTiming() and resumeTiming() from the measurement, for
+     * per-iteration setup that should not be charged to the code under test.
+     */
+    void pauseTiming();
+    void resumeTiming();
+
+    /**
+     * Reports how much work the whole repetition performed, so that the runner can compute
+     * throughput. These are totals across all iterations, not per-iteration counts.
+     */
+    void setItemsProcessed(std::int64_t items) {
+        _itemsProcessed = items;
+    }
+    void setBytesProcessed(std::int64_t bytes) {
+        _bytesProcessed = bytes;
+    }
+
+    std::int64_t iterations() const {
+        return _iterations;
+    }
+
+    std::int64_t itemsProcessed() const {
+        return _itemsProcessed;
+    }
+
+    std::int64_t bytesProcessed() const {
+        return _bytesProcessed;
+    }
+
+    /**
+     * Returns the time accumulated while timing was running.
+     */
+    Clock::duration elapsed() const {
+        return _elapsed;
+    }
+
+    /**
+     * Returns true once every iteration has been run.
+     */
+    bool finished() const {
+        return _finished;
+    }
+
+private:
+    bool _keepRunningSlow();
+
+    const std::int64_t _iterations;
+    std::int64_t _remaining;
+    bool _started = false;
+    bool _finished = false;
+    bool _paused = false;
+    Clock::time_point _start;
+    Clock::duration _elapsed = Clock::duration::zero();
+    std::int64_t _itemsProcessed = 0;
+    std::int64_t _bytesProcessed = 0;
+};
+
+/**
+ * Base type for benchmark fixtures. Also, the default fixture type used by the BENCHMARK macro.
+ *
+ * A fresh instance is constructed for every repetition, including calibration runs.
+ */
+class Benchmark {
+    MONGO_DISALLOW_COPYING(Benchmark);
+
+public:
+    using Factory = stdx::function<std::unique_ptr<Benchmark>()>;
+
+    Benchmark() = default;
+    virtual ~Benchmark() = default;
+
+    void run(BenchmarkState& state);
+
+    /**
+     * Adds a benchmark to the global registry. Safe to call during static initialization.
+     */
+    static void registerBenchmark(const std::string& suiteName,
+                                  const std::string& benchmarkName,
+                                  Factory factory);
+
+protected:
+    /**
+     * Registration agent for adding benchmarks to the registry, used by the BENCHMARK macro.
+     */
+    template <typename T>
+    class RegistrationAgent {
+        MONGO_DISALLOW_COPYING(RegistrationAgent);
+
+    public:
+        RegistrationAgent(const std::string& suiteName, const std::string& benchmarkName) {
+            registerBenchmark(
+                suiteName, benchmarkName, [] { return std::unique_ptr<Benchmark>(new T()); });
+        }
+    };
+
+private:
+    /**
+     * Called on the benchmark object before each repetition, outside of the timed region.
+     */
+    virtual void setUp() {}
+
+    /**
+     * Called on the benchmark object after each repetition, outside of the timed region.
+     */
+    virtual void tearDown() {}
+
+    /**
+     * The benchmark itself.
+     */
+    virtual void _doBenchmark(BenchmarkState& state) = 0;
+};
+
+/**
+ * Summary statistics over the per-iteration times of all repetitions of one benchmark.
+ */
+struct BenchmarkStatistics {
+    /**
+     * Computes the statistics of "samples", which must not be empty. The standard deviation is
+     * the sample standard deviation, and is zero when there is only one sample.
+     */
+    static BenchmarkStatistics compute(std::vector<double> samples);
+
+    double min = 0;
+    double max = 0;
+    double mean = 0;
+    double median = 0;
+    double stddev = 0;
+};
+
+/**
+ * The measurements collected for one benchmark.
+ */
+struct BenchmarkResult {
+    BSONObj toBSON() const;
+
+    std::string suiteName;
+    std::string benchmarkName;
+
+    // Number of iterations in every timed repetition.
+    std::int64_t iterations = 0;
+
+    // Nanoseconds per iteration, one entry per repetition.
+    std::vector<double> nanosPerIteration;
+
+    // Work reported through BenchmarkState in the last repetition, per iteration.
+    double itemsPerIteration = 0;
+    double bytesPerIteration = 0;
+};
+
+struct BenchmarkOptions {
+    // Only benchmarks whose "<suite>.<name>" contains this string are run.
+    std::string filter;
+
+    // Number of timed repetitions for each benchmark.
+    int repetitions = 5;
+
+    // Minimum duration of one repetition, used to calibrate the iteration count.
+    stdx::chrono::milliseconds minTime{100};
+
+    // If true, print the names of the matching benchmarks instead of running them.
+    bool listOnly = false;
+
+    // "text" or "json".
+    std::string format = "text";
+
+    // If not empty, write the report to this file instead of standard output.
+    std::string outputFile;
+};
+
+/**
+ * Runs a single registered benchmark: calibrates the iteration count, then times
+ * options.repetitions repetitions.
+ */
+BenchmarkResult runBenchmark(const std::string& suiteName,
+                             const std::string& benchmarkName,
+                             const Benchmark::Factory& factory,
+                             const BenchmarkOptions& options);
+
+/**
+ * Runs every registered benchmark that matches options.filter and writes the report. Returns
+ * the process exit code.
+ */
+int runBenchmarks(const BenchmarkOptions& options);
+
+}  // namespace unittest
+}  // namespace mongo
@@ -0,0 +1,93 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "mongo/base/initializer.h"
+#include "mongo/base/parse_number.h"
+#include "mongo/base/string_data.h"
+#include "mongo/unittest/benchmark.h"
+#include "mongo/util/signal_handlers_synchronous.h"
+
+namespace {
+
+const char kUsage[] =
+    "Usage: <benchmark> [options]\n"
+    "  --filter=<substring>    only run benchmarks whose <suite>.<name> contains <substring>\n"
+    "  --repetitions=<n>       timed repetitions per benchmark (default 5)\n"
+    "  --minTimeMillis=<n>     minimum duration of one repetition (default 100)\n"
+    "  --format=<text|json>    report format (default text)\n"
+    "  --out=<file>            write the report to <file> instead of standard output\n"
+    "  --list                  print the matching benchmark names and exit\n";
+
+bool parseIntOption(mongo::StringData arg, mongo::StringData prefix, int* out) {
+    if (!arg.startsWith(prefix)) {
+        return false;
+    }
+    int value;
+    if (!mongo::parseNumberFromString(arg.substr(prefix.size()), &value).isOK() || value <= 0) {
+        std::cerr << "invalid value for " << prefix << " " << arg.substr(prefix.size()) << '\n';
+        std::exit(EXIT_FAILURE);
+    }
+    *out = value;
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv, char** envp) {
+    ::mongo::clearSignalMask();
+    ::mongo::setupSynchronousSignalHandlers();
+    ::mongo::runGlobalInitializersOrDie(argc, argv, envp);
+
+    ::mongo::unittest::BenchmarkOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const ::mongo::StringData arg(argv[i]);
+        int minTimeMillis;
+        if (arg.startsWith("--filter=")) {
+            options.filter = arg.substr(9).toString();
+        } else if (parseIntOption(arg, "--repetitions=", &options.repetitions)) {
+        } else if (parseIntOption(arg, "--minTimeMillis=", &minTimeMillis)) {
+            options.minTime = ::mongo::stdx::chrono::milliseconds(minTimeMillis);
+        } else if (arg == "--format=text" || arg == "--format=json") {
+            options.format = arg.substr(9).toString();
+        } else if (arg.startsWith("--out=")) {
+            options.outputFile = arg.substr(6).toString();
+        } else if (arg == "--list") {
+            options.listOnly = true;
+        } else {
+            std::cerr << kUsage;
+            return arg == "--help" ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    return ::mongo::unittest::runBenchmarks(options);
+}
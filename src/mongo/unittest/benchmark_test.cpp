@@ -0,0 +1,156 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/unittest/benchmark.h"
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace unittest {
+namespace {
+
+TEST(BenchmarkStatisticsTest, OddNumberOfSamples) {
+    const auto stats = BenchmarkStatistics::compute({4, 1, 7});
+    ASSERT_EQUALS(1, stats.min);
+    ASSERT_EQUALS(7, stats.max);
+    ASSERT_EQUALS(4, stats.median);
+    ASSERT_EQUALS(4, stats.mean);
+    ASSERT_EQUALS(3, stats.stddev);
+}
+
+TEST(BenchmarkStatisticsTest, EvenNumberOfSamples) {
+    const auto stats = BenchmarkStatistics::compute({10, 2, 4, 8});
+    ASSERT_EQUALS(2, stats.min);
+    ASSERT_EQUALS(10, stats.max);
+    ASSERT_EQUALS(6, stats.median);
+    ASSERT_EQUALS(6, stats.mean);
+}
+
+TEST(BenchmarkStatisticsTest, SingleSampleHasNoDeviation) {
+    const auto stats = BenchmarkStatistics::compute({5});
+    ASSERT_EQUALS(5, stats.median);
+    ASSERT_EQUALS(0, stats.stddev);
+}
+
+TEST(BenchmarkStateTest, RunsRequestedIterations) {
+    BenchmarkState state(3);
+    int runs = 0;
+    while (state.keepRunning()) {
+        ++runs;
+    }
+    ASSERT_EQUALS(3, runs);
+    ASSERT_TRUE(state.finished());
+    ASSERT_FALSE(state.keepRunning());
+}
+
+TEST(BenchmarkStateTest, ZeroIterations) {
+    BenchmarkState state(0);
+    ASSERT_FALSE(state.keepRunning());
+    ASSERT_TRUE(state.finished());
+    ASSERT_TRUE(state.elapsed() >= BenchmarkState::Clock::duration::zero());
+}
+
+struct CountingBenchmark : public Benchmark {
+    static int setUps;
+    static int tearDowns;
+    static std::int64_t iterationsRun;
+
+    void setUp() override {
+        ++setUps;
+    }
+
+    void tearDown() override {
+        ++tearDowns;
+    }
+
+    void _doBenchmark(BenchmarkState& state) override {
+        while (state.keepRunning()) {
+            ++iterationsRun;
+        }
+        state.setItemsProcessed(2 * state.iterations());
+    }
+};
+
+int CountingBenchmark::setUps = 0;
+int CountingBenchmark::tearDowns = 0;
+std::int64_t CountingBenchmark::iterationsRun = 0;
+
+TEST(BenchmarkRunnerTest, CalibratesAndRepeats) {
+    BenchmarkOptions options;
+    options.repetitions = 3;
+    options.minTime = stdx::chrono::milliseconds(1);
+
+    const auto result = runBenchmark("Suite", "Counting", [] {
+        return std::unique_ptr<Benchmark>(new CountingBenchmark());
+    }, options);
+
+    ASSERT_EQUALS("Suite", result.suiteName);
+    ASSERT_EQUALS("Counting", result.benchmarkName);
+    ASSERT_GREATER_THAN(result.iterations, 1);
+    ASSERT_EQUALS(3U, result.nanosPerIteration.size());
+    ASSERT_EQUALS(2, result.itemsPerIteration);
+
+    // Every calibration run and every repetition gets its own setUp() and tearDown().
+    ASSERT_GREATER_THAN(CountingBenchmark::setUps, 3);
+    ASSERT_EQUALS(CountingBenchmark::setUps, CountingBenchmark::tearDowns);
+    ASSERT_GREATER_THAN_OR_EQUALS(CountingBenchmark::iterationsRun, 3 * result.iterations);
+
+    const BSONObj obj = result.toBSON();
+    ASSERT_EQUALS(3, obj["repetitions"].numberInt());
+    ASSERT_EQUALS(3, obj["nanosPerIteration"]["samples"].Array().size());
+    ASSERT_TRUE(obj["itemsPerSecond"].isNumber());
+    ASSERT_FALSE(obj.hasField("bytesPerSecond"));
+}
+
+struct EarlyReturnBenchmark : public Benchmark {
+    void _doBenchmark(BenchmarkState& state) override {
+        state.keepRunning();
+    }
+};
+
+TEST(BenchmarkRunnerTest, BenchmarkMustFinishIterating) {
+    BenchmarkOptions options;
+    options.repetitions = 1;
+    options.minTime = stdx::chrono::milliseconds(1);
+
+    ASSERT_THROWS_CODE(runBenchmark("Suite",
+                                    "EarlyReturn",
+                                    [] {
+                                        return std::unique_ptr<Benchmark>(
+                                            new EarlyReturnBenchmark());
+                                    },
+                                    options),
+                       UserException,
+                       40653);
+}
+
+}  // namespace
+}  // namespace unittest
+}  // namespace mongo
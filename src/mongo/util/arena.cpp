@@ -0,0 +1,100 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/arena.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include "mongo/util/allocator.h"
+
+namespace mongo {
+
+namespace {
+
+size_t alignUp(size_t bytes) {
+    return (bytes + Arena::kAlignment - 1) & ~(Arena::kAlignment - 1);
+}
+
+}  // namespace
+
+constexpr size_t Arena::kAlignment;
+constexpr size_t Arena::kDefaultBlockSize;
+
+Arena::Arena(size_t blockSize) : _blockSize(alignUp(blockSize)) {}
+
+Arena::~Arena() {
+    for (auto block : _blocks) {
+        std::free(block);
+    }
+}
+
+char* Arena::_newBlock(size_t bytes) {
+    char* block = static_cast<char*>(mongoMalloc(bytes));
+    _blocks.push_back(block);
+    _bytesReserved += bytes;
+    return block;
+}
+
+void* Arena::allocate(size_t bytes) {
+    bytes = alignUp(bytes);
+    if (bytes > _blockSize) {
+        // Large allocations get a block of their own, leaving the current block in use.
+        return _newBlock(bytes);
+    }
+
+    if (static_cast<size_t>(_end - _next) < bytes) {
+        _next = _newBlock(_blockSize);
+        _end = _next + _blockSize;
+    }
+
+    _last = _next;
+    _next += bytes;
+    return _last;
+}
+
+void* Arena::reallocate(void* ptr, size_t oldBytes, size_t newBytes) {
+    if (ptr && ptr == _last) {
+        const size_t alignedBytes = alignUp(newBytes);
+        if (static_cast<size_t>(_end - _last) >= alignedBytes) {
+            _next = _last + alignedBytes;
+            return ptr;
+        }
+    }
+
+    void* newPtr = allocate(newBytes);
+    if (ptr) {
+        std::memcpy(newPtr, ptr, std::min(oldBytes, newBytes));
+    }
+    return newPtr;
+}
+
+}  // namespace mongo
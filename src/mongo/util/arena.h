@@ -0,0 +1,94 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+
+namespace mongo {
+
+/**
+ * A bump allocator for memory whose lifetime is that of the Arena itself, such as the transient
+ * buffers of a single operation. Allocations are carved out of blocks obtained from the system
+ * allocator, and are never freed individually: all the blocks are released together when the
+ * Arena is destroyed.
+ *
+ * Allocations are aligned to kAlignment bytes. Requests larger than a block get a block of their
+ * own, so that they do not waste the rest of the current block.
+ *
+ * This class is not thread safe.
+ */
+class Arena {
+    MONGO_DISALLOW_COPYING(Arena);
+
+public:
+    static constexpr size_t kAlignment = 16;
+    static constexpr size_t kDefaultBlockSize = 32 * 1024;
+
+    explicit Arena(size_t blockSize = kDefaultBlockSize);
+    ~Arena();
+
+    /**
+     * Returns 'bytes' of uninitialized memory, valid until the Arena is destroyed.
+     */
+    void* allocate(size_t bytes);
+
+    /**
+     * Returns 'newBytes' of memory starting with the first 'oldBytes' of 'ptr', which must be the
+     * result of an earlier allocation of 'oldBytes' from this Arena, or null. The allocation is
+     * extended in place if it is the last one made and the current block has room, and copied into
+     * a new allocation otherwise.
+     */
+    void* reallocate(void* ptr, size_t oldBytes, size_t newBytes);
+
+    /**
+     * Returns the number of bytes obtained from the system allocator. Since nothing is freed
+     * before the Arena is destroyed, this is also the peak memory usage of the Arena.
+     */
+    size_t bytesReserved() const {
+        return _bytesReserved;
+    }
+
+private:
+    char* _newBlock(size_t bytes);
+
+    const size_t _blockSize;
+    std::vector<char*> _blocks;
+
+    // The unused end of the current block, and the start of the last allocation made in it.
+    char* _next = nullptr;
+    char* _end = nullptr;
+    char* _last = nullptr;
+
+    size_t _bytesReserved = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,87 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/arena.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+bool isAligned(void* ptr) {
+    return reinterpret_cast<uintptr_t>(ptr) % Arena::kAlignment == 0;
+}
+
+TEST(ArenaTest, AllocationsAreAlignedAndShareBlocks) {
+    Arena arena(1024);
+    ASSERT_EQ(0U, arena.bytesReserved());
+
+    char* first = static_cast<char*>(arena.allocate(1));
+    char* second = static_cast<char*>(arena.allocate(100));
+    ASSERT(isAligned(first));
+    ASSERT(isAligned(second));
+    ASSERT_EQ(first + Arena::kAlignment, second);
+    ASSERT_EQ(1024U, arena.bytesReserved());
+}
+
+TEST(ArenaTest, LargeAllocationsGetTheirOwnBlock) {
+    Arena arena(1024);
+    char* small = static_cast<char*>(arena.allocate(16));
+    arena.allocate(4096);
+    ASSERT_EQ(1024U + 4096U, arena.bytesReserved());
+
+    // The current block is still used for small allocations.
+    ASSERT_EQ(small + 16, arena.allocate(16));
+    ASSERT_EQ(1024U + 4096U, arena.bytesReserved());
+}
+
+TEST(ArenaTest, ReallocateExtendsTheLastAllocationInPlace) {
+    Arena arena(1024);
+    char* ptr = static_cast<char*>(arena.allocate(16));
+    ASSERT_EQ(ptr, arena.reallocate(ptr, 16, 512));
+    ASSERT_EQ(ptr + 512, arena.allocate(16));
+}
+
+TEST(ArenaTest, ReallocateCopiesWhenItCannotExtend) {
+    Arena arena(1024);
+    char* ptr = static_cast<char*>(arena.allocate(16));
+    std::memcpy(ptr, "0123456789abcdef", 16);
+    arena.allocate(16);
+
+    char* moved = static_cast<char*>(arena.reallocate(ptr, 16, 32));
+    ASSERT_NOT_EQUALS(ptr, moved);
+    ASSERT_EQ(0, std::memcmp(moved, "0123456789abcdef", 16));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -32,6 +32,9 @@
 
 #include "mongo/util/concurrency/thread_pool_test_common.h"
 
+#include <algorithm>
+
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/mutex.h"
@@ -40,6 +43,7 @@
 #include "mongo/util/concurrency/thread_pool_interface.h"
 #include "mongo/util/concurrency/thread_pool_test_fixture.h"
 #include "mongo/util/log.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace {
@@ -210,6 +214,46 @@ COMMON_THREAD_POOL_TEST(RepeatedScheduleDoesntSmashStack) {
     condvar.wait(lk, [&n, depth] { return n == depth; });
 }
 
+COMMON_THREAD_POOL_TEST(ManySmallTasks) {
+    // Each root task schedules the same number of leaf tasks, so that tasks are scheduled both
+    // from outside the pool and from its threads.
+    const std::size_t numRoots = 100;
+    const std::size_t leavesPerRoot = 100;
+    const std::size_t numTasks = numRoots * (leavesPerRoot + 1);
+    auto& pool = getThreadPool();
+    AtomicUInt64 numRun;
+    stdx::mutex mutex;
+    stdx::condition_variable condvar;
+    auto leaf = [&] {
+        if (numRun.addAndFetch(1) == numTasks) {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            condvar.notify_one();
+        }
+    };
+
+    pool.startup();
+    Timer timer;
+    for (std::size_t i = 0; i < numRoots; ++i) {
+        ASSERT_OK(pool.schedule([&] {
+            for (std::size_t j = 0; j < leavesPerRoot; ++j) {
+                ASSERT_OK(pool.schedule(leaf));
+            }
+            leaf();
+        }));
+    }
+
+    {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        condvar.wait(lk, [&] { return numRun.load() == numTasks; });
+    }
+    const long long micros = std::max(timer.micros(), 1LL);
+    log() << "Ran " << numTasks << " small tasks in " << micros << " microseconds, "
+          << numTasks * 1000000 / micros << " tasks per second";
+
+    pool.shutdown();
+    pool.join();
+}
+
 }  // namespace
 
 void addTestsForThreadPool(const std::string& suiteName, ThreadPoolFactory makeThreadPool) {
@@ -0,0 +1,109 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/benchmark.h"
+#include "mongo/util/concurrency/ticketholder.h"
+
+namespace mongo {
+namespace {
+
+using unittest::benchmarkDoNotOptimize;
+
+BENCHMARK(TicketHolder, TryAcquireRelease) {
+    TicketHolder holder(128);
+    while (state.keepRunning()) {
+        benchmarkDoNotOptimize(holder.tryAcquire());
+        holder.release();
+    }
+}
+
+BENCHMARK(TicketHolder, WaitForTicketRelease) {
+    TicketHolder holder(128);
+    while (state.keepRunning()) {
+        holder.waitForTicket();
+        holder.release();
+    }
+}
+
+/**
+ * Runs the benchmark thread against background threads that continuously acquire and release
+ * tickets from the same holder. With kNumTickets smaller than the number of threads, some
+ * acquisitions have to wait.
+ */
+template <int kNumTickets>
+class ContendedTicketHolderBenchmark : public unittest::Benchmark {
+protected:
+    static const int kNumBackgroundThreads = 4;
+
+    void setUp() override {
+        for (int i = 0; i < kNumBackgroundThreads; ++i) {
+            _threads.emplace_back([this] {
+                while (!_stop.load()) {
+                    ScopedTicket ticket(&holder);
+                }
+            });
+        }
+    }
+
+    void tearDown() override {
+        _stop.store(true);
+        for (auto& thread : _threads) {
+            thread.join();
+        }
+    }
+
+    TicketHolder holder{kNumTickets};
+
+private:
+    AtomicBool _stop{false};
+    std::vector<stdx::thread> _threads;
+};
+
+using PlentifulTickets = ContendedTicketHolderBenchmark<128>;
+using ScarceTickets = ContendedTicketHolderBenchmark<2>;
+
+BENCHMARK_F(PlentifulTickets, ScopedTicket) {
+    while (state.keepRunning()) {
+        ScopedTicket ticket(&holder);
+    }
+}
+
+BENCHMARK_F(ScarceTickets, ScopedTicket) {
+    while (state.keepRunning()) {
+        ScopedTicket ticket(&holder);
+    }
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,351 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kExecutor
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/concurrency/work_stealing_thread_pool.h"
+
+#include "mongo/base/status.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/concurrency/threadlocal.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+namespace {
+
+// Counter used to assign unique names to otherwise-unnamed thread pools.
+AtomicInt32 nextUnnamedThreadPoolId{1};
+
+// The pool and index of the worker running on this thread, if any.
+MONGO_TRIVIALLY_CONSTRUCTIBLE_THREAD_LOCAL const WorkStealingThreadPool* currentPool;
+MONGO_TRIVIALLY_CONSTRUCTIBLE_THREAD_LOCAL size_t currentWorkerIndex;
+
+WorkStealingThreadPool::Options cleanUpOptions(WorkStealingThreadPool::Options&& options) {
+    if (options.poolName.empty()) {
+        options.poolName = str::stream() << "WorkStealingThreadPool"
+                                         << nextUnnamedThreadPoolId.fetchAndAdd(1);
+    }
+    if (options.threadNamePrefix.empty()) {
+        options.threadNamePrefix = str::stream() << options.poolName << '-';
+    }
+    if (options.numThreads < 1) {
+        severe() << "Tried to create pool " << options.poolName << " with " << options.numThreads
+                 << " threads but it needs at least 1";
+        fassertFailed(40661);
+    }
+    return options;
+}
+
+}  // namespace
+
+const int64_t WorkStealingThreadPool::TaskDeque::kCapacity;
+
+bool WorkStealingThreadPool::TaskDeque::push(Task* task) {
+    const int64_t bottom = _bottom.load(std::memory_order_relaxed);
+    const int64_t top = _top.load(std::memory_order_acquire);
+    if (bottom - top >= kCapacity) {
+        return false;
+    }
+    _tasks[bottom % kCapacity].store(task, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    _bottom.store(bottom + 1, std::memory_order_relaxed);
+    return true;
+}
+
+WorkStealingThreadPool::Task* WorkStealingThreadPool::TaskDeque::pop() {
+    const int64_t bottom = _bottom.load(std::memory_order_relaxed) - 1;
+    _bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = _top.load(std::memory_order_relaxed);
+    if (top > bottom) {
+        // The queue was empty.
+        _bottom.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Task* task = _tasks[bottom % kCapacity].load(std::memory_order_relaxed);
+    if (top == bottom) {
+        // This is the last task, which a thief may be taking at the same time.
+        if (!_top.compare_exchange_strong(
+                top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            task = nullptr;
+        }
+        _bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return task;
+}
+
+WorkStealingThreadPool::Task* WorkStealingThreadPool::TaskDeque::steal() {
+    int64_t top = _top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t bottom = _bottom.load(std::memory_order_acquire);
+    if (top >= bottom) {
+        return nullptr;
+    }
+
+    Task* task = _tasks[top % kCapacity].load(std::memory_order_relaxed);
+    if (!_top.compare_exchange_strong(
+            top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    return task;
+}
+
+WorkStealingThreadPool::WorkStealingThreadPool(Options options)
+    : _options(cleanUpOptions(std::move(options))) {
+    for (size_t i = 0; i < _options.numThreads; ++i) {
+        _workers.push_back(stdx::make_unique<Worker>());
+    }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _shutdown_inlock();
+        if (_state == shutdownComplete) {
+            return;
+        }
+    }
+    join();
+}
+
+void WorkStealingThreadPool::startup() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_state != preStart) {
+        severe() << "Attempting to start pool " << _options.poolName
+                 << ", but it has already started";
+        fassertFailed(40659);
+    }
+    _setState_inlock(running);
+    for (size_t i = 0; i < _workers.size(); ++i) {
+        const std::string threadName = str::stream() << _options.threadNamePrefix << i;
+        _workers[i]->thread = stdx::thread(&_workerThreadBody, this, i, threadName);
+    }
+}
+
+void WorkStealingThreadPool::shutdown() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _shutdown_inlock();
+}
+
+void WorkStealingThreadPool::_shutdown_inlock() {
+    switch (_state) {
+        case preStart:
+        case running:
+            _setState_inlock(joinRequired);
+            _workAvailable.notify_all();
+            return;
+        case joinRequired:
+        case joining:
+        case shutdownComplete:
+            return;
+    }
+    MONGO_UNREACHABLE;
+}
+
+void WorkStealingThreadPool::join() {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _stateChange.wait(lk, [this] {
+        switch (_state) {
+            case preStart:
+            case running:
+                return false;
+            case joinRequired:
+                return true;
+            case joining:
+            case shutdownComplete:
+                severe() << "Attempted to join pool " << _options.poolName << " more than once";
+                fassertFailed(40660);
+        }
+        MONGO_UNREACHABLE;
+    });
+    _setState_inlock(joining);
+    lk.unlock();
+
+    for (auto&& worker : _workers) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+
+    // The workers only exit once every task has run, but a pool that never started has no
+    // workers, so the joining thread runs the tasks itself.
+    while (_numQueued.load() > 0) {
+        if (auto task = _takeSharedTask()) {
+            _runTask(std::move(task));
+        } else {
+            stdx::this_thread::yield();
+        }
+    }
+
+    lk.lock();
+    _setState_inlock(shutdownComplete);
+}
+
+Status WorkStealingThreadPool::schedule(Task task) {
+    // Counting the task before checking the state guarantees that a shutting down pool either
+    // rejects it or waits for it to run.
+    _numQueued.fetchAndAdd(1);
+    const LifecycleState state = _atomicState.load();
+    if (state != preStart && state != running) {
+        _numQueued.fetchAndSubtract(1);
+        return Status(ErrorCodes::ShutdownInProgress,
+                      str::stream() << "Shutdown of thread pool " << _options.poolName
+                                    << " in progress");
+    }
+
+    auto ownedTask = stdx::make_unique<Task>(std::move(task));
+    if (currentPool == this && _workers[currentWorkerIndex]->tasks.push(ownedTask.get())) {
+        ownedTask.release();
+    } else {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _sharedTasks.push_back(std::move(ownedTask));
+        _numSharedTasks.fetchAndAdd(1);
+    }
+
+    if (_numSleepers.load() > 0) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _workAvailable.notify_one();
+    }
+    return Status::OK();
+}
+
+WorkStealingThreadPool::Stats WorkStealingThreadPool::getStats() const {
+    Stats stats;
+    stats.numThreads = _workers.size();
+    stats.numPendingTasks = _numQueued.load();
+    stats.numStolenTasks = _numStolenTasks.load();
+    return stats;
+}
+
+void WorkStealingThreadPool::_workerThreadBody(WorkStealingThreadPool* pool,
+                                               size_t workerIndex,
+                                               const std::string& threadName) {
+    setThreadName(threadName);
+    pool->_options.onCreateThread(threadName);
+    LOG(1) << "starting thread in pool " << pool->_options.poolName;
+    pool->_consumeTasks(workerIndex);
+    LOG(1) << "shutting down thread in pool " << pool->_options.poolName;
+}
+
+void WorkStealingThreadPool::_consumeTasks(size_t workerIndex) {
+    currentPool = this;
+    currentWorkerIndex = workerIndex;
+    ON_BLOCK_EXIT([] { currentPool = nullptr; });
+
+    while (true) {
+        if (auto task = _takeTask(workerIndex)) {
+            _runTask(std::move(task));
+            continue;
+        }
+
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        if (_numQueued.load() > 0) {
+            // A task is being queued by a concurrent call to schedule().
+            lk.unlock();
+            stdx::this_thread::yield();
+            continue;
+        }
+        if (_state != running) {
+            return;
+        }
+
+        // Registering as a sleeper before checking for tasks pairs with schedule(), which queues
+        // its task before checking for sleepers, so that one of them always sees the other.
+        _numSleepers.fetchAndAdd(1);
+        MONGO_IDLE_THREAD_BLOCK;
+        _workAvailable.wait(lk, [this] { return _numQueued.load() > 0 || _state != running; });
+        _numSleepers.fetchAndSubtract(1);
+    }
+}
+
+std::unique_ptr<WorkStealingThreadPool::Task> WorkStealingThreadPool::_takeTask(
+    size_t workerIndex) {
+    if (Task* task = _workers[workerIndex]->tasks.pop()) {
+        _numQueued.fetchAndSubtract(1);
+        return std::unique_ptr<Task>(task);
+    }
+
+    if (auto task = _takeSharedTask()) {
+        return task;
+    }
+
+    for (size_t i = 1; i < _workers.size(); ++i) {
+        if (Task* task = _workers[(workerIndex + i) % _workers.size()]->tasks.steal()) {
+            _numQueued.fetchAndSubtract(1);
+            _numStolenTasks.fetchAndAdd(1);
+            return std::unique_ptr<Task>(task);
+        }
+    }
+    return nullptr;
+}
+
+std::unique_ptr<WorkStealingThreadPool::Task> WorkStealingThreadPool::_takeSharedTask() {
+    if (_numSharedTasks.load() == 0) {
+        return nullptr;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_sharedTasks.empty()) {
+        return nullptr;
+    }
+    auto task = std::move(_sharedTasks.front());
+    _sharedTasks.pop_front();
+    _numSharedTasks.fetchAndSubtract(1);
+    _numQueued.fetchAndSubtract(1);
+    return task;
+}
+
+void WorkStealingThreadPool::_runTask(std::unique_ptr<Task> task) {
+    try {
+        (*task)();
+    } catch (...) {
+        severe() << "Exception escaped task in thread pool " << _options.poolName << ": "
+                 << exceptionToStatus();
+        std::terminate();
+    }
+}
+
+void WorkStealingThreadPool::_setState_inlock(LifecycleState newState) {
+    if (newState == _state) {
+        return;
+    }
+    _state = newState;
+    _atomicState.store(newState);
+    _stateChange.notify_all();
+}
+
+}  // namespace mongo
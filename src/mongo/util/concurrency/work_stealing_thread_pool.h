@@ -0,0 +1,220 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/thread_pool_interface.h"
+
+namespace mongo {
+
+class Status;
+
+/**
+ * A thread pool with a fixed number of workers, each with its own queue of tasks, for workloads
+ * made of many small tasks, often scheduled by other tasks.
+ *
+ * Tasks scheduled by a worker of the pool go to the back of that worker's queue without taking
+ * any lock. Tasks scheduled from other threads go to a shared queue protected by a mutex. A worker
+ * runs the most recently queued task of its own queue first, then takes tasks from the shared
+ * queue, and when both are empty it steals the oldest task of another worker's queue.
+ *
+ * Unlike ThreadPool, the pool does not grow or shrink, and it offers no waitForIdle().
+ */
+class WorkStealingThreadPool final : public ThreadPoolInterface {
+    MONGO_DISALLOW_COPYING(WorkStealingThreadPool);
+
+public:
+    /**
+     * Structure used to configure an instance of WorkStealingThreadPool.
+     */
+    struct Options {
+        // Name of the thread pool. If this string is empty, the pool will be assigned a name
+        // unique to the current process.
+        std::string poolName;
+
+        // Prefix used to name threads for logging purposes. An integer will be appended to this
+        // string to create the thread name for each thread in the pool. If you leave this empty,
+        // the prefix will be the pool name followed by a hyphen.
+        std::string threadNamePrefix;
+
+        // Number of worker threads, all created at startup.
+        size_t numThreads = 8;
+
+        // This function is run before each worker thread begins consuming tasks.
+        using OnCreateThreadFn = stdx::function<void(const std::string& threadName)>;
+        OnCreateThreadFn onCreateThread = [](const std::string&) {};
+    };
+
+    /**
+     * Structure used to return information about the thread pool via getStats().
+     */
+    struct Stats {
+        size_t numThreads;
+
+        // The number of tasks waiting to be executed by the pool.
+        size_t numPendingTasks;
+
+        // The number of tasks that a worker took from the queue of another worker.
+        uint64_t numStolenTasks;
+    };
+
+    explicit WorkStealingThreadPool(Options options);
+
+    ~WorkStealingThreadPool() override;
+
+    void startup() override;
+    void shutdown() override;
+    void join() override;
+    Status schedule(Task task) override;
+
+    Stats getStats() const;
+
+private:
+    /**
+     * A bounded double-ended queue of tasks, after Chase and Lev. Only the worker owning the queue
+     * pushes and pops at the back, while any thread may steal from the front, and none of these
+     * take a lock.
+     */
+    class TaskDeque {
+        MONGO_DISALLOW_COPYING(TaskDeque);
+
+    public:
+        static const int64_t kCapacity = 1024;
+
+        TaskDeque() = default;
+
+        /**
+         * Adds 'task' at the back. Returns false, leaving 'task' to the caller, if the queue is
+         * full. Only called by the owner.
+         */
+        bool push(Task* task);
+
+        /**
+         * Removes and returns the task at the back, or null if the queue is empty. Only called by
+         * the owner.
+         */
+        Task* pop();
+
+        /**
+         * Removes and returns the task at the front, or null if the queue is empty or another
+         * thread took that task first.
+         */
+        Task* steal();
+
+    private:
+        std::atomic<int64_t> _top{0};     // NOLINT
+        std::atomic<int64_t> _bottom{0};  // NOLINT
+        std::array<std::atomic<Task*>, kCapacity> _tasks;  // NOLINT
+    };
+
+    struct Worker {
+        TaskDeque tasks;
+        stdx::thread thread;
+    };
+
+    /**
+     * See ThreadPool::LifecycleState.
+     */
+    enum LifecycleState { preStart, running, joinRequired, joining, shutdownComplete };
+
+    static void _workerThreadBody(WorkStealingThreadPool* pool,
+                                  size_t workerIndex,
+                                  const std::string& threadName);
+
+    /**
+     * This is the run loop of the worker at 'workerIndex'. It returns once the pool is shutting
+     * down and no task is left.
+     */
+    void _consumeTasks(size_t workerIndex);
+
+    /**
+     * Takes a task for the worker at 'workerIndex', from its own queue, the shared queue or the
+     * queue of another worker, in this order. Returns null if none was found.
+     */
+    std::unique_ptr<Task> _takeTask(size_t workerIndex);
+
+    /**
+     * Takes the oldest task of the shared queue, or returns null if that is empty.
+     */
+    std::unique_ptr<Task> _takeSharedTask();
+
+    void _runTask(std::unique_ptr<Task> task);
+
+    void _shutdown_inlock();
+
+    void _setState_inlock(LifecycleState newState);
+
+    const Options _options;
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+
+    // Tasks scheduled but not yet taken by a thread, including those about to be queued by a
+    // concurrent call to schedule(). Workers only exit once this drops to zero after shutdown.
+    AtomicUInt64 _numQueued;
+
+    // Workers sleeping on _workAvailable, which schedule() only signals when there are some.
+    AtomicUInt32 _numSleepers;
+
+    // The size of _sharedTasks, so that workers only take _mutex when it has tasks.
+    AtomicUInt64 _numSharedTasks;
+
+    AtomicUInt64 _numStolenTasks;
+
+    // Mirrors _state, for schedule() to check without taking _mutex.
+    std::atomic<LifecycleState> _atomicState{preStart};  // NOLINT
+
+    // Guards _state, _sharedTasks and the waits on the condition variables.
+    mutable stdx::mutex _mutex;
+
+    LifecycleState _state = preStart;
+
+    // Tasks scheduled from outside the pool's workers, or by a worker whose own queue was full.
+    std::deque<std::unique_ptr<Task>> _sharedTasks;
+
+    // Signaled when a task is queued while workers sleep, and when the pool shuts down.
+    stdx::condition_variable _workAvailable;
+
+    // Signaled whenever _state changes.
+    stdx::condition_variable _stateChange;
+};
+
+}  // namespace mongo
@@ -0,0 +1,121 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/concurrency/work_stealing_thread_pool.h"
+
+#include "mongo/base/init.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/unittest/death_test.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/thread_pool_test_common.h"
+
+namespace {
+using namespace mongo;
+
+MONGO_INITIALIZER(WorkStealingThreadPoolCommonTests)(InitializerContext*) {
+    addTestsForThreadPool("WorkStealingThreadPoolCommon", []() {
+        return stdx::make_unique<WorkStealingThreadPool>(WorkStealingThreadPool::Options());
+    });
+    return Status::OK();
+}
+
+WorkStealingThreadPool::Options makeOptions(size_t numThreads) {
+    WorkStealingThreadPool::Options options;
+    options.numThreads = numThreads;
+    return options;
+}
+
+TEST(WorkStealingThreadPoolTest, IdleWorkersStealTasksFromABusyWorker) {
+    WorkStealingThreadPool pool(makeOptions(4));
+    pool.startup();
+
+    // The root task queues its children on its own worker and then waits for them, so all of
+    // them must be run by the other workers.
+    const size_t numChildren = 50;
+    AtomicUInt64 numRun;
+    stdx::mutex mutex;
+    stdx::condition_variable condvar;
+    ASSERT_OK(pool.schedule([&] {
+        for (size_t i = 0; i < numChildren; ++i) {
+            ASSERT_OK(pool.schedule([&] {
+                if (numRun.addAndFetch(1) == numChildren) {
+                    stdx::lock_guard<stdx::mutex> lk(mutex);
+                    condvar.notify_all();
+                }
+            }));
+        }
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        condvar.wait(lk, [&] { return numRun.load() == numChildren; });
+    }));
+
+    pool.shutdown();
+    pool.join();
+    ASSERT_EQ(numChildren, numRun.load());
+    ASSERT_EQ(numChildren, pool.getStats().numStolenTasks);
+    ASSERT_EQ(0U, pool.getStats().numPendingTasks);
+}
+
+TEST(WorkStealingThreadPoolTest, TasksBeyondTheQueueCapacityAreShared) {
+    WorkStealingThreadPool pool(makeOptions(1));
+    pool.startup();
+
+    const size_t numChildren = 3000;
+    AtomicUInt64 numRun;
+    ASSERT_OK(pool.schedule([&] {
+        for (size_t i = 0; i < numChildren; ++i) {
+            ASSERT_OK(pool.schedule([&] { numRun.addAndFetch(1); }));
+        }
+    }));
+
+    pool.shutdown();
+    pool.join();
+    ASSERT_EQ(numChildren, numRun.load());
+}
+
+TEST(WorkStealingThreadPoolTest, TasksScheduledWhileShuttingDownFromAWorkerAreRejected) {
+    WorkStealingThreadPool pool(makeOptions(2));
+    Status status = Status::OK();
+    ASSERT_OK(pool.schedule([&] {
+        pool.shutdown();
+        status = pool.schedule([] {});
+    }));
+    pool.startup();
+    pool.join();
+    ASSERT_EQ(ErrorCodes::ShutdownInProgress, status);
+}
+
+DEATH_TEST(WorkStealingThreadPoolTest, NoThreadsDies, "but it needs at least 1") {
+    WorkStealingThreadPool pool(makeOptions(0));
+}
+
+}  // namespace
@@ -152,6 +152,42 @@ TEST(DecorableTest, ThrowingConstructor) {
     ASSERT_EQ(1, numDestructedAs);
 }
 
+TEST(DecorableTest, TrivialDecorationsAreValueInitialized) {
+    struct Trivial {
+        int a;
+        double b;
+        char c[13];
+    };
+
+    numConstructedAs = 0;
+    numDestructedAs = 0;
+    DecorationRegistry registry;
+    const auto trivial = registry.declareDecoration<Trivial>();
+    const auto dd1 = registry.declareDecoration<A>();
+    const auto number = registry.declareDecoration<long long>();
+
+    for (int i = 0; i < 10; ++i) {
+        DecorationContainer d(&registry);
+        ASSERT_EQ(0, d.getDecoration(trivial).a);
+        ASSERT_EQ(0.0, d.getDecoration(trivial).b);
+        for (auto c : d.getDecoration(trivial).c) {
+            ASSERT_EQ(0, c);
+        }
+        ASSERT_EQ(0, d.getDecoration(dd1).value);
+        ASSERT_EQ(0, d.getDecoration(number));
+
+        // Dirty the decorations so that later iterations would notice if reused memory were not
+        // initialized.
+        d.getDecoration(trivial).a = 1;
+        d.getDecoration(trivial).b = 2;
+        d.getDecoration(trivial).c[12] = 3;
+        d.getDecoration(dd1).value = 4;
+        d.getDecoration(number) = 5;
+    }
+    ASSERT_EQ(10, numConstructedAs);
+    ASSERT_EQ(10, numDestructedAs);
+}
+
 TEST(DecorableTest, Alignment) {
     DecorationRegistry registry;
     const auto firstChar = registry.declareDecoration<char>();
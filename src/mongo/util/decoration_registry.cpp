@@ -30,6 +30,8 @@
 
 #include "mongo/util/decoration_registry.h"
 
+#include <cstring>
+
 namespace mongo {
 
 DecorationContainer::DecorationDescriptor DecorationRegistry::declareDecoration(
@@ -42,22 +44,35 @@ DecorationContainer::DecorationDescriptor DecorationRegistry::declareDecoration(
         _totalSizeBytes += alignBytes - misalignment;
     }
     DecorationContainer::DecorationDescriptor result(_totalSizeBytes);
-    _decorationInfo.push_back(DecorationInfo(result, constructor, destructor));
+    if (constructor || destructor) {
+        _decorationInfo.push_back(DecorationInfo(result, constructor, destructor));
+    }
     _totalSizeBytes += sizeBytes;
     return result;
 }
 
 void DecorationRegistry::construct(DecorationContainer* decorable) const {
+    // Value initializes every decoration declared without a constructor in one pass.
+    if (_totalSizeBytes) {
+        memset(decorable->getDecoration(DecorationContainer::DecorationDescriptor(0)),
+               0,
+               _totalSizeBytes);
+    }
+
     auto iter = _decorationInfo.cbegin();
     try {
         for (; iter != _decorationInfo.cend(); ++iter) {
-            iter->constructor(decorable->getDecoration(iter->descriptor));
+            if (iter->constructor) {
+                iter->constructor(decorable->getDecoration(iter->descriptor));
+            }
         }
     } catch (...) {
         try {
             while (iter != _decorationInfo.cbegin()) {
                 --iter;
-                iter->destructor(decorable->getDecoration(iter->descriptor));
+                if (iter->destructor) {
+                    iter->destructor(decorable->getDecoration(iter->descriptor));
+                }
             }
         } catch (...) {
             std::terminate();
@@ -72,7 +87,9 @@ void DecorationRegistry::destruct(DecorationContainer* decorable) const {
                                                           end = _decorationInfo.rend();
              iter != end;
              ++iter) {
-            iter->destructor(decorable->getDecoration(iter->descriptor));
+            if (iter->destructor) {
+                iter->destructor(decorable->getDecoration(iter->descriptor));
+            }
         }
     } catch (...) {
         std::terminate();
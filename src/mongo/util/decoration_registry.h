@@ -56,6 +56,10 @@ public:
      * Declares a decoration of type T, constructed with T's default constructor, and
      * returns a descriptor for accessing that decoration.
      *
+     * Decorations of trivially default constructible types are value initialized by zeroing
+     * them, and those of trivially destructible types are not visited on destruction, so a
+     * DecorationContainer only calls out to constructors and destructors which do something.
+     *
      * NOTE: T's destructor must not throw exceptions.
      */
     template <typename T>
@@ -63,7 +67,10 @@ public:
         MONGO_STATIC_ASSERT_MSG(std::is_nothrow_destructible<T>::value,
                                 "Decorations must be nothrow destructible");
         return DecorationContainer::DecorationDescriptorWithType<T>(std::move(declareDecoration(
-            sizeof(T), std::alignment_of<T>::value, &constructAt<T>, &destructAt<T>)));
+            sizeof(T),
+            std::alignment_of<T>::value,
+            std::is_trivially_default_constructible<T>::value ? nullptr : &constructAt<T>,
+            std::is_trivially_destructible<T>::value ? nullptr : &destructAt<T>)));
     }
 
     size_t getDecorationBufferSizeBytes() const {
@@ -89,12 +96,12 @@ private:
     /**
      * Function that constructs (initializes) a single instance of a decoration.
      */
-    using DecorationConstructorFn = stdx::function<void(void*)>;
+    using DecorationConstructorFn = void (*)(void*);
 
     /**
      * Function that destructs (deinitializes) a single instance of a decoration.
      */
-    using DecorationDestructorFn = stdx::function<void(void*)>;
+    using DecorationDestructorFn = void (*)(void*);
 
     struct DecorationInfo {
         DecorationInfo() {}
@@ -121,7 +128,8 @@ private:
 
     /**
      * Declares a decoration with given "constructor" and "destructor" functions,
-     * of "sizeBytes" bytes.
+     * of "sizeBytes" bytes. A null "constructor" means zeroing the decoration initializes it,
+     * and a null "destructor" means it needs no destruction.
      *
      * NOTE: "destructor" must not throw exceptions.
      */
@@ -130,6 +138,7 @@ private:
                                                                 DecorationConstructorFn constructor,
                                                                 DecorationDestructorFn destructor);
 
+    // Only the decorations with a constructor or a destructor to run, in declaration order.
     DecorationInfoVector _decorationInfo;
     size_t _totalSizeBytes{0};
 };
@@ -0,0 +1,177 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kControl
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/huge_page_arena.h"
+
+#include <algorithm>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#ifdef __linux__
+#include "mongo/util/procparser.h"
+#endif
+
+namespace mongo {
+namespace {
+
+size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+#ifdef __linux__
+const std::vector<StringData> kHugePageMemInfoKeys = {"AnonHugePages"_sd,
+                                                      "HugePages_Free"_sd,
+                                                      "HugePages_Rsvd"_sd,
+                                                      "HugePages_Surp"_sd,
+                                                      "HugePages_Total"_sd,
+                                                      "Hugepagesize"_sd};
+#endif
+
+}  // namespace
+
+HugePageArena::~HugePageArena() {
+#ifdef __linux__
+    if (_base) {
+        munmap(_base, _reservedBytes);
+    }
+#endif
+}
+
+HugePageArena& HugePageArena::get() {
+    // Leaked, since the allocator may hand out its memory until the process exits.
+    static HugePageArena* arena = new HugePageArena();
+    return *arena;
+}
+
+size_t HugePageArena::getHugePageSize() {
+#ifdef __linux__
+    BSONObjBuilder builder;
+    if (!procparser::parseProcMemInfoFile("/proc/meminfo", {"Hugepagesize"_sd}, &builder).isOK()) {
+        return 0;
+    }
+    return static_cast<size_t>(builder.obj()["Hugepagesize_kb"].safeNumberLong()) * 1024;
+#else
+    return 0;
+#endif
+}
+
+Status HugePageArena::reserve(size_t bytes) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    invariant(!_base);
+
+    _pageSize = getHugePageSize();
+    if (_pageSize == 0) {
+        _reservationStatus = {ErrorCodes::IllegalOperation,
+                              "Explicit huge pages are not supported on this system"};
+        return _reservationStatus;
+    }
+
+#ifdef __linux__
+    size_t length = alignUp(bytes, _pageSize);
+    void* base = mmap(
+        NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (base == MAP_FAILED) {
+        _reservationStatus = {ErrorCodes::ExceededMemoryLimit,
+                              str::stream() << "Failed to reserve " << length / _pageSize
+                                            << " huge pages of "
+                                            << _pageSize
+                                            << " bytes: "
+                                            << errnoWithDescription()
+                                            << "; check /proc/sys/vm/nr_hugepages"};
+        return _reservationStatus;
+    }
+
+    _base = static_cast<char*>(base);
+    _reservedBytes = length;
+#endif
+    return Status::OK();
+}
+
+Status HugePageArena::getReservationStatus() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _reservationStatus;
+}
+
+void* HugePageArena::allocate(size_t size, size_t alignment, size_t* actualSize) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (!_base || size == 0) {
+        return nullptr;
+    }
+
+    // The base is huge page aligned, so only alignments beyond that can leave a gap.
+    uintptr_t next = reinterpret_cast<uintptr_t>(_base) + _usedBytes;
+    size_t start = _usedBytes + (alignUp(next, std::max(alignment, size_t(1))) - next);
+    size_t length = alignUp(size, _pageSize);
+    if (start > _reservedBytes || length > _reservedBytes - start) {
+        return nullptr;
+    }
+
+    _usedBytes = start + length;
+    ++_allocations;
+    *actualSize = length;
+    return _base + start;
+}
+
+void HugePageArena::noteFallback(size_t bytes) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    ++_fallbackAllocations;
+    _fallbackBytes += bytes;
+}
+
+void HugePageArena::appendStats(BSONObjBuilder* builder) const {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        builder->appendNumber("pageSizeBytes", static_cast<long long>(_pageSize));
+        builder->appendNumber("reservedBytes", static_cast<long long>(_reservedBytes));
+        builder->appendNumber("allocatedBytes", static_cast<long long>(_usedBytes));
+        builder->appendNumber("allocations", static_cast<long long>(_allocations));
+        builder->appendNumber("fallbackAllocations",
+                              static_cast<long long>(_fallbackAllocations));
+        builder->appendNumber("fallbackBytes", static_cast<long long>(_fallbackBytes));
+        if (!_reservationStatus.isOK()) {
+            builder->append("reservationError", _reservationStatus.reason());
+        }
+    }
+
+#ifdef __linux__
+    BSONObjBuilder systemBuilder(builder->subobjStart("system"));
+    // Counters the kernel does not report are left out.
+    procparser::parseProcMemInfoFile("/proc/meminfo", kHugePageMemInfoKeys, &systemBuilder);
+#endif
+}
+
+}  // namespace mongo
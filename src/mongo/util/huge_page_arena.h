@@ -0,0 +1,108 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * A region of explicitly reserved huge pages that the process carves its long-lived memory out of.
+ *
+ * The region is mapped once with MAP_HUGETLB, which takes its pages out of the kernel's hugetlb
+ * pool up front, so it either fails at startup or is guaranteed to be backed by huge pages. This
+ * gives the TLB reach of huge pages without transparent huge pages and their compaction stalls.
+ * Memory handed out by allocate() is never returned to the arena.
+ *
+ * When mongod runs with tcmalloc, the arena backs tcmalloc's system allocator, so the WiredTiger
+ * cache, Sorter buffers and large BufBuilders grow into it until it runs out.
+ */
+class HugePageArena {
+    MONGO_DISALLOW_COPYING(HugePageArena);
+
+public:
+    HugePageArena() = default;
+    ~HugePageArena();
+
+    /**
+     * The arena used by the process wide allocator.
+     */
+    static HugePageArena& get();
+
+    /**
+     * Returns the size of the kernel's default huge page, or 0 if the kernel has no hugetlb
+     * support.
+     */
+    static size_t getHugePageSize();
+
+    /**
+     * Maps "bytes", rounded up to whole huge pages. Fails if the hugetlb pool cannot cover the
+     * reservation. May only be called once.
+     */
+    Status reserve(size_t bytes);
+
+    /**
+     * The result of reserve(), or OK if no reservation was attempted.
+     */
+    Status getReservationStatus() const;
+
+    /**
+     * Returns "size" bytes rounded up to whole huge pages and aligned to "alignment", storing the
+     * rounded size in "actualSize". Returns nullptr once the reservation is exhausted, in which
+     * case the caller is expected to fall back to normal pages and report it with noteFallback().
+     */
+    void* allocate(size_t size, size_t alignment, size_t* actualSize);
+
+    void noteFallback(size_t bytes);
+
+    /**
+     * Appends the reservation and its usage, along with the system wide huge page counters.
+     */
+    void appendStats(BSONObjBuilder* builder) const;
+
+private:
+    mutable stdx::mutex _mutex;
+
+    Status _reservationStatus = Status::OK();
+    char* _base = nullptr;
+    size_t _pageSize = 0;
+    size_t _reservedBytes = 0;
+    size_t _usedBytes = 0;
+    size_t _allocations = 0;
+    size_t _fallbackAllocations = 0;
+    size_t _fallbackBytes = 0;
+};
+
+}  // namespace mongo
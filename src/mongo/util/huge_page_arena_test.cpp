@@ -0,0 +1,88 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <cstring>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/huge_page_arena.h"
+
+namespace mongo {
+namespace {
+
+TEST(HugePageArenaTest, UnreservedArenaAllocatesNothing) {
+    HugePageArena arena;
+    size_t actualSize = 0;
+    ASSERT_OK(arena.getReservationStatus());
+    ASSERT(!arena.allocate(4096, 4096, &actualSize));
+}
+
+// The hugetlb pool is usually empty on test machines, so a failed reservation is checked rather
+// than required to succeed.
+TEST(HugePageArenaTest, AllocatesWholePagesUntilExhausted) {
+    const size_t pageSize = HugePageArena::getHugePageSize();
+    HugePageArena arena;
+    Status status = arena.reserve(2 * pageSize);
+    ASSERT_EQ(status, arena.getReservationStatus());
+
+    size_t actualSize = 0;
+    if (!status.isOK()) {
+        ASSERT(!arena.allocate(1, 1, &actualSize));
+        return;
+    }
+
+    char* first = static_cast<char*>(arena.allocate(1, 8192, &actualSize));
+    ASSERT(first);
+    ASSERT_EQ(pageSize, actualSize);
+    ASSERT_EQ(0U, reinterpret_cast<uintptr_t>(first) % pageSize);
+    std::memset(first, 1, actualSize);
+
+    char* second = static_cast<char*>(arena.allocate(pageSize, 8192, &actualSize));
+    ASSERT_EQ(first + pageSize, second);
+    ASSERT(!arena.allocate(1, 8192, &actualSize));
+}
+
+TEST(HugePageArenaTest, StatsCountFallbacks) {
+    HugePageArena arena;
+    arena.noteFallback(1024);
+    arena.noteFallback(2048);
+
+    BSONObjBuilder builder;
+    arena.appendStats(&builder);
+    BSONObj stats = builder.obj();
+    ASSERT_EQ(0, stats["reservedBytes"].numberLong());
+    ASSERT_EQ(0, stats["allocatedBytes"].numberLong());
+    ASSERT_EQ(2, stats["fallbackAllocations"].numberLong());
+    ASSERT_EQ(3072, stats["fallbackBytes"].numberLong());
+    ASSERT(!stats.hasField("reservationError"));
+}
+
+}  // namespace
+}  // namespace mongo
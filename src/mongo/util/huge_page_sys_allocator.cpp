@@ -0,0 +1,114 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kControl
+
+#include "mongo/platform/basic.h"
+
+#include <gperftools/malloc_extension.h>
+
+#include "mongo/base/init.h"
+#include "mongo/db/commands/server_status.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/util/huge_page_arena.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+namespace {
+
+// How much of the hugetlb pool to reserve for tcmalloc at startup. 0 leaves tcmalloc on normal
+// pages.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(hugePageReservationMB, int, 0);
+
+/**
+ * Serves tcmalloc's requests for more memory from the huge page arena, and from the allocator it
+ * replaced once the arena runs out.
+ */
+class HugePageSysAllocator : public SysAllocator {
+public:
+    explicit HugePageSysAllocator(SysAllocator* fallback) : _fallback(fallback) {}
+
+    void* Alloc(size_t size, size_t* actualSize, size_t alignment) override {
+        size_t length;
+        if (void* result = HugePageArena::get().allocate(size, alignment, &length)) {
+            if (actualSize) {
+                *actualSize = length;
+            }
+            return result;
+        }
+
+        HugePageArena::get().noteFallback(size);
+        return _fallback->Alloc(size, actualSize, alignment);
+    }
+
+private:
+    SysAllocator* const _fallback;
+};
+
+// Runs before the storage engine starts, so the WiredTiger cache is allocated from the arena.
+MONGO_INITIALIZER_GENERAL(ReserveHugePages, ("EndStartupOptionHandling"), ("default"))
+(InitializerContext* context) {
+    if (hugePageReservationMB < 0) {
+        return {ErrorCodes::BadValue, "hugePageReservationMB must not be negative"};
+    }
+    if (hugePageReservationMB == 0) {
+        return Status::OK();
+    }
+
+    // A failed reservation only costs performance, so it is reported as a startup warning rather
+    // than preventing startup.
+    auto& arena = HugePageArena::get();
+    if (!arena.reserve(static_cast<size_t>(hugePageReservationMB) * 1024 * 1024).isOK()) {
+        return Status::OK();
+    }
+
+    auto mallocExtension = MallocExtension::instance();
+    mallocExtension->SetSystemAllocator(
+        new HugePageSysAllocator(mallocExtension->GetSystemAllocator()));
+    return Status::OK();
+}
+
+class HugePagesServerStatusSection : public ServerStatusSection {
+public:
+    HugePagesServerStatusSection() : ServerStatusSection("hugePages") {}
+
+    bool includeByDefault() const override {
+        return hugePageReservationMB > 0;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override {
+        BSONObjBuilder builder;
+        HugePageArena::get().appendStats(&builder);
+        return builder.obj();
+    }
+} hugePagesServerStatusSection;
+
+}  // namespace
+}  // namespace mongo
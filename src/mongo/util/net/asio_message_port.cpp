@@ -467,6 +467,10 @@ void ASIOMessagingPort::say(Message& toSend, int responseTo) {
 
 void ASIOMessagingPort::say(const Message& toSend) {
     invariant(!toSend.empty());
+    if (toSend.hasSegments()) {
+        send(toSend.gatherRanges(), nullptr);
+        return;
+    }
     auto buf = toSend.buf();
     if (buf) {
         send(buf, MsgData::ConstView(buf).getLen(), nullptr);
@@ -31,6 +31,7 @@
 #include "mongo/util/net/message.h"
 
 #include "mongo/platform/atomic_word.h"
+#include "mongo/util/assert_util.h"
 
 namespace mongo {
 
@@ -42,4 +43,72 @@ int32_t nextMessageId() {
     return NextMsgId.fetchAndAdd(1);
 }
 
+std::vector<std::pair<char*, int>> Message::gatherRanges() const {
+    std::vector<std::pair<char*, int>> ranges;
+    if (_segments.empty()) {
+        ranges.emplace_back(_buf.get(), size());
+        return ranges;
+    }
+
+    ranges.reserve(_segments.size() + 1);
+    ranges.emplace_back(_buf.get(), _headLength);
+    for (auto&& segment : _segments) {
+        ranges.emplace_back(const_cast<char*>(segment.data), segment.length);
+    }
+    return ranges;
+}
+
+void Message::flatten() {
+    if (_segments.empty()) {
+        return;
+    }
+
+    auto flattened = SharedBuffer::allocate(size());
+    char* out = flattened.get();
+    for (auto&& range : gatherRanges()) {
+        memcpy(out, range.first, range.second);
+        out += range.second;
+    }
+    invariant(out == flattened.get() + size());
+
+    _buf = std::move(flattened);
+    _segments.clear();
+}
+
+void GatherBufBuilder::appendShared(ConstSharedBuffer holder, const char* data, int length) {
+    if (length < kMinSharedLength) {
+        _builder.appendBuf(data, length);
+        return;
+    }
+    _shared.push_back({_builder.len(), {std::move(holder), data, length}});
+    _sharedLength += length;
+}
+
+Message GatherBufBuilder::release() {
+    const int copiedLength = _builder.len();
+    Message message(_builder.release());
+    if (_shared.empty()) {
+        return message;
+    }
+
+    // Interleave the referenced runs with the copied bytes that follow each of them.
+    const char* copied = message.buf();
+    std::vector<Message::Segment> segments;
+    segments.reserve(_shared.size() * 2);
+    for (size_t i = 0; i < _shared.size(); ++i) {
+        segments.push_back(std::move(_shared[i].segment));
+
+        const int end = i + 1 < _shared.size() ? _shared[i + 1].offset : copiedLength;
+        const int start = _shared[i].offset;
+        if (end > start) {
+            segments.push_back({message.sharedBuffer(), copied + start, end - start});
+        }
+    }
+    message.setSegments(_shared.front().offset, std::move(segments));
+
+    _shared.clear();
+    _sharedLength = 0;
+    return message;
+}
+
 }  // namespace mongo
@@ -29,12 +29,17 @@
 #pragma once
 
 #include <cstdint>
+#include <utility>
+#include <vector>
 
 #include "mongo/base/data_type_endian.h"
 #include "mongo/base/data_view.h"
+#include "mongo/base/disallow_copying.h"
 #include "mongo/base/encoded_value_storage.h"
 #include "mongo/base/static_assert.h"
+#include "mongo/bson/util/builder.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/shared_buffer.h"
 
 namespace mongo {
 
@@ -408,7 +413,7 @@ public:
     }
 
     MsgData::View singleData() const {
-        massert(13273, "single data buffer expected", _buf);
+        massert(13273, "single data buffer expected", _buf && _segments.empty());
         return header();
     }
 
@@ -429,6 +434,7 @@ public:
 
     void reset() {
         _buf = {};
+        _segments.clear();
     }
 
     // use to set first buffer if empty
@@ -436,6 +442,43 @@ public:
         verify(empty());
         _buf = std::move(buf);
     }
+
+    /**
+     * A run of this message's bytes that lives in some other shared buffer, such as a document
+     * owned by a plan executor. Holding the buffer keeps the bytes alive until they are sent.
+     */
+    struct Segment {
+        ConstSharedBuffer holder;
+        const char* data;
+        int length;
+    };
+
+    /**
+     * Makes this message consist of the first 'headLength' bytes of its own buffer followed by
+     * 'segments', so that it can be sent with a gathering write and without copying the segments.
+     * The length in the header must already count every byte.
+     *
+     * Only the header may be read from such a message; call flatten() to read the rest.
+     */
+    void setSegments(int headLength, std::vector<Segment> segments) {
+        verify(!empty());
+        _headLength = headLength;
+        _segments = std::move(segments);
+    }
+
+    bool hasSegments() const {
+        return !_segments.empty();
+    }
+
+    /**
+     * Returns the ranges of bytes to write to the wire, in order.
+     */
+    std::vector<std::pair<char*, int>> gatherRanges() const;
+
+    /**
+     * Copies any segments into a single buffer, so that the whole message can be read.
+     */
+    void flatten();
     void setData(int operation, const char* msgtxt) {
         setData(operation, msgtxt, strlen(msgtxt) + 1);
     }
@@ -470,6 +513,67 @@ public:
 
 private:
     SharedBuffer _buf;
+
+    // Only meaningful when there are segments: the number of leading bytes of '_buf' which are
+    // part of the message.
+    int _headLength = 0;
+    std::vector<Segment> _segments;
+};
+
+/**
+ * Builds a message like a BufBuilder, except that runs of bytes already held in a shared buffer
+ * can be referenced rather than copied. Query replies use this for documents the plan executor
+ * already owns, such as those read by a collection scan, so that a large batch is not copied a
+ * second time on its way to the socket.
+ */
+class GatherBufBuilder {
+    MONGO_DISALLOW_COPYING(GatherBufBuilder);
+
+public:
+    // Shorter runs are copied, since each referenced run costs an iovec in the eventual write.
+    static const int kMinSharedLength = 4096;
+
+    explicit GatherBufBuilder(int initialSize) : _builder(initialSize) {}
+
+    void skip(int n) {
+        _builder.skip(n);
+    }
+
+    void appendBuf(const void* src, size_t len) {
+        _builder.appendBuf(src, len);
+    }
+
+    /**
+     * Appends 'length' bytes at 'data', which must stay valid for as long as 'holder' does.
+     */
+    void appendShared(ConstSharedBuffer holder, const char* data, int length);
+
+    /**
+     * The length of the message built so far, including referenced bytes.
+     */
+    int len() const {
+        return _builder.len() + _sharedLength;
+    }
+
+    /**
+     * The start of the message, where its header is written.
+     */
+    char* buf() {
+        return _builder.buf();
+    }
+
+    Message release();
+
+private:
+    struct SharedRun {
+        // Where the run falls among the copied bytes.
+        int offset;
+        Message::Segment segment;
+    };
+
+    BufBuilder _builder;
+    std::vector<SharedRun> _shared;
+    int _sharedLength = 0;
 };
 
 /**
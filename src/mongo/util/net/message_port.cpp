@@ -213,6 +213,10 @@ void MessagingPort::say(Message& toSend, int responseTo) {
 
 void MessagingPort::say(const Message& toSend) {
     invariant(!toSend.empty());
+    if (toSend.hasSegments()) {
+        send(toSend.gatherRanges(), "say");
+        return;
+    }
     auto buf = toSend.buf();
     if (buf) {
         send(buf, MsgData::ConstView(buf).getLen(), "say");
@@ -0,0 +1,115 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/net/message.h"
+
+#include <string>
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::string concatenate(const Message& message) {
+    std::string bytes;
+    for (auto&& range : message.gatherRanges()) {
+        bytes.append(range.first, range.second);
+    }
+    return bytes;
+}
+
+SharedBuffer makeBuffer(const std::string& contents) {
+    auto buffer = SharedBuffer::allocate(contents.size());
+    memcpy(buffer.get(), contents.data(), contents.size());
+    return buffer;
+}
+
+TEST(GatherBufBuilder, CopiesShortSharedRuns) {
+    const std::string shortRun(GatherBufBuilder::kMinSharedLength - 1, 's');
+    auto holder = makeBuffer(shortRun);
+
+    GatherBufBuilder builder(64);
+    builder.skip(sizeof(MSGHEADER::Value));
+    builder.appendShared(holder, holder.get(), shortRun.size());
+    MsgData::View(builder.buf()).setLen(builder.len());
+
+    auto message = builder.release();
+    ASSERT_FALSE(message.hasSegments());
+    ASSERT_EQ(message.dataSize(), static_cast<int>(shortRun.size()));
+}
+
+TEST(GatherBufBuilder, ReferencesLongSharedRuns) {
+    const std::string first(GatherBufBuilder::kMinSharedLength, 'a');
+    const std::string second(GatherBufBuilder::kMinSharedLength * 2, 'b');
+    auto firstHolder = makeBuffer(first);
+    auto secondHolder = makeBuffer(second);
+
+    GatherBufBuilder builder(64);
+    builder.skip(sizeof(MSGHEADER::Value));
+    builder.appendBuf("head", 4);
+    builder.appendShared(firstHolder, firstHolder.get(), first.size());
+    builder.appendBuf("middle", 6);
+    builder.appendShared(secondHolder, secondHolder.get(), second.size());
+    builder.appendBuf("tail", 4);
+    MsgData::View(builder.buf()).setLen(builder.len());
+
+    auto message = builder.release();
+    ASSERT_TRUE(message.hasSegments());
+    ASSERT_EQ(message.gatherRanges().size(), 5U);
+    // The shared runs are sent from their own buffers.
+    ASSERT_EQ(message.gatherRanges()[1].first, firstHolder.get());
+    ASSERT_EQ(message.gatherRanges()[3].first, secondHolder.get());
+
+    const std::string expectedData = "head" + first + "middle" + second + "tail";
+    ASSERT_EQ(message.dataSize(), static_cast<int>(expectedData.size()));
+    auto bytes = concatenate(message);
+    ASSERT_EQ(bytes.substr(sizeof(MSGHEADER::Value)), expectedData);
+
+    message.flatten();
+    ASSERT_FALSE(message.hasSegments());
+    ASSERT_EQ(std::string(message.singleData().data(), message.dataSize()), expectedData);
+}
+
+TEST(GatherBufBuilder, MessageKeepsSharedRunsAlive) {
+    const std::string run(GatherBufBuilder::kMinSharedLength, 'x');
+    GatherBufBuilder builder(64);
+    builder.skip(sizeof(MSGHEADER::Value));
+    {
+        auto holder = makeBuffer(run);
+        builder.appendShared(holder, holder.get(), run.size());
+    }
+    MsgData::View(builder.buf()).setLen(builder.len());
+
+    auto message = builder.release();
+    ASSERT_EQ(concatenate(message).substr(sizeof(MSGHEADER::Value)), run);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -121,6 +121,16 @@ OpMsg OpMsg::parse(const Message& message) try {
     throw;
 }
 
+void OpMsg::setFlag(Message* message, uint32_t flag) {
+    invariant(message->operation() == dbMsg);
+    invariant(!(flag & kChecksumPresent));
+
+    DataView flagsView(message->singleData().data());
+    const auto flags = flagsView.read<LittleEndian<uint32_t>>();
+    invariant(!(flags & kChecksumPresent));
+    flagsView.write<LittleEndian<uint32_t>>(flags | flag);
+}
+
 Message OpMsg::serialize() const {
     OpMsgBuilder builder;
     for (auto&& seq : sequences) {
@@ -90,6 +90,12 @@ struct OpMsg {
         return flags & flag;
     }
 
+    /**
+     * Sets flag in the header of an already serialized OP_MSG. The message must not have a
+     * checksum.
+     */
+    static void setFlag(Message* message, uint32_t flag);
+
     uint32_t flags = 0;
     BSONObj body;
     std::vector<DocumentSequence> sequences;
@@ -34,6 +34,7 @@
 #include "mongo/util/net/sock.h"
 
 #include <algorithm>
+#include <climits>
 
 #if !defined(_WIN32)
 #include <arpa/inet.h>
@@ -555,9 +556,11 @@ void Socket::send(const vector<pair<char*, int>>& data, const char* context) {
     struct msghdr meta;
     memset(&meta, 0, sizeof(meta));
     meta.msg_iov = &d[0];
-    meta.msg_iovlen = d.size();
 
-    while (meta.msg_iovlen > 0) {
+    // A single sendmsg accepts at most IOV_MAX buffers, so larger vectors go out in chunks.
+    size_t remaining = i;
+    while (remaining > 0) {
+        meta.msg_iovlen = std::min<size_t>(remaining, IOV_MAX);
         int ret = -1;
         if (MONGO_FAIL_POINT(throwSockExcep)) {
 #if defined(_WIN32)
@@ -581,7 +584,7 @@ void Socket::send(const vector<pair<char*, int>>& data, const char* context) {
                 } else {
                     ret -= i->iov_len;
                     ++i;
-                    --(meta.msg_iovlen);
+                    --remaining;
                 }
             }
         }
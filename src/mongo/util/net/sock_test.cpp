@@ -31,6 +31,7 @@
 #include "mongo/util/net/sock.h"
 
 #ifndef _WIN32
+#include <climits>
 #include <netdb.h>
 #include <sys/socket.h>
 #include <sys/types.h>
@@ -344,4 +345,26 @@ TEST_F(SocketFailPointTest, TestFailedRecvsDontRecv) {
 }
 
 
+#ifndef _WIN32
+// A gathering send of more buffers than one sendmsg accepts still delivers every byte, in order.
+TEST(SocketGatherSendTest, SendsMoreBuffersThanIovMax) {
+    const SocketPair sockets = socketPair(SOCK_STREAM);
+    ASSERT_TRUE(sockets.first);
+    ASSERT_TRUE(sockets.second);
+
+    const int numBuffers = IOV_MAX * 2 + 7;
+    std::vector<char> bytes(numBuffers);
+    std::vector<std::pair<char*, int>> data;
+    for (int i = 0; i < numBuffers; ++i) {
+        bytes[i] = static_cast<char>(i % 127);
+        data.push_back(std::make_pair(&bytes[i], 1));
+    }
+    sockets.first->send(data, "SocketGatherSendTest");
+
+    std::vector<char> received(numBuffers);
+    sockets.second->recv(received.data(), numBuffers);
+    ASSERT_TRUE(bytes == received);
+}
+#endif
+
 }  // namespace
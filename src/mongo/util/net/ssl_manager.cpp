@@ -46,12 +46,14 @@
 #include "mongo/db/server_parameters.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/transport/session.h"
 #include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/concurrency/threadlocal.h"
 #include "mongo/util/debug_util.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
+#include "mongo/util/lru_cache.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/net/sock.h"
 #include "mongo/util/net/socket_exception.h"
@@ -225,6 +227,14 @@ void _free_ssl_context(SSL_CTX* ctx) {
 SimpleMutex sslManagerMtx;
 SSLManagerInterface* theSSLManager = NULL;
 using UniqueSSLContext = std::unique_ptr<SSL_CTX, decltype(&_free_ssl_context)>;
+using SharedSSLSession = std::shared_ptr<SSL_SESSION>;
+
+/**
+ * Configurable via --setParameter sslSessionCacheSize=N. Bounds both the number of sessions an
+ * incoming SSL context keeps for resumption and the number of remotes whose last session is kept
+ * for resuming outgoing connections. 0 disables session resumption.
+ */
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(sslSessionCacheSize, int, 1000);
 static const int BUFFER_SIZE = 8 * 1024;
 static const int DATE_LEN = 128;
 
@@ -250,6 +260,12 @@ public:
     StatusWith<boost::optional<SSLPeerInfo>> parseAndValidatePeerCertificate(
         SSL* conn, const std::string& remoteHost) final;
 
+    void setResumableSession(SSL* ssl, const std::string& remote) final;
+
+    void recordHandshake(SSL* ssl, ConnectionDirection direction, const std::string& remote) final;
+
+    void appendHandshakeStats(BSONObjBuilder* builder) const final;
+
     virtual const SSLConfiguration& getSSLConfiguration() const {
         return _sslConfiguration;
     }
@@ -279,6 +295,16 @@ private:
     bool _allowInvalidHostnames;
     SSLConfiguration _sslConfiguration;
 
+    // The last session negotiated on an outgoing connection to each remote, least recently used
+    // first evicted once sslSessionCacheSize remotes are cached.
+    mutable stdx::mutex _clientSessionsMutex;
+    LRUCache<std::string, SharedSSLSession> _clientSessions;
+
+    AtomicUInt64 _incomingFullHandshakes;
+    AtomicUInt64 _incomingResumedHandshakes;
+    AtomicUInt64 _outgoingFullHandshakes;
+    AtomicUInt64 _outgoingResumedHandshakes;
+
     /**
      * creates an SSL object to be used for this file descriptor.
      * caller must SSL_free it.
@@ -524,7 +550,8 @@ SSLManager::SSLManager(const SSLParams& params, bool isServer)
       _clientContext(nullptr, _free_ssl_context),
       _weakValidation(params.sslWeakCertificateValidation),
       _allowInvalidCertificates(params.sslAllowInvalidCertificates),
-      _allowInvalidHostnames(params.sslAllowInvalidHostnames) {
+      _allowInvalidHostnames(params.sslAllowInvalidHostnames),
+      _clientSessions(std::max(sslSessionCacheSize, 0)) {
     if (!_initSynchronousSSLContext(&_clientContext, params, ConnectionDirection::kOutgoing)) {
         uasserted(16768, "ssl initialization problem");
     }
@@ -678,6 +705,16 @@ Status SSLManager::initSSLContext(SSL_CTX* context,
                                     << getSSLErrorMessage(ERR_get_error()));
     }
 
+    // Incoming contexts resume sessions from their internal cache (by session ID) or from session
+    // tickets, which OpenSSL issues by default. Outgoing contexts are resumed through
+    // setResumableSession instead, since OpenSSL never reuses client sessions on its own.
+    if (sslSessionCacheSize <= 0) {
+        ::SSL_CTX_set_session_cache_mode(context, SSL_SESS_CACHE_OFF);
+        ::SSL_CTX_set_options(context, SSL_OP_NO_TICKET);
+    } else if (direction == ConnectionDirection::kIncoming) {
+        ::SSL_CTX_sess_set_cache_size(context, sslSessionCacheSize);
+    }
+
     if (direction == ConnectionDirection::kOutgoing && !params.sslClusterFile.empty()) {
         ::EVP_set_pw_prompt("Enter cluster certificate passphrase");
         if (!_setupPEM(context, params.sslClusterFile, params.sslClusterPassword)) {
@@ -1133,6 +1170,9 @@ SSLConnection* SSLManager::connect(Socket* socket) {
     if (ret != 1)
         _handleSSLError(SSL_get_error(sslConn.get(), ret), ret);
 
+    const auto remote = socket->remoteAddr().toString();
+    setResumableSession(sslConn->ssl, remote);
+
     do {
         ret = ::SSL_connect(sslConn->ssl);
     } while (!_doneWithSSLOp(sslConn.get(), ret));
@@ -1140,6 +1180,8 @@ SSLConnection* SSLManager::connect(Socket* socket) {
     if (ret != 1)
         _handleSSLError(SSL_get_error(sslConn.get(), ret), ret);
 
+    recordHandshake(sslConn->ssl, ConnectionDirection::kOutgoing, remote);
+
     return sslConn.release();
 }
 
@@ -1155,9 +1197,70 @@ SSLConnection* SSLManager::accept(Socket* socket, const char* initialBytes, int
     if (ret != 1)
         _handleSSLError(SSL_get_error(sslConn.get(), ret), ret);
 
+    recordHandshake(sslConn->ssl, ConnectionDirection::kIncoming, socket->remoteString());
+
     return sslConn.release();
 }
 
+void SSLManager::setResumableSession(SSL* ssl, const std::string& remote) {
+    SharedSSLSession session;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_clientSessionsMutex);
+        auto it = _clientSessions.find(remote);
+        if (it == _clientSessions.end()) {
+            return;
+        }
+        session = it->second;
+    }
+
+    // The SSL object takes its own reference to the session.
+    ::SSL_set_session(ssl, session.get());
+}
+
+void SSLManager::recordHandshake(SSL* ssl,
+                                 ConnectionDirection direction,
+                                 const std::string& remote) {
+    const bool resumed = ::SSL_session_reused(ssl);
+    if (direction == ConnectionDirection::kIncoming) {
+        (resumed ? _incomingResumedHandshakes : _incomingFullHandshakes).fetchAndAdd(1);
+        return;
+    }
+
+    (resumed ? _outgoingResumedHandshakes : _outgoingFullHandshakes).fetchAndAdd(1);
+
+    if (sslSessionCacheSize <= 0 || resumed) {
+        return;
+    }
+
+    SSL_SESSION* session = ::SSL_get1_session(ssl);
+    if (!session) {
+        return;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_clientSessionsMutex);
+    _clientSessions.add(remote, SharedSSLSession(session, ::SSL_SESSION_free));
+}
+
+void SSLManager::appendHandshakeStats(BSONObjBuilder* builder) const {
+    BSONObjBuilder handshakes(builder->subobjStart("SSLHandshakes"));
+    {
+        BSONObjBuilder incoming(handshakes.subobjStart("incoming"));
+        incoming.appendNumber("full", static_cast<long long>(_incomingFullHandshakes.load()));
+        incoming.appendNumber("resumed",
+                              static_cast<long long>(_incomingResumedHandshakes.load()));
+    }
+    {
+        BSONObjBuilder outgoing(handshakes.subobjStart("outgoing"));
+        outgoing.appendNumber("full", static_cast<long long>(_outgoingFullHandshakes.load()));
+        outgoing.appendNumber("resumed",
+                              static_cast<long long>(_outgoingResumedHandshakes.load()));
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_clientSessionsMutex);
+    handshakes.appendNumber("cachedOutgoingSessions",
+                            static_cast<long long>(_clientSessions.size()));
+}
+
 // TODO SERVER-11601 Use NFC Unicode canonicalization
 bool SSLManager::_hostNameMatch(const char* nameToMatch, const char* certHostName) {
     if (strlen(certHostName) < 2) {
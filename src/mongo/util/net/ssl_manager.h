@@ -57,6 +57,7 @@ const std::string getSSLVersion(const std::string& prefix, const std::string& su
 
 #ifdef MONGO_CONFIG_SSL
 namespace mongo {
+class BSONObjBuilder;
 struct SSLParams;
 
 class SSLConnection {
@@ -186,6 +187,26 @@ public:
      */
     virtual StatusWith<boost::optional<SSLPeerInfo>> parseAndValidatePeerCertificate(
         SSL* ssl, const std::string& remoteHost) = 0;
+
+    /**
+     * Offers 'ssl' the session last negotiated with 'remote', if one is cached, so that the
+     * upcoming client handshake resumes it by session ticket or session ID instead of performing
+     * a full handshake. 'remote' is the address of the peer, as formatted by SockAddr::toString.
+     */
+    virtual void setResumableSession(SSL* ssl, const std::string& remote) = 0;
+
+    /**
+     * Counts the handshake just completed on 'ssl' as full or resumed and, for outgoing
+     * connections, caches its session for the next connection to 'remote'.
+     */
+    virtual void recordHandshake(SSL* ssl,
+                                 ConnectionDirection direction,
+                                 const std::string& remote) = 0;
+
+    /**
+     * Appends the handshake counts and session cache usage reported by serverStatus.
+     */
+    virtual void appendHandshakeStats(BSONObjBuilder* builder) const = 0;
 };
 
 // Access SSL functions through this instance.
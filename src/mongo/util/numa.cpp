@@ -0,0 +1,238 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kControl
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/numa.h"
+
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <string>
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "mongo/base/error_codes.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+// Whether to interleave the memory of the process across the NUMA nodes of the host
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(numaInterleaveMemory, bool, false);
+
+// Whether to bind each thread serving clients to one of the NUMA nodes of the host, round-robin
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(numaBindServiceThreads, bool, false);
+
+namespace {
+
+#ifdef __linux__
+// The set_mempolicy(2) mode interleaving allocations across a set of nodes, from
+// <linux/mempolicy.h>, which isn't installed everywhere.
+const int kMemPolicyInterleave = 3;
+
+const char kNodesPath[] = "/sys/devices/system/node";
+
+/**
+ * Parses a list of CPUs in the format of the kernel, such as "0-3,8,10-11".
+ */
+std::vector<unsigned> parseCpuList(const std::string& list) {
+    std::vector<unsigned> cpus;
+    size_t pos = 0;
+    while (pos < list.size()) {
+        size_t end = list.find(',', pos);
+        if (end == std::string::npos) {
+            end = list.size();
+        }
+
+        const std::string range = list.substr(pos, end - pos);
+        const size_t dash = range.find('-');
+        try {
+            const unsigned first = std::stoul(range.substr(0, dash));
+            const unsigned last =
+                (dash == std::string::npos) ? first : std::stoul(range.substr(dash + 1));
+            for (unsigned cpu = first; cpu <= last; cpu++) {
+                cpus.push_back(cpu);
+            }
+        } catch (const std::exception&) {
+            // Skip anything unexpected rather than fail reading the rest of the topology.
+        }
+
+        pos = end + 1;
+    }
+    return cpus;
+}
+
+std::string readFirstLine(const boost::filesystem::path& path) {
+    std::ifstream file(path.string());
+    std::string line;
+    std::getline(file, line);
+    return line;
+}
+#endif
+
+}  // namespace
+
+const NumaTopology& NumaTopology::get() {
+    static const NumaTopology* topology = new NumaTopology();
+    return *topology;
+}
+
+bool NumaTopology::shouldInterleaveMemory() {
+    return numaInterleaveMemory;
+}
+
+bool NumaTopology::shouldBindServiceThreads() {
+    return numaBindServiceThreads;
+}
+
+NumaTopology::NumaTopology() {
+#ifdef __linux__
+    try {
+        const boost::filesystem::path nodesPath(kNodesPath);
+        if (!boost::filesystem::exists(nodesPath)) {
+            return;
+        }
+
+        for (boost::filesystem::directory_iterator it(nodesPath), end; it != end; ++it) {
+            const std::string name = it->path().filename().string();
+            if (name.size() <= 4 || name.compare(0, 4, "node") != 0 ||
+                !std::all_of(name.begin() + 4, name.end(), ::isdigit)) {
+                continue;
+            }
+
+            Node node;
+            node.id = std::stoul(name.substr(4));
+            node.cpus = parseCpuList(readFirstLine(it->path() / "cpulist"));
+            _nodes.push_back(std::move(node));
+        }
+    } catch (const boost::filesystem::filesystem_error& e) {
+        warning() << "Cannot read the NUMA topology of the host. Failed to probe \""
+                  << e.path1().string() << "\": " << e.code().message();
+        _nodes.clear();
+    }
+
+    std::sort(_nodes.begin(), _nodes.end(), [](const Node& lhs, const Node& rhs) {
+        return lhs.id < rhs.id;
+    });
+#endif
+}
+
+Status NumaTopology::interleaveMemory() const {
+    if (!isNuma()) {
+        return Status::OK();
+    }
+
+#ifdef __linux__
+    const size_t bitsPerWord = sizeof(unsigned long) * 8;
+    std::vector<unsigned long> nodeMask(_nodes.back().id / bitsPerWord + 1);
+    for (const auto& node : _nodes) {
+        nodeMask[node.id / bitsPerWord] |= 1UL << (node.id % bitsPerWord);
+    }
+
+    // The kernel ignores the last bit of the mask it is given the size of.
+    if (syscall(SYS_set_mempolicy,
+                kMemPolicyInterleave,
+                nodeMask.data(),
+                nodeMask.size() * bitsPerWord + 1) != 0) {
+        return Status(ErrorCodes::OperationFailed,
+                      str::stream() << "Failed to interleave memory across NUMA nodes: "
+                                    << errnoWithDescription());
+    }
+#endif
+    return Status::OK();
+}
+
+Status NumaTopology::bindThreadToNode(size_t index) const {
+    if (!isNuma()) {
+        return Status::OK();
+    }
+
+#ifdef __linux__
+    // Nodes may only have memory, in which case no thread can run on them.
+    std::vector<const Node*> nodesWithCpus;
+    for (const auto& node : _nodes) {
+        if (!node.cpus.empty()) {
+            nodesWithCpus.push_back(&node);
+        }
+    }
+    if (nodesWithCpus.empty()) {
+        return Status::OK();
+    }
+
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (unsigned cpu : nodesWithCpus[index % nodesWithCpus.size()]->cpus) {
+        if (cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &cpus);
+        }
+    }
+
+    if (sched_setaffinity(0, sizeof(cpus), &cpus) != 0) {
+        return Status(ErrorCodes::OperationFailed,
+                      str::stream() << "Failed to bind thread to NUMA node "
+                                    << nodesWithCpus[index % nodesWithCpus.size()]->id
+                                    << ": "
+                                    << errnoWithDescription());
+    }
+#endif
+    return Status::OK();
+}
+
+void NumaTopology::appendStats(BSONObjBuilder* builder) const {
+    builder->append("numNodes", static_cast<int>(_nodes.size()));
+    builder->append("interleaveMemory", shouldInterleaveMemory());
+    builder->append("bindServiceThreads", shouldBindServiceThreads());
+
+    BSONObjBuilder nodesBuilder(builder->subobjStart("nodes"));
+    for (const auto& node : _nodes) {
+        BSONObjBuilder nodeBuilder(nodesBuilder.subobjStart(std::to_string(node.id)));
+        nodeBuilder.append("numCpus", static_cast<int>(node.cpus.size()));
+
+#ifdef __linux__
+        // Each line of numastat is the name of a counter followed by its value, such as
+        // "numa_miss 1234" for the allocations meant for another node which were satisfied here.
+        std::ifstream numastat(str::stream() << kNodesPath << "/node" << node.id << "/numastat");
+        std::string counter;
+        long long value;
+        while (numastat >> counter >> value) {
+            nodeBuilder.append(counter, value);
+        }
+#endif
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,104 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * The NUMA topology of the host, and the placement of the memory and the threads of this process
+ * across its nodes. Only Linux is supported; on other platforms, or when the topology cannot be
+ * read, the host is treated as having a single node and placement requests are no-ops.
+ */
+class NumaTopology {
+    MONGO_DISALLOW_COPYING(NumaTopology);
+
+public:
+    struct Node {
+        unsigned id;
+        std::vector<unsigned> cpus;
+    };
+
+    /**
+     * Returns the topology of the host, which is read the first time this is called.
+     */
+    static const NumaTopology& get();
+
+    /**
+     * Whether the numaInterleaveMemory startup parameter asks for memory to be interleaved across
+     * the nodes.
+     */
+    static bool shouldInterleaveMemory();
+
+    /**
+     * Whether the numaBindServiceThreads startup parameter asks for the threads serving clients to
+     * be bound to nodes.
+     */
+    static bool shouldBindServiceThreads();
+
+    const std::vector<Node>& nodes() const {
+        return _nodes;
+    }
+
+    bool isNuma() const {
+        return _nodes.size() > 1;
+    }
+
+    /**
+     * Sets the memory policy of the calling thread to interleave its allocations across all the
+     * nodes. Threads started by the calling thread from then on inherit the policy, so calling
+     * this early during startup interleaves the caches of the storage engine too.
+     */
+    Status interleaveMemory() const;
+
+    /**
+     * Restricts the calling thread to the CPUs of a node, chosen round-robin by 'index', so that
+     * the memory it allocates under the default policy is local to it.
+     */
+    Status bindThreadToNode(size_t index) const;
+
+    /**
+     * Appends the nodes with their CPUs, along with the kernel's counters of the allocations
+     * satisfied on each node and of those which had to use another node.
+     */
+    void appendStats(BSONObjBuilder* builder) const;
+
+private:
+    NumaTopology();
+
+    std::vector<Node> _nodes;
+};
+
+}  // namespace mongo
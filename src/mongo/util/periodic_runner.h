@@ -48,6 +48,9 @@ public:
         PeriodicJob(Job callable, Milliseconds period)
             : job(std::move(callable)), interval(period) {}
 
+        PeriodicJob(Job callable, stdx::function<Milliseconds()> periodFn)
+            : job(std::move(callable)), interval(periodFn()), intervalFn(std::move(periodFn)) {}
+
         /**
          * A task to be run at regular intervals by the runner.
          */
@@ -57,6 +60,16 @@ public:
          * An interval at which the job should be run. Defaults to 1 minute.
          */
         Milliseconds interval;
+
+        /**
+         * If set, chooses the interval before each run of the job in place of "interval", so that
+         * the period can follow a server parameter that is changed at runtime.
+         */
+        stdx::function<Milliseconds()> intervalFn;
+
+        Milliseconds getInterval() const {
+            return intervalFn ? intervalFn() : interval;
+        }
     };
 
     virtual ~PeriodicRunner();
@@ -73,7 +73,8 @@ void PeriodicRunnerASIO::_scheduleJob(std::weak_ptr<PeriodicJobASIO> job) {
     }
 
     // Adjust the timer to expire at the correct time.
-    auto adjustedMS = lockedJob->start + lockedJob->interval - _timerFactory->now();
+    const auto interval = lockedJob->intervalFn ? lockedJob->intervalFn() : lockedJob->interval;
+    auto adjustedMS = lockedJob->start + interval - _timerFactory->now();
     lockedJob->timer->expireAfter(adjustedMS);
     lockedJob->timer->asyncWait([this, job](std::error_code ec) mutable {
         if (ec) {
@@ -80,10 +80,12 @@ private:
                                  std::shared_ptr<executor::AsyncTimerInterface> sharedTimer)
             : job(std::move(callable.job)),
               interval(callable.interval),
+              intervalFn(std::move(callable.intervalFn)),
               start(startTime),
               timer(sharedTimer) {}
         Job job;
         Milliseconds interval;
+        stdx::function<Milliseconds()> intervalFn;
         Date_t start;
         std::shared_ptr<executor::AsyncTimerInterface> timer;
     };
@@ -0,0 +1,174 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kControl
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/periodic_runner_impl.h"
+
+#include "mongo/stdx/memory.h"
+#include "mongo/util/clock_source.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+namespace {
+
+ThreadPool::Options makeThreadPoolOptions(const PeriodicRunnerImpl::Options& options) {
+    ThreadPool::Options poolOptions;
+    poolOptions.poolName = options.poolName;
+    poolOptions.threadNamePrefix = options.threadNamePrefix;
+    poolOptions.minThreads = 0;
+    poolOptions.maxThreads = options.maxThreads;
+    poolOptions.onCreateThread = options.onCreateThread;
+    return poolOptions;
+}
+
+}  // namespace
+
+PeriodicRunnerImpl::PeriodicRunnerImpl(ClockSource* clockSource, Options options)
+    : _clockSource(clockSource),
+      _options(std::move(options)),
+      _pool(makeThreadPoolOptions(_options)),
+      _wheel(_clockSource->now(), _options.resolution) {}
+
+PeriodicRunnerImpl::~PeriodicRunnerImpl() {
+    shutdown();
+}
+
+void PeriodicRunnerImpl::scheduleJob(PeriodicJob job) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_state == State::kComplete) {
+        return;
+    }
+
+    const TimerWheel::TimerId id = _jobs.size();
+    _jobs.push_back(stdx::make_unique<PeriodicJob>(std::move(job)));
+    if (_state == State::kRunning) {
+        _addTimer_inlock(id, _clockSource->now() + _jobs.back()->getInterval());
+    }
+}
+
+Status PeriodicRunnerImpl::startup() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_state != State::kReady) {
+        return {ErrorCodes::ShutdownInProgress, "startup() already called"};
+    }
+
+    _state = State::kRunning;
+    _pool.startup();
+
+    const Date_t now = _clockSource->now();
+    for (TimerWheel::TimerId id = 0; id < _jobs.size(); ++id) {
+        _addTimer_inlock(id, now + _jobs[id]->getInterval());
+    }
+    _timerThread = stdx::thread([this] { _timerThreadBody(); });
+
+    return Status::OK();
+}
+
+void PeriodicRunnerImpl::shutdown() {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_state != State::kRunning) {
+            _state = State::kComplete;
+            return;
+        }
+        _state = State::kComplete;
+        _timerThreadWakeup.notify_one();
+    }
+
+    _timerThread.join();
+    _pool.shutdown();
+    _pool.join();
+}
+
+void PeriodicRunnerImpl::_addTimer_inlock(TimerWheel::TimerId id, Date_t deadline) {
+    _wheel.add(id, deadline);
+    if (deadline < _nextWakeup) {
+        _timerThreadWakeup.notify_one();
+    }
+}
+
+void PeriodicRunnerImpl::_timerThreadBody() {
+    setThreadName(str::stream() << _options.poolName << "Timer");
+
+    std::vector<TimerWheel::TimerId> due;
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    while (_state == State::kRunning) {
+        _wheel.advanceTo(_clockSource->now(), &due);
+        if (!due.empty()) {
+            lk.unlock();
+            for (auto id : due) {
+                Status status = _pool.schedule([this, id] { _runJob(id); });
+                if (!status.isOK()) {
+                    // The pool only refuses work once we are shutting down.
+                    LOG(1) << "Not running a periodic job: " << status;
+                }
+            }
+            due.clear();
+            lk.lock();
+            continue;
+        }
+
+        auto nextWakeup = _wheel.nextWakeup();
+        _nextWakeup = nextWakeup ? *nextWakeup : Date_t::max();
+        MONGO_IDLE_THREAD_BLOCK;
+        if (nextWakeup) {
+            _clockSource->waitForConditionUntil(_timerThreadWakeup, lk, *nextWakeup);
+        } else {
+            _timerThreadWakeup.wait(lk);
+        }
+        _nextWakeup = Date_t();
+    }
+}
+
+void PeriodicRunnerImpl::_runJob(TimerWheel::TimerId id) {
+    PeriodicJob* job;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_state != State::kRunning) {
+            return;
+        }
+        job = _jobs[id].get();
+    }
+
+    const Date_t start = _clockSource->now();
+    job->job();
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_state == State::kRunning) {
+        _addTimer_inlock(id, start + job->getInterval());
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,121 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/periodic_runner.h"
+#include "mongo/util/timer_wheel.h"
+
+namespace mongo {
+
+class ClockSource;
+
+/**
+ * A PeriodicRunner that multiplexes any number of jobs onto a single timer thread and a small,
+ * bounded pool of worker threads.
+ *
+ * The timer thread keeps the jobs' deadlines in a TimerWheel and only wakes up when some job is
+ * due, handing the due jobs to the worker pool. A job is not run again until its previous run has
+ * finished; its next run is due one interval after the start of the previous one.
+ */
+class PeriodicRunnerImpl final : public PeriodicRunner {
+public:
+    struct Options {
+        std::string poolName = "PeriodicRunner";
+        std::string threadNamePrefix = "PeriodicRunner-";
+
+        /**
+         * The most jobs that may run at the same time.
+         */
+        size_t maxThreads = 2;
+
+        /**
+         * The granularity of the timer wheel. Jobs may run up to this much later than they are due.
+         */
+        Milliseconds resolution{100};
+
+        /**
+         * Called on each worker thread when it is created, before it runs any jobs.
+         */
+        stdx::function<void(const std::string& threadName)> onCreateThread = [](
+            const std::string&) {};
+    };
+
+    PeriodicRunnerImpl(ClockSource* clockSource, Options options);
+
+    ~PeriodicRunnerImpl();
+
+    void scheduleJob(PeriodicJob job) override;
+
+    /**
+     * Starts the timer thread and the worker pool, scheduling the jobs added so far. Like
+     * PeriodicRunnerASIO, this runner may only be started once.
+     */
+    Status startup() override;
+
+    /**
+     * Stops running jobs and waits for any that are running to finish. May be called more than
+     * once.
+     */
+    void shutdown() override;
+
+private:
+    enum class State { kReady, kRunning, kComplete };
+
+    void _timerThreadBody();
+    void _runJob(TimerWheel::TimerId id);
+    void _addTimer_inlock(TimerWheel::TimerId id, Date_t deadline);
+
+    ClockSource* const _clockSource;
+    const Options _options;
+
+    ThreadPool _pool;
+    stdx::thread _timerThread;
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _timerThreadWakeup;
+    State _state = State::kReady;
+
+    // Jobs are identified in the timer wheel by their index in this vector.
+    std::vector<std::unique_ptr<PeriodicJob>> _jobs;
+    TimerWheel _wheel;
+
+    // When the timer thread is next going to wake up, or Date_t::max() if it sleeps until woken.
+    Date_t _nextWakeup = Date_t::max();
+};
+
+}  // namespace mongo
@@ -0,0 +1,225 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/periodic_runner_impl.h"
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/clock_source_mock.h"
+
+namespace mongo {
+namespace {
+
+class PeriodicRunnerImplTestNoSetup : public unittest::Test {
+public:
+    void setUp() override {
+        PeriodicRunnerImpl::Options options;
+        options.resolution = Milliseconds(1);
+        options.onCreateThread = [this](const std::string&) { _threadsCreated.addAndFetch(1); };
+        _runner = stdx::make_unique<PeriodicRunnerImpl>(&_clockSource, std::move(options));
+    }
+
+    void tearDown() override {
+        _runner->shutdown();
+    }
+
+    ClockSourceMock& clockSource() {
+        return _clockSource;
+    }
+
+    std::unique_ptr<PeriodicRunnerImpl>& runner() {
+        return _runner;
+    }
+
+    unsigned threadsCreated() {
+        return _threadsCreated.load();
+    }
+
+private:
+    ClockSourceMock _clockSource;
+    AtomicUInt32 _threadsCreated;
+    std::unique_ptr<PeriodicRunnerImpl> _runner;
+};
+
+class PeriodicRunnerImplTest : public PeriodicRunnerImplTestNoSetup {
+public:
+    void setUp() override {
+        PeriodicRunnerImplTestNoSetup::setUp();
+        ASSERT_OK(runner()->startup());
+    }
+};
+
+TEST_F(PeriodicRunnerImplTest, OneJobTest) {
+    int count = 0;
+    Milliseconds interval{5};
+
+    stdx::mutex mutex;
+    stdx::condition_variable cv;
+
+    PeriodicRunner::PeriodicJob job(
+        [&] {
+            {
+                stdx::unique_lock<stdx::mutex> lk(mutex);
+                count++;
+            }
+            cv.notify_all();
+        },
+        interval);
+
+    runner()->scheduleJob(std::move(job));
+
+    // Fast forward ten times, we should run all ten times.
+    for (int i = 0; i < 10; i++) {
+        clockSource().advance(interval);
+        {
+            stdx::unique_lock<stdx::mutex> lk(mutex);
+            cv.wait(lk, [&] { return count > i; });
+        }
+    }
+
+    // Jobs run on the worker pool, whose threads are set up by the onCreateThread hook.
+    ASSERT_GTE(threadsCreated(), 1U);
+}
+
+TEST_F(PeriodicRunnerImplTestNoSetup, ScheduleBeforeStartupTest) {
+    int count = 0;
+    Milliseconds interval{5};
+
+    stdx::mutex mutex;
+    stdx::condition_variable cv;
+
+    PeriodicRunner::PeriodicJob job(
+        [&] {
+            stdx::unique_lock<stdx::mutex> lk(mutex);
+            count++;
+            cv.notify_all();
+        },
+        interval);
+
+    runner()->scheduleJob(std::move(job));
+    ASSERT_OK(runner()->startup());
+    ASSERT_NOT_OK(runner()->startup());
+
+    clockSource().advance(interval);
+    stdx::unique_lock<stdx::mutex> lk(mutex);
+    cv.wait(lk, [&] { return count > 0; });
+}
+
+TEST_F(PeriodicRunnerImplTest, TwoJobsTest) {
+    int countA = 0;
+    int countB = 0;
+    Milliseconds intervalA{5};
+    Milliseconds intervalB{10};
+
+    stdx::mutex mutex;
+    stdx::condition_variable cv;
+
+    runner()->scheduleJob({[&] {
+                               stdx::unique_lock<stdx::mutex> lk(mutex);
+                               countA++;
+                               cv.notify_all();
+                           },
+                           intervalA});
+    runner()->scheduleJob({[&] {
+                               stdx::unique_lock<stdx::mutex> lk(mutex);
+                               countB++;
+                               cv.notify_all();
+                           },
+                           intervalB});
+
+    for (int i = 0; i < 10; i++) {
+        clockSource().advance(intervalA);
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        cv.wait(lk, [&] { return countA > i && countB >= (i + 1) / 2; });
+    }
+}
+
+TEST_F(PeriodicRunnerImplTest, IntervalFnIsConsultedBeforeEachRun) {
+    AtomicInt64 intervalMillis(10);
+    std::vector<Date_t> runTimes;
+
+    stdx::mutex mutex;
+    stdx::condition_variable cv;
+
+    runner()->scheduleJob({[&] {
+                               stdx::unique_lock<stdx::mutex> lk(mutex);
+                               runTimes.push_back(clockSource().now());
+                               intervalMillis.store(1000);
+                               cv.notify_all();
+                           },
+                           [&] { return Milliseconds(intervalMillis.load()); }});
+
+    clockSource().advance(Milliseconds(10));
+    {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        cv.wait(lk, [&] { return runTimes.size() == 1; });
+    }
+
+    clockSource().advance(Milliseconds(500));
+    clockSource().advance(Milliseconds(500));
+    stdx::unique_lock<stdx::mutex> lk(mutex);
+    cv.wait(lk, [&] { return runTimes.size() == 2; });
+    ASSERT_GTE(runTimes[1] - runTimes[0], Milliseconds(1000));
+}
+
+TEST_F(PeriodicRunnerImplTest, NoJobsRunAfterShutdown) {
+    int count = 0;
+    Milliseconds interval{5};
+
+    stdx::mutex mutex;
+    stdx::condition_variable cv;
+
+    runner()->scheduleJob({[&] {
+                               stdx::unique_lock<stdx::mutex> lk(mutex);
+                               count++;
+                               cv.notify_all();
+                           },
+                           interval});
+
+    clockSource().advance(interval);
+    {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        cv.wait(lk, [&] { return count > 0; });
+    }
+
+    // Shutdown joins every thread of the runner, so nothing can run the job after it returns.
+    runner()->shutdown();
+    const int countAtShutdown = count;
+    clockSource().advance(interval * 10);
+    runner()->scheduleJob({[&] { count++; }, interval});
+    clockSource().advance(interval * 10);
+    ASSERT_EQ(countAtShutdown, count);
+}
+
+}  // namespace
+}  // namespace mongo
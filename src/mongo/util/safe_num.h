@@ -159,7 +159,11 @@ public:
     friend class mutablebson::Element;
     friend class mutablebson::Document;
 
-    // TODO: output to builder
+    /**
+     * Appends the value to 'bob' as a field named 'fieldName', with the BSON type of the SafeNum.
+     * The SafeNum must be valid.
+     */
+    void toBSON(StringData fieldName, BSONObjBuilder* bob) const;
 
     //
     // accessors
@@ -31,6 +31,7 @@
 #undef MONGO_PCH_WHITELISTED  // for malloc/realloc pulled from bson
 
 #include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/bson/bsontypes.h"
 #include "mongo/platform/decimal128.h"
 #include "mongo/unittest/unittest.h"
@@ -38,6 +39,8 @@
 
 namespace {
 
+using mongo::BSONObj;
+using mongo::BSONObjBuilder;
 using mongo::SafeNum;
 using mongo::Decimal128;
 
@@ -535,4 +538,20 @@ TEST(Multiplication, BoundsWithNegativeOne) {
     ASSERT_EQUALS(mongo::EOO, (minusOneInt64 * minInt64).type());
 }
 
+TEST(ToBSON, PreservesType) {
+    BSONObjBuilder bob;
+    SafeNum(static_cast<int32_t>(1)).toBSON("int", &bob);
+    SafeNum(static_cast<int64_t>(2)).toBSON("long", &bob);
+    SafeNum(3.5).toBSON("double", &bob);
+    SafeNum(Decimal128("4.5")).toBSON("decimal", &bob);
+    BSONObj obj = bob.obj();
+    ASSERT_BSONOBJ_EQ(BSON("int" << 1 << "long" << 2LL << "double" << 3.5 << "decimal"
+                                 << Decimal128("4.5")),
+                      obj);
+    ASSERT_EQUALS(mongo::NumberInt, obj["int"].type());
+    ASSERT_EQUALS(mongo::NumberLong, obj["long"].type());
+    ASSERT_EQUALS(mongo::NumberDouble, obj["double"].type());
+    ASSERT_EQUALS(mongo::NumberDecimal, obj["decimal"].type());
+}
+
 }  // unnamed namespace
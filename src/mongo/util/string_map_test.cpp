@@ -34,6 +34,7 @@
 #include "mongo/platform/random.h"
 #include "mongo/platform/unordered_map.h"
 #include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
 #include "mongo/util/string_map.h"
 #include "mongo/util/timer.h"
 
@@ -206,6 +207,58 @@ TEST(StringMapTest, Assign) {
     ASSERT_EQUALS(5, y["eliot"]);
 }
 
+TEST(StringMapTest, CapacityFollowsLoadFactor) {
+    StringMap<int> m;
+    char buf[64];
+
+    for (int i = 0; i < 10000; i++) {
+        sprintf(buf, "foo%d", i);
+        m[buf] = i;
+    }
+
+    // Live entries never fill more than three quarters of the table, and growing never leaves them
+    // filling less than a quarter of it.
+    ASSERT_LTE(m.size() * 4, m.capacity() * 3);
+    ASSERT_GTE(m.size() * 4, m.capacity());
+}
+
+TEST(StringMapTest, EraseChurnWithLiveEntries) {
+    StringMap<int> m;
+    char buf[64];
+
+    for (int i = 0; i < 100; i++) {
+        sprintf(buf, "live%d", i);
+        m[buf] = i;
+    }
+    size_t before = m.capacity();
+
+    for (int i = 0; i < 10000; i++) {
+        sprintf(buf, "foo%d", i);
+        m[buf] = i;
+        ASSERT_EQUALS(1U, m.erase(buf));
+        ASSERT(m.end() == m.find(buf));
+    }
+
+    // Tombstones left by the erases are dropped rather than causing the table to grow.
+    ASSERT_EQUALS(before, m.capacity());
+    ASSERT_EQUALS(100U, m.size());
+    for (int i = 0; i < 100; i++) {
+        sprintf(buf, "live%d", i);
+        ASSERT_EQUALS(i, m.find(buf)->second);
+    }
+}
+
+TEST(StringMapTest, HashedKeyLookup) {
+    StringMap<int> m;
+    m["eliot"] = 5;
+
+    StringMap<int>::HashedKey key("eliot");
+    ASSERT_EQUALS(5, m.find(key)->second);
+    ASSERT_EQUALS(5, m[key]);
+    ASSERT_EQUALS(1U, m.erase(key));
+    ASSERT(m.end() == m.find(key));
+}
+
 TEST(StringMapTest, InitWithInitializerList) {
     StringMap<int> smap{
         {"q", 1}, {"coollog", 2}, {"mango", 3}, {"mango", 4},
@@ -215,4 +268,45 @@ TEST(StringMapTest, InitWithInitializerList) {
     ASSERT_EQ(2, smap["coollog"]);
     ASSERT_EQ(3, smap["mango"]);
 }
+
+TEST(StringMapPerf, LookupAgainstUnorderedMap) {
+    const int kNumKeys = 100000;
+    const int kNumPasses = 10;
+
+    std::vector<std::string> keys;
+    PseudoRandom random(12345);
+    for (int i = 0; i < kNumKeys; i++) {
+        keys.push_back(str::stream() << "db" << random.nextInt32(1000) << ".coll" << i);
+    }
+
+    StringMap<int> stringMap;
+    unordered_map<std::string, int> unorderedMap;
+    long long sum = 0;
+
+    Timer stringMapTimer;
+    for (int i = 0; i < kNumKeys; i++) {
+        stringMap[keys[i]] = i;
+    }
+    for (int pass = 0; pass < kNumPasses; pass++) {
+        for (auto&& key : keys) {
+            sum += stringMap.find(key)->second;
+        }
+    }
+    long long stringMapMicros = stringMapTimer.micros();
+
+    Timer unorderedMapTimer;
+    for (int i = 0; i < kNumKeys; i++) {
+        unorderedMap[keys[i]] = i;
+    }
+    for (int pass = 0; pass < kNumPasses; pass++) {
+        for (auto&& key : keys) {
+            sum -= unorderedMap.find(key)->second;
+        }
+    }
+    long long unorderedMapMicros = unorderedMapTimer.micros();
+
+    ASSERT_EQUALS(0, sum);
+    log() << "StringMap: " << stringMapMicros << "us, unordered_map: " << unorderedMapMicros
+          << "us for " << kNumKeys << " inserts and " << kNumKeys * kNumPasses << " lookups";
+}
 }
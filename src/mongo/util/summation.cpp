@@ -30,6 +30,7 @@
 
 #include "summation.h"
 
+#include <algorithm>
 #include <cmath>
 
 #include "mongo/util/assert_util.h"
@@ -44,6 +45,66 @@ void DoubleDoubleSummation::addLong(long long x) {
     addDouble(high);
 }
 
+void DoubleDoubleSummation::addLongs(const long long* values, size_t count) {
+    // Split every value into two halves the same way addLong() does, but sum the halves as
+    // integers. Each half is less than 2**32 in magnitude, so neither sum can overflow for up to
+    // 2**31 values and no per-value overflow check is needed.
+    const size_t kMaxBlockSize = size_t(1) << 31;
+    while (count > 0) {
+        const size_t blockSize = std::min(count, kMaxBlockSize);
+        int64_t highSum = 0;
+        int64_t lowSum = 0;
+        for (size_t i = 0; i < blockSize; i++) {
+            int64_t high = values[i] / (1ll << 32);
+            highSum += high;
+            lowSum += values[i] - high * (1ll << 32);
+        }
+        values += blockSize;
+        count -= blockSize;
+
+        // The block sum is highSum * 2**32 + lowSum. Split both sums again so that all parts are
+        // exactly representable as doubles, and add them smallest first.
+        int64_t highSumHigh = highSum / (1ll << 32);
+        int64_t highSumLow = highSum - highSumHigh * (1ll << 32);
+        int64_t lowSumHigh = lowSum / (1ll << 32);
+        int64_t lowSumLow = lowSum - lowSumHigh * (1ll << 32);
+        addDouble(lowSumLow);
+        addDouble(std::ldexp(lowSumHigh, 32));
+        addDouble(std::ldexp(highSumLow, 32));
+        addDouble(std::ldexp(highSumHigh, 64));
+    }
+}
+
+void DoubleDoubleSummation::addDoubles(const double* values, size_t count) {
+    // Each compensated add depends on the result of the previous one. Interleaving several
+    // independent sums lets consecutive adds execute in parallel, and lets the compiler vectorize
+    // the inner loop.
+    const size_t kLanes = 4;
+    double sums[kLanes] = {};
+    double addends[kLanes] = {};
+    double specials[kLanes] = {};
+
+    size_t i = 0;
+    for (; i + kLanes <= count; i += kLanes) {
+        for (size_t lane = 0; lane < kLanes; lane++) {
+            double x = values[i + lane];
+            specials[lane] += x;
+            std::tie(x, addends[lane]) = _fast2Sum(x, addends[lane]);
+            std::tie(sums[lane], x) = _2Sum(sums[lane], x);
+            addends[lane] += x;
+        }
+    }
+
+    for (size_t lane = 0; lane < kLanes; lane++) {
+        _special += specials[lane];
+        _addCompensated(sums[lane]);
+        _addCompensated(addends[lane]);
+    }
+    for (; i < count; i++) {
+        addDouble(values[i]);
+    }
+}
+
 /**
  * Returns whether the sum is in range of the 64-bit signed integer long long type.
  */
@@ -86,4 +147,25 @@ long long DoubleDoubleSummation::getLong() const {
     sum += llround((_sum - sum) + _addend);
     return sum;
 }
+
+void DecimalSummation::_addSlow(const Decimal128& x) {
+    if (_isFixedPoint) {
+        _total = getDecimal();
+        _isFixedPoint = false;
+    }
+    _total = _total.add(x);
+}
+
+Decimal128 DecimalSummation::getDecimal() const {
+    if (!_isFixedPoint)
+        return _total;
+    if (!_hasExponent)
+        return Decimal128();
+
+    // Negate in unsigned arithmetic, so that the most negative sum doesn't overflow.
+    const bool isNegative = _coefficientSum < 0;
+    const uint64_t magnitude = isNegative ? 0 - static_cast<uint64_t>(_coefficientSum)
+                                          : static_cast<uint64_t>(_coefficientSum);
+    return Decimal128(isNegative, _biasedExponent, 0, magnitude);
+}
 }  // namespace mongo
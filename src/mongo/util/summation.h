@@ -29,10 +29,12 @@
 #pragma once
 
 #include <cmath>
+#include <limits>
 #include <tuple>
 #include <utility>
 
 #include "mongo/platform/decimal128.h"
+#include "mongo/platform/overflow_arithmetic.h"
 #include "mongo/util/assert_util.h"
 
 namespace mongo {
@@ -51,18 +53,29 @@ public:
      * Adds x to the sum, keeping track of a compensation amount to be subtracted later.
      */
     void addDouble(double x) {
-        _special += x;                                 // Keep a simple sum to use in case of NaN
-        std::tie(x, _addend) = _fast2Sum(x, _addend);  // Compensated add: _addend tinier than _sum
-        std::tie(_sum, x) = _2Sum(_sum, x);            // Compensated add: x maybe larger than _sum
-        _addend += x;                                  // Store away lowest part of sum
+        _special += x;  // Keep a simple sum to use in case of NaN
+        _addCompensated(x);
     }
 
+    /**
+     * Adds the 'count' doubles starting at 'values'. The values are spread over several
+     * independent compensated sums that are combined at the end, so the result may differ from
+     * calling addDouble() on each value in the last bits of the compensation amount.
+     */
+    void addDoubles(const double* values, size_t count);
+
     /**
      * Adds x to internal sum. Extra precision guarantees that sum is exact, unless intermediate
      * sums exceed a magnitude of 2**106.
      */
     void addLong(long long x);
 
+    /**
+     * Adds the 'count' integers starting at 'values'. The result is the same as calling addLong()
+     * on each value, but the values are summed with integer arithmetic only.
+     */
+    void addLongs(const long long* values, size_t count);
+
     /**
      * Adds x to internal sum. Adds as double as that is more efficient.
      */
@@ -113,6 +126,15 @@ public:
     long long getLong() const;
 
 private:
+    /**
+     * Adds x to the unevaluated sum of _sum and _addend, without updating _special.
+     */
+    void _addCompensated(double x) {
+        std::tie(x, _addend) = _fast2Sum(x, _addend);  // Compensated add: _addend tinier than _sum
+        std::tie(_sum, x) = _2Sum(_sum, x);            // Compensated add: x maybe larger than _sum
+        _addend += x;                                  // Store away lowest part of sum
+    }
+
     /**
      * Assuming |b| <= |a|, returns exact unevaluated sum of a and b, where the first member is the
      * double nearest the sum (ties to even) and the second member is the remainder.
@@ -151,4 +173,67 @@ private:
     // using compensated addition.
     double _special = 0.0;
 };
+
+/**
+ * Class to sum a series of Decimal128 values, with the same result as adding each of them in turn
+ * to a 0E0 Decimal128 using Decimal128::add().
+ *
+ * As long as every value is finite, has a coefficient that fits a long long, and shares the same
+ * non-positive exponent, every intermediate sum is exactly representable at that exponent, so the
+ * sum is kept as a 64-bit integer coefficient without calling into the decimal library. The first
+ * value that breaks one of these conditions, or would overflow the integer sum, converts the sum
+ * to a Decimal128 and all later values are added with Decimal128::add().
+ */
+class DecimalSummation {
+public:
+    void add(const Decimal128& x) {
+        if (_isFixedPoint && _addFixedPoint(x))
+            return;
+        _addSlow(x);
+    }
+
+    /**
+     * Returns the sum, which is 0E0 if nothing was added.
+     */
+    Decimal128 getDecimal() const;
+
+private:
+    /**
+     * Adds x to the integer coefficient sum if that can be done exactly. Returns false, leaving the
+     * sum unchanged, if it can't.
+     */
+    bool _addFixedPoint(const Decimal128& x) {
+        const uint32_t exponent = x.getBiasedExponent();
+        if (exponent > static_cast<uint32_t>(Decimal128::kExponentBias) ||
+            (_hasExponent && exponent != _biasedExponent) || x.getCoefficientHigh() != 0 ||
+            x.getCoefficientLow() > static_cast<uint64_t>(std::numeric_limits<long long>::max())) {
+            // Covers NaN and infinity, whose biased exponent is above any finite one.
+            return false;
+        }
+
+        const long long coefficient = static_cast<long long>(x.getCoefficientLow());
+        long long sum;
+        if (mongoSignedAddOverflow64(
+                _coefficientSum, x.isNegative() ? -coefficient : coefficient, &sum)) {
+            return false;
+        }
+        _coefficientSum = sum;
+        _biasedExponent = exponent;
+        _hasExponent = true;
+        return true;
+    }
+
+    void _addSlow(const Decimal128& x);
+
+    bool _isFixedPoint = true;
+
+    // The integer sum and the biased exponent shared by everything added to it. Only meaningful
+    // while _isFixedPoint is true, and _biasedExponent only once _hasExponent is set.
+    bool _hasExponent = false;
+    uint32_t _biasedExponent = 0;
+    long long _coefficientSum = 0;
+
+    // The sum once _isFixedPoint is false.
+    Decimal128 _total;
+};
 }  // namespace mongo
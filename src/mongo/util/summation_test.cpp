@@ -28,13 +28,17 @@
 
 #include "mongo/platform/basic.h"
 
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault
+
 #include <cmath>
 #include <limits>
 #include <vector>
 
 #include "mongo/unittest/unittest.h"
 
+#include "mongo/util/log.h"
 #include "mongo/util/summation.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -198,4 +202,207 @@ TEST(Summation, AddDoubles) {
     ASSERT_EQUALS(sum.getDouble(), doubleValuesSum);
     ASSERT(straightSum != sum.getDouble());
 }
+
+TEST(Summation, AddDoublesBatch) {
+    // Try every split into a batch and single values, so that each value lands in each lane.
+    for (size_t offset = 0; offset < 8; offset++) {
+        DoubleDoubleSummation sum;
+        for (size_t i = 0; i < offset; i++) {
+            sum.addDouble(doubleValues[i]);
+        }
+        sum.addDoubles(doubleValues.data() + offset, doubleValues.size() - offset);
+        ASSERT_EQUALS(sum.getDouble(), doubleValuesSum);
+    }
+}
+
+TEST(Summation, AddDoublesBatchSpecial) {
+    for (auto x : specialValues) {
+        std::vector<double> values(doubleValues);
+        values[5] = x;
+        DoubleDoubleSummation sum;
+        sum.addDoubles(values.data(), values.size());
+        if (std::isnan(x)) {
+            ASSERT(std::isnan(sum.getDouble()));
+        } else {
+            ASSERT_EQUALS(sum.getDouble(), x);
+        }
+    }
+
+    std::vector<double> infinities = {std::numeric_limits<double>::infinity(),
+                                      1.0,
+                                      -std::numeric_limits<double>::infinity(),
+                                      2.0};
+    DoubleDoubleSummation sum;
+    sum.addDoubles(infinities.data(), infinities.size());
+    ASSERT(std::isnan(sum.getDouble()));
+}
+
+TEST(Summation, AddLongsBatch) {
+    // Sums of all long values, with and without each one, cover overflow in both directions.
+    for (size_t skip = 0; skip <= longValues.size(); skip++) {
+        std::vector<long long> values(longValues);
+        if (skip < values.size()) {
+            values.erase(values.begin() + skip);
+        }
+        values.insert(values.end(), longValues.begin(), longValues.end());
+
+        DoubleDoubleSummation batchSum;
+        batchSum.addLong(3);
+        batchSum.addLongs(values.data(), values.size());
+
+        DoubleDoubleSummation sum;
+        sum.addLong(3);
+        for (auto x : values) {
+            sum.addLong(x);
+        }
+
+        ASSERT(batchSum.isInteger());
+        ASSERT_EQUALS(batchSum.fitsLong(), sum.fitsLong());
+        ASSERT(batchSum.getDecimal().isEqual(sum.getDecimal()));
+        if (sum.fitsLong()) {
+            ASSERT_EQUALS(batchSum.getLong(), sum.getLong());
+        }
+    }
+
+    std::vector<long long> maxValues(1000, limits::max());
+    DoubleDoubleSummation sum;
+    sum.addLongs(maxValues.data(), maxValues.size());
+    ASSERT(!sum.fitsLong());
+    for (size_t i = 0; i < maxValues.size() - 1; i++) {
+        sum.addLong(-limits::max());
+    }
+    ASSERT_EQUALS(sum.getLong(), limits::max());
+}
+
+TEST(Summation, PerfAddBatch) {
+    const int kNumValues = 1000000;
+    std::vector<double> doubles;
+    std::vector<long long> longs;
+    for (int i = 0; i < kNumValues; i++) {
+        doubles.push_back(doubleValues[i % doubleValues.size()]);
+        longs.push_back(longValues[i % longValues.size()]);
+    }
+
+    Timer singleTimer;
+    DoubleDoubleSummation singleDoubles;
+    for (auto x : doubles) {
+        singleDoubles.addDouble(x);
+    }
+    DoubleDoubleSummation singleLongs;
+    for (auto x : longs) {
+        singleLongs.addLong(x);
+    }
+    long long singleMicros = singleTimer.micros();
+
+    Timer batchTimer;
+    DoubleDoubleSummation batchDoubles;
+    batchDoubles.addDoubles(doubles.data(), doubles.size());
+    DoubleDoubleSummation batchLongs;
+    batchLongs.addLongs(longs.data(), longs.size());
+    long long batchMicros = batchTimer.micros();
+
+    ASSERT(batchLongs.getDecimal().isEqual(singleLongs.getDecimal()));
+    ASSERT_APPROX_EQUAL(batchDoubles.getDouble(),
+                        singleDoubles.getDouble(),
+                        std::abs(singleDoubles.getDouble()) * 1e-15);
+    log() << "addDouble/addLong: " << singleMicros << "us, addDoubles/addLongs: " << batchMicros
+          << "us for " << kNumValues << " doubles and " << kNumValues << " longs";
+}
+
+namespace {
+/**
+ * Asserts that DecimalSummation yields exactly, including exponent and sign of zero, what adding
+ * 'values' one at a time to 0E0 with Decimal128::add() does.
+ */
+void assertDecimalSumMatchesSequentialAdd(const std::vector<Decimal128>& values) {
+    DecimalSummation sum;
+    Decimal128 straightSum;
+    for (auto&& x : values) {
+        sum.add(x);
+        straightSum = straightSum.add(x);
+    }
+    Decimal128::Value expected = straightSum.getValue();
+    Decimal128::Value actual = sum.getDecimal().getValue();
+    ASSERT_EQUALS(expected.high64, actual.high64);
+    ASSERT_EQUALS(expected.low64, actual.low64);
+}
+}  // namespace
+
+TEST(DecimalSummation, Empty) {
+    assertDecimalSumMatchesSequentialAdd({});
+}
+
+TEST(DecimalSummation, SameExponent) {
+    assertDecimalSumMatchesSequentialAdd(
+        {Decimal128("1.25"), Decimal128("-3.10"), Decimal128("100.00"), Decimal128("0.01")});
+}
+
+TEST(DecimalSummation, ZeroSums) {
+    assertDecimalSumMatchesSequentialAdd({Decimal128("-0.00")});
+    assertDecimalSumMatchesSequentialAdd({Decimal128("1.50"), Decimal128("-1.50")});
+    assertDecimalSumMatchesSequentialAdd({Decimal128("-0.00"), Decimal128("-0.00")});
+}
+
+TEST(DecimalSummation, PositiveExponent) {
+    assertDecimalSumMatchesSequentialAdd({Decimal128("1E+3"), Decimal128("2E+3")});
+}
+
+TEST(DecimalSummation, ExponentChanges) {
+    assertDecimalSumMatchesSequentialAdd(
+        {Decimal128("1.25"), Decimal128("2.5"), Decimal128("0.125"), Decimal128("7")});
+}
+
+TEST(DecimalSummation, CoefficientOverflow) {
+    // Each coefficient fits a long long, but their sum doesn't.
+    assertDecimalSumMatchesSequentialAdd({Decimal128("9000000000000000000"),
+                                          Decimal128("9000000000000000000"),
+                                          Decimal128("-1")});
+    assertDecimalSumMatchesSequentialAdd({Decimal128("-9223372036854775807"), Decimal128("-1")});
+    assertDecimalSumMatchesSequentialAdd(
+        {Decimal128("1234567890123456789012345678901234"), Decimal128("1")});
+}
+
+TEST(DecimalSummation, Special) {
+    assertDecimalSumMatchesSequentialAdd({Decimal128("1.5"), Decimal128::kPositiveInfinity});
+    assertDecimalSumMatchesSequentialAdd(
+        {Decimal128::kPositiveInfinity, Decimal128::kNegativeInfinity, Decimal128("1")});
+    assertDecimalSumMatchesSequentialAdd({Decimal128("1.5"), Decimal128::kPositiveNaN});
+}
+
+TEST(DecimalSummation, ManyPrices) {
+    std::vector<Decimal128> values;
+    for (int i = 0; i < 100000; ++i) {
+        values.push_back(Decimal128(static_cast<int64_t>((i * 7919) % 100000 - 50000))
+                             .divide(Decimal128("100")));
+    }
+    assertDecimalSumMatchesSequentialAdd(values);
+}
+
+TEST(DecimalSummation, PerfSameExponent) {
+    const int kNumValues = 1000000;
+    std::vector<Decimal128> values;
+    values.reserve(kNumValues);
+    for (int i = 0; i < kNumValues; ++i) {
+        values.push_back(Decimal128(0, Decimal128::kExponentBias - 2, 0, (i * 7919LL) % 100000));
+    }
+
+    Timer fixedPointTimer;
+    DecimalSummation sum;
+    for (auto&& x : values) {
+        sum.add(x);
+    }
+    Decimal128 fixedPointTotal = sum.getDecimal();
+    long long fixedPointMicros = fixedPointTimer.micros();
+
+    Timer straightTimer;
+    Decimal128 straightTotal;
+    for (auto&& x : values) {
+        straightTotal = straightTotal.add(x);
+    }
+    long long straightMicros = straightTimer.micros();
+
+    ASSERT_TRUE(fixedPointTotal.isEqual(straightTotal));
+    log() << "DecimalSummation: " << fixedPointMicros
+          << "us, Decimal128::add: " << straightMicros << "us for " << kNumValues << " values";
+}
 }  // namespace mongo
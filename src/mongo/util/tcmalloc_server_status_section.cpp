@@ -38,14 +38,28 @@
 
 #include "mongo/base/init.h"
 #include "mongo/db/commands/server_status.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/transport/transport_layer.h"
+#include "mongo/util/background.h"
 #include "mongo/util/log.h"
 #include "mongo/util/net/listen.h"
 #include "mongo/util/net/thread_idle_callback.h"
+#include "mongo/util/processinfo.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
+// Rate at which the free pages of the tcmalloc page heap are released to the operating system in
+// the background, or 0 to leave them to tcmalloc
+MONGO_EXPORT_SERVER_PARAMETER(tcmallocReleaseRateBytesPerSecond, long long, 0);
+
+// Size of the thread caches per client thread, which the background task sizes the total of the
+// thread caches by as the number of clients changes, or 0 to keep the total thread cache size
+// fixed at tcmallocMaxTotalThreadCacheBytes
+MONGO_EXPORT_SERVER_PARAMETER(tcmallocThreadCacheBytesPerClient, long long, 0);
+
 namespace {
 // If many clients are used, the per-thread caches become smaller and chances of
 // rebalancing of free space during critical sections increases. In such situations,
@@ -92,6 +106,112 @@ MONGO_INITIALIZER(TCMallocThreadIdleListener)(InitializerContext*) {
     return Status::OK();
 }
 
+// The total size of the thread caches is kept between these bounds when sized by the number of
+// clients. The upper bound is the default of tcmallocMaxTotalThreadCacheBytes.
+const size_t kMinTotalThreadCacheBytes = 16 * 1024 * 1024;
+const size_t kMaxTotalThreadCacheBytes = 1024 * 1024 * 1024;
+
+size_t getNumericPropertyOrZero(const char* property) {
+    size_t value = 0;
+    MallocExtension::instance()->GetNumericProperty(property, &value);
+    return value;
+}
+
+/**
+ * Periodically releases free memory of the page heap to the operating system, a bounded amount at
+ * a time so that memory freed all at once, such as after a large aggregation, is returned
+ * gradually, and resizes the thread caches with the number of clients.
+ */
+class TCMallocMaintenanceTask : public PeriodicTask {
+public:
+    std::string taskName() const override {
+        return "TCMallocMaintenance";
+    }
+
+    void taskDoWork() override {
+        if (RUNNING_ON_VALGRIND) {
+            return;
+        }
+
+        const double elapsedSeconds = _timer.seconds();
+        _timer.reset();
+
+        _releaseFreeMemory(elapsedSeconds);
+        _resizeThreadCaches();
+    }
+
+    void appendStats(BSONObjBuilder* builder) const {
+        builder->appendNumber("released_bytes", static_cast<long long>(_releasedBytes.load()));
+        builder->appendNumber("resized_thread_caches",
+                              static_cast<long long>(_threadCacheResizes.load()));
+    }
+
+private:
+    void _releaseFreeMemory(double elapsedSeconds) {
+        const long long rate = tcmallocReleaseRateBytesPerSecond.load();
+        if (rate <= 0) {
+            return;
+        }
+
+        const size_t freeBytes = getNumericPropertyOrZero("tcmalloc.pageheap_free_bytes");
+        const size_t bytesToRelease =
+            std::min(freeBytes, static_cast<size_t>(rate * std::max(elapsedSeconds, 1.0)));
+        if (bytesToRelease == 0) {
+            return;
+        }
+
+        const size_t unmappedBefore = getNumericPropertyOrZero("tcmalloc.pageheap_unmapped_bytes");
+        MallocExtension::instance()->ReleaseToSystem(bytesToRelease);
+        const size_t unmappedAfter = getNumericPropertyOrZero("tcmalloc.pageheap_unmapped_bytes");
+
+        if (unmappedAfter > unmappedBefore) {
+            _releasedBytes.fetchAndAdd(unmappedAfter - unmappedBefore);
+            LOG(1) << "released " << (unmappedAfter - unmappedBefore) / 1024
+                   << "k of free tcmalloc memory to the system";
+        }
+    }
+
+    void _resizeThreadCaches() {
+        const long long bytesPerClient = tcmallocThreadCacheBytesPerClient.load();
+        if (bytesPerClient <= 0) {
+            return;
+        }
+
+        const size_t numClients =
+            getGlobalServiceContext()->getTransportLayer()->sessionStats().numOpenSessions;
+        const size_t maxBytes = std::min(kMaxTotalThreadCacheBytes,
+                                         static_cast<size_t>(ProcessInfo().getMemSizeMB() / 8) *
+                                             1024 * 1024);
+        const size_t clientsBytes =
+            static_cast<size_t>(bytesPerClient) * std::max<size_t>(numClients, 1);
+        const size_t targetBytes =
+            std::max(kMinTotalThreadCacheBytes, std::min(maxBytes, clientsBytes));
+
+        const size_t currentBytes =
+            getNumericPropertyOrZero("tcmalloc.max_total_thread_cache_bytes");
+
+        // Avoid churning the thread caches over small changes in the number of clients.
+        if (targetBytes >= currentBytes - currentBytes / 8 &&
+            targetBytes <= currentBytes + currentBytes / 8) {
+            return;
+        }
+
+        if (MallocExtension::instance()->SetNumericProperty("tcmalloc.max_total_thread_cache_bytes",
+                                                            targetBytes)) {
+            _threadCacheResizes.fetchAndAdd(1);
+            LOG(1) << "resized the tcmalloc thread caches for " << numClients
+                   << " clients from " << currentBytes / 1024 << "k to " << targetBytes / 1024
+                   << "k";
+        }
+    }
+
+    // Only accessed by the periodic task runner
+    Timer _timer;
+
+    AtomicUInt64 _releasedBytes;
+    AtomicUInt64 _threadCacheResizes;
+} tcmallocMaintenanceTask;
+
 class TCMallocServerStatusSection : public ServerStatusSection {
 public:
     TCMallocServerStatusSection() : ServerStatusSection("tcmalloc") {}
@@ -156,6 +276,29 @@ public:
             appendNumericPropertyIfAvailable(
                 sub, "aggressive_memory_decommit", "tcmalloc.aggressive_memory_decommit");
 
+            // Memory which tcmalloc holds on to without it being in use: the resident part of the
+            // heap less what is allocated.
+            size_t allocated;
+            size_t heapSize;
+            size_t unmapped;
+            if (MallocExtension::instance()->GetNumericProperty("generic.current_allocated_bytes",
+                                                                &allocated) &&
+                MallocExtension::instance()->GetNumericProperty("generic.heap_size", &heapSize) &&
+                MallocExtension::instance()->GetNumericProperty("tcmalloc.pageheap_unmapped_bytes",
+                                                                &unmapped) &&
+                heapSize >= unmapped + allocated) {
+                const size_t resident = heapSize - unmapped;
+                sub.appendNumber("resident_free_bytes", resident - allocated);
+                if (allocated > 0) {
+                    sub.append("fragmentation_ratio",
+                               static_cast<double>(resident) / static_cast<double>(allocated));
+                }
+            }
+            {
+                BSONObjBuilder maintenance(sub.subobjStart("maintenance"));
+                tcmallocMaintenanceTask.appendStats(&maintenance);
+            }
+
 #if MONGO_HAVE_GPERFTOOLS_SIZE_CLASS_STATS
             if (verbosity >= 2) {
                 // Size class information
@@ -0,0 +1,165 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/timer_wheel.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+namespace {
+
+const std::uint64_t kSlotMask = TimerWheel::kSlotsPerLevel - 1;
+
+// The number of ticks the wheel spans; timers further out than this are parked in the top level
+// and placed again each time their slot is cascaded.
+const std::uint64_t kSpan = 1ULL << (TimerWheel::kSlotBits * TimerWheel::kLevels);
+
+std::uint64_t ticksPerSlot(int level) {
+    return 1ULL << (TimerWheel::kSlotBits * level);
+}
+
+}  // namespace
+
+TimerWheel::TimerWheel(Date_t start, Milliseconds resolution)
+    : _start(start), _resolution(resolution) {
+    invariant(_resolution > Milliseconds(0));
+}
+
+std::uint64_t TimerWheel::_tickFor(Date_t deadline) const {
+    if (deadline <= _start) {
+        return 0;
+    }
+    const std::uint64_t millis = durationCount<Milliseconds>(deadline - _start);
+    const std::uint64_t resolution = durationCount<Milliseconds>(_resolution);
+    return (millis + resolution - 1) / resolution;
+}
+
+Date_t TimerWheel::_timeOfTick(std::uint64_t tick) const {
+    return _start + _resolution * static_cast<long long>(tick);
+}
+
+void TimerWheel::add(TimerId id, Date_t deadline) {
+    _place({std::max(_tickFor(deadline), _currentTick + 1), id});
+    ++_size;
+}
+
+void TimerWheel::_place(Entry entry) {
+    invariant(entry.tick >= _currentTick);
+    std::uint64_t placement = entry.tick;
+    if (placement - _currentTick >= kSpan) {
+        placement = _currentTick + kSpan - 1;
+    }
+
+    int level = 0;
+    while (placement - _currentTick >= ticksPerSlot(level + 1)) {
+        ++level;
+    }
+    const std::uint64_t slot = (placement >> (kSlotBits * level)) & kSlotMask;
+    _levels[level][slot].push_back(entry);
+}
+
+void TimerWheel::_step(std::vector<TimerId>* expired) {
+    ++_currentTick;
+
+    // Cascade from the top down, so that timers moving out of a higher level can be cascaded again
+    // by a lower level turning over on the same tick.
+    for (int level = kLevels - 1; level > 0; --level) {
+        if ((_currentTick & (ticksPerSlot(level) - 1)) != 0) {
+            continue;
+        }
+        std::vector<Entry> cascaded;
+        cascaded.swap(_levels[level][(_currentTick >> (kSlotBits * level)) & kSlotMask]);
+        for (const auto& entry : cascaded) {
+            _place(entry);
+        }
+    }
+
+    auto& slot = _levels[0][_currentTick & kSlotMask];
+    for (const auto& entry : slot) {
+        dassert(entry.tick == _currentTick);
+        expired->push_back(entry.id);
+    }
+    _size -= slot.size();
+    slot.clear();
+}
+
+void TimerWheel::advanceTo(Date_t now, std::vector<TimerId>* expired) {
+    const std::uint64_t target = now <= _start
+        ? 0
+        : durationCount<Milliseconds>(now - _start) / durationCount<Milliseconds>(_resolution);
+    while (_currentTick < target) {
+        // Ticks before the next wakeup neither expire nor cascade any timers, so skip over them.
+        const std::uint64_t next = _nextWakeupTick();
+        if (next > target) {
+            _currentTick = target;
+            return;
+        }
+        _currentTick = next - 1;
+        _step(expired);
+    }
+}
+
+boost::optional<Date_t> TimerWheel::nextWakeup() const {
+    if (_size == 0) {
+        return boost::none;
+    }
+    return _timeOfTick(_nextWakeupTick());
+}
+
+std::uint64_t TimerWheel::_nextWakeupTick() const {
+    std::uint64_t next = std::numeric_limits<std::uint64_t>::max();
+    for (std::uint64_t ahead = 1; ahead < kSlotsPerLevel; ++ahead) {
+        if (!_levels[0][(_currentTick + ahead) & kSlotMask].empty()) {
+            next = _currentTick + ahead;
+            break;
+        }
+    }
+
+    // A slot in a higher level needs attention when the wheel reaches its first tick, which is a
+    // whole number of turns of the level below it. The slot for the current position of a level
+    // may hold timers a full turn ahead.
+    for (int level = 1; level < kLevels; ++level) {
+        const std::uint64_t position = _currentTick >> (kSlotBits * level);
+        for (std::uint64_t ahead = 1; ahead <= kSlotsPerLevel; ++ahead) {
+            if (!_levels[level][(position + ahead) & kSlotMask].empty()) {
+                next = std::min(next, (position + ahead) << (kSlotBits * level));
+                break;
+            }
+        }
+    }
+
+    return next;
+}
+
+}  // namespace mongo
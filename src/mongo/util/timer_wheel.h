@@ -0,0 +1,120 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <boost/optional.hpp>
+#include <cstdint>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+/**
+ * A hierarchical timing wheel, which keeps timers ordered by deadline at a constant cost per
+ * insertion and per tick, however many timers there are.
+ *
+ * Time is divided into ticks of a fixed resolution. The lowest level of the wheel has one slot per
+ * tick for the timers that expire soon; each higher level has slots covering a whole turn of the
+ * level below it. As the wheel turns, the timers in a higher level slot are cascaded into the
+ * lower levels, so that every timer reaches the lowest level by the tick at which it expires.
+ * Deadlines are rounded up to the next tick.
+ *
+ * This class is not thread safe.
+ */
+class TimerWheel {
+    MONGO_DISALLOW_COPYING(TimerWheel);
+
+public:
+    using TimerId = std::uint64_t;
+
+    static constexpr int kLevels = 4;
+    static constexpr int kSlotBits = 6;
+    static constexpr std::size_t kSlotsPerLevel = 1 << kSlotBits;
+
+    /**
+     * Makes an empty wheel whose first tick is at "start".
+     */
+    TimerWheel(Date_t start, Milliseconds resolution);
+
+    /**
+     * Adds a timer that expires at "deadline". A deadline that is not after the current tick
+     * expires at the next one.
+     */
+    void add(TimerId id, Date_t deadline);
+
+    /**
+     * Turns the wheel up to "now", appending the ids of the timers that expired to "expired" in
+     * order of expiration.
+     */
+    void advanceTo(Date_t now, std::vector<TimerId>* expired);
+
+    /**
+     * Returns the time at which the wheel next needs to be turned: the deadline of its next timer,
+     * or, if all the timers are in the higher levels, the next time some of them are cascaded.
+     * Returns boost::none if the wheel is empty.
+     */
+    boost::optional<Date_t> nextWakeup() const;
+
+    /**
+     * Returns the number of timers in the wheel.
+     */
+    std::size_t size() const {
+        return _size;
+    }
+
+private:
+    struct Entry {
+        std::uint64_t tick;
+        TimerId id;
+    };
+
+    std::uint64_t _tickFor(Date_t deadline) const;
+    Date_t _timeOfTick(std::uint64_t tick) const;
+
+    /**
+     * Returns the first tick at which a timer expires or is cascaded, or the largest tick if the
+     * wheel is empty.
+     */
+    std::uint64_t _nextWakeupTick() const;
+
+    void _place(Entry entry);
+    void _step(std::vector<TimerId>* expired);
+
+    const Date_t _start;
+    const Milliseconds _resolution;
+
+    std::uint64_t _currentTick = 0;
+    std::size_t _size = 0;
+    std::array<std::array<std::vector<Entry>, kSlotsPerLevel>, kLevels> _levels;
+};
+
+}  // namespace mongo
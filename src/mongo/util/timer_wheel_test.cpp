@@ -0,0 +1,140 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/timer_wheel.h"
+
+#include <vector>
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using TimerId = TimerWheel::TimerId;
+
+const Date_t kStart = Date_t::fromMillisSinceEpoch(1000000);
+const Milliseconds kResolution{10};
+
+TEST(TimerWheelTest, EmptyWheelHasNoWakeup) {
+    TimerWheel wheel(kStart, kResolution);
+    ASSERT_EQ(0U, wheel.size());
+    ASSERT_FALSE(wheel.nextWakeup());
+
+    std::vector<TimerId> expired;
+    wheel.advanceTo(kStart + Hours(1), &expired);
+    ASSERT_TRUE(expired.empty());
+}
+
+TEST(TimerWheelTest, TimerExpiresAtItsDeadline) {
+    TimerWheel wheel(kStart, kResolution);
+    wheel.add(1, kStart + Milliseconds(100));
+    ASSERT_EQ(1U, wheel.size());
+    ASSERT_EQ(kStart + Milliseconds(100), *wheel.nextWakeup());
+
+    std::vector<TimerId> expired;
+    wheel.advanceTo(kStart + Milliseconds(99), &expired);
+    ASSERT_TRUE(expired.empty());
+
+    wheel.advanceTo(kStart + Milliseconds(100), &expired);
+    ASSERT_EQ(1U, expired.size());
+    ASSERT_EQ(1U, expired.front());
+    ASSERT_EQ(0U, wheel.size());
+    ASSERT_FALSE(wheel.nextWakeup());
+}
+
+TEST(TimerWheelTest, DeadlinesAreRoundedUpToTheNextTick) {
+    TimerWheel wheel(kStart, kResolution);
+    wheel.add(1, kStart + Milliseconds(101));
+    ASSERT_EQ(kStart + Milliseconds(110), *wheel.nextWakeup());
+
+    std::vector<TimerId> expired;
+    wheel.advanceTo(kStart + Milliseconds(109), &expired);
+    ASSERT_TRUE(expired.empty());
+    wheel.advanceTo(kStart + Milliseconds(110), &expired);
+    ASSERT_EQ(1U, expired.size());
+    ASSERT_EQ(1U, expired.front());
+}
+
+TEST(TimerWheelTest, PastDeadlineExpiresOnTheNextTick) {
+    TimerWheel wheel(kStart, kResolution);
+    std::vector<TimerId> expired;
+    wheel.advanceTo(kStart + Seconds(1), &expired);
+
+    wheel.add(1, kStart);
+    ASSERT_EQ(kStart + Seconds(1) + kResolution, *wheel.nextWakeup());
+    wheel.advanceTo(kStart + Seconds(1) + kResolution, &expired);
+    ASSERT_EQ(1U, expired.size());
+    ASSERT_EQ(1U, expired.front());
+}
+
+TEST(TimerWheelTest, TimersExpireInDeadlineOrderAcrossAllLevels) {
+    TimerWheel wheel(kStart, kResolution);
+    // One deadline in each level of the wheel, and one beyond its span, added out of order.
+    const std::vector<Milliseconds> delays{
+        Hours(24 * 60), Seconds(5), Milliseconds(30), Minutes(20), Seconds(500), Hours(30)};
+    for (TimerId id = 0; id < delays.size(); ++id) {
+        wheel.add(id, kStart + delays[id]);
+    }
+
+    std::vector<TimerId> expired;
+    const std::vector<TimerId> expectedOrder{2, 1, 4, 3, 5, 0};
+    for (auto id : expectedOrder) {
+        // The wheel may need to be turned at intermediate times to cascade timers, but never past
+        // the next deadline.
+        while (expired.empty()) {
+            auto wakeup = wheel.nextWakeup();
+            ASSERT_TRUE(wakeup);
+            ASSERT_LTE(*wakeup, kStart + delays[id]);
+            wheel.advanceTo(*wakeup, &expired);
+        }
+        ASSERT_EQ(1U, expired.size());
+        ASSERT_EQ(id, expired.front());
+        expired.clear();
+    }
+    ASSERT_EQ(0U, wheel.size());
+}
+
+TEST(TimerWheelTest, JumpingAheadExpiresEverythingDue) {
+    TimerWheel wheel(kStart, kResolution);
+    for (TimerId id = 0; id < 100; ++id) {
+        wheel.add(id, kStart + Seconds(static_cast<long long>(id) * 7));
+    }
+
+    std::vector<TimerId> expired;
+    wheel.advanceTo(kStart + Seconds(350), &expired);
+    ASSERT_EQ(51U, expired.size());
+    for (TimerId id = 0; id < expired.size(); ++id) {
+        ASSERT_EQ(id, expired[id]);
+    }
+    ASSERT_EQ(49U, wheel.size());
+}
+
+}  // namespace
+}  // namespace mongo
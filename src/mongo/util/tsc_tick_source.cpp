@@ -0,0 +1,141 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/tsc_tick_source.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <cpuid.h>
+#include <x86intrin.h>
+#define MONGO_HAVE_TSC_TICK_SOURCE
+#elif defined(_M_X64)
+#include <intrin.h>
+#define MONGO_HAVE_TSC_TICK_SOURCE
+#endif
+
+#include "mongo/base/init.h"
+#include "mongo/util/system_tick_source.h"
+
+namespace mongo {
+
+namespace {
+
+// Set by the initializer below, and left false if the time stamp counter is not usable.
+bool useTsc = false;
+TickSource::Tick tscTicksPerSecond = 0;
+
+#ifdef MONGO_HAVE_TSC_TICK_SOURCE
+TickSource::Tick readTsc() {
+    return static_cast<TickSource::Tick>(__rdtsc());
+}
+
+/**
+ * Returns true if the processor advertises an invariant time stamp counter, which ticks at a
+ * constant rate in every power state.
+ */
+bool hasInvariantTsc() {
+    const unsigned int kPowerManagementLeaf = 0x80000007;
+    const unsigned int kInvariantTscBit = 1 << 8;
+#if defined(_MSC_VER)
+    int regs[4];
+    __cpuid(regs, 0x80000000);
+    if (static_cast<unsigned int>(regs[0]) < kPowerManagementLeaf) {
+        return false;
+    }
+    __cpuid(regs, kPowerManagementLeaf);
+    return static_cast<unsigned int>(regs[3]) & kInvariantTscBit;
+#else
+    if (__get_cpuid_max(0x80000000, nullptr) < kPowerManagementLeaf) {
+        return false;
+    }
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(kPowerManagementLeaf, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+    return edx & kInvariantTscBit;
+#endif
+}
+
+/**
+ * Measures how far the time stamp counter moves while the SystemTickSource moves by two
+ * milliseconds.
+ */
+TickSource::Tick calibrateTsc() {
+    auto systemTickSource = SystemTickSource::get();
+    const auto systemTicksPerSecond = systemTickSource->getTicksPerSecond();
+
+    const auto systemStart = systemTickSource->getTicks();
+    const auto tscStart = readTsc();
+    auto systemEnd = systemStart;
+    while (systemEnd - systemStart < systemTicksPerSecond / 500) {
+        systemEnd = systemTickSource->getTicks();
+    }
+    const auto tscEnd = readTsc();
+
+    return (tscEnd - tscStart) * systemTicksPerSecond / (systemEnd - systemStart);
+}
+#endif
+
+}  // namespace
+
+MONGO_INITIALIZER_WITH_PREREQUISITES(TscTickSourceInit, ("SystemTickSourceInit"))
+(InitializerContext* context) {
+#ifdef MONGO_HAVE_TSC_TICK_SOURCE
+    if (hasInvariantTsc()) {
+        tscTicksPerSecond = calibrateTsc();
+        useTsc = tscTicksPerSecond > 0;
+    }
+#endif
+    TscTickSource::get();
+    return Status::OK();
+}
+
+TickSource::Tick TscTickSource::getTicks() {
+#ifdef MONGO_HAVE_TSC_TICK_SOURCE
+    if (useTsc) {
+        return readTsc();
+    }
+#endif
+    return SystemTickSource::get()->getTicks();
+}
+
+TickSource::Tick TscTickSource::getTicksPerSecond() {
+    return useTsc ? tscTicksPerSecond : SystemTickSource::get()->getTicksPerSecond();
+}
+
+bool TscTickSource::usesTsc() const {
+    return useTsc;
+}
+
+TscTickSource* TscTickSource::get() {
+    static TscTickSource globalTscTickSource;
+    return &globalTscTickSource;
+}
+
+}  // namespace mongo
@@ -0,0 +1,60 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/util/tick_source.h"
+
+namespace mongo {
+
+/**
+ * Tick source reading the time stamp counter of the processor, which is cheap enough to time
+ * every call into a plan stage. Its rate is calibrated against the SystemTickSource at startup.
+ *
+ * On processors without an invariant time stamp counter, which may change rate or stop in deep
+ * sleep states, and on platforms other than x86-64, it returns the ticks of the SystemTickSource
+ * instead.
+ */
+class TscTickSource final : public TickSource {
+public:
+    TickSource::Tick getTicks() override;
+
+    TickSource::Tick getTicksPerSecond() override;
+
+    /**
+     * Returns true if the ticks come from the time stamp counter.
+     */
+    bool usesTsc() const;
+
+    /**
+     * Gets the singleton instance of TscTickSource. Should not be called before the global
+     * initializers are done.
+     */
+    static TscTickSource* get();
+};
+}  // namespace mongo
@@ -0,0 +1,71 @@
+/**
+ *    Copyright (C) 2017 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/tsc_tick_source.h"
+
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/system_tick_source.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+TEST(TscTickSourceTest, TicksNeverGoBackwards) {
+    auto tickSource = TscTickSource::get();
+    ASSERT_GT(tickSource->getTicksPerSecond(), 0);
+
+    auto previous = tickSource->getTicks();
+    for (int i = 0; i < 1000; ++i) {
+        const auto ticks = tickSource->getTicks();
+        ASSERT_GTE(ticks, previous);
+        previous = ticks;
+    }
+}
+
+TEST(TscTickSourceTest, ElapsedTimeAgreesWithSystemTickSource) {
+    auto tickSource = TscTickSource::get();
+    auto systemTickSource = SystemTickSource::get();
+
+    const auto start = tickSource->getTicks();
+    const auto systemStart = systemTickSource->getTicks();
+    sleepmillis(100);
+    const auto elapsed = tickSource->getTicks() - start;
+    const auto systemElapsed = systemTickSource->getTicks() - systemStart;
+
+    const double seconds = static_cast<double>(elapsed) / tickSource->getTicksPerSecond();
+    const double systemSeconds =
+        static_cast<double>(systemElapsed) / systemTickSource->getTicksPerSecond();
+
+    // The calibration is only as good as the short interval it measures.
+    ASSERT_APPROX_EQUAL(seconds, systemSeconds, systemSeconds * 0.05);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -41,6 +41,10 @@ namespace mongo {
 /**
  * A hash map that allows a different type to be used stored (K_S) than is used for lookups (K_L).
  *
+ * Entries live inline in a single array and collisions are resolved by linear probing, so inserting
+ * a key costs no allocation beyond whatever K_S itself needs. Erased entries leave tombstones
+ * behind; these count towards the load factor and are discarded the next time the table is rebuilt.
+ *
  * Takes a Traits class that must have the following:
  *
  * static uint32_t hash(K_L); // Computes a 32-bit hash of the key.
@@ -75,7 +79,7 @@ private:
         Entry() = default;
 
         Entry(const Entry& other)
-            : _used(other._used), _everUsed(other.everUsed), _curHash(other._curHash) {
+            : _used(other._used), _everUsed(other._everUsed), _curHash(other._curHash) {
             if (other.isUsed()) {
                 new (&_data) value_type(other.getData());
             }
@@ -158,15 +162,13 @@ private:
     struct Area {
         Area() = default;  // TODO constexpr
 
-        Area(unsigned capacity, unsigned maxProbe)
-            : _hashMask(capacity - 1),
-              _maxProbe(maxProbe),
-              _entries(capacity ? new Entry[capacity] : nullptr) {
+        explicit Area(unsigned capacity)
+            : _hashMask(capacity - 1), _entries(capacity ? new Entry[capacity] : nullptr) {
             // Capacity must be a power of two or zero. See the comment on _hashMask for why.
             dassert((capacity & (capacity - 1)) == 0);
         }
 
-        Area(const Area& other) : Area(other.capacity(), other._maxProbe) {
+        Area(const Area& other) : Area(other.capacity()) {
             std::copy(other.begin(), other.end(), begin());
         }
 
@@ -177,12 +179,11 @@ private:
 
         int find(const HashedKey& key, int* firstEmpty) const;
 
-        bool transfer(Area* newArea) const;
+        void transfer(Area* newArea) const;
 
         void swap(Area* other) {
             using std::swap;
             swap(_hashMask, other->_hashMask);
-            swap(_maxProbe, other->_maxProbe);
             swap(_entries, other->_entries);
         }
 
@@ -209,7 +210,6 @@ private:
         // store it directly and derive the capacity from it. The default capacity is 0 so the
         // default hashMask is -1.
         unsigned _hashMask = -1;
-        unsigned _maxProbe = 0;
         std::unique_ptr<Entry[]> _entries = {};
     };
 
@@ -404,6 +404,7 @@ public:
     void swap(UnorderedFastKeyTable& other) {
         _area.swap(&(other._area));
         std::swap(_size, other._size);
+        std::swap(_numTombstones, other._numTombstones);
     }
 
     friend void swap(UnorderedFastKeyTable& lhs, UnorderedFastKeyTable& rhs) {
@@ -411,9 +412,14 @@ public:
     }
 
 private:
+    /**
+     * Rebuilds the table so that it has room for at least one more entry. This doubles the capacity
+     * when live entries would fill more than half of it, and otherwise only drops the tombstones.
+     */
     void _grow();
 
     size_t _size = 0;
+    size_t _numTombstones = 0;  // Slots whose entry was erased since the area was last rebuilt.
     Area _area;
 };
 }
@@ -30,6 +30,9 @@
 
 #pragma once
 
+#include <algorithm>
+#include <limits>
+
 #include "mongo/util/unordered_fast_key_table.h"
 
 namespace mongo {
@@ -40,8 +43,9 @@ inline int UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::find(const HashedKe
     dassert(capacity());                        // Caller must special-case empty tables.
     dassert(!firstEmpty || *firstEmpty == -1);  // Caller must initialize *firstEmpty.
 
-    unsigned probe = 0;
-    do {
+    // The load factor guarantees some slot was never used, so probing always ends before wrapping
+    // all the way around.
+    for (unsigned probe = 0; probe < capacity(); ++probe) {
         unsigned pos = (key.hash() + probe) & _hashMask;
 
         if (!_entries[pos].isUsed()) {
@@ -67,12 +71,12 @@ inline int UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::find(const HashedKe
         // hashes and strings are equal
         // yay!
         return pos;
-    } while (++probe < _maxProbe);
+    }
     return -1;
 }
 
 template <typename K_L, typename K_S, typename V, typename Traits>
-inline bool UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::transfer(Area* newArea) const {
+inline void UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::transfer(Area* newArea) const {
     for (auto&& entry : *this) {
         if (!entry.isUsed())
             continue;
@@ -82,13 +86,10 @@ inline bool UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::transfer(Area* new
             HashedKey(Traits::toLookup(entry.getData().first), entry.getCurHash()), &firstEmpty);
 
         verify(loc == -1);
-        if (firstEmpty < 0) {
-            return false;
-        }
+        verify(firstEmpty >= 0);
 
         newArea->_entries[firstEmpty] = entry;
     }
-    return true;
 }
 
 template <typename K_L, typename K_S, typename V, typename Traits>
@@ -121,6 +122,7 @@ inline size_t UnorderedFastKeyTable<K_L, K_S, V, Traits>::erase(const HashedKey&
         return 0;
 
     --_size;
+    ++_numTombstones;
     _area._entries[pos].unUse();
     return 1;
 }
@@ -131,6 +133,7 @@ void UnorderedFastKeyTable<K_L, K_S, V, Traits>::erase(const_iterator it) {
     dassert(it._area == &_area);
 
     --_size;
+    ++_numTombstones;
     _area._entries[it._position].unUse();
 }
 
@@ -145,52 +148,54 @@ inline auto UnorderedFastKeyTable<K_L, K_S, V, Traits>::try_emplace(const Hashed
         _grow();
     }
 
-    for (int numGrowTries = 0; numGrowTries < 5; numGrowTries++) {
-        int firstEmpty = -1;
-        int pos = _area.find(key, &firstEmpty);
-        if (pos >= 0) {
-            // This is only possible the first pass through the loop, since you're allocating space
-            // for a new element after that.
-            dassert(numGrowTries == 0);
-            return {iterator(&_area, pos), false};
-        }
+    int firstEmpty = -1;
+    int pos = _area.find(key, &firstEmpty);
+    if (pos >= 0) {
+        return {iterator(&_area, pos), false};
+    }
 
-        // key not in map
-        // need to add
-        if (firstEmpty >= 0) {
-            _size++;
-            _area._entries[firstEmpty].emplaceData(key, std::forward<Args>(args)...);
-            return {iterator(&_area, firstEmpty), true};
+    // key not in map
+    // need to add
+    if (firstEmpty < 0 || !_area._entries[firstEmpty].wasEverUsed()) {
+        // Reusing a tombstone doesn't change how full the table is, but claiming a slot which was
+        // never used does, and may take the table past its maximum load factor.
+        const size_t kMaxLoadNumerator = 3;
+        const size_t kMaxLoadDenominator = 4;
+        if ((_size + _numTombstones + 1) * kMaxLoadDenominator >
+            _area.capacity() * kMaxLoadNumerator) {
+            _grow();
+            firstEmpty = -1;
+            pos = _area.find(key, &firstEmpty);
+            dassert(pos < 0);
         }
+    }
 
-        // no space left in map
-        _grow();
+    massert(16471, "UnorderedFastKeyTable couldn't find space for a new entry", firstEmpty >= 0);
+    if (_area._entries[firstEmpty].wasEverUsed()) {
+        --_numTombstones;
     }
-    msgasserted(16471, "UnorderedFastKeyTable couldn't add entry after growing many times");
+    _size++;
+    _area._entries[firstEmpty].emplaceData(key, std::forward<Args>(args)...);
+    return {iterator(&_area, firstEmpty), true};
 }
 
 template <typename K_L, typename K_S, typename V, typename Traits>
 inline void UnorderedFastKeyTable<K_L, K_S, V, Traits>::_grow() {
-    unsigned capacity = _area.capacity();
-    for (int numGrowTries = 0; numGrowTries < 5; numGrowTries++) {
-        if (capacity == 0) {
-            const unsigned kDefaultStartingCapacity = 16;
-            capacity = kDefaultStartingCapacity;
-        } else {
-            capacity *= 2;
-        }
-
-        const double kMaxProbeRatio = 0.05;
-        unsigned maxProbes = (capacity * kMaxProbeRatio) + 1;  // Round up
-
-        Area newArea(capacity, maxProbes);
-        bool success = _area.transfer(&newArea);
-        if (!success) {
-            continue;
-        }
-        _area.swap(&newArea);
-        return;
+    const unsigned kDefaultStartingCapacity = 16;
+    unsigned capacity = std::max(_area.capacity(), kDefaultStartingCapacity);
+
+    // Keep the live entries to at most half of the new area, so that a table whose size is steady
+    // but which sees many erases only needs rebuilding after a good number of insertions.
+    while ((_size + 1) * 2 > capacity) {
+        massert(16845,
+                "UnorderedFastKeyTable::_grow couldn't add entry after growing many times",
+                capacity <= (std::numeric_limits<unsigned>::max() >> 1));
+        capacity *= 2;
     }
-    msgasserted(16845, "UnorderedFastKeyTable::_grow couldn't add entry after growing many times");
+
+    Area newArea(capacity);
+    _area.transfer(&newArea);
+    _area.swap(&newArea);
+    _numTombstones = 0;
 }
 }